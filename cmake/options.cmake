@@ -9,8 +9,12 @@ option(BUILD_SCRIPTDEV      "Build ScriptDev. (OFF Speedup build)"  ON)
 option(BUILD_PLAYERBOT      "Build Playerbot mod"                   OFF)
 option(BUILD_AHBOT          "Build Auction House Bot mod"           OFF)
 option(BUILD_METRICS        "Build Metrics, generate data for Grafana" OFF)
+option(BUILD_DEBUG_LOG      "Compile in debug level log output"     ON)
 option(BUILD_RECASTDEMOMOD  "Build map/vmap/mmap viewer"            OFF)
 option(BUILD_GIT_ID         "Build git_id"                          OFF)
+option(BUILD_LOADTEST       "Build synthetic client load generator" OFF)
+option(BUILD_PACKETLOG      "Build chunked packet log reader"       OFF)
+option(BUILD_BENCHMARKS    "Build core microbenchmarks and the packet replay into mangosd" OFF)
 option(BUILD_DOCS           "Build documentation with doxygen"      OFF)
 option(CMAKE_INTERPROCEDURAL_OPTIMIZATION "Enable link-time optimizations" OFF)
 
@@ -36,8 +40,12 @@ message(STATUS
     BUILD_PLAYERBOT         Build Playerbot mod
     BUILD_AHBOT             Build Auction House Bot mod
     BUILD_METRICS           Build Metrics, generate data for Grafana
+    BUILD_DEBUG_LOG         Compile in debug level log output (disable to drop it and its arguments from release builds)
     BUILD_RECASTDEMOMOD     Build map/vmap/mmap viewer
     BUILD_GIT_ID            Build git_id
+    BUILD_LOADTEST          Build synthetic client load generator (requires game server)
+    BUILD_PACKETLOG         Build chunked packet log reader (requires game server)
+    BUILD_BENCHMARKS        Build core microbenchmarks and the packet replay, run with mangosd --benchmark <file> or --replay <capture> (requires game server)
     BUILD_DOCS              Build documentation with doxygen
 
   To set an option simply type -D<OPTION>=<VALUE> after 'cmake <srcs>'.
@@ -61,6 +61,12 @@ else()
   message(STATUS "Build METRICs         : No  (default)")
 endif()
 
+if(BUILD_DEBUG_LOG)
+  message(STATUS "Build debug log       : Yes (default)")
+else()
+  message(STATUS "Build debug log       : No")
+endif()
+
 if(BUILD_PLAYERBOT)
   message(STATUS "Build Playerbot       : Yes")
 else()
@@ -85,6 +91,24 @@ else()
   message(STATUS "Build git_id          : No  (default)")
 endif()
 
+if(BUILD_LOADTEST)
+  message(STATUS "Build loadtest        : Yes")
+else()
+  message(STATUS "Build loadtest        : No  (default)")
+endif()
+
+if(BUILD_PACKETLOG)
+  message(STATUS "Build packetlog       : Yes")
+else()
+  message(STATUS "Build packetlog       : No  (default)")
+endif()
+
+if(BUILD_BENCHMARKS)
+  message(STATUS "Build benchmarks      : Yes")
+else()
+  message(STATUS "Build benchmarks      : No  (default)")
+endif()
+
 if(BUILD_DOCS)
   message(STATUS "Build documentation   : Yes")
 else()
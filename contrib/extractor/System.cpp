@@ -4,6 +4,11 @@
 #include <deque>
 #include <set>
 #include <cstdlib>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <thread>
+#include <vector>
 
 #ifdef _WIN32
 #include "direct.h"
@@ -39,7 +44,7 @@
 #endif
 
 #include "Maps/GridMapDefines.h"
-extern ArchiveSet gOpenArchives;
+extern thread_local ArchiveSet gOpenArchives;
 
 typedef struct
 {
@@ -53,6 +58,7 @@ uint16* LiqType;
 char output_path[128] = ".";
 char input_path[128] = ".";
 uint32 maxAreaId = 0;
+uint32 maxLiqTypeId = 0;
 
 //**************************************************
 // Extractor options
@@ -78,6 +84,11 @@ float CONF_float_to_int16_limit = 2048.0f;   // Max accuracy = val/65536
 float CONF_flat_height_delta_limit = 0.005f; // If max - min less this value - surface is flat
 float CONF_flat_liquid_delta_limit = 0.001f; // If max - min less this value - liquid surface is flat
 
+// Threads used to extract dbc files and convert map tiles, each opens its own MPQ handles
+int   CONF_threads = 1;
+// Skip map tiles whose source and conversion settings are unchanged since the last extraction
+bool  CONF_incremental = false;
+
 // List MPQ for extract from
 static char const* CONF_mpq_list[] =
 {
@@ -125,6 +136,8 @@ void Usage(char* prg)
         "-o set output path\n"\
         "-e extract only MAP(1)/DBC(2)/Camera(4) - standard: all(7)\n"\
         "-f height stored as int (less map size but lost some accuracy) 1 by default\n"\
+        "-t number of extraction threads, 0 uses all cores - standard: 1\n"\
+        "-u only convert map tiles changed since the last extraction 0 by default\n"\
         "Example: %s -f 0 -i \"c:\\games\\game\"", prg, prg);
     exit(1);
 }
@@ -138,6 +151,8 @@ void HandleArgs(int argc, char* arg[])
         // e - extract only MAP(1)/DBC(2) - standard both(3)
         // f - use float to int conversion
         // h - limit minimum height
+        // t - extraction threads
+        // u - incremental map extraction
         if (arg[c][0] != '-')
             Usage(arg[0]);
 
@@ -171,6 +186,24 @@ void HandleArgs(int argc, char* arg[])
                 else
                     Usage(arg[0]);
                 break;
+            case 't':
+                if (c + 1 < argc)                           // all ok
+                {
+                    CONF_threads = atoi(arg[(c++) + 1]);
+                    if (CONF_threads < 0)
+                        Usage(arg[0]);
+                    if (!CONF_threads)
+                        CONF_threads = std::max(1u, std::thread::hardware_concurrency());
+                }
+                else
+                    Usage(arg[0]);
+                break;
+            case 'u':
+                if (c + 1 < argc)                           // all ok
+                    CONF_incremental = atoi(arg[(c++) + 1]) != 0;
+                else
+                    Usage(arg[0]);
+                break;
         }
     }
 }
@@ -276,6 +309,8 @@ void ReadLiquidTypeTableDBC()
     for (uint32 x = 0; x < LiqType_count; ++x)
         LiqType[dbc.getRecord(x).getUInt(0)] = dbc.getRecord(x).getUInt(3);
 
+    maxLiqTypeId = LiqType_maxid;
+
     printf("Done! (%u LiqTypes loaded)\n", uint32(LiqType_count));
 }
 
@@ -300,27 +335,23 @@ float selectUInt16StepStore(float maxDiff)
     return 65535 / maxDiff;
 }
 // Temporary grid data store
-uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-
-float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
-uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
-uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
-
-uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
-
-bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32 build)
+// conversion buffers, one set per extraction thread
+thread_local uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+
+thread_local float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+thread_local uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+thread_local uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+
+thread_local uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+
+bool ConvertADT(ADT_file& adt, char const* filename, char const* filename2, int cell_y, int cell_x, uint32 build)
 {
-    ADT_file adt;
-
-    if (!adt.loadFile(filename))
-        return false;
-
     adt_MCIN* cells = adt.a_grid->getMCIN();
     if (!cells)
     {
@@ -864,10 +895,143 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
     return true;
 }
 
-void ExtractMapsFromMpq(uint32 build)
+void LoadLocaleMPQFiles(int const locale)
+{
+    char filename[512];
+
+    sprintf(filename, "%s/Data/%s/locale-%s.MPQ", input_path, langs[locale], langs[locale]);
+    new MPQArchive(filename);
+
+    for (int i = 1; i < 5; ++i)
+    {
+        char ext[3] = "";
+        if (i > 1)
+            sprintf(ext, "-%i", i);
+
+        sprintf(filename, "%s/Data/%s/patch-%s%s.MPQ", input_path, langs[locale], langs[locale], ext);
+        if (FileExists(filename))
+            new MPQArchive(filename);
+    }
+}
+
+void LoadCommonMPQFiles()
+{
+    char filename[512];
+    int count = sizeof(CONF_mpq_list) / sizeof(char*);
+    for (int i = 0; i < count; ++i)
+    {
+        sprintf(filename, "%s/Data/%s", input_path, CONF_mpq_list[i]);
+        if (FileExists(filename))
+            new MPQArchive(filename);
+    }
+}
+
+inline void CloseMPQFiles()
+{
+    for (ArchiveSet::iterator j = gOpenArchives.begin(); j != gOpenArchives.end(); ++j)(*j)->close();
+    gOpenArchives.clear();
+}
+
+// Calls job(index) for each index below count. With more than one thread configured every worker opens its
+// own archives through openArchives, libmpq archive handles can not be read from several threads at once.
+void RunParallel(size_t count, std::function<void()> const& openArchives, std::function<void(size_t)> const& job)
+{
+    if (CONF_threads <= 1 || count <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+            job(i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < CONF_threads; ++t)
+    {
+        workers.emplace_back([&]()
+        {
+            openArchives();
+
+            for (size_t i = next++; i < count; i = next++)
+                job(i);
+
+            CloseMPQFiles();
+        });
+    }
+
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+// FNV-1a, used to detect map tiles which do not need to be converted again
+uint64 HashData(uint64 hash, void const* data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<uint8 const*>(data)[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// everything besides the tile itself which changes the converted map file
+uint64 GetConversionHash(uint32 build)
+{
+    uint64 hash = 0xCBF29CE484222325ULL;
+    hash = HashData(hash, MAP_VERSION_MAGIC, 4);
+    hash = HashData(hash, &build, sizeof(build));
+    hash = HashData(hash, &CONF_allow_height_limit, sizeof(CONF_allow_height_limit));
+    hash = HashData(hash, &CONF_use_minHeight, sizeof(CONF_use_minHeight));
+    hash = HashData(hash, &CONF_allow_float_to_int, sizeof(CONF_allow_float_to_int));
+    hash = HashData(hash, areas, (maxAreaId + 1) * sizeof(uint16));
+    hash = HashData(hash, LiqType, (maxLiqTypeId + 1) * sizeof(uint16));
+    return hash;
+}
+
+struct MapTile
+{
+    uint32 map;                                             // index in map_ids
+    uint32 x;
+    uint32 y;
+    uint64 hash;                                            // of the source tile, 0 if it could not be loaded
+};
+
+static char const* TILE_HASH_FILE = "tiles.hash";
+
+void LoadTileHashes(std::map<std::string, uint64>& hashes)
+{
+    std::string filename = std::string(output_path) + "/maps/" + TILE_HASH_FILE;
+    FILE* input = fopen(filename.c_str(), "r");
+    if (!input)
+        return;
+
+    char name[64];
+    unsigned long long hash;
+    while (fscanf(input, "%63s %llx", name, &hash) == 2)
+        hashes[name] = hash;
+
+    fclose(input);
+}
+
+void SaveTileHashes(std::vector<MapTile> const& tiles)
+{
+    std::string filename = std::string(output_path) + "/maps/" + TILE_HASH_FILE;
+    FILE* output = fopen(filename.c_str(), "w");
+    if (!output)
+    {
+        printf("Can't create the output file '%s'\n", filename.c_str());
+        return;
+    }
+
+    for (MapTile const& tile : tiles)
+        if (tile.hash)
+            fprintf(output, "%03u%02u%02u.map %016llx\n", map_ids[tile.map].id, tile.y, tile.x, (unsigned long long)tile.hash);
+
+    fclose(output);
+}
+
+void ExtractMapsFromMpq(uint32 build, int locale)
 {
-    char mpq_filename[1024];
-    char output_filename[1024];
     char mpq_map_name[1024];
 
     printf("Extracting maps...\n");
@@ -881,10 +1045,10 @@ void ExtractMapsFromMpq(uint32 build)
     path += "/maps/";
     CreateDir(path);
 
-    printf("Convert map files\n");
+    // collect the tiles of all maps first, they are converted in any order
+    std::vector<MapTile> tiles;
     for (uint32 z = 0; z < map_count; ++z)
     {
-        printf("Extract %s (%d/%d)                  \n", map_ids[z].name, z + 1, map_count);
         // Loadup map grid data
         sprintf(mpq_map_name, "World\\Maps\\%s\\%s.wdt", map_ids[z].name, map_ids[z].name);
         WDT_file wdt;
@@ -895,19 +1059,61 @@ void ExtractMapsFromMpq(uint32 build)
         }
 
         for (uint32 y = 0; y < WDT_MAP_SIZE; ++y)
-        {
             for (uint32 x = 0; x < WDT_MAP_SIZE; ++x)
-            {
-                if (!wdt.main->adt_list[y][x].exist)
-                    continue;
-                sprintf(mpq_filename, "World\\Maps\\%s\\%s_%u_%u.adt", map_ids[z].name, map_ids[z].name, x, y);
-                sprintf(output_filename, "%s/maps/%03u%02u%02u.map", output_path, map_ids[z].id, y, x);
-                ConvertADT(mpq_filename, output_filename, y, x, build);
-            }
-            // draw progress bar
-            printf("Processing........................%d%%\r", (100 * (y + 1)) / WDT_MAP_SIZE);
-        }
+                if (wdt.main->adt_list[y][x].exist)
+                    tiles.push_back({ z, x, y, 0 });
     }
+
+    std::map<std::string, uint64> oldHashes;
+    if (CONF_incremental)
+        LoadTileHashes(oldHashes);
+
+    uint64 const conversionHash = GetConversionHash(build);
+
+    std::atomic<uint32> processed(0);
+    std::atomic<uint32> skipped(0);
+    std::atomic<int> lastPercent(-1);
+
+    printf("Convert %u map tiles using %d thread(s)\n", uint32(tiles.size()), CONF_threads);
+    RunParallel(tiles.size(), [locale]()
+    {
+        LoadLocaleMPQFiles(locale);
+        LoadCommonMPQFiles();
+    }, [&](size_t index)
+    {
+        MapTile& tile = tiles[index];
+        char mpq_filename[1024];
+        char output_filename[1024];
+        char output_name[64];
+
+        sprintf(mpq_filename, "World\\Maps\\%s\\%s_%u_%u.adt", map_ids[tile.map].name, map_ids[tile.map].name, tile.x, tile.y);
+        sprintf(output_name, "%03u%02u%02u.map", map_ids[tile.map].id, tile.y, tile.x);
+        sprintf(output_filename, "%s/maps/%s", output_path, output_name);
+
+        ADT_file adt;
+        if (adt.loadFile(mpq_filename))
+        {
+            tile.hash = HashData(conversionHash, adt.GetData(), adt.GetDataSize());
+
+            auto const itr = oldHashes.find(output_name);
+            if (itr != oldHashes.end() && itr->second == tile.hash && FileExists(output_filename))
+                ++skipped;
+            else
+                ConvertADT(adt, mpq_filename, output_filename, tile.y, tile.x, build);
+        }
+
+        // draw progress bar
+        int const percent = int(100 * uint64(++processed) / tiles.size());
+        int last = lastPercent;
+        if (percent > last && lastPercent.compare_exchange_strong(last, percent))
+            printf("Processing........................%d%%\r", percent);
+    });
+
+    if (CONF_incremental)
+        printf("\nSkipped %u unchanged map tiles\n", uint32(skipped));
+
+    SaveTileHashes(tiles);
+
     delete [] areas;
     delete [] map_ids;
 }
@@ -932,7 +1138,7 @@ void ExtractDBCFiles(int locale, bool basicLocale)
 {
     printf("Extracting dbc files...\n");
 
-    std::set<std::string> dbcfiles;
+    std::set<std::string> dbcfileset;
 
     // get DBC file list
     for (ArchiveSet::iterator i = gOpenArchives.begin(); i != gOpenArchives.end(); ++i)
@@ -941,7 +1147,7 @@ void ExtractDBCFiles(int locale, bool basicLocale)
         (*i)->GetFileListTo(files);
         for (vector<string>::iterator iter = files.begin(); iter != files.end(); ++iter)
             if (iter->rfind(".dbc") == iter->length() - strlen(".dbc"))
-                dbcfiles.insert(*iter);
+                dbcfileset.insert(*iter);
     }
 
     std::string path = output_path;
@@ -963,16 +1169,17 @@ void ExtractDBCFiles(int locale, bool basicLocale)
     }
 
     // extract DBCs
-    int count = 0;
-    for (set<string>::iterator iter = dbcfiles.begin(); iter != dbcfiles.end(); ++iter)
+    std::vector<std::string> dbcfiles(dbcfileset.begin(), dbcfileset.end());
+    std::atomic<int> count(0);
+    RunParallel(dbcfiles.size(), [locale]() { LoadLocaleMPQFiles(locale); }, [&](size_t index)
     {
         string filename = path;
-        filename += (iter->c_str() + strlen("DBFilesClient\\"));
+        filename += (dbcfiles[index].c_str() + strlen("DBFilesClient\\"));
 
-        if (ExtractFile(iter->c_str(), filename))
+        if (ExtractFile(dbcfiles[index].c_str(), filename))
             ++count;
-    }
-    printf("Extracted %u DBC files\n\n", count);
+    });
+    printf("Extracted %u DBC files\n\n", int(count));
 }
 
 void ExtractCameraFiles(int locale, bool basicLocale)
@@ -1025,43 +1232,6 @@ void ExtractCameraFiles(int locale, bool basicLocale)
     printf("Extracted %u camera files\n", count);
 }
 
-void LoadLocaleMPQFiles(int const locale)
-{
-    char filename[512];
-
-    sprintf(filename, "%s/Data/%s/locale-%s.MPQ", input_path, langs[locale], langs[locale]);
-    new MPQArchive(filename);
-
-    for (int i = 1; i < 5; ++i)
-    {
-        char ext[3] = "";
-        if (i > 1)
-            sprintf(ext, "-%i", i);
-
-        sprintf(filename, "%s/Data/%s/patch-%s%s.MPQ", input_path, langs[locale], langs[locale], ext);
-        if (FileExists(filename))
-            new MPQArchive(filename);
-    }
-}
-
-void LoadCommonMPQFiles()
-{
-    char filename[512];
-    int count = sizeof(CONF_mpq_list) / sizeof(char*);
-    for (int i = 0; i < count; ++i)
-    {
-        sprintf(filename, "%s/Data/%s", input_path, CONF_mpq_list[i]);
-        if (FileExists(filename))
-            new MPQArchive(filename);
-    }
-}
-
-inline void CloseMPQFiles()
-{
-    for (ArchiveSet::iterator j = gOpenArchives.begin(); j != gOpenArchives.end(); ++j)(*j)->close();
-    gOpenArchives.clear();
-}
-
 int main(int argc, char* arg[])
 {
     printf("Map & DBC Extractor\n");
@@ -1135,7 +1305,7 @@ int main(int argc, char* arg[])
         LoadCommonMPQFiles();
 
         // Extract maps
-        ExtractMapsFromMpq(build);
+        ExtractMapsFromMpq(build, FirstLocale);
 
         // Close MPQs
         CloseMPQFiles();
@@ -2,7 +2,8 @@
 #include <deque>
 #include <cstdio>
 
-ArchiveSet gOpenArchives;
+// each extraction thread opens its own archives
+thread_local ArchiveSet gOpenArchives;
 
 MPQArchive::MPQArchive(const char* filename)
 {
@@ -0,0 +1,856 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LoadClient.h"
+#include "Spells/SpellTargetDefines.h"
+
+#include <zlib.h>
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    // realmd commands, see src/realmd/AuthCodes.h
+    uint8 const REALM_CMD_LOGON_CHALLENGE   = 0x00;
+    uint8 const REALM_CMD_LOGON_PROOF       = 0x01;
+    uint8 const REALM_CMD_REALM_LIST        = 0x10;
+
+    // B, g length, g, N length, N, salt, version challenge and security flags
+    size_t const LOGON_CHALLENGE_SIZE       = 32 + 1 + 1 + 1 + 32 + 32 + 16 + 1;
+    // M2, account flags, survey id and unknown flags
+    size_t const LOGON_PROOF_SIZE           = 20 + 4 + 4 + 2;
+
+    uint32 const UPDATE_INTERVAL            = 100;      // ms between two behaviour updates
+    uint32 const LOGIN_TIMEOUT              = 60000;    // ms from realmd connect to entering the world
+    uint32 const REQUEST_TIMEOUT            = 10000;    // ms after which an unanswered query is given up
+    uint32 const MOVE_DURATION              = 2000;     // ms a client runs before stopping again
+    uint32 const HEARTBEAT_INTERVAL         = 500;
+    float const RUN_SPEED                   = 7.0f;
+
+    // fingerprint addon the server expects in every auth session, see AddonHandler.cpp
+    char const* const ADDON_NAME            = "Blizzard_AuctionUI";
+    uint32 const ADDON_MODULUS_CRC          = 0x4C1C776D;
+
+    std::string ToUpper(std::string value)
+    {
+        for (char& c : value)
+            c = char(std::toupper(static_cast<unsigned char>(c)));
+        return value;
+    }
+}
+
+LoadClient::LoadClient(boost::asio::io_context& context, LoadConfig const& config, LoadStats& stats, uint32 accountIndex) :
+    m_context(context), m_socket(context), m_timer(context), m_config(config), m_stats(stats), m_random(accountIndex),
+    m_state(STATE_IDLE), m_account(ToUpper(config.accountPrefix + std::to_string(accountIndex))), m_accountIndex(accountIndex),
+    m_writing(false), m_guid(0), m_mapId(0), m_x(0.0f), m_y(0.0f), m_z(0.0f), m_o(0.0f), m_castCount(0), m_chatCount(0),
+    m_moving(false), m_pingPending(false), m_queryPending(false), m_auctionPending(false), m_pingSequence(0)
+{
+}
+
+void LoadClient::Start(Clock::duration delay)
+{
+    auto self = shared_from_this();
+    m_timer.expires_after(delay);
+    m_timer.async_wait([self](boost::system::error_code const& error)
+    {
+        if (!error && self->m_state == STATE_IDLE)
+            self->ConnectRealm();
+    });
+}
+
+void LoadClient::Stop()
+{
+    auto self = shared_from_this();
+    boost::asio::post(m_context, [self]()
+    {
+        if (self->m_state == STATE_IN_WORLD)
+            self->m_stats.ChangeOnline(-1);
+
+        self->m_state = STATE_CLOSED;
+        self->m_timer.cancel();
+        boost::system::error_code error;
+        self->m_socket.close(error);
+    });
+}
+
+void LoadClient::Fail(char const* reason)
+{
+    if (m_state == STATE_CLOSED)
+        return;
+
+    if (m_state == STATE_IN_WORLD)
+    {
+        m_stats.ChangeOnline(-1);
+        m_stats.Add(COUNTER_DISCONNECTS);
+    }
+    else
+        m_stats.Add(COUNTER_LOGIN_FAILURES);
+
+    fprintf(stderr, "%s: %s\n", m_account.c_str(), reason);
+
+    m_state = STATE_CLOSED;
+    m_timer.cancel();
+    boost::system::error_code error;
+    m_socket.close(error);
+}
+
+uint32 LoadClient::GetClientTime() const
+{
+    return uint32(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_startTime).count());
+}
+
+LoadClient::Clock::time_point LoadClient::Jittered(Clock::time_point now, uint32 interval)
+{
+    return now + std::chrono::milliseconds(interval ? m_random() % interval : 0);
+}
+
+void LoadClient::ReadExactly(size_t length, void (LoadClient::*handler)())
+{
+    auto self = shared_from_this();
+    m_readBuffer.resize(length);
+    boost::asio::async_read(m_socket, boost::asio::buffer(m_readBuffer), [self, handler](boost::system::error_code const& error, size_t /*length*/)
+    {
+        if (!self->IsOpen())
+            return;
+
+        if (error)
+            return self->Fail("realmd connection lost");
+
+        ((*self).*handler)();
+    });
+}
+
+void LoadClient::SendRaw(std::vector<uint8>&& data)
+{
+    m_writeQueue.push_back(std::move(data));
+    if (!m_writing)
+        FlushWrites();
+}
+
+void LoadClient::FlushWrites()
+{
+    if (m_writeQueue.empty() || !IsOpen())
+    {
+        m_writing = false;
+        return;
+    }
+
+    m_writing = true;
+    auto self = shared_from_this();
+    boost::asio::async_write(m_socket, boost::asio::buffer(m_writeQueue.front()), [self](boost::system::error_code const& error, size_t /*length*/)
+    {
+        self->m_writeQueue.pop_front();
+        if (error)
+        {
+            self->m_writing = false;
+            return self->Fail("write failed");
+        }
+
+        self->FlushWrites();
+    });
+}
+
+//////////////////////////////////////////////////////////////////////////
+// realmd
+
+void LoadClient::ConnectRealm()
+{
+    m_state = STATE_REALM;
+    m_startTime = Clock::now();
+
+    auto self = shared_from_this();
+    m_timer.expires_after(std::chrono::milliseconds(LOGIN_TIMEOUT));
+    m_timer.async_wait([self](boost::system::error_code const& error)
+    {
+        if (!error && self->IsOpen() && self->m_state != STATE_IN_WORLD)
+            self->Fail("login timed out");
+    });
+
+    m_socket.async_connect(m_config.realmd, [self](boost::system::error_code const& error)
+    {
+        if (!self->IsOpen())
+            return;
+
+        if (error)
+            return self->Fail("cannot connect to realmd");
+
+        self->SendLogonChallenge();
+    });
+}
+
+void LoadClient::SendLogonChallenge()
+{
+    // layout of sAuthLogonChallenge_C, the four character codes are sent reversed
+    ByteBuffer pkt;
+    pkt << uint8(REALM_CMD_LOGON_CHALLENGE);
+    pkt << uint8(0x08);                                     // protocol version
+    pkt << uint16(30 + m_account.size());
+    pkt.append("WoW", 4);
+    pkt << uint8(3) << uint8(3) << uint8(5);
+    pkt << uint16(m_config.build);
+    pkt.append("68x", 4);
+    pkt.append("niW", 4);
+    pkt.append("SUne", 4);
+    pkt << uint32(0);                                       // timezone bias
+    pkt << uint32(0x0100007F);                              // client ip
+    pkt << uint8(m_account.size());
+    pkt.append(m_account.c_str(), m_account.size());
+
+    SendRaw(std::vector<uint8>(pkt.contents(), pkt.contents() + pkt.size()));
+    ReadExactly(3, &LoadClient::HandleLogonChallengeResult);
+}
+
+void LoadClient::HandleLogonChallengeResult()
+{
+    if (m_readBuffer[0] != REALM_CMD_LOGON_CHALLENGE || m_readBuffer[2] != 0)
+        return Fail("logon challenge rejected, check account name and client build");
+
+    ReadExactly(LOGON_CHALLENGE_SIZE, &LoadClient::HandleLogonChallenge);
+}
+
+void LoadClient::HandleLogonChallenge()
+{
+    uint8* const B = &m_readBuffer[0];
+    uint8 const gLength = m_readBuffer[32];
+    uint8 const NLength = m_readBuffer[34];
+    uint8* const salt = &m_readBuffer[67];
+    uint8 const securityFlags = m_readBuffer[115];
+
+    if (gLength != 1 || NLength != 32)
+        return Fail("unexpected SRP6 parameters");
+
+    if (securityFlags)
+        return Fail("accounts with PIN, matrix or authenticator are not supported");
+
+    Sha1Hash credentials;
+    credentials.UpdateData(m_account + ":" + ToUpper(m_config.password));
+    credentials.Finalize();
+
+    m_srp.SetSalt(salt, 32);
+    m_srp.CalculateClientPublicEphemeral();
+    if (!m_srp.CalculateClientSessionKey(B, 32, credentials.GetDigest()))
+        return Fail("invalid host public ephemeral");
+
+    m_srp.HashSessionKey();
+    m_srp.CalculateProof(m_account);
+
+    // layout of sAuthLogonProof_C
+    ByteBuffer pkt;
+    pkt << uint8(REALM_CMD_LOGON_PROOF);
+    pkt.append(m_srp.GetClientPublicEphemeral().AsByteArray(32));
+    pkt.append(m_srp.GetProof().AsByteArray(20));
+    pkt.append(std::vector<uint8>(20, 0));                  // crc hash, not checked by realmd
+    pkt << uint8(0);                                        // number of keys
+    pkt << uint8(0);                                        // security flags
+
+    SendRaw(std::vector<uint8>(pkt.contents(), pkt.contents() + pkt.size()));
+    ReadExactly(2, &LoadClient::HandleLogonProofResult);
+}
+
+void LoadClient::HandleLogonProofResult()
+{
+    if (m_readBuffer[0] != REALM_CMD_LOGON_PROOF || m_readBuffer[1] != 0)
+        return Fail("logon proof rejected, check password");
+
+    ReadExactly(LOGON_PROOF_SIZE, &LoadClient::HandleLogonProof);
+}
+
+void LoadClient::HandleLogonProof()
+{
+    Sha1Hash sha;
+    m_srp.Finalize(sha);
+    if (memcmp(sha.GetDigest(), &m_readBuffer[0], Sha1Hash::GetLength()))
+        return Fail("realmd sent a wrong server proof");
+
+    uint8 const request[5] = { REALM_CMD_REALM_LIST, 0, 0, 0, 0 };
+    SendRaw(std::vector<uint8>(request, request + sizeof(request)));
+    ReadExactly(3, &LoadClient::HandleRealmListHeader);
+}
+
+void LoadClient::HandleRealmListHeader()
+{
+    if (m_readBuffer[0] != REALM_CMD_REALM_LIST)
+        return Fail("unexpected realm list reply");
+
+    uint16 const size = uint16(m_readBuffer[1] | (m_readBuffer[2] << 8));
+    ReadExactly(size, &LoadClient::HandleRealmList);
+}
+
+void LoadClient::HandleRealmList()
+{
+    ByteBuffer data;
+    data.append(m_readBuffer);
+
+    std::string address;
+    try
+    {
+        uint16 count;
+        data.read_skip<uint32>();
+        data >> count;
+
+        for (uint16 i = 0; i < count; ++i)
+        {
+            uint8 icon, lock, flags, characters, timezone, id;
+            std::string name, realmAddress;
+            float population;
+
+            data >> icon >> lock >> flags >> name >> realmAddress >> population >> characters >> timezone >> id;
+            if (flags & REALM_FLAG_SPECIFYBUILD)
+                data.read_skip(5);                          // major, minor and bugfix version, build
+
+            if (lock || (flags & REALM_FLAG_OFFLINE))
+                continue;
+
+            if (!m_config.realmName.empty() && name != m_config.realmName)
+                continue;
+
+            address = realmAddress;
+            break;
+        }
+    }
+    catch (ByteBufferException const&)
+    {
+        return Fail("malformed realm list");
+    }
+
+    if (address.empty())
+        return Fail("no matching online realm");
+
+    boost::system::error_code error;
+    m_socket.close(error);
+    ConnectWorld(address);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// world server
+
+void LoadClient::ConnectWorld(std::string const& address)
+{
+    m_state = STATE_WORLD_AUTH;
+
+    std::string host = address;
+    std::string port = "8085";
+    size_t const separator = address.rfind(':');
+    if (separator != std::string::npos)
+    {
+        host = address.substr(0, separator);
+        port = address.substr(separator + 1);
+    }
+
+    boost::system::error_code error;
+    boost::asio::ip::tcp::resolver resolver(m_context);
+    auto const endpoints = resolver.resolve(host, port, error);
+    if (error)
+        return Fail("cannot resolve world server address");
+
+    auto self = shared_from_this();
+    boost::asio::async_connect(m_socket, endpoints, [self](boost::system::error_code const& error, boost::asio::ip::tcp::endpoint const& /*endpoint*/)
+    {
+        if (!self->IsOpen())
+            return;
+
+        if (error)
+            return self->Fail("cannot connect to world server");
+
+        self->ReadWorldHeader();
+    });
+}
+
+void LoadClient::ReadWorldHeader()
+{
+    // the first byte tells whether a 4 or 5 byte header follows, so decrypt it alone
+    auto self = shared_from_this();
+    m_readBuffer.resize(5);
+    boost::asio::async_read(m_socket, boost::asio::buffer(m_readBuffer.data(), 1), [self](boost::system::error_code const& error, size_t /*length*/)
+    {
+        if (!self->IsOpen())
+            return;
+
+        if (error)
+            return self->Fail("world server connection lost");
+
+        // the server encrypts with its send stream, which is our receive stream
+        self->m_crypt.EncryptSend(&self->m_readBuffer[0], 1);
+        self->ReadWorldHeaderTail((self->m_readBuffer[0] & 0x80) ? 4 : 3);
+    });
+}
+
+void LoadClient::ReadWorldHeaderTail(size_t length)
+{
+    auto self = shared_from_this();
+    boost::asio::async_read(m_socket, boost::asio::buffer(&m_readBuffer[1], length), [self, length](boost::system::error_code const& error, size_t /*length*/)
+    {
+        if (!self->IsOpen())
+            return;
+
+        if (error)
+            return self->Fail("world server connection lost");
+
+        self->m_crypt.EncryptSend(&self->m_readBuffer[1], length);
+
+        // big endian size including the opcode, little endian opcode, see ServerPktHeader
+        uint8 const* header = self->m_readBuffer.data();
+        uint32 size;
+        uint16 opcode;
+        if (length == 4)
+        {
+            size = ((header[0] & 0x7F) << 16) | (header[1] << 8) | header[2];
+            opcode = uint16(header[3] | (header[4] << 8));
+        }
+        else
+        {
+            size = (header[0] << 8) | header[1];
+            opcode = uint16(header[2] | (header[3] << 8));
+        }
+
+        if (size < 2)
+            return self->Fail("malformed world packet header");
+
+        self->m_stats.Add(COUNTER_PACKETS_RECEIVED);
+        self->m_stats.Add(COUNTER_BYTES_RECEIVED, 1 + length + size - 2);
+        self->ReadWorldBody(size - 2, opcode);
+    });
+}
+
+void LoadClient::ReadWorldBody(uint32 size, uint16 opcode)
+{
+    if (!size)
+    {
+        WorldPacket packet(Opcodes(opcode), 0);
+        HandleWorldPacket(packet);
+        if (IsOpen())
+            ReadWorldHeader();
+        return;
+    }
+
+    auto self = shared_from_this();
+    m_readBuffer.resize(size);
+    boost::asio::async_read(m_socket, boost::asio::buffer(m_readBuffer), [self, opcode](boost::system::error_code const& error, size_t /*length*/)
+    {
+        if (!self->IsOpen())
+            return;
+
+        if (error)
+            return self->Fail("world server connection lost");
+
+        WorldPacket packet(Opcodes(opcode), self->m_readBuffer.size());
+        packet.append(self->m_readBuffer);
+
+        try
+        {
+            self->HandleWorldPacket(packet);
+        }
+        catch (ByteBufferException const&)
+        {
+            return self->Fail("malformed world packet");
+        }
+
+        if (self->IsOpen())
+            self->ReadWorldHeader();
+    });
+}
+
+void LoadClient::SendWorldPacket(WorldPacket const& packet)
+{
+    // big endian size including the opcode, little endian 32 bit opcode, see ClientPktHeader
+    uint16 const size = uint16(packet.size() + 4);
+    uint32 const opcode = packet.GetOpcode();
+
+    std::vector<uint8> data(6 + packet.size());
+    data[0] = uint8(size >> 8);
+    data[1] = uint8(size);
+    data[2] = uint8(opcode);
+    data[3] = uint8(opcode >> 8);
+    data[4] = uint8(opcode >> 16);
+    data[5] = uint8(opcode >> 24);
+
+    // the server decrypts with its receive stream, which is our send stream
+    m_crypt.DecryptRecv(data.data(), 6);
+    if (!packet.empty())
+        memcpy(&data[6], packet.contents(), packet.size());
+
+    m_stats.Add(COUNTER_PACKETS_SENT);
+    m_stats.Add(COUNTER_BYTES_SENT, data.size());
+    SendRaw(std::move(data));
+}
+
+void LoadClient::HandleWorldPacket(WorldPacket& packet)
+{
+    switch (packet.GetOpcode())
+    {
+        case SMSG_AUTH_CHALLENGE:       HandleAuthChallenge(packet); break;
+        case SMSG_AUTH_RESPONSE:        HandleAuthResponse(packet); break;
+        case SMSG_CHAR_ENUM:            HandleCharEnum(packet); break;
+        case SMSG_CHAR_CREATE:          HandleCharCreate(packet); break;
+        case SMSG_LOGIN_VERIFY_WORLD:   HandleLoginVerifyWorld(packet); break;
+        case SMSG_TIME_SYNC_REQ:        HandleTimeSyncRequest(packet); break;
+        case SMSG_PONG:
+            if (m_pingPending)
+            {
+                m_pingPending = false;
+                m_stats.AddSample(LATENCY_PING, Clock::now() - m_pingSent);
+            }
+            break;
+        case SMSG_NAME_QUERY_RESPONSE:
+            if (m_queryPending)
+            {
+                m_queryPending = false;
+                m_stats.AddSample(LATENCY_WORLD, Clock::now() - m_querySent);
+            }
+            break;
+        case SMSG_AUCTION_LIST_RESULT:
+            if (m_auctionPending)
+            {
+                m_auctionPending = false;
+                m_stats.AddSample(LATENCY_AUCTION, Clock::now() - m_auctionSent);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void LoadClient::HandleAuthChallenge(WorldPacket& packet)
+{
+    uint32 serverSeed;
+    packet.read_skip<uint32>();
+    packet >> serverSeed;
+
+    uint32 const clientSeed = m_random();
+    BigNumber K = m_srp.GetStrongSessionKey();
+
+    // same digest as checked in WorldSocket::HandleAuthSession
+    uint32 const t = 0;
+    Sha1Hash sha;
+    sha.UpdateData(m_account);
+    sha.UpdateData((uint8 const*)&t, 4);
+    sha.UpdateData((uint8 const*)&clientSeed, 4);
+    sha.UpdateData((uint8 const*)&serverSeed, 4);
+    sha.UpdateBigNumbers(&K, nullptr);
+    sha.Finalize();
+
+    WorldPacket auth(CMSG_AUTH_SESSION, 128);
+    auth << uint32(m_config.build);
+    auth << uint32(0);                                      // login server id
+    auth << m_account;
+    auth << uint32(0);                                      // login server type
+    auth << clientSeed;
+    auth << uint32(0);                                      // region id
+    auth << uint32(0);                                      // battlegroup id
+    auth << uint32(0);                                      // realm id
+    auth << uint64(0);                                      // dos response
+    auth.append(sha.GetDigest(), Sha1Hash::GetLength());
+
+    // the server kicks sessions without addon data, send the single fingerprint addon
+    ByteBuffer addons;
+    addons << uint32(1);
+    addons << ADDON_NAME << uint8(1) << ADDON_MODULUS_CRC << uint32(0);
+
+    uLongf compressedSize = compressBound(addons.size());
+    std::vector<uint8> compressed(compressedSize);
+    if (compress(compressed.data(), &compressedSize, addons.contents(), addons.size()) != Z_OK)
+        return Fail("cannot compress addon data");
+
+    auth << uint32(addons.size());
+    auth.append(compressed.data(), compressedSize);
+
+    SendWorldPacket(auth);
+
+    // everything after the session packet is encrypted in both directions
+    m_crypt.Init(&K);
+}
+
+void LoadClient::HandleAuthResponse(WorldPacket& packet)
+{
+    uint8 code;
+    packet >> code;
+
+    if (code == AUTH_WAIT_QUEUE)
+        return;                                             // another response follows once we leave the queue
+
+    if (code != AUTH_OK)
+        return Fail("world server rejected the session");
+
+    SendCharEnum();
+}
+
+void LoadClient::SendCharEnum()
+{
+    m_state = STATE_CHAR_ENUM;
+    WorldPacket data(CMSG_CHAR_ENUM, 0);
+    SendWorldPacket(data);
+}
+
+void LoadClient::HandleCharEnum(WorldPacket& packet)
+{
+    uint8 count;
+    packet >> count;
+
+    if (count)
+    {
+        // only the guid of the first character is needed
+        packet >> m_guid;
+
+        m_state = STATE_LOGIN;
+        WorldPacket data(CMSG_PLAYER_LOGIN, 8);
+        data << m_guid;
+        SendWorldPacket(data);
+        return;
+    }
+
+    // names only allow letters, so spell the account index with them
+    std::string name = "Lt";
+    uint32 value = m_accountIndex;
+    do
+    {
+        name += char('a' + value % 26);
+        value /= 26;
+    }
+    while (value);
+
+    m_state = STATE_CHAR_CREATE;
+    WorldPacket data(CMSG_CHAR_CREATE, 32);
+    data << name;
+    data << uint8(RACE_HUMAN) << uint8(CLASS_WARRIOR) << uint8(GENDER_MALE);
+    data << uint8(0) << uint8(0);                           // skin, face
+    data << uint8(0) << uint8(0) << uint8(0);               // hair style, hair color, facial hair
+    data << uint8(0);                                       // outfit id
+    SendWorldPacket(data);
+}
+
+void LoadClient::HandleCharCreate(WorldPacket& packet)
+{
+    uint8 result;
+    packet >> result;
+
+    if (result != CHAR_CREATE_SUCCESS)
+        return Fail("character creation failed");
+
+    SendCharEnum();
+}
+
+void LoadClient::HandleLoginVerifyWorld(WorldPacket& packet)
+{
+    packet >> m_mapId >> m_x >> m_y >> m_z >> m_o;
+
+    // also sent after teleports, only the first one completes the login
+    if (m_state == STATE_IN_WORLD)
+        return;
+
+    m_state = STATE_IN_WORLD;
+    m_stats.Add(COUNTER_LOGINS);
+    m_stats.ChangeOnline(1);
+    m_stats.AddSample(LATENCY_LOGIN, Clock::now() - m_startTime);
+
+    // spread the first action of every kind so the swarm does not act in lockstep
+    Clock::time_point const now = Clock::now();
+    m_nextMove = Jittered(now, m_config.moveInterval);
+    m_nextChat = Jittered(now, m_config.chatInterval);
+    m_nextCast = Jittered(now, m_config.castInterval);
+    m_nextAuction = Jittered(now, m_config.auctionInterval);
+    m_nextQuery = Jittered(now, m_config.queryInterval);
+    m_nextPing = Jittered(now, m_config.pingInterval);
+
+    ScheduleUpdate();
+}
+
+void LoadClient::HandleTimeSyncRequest(WorldPacket& packet)
+{
+    uint32 counter;
+    packet >> counter;
+
+    WorldPacket data(CMSG_TIME_SYNC_RESP, 8);
+    data << counter;
+    data << GetClientTime();
+    SendWorldPacket(data);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// behaviour
+
+void LoadClient::ScheduleUpdate()
+{
+    auto self = shared_from_this();
+    m_timer.expires_after(std::chrono::milliseconds(UPDATE_INTERVAL));
+    m_timer.async_wait([self](boost::system::error_code const& error)
+    {
+        if (error || self->m_state != STATE_IN_WORLD)
+            return;
+
+        self->Update();
+        self->ScheduleUpdate();
+    });
+}
+
+void LoadClient::Update()
+{
+    Clock::time_point const now = Clock::now();
+    std::chrono::milliseconds const timeout(REQUEST_TIMEOUT);
+
+    if (m_config.moveInterval)
+        UpdateMovement(now);
+
+    if (m_config.chatInterval && now >= m_nextChat)
+    {
+        SendChat();
+        m_nextChat = now + std::chrono::milliseconds(m_config.chatInterval);
+    }
+
+    if (m_config.castInterval && now >= m_nextCast)
+    {
+        SendCast();
+        m_nextCast = now + std::chrono::milliseconds(m_config.castInterval);
+    }
+
+    if (m_config.auctionInterval && now >= m_nextAuction && (!m_auctionPending || now - m_auctionSent > timeout))
+    {
+        SendAuctionQuery();
+        m_nextAuction = now + std::chrono::milliseconds(m_config.auctionInterval);
+    }
+
+    if (m_config.queryInterval && now >= m_nextQuery && (!m_queryPending || now - m_querySent > timeout))
+    {
+        SendNameQuery();
+        m_nextQuery = now + std::chrono::milliseconds(m_config.queryInterval);
+    }
+
+    if (m_config.pingInterval && now >= m_nextPing && (!m_pingPending || now - m_pingSent > timeout))
+    {
+        SendPing();
+        m_nextPing = now + std::chrono::milliseconds(m_config.pingInterval);
+    }
+}
+
+void LoadClient::UpdateMovement(Clock::time_point now)
+{
+    if (!m_moving)
+    {
+        if (now < m_nextMove)
+            return;
+
+        m_moving = true;
+        m_lastMoveUpdate = now;
+        m_moveStopTime = now + std::chrono::milliseconds(MOVE_DURATION);
+        m_nextHeartbeat = now + std::chrono::milliseconds(HEARTBEAT_INTERVAL);
+        m_stats.Add(COUNTER_MOVES);
+        SendMovement(MSG_MOVE_START_FORWARD);
+        return;
+    }
+
+    Clock::time_point const until = std::min(now, m_moveStopTime);
+    float const distance = RUN_SPEED * std::chrono::duration<float>(until - m_lastMoveUpdate).count();
+    m_x += std::cos(m_o) * distance;
+    m_y += std::sin(m_o) * distance;
+    m_lastMoveUpdate = until;
+
+    if (now >= m_moveStopTime)
+    {
+        m_moving = false;
+        SendMovement(MSG_MOVE_STOP);
+
+        // turn around so every client keeps running back and forth near its spawn point
+        m_o = std::fmod(m_o + M_PI_F, 2 * M_PI_F);
+        SendMovement(MSG_MOVE_SET_FACING);
+        m_nextMove = now + std::chrono::milliseconds(m_config.moveInterval);
+    }
+    else if (now >= m_nextHeartbeat)
+    {
+        SendMovement(MSG_MOVE_HEARTBEAT);
+        m_nextHeartbeat = now + std::chrono::milliseconds(HEARTBEAT_INTERVAL);
+    }
+}
+
+void LoadClient::SendMovement(Opcodes opcode)
+{
+    // packed guid followed by the fields read in MovementInfo::Read
+    WorldPacket data(opcode, 40);
+    data.appendPackGUID(m_guid);
+    data << uint32(m_moving ? MOVEFLAG_FORWARD : MOVEFLAG_NONE);
+    data << uint16(0);                                      // extra movement flags
+    data << GetClientTime();
+    data << m_x << m_y << m_z << m_o;
+    data << uint32(0);                                      // fall time
+    SendWorldPacket(data);
+}
+
+void LoadClient::SendChat()
+{
+    WorldPacket data(CMSG_MESSAGECHAT, 64);
+    data << uint32(CHAT_MSG_SAY);
+    data << uint32(LANG_COMMON);
+    data << ("load test message " + std::to_string(++m_chatCount));
+    m_stats.Add(COUNTER_CHATS);
+    SendWorldPacket(data);
+}
+
+void LoadClient::SendCast()
+{
+    WorldPacket data(CMSG_CAST_SPELL, 10);
+    data << uint8(++m_castCount);
+    data << uint32(m_config.spellId);
+    data << uint8(0);                                       // cast flags
+    data << uint32(TARGET_FLAG_SELF);
+    m_stats.Add(COUNTER_CASTS);
+    SendWorldPacket(data);
+}
+
+void LoadClient::SendAuctionQuery()
+{
+    // the own guid opens the auction house remotely, which needs access to the .auction command
+    WorldPacket data(CMSG_AUCTION_LIST_ITEMS, 40);
+    data << m_guid;
+    data << uint32(0);                                      // list from
+    data << std::string();                                  // searched name
+    data << uint8(0) << uint8(0);                           // level min, level max
+    data << uint32(0xFFFFFFFF);                             // inventory type
+    data << uint32(0xFFFFFFFF);                             // item class
+    data << uint32(0xFFFFFFFF);                             // item subclass
+    data << uint32(0xFFFFFFFF);                             // quality
+    data << uint8(0) << uint8(0);                           // usable, full list
+    data << uint8(0);                                       // sort column count
+
+    m_auctionPending = true;
+    m_auctionSent = Clock::now();
+    m_stats.Add(COUNTER_AUCTION_QUERIES);
+    SendWorldPacket(data);
+}
+
+void LoadClient::SendNameQuery()
+{
+    // handled during the world update, so the round trip includes the wait for the next tick
+    WorldPacket data(CMSG_NAME_QUERY, 8);
+    data << m_guid;
+
+    m_queryPending = true;
+    m_querySent = Clock::now();
+    SendWorldPacket(data);
+}
+
+void LoadClient::SendPing()
+{
+    // handled by the network thread, the round trip is the pure network latency
+    WorldPacket data(CMSG_PING, 8);
+    data << ++m_pingSequence;
+    data << uint32(0);                                      // latency
+
+    m_pingPending = true;
+    m_pingSent = Clock::now();
+    SendWorldPacket(data);
+}
@@ -0,0 +1,163 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _LOADTEST_LOADCLIENT_H
+#define _LOADTEST_LOADCLIENT_H
+
+#include "Common.h"
+#include "Auth/SRP6.h"
+#include "Server/AuthCrypt.h"
+#include "Server/WorldPacket.h"
+#include "LoadStats.h"
+
+#include <boost/asio.hpp>
+
+#include <deque>
+#include <memory>
+#include <random>
+
+struct LoadConfig
+{
+    boost::asio::ip::tcp::endpoint realmd;
+    std::string realmName;                                  // empty picks the first online realm
+    std::string accountPrefix;
+    std::string password;
+    uint32 firstAccount;
+    uint32 clients;
+    uint32 rampUpDelay;                                     // ms between two client logins
+    uint16 build;
+
+    // ms between two actions of the same kind per client, 0 disables the action
+    uint32 moveInterval;
+    uint32 chatInterval;
+    uint32 castInterval;
+    uint32 auctionInterval;
+    uint32 queryInterval;
+    uint32 pingInterval;
+
+    uint32 spellId;
+};
+
+// One scripted client: logs in through realmd, enters the world with its
+// character (created on first use) and then keeps walking, chatting, casting
+// and browsing the auction house until stopped. Every callback runs on the
+// owning io_context, so a client needs no locking of its own.
+class LoadClient : public std::enable_shared_from_this<LoadClient>
+{
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        LoadClient(boost::asio::io_context& context, LoadConfig const& config, LoadStats& stats, uint32 accountIndex);
+
+        void Start(Clock::duration delay);
+        void Stop();
+
+    private:
+        enum ClientState
+        {
+            STATE_IDLE,
+            STATE_REALM,                                    // realmd challenge, proof and realm list
+            STATE_WORLD_AUTH,
+            STATE_CHAR_ENUM,
+            STATE_CHAR_CREATE,
+            STATE_LOGIN,
+            STATE_IN_WORLD,
+            STATE_CLOSED
+        };
+
+        // realmd
+        void ConnectRealm();
+        void SendLogonChallenge();
+        void HandleLogonChallengeResult();
+        void HandleLogonChallenge();
+        void HandleLogonProofResult();
+        void HandleLogonProof();
+        void HandleRealmListHeader();
+        void HandleRealmList();
+
+        // world server
+        void ConnectWorld(std::string const& address);
+        void ReadWorldHeader();
+        void ReadWorldHeaderTail(size_t length);
+        void ReadWorldBody(uint32 size, uint16 opcode);
+        void HandleWorldPacket(WorldPacket& packet);
+        void HandleAuthChallenge(WorldPacket& packet);
+        void HandleAuthResponse(WorldPacket& packet);
+        void HandleCharEnum(WorldPacket& packet);
+        void HandleCharCreate(WorldPacket& packet);
+        void HandleLoginVerifyWorld(WorldPacket& packet);
+        void HandleTimeSyncRequest(WorldPacket& packet);
+        void SendCharEnum();
+
+        void SendWorldPacket(WorldPacket const& packet);
+        void SendRaw(std::vector<uint8>&& data);
+        void FlushWrites();
+
+        // scripted behaviour once in world
+        void ScheduleUpdate();
+        void Update();
+        void UpdateMovement(Clock::time_point now);
+        void SendMovement(Opcodes opcode);
+        void SendChat();
+        void SendCast();
+        void SendAuctionQuery();
+        void SendNameQuery();
+        void SendPing();
+
+        void ReadExactly(size_t length, void (LoadClient::*handler)());
+        void Fail(char const* reason);
+        bool IsOpen() const { return m_state != STATE_IDLE && m_state != STATE_CLOSED; }
+        uint32 GetClientTime() const;
+        Clock::time_point Jittered(Clock::time_point now, uint32 interval);
+
+        boost::asio::io_context& m_context;
+        boost::asio::ip::tcp::socket m_socket;
+        boost::asio::steady_timer m_timer;
+        LoadConfig const& m_config;
+        LoadStats& m_stats;
+        std::mt19937 m_random;
+
+        ClientState m_state;
+        std::string m_account;                              // upper case, as the client sends it
+        uint32 m_accountIndex;
+        Clock::time_point m_startTime;
+
+        SRP6 m_srp;
+        AuthCrypt m_crypt;
+        std::vector<uint8> m_readBuffer;
+        std::deque<std::vector<uint8>> m_writeQueue;
+        bool m_writing;
+
+        uint64 m_guid;
+        uint32 m_mapId;
+        float m_x, m_y, m_z, m_o;
+        uint8 m_castCount;
+        uint32 m_chatCount;
+
+        bool m_moving;
+        Clock::time_point m_moveStopTime;
+        Clock::time_point m_lastMoveUpdate;
+        Clock::time_point m_nextMove, m_nextHeartbeat, m_nextChat, m_nextCast, m_nextAuction, m_nextQuery, m_nextPing;
+
+        // one outstanding request per kind, the reply time gives the latency sample
+        Clock::time_point m_pingSent, m_querySent, m_auctionSent;
+        bool m_pingPending, m_queryPending, m_auctionPending;
+        uint32 m_pingSequence;
+};
+
+#endif
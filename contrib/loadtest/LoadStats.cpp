@@ -0,0 +1,147 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LoadStats.h"
+
+#include <algorithm>
+#include <cstdio>
+
+LoadStats::LoadStats(uint32 clients) : m_clients(clients), m_online(0), m_reportedElapsed(Clock::duration::zero()), m_lastPingAverage(0.0)
+{
+    for (uint32 i = 0; i < MAX_LOAD_COUNTER; ++i)
+    {
+        m_counters[i].store(0, std::memory_order_relaxed);
+        m_reported[i] = 0;
+    }
+}
+
+void LoadStats::AddSample(LoadLatency latency, Clock::duration elapsed)
+{
+    uint64 const micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    uint32 const sample = uint32(std::min<uint64>(micros, 0xFFFFFFFF));
+
+    std::lock_guard<std::mutex> guard(m_sampleLock);
+    m_samples[latency].push_back(sample);
+
+    LatencyTotals& totals = m_totals[latency];
+    ++totals.count;
+    totals.sum += sample;
+    totals.max = std::max(totals.max, sample);
+}
+
+LoadStats::Distribution LoadStats::Summarize(std::vector<uint32>& samples)
+{
+    Distribution result;
+    if (samples.empty())
+        return result;
+
+    std::sort(samples.begin(), samples.end());
+
+    uint64 sum = 0;
+    for (uint32 sample : samples)
+        sum += sample;
+
+    result.count = samples.size();
+    result.average = double(sum) / samples.size() / 1000.0;
+    result.p95 = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)] / 1000.0;
+    result.max = samples.back() / 1000.0;
+    return result;
+}
+
+// A query handled in the world update waits on average half a tick before it is
+// processed, so twice its delay over the plain network round trip approximates
+// how long one world tick takes. It is not exact; BUILD_METRICS reports the real value.
+double LoadStats::EstimateTick(Distribution const& ping, Distribution const& world)
+{
+    if (ping.count)
+        m_lastPingAverage = ping.average;
+
+    if (!world.count)
+        return 0.0;
+
+    return std::max(0.0, 2.0 * (world.average - m_lastPingAverage));
+}
+
+void LoadStats::Report(Clock::duration elapsed)
+{
+    Distribution distributions[MAX_LOAD_LATENCY];
+    {
+        std::lock_guard<std::mutex> guard(m_sampleLock);
+        for (uint32 i = 0; i < MAX_LOAD_LATENCY; ++i)
+        {
+            distributions[i] = Summarize(m_samples[i]);
+            m_samples[i].clear();
+        }
+    }
+
+    uint64 delta[MAX_LOAD_COUNTER];
+    for (uint32 i = 0; i < MAX_LOAD_COUNTER; ++i)
+    {
+        uint64 const current = m_counters[i].load(std::memory_order_relaxed);
+        delta[i] = current - m_reported[i];
+        m_reported[i] = current;
+    }
+
+    double seconds = std::chrono::duration<double>(elapsed - m_reportedElapsed).count();
+    m_reportedElapsed = elapsed;
+    if (seconds <= 0.0)
+        seconds = 1.0;
+
+    Distribution const& ping = distributions[LATENCY_PING];
+    Distribution const& world = distributions[LATENCY_WORLD];
+    Distribution const& auction = distributions[LATENCY_AUCTION];
+
+    printf("[%5us] online %d/%u | sent %.0f pkt/s %.1f KB/s | recv %.0f pkt/s %.1f KB/s | ping %.1f/%.1f ms | world %.1f/%.1f/%.1f ms | tick ~%.1f ms | auction %.1f/%.1f ms | actions %.0f/s | logins %lu failed %lu dropped %lu\n",
+           uint32(std::chrono::duration_cast<std::chrono::seconds>(elapsed).count()), GetOnline(), m_clients,
+           delta[COUNTER_PACKETS_SENT] / seconds, delta[COUNTER_BYTES_SENT] / seconds / 1024.0,
+           delta[COUNTER_PACKETS_RECEIVED] / seconds, delta[COUNTER_BYTES_RECEIVED] / seconds / 1024.0,
+           ping.average, ping.p95, world.average, world.p95, world.max, EstimateTick(ping, world), auction.average, auction.p95,
+           (delta[COUNTER_MOVES] + delta[COUNTER_CHATS] + delta[COUNTER_CASTS] + delta[COUNTER_AUCTION_QUERIES]) / seconds,
+           (unsigned long)delta[COUNTER_LOGINS], (unsigned long)delta[COUNTER_LOGIN_FAILURES], (unsigned long)delta[COUNTER_DISCONNECTS]);
+    fflush(stdout);
+}
+
+void LoadStats::Summary(Clock::duration elapsed)
+{
+    static char const* latencyNames[MAX_LOAD_LATENCY] = { "login", "ping", "world", "auction" };
+
+    double const seconds = std::max(1.0, std::chrono::duration<double>(elapsed).count());
+
+    printf("\nLoad test finished after %.0f seconds\n", seconds);
+    printf("  logins %lu, failed %lu, dropped %lu\n",
+           (unsigned long)m_counters[COUNTER_LOGINS].load(), (unsigned long)m_counters[COUNTER_LOGIN_FAILURES].load(),
+           (unsigned long)m_counters[COUNTER_DISCONNECTS].load());
+    printf("  sent %.0f pkt/s %.1f KB/s, received %.0f pkt/s %.1f KB/s\n",
+           m_counters[COUNTER_PACKETS_SENT].load() / seconds, m_counters[COUNTER_BYTES_SENT].load() / seconds / 1024.0,
+           m_counters[COUNTER_PACKETS_RECEIVED].load() / seconds, m_counters[COUNTER_BYTES_RECEIVED].load() / seconds / 1024.0);
+    printf("  moves %lu, chats %lu, casts %lu, auction queries %lu\n",
+           (unsigned long)m_counters[COUNTER_MOVES].load(), (unsigned long)m_counters[COUNTER_CHATS].load(),
+           (unsigned long)m_counters[COUNTER_CASTS].load(), (unsigned long)m_counters[COUNTER_AUCTION_QUERIES].load());
+
+    std::lock_guard<std::mutex> guard(m_sampleLock);
+    for (uint32 i = 0; i < MAX_LOAD_LATENCY; ++i)
+    {
+        LatencyTotals const& totals = m_totals[i];
+        if (!totals.count)
+            continue;
+
+        printf("  %-8s samples %lu, avg %.1f ms, max %.1f ms\n", latencyNames[i], (unsigned long)totals.count,
+               double(totals.sum) / totals.count / 1000.0, totals.max / 1000.0);
+    }
+    fflush(stdout);
+}
@@ -0,0 +1,111 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _LOADTEST_LOADSTATS_H
+#define _LOADTEST_LOADSTATS_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+enum LoadCounter
+{
+    COUNTER_LOGINS,                                         // characters that reached the world
+    COUNTER_LOGIN_FAILURES,
+    COUNTER_DISCONNECTS,                                    // connections lost after entering the world
+    COUNTER_PACKETS_SENT,
+    COUNTER_BYTES_SENT,
+    COUNTER_PACKETS_RECEIVED,
+    COUNTER_BYTES_RECEIVED,
+    COUNTER_MOVES,
+    COUNTER_CHATS,
+    COUNTER_CASTS,
+    COUNTER_AUCTION_QUERIES,
+    MAX_LOAD_COUNTER
+};
+
+enum LoadLatency
+{
+    LATENCY_LOGIN,                                          // realmd connect until SMSG_LOGIN_VERIFY_WORLD
+    LATENCY_PING,                                           // CMSG_PING, answered by the network thread
+    LATENCY_WORLD,                                          // CMSG_NAME_QUERY, answered during the world update
+    LATENCY_AUCTION,                                        // CMSG_AUCTION_LIST_ITEMS, answered during the world update
+    MAX_LOAD_LATENCY
+};
+
+// Collects what all clients observe. Counters can be bumped from any io thread,
+// latency samples are kept per report interval and reset by Report().
+class LoadStats
+{
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        LoadStats(uint32 clients);
+
+        void Add(LoadCounter counter, uint64 value = 1) { m_counters[counter].fetch_add(value, std::memory_order_relaxed); }
+        void AddSample(LoadLatency latency, Clock::duration elapsed);
+        void ChangeOnline(int32 delta) { m_online.fetch_add(delta, std::memory_order_relaxed); }
+
+        int32 GetOnline() const { return m_online.load(std::memory_order_relaxed); }
+
+        // prints one line covering everything since the previous call
+        void Report(Clock::duration elapsed);
+        // prints run totals
+        void Summary(Clock::duration elapsed);
+
+    private:
+        struct LatencyTotals
+        {
+            LatencyTotals() : count(0), sum(0), max(0) {}
+
+            uint64 count;
+            uint64 sum;                                     // microseconds
+            uint32 max;
+        };
+
+        struct Distribution
+        {
+            Distribution() : count(0), average(0.0), p95(0.0), max(0.0) {}
+
+            size_t count;
+            double average;                                 // milliseconds
+            double p95;
+            double max;
+        };
+
+        static Distribution Summarize(std::vector<uint32>& samples);
+        double EstimateTick(Distribution const& ping, Distribution const& world);
+
+        uint32 const m_clients;
+        std::atomic<uint64> m_counters[MAX_LOAD_COUNTER];
+        std::atomic<int32> m_online;
+
+        std::mutex m_sampleLock;
+        std::vector<uint32> m_samples[MAX_LOAD_LATENCY];    // microseconds, current interval only
+        LatencyTotals m_totals[MAX_LOAD_LATENCY];
+
+        // only touched by the reporting thread
+        uint64 m_reported[MAX_LOAD_COUNTER];
+        Clock::duration m_reportedElapsed;
+        double m_lastPingAverage;
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Headless load generator: logs in many scripted clients against a test realm
+/// and reports latency and throughput as seen from the client side.
+
+#include "LoadClient.h"
+#include "LoadStats.h"
+
+#include <boost/program_options.hpp>
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    std::atomic<bool> stopEvent(false);
+
+    void OnSignal(int /*signal*/)
+    {
+        stopEvent = true;
+    }
+
+    bool ResolveRealmd(std::string const& address, boost::asio::ip::tcp::endpoint& endpoint)
+    {
+        std::string host = address;
+        std::string port = "3724";
+        size_t const separator = address.rfind(':');
+        if (separator != std::string::npos)
+        {
+            host = address.substr(0, separator);
+            port = address.substr(separator + 1);
+        }
+
+        boost::asio::io_context context;
+        boost::asio::ip::tcp::resolver resolver(context);
+        boost::system::error_code error;
+        auto const endpoints = resolver.resolve(host, port, error);
+        if (error || endpoints.empty())
+            return false;
+
+        endpoint = *endpoints.begin();
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    namespace po = boost::program_options;
+
+    LoadConfig config;
+    std::string realmd;
+    uint32 threadCount, duration, reportInterval;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "print usage and exit")
+    ("realmd,r", po::value<std::string>(&realmd)->default_value("127.0.0.1:3724"), "realmd address as host[:port]")
+    ("realm", po::value<std::string>(&config.realmName), "realm name, the first online realm when omitted")
+    ("prefix", po::value<std::string>(&config.accountPrefix)->default_value("loadtest"), "accounts are named <prefix><number>")
+    ("password", po::value<std::string>(&config.password)->default_value("loadtest"), "password of every account")
+    ("first", po::value<uint32>(&config.firstAccount)->default_value(1), "number of the first account")
+    ("clients,n", po::value<uint32>(&config.clients)->default_value(100), "number of clients")
+    ("ramp", po::value<uint32>(&config.rampUpDelay)->default_value(50), "ms between two client logins")
+    ("threads,t", po::value<uint32>(&threadCount)->default_value(1), "network threads")
+    ("duration,d", po::value<uint32>(&duration)->default_value(0), "seconds to run, 0 runs until interrupted")
+    ("report", po::value<uint32>(&reportInterval)->default_value(10), "seconds between two report lines")
+    ("build", po::value<uint16>(&config.build)->default_value(12340), "client build sent to realmd and mangosd")
+    ("move", po::value<uint32>(&config.moveInterval)->default_value(3000), "ms between two runs, 0 disables movement")
+    ("chat", po::value<uint32>(&config.chatInterval)->default_value(15000), "ms between two say messages, 0 disables chat")
+    ("cast", po::value<uint32>(&config.castInterval)->default_value(10000), "ms between two casts, 0 disables casting")
+    ("spell", po::value<uint32>(&config.spellId)->default_value(2457), "self cast spell, default Battle Stance")
+    ("auction", po::value<uint32>(&config.auctionInterval)->default_value(30000), "ms between two auction queries, 0 disables them")
+    ("query", po::value<uint32>(&config.queryInterval)->default_value(1000), "ms between two world round trip probes, 0 disables them")
+    ("ping", po::value<uint32>(&config.pingInterval)->default_value(30000), "ms between two pings, 0 disables them");
+
+    po::variables_map vm;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    }
+    catch (po::error const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    if (!config.clients || !threadCount || !reportInterval)
+    {
+        std::cerr << "ERROR: clients, threads and report have to be positive" << std::endl;
+        return 1;
+    }
+
+    if (!ResolveRealmd(realmd, config.realmd))
+    {
+        std::cerr << "ERROR: cannot resolve realmd address " << realmd << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    LoadStats stats(config.clients);
+
+    typedef boost::asio::executor_work_guard<boost::asio::io_context::executor_type> WorkGuard;
+    std::vector<std::unique_ptr<boost::asio::io_context>> contexts;
+    std::vector<WorkGuard> guards;
+    for (uint32 i = 0; i < threadCount; ++i)
+    {
+        contexts.emplace_back(new boost::asio::io_context(1));
+        guards.emplace_back(boost::asio::make_work_guard(*contexts.back()));
+    }
+
+    std::vector<std::shared_ptr<LoadClient>> clients;
+    clients.reserve(config.clients);
+    for (uint32 i = 0; i < config.clients; ++i)
+    {
+        clients.push_back(std::make_shared<LoadClient>(*contexts[i % threadCount], config, stats, config.firstAccount + i));
+        clients.back()->Start(std::chrono::milliseconds(uint64(i) * config.rampUpDelay));
+    }
+
+    std::vector<std::thread> threads;
+    for (auto& context : contexts)
+        threads.emplace_back([&context]() { context->run(); });
+
+    printf("Started %u clients on %u threads against %s\n", config.clients, threadCount, realmd.c_str());
+    fflush(stdout);
+
+    LoadStats::Clock::time_point const start = LoadStats::Clock::now();
+    LoadStats::Clock::time_point nextReport = start + std::chrono::seconds(reportInterval);
+    while (!stopEvent)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        LoadStats::Clock::time_point const now = LoadStats::Clock::now();
+        if (now >= nextReport)
+        {
+            stats.Report(now - start);
+            nextReport += std::chrono::seconds(reportInterval);
+        }
+
+        if (duration && now - start >= std::chrono::seconds(duration))
+            break;
+    }
+
+    // closing the sockets lets every io_context run out of work
+    for (auto& client : clients)
+        client->Stop();
+    guards.clear();
+    for (auto& thread : threads)
+        thread.join();
+
+    stats.Summary(LoadStats::Clock::now() - start);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "BuildManifest.h"
+
+#include <cinttypes>
+
+namespace MMAP
+{
+    void InputHash::Add(void const* data, size_t size)
+    {
+        unsigned char const* bytes = static_cast<unsigned char const*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            m_value ^= bytes[i];
+            m_value *= UINT64_C(0x100000001b3);
+        }
+    }
+
+    void InputHash::AddFile(std::string const& fileName)
+    {
+        FILE* file = fopen(fileName.c_str(), "rb");
+        AddValue(file != nullptr);
+        if (!file)
+            return;
+
+        unsigned char buffer[64 * 1024];
+        size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            Add(buffer, read);
+        fclose(file);
+    }
+
+    BuildManifest::BuildManifest(std::string const& fileName) : m_fileName(fileName), m_log(nullptr)
+    {
+        if (FILE* file = fopen(fileName.c_str(), "rb"))
+        {
+            char line[128];
+            while (fgets(line, sizeof(line), file))
+            {
+                uint32 mapId, tileX, tileY, hasOutput;
+                uint64 hash;
+                // a line cut by an interrupted build does not parse and its tile is built again
+                if (sscanf(line, "%u %u %u %" SCNx64 " %u", &mapId, &tileX, &tileY, &hash, &hasOutput) == 5)
+                    m_entries[Key(mapId, tileX, tileY)] = { hash, hasOutput != 0 };
+            }
+            fclose(file);
+        }
+
+        m_log = fopen(fileName.c_str(), "ab");
+        if (!m_log)
+            printf("Could not open %s, finished tiles will not be remembered!\n", fileName.c_str());
+    }
+
+    BuildManifest::~BuildManifest()
+    {
+        if (m_log)
+            fclose(m_log);
+    }
+
+    bool BuildManifest::IsUpToDate(uint32 mapId, uint32 tileX, uint32 tileY, uint64 hash, std::string const& outputFile) const
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        auto itr = m_entries.find(Key(mapId, tileX, tileY));
+        if (itr == m_entries.end() || itr->second.hash != hash)
+            return false;
+
+        if (!itr->second.hasOutput)
+            return true;
+
+        FILE* file = fopen(outputFile.c_str(), "rb");
+        if (!file)
+            return false;
+        fclose(file);
+        return true;
+    }
+
+    void BuildManifest::MarkBuilt(uint32 mapId, uint32 tileX, uint32 tileY, uint64 hash, bool hasOutput)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_entries[Key(mapId, tileX, tileY)] = { hash, hasOutput };
+        if (!m_log)
+            return;
+
+        fprintf(m_log, "%u %u %u %016" PRIx64 " %u\n", mapId, tileX, tileY, hash, hasOutput ? 1 : 0);
+        fflush(m_log);
+    }
+
+    void BuildManifest::Compact()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (m_log)
+            fclose(m_log);
+
+        std::string const tempName = m_fileName + ".tmp";
+        FILE* file = fopen(tempName.c_str(), "wb");
+        if (file)
+        {
+            for (auto const& entry : m_entries)
+                fprintf(file, "%u %u %u %016" PRIx64 " %u\n", uint32(entry.first >> 32), uint32(entry.first >> 16) & 0xFFFF,
+                        uint32(entry.first) & 0xFFFF, entry.second.hash, entry.second.hasOutput ? 1 : 0);
+            fclose(file);
+            remove(m_fileName.c_str());
+            rename(tempName.c_str(), m_fileName.c_str());
+        }
+
+        m_log = fopen(m_fileName.c_str(), "ab");
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _BUILD_MANIFEST_H
+#define _BUILD_MANIFEST_H
+
+#include "Platform/Define.h"
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace MMAP
+{
+    // FNV-1a, inputs of a tile are chained through it
+    class InputHash
+    {
+        public:
+            InputHash() : m_value(UINT64_C(0xcbf29ce484222325)) {}
+
+            void Add(void const* data, size_t size);
+            void Add(std::string const& value) { Add(value.data(), value.size()); }
+            template<typename T>
+            void AddValue(T const& value) { Add(&value, sizeof(T)); }
+            // missing files hash differently from empty ones
+            void AddFile(std::string const& fileName);
+
+            uint64 Value() const { return m_value; }
+
+        private:
+            uint64 m_value;
+    };
+
+    // mmaps/build.manifest: one "map x y hash output" line per finished tile, the last line of a tile wins.
+    // Lines are appended as soon as a tile is written, an interrupted build continues where it stopped.
+    class BuildManifest
+    {
+        public:
+            explicit BuildManifest(std::string const& fileName);
+            ~BuildManifest();
+            BuildManifest(BuildManifest const&) = delete;
+            BuildManifest& operator=(BuildManifest const&) = delete;
+
+            // same inputs as the recorded build and its output, if it had one, still on disk
+            bool IsUpToDate(uint32 mapId, uint32 tileX, uint32 tileY, uint64 hash, std::string const& outputFile) const;
+            void MarkBuilt(uint32 mapId, uint32 tileX, uint32 tileY, uint64 hash, bool hasOutput);
+            // rewrites the file with one line per tile
+            void Compact();
+
+        private:
+            struct Entry
+            {
+                uint64 hash;
+                bool hasOutput;
+            };
+
+            static uint64 Key(uint32 mapId, uint32 tileX, uint32 tileY) { return (uint64(mapId) << 32) | (tileX << 16) | tileY; }
+
+            std::string m_fileName;
+            mutable std::mutex m_lock;
+            std::unordered_map<uint64, Entry> m_entries;
+            FILE* m_log;
+    };
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include "ModelInstance.h"
 
 #include "DetourNavMeshBuilder.h"
+#include "DetourNavMeshQuery.h"
 #include "DetourCommon.h"
 #include "Vmap/VMapDefinitions.h"
 
@@ -76,13 +77,14 @@ namespace MMAP
     }
 
     MapBuilder::MapBuilder(const char* configInputPath, int threads, bool skipLiquid, bool skipContinents, bool skipJunkMaps,
-                           bool skipBattlegrounds, bool debug, bool buildAlternate, const char* offMeshFilePath, const char* workdir) :
+                           bool skipBattlegrounds, bool debug, bool buildAlternate, const char* offMeshFilePath, const char* workdir, bool forceRebuild) :
         m_taskQueue(new TaskQueue(this, threads)),
         m_debug(debug),
         m_skipContinents(skipContinents),
         m_skipJunkMaps(skipJunkMaps),
         m_skipBattlegrounds(skipBattlegrounds),
         m_buildAlternate(buildAlternate),
+        m_forceRebuild(forceRebuild || debug),
         m_offMeshFilePath(offMeshFilePath),
         m_workdir(workdir)
     {
@@ -96,6 +98,8 @@ namespace MMAP
         printf("Using %d thread(s) for processing.\n", threads);
         discoverTiles();
 
+        m_manifest.reset(new BuildManifest(std::string(m_workdir) + "/mmaps/build.manifest"));
+
         m_modelList = GameobjectModelData::LoadGameObjectModelList(std::string(m_workdir) + "/vmaps/" + VMAP::GAMEOBJECT_MODELS);
     }
 
@@ -115,14 +119,16 @@ namespace MMAP
     /**************************************************************************/
     void MapBuilder::BuildMaps(std::vector<uint32>& ids)
     {
+        std::vector<uint32> builtMaps;
         if (ids.empty())
         {
             for (auto tileItr : m_tiles)
             {
                 uint32 const& mapID = tileItr.first;
-                if (!shouldSkipMap(mapID))
-                    buildMap(mapID);
+                if (!shouldSkipMap(mapID) && buildMap(mapID))
+                    builtMaps.push_back(mapID);
 
+                std::lock_guard<std::mutex> guard(m_mapDoneLock);
                 m_mapDone.insert(mapID);
             }
         }
@@ -130,15 +136,130 @@ namespace MMAP
         {
             for (auto& mapId : ids)
             {
-                if (!shouldSkipMap(mapId))
-                    buildMap(mapId);
+                if (!shouldSkipMap(mapId) && buildMap(mapId))
+                    builtMaps.push_back(mapId);
 
+                std::lock_guard<std::mutex> guard(m_mapDoneLock);
                 m_mapDone.insert(mapId);
             }
         }
 
         // Wait all work to be done
         m_taskQueue->WaitAll();
+        m_manifest->Compact();
+
+        // the graph needs the final tiles of the whole map, maps without changed tiles keep theirs
+        for (auto mapID : builtMaps)
+            buildTileGraph(mapID);
+    }
+
+    /**************************************************************************/
+    TaskQueue::TaskQueue(MapBuilder* mapBuilder, uint32 threads) : m_mapBuilder(mapBuilder), m_nextWorker(0), m_pending(0), m_stop(false)
+    {
+        threads = std::max(threads, 1u);
+        for (uint32 i = 0; i < threads; ++i)
+            m_workers.emplace_back(new Worker());
+        for (uint32 i = 0; i < threads; ++i)
+            m_threads.emplace_back(&TaskQueue::Run, this, i);
+    }
+
+    TaskQueue::~TaskQueue()
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_stateLock);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    void TaskQueue::WaitAll()
+    {
+        std::unique_lock<std::mutex> guard(m_stateLock);
+        m_idle.wait(guard, [this] { return m_pending == 0; });
+    }
+
+    bool TaskQueue::Take(uint32 index, TaskType& task)
+    {
+        // own tasks newest first, tiles of the map just queued reuse the warm caches
+        {
+            Worker& own = *m_workers[index];
+            std::lock_guard<std::mutex> guard(own.lock);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        // steal the oldest task of the others
+        for (uint32 i = 1; i < m_workers.size(); ++i)
+        {
+            Worker& victim = *m_workers[(index + i) % m_workers.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void TaskQueue::Run(uint32 index)
+    {
+        while (true)
+        {
+            TaskType task;
+            if (Take(index, task))
+            {
+                task.second();
+                TaskDone(task.first);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> guard(m_stateLock);
+            if (m_stop)
+                return;
+
+            // pushes between the failed take and this wait are not lost, they count in m_pending
+            uint32 const pending = m_pending;
+            m_wake.wait_for(guard, std::chrono::milliseconds(100), [this, pending] { return m_stop || m_pending != pending; });
+        }
+    }
+
+    void TaskQueue::TaskDone(uint32 mapId)
+    {
+        std::lock_guard<std::mutex> guard(m_stateLock);
+
+        // check if map is done (all tile jobs should be in the queue if any remain)
+        if (--m_mapTasks[mapId] == 0)
+        {
+            m_mapTasks.erase(mapId);
+            if (m_mapBuilder->IsMapDone(mapId))
+            {
+                std::stringstream ss;
+                ss << "Map [" << mapId << "] is done!";
+                if (m_mapTasks.empty())
+                    ss << "                             \n"; // should delete some remaining char in the line
+                else
+                {
+                    ss << " Still ongoing:";
+                    for (auto const& mapTasks : m_mapTasks)
+                        ss << " [" << mapTasks.first << "]";
+                    ss << "                              ";
+                }
+                printf("%s\n", ss.str().c_str());
+            }
+        }
+
+        if (--m_pending == 0)
+            m_idle.notify_all();
     }
 
     /**************************************************************************/
@@ -225,6 +346,8 @@ namespace MMAP
     /**************************************************************************/
     bool MapBuilder::IsMapDone(uint32 mapId) const
     {
+        // asked by the workers while maps are still queued
+        std::lock_guard<std::mutex> guard(m_mapDoneLock);
         auto itr = std::find(m_mapDone.begin(), m_mapDone.end(), mapId);
         return itr != m_mapDone.end();
     }
@@ -588,7 +711,7 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    void MapBuilder::buildMap(uint32 mapID)
+    uint32 MapBuilder::buildMap(uint32 mapID)
     {
         printf("Building map %03u:                                    \n", mapID);
 
@@ -608,7 +731,7 @@ namespace MMAP
         }
 
         if (!tiles->size())
-            return;
+            return 0;
 
         // build navMesh
         dtNavMesh* navMesh = nullptr;
@@ -616,13 +739,18 @@ namespace MMAP
         if (!navMesh)
         {
             printf("[Map %03i] Failed creating navmesh!                   \n", mapID);
-            return;
+            return 0;
         }
 
         // now start building mmtiles for each tile
         printf("[Map %03i] We have %u tiles.                          \n", mapID, uint32(tiles->size()));
 
+        dtNavMeshParams const navMeshParams = *navMesh->getParams();
+        dtFreeNavMesh(navMesh);
+
         uint32 currentTile = 0;
+        uint32 queuedTiles = 0;
+        uint32 upToDateTiles = 0;
         for (std::set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
         {
             currentTile++;
@@ -634,32 +762,132 @@ namespace MMAP
             if (shouldSkipTile(mapID, tileX, tileY))
                 continue;
 
-            // Make a copy of the original navMesh object to work on a separate
-            // thread since "the data should not be reused in other nav meshes"
-            // (see dtNavMesh::addTile description)
-            dtNavMesh* navMeshCopy = dtAllocNavMesh();
-            dtStatus dtResult = navMeshCopy->init(navMesh->getParams());
-            if (dtStatusFailed(dtResult))
+            char fileName[1024];
+            sprintf(fileName, "%s/mmaps/%03u%02i%02i.mmtile", m_workdir, mapID, tileY, tileX);
+            std::string const outputFile = fileName;
+
+            uint64 const inputHash = getTileInputHash(mapID, tileX, tileY, navMeshParams);
+            if (!m_forceRebuild && m_manifest->IsUpToDate(mapID, tileX, tileY, inputHash, outputFile))
             {
-                printf("[Map %03i] Failed to copy navmesh!                   \n", mapID);
-                printf("%s\n", GetDTErrorReason(dtResult));
+                ++upToDateTiles;
                 continue;
             }
 
             // passing by value
             auto builder = [=]()
             {
+                // Make a copy of the original navMesh object to work on a separate
+                // thread since "the data should not be reused in other nav meshes"
+                // (see dtNavMesh::addTile description)
+                // created by the task so only running tiles hold one
+                dtNavMesh* navMeshCopy = dtAllocNavMesh();
+                dtStatus dtResult = navMeshCopy->init(&navMeshParams);
+                if (dtStatusFailed(dtResult))
+                {
+                    printf("[Map %03i] Failed to copy navmesh!                   \n", mapID);
+                    printf("%s\n", GetDTErrorReason(dtResult));
+                    dtFreeNavMesh(navMeshCopy);
+                    return;
+                }
+
                 // build tile with copy version of the navmesh
                 buildTile(mapID, tileX, tileY, navMeshCopy, currentTile, uint32(tiles->size()));
 
                 // free this navmesh
                 dtFreeNavMesh(navMeshCopy);
+
+                // tiles without walkable surface write nothing, remember them too
+                FILE* output = fopen(outputFile.c_str(), "rb");
+                if (output)
+                    fclose(output);
+                m_manifest->MarkBuilt(mapID, tileX, tileY, inputHash, output != nullptr);
             };
 
             m_taskQueue->PushWork(builder, mapID);
+            ++queuedTiles;
         }
 
-        dtFreeNavMesh(navMesh);
+        if (upToDateTiles)
+            printf("[Map %03i] Skipping %u unchanged tiles.               \n", mapID, upToDateTiles);
+
+        // the graph is rebuilt when tiles changed or it is missing
+        if (!queuedTiles)
+        {
+            char graphName[1024];
+            sprintf(graphName, "%s/mmaps/%03u.mmgraph", m_workdir, mapID);
+            if (FILE* graph = fopen(graphName, "rb"))
+            {
+                fclose(graph);
+                return 0;
+            }
+            return 1;
+        }
+
+        return queuedTiles;
+    }
+
+    /**************************************************************************/
+    uint64 MapBuilder::getTileInputHash(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMeshParams const& navMeshParams)
+    {
+        InputHash hash;
+        hash.AddValue(uint32(MMAP_VERSION));
+        hash.AddValue(uint32(DT_NAVMESH_VERSION));
+        hash.AddValue(m_buildAlternate);
+        hash.AddValue(m_terrainBuilder->usesLiquids());
+
+        // tiles store positions relative to the navmesh origin
+        hash.AddValue(navMeshParams.orig);
+        hash.AddValue(navMeshParams.tileWidth);
+        hash.AddValue(navMeshParams.tileHeight);
+        hash.AddValue(navMeshParams.maxTiles);
+        hash.AddValue(navMeshParams.maxPolys);
+
+        hash.Add(getTileConfig(mapID, tileX, tileY).dump());
+
+        // terrain borders are taken from the four neighbours, see TerrainBuilder::loadMap
+        char fileName[1024];
+        int const neighbours[5][2] = { { 0, 0 }, { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+        for (auto const& offset : neighbours)
+        {
+            sprintf(fileName, "%s/maps/%03u%02u%02u.map", m_workdir, mapID, tileY + offset[1], tileX + offset[0]);
+            hash.AddFile(fileName);
+        }
+
+        std::string const vmapDir = std::string(m_workdir) + "/vmaps/";
+        sprintf(fileName, "%03u.vmtree", mapID);
+        hash.AddFile(vmapDir + fileName);
+        hash.AddFile(vmapDir + StaticMapTree::getTileFileName(mapID, tileY, tileX));
+
+        // same matching as TerrainBuilder::loadOffMeshConnections
+        if (m_offMeshFilePath)
+        {
+            if (FILE* offMesh = fopen(m_offMeshFilePath, "rb"))
+            {
+                char line[512];
+                while (fgets(line, sizeof(line), offMesh))
+                {
+                    int mid, tx, ty;
+                    if (sscanf(line, "%d %d,%d", &mid, &tx, &ty) == 3 && uint32(mid) == mapID && uint32(tx) == tileX && uint32(ty) == tileY)
+                        hash.Add(std::string(line));
+                }
+                fclose(offMesh);
+            }
+        }
+
+        auto buildings = BuildingMap.find(mapID);
+        if (buildings != BuildingMap.end())
+        {
+            for (TileBuilding const& building : buildings->second)
+            {
+                hash.Add(building.modelName);
+                double const placement[] = { building.x, building.y, building.z, building.ori, building.qx, building.qy, building.qz, building.qw };
+                hash.AddValue(placement);
+                hash.AddValue(building.tileNumber);
+                hash.AddValue(building.byDefault);
+            }
+        }
+
+        return hash.Value();
     }
 
     const std::array<uint32, 6> factorial =
@@ -865,6 +1093,272 @@ namespace MMAP
         fclose(file);
     }
 
+    /**************************************************************************/
+    // crossings closer than this along a border and in height belong to the same passage
+    static float const GRAPH_CROSSING_GAP = 2.0f;
+    static float const GRAPH_CROSSING_CLIMB = 4.0f;
+    // wide passages like open fields get one node every this many yards
+    static float const GRAPH_NODE_SPACING = 64.0f;
+    static int const GRAPH_MAX_SEARCH_NODES = 65535;
+
+    struct GraphCrossing
+    {
+        dtPolyRef poly;                                     // polygon in the tile
+        dtPolyRef neighbour;                                // polygon across the border
+        float pos[3];                                       // middle of the shared edge
+        float alongMin, alongMax, along;                    // position along the border
+    };
+
+    struct GraphPassage
+    {
+        std::vector<GraphCrossing> crossings;
+        float alongMin, alongMax, height;
+    };
+
+    void MapBuilder::buildTileGraph(uint32 mapID)
+    {
+        char fileName[1024];
+        sprintf(fileName, "%s/mmaps/%03u.mmap", m_workdir, mapID);
+        FILE* file = fopen(fileName, "rb");
+        if (!file)
+            return;
+
+        dtNavMeshParams params;
+        size_t const paramsRead = fread(&params, sizeof(dtNavMeshParams), 1, file);
+        fclose(file);
+        if (paramsRead != 1)
+            return;
+
+        dtNavMesh* navMesh = dtAllocNavMesh();
+        if (dtStatusFailed(navMesh->init(&params)))
+        {
+            printf("[Map %03i] Failed creating navmesh for tile graph!    \n", mapID);
+            dtFreeNavMesh(navMesh);
+            return;
+        }
+
+        printf("[Map %03i] Building tile graph...                     \n", mapID);
+
+        // only default tiles, alternate gameobject tiles (_NN) are swapped in at runtime
+        char mmapsDir[1024];
+        char filter[16];
+        sprintf(mmapsDir, "%s/mmaps", m_workdir);
+        sprintf(filter, "%03u*.mmtile", mapID);
+        std::vector<std::string> files;
+        getDirContents(files, mmapsDir, filter);
+        for (auto const& tileName : files)
+        {
+            if (tileName.size() != strlen("0000000.mmtile"))
+                continue;
+
+            FILE* tileFile = fopen((std::string(mmapsDir) + "/" + tileName).c_str(), "rb");
+            if (!tileFile)
+                continue;
+
+            MmapTileHeader header;
+            if (fread(&header, sizeof(MmapTileHeader), 1, tileFile) != 1 || header.mmapMagic != MMAP_MAGIC || header.mmapVersion != MMAP_VERSION)
+            {
+                fclose(tileFile);
+                continue;
+            }
+
+            unsigned char* data = (unsigned char*)dtAlloc(header.size, DT_ALLOC_PERM);
+            if (fread(data, header.size, 1, tileFile) != 1 || dtStatusFailed(navMesh->addTile(data, header.size, DT_TILE_FREE_DATA, 0, nullptr)))
+                dtFree(data);
+            fclose(tileFile);
+        }
+
+        dtNavMesh const* mesh = navMesh;
+        std::vector<MmapGraphNode> nodes;
+        std::map<uint32, std::vector<std::pair<uint32, dtPolyRef>>> tileNodes;  // nodes on each tile border with their polygon inside the tile
+
+        for (int t = 0; t < mesh->getMaxTiles(); ++t)
+        {
+            dtMeshTile const* tile = mesh->getTile(t);
+            if (!tile || !tile->header)
+                continue;
+
+            // each border is collected from the tile on its lower side, links towards +x (side 0) and +z (side 2)
+            std::vector<GraphPassage> passages[2];
+            dtPolyRef const base = mesh->getPolyRefBase(tile);
+            for (int p = 0; p < tile->header->polyCount; ++p)
+            {
+                dtPoly const* poly = &tile->polys[p];
+                if (poly->getType() == DT_POLYTYPE_OFFMESH_CONNECTION || !(poly->flags & NAV_GROUND))
+                    continue;
+
+                for (unsigned int l = poly->firstLink; l != DT_NULL_LINK; l = tile->links[l].next)
+                {
+                    dtLink const& link = tile->links[l];
+                    if (link.side != 0 && link.side != 2)
+                        continue;
+
+                    float const* va = &tile->verts[poly->verts[link.edge] * 3];
+                    float const* vb = &tile->verts[poly->verts[(link.edge + 1) % poly->vertCount] * 3];
+                    int const axis = link.side == 0 ? 2 : 0;
+
+                    GraphCrossing crossing;
+                    crossing.poly = base | dtPolyRef(p);
+                    crossing.neighbour = link.ref;
+                    dtVlerp(crossing.pos, va, vb, 0.5f);
+                    crossing.alongMin = std::min(va[axis], vb[axis]);
+                    crossing.alongMax = std::max(va[axis], vb[axis]);
+                    crossing.along = crossing.pos[axis];
+
+                    std::vector<GraphPassage>& sidePassages = passages[link.side / 2];
+                    GraphPassage* passage = nullptr;
+                    for (auto& candidate : sidePassages)
+                    {
+                        if (crossing.alongMin <= candidate.alongMax + GRAPH_CROSSING_GAP && crossing.alongMax >= candidate.alongMin - GRAPH_CROSSING_GAP &&
+                                std::fabs(crossing.pos[1] - candidate.height) <= GRAPH_CROSSING_CLIMB)
+                        {
+                            passage = &candidate;
+                            break;
+                        }
+                    }
+
+                    if (!passage)
+                    {
+                        sidePassages.emplace_back();
+                        passage = &sidePassages.back();
+                        passage->alongMin = crossing.alongMin;
+                        passage->alongMax = crossing.alongMax;
+                    }
+
+                    passage->alongMin = std::min(passage->alongMin, crossing.alongMin);
+                    passage->alongMax = std::max(passage->alongMax, crossing.alongMax);
+                    passage->height = crossing.pos[1];
+                    passage->crossings.push_back(crossing);
+                }
+            }
+
+            for (auto const& sidePassages : passages)
+            {
+                for (auto const& passage : sidePassages)
+                {
+                    uint32 const pieces = std::max(1u, uint32(std::ceil((passage.alongMax - passage.alongMin) / GRAPH_NODE_SPACING)));
+                    float const pieceLength = (passage.alongMax - passage.alongMin) / pieces;
+                    GraphCrossing const* last = nullptr;
+                    for (uint32 i = 0; i < pieces; ++i)
+                    {
+                        float const center = passage.alongMin + pieceLength * (i + 0.5f);
+                        GraphCrossing const* best = &passage.crossings.front();
+                        for (auto const& crossing : passage.crossings)
+                            if (std::fabs(crossing.along - center) < std::fabs(best->along - center))
+                                best = &crossing;
+
+                        if (best == last)
+                            continue;
+                        last = best;
+
+                        dtMeshTile const* neighbourTile = nullptr;
+                        dtPoly const* neighbourPoly = nullptr;
+                        mesh->getTileAndPolyByRefUnsafe(best->neighbour, &neighbourTile, &neighbourPoly);
+
+                        MmapGraphNode node;
+                        dtVcopy(node.pos, best->pos);
+                        node.tiles[0] = uint32(tile->header->x) << 16 | uint32(tile->header->y);
+                        node.tiles[1] = uint32(neighbourTile->header->x) << 16 | uint32(neighbourTile->header->y);
+                        node.firstEdge = 0;
+                        node.edgeCount = 0;
+
+                        uint32 const nodeId = nodes.size();
+                        nodes.push_back(node);
+                        tileNodes[node.tiles[0]].emplace_back(nodeId, best->poly);
+                        tileNodes[node.tiles[1]].emplace_back(nodeId, best->neighbour);
+                    }
+                }
+            }
+        }
+
+        // walk costs between the nodes of every tile, one search from each node reaches all others
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        query->init(navMesh, GRAPH_MAX_SEARCH_NODES);
+        dtQueryFilter queryFilter;
+        queryFilter.setIncludeFlags(NAV_GROUND | NAV_WATER);
+        queryFilter.setExcludeFlags(0);
+
+        std::vector<dtPolyRef> resultRefs(GRAPH_MAX_SEARCH_NODES);
+        std::vector<float> resultCosts(GRAPH_MAX_SEARCH_NODES);
+        std::vector<std::map<uint32, float>> adjacency(nodes.size());
+        for (auto const& tileEntry : tileNodes)
+        {
+            auto const& entries = tileEntry.second;
+            for (auto const& from : entries)
+            {
+                float radius = 0.0f;
+                for (auto const& to : entries)
+                    radius = std::max(radius, dtVdist(nodes[from.first].pos, nodes[to.first].pos));
+                if (radius <= 0.0f)
+                    continue;
+
+                int resultCount = 0;
+                query->findPolysAroundCircle(from.second, nodes[from.first].pos, radius + GRAPH_CROSSING_GAP, &queryFilter,
+                                             resultRefs.data(), nullptr, resultCosts.data(), &resultCount, GRAPH_MAX_SEARCH_NODES);
+
+                std::unordered_map<dtPolyRef, float> reached;
+                for (int i = 0; i < resultCount; ++i)
+                    reached[resultRefs[i]] = resultCosts[i];
+
+                for (auto const& to : entries)
+                {
+                    if (to.first == from.first)
+                        continue;
+
+                    auto itr = reached.find(to.second);
+                    if (itr == reached.end())
+                        continue;
+
+                    // cost is measured to the polygon entry, finish with the rest of the way to the crossing
+                    float const cost = std::max(itr->second, dtVdist(nodes[from.first].pos, nodes[to.first].pos));
+                    auto edge = adjacency[from.first].find(to.first);
+                    if (edge == adjacency[from.first].end() || edge->second > cost)
+                        adjacency[from.first][to.first] = cost;
+                }
+            }
+        }
+
+        dtFreeNavMeshQuery(query);
+        dtFreeNavMesh(navMesh);
+
+        std::vector<MmapGraphEdge> edges;
+        for (uint32 i = 0; i < nodes.size(); ++i)
+        {
+            nodes[i].firstEdge = edges.size();
+            nodes[i].edgeCount = adjacency[i].size();
+            for (auto const& edge : adjacency[i])
+                edges.push_back({ edge.first, edge.second });
+        }
+
+        sprintf(fileName, "%s/mmaps/%03u.mmgraph", m_workdir, mapID);
+        if (nodes.empty())
+        {
+            // single tile maps need no graph, do not leave one from an older build behind
+            remove(fileName);
+            return;
+        }
+
+        file = fopen(fileName, "wb");
+        if (!file)
+        {
+            char message[1024];
+            sprintf(message, "[Map %03i] Failed to open %s for writing!             \n", mapID, fileName);
+            perror(message);
+            return;
+        }
+
+        MmapGraphHeader header;
+        header.nodeCount = nodes.size();
+        header.edgeCount = edges.size();
+        fwrite(&header, sizeof(MmapGraphHeader), 1, file);
+        fwrite(nodes.data(), sizeof(MmapGraphNode), nodes.size(), file);
+        if (!edges.empty())
+            fwrite(edges.data(), sizeof(MmapGraphEdge), edges.size(), file);
+        fclose(file);
+
+        printf("[Map %03i] Tile graph has %u nodes and %u edges.       \n", mapID, uint32(nodes.size()), uint32(edges.size()));
+    }
+
     /**************************************************************************/
     void MapBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY, uint32 tileNumber,
                                       MeshData& meshData, float bmin[3], float bmax[3],
@@ -22,11 +22,17 @@
 #include <vector>
 #include <set>
 #include <map>
-#include <future>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 #include "TerrainBuilder.h"
 #include "IntermediateValues.h"
+#include "BuildManifest.h"
 
 #include "IVMapManager.h"
 #include "WorldModel.h"
@@ -93,7 +99,8 @@ namespace MMAP
                        bool debug               = false,
                        bool buildAlternate      = true,
                        const char* offMeshFilePath = NULL,
-                       const char* workdir = NULL);
+                       const char* workdir = NULL,
+                       bool forceRebuild        = false);
 
             ~MapBuilder();
 
@@ -110,8 +117,11 @@ namespace MMAP
             bool IsMapDone(uint32 mapId) const;
 
         private:
-            // builds all mmap tiles for the specified map id (ignores skip settings)
-            void buildMap(uint32 mapID);
+            // builds all changed mmap tiles for the specified map id (ignores skip settings), returns queued tiles
+            uint32 buildMap(uint32 mapID);
+
+            // everything a tile is built from: terrain of it and its neighbours, vmap tile, offmesh links, config
+            uint64 getTileInputHash(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMeshParams const& navMeshParams);
 
             // detect maps and tiles
             void discoverTiles();
@@ -119,6 +129,9 @@ namespace MMAP
 
             void buildNavMesh(uint32 mapID, dtNavMesh*& navMesh);
 
+            // border crossings between tiles and their walk costs, written once all tiles of the map exist
+            void buildTileGraph(uint32 mapID);
+
             void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, uint32 curTile, uint32 tileCount);
             void PrepareAndBuildTile(MeshData& meshData, uint32 mapID, uint32 tileX, uint32 tileY, uint32 tileId, dtNavMesh* navMesh);
             bool buildCommonTile(const char* tileString, Tile& tile, rcConfig& tileCfg, float* tVerts, int tVertCount, int* tTris, int tTriCount, uint8* tTriFlags, float* lVerts, int lVertCount,
@@ -148,6 +161,7 @@ namespace MMAP
             bool m_skipJunkMaps;
             bool m_skipBattlegrounds;
             bool m_buildAlternate;
+            bool m_forceRebuild;
 
             json m_config;
 
@@ -159,102 +173,72 @@ namespace MMAP
 
             // used to know wich map have launched all its tile work
             MapSet m_mapDone;
+            mutable std::mutex m_mapDoneLock;
+
+            // finished tiles and their inputs, lets builds resume and skip unchanged tiles
+            std::unique_ptr<BuildManifest> m_manifest;
 
             ModelList m_modelList;
     };
 
-    // Task queue : not thread safe (do not add worker asynchronously)
+    // Work stealing scheduler: every worker owns a deque, runs its newest task and takes the oldest
+    // task of another worker once its own deque is empty. Idle workers sleep instead of spinning.
+    // Tasks must only be pushed from the thread driving the builder.
     class TaskQueue
     {
         private:
-            typedef std::pair<uint32, std::future<void>> TaskType;
-            typedef std::vector<TaskType> TaskVec;
+            typedef std::function<void()> Task;
+            typedef std::pair<uint32, Task> TaskType;       // map id, work
+
+            struct Worker
+            {
+                std::mutex lock;
+                std::deque<TaskType> tasks;
+            };
 
         public:
-            TaskQueue(MapBuilder* mapBuilder, uint32 maxSize)
-                : m_mapBuilder(mapBuilder), m_maxSize(maxSize) {
-                m_taskList.reserve(maxSize);
-            }
+            TaskQueue(MapBuilder* mapBuilder, uint32 threads);
             TaskQueue() = delete;
             TaskQueue(TaskQueue const&) = delete;
+            ~TaskQueue();
 
-            // Add worker to the queue and block until at least there is one thread free
+            // never blocks, tiles are spread over the workers and rebalanced by stealing
             template<typename T>
             void PushWork(T&& work, uint32 mapId)
             {
-                m_taskList.emplace_back(mapId, std::async(std::launch::async, work));
-                while (m_taskList.size() == m_maxSize)
                 {
-                    RemoveFinishedTask();
+                    std::lock_guard<std::mutex> guard(m_stateLock);
+                    ++m_pending;
+                    ++m_mapTasks[mapId];
+                }
 
-                    // allow other thread to run
-                    std::this_thread::yield();
+                Worker& worker = *m_workers[m_nextWorker++ % m_workers.size()];
+                {
+                    std::lock_guard<std::mutex> guard(worker.lock);
+                    worker.tasks.emplace_back(mapId, Task(std::forward<T>(work)));
                 }
+                m_wake.notify_one();
             }
 
             // wait all worker to finish
-            void WaitAll()
-            {
-                while (!m_taskList.empty())
-                    RemoveFinishedTask();
-            }
+            void WaitAll();
 
         private:
-            // Try to remove a finished worker from the queue
-            void RemoveFinishedTask()
-            {
-                for (TaskVec::iterator fItr = m_taskList.begin(); fItr != m_taskList.end();)
-                {
-                    std::future_status status = fItr->second.wait_for(std::chrono::seconds(0));
-                    if (status == std::future_status::ready)
-                    {
-                        // take a copy of current finished job work map id before deleting this iterator
-                        uint32 justDeletedMapId = fItr->first;
-
-                        fItr->second.get();
-                        fItr = m_taskList.erase(fItr);
-
-                        // check if map is done (all tile jobs should be in the queue if any remain)
-                        if (m_mapBuilder->IsMapDone(justDeletedMapId))
-                        {
-                            MapSet onGoingMap;
-                            // search if there is remaining work to do 
-                            bool foundWork = false;
-                            for (auto& itr : m_taskList)
-                            {
-                                if (itr.first == justDeletedMapId)
-                                {
-                                    foundWork = true;
-                                    break;
-                                }
-                                onGoingMap.insert(itr.first);
-                            }
-
-                            if (!foundWork)
-                            {
-                                std::stringstream ss;
-                                ss << "Map [" << justDeletedMapId << "] is done!";
-                                if (onGoingMap.empty())
-                                    ss << "                             \n"; // should delete some remaining char in the line
-                                else
-                                {
-                                    ss << " Still ongoing:";
-                                    for (auto mId : onGoingMap)
-                                        ss << " [" << mId << "]";
-                                    ss << "                              ";
-                                }
-                                printf("%s\n", ss.str().c_str());
-                            }
-                        }
-                    }
-                    else
-                        ++fItr;
-                }
-            };
-
-            MapBuilder* m_mapBuilder;       // needed for MapNuilder::IsMapDone
-            uint32 m_maxSize;               // max thread usable
-            TaskVec m_taskList;             // task queue in a vector
+            void Run(uint32 index);
+            bool Take(uint32 index, TaskType& task);
+            void TaskDone(uint32 mapId);
+
+            MapBuilder* m_mapBuilder;       // needed for MapBuilder::IsMapDone
+            std::vector<std::unique_ptr<Worker>> m_workers;
+            std::vector<std::thread> m_threads;
+            uint32 m_nextWorker;
+
+            std::mutex m_stateLock;
+            std::condition_variable m_wake; // tasks pushed or shutting down
+            std::condition_variable m_idle; // last pending task finished
+            uint32 m_pending;               // pushed and not finished yet
+            bool m_stop;
+            std::map<uint32, uint32> m_mapTasks;
     };
 }
 
@@ -52,8 +52,8 @@ namespace VMAP
     // declared in src/shared/vmap/WorldModel.h
     void GroupModel::getMeshData(vector<Vector3>& outVertices, vector<MeshTriangle>& outTriangles, WmoLiquid*& liquid)
     {
-        outVertices = vertices;
-        outTriangles = triangles;
+        outVertices.assign(iVertices, iVertices + iVertexCount);
+        outTriangles.assign(iTriangles, iTriangles + iTriangleCount);
         liquid = iLiquid;
     }
 
@@ -85,6 +85,7 @@ void printUsage()
     printf("--buildGameObjects : builds only gameobject models for transports\n\n");
     printf("--buildAlternate : builds only tiles with GOs inside (including default tile)\n\n");
     printf("--threads [#]: specifies number of threads to use for maps processing\n\n");
+    printf("--force : rebuild all tiles, by default only tiles whose inputs changed since the last build are rebuilt\n\n");
     printf("--workdir [directory] : Path to basedir of maps/vmaps.\n\n");
     printf("Example:\nmovemapgen (generate all mmap with default arg\n"
            "movemapgen \"1 0 169\" (generate maps 1, 0 and 169)\n"
@@ -104,6 +105,7 @@ bool handleArgs(int argc, char** argv,
                 bool& silent,
                 bool& buildGameObjects,
                 bool& buildAlternate,
+                bool& forceRebuild,
                 char*& offMeshInputPath,
                 char*& configInputPath,
                 int& threads,
@@ -169,6 +171,10 @@ bool handleArgs(int argc, char** argv,
         {
             buildAlternate = true;
         }
+        else if (strcmp(argv[i], "--force") == 0)
+        {
+            forceRebuild = true;
+        }
         else if (strcmp(argv[i], "--offMeshInput") == 0 && i + 1 < argc)
         {
             param = argv[++i];
@@ -253,6 +259,7 @@ int main(int argc, char** argv)
     bool silent = false;
     bool buildGameObjects = false;
     bool buildAlternate = false;
+    bool forceRebuild = false;
 
     char* offMeshInputPath = "offmesh.txt";
     char* configInputPath = "config.json";
@@ -260,7 +267,7 @@ int main(int argc, char** argv)
 
     bool validParam = handleArgs(argc, argv, mapIds, tileX, tileY, skipLiquid,
                                  skipContinents, skipJunkMaps, skipBattlegrounds,
-                                 debug, silent, buildGameObjects, buildAlternate,
+                                 debug, silent, buildGameObjects, buildAlternate, forceRebuild,
                                  offMeshInputPath, configInputPath, threads, workdir);
 
     if (!validParam)
@@ -292,7 +299,7 @@ int main(int argc, char** argv)
     if (!checkDirectories(debug, workdir))
         return -3;
 
-    MapBuilder builder(configInputPath, threads, skipLiquid, skipContinents, skipJunkMaps, skipBattlegrounds, debug, buildAlternate, offMeshInputPath, workdir);
+    MapBuilder builder(configInputPath, threads, skipLiquid, skipContinents, skipJunkMaps, skipBattlegrounds, debug, buildAlternate, offMeshInputPath, workdir, forceRebuild);
 
     if (mapIds.size() == 1 && tileX > -1 && tileY > -1)
         builder.buildSingleTile(mapIds.front(), tileX, tileY);
@@ -0,0 +1,299 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Offline reader for chunked packet logs (PacketLog.Format = 1): prints a
+/// summary or the packets themselves and converts captures to PKT 3.1 for WPP.
+
+#include "Server/PacketLogReader.h"
+#include "Server/Opcodes.h"
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <set>
+
+namespace
+{
+    struct OpcodeTotals
+    {
+        OpcodeTotals() : count(0), bytes(0) {}
+
+        uint64 count;
+        uint64 bytes;
+    };
+
+    struct Filter
+    {
+        std::set<uint32> accounts;
+        std::set<uint32> connections;
+        std::set<uint32> opcodes;
+        int direction = -1;
+
+        bool Matches(PacketLogRecordHeader const& record) const
+        {
+            if (!accounts.empty() && accounts.find(record.accountId) == accounts.end())
+                return false;
+            if (!connections.empty() && connections.find(record.connectionId) == connections.end())
+                return false;
+            if (!opcodes.empty() && opcodes.find(record.opcode) == opcodes.end())
+                return false;
+            return direction < 0 || record.direction == uint8(direction);
+        }
+    };
+
+    char const* DirectionName(uint8 direction)
+    {
+        return direction == PACKET_LOG_CLIENT_TO_SERVER ? "CMSG" : "SMSG";
+    }
+
+    char const* OpcodeName(uint16 opcode)
+    {
+        return opcode < NUM_MSG_TYPES ? LookupOpcodeName(Opcodes(opcode)) : "UNKNOWN";
+    }
+
+    void DumpPayload(uint8 const* payload, uint32 size)
+    {
+        for (uint32 row = 0; row < size; row += 16)
+        {
+            printf("    %04X ", row);
+            for (uint32 i = row; i < row + 16; ++i)
+            {
+                if (i < size)
+                    printf(" %02X", payload[i]);
+                else
+                    printf("   ");
+            }
+            printf("  ");
+            for (uint32 i = row; i < row + 16 && i < size; ++i)
+                putchar(payload[i] >= 32 && payload[i] < 127 ? payload[i] : '.');
+            putchar('\n');
+        }
+    }
+
+#pragma pack(push, 1)
+    // same layout as the server writes with PacketLog.Format = 0
+    struct PktFileHeader
+    {
+        char Signature[3];
+        uint16 FormatVersion;
+        uint8 SnifferId;
+        uint32 Build;
+        char Locale[4];
+        uint8 SessionKey[40];
+        uint32 SniffStartUnixtime;
+        uint32 SniffStartTicks;
+        uint32 OptionalDataSize;
+    };
+
+    struct PktPacketHeader
+    {
+        uint32 Direction;
+        uint32 ConnectionId;
+        uint32 ArrivalTicks;
+        uint32 OptionalDataSize;
+        uint32 Length;
+        uint8 SocketIPBytes[16];
+        uint32 SocketPort;
+        uint32 Opcode;
+    };
+#pragma pack(pop)
+
+    FILE* OpenPkt(std::string const& path, PacketLogFileHeader const& source)
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file)
+            return nullptr;
+
+        PktFileHeader header;
+        memcpy(header.Signature, "PKT", 3);
+        header.FormatVersion = 0x0301;
+        header.SnifferId = 'T';
+        header.Build = source.build;
+        memcpy(header.Locale, "enUS", 4);
+        memset(header.SessionKey, 0, sizeof(header.SessionKey));
+        header.SniffStartUnixtime = source.startUnixtime;
+        header.SniffStartTicks = source.startTicks;
+        header.OptionalDataSize = 0;
+        fwrite(&header, sizeof(header), 1, file);
+        return file;
+    }
+
+    void WritePkt(FILE* file, PacketLogRecordHeader const& record, uint8 const* payload)
+    {
+        PktPacketHeader header;
+        header.Direction = record.direction == PACKET_LOG_CLIENT_TO_SERVER ? 0x47534d43 : 0x47534d53;
+        header.ConnectionId = record.connectionId;
+        header.ArrivalTicks = record.ticks;
+        header.OptionalDataSize = sizeof(header.SocketIPBytes) + sizeof(header.SocketPort);
+        header.Length = record.size + sizeof(header.Opcode);
+        memset(header.SocketIPBytes, 0, sizeof(header.SocketIPBytes));   // addresses are not kept in chunked captures
+        header.SocketPort = 0;
+        header.Opcode = record.opcode;
+
+        fwrite(&header, sizeof(header), 1, file);
+        if (record.size)
+            fwrite(payload, 1, record.size, file);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    namespace po = boost::program_options;
+
+    std::string input, pktOutput, direction;
+    std::vector<uint32> accounts, connections, opcodes;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "print usage and exit")
+    ("input,i", po::value<std::string>(&input), "chunked packet log written by mangosd")
+    ("list,l", "print one line per packet instead of the summary")
+    ("dump,d", "print one line per packet followed by its payload")
+    ("pkt", po::value<std::string>(&pktOutput), "write the selected packets to this PKT 3.1 file")
+    ("account,a", po::value<std::vector<uint32>>(&accounts)->composing(), "only packets of this account, repeatable")
+    ("connection,c", po::value<std::vector<uint32>>(&connections)->composing(), "only packets of this connection, repeatable")
+    ("opcode,o", po::value<std::vector<uint32>>(&opcodes)->composing(), "only packets with this opcode, repeatable")
+    ("direction", po::value<std::string>(&direction), "only cmsg or smsg packets");
+
+    po::positional_options_description positional;
+    positional.add("input", 1);
+
+    po::variables_map vm;
+    try
+    {
+        po::store(po::command_line_parser(argc, argv).options(desc).positional(positional).run(), vm);
+        po::notify(vm);
+    }
+    catch (po::error const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help") || input.empty())
+    {
+        std::cout << "Usage: packetlog [options] <capture>" << std::endl << desc << std::endl;
+        return input.empty() && !vm.count("help") ? 1 : 0;
+    }
+
+    Filter filter;
+    filter.accounts.insert(accounts.begin(), accounts.end());
+    filter.connections.insert(connections.begin(), connections.end());
+    filter.opcodes.insert(opcodes.begin(), opcodes.end());
+    if (direction == "cmsg")
+        filter.direction = PACKET_LOG_CLIENT_TO_SERVER;
+    else if (direction == "smsg")
+        filter.direction = PACKET_LOG_SERVER_TO_CLIENT;
+    else if (!direction.empty())
+    {
+        std::cerr << "ERROR: direction has to be cmsg or smsg" << std::endl;
+        return 1;
+    }
+
+    PacketLogReader reader;
+    if (!reader.Open(input))
+    {
+        std::cerr << "ERROR: " << reader.GetError() << std::endl;
+        return 1;
+    }
+
+    PacketLogFileHeader const& header = reader.GetFileHeader();
+    printf("Capture of build %u started at %u (ticks %u)\n", header.build, header.startUnixtime, header.startTicks);
+
+    FILE* pkt = nullptr;
+    if (!pktOutput.empty() && !(pkt = OpenPkt(pktOutput, header)))
+    {
+        std::cerr << "ERROR: cannot open " << pktOutput << " for writing" << std::endl;
+        return 1;
+    }
+
+    bool const list = vm.count("list") || vm.count("dump");
+    bool const dump = vm.count("dump") != 0;
+
+    std::map<uint32, OpcodeTotals> totals[2];
+    std::map<uint32, OpcodeTotals> perAccount;
+    uint64 selected = 0, skipped = 0;
+    uint32 firstTicks = 0, lastTicks = 0;
+
+    PacketLogRecordHeader record;
+    uint8 const* payload;
+    while (reader.Next(record, payload))
+    {
+        if (!filter.Matches(record))
+        {
+            ++skipped;
+            continue;
+        }
+
+        if (!selected)
+            firstTicks = record.ticks;
+        lastTicks = record.ticks;
+        ++selected;
+
+        OpcodeTotals& opcodeTotals = totals[record.direction == PACKET_LOG_CLIENT_TO_SERVER ? 0 : 1][record.opcode];
+        ++opcodeTotals.count;
+        opcodeTotals.bytes += record.size;
+        ++perAccount[record.accountId].count;
+        perAccount[record.accountId].bytes += record.size;
+
+        if (list)
+            printf("%10u account %u conn %u %s %s (0x%04X) size %u\n", record.ticks - header.startTicks, record.accountId,
+                   record.connectionId, DirectionName(record.direction), OpcodeName(record.opcode), record.opcode, record.size);
+        if (dump)
+            DumpPayload(payload, record.size);
+        if (pkt)
+            WritePkt(pkt, record, payload);
+    }
+
+    if (pkt)
+        fclose(pkt);
+
+    if (!reader.GetError().empty())
+        std::cerr << "ERROR: " << reader.GetError() << ", output stops there" << std::endl;
+
+    if (!list)
+    {
+        printf("%u chunks, " UI64FMTD " packets selected, " UI64FMTD " filtered out, %.1f seconds\n", reader.GetChunksRead(), selected, skipped,
+               selected ? (lastTicks - firstTicks) / 1000.0f : 0.0f);
+
+        for (uint32 i = 0; i < 2; ++i)
+        {
+            std::vector<std::pair<uint32, OpcodeTotals>> sorted(totals[i].begin(), totals[i].end());
+            std::sort(sorted.begin(), sorted.end(), [](std::pair<uint32, OpcodeTotals> const& a, std::pair<uint32, OpcodeTotals> const& b)
+            {
+                return a.second.bytes > b.second.bytes;
+            });
+
+            printf("\n%s by volume:\n", i == 0 ? "Client packets" : "Server packets");
+            for (auto const& entry : sorted)
+                printf("  %-40s %10" PRIu64 " packets %12" PRIu64 " bytes\n", OpcodeName(uint16(entry.first)), entry.second.count, entry.second.bytes);
+        }
+
+        printf("\nAccounts:\n");
+        for (auto const& entry : perAccount)
+            printf("  %-10u %10" PRIu64 " packets %12" PRIu64 " bytes\n", entry.first, entry.second.count, entry.second.bytes);
+    }
+
+    return reader.GetError().empty() ? 0 : 2;
+}
@@ -18,15 +18,36 @@
 
 #include <string>
 #include <iostream>
+#include <cstdlib>
+#include <thread>
 
 #include "TileAssembler.h"
 
 //=======================================================
 int main(int argc, char* argv[])
 {
-    if (argc != 3)
+    bool compact = false;
+    bool valid = argc >= 3;
+    unsigned int threads = 1;
+    for (int i = 3; i < argc && valid; ++i)
     {
-        std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir>" << std::endl;
+        std::string arg = argv[i];
+        if (arg == "--compact")
+            compact = true;
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            threads = std::atoi(argv[++i]);
+            if (!threads)                                   // 0 = all cores
+                threads = std::thread::hardware_concurrency();
+        }
+        else
+            valid = false;
+    }
+
+    if (!valid)
+    {
+        std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir> [--compact] [--threads N]" << std::endl;
+        std::cout << "       --threads N   convert maps and models on N threads, 0 uses all cores (default 1)" << std::endl;
         return 1;
     }
 
@@ -36,6 +57,8 @@ int main(int argc, char* argv[])
     std::cout << "using " << src << " as source directory and writing output to " << dest << std::endl;
 
     VMAP::TileAssembler* ta = new VMAP::TileAssembler(src, dest);
+    ta->setCompactModels(compact);
+    ta->setThreads(threads);
 
     if (!ta->convertWorld2())
     {
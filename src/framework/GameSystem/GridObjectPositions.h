@@ -0,0 +1,97 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _GRIDOBJECTPOSITIONS_H
+#define _GRIDOBJECTPOSITIONS_H
+
+#include "Platform/Define.h"
+#include <vector>
+
+// Hot positional data of one object stored in a grid cell
+struct GridObjectPosition
+{
+    GridObjectPosition() : x(0.0f), y(0.0f), z(0.0f), radius(0.0f), flags(0) {}
+    GridObjectPosition(float _x, float _y, float _z, float _radius, uint32 _flags) : x(_x), y(_y), z(_z), radius(_radius), flags(_flags) {}
+
+    float x;
+    float y;
+    float z;
+    float radius;                                           // larger of bounding radius and combat reach
+    uint32 flags;                                           // phase mask of the object
+};
+
+// Structure of arrays holding the GridObjectPosition of every object of one type in a cell,
+// ordered like the object array of the owning GridRefManager. Range checks walk these arrays
+// linearly and only dereference the objects that pass.
+class GridPositionBlock
+{
+    public:
+        size_t size() const { return m_x.size(); }
+        bool empty() const { return m_x.empty(); }
+
+        float const* X() const { return m_x.data(); }
+        float const* Y() const { return m_y.data(); }
+        float const* Z() const { return m_z.data(); }
+        float const* Radius() const { return m_radius.data(); }
+        uint32 const* Flags() const { return m_flags.data(); }
+
+        GridObjectPosition Get(size_t index) const
+        {
+            return GridObjectPosition(m_x[index], m_y[index], m_z[index], m_radius[index], m_flags[index]);
+        }
+
+        void Set(size_t index, GridObjectPosition const& pos)
+        {
+            m_x[index] = pos.x;
+            m_y[index] = pos.y;
+            m_z[index] = pos.z;
+            m_radius[index] = pos.radius;
+            m_flags[index] = pos.flags;
+        }
+
+        void PushBack(GridObjectPosition const& pos)
+        {
+            m_x.push_back(pos.x);
+            m_y.push_back(pos.y);
+            m_z.push_back(pos.z);
+            m_radius.push_back(pos.radius);
+            m_flags.push_back(pos.flags);
+        }
+
+        // moves the last entry into index and drops the last slot
+        void SwapRemove(size_t index)
+        {
+            size_t const last = m_x.size() - 1;
+            if (index != last)
+                Set(index, Get(last));
+            m_x.pop_back();
+            m_y.pop_back();
+            m_z.pop_back();
+            m_radius.pop_back();
+            m_flags.pop_back();
+        }
+
+    private:
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_z;
+        std::vector<float> m_radius;
+        std::vector<uint32> m_flags;
+};
+
+#endif
@@ -20,16 +20,26 @@
 #define _GRIDREFMANAGER
 
 #include "Utilities/LinkedReference/RefManager.h"
+#include "GameSystem/GridObjectPositions.h"
 
 template<class OBJECT> class GridReference;
 
+// Besides the intrusive list used by the visitors, every linked object is kept in a
+// contiguous array with its hot positional data in a parallel GridPositionBlock.
+// Removal swaps the last entry into the freed slot, the moved reference carries its
+// new index, so array order is not stable while list order is.
 template<class OBJECT>
 class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
 {
+        friend class GridReference<OBJECT>;
+
     public:
 
         typedef LinkedListHead::Iterator< GridReference<OBJECT> > iterator;
 
+        // the arrays must still be alive while the base class invalidates the references
+        ~GridRefManager() { this->clearReferences(); }
+
         GridReference<OBJECT>* getFirst()
         {
             return (GridReference<OBJECT>*)RefManager<GridRefManager<OBJECT>, OBJECT>::getFirst();
@@ -44,5 +54,39 @@ class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
         iterator end() { return iterator(nullptr); }
         iterator rbegin() { return iterator(getLast()); }
         iterator rend() { return iterator(nullptr); }
+
+        OBJECT* const* GetObjects() const { return m_objects.data(); }
+        GridPositionBlock const& GetPositions() const { return m_positions; }
+        size_t GetArraySize() const { return m_objects.size(); }
+
+    private:
+        void AddToArray(GridReference<OBJECT>* ref)
+        {
+            ref->m_arrayIndex = uint32(m_objects.size());
+            m_objects.push_back(ref->getSource());
+            m_refs.push_back(ref);
+            m_positions.PushBack(ref->m_position);
+        }
+
+        void RemoveFromArray(GridReference<OBJECT>* ref)
+        {
+            uint32 const index = ref->m_arrayIndex;
+            uint32 const last = uint32(m_objects.size() - 1);
+            if (index != last)
+            {
+                m_objects[index] = m_objects[last];
+                m_refs[index] = m_refs[last];
+                m_refs[index]->m_arrayIndex = index;
+            }
+            m_objects.pop_back();
+            m_refs.pop_back();
+            m_positions.SwapRemove(index);
+        }
+
+        void SetArrayPosition(uint32 index, GridObjectPosition const& pos) { m_positions.Set(index, pos); }
+
+        std::vector<OBJECT*> m_objects;
+        std::vector<GridReference<OBJECT>*> m_refs;
+        GridPositionBlock m_positions;
 };
 #endif
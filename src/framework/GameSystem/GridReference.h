@@ -20,12 +20,15 @@
 #define _GRIDREFERENCE_H
 
 #include "Utilities/LinkedReference/Reference.h"
+#include "GameSystem/GridObjectPositions.h"
 
 template<class OBJECT> class GridRefManager;
 
 template<class OBJECT>
 class GridReference : public Reference<GridRefManager<OBJECT>, OBJECT>
 {
+        friend class GridRefManager<OBJECT>;
+
     protected:
 
         void targetObjectBuildLink() override
@@ -33,25 +36,30 @@ class GridReference : public Reference<GridRefManager<OBJECT>, OBJECT>
             // called from link()
             this->getTarget()->insertFirst(this);
             this->getTarget()->incSize();
+            this->getTarget()->AddToArray(this);
         }
 
         void targetObjectDestroyLink() override
         {
             // called from unlink()
             if (this->isValid())
+            {
                 this->getTarget()->decSize();
+                this->getTarget()->RemoveFromArray(this);
+            }
         }
 
         void sourceObjectDestroyLink() override
         {
             // called from invalidate()
             this->getTarget()->decSize();
+            this->getTarget()->RemoveFromArray(this);
         }
 
     public:
 
         GridReference()
-            : Reference<GridRefManager<OBJECT>, OBJECT>()
+            : Reference<GridRefManager<OBJECT>, OBJECT>(), m_arrayIndex(0)
         {
         }
 
@@ -64,6 +72,18 @@ class GridReference : public Reference<GridRefManager<OBJECT>, OBJECT>
         {
             return (GridReference*)Reference<GridRefManager<OBJECT>, OBJECT>::next();
         }
+
+        // kept across relinks, so moving to another cell carries the last known position
+        void UpdatePosition(GridObjectPosition const& pos)
+        {
+            m_position = pos;
+            if (this->isValid())
+                this->getTarget()->SetArrayPosition(m_arrayIndex, pos);
+        }
+
+    private:
+        GridObjectPosition m_position;
+        uint32 m_arrayIndex;                                // slot in the target's object array, valid while linked
 };
 
 #endif
@@ -18,9 +18,32 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    uint32 LowestSetBit(uint64 value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return uint32(index);
+#else
+        return uint32(__builtin_ctzll(value));
+#endif
+    }
+}
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_wheelTime = 0;
+    m_sequence = 0;
+    m_eventCount = 0;
     m_aborting = false;
 }
 
@@ -35,12 +58,11 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (EventNode* node = PopExpired())
     {
         // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        BasicEvent* Event = node->event;
+        delete node;
 
         if (!Event->to_Abort)
         {
@@ -56,6 +78,8 @@ void EventProcessor::Update(uint32 p_time)
             delete Event;
         }
     }
+
+    ReleaseWheelIfEmpty();
 }
 
 void EventProcessor::KillAllEvents(bool force)
@@ -63,39 +87,71 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
+    if (!m_wheel)
+        return;
+
+    // detach every slot first, events kept alive are scheduled again afterwards
+    EventNode* detached[WHEEL_OVERFLOW_SLOT + 1];
+    std::copy(std::begin(m_wheel->slots), std::end(m_wheel->slots), detached);
+    std::fill(std::begin(m_wheel->slots), std::end(m_wheel->slots), nullptr);
+    std::fill(std::begin(m_wheel->occupied), std::end(m_wheel->occupied), 0);
+
     // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    for (EventNode* head : detached)
     {
-        EventList::iterator i_old = i;
-        ++i;
+        if (!head)
+            continue;
 
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
+        head->prev->next = nullptr;                     // open the circle
+        for (EventNode* node = head; node;)
         {
-            delete i_old->second;
+            EventNode* next = node->next;
 
-            if (!force)                                     // need per-element cleanup
-                m_events.erase(i_old);
+            node->event->to_Abort = true;
+            node->event->Abort(m_time);
+            if (force || node->event->IsDeletable())
+            {
+                delete node->event;
+                delete node;
+                --m_eventCount;
+            }
+            else
+                Schedule(node);
+
+            node = next;
         }
     }
 
-    // fast clear event list (in force case)
-    if (force)
-        m_events.clear();
+    ReleaseWheelIfEmpty();
 }
 
 void EventProcessor::KillEvent(BasicEvent* event)
 {
-    for (EventList::iterator iter = m_events.begin(); iter != m_events.end();)
+    if (!m_wheel)
+        return;
+
+    bool found = false;
+    for (EventNode*& head : m_wheel->slots)
     {
-        if (iter->second == event)
+        EventNode* node = head;
+        while (node)
         {
-            delete iter->second;
-            iter = m_events.erase(iter);
+            EventNode* next = node->next != head ? node->next : nullptr;
+            if (node->event == event)
+            {
+                Unlink(node);
+                delete node;
+                --m_eventCount;
+                found = true;
+            }
+            node = next;
         }
-        else ++iter;
     }
+
+    if (found)
+        delete event;
+
+    ReleaseWheelIfEmpty();
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -104,20 +160,43 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+
+    if (!m_wheel)
+        m_wheel.reset(new EventWheel());
+
+    EventNode* node = new EventNode;
+    node->event = Event;
+    node->time = e_time;
+    node->sequence = m_sequence++;
+    Schedule(node);
+    ++m_eventCount;
 }
 
 void EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 msTime)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end(); ++itr)
+    if (!m_wheel)
+        return;
+
+    for (EventNode* head : m_wheel->slots)
     {
-        if (itr->second != Event)
+        if (!head)
             continue;
 
-        Event->m_execTime = msTime;
-        m_events.erase(itr);
-        m_events.insert(std::pair<uint64, BasicEvent*>(msTime, Event));
-        break;
+        EventNode* node = head;
+        do
+        {
+            if (node->event == Event)
+            {
+                Event->m_execTime = msTime;
+                Unlink(node);
+                node->time = msTime;
+                node->sequence = m_sequence++;
+                Schedule(node);
+                return;
+            }
+            node = node->next;
+        }
+        while (node != head);
     }
 }
 
@@ -125,3 +204,149 @@ uint64 EventProcessor::CalculateTime(uint64 t_offset) const
 {
     return m_time + t_offset;
 }
+
+void EventProcessor::Schedule(EventNode* node)
+{
+    // events already due go to the current slot and run in this or the next update
+    uint64 const time = std::max(node->time, m_wheelTime);
+    uint64 const delta = time - m_wheelTime;
+
+    node->slot = WHEEL_OVERFLOW_SLOT;
+    for (uint32 level = 0; level < WHEEL_LEVELS; ++level)
+    {
+        if (delta >= (uint64(1) << (WHEEL_LEVEL_BITS * (level + 1))))
+            continue;
+
+        uint32 const index = uint32(time >> (WHEEL_LEVEL_BITS * level)) & (WHEEL_LEVEL_SLOTS - 1);
+        node->slot = level * WHEEL_LEVEL_SLOTS + index;
+        m_wheel->occupied[level] |= uint64(1) << index;
+        break;
+    }
+
+    EventNode*& head = m_wheel->slots[node->slot];
+    if (!head)
+    {
+        node->prev = node;
+        node->next = node;
+        head = node;
+        return;
+    }
+
+    // keep slots ordered by due time and insertion, new events nearly always go last
+    auto later = [](EventNode const* lhs, EventNode const* rhs)
+    {
+        return lhs->time != rhs->time ? lhs->time > rhs->time : lhs->sequence > rhs->sequence;
+    };
+
+    EventNode* before = head->prev;
+    while (later(before, node))
+    {
+        if (before == head)
+        {
+            node->next = head;
+            node->prev = head->prev;
+            head->prev->next = node;
+            head->prev = node;
+            head = node;
+            return;
+        }
+        before = before->prev;
+    }
+
+    node->prev = before;
+    node->next = before->next;
+    before->next->prev = node;
+    before->next = node;
+}
+
+void EventProcessor::Unlink(EventNode* node)
+{
+    EventNode*& head = m_wheel->slots[node->slot];
+    if (node->next == node)
+    {
+        head = nullptr;
+        if (node->slot < WHEEL_OVERFLOW_SLOT)
+            m_wheel->occupied[node->slot / WHEEL_LEVEL_SLOTS] &= ~(uint64(1) << (node->slot % WHEEL_LEVEL_SLOTS));
+        return;
+    }
+
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    if (head == node)
+        head = node->next;
+}
+
+EventProcessor::EventNode* EventProcessor::PopExpired()
+{
+    while (true)
+    {
+        if (!m_eventCount)
+        {
+            m_wheelTime = m_time;
+            return nullptr;
+        }
+
+        uint32 const index = uint32(m_wheelTime) & (WHEEL_LEVEL_SLOTS - 1);
+        if (EventNode* node = m_wheel->slots[index])
+        {
+            Unlink(node);
+            --m_eventCount;
+            return node;
+        }
+
+        if (m_wheelTime >= m_time)
+            return nullptr;
+
+        // skip to the next occupied slot of this level 0 round, or to the start of the next round
+        uint64 const pending = index + 1 < WHEEL_LEVEL_SLOTS ? m_wheel->occupied[0] & (~uint64(0) << (index + 1)) : 0;
+        uint64 const roundStart = m_wheelTime & ~uint64(WHEEL_LEVEL_SLOTS - 1);
+        uint64 const next = pending ? roundStart + LowestSetBit(pending) : roundStart + WHEEL_LEVEL_SLOTS;
+        if (next > m_time)
+        {
+            m_wheelTime = m_time;
+            return nullptr;
+        }
+
+        m_wheelTime = next;
+        if (!(m_wheelTime & (WHEEL_LEVEL_SLOTS - 1)))
+            Cascade();
+    }
+}
+
+void EventProcessor::Cascade()
+{
+    // higher levels first, their events may land in the lower slot reached at the same time
+    for (uint32 level = WHEEL_LEVELS; level > 0; --level)
+    {
+        uint32 const shift = WHEEL_LEVEL_BITS * level;
+        if (m_wheelTime & ((uint64(1) << shift) - 1))
+            continue;
+
+        uint32 slot = WHEEL_OVERFLOW_SLOT;
+        if (level < WHEEL_LEVELS)
+        {
+            uint32 const index = uint32(m_wheelTime >> shift) & (WHEEL_LEVEL_SLOTS - 1);
+            slot = level * WHEEL_LEVEL_SLOTS + index;
+            m_wheel->occupied[level] &= ~(uint64(1) << index);
+        }
+
+        EventNode* head = m_wheel->slots[slot];
+        if (!head)
+            continue;
+
+        m_wheel->slots[slot] = nullptr;
+        head->prev->next = nullptr;                         // open the circle
+        for (EventNode* node = head; node;)
+        {
+            EventNode* next = node->next;
+            Schedule(node);
+            node = next;
+        }
+    }
+}
+
+void EventProcessor::ReleaseWheelIfEmpty()
+{
+    if (!m_eventCount)
+        m_wheel.reset();
+}
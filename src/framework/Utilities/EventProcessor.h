@@ -20,8 +20,9 @@
 #define __EVENTPROCESSOR_H
 
 #include "Platform/Define.h"
+#include "Util/BlockPool.h"
 
-#include <map>
+#include <memory>
 
 // Note. All times are in milliseconds here.
 
@@ -55,8 +56,12 @@ class BasicEvent
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
-
+// Events are kept in a hierarchical timing wheel with 1ms resolution.
+// Each of the WHEEL_LEVELS levels has 64 slots, a slot of level n covers 64^n ms,
+// events further away than the whole wheel wait in an overflow slot. Inserting is a
+// constant time slot pick, expiring walks occupied slots only and moves the events
+// of a coarse slot one level down once its time range is reached. Events due at the
+// same time run in insertion order. The wheel is only allocated while events exist.
 class EventProcessor
 {
     public:
@@ -70,12 +75,67 @@ class EventProcessor
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         void ModifyEventTime(BasicEvent* event, uint64 msTime);
         uint64 CalculateTime(uint64 t_offset) const;
-        EventList& GetEvents() { return m_events; }
+
+        // calls worker for every queued event, events must not be added or removed meanwhile
+        template<typename Worker>
+        void ForEachEvent(Worker&& worker) const
+        {
+            if (!m_wheel)
+                return;
+
+            for (EventNode* head : m_wheel->slots)
+            {
+                if (!head)
+                    continue;
+
+                EventNode* node = head;
+                do
+                {
+                    worker(node->event);
+                    node = node->next;
+                }
+                while (node != head);
+            }
+        }
 
     protected:
 
+        static uint32 const WHEEL_LEVELS = 4;
+        static uint32 const WHEEL_LEVEL_BITS = 6;
+        static uint32 const WHEEL_LEVEL_SLOTS = 1 << WHEEL_LEVEL_BITS;
+        static uint32 const WHEEL_OVERFLOW_SLOT = WHEEL_LEVELS * WHEEL_LEVEL_SLOTS;
+
+        struct EventNode
+        {
+            BasicEvent* event;
+            uint64 time;
+            uint64 sequence;                                // insertion order among events due at the same time
+            EventNode* prev;                                // slot lists are circular, head->prev is the tail
+            EventNode* next;
+            uint32 slot;
+
+            BLOCK_POOL_ALLOCATED
+        };
+
+        struct EventWheel
+        {
+            EventNode* slots[WHEEL_OVERFLOW_SLOT + 1];
+            uint64 occupied[WHEEL_LEVELS];                  // bit per non empty slot of each level
+
+            BLOCK_POOL_ALLOCATED
+        };
+
+        void Schedule(EventNode* node);
+        void Unlink(EventNode* node);
+        EventNode* PopExpired();
+        void Cascade();
+        void ReleaseWheelIfEmpty();
+
         uint64 m_time;
-        EventList m_events;
+        uint64 m_wheelTime;                                 // time the wheel has been advanced to, trails m_time during Update
+        uint64 m_sequence;
+        uint32 m_eventCount;
+        std::unique_ptr<EventWheel> m_wheel;
         bool m_aborting;
 };
 
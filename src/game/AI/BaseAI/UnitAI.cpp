@@ -597,6 +597,7 @@ class AiDelayEventAround : public BasicEvent
             {
                 if (Creature* pReceiver = m_owner.GetMap()->GetAnyTypeCreature(*itr))
                 {
+                    pReceiver->WakeFromDormancy();
                     pReceiver->AI()->ReceiveAIEvent(m_eventType, &m_owner, pInvoker, m_miscValue);
                     // Special case for type 0 (call-assistance)
                     if (m_eventType == AI_EVENT_CALL_ASSISTANCE)
@@ -650,6 +651,7 @@ void UnitAI::SendAIEventAround(AIEventType eventType, Unit* invoker, uint32 dela
             {
                 for (Creature* receiver : receiverList)
                 {
+                    receiver->WakeFromDormancy();
                     receiver->AI()->ReceiveAIEvent(eventType, m_unit, invoker, miscValue);
                     // Special case for type 0 (call-assistance)
                     if (eventType == AI_EVENT_CALL_ASSISTANCE)
@@ -663,6 +665,8 @@ void UnitAI::SendAIEventAround(AIEventType eventType, Unit* invoker, uint32 dela
 void UnitAI::SendAIEvent(AIEventType eventType, Unit* invoker, Unit* receiver, uint32 miscValue /*=0*/) const
 {
     MANGOS_ASSERT(receiver);
+    if (receiver->IsCreature())
+        static_cast<Creature*>(receiver)->WakeFromDormancy();
     receiver->AI()->ReceiveAIEvent(eventType, m_unit, invoker, miscValue);
 }
 
@@ -103,7 +103,7 @@ CreatureEventAI::CreatureEventAI(Creature* creature) : CreatureAI(creature),
     m_LastSpellMaxRange(0),
     m_despawnAggregationMask(0)
 {
-
+    std::fill(std::begin(m_eventTypeStart), std::end(m_eventTypeStart), 0);
 }
 
 void CreatureEventAI::InitAI()
@@ -202,6 +202,31 @@ void CreatureEventAI::InitAI()
         const CreatureEventAI_Event_Vec& creatureEvent = creatureEventsGuidItr->second;
         processMap(creatureEvent);
     }
+
+    BuildEventTypeIndex();
+}
+
+void CreatureEventAI::BuildEventTypeIndex()
+{
+    // counting sort on the event type, stable so events of one type keep their list order
+    uint32 counts[EVENT_T_END] = {};
+    for (auto const& holder : m_CreatureEventAIList)
+        if (holder.event.event_type < EVENT_T_END)
+            ++counts[holder.event.event_type];
+
+    m_eventTypeStart[0] = 0;
+    for (uint32 type = 0; type < EVENT_T_END; ++type)
+        m_eventTypeStart[type + 1] = uint16(m_eventTypeStart[type] + counts[type]);
+
+    m_eventsByType.assign(m_eventTypeStart[EVENT_T_END], 0);
+    uint16 next[EVENT_T_END];
+    std::copy(m_eventTypeStart, m_eventTypeStart + EVENT_T_END, next);
+    for (uint32 i = 0; i < m_CreatureEventAIList.size(); ++i)
+    {
+        uint32 const type = m_CreatureEventAIList[i].event.event_type;
+        if (type < EVENT_T_END)
+            m_eventsByType[next[type]++] = uint16(i);
+    }
 }
 
 bool CreatureEventAI::IsTimerExecutedEvent(EventAI_Type type) const
@@ -1492,11 +1517,10 @@ void CreatureEventAI::Reset()
 void CreatureEventAI::JustReachedHome()
 {
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    ForEachEventOfType(EVENT_T_REACHED_HOME, [&](CreatureEventAIHolder& holder)
     {
-        if (i.event.event_type == EVENT_T_REACHED_HOME)
-            CheckAndReadyEventForExecution(i);
-    }
+        CheckAndReadyEventForExecution(holder);
+    });
     ProcessEvents();
 
     Reset();
@@ -1508,11 +1532,10 @@ void CreatureEventAI::EnterEvadeMode()
 
     // Handle Evade events
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    ForEachEventOfType(EVENT_T_EVADE, [&](CreatureEventAIHolder& holder)
     {
-        if (i.event.event_type == EVENT_T_EVADE)
-            CheckAndReadyEventForExecution(i);
-    }
+        CheckAndReadyEventForExecution(holder);
+    });
     ProcessEvents();
 
     if ((m_despawnAggregationMask & AGGREGATION_EVADE) != 0)
@@ -1529,11 +1552,10 @@ void CreatureEventAI::JustDied(Unit* killer)
 
     // Handle On Death events
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    ForEachEventOfType(EVENT_T_DEATH, [&](CreatureEventAIHolder& holder)
     {
-        if (i.event.event_type == EVENT_T_DEATH)
-            CheckAndReadyEventForExecution(i, killer);
-    }
+        CheckAndReadyEventForExecution(holder, killer);
+    });
     ProcessEvents(killer);
 
     // reset phase after any death state events
@@ -1546,22 +1568,20 @@ void CreatureEventAI::JustDied(Unit* killer)
 void CreatureEventAI::KilledUnit(Unit* victim)
 {
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    ForEachEventOfType(EVENT_T_KILL, [&](CreatureEventAIHolder& holder)
     {
-        if (i.event.event_type == EVENT_T_KILL)
-            CheckAndReadyEventForExecution(i, victim);
-    }
+        CheckAndReadyEventForExecution(holder, victim);
+    });
     ProcessEvents(victim);
 }
 
 void CreatureEventAI::JustSummoned(Creature* summoned)
 {
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    ForEachEventOfType(EVENT_T_SUMMONED_UNIT, [&](CreatureEventAIHolder& holder)
     {
-        if (i.event.event_type == EVENT_T_SUMMONED_UNIT)
-            CheckAndReadyEventForExecution(i, summoned);
-    }
+        CheckAndReadyEventForExecution(holder, summoned);
+    });
     ProcessEvents(summoned);
     if ((m_despawnAggregationMask & AGGREGATION_ENABLED) != 0)
         if (m_entriesForDespawn.empty() || m_entriesForDespawn.find(summoned->GetEntry()) != m_entriesForDespawn.end())
@@ -1571,22 +1591,20 @@ void CreatureEventAI::JustSummoned(Creature* summoned)
 void CreatureEventAI::SummonedCreatureJustDied(Creature* summoned)
 {
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    ForEachEventOfType(EVENT_T_SUMMONED_JUST_DIED, [&](CreatureEventAIHolder& holder)
     {
-        if (i.event.event_type == EVENT_T_SUMMONED_JUST_DIED)
-            CheckAndReadyEventForExecution(i, summoned);
-    }
+        CheckAndReadyEventForExecution(holder, summoned);
+    });
     ProcessEvents(summoned);
 }
 
 void CreatureEventAI::SummonedCreatureDespawn(Creature* summoned)
 {
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    ForEachEventOfType(EVENT_T_SUMMONED_JUST_DESPAWN, [&](CreatureEventAIHolder& holder)
     {
-        if (i.event.event_type == EVENT_T_SUMMONED_JUST_DESPAWN)
-            CheckAndReadyEventForExecution(i, summoned);
-    }
+        CheckAndReadyEventForExecution(holder, summoned);
+    });
     ProcessEvents(summoned);
 }
 
@@ -1595,12 +1613,11 @@ void CreatureEventAI::ReceiveAIEvent(AIEventType eventType, Unit* sender, Unit*
     MANGOS_ASSERT(sender);
 
     IncreaseDepthIfNecessary();
-    for (auto& itr : m_CreatureEventAIList)
+    ForEachEventOfType(EVENT_T_RECEIVE_AI_EVENT, [&](CreatureEventAIHolder& holder)
     {
-        if (itr.event.event_type == EVENT_T_RECEIVE_AI_EVENT &&
-                itr.event.receiveAIEvent.eventType == uint32(eventType) && (!itr.event.receiveAIEvent.senderEntry || itr.event.receiveAIEvent.senderEntry == sender->GetEntry()))
-            CheckAndReadyEventForExecution(itr, invoker, sender);
-    }
+        if (holder.event.receiveAIEvent.eventType == uint32(eventType) && (!holder.event.receiveAIEvent.senderEntry || holder.event.receiveAIEvent.senderEntry == sender->GetEntry()))
+            CheckAndReadyEventForExecution(holder, invoker, sender);
+    });
     ProcessEvents(invoker, sender);
 }
 
@@ -1655,27 +1672,24 @@ void CreatureEventAI::MoveInLineOfSight(Unit* who)
     IncreaseDepthIfNecessary();
     if (m_HasOOCLoSEvent && !m_creature->GetVictim())
     {
-        for (auto& itr : m_CreatureEventAIList)
+        ForEachEventOfType(EVENT_T_OOC_LOS, [&](CreatureEventAIHolder& holder)
         {
-            if (itr.event.event_type == EVENT_T_OOC_LOS)
-            {
-                // can trigger if closer than fMaxAllowedRange
-                float fMaxAllowedRange = (float)itr.event.ooc_los.maxRange;
+            // can trigger if closer than fMaxAllowedRange
+            float fMaxAllowedRange = (float)holder.event.ooc_los.maxRange;
 
-                // who must be player type if this option is turned on
-                if (!itr.event.ooc_los.playerOnly || who->GetTypeId() == TYPEID_PLAYER)
+            // who must be player type if this option is turned on
+            if (!holder.event.ooc_los.playerOnly || who->GetTypeId() == TYPEID_PLAYER)
+            {
+                // if friendly event && who is not hostile OR hostile event && who is hostile
+                if ((holder.event.ooc_los.noHostile && !m_creature->IsEnemy(who)) ||
+                        ((!holder.event.ooc_los.noHostile) && m_creature->IsEnemy(who)))
                 {
-                    // if friendly event && who is not hostile OR hostile event && who is hostile
-                    if ((itr.event.ooc_los.noHostile && !m_creature->IsEnemy(who)) ||
-                            ((!itr.event.ooc_los.noHostile) && m_creature->IsEnemy(who)))
-                    {
-                        // if range is ok and we are actually in LOS
-                        if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
-                            CheckAndReadyEventForExecution(itr, who);
-                    }
+                    // if range is ok and we are actually in LOS
+                    if (m_creature->IsWithinDistInMap(who, fMaxAllowedRange) && m_creature->IsWithinLOSInMap(who))
+                        CheckAndReadyEventForExecution(holder, who);
                 }
             }
-        }
+        });
         ProcessEvents(who);
     }
 
@@ -1685,12 +1699,13 @@ void CreatureEventAI::MoveInLineOfSight(Unit* who)
 void CreatureEventAI::SpellHit(Unit* unit, const SpellEntry* spellInfo)
 {
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-        if (i.event.event_type == EVENT_T_SPELLHIT)
-            // If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            if (!i.event.spell_hit.spellId || spellInfo->Id == i.event.spell_hit.spellId)
-                if (spellInfo->SchoolMask & i.event.spell_hit.schoolMask)
-                    CheckAndReadyEventForExecution(i, unit);
+    ForEachEventOfType(EVENT_T_SPELLHIT, [&](CreatureEventAIHolder& holder)
+    {
+        // If spell id matches (or no spell id) & if spell school matches (or no spell school)
+        if (!holder.event.spell_hit.spellId || spellInfo->Id == holder.event.spell_hit.spellId)
+            if (spellInfo->SchoolMask & holder.event.spell_hit.schoolMask)
+                CheckAndReadyEventForExecution(holder, unit);
+    });
 
     ProcessEvents(unit);
 }
@@ -1698,12 +1713,13 @@ void CreatureEventAI::SpellHit(Unit* unit, const SpellEntry* spellInfo)
 void CreatureEventAI::SpellHitTarget(Unit* target, const SpellEntry* spellInfo)
 {
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-        if (i.event.event_type == EVENT_T_SPELLHIT_TARGET)
-            // If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            if (!i.event.spell_hit_target.spellId || spellInfo->Id == i.event.spell_hit_target.spellId)
-                if (spellInfo->SchoolMask & i.event.spell_hit_target.schoolMask)
-                    CheckAndReadyEventForExecution(i, target);
+    ForEachEventOfType(EVENT_T_SPELLHIT_TARGET, [&](CreatureEventAIHolder& holder)
+    {
+        // If spell id matches (or no spell id) & if spell school matches (or no spell school)
+        if (!holder.event.spell_hit_target.spellId || spellInfo->Id == holder.event.spell_hit_target.spellId)
+            if (spellInfo->SchoolMask & holder.event.spell_hit_target.schoolMask)
+                CheckAndReadyEventForExecution(holder, target);
+    });
 
     ProcessEvents(target);
 }
@@ -1846,16 +1862,11 @@ inline Unit* CreatureEventAI::GetTargetByType(uint32 target, Unit* actionInvoker
 void CreatureEventAI::ReceiveEmote(Player* player, uint32 textEmote)
 {
     IncreaseDepthIfNecessary();
-    for (auto& itr : m_CreatureEventAIList)
+    ForEachEventOfType(EVENT_T_RECEIVE_EMOTE, [&](CreatureEventAIHolder& holder)
     {
-        if (itr.event.event_type == EVENT_T_RECEIVE_EMOTE)
-        {
-            if (itr.event.receive_emote.emoteId != textEmote)
-                continue;
-
-            CheckAndReadyEventForExecution(itr, player);
-        }
-    }
+        if (holder.event.receive_emote.emoteId == textEmote)
+            CheckAndReadyEventForExecution(holder, player);
+    });
     ProcessEvents(player);
 }
 
@@ -1896,10 +1907,10 @@ void CreatureEventAI::DamageTaken(Unit* dealer, uint32& damage, DamageEffectType
 void CreatureEventAI::JustPreventedDeath(Unit* attacker)
 {
     IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
-        if (i.event.event_type == EVENT_T_DEATH_PREVENTED)
-            // If spell id matches (or no spell id) & if spell school matches (or no spell school)
-            CheckAndReadyEventForExecution(i, attacker);
+    ForEachEventOfType(EVENT_T_DEATH_PREVENTED, [&](CreatureEventAIHolder& holder)
+    {
+        CheckAndReadyEventForExecution(holder, attacker);
+    });
 
     ProcessEvents(attacker);
 }
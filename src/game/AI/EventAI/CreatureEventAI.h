@@ -906,6 +906,15 @@ class CreatureEventAI : public CreatureAI
         bool IsRepeatableEvent(EventAI_Type type) const;
         bool IsTimerBasedEvent(EventAI_Type type) const;
 
+        void BuildEventTypeIndex();
+        // calls worker for every event of the given type, in list order
+        template<typename Worker>
+        void ForEachEventOfType(EventAI_Type type, Worker&& worker)
+        {
+            for (uint32 i = m_eventTypeStart[type]; i < m_eventTypeStart[type + 1]; ++i)
+                worker(m_CreatureEventAIList[m_eventsByType[i]]);
+        }
+
         uint32 m_EventUpdateTime;                           // Time between event updates
         uint32 m_EventDiff;                                 // Time between the last event call
         bool   m_bEmptyList;
@@ -913,6 +922,8 @@ class CreatureEventAI : public CreatureAI
         // Variables used by Events themselves
         typedef std::vector<CreatureEventAIHolder> CreatureEventAIList;
         CreatureEventAIList m_CreatureEventAIList;          // Holder for events (stores enabled, time, and eventid)
+        std::vector<uint16> m_eventsByType;                 // positions in m_CreatureEventAIList grouped by event type, list order kept
+        uint16 m_eventTypeStart[EVENT_T_END + 1];           // first position of each type in m_eventsByType
         std::vector<std::vector<std::reference_wrapper<CreatureEventAIHolder>>> m_creatureEventAITempList; // Holder for events that are ready to go off
         uint32 m_depth;
 
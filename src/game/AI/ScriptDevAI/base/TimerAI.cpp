@@ -17,164 +17,188 @@
 #include "TimerAI.h"
 #include "Chat/Chat.h"
 #include "Log.h"
+#include <algorithm>
+#include <functional>
 #include <string>
 
-Timer::Timer(uint32 id, std::function<void()> functor, uint32 timerMin, uint32 timerMax, bool disabled)
-    : id(id), timer(urand(timerMin, timerMax)), disabled(disabled), functor(functor), initialMin(timerMin), initialMax(timerMax), initialDisabled(disabled)
+Timer::Timer(uint32 id, TimerFunctor&& functor, uint32 timerMin, uint32 timerMax, bool disabled)
+    : id(id), expireTime(0), version(0), disabled(disabled), functor(std::move(functor)), initialMin(timerMin), initialMax(timerMax), initialDisabled(disabled)
     {}
 
-bool Timer::UpdateTimer(const uint32 diff, bool /*combat*/)
+Timer* TimerScheduler::AddTimer(Timer&& timer)
 {
-    if (disabled)
-        return false;
+    auto result = m_timers.emplace(timer.id, std::move(timer));
+    if (!result.second)
+        return nullptr;
 
-    if (timer <= diff)
+    Timer& added = result.first->second;
+    added.expireTime = m_clock;
+    if (!added.disabled)
     {
-        timer = 0;
-        disabled = true;
-        return true;
+        added.expireTime += urand(added.initialMin, added.initialMax);
+        Schedule(added);
+    }
+    return &added;
+}
+
+Timer* TimerScheduler::FindTimer(uint32 id)
+{
+    auto itr = m_timers.find(id);
+    return itr != m_timers.end() ? &itr->second : nullptr;
+}
+
+void TimerScheduler::Schedule(Timer& timer)
+{
+    // drop stale entries once they outnumber the timers, repeated delays would grow the queue otherwise
+    if (m_queue.size() > 2 * m_timers.size() + 8)
+    {
+        m_queue.clear();
+        for (auto& data : m_timers)
+            if (!data.second.disabled && &data.second != &timer)
+                m_queue.push_back({ data.second.expireTime, &data.second, data.second.version });
+        std::make_heap(m_queue.begin(), m_queue.end(), std::greater<QueueEntry>());
     }
-    else timer -= diff;
 
-    return false;
+    m_queue.push_back({ timer.expireTime, &timer, timer.version });
+    std::push_heap(m_queue.begin(), m_queue.end(), std::greater<QueueEntry>());
 }
 
-void Timer::ResetTimer()
+void TimerScheduler::ResetTimer(Timer& timer, uint32 delay)
 {
-    timer = urand(initialMin, initialMax);
-    disabled = initialDisabled;
+    ++timer.version;
+    timer.expireTime = m_clock + delay;
+    timer.disabled = false;
+    Schedule(timer);
 }
 
-bool CombatTimer::UpdateTimer(const uint32 diff, bool combat)
+void TimerScheduler::ResetTimer(Timer& timer)
 {
-    if (disabled)
-        return false;
+    if (timer.initialDisabled)
+        DisableTimer(timer);
+    else
+        ResetTimer(timer, urand(timer.initialMin, timer.initialMax));
+}
 
-    if (this->combat != combat)
-        return false;
+void TimerScheduler::ResetAllTimers()
+{
+    for (auto& data : m_timers)
+        ResetTimer(data.second);
+}
 
-    if (timer <= diff)
+void TimerScheduler::DisableTimer(Timer& timer)
+{
+    ++timer.version;
+    timer.expireTime = m_clock;
+    timer.disabled = true;
+}
+
+void TimerScheduler::Update(const uint32 diff)
+{
+    m_clock += diff;
+
+    while (!m_queue.empty() && m_queue.front().expireTime <= m_clock)
     {
-        timer = 0;
-        disabled = true;
-        return true;
+        std::pop_heap(m_queue.begin(), m_queue.end(), std::greater<QueueEntry>());
+        QueueEntry const& entry = m_queue.back();
+        if (entry.version == entry.timer->version)
+            m_expired.push_back(entry);
+        m_queue.pop_back();
     }
-    else timer -= diff;
 
-    return false;
+    if (m_expired.empty())
+        return;
+
+    // fire in id order as timers expiring together always did, functors may change any timer meanwhile
+    std::sort(m_expired.begin(), m_expired.end(), [](QueueEntry const& left, QueueEntry const& right) { return left.timer->id < right.timer->id; });
+    for (size_t i = 0; i < m_expired.size(); ++i)
+    {
+        Timer& timer = *m_expired[i].timer;
+        if (m_expired[i].version != timer.version)
+            continue;
+
+        DisableTimer(timer);
+        timer.functor();
+    }
+    m_expired.clear();
 }
 
-void TimerManager::AddTimer(uint32 id, Timer&& timer)
+void TimerManager::AddTimer(uint32 /*id*/, Timer&& timer)
 {
-    m_timers.emplace(id, timer);
+    m_timers.AddTimer(std::move(timer));
 }
 
-void TimerManager::AddCustomAction(uint32 id, bool disabled, std::function<void()> functor, TimerCombat timerCombat)
+// combat dependent custom actions have always been updated regardless of combat state, timerCombat is kept for the scripts
+void TimerManager::AddCustomAction(uint32 id, bool disabled, TimerFunctor functor, TimerCombat /*timerCombat*/)
 {
-    switch (timerCombat)
-    {
-        case TIMER_ALWAYS:
-            m_timers.emplace(id, Timer(id, functor, 0, 0, disabled));
-            break;
-        case TIMER_COMBAT_OOC:
-            m_timers.emplace(id, CombatTimer(id, functor, false, 0, 0, disabled));
-            break;
-        case TIMER_COMBAT_COMBAT:
-            m_timers.emplace(id, CombatTimer(id, functor, true, 0, 0, disabled));
-            break;
-    }    
+    m_timers.AddTimer(Timer(id, std::move(functor), 0, 0, disabled));
 }
 
-void TimerManager::AddCustomAction(uint32 id, uint32 timer, std::function<void()> functor, TimerCombat timerCombat)
+void TimerManager::AddCustomAction(uint32 id, uint32 timer, TimerFunctor functor, TimerCombat /*timerCombat*/)
 {
-    switch (timerCombat)
-    {
-        case TIMER_ALWAYS:
-            m_timers.emplace(id, Timer(id, functor, timer, timer, false));
-            break;
-        case TIMER_COMBAT_OOC:
-            m_timers.emplace(id, CombatTimer(id, functor, false, timer, timer, false));
-            break;
-        case TIMER_COMBAT_COMBAT:
-            m_timers.emplace(id, CombatTimer(id, functor, true, timer, timer, false));
-            break;
-    }
+    m_timers.AddTimer(Timer(id, std::move(functor), timer, timer, false));
 }
 
-void TimerManager::AddCustomAction(uint32 id, uint32 timerMin, uint32 timerMax, std::function<void()> functor, TimerCombat timerCombat)
+void TimerManager::AddCustomAction(uint32 id, uint32 timerMin, uint32 timerMax, TimerFunctor functor, TimerCombat /*timerCombat*/)
 {
-    switch (timerCombat)
-    {
-        case TIMER_ALWAYS:
-            m_timers.emplace(id, Timer(id, functor, timerMin, timerMax, false));
-            break;
-        case TIMER_COMBAT_OOC:
-            m_timers.emplace(id, CombatTimer(id, functor, false, timerMin, timerMax, false));
-            break;
-        case TIMER_COMBAT_COMBAT:
-            m_timers.emplace(id, CombatTimer(id, functor, true, timerMin, timerMax, false));
-            break;
-    }
+    m_timers.AddTimer(Timer(id, std::move(functor), timerMin, timerMax, false));
 }
 
 void TimerManager::ResetTimer(uint32 index, uint32 timer)
 {
-    auto data = m_timers.find(index);
-    if (data == m_timers.end())
+    Timer* data = m_timers.FindTimer(index);
+    if (!data)
     {
         sLog.outError("Timer index %u does not exist.", index);
         return;
     }
-    (*data).second.timer = timer; (*data).second.disabled = false;
+    m_timers.ResetTimer(*data, timer);
 }
 
 void TimerManager::DisableTimer(uint32 index)
 {
-    auto data = m_timers.find(index);
-    if (data == m_timers.end())
+    Timer* data = m_timers.FindTimer(index);
+    if (!data)
     {
         sLog.outError("Timer index %u does not exist.", index);
         return;
     }
-    (*data).second.timer = 0; (*data).second.disabled = true;
+    m_timers.DisableTimer(*data);
 }
 
 void TimerManager::ReduceTimer(uint32 index, uint32 timer)
 {
-    auto data = m_timers.find(index);
-    if (data == m_timers.end())
+    Timer* data = m_timers.FindTimer(index);
+    if (!data)
     {
         sLog.outError("Timer index %u does not exist.", index);
         return;
     }
-    (*data).second.timer = std::min((*data).second.timer, timer);
+    if (!data->disabled && timer < m_timers.GetRemaining(*data))
+        m_timers.ResetTimer(*data, timer);
 }
 
 void TimerManager::DelayTimer(uint32 index, uint32 timer)
 {
-    auto data = m_timers.find(index);
-    if (data == m_timers.end())
+    Timer* data = m_timers.FindTimer(index);
+    if (!data)
     {
         sLog.outError("Timer index %u does not exist.", index);
         return;
     }
-    if (!(*data).second.disabled)
-        (*data).second.timer = (*data).second.timer > timer ? (*data).second.timer : timer;
+    if (!data->disabled && timer > m_timers.GetRemaining(*data))
+        m_timers.ResetTimer(*data, timer);
 }
 
 void TimerManager::ResetIfNotStarted(uint32 index, uint32 timer)
 {
-    auto data = m_timers.find(index);
-    if (data == m_timers.end())
+    Timer* data = m_timers.FindTimer(index);
+    if (!data)
     {
         sLog.outError("Timer index %u does not exist.", index);
         return;
     }
-    if ((*data).second.disabled)
-    {
-        (*data).second.timer = timer;
-        (*data).second.disabled = false;
-    }
+    if (data->disabled)
+        m_timers.ResetTimer(*data, timer);
 }
 
 void TimerManager::UpdateTimers(const uint32 diff)
@@ -182,43 +206,39 @@ void TimerManager::UpdateTimers(const uint32 diff)
     UpdateTimers(diff, false);
 }
 
-void TimerManager::UpdateTimers(const uint32 diff, bool combat)
+void TimerManager::UpdateTimers(const uint32 diff, bool /*combat*/)
 {
-    for (auto& data : m_timers)
-    {
-        Timer& timer = data.second;
-        if (timer.UpdateTimer(diff, combat))
-            timer.functor();
-    }
+    m_timers.Update(diff);
 }
 
 void TimerManager::ResetAllTimers()
 {
-    for (auto& data : m_timers)
-        data.second.ResetTimer();
+    m_timers.ResetAllTimers();
+}
+
+static void AppendTimerInformation(std::string& output, TimerScheduler const& scheduler)
+{
+    for (auto& data : scheduler.GetTimers())
+    {
+        Timer const& timer = data.second;
+        output += "Timer ID: " + std::to_string(timer.id) + " Timer: " + std::to_string(scheduler.GetRemaining(timer)) + " Disabled: " + std::to_string(timer.disabled) + "\n";
+    }
 }
 
 void TimerManager::GetAIInformation(ChatHandler& reader)
 {
     reader.PSendSysMessage("TimerAI: Timers:");
     std::string output = "";
-    for (auto itr = m_timers.begin(); itr != m_timers.end(); ++itr)
-    {
-        Timer& timer = (*itr).second;
-        output += "Timer ID: " + std::to_string(timer.id) + " Timer: " + std::to_string(timer.timer), +" Disabled: " + std::to_string(timer.disabled) + "\n";
-    }
+    AppendTimerInformation(output, m_timers);
     reader.PSendSysMessage("%s", output.data());
 }
 
 void CombatActions::UpdateTimers(const uint32 diff, bool combat)
 {
     TimerManager::UpdateTimers(diff, combat);
-    for (auto& data : m_CombatActions)
-    {
-        CombatTimer& timer = data.second;
-        if (timer.UpdateTimer(diff, combat))
-            timer.functor();
-    }
+    // combat actions are paused out of combat
+    if (combat)
+        m_combatActions.Update(diff);
 }
 
 void CombatActions::ResetAllTimers()
@@ -231,26 +251,25 @@ void CombatActions::ResetAllTimers()
         else
             m_actionReadyStatus[i] = (*itr).second;
     }
-    for (auto& data : m_CombatActions)
-        data.second.ResetTimer();
+    m_combatActions.ResetAllTimers();
     TimerManager::ResetAllTimers();
 }
 
 void CombatActions::AddCombatAction(uint32 id, bool disabled)
 {
-    m_CombatActions.emplace(id, CombatTimer(id, [&, id] { m_actionReadyStatus[id] = true; }, true, 0, 0, disabled));
+    m_combatActions.AddTimer(Timer(id, [&, id] { m_actionReadyStatus[id] = true; }, 0, 0, disabled));
     m_actionReadyStatus[id] = !disabled;
 }
 
 void CombatActions::AddCombatAction(uint32 id, uint32 timer)
 {
-    m_CombatActions.emplace(id, CombatTimer(id, [&, id] { m_actionReadyStatus[id] = true; }, true, timer, timer, false));
+    m_combatActions.AddTimer(Timer(id, [&, id] { m_actionReadyStatus[id] = true; }, timer, timer, false));
     m_actionReadyStatus[id] = false;
 }
 
 void CombatActions::AddCombatAction(uint32 id, uint32 timerMin, uint32 timerMax)
 {
-    m_CombatActions.emplace(id, CombatTimer(id, [&, id] { m_actionReadyStatus[id] = true; }, true, timerMin, timerMax, false));
+    m_combatActions.AddTimer(Timer(id, [&, id] { m_actionReadyStatus[id] = true; }, timerMin, timerMax, false));
     m_actionReadyStatus[id] = false;
 }
 
@@ -262,56 +281,47 @@ void CombatActions::AddTimerlessCombatAction(uint32 id, bool byDefault)
 
 void CombatActions::ResetTimer(uint32 index, uint32 timer)
 {
-    auto data = m_CombatActions.find(index);
-    if (data == m_CombatActions.end())
+    Timer* data = m_combatActions.FindTimer(index);
+    if (!data)
         TimerManager::ResetTimer(index, timer);
     else
-    {
-        (*data).second.timer = timer;
-        (*data).second.disabled = false;
-    }
+        m_combatActions.ResetTimer(*data, timer);
 }
 
 void CombatActions::DisableTimer(uint32 index)
 {
-    auto data = m_CombatActions.find(index);
-    if (data == m_CombatActions.end())
+    Timer* data = m_combatActions.FindTimer(index);
+    if (!data)
         TimerManager::DisableTimer(index);
     else
-    {
-        (*data).second.timer = 0;
-        (*data).second.disabled = true;
-    }
+        m_combatActions.DisableTimer(*data);
 }
 
 void CombatActions::ReduceTimer(uint32 index, uint32 timer)
 {
-    auto data = m_CombatActions.find(index);
-    if (data == m_CombatActions.end())
+    Timer* data = m_combatActions.FindTimer(index);
+    if (!data)
         TimerManager::ReduceTimer(index, timer);
-    else
-        (*data).second.timer = std::min((*data).second.timer, timer);
+    else if (!data->disabled && timer < m_combatActions.GetRemaining(*data))
+        m_combatActions.ResetTimer(*data, timer);
 }
 
 void CombatActions::DelayTimer(uint32 index, uint32 timer)
 {
-    auto data = m_CombatActions.find(index);
-    if (data == m_CombatActions.end())
+    Timer* data = m_combatActions.FindTimer(index);
+    if (!data)
         TimerManager::DelayTimer(index, timer);
-    else if (!(*data).second.disabled)
-        (*data).second.timer = (*data).second.timer > timer ? (*data).second.timer : timer;
+    else if (!data->disabled && timer > m_combatActions.GetRemaining(*data))
+        m_combatActions.ResetTimer(*data, timer);
 }
 
 void CombatActions::ResetIfNotStarted(uint32 index, uint32 timer)
 {
-    auto data = m_CombatActions.find(index);
-    if (data == m_CombatActions.end())
+    Timer* data = m_combatActions.FindTimer(index);
+    if (!data)
         TimerManager::ResetIfNotStarted(index, timer);
-    else if ((*data).second.disabled)
-    {
-        (*data).second.timer = timer;
-        (*data).second.disabled = false;
-    }
+    else if (data->disabled)
+        m_combatActions.ResetTimer(*data, timer);
 }
 
 void CombatActions::DisableCombatAction(uint32 index)
@@ -325,10 +335,6 @@ void CombatActions::GetAIInformation(ChatHandler& reader)
 {
     reader.PSendSysMessage("Combat Timers:");
     std::string output = "";
-    for (auto itr = m_CombatActions.begin(); itr != m_CombatActions.end(); ++itr)
-    {
-        Timer& timer = (*itr).second;
-        output += "Timer ID: " + std::to_string(timer.id) + " Timer: " + std::to_string(timer.timer), +" Disabled: " + std::to_string(timer.disabled) + "\n";
-    }
+    AppendTimerInformation(output, m_combatActions);
     reader.PSendSysMessage("%s", output.data());
-}
\ No newline at end of file
+}
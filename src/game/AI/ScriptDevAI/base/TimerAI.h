@@ -18,10 +18,10 @@
 #define TIMER_AI_H
 
 #include "Util/Util.h"
+#include "Util/InplaceFunction.h"
 #include "Platform/Define.h"
 
 #include <chrono>
-#include <functional>
 #include <map>
 #include <vector>
 
@@ -29,32 +29,65 @@ using namespace std::chrono_literals;
 
 class ChatHandler;
 
+typedef InplaceFunction<void()> TimerFunctor;
+
 /*
 Timer data class used for execution of TimerAI events
 */
 struct Timer
 {
-    Timer(uint32 id, std::function<void()> functor, uint32 timerMin, uint32 timerMax, bool disabled = false);
+    Timer(uint32 id, TimerFunctor&& functor, uint32 timerMin, uint32 timerMax, bool disabled = false);
     uint32 id;
-    uint32 timer;
+    uint64 expireTime;                                      // TimerScheduler clock at which the timer fires
+    uint32 version;                                         // bumped on each change, queue entries of older versions are stale
     bool disabled;
-    std::function<void()> functor;
+    TimerFunctor functor;
 
     // initial settings
     uint32 initialMin, initialMax;
     bool initialDisabled;
-
-    virtual bool UpdateTimer(const uint32 diff, bool /*combat*/);
-    void ResetTimer();
 };
 
-struct CombatTimer : public Timer
+/*
+Keeps timers ordered by expire time so an update only touches the ones that fire.
+Timers do not count down, the scheduler owns a clock which only advances in Update.
+*/
+class TimerScheduler
 {
-    CombatTimer(uint32 id, std::function<void()> functor, bool combat, uint32 timerMin, uint32 timerMax, bool disabled = false) : Timer(id, functor, timerMin, timerMax, disabled), combat(combat) {}
+    public:
+        TimerScheduler() : m_clock(0) {}
+        TimerScheduler(TimerScheduler const&) = delete;
+        TimerScheduler& operator=(TimerScheduler const&) = delete;
+
+        Timer* AddTimer(Timer&& timer);
+        Timer* FindTimer(uint32 id);
+
+        void Update(const uint32 diff);
+
+        void ResetTimer(Timer& timer, uint32 delay);
+        void ResetTimer(Timer& timer);                      // back to initial settings
+        void ResetAllTimers();
+        void DisableTimer(Timer& timer);
+        uint32 GetRemaining(Timer const& timer) const { return timer.disabled || timer.expireTime <= m_clock ? 0 : uint32(timer.expireTime - m_clock); }
+
+        std::map<uint32, Timer> const& GetTimers() const { return m_timers; }
+
+    private:
+        struct QueueEntry
+        {
+            uint64 expireTime;
+            Timer* timer;
+            uint32 version;
+
+            bool operator>(QueueEntry const& other) const { return expireTime > other.expireTime; }
+        };
 
-    bool combat;
+        void Schedule(Timer& timer);
 
-    virtual bool UpdateTimer(const uint32 diff, bool combat);
+        std::map<uint32, Timer> m_timers;                   // node based, queue entries point into it
+        std::vector<QueueEntry> m_queue;                    // min heap on expire time
+        std::vector<QueueEntry> m_expired;
+        uint64 m_clock;
 };
 
 enum TimerCombat
@@ -74,16 +107,16 @@ class TimerManager
         TimerManager() {}
 
         // TODO: remove first function
-        void AddCustomAction(uint32 id, bool disabled, std::function<void()> functor, TimerCombat timerCombat = TIMER_ALWAYS);
-        void AddCustomAction(uint32 id, uint32 timer, std::function<void()> functor, TimerCombat timerCombat = TIMER_ALWAYS);
-        void AddCustomAction(uint32 id, std::chrono::milliseconds timer, std::function<void()> functor, TimerCombat timerCombat = TIMER_ALWAYS)
+        void AddCustomAction(uint32 id, bool disabled, TimerFunctor functor, TimerCombat timerCombat = TIMER_ALWAYS);
+        void AddCustomAction(uint32 id, uint32 timer, TimerFunctor functor, TimerCombat timerCombat = TIMER_ALWAYS);
+        void AddCustomAction(uint32 id, std::chrono::milliseconds timer, TimerFunctor functor, TimerCombat timerCombat = TIMER_ALWAYS)
         {
-            AddCustomAction(id, uint32(timer.count()), functor, timerCombat);
+            AddCustomAction(id, uint32(timer.count()), std::move(functor), timerCombat);
         }
-        void AddCustomAction(uint32 id, uint32 timerMin, uint32 timerMax, std::function<void()> functor, TimerCombat timerCombat = TIMER_ALWAYS);
-        void AddCustomAction(uint32 id, std::chrono::milliseconds timerMin, std::chrono::milliseconds timerMax, std::function<void()> functor, TimerCombat timerCombat = TIMER_ALWAYS)
+        void AddCustomAction(uint32 id, uint32 timerMin, uint32 timerMax, TimerFunctor functor, TimerCombat timerCombat = TIMER_ALWAYS);
+        void AddCustomAction(uint32 id, std::chrono::milliseconds timerMin, std::chrono::milliseconds timerMax, TimerFunctor functor, TimerCombat timerCombat = TIMER_ALWAYS)
         {
-            AddCustomAction(id, timerMin.count(), timerMax.count(), functor, timerCombat);
+            AddCustomAction(id, timerMin.count(), timerMax.count(), std::move(functor), timerCombat);
         }
 
         virtual void ResetTimer(uint32 index, uint32 timer);
@@ -118,7 +151,7 @@ class TimerManager
     protected:
         void AddTimer(uint32 id, Timer&& timer);
     private:
-        std::map<uint32, Timer> m_timers;
+        TimerScheduler m_timers;
 };
 
 class CombatActions : public TimerManager
@@ -205,7 +238,7 @@ class CombatActions : public TimerManager
         size_t GetCombatActionCount() { return m_actionReadyStatus.size(); }
 
     private:
-        std::map<uint32, CombatTimer> m_CombatActions;
+        TimerScheduler m_combatActions;                     // only advances in combat
         std::vector<bool> m_actionReadyStatus;
         std::map<uint32, bool> m_timerlessActionSettings;
         std::map<uint32, uint32> m_spellAction;
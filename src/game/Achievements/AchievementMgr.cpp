@@ -915,16 +915,22 @@ void AchievementMgr::UpdateAchievementCriteria(AchievementCriteriaTypes type, ui
     if (!sWorld.getConfig(CONFIG_BOOL_GM_ALLOW_ACHIEVEMENT_GAINS) && m_player->GetSession()->GetSecurity() > SEC_PLAYER)
         return;
 
-    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr.GetAchievementCriteriaByType(type);
-    for (auto achievementCriteria : achievementCriteriaList)
+    // lists hold only criteria of the player team, and only those of the given asset for keyed types out of the login case
+    AchievementCriteriaEntryList const* achievementCriteriaList;
+    if (miscvalue1 && AchievementGlobalMgr::IsCriteriaTypeKeyedByAsset(type))
+    {
+        achievementCriteriaList = sAchievementMgr.GetAchievementCriteriaByAsset(type, GetPlayer()->GetTeam(), miscvalue1);
+        if (!achievementCriteriaList)
+            return;
+    }
+    else
+        achievementCriteriaList = &sAchievementMgr.GetAchievementCriteriaByType(type, GetPlayer()->GetTeam());
+
+    for (auto achievementCriteria : *achievementCriteriaList)
     {
         AchievementEntry const* achievement = sAchievementStore.LookupEntry(achievementCriteria->referredAchievement);
         // Checked in LoadAchievementCriteriaList
 
-        if ((achievement->factionFlag == ACHIEVEMENT_FACTION_FLAG_HORDE    && GetPlayer()->GetTeam() != HORDE) ||
-                (achievement->factionFlag == ACHIEVEMENT_FACTION_FLAG_ALLIANCE && GetPlayer()->GetTeam() != ALLIANCE))
-            continue;
-
         // don't update already completed criteria
         if (IsCompletedCriteria(achievementCriteria, achievement))
             continue;
@@ -2458,6 +2464,57 @@ AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteria
     return m_AchievementCriteriasByType[type];
 }
 
+AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteriaByType(AchievementCriteriaTypes type, Team team) const
+{
+    return m_AchievementCriteriasByTeam[type][GetTeamIndexByTeamId(team)];
+}
+
+AchievementCriteriaEntryList const* AchievementGlobalMgr::GetAchievementCriteriaByAsset(AchievementCriteriaTypes type, Team team, uint32 asset) const
+{
+    AchievementCriteriaListByAsset const& byAsset = m_AchievementCriteriasByAsset[type][GetTeamIndexByTeamId(team)];
+    AchievementCriteriaListByAsset::const_iterator itr = byAsset.find(asset);
+    return itr != byAsset.end() ? &itr->second : nullptr;
+}
+
+// Types that never progress, with a non-zero miscvalue1, on a criteria whose first value (raw.value) differs from it
+bool AchievementGlobalMgr::IsCriteriaTypeKeyedByAsset(AchievementCriteriaTypes type)
+{
+    switch (type)
+    {
+        case ACHIEVEMENT_CRITERIA_TYPE_KILL_CREATURE:
+        case ACHIEVEMENT_CRITERIA_TYPE_REACH_SKILL_LEVEL:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILL_LEVEL:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUESTS_IN_ZONE:
+        case ACHIEVEMENT_CRITERIA_TYPE_KILLED_BY_CREATURE:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUEST:
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET:
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET2:
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL:
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL2:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SPELL:
+        case ACHIEVEMENT_CRITERIA_TYPE_LOOT_TYPE:
+        case ACHIEVEMENT_CRITERIA_TYPE_OWN_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_USE_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_LOOT_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_GAIN_REPUTATION:
+        case ACHIEVEMENT_CRITERIA_TYPE_DO_EMOTE:
+        case ACHIEVEMENT_CRITERIA_TYPE_EQUIP_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_USE_GAMEOBJECT:
+        case ACHIEVEMENT_CRITERIA_TYPE_FISH_IN_GAMEOBJECT:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILLLINE_SPELLS:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILL_LINE:
+        case ACHIEVEMENT_CRITERIA_TYPE_HK_CLASS:
+        case ACHIEVEMENT_CRITERIA_TYPE_HK_RACE:
+        case ACHIEVEMENT_CRITERIA_TYPE_HIGHEST_TEAM_RATING:
+        case ACHIEVEMENT_CRITERIA_TYPE_HIGHEST_PERSONAL_RATING:
+        case ACHIEVEMENT_CRITERIA_TYPE_HONORABLE_KILL_AT_AREA:
+        case ACHIEVEMENT_CRITERIA_TYPE_BG_OBJECTIVE_CAPTURE:
+            return true;
+        default:
+            return false;
+    }
+}
+
 AchievementCriteriaEntryList const* AchievementGlobalMgr::GetAchievementCriteriaByAchievement(uint32 id)
 {
     AchievementCriteriaListByAchievement::const_iterator itr = m_AchievementCriteriaListByAchievement.find(id);
@@ -2534,13 +2591,26 @@ void AchievementGlobalMgr::LoadAchievementCriteriaList()
         AchievementEntry const* achiev = sAchievementStore.LookupEntry(criteria->referredAchievement);
         if (!achiev)
         {
-            sLog.outDetail("Removed achievement-criteria %u, because referred achievement does not exist", entryId);
+            DETAIL_LOG("Removed achievement-criteria %u, because referred achievement does not exist", entryId);
             sAchievementCriteriaStore.EraseEntry(entryId);
             continue;
         }
 
         m_AchievementCriteriasByType[criteria->requiredType].push_back(criteria);
         m_AchievementCriteriaListByAchievement[criteria->referredAchievement].push_back(criteria);
+
+        AchievementCriteriaTypes const type = AchievementCriteriaTypes(criteria->requiredType);
+        for (Team team : { ALLIANCE, HORDE })
+        {
+            if ((achiev->factionFlag == ACHIEVEMENT_FACTION_FLAG_HORDE && team != HORDE) ||
+                    (achiev->factionFlag == ACHIEVEMENT_FACTION_FLAG_ALLIANCE && team != ALLIANCE))
+                continue;
+
+            PvpTeamIndex const teamIndex = GetTeamIndexByTeamId(team);
+            m_AchievementCriteriasByTeam[type][teamIndex].push_back(criteria);
+            if (IsCriteriaTypeKeyedByAsset(type))
+                m_AchievementCriteriasByAsset[type][teamIndex][criteria->raw.value].push_back(criteria);
+        }
         ++count;
     }
 
@@ -2574,7 +2644,7 @@ void AchievementGlobalMgr::LoadAchievementReferenceList()
         AchievementEntry const* refAchiev = sAchievementStore.LookupEntry(achievement->refAchievement);
         if (!refAchiev)
         {
-            sLog.outDetail("Removed achieviement %u, because referred achievement does not exist", entryId);
+            DETAIL_LOG("Removed achieviement %u, because referred achievement does not exist", entryId);
             sAchievementStore.EraseEntry(entryId);
             continue;
         }
@@ -29,10 +29,11 @@
 struct AchievementEntry;
 struct AchievementCriteriaEntry;
 
-typedef std::list<AchievementCriteriaEntry const*> AchievementCriteriaEntryList;
+typedef std::vector<AchievementCriteriaEntry const*> AchievementCriteriaEntryList;
 typedef std::list<AchievementEntry const*>         AchievementEntryList;
 
 typedef std::map<uint32, AchievementCriteriaEntryList> AchievementCriteriaListByAchievement;
+typedef std::unordered_map<uint32, AchievementCriteriaEntryList> AchievementCriteriaListByAsset;
 typedef std::map<uint32, AchievementEntryList>         AchievementListByReferencedId;
 typedef std::map<uint32, time_t>                       AchievementCriteriaFailTimeMap;
 
@@ -329,6 +330,11 @@ class AchievementGlobalMgr
 {
     public:
         AchievementCriteriaEntryList const& GetAchievementCriteriaByType(AchievementCriteriaTypes type) const;
+        // only criteria of achievements available to the team
+        AchievementCriteriaEntryList const& GetAchievementCriteriaByType(AchievementCriteriaTypes type, Team team) const;
+        // only criteria of the team with the asset (creature entry, item id, spell id...), for types progressing on their asset only
+        AchievementCriteriaEntryList const* GetAchievementCriteriaByAsset(AchievementCriteriaTypes type, Team team, uint32 asset) const;
+        static bool IsCriteriaTypeKeyedByAsset(AchievementCriteriaTypes type);
         AchievementCriteriaEntryList const* GetAchievementCriteriaByAchievement(uint32 id);
         AchievementEntryList const* GetAchievementByReferencedId(uint32 id) const;
         AchievementReward const* GetAchievementReward(AchievementEntry const* achievement, uint8 gender) const;
@@ -350,6 +356,8 @@ class AchievementGlobalMgr
 
         // store achievement criterias by type to speed up lookup
         AchievementCriteriaEntryList m_AchievementCriteriasByType[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
+        AchievementCriteriaEntryList m_AchievementCriteriasByTeam[ACHIEVEMENT_CRITERIA_TYPE_TOTAL][PVP_TEAM_COUNT];
+        AchievementCriteriaListByAsset m_AchievementCriteriasByAsset[ACHIEVEMENT_CRITERIA_TYPE_TOTAL][PVP_TEAM_COUNT];
         // store achievement criterias by achievement to speed up lookup
         AchievementCriteriaListByAchievement m_AchievementCriteriaListByAchievement;
         // store achievements by referenced achievement id to speed up lookup
@@ -515,18 +515,23 @@ void Antispam::Analyze()
     }
 
     // step 5: see if they are repeating their messages too often
+    auto const threshold = sAnticheatConfig.GetAntispamUniquenessThreshold();
     for (auto const &msg : messages)
     {
+        auto const fingerprint = nam::make_fingerprint(msg);
+
         // first see if the message is similar to previously observed unique messages
         bool found = false;
         for (auto i = 0u; i < _uniqueMessages.size(); ++i)
         {
             auto &u = _uniqueMessages[i];
 
-            auto const distance = static_cast<uint32>(nam::damerau_levenshtein_distance(msg, u.second));
+            // the fingerprints bound the distance from below, only near duplicates get the distance computed
+            if (nam::bag_distance(fingerprint, _uniqueFingerprints[i]) >= threshold)
+                continue;
 
             // if these two messages are the same, increase the count
-            if (distance < sAnticheatConfig.GetAntispamUniquenessThreshold())
+            if (nam::damerau_levenshtein_within(msg, u.second, threshold))
             {
                 ++u.first;
                 found = true;
@@ -539,6 +544,7 @@ void Antispam::Analyze()
 
         // otherwise, insert the message to track it for repetition
         _uniqueMessages.emplace_back(1, msg);
+        _uniqueFingerprints.push_back(fingerprint);
     }
 
     auto const score = RepetitionScore();
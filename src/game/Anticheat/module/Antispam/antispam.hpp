@@ -13,6 +13,7 @@
 
 #include "../priority.hpp"
 #include "../cyclic.hpp"
+#include "../dldist.hpp"
 
 #include <string>
 #include <unordered_set>
@@ -62,6 +63,9 @@ class Antispam : public std::enable_shared_from_this<Antispam>
         // unique messages as determined by fuzzy string comparison
         std::vector<std::pair<uint32, std::string> > _uniqueMessages;
 
+        // character histograms of _uniqueMessages, same order
+        std::vector<nam::fingerprint> _uniqueFingerprints;
+
         // log of highest scoring blacklist messages, along with which blacklist entries contributed to the score.
         // this container is updated by analysis thread, so results are not available in real time.
         nam::priority<std::string, uint32, 5> _topBlacklistedMessages;
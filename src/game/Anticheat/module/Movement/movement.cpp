@@ -97,7 +97,7 @@ extern float computeFallElevation(float time, bool slowFall, float initialSpeed)
 namespace NamreebAnticheat
 {
 Movement::Movement(Player* me) :
-    _me(me), _jumpInitialSpeed(0.f), _inKnockBack(false),
+    _me(me), _jumpInitialSpeed(0.f), _inKnockBack(false), _lastGeometryCheckTime(0), _lastSuspicionTime(0),
     _anticheat(reinterpret_cast<SessionAnticheat *>(me->GetSession()->GetAnticheat())),
     _serverInitTime(0), _clientInitTime(0), _justTeleported(false), _totalDistanceTraveled(0.f),
     overSpeedDistanceTick(0.f), overSpeedDistanceTotal(0.f), _wasMovingOther(false)
@@ -122,6 +122,25 @@ void Movement::KnockBack(float speedxy, float speedz, float cos, float sin)
     _inKnockBack = true;
 }
 
+bool Movement::IsSuspicious() const
+{
+    return _lastSuspicionTime && WorldTimer::getMSTimeDiff(_lastSuspicionTime, WorldTimer::getMSTime()) < sAnticheatConfig.GetMovementSuspicionDuration();
+}
+
+bool Movement::SampleGeometryCheck()
+{
+    auto const interval = sAnticheatConfig.GetMovementGeometrySampleInterval();
+    if (!interval || IsSuspicious())
+        return true;
+
+    auto const now = WorldTimer::getMSTime();
+    if (_lastGeometryCheckTime && WorldTimer::getMSTimeDiff(_lastGeometryCheckTime, now) < interval)
+        return false;
+
+    _lastGeometryCheckTime = now | 1;
+    return true;
+}
+
 void Movement::VerifyMovementFlags(uint32 flags, uint32 &removeFlags, bool strict) const
 {
     removeFlags = 0;
@@ -239,14 +258,14 @@ void Movement::OrderSent(uint16 opcode, uint32 counter)
 
     _orders.emplace_back<PendingOrder>({ opcode, counter, WorldTimer::getMSTime() });
 
-    sLog.outDebug("ORDER: %s (%u) sent to %s (counter = %u)", LookupOpcodeName(opcode), opcode, _me->GetName(), counter);
+    DEBUG_LOG("ORDER: %s (%u) sent to %s (counter = %u)", LookupOpcodeName(opcode), opcode, _me->GetName(), counter);
 }
 
 void Movement::OrderAck(uint16 opcode, uint32 counter)
 {
     _ackHistory.push_back({ opcode, WorldTimer::getMSTime() });
 
-    sLog.outDebug("ORDER: %s (%u) ACK %s (counter = %u)", LookupOpcodeName(opcode), opcode, _me->GetName(), counter);
+    DEBUG_LOG("ORDER: %s (%u) ACK %s (counter = %u)", LookupOpcodeName(opcode), opcode, _me->GetName(), counter);
 
     if (_orders.empty())
     {
@@ -533,7 +552,7 @@ bool Movement::HandleAnticheatTests(MovementInfo& movementInfo, WorldSession* se
             Position extrap;
 
             // predict destination given the last movement position, direction, and flags, and compare to value reported by the client
-            if (ExtrapolateMovement(GetLastMovementInfo(), dt, extrap))
+            if (ExtrapolateMovement(GetLastMovementInfo(), dt, extrap, SampleGeometryCheck()))
             {
                 auto const includeZ = !!((movementInfo.moveFlags | GetLastMovementInfo().moveFlags) & MOVEFLAG_FALLING);
 
@@ -560,12 +579,16 @@ bool Movement::HandleAnticheatTests(MovementInfo& movementInfo, WorldSession* se
                     }
 
                     if (delta >= minErr)
+                    {
+                        MarkSuspicious();
+
                         if (auto const anticheat = dynamic_cast<AnticheatLib *>(GetAnticheatLib()))
                             anticheat->OfferExtrapolationData(
                                 GetLastMovementInfo(),
                                 clientSpeeds[GetMoveType(GetLastMovementInfo().moveFlags)],
                                 clientSpeeds[GetMoveType(movementInfo.moveFlags)],
                                 movementInfo, extrap, delta);
+                    }
                 }
             }
         }
@@ -693,7 +716,7 @@ void Movement::TimeSkipped(const ObjectGuid &mover, uint32 ms)
 
     _clientInitTime += ms;
 
-    sLog.outDebug("Time skipped: Player %s (GUID 0x%x) mover 0x%lx ms %u",
+    DEBUG_LOG("Time skipped: Player %s (GUID 0x%x) mover 0x%lx ms %u",
         _me ? _me->GetName() : "<none>", _me ? _me->GetGUIDLow() : 0, mover.GetRawValue(), ms);
 }
 
@@ -731,7 +754,7 @@ float Movement::GetXYFlagBasedClientSpeed(uint32 moveFlags) const
     return clientSpeeds[MOVE_RUN];
 }
 
-bool Movement::ExtrapolateMovement(MovementInfo const& mi, uint32 diffMs, Position &pos) const
+bool Movement::ExtrapolateMovement(MovementInfo const& mi, uint32 diffMs, Position &pos, bool geometry) const
 {
     // TODO: These cases are not handled in movement extrapolation
     // - Transports
@@ -844,6 +867,10 @@ bool Movement::ExtrapolateMovement(MovementInfo const& mi, uint32 diffMs, Positi
     if (!MaNGOS::IsValidMapCoord(pos.x, pos.y, pos.z, pos.o))
         return false;
 
+    // the lateral distance compared by the speed checks does not depend on the terrain
+    if (!geometry)
+        return true;
+
     if (!(mi.moveFlags & (MOVEFLAG_FALLING | MOVEFLAG_FALLINGFAR | MOVEFLAG_SWIMMING | MOVEFLAG_WATERWALKING)))
         pos.z = _me->GetMap()->GetHeight(_me->GetPhaseMask(), pos.x, pos.y, pos.z);
 
@@ -937,6 +964,15 @@ bool Movement::IsTeleportAllowed(MovementInfo const& movementInfo, float& distan
     if (_me->IsBeingTeleported())
         return true;
 
+    float deltaX = _me->GetPositionX() - movementInfo.pos.x;
+    float deltaY = _me->GetPositionY() - movementInfo.pos.y;
+    float deltaZ = _me->GetPositionZ() - movementInfo.pos.z;
+    distance = sqrt(deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ);
+
+    // short moves need no terrain lookup
+    if (distance < 40.0f)
+        return true;
+
     // some exclude zones - lifts and other, but..
     uint32 destZoneId = 0;
     uint32 destAreaId = 0;
@@ -955,14 +991,6 @@ bool Movement::IsTeleportAllowed(MovementInfo const& movementInfo, float& distan
             return true;
     }
 
-    float deltaX = _me->GetPositionX() - movementInfo.pos.x;
-    float deltaY = _me->GetPositionY() - movementInfo.pos.y;
-    float deltaZ = _me->GetPositionZ() - movementInfo.pos.z;
-    distance = sqrt(deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ);
-
-    if (distance < 40.0f)
-        return true;
-
     return false;
 }
 
@@ -57,6 +57,10 @@ class Movement
         float _jumpInitialSpeed;
         bool _inKnockBack;
 
+        // terrain and vmap queries run on every packet only while the session is suspicious, otherwise sampled
+        uint32 _lastGeometryCheckTime;
+        uint32 _lastSuspicionTime;
+
         struct Order
         {
             uint16 opcode;
@@ -100,6 +104,9 @@ class Movement
 
         bool IsTeleportAllowed(MovementInfo const& movementInfo, float& distance);
 
+        // true when the expensive geometry checks should run for this packet
+        bool SampleGeometryCheck();
+
     public:
         float clientSpeeds[MAX_MOVE_TYPE];
 
@@ -116,6 +123,10 @@ class Movement
         bool IsInKnockBack() const { return _inKnockBack; }
         void KnockBack(float speedxy, float speedz, float cos, float sin);
 
+        // escalates the session to full geometry checks for Movement.SuspicionDuration
+        void MarkSuspicious() { _lastSuspicionTime = WorldTimer::getMSTime() | 1; }
+        bool IsSuspicious() const;
+
         bool HandleAnticheatTests(MovementInfo& movementInfo, WorldSession* session, const WorldPacket& packet);
         bool HandleSpeedChangeAck(MovementInfo& movementInfo, WorldSession* session, const WorldPacket& packet, float newSpeed);
         void HandleEnterWorld();
@@ -131,7 +142,8 @@ class Movement
         void OrderAck(uint16 opcode, uint32 counter);
         void CheckExpiredOrders(uint32 latency);
 
-        bool ExtrapolateMovement(MovementInfo const& mi, uint32 diffMs, Position &pos) const;
+        // without geometry the height and line of sight of the destination are not checked
+        bool ExtrapolateMovement(MovementInfo const& mi, uint32 diffMs, Position &pos, bool geometry = true) const;
         bool GetMaxAllowedDist(MovementInfo const& mi, uint32 diffMs, float &dxy, float &dz) const;
         void OnExplore(AreaTableEntry const* p);
         void OnTransport(Player* plMover, ObjectGuid transportGuid);
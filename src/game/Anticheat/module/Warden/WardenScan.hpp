@@ -96,12 +96,34 @@ class WindowsScan : public Scan
         WindowsScan() = delete;
 };
 
+// random seeds with their HMAC of a fixed scan argument, hashed once at load so building a request does not hash
+class WindowsSeedPool
+{
+    private:
+        struct Entry
+        {
+            uint32 seed;
+            uint8 digest[SHA_DIGEST_LENGTH];
+        };
+
+        std::vector<Entry> _entries;
+
+    public:
+        static constexpr size_t Size = 32;
+
+        void Build(const uint8 *data, size_t size);
+
+        // appends a random seed followed by its digest
+        void Append(ByteBuffer &scan) const;
+};
+
 // check to see if a module is loaded
 class WindowsModuleScan : public WindowsScan
 {
     private:
         std::string _module;
         bool _wanted;
+        WindowsSeedPool _seeds;
 
     public:
         static constexpr uint8 ModuleFound = 0x4A;
@@ -133,6 +155,7 @@ class WindowsCodeScan : public WindowsScan
         std::vector<uint8> _pattern;
         bool _memImageOnly;
         bool _wanted;
+        WindowsSeedPool _seeds;
 
     public:
         static constexpr uint8 PatternFound = 0x4A;
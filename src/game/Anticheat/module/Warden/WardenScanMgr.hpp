@@ -11,8 +11,11 @@
 #include "WardenScan.hpp"
 #include "Policies/Singleton.h"
 
+#include <atomic>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 class WardenScanMgr
 {
@@ -22,7 +25,21 @@ class WardenScanMgr
         // of existing clients
         std::vector<std::shared_ptr<const Scan>> m_scans;
 
+        typedef std::vector<std::shared_ptr<const Scan>> ScanList;
+
+        // scans matching each requested flag combination, built on first use and dropped when the scans change
+        mutable std::unordered_map<uint32, std::shared_ptr<const ScanList>> m_candidates;
+        mutable std::mutex m_scanLock;
+
+        // scan requests started by all sessions in the current second, see Warden.ScanBudget
+        std::atomic<uint32> m_budgetSecond;
+        std::atomic<uint32> m_budgetUsed;
+
+        std::shared_ptr<const ScanList> GetCandidates(ScanFlags flags) const;
+
     public:
+        WardenScanMgr() : m_budgetSecond(0), m_budgetUsed(0) {}
+
         // load static scans from database
         void loadFromDB();
 
@@ -35,6 +52,9 @@ class WardenScanMgr
         void AddWindowsScan(std::shared_ptr<WindowsScan>);
 
         std::vector<std::shared_ptr<const Scan>> GetRandomScans(ScanFlags flags) const;
+
+        // false when the sessions together already started Warden.ScanBudget periodic scan requests this second
+        bool ConsumeScanBudget();
 };
 
 #define sWardenScanMgr MaNGOS::Singleton<WardenScanMgr>::Instance()
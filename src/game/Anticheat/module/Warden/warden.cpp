@@ -68,7 +68,7 @@ Warden::Warden(WorldSession *session, const WardenModule *module, const BigNumbe
 
     _xor = inputKey[0];
 
-    sLog.outDebug("WARDEN: Initializing for account %u ip %s", _session->GetAccountId(), _session->GetRemoteAddress().c_str());
+    DEBUG_LOG("WARDEN: Initializing for account %u ip %s", _session->GetAccountId(), _session->GetRemoteAddress().c_str());
 
     if (_module)
     {
@@ -91,7 +91,7 @@ void Warden::RequestChallenge()
 {
     MANGOS_ASSERT(!!_module && !_module->crk.empty());
 
-    sLog.outDebug("WARDEN: Sending challenge to account %u", _session->GetAccountId());
+    DEBUG_LOG("WARDEN: Sending challenge to account %u", _session->GetAccountId());
 
     StopTimeoutClock();
 
@@ -135,14 +135,14 @@ void Warden::HandleChallengeResponse(ByteBuffer &buff)
 
     _xor = _crk->clientKey[0];
 
-    sLog.outDebug("WARDEN: Challenge response validated.  Warden packet encryption initialized.");
+    DEBUG_LOG("WARDEN: Challenge response validated.  Warden packet encryption initialized.");
 
     _crk = nullptr;
 }
 
 void Warden::SendModuleToClient()
 {
-    sLog.outDebug("WARDEN: Sending module to account %u ip %s", _session->GetAccountId(), _session->GetRemoteAddress().c_str());
+    DEBUG_LOG("WARDEN: Sending module to account %u ip %s", _session->GetAccountId(), _session->GetRemoteAddress().c_str());
 
     StopTimeoutClock();
 
@@ -165,7 +165,7 @@ void Warden::SendModuleToClient()
 
     _moduleSendPending = true;
 
-    sLog.outDebug("WARDEN: Module transfer complete");
+    DEBUG_LOG("WARDEN: Module transfer complete");
 }
 
 std::vector<std::shared_ptr<const Scan>> Warden::SelectScans(ScanFlags flags) const
@@ -439,13 +439,13 @@ void Warden::HandlePacket(WorldPacket& recvData)
         // FIXME: Find when/why/how this actually happens and how to handle it
         case WARDEN_CMSG_MEM_CHECKS_RESULT:
         {
-            sLog.outDebug("WARDEN: Account - %u received opcode 03", _session->GetAccountId());
+            DEBUG_LOG("WARDEN: Account - %u received opcode 03", _session->GetAccountId());
             break;
         }
 
         case WARDEN_CMSG_HASH_RESULT:
         {
-            sLog.outDebug("WARDEN: Account - %u received opcode 04", _session->GetAccountId());
+            DEBUG_LOG("WARDEN: Account - %u received opcode 04", _session->GetAccountId());
 
             HandleChallengeResponse(recvData);
 
@@ -496,8 +496,8 @@ void Warden::Update(uint32 diff)
         // if there are enqueued scans which may now be requested, do so immediately (with no additional scans)
         if (!_enqueuedScans.empty())
             RequestScans({});
-        // otherwise, if the scan clock is running and has expired, request randomly selected scans
-        else if (!!_scanClock && WorldTimer::getMSTime() > _scanClock)
+        // otherwise, if the scan clock is running and has expired, request randomly selected scans if the global budget allows
+        else if (!!_scanClock && WorldTimer::getMSTime() > _scanClock && sWardenScanMgr.ConsumeScanBudget())
         {
             auto const inWorld = _session->GetPlayer() ? _session->GetPlayer()->IsInWorld() : false;
 
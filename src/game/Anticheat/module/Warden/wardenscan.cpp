@@ -17,6 +17,30 @@
 #include <algorithm>
 #include <functional>
 
+void WindowsSeedPool::Build(const uint8 *data, size_t size)
+{
+    _entries.resize(Size);
+
+    for (auto &entry : _entries)
+    {
+        entry.seed = static_cast<uint32>(urand());
+
+        HMACSHA1 hash(sizeof(entry.seed), reinterpret_cast<const uint8*>(&entry.seed));
+        hash.UpdateData(data, size);
+        hash.Finalize();
+
+        ::memcpy(entry.digest, hash.GetDigest(), sizeof(entry.digest));
+    }
+}
+
+void WindowsSeedPool::Append(ByteBuffer &scan) const
+{
+    auto const &entry = _entries[urand(0, _entries.size() - 1)];
+
+    scan << entry.seed;
+    scan.append(entry.digest, sizeof(entry.digest));
+}
+
 WindowsModuleScan::WindowsModuleScan(const std::string &module, bool wanted, const std::string &comment, uint32 flags)
     : _module(module), _wanted(wanted),
     WindowsScan(
@@ -24,15 +48,10 @@ WindowsModuleScan::WindowsModuleScan(const std::string &module, bool wanted, con
     [this](const Warden *warden, std::vector<std::string> &, ByteBuffer &scan)
     {
         auto const winWarden = reinterpret_cast<const WardenWin *>(warden);
-        auto const seed = static_cast<uint32>(urand());
 
-        scan << static_cast<uint8>(winWarden->GetModule()->opcodes[FIND_MODULE_BY_NAME] ^ winWarden->GetXor()) << seed;
+        scan << static_cast<uint8>(winWarden->GetModule()->opcodes[FIND_MODULE_BY_NAME] ^ winWarden->GetXor());
 
-        HMACSHA1 hash(sizeof(seed), reinterpret_cast<const uint8*>(&seed));
-        hash.UpdateData(this->_module);
-        hash.Finalize();
-
-        scan.append(hash.GetDigest(), hash.GetLength());
+        this->_seeds.Append(scan);
     },
     // checker
     [this](const Warden *, ByteBuffer &buff)
@@ -43,6 +62,8 @@ WindowsModuleScan::WindowsModuleScan(const std::string &module, bool wanted, con
 {
     // the game depends on uppercase module names being sent
     std::transform(_module.begin(), _module.end(), _module.begin(), ::toupper);
+
+    _seeds.Build(reinterpret_cast<const uint8 *>(_module.c_str()), _module.length());
 }
 
 WindowsModuleScan::WindowsModuleScan(const std::string &module, CheckT checker, const std::string &comment, uint32 flags)
@@ -52,20 +73,17 @@ WindowsModuleScan::WindowsModuleScan(const std::string &module, CheckT checker,
     [this](const Warden *warden, std::vector<std::string> &, ByteBuffer &scan)
     {
         auto const winWarden = reinterpret_cast<const WardenWin *>(warden);
-        auto const seed = static_cast<uint32>(urand());
 
-        scan << static_cast<uint8>(winWarden->GetModule()->opcodes[FIND_MODULE_BY_NAME] ^ winWarden->GetXor()) << seed;
-
-        HMACSHA1 hash(sizeof(seed), reinterpret_cast<const uint8*>(&seed));
-        hash.UpdateData(this->_module);
-        hash.Finalize();
+        scan << static_cast<uint8>(winWarden->GetModule()->opcodes[FIND_MODULE_BY_NAME] ^ winWarden->GetXor());
 
-        scan.append(hash.GetDigest(), hash.GetLength());
+        this->_seeds.Append(scan);
     },
     checker, sizeof(uint8) + sizeof(uint32) + Sha1Hash::GetLength(), sizeof(uint8), comment, flags)
 {
     // the game depends on uppercase module names being sent
     std::transform(_module.begin(), _module.end(), _module.begin(), ::toupper);
+
+    _seeds.Build(reinterpret_cast<const uint8 *>(_module.c_str()), _module.length());
 }
 
 WindowsMemoryScan::WindowsMemoryScan(uint32 offset, const void *expected, size_t length, const std::string &comment, uint32 flags)
@@ -180,16 +198,10 @@ WindowsCodeScan::WindowsCodeScan(uint32 offset, const std::vector<uint8> &patter
     [this](const Warden *warden, std::vector<std::string> &, ByteBuffer &scan)
     {
         auto const winWarden = reinterpret_cast<const WardenWin *>(warden);
-        auto const seed = static_cast<uint32>(urand());
 
-        scan << static_cast<uint8>(winWarden->GetModule()->opcodes[this->_memImageOnly ? FIND_MEM_IMAGE_CODE_BY_HASH : FIND_CODE_BY_HASH] ^ winWarden->GetXor())
-             << seed;
+        scan << static_cast<uint8>(winWarden->GetModule()->opcodes[this->_memImageOnly ? FIND_MEM_IMAGE_CODE_BY_HASH : FIND_CODE_BY_HASH] ^ winWarden->GetXor());
 
-        HMACSHA1 hash(sizeof(seed), reinterpret_cast<const uint8*>(&seed));
-        hash.UpdateData(&this->_pattern[0], this->_pattern.size());
-        hash.Finalize();
-        
-        scan.append(hash.GetDigest(), hash.GetLength());
+        this->_seeds.Append(scan);
 
         scan << this->_offset << static_cast<uint8>(this->_pattern.size());
     },
@@ -200,6 +212,8 @@ WindowsCodeScan::WindowsCodeScan(uint32 offset, const std::vector<uint8> &patter
     }, sizeof(uint8) + sizeof(uint32) + Sha1Hash::GetLength() + sizeof(uint32) + sizeof(uint8), sizeof(uint8), comment, flags)
 {
     MANGOS_ASSERT(_pattern.size() <= 0xFF);
+
+    _seeds.Build(&_pattern[0], _pattern.size());
 }
 
 WindowsFileHashScan::WindowsFileHashScan(const std::string &file, const void *expected, bool wanted, const std::string &comment, uint32 flags)
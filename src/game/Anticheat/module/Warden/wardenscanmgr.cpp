@@ -64,6 +64,9 @@ void WardenScanMgr::loadFromDB()
 {
     auto result = WorldDatabase.Query("SELECT id,type,str,data,address,length,result,flags,comment FROM warden_scans");
 
+    std::lock_guard<std::mutex> guard(m_scanLock);
+    m_candidates.clear();
+
     // copy any non-database scans into a placeholder
     std::vector<std::shared_ptr<const Scan> > new_scans;
     new_scans.reserve(m_scans.size());
@@ -216,28 +219,41 @@ void WardenScanMgr::loadFromDB()
 
 void WardenScanMgr::AddMacScan(const MacScan *scan)
 {
+    std::lock_guard<std::mutex> guard(m_scanLock);
+    m_candidates.clear();
     m_scans.push_back(std::shared_ptr<const MacScan>(scan));
 }
 
 void WardenScanMgr::AddMacScan(std::shared_ptr<MacScan> scan)
 {
+    std::lock_guard<std::mutex> guard(m_scanLock);
+    m_candidates.clear();
     m_scans.push_back(scan);
 }
 
 void WardenScanMgr::AddWindowsScan(const WindowsScan *scan)
 {
+    std::lock_guard<std::mutex> guard(m_scanLock);
+    m_candidates.clear();
     m_scans.push_back(std::shared_ptr<const WindowsScan>(scan));
 }
 
 void WardenScanMgr::AddWindowsScan(std::shared_ptr<WindowsScan> scan)
 {
+    std::lock_guard<std::mutex> guard(m_scanLock);
+    m_candidates.clear();
     m_scans.push_back(scan);
 }
 
-std::vector<std::shared_ptr<const Scan>> WardenScanMgr::GetRandomScans(ScanFlags flags) const
+std::shared_ptr<const WardenScanMgr::ScanList> WardenScanMgr::GetCandidates(ScanFlags flags) const
 {
-    std::vector<std::shared_ptr<const Scan>> matches;
-    matches.reserve(m_scans.size());
+    std::lock_guard<std::mutex> guard(m_scanLock);
+
+    auto const itr = m_candidates.find(flags);
+    if (itr != m_candidates.end())
+        return itr->second;
+
+    auto matches = std::make_shared<ScanList>();
 
     // save those scans which match the requested flags
     for (auto const &scan : m_scans)
@@ -264,19 +280,36 @@ std::vector<std::shared_ptr<const Scan>> WardenScanMgr::GetRandomScans(ScanFlags
         if (!!(scan->flags & InWorld) && !(flags & InWorld))
             continue;
 
-        matches.push_back(scan);
+        matches->push_back(scan);
     }
 
-    // randomize the order of matching scans
-    std::shuffle(matches.begin(), matches.end(), *GetRandomGenerator());
+    m_candidates[flags] = matches;
+    return matches;
+}
+
+std::vector<std::shared_ptr<const Scan>> WardenScanMgr::GetRandomScans(ScanFlags flags) const
+{
+    auto const candidates = GetCandidates(flags);
+
+    // pick a random subset by partially shuffling indices, only the picked scans are copied
+    std::vector<uint32> order(candidates->size());
+    for (auto i = 0u; i < order.size(); ++i)
+        order[i] = i;
+
+    auto const count = std::min<size_t>(order.size(), sAnticheatConfig.GetWardenScanCount());
+
+    std::vector<std::shared_ptr<const Scan>> matches;
+    matches.reserve(count);
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        std::swap(order[i], order[urand(i, order.size() - 1)]);
+        matches.push_back((*candidates)[order[i]]);
+    }
 
     // determine how many of the identified scans we can fit into the client's request and response buffers
     size_t request = 0, reply = 0;
 
-    // if we have matched too many, shrink.  this will probably be shrunk even further, depending on buffer sizes
-    if (matches.size() >= sAnticheatConfig.GetWardenScanCount())
-        matches.resize(sAnticheatConfig.GetWardenScanCount());
-
     for (auto i = 0u; i < matches.size(); ++i)
     {
         auto const &scan = matches[i];
@@ -293,4 +326,18 @@ std::vector<std::shared_ptr<const Scan>> WardenScanMgr::GetRandomScans(ScanFlags
     }
 
     return std::move(matches);
-}
\ No newline at end of file
+}
+bool WardenScanMgr::ConsumeScanBudget()
+{
+    auto const budget = sAnticheatConfig.GetWardenScanBudget();
+    if (!budget)
+        return true;
+
+    // the first session to see a new second resets the count, a few requests racing the reset are harmless
+    auto const second = WorldTimer::getMSTime() / IN_MILLISECONDS;
+    auto current = m_budgetSecond.load();
+    if (current != second && m_budgetSecond.compare_exchange_strong(current, second))
+        m_budgetUsed = 0;
+
+    return m_budgetUsed.fetch_add(1) < budget;
+}
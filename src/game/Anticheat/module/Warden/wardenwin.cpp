@@ -426,7 +426,7 @@ void WardenWin::LoadScriptedScans()
             return true;
         }
 
-        sLog.outDebug("WARDEN: Account %u IP %s read system information structure successfully",
+        DEBUG_LOG("WARDEN: Account %u IP %s read system information structure successfully",
             wardenWin->_session->GetAccountId(), wardenWin->_session->GetRemoteAddress().c_str());
 
         return false;
@@ -70,6 +70,9 @@ void AnticheatConfig::loadConfigSettings()
     setConfig(CONFIG_BOOL_AC_ANTISPAM_ENABLED, "Antispam.Enable", false);
     setConfig(CONFIG_BOOL_AC_ANTISPAM_SILENCE, "Antispam.Silence", false);
 
+    setConfig(CONFIG_UINT32_AC_MOVEMENT_GEOMETRY_SAMPLE_INTERVAL, "Movement.GeometrySampleInterval", 0);
+    setConfig(CONFIG_UINT32_AC_MOVEMENT_SUSPICION_DURATION, "Movement.SuspicionDuration", 60000);
+
     setConfig(CONFIG_UINT32_AC_FINGERPRINT_HISTORY, "FingerprintHistory", 30);
     setConfig(CONFIG_UINT32_AC_FINGERPRINT_LEVEL, "FingerprintLevel", 6);
 
@@ -133,6 +136,7 @@ void AnticheatConfig::loadConfigSettings()
     setConfig(CONFIG_UINT32_AC_WARDEN_TIMEOUT, "Warden.Timeout", 30);
     setConfig(CONFIG_UINT32_AC_WARDEN_SCAN_FREQUENCY, "Warden.ScanFrequency", 15);
     setConfig(CONFIG_UINT32_AC_WARDEN_SCAN_COUNT, "Warden.ScanCount", 10);
+    setConfig(CONFIG_UINT32_AC_WARDEN_SCAN_BUDGET, "Warden.ScanBudget", 0);
     setConfig(CONFIG_UINT32_AC_WARDEN_MINIMUM_LEVEL, "Warden.MinimumLevel", 25);
     setConfig(CONFIG_UINT32_AC_WARDEN_MINIMUM_ADVANCED_LEVEL, "Warden.MinimumAdvancedLevel", 18);
     setConfig(CONFIG_UINT32_AC_WARDEN_SUSPICIOUS_ENDSCENE_HOOK_ACTION, "Warden.SuspiciousEndSceneHookAction", 1);
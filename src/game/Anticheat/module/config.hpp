@@ -30,6 +30,8 @@ enum AnticheatConfigUInt32Values
     CONFIG_UINT32_AC_ANTISPAM_REPETITION_NOTIFY,
     CONFIG_UINT32_AC_ANTISPAM_REPETITION_SILENCE,
     CONFIG_UINT32_AC_ANTISPAM_REPETITION_MOVEMENT_TIMEOUT,
+    CONFIG_UINT32_AC_MOVEMENT_GEOMETRY_SAMPLE_INTERVAL,
+    CONFIG_UINT32_AC_MOVEMENT_SUSPICION_DURATION,
     CONFIG_UINT32_AC_FINGERPRINT_HISTORY,
     CONFIG_UINT32_AC_FINGERPRINT_LEVEL,
     CONFIG_UINT32_AC_KICK_DELAY_MIN,
@@ -44,6 +46,7 @@ enum AnticheatConfigUInt32Values
     CONFIG_UINT32_AC_WARDEN_TIMEOUT,
     CONFIG_UINT32_AC_WARDEN_SCAN_FREQUENCY,
     CONFIG_UINT32_AC_WARDEN_SCAN_COUNT,
+    CONFIG_UINT32_AC_WARDEN_SCAN_BUDGET,
     CONFIG_UINT32_AC_WARDEN_MINIMUM_LEVEL,
     CONFIG_UINT32_AC_WARDEN_MINIMUM_ADVANCED_LEVEL,
     CONFIG_UINT32_AC_WARDEN_SUSPICIOUS_ENDSCENE_HOOK_ACTION,
@@ -116,12 +119,15 @@ class AnticheatConfig : public Config
         }
 
         bool EnableAntiSpeedHack()                      const { return getConfig(CONFIG_BOOL_AC_MOVEMENT_SPEED_HACK_ENABLED);               }
+        uint32 GetMovementGeometrySampleInterval()      const { return getConfig(CONFIG_UINT32_AC_MOVEMENT_GEOMETRY_SAMPLE_INTERVAL);       }
+        uint32 GetMovementSuspicionDuration()           const { return getConfig(CONFIG_UINT32_AC_MOVEMENT_SUSPICION_DURATION);             }
         uint32 GetFingerprintHistory()                  const { return getConfig(CONFIG_UINT32_AC_FINGERPRINT_HISTORY);                     }
         uint32 GetFingerprintLevel()                    const { return getConfig(CONFIG_UINT32_AC_FINGERPRINT_LEVEL);                       }
 
         uint32 GetWardenTimeout()                       const { return getConfig(CONFIG_UINT32_AC_WARDEN_TIMEOUT);                          }
         uint32 GetWardenScanFrequency()                 const { return getConfig(CONFIG_UINT32_AC_WARDEN_SCAN_FREQUENCY);                   }
         uint32 GetWardenScanCount()                     const { return getConfig(CONFIG_UINT32_AC_WARDEN_SCAN_COUNT);                       }
+        uint32 GetWardenScanBudget()                    const { return getConfig(CONFIG_UINT32_AC_WARDEN_SCAN_BUDGET);                      }
         uint32 GetWardenMinimumLevel()                  const { return getConfig(CONFIG_UINT32_AC_WARDEN_MINIMUM_LEVEL);                    }
         uint32 GetWardenMinimumAdvancedLevel()          const { return getConfig(CONFIG_UINT32_AC_WARDEN_MINIMUM_ADVANCED_LEVEL);           }
         uint32 GetWardenSuspiciousEndSceneHookAction()  const { return getConfig(CONFIG_UINT32_AC_WARDEN_SUSPICIOUS_ENDSCENE_HOOK_ACTION);  }
@@ -28,6 +28,8 @@
 
 #include <string>
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <vector>
 
 namespace nam
@@ -46,7 +48,7 @@ constexpr T min3(const T &a, const T &b, const T &c)
 }
 }
 
-int damerau_levenshtein_distance(const std::string &string1, const std::string &string2)
+inline int damerau_levenshtein_distance(const std::string &string1, const std::string &string2)
 {
     auto const string1_length = string1.length();
     auto const string2_length = string2.length();
@@ -94,5 +96,106 @@ int damerau_levenshtein_distance(const std::string &string1, const std::string &
 
     return dist[get_index(columns, static_cast<int>(string1_length), static_cast<int>(string2_length))];
 }
+// byte histogram folded into 32 saturating buckets. every edit operation changes at most one bucket on
+// each side and a transposition none, so the bag distance of two fingerprints is a lower bound of the
+// damerau-levenshtein distance of their strings, and much cheaper than the distance itself
+struct fingerprint
+{
+    std::array<uint8_t, 32> buckets;
+    size_t length;
+};
+
+inline fingerprint make_fingerprint(const std::string &str)
+{
+    fingerprint result;
+    result.buckets.fill(0);
+    result.length = str.length();
+
+    for (auto const c : str)
+    {
+        auto &bucket = result.buckets[static_cast<uint8_t>(c) & 31];
+        if (bucket < 255)
+            ++bucket;
+    }
+
+    return result;
+}
+
+inline size_t bag_distance(const fingerprint &fp1, const fingerprint &fp2)
+{
+    size_t surplus = 0, deficit = 0;
+    for (auto i = 0u; i < fp1.buckets.size(); ++i)
+    {
+        if (fp1.buckets[i] > fp2.buckets[i])
+            surplus += fp1.buckets[i] - fp2.buckets[i];
+        else
+            deficit += fp2.buckets[i] - fp1.buckets[i];
+    }
+
+    return std::max(surplus, deficit);
+}
+
+// whether the distance as computed by damerau_levenshtein_distance is below limit. only the band
+// of cells within limit - 1 of the diagonal is computed, in three rolling rows, and the search
+// stops once a whole row exceeds it
+inline bool damerau_levenshtein_within(const std::string &string1, const std::string &string2, size_t limit)
+{
+    if (!limit)
+        return false;
+
+    auto const max_dist = limit - 1;
+    auto const string1_length = string1.length();
+    auto const string2_length = string2.length();
+
+    if ((string1_length > string2_length ? string1_length - string2_length : string2_length - string1_length) > max_dist)
+        return false;
+
+    auto const columns = string2_length + 1;
+    auto const outside = max_dist + 1;
+
+    std::vector<size_t> rows(3 * columns, outside);
+    auto *before = &rows[0];
+    auto *previous = &rows[columns];
+    auto *current = &rows[2 * columns];
+
+    for (auto j = 0u; j <= std::min(string2_length, max_dist); ++j)
+        previous[j] = j;
+
+    for (auto i = 1u; i <= string1_length; ++i)
+    {
+        auto const first = i > max_dist ? i - max_dist : 1;
+        auto const last = std::min(string2_length, i + max_dist);
+
+        current[first - 1] = first == 1 && i <= max_dist ? i : outside;
+        auto row_min = current[first - 1];
+
+        for (auto j = first; j <= last; ++j)
+        {
+            auto const cost = string1[i - 1] == string2[j - 1] ? 0u : 1u;
+
+            auto cell = min3(previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost);
+
+            if (i > 1 && j > 1 &&
+                string1[i - 1] == string2[j - 2] &&
+                string1[i - 2] == string2[j - 1])
+                cell = std::min(cell, before[j - 2] + cost);
+
+            current[j] = std::min(cell, outside);
+            row_min = std::min(row_min, current[j]);
+        }
+
+        // the next row reads one cell past this band
+        if (last < string2_length)
+            current[last + 1] = outside;
+
+        if (row_min > max_dist)
+            return false;
+
+        std::swap(before, previous);
+        std::swap(previous, current);
+    }
+
+    return previous[string2_length] <= max_dist;
+}
 }
-#endif /* !__DLDIST_HPP_ */
\ No newline at end of file
+#endif /* !__DLDIST_HPP_ */
@@ -755,11 +755,18 @@ void SessionAnticheat::Update(uint32 diff)
         {
             _banTimer = 0;
 
-            if (_banAccount)
-                sWorld.BanAccount(BAN_ACCOUNT, _session->GetAccountName(), 0, "Cheat detected", "Anticheat");
+            // banning kicks every matching session, run it in the merge phase of parallel session updates
+            auto ban = [banAccount = _banAccount, banIP = _banIP, accountName = _session->GetAccountName(), address = _session->GetRemoteAddress()]()
+            {
+                if (banAccount)
+                    sWorld.BanAccount(BAN_ACCOUNT, accountName, 0, "Cheat detected", "Anticheat");
+
+                if (banIP)
+                    sWorld.BanAccount(BAN_IP, address, 0, "Cheat detected", "Anticheat");
+            };
 
-            if (_banIP)
-                sWorld.BanAccount(BAN_IP, _session->GetRemoteAddress(), 0, "Cheat detected", "Anticheat");
+            if (!World::DeferSessionOperation(ban))
+                ban();
         }
     }
 
@@ -1076,6 +1083,9 @@ void SessionAnticheat::RecordCheatInternal(CheatType cheat, const char *format,
     ++_cheatOccuranceTotal[cheat];
     ++_cheatOccuranceTick[cheat];
 
+    if (_movementData)
+        _movementData->MarkSuspicious();
+
     uint32 actionMask;
 
     // when false, take no action
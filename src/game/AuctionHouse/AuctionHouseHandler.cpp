@@ -25,6 +25,7 @@
 #include "Entities/ObjectGuid.h"
 #include "Entities/Player.h"
 #include "AuctionHouse/AuctionHouseMgr.h"
+#include "AuctionHouse/AuctionQueryPool.h"
 #include "Mails/Mail.h"
 #include "Util/Util.h"
 #include "Chat/Chat.h"
@@ -539,6 +540,39 @@ void WorldSession::HandleAuctionListBidderItems(WorldPacket& recv_data)
     // always return pointer
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(auctionHouseEntry);
 
+    // own bids must be listed, so only a snapshot with every change can be used
+    std::shared_ptr<AuctionHouseSnapshot const> snapshot = sAuctionQueries.IsRunning() ? auctionHouse->GetSnapshot() : nullptr;
+    if (snapshot && auctionHouse->IsSnapshotCurrent())
+    {
+        std::vector<uint32> outbiddedAuctionIds(outbiddedCount);
+        for (uint32& outbiddedAuctionId : outbiddedAuctionIds)
+            recv_data >> outbiddedAuctionId;
+
+        sAuctionQueries.Enqueue([snapshot, outbiddedAuctionIds, listfrom, accountId = GetAccountId(), playerGuid = GetPlayer()->GetObjectGuid()]()
+        {
+            WorldPacket data(SMSG_AUCTION_BIDDER_LIST_RESULT, (4 + 4 + 4));
+            data << uint32(0);                              // add 0 as count
+            uint32 count = 0;
+            uint32 totalcount = 0;
+            for (uint32 outbiddedAuctionId : outbiddedAuctionIds)
+            {
+                if (AuctionHouseSnapshot::Entry const* entry = snapshot->GetEntry(outbiddedAuctionId))
+                {
+                    entry->BuildAuctionInfo(data);
+                    ++totalcount;
+                    ++count;
+                }
+            }
+
+            snapshot->BuildListBidderItems(data, playerGuid.GetCounter(), listfrom, count, totalcount);
+            data.put<uint32>(0, count);                     // add count to placeholder
+            data << uint32(totalcount);
+            data << uint32(300);                            // unk 2.3.0 delay for next isFull request?
+            AuctionQueryPool::SendResult(accountId, playerGuid, std::move(data));
+        });
+        return;
+    }
+
     WorldPacket data(SMSG_AUCTION_BIDDER_LIST_RESULT, (4 + 4 + 4));
     Player* pl = GetPlayer();
     data << uint32(0);                                      // add 0 as count
@@ -561,7 +595,7 @@ void WorldSession::HandleAuctionListBidderItems(WorldPacket& recv_data)
     data.put<uint32>(0, count);                             // add count to placeholder
     data << uint32(totalcount);
     data << uint32(300);                                    // unk 2.3.0 delay for next isFull request?
-    SendPacket(data);
+    SendPacket(std::make_shared<WorldPacket const>(std::move(data)));
 }
 
 // this void sends player info about his auctions
@@ -582,6 +616,27 @@ void WorldSession::HandleAuctionListOwnerItems(WorldPacket& recv_data)
     // always return pointer
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(auctionHouseEntry);
 
+    // own auctions must be listed, so only a snapshot with every change can be used
+    std::shared_ptr<AuctionHouseSnapshot const> snapshot = sAuctionQueries.IsRunning() ? auctionHouse->GetSnapshot() : nullptr;
+    if (snapshot && auctionHouse->IsSnapshotCurrent())
+    {
+        sAuctionQueries.Enqueue([snapshot, listfrom, accountId = GetAccountId(), playerGuid = GetPlayer()->GetObjectGuid()]()
+        {
+            WorldPacket data(SMSG_AUCTION_OWNER_LIST_RESULT, (4 + 4 + 4));
+            data << uint32(0);                              // amount place holder
+
+            uint32 count = 0;
+            uint32 totalcount = 0;
+
+            snapshot->BuildListOwnerItems(data, playerGuid.GetCounter(), listfrom, count, totalcount);
+            data.put<uint32>(0, count);
+            data << uint32(totalcount);
+            data << uint32(300);                            // 2.3.0 delay for next isFull request?
+            AuctionQueryPool::SendResult(accountId, playerGuid, std::move(data));
+        });
+        return;
+    }
+
     WorldPacket data(SMSG_AUCTION_OWNER_LIST_RESULT, (4 + 4 + 4));
     data << uint32(0);                                      // amount place holder
 
@@ -592,7 +647,7 @@ void WorldSession::HandleAuctionListOwnerItems(WorldPacket& recv_data)
     data.put<uint32>(0, count);
     data << uint32(totalcount);
     data << uint32(300);                                    // 2.3.0 delay for next isFull request?
-    SendPacket(data);
+    SendPacket(std::make_shared<WorldPacket const>(std::move(data)));
 }
 
 // this void is called when player clicks on search button
@@ -601,7 +656,7 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
     DEBUG_LOG("WORLD: HandleAuctionListItems");
 
     ObjectGuid auctioneerGuid;
-    std::string searchedname;
+    std::string_view searchedname;                          // points into recv_data, only converted below
     uint8 levelmin, levelmax, usable, isFull, sortCount;
     uint32 listfrom, auctionSlotID, auctionMainCategory, auctionSubCategory, quality;
 
@@ -639,39 +694,64 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
     // always return pointer
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(auctionHouseEntry);
 
-    // Sort
-    AuctionHouseObject::AuctionEntryMap const& aucs = auctionHouse->GetAuctions();
-    std::vector<AuctionEntry*> auctions;
-    auctions.reserve(aucs.size());
+    // converting string that we try to find to lower case
+    AuctionListFilter filter;
+    if (!Utf8toWStr(searchedname, filter.searchedName))
+        return;
 
-    for (const auto& auc : aucs)
-        auctions.push_back(auc.second);
+    wstrToLower(filter.searchedName);
+    filter.levelMin = levelmin;
+    filter.levelMax = levelmax;
+    filter.inventoryType = auctionSlotID;
+    filter.itemClass = auctionMainCategory;
+    filter.itemSubClass = auctionSubCategory;
+    filter.quality = quality;
+    filter.locIdx = GetSessionDbLocaleIndex();
 
-    AuctionSorter sorter(Sort, GetPlayer());
-    std::sort(auctions.begin(), auctions.end(), sorter);
+    AuctionSorter sorter(Sort, filter.locIdx);
 
     // DEBUG_LOG("Auctionhouse search %s list from: %u, searchedname: %s, levelmin: %u, levelmax: %u, auctionSlotID: %u, auctionMainCategory: %u, auctionSubCategory: %u, quality: %u, usable: %u",
     //  auctioneerGuid.GetString().c_str(), listfrom, searchedname.c_str(), levelmin, levelmax, auctionSlotID, auctionMainCategory, auctionSubCategory, quality, usable);
 
+    // usable items depend on the player, those searches stay on the world thread
+    if (!usable && sAuctionQueries.IsRunning())
+    {
+        std::shared_ptr<AuctionHouseSnapshot const> snapshot = auctionHouse->GetSnapshot();
+        sAuctionQueries.Enqueue([snapshot, filter, sorter, listfrom, isFull, accountId = GetAccountId(), playerGuid = GetPlayer()->GetObjectGuid()]()
+        {
+            WorldPacket data(SMSG_AUCTION_LIST_RESULT, (4 + 4 + 4));
+            uint32 count = 0;
+            uint32 totalcount = 0;
+            data << uint32(0);
+
+            snapshot->BuildListAuctionItems(data, filter, sorter, listfrom, isFull != 0, count, totalcount);
+
+            data.put<uint32>(0, count);
+            data << uint32(totalcount);
+            data << uint32(300);                            // 2.3.0 delay for next isFull request?
+            AuctionQueryPool::SendResult(accountId, playerGuid, std::move(data));
+        });
+        return;
+    }
+
+    // candidates of the searched item class, filtered and sorted in BuildListAuctionItems
+    std::vector<AuctionEntry*> auctions;
+    if (isFull)
+        auctionHouse->GetAuctionsByClass(0xffffffff, 0xffffffff, auctions);
+    else
+        auctionHouse->GetAuctionsByClass(auctionMainCategory, auctionSubCategory, auctions);
+
     WorldPacket data(SMSG_AUCTION_LIST_RESULT, (4 + 4 + 4));
     uint32 count = 0;
     uint32 totalcount = 0;
     data << uint32(0);
 
-    // converting string that we try to find to lower case
-    std::wstring wsearchedname;
-    if (!Utf8toWStr(searchedname, wsearchedname))
-        return;
-
-    wstrToLower(wsearchedname);
-
-    BuildListAuctionItems(auctions, data, wsearchedname, listfrom, levelmin, levelmax, usable,
-                          auctionSlotID, auctionMainCategory, auctionSubCategory, quality, count, totalcount, isFull != 0);
+    BuildListAuctionItems(auctions, filter, sorter, data, listfrom, usable, count, totalcount, isFull != 0);
 
     data.put<uint32>(0, count);
     data << uint32(totalcount);
     data << uint32(300);                                    // 2.3.0 delay for next isFull request?
-    SendPacket(data);
+    SendPacket(std::make_shared<WorldPacket const>(std::move(data)));
 }
 
 void WorldSession::HandleAuctionListPendingSales(WorldPacket& recv_data)
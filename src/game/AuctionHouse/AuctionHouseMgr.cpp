@@ -17,6 +17,7 @@
  */
 
 #include "AuctionHouse/AuctionHouseMgr.h"
+#include "AuctionHouse/AuctionQueryPool.h"
 #include "Database/DatabaseEnv.h"
 #include "Server/SQLStorages.h"
 #include "Server/DBCStores.h"
@@ -560,47 +561,182 @@ AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(Unit* unit)
     return sAuctionHouseStore.LookupEntry(houseid);
 }
 
+void AuctionHouseObject::AddAuction(AuctionEntry* ah)
+{
+    MANGOS_ASSERT(ah);
+    AuctionsMap[ah->Id] = ah;
+    m_dueAuctions.insert(std::make_pair(GetDueTime(ah), ah->Id));
+    m_snapshotDirty = true;
+
+    // auctions of unknown items can't match any class filter, they are only listed unfiltered
+    if (uint32 key = GetClassIndexKey(ah))
+        m_classIndex[key][ah->Id] = ah;
+}
+
+bool AuctionHouseObject::RemoveAuction(uint32 id)
+{
+    AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+    if (itr == AuctionsMap.end())
+        return false;
+
+    RemoveFromClassIndex(itr->second);
+    m_dueAuctions.erase(std::make_pair(GetDueTime(itr->second), id));
+    AuctionsMap.erase(itr);
+    m_snapshotDirty = true;
+    return true;
+}
+
+uint32 AuctionHouseObject::GetClassIndexKey(AuctionEntry const* ah)
+{
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(ah->itemTemplate);
+    if (!proto)
+        return 0;
+
+    // class 0 (consumable) subclass 0 is shifted by one to keep 0 free as "not indexed"
+    return ((proto->Class << 16) | proto->SubClass) + 1;
+}
+
+void AuctionHouseObject::RemoveFromClassIndex(AuctionEntry const* ah)
+{
+    uint32 key = GetClassIndexKey(ah);
+    if (!key)
+        return;
+
+    AuctionClassIndex::iterator itr = m_classIndex.find(key);
+    if (itr == m_classIndex.end())
+        return;
+
+    itr->second.erase(ah->Id);
+    if (itr->second.empty())
+        m_classIndex.erase(itr);
+}
+
+void AuctionHouseObject::GetAuctionsByClass(uint32 itemClass, uint32 itemSubClass, std::vector<AuctionEntry*>& auctions) const
+{
+    if (itemClass == 0xffffffff)
+    {
+        auctions.reserve(AuctionsMap.size());
+        for (const auto& auc : AuctionsMap)
+            auctions.push_back(auc.second);
+        return;
+    }
+
+    // out of the key range, no item has such a class or subclass
+    if (itemClass > 0xFFFF || (itemSubClass != 0xffffffff && itemSubClass > 0xFFFF))
+        return;
+
+    AuctionClassIndex::const_iterator begin, end;
+    if (itemSubClass == 0xffffffff)
+    {
+        begin = m_classIndex.lower_bound((itemClass << 16) + 1);
+        end = m_classIndex.lower_bound(((itemClass + 1) << 16) + 1);
+    }
+    else
+    {
+        begin = m_classIndex.find(((itemClass << 16) | itemSubClass) + 1);
+        end = begin == m_classIndex.end() ? begin : std::next(begin);
+    }
+
+    for (AuctionClassIndex::const_iterator itr = begin; itr != end; ++itr)
+        for (const auto& auc : itr->second)
+            auctions.push_back(auc.second);
+}
+
+std::shared_ptr<AuctionHouseSnapshot const> AuctionHouseObject::GetSnapshot()
+{
+    uint32 now = WorldTimer::getMSTime();
+    if (m_snapshot && (!m_snapshotDirty || WorldTimer::getMSTimeDiff(m_snapshotTime, now) < sWorld.getConfig(CONFIG_UINT32_AUCTION_SNAPSHOT_INTERVAL)))
+        return m_snapshot;
+
+    std::shared_ptr<AuctionHouseSnapshot> snapshot = std::make_shared<AuctionHouseSnapshot>();
+    snapshot->entries.reserve(AuctionsMap.size());
+    for (const auto& itr : AuctionsMap)
+    {
+        AuctionEntry const* auction = itr.second;
+        if (auction->moneyDeliveryTime)
+            continue;
+        Item* item = sAuctionMgr.GetAItem(auction->itemGuidLow);
+        if (!item)
+            continue;
+
+        snapshot->entries.emplace_back();
+        AuctionHouseSnapshot::Entry& entry = snapshot->entries.back();
+        entry.auction = *auction;
+        entry.proto = item->GetProto();
+        for (uint8 i = 0; i < MAX_INSPECTED_ENCHANTMENT_SLOT; ++i)
+        {
+            entry.enchantments[i][0] = item->GetEnchantmentId(EnchantmentSlot(i));
+            entry.enchantments[i][1] = item->GetEnchantmentDuration(EnchantmentSlot(i));
+            entry.enchantments[i][2] = item->GetEnchantmentCharges(EnchantmentSlot(i));
+        }
+        entry.suffixFactor = item->GetItemSuffixFactor();
+        entry.spellCharges = item->GetSpellCharges();
+    }
+
+    m_snapshot = std::move(snapshot);
+    m_snapshotTime = now;
+    m_snapshotDirty = false;
+    return m_snapshot;
+}
+
+void AuctionHouseObject::SetAuctionWon(AuctionEntry* ah, time_t moneyDeliveryTime)
+{
+    m_dueAuctions.erase(std::make_pair(GetDueTime(ah), ah->Id));
+    ah->moneyDeliveryTime = moneyDeliveryTime;
+    m_dueAuctions.insert(std::make_pair(moneyDeliveryTime, ah->Id));
+    m_snapshotDirty = true;
+}
+
+void AuctionHouseObject::SetAuctionExpireTime(AuctionEntry* ah, time_t expireTime)
+{
+    m_dueAuctions.erase(std::make_pair(GetDueTime(ah), ah->Id));
+    ah->expireTime = expireTime;
+    m_dueAuctions.insert(std::make_pair(GetDueTime(ah), ah->Id));
+    m_snapshotDirty = true;
+}
+
 void AuctionHouseObject::Update()
 {
     time_t curTime = sWorld.GetGameTime();
-    ///- Handle expired auctions
-    for (AuctionEntryMap::iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end();)
+    std::vector<uint32> deletedIds;
+
+    ///- Handle expired auctions, only the due ones are visited
+    while (!m_dueAuctions.empty() && curTime > m_dueAuctions.begin()->first)
     {
-        if (itr->second->moneyDeliveryTime)                 // pending auction
-        {
-            if (curTime > itr->second->moneyDeliveryTime)
-            {
-                sAuctionMgr.SendAuctionSuccessfulMail(itr->second);
+        uint32 auctionId = m_dueAuctions.begin()->second;
+        m_dueAuctions.erase(m_dueAuctions.begin());
 
-                itr->second->DeleteFromDB();
-                MANGOS_ASSERT(!itr->second->itemGuidLow);   // already removed or send in mail at won
-                delete itr->second;
-                AuctionsMap.erase(itr++);
-                continue;
-            }
+        AuctionEntryMap::iterator itr = AuctionsMap.find(auctionId);
+        if (itr == AuctionsMap.end())
+            continue;
+
+        AuctionEntry* auction = itr->second;
+        if (auction->moneyDeliveryTime)                     // pending auction
+        {
+            sAuctionMgr.SendAuctionSuccessfulMail(auction);
+            MANGOS_ASSERT(!auction->itemGuidLow);           // already removed or send in mail at won
         }
         else                                                // active auction
         {
-            if (curTime > itr->second->expireTime)
+            ///- perform the transaction if there was bidder, it is due again at money delivery
+            if (auction->bid)
             {
-                ///- perform the transaction if there was bidder
-                if (itr->second->bid)
-                    itr->second->AuctionBidWinning();
-                ///- cancel the auction if there was no bidder and clear the auction
-                else
-                {
-                    sAuctionMgr.SendAuctionExpiredMail(itr->second);
-
-                    itr->second->DeleteFromDB();
-                    delete itr->second;
-                    AuctionsMap.erase(itr++);
-                    continue;
-                }
+                auction->AuctionBidWinning();
+                continue;
             }
+
+            ///- cancel the auction if there was no bidder and clear the auction
+            sAuctionMgr.SendAuctionExpiredMail(auction);
         }
 
-        ++itr;
+        deletedIds.push_back(auction->Id);
+        RemoveFromClassIndex(auction);
+        m_snapshotDirty = true;
+        delete auction;
+        AuctionsMap.erase(itr);
     }
+
+    AuctionEntry::DeleteFromDB(deletedIds);
 }
 
 void AuctionHouseObject::BuildListBidderItems(WorldPacket& data, Player* player, uint32 listfrom, uint32& count, uint32& totalcount)
@@ -643,7 +779,7 @@ void AuctionHouseObject::BuildListOwnerItems(WorldPacket& data, Player* player,
     }
 }
 
-int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Player* viewPlayer) const
+int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, int32 loc_idx) const
 {
     switch (column)
     {
@@ -710,8 +846,6 @@ int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Pl
             if (!itemProto2 || !itemProto1)
                 return 0;
 
-            int32 loc_idx = viewPlayer->GetSession()->GetSessionDbLocaleIndex();
-
             std::string name1 = itemProto1->Name1;
             sObjectMgr.GetItemLocaleStrings(itemProto1->ItemId, loc_idx, &name1);
 
@@ -792,7 +926,7 @@ bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc
         if (m_sort[i] == MAX_AUCTION_SORT)                  // end of sort
             return false;
 
-        int res = auc1->CompareAuctionEntry(m_sort[i] & ~AUCTION_SORT_REVERSED, auc2, m_viewPlayer);
+        int res = auc1->CompareAuctionEntry(m_sort[i] & ~AUCTION_SORT_REVERSED, auc2, m_locIdx);
         // "equal" by used column
         if (res == 0)
             continue;
@@ -803,81 +937,85 @@ bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc
     return false;                                           // "equal" by all sorts
 }
 
-void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
-        uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull) const
+bool AuctionListFilter::Matches(ItemPrototype const* proto) const
 {
-    int loc_idx = _player->GetSession()->GetSessionDbLocaleIndex();
+    if (itemClass != 0xffffffff && proto->Class != itemClass)
+        return false;
 
-    for (auto Aentry : auctions)
-    {
-        if (Aentry->moneyDeliveryTime)
-            continue;
-        Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (!item)
-            continue;
+    if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
+        return false;
 
-        if (isFull)
-        {
-            ++count;
-            Aentry->BuildAuctionInfo(data);
-        }
-        else
+    if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
+    {
+        if (inventoryType != INVTYPE_CHEST || proto->InventoryType != INVTYPE_ROBE)
         {
-            ItemPrototype const* proto = item->GetProto();
+            // if inventory type is chest, we want to return robes too
+            // i.e. cloth chests are in most cases robes by definition
 
-            if (itemClass != 0xffffffff && proto->Class != itemClass)
-                continue;
+            return false;
+        }
+    }
 
-            if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
-                continue;
+    if (quality != 0xffffffff && proto->Quality < quality)
+        return false;
 
-            if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
-            {
-                if (inventoryType != INVTYPE_CHEST || proto->InventoryType != INVTYPE_ROBE)
-                {
-                    // if inventory type is chest, we want to return robes too
-                    // i.e. cloth chests are in most cases robes by definition
+    if (levelMin != 0x00 && (proto->RequiredLevel < levelMin || (levelMax != 0x00 && proto->RequiredLevel > levelMax)))
+        return false;
 
-                    continue;
-                }
-            }
+    if (!searchedName.empty())
+    {
+        std::string name = proto->Name1;
+        sObjectMgr.GetItemLocaleStrings(proto->ItemId, locIdx, &name);
 
-            if (quality != 0xffffffff && proto->Quality < quality)
-                continue;
+        if (!Utf8FitTo(name, searchedName))
+            return false;
+    }
 
-            if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
-                continue;
+    return true;
+}
 
-            if (usable != 0x00)
-            {
-                if (_player->CanUseItem(item) != EQUIP_ERR_OK)
-                    continue;
+void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*>& auctions, AuctionListFilter const& filter, AuctionSorter const& sorter, WorldPacket& data, uint32 listfrom,
+        uint32 usable, uint32& count, uint32& totalcount, bool isFull) const
+{
+    // filter before sorting, so only the matching auctions are compared
+    auctions.erase(std::remove_if(auctions.begin(), auctions.end(), [&](AuctionEntry const* Aentry)
+    {
+        if (Aentry->moneyDeliveryTime)
+            return true;
+        Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
+        if (!item)
+            return true;
 
-                if (proto->Class == ITEM_CLASS_RECIPE)
-                {
-                    if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
-                    {
-                        if (_player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
-                            continue;
-                    }
-                }
-            }
+        if (isFull)
+            return false;
 
-            std::string name = proto->Name1;
-            sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
+        ItemPrototype const* proto = item->GetProto();
 
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
-                continue;
+        if (usable != 0x00)
+        {
+            if (_player->CanUseItem(item) != EQUIP_ERR_OK)
+                return true;
 
-            if (count < MAX_AUCTION_ITEMS_CLIENT_UI_PAGE && totalcount >= listfrom)
+            if (proto->Class == ITEM_CLASS_RECIPE)
             {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
+                if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
+                {
+                    if (_player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
+                        return true;
+                }
             }
         }
 
-        ++totalcount;
-    }
+        return !filter.Matches(proto);
+    }), auctions.end());
+
+    totalcount = auctions.size();
+
+    BuildAuctionListPage(auctions, sorter, listfrom, isFull, [&](AuctionEntry const* Aentry)
+    {
+        ++count;
+        Aentry->BuildAuctionInfo(data);
+    });
 }
 
 void AuctionHouseObject::BuildListPendingSales(WorldPacket& data, Player* player, uint32& count)
@@ -908,7 +1046,7 @@ void AuctionHouseObject::BuildListPendingSales(WorldPacket& data, Player* player
     }
 }
 
-AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout, uint32 deposit, Player* pl /*= nullptr*/)
+AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout, uint32 deposit, Player* pl /*= nullptr*/, bool ownTransaction /*= true*/)
 {
     uint32 auction_time = uint32(etime * sWorld.getConfig(CONFIG_FLOAT_RATE_AUCTION_TIME));
 
@@ -936,7 +1074,8 @@ AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHou
 
     sAuctionMgr.AddAItem(newItem);
 
-    CharacterDatabase.BeginTransaction();
+    if (ownTransaction)
+        CharacterDatabase.BeginTransaction();
 
     newItem->SaveToDB();
     AH->SaveToDB();
@@ -944,7 +1083,8 @@ AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHou
     if (pl)
         pl->SaveInventoryAndGoldToDB();
 
-    CharacterDatabase.CommitTransaction();
+    if (ownTransaction)
+        CharacterDatabase.CommitTransaction();
 
     return AH;
 }
@@ -1003,6 +1143,21 @@ void AuctionEntry::DeleteFromDB() const
     CharacterDatabase.PExecute("DELETE FROM auction WHERE id = '%u'", Id);
 }
 
+void AuctionEntry::DeleteFromDB(std::vector<uint32> const& auctionIds)
+{
+    // one statement per this many auctions keeps the query length bounded
+    size_t const batchSize = 500;
+
+    for (size_t i = 0; i < auctionIds.size(); i += batchSize)
+    {
+        std::ostringstream ids;
+        for (size_t j = i; j < std::min(i + batchSize, auctionIds.size()); ++j)
+            ids << (j == i ? "" : ",") << auctionIds[j];
+
+        CharacterDatabase.PExecute("DELETE FROM auction WHERE id IN (%s)", ids.str().c_str());
+    }
+}
+
 void AuctionEntry::SaveToDB() const
 {
     // No SQL injection (no strings)
@@ -1013,7 +1168,7 @@ void AuctionEntry::SaveToDB() const
 
 void AuctionEntry::AuctionBidWinning(Player* newbidder)
 {
-    moneyDeliveryTime = time(nullptr) + HOUR;
+    sAuctionMgr.GetAuctionsMap(auctionHouseEntry)->SetAuctionWon(this, time(nullptr) + HOUR);
 
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.PExecute("UPDATE auction SET itemguid = 0, moneyTime = '" UI64FMTD "', buyguid = '%u', lastbid = '%u' WHERE id = '%u'", (uint64)moneyDeliveryTime, bidder, bid, Id);
@@ -1047,6 +1202,7 @@ bool AuctionEntry::UpdateBid(uint32 newbid, Player* newbidder /*=nullptr*/)
 
     bidder = newbidder ? newbidder->GetGUIDLow() : 0;
     bid = newbid;
+    sAuctionMgr.GetAuctionsMap(auctionHouseEntry)->SetSnapshotDirty();
 
     if ((newbid < buyout) || (buyout == 0))                 // bid
     {
@@ -22,8 +22,12 @@
 #include "Common.h"
 #include "Server/DBCStructure.h"
 
+#include <memory>
+
 class Item;
 class Player;
+struct AuctionHouseSnapshot;
+struct ItemPrototype;
 class Unit;
 class WorldPacket;
 
@@ -78,11 +82,12 @@ struct AuctionEntry
     uint32 GetAuctionOutBid() const;
     bool BuildAuctionInfo(WorldPacket& data) const;
     void DeleteFromDB() const;
+    static void DeleteFromDB(std::vector<uint32> const& auctionIds);
     void SaveToDB() const;
     void AuctionBidWinning(Player* newbidder = nullptr);
 
     // -1,0,+1 order result
-    int CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Player* viewPlayer) const;
+    int CompareAuctionEntry(uint32 column, const AuctionEntry* auc, int32 loc_idx) const;
 
     bool UpdateBid(uint32 newbid, Player* newbidder = nullptr);// true if normal bid, false if buyout, bidder==nullptr for generated bid
 };
@@ -91,7 +96,7 @@ struct AuctionEntry
 class AuctionHouseObject
 {
     public:
-        AuctionHouseObject() {}
+        AuctionHouseObject() : m_snapshotTime(0), m_snapshotDirty(true) {}
         ~AuctionHouseObject()
         {
             for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
@@ -100,17 +105,17 @@ class AuctionHouseObject
 
         typedef std::map<uint32, AuctionEntry*> AuctionEntryMap;
         typedef std::pair<AuctionEntryMap::const_iterator, AuctionEntryMap::const_iterator> AuctionEntryMapBounds;
+        // (item class << 16 | item subclass) -> auctions, ordered so that a whole class is one key range
+        typedef std::map<uint32, AuctionEntryMap> AuctionClassIndex;
+        // (time of expiry or of money delivery, auction id), the next auction due for Update first
+        typedef std::set<std::pair<time_t, uint32>> AuctionDueQueue;
 
         uint32 GetCount() const { return AuctionsMap.size(); }
 
         AuctionEntryMap const& GetAuctions() const { return AuctionsMap; }
         AuctionEntryMapBounds GetAuctionsBounds() const {return AuctionEntryMapBounds(AuctionsMap.begin(), AuctionsMap.end()); }
 
-        void AddAuction(AuctionEntry* ah)
-        {
-            MANGOS_ASSERT(ah);
-            AuctionsMap[ah->Id] = ah;
-        }
+        void AddAuction(AuctionEntry* ah);
 
         AuctionEntry* GetAuction(uint32 id) const
         {
@@ -118,34 +123,92 @@ class AuctionHouseObject
             return itr != AuctionsMap.end() ? itr->second : nullptr;
         }
 
-        bool RemoveAuction(uint32 id)
-        {
-            return AuctionsMap.erase(id) > 0;
-        }
+        bool RemoveAuction(uint32 id);
+
+        // all auctions of the item class and subclass, 0xffffffff for any, in no particular order
+        void GetAuctionsByClass(uint32 itemClass, uint32 itemSubClass, std::vector<AuctionEntry*>& auctions) const;
 
         void Update();
 
+        // listed auctions for the auction query threads, rebuilt after changes once the current one is Auction.SnapshotInterval old
+        std::shared_ptr<AuctionHouseSnapshot const> GetSnapshot();
+        // the last snapshot has every change, so own auctions and bids can be listed from it
+        bool IsSnapshotCurrent() const { return m_snapshot && !m_snapshotDirty; }
+        void SetSnapshotDirty() { m_snapshotDirty = true; }
+
+        // the auction gets a money delivery time, so it is due at that time instead of its expiry
+        void SetAuctionWon(AuctionEntry* ah, time_t moneyDeliveryTime);
+        // moves the expiry of a not yet won auction, e.g. to let it expire at the next update
+        void SetAuctionExpireTime(AuctionEntry* ah, time_t expireTime);
+
         void BuildListBidderItems(WorldPacket& data, Player* player, uint32 listfrom, uint32& count, uint32& totalcount);
         void BuildListOwnerItems(WorldPacket& data, Player* player, uint32 listfrom, uint32& count, uint32& totalcount);
         void BuildListPendingSales(WorldPacket& data, Player* player, uint32& count);
 
-        AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout = 0, uint32 deposit = 0, Player* pl = nullptr);
+        // ownTransaction false when the caller saves several auctions in its own transaction
+        AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout = 0, uint32 deposit = 0, Player* pl = nullptr, bool ownTransaction = true);
     private:
+        static uint32 GetClassIndexKey(AuctionEntry const* ah);
+        void RemoveFromClassIndex(AuctionEntry const* ah);
+        static time_t GetDueTime(AuctionEntry const* ah) { return ah->moneyDeliveryTime ? ah->moneyDeliveryTime : ah->expireTime; }
+
         AuctionEntryMap AuctionsMap;
+        AuctionClassIndex m_classIndex;
+        AuctionDueQueue m_dueAuctions;
+
+        std::shared_ptr<AuctionHouseSnapshot const> m_snapshot;
+        uint32 m_snapshotTime;                              // WorldTimer::getMSTime() at build of m_snapshot
+        bool m_snapshotDirty;
 };
 
+// keeps its own copy of the sort columns and only the locale of the viewer, so it can be used by the auction query threads
 class AuctionSorter
 {
     public:
-        AuctionSorter(AuctionSorter const& sorter) : m_sort(sorter.m_sort), m_viewPlayer(sorter.m_viewPlayer) {}
-        AuctionSorter(uint8* sort, Player* viewPlayer) : m_sort(sort), m_viewPlayer(viewPlayer) {}
+        AuctionSorter(uint8 const* sort, int32 loc_idx) : m_locIdx(loc_idx) { memcpy(m_sort, sort, MAX_AUCTION_SORT); }
         bool operator()(const AuctionEntry* auc1, const AuctionEntry* auc2) const;
 
     private:
-        uint8* m_sort;
-        Player* m_viewPlayer;
+        uint8 m_sort[MAX_AUCTION_SORT];
+        int32 m_locIdx;
 };
 
+// search criteria of CMSG_AUCTION_LIST_ITEMS that don't depend on the searching player
+struct AuctionListFilter
+{
+    std::wstring searchedName;                              // lower case
+    uint32 levelMin;
+    uint32 levelMax;
+    uint32 inventoryType;
+    uint32 itemClass;
+    uint32 itemSubClass;
+    uint32 quality;
+    int32 locIdx;
+
+    bool Matches(ItemPrototype const* proto) const;
+};
+
+// sorts the matching auctions only as far as needed and passes the requested page, or all of them for a full listing, to build
+template <class T, class Compare, class Build>
+void BuildAuctionListPage(std::vector<T>& matches, Compare const& compare, uint32 listfrom, bool isFull, Build const& build)
+{
+    if (isFull)
+    {
+        std::sort(matches.begin(), matches.end(), compare);
+        for (T const& match : matches)
+            build(match);
+        return;
+    }
+
+    if (listfrom >= matches.size())
+        return;
+
+    typename std::vector<T>::iterator pageEnd = matches.begin() + std::min<size_t>(listfrom + MAX_AUCTION_ITEMS_CLIENT_UI_PAGE, matches.size());
+    std::partial_sort(matches.begin(), pageEnd, matches.end(), compare);
+    for (typename std::vector<T>::iterator itr = matches.begin() + listfrom; itr != pageEnd; ++itr)
+        build(*itr);
+}
+
 enum AuctionHouseType
 {
     AUCTION_HOUSE_ALLIANCE  = 0,
@@ -0,0 +1,174 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "AuctionHouse/AuctionQueryPool.h"
+#include "Entities/Player.h"
+#include "Log.h"
+#include "Server/WorldPacket.h"
+#include "Server/WorldSession.h"
+#include "World/World.h"
+
+void AuctionHouseSnapshot::Entry::BuildAuctionInfo(WorldPacket& data) const
+{
+    data << uint32(auction.Id);
+    data << uint32(auction.itemTemplate);
+
+    for (uint8 i = 0; i < MAX_INSPECTED_ENCHANTMENT_SLOT; ++i)
+    {
+        data << uint32(enchantments[i][0]);
+        data << uint32(enchantments[i][1]);
+        data << uint32(enchantments[i][2]);
+    }
+
+    data << uint32(auction.itemRandomPropertyId);           // random item property id
+    data << uint32(suffixFactor);                           // SuffixFactor
+    data << uint32(auction.itemCount);                      // item->count
+    data << uint32(spellCharges);                           // item->charge FFFFFFF
+    data << uint32(0);                                      // item flags (dynamic?) (0x04 no lockId?)
+    data << ObjectGuid(HIGHGUID_PLAYER, auction.owner);     // Auction->owner
+    data << uint32(auction.startbid);                       // Auction->startbid (not sure if useful)
+    data << uint32(auction.bid ? auction.GetAuctionOutBid() : 0); // minimal outbid
+    data << uint32(auction.buyout);                         // auction->buyout
+    data << uint32((auction.expireTime - time(nullptr))*IN_MILLISECONDS); // time left
+    data << ObjectGuid(HIGHGUID_PLAYER, auction.bidder);    // auction->bidder current
+    data << uint32(auction.bid);                            // current bid
+}
+
+AuctionHouseSnapshot::Entry const* AuctionHouseSnapshot::GetEntry(uint32 auctionId) const
+{
+    EntryList::const_iterator itr = std::lower_bound(entries.begin(), entries.end(), auctionId, [](Entry const& entry, uint32 id)
+    {
+        return entry.auction.Id < id;
+    });
+    return itr != entries.end() && itr->auction.Id == auctionId ? &*itr : nullptr;
+}
+
+void AuctionHouseSnapshot::BuildListAuctionItems(WorldPacket& data, AuctionListFilter const& filter, AuctionSorter const& sorter, uint32 listfrom, bool isFull, uint32& count, uint32& totalcount) const
+{
+    std::vector<Entry const*> matches;
+    if (isFull)
+        matches.reserve(entries.size());
+
+    for (Entry const& entry : entries)
+        if (isFull || filter.Matches(entry.proto))
+            matches.push_back(&entry);
+
+    totalcount = matches.size();
+
+    BuildAuctionListPage(matches, [&sorter](Entry const* entry1, Entry const* entry2)
+    {
+        return sorter(&entry1->auction, &entry2->auction);
+    }, listfrom, isFull, [&](Entry const* entry)
+    {
+        ++count;
+        entry->BuildAuctionInfo(data);
+    });
+}
+
+void AuctionHouseSnapshot::BuildListBidderItems(WorldPacket& data, uint32 bidderLowGuid, uint32 listfrom, uint32& count, uint32& totalcount) const
+{
+    for (Entry const& entry : entries)
+    {
+        if (entry.auction.bidder == bidderLowGuid)
+        {
+            if (count < MAX_AUCTION_ITEMS_CLIENT_UI_PAGE && totalcount >= listfrom)
+            {
+                entry.BuildAuctionInfo(data);
+                ++count;
+            }
+            ++totalcount;
+        }
+    }
+}
+
+void AuctionHouseSnapshot::BuildListOwnerItems(WorldPacket& data, uint32 ownerLowGuid, uint32 listfrom, uint32& count, uint32& totalcount) const
+{
+    for (Entry const& entry : entries)
+    {
+        if (entry.auction.owner == ownerLowGuid)
+        {
+            if (count < MAX_AUCTION_ITEMS_CLIENT_UI_PAGE && totalcount >= listfrom)
+            {
+                entry.BuildAuctionInfo(data);
+                ++count;
+            }
+            ++totalcount;
+        }
+    }
+}
+
+AuctionQueryPool& AuctionQueryPool::Instance()
+{
+    static AuctionQueryPool pool;
+    return pool;
+}
+
+void AuctionQueryPool::Start(uint32 threads)
+{
+    for (uint32 i = 0; i < threads; ++i)
+        m_threads.emplace_back(&AuctionQueryPool::WorkerThread, this);
+
+    if (!m_threads.empty())
+        sLog.outString("Auction house listings are built by %u query threads", threads);
+}
+
+void AuctionQueryPool::Stop()
+{
+    if (m_threads.empty())
+        return;
+
+    m_queue.Cancel();
+    for (std::thread& thread : m_threads)
+        thread.join();
+    m_threads.clear();
+}
+
+bool AuctionQueryPool::Enqueue(Job const& job)
+{
+    if (m_threads.empty())
+        return false;
+
+    m_queue.Push(new Job(job));
+    return true;
+}
+
+void AuctionQueryPool::SendResult(uint32 accountId, ObjectGuid playerGuid, WorldPacket&& data)
+{
+    std::shared_ptr<WorldPacket const> packet = std::make_shared<WorldPacket const>(std::move(data));
+    sWorld.GetMessager().AddMessage([accountId, playerGuid, packet](World* world)
+    {
+        // the character could have logged out while the listing was built
+        if (WorldSession* session = world->FindSession(accountId))
+            if (session->GetPlayer() && session->GetPlayer()->GetObjectGuid() == playerGuid)
+                session->SendPacket(packet);
+    });
+}
+
+void AuctionQueryPool::WorkerThread()
+{
+    while (true)
+    {
+        Job* job = nullptr;
+        m_queue.WaitAndPop(job);
+        if (!job)
+            break;
+
+        (*job)();
+        delete job;
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _AUCTION_QUERY_POOL_H
+#define _AUCTION_QUERY_POOL_H
+
+#include "Common.h"
+#include "AuctionHouse/AuctionHouseMgr.h"
+#include "Entities/Item.h"
+#include "Util/ProducerConsumerQueue.h"
+
+#include <functional>
+#include <memory>
+#include <thread>
+
+class WorldPacket;
+
+// Immutable copy of the listed auctions of one house. Built on the world thread,
+// then only read, by any number of auction query threads at once.
+struct AuctionHouseSnapshot
+{
+    struct Entry
+    {
+        AuctionEntry auction;
+        ItemPrototype const* proto;
+        uint32 enchantments[MAX_INSPECTED_ENCHANTMENT_SLOT][3]; // id, duration, charges
+        uint32 suffixFactor;
+        uint32 spellCharges;
+
+        // same layout as AuctionEntry::BuildAuctionInfo
+        void BuildAuctionInfo(WorldPacket& data) const;
+    };
+
+    typedef std::vector<Entry> EntryList;
+
+    EntryList entries;                                      // ordered by auction id, without pending money deliveries
+
+    Entry const* GetEntry(uint32 auctionId) const;
+
+    void BuildListAuctionItems(WorldPacket& data, AuctionListFilter const& filter, AuctionSorter const& sorter, uint32 listfrom, bool isFull, uint32& count, uint32& totalcount) const;
+    void BuildListBidderItems(WorldPacket& data, uint32 bidderLowGuid, uint32 listfrom, uint32& count, uint32& totalcount) const;
+    void BuildListOwnerItems(WorldPacket& data, uint32 ownerLowGuid, uint32 listfrom, uint32& count, uint32& totalcount) const;
+};
+
+// Threads answering auction listings from snapshots, bids and buyouts stay on the world thread
+class AuctionQueryPool
+{
+    public:
+        typedef std::function<void()> Job;
+
+        static AuctionQueryPool& Instance();
+
+        ~AuctionQueryPool() { Stop(); }
+
+        void Start(uint32 threads);
+        void Stop();
+
+        bool IsRunning() const { return !m_threads.empty(); }
+
+        // false without query threads, the caller lists on the world thread then
+        bool Enqueue(Job const& job);
+
+        // from a query thread, sends the result to the player through the world thread if still logged in
+        static void SendResult(uint32 accountId, ObjectGuid playerGuid, WorldPacket&& data);
+
+    private:
+        void WorkerThread();
+
+        std::vector<std::thread> m_threads;
+        ProducerConsumerQueue<Job*> m_queue;
+};
+
+#define sAuctionQueries AuctionQueryPool::Instance()
+
+#endif
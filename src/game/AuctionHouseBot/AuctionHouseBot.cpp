@@ -24,13 +24,19 @@
 #include "SystemConfig.h"
 #include "World/World.h"
 
+#ifdef BUILD_METRICS
+ #include "Metric/Metric.h"
+#endif
+
+#include <chrono>
+
 // Format is YYYYMMDDRR where RR is the change in the conf file
 // for that day.
 #define AUCTIONHOUSEBOT_CONF_VERSION    2021011201
 
 INSTANTIATE_SINGLETON_1(AuctionHouseBot);
 
-AuctionHouseBot::AuctionHouseBot() : m_configFileName(_AUCTIONHOUSEBOT_CONFIG), m_houseAction(-1)
+AuctionHouseBot::AuctionHouseBot() : m_configFileName(_AUCTIONHOUSEBOT_CONFIG), m_houseAction(-1), m_updateBudget(0)
 {
 }
 
@@ -40,6 +46,11 @@ AuctionHouseBot::~AuctionHouseBot()
 
 void AuctionHouseBot::Initialize()
 {
+    // a running cycle may refer to the old configuration
+    m_cycle = AuctionHouseBotCycle();
+    m_lootSources.clear();
+    m_sellValues.clear();
+
     if (!m_ahBotCfg.SetSource(m_configFileName))
     {
         // set buy/sell chance to 0, this prevents Update() from accessing uninitialized variables
@@ -53,6 +64,8 @@ void AuctionHouseBot::Initialize()
     m_chanceSell = GetMinMaxConfig("AuctionHouseBot.Chance.Sell", 0, 100, 10);
     m_chanceBuy = GetMinMaxConfig("AuctionHouseBot.Chance.Buy", 0, 100, 10);
 
+    m_updateBudget = GetMinMaxConfig("AuctionHouseBot.Update.Budget", 0, 1000, 5);
+
     sLog.outString("AHBot selling items: %s", m_chanceSell > 0 ? "Enabled" : "Disabled");
     sLog.outString("AHBot buying items: %s", m_chanceBuy > 0 ? "Enabled" : "Disabled");
 
@@ -95,6 +108,31 @@ void AuctionHouseBot::Initialize()
         FillUintVectorFromQuery("SELECT item FROM npc_vendor", tmpVector);
         std::copy(tmpVector.begin(), tmpVector.end(), std::inserter(m_vendorItems, m_vendorItems.end()));
 
+        m_lootSources.push_back({ &LootTemplates_Creature, &m_creatureLootNormalConfig, &m_creatureLootNormalTemplates });       // normal creature loot
+        m_lootSources.push_back({ &LootTemplates_Creature, &m_creatureLootEliteConfig, &m_creatureLootEliteTemplates });         // elite creature loot
+        m_lootSources.push_back({ &LootTemplates_Creature, &m_creatureLootRareEliteConfig, &m_creatureLootRareEliteTemplates }); // rare elite creature loot
+        m_lootSources.push_back({ &LootTemplates_Creature, &m_creatureLootWorldBossConfig, &m_creatureLootWorldBossTemplates }); // world boss creature loot
+        m_lootSources.push_back({ &LootTemplates_Creature, &m_creatureLootRareConfig, &m_creatureLootRareTemplates });           // rare creature loot
+        m_lootSources.push_back({ &LootTemplates_Disenchant, &m_disenchantLootConfig, &m_disenchantLootTemplates });             // disenchant loot
+        m_lootSources.push_back({ &LootTemplates_Fishing, &m_fishingLootConfig, &m_fishingLootTemplates });                      // fishing loot
+        m_lootSources.push_back({ &LootTemplates_Gameobject, &m_gameobjectLootConfig, &m_gameobjectLootTemplates });             // gameobject loot
+        m_lootSources.push_back({ &LootTemplates_Skinning, &m_skinningLootConfig, &m_skinningLootTemplates });                   // skinning loot
+
+        // drop what can never be added once, instead of skipping it in every cycle
+        for (auto const& source : m_lootSources)
+        {
+            LootStore* store = source.store;
+            source.templates->erase(std::remove_if(source.templates->begin(), source.templates->end(), [store](uint32 lootId)
+            {
+                return !store->HaveLootFor(lootId);
+            }), source.templates->end());
+        }
+        m_professionItems.erase(std::remove_if(m_professionItems.begin(), m_professionItems.end(), [](uint32 itemId)
+        {
+            ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(itemId);
+            return !prototype || prototype->Quality == 0;
+        }), m_professionItems.end());
+
         // item value
         ParseItemValueConfig("AuctionHouseBot.Value.Poor", m_itemValue[ITEM_QUALITY_POOR]);
         ParseItemValueConfig("AuctionHouseBot.Value.Normal", m_itemValue[ITEM_QUALITY_NORMAL]);
@@ -153,119 +191,237 @@ void AuctionHouseBot::Initialize()
 }
 
 void AuctionHouseBot::Update()
+{
+    if (!m_cycle.active)
+        StartCycle();
+
+    if (m_cycle.active)
+        RunCycle(m_updateBudget);
+}
+
+void AuctionHouseBot::ContinueCycle()
+{
+    if (m_cycle.active)
+        RunCycle(m_updateBudget);
+}
+
+void AuctionHouseBot::StartCycle()
 {
     if (++m_houseAction >= MAX_AUCTION_HOUSE_TYPE * 2)
         m_houseAction = 0;
 
-    AuctionHouseType houseType = AuctionHouseType(m_houseAction % MAX_AUCTION_HOUSE_TYPE);
-    AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(houseType);
+    m_cycle = AuctionHouseBotCycle();
+    m_cycle.houseType = AuctionHouseType(m_houseAction % MAX_AUCTION_HOUSE_TYPE);
     if (m_houseAction < MAX_AUCTION_HOUSE_TYPE && urand(0, 99) < m_chanceSell)
     {
-        // Sell items
-        std::unordered_map<uint32, uint32> itemMap;
-
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootNormalConfig, m_creatureLootNormalTemplates, itemMap);       // normal creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootEliteConfig, m_creatureLootEliteTemplates, itemMap);         // elite creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootRareEliteConfig, m_creatureLootRareEliteTemplates, itemMap); // rare elite creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootWorldBossConfig, m_creatureLootWorldBossTemplates, itemMap); // world boss creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootRareConfig, m_creatureLootRareTemplates, itemMap);           // rare creature loot
-
-        AddLootToItemMap(&LootTemplates_Disenchant, m_disenchantLootConfig, m_disenchantLootTemplates, itemMap);             // disenchant loot
-        AddLootToItemMap(&LootTemplates_Fishing, m_fishingLootConfig, m_fishingLootTemplates, itemMap);                      // fishing loot
-        AddLootToItemMap(&LootTemplates_Gameobject, m_gameobjectLootConfig, m_gameobjectLootTemplates, itemMap);             // gameobject loot
-        AddLootToItemMap(&LootTemplates_Skinning, m_skinningLootConfig, m_skinningLootTemplates, itemMap);                   // skinning loot
-
-        // profession items are a bit different (not looted)
-        if (m_professionItemsConfig[1] > 0 && m_professionItemsConfig[3] > 0 && m_professionItems.size() > 0)
+        // Sell items, only pick the sources here, looting them is done in steps
+        m_cycle.selling = true;
+        for (auto const& source : m_lootSources)
+            AddLootRolls(source, m_cycle.lootRolls);
+    }
+    else if (m_houseAction >= MAX_AUCTION_HOUSE_TYPE && urand(0, 99) < m_chanceBuy)
+    {
+        // Buy items, auctions added later are checked by the next buy cycle
+        AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(m_cycle.houseType)->GetAuctionsBounds();
+        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
         {
-            int32 maxTemplates = m_professionItemsConfig[0] < 0 ? urand(0, m_professionItemsConfig[1] - m_professionItemsConfig[0]) + m_professionItemsConfig[0] : urand(m_professionItemsConfig[0], m_professionItemsConfig[1]);
-            if (maxTemplates > 0)
-            {
-                for (int32 templateCounter = 0; templateCounter < maxTemplates; ++templateCounter)
-                {
-                    uint32 item = m_professionItems[urand(0, m_professionItems.size() - 1)];
-                    ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(item);
-                    if (!prototype || prototype->Quality == 0 || urand(0, (1 << (prototype->Quality - 1)) - 1) > 0)
-                        continue; // make it decreasingly likely that crafted items of higher quality is added to the auction house (white: 100%, green: 50%, blue: 25%, purple: 12.5%, ...)
-                    uint32 count = (uint32) round((uint64)prototype->GetMaxStackSize() * urand(m_professionItemsConfig[2], m_professionItemsConfig[3]) / 100.0);
-                    if (count <= 0)
-                        count = 1;
-                    itemMap[item] += count;
-                }
-            }
+            AuctionEntry* auction = itr->second;
+            if (auction->owner == 0 && auction->bid == 0)
+                continue; // ignore bidding/buying auctions that were created by ahbot and not bidded on by player
+            m_cycle.auctionIds.push_back(auction->Id);
         }
+    }
+    else
+        return;
+
+    m_cycle.active = true;
+}
 
-        // remove items we've overridden (AddChance > 0) and add using given AddChance and stack size
-        for (auto& itemData : m_itemData)
+void AuctionHouseBot::RunCycle(uint32 budget)
+{
+#ifdef BUILD_METRICS
+    static metric::histogram& sliceHistogram = metric::aggregates::instance().register_histogram("ahbot.update.slice");
+    metric::timer meas(sliceHistogram);
+#endif
+
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point const deadline = start + std::chrono::milliseconds(budget);
+
+    // all auctions put up in one slice are saved in one transaction
+    bool saving = false;
+    bool done = false;
+    do
+    {
+        if (m_cycle.selling && m_cycle.rolled && !saving)
         {
-            if (itemData.second.AddChance > 0) // replace normal loot sources with custom chance of adding item
-                itemMap[itemData.first] = urand(0, 99) < itemData.second.AddChance ? urand(itemData.second.MinAmount, itemData.second.MaxAmount) : 0;
+            CharacterDatabase.BeginTransaction();
+            saving = true;
         }
 
-        for (auto& itemEntry : itemMap)
+        if (!RunCycleStep())
         {
-            ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(itemEntry.first);
-            if (!prototype || prototype->GetMaxStackSize() == 0)
-                continue; // really shouldn't happen, but better safe than sorry
-            auto iterator = m_itemData.find(prototype->ItemId);
-            if (iterator != m_itemData.end() && iterator->second.Value == 0)
-                continue; // item is blacklisted
-            if (iterator == m_itemData.end() || iterator->second.AddChance == 0)
-            {
-                if (prototype->Bonding == BIND_WHEN_PICKED_UP || prototype->Bonding == BIND_QUEST_ITEM)
-                    continue; // no BoP and quest items
-                if (prototype->Flags & ITEM_FLAG_HAS_LOOT)
-                    continue; // nor items containing loot
-                if (m_itemValue[prototype->Quality][prototype->Class] == 0)
-                    continue; // item class is filtered out
-            }
+            done = true;
+            break;
+        }
+    }
+    while (!budget || std::chrono::steady_clock::now() < deadline);
 
-            uint32 itemValue = ValueWithVariance(iterator != m_itemData.end() ? iterator->second.Value : CalculateBuyoutPrice(prototype));
-            for (uint32 stackCounter = 0; stackCounter < itemEntry.second; stackCounter += prototype->GetMaxStackSize())
-            {
-                uint32 count = itemEntry.second - stackCounter > prototype->GetMaxStackSize() ? prototype->GetMaxStackSize() : itemEntry.second - stackCounter;
-                uint32 buyoutPrice = itemValue * count;
-                Item* item = Item::CreateItem(itemEntry.first, count);
-                if (buyoutPrice == 0 || !item)
-                    continue; // don't put up items we don't know the value of
-                uint32 bidPrice = buyoutPrice * (urand(m_auctionBidMin, m_auctionBidMax)) / 100;
-                if (item)
-                    auctionHouse->AddAuction(sAuctionHouseStore.LookupEntry(houseType == AUCTION_HOUSE_ALLIANCE ? 1 : (houseType == AUCTION_HOUSE_HORDE ? 6 : 7)), item, urand(m_auctionTimeMin, m_auctionTimeMax) * HOUR, bidPrice, buyoutPrice);
-            }
+    if (saving)
+        CharacterDatabase.CommitTransaction();
+
+    ++m_cycle.slices;
+    m_cycle.duration += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    if (done)
+        FinishCycle();
+}
+
+bool AuctionHouseBot::RunCycleStep()
+{
+    AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(m_cycle.houseType);
+    if (!m_cycle.selling)
+    {
+        if (m_cycle.position >= m_cycle.auctionIds.size())
+            return false;
+
+        BuyAuction(auctionHouse, m_cycle.auctionIds[m_cycle.position++]);
+        return true;
+    }
+
+    if (!m_cycle.rolled)
+    {
+        if (m_cycle.position >= m_cycle.lootRolls.size())
+        {
+            FinishSellRolls();
+            return true;
+        }
+
+        AuctionHouseBotLootRoll const& roll = m_cycle.lootRolls[m_cycle.position++];
+        // looked up again as the loot templates can be reloaded while the cycle runs
+        LootTemplate const* lootTable = roll.store->GetLootFor(roll.lootId);
+        if (!lootTable)
+            return true;
+
+        std::unique_ptr<Loot> loot = std::unique_ptr<Loot>(new Loot(LOOT_DEBUG));
+        for (uint32 repeat = roll.repeat; repeat > 0; --repeat)
+            lootTable->Process(*loot, nullptr, *roll.store, roll.store->IsRatesAllowed());
+
+        LootItem* lootItem;
+        for (uint32 slot = 0; (lootItem = loot->GetLootItemInSlot(slot)); ++slot)
+            m_cycle.itemMap[lootItem->itemId] += lootItem->count;
+        return true;
+    }
+
+    if (m_cycle.position >= m_cycle.stacks.size())
+        return false;
+
+    AuctionHouseBotStack const& stack = m_cycle.stacks[m_cycle.position++];
+    uint32 buyoutPrice = stack.itemValue * stack.count;
+    if (buyoutPrice == 0)
+        return true; // don't put up items we don't know the value of
+    Item* item = Item::CreateItem(stack.itemId, stack.count);
+    if (!item)
+        return true;
+    uint32 bidPrice = buyoutPrice * (urand(m_auctionBidMin, m_auctionBidMax)) / 100;
+    auctionHouse->AddAuction(sAuctionHouseStore.LookupEntry(m_cycle.houseType == AUCTION_HOUSE_ALLIANCE ? 1 : (m_cycle.houseType == AUCTION_HOUSE_HORDE ? 6 : 7)), item, urand(m_auctionTimeMin, m_auctionTimeMax) * HOUR, bidPrice, buyoutPrice, 0, nullptr, false);
+    ++m_cycle.auctions;
+    return true;
+}
+
+void AuctionHouseBot::FinishSellRolls()
+{
+    std::unordered_map<uint32, uint32>& itemMap = m_cycle.itemMap;
+
+    // profession items are a bit different (not looted)
+    if (m_professionItemsConfig[1] > 0 && m_professionItemsConfig[3] > 0 && m_professionItems.size() > 0)
+    {
+        int32 maxTemplates = m_professionItemsConfig[0] < 0 ? urand(0, m_professionItemsConfig[1] - m_professionItemsConfig[0]) + m_professionItemsConfig[0] : urand(m_professionItemsConfig[0], m_professionItemsConfig[1]);
+        for (int32 templateCounter = 0; templateCounter < maxTemplates; ++templateCounter)
+        {
+            // m_professionItems only has existing items of quality white or better
+            ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(m_professionItems[urand(0, m_professionItems.size() - 1)]);
+            if (!prototype || urand(0, (1 << (prototype->Quality - 1)) - 1) > 0)
+                continue; // make it decreasingly likely that crafted items of higher quality is added to the auction house (white: 100%, green: 50%, blue: 25%, purple: 12.5%, ...)
+            uint32 count = (uint32) round((uint64)prototype->GetMaxStackSize() * urand(m_professionItemsConfig[2], m_professionItemsConfig[3]) / 100.0);
+            if (count <= 0)
+                count = 1;
+            itemMap[prototype->ItemId] += count;
         }
-    } else if (m_houseAction >= MAX_AUCTION_HOUSE_TYPE && urand(0, 99) < m_chanceBuy)
+    }
+
+    // remove items we've overridden (AddChance > 0) and add using given AddChance and stack size
+    for (auto& itemData : m_itemData)
     {
-        // Buy items
-        AuctionHouseObject::AuctionEntryMapBounds bounds = auctionHouse->GetAuctionsBounds();
-        std::vector<AuctionEntry*> buyoutAuctions;
-        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+        if (itemData.second.AddChance > 0) // replace normal loot sources with custom chance of adding item
+            itemMap[itemData.first] = urand(0, 99) < itemData.second.AddChance ? urand(itemData.second.MinAmount, itemData.second.MaxAmount) : 0;
+    }
+
+    for (auto& itemEntry : itemMap)
+    {
+        ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(itemEntry.first);
+        if (!prototype || prototype->GetMaxStackSize() == 0)
+            continue; // really shouldn't happen, but better safe than sorry
+        uint32 sellValue = GetSellValue(prototype);
+        if (!sellValue)
+            continue;
+
+        uint32 itemValue = ValueWithVariance(sellValue);
+        for (uint32 stackCounter = 0; stackCounter < itemEntry.second; stackCounter += prototype->GetMaxStackSize())
         {
-            AuctionEntry* auction = itr->second;
-            if (auction->owner == 0 && auction->bid == 0)
-                continue; // ignore bidding/buying auctions that were created by ahbot and not bidded on by player
-            Item* item = sAuctionMgr.GetAItem(auction->itemGuidLow);
-            if (!item)
-                continue; // shouldn't happen, but apparently it does(?)
-            auto prototype = item->GetProto();
-            if (!prototype)
-                continue; // shouldn't happen
-            auto iterator = m_itemData.find(prototype->ItemId);
-            if (iterator != m_itemData.end() && iterator->second.Value == 0)
-                continue; // item is blacklisted
-
-            uint32 buyItemCheck = ValueWithVariance(iterator != m_itemData.end() ? iterator->second.Value : CalculateBuyoutPrice(prototype));
-            buyItemCheck *= item->GetCount();
-            uint32 bidPrice = auction->bid + auction->GetAuctionOutBid();
-            if (auction->startbid > bidPrice)
-                bidPrice = auction->startbid;
-            if (auction->buyout > 0 && buyItemCheck > auction->buyout)
-                buyoutAuctions.push_back(auction); // can't buyout item here as that modifies the AuctionEntryMap, invalidating the iterator
-            else if (buyItemCheck > bidPrice)
-                auction->UpdateBid(bidPrice);
+            uint32 count = itemEntry.second - stackCounter > prototype->GetMaxStackSize() ? prototype->GetMaxStackSize() : itemEntry.second - stackCounter;
+            m_cycle.stacks.push_back({ itemEntry.first, count, itemValue });
         }
-        for (auto auction : buyoutAuctions)
-            auction->UpdateBid(auction->buyout);
     }
+
+    m_cycle.itemMap.clear();
+    m_cycle.lootRolls.clear();
+    m_cycle.position = 0;
+    m_cycle.rolled = true;
+}
+
+void AuctionHouseBot::BuyAuction(AuctionHouseObject* auctionHouse, uint32 auctionId)
+{
+    AuctionEntry* auction = auctionHouse->GetAuction(auctionId);
+    if (!auction || auction->moneyDeliveryTime)
+        return; // gone or won since the cycle started
+    if (auction->owner == 0 && auction->bid == 0)
+        return;
+    Item* item = sAuctionMgr.GetAItem(auction->itemGuidLow);
+    if (!item)
+        return; // shouldn't happen, but apparently it does(?)
+    auto prototype = item->GetProto();
+    if (!prototype)
+        return; // shouldn't happen
+    auto iterator = m_itemData.find(prototype->ItemId);
+    if (iterator != m_itemData.end() && iterator->second.Value == 0)
+        return; // item is blacklisted
+
+    uint32 buyItemCheck = ValueWithVariance(iterator != m_itemData.end() ? iterator->second.Value : CalculateBuyoutPrice(prototype));
+    buyItemCheck *= item->GetCount();
+    uint32 bidPrice = auction->bid + auction->GetAuctionOutBid();
+    if (auction->startbid > bidPrice)
+        bidPrice = auction->startbid;
+    if (auction->buyout > 0 && buyItemCheck > auction->buyout)
+        auction->UpdateBid(auction->buyout);
+    else if (buyItemCheck > bidPrice)
+        auction->UpdateBid(bidPrice);
+    else
+        return;
+    ++m_cycle.auctions;
+}
+
+void AuctionHouseBot::FinishCycle()
+{
+    DEBUG_LOG("AHBot: %s cycle for auction house %u took %u us in %u slices, %u auctions", m_cycle.selling ? "sell" : "buy", uint32(m_cycle.houseType), uint32(m_cycle.duration), m_cycle.slices, m_cycle.auctions);
+
+#ifdef BUILD_METRICS
+    metric::measurement meas("ahbot.cycle", { { "house", std::to_string(uint32(m_cycle.houseType)) }, { "action", m_cycle.selling ? "sell" : "buy" } });
+    meas.add_field("duration", std::to_string(m_cycle.duration));
+    meas.add_field("slices", std::to_string(m_cycle.slices));
+    meas.add_field("auctions", std::to_string(m_cycle.auctions));
+#endif
+
+    m_cycle = AuctionHouseBotCycle();
 }
 
 bool AuctionHouseBot::ReloadAllConfig()
@@ -279,7 +435,8 @@ void AuctionHouseBot::Rebuild(bool all)
     sLog.outString("AHBot: Rebuilding auction house items");
     for (uint32 i = 0; i < MAX_AUCTION_HOUSE_TYPE; ++i)
     {
-        AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i))->GetAuctionsBounds();
+        AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i));
+        AuctionHouseObject::AuctionEntryMapBounds bounds = auctionHouse->GetAuctionsBounds();
         for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
         {
             AuctionEntry* entry = itr->second;
@@ -287,17 +444,23 @@ void AuctionHouseBot::Rebuild(bool all)
             {
                 // ahbot auction
                 if (all || entry->bid == 0) // expire auction if no bid or forced
-                    entry->expireTime = sWorld.GetGameTime();
+                    auctionHouse->SetAuctionExpireTime(entry, sWorld.GetGameTime());
             }
         }
     }
+    // finish a running cycle, the refill below runs whole cycles regardless of the update budget
+    if (m_cycle.active)
+        RunCycle(0);
+
     // refill auction house with items, simulating typical max amount of items available after some time
     uint32 updateCounter = ((m_auctionTimeMax - m_auctionTimeMin) / 2 + m_auctionTimeMin) * 90;
     for (uint32 i = 0; i < updateCounter; ++i)
     {
         if (m_houseAction >= MAX_AUCTION_HOUSE_TYPE - 1)
             m_houseAction = -1; // this prevents AHBot from buying items when refilling
-        Update();
+        StartCycle();
+        if (m_cycle.active)
+            RunCycle(0);
     }
 }
 
@@ -336,6 +499,8 @@ void AuctionHouseBot::SetItemData(uint32 item, AuctionHouseBotItemData& itemData
     SqlStatement stmt = CharacterDatabase.CreateStatement(delItem, "DELETE FROM ahbot_items WHERE item = ?");
     stmt.PExecute(item);
 
+    m_sellValues.erase(item);
+
     if (reset)
     {
         m_itemData.erase(item);
@@ -460,27 +625,40 @@ void AuctionHouseBot::ParseItemValueConfig(char const* fieldname, std::vector<ui
     }
 }
 
-void AuctionHouseBot::AddLootToItemMap(LootStore* store, std::vector<int32>& lootConfig, std::vector<uint32>& lootTemplates, std::unordered_map<uint32, uint32>& itemMap)
+void AuctionHouseBot::AddLootRolls(AuctionHouseBotLootSource const& source, std::vector<AuctionHouseBotLootRoll>& lootRolls)
 {
+    std::vector<int32> const& lootConfig = *source.config;
+    std::vector<uint32> const& lootTemplates = *source.templates;
     if (lootConfig[1] <= 0 || lootConfig[3] <= 0 || lootTemplates.size() <= 0)
         return;
     int32 maxTemplates = lootConfig[0] < 0 ? urand(0, lootConfig[1] - lootConfig[0]) + lootConfig[0] : urand(lootConfig[0], lootConfig[1]);
-    if (maxTemplates <= 0)
-        return;
     for (int32 templateCounter = 0; templateCounter < maxTemplates; ++templateCounter)
-    {
-        uint32 lootTemplate = urand(0, lootTemplates.size() - 1);
-        LootTemplate const* lootTable = store->GetLootFor(lootTemplates[lootTemplate]);
-        if (!lootTable)
-            continue;
-        std::unique_ptr<Loot> loot = std::unique_ptr<Loot>(new Loot(LOOT_DEBUG));
-        for (uint32 repeat = urand(lootConfig[2], lootConfig[3]); repeat > 0; --repeat)
-            lootTable->Process(*loot, nullptr, *store, store->IsRatesAllowed());
+        lootRolls.push_back({ source.store, lootTemplates[urand(0, lootTemplates.size() - 1)], urand(lootConfig[2], lootConfig[3]) });
+}
 
-        LootItem* lootItem;
-        for (uint32 slot = 0; (lootItem = loot->GetLootItemInSlot(slot)); ++slot)
-            itemMap[lootItem->itemId] += lootItem->count;
-    }
+uint32 AuctionHouseBot::GetSellValue(ItemPrototype const* prototype)
+{
+    auto cached = m_sellValues.find(prototype->ItemId);
+    if (cached != m_sellValues.end())
+        return cached->second;
+
+    uint32 sellValue = 0;
+    auto iterator = m_itemData.find(prototype->ItemId);
+    if (iterator != m_itemData.end() && iterator->second.AddChance > 0)
+        sellValue = iterator->second.Value;
+    else if (iterator != m_itemData.end() && iterator->second.Value == 0)
+        sellValue = 0; // item is blacklisted
+    else if (prototype->Bonding == BIND_WHEN_PICKED_UP || prototype->Bonding == BIND_QUEST_ITEM)
+        sellValue = 0; // no BoP and quest items
+    else if (prototype->Flags & ITEM_FLAG_HAS_LOOT)
+        sellValue = 0; // nor items containing loot
+    else if (m_itemValue[prototype->Quality][prototype->Class] == 0)
+        sellValue = 0; // item class is filtered out
+    else
+        sellValue = iterator != m_itemData.end() ? iterator->second.Value : CalculateBuyoutPrice(prototype);
+
+    m_sellValues[prototype->ItemId] = sellValue;
+    return sellValue;
 }
 
 uint32 AuctionHouseBot::CalculateBuyoutPrice(ItemPrototype const* prototype)
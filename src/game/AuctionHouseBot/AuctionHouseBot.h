@@ -42,6 +42,48 @@ struct AuctionHouseBotStatusInfoPerType
 
 typedef AuctionHouseBotStatusInfoPerType AuctionHouseBotStatusInfo[MAX_AUCTION_HOUSE_TYPE];
 
+// loot templates of one configured source, e.g. elite creatures or fishing
+struct AuctionHouseBotLootSource
+{
+    LootStore* store;
+    std::vector<int32>* config;
+    std::vector<uint32>* templates;
+};
+
+struct AuctionHouseBotLootRoll
+{
+    LootStore* store;
+    uint32 lootId;
+    uint32 repeat;
+};
+
+struct AuctionHouseBotStack
+{
+    uint32 itemId;
+    uint32 count;
+    uint32 itemValue;
+};
+
+// One sell or buy visit of an auction house, split into steps so it can be spread over several world updates.
+// Selling first rolls the loot sources, then puts up the stacks; buying checks the auctions listed at its start.
+struct AuctionHouseBotCycle
+{
+    bool active = false;
+    bool selling = false;
+    bool rolled = false;                                    // all loot rolled, stacks are put up now
+    AuctionHouseType houseType = AUCTION_HOUSE_ALLIANCE;
+
+    std::vector<AuctionHouseBotLootRoll> lootRolls;
+    std::unordered_map<uint32, uint32> itemMap;
+    std::vector<AuctionHouseBotStack> stacks;
+    std::vector<uint32> auctionIds;
+    size_t position = 0;                                    // next step in lootRolls, stacks or auctionIds
+
+    uint32 slices = 0;
+    uint32 auctions = 0;                                    // auctions added or bid on
+    uint64 duration = 0;                                    // microseconds spent in all slices
+};
+
 class AuctionHouseBot
 {
     public:
@@ -50,7 +92,10 @@ class AuctionHouseBot
 
         void Initialize();
         void SetConfigFileName(const std::string& filename) { m_configFileName = filename; }
+        // starts a new cycle if the previous one is done and runs it within AuctionHouseBot.Update.Budget
         void Update();
+        // continues a cycle that did not fit the budget of the previous world update
+        void ContinueCycle();
 
         // Following methods are mainly used by level3.cpp for ingame/console commands
         bool ReloadAllConfig();
@@ -64,7 +109,14 @@ class AuctionHouseBot
         void ParseLootConfig(char const* fieldname, std::vector<int32>& lootConfig);
         void FillUintVectorFromQuery(char const* query, std::vector<uint32>& lootTemplates);
         void ParseItemValueConfig(char const* fieldname, std::vector<uint32>& itemValues);
-        void AddLootToItemMap(LootStore* store, std::vector<int32>& lootConfig, std::vector<uint32>& lootTemplates, std::unordered_map<uint32, uint32>& itemMap);
+        void AddLootRolls(AuctionHouseBotLootSource const& source, std::vector<AuctionHouseBotLootRoll>& lootRolls);
+        void StartCycle();
+        void RunCycle(uint32 budget);
+        bool RunCycleStep();
+        void FinishSellRolls();
+        void BuyAuction(AuctionHouseObject* auctionHouse, uint32 auctionId);
+        void FinishCycle();
+        uint32 GetSellValue(ItemPrototype const* prototype);
         uint32 CalculateBuyoutPrice(ItemPrototype const* prototype);
         uint32 ValueWithVariance(uint32 itemValue) { return (uint32) (itemValue + ((int32) urand(0, m_valueVariance * 2 + 1) - (int32) m_valueVariance) * (int32) (itemValue / 100)); };
 
@@ -72,6 +124,8 @@ class AuctionHouseBot
         Config m_ahBotCfg;
 
         uint32 m_houseAction;
+        uint32 m_updateBudget;                              // ms per world update, 0 runs each cycle at once
+        AuctionHouseBotCycle m_cycle;
 
         uint32 m_chanceSell;
         uint32 m_chanceBuy;
@@ -107,6 +161,9 @@ class AuctionHouseBot
         std::vector<uint32> m_skinningLootTemplates;
         std::vector<uint32> m_professionItems;
 
+        std::vector<AuctionHouseBotLootSource> m_lootSources;
+        std::unordered_map<uint32, uint32> m_sellValues;    // item value before variance, 0 if the bot does not sell the item
+
         std::unordered_set<uint32> m_vendorItems;
 
         std::unordered_map<uint32, AuctionHouseBotItemData> m_itemData;
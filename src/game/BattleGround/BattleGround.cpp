@@ -236,6 +236,7 @@ BattleGround::BattleGround(): m_buffChange(false), m_startDelayTime(0), m_arenaB
     m_levelMin          = 0;
     m_levelMax          = 0;
     m_hasBgFreeSlotQueue = false;
+    m_isPrecreated      = false;
 
     m_maxPlayersPerTeam = 0;
     m_maxPlayers        = 0;
@@ -316,6 +317,10 @@ BattleGround::~BattleGround()
 */
 void BattleGround::Update(uint32 diff)
 {
+    // kept empty and alive until a match takes it
+    if (m_isPrecreated)
+        return;
+
     if (!GetPlayersSize())
     {
         // BG is empty
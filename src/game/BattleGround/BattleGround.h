@@ -390,6 +390,7 @@ class BattleGround
         void SetMinPlayers(uint32 minPlayers) { m_minPlayers = minPlayers; }
         void SetLevelRange(uint32 min, uint32 max) { m_levelMin = min; m_levelMax = max; }
         void SetRated(bool state)           { m_isRated = state; }
+        void SetPrecreated(bool state)      { m_isPrecreated = state; }
         void SetArenaType(ArenaType type)   { m_arenaType = type; }
         void SetArenaorBGType(bool isArena) { m_isArena = isArena; }
         void SetWinner(BattleGroundWinner winner) { m_winner = winner; }
@@ -420,6 +421,7 @@ class BattleGround
         bool IsArena() const        { return m_isArena; }
         bool IsBattleGround() const { return !m_isArena; }
         bool IsRated() const        { return m_isRated; }
+        bool IsPrecreated() const   { return m_isPrecreated; }
 
         // Functions that handle battleground players
         typedef std::map<ObjectGuid, BattleGroundPlayer> BattleGroundPlayerMap;
@@ -721,6 +723,7 @@ class BattleGround
         bool m_arenaBuffSpawned;                            // to cache if arenabuff event is started (cause bool is faster than checking IsActiveEvent)
         bool m_hasBgFreeSlotQueue;                          // used to make sure that BG is only once inserted into the BattleGroundMgr.BGFreeSlotQueue[bgTypeId] deque
         bool m_isRated;                                     // is this battle rated?
+        bool m_isPrecreated;                                // idle instance waiting in the BattleGroundMgr pool, not used by a match yet
         bool m_prematureCountDown;
         bool m_isArena;
 
@@ -240,6 +240,8 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* group, Battle
 
         // add GroupInfo to m_QueuedGroups
         m_queuedGroups[bracketId][index].push_back(queueInfo);
+        if (isRated)
+            m_arenaRatingIndex[bracketId].emplace(arenaRating, queueInfo);
 
         // announce to world, this code needs mutex
         if (arenaType == ARENA_TYPE_NONE && !isRated && !isPremade && sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN))
@@ -445,6 +447,8 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     if (group->players.empty())
     {
         m_queuedGroups[bracketId][index].erase(group_itr);
+        if (group->isRated)
+            RemoveFromArenaRatingIndex(BattleGroundBracketId(bracketId), group);
         delete group;
     }
     // if group wasn't empty, so it wasn't deleted, and player have left a rated
@@ -1022,144 +1026,163 @@ void BattleGroundQueue::Update(BattleGroundTypeId bgTypeId, BattleGroundBracketI
     }
     else if (bgTemplate->IsArena())
     {
-        // found out the minimum and maximum ratings the newly added team should battle against
-        // arenaRating is the rating of the latest joined team, or 0
-        // 0 is on (automatic update call) and we must set it to team's with longest wait time
-        if (!arenaRating)
+        // the team that just joined, else the one waiting longest, looks for the closest rated opponent it accepts
+        uint32 now = WorldTimer::getMSTime();
+        GroupQueueInfo* team = nullptr;
+        if (arenaRating)
         {
-            GroupQueueInfo* front1 = nullptr;
-            GroupQueueInfo* front2 = nullptr;
-            if (!m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].empty())
-            {
-                front1 = m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].front();
-                arenaRating = front1->arenaTeamRating;
-            }
+            ArenaRatingIndex::const_iterator itr = m_arenaRatingIndex[bracketId].find(arenaRating);
+            if (itr != m_arenaRatingIndex[bracketId].end())
+                team = itr->second;
+        }
 
-            if (!m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].empty())
-            {
-                front2 = m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].front();
-                arenaRating = front2->arenaTeamRating;
-            }
+        if (!team)
+            team = GetOldestArenaTeam(bracketId);
 
-            if (front1 && front2)
-            {
-                if (front1->joinTime < front2->joinTime)
-                    arenaRating = front1->arenaTeamRating;
-            }
-            else if (!front1 && !front2)
-                return; // queues are empty
-        }
+        if (!team)
+            return; // queues are empty
 
-        // set rating range
-        uint32 arenaMinRating = (arenaRating <= sBattleGroundMgr.GetMaxRatingDifference()) ? 0 : arenaRating - sBattleGroundMgr.GetMaxRatingDifference();
-        uint32 arenaMaxRating = arenaRating + sBattleGroundMgr.GetMaxRatingDifference();
-        // if max rating difference is set and the time past since server startup is greater than the rating discard time
-        // (after what time the ratings aren't taken into account when making teams) then
-        // the discard time is current_time - time_to_discard, teams that joined after that, will have their ratings taken into account
-        // else leave the discard time on 0, this way all ratings will be discarded
-        uint32 discardTime = WorldTimer::getMSTime() - sBattleGroundMgr.GetRatingDiscardTimer();
+        GroupQueueInfo* opponent = FindArenaOpponent(bracketId, team, now);
+        if (!opponent)
+            return;
 
-        // we need to find 2 teams which will play next game
+        BattleGround* arena = sBattleGroundMgr.CreateNewBattleGround(bgTypeId, bracketEntry, arenaType, true);
+        if (!arena)
+        {
+            sLog.outError("BattlegroundQueue::Update couldn't create arena instance for rated arena match!");
+            return;
+        }
 
-        GroupsQueueType::iterator itr_team[PVP_TEAM_COUNT];
+        team->opponentsTeamRating = opponent->arenaTeamRating;
+        DEBUG_LOG("setting oposite teamrating for team %u to %u", team->arenaTeamId, team->opponentsTeamRating);
+        opponent->opponentsTeamRating = team->arenaTeamRating;
+        DEBUG_LOG("setting oposite teamrating for team %u to %u", opponent->arenaTeamId, opponent->opponentsTeamRating);
 
-        // optimalization : --- we dont need to use selection_pools - each update we select max 2 groups
+        RemoveFromArenaRatingIndex(bracketId, team);
+        RemoveFromArenaRatingIndex(bracketId, opponent);
 
-        for (uint8 i = BG_QUEUE_PREMADE_ALLIANCE; i < BG_QUEUE_NORMAL_ALLIANCE; ++i)
+        // teams of the same faction play on both sides. The opponent is moved to the queue of its new side,
+        // Queue::RemovePlayer looks for it there
+        if (team->groupTeam == opponent->groupTeam)
         {
-            // take the group that joined first
-            itr_team[i] = m_queuedGroups[bracketId][i].begin();
-            for (; itr_team[i] != m_queuedGroups[bracketId][i].end(); ++(itr_team[i]))
-            {
-                // if group match conditions, then add it to pool
-                if (!(*itr_team[i])->isInvitedToBgInstanceGuid
-                        && (((*itr_team[i])->arenaTeamRating >= arenaMinRating && (*itr_team[i])->arenaTeamRating <= arenaMaxRating)
-                            || (*itr_team[i])->joinTime < discardTime))
-                {
-                    m_selectionPools[i].AddGroup((*itr_team[i]), maxPlayersPerTeam, 0);
-                    // break for cycle to be able to start selecting another group from same faction queue
-                    break;
-                }
-            }
+            Team side = team->groupTeam == ALLIANCE ? HORDE : ALLIANCE;
+            GroupsQueueType& from = m_queuedGroups[bracketId][GetTeamIndexByTeamId(opponent->groupTeam)];
+            from.erase(std::find(from.begin(), from.end(), opponent));
+            m_queuedGroups[bracketId][GetTeamIndexByTeamId(side)].push_front(opponent);
+            opponent->groupTeam = side;
         }
-        // now we are done if we have 2 groups - ali vs horde!
-        // if we don't have, we must try to continue search in same queue
-        // tmp variables are correctly set
-        // this code isn't much userfriendly - but it is supposed to continue search for mathing group in HORDE queue
-        if (m_selectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount() == 0 && m_selectionPools[TEAM_INDEX_HORDE].GetPlayerCount())
-        {
-            itr_team[TEAM_INDEX_ALLIANCE] = itr_team[TEAM_INDEX_HORDE];
-            ++itr_team[TEAM_INDEX_ALLIANCE];
 
-            for (; itr_team[TEAM_INDEX_ALLIANCE] != m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].end(); ++(itr_team[TEAM_INDEX_ALLIANCE]))
-            {
-                if (!(*itr_team[TEAM_INDEX_ALLIANCE])->isInvitedToBgInstanceGuid
-                        && (((*itr_team[TEAM_INDEX_ALLIANCE])->arenaTeamRating >= arenaMinRating && (*itr_team[TEAM_INDEX_ALLIANCE])->arenaTeamRating <= arenaMaxRating)
-                            || (*itr_team[TEAM_INDEX_ALLIANCE])->joinTime < discardTime))
-                {
-                    m_selectionPools[TEAM_INDEX_ALLIANCE].AddGroup((*itr_team[TEAM_INDEX_ALLIANCE]), maxPlayersPerTeam, 0);
-                    break;
-                }
-            }
+        InviteGroupToBg(team, arena, team->groupTeam);
+        InviteGroupToBg(opponent, arena, opponent->groupTeam);
+
+        DEBUG_LOG("Starting rated arena match!");
+
+        arena->StartBattleGround();
+    }
+}
+
+/**
+  Method that drops a rated arena team from the rating index, once invited or out of the queue
+
+  @param    bracket id
+  @param    group queue info
+*/
+void BattleGroundQueue::RemoveFromArenaRatingIndex(BattleGroundBracketId bracketId, GroupQueueInfo* queueInfo)
+{
+    auto bounds = m_arenaRatingIndex[bracketId].equal_range(queueInfo->arenaTeamRating);
+    for (ArenaRatingIndex::iterator itr = bounds.first; itr != bounds.second; ++itr)
+    {
+        if (itr->second == queueInfo)
+        {
+            m_arenaRatingIndex[bracketId].erase(itr);
+            return;
         }
-        // this code isn't much userfriendly - but it is supposed to continue search for mathing group in ALLIANCE queue
-        if (m_selectionPools[TEAM_INDEX_HORDE].GetPlayerCount() == 0 && m_selectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount())
+    }
+}
+
+/**
+  Function that returns the rated arena team waiting longest and not invited yet, of either faction
+
+  @param    bracket id
+*/
+GroupQueueInfo* BattleGroundQueue::GetOldestArenaTeam(BattleGroundBracketId bracketId) const
+{
+    GroupQueueInfo* oldest = nullptr;
+    for (uint8 i = BG_QUEUE_PREMADE_ALLIANCE; i < BG_QUEUE_NORMAL_ALLIANCE; ++i)
+    {
+        // queues are in join order, only teams of running matches are in front
+        for (GroupQueueInfo* queueInfo : m_queuedGroups[bracketId][i])
         {
-            itr_team[TEAM_INDEX_HORDE] = itr_team[TEAM_INDEX_ALLIANCE];
-            ++itr_team[TEAM_INDEX_HORDE];
+            if (queueInfo->isInvitedToBgInstanceGuid)
+                continue;
 
-            for (; itr_team[TEAM_INDEX_HORDE] != m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].end(); ++(itr_team[TEAM_INDEX_HORDE]))
-            {
-                if (!(*itr_team[TEAM_INDEX_HORDE])->isInvitedToBgInstanceGuid
-                        && (((*itr_team[TEAM_INDEX_HORDE])->arenaTeamRating >= arenaMinRating && (*itr_team[TEAM_INDEX_HORDE])->arenaTeamRating <= arenaMaxRating)
-                            || (*itr_team[TEAM_INDEX_HORDE])->joinTime < discardTime))
-                {
-                    m_selectionPools[TEAM_INDEX_HORDE].AddGroup((*itr_team[TEAM_INDEX_HORDE]), maxPlayersPerTeam, 0);
-                    break;
-                }
-            }
+            if (!oldest || queueInfo->joinTime < oldest->joinTime)
+                oldest = queueInfo;
+            break;
         }
+    }
+    return oldest;
+}
 
-        // if we have 2 teams, then start new arena and invite players!
-        if (m_selectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount() && m_selectionPools[TEAM_INDEX_HORDE].GetPlayerCount())
-        {
-            BattleGround* arena = sBattleGroundMgr.CreateNewBattleGround(bgTypeId, bracketEntry, arenaType, true);
-            if (!arena)
-            {
-                sLog.outError("BattlegroundQueue::Update couldn't create arena instance for rated arena match!");
-                return;
-            }
+/**
+  Function that returns the rating distance a team accepts. It widens with the time in queue
+  up to twice the max rating difference, after the rating discard time any opponent is accepted.
 
-            (*(itr_team[TEAM_INDEX_ALLIANCE]))->opponentsTeamRating = (*(itr_team[TEAM_INDEX_HORDE]))->arenaTeamRating;
-            DEBUG_LOG("setting oposite teamrating for team %u to %u", (*(itr_team[TEAM_INDEX_ALLIANCE]))->arenaTeamId, (*(itr_team[TEAM_INDEX_ALLIANCE]))->opponentsTeamRating);
-            (*(itr_team[TEAM_INDEX_HORDE]))->opponentsTeamRating = (*(itr_team[TEAM_INDEX_ALLIANCE]))->arenaTeamRating;
-            DEBUG_LOG("setting oposite teamrating for team %u to %u", (*(itr_team[TEAM_INDEX_HORDE]))->arenaTeamId, (*(itr_team[TEAM_INDEX_HORDE]))->opponentsTeamRating);
+  @param    group queue info
+  @param    current time
+*/
+uint32 BattleGroundQueue::GetArenaRatingWindow(GroupQueueInfo const* queueInfo, uint32 now)
+{
+    uint32 maxDifference = sBattleGroundMgr.GetMaxRatingDifference();
+    uint32 discardTimer = sBattleGroundMgr.GetRatingDiscardTimer();
+    uint32 waited = WorldTimer::getMSTimeDiff(queueInfo->joinTime, now);
+    if (waited >= discardTimer)
+        return std::numeric_limits<uint32>::max();
 
-            // now we must move team if we changed its faction to another faction queue, because then we will spam log by errors in Queue::RemovePlayer
-            if ((*(itr_team[TEAM_INDEX_ALLIANCE]))->groupTeam != ALLIANCE)
-            {
-                // add to alliance queue
-                m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].push_front(*(itr_team[TEAM_INDEX_ALLIANCE]));
-                // erase from horde queue
-                m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].erase(itr_team[TEAM_INDEX_ALLIANCE]);
-                itr_team[TEAM_INDEX_ALLIANCE] = m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].begin();
-            }
+    return maxDifference + uint32(uint64(maxDifference) * waited / discardTimer);
+}
 
-            if ((*(itr_team[TEAM_INDEX_HORDE]))->groupTeam != HORDE)
-            {
-                m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].push_front(*(itr_team[TEAM_INDEX_HORDE]));
-                m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].erase(itr_team[TEAM_INDEX_HORDE]);
-                itr_team[TEAM_INDEX_HORDE] = m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].begin();
-            }
+/**
+  Function that finds the closest rated opponent within the rating window of a team,
+  walking the rating index outwards from the team's own rating
 
-            InviteGroupToBg(*(itr_team[TEAM_INDEX_ALLIANCE]), arena, ALLIANCE);
-            InviteGroupToBg(*(itr_team[TEAM_INDEX_HORDE]), arena, HORDE);
+  @param    bracket id
+  @param    group queue info
+  @param    current time
+*/
+GroupQueueInfo* BattleGroundQueue::FindArenaOpponent(BattleGroundBracketId bracketId, GroupQueueInfo const* queueInfo, uint32 now) const
+{
+    ArenaRatingIndex const& index = m_arenaRatingIndex[bracketId];
+    uint32 rating = queueInfo->arenaTeamRating;
+    uint32 window = GetArenaRatingWindow(queueInfo, now);
+    uint32 minRating = rating > window ? rating - window : 0;
+    uint32 maxRating = window > std::numeric_limits<uint32>::max() - rating ? std::numeric_limits<uint32>::max() : rating + window;
+
+    ArenaRatingIndex::const_iterator up = index.lower_bound(rating);
+    ArenaRatingIndex::const_reverse_iterator down(up);
+    while (true)
+    {
+        bool canUp = up != index.end() && up->first <= maxRating;
+        bool canDown = down != index.rend() && down->first >= minRating;
+        if (!canUp && !canDown)
+            break;
 
-            DEBUG_LOG("Starting rated arena match!");
+        GroupQueueInfo* candidate;
+        if (canUp && (!canDown || up->first - rating <= rating - down->first))
+            candidate = (up++)->second;
+        else
+            candidate = (down++)->second;
 
-            arena->StartBattleGround();
-        }
+        if (candidate != queueInfo)
+            return candidate;
     }
+
+    // a team waiting past the rating discard time takes any opponent
+    GroupQueueInfo* oldest = GetOldestArenaTeam(bracketId);
+    if (oldest && oldest != queueInfo && GetArenaRatingWindow(oldest, now) == std::numeric_limits<uint32>::max())
+        return oldest;
+
+    return nullptr;
 }
 
 /*********************************************************/
@@ -1293,6 +1316,11 @@ void BattleGroundMgr::DeleteAllBattleGrounds()
             delete bg;
         }
     }
+
+    for (auto& precreated : m_precreatedBattleGrounds)
+        for (BattleGround* bg : precreated.second.instances)
+            delete bg;
+    m_precreatedBattleGrounds.clear();
 }
 
 /**
@@ -1362,6 +1390,8 @@ void BattleGroundMgr::Update(uint32 diff)
         else
             m_autoDistributionTimeChecker -= diff;
     }
+
+    UpdatePrecreatedBattleGrounds(diff);
 }
 
 /**
@@ -1755,6 +1785,42 @@ BattleGround* BattleGroundMgr::CreateNewBattleGround(BattleGroundTypeId bgTypeId
         isRandom = true;
     }
 
+    BattleGround* bg = TakePrecreatedBattleGround(bgTypeId, bracketEntry);
+    if (!bg)
+        bg = CreateBattleGroundInstance(bgTypeId, bracketEntry);
+    if (!bg)
+        return nullptr;
+
+    bgTypeId = isRandom ? BATTLEGROUND_RB : bgTypeId;
+
+    bg->SetClientInstanceId(CreateClientVisibleInstanceId(bgTypeId, bracketEntry->GetBracketId()));
+
+    // reset the new bg (set status to status_wait_queue from status_none)
+    bg->Reset();
+
+    // start the joining of the bg
+    bg->SetStatus(STATUS_WAIT_JOIN);
+    bg->SetArenaType(arenaType);
+    bg->SetRated(isRated);
+    bg->SetRandom(isRandom);
+    bg->SetTypeId(bgTypeId);
+    bg->SetRandomTypeId(bgRandomTypeId);
+
+    return bg;
+}
+
+/**
+  Function that copies the template of a resolved battleground type and creates its map
+
+  @param    battleground type id
+  @param    bracket entry
+*/
+BattleGround* BattleGroundMgr::CreateBattleGroundInstance(BattleGroundTypeId bgTypeId, PvPDifficultyEntry const* bracketEntry)
+{
+    BattleGround* bgTemplate = GetBattleGroundTemplate(bgTypeId);
+    if (!bgTemplate)
+        return nullptr;
+
     BattleGround* bg;
     // create a copy of the BG template
     switch (bgTypeId)
@@ -1792,9 +1858,6 @@ BattleGround* BattleGroundMgr::CreateNewBattleGround(BattleGroundTypeId bgTypeId
         case BATTLEGROUND_IC:
             bg = new BattleGroundIC(*(BattleGroundIC*)bgTemplate);
             break;
-        case BATTLEGROUND_AA:
-        case BATTLEGROUND_RB:
-            break;
         default:
             // error, but it is handled few lines above
             return nullptr;
@@ -1803,27 +1866,77 @@ BattleGround* BattleGroundMgr::CreateNewBattleGround(BattleGroundTypeId bgTypeId
     // must occur before CreateBgMap - used to detect difficulty of BG
     bg->SetBracket(bracketEntry);
 
-    bgTypeId = isRandom ? BATTLEGROUND_RB : bgTypeId;
-
     // will also set m_bgMap, instanceid
     sMapMgr.CreateBgMap(bg->GetMapId(), bg);
 
-    bg->SetClientInstanceId(CreateClientVisibleInstanceId(bgTypeId, bracketEntry->GetBracketId()));
+    return bg;
+}
 
-    // reset the new bg (set status to status_wait_queue from status_none)
-    bg->Reset();
+/**
+  Function that hands out an idle instance created ahead, nullptr if there is none
 
-    // start the joining of the bg
-    bg->SetStatus(STATUS_WAIT_JOIN);
-    bg->SetArenaType(arenaType);
-    bg->SetRated(isRated);
-    bg->SetRandom(isRandom);
-    bg->SetTypeId(bgTypeId);
-    bg->SetRandomTypeId(bgRandomTypeId);
+  @param    battleground type id
+  @param    bracket entry
+*/
+BattleGround* BattleGroundMgr::TakePrecreatedBattleGround(BattleGroundTypeId bgTypeId, PvPDifficultyEntry const* bracketEntry)
+{
+    // arenas pick a random map for each match
+    if (IsArenaType(bgTypeId) || !sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_PRECREATED_INSTANCES))
+        return nullptr;
+
+    PrecreatedBattleGrounds& precreated = m_precreatedBattleGrounds[std::make_pair(bgTypeId, bracketEntry)];
+    precreated.idleTime = 0;
+    if (precreated.instances.empty())
+        return nullptr;
 
+    BattleGround* bg = precreated.instances.back();
+    precreated.instances.pop_back();
+    bg->SetPrecreated(false);
     return bg;
 }
 
+/**
+  Method that keeps the pools of idle instances filled, at most one map is created per update
+
+  @param    diff
+*/
+void BattleGroundMgr::UpdatePrecreatedBattleGrounds(uint32 diff)
+{
+    uint32 const wanted = sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_PRECREATED_INSTANCES);
+    bool created = false;
+
+    for (PrecreatedBattleGroundMap::iterator itr = m_precreatedBattleGrounds.begin(); itr != m_precreatedBattleGrounds.end();)
+    {
+        PrecreatedBattleGrounds& precreated = itr->second;
+        precreated.idleTime += diff;
+
+        // no longer popular, let the maps unload
+        uint32 keep = precreated.idleTime < BG_PRECREATED_IDLE_TIME ? wanted : 0;
+        while (precreated.instances.size() > keep)
+        {
+            delete precreated.instances.back();
+            precreated.instances.pop_back();
+        }
+
+        if (!keep)
+        {
+            itr = m_precreatedBattleGrounds.erase(itr);
+            continue;
+        }
+
+        if (!created && precreated.instances.size() < keep)
+        {
+            if (BattleGround* bg = CreateBattleGroundInstance(itr->first.first, itr->first.second))
+            {
+                bg->SetPrecreated(true);
+                precreated.instances.push_back(bg);
+            }
+            created = true;
+        }
+        ++itr;
+    }
+}
+
 /**
   Function that creates battleground templates
 
@@ -38,6 +38,7 @@ typedef std::unordered_map<uint32, BattleGroundEventIdx> GameObjectBattleEventIn
 
 #define BATTLEGROUND_ARENA_POINT_DISTRIBUTION_DAY 86400     // seconds in a day
 #define COUNT_OF_PLAYERS_TO_AVERAGE_WAIT_TIME 10
+#define BG_PRECREATED_IDLE_TIME (30 * MINUTE * IN_MILLISECONDS) // pools of types and brackets without a match for this long are dropped
 
 struct GroupQueueInfo;                                      // type predefinition
 struct PlayerQueueInfo                                      // stores information for players in queue
@@ -132,6 +133,15 @@ class BattleGroundQueue
         // one selection pool for horde, other one for alliance
         SelectionPool m_selectionPools[PVP_TEAM_COUNT];
 
+        // rated arena teams not invited yet, by team rating. Both factions share it, arenas are cross faction
+        typedef std::multimap<uint32, GroupQueueInfo*> ArenaRatingIndex;
+        ArenaRatingIndex m_arenaRatingIndex[MAX_BATTLEGROUND_BRACKETS];
+
+        void RemoveFromArenaRatingIndex(BattleGroundBracketId bracketId, GroupQueueInfo* queueInfo);
+        GroupQueueInfo* GetOldestArenaTeam(BattleGroundBracketId bracketId) const;
+        GroupQueueInfo* FindArenaOpponent(BattleGroundBracketId bracketId, GroupQueueInfo const* queueInfo, uint32 now) const;
+        static uint32 GetArenaRatingWindow(GroupQueueInfo const* queueInfo, uint32 now);
+
         bool InviteGroupToBg(GroupQueueInfo* /*groupInfo*/, BattleGround* /*bg*/, Team /*side*/);
 
         uint32 m_waitTimes[PVP_TEAM_COUNT][MAX_BATTLEGROUND_BRACKETS][COUNT_OF_PLAYERS_TO_AVERAGE_WAIT_TIME];
@@ -291,6 +301,21 @@ class BattleGroundMgr
 
         std::set<uint32> const& GetUsedRefLootIds() const { return m_usedRefloot; }
     private:
+        BattleGround* CreateBattleGroundInstance(BattleGroundTypeId bgTypeId, PvPDifficultyEntry const* bracketEntry);
+
+        // idle instances with their map already created, kept for battleground types and brackets that recently started a match
+        struct PrecreatedBattleGrounds
+        {
+            std::vector<BattleGround*> instances;
+            uint32 idleTime;                                // ms since a match of this type and bracket last started
+        };
+        typedef std::map<std::pair<BattleGroundTypeId, PvPDifficultyEntry const*>, PrecreatedBattleGrounds> PrecreatedBattleGroundMap;
+
+        BattleGround* TakePrecreatedBattleGround(BattleGroundTypeId bgTypeId, PvPDifficultyEntry const* bracketEntry);
+        void UpdatePrecreatedBattleGrounds(uint32 diff);
+
+        PrecreatedBattleGroundMap m_precreatedBattleGrounds;
+
         std::mutex schedulerLock;
         BattleMastersMap m_battleMastersMap;
         CreatureBattleEventIndexesMap m_creatureBattleEventIndexMap;
@@ -0,0 +1,377 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Benchmark/CoreBenchmarks.h"
+#include "Maps/MapManager.h"
+#include "Grids/GridNotifiers.h"
+#include "Grids/GridNotifiersImpl.h"
+#include "Grids/CellImpl.h"
+#include "Entities/Creature.h"
+#include "Entities/UpdateData.h"
+#include "Entities/UpdateMask.h"
+#include "Server/WorldPacket.h"
+#include "Server/SQLStorages.h"
+#include "Globals/ObjectMgr.h"
+#include "Loot/LootMgr.h"
+#include "Spells/SpellAuras.h"
+#include "Spells/SpellMgr.h"
+#include "MotionGenerators/PathFinder.h"
+#include "Vmap/VMapFactory.h"
+#include "Util/ByteBuffer.h"
+#include "Util/Util.h"
+#include "Log.h"
+#include "SystemConfig.h"
+#include "revision.h"
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+// Goldshire, a populated grid with terrain, buildings and a navmesh
+#define BENCHMARK_MAP_ID            0
+#define BENCHMARK_POSITION_X        -9464.0f
+#define BENCHMARK_POSITION_Y        62.0f
+
+#define BENCHMARK_ROUNDS            10
+#define BENCHMARK_ROUND_TIME        std::chrono::milliseconds(20)
+
+namespace
+{
+    struct BenchmarkResult
+    {
+        std::string name;
+        std::string detail;                                 // what one operation is made of
+        uint64 operations;
+        double meanNs;                                      // per operation
+        double minNs;                                       // per operation in the fastest round
+    };
+
+    // keeps the compiler from dropping the measured work
+    volatile uint64 s_sink = 0;
+
+    // doubles the calls per round until one takes BENCHMARK_ROUND_TIME, then times
+    // BENCHMARK_ROUNDS rounds of that size. body does opsPerCall operations.
+    template <typename Body>
+    BenchmarkResult Measure(std::string name, std::string detail, uint32 opsPerCall, Body body)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        uint64 calls = 1;
+        for (;;)
+        {
+            Clock::time_point const start = Clock::now();
+            for (uint64 i = 0; i < calls; ++i)
+                s_sink = s_sink + body();
+            if (Clock::now() - start >= BENCHMARK_ROUND_TIME || calls >= (uint64(1) << 30))
+                break;
+            calls *= 2;
+        }
+
+        BenchmarkResult result;
+        result.name = std::move(name);
+        result.detail = std::move(detail);
+        result.operations = calls * opsPerCall * BENCHMARK_ROUNDS;
+        result.minNs = std::numeric_limits<double>::max();
+
+        double total = 0.0;
+        for (uint32 round = 0; round < BENCHMARK_ROUNDS; ++round)
+        {
+            Clock::time_point const start = Clock::now();
+            for (uint64 i = 0; i < calls; ++i)
+                s_sink = s_sink + body();
+            double const perOp = double(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()) / double(calls * opsPerCall);
+            total += perOp;
+            result.minNs = std::min(result.minNs, perOp);
+        }
+        result.meanNs = total / BENCHMARK_ROUNDS;
+
+        sLog.outString("Benchmark %-32s %12.1f ns/op (best %.1f), %s", result.name.c_str(), result.meanNs, result.minNs, result.detail.c_str());
+        return result;
+    }
+
+    // grid and world containers of every cell of the grid, with the visitor Map::Update crawls active cells with
+    uint64 VisitGrid(Map* map, GridPair const& grid, uint32 generation, WorldObjectVector& objects)
+    {
+        objects.clear();
+        MaNGOS::ObjectUpdater updater(objects, generation, 0);
+        TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> gridVisitor(updater);
+        TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> worldVisitor(updater);
+
+        for (uint32 x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
+        {
+            for (uint32 y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
+            {
+                Cell cell(CellPair(grid.x_coord * MAX_NUMBER_OF_CELLS + x, grid.y_coord * MAX_NUMBER_OF_CELLS + y));
+                cell.SetNoCreate();
+                map->Visit(cell, gridVisitor);
+                map->Visit(cell, worldVisitor);
+            }
+        }
+        return objects.size();
+    }
+
+    // values block of everything the creature has set, what a client gets for a full refresh
+    void BuildValuesBlock(Creature const* creature, ByteBuffer& block)
+    {
+        UpdateMask mask;
+        mask.SetCount(creature->GetValuesCount());
+        for (uint16 index = 0; index < creature->GetValuesCount(); ++index)
+            if (creature->GetUInt32Value(index))
+                mask.SetBit(index);
+
+        block << uint8(UPDATETYPE_VALUES);
+        block << creature->GetPackGUID();
+        block << uint8(mask.GetBlockCount());
+        block.append(mask.GetMask(), mask.GetLength());
+        for (uint16 index = 0; index < creature->GetValuesCount(); ++index)
+            if (mask.GetBit(index))
+                block << creature->GetUInt32Value(index);
+    }
+}
+
+std::string CoreBenchmarks::EscapeJson(std::string const& text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped.push_back('\\');
+        if (uint8(c) >= 0x20)
+            escaped.push_back(c);
+    }
+    return escaped;
+}
+
+bool CoreBenchmarks::Run(std::string const& fileName)
+{
+    Map* map = sMapMgr.CreateMap(BENCHMARK_MAP_ID, nullptr);
+    if (!map)
+    {
+        sLog.outError("Benchmarks: map %u cannot be created", BENCHMARK_MAP_ID);
+        return false;
+    }
+
+    map->ForceLoadGrid(BENCHMARK_POSITION_X, BENCHMARK_POSITION_Y);
+    GridPair const grid = MaNGOS::ComputeGridPair(BENCHMARK_POSITION_X, BENCHMARK_POSITION_Y);
+
+    uint32 generation = std::numeric_limits<uint32>::max() / 2;   // far from anything Map::Update stamped
+    WorldObjectVector objects;
+    VisitGrid(map, grid, ++generation, objects);
+
+    std::vector<Creature*> creatures;
+    for (WorldObject* object : objects)
+        if (object->GetTypeId() == TYPEID_UNIT)
+            creatures.push_back(static_cast<Creature*>(object));
+
+    if (creatures.size() < 2)
+    {
+        sLog.outError("Benchmarks: grid [%u,%u] of map %u has no creatures, is the world database populated?", grid.x_coord, grid.y_coord, BENCHMARK_MAP_ID);
+        return false;
+    }
+
+    sLog.outString("Benchmarks: map %u grid [%u,%u], %u objects, %u creatures", BENCHMARK_MAP_ID, grid.x_coord, grid.y_coord,
+                   uint32(objects.size()), uint32(creatures.size()));
+
+    std::vector<BenchmarkResult> results;
+    char detail[256];
+
+    // grid visits
+    snprintf(detail, sizeof(detail), "%u cells, %u objects collected", MAX_NUMBER_OF_CELLS * MAX_NUMBER_OF_CELLS, uint32(objects.size()));
+    results.push_back(Measure("grid.visit", detail, 1, [&]()
+    {
+        return VisitGrid(map, grid, ++generation, objects);
+    }));
+
+    // update packets
+    std::vector<ByteBuffer> blocks(creatures.size());
+    size_t blockBytes = 0;
+    for (size_t i = 0; i < creatures.size(); ++i)
+    {
+        BuildValuesBlock(creatures[i], blocks[i]);
+        blockBytes += blocks[i].size();
+    }
+
+    snprintf(detail, sizeof(detail), "%u creature value blocks, %u bytes before compression", uint32(blocks.size()), uint32(blockBytes));
+    results.push_back(Measure("updatedata.build_packet", detail, 1, [&]()
+    {
+        UpdateData data;
+        for (ByteBuffer const& block : blocks)
+            data.AddUpdateBlock(block);
+
+        uint64 size = 0;
+        for (size_t i = 0; i < data.GetPacketCount(); ++i)
+            size += data.BuildPacket(i).size();
+        return size;
+    }));
+
+    snprintf(detail, sizeof(detail), "one creature value block, %u bytes", uint32(blocks[0].size()));
+    results.push_back(Measure("updatedata.build_packet_single", detail, 1, [&]()
+    {
+        UpdateData data;
+        data.AddUpdateBlock(blocks[0]);
+        return uint64(data.BuildPacket(0).size());
+    }));
+
+    // line of sight between creatures, from eye height
+    VMAP::IVMapManager* vmaps = VMAP::VMapFactory::createOrGetVMapManager();
+    uint32 pair = 0;
+    snprintf(detail, sizeof(detail), "16 segments between %u creatures", uint32(creatures.size()));
+    results.push_back(Measure("vmap.line_of_sight", detail, 16, [&]()
+    {
+        uint64 visible = 0;
+        for (uint32 i = 0; i < 16; ++i, ++pair)
+        {
+            Creature const* from = creatures[pair % creatures.size()];
+            Creature const* to = creatures[(pair * 7 + 1) % creatures.size()];
+            visible += vmaps->isInLineOfSight(BENCHMARK_MAP_ID, from->GetPositionX(), from->GetPositionY(), from->GetPositionZ() + 2.0f,
+                                              to->GetPositionX(), to->GetPositionY(), to->GetPositionZ() + 2.0f, true);
+        }
+        return visible;
+    }));
+
+    // paths from the first creature to the others
+    uint32 destination = 0;
+    snprintf(detail, sizeof(detail), "from one creature to the other %u", uint32(creatures.size() - 1));
+    results.push_back(Measure("pathfinder.calculate", detail, 1, [&]()
+    {
+        Creature const* to = creatures[1 + destination++ % (creatures.size() - 1)];
+        PathFinder path(creatures[0]);
+        path.calculate(to->GetPositionX(), to->GetPositionY(), to->GetPositionZ());
+        return uint64(path.getPath().size());
+    }));
+
+    // ByteBuffer round trip of a movement like record
+    ByteBuffer buffer(128);
+    results.push_back(Measure("bytebuffer.serialize", "write and read a packed guid, 2 uint32, 4 floats and a string", 1, [&]()
+    {
+        buffer.clear();
+        buffer.appendPackGUID(creatures[0]->GetObjectGuid().GetRawValue());
+        buffer << uint32(0x00200001) << uint32(generation);
+        buffer << creatures[0]->GetPositionX() << creatures[0]->GetPositionY() << creatures[0]->GetPositionZ() << creatures[0]->GetOrientation();
+        buffer << "benchmark";
+
+        uint64 const guid = buffer.readPackGUID();
+        uint32 flags, counter;
+        float x, y, z, o;
+        std::string text;
+        buffer >> flags >> counter >> x >> y >> z >> o >> text;
+        return guid + flags + counter + uint64(x) + text.size();
+    }));
+
+    // same record read back with the bulk reader and a string view, no allocation
+    results.push_back(Measure("bytebuffer.view_read", "read a packed guid, 2 uint32 and 4 floats in one bounds check and a string view", 1, [&]()
+    {
+        buffer.rpos(0);
+
+        uint64 const guid = buffer.readPackGUID();
+        uint32 flags, counter;
+        float x, y, z, o;
+        buffer.read_bulk(flags, counter, x, y, z, o);
+        std::string_view text = buffer.read_string_view(true);
+        return guid + flags + counter + uint64(x) + text.size();
+    }));
+
+    // the holder filter of Unit::ProcDamageAndSpellFor, for a melee hit taken by each creature
+    uint32 holders = 0;
+    for (Creature const* creature : creatures)
+        holders += uint32(creature->GetSpellAuraHolderMap().size());
+
+    uint32 victim = 0;
+    snprintf(detail, sizeof(detail), "holders of one creature, %u holders on %u creatures", holders, uint32(creatures.size()));
+    results.push_back(Measure("spellauraholder.proc_iteration", detail, 1, [&]()
+    {
+        uint64 matching = 0;
+        for (auto const& itr : creatures[victim++ % creatures.size()]->GetSpellAuraHolderMap())
+        {
+            SpellAuraHolder const* holder = itr.second;
+            if (holder->GetState() != SPELLAURAHOLDER_STATE_READY || holder->IsDeleted())
+                continue;
+
+            SpellProcEventEntry const* procEvent = sSpellMgr.GetSpellProcEvent(holder->GetId());
+            uint32 const procFlags = procEvent && procEvent->procFlags ? procEvent->procFlags : holder->GetSpellProto()->procFlags;
+            if (procFlags & PROC_FLAG_TAKE_MELEE_SWING)
+                ++matching;
+        }
+        return matching;
+    }));
+
+    // template lookups, the entries of the grid and random ones over the whole range
+    std::vector<uint32> entries;
+    for (Creature const* creature : creatures)
+        entries.push_back(creature->GetEntry());
+    for (uint32 i = 0; i < 64; ++i)
+        entries.push_back(urand(1, sCreatureStorage.GetMaxEntry()));
+
+    uint32 lookup = 0;
+    snprintf(detail, sizeof(detail), "creature_template, %u entries of the grid and 64 random ones", uint32(creatures.size()));
+    results.push_back(Measure("sqlstorage.lookup", detail, 64, [&]()
+    {
+        uint64 found = 0;
+        for (uint32 i = 0; i < 64; ++i)
+            if (CreatureInfo const* info = sCreatureStorage.LookupEntry<CreatureInfo>(entries[lookup++ % entries.size()]))
+                found += info->Entry;
+        return found;
+    }));
+
+    // creature loot generation, without a looter so conditions are not checked
+    std::vector<LootTemplate const*> lootTemplates;
+    for (Creature const* creature : creatures)
+        if (LootTemplate const* lootTemplate = LootTemplates_Creature.GetLootFor(creature->GetCreatureInfo()->LootId))
+            lootTemplates.push_back(lootTemplate);
+
+    if (!lootTemplates.empty())
+    {
+        uint32 kill = 0;
+        snprintf(detail, sizeof(detail), "loot of one creature, %u creatures of the grid have loot", uint32(lootTemplates.size()));
+        results.push_back(Measure("loot.generate", detail, 1, [&]()
+        {
+            Loot loot(LOOT_DEBUG);
+            lootTemplates[kill++ % lootTemplates.size()]->Process(loot, nullptr, LootTemplates_Creature, LootTemplates_Creature.IsRatesAllowed());
+            uint64 items = 0;
+            while (loot.GetLootItemInSlot(items))
+                ++items;
+            return items;
+        }));
+    }
+
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+    {
+        sLog.outError("Benchmarks: cannot open %s for writing", fileName.c_str());
+        return false;
+    }
+
+    fprintf(file, "{\n  \"version\": \"%s\",\n  \"map\": %u,\n  \"grid\": [%u, %u],\n  \"timestamp\": " UI64FMTD ",\n  \"benchmarks\": [",
+            EscapeJson(_FULLVERSION(REVISION_DATE, REVISION_ID)).c_str(), BENCHMARK_MAP_ID, grid.x_coord, grid.y_coord, uint64(time(nullptr)));
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        BenchmarkResult const& result = results[i];
+        fprintf(file, "%s\n    { \"name\": \"%s\", \"detail\": \"%s\", \"operations\": " UI64FMTD ", \"ns_per_op\": %.2f, \"min_ns_per_op\": %.2f }",
+                i ? "," : "", result.name.c_str(), EscapeJson(result.detail).c_str(), result.operations, result.meanNs, result.minNs);
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    bool const written = !ferror(file);
+    fclose(file);
+
+    if (written)
+        sLog.outString("Benchmarks: results written to %s", fileName.c_str());
+    else
+        sLog.outError("Benchmarks: writing %s failed", fileName.c_str());
+    return written;
+}
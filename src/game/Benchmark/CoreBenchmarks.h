@@ -0,0 +1,41 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_COREBENCHMARKS_H
+#define MANGOS_COREBENCHMARKS_H
+
+#include "Common.h"
+
+#include <string>
+
+// Microbenchmarks of core hot paths, only built with BUILD_BENCHMARKS and started by
+// mangosd --benchmark <file> once the world is loaded. They run on the real world
+// database and the extracted maps, vmaps and mmaps around one continent grid, the
+// network is never started. Results are written as one JSON document so runs of
+// different builds can be compared.
+class CoreBenchmarks
+{
+    public:
+        // false when the grid could not be populated or the file could not be written
+        static bool Run(std::string const& fileName);
+
+        // for string values of the JSON reports, drops control characters
+        static std::string EscapeJson(std::string const& text);
+};
+
+#endif
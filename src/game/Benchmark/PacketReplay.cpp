@@ -0,0 +1,327 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Benchmark/PacketReplay.h"
+#include "Benchmark/CoreBenchmarks.h"
+#include "Server/PacketLogReader.h"
+#include "Server/WorldSocket.h"
+#include "Server/WorldSession.h"
+#include "Server/WorldPacket.h"
+#include "Server/Opcodes.h"
+#include "Server/OpcodeProfiler.h"
+#include "Globals/Locales.h"
+#include "World/World.h"
+#include "Database/DatabaseEnv.h"
+#include "Auth/BigNumber.h"
+#include "Log.h"
+#include "SystemConfig.h"
+#include "revision.h"
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <memory>
+#include <thread>
+
+// time the sessions get to log out once the capture is done
+#define REPLAY_LOGOUT_TIMEOUT       std::chrono::seconds(60)
+
+std::atomic<bool> PacketReplay::s_running(false);
+std::mutex PacketReplay::s_tickLock;
+std::vector<uint32> PacketReplay::s_ticks;
+
+namespace
+{
+    typedef std::chrono::steady_clock ReplayClock;
+
+    struct ReplayConnection
+    {
+        ReplayConnection() : accountId(0), session(nullptr) {}
+
+        uint32 accountId;
+        std::shared_ptr<WorldSocket> socket;                // null when no session could be created
+        WorldSession* session;                              // only valid while the socket is open
+    };
+
+    // never destroyed, the sessions of a server stopped during the replay may hold their socket until exit
+    boost::asio::io_service& GetReplayService()
+    {
+        static boost::asio::io_service* service = new boost::asio::io_service();
+        return *service;
+    }
+
+    // what WorldSocket::HandleAuthSession sets up for a verified client
+    WorldSession* CreateReplaySession(uint32 accountId, WorldSocket* socket, uint32 build)
+    {
+        std::unique_ptr<QueryResult> result(LoginDatabase.PQuery("SELECT username, gmlevel, expansion, mutetime, locale, flags FROM account WHERE id = %u", accountId));
+        if (!result)
+        {
+            sLog.outError("PacketReplay: account %u of the capture does not exist", accountId);
+            return nullptr;
+        }
+
+        Field* fields = result->Fetch();
+
+        uint32 const security = std::min(uint32(fields[1].GetUInt16()), uint32(SEC_ADMINISTRATOR));
+        uint8 const expansion = std::min(fields[2].GetUInt8(), uint8(sWorld.getConfig(CONFIG_UINT32_EXPANSION)));
+
+        // recruit a friend links are not replayed
+        WorldSession* session = new WorldSession(accountId, socket, AccountTypes(security), expansion, time_t(fields[3].GetUInt64()),
+                                                 GetLocaleByName(fields[4].GetCppString()), fields[0].GetCppString(), fields[5].GetUInt32(), 0, false);
+
+        session->LoadGlobalAccountData();
+        session->LoadTutorialsData();
+        session->SetGameBuild(build);
+
+        // there is no client to answer, an anticheat that challenges it will kick the session
+        BigNumber K;
+        K.SetRand(40 * 8);
+        session->InitializeAnticheat(K);
+
+        sWorld.AddSession(session);
+        return session;
+    }
+
+    uint32 GetTickPercentile(std::vector<uint32> const& sorted, float percentile)
+    {
+        return sorted.empty() ? 0 : sorted[std::min(sorted.size() - 1, size_t(percentile * sorted.size()))];
+    }
+}
+
+PacketReplay::PacketReplay(std::string captureFile, float speed, std::string reportFile)
+    : m_captureFile(std::move(captureFile)), m_speed(speed), m_reportFile(std::move(reportFile)), m_connections(0),
+      m_packetsReplayed(0), m_packetsDropped(0), m_packetsSkipped(0), m_packetsSent(0), m_bytesSent(0)
+{
+}
+
+void PacketReplay::run()
+{
+    LoginDatabase.ThreadStart();
+    CharacterDatabase.ThreadStart();
+
+    bool const replayed = Replay();
+
+    CharacterDatabase.ThreadEnd();
+    LoginDatabase.ThreadEnd();
+
+    if (!World::IsStopped())
+        World::StopNow(replayed ? SHUTDOWN_EXIT_CODE : ERROR_EXIT_CODE);
+}
+
+void PacketReplay::RecordTick(uint64 duration)
+{
+    std::lock_guard<std::mutex> guard(s_tickLock);
+    s_ticks.push_back(uint32(std::min(duration, uint64(std::numeric_limits<uint32>::max()))));
+}
+
+bool PacketReplay::Replay()
+{
+    PacketLogReader reader;
+    if (!reader.Open(m_captureFile))
+    {
+        sLog.outError("PacketReplay: %s", reader.GetError().c_str());
+        return false;
+    }
+
+    sLog.outString("PacketReplay: replaying %s at %.2fx", m_captureFile.c_str(), m_speed);
+
+    // handler costs are part of the report
+    sWorld.setConfig(CONFIG_BOOL_OPCODE_PROFILING, true);
+    sOpcodeProfiler.Reset();
+    {
+        std::lock_guard<std::mutex> guard(s_tickLock);
+        s_ticks.clear();
+    }
+    s_running.store(true, std::memory_order_relaxed);
+
+    std::map<uint32, ReplayConnection> connections;         // by captured connection id
+    std::vector<std::weak_ptr<WorldSocket>> closed;
+
+    // closing the socket is a client disconnect, the world logs the player out and deletes the session
+    auto disconnect = [&](ReplayConnection& connection)
+    {
+        if (!connection.socket)
+            return;
+
+        connection.socket->Close();
+        m_packetsSent += connection.socket->GetReplayPacketsSent();
+        m_bytesSent += connection.socket->GetReplayBytesSent();
+        closed.push_back(connection.socket);
+        connection.socket = nullptr;
+    };
+
+    ReplayClock::time_point const start = ReplayClock::now();
+    bool started = false;
+    uint32 firstTicks = 0;
+
+    PacketLogRecordHeader record;
+    uint8 const* payload;
+    while (!World::IsStopped() && reader.Next(record, payload))
+    {
+        if (record.direction != PACKET_LOG_CLIENT_TO_SERVER)
+            continue;
+
+        if (!started)
+        {
+            firstTicks = record.ticks;
+            started = true;
+        }
+
+        // unsigned difference keeps the spacing across a wrap of getMSTime()
+        ReplayClock::time_point const due = start + std::chrono::microseconds(uint64((record.ticks - firstTicks) * 1000.0 / m_speed));
+        while (!World::IsStopped() && ReplayClock::now() < due)
+            std::this_thread::sleep_until(std::min(due, ReplayClock::now() + std::chrono::seconds(1)));
+
+        switch (record.opcode)
+        {
+            case CMSG_AUTH_SESSION:                         // replaced by CreateReplaySession
+            case CMSG_PING:
+            case CMSG_KEEP_ALIVE:
+                ++m_packetsSkipped;
+                continue;
+            default:
+                break;
+        }
+
+        if (record.opcode >= NUM_MSG_TYPES)
+        {
+            ++m_packetsSkipped;
+            continue;
+        }
+
+        auto itr = connections.find(record.connectionId);
+        if (itr == connections.end())
+        {
+            // a reconnecting client replaces the session of its previous connection
+            for (auto old = connections.begin(); old != connections.end();)
+            {
+                if (old->second.accountId == record.accountId)
+                {
+                    disconnect(old->second);
+                    old = connections.erase(old);
+                }
+                else
+                    ++old;
+            }
+
+            ReplayConnection& connection = connections[record.connectionId];
+            connection.accountId = record.accountId;
+            connection.socket = WorldSocket::CreateReplaySocket(GetReplayService());
+            if (connection.socket)
+                connection.session = CreateReplaySession(record.accountId, connection.socket.get(), reader.GetFileHeader().build);
+            if (!connection.session)
+                connection.socket = nullptr;
+
+            ++m_connections;
+            itr = connections.find(record.connectionId);
+        }
+
+        ReplayConnection& connection = itr->second;
+        if (!connection.socket || connection.socket->IsClosed())
+        {
+            ++m_packetsDropped;
+            continue;
+        }
+
+        std::unique_ptr<WorldPacket> packet(new WorldPacket(Opcodes(record.opcode), record.size, PooledStorageTag()));
+        if (record.size)
+            packet->append(payload, record.size);
+        if (record.opcode == CMSG_TIME_SYNC_RESP)
+            packet->SetReceivedTime(ReplayClock::now());
+
+        if (connection.session->QueuePacket(std::move(packet)))
+            ++m_packetsReplayed;
+        else
+            ++m_packetsDropped;
+    }
+
+    uint64 const duration = std::chrono::duration_cast<std::chrono::milliseconds>(ReplayClock::now() - start).count();
+    s_running.store(false, std::memory_order_relaxed);
+
+    if (!reader.GetError().empty())
+        sLog.outError("PacketReplay: capture ended early, %s", reader.GetError().c_str());
+
+    for (auto& connection : connections)
+        disconnect(connection.second);
+    connections.clear();
+
+    // the world drops its reference to a socket together with the session
+    ReplayClock::time_point const logoutEnd = ReplayClock::now() + REPLAY_LOGOUT_TIMEOUT;
+    while (!World::IsStopped() && ReplayClock::now() < logoutEnd &&
+            std::any_of(closed.begin(), closed.end(), [](std::weak_ptr<WorldSocket> const& socket) { return !socket.expired(); }))
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    return WriteReport(duration);
+}
+
+bool PacketReplay::WriteReport(uint64 duration) const
+{
+    std::vector<uint32> ticks;
+    {
+        std::lock_guard<std::mutex> guard(s_tickLock);
+        ticks.swap(s_ticks);
+    }
+    std::sort(ticks.begin(), ticks.end());
+
+    uint64 tickTotal = 0;
+    for (uint32 tick : ticks)
+        tickTotal += tick;
+    double const tickMean = ticks.empty() ? 0.0 : double(tickTotal) / ticks.size();
+
+    sLog.outString("PacketReplay: %u connections, " UI64FMTD " packets in " UI64FMTD " ms (" UI64FMTD " dropped), " SIZEFMTD " ticks, mean %.0f us, p99 %u us, max %u us",
+                   m_connections, m_packetsReplayed, duration, m_packetsDropped, ticks.size(), tickMean, GetTickPercentile(ticks, 0.99f), ticks.empty() ? 0 : ticks.back());
+
+    FILE* file = fopen(m_reportFile.c_str(), "w");
+    if (!file)
+    {
+        sLog.outError("PacketReplay: cannot open %s for writing", m_reportFile.c_str());
+        return false;
+    }
+
+    fprintf(file, "{\n  \"version\": \"%s\",\n  \"capture\": \"%s\",\n  \"speed\": %.2f,\n  \"timestamp\": " UI64FMTD ",\n  \"duration_ms\": " UI64FMTD ",\n  \"connections\": %u,\n",
+            CoreBenchmarks::EscapeJson(_FULLVERSION(REVISION_DATE, REVISION_ID)).c_str(), CoreBenchmarks::EscapeJson(m_captureFile).c_str(), m_speed,
+            uint64(time(nullptr)), duration, m_connections);
+    fprintf(file, "  \"packets\": { \"replayed\": " UI64FMTD ", \"dropped\": " UI64FMTD ", \"skipped\": " UI64FMTD ", \"sent\": " UI64FMTD ", \"sent_bytes\": " UI64FMTD " },\n",
+            m_packetsReplayed, m_packetsDropped, m_packetsSkipped, m_packetsSent, m_bytesSent);
+    fprintf(file, "  \"ticks\": { \"count\": " SIZEFMTD ", \"mean_us\": %.1f, \"p50_us\": %u, \"p95_us\": %u, \"p99_us\": %u, \"max_us\": %u },\n  \"handlers\": [",
+            ticks.size(), tickMean, GetTickPercentile(ticks, 0.5f), GetTickPercentile(ticks, 0.95f), GetTickPercentile(ticks, 0.99f), ticks.empty() ? 0 : ticks.back());
+
+    static char const* const threadNames[MAX_OPCODE_PROFILE_THREAD] = { "world", "map" };
+    std::vector<OpcodeLatencySummary> const summaries = sOpcodeProfiler.GetSummaries();
+    for (size_t i = 0; i < summaries.size(); ++i)
+    {
+        OpcodeLatencySnapshot const& data = summaries[i].data;
+        fprintf(file, "%s\n    { \"opcode\": \"%s\", \"thread\": \"%s\", \"count\": " UI64FMTD ", \"wall_us\": " UI64FMTD ", \"cpu_us\": " UI64FMTD ", \"p50_us\": %u, \"p99_us\": %u, \"max_us\": %u }",
+                i ? "," : "", LookupOpcodeName(summaries[i].opcode), threadNames[summaries[i].thread], data.count, data.wallTime, data.cpuTime,
+                data.GetPercentile(0.5f), data.GetPercentile(0.99f), data.maxTime);
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    bool const written = !ferror(file);
+    fclose(file);
+
+    if (written)
+        sLog.outString("PacketReplay: report written to %s", m_reportFile.c_str());
+    else
+        sLog.outError("PacketReplay: writing %s failed", m_reportFile.c_str());
+    return written;
+}
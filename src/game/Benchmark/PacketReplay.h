@@ -0,0 +1,70 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PACKETREPLAY_H
+#define MANGOS_PACKETREPLAY_H
+
+#include "Common.h"
+#include "Multithreading/Threading.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Feeds the client packets of a PacketLog.Format = 1 capture into the running world,
+// only built with BUILD_BENCHMARKS and started by mangosd --replay <capture>. Every
+// captured connection gets a session on a replay socket that is never connected and
+// drops what the server sends, authentication is skipped. Packets keep their captured
+// spacing divided by the speed-up. Once the capture is done the sessions log out, world
+// tick times and handler costs are written as JSON and the server stops.
+//
+// The characters of the capture have to exist in the character database with the same
+// guids, a copy of the database the capture was taken on is the easiest way.
+class PacketReplay : public MaNGOS::Runnable
+{
+    public:
+        PacketReplay(std::string captureFile, float speed, std::string reportFile);
+
+        void run() override;
+
+        // world thread, duration of one World::Update in microseconds while a replay runs
+        static bool IsRunning() { return s_running.load(std::memory_order_relaxed); }
+        static void RecordTick(uint64 duration);
+
+    private:
+        bool Replay();
+        bool WriteReport(uint64 duration) const;
+
+        std::string const m_captureFile;
+        float const m_speed;
+        std::string const m_reportFile;
+
+        uint32 m_connections;
+        uint64 m_packetsReplayed;
+        uint64 m_packetsDropped;                            // no session for the connection or its receive queue was full
+        uint64 m_packetsSkipped;                            // handled by the socket in a real connection
+        uint64 m_packetsSent;
+        uint64 m_bytesSent;
+
+        static std::atomic<bool> s_running;
+        static std::mutex s_tickLock;
+        static std::vector<uint32> s_ticks;
+};
+
+#endif
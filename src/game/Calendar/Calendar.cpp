@@ -39,7 +39,11 @@ bool CalendarEvent::AddInvite(CalendarInvite* invite)
     if (!invite)
         return false;
 
-    return m_Invitee.insert(CalendarInviteMap::value_type(invite->InviteId, invite)).second;
+    if (!m_Invitee.insert(CalendarInviteMap::value_type(invite->InviteId, invite)).second)
+        return false;
+
+    sCalendarMgr.IndexInvite(invite);
+    return true;
 }
 
 CalendarInvite* CalendarEvent::GetInviteById(uint64 inviteId)
@@ -75,6 +79,7 @@ void CalendarEvent::RemoveInviteByItr(CalendarInviteMap::iterator inviteItr)
 
     CharacterDatabase.PExecute("DELETE FROM calendar_invites WHERE inviteId=" UI64FMTD, inviteItr->second->InviteId);
 
+    sCalendarMgr.UnindexInvite(inviteItr->second);
     delete inviteItr->second;
     m_Invitee.erase(inviteItr);
 }
@@ -193,56 +198,149 @@ CalendarInvite::CalendarInvite(CalendarEvent* event, uint64 inviteId, ObjectGuid
 //////////////////////////////////////////////////////////////////////////
 
 // fill all player events in provided CalendarEventsList
-void CalendarMgr::GetPlayerEventsList(ObjectGuid const& guid, CalendarEventsList& calEventList)
+void CalendarMgr::GetPlayerEventsList(ObjectGuid const& guid, uint32 guildId, CalendarEventsList& calEventList)
 {
-    uint32 guildId;
-    Player* player = sObjectMgr.GetPlayer(guid);
-    if (player)
-        guildId = player->GetGuildId();
-    else
-        guildId = Player::GetGuildIdFromDB(guid);
+    // own events, same guild events or announcements and all events where player is invited, ordered by id
+    EventIdSet eventIds;
 
-    for (auto& itr : m_EventStore)
-    {
-        CalendarEvent* event = &itr.second;
+    auto creatorItr = m_CreatorEvents.find(guid);
+    if (creatorItr != m_CreatorEvents.end())
+        eventIds.insert(creatorItr->second.begin(), creatorItr->second.end());
 
-        // add own event and same guild event or announcement
-        if ((event->CreatorGuid == guid) || ((event->IsGuildAnnouncement() || event->IsGuildEvent()) && event->GuildId == guildId))
+    if (guildId)
+    {
+        auto guildItr = m_GuildEvents.find(guildId);
+        if (guildItr != m_GuildEvents.end())
         {
-            calEventList.push_back(event);
-            continue;
+            for (uint64 eventId : guildItr->second.events)
+            {
+                CalendarEvent const* event = GetEventById(eventId);
+                if (event->IsGuildAnnouncement() || event->IsGuildEvent())
+                    eventIds.insert(eventId);
+            }
         }
-
-        // add all event where player is invited
-        if (event->GetInviteByGuid(guid))
-            calEventList.push_back(event);
     }
+
+    auto inviteItr = m_PlayerInvites.find(guid);
+    if (inviteItr != m_PlayerInvites.end())
+        for (auto& itr : inviteItr->second)
+            eventIds.insert(itr.first);
+
+    for (uint64 eventId : eventIds)
+        calEventList.push_back(GetEventById(eventId));
 }
 
 // fill all player invites in provided CalendarInvitesList
 void CalendarMgr::GetPlayerInvitesList(ObjectGuid const& guid, CalendarInvitesList& calInvList)
 {
-    for (auto& itr : m_EventStore)
-    {
-        CalendarEvent* event = &itr.second;
+    auto inviteItr = m_PlayerInvites.find(guid);
+    if (inviteItr == m_PlayerInvites.end())
+        return;
 
-        if (event->IsGuildAnnouncement())
+    for (auto& itr : inviteItr->second)
+    {
+        if (itr.second->GetCalendarEvent()->IsGuildAnnouncement())
             continue;
 
-        CalendarInviteMap const* cInvMap = event->GetInviteMap();
-        CalendarInviteMap::const_iterator ci_itr = cInvMap->begin();
-        while (ci_itr != cInvMap->end())
-        {
-            if (ci_itr->second->InviteeGuid == guid)
-            {
-                calInvList.push_back(ci_itr->second);
-                break;
-            }
-            ++ci_itr;
-        }
+        calInvList.push_back(itr.second);
+    }
+}
+
+// return the cached invites and events part of the calendar, rebuilt only if something changed for that player
+ByteBuffer const& CalendarMgr::GetPlayerCalendarData(ObjectGuid const& guid, uint32 guildId)
+{
+    uint32 guildVersion = 0;
+    if (guildId)
+    {
+        auto guildItr = m_GuildEvents.find(guildId);
+        if (guildItr != m_GuildEvents.end())
+            guildVersion = guildItr->second.version;
+    }
+
+    PlayerCalendarCache& cache = m_PlayerCalendars[guid];
+    if (!cache.data.empty() && cache.guildId == guildId && cache.guildVersion == guildVersion)
+        return cache.data;
+
+    cache.guildId = guildId;
+    cache.guildVersion = guildVersion;
+    cache.data.clear();
+    BuildPlayerCalendarData(guid, guildId, cache.data);
+    return cache.data;
+}
+
+// drop cached calendars of everyone seeing that event
+void CalendarMgr::InvalidateEventCalendars(CalendarEvent const* event)
+{
+    InvalidatePlayerCalendar(event->CreatorGuid);
+
+    for (auto& itr : *event->GetInviteMap())
+        InvalidatePlayerCalendar(itr.second->InviteeGuid);
+
+    if (event->GuildId)
+        ++m_GuildEvents[event->GuildId].version;
+}
+
+void CalendarMgr::IndexInvite(CalendarInvite* invite)
+{
+    // first invite of a player in an event is the one used, like GetInviteByGuid
+    m_PlayerInvites[invite->InviteeGuid].emplace(invite->GetCalendarEvent()->EventId, invite);
+    InvalidatePlayerCalendar(invite->InviteeGuid);
+}
+
+void CalendarMgr::UnindexInvite(CalendarInvite const* invite)
+{
+    auto playerItr = m_PlayerInvites.find(invite->InviteeGuid);
+    if (playerItr != m_PlayerInvites.end())
+    {
+        PlayerInviteIndex::iterator itr = playerItr->second.find(invite->GetCalendarEvent()->EventId);
+        if (itr != playerItr->second.end() && itr->second == invite)
+            playerItr->second.erase(itr);
+
+        if (playerItr->second.empty())
+            m_PlayerInvites.erase(playerItr);
+    }
+
+    InvalidatePlayerCalendar(invite->InviteeGuid);
+}
+
+void CalendarMgr::IndexEvent(CalendarEvent const& event)
+{
+    m_CreatorEvents[event.CreatorGuid].insert(event.EventId);
+    InvalidatePlayerCalendar(event.CreatorGuid);
+
+    if (event.GuildId)
+    {
+        GuildCalendar& guildCalendar = m_GuildEvents[event.GuildId];
+        guildCalendar.events.insert(event.EventId);
+        ++guildCalendar.version;
     }
 }
 
+// remove event from the store and all indexes, remaining invites are removed by the event destructor
+void CalendarMgr::EraseEvent(CalendarEventStore::iterator itr)
+{
+    CalendarEvent const& event = itr->second;
+
+    auto creatorItr = m_CreatorEvents.find(event.CreatorGuid);
+    if (creatorItr != m_CreatorEvents.end())
+    {
+        creatorItr->second.erase(event.EventId);
+        if (creatorItr->second.empty())
+            m_CreatorEvents.erase(creatorItr);
+    }
+    InvalidatePlayerCalendar(event.CreatorGuid);
+
+    // guild entry is kept so its version never goes back
+    if (event.GuildId)
+    {
+        GuildCalendar& guildCalendar = m_GuildEvents[event.GuildId];
+        guildCalendar.events.erase(event.EventId);
+        ++guildCalendar.version;
+    }
+
+    m_EventStore.erase(itr);
+}
+
 // add single event to main events store
 // some check done before so it may fail and raison is sent to client
 // return value is the CalendarEvent pointer on success
@@ -309,6 +407,8 @@ CalendarEvent* CalendarMgr::AddEvent(ObjectGuid const& guid, std::string title,
     newEvent.Flags = flags;
     newEvent.GuildId = guildId;
 
+    IndexEvent(newEvent);
+
     CharacterDatabase.escape_string(title);
     CharacterDatabase.escape_string(description);
     CharacterDatabase.PExecute("INSERT INTO calendar_events VALUES (" UI64FMTD ", %u, %u, %u, %u, %d, %u, '%s', '%s')",
@@ -348,7 +448,7 @@ void CalendarMgr::RemoveEvent(uint64 eventId, Player* remover)
 
     // explicitly remove all invite and send mail to all invitee
     citr->second.RemoveAllInvite(remover->GetObjectGuid());
-    m_EventStore.erase(citr);
+    EraseEvent(citr);
 }
 
 // Add invit to an event and inform client
@@ -523,7 +623,7 @@ void CalendarMgr::RemovePlayerCalendar(ObjectGuid const& playerGuid)
         if (itr->second.CreatorGuid == playerGuid)
         {
             // all invite will be automaticaly deleted
-            m_EventStore.erase(itr++);
+            EraseEvent(itr++);
             // itr already incremented so go recheck event owner
             continue;
         }
@@ -532,6 +632,8 @@ void CalendarMgr::RemovePlayerCalendar(ObjectGuid const& playerGuid)
         event->RemoveInviteByGuid(playerGuid);
         ++itr;
     }
+
+    InvalidatePlayerCalendar(playerGuid);
 }
 
 // remove all events and invite of player related to a specific guild
@@ -546,7 +648,7 @@ void CalendarMgr::RemoveGuildCalendar(ObjectGuid const& playerGuid, uint32 Guild
         if (event->CreatorGuid == playerGuid && (event->IsGuildEvent() || event->IsGuildAnnouncement()))
         {
             // all invite will be automaticaly deleted
-            m_EventStore.erase(itr++);
+            EraseEvent(itr++);
             // itr already incremented so go recheck event owner
             continue;
         }
@@ -570,6 +672,10 @@ void CalendarMgr::LoadCalendarsFromDB()
     m_MaxInviteId = 0;
     m_MaxEventId = 0;
     m_EventStore.clear();
+    m_PlayerInvites.clear();
+    m_CreatorEvents.clear();
+    m_GuildEvents.clear();
+    m_PlayerCalendars.clear();
 
     sLog.outString("Loading Calendar Events...");
 
@@ -604,6 +710,8 @@ void CalendarMgr::LoadCalendarsFromDB()
             newEvent.Title         = field[7].GetCppString();
             newEvent.Description   = field[8].GetCppString();
 
+            IndexEvent(newEvent);
+
             m_MaxEventId = std::max(eventId, m_MaxEventId);
         }
         while (eventsQuery->NextRow());
@@ -625,6 +733,8 @@ void CalendarMgr::LoadCalendarsFromDB()
         {
             // delete all events (no event exist without at least one invite)
             m_EventStore.clear();
+            m_CreatorEvents.clear();
+            m_GuildEvents.clear();
             m_MaxEventId = 0;
             CharacterDatabase.DirectExecute("TRUNCATE TABLE calendar_events");
             sLog.outString(">> calendar_invites table is empty, cleared calendar_events table!");
@@ -685,12 +795,8 @@ void CalendarMgr::LoadCalendarsFromDB()
 // check if player have not reached event limit
 bool CalendarMgr::CanAddEvent(ObjectGuid const& guid)
 {
-    uint32 totalEvents = 0;
-    // count all event created by guid
-    for (auto& itr : m_EventStore)
-        if ((itr.second.CreatorGuid == guid) && (++totalEvents >= CALENDAR_MAX_EVENTS))
-            return false;
-    return true;
+    auto itr = m_CreatorEvents.find(guid);
+    return itr == m_CreatorEvents.end() || itr->second.size() < CALENDAR_MAX_EVENTS;
 }
 
 // check if guild have not reached event limit
@@ -699,35 +805,21 @@ bool CalendarMgr::CanAddGuildEvent(uint32 guildId)
     if (!guildId)
         return false;
 
-    uint32 totalEvents = 0;
-    // count all guild events in a guild
-    for (auto& itr : m_EventStore)
-        if ((itr.second.GuildId == guildId) && (++totalEvents >= CALENDAR_MAX_GUILD_EVENTS))
-            return false;
-    return true;
+    auto itr = m_GuildEvents.find(guildId);
+    return itr == m_GuildEvents.end() || itr->second.events.size() < CALENDAR_MAX_GUILD_EVENTS;
 }
 
 // check if an invitee have not reached invite limit
 bool CalendarMgr::CanAddInviteTo(ObjectGuid const& guid)
 {
-    uint32 totalInvites = 0;
+    auto itr = m_PlayerInvites.find(guid);
+    if (itr == m_PlayerInvites.end())
+        return true;
 
-    for (auto& itr : m_EventStore)
-    {
-        CalendarEvent* event = &itr.second;
-
-        if (event->IsGuildAnnouncement())
-            continue;
-
-        CalendarInviteMap const* cInvMap = event->GetInviteMap();
-        CalendarInviteMap::const_iterator ci_itr = cInvMap->begin();
-        while (ci_itr != cInvMap->end())
-        {
-            if ((ci_itr->second->InviteeGuid == guid) && (++totalInvites >= CALENDAR_MAX_INVITES))
-                return false;
-            ++ci_itr;
-        }
-    }
+    uint32 totalInvites = 0;
+    for (auto& inviteItr : itr->second)
+        if (!inviteItr.second->GetCalendarEvent()->IsGuildAnnouncement() && ++totalInvites >= CALENDAR_MAX_INVITES)
+            return false;
 
     return true;
 }
@@ -23,6 +23,9 @@
 #include "Common.h"
 #include "Entities/ObjectGuid.h"
 
+#include <set>
+#include <unordered_map>
+
 enum CalendarEventType
 {
     CALENDAR_TYPE_RAID              = 0,
@@ -220,9 +223,14 @@ class CalendarMgr
         CalendarMgr() : m_MaxEventId(0), m_MaxInviteId(0) {};
         ~CalendarMgr() {};
 
-        void GetPlayerEventsList(ObjectGuid const& guid, CalendarEventsList& calEventList);
+        void GetPlayerEventsList(ObjectGuid const& guid, uint32 guildId, CalendarEventsList& calEventList);
         void GetPlayerInvitesList(ObjectGuid const& guid, CalendarInvitesList& calInvList);
 
+        // invites and events part of SMSG_CALENDAR_SEND_CALENDAR, only rebuilt after a change touching that player
+        ByteBuffer const& GetPlayerCalendarData(ObjectGuid const& guid, uint32 guildId);
+        void InvalidatePlayerCalendar(ObjectGuid const& guid) { m_PlayerCalendars.erase(guid); }
+        void InvalidateEventCalendars(CalendarEvent const* event);
+
         CalendarEvent* AddEvent(ObjectGuid const& guid, std::string title, std::string description, uint32 type, uint32 repeatable, uint32 maxInvites,
                                 int32 dungeonId, time_t eventTime, time_t unkTime, uint32 flags);
 
@@ -270,6 +278,39 @@ class CalendarMgr
         bool CanAddGuildEvent(uint32 guildId);          // check if guild not reached the event number limit
         bool CanAddEvent(ObjectGuid const& guid);       // check if player not reached the event number limit
 
+        // index maintenance, invites are (un)indexed by CalendarEvent itself
+        friend class CalendarEvent;
+        void IndexInvite(CalendarInvite* invite);
+        void UnindexInvite(CalendarInvite const* invite);
+        void IndexEvent(CalendarEvent const& event);
+        void EraseEvent(CalendarEventStore::iterator itr);
+
+        void BuildPlayerCalendarData(ObjectGuid const& guid, uint32 guildId, ByteBuffer& data);
+
+        typedef std::map<uint64, CalendarInvite*> PlayerInviteIndex;    // invites of one player by event id
+        typedef std::set<uint64> EventIdSet;
+
+        struct GuildCalendar
+        {
+            GuildCalendar() : version(0) {}
+
+            EventIdSet events;                  // guild events and announcements
+            uint32 version;                     // changed with any of these events
+        };
+
+        struct PlayerCalendarCache
+        {
+            uint32 guildId;
+            uint32 guildVersion;
+            ByteBuffer data;
+        };
+
+        // declared before the event store, events still unindex their invites when destroyed
+        std::unordered_map<ObjectGuid, PlayerInviteIndex> m_PlayerInvites;
+        std::unordered_map<ObjectGuid, EventIdSet> m_CreatorEvents;
+        std::unordered_map<uint32, GuildCalendar> m_GuildEvents;
+        std::unordered_map<ObjectGuid, PlayerCalendarCache> m_PlayerCalendars;
+
         CalendarEventStore m_EventStore;        // main events storage
         uint64 m_MaxEventId;                    // current max event ID
         uint64 m_MaxInviteId;                   // current max invite ID
@@ -40,51 +40,8 @@ void WorldSession::HandleCalendarGetCalendar(WorldPacket& /*recv_data*/)
 
     WorldPacket data(SMSG_CALENDAR_SEND_CALENDAR);
 
-    CalendarInvitesList invites;
-    sCalendarMgr.GetPlayerInvitesList(guid, invites);
-
-    data << uint32(invites.size());
-    DEBUG_FILTER_LOG(LOG_FILTER_CALENDAR, "Sending > %u invites", uint32(invites.size()));
-
-    for (CalendarInvitesList::const_iterator itr = invites.begin(); itr != invites.end(); ++itr)
-    {
-        CalendarEvent const* event = (*itr)->GetCalendarEvent();
-        MANGOS_ASSERT(event);                           // TODO: be sure no way to have a null event
-
-        data << uint64(event->EventId);
-        data << uint64((*itr)->InviteId);
-        data << uint8((*itr)->Status);
-        data << uint8((*itr)->Rank);
-
-        data << uint8(event->IsGuildEvent());
-        data << event->CreatorGuid.WriteAsPacked();
-        DEBUG_FILTER_LOG(LOG_FILTER_CALENDAR, "invite> EventId[" UI64FMTD "], InviteId[" UI64FMTD "], status[%u], rank[%u]",
-                         event->EventId, (*itr)->InviteId, uint32((*itr)->Status), uint32((*itr)->Rank));
-    }
-
-    CalendarEventsList events;
-    sCalendarMgr.GetPlayerEventsList(guid, events);
-
-    data << uint32(events.size());
-    DEBUG_FILTER_LOG(LOG_FILTER_CALENDAR, "Sending > %u events", uint32(events.size()));
-
-    for (CalendarEventsList::const_iterator itr = events.begin(); itr != events.end(); ++itr)
-    {
-        CalendarEvent const* event = *itr;
-
-        data << uint64(event->EventId);
-        data << event->Title;
-        data << uint32(event->Type);
-        data << secsToTimeBitFields(event->EventTime);
-        data << uint32(event->Flags);
-        data << int32(event->DungeonId);
-        data << event->CreatorGuid.WriteAsPacked();
-
-        std::string timeStr = TimeToTimestampStr(event->EventTime);
-        DEBUG_FILTER_LOG(LOG_FILTER_CALENDAR, "Events> EventId[" UI64FMTD "], Title[%s], Time[%s], Type[%u],  Flag[%u], DungeonId[%d], CreatorGuid[%s]",
-                         event->EventId, event->Title.c_str(), timeStr.c_str(), uint32(event->Type),
-                         uint32(event->Flags), event->DungeonId, event->CreatorGuid.GetString().c_str());
-    }
+    // invites and events only change with calendar actions, reuse them until then
+    data.append(sCalendarMgr.GetPlayerCalendarData(guid, _player->GetGuildId()));
 
     data << uint32(currTime);                               // server time
     data << secsToTimeBitFields(currTime);                  // zone time ??
@@ -365,6 +322,7 @@ void WorldSession::HandleCalendarUpdateEvent(WorldPacket& recv_data)
         event->Title = title;
         event->Description = description;
 
+        sCalendarMgr.InvalidateEventCalendars(event);
         sCalendarMgr.SendCalendarEventUpdateAlert(event, oldEventTime);
 
         // query construction
@@ -561,6 +519,7 @@ void WorldSession::HandleCalendarEventRsvp(WorldPacket& recv_data)
             }
             invite->Status = CalendarInviteStatus(status);
             invite->LastUpdateTime = time(nullptr);
+            sCalendarMgr.InvalidatePlayerCalendar(invite->InviteeGuid);
 
             CharacterDatabase.PExecute("UPDATE calendar_invites SET status=%u, lastUpdateTime=%u WHERE inviteId = " UI64FMTD, status, uint32(invite->LastUpdateTime), invite->InviteId);
             sCalendarMgr.SendCalendarEventStatus(invite);
@@ -634,6 +593,7 @@ void WorldSession::HandleCalendarEventStatus(WorldPacket& recv_data)
             }
             invite->Status = (CalendarInviteStatus)status;
             invite->LastUpdateTime = time(nullptr);            // not sure if we should set response time when moderator changes invite status
+            sCalendarMgr.InvalidatePlayerCalendar(invite->InviteeGuid);
 
             CharacterDatabase.PExecute("UPDATE calendar_invites SET status=%u, lastUpdateTime=%u WHERE inviteId=" UI64FMTD, status, uint32(invite->LastUpdateTime), invite->InviteId);
             sCalendarMgr.SendCalendarEventStatus(invite);
@@ -691,6 +651,7 @@ void WorldSession::HandleCalendarEventModeratorStatus(WorldPacket& recv_data)
 
             CharacterDatabase.PExecute("UPDATE calendar_invites SET `rank` = %u WHERE inviteId=" UI64FMTD, rank, invite->InviteId);
             invite->Rank = CalendarModerationRank(rank);
+            sCalendarMgr.InvalidatePlayerCalendar(invite->InviteeGuid);
             sCalendarMgr.SendCalendarEventModeratorStatusAlert(invite);
         }
         else
@@ -742,6 +703,56 @@ void WorldSession::HandleCalendarGetNumPending(WorldPacket& /*recv_data*/)
 // Send function
 //////////////////////////////////////////////////////////////////////////
 
+// invites and events part of SMSG_CALENDAR_SEND_CALENDAR
+void CalendarMgr::BuildPlayerCalendarData(ObjectGuid const& guid, uint32 guildId, ByteBuffer& data)
+{
+    CalendarInvitesList invites;
+    GetPlayerInvitesList(guid, invites);
+
+    data << uint32(invites.size());
+    DEBUG_FILTER_LOG(LOG_FILTER_CALENDAR, "Sending > %u invites", uint32(invites.size()));
+
+    for (CalendarInvitesList::const_iterator itr = invites.begin(); itr != invites.end(); ++itr)
+    {
+        CalendarEvent const* event = (*itr)->GetCalendarEvent();
+        MANGOS_ASSERT(event);                           // TODO: be sure no way to have a null event
+
+        data << uint64(event->EventId);
+        data << uint64((*itr)->InviteId);
+        data << uint8((*itr)->Status);
+        data << uint8((*itr)->Rank);
+
+        data << uint8(event->IsGuildEvent());
+        data << event->CreatorGuid.WriteAsPacked();
+        DEBUG_FILTER_LOG(LOG_FILTER_CALENDAR, "invite> EventId[" UI64FMTD "], InviteId[" UI64FMTD "], status[%u], rank[%u]",
+                         event->EventId, (*itr)->InviteId, uint32((*itr)->Status), uint32((*itr)->Rank));
+    }
+
+    CalendarEventsList events;
+    GetPlayerEventsList(guid, guildId, events);
+
+    data << uint32(events.size());
+    DEBUG_FILTER_LOG(LOG_FILTER_CALENDAR, "Sending > %u events", uint32(events.size()));
+
+    for (CalendarEventsList::const_iterator itr = events.begin(); itr != events.end(); ++itr)
+    {
+        CalendarEvent const* event = *itr;
+
+        data << uint64(event->EventId);
+        data << event->Title;
+        data << uint32(event->Type);
+        data << secsToTimeBitFields(event->EventTime);
+        data << uint32(event->Flags);
+        data << int32(event->DungeonId);
+        data << event->CreatorGuid.WriteAsPacked();
+
+        std::string timeStr = TimeToTimestampStr(event->EventTime);
+        DEBUG_FILTER_LOG(LOG_FILTER_CALENDAR, "Events> EventId[" UI64FMTD "], Title[%s], Time[%s], Type[%u],  Flag[%u], DungeonId[%d], CreatorGuid[%s]",
+                         event->EventId, event->Title.c_str(), timeStr.c_str(), uint32(event->Type),
+                         uint32(event->Flags), event->DungeonId, event->CreatorGuid.GetString().c_str());
+    }
+}
+
 void CalendarMgr::SendCalendarEventInviteAlert(CalendarInvite const* invite) const
 {
     DEBUG_LOG("WORLD: SMSG_CALENDAR_EVENT_INVITE_ALERT");
@@ -121,6 +121,7 @@ void Channel::Join(Player* player, const char* password)
     PlayerInfo& pinfo = m_players[guid];
     pinfo.player = guid;
     pinfo.flags = MEMBER_FLAG_NONE;
+    AddMember(player);
 
     MakeYouJoined(data, m_name, *this);
     SendToOne(data, guid);
@@ -162,6 +163,7 @@ void Channel::Leave(Player* player, bool send)
 
     bool changeowner = m_players[guid].IsOwner();
 
+    RemoveMember(guid);
     m_players.erase(guid);
 
     const uint32 level = sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_CHANNEL_SILENT_JOIN);
@@ -243,6 +245,7 @@ void Channel::KickOrBan(Player* player, const char* targetName, bool ban)
         MakePlayerKicked(data, m_name, targetGuid, guid);
 
     SendToAll(data);
+    RemoveMember(targetGuid);
     m_players.erase(targetGuid);
     target->LeftChannel(this);
 
@@ -746,16 +749,46 @@ void Channel::SendToOne(WorldPacket const& data, ObjectGuid receiver) const
 
 void Channel::SendToAll(WorldPacket const& data) const
 {
-    for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
-        SendToOne(data, i->first);
+    if (m_members.empty())
+        return;
+
+    // one copy of the packet, every socket references it
+    std::shared_ptr<WorldPacket const> packet = std::make_shared<WorldPacket const>(data);
+    for (Member const& member : m_members)
+        member.session->SendPacket(packet);
 }
 
 void Channel::SendMessage(WorldPacket const& data, ObjectGuid sender) const
 {
-    for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
-        if (Player* plr = sObjectMgr.GetPlayer(i->first))
-            if (!sender || !plr->GetSocial()->HasIgnore(sender))
-                plr->GetSession()->SendPacket(data);
+    if (m_members.empty())
+        return;
+
+    std::shared_ptr<WorldPacket const> packet = std::make_shared<WorldPacket const>(data);
+    for (Member const& member : m_members)
+        if (!sender || !member.player->GetSocial()->HasIgnore(sender))
+            member.session->SendPacket(packet);
+}
+
+void Channel::AddMember(Player* player)
+{
+    m_players[player->GetObjectGuid()].member = m_members.size();
+    m_members.push_back({ player, player->GetSession() });
+}
+
+void Channel::RemoveMember(ObjectGuid guid)
+{
+    PlayerList::iterator itr = m_players.find(guid);
+    if (itr == m_players.end())
+        return;
+
+    // the last member takes the place of the removed one
+    size_t const index = itr->second.member;
+    if (index + 1 != m_members.size())
+    {
+        m_members[index] = m_members.back();
+        m_players[m_members[index].player->GetObjectGuid()].member = index;
+    }
+    m_members.pop_back();
 }
 
 void Channel::Voice(ObjectGuid /*guid1*/, ObjectGuid /*guid2*/) const
@@ -25,6 +25,7 @@
 #include "Entities/Player.h"
 
 #include <map>
+#include <vector>
 
 enum ChatNotify : uint8
 {
@@ -123,6 +124,7 @@ class Channel
         {
             ObjectGuid player;
             uint8 flags;
+            size_t member;                                  // index in m_members
 
             inline bool HasFlag(uint8 flag) const { return (flags & flag) != 0; }
             void SetFlag(uint8 flag, bool state) { if (state) flags |= flag; else flags &= ~flag; }
@@ -136,6 +138,13 @@ class Channel
 
         typedef std::map<ObjectGuid, PlayerInfo> PlayerList;
 
+        // broadcast target, a member is removed from the channel before its player is deleted
+        struct Member
+        {
+            Player* player;
+            WorldSession* session;
+        };
+
     public:
         Channel(const std::string& name, uint32 channel_id = 0);
         std::string GetName() const { return m_name; }
@@ -221,6 +230,9 @@ class Channel
         void SendToAll(WorldPacket const& data) const;
         void SendMessage(WorldPacket const& data, ObjectGuid sender) const;
 
+        void AddMember(Player* player);
+        void RemoveMember(ObjectGuid guid);
+
         bool IsOn(ObjectGuid who) const { return m_players.find(who) != m_players.end(); }
         bool IsBanned(ObjectGuid guid) const { return m_banned.find(guid) != m_banned.end(); }
 
@@ -243,6 +255,7 @@ class Channel
         std::string                 m_password;
         ObjectGuid                  m_ownerGuid;
         PlayerList                  m_players;
+        std::vector<Member>         m_members;              // m_players in no order, iterated by broadcasts
         GuidSet                     m_banned;
         const ChatChannelsEntry*    m_entry = nullptr;
         bool                        m_announcements = false;
@@ -34,6 +34,9 @@
 #include "Pools/PoolManager.h"
 #include "GameEvents/GameEventMgr.h"
 
+#include <unordered_map>
+#include <vector>
+
 // Supported shift-links (client generated and server side)
 // |color|Hachievement:achievement_id:player_guid_hex:completed_0_1:mm:dd:yy_from_2000:criteriaMask1:criteriaMask2:criteriaMask3:criteriaMask4|h[name]|h|r
 //                                                                        - client, item icon shift click, not used in server currently
@@ -64,6 +67,75 @@
 
 bool ChatHandler::load_command_table = true;
 
+// Per command table, the entries a lowercase abbreviation selects in table order: the entries
+// whose name starts with it and the "" entries, which match anything. Built once with the
+// hardcoded tables, the names never change with a reload of the `command` table.
+typedef std::unordered_map<std::string, std::vector<uint32>> CommandAbbrIndex;
+static std::unordered_map<ChatCommand const*, CommandAbbrIndex> s_commandAbbrIndex;
+
+static void BuildCommandAbbrIndex(ChatCommand const* table)
+{
+    CommandAbbrIndex& index = s_commandAbbrIndex[table];
+
+    // all abbreviations first, a "" entry is a candidate of every one of them
+    for (uint32 i = 0; table[i].Name != nullptr; ++i)
+    {
+        std::string abbr;
+        for (char const* c = table[i].Name; *c; ++c)
+        {
+            abbr += char(tolower(*c));
+            index[abbr];
+        }
+    }
+
+    for (uint32 i = 0; table[i].Name != nullptr; ++i)
+    {
+        if (!*table[i].Name)
+        {
+            for (auto& candidates : index)
+                candidates.second.push_back(i);
+        }
+        else
+        {
+            std::string abbr;
+            for (char const* c = table[i].Name; *c; ++c)
+            {
+                abbr += char(tolower(*c));
+                index[abbr].push_back(i);
+            }
+        }
+
+        if (table[i].ChildCommands && s_commandAbbrIndex.find(table[i].ChildCommands) == s_commandAbbrIndex.end())
+            BuildCommandAbbrIndex(table[i].ChildCommands);
+    }
+
+    // the "" abbreviation only selects "" entries
+    std::vector<uint32>& unnamed = index[""];
+    unnamed.clear();
+    for (uint32 i = 0; table[i].Name != nullptr; ++i)
+        if (!*table[i].Name)
+            unnamed.push_back(i);
+}
+
+// nullptr for a table outside of the index
+static std::vector<uint32> const* FindCommandAbbrCandidates(ChatCommand const* table, std::string const& cmd)
+{
+    auto tableItr = s_commandAbbrIndex.find(table);
+    if (tableItr == s_commandAbbrIndex.end())
+        return nullptr;
+
+    std::string abbr;
+    abbr.reserve(cmd.size());
+    for (char c : cmd)
+        abbr += char(tolower(c));
+
+    // longer than any name, only the "" entries are left
+    auto itr = tableItr->second.find(abbr);
+    if (itr == tableItr->second.end())
+        itr = tableItr->second.find("");
+    return &itr->second;
+}
+
 ChatCommand* ChatHandler::getCommandTable()
 {
     static ChatCommand accountSetCommandTable[] =
@@ -268,9 +340,11 @@ ChatCommand* ChatHandler::getCommandTable()
         { "arena",          SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugArenaCommand,               "", nullptr },
         { "areatriggers",   SEC_MODERATOR,      false, &ChatHandler::HandleDebugAreaTriggersCommand,        "", nullptr },
         { "bg",             SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugBattlegroundCommand,        "", nullptr },
+        { "creaturememory", SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugCreatureMemoryCommand,      "", nullptr },
         { "getitemstate",   SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugGetItemStateCommand,        "", nullptr },
         { "lootrecipient",  SEC_GAMEMASTER,     false, &ChatHandler::HandleDebugGetLootRecipientCommand,    "", nullptr },
         { "listupdatefields",SEC_ADMINISTRATOR, false, &ChatHandler::HandleDebugListUpdateFieldsCommand,    "", nullptr },
+        { "mapcost",        SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugMapCostCommand,             "", nullptr },
         { "getitemvalue",   SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugGetItemValueCommand,        "", nullptr },
         { "getvaluebyindex",SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugGetValueByIndexCommand,     "", nullptr },
         { "getvaluebyname", SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugGetValueByNameCommand,      "", nullptr },
@@ -298,6 +372,10 @@ ChatCommand* ChatHandler::getCommandTable()
         { "chatfreeze",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugChatFreezeCommand,          "", nullptr },
         { "opcodeouthistory",SEC_ADMINISTRATOR, true,  &ChatHandler::HandleDebugOutPacketHistory,           "", nullptr },
         { "opcodeinchistory",SEC_ADMINISTRATOR, true,  &ChatHandler::HandleDebugIncPacketHistory,           "", nullptr },
+        { "opcodes",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOpcodesCommand,             "", nullptr },
+        { "queries",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugQueriesCommand,             "", nullptr },
+        { "tickpacer",      SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugTickPacerCommand,           "", nullptr },
+        { "tickprofile",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugTickProfileCommand,         "", nullptr },
         { "transports",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugTransports,                 "", nullptr },
         { "spawn",          SEC_GAMEMASTER,     true,  nullptr,                                             "", debugSpawnsCommandtable },
         { "debugflags",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugObjectFlags,                "", nullptr },
@@ -1084,6 +1162,9 @@ ChatCommand* ChatHandler::getCommandTable()
         // check hardcoded part integrity
         CheckIntegrity(commandTable, nullptr);
 
+        if (s_commandAbbrIndex.empty())
+            BuildCommandAbbrIndex(commandTable);
+
         QueryResult* result = WorldDatabase.Query("SELECT name,security,help FROM command");
         if (result)
         {
@@ -1372,16 +1453,21 @@ ChatCommandSearchResult ChatHandler::FindCommand(ChatCommand* table, char const*
 
     while (*text == ' ') ++text;
 
+    // abbreviations only visit the entries they select, exact names and tables outside of the index are scanned
+    std::vector<uint32> const* candidates = exactlyName ? nullptr : FindCommandAbbrCandidates(table, cmd);
+
     // search first level command in table
-    for (uint32 i = 0; table[i].Name != nullptr; ++i)
+    for (uint32 c = 0; candidates ? c < candidates->size() : table[c].Name != nullptr; ++c)
     {
+        uint32 const i = candidates ? (*candidates)[c] : c;
+
         if (exactlyName)
         {
             size_t len = strlen(table[i].Name);
             if (strncmp(table[i].Name, cmd.c_str(), len + 1) != 0)
                 continue;
         }
-        else
+        else if (!candidates)
         {
             if (!hasStringAbbr(table[i].Name, cmd.c_str()))
                 continue;
@@ -2217,9 +2303,9 @@ bool ChatHandler::CheckEscapeSequences(const char* message)
                             }
 
                             bool foundName = false;
-                            for (const auto& i : ql->Title)
+                            for (size_t i = 0; i < ql->Title.size(); ++i)
                             {
-                                if (i == buffer)
+                                if (ql->Title[i] == buffer)
                                 {
                                     foundName = true;
                                     break;
@@ -3630,6 +3716,31 @@ int ChatHandler::GetSessionDbLocaleIndex() const
     return m_session->GetSessionDbLocaleIndex();
 }
 
+bool CliHandler::IsReadOnlyCommand(ChatCommand const* command)
+{
+    static bool (ChatHandler::* const readOnlyHandlers[])(char*) =
+    {
+        &CliHandler::HandleAccountCharactersCommand,
+        &CliHandler::HandleLookupAreaCommand,
+        &CliHandler::HandleLookupItemSetCommand,
+        &CliHandler::HandleLookupPlayerAccountCommand,
+        &CliHandler::HandleLookupPlayerEmailCommand,
+        &CliHandler::HandleLookupPlayerIpCommand,
+        &CliHandler::HandleLookupSkillCommand,
+        &CliHandler::HandleLookupTaxiNodeCommand,
+        &CliHandler::HandleLookupTitleCommand,
+    };
+
+    if (!command || !command->Handler)
+        return false;
+
+    for (auto handler : readOnlyHandlers)
+        if (command->Handler == handler)
+            return true;
+
+    return false;
+}
+
 const char* CliHandler::GetMangosString(int32 entry) const
 {
     return sObjectMgr.GetMangosStringForDbcLocale(entry);
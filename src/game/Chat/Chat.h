@@ -41,6 +41,7 @@ class ChatHandler;
 class WorldSession;
 class WorldPacket;
 class GMTicket;
+class LootStore;
 class MailDraft;
 class Object;
 class GameObject;
@@ -269,6 +270,7 @@ class ChatHandler
         bool HandleDebugGetItemStateCommand(char* args);
         bool HandleDebugGetItemValueCommand(char* args);
         bool HandleDebugGetLootRecipientCommand(char* args);
+        bool HandleDebugCreatureMemoryCommand(char* args);
         bool HandleDebugGetValueByIndexCommand(char* args);
         bool HandleDebugGetValueByNameCommand(char* args);
         bool HandleDebugModItemValueCommand(char* args);
@@ -324,6 +326,11 @@ class ChatHandler
 
         bool HandleDebugOutPacketHistory(char* args);
         bool HandleDebugIncPacketHistory(char* args);
+        bool HandleDebugOpcodesCommand(char* args);
+        bool HandleDebugTickProfileCommand(char* args);
+        bool HandleDebugTickPacerCommand(char* args);
+        bool HandleDebugMapCostCommand(char* args);
+        bool HandleDebugQueriesCommand(char* args);
 
         bool HandleDebugTransports(char* args);
 
@@ -896,6 +903,8 @@ class ChatHandler
         void HandleCharacterDeletedListHelper(DeletedInfoList const& foundList);
         void HandleCharacterDeletedRestoreHelper(DeletedInfo const& delInfo);
 
+        bool ReloadLootStoreInBackground(LootStore& store, void (*loader)());
+
         void SetSentErrorMessage(bool val) { sentErrorMessage = val;};
     private:
         WorldSession* m_session;                            // != nullptr for chat command call and nullptr for CLI command
@@ -917,6 +926,11 @@ class CliHandler : public ChatHandler
         CliHandler(uint32 accountId, AccountTypes accessLevel, Print zprint)
             : m_accountId(accountId), m_loginAccessLevel(accessLevel), m_print(std::move(zprint)) {}
 
+        // console accepts commands with and without the chat prefix
+        static char const* SkipCommandPrefix(char const* text) { return (*text == '.' || *text == '!') ? text + 1 : text; }
+        // command only reads the databases and never reloaded stores, so it can run outside the world thread
+        static bool IsReadOnlyCommand(ChatCommand const* command);
+
         // overwrite functions
         const char* GetMangosString(int32 entry) const override;
         uint32 GetAccountId() const override;
@@ -2535,6 +2535,9 @@ bool ChatHandler::HandleNpcShowLootCommand(char* /*args*/)
         return true;
     }
 
+    if (creature->m_loot->IsDeferred())
+        creature->m_loot->FillDeferred(m_session ? m_session->GetPlayer() : nullptr);
+
     creature->m_loot->PrintLootList(*this, m_session);
     return true;
 }
@@ -3898,9 +3901,12 @@ bool ChatHandler::HandleCharacterReputationCommand(char* args)
     FactionStateList const& targetFSL = target->GetReputationMgr().GetStateList();
     for (const auto& itr : targetFSL)
     {
-        FactionEntry const* factionEntry = sFactionStore.LookupEntry(itr.second.ID);
+        if (!itr.ID)
+            continue;
+
+        FactionEntry const* factionEntry = sFactionStore.LookupEntry(itr.ID);
 
-        ShowFactionListHelper(factionEntry, loc, &itr.second, target);
+        ShowFactionListHelper(factionEntry, loc, &itr, target);
     }
     return true;
 }
@@ -4662,7 +4668,7 @@ bool ChatHandler::HandlePoolSpawnsCommand(char* args)
 
     SpawnedPoolData const& spawns = mapState->GetSpawnedPoolData();
 
-    SpawnedPoolObjects const& crSpawns = spawns.GetSpawnedCreatures();
+    SpawnedPoolObjects crSpawns = spawns.GetSpawnedCreatures();
     for (uint32 crSpawn : crSpawns)
         if (!pool_id || pool_id == sPoolMgr.IsPartOfAPool<Creature>(crSpawn))
             if (CreatureData const* data = sObjectMgr.GetCreatureData(crSpawn))
@@ -4670,7 +4676,7 @@ bool ChatHandler::HandlePoolSpawnsCommand(char* args)
                     PSendSysMessage(LANG_CREATURE_LIST_CHAT, crSpawn, PrepareStringNpcOrGoSpawnInformation<Creature>(crSpawn).c_str(),
                         crSpawn, info->Name, data->posX, data->posY, data->posZ, data->mapid);
 
-    SpawnedPoolObjects const& goSpawns = spawns.GetSpawnedGameobjects();
+    SpawnedPoolObjects goSpawns = spawns.GetSpawnedGameobjects();
     for (uint32 goSpawn : goSpawns)
         if (!pool_id || pool_id == sPoolMgr.IsPartOfAPool<GameObject>(goSpawn))
             if (GameObjectData const* data = sObjectMgr.GetGOData(goSpawn))
@@ -4717,7 +4723,6 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
     }
 
     PoolGroup<Creature> const& poolCreatures = sPoolMgr.GetPoolCreatures(pool_id);
-    SpawnedPoolObjects const* crSpawns = spawns ? &spawns->GetSpawnedCreatures() : nullptr;
 
     PoolObjectList const& poolCreaturesEx = poolCreatures.GetExplicitlyChanced();
     if (!poolCreaturesEx.empty())
@@ -4729,7 +4734,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
             {
                 if (CreatureInfo const* info = ObjectMgr::GetCreatureTemplate(data->id))
                 {
-                    char const* active = crSpawns && crSpawns->find(itr.guid) != crSpawns->end() ? active_str.c_str() : "";
+                    char const* active = spawns && spawns->IsSpawnedObject<Creature>(itr.guid) ? active_str.c_str() : "";
                     if (m_session)
                         PSendSysMessage(LANG_POOL_CHANCE_CREATURE_LIST_CHAT, itr.guid, PrepareStringNpcOrGoSpawnInformation<Creature>(itr.guid).c_str(),
                             itr.guid, info->Name, data->posX, data->posY, data->posZ, data->mapid, itr.chance, active);
@@ -4751,7 +4756,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
             {
                 if (CreatureInfo const* info = ObjectMgr::GetCreatureTemplate(data->id))
                 {
-                    char const* active = crSpawns && crSpawns->find(itr.guid) != crSpawns->end() ? active_str.c_str() : "";
+                    char const* active = spawns && spawns->IsSpawnedObject<Creature>(itr.guid) ? active_str.c_str() : "";
                     if (m_session)
                         PSendSysMessage(LANG_POOL_CREATURE_LIST_CHAT, itr.guid, PrepareStringNpcOrGoSpawnInformation<Creature>(itr.guid).c_str(),
                             itr.guid, info->Name, data->posX, data->posY, data->posZ, data->mapid, active);
@@ -4764,7 +4769,6 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
     }
 
     PoolGroup<GameObject> const& poolGameObjects = sPoolMgr.GetPoolGameObjects(pool_id);
-    SpawnedPoolObjects const* goSpawns = spawns ? &spawns->GetSpawnedGameobjects() : nullptr;
 
     PoolObjectList const& poolGameObjectsEx = poolGameObjects.GetExplicitlyChanced();
     if (!poolGameObjectsEx.empty())
@@ -4776,7 +4780,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
             {
                 if (GameObjectInfo const* info = ObjectMgr::GetGameObjectInfo(data->id))
                 {
-                    char const* active = goSpawns && goSpawns->find(itr.guid) != goSpawns->end() ? active_str.c_str() : "";
+                    char const* active = spawns && spawns->IsSpawnedObject<GameObject>(itr.guid) ? active_str.c_str() : "";
                     if (m_session)
                         PSendSysMessage(LANG_POOL_CHANCE_GO_LIST_CHAT, itr.guid, PrepareStringNpcOrGoSpawnInformation<GameObject>(itr.guid).c_str(),
                             itr.guid, info->name, data->posX, data->posY, data->posZ, data->mapid, itr.chance, active);
@@ -4798,7 +4802,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
             {
                 if (GameObjectInfo const* info = ObjectMgr::GetGameObjectInfo(data->id))
                 {
-                    char const* active = goSpawns && goSpawns->find(itr.guid) != goSpawns->end() ? active_str.c_str() : "";
+                    char const* active = spawns && spawns->IsSpawnedObject<GameObject>(itr.guid) ? active_str.c_str() : "";
                     if (m_session)
                         PSendSysMessage(LANG_POOL_GO_LIST_CHAT, itr.guid, PrepareStringNpcOrGoSpawnInformation<GameObject>(itr.guid).c_str(),
                             itr.guid, info->name, data->posX, data->posY, data->posZ, data->mapid, active);
@@ -4811,7 +4815,6 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
     }
 
     PoolGroup<Pool> const& poolPools = sPoolMgr.GetPoolPools(pool_id);
-    SpawnedPoolPools const* poolSpawns = spawns ? &spawns->GetSpawnedPools() : nullptr;
 
     PoolObjectList const& poolPoolsEx = poolPools.GetExplicitlyChanced();
     if (!poolPoolsEx.empty())
@@ -4820,7 +4823,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
         for (auto itr : poolPoolsEx)
         {
             PoolTemplateData const& itr_template = sPoolMgr.GetPoolTemplate(itr.guid);
-            char const* active = poolSpawns && poolSpawns->find(itr.guid) != poolSpawns->end() ? active_str.c_str() : "";
+            char const* active = spawns && spawns->IsSpawnedObject<Pool>(itr.guid) ? active_str.c_str() : "";
             if (m_session)
                 PSendSysMessage(LANG_POOL_CHANCE_POOL_LIST_CHAT, itr.guid,
                     itr.guid, itr_template.description.c_str(), itr_template.AutoSpawn ? 1 : 0, itr_template.MaxLimit,
@@ -4841,7 +4844,7 @@ bool ChatHandler::HandlePoolInfoCommand(char* args)
         for (auto itr : poolPoolsEq)
         {
             PoolTemplateData const& itr_template = sPoolMgr.GetPoolTemplate(itr.guid);
-            char const* active = poolSpawns && poolSpawns->find(itr.guid) != poolSpawns->end() ? active_str.c_str() : "";
+            char const* active = spawns && spawns->IsSpawnedObject<Pool>(itr.guid) ? active_str.c_str() : "";
             if (m_session)
                 PSendSysMessage(LANG_POOL_POOL_LIST_CHAT, itr.guid,
                     itr.guid, itr_template.description.c_str(), itr_template.AutoSpawn ? 1 : 0, itr_template.MaxLimit,
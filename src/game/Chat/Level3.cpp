@@ -60,6 +60,9 @@
 #ifdef BUILD_METRICS
 #include "Metric/Metric.h"
 #endif
+#ifdef BUILD_PLAYERBOT
+#include "PlayerBot/Base/PlayerbotMgr.h"
+#endif
 #include "Server/PacketLog.h"
 
 #ifdef BUILD_AHBOT
@@ -220,6 +223,13 @@ bool ChatHandler::HandleReloadAllAreaCommand(char* /*args*/)
 
 bool ChatHandler::HandleReloadAllLootCommand(char* /*args*/)
 {
+    if (IsLootTemplatesReloadRunning())
+    {
+        SendSysMessage("Another loot table is still being reloaded, try again later.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
     sLog.outString("Re-Loading Loot Tables...");
     LootIdSet ids_set;
     LoadLootTables(ids_set);
@@ -335,6 +345,9 @@ bool ChatHandler::HandleReloadConfigCommand(char* /*args*/)
     sLog.outString("Re-Loading config settings...");
     sWorld.LoadConfigSettings(true);
     sMapMgr.InitializeVisibilityDistanceInfo();
+#ifdef BUILD_PLAYERBOT
+    PlayerbotMgr::ReloadConfig();
+#endif
 #ifdef BUILD_METRICS
     metric::metric::instance().reload_config();
 #endif
@@ -482,115 +495,114 @@ bool ChatHandler::HandleReloadQuestTemplateCommand(char* /*args*/)
 
 bool ChatHandler::HandleReloadLootTemplatesCreatureCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`creature_loot_template`)");
-    LoadLootTemplates_Creature();
-    LootTemplates_Creature.CheckLootRefs();
-    SendGlobalSysMessage("DB table `creature_loot_template` reloaded.");
-    return true;
+    return ReloadLootStoreInBackground(LootTemplates_Creature, &LoadLootTemplates_Creature);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesDisenchantCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`disenchant_loot_template`)");
-    LoadLootTemplates_Disenchant();
-    LootTemplates_Disenchant.CheckLootRefs();
-    SendGlobalSysMessage("DB table `disenchant_loot_template` reloaded.");
-    return true;
+    return ReloadLootStoreInBackground(LootTemplates_Disenchant, &LoadLootTemplates_Disenchant);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesFishingCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`fishing_loot_template`)");
-    LoadLootTemplates_Fishing();
-    LootTemplates_Fishing.CheckLootRefs();
-    SendGlobalSysMessage("DB table `fishing_loot_template` reloaded.");
-    return true;
+    return ReloadLootStoreInBackground(LootTemplates_Fishing, &LoadLootTemplates_Fishing);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesGameobjectCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`gameobject_loot_template`)");
-    LoadLootTemplates_Gameobject();
-    LootTemplates_Gameobject.CheckLootRefs();
-    SendGlobalSysMessage("DB table `gameobject_loot_template` reloaded.");
-    return true;
+    return ReloadLootStoreInBackground(LootTemplates_Gameobject, &LoadLootTemplates_Gameobject);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesItemCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`item_loot_template`)");
-    LoadLootTemplates_Item();
-    LootTemplates_Item.CheckLootRefs();
-    SendGlobalSysMessage("DB table `item_loot_template` reloaded.");
-    return true;
+    return ReloadLootStoreInBackground(LootTemplates_Item, &LoadLootTemplates_Item);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesMillingCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`milling_loot_template`)");
-    LoadLootTemplates_Milling();
-    LootTemplates_Milling.CheckLootRefs();
-    SendGlobalSysMessage("DB table `milling_loot_template` reloaded.");
-    return true;
+    return ReloadLootStoreInBackground(LootTemplates_Milling, &LoadLootTemplates_Milling);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesPickpocketingCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`pickpocketing_loot_template`)");
-    LoadLootTemplates_Pickpocketing();
-    LootTemplates_Pickpocketing.CheckLootRefs();
-    SendGlobalSysMessage("DB table `pickpocketing_loot_template` reloaded.");
-    return true;
+    return ReloadLootStoreInBackground(LootTemplates_Pickpocketing, &LoadLootTemplates_Pickpocketing);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesProspectingCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`prospecting_loot_template`)");
-    LoadLootTemplates_Prospecting();
-    LootTemplates_Prospecting.CheckLootRefs();
-    SendGlobalSysMessage("DB table `prospecting_loot_template` reloaded.");
-    return true;
+    return ReloadLootStoreInBackground(LootTemplates_Prospecting, &LoadLootTemplates_Prospecting);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesMailCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`mail_loot_template`)");
-    LoadLootTemplates_Mail();
-    LootTemplates_Mail.CheckLootRefs();
-    SendGlobalSysMessage("DB table `mail_loot_template` reloaded.");
-    return true;
+    return ReloadLootStoreInBackground(LootTemplates_Mail, &LoadLootTemplates_Mail);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesReferenceCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`reference_loot_template`)");
-    LootIdSet ids_set;
-    LoadLootTemplates_Reference(ids_set);
-    CheckLootTemplates_Reference(ids_set);
-    SendGlobalSysMessage("DB table `reference_loot_template` reloaded.");
+    std::shared_ptr<LootIdSet> ids_set = std::make_shared<LootIdSet>();
+    if (!ReloadLootTemplatesInBackground(LootTemplates_Reference, [ids_set]() { LoadLootTemplates_Reference(*ids_set); }, [ids_set]()
+    {
+        CheckLootTemplates_Reference(*ids_set);
+
+        WorldPacket data;
+        ChatHandler::BuildChatPacket(data, CHAT_MSG_SYSTEM, "DB table `reference_loot_template` reloaded.");
+        sWorld.SendGlobalMessage(data);
+    }))
+    {
+        SendSysMessage("Another loot table is still being reloaded, try again later.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    SendSysMessage("Reloading `reference_loot_template` in the background.");
     return true;
 }
 
-bool ChatHandler::HandleReloadLootTemplatesSkinningCommand(char* /*args*/)
+// Loads the table off the world thread and swaps it in between two ticks, see ReloadLootTemplatesInBackground
+bool ChatHandler::ReloadLootStoreInBackground(LootStore& store, void (*loader)())
 {
-    sLog.outString("Re-Loading Loot Tables... (`skinning_loot_template`)");
-    LoadLootTemplates_Skinning();
-    LootTemplates_Skinning.CheckLootRefs();
-    SendGlobalSysMessage("DB table `skinning_loot_template` reloaded.");
+    sLog.outString("Re-Loading Loot Tables... (`%s`)", store.GetName());
+    if (!ReloadLootTemplatesInBackground(store, loader, [&store]()
+    {
+        store.CheckLootRefs();
+
+        std::string text = std::string("DB table `") + store.GetName() + "` reloaded.";
+        WorldPacket data;
+        ChatHandler::BuildChatPacket(data, CHAT_MSG_SYSTEM, text.c_str());
+        sWorld.SendGlobalMessage(data);
+    }))
+    {
+        SendSysMessage("Another loot table is still being reloaded, try again later.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Reloading `%s` in the background.", store.GetName());
     return true;
 }
 
+bool ChatHandler::HandleReloadLootTemplatesSkinningCommand(char* /*args*/)
+{
+    return ReloadLootStoreInBackground(LootTemplates_Skinning, &LoadLootTemplates_Skinning);
+}
+
 bool ChatHandler::HandleReloadLootTemplatesSpellCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`spell_loot_template`)");
-    LoadLootTemplates_Spell();
-    LootTemplates_Spell.CheckLootRefs();
-    SendGlobalSysMessage("DB table `spell_loot_template` reloaded.");
-    return true;
+    return ReloadLootStoreInBackground(LootTemplates_Spell, &LoadLootTemplates_Spell);
 }
 
 bool ChatHandler::HandleReloadMangosStringCommand(char* /*args*/)
 {
+    // console commands answered outside the world thread read the strings
+    if (sWorld.IsCliReadOnlyCommandRunning())
+    {
+        SendSysMessage("Console commands are still being answered, try again later.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
     sLog.outString("Re-Loading mangos_string Table!");
     sObjectMgr.LoadMangosStrings();
     SendGlobalSysMessage("DB table `mangos_string` reloaded.");
@@ -3651,6 +3663,7 @@ bool ChatHandler::HandleGuildRankCommand(char* args)
     else
         slot->ChangeRank(newrank);
 
+    targetGuild->InvalidateRoster();
     return true;
 }
 
@@ -5070,6 +5083,7 @@ static bool HandleResetStatsOrLevelHelper(Player* player)
 
     player->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, DEFAULT_WORLD_OBJECT_SIZE);
     player->SetFloatValue(UNIT_FIELD_COMBATREACH, 1.5f);
+    player->UpdateGridPosition();
 
     player->setFactionForRace(player->getRace());
 
@@ -5314,9 +5328,10 @@ bool ChatHandler::HandleResetAllCommand(char* args)
     }
 
     CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '%u' WHERE (at_login & '%u') = '0'", atLogin, atLogin);
-    HashMapHolder<Player>::MapType const& plist = sObjectAccessor.GetPlayers();
-    for (const auto& itr : plist)
-        itr.second->SetAtLoginFlag(atLogin);
+    sObjectAccessor.ExecuteOnAllPlayers([atLogin](Player* player)
+    {
+        player->SetAtLoginFlag(atLogin);
+    });
 
     return true;
 }
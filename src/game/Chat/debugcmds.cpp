@@ -36,6 +36,11 @@
 #include "Cinematics/M2Stores.h"
 #include "Entities/Transports.h"
 #include "World/World.h"
+#include "Server/OpcodeProfiler.h"
+#include "World/TickProfiler.h"
+#include "World/TickPacer.h"
+#include "Maps/MapCostSampler.h"
+#include "Config/Config.h"
 
 bool ChatHandler::HandleDebugSendSpellFailCommand(char* args)
 {
@@ -432,6 +437,37 @@ bool ChatHandler::HandleDebugGetLootRecipientCommand(char* /*args*/)
     return true;
 }
 
+bool ChatHandler::HandleDebugCreatureMemoryCommand(char* /*args*/)
+{
+    Creature* target = getSelectedCreature();
+    if (!target)
+        return false;
+
+    // node sizes are estimated as the element plus the usual three tree pointers and color, or two list pointers
+    size_t const mapNodeOverhead = 4 * sizeof(void*);
+    size_t const listNodeOverhead = 2 * sizeof(void*);
+
+    size_t const objectBytes = sizeof(Creature);
+    size_t const valuesBytes = target->GetValuesCount() * sizeof(uint32) + ((target->GetValuesCount() + 31) / 32) * sizeof(uint32);
+
+    CreatureSpellList const& spellList = target->GetSpellList();
+    size_t const spellListBytes = sizeof(CreatureSpellList) + spellList.Spells.size() * (sizeof(std::pair<uint32 const, CreatureSpellListSpell>) + mapNodeOverhead);
+
+    size_t vendorBytes = 0;
+    if (VendorItemCounts const* counts = target->GetVendorItemCounts())
+        vendorBytes = sizeof(VendorItemCounts) + counts->size() * (sizeof(VendorItemCount) + listNodeOverhead);
+
+    size_t const ownBytes = objectBytes + valuesBytes + vendorBytes + (target->HasOwnSpellList() ? spellListBytes : 0);
+
+    PSendSysMessage("%s uses about " SIZEFMTD " bytes of its own", target->GetGuidStr().c_str(), ownBytes);
+    PSendSysMessage("object: " SIZEFMTD ", update fields: " SIZEFMTD ", vendor counts: " SIZEFMTD, objectBytes, valuesBytes, vendorBytes);
+    PSendSysMessage("spell list %u: " SIZEFMTD " bytes, %s", spellList.Id, spellListBytes, target->HasOwnSpellList() ? "own copy" : "shared with the template");
+
+    SlabPool::Stats const poolStats = target->GetMap()->GetObjectPool().GetStats();
+    PSendSysMessage("map object pool: " UI64FMTD " allocated, " UI64FMTD " reused, " UI64FMTD " cached", poolStats.allocated, poolStats.reused, poolStats.cached);
+    return true;
+}
+
 bool ChatHandler::HandleDebugSendQuestInvalidMsgCommand(char* args)
 {
     uint32 msg = std::stoul(args);
@@ -1853,6 +1889,243 @@ bool ChatHandler::HandleDebugIncPacketHistory(char* args)
     return true;
 }
 
+bool ChatHandler::HandleDebugOpcodesCommand(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        sOpcodeProfiler.Reset();
+        SendSysMessage("Opcode profile reset.");
+        return true;
+    }
+
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10))
+        return false;
+
+    if (!sWorld.getConfig(CONFIG_BOOL_OPCODE_PROFILING))
+        SendSysMessage("Opcode profiling is disabled (Network.OpcodeProfiling), showing previously recorded data.");
+
+    static char const* const threadNames[MAX_OPCODE_PROFILE_THREAD] = { "world", "map" };
+    std::vector<OpcodeLatencySummary> const summaries = sOpcodeProfiler.GetSummaries();
+    PSendSysMessage("Opcode handlers by total time (us): count p50 p99 max wall cpu");
+    for (size_t i = 0; i < summaries.size() && i < count; ++i)
+    {
+        OpcodeLatencySnapshot const& data = summaries[i].data;
+        PSendSysMessage("%s [%s]: " UI64FMTD " %u %u %u " UI64FMTD " " UI64FMTD, LookupOpcodeName(summaries[i].opcode), threadNames[summaries[i].thread],
+                        data.count, data.GetPercentile(0.5f), data.GetPercentile(0.99f), data.maxTime, data.wallTime, data.cpuTime);
+    }
+    return true;
+}
+
+bool ChatHandler::HandleDebugTickProfileCommand(char* args)
+{
+    uint32 ticks;
+    if (!ExtractOptUInt32(&args, ticks, 100))
+        return false;
+
+    if (!ticks || ticks > 10000)
+    {
+        SendSysMessage("Between 1 and 10000 ticks can be recorded.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    // the trace always goes to the logs directory
+    std::string name;
+    if (char* fileName = ExtractQuotedOrLiteralArg(&args))
+        name = fileName;
+    else
+        name = "tickprofile_" + std::to_string(uint64(time(nullptr))) + ".json";
+
+    if (name.find_first_of("/\\") != std::string::npos || name.find("..") != std::string::npos)
+    {
+        SendSysMessage("The file name must not contain a path.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    std::string path = sConfig.GetStringDefault("LogsDir", "");
+    if (!path.empty() && path.back() != '/' && path.back() != '\\')
+        path.push_back('/');
+    path += name;
+
+    if (!sTickProfiler.Start(ticks, path))
+    {
+        SendSysMessage("A tick profile is already being recorded.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Recording the next %u ticks to %s, open it in chrome://tracing or ui.perfetto.dev.", ticks, path.c_str());
+    return true;
+}
+
+bool ChatHandler::HandleDebugTickPacerCommand(char* /*args*/)
+{
+    PSendSysMessage("World ticks (last %u): p50 %u ms, p90 %u ms, p95 %u ms, p99 %u ms", sTickPacer.GetTickCount(),
+                    sTickPacer.GetPercentile(50), sTickPacer.GetPercentile(90), sTickPacer.GetPercentile(95), sTickPacer.GetPercentile(99));
+    PSendSysMessage("Tick period %u ms (TickPacer.MaxInterval %u), movement step %u ms, non-critical updates %s (TickPacer.DegradeThreshold %u ms)",
+                    sTickPacer.GetLastPeriod(), sWorld.getConfig(CONFIG_UINT32_TICK_PACER_MAX_INTERVAL), sWorld.getConfig(CONFIG_UINT32_TICK_PACER_MOVEMENT_STEP),
+                    sTickPacer.IsDegraded() ? "deferred" : "on time", sWorld.getConfig(CONFIG_UINT32_TICK_PACER_DEGRADE_THRESHOLD));
+    return true;
+}
+
+bool ChatHandler::HandleDebugMapCostCommand(char* args)
+{
+    MapCostSampler& sampler = m_session->GetPlayer()->GetMap()->GetCostSampler();
+
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        sampler.Reset();
+        SendSysMessage("Sampled object update costs of this map cleared.");
+        return true;
+    }
+
+    if (ExtractLiteralArg(&args, "interval"))
+    {
+        uint32 interval;
+        if (!ExtractUInt32(&args, interval))
+            return false;
+
+        sWorld.setConfig(CONFIG_UINT32_MAP_COST_SAMPLE_INTERVAL, interval);
+        if (interval)
+            PSendSysMessage("Object updates of all maps are timed every %u ticks.", interval);
+        else
+            SendSysMessage("Object update sampling disabled.");
+        return true;
+    }
+
+    uint32 top;
+    if (!ExtractOptUInt32(&args, top, 5))
+        return false;
+
+    MapCostSampler::Snapshot snapshot;
+    sampler.GetSnapshot(snapshot);
+    if (!snapshot.ticks)
+    {
+        PSendSysMessage("No sampled ticks on this map, sampling interval is %u (.debug mapcost interval #ticks).",
+                        sWorld.getConfig(CONFIG_UINT32_MAP_COST_SAMPLE_INTERVAL));
+        return true;
+    }
+
+    PSendSysMessage("Map %u, %u sampled ticks, cost in ms per sampled tick:", m_session->GetPlayer()->GetMapId(), snapshot.ticks);
+
+    auto Print = [&](char const* label, MapCostSampler::Cost const& cost)
+    {
+        PSendSysMessage("  %s: %.3f ms, %u updates, max %.3f ms", label, cost.total / 1000000.0 / snapshot.ticks, cost.samples, cost.max / 1000000.0);
+    };
+
+    SendSysMessage("Zones:");
+    for (uint32 i = 0; i < top && i < snapshot.zones.size(); ++i)
+    {
+        AreaTableEntry const* zoneEntry = GetAreaEntryByAreaID(snapshot.zones[i].first);
+        std::string const label = std::string(zoneEntry ? zoneEntry->area_name[GetSessionDbcLocale()] : "<unknown>") + " (" + std::to_string(snapshot.zones[i].first) + ")";
+        Print(label.c_str(), snapshot.zones[i].second);
+    }
+
+    SendSysMessage("Grids:");
+    for (uint32 i = 0; i < top && i < snapshot.grids.size(); ++i)
+    {
+        std::string const label = "grid[" + std::to_string(snapshot.grids[i].first / MAX_NUMBER_OF_GRIDS) + "," + std::to_string(snapshot.grids[i].first % MAX_NUMBER_OF_GRIDS) + "]";
+        Print(label.c_str(), snapshot.grids[i].second);
+    }
+
+    SendSysMessage("Entries:");
+    for (uint32 i = 0; i < top && i < snapshot.entries.size(); ++i)
+    {
+        uint32 const entry = uint32(snapshot.entries[i].first);
+        std::string label;
+        switch (uint32(snapshot.entries[i].first >> 32))
+        {
+            case TYPEID_PLAYER:
+                label = "players";
+                break;
+            case TYPEID_UNIT:
+            {
+                CreatureInfo const* info = ObjectMgr::GetCreatureTemplate(entry);
+                label = "creature " + std::to_string(entry) + " " + (info ? info->Name : "<unknown>");
+                break;
+            }
+            case TYPEID_GAMEOBJECT:
+            {
+                GameObjectInfo const* info = ObjectMgr::GetGameObjectInfo(entry);
+                label = "gameobject " + std::to_string(entry) + " " + (info ? info->name : "<unknown>");
+                break;
+            }
+            default:
+                label = "object " + std::to_string(entry);
+                break;
+        }
+        Print(label.c_str(), snapshot.entries[i].second);
+    }
+
+    SendSysMessage("AI and scripts:");
+    for (uint32 i = 0; i < top && i < snapshot.scripts.size(); ++i)
+        Print(snapshot.scripts[i].first.c_str(), snapshot.scripts[i].second);
+
+    return true;
+}
+
+bool ChatHandler::HandleDebugQueriesCommand(char* args)
+{
+    char* dbName = ExtractLiteralArg(&args);
+    if (!dbName)
+        return false;
+
+    std::pair<char const*, Database*> const databases[] = { {"world", &WorldDatabase}, {"character", &CharacterDatabase}, {"login", &LoginDatabase}, {"logs", &LogsDatabase} };
+    // a full name always wins, a prefix only when it names a single database ("l" is login or logs)
+    Database* database = nullptr;
+    uint32 prefixMatches = 0;
+    for (auto const& entry : databases)
+    {
+        if (strcmp(dbName, entry.first) == 0)
+        {
+            database = entry.second;
+            prefixMatches = 1;
+            break;
+        }
+        if (strncmp(dbName, entry.first, strlen(dbName)) == 0)
+        {
+            database = entry.second;
+            ++prefixMatches;
+        }
+    }
+
+    if (prefixMatches > 1)
+    {
+        PSendSysMessage("Database name '%s' is ambiguous, use world, character, login or logs.", dbName);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    if (!database)
+        return false;
+
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        database->GetQueryProfiler().Reset();
+        SendSysMessage("Query profile reset.");
+        return true;
+    }
+
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10))
+        return false;
+
+    if (!database->GetQueryProfiler().IsEnabled())
+        SendSysMessage("Query profiling is disabled (SQLProfiling), showing previously recorded data.");
+
+    std::vector<SqlQuerySummary> const summaries = database->GetQueryProfiler().GetSummaries();
+    PSendSysMessage("Statements by total time (us): id count p50 p99 max total rows");
+    for (size_t i = 0; i < summaries.size() && i < count; ++i)
+    {
+        SqlQueryStats const& data = summaries[i].data;
+        PSendSysMessage("%08X " UI64FMTD " %u %u %u " UI64FMTD " " UI64FMTD ": %s", summaries[i].id,
+                        data.count, data.GetPercentile(0.5f), data.GetPercentile(0.99f), data.maxTime, data.totalTime, data.rows, summaries[i].query.c_str());
+    }
+    return true;
+}
+
 bool ChatHandler::HandleDebugTransports(char* args)
 {
     Player* player = GetSession()->GetPlayer();
@@ -143,6 +143,7 @@ void HostileRefManager::updateThreatTables()
 
 void HostileRefManager::deleteReferences()
 {
+    ThreatContainer::BulkRemoveScope bulkRemove;
     HostileReference* ref = getFirst();
     while (ref)
     {
@@ -158,6 +159,7 @@ void HostileRefManager::deleteReferences()
 
 void HostileRefManager::deleteReferencesForFaction(uint32 faction)
 {
+    ThreatContainer::BulkRemoveScope bulkRemove;
     HostileReference* ref = getFirst();
     while (ref)
     {
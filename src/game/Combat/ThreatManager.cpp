@@ -90,6 +90,7 @@ HostileReference::HostileReference(Unit* unit, ThreatManager* threatManager, flo
     m_online = true;
     m_suppresabilityToggle = false;
     iAccessible = true;
+    m_threatListIndex = 0;
 }
 
 //============================================================
@@ -227,16 +228,78 @@ Unit* HostileReference::getSourceUnit() const
 //================ ThreatContainer ===========================
 //============================================================
 
+thread_local uint32 ThreatContainer::s_bulkRemoveDepth = 0;
+thread_local std::vector<ThreatContainer*> ThreatContainer::s_pendingCompaction;
+
+ThreatContainer::BulkRemoveScope::~BulkRemoveScope()
+{
+    if (--s_bulkRemoveDepth)
+        return;
+
+    for (ThreatContainer* container : s_pendingCompaction)
+        container->compact();
+    s_pendingCompaction.clear();
+}
+
+ThreatContainer::~ThreatContainer()
+{
+    clearReferences();
+
+    if (iHoles)
+        s_pendingCompaction.erase(std::remove(s_pendingCompaction.begin(), s_pendingCompaction.end(), this), s_pendingCompaction.end());
+}
+
 void ThreatContainer::clearReferences()
 {
     for (ThreatList::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
     {
+        if (!*i)
+            continue;
         (*i)->unlink();
         delete (*i);
     }
     iThreatList.clear();
 }
 
+//============================================================
+// Remove the reference if it is in this container, order of the others is kept
+
+void ThreatContainer::remove(HostileReference* ref)
+{
+    size_t index = ref->m_threatListIndex;
+    if (index >= iThreatList.size() || iThreatList[index] != ref)
+        return;
+
+    if (s_bulkRemoveDepth)
+    {
+        iThreatList[index] = nullptr;
+        if (!iHoles)
+        {
+            iHoles = true;
+            s_pendingCompaction.push_back(this);
+        }
+        return;
+    }
+
+    iThreatList.erase(iThreatList.begin() + index);
+    for (; index < iThreatList.size(); ++index)
+        iThreatList[index]->m_threatListIndex = index;
+}
+
+void ThreatContainer::compact()
+{
+    size_t count = 0;
+    for (HostileReference* ref : iThreatList)
+    {
+        if (!ref)
+            continue;
+        ref->m_threatListIndex = count;
+        iThreatList[count++] = ref;
+    }
+    iThreatList.resize(count);
+    iHoles = false;
+}
+
 //============================================================
 // Return the HostileReference of nullptr, if not found
 
@@ -288,17 +351,22 @@ void ThreatContainer::modifyAllThreatPercent(int32 threatPercent)
 {
     if (threatPercent < -100)
     {
-        while (!iThreatList.empty())
+        BulkRemoveScope bulkRemove;
+        for (size_t i = 0; i < iThreatList.size(); ++i)
         {
-            HostileReference* ref = *iThreatList.begin();
-            ref->removeReference();
-            delete ref;
+            if (HostileReference* ref = iThreatList[i])
+            {
+                ref->removeReference();
+                delete ref;
+            }
         }
     }
     else
     {
-        for (auto itr : iThreatList)
-            itr->addThreatPercent(threatPercent);
+        // changing the threat can move the reference to the offline container
+        ThreatList const refs = iThreatList;
+        for (auto ref : refs)
+            ref->addThreatPercent(threatPercent);
     }
 }
 //============================================================
@@ -308,7 +376,7 @@ void ThreatContainer::update(bool force, bool isPlayer)
 {
     if ((iDirty || force || isPlayer) && iThreatList.size() > 1)
     {
-        iThreatList.sort([&](const HostileReference* lhs, const HostileReference* rhs)->bool
+        auto comparator = [&](const HostileReference* lhs, const HostileReference* rhs)->bool
         {
             Unit* owner = lhs->getSource()->getOwner();
             if (isPlayer)
@@ -338,7 +406,30 @@ void ThreatContainer::update(bool force, bool isPlayer)
             if (lhs->GetHostileState() != rhs->GetHostileState())
                 return lhs->GetHostileState() > rhs->GetHostileState();
             return lhs->getThreat() > rhs->getThreat(); // reverse sorting
-        });
+        };
+
+        // between two updates only a few references change their place, insertion keeps that close to one
+        // comparison per reference and falls back to a full sort once too much has moved, both are stable
+        size_t const maxMoves = iThreatList.size() * 2;
+        size_t moves = 0;
+        for (size_t i = 1; i < iThreatList.size(); ++i)
+        {
+            HostileReference* ref = iThreatList[i];
+            size_t j = i;
+            for (; j > 0 && comparator(ref, iThreatList[j - 1]); --j)
+                iThreatList[j] = iThreatList[j - 1];
+            iThreatList[j] = ref;
+
+            moves += i - j;
+            if (moves > maxMoves)
+            {
+                std::stable_sort(iThreatList.begin(), iThreatList.end(), comparator);
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < iThreatList.size(); ++i)
+            iThreatList[i]->m_threatListIndex = i;
     }
     iDirty = false;
 }
@@ -758,6 +849,8 @@ void ThreatManager::DeleteOutOfRangeReferences()
     for (auto& ref : iThreatOfflineContainer.getThreatList())
         if (ref->isValid() && ref->getTarget()->GetDistance(getOwner(), true, DIST_CALC_COMBAT_REACH) > 60.f)
             m_refs.push_back(ref);
+
+    ThreatContainer::BulkRemoveScope bulkRemove;
     for (auto& ref : m_refs)
     {
         ref->removeReference();
@@ -25,7 +25,7 @@
 #include "Entities/UnitEvents.h"
 #include "Util/Timer.h"
 #include "Entities/ObjectGuid.h"
-#include <list>
+#include <vector>
 
 //==============================================================
 
@@ -129,6 +129,8 @@ class HostileReference : public Reference<Unit, ThreatManager>
         void SetTauntState(TauntState state) { m_tauntState = state; }
         TauntState GetTauntState() const { return m_tauntState; }
     protected:
+        friend class ThreatContainer;
+
         // Inform the source, that the status of that reference was changed
         void fireStatusChanged(ThreatRefStatusChangeEvent& threatRefStatusChangeEvent);
 
@@ -142,18 +144,28 @@ class HostileReference : public Reference<Unit, ThreatManager>
         ObjectGuid iUnitGuid;
         bool m_online;
         bool iAccessible;
+        size_t m_threatListIndex;                           // position in the ThreatContainer holding the reference
 };
 
 //==============================================================
 class ThreatManager;
 
-typedef std::list<HostileReference*> ThreatList;
+typedef std::vector<HostileReference*> ThreatList;
 
 class ThreatContainer
 {
     public:
-        ThreatContainer() { iDirty = false; }
-        ~ThreatContainer() { clearReferences(); }
+        // While a scope lives, removals only clear their slot and every touched container
+        // is compacted once when the outermost scope ends, instead of shifting the list per removal
+        class BulkRemoveScope
+        {
+            public:
+                BulkRemoveScope() { ++s_bulkRemoveDepth; }
+                ~BulkRemoveScope();
+        };
+
+        ThreatContainer() : iDirty(false), iHoles(false) {}
+        ~ThreatContainer();
 
         HostileReference* addThreat(Unit* victim, float threat);
 
@@ -176,15 +188,26 @@ class ThreatContainer
     protected:
         friend class ThreatManager;
 
-        void remove(HostileReference* ref) { iThreatList.remove(ref); }
-        void addReference(HostileReference* hostileReference) { iThreatList.push_back(hostileReference); }
+        void remove(HostileReference* ref);
+        void addReference(HostileReference* hostileReference)
+        {
+            hostileReference->m_threatListIndex = iThreatList.size();
+            iThreatList.push_back(hostileReference);
+        }
         void clearReferences();
         // Sort the list if necessary
         void update(bool force, bool isPlayer);
 
         ThreatList iThreatList;
     private:
+        // drop the slots cleared by a bulk removal, order of the others is kept
+        void compact();
+
         bool iDirty;
+        bool iHoles;
+
+        static thread_local uint32 s_bulkRemoveDepth;
+        static thread_local std::vector<ThreatContainer*> s_pendingCompaction;
 };
 
 //=================================================
@@ -235,7 +258,8 @@ class ThreatManager
         void setDirty(bool dirty) { iThreatContainer.setDirty(dirty); }
 
         // Don't must be used for explicit modify threat values in iterator return pointers
-        ThreatList const& getThreatList() const { return iThreatContainer.getThreatList(); }
+        // a copy, callers add threat or change online states while iterating and the vector would move under them
+        ThreatList getThreatList() const { return iThreatContainer.getThreatList(); }
 
         void DeleteOutOfRangeReferences();
 
@@ -638,17 +638,20 @@ void ScriptMgr::LoadScripts(ScriptMapMapName& scripts, const char* tablename)
                 if (!sLog.HasLogFilter(LOG_FILTER_DB_STRICTED_CHECK))
                 {
                     uint32 taxiSpell = 0;
-                    for (uint32 i = 1; i < sSpellTemplate.GetMaxEntry() && taxiSpell == 0; ++i)
+                    for (uint32 spellId : sSpellMgr.GetSpellsWithEffect(SPELL_EFFECT_SEND_TAXI))
                     {
-                        if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(i))
-                            for (int j = 0; j < MAX_EFFECT_INDEX; ++j)
+                        SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(spellId);
+                        for (int j = 0; j < MAX_EFFECT_INDEX; ++j)
+                        {
+                            if (spell->Effect[j] == SPELL_EFFECT_SEND_TAXI && spell->EffectMiscValue[j] == int32(tmp.sendTaxiPath.taxiPathId))
                             {
-                                if (spell->Effect[j] == SPELL_EFFECT_SEND_TAXI && spell->EffectMiscValue[j] == int32(tmp.sendTaxiPath.taxiPathId))
-                                {
-                                    taxiSpell = i;
-                                    break;
-                                }
+                                taxiSpell = spellId;
+                                break;
                             }
+                        }
+
+                        if (taxiSpell)
+                            break;
                     }
 
                     if (taxiSpell)
@@ -1584,6 +1587,11 @@ bool ScriptAction::HandleScriptStep()
         WorldObject* pTarget = data.second;
         Object* pSourceOrItem = pSource ? pSource : itemSource;
 
+        // scripted creatures must not lag behind their script by a dormant update interval
+        for (WorldObject* object : { pSource, pTarget })
+            if (object && object->IsCreature())
+                static_cast<Creature*>(object)->WakeFromDormancy();
+
         bool result = ExecuteDbscriptCommand(pSource, pTarget, pSourceOrItem);
         if (result == true)
             finalResult = true;
@@ -1818,7 +1826,7 @@ bool ScriptAction::ExecuteDbscriptCommand(WorldObject* pSource, WorldObject* pTa
             {
                 WorldObject* pSearcher = pRewardSource ? pRewardSource : (pSource ? pSource : pTarget);
                 if (pSearcher != pRewardSource)
-                    sLog.outDebug(" DB-SCRIPTS: Process table `%s` id %u, SCRIPT_COMMAND_KILL_CREDIT called for groupCredit without creature as searcher, script might need adjustment.", m_table, m_script->id);
+                    DEBUG_LOG(" DB-SCRIPTS: Process table `%s` id %u, SCRIPT_COMMAND_KILL_CREDIT called for groupCredit without creature as searcher, script might need adjustment.", m_table, m_script->id);
                 pPlayer->RewardPlayerAndGroupAtEventCredit(creatureEntry, pSearcher);
             }
             else
@@ -2615,14 +2623,14 @@ bool ScriptAction::ExecuteDbscriptCommand(WorldObject* pSource, WorldObject* pTa
                 return false;
             if (!pTarget)
             {
-                sLog.outDebug(" DB-SCRIPTS: Process table `%s` id %u, SCRIPT_COMMAND_MOVE_DYNAMIC called but target doesnt exist: skipping.", m_table, m_script->id);
+                DEBUG_LOG(" DB-SCRIPTS: Process table `%s` id %u, SCRIPT_COMMAND_MOVE_DYNAMIC called but target doesnt exist: skipping.", m_table, m_script->id);
                 return false;
             }
 
             Creature* source = static_cast<Creature*>(pSource);
             if (source->IsInCombat())
             {
-                sLog.outDebug(" DB-SCRIPTS: Process table `%s` id %u, SCRIPT_COMMAND_MOVE_DYNAMIC called for source guid %s but source is in combat and may lead to wrong behaviour: skipping.", m_table, m_script->id, pSource->GetGuidStr().c_str());
+                DEBUG_LOG(" DB-SCRIPTS: Process table `%s` id %u, SCRIPT_COMMAND_MOVE_DYNAMIC called for source guid %s but source is in combat and may lead to wrong behaviour: skipping.", m_table, m_script->id, pSource->GetGuidStr().c_str());
                 break;
             }
 
@@ -3192,18 +3200,15 @@ void ScriptMgr::CollectPossibleEventIds(std::set<uint32>& eventIds)
     }
 
     // Load all possible script entries from spells
-    for (uint32 i = 1; i < sSpellTemplate.GetMaxEntry(); ++i)
+    for (uint32 spellId : sSpellMgr.GetSpellsWithEffect(SPELL_EFFECT_SEND_EVENT))
     {
-        SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(i);
-        if (spell)
+        SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(spellId);
+        for (int j = 0; j < MAX_EFFECT_INDEX; ++j)
         {
-            for (int j = 0; j < MAX_EFFECT_INDEX; ++j)
+            if (spell->Effect[j] == SPELL_EFFECT_SEND_EVENT)
             {
-                if (spell->Effect[j] == SPELL_EFFECT_SEND_EVENT)
-                {
-                    if (spell->EffectMiscValue[j])
-                        eventIds.insert(spell->EffectMiscValue[j]);
-                }
+                if (spell->EffectMiscValue[j])
+                    eventIds.insert(spell->EffectMiscValue[j]);
             }
         }
     }
@@ -150,6 +150,17 @@ void Camera::UpdateVisibilityForOwner(bool addToWorld)
     notifier.Notify();
 }
 
+void Camera::UpdateVisibilityForOwner(MaNGOS::VisibleObjectsCollector const& objects)
+{
+    MaNGOS::VisibleNotifier notifier(*this);
+    notifier.Visit(objects.i_players);
+    notifier.Visit(objects.i_creatures);
+    notifier.Visit(objects.i_corpses);
+    notifier.Visit(objects.i_gameObjects);
+    notifier.Visit(objects.i_dynamicObjects);
+    notifier.Notify();
+}
+
 //////////////////
 
 ViewPoint::~ViewPoint()
@@ -159,3 +170,20 @@ ViewPoint::~ViewPoint()
         sLog.outError("ViewPoint destructor called, but some cameras referenced to it");
     }
 }
+
+void ViewPoint::Call_UpdateVisibilityForOwner()
+{
+    if (m_cameras.size() <= 1)
+    {
+        CameraCall(&Camera::UpdateVisibilityForOwner);
+        return;
+    }
+
+    // all cameras look from the same object, so one grid visit serves them all
+    WorldObject* source = m_cameras.front()->GetBody();
+    MaNGOS::VisibleObjectsCollector objects;
+    Cell::VisitAllObjects(source, objects, source->GetVisibilityData().GetVisibilityDistance(), false);
+
+    for (size_t i = m_cameras.size(); i > 0; --i)
+        m_cameras[i - 1]->UpdateVisibilityForOwner(objects);
+}
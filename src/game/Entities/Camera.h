@@ -27,6 +27,11 @@ class ViewPoint;
 class UpdateData;
 class WorldPacket;
 
+namespace MaNGOS
+{
+    struct VisibleObjectsCollector;
+}
+
 /// Camera - object-receiver. Receives broadcast packets from nearby worldobjects, object visibility changes and sends them to client
 class Camera
 {
@@ -56,6 +61,8 @@ class Camera
         // updates visibility of worldobjects around viewpoint for camera's owner
         void UpdateVisibilityForOwner() { UpdateVisibilityForOwner(false); }
         void UpdateVisibilityForOwner(bool addToWorld);
+        // same, from objects already gathered around the viewpoint
+        void UpdateVisibilityForOwner(MaNGOS::VisibleObjectsCollector const& objects);
 
     private:
         // called when viewpoint changes visibility state
@@ -81,24 +88,24 @@ class ViewPoint
 {
         friend class Camera;
 
-        typedef std::list<Camera*> CameraList;
+        typedef std::vector<Camera*> CameraList;
 
         CameraList m_cameras;
         GridType* m_grid;
 
         void Attach(Camera* c) { m_cameras.push_back(c); }
-        void Detach(Camera* c) { m_cameras.remove(c); }
+        void Detach(Camera* c)
+        {
+            CameraList::iterator itr = std::find(m_cameras.begin(), m_cameras.end(), c);
+            if (itr != m_cameras.end())
+                m_cameras.erase(itr);
+        }
 
         void CameraCall(void (Camera::*handler)())
         {
-            if (!m_cameras.empty())
-            {
-                for (CameraList::iterator itr = m_cameras.begin(); itr != m_cameras.end();)
-                {
-                    Camera* c = *(itr++);
-                    (c->*handler)();
-                }
-            }
+            // backwards, a handler may detach its own camera from this viewpoint
+            for (size_t i = m_cameras.size(); i > 0; --i)
+                (m_cameras[i - 1]->*handler)();
         }
 
     public:
@@ -132,10 +139,7 @@ class ViewPoint
             CameraCall(&Camera::Event_ViewPointVisibilityChanged);
         }
 
-        void Call_UpdateVisibilityForOwner()
-        {
-            CameraCall(&Camera::UpdateVisibilityForOwner);
-        }
+        void Call_UpdateVisibilityForOwner();
 };
 
 #endif
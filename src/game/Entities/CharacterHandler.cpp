@@ -45,6 +45,10 @@
 #include "PlayerBot/Base/PlayerbotMgr.h"
 #endif
 
+#ifdef BUILD_METRICS
+ #include "Metric/Metric.h"
+#endif
+
 // config option SkipCinematics supported values
 enum CinematicsSkipMode
 {
@@ -72,44 +76,82 @@ bool LoginQueryHolder::Initialize()
 
     bool res = true;
 
+    // every query only takes the character guid, run them as prepared statements
+    auto SetGuidQuery = [this](size_t index, SqlStatementID& stmtId, char const* sql)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(stmtId, sql);
+        stmt.addUInt32(m_guid.GetCounter());
+        return SetStmtQuery(index, stmt);
+    };
+
     // NOTE: all fields in `characters` must be read to prevent lost character data at next save in case wrong DB structure.
     // !!! NOTE: including unused `zone`,`online`
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADFROM,            "SELECT guid, account, name, race, class, gender, level, xp, money, playerBytes, playerBytes2, playerFlags,"
-                     "position_x, position_y, position_z, map, orientation, taximask, cinematic, totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost,"
-                     "resettalents_time, trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, online, death_expire_time, taxi_path, dungeon_difficulty,"
-                     "arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, totalKills, todayKills, yesterdayKills, chosenTitle, knownCurrencies, watchedFaction, drunk,"
-                     "health, power1, power2, power3, power4, power5, power6, power7, specCount, activeSpec, exploredZones, equipmentCache, ammoId, knownTitles, actionBars, grantableLevels, fishingSteps FROM characters WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADGROUP,           "SELECT groupId FROM group_member WHERE memberGuid ='%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADBOUNDINSTANCES,  "SELECT id, permanent, map, difficulty, ExtendState, resettime FROM character_instance LEFT JOIN instance ON instance = id WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADAURAS,           "SELECT caster_guid,item_guid,spell,stackcount,remaincharges,basepoints0,basepoints1,basepoints2,periodictime0,periodictime1,periodictime2,maxduration,remaintime,effIndexMask FROM character_aura WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSPELLS,          "SELECT spell,active,disabled FROM character_spell WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADQUESTSTATUS,     "SELECT quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4,itemcount5,itemcount6 FROM character_queststatus WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADDAILYQUESTSTATUS, "SELECT quest FROM character_queststatus_daily WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADWEEKLYQUESTSTATUS, "SELECT quest FROM character_queststatus_weekly WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMONTHLYQUESTSTATUS, "SELECT quest FROM character_queststatus_monthly WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADREPUTATION,      "SELECT faction,standing,flags FROM character_reputation WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADINVENTORY,       "SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, bag, slot, item, item_template FROM character_inventory JOIN item_instance ON character_inventory.item = item_instance.guid WHERE character_inventory.guid = '%u' ORDER BY bag,slot", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADITEMLOOT,        "SELECT guid,itemid,amount,suffix,property FROM item_loot WHERE owner_guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADACTIONS,         "SELECT spec,button,action,type FROM character_action WHERE guid = '%u' ORDER BY button", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSOCIALLIST,      "SELECT friend,flags,note FROM character_social WHERE guid = '%u' LIMIT 255", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADHOMEBIND,        "SELECT map,zone,position_x,position_y,position_z FROM character_homebind WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSPELLCOOLDOWNS,  "SELECT SpellId, SpellExpireTime, Category, CategoryExpireTime, ItemId FROM character_spell_cooldown WHERE guid = '%u'", m_guid.GetCounter());
+    static SqlStatementID loadfrom;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADFROM, loadfrom, "SELECT guid, account, name, race, class, gender, level, xp, money, playerBytes, playerBytes2, playerFlags,"
+                          "position_x, position_y, position_z, map, orientation, taximask, cinematic, totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost,"
+                          "resettalents_time, trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, online, death_expire_time, taxi_path, dungeon_difficulty,"
+                          "arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, totalKills, todayKills, yesterdayKills, chosenTitle, knownCurrencies, watchedFaction, drunk,"
+                          "health, power1, power2, power3, power4, power5, power6, power7, specCount, activeSpec, exploredZones, equipmentCache, ammoId, knownTitles, actionBars, grantableLevels, fishingSteps FROM characters WHERE guid = ?");
+    static SqlStatementID loadgroup;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADGROUP, loadgroup, "SELECT groupId FROM group_member WHERE memberGuid = ?");
+    static SqlStatementID loadboundinstances;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADBOUNDINSTANCES, loadboundinstances, "SELECT id, permanent, map, difficulty, ExtendState, resettime FROM character_instance LEFT JOIN instance ON instance = id WHERE guid = ?");
+    static SqlStatementID loadauras;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADAURAS, loadauras, "SELECT caster_guid,item_guid,spell,stackcount,remaincharges,basepoints0,basepoints1,basepoints2,periodictime0,periodictime1,periodictime2,maxduration,remaintime,effIndexMask FROM character_aura WHERE guid = ?");
+    static SqlStatementID loadspells;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADSPELLS, loadspells, "SELECT spell,active,disabled FROM character_spell WHERE guid = ?");
+    static SqlStatementID loadqueststatus;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADQUESTSTATUS, loadqueststatus, "SELECT quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4,itemcount5,itemcount6 FROM character_queststatus WHERE guid = ?");
+    static SqlStatementID loaddailyqueststatus;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADDAILYQUESTSTATUS, loaddailyqueststatus, "SELECT quest FROM character_queststatus_daily WHERE guid = ?");
+    static SqlStatementID loadweeklyqueststatus;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADWEEKLYQUESTSTATUS, loadweeklyqueststatus, "SELECT quest FROM character_queststatus_weekly WHERE guid = ?");
+    static SqlStatementID loadmonthlyqueststatus;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADMONTHLYQUESTSTATUS, loadmonthlyqueststatus, "SELECT quest FROM character_queststatus_monthly WHERE guid = ?");
+    static SqlStatementID loadreputation;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADREPUTATION, loadreputation, "SELECT faction,standing,flags FROM character_reputation WHERE guid = ?");
+    static SqlStatementID loadinventory;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADINVENTORY, loadinventory, "SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, bag, slot, item, item_template FROM character_inventory JOIN item_instance ON character_inventory.item = item_instance.guid WHERE character_inventory.guid = ? ORDER BY bag,slot");
+    static SqlStatementID loaditemloot;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADITEMLOOT, loaditemloot, "SELECT guid,itemid,amount,suffix,property FROM item_loot WHERE owner_guid = ?");
+    static SqlStatementID loadactions;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADACTIONS, loadactions, "SELECT spec,button,action,type FROM character_action WHERE guid = ? ORDER BY button");
+    static SqlStatementID loadsociallist;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADSOCIALLIST, loadsociallist, "SELECT friend,flags,note FROM character_social WHERE guid = ? LIMIT 255");
+    static SqlStatementID loadhomebind;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADHOMEBIND, loadhomebind, "SELECT map,zone,position_x,position_y,position_z FROM character_homebind WHERE guid = ?");
+    static SqlStatementID loadspellcooldowns;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADSPELLCOOLDOWNS, loadspellcooldowns, "SELECT SpellId, SpellExpireTime, Category, CategoryExpireTime, ItemId FROM character_spell_cooldown WHERE guid = ?");
+    static SqlStatementID loaddeclinednames;
     if (sWorld.getConfig(CONFIG_BOOL_DECLINED_NAMES_USED))
-        res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADDECLINEDNAMES,   "SELECT genitive, dative, accusative, instrumental, prepositional FROM character_declinedname WHERE guid = '%u'", m_guid.GetCounter());
+        res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADDECLINEDNAMES, loaddeclinednames, "SELECT genitive, dative, accusative, instrumental, prepositional FROM character_declinedname WHERE guid = ?");
     // in other case still be dummy query
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADGUILD,           "SELECT guildid, `rank` FROM guild_member WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADARENAINFO,       "SELECT arenateamid, played_week, played_season, wons_season, personal_rating FROM arena_team_member WHERE guid='%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADACHIEVEMENTS,    "SELECT achievement, date FROM character_achievement WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADCRITERIAPROGRESS, "SELECT criteria, counter, date FROM character_achievement_progress WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADEQUIPMENTSETS,   "SELECT setguid, setindex, name, iconname, ignore_mask, item0, item1, item2, item3, item4, item5, item6, item7, item8, item9, item10, item11, item12, item13, item14, item15, item16, item17, item18 FROM character_equipmentsets WHERE guid = '%u' ORDER BY setindex", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADBGDATA,          "SELECT instance_id, team, join_x, join_y, join_z, join_o, join_map, mount_spell FROM character_battleground_data WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADACCOUNTDATA,     "SELECT type, time, data FROM character_account_data WHERE guid='%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADTALENTS,         "SELECT talent_id, current_rank, spec FROM character_talent WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSKILLS,          "SELECT skill, value, max FROM character_skills WHERE guid = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADGLYPHS,          "SELECT spec, slot, glyph FROM character_glyphs WHERE guid='%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILS,           "SELECT id,messageType,sender,receiver,subject,body,expire_time,deliver_time,money,cod,checked,stationery,mailTemplateId,has_items FROM mail WHERE receiver = '%u' ORDER BY id DESC", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILEDITEMS,     "SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, mail_id, item_guid, item_template FROM mail_items JOIN item_instance ON item_guid = guid WHERE receiver = '%u'", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADRANDOMBATTLEGROUND, "SELECT guid FROM character_battleground_random WHERE guid = '%u'", m_guid.GetCounter());
+    static SqlStatementID loadguild;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADGUILD, loadguild, "SELECT guildid, `rank` FROM guild_member WHERE guid = ?");
+    static SqlStatementID loadarenainfo;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADARENAINFO, loadarenainfo, "SELECT arenateamid, played_week, played_season, wons_season, personal_rating FROM arena_team_member WHERE guid = ?");
+    static SqlStatementID loadachievements;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADACHIEVEMENTS, loadachievements, "SELECT achievement, date FROM character_achievement WHERE guid = ?");
+    static SqlStatementID loadcriteriaprogress;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADCRITERIAPROGRESS, loadcriteriaprogress, "SELECT criteria, counter, date FROM character_achievement_progress WHERE guid = ?");
+    static SqlStatementID loadequipmentsets;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADEQUIPMENTSETS, loadequipmentsets, "SELECT setguid, setindex, name, iconname, ignore_mask, item0, item1, item2, item3, item4, item5, item6, item7, item8, item9, item10, item11, item12, item13, item14, item15, item16, item17, item18 FROM character_equipmentsets WHERE guid = ? ORDER BY setindex");
+    static SqlStatementID loadbgdata;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADBGDATA, loadbgdata, "SELECT instance_id, team, join_x, join_y, join_z, join_o, join_map, mount_spell FROM character_battleground_data WHERE guid = ?");
+    static SqlStatementID loadaccountdata;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADACCOUNTDATA, loadaccountdata, "SELECT type, time, data FROM character_account_data WHERE guid = ?");
+    static SqlStatementID loadtalents;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADTALENTS, loadtalents, "SELECT talent_id, current_rank, spec FROM character_talent WHERE guid = ?");
+    static SqlStatementID loadskills;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADSKILLS, loadskills, "SELECT skill, value, max FROM character_skills WHERE guid = ?");
+    static SqlStatementID loadglyphs;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADGLYPHS, loadglyphs, "SELECT spec, slot, glyph FROM character_glyphs WHERE guid = ?");
+    static SqlStatementID loadmails;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADMAILS, loadmails, "SELECT id,messageType,sender,receiver,subject,LENGTH(body),expire_time,deliver_time,money,cod,checked,stationery,mailTemplateId,has_items FROM mail WHERE receiver = ? ORDER BY id DESC");
+    static SqlStatementID loadmaileditems;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADMAILEDITEMS, loadmaileditems, "SELECT mail_id, item_guid, item_template FROM mail_items WHERE receiver = ?");
+    static SqlStatementID loadrandombattleground;
+    res &= SetGuidQuery(PLAYER_LOGIN_QUERY_LOADRANDOMBATTLEGROUND, loadrandombattleground, "SELECT guid FROM character_battleground_random WHERE guid = ?");
 
     return res;
 }
@@ -677,6 +719,12 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
 {
     ObjectGuid playerGuid = holder->GetGuid();
 
+    DETAIL_LOG("HandlePlayerLogin> character data of %s loaded in " UI64FMTD " us", playerGuid.GetString().c_str(), holder->GetExecutionTime());
+#ifdef BUILD_METRICS
+    metric::measurement meas("session.login");
+    meas.add_field("db_time", std::to_string(holder->GetExecutionTime()));
+#endif
+
     Player* pCurrChar = new Player(this);
     SetPlayer(pCurrChar, playerGuid);
     m_playerLoading = true;
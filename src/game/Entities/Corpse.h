@@ -87,8 +87,10 @@ class Corpse : public WorldObject
         bool lootForBody;
 
         GridReference<Corpse>& GetGridRef() { return m_gridRef; }
+        void UpdateGridPosition() override { m_gridRef.UpdatePosition(GetGridObjectPosition()); }
 
-        bool IsExpired(time_t t) const;
+        bool IsExpired(time_t t) const { return GetExpiryTime() < t; }
+        time_t GetExpiryTime() const;
         Team GetTeam() const;
     private:
         GridReference<Corpse> m_gridRef;
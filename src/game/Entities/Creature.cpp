@@ -45,6 +45,7 @@
 #include "Grids/GridNotifiersImpl.h"
 #include "Grids/CellImpl.h"
 #include "Movement/MoveSplineInit.h"
+#include "Movement/MoveSpline.h"
 #include "Entities/CreatureLinkingMgr.h"
 #include "Entities/Transports.h"
 #include "Maps/SpawnManager.h"
@@ -136,6 +137,13 @@ bool CreatureCreatePos::Relocate(Creature* cr) const
     return true;
 }
 
+// until a spell list is set all creatures share one empty list
+static std::shared_ptr<CreatureSpellList const> const& GetEmptySpellList()
+{
+    static std::shared_ptr<CreatureSpellList const> const emptyList = std::make_shared<CreatureSpellList>();
+    return emptyList;
+}
+
 Creature::Creature(CreatureSubtype subtype) : Unit(),
     m_gossipMenuId(0), m_lootMoney(0), m_lootGroupRecipientId(0),
     m_lootStatus(CREATURE_LOOT_STATUS_NONE),
@@ -143,13 +151,14 @@ Creature::Creature(CreatureSubtype subtype) : Unit(),
     m_respawnTime(0), m_respawnDelay(25), m_respawnOverriden(false), m_respawnOverrideOnce(false), m_corpseDelay(60), m_canAggro(false),
     m_respawnradius(5.0f), m_interactionPauseTimer(0), m_subtype(subtype), m_defaultMovementType(IDLE_MOTION_TYPE),
     m_equipmentId(0), m_detectionRange(20.f), m_AlreadyCallAssistance(false), m_canCallForAssistance(true),
-    m_isDeadByDefault(false),
+    m_isDeadByDefault(false), m_isDormant(false), m_dormantDiff(0), m_dormantCheckTimer(0),
     m_temporaryFactionFlags(TEMPFACTION_NONE),
     m_originalEntry(0), m_ai(nullptr),
     m_isInvisible(false), m_ignoreMMAP(false), m_forceAttackingCapability(false), m_countSpawns(false),
     m_creatureInfo(nullptr),
     m_noXP(false), m_noLoot(false), m_noReputation(false), m_noWoundedSlowdown(false), m_ignoringFeignDeath(false), m_noWeaponSkillGain(false),
     m_immunitySet(UINT32_MAX),
+    m_spellList(GetEmptySpellList()), m_ownsSpellList(false),
     m_creatureGroup(nullptr), m_imposedCooldown(false)
 {
     m_valuesCount = UNIT_END;
@@ -168,7 +177,7 @@ void Creature::AddToWorld()
     if (!IsInWorld())
     {
         if (GetObjectGuid().IsCreatureOrVehicle())
-            GetMap()->GetObjectsStore().insert<Creature>(GetObjectGuid(), (Creature*)this);
+            GetMap()->InsertObject<Creature>(GetObjectGuid(), (Creature*)this);
         if (GetDbGuid())
             GetMap()->AddDbGuidObject(this);
     }
@@ -177,17 +186,8 @@ void Creature::AddToWorld()
     {
         case CREATURE_SUBTYPE_PET:
         case CREATURE_SUBTYPE_TEMPORARY_SUMMON:
-        {
-            std::map<uint32, uint32>& targetArray = GetMap()->GetTempCreatures();
-            if (GetSubtype() == CREATURE_SUBTYPE_PET)
-                targetArray = GetMap()->GetTempPets();
-            // If creature exists, add count
-            if (targetArray.find(this->GetEntry()) != targetArray.end())
-                ++targetArray[this->GetEntry()];
-            else
-                targetArray.insert(std::pair<uint32, uint32>(this->GetEntry(), 1));
+            GetMap()->AddTempCreature(GetEntry(), GetSubtype() == CREATURE_SUBTYPE_PET);
             break;
-        }
         default: break;
     }
 
@@ -211,7 +211,7 @@ void Creature::RemoveFromWorld()
     if (IsInWorld())
     {
         if (GetObjectGuid().IsCreatureOrVehicle())
-            GetMap()->GetObjectsStore().erase<Creature>(GetObjectGuid(), (Creature*)nullptr);
+            GetMap()->EraseObject<Creature>(GetObjectGuid());
         if (GetDbGuid())
             GetMap()->RemoveDbGuidObject(this);
 
@@ -219,19 +219,8 @@ void Creature::RemoveFromWorld()
         {
             case CREATURE_SUBTYPE_PET:
             case CREATURE_SUBTYPE_TEMPORARY_SUMMON:
-            {
-                std::map<uint32, uint32>& targetArray = GetMap()->GetTempCreatures();
-                if (GetSubtype() == CREATURE_SUBTYPE_PET)
-                    targetArray = GetMap()->GetTempPets();
-                if (targetArray.find(this->GetEntry()) != targetArray.end())
-                {
-                    --targetArray[this->GetEntry()];
-
-                    if (targetArray[this->GetEntry()] <= 0)
-                        targetArray.erase(this->GetEntry());
-                }
+                GetMap()->RemoveTempCreature(GetEntry(), GetSubtype() == CREATURE_SUBTYPE_PET);
                 break;
-            }
             default: break;
         }
 
@@ -261,7 +250,7 @@ void Creature::CleanupsBeforeDelete()
         GetCreatureGroup()->GetFormationData()->OnDelete(this);
 
     Unit::CleanupsBeforeDelete();
-    m_vendorItemCounts.clear();
+    m_vendorItemCounts.reset();
 }
 
 void Creature::RemoveCorpse(bool inPlace)
@@ -801,7 +790,11 @@ void Creature::Update(const uint32 diff)
                 }
             }
 
-            Unit::Update(diff);
+            uint32 updateDiff = diff;
+            if (DeferDormantUpdate(updateDiff))
+                break;
+
+            Unit::Update(updateDiff);
 
             // creature can be dead after Unit::Update call
             // CORPSE/DEAD state will processed at next tick (in other case death timer will be updated unexpectedly)
@@ -810,7 +803,7 @@ void Creature::Update(const uint32 diff)
 
             // Creature can be dead after unit update
             if (IsAlive())
-                RegenerateAll(diff);
+                RegenerateAll(updateDiff);
 
             break;
         }
@@ -819,6 +812,63 @@ void Creature::Update(const uint32 diff)
     }
 }
 
+bool Creature::CanBeDormant() const
+{
+    // anything that reacts within a tick or is driven by someone else keeps the full update rate
+    if (IsInCombat() || GetVictim() || GetCombatManager().IsInEvadeMode() || IsNonMeleeSpellCasted(false))
+        return false;
+
+    if (isActiveObject() || IsPet() || GetMasterGuid() || IsBoarded() || IsVehicle())
+        return false;
+
+    // spline arrival is only reported in the tick it happens
+    return movespline->Finalized();
+}
+
+// Returns true when the update is skipped, otherwise diff holds the time to update with
+bool Creature::DeferDormantUpdate(uint32& diff)
+{
+    uint32 const interval = sWorld.getConfig(CONFIG_UINT32_CREATURE_DORMANT_INTERVAL);
+
+    if (m_isDormant && interval && CanBeDormant())
+    {
+        m_dormantDiff += diff;
+        if (m_dormantDiff < interval)
+            return true;
+
+        diff = m_dormantDiff;
+        m_dormantDiff = 0;
+    }
+    else
+    {
+        // woken up, catch up with the time spent dormant
+        diff += m_dormantDiff;
+        m_dormantDiff = 0;
+
+        if (!interval || !CanBeDormant())
+        {
+            m_isDormant = false;
+            m_dormantCheckTimer = 0;
+            return false;
+        }
+
+        m_dormantCheckTimer += diff;
+        if (m_dormantCheckTimer < interval)
+            return false;
+    }
+
+    m_dormantCheckTimer = 0;
+
+    Player* player = nullptr;
+    float const radius = sWorld.getConfig(CONFIG_FLOAT_CREATURE_DORMANT_RADIUS);
+    MaNGOS::AnyPlayerInObjectRangeCheck check(this, radius);
+    MaNGOS::PlayerSearcher<MaNGOS::AnyPlayerInObjectRangeCheck> searcher(player, check);
+    Cell::VisitWorldObjects(this, searcher, radius);
+
+    m_isDormant = player == nullptr;
+    return false;
+}
+
 void Creature::RegenerateAll(uint32 diff)
 {
     m_regenTimer += diff;
@@ -1558,14 +1608,14 @@ float Creature::_GetSpellDamageMod(int32 Rank)
 std::vector<uint32> Creature::GetCharmSpells() const
 {
     std::vector<uint32> spells(CREATURE_MAX_SPELLS, 0);
-    for (auto& data : m_spellList.Spells)
+    for (auto& data : m_spellList->Spells)
         spells[data.second.Position] = data.second.SpellId;
     return spells;
 }
 
 Creature::CooldownResult Creature::GetSpellCooldown(uint32 spellId, uint32& cooldown) const
 {
-    for (auto& data : m_spellList.Spells)
+    for (auto& data : m_spellList->Spells)
     {
         if (data.second.SpellId == spellId)
         {
@@ -2012,7 +2062,7 @@ SpellEntry const* Creature::ReachWithSpellAttack(Unit* pVictim)
     if (!pVictim)
         return nullptr;
 
-    for (auto& data : m_spellList.Spells)
+    for (auto& data : m_spellList->Spells)
     {
         uint32 spellId = data.second.SpellId;
         if (!spellId)
@@ -2065,7 +2115,7 @@ SpellEntry const* Creature::ReachWithSpellCure(Unit* pVictim)
     if (!pVictim)
         return nullptr;
 
-    for (auto& data : m_spellList.Spells)
+    for (auto& data : m_spellList->Spells)
     {
         uint32 spellId = data.second.SpellId;
         if (!spellId)
@@ -2388,7 +2438,7 @@ uint8 Creature::getRace() const
 
 bool Creature::HasSpell(uint32 spellID) const
 {
-    for (auto& spell : m_spellList.Spells)
+    for (auto& spell : m_spellList->Spells)
         if (spell.second.SpellId == spellID)
             return true;
 
@@ -2397,36 +2447,43 @@ bool Creature::HasSpell(uint32 spellID) const
 
 void Creature::UpdateSpell(int32 index, int32 newSpellId)
 {
-    auto itr = m_spellList.Spells.find(index);
-    if (itr != m_spellList.Spells.end())
+    if (m_spellList->Spells.find(index) == m_spellList->Spells.end())
+        return;
+
+    CreatureSpellList& spellList = GetOwnSpellList();
+    auto itr = spellList.Spells.find(index);
+    if (newSpellId == 0)
+        spellList.Spells.erase(itr);
+    else
+        (*itr).second.SpellId = newSpellId;
+}
+
+CreatureSpellList& Creature::GetOwnSpellList()
+{
+    if (!m_ownsSpellList)
     {
-        if (newSpellId == 0)
-            m_spellList.Spells.erase(itr);
-        else
-            (*itr).second.SpellId = newSpellId;
+        m_spellList = std::make_shared<CreatureSpellList>(*m_spellList);
+        m_ownsSpellList = true;
     }
+    return const_cast<CreatureSpellList&>(*m_spellList);
 }
 
 void Creature::SetSpellList(uint32 spellSet)
 {
     // Try difficulty dependent version before falling back to base entry
-    auto spellList = GetMap()->GetMapDataContainer().GetCreatureSpellList(spellSet);
+    std::shared_ptr<CreatureSpellList const> spellList = GetMap()->GetMapDataContainer().GetSharedCreatureSpellList(spellSet);
     if (!spellList)
         return;
-    
-    m_spellList = *spellList;
-    for (auto itr = m_spellList.Spells.begin(); itr != m_spellList.Spells.end();)
+
+    m_spellList = spellList;
+    m_ownsSpellList = false;
+
+    // spells that did not pass their roll are not available during this spell list lifetime, only then a copy is needed
+    for (auto itr = spellList->Spells.begin(); itr != spellList->Spells.end(); ++itr)
     {
-        auto& spell = (*itr).second;
-        if (spell.Availability < 100)
-        {
-            if (urand(0, 100) > spell.Availability) // such spells will not be available during this spell list lifetime
-            {
-                itr = m_spellList.Spells.erase(itr);
-                continue;
-            }
-        }
-        ++itr;
+        auto const& spell = (*itr).second;
+        if (spell.Availability < 100 && urand(0, 100) > spell.Availability)
+            GetOwnSpellList().Spells.erase((*itr).first);
     }
 
     if (AI()) // might not yet be initialized - dealt with at init
@@ -2538,12 +2595,15 @@ uint32 Creature::GetVendorItemCurrentCount(VendorItem const* vItem)
     if (!vItem->maxcount)
         return vItem->maxcount;
 
-    VendorItemCounts::iterator itr = m_vendorItemCounts.begin();
-    for (; itr != m_vendorItemCounts.end(); ++itr)
+    if (!m_vendorItemCounts)
+        return vItem->maxcount;
+
+    VendorItemCounts::iterator itr = m_vendorItemCounts->begin();
+    for (; itr != m_vendorItemCounts->end(); ++itr)
         if (itr->itemId == vItem->item)
             break;
 
-    if (itr == m_vendorItemCounts.end())
+    if (itr == m_vendorItemCounts->end())
         return vItem->maxcount;
 
     VendorItemCount* vCount = &*itr;
@@ -2557,7 +2617,7 @@ uint32 Creature::GetVendorItemCurrentCount(VendorItem const* vItem)
         uint32 diff = uint32((ptime - vCount->lastIncrementTime) / vItem->incrtime);
         if ((vCount->count + diff * pProto->BuyCount) >= vItem->maxcount)
         {
-            m_vendorItemCounts.erase(itr);
+            m_vendorItemCounts->erase(itr);
             return vItem->maxcount;
         }
 
@@ -2573,15 +2633,18 @@ uint32 Creature::UpdateVendorItemCurrentCount(VendorItem const* vItem, uint32 us
     if (!vItem->maxcount)
         return 0;
 
-    VendorItemCounts::iterator itr = m_vendorItemCounts.begin();
-    for (; itr != m_vendorItemCounts.end(); ++itr)
+    if (!m_vendorItemCounts)
+        m_vendorItemCounts.reset(new VendorItemCounts);
+
+    VendorItemCounts::iterator itr = m_vendorItemCounts->begin();
+    for (; itr != m_vendorItemCounts->end(); ++itr)
         if (itr->itemId == vItem->item)
             break;
 
-    if (itr == m_vendorItemCounts.end())
+    if (itr == m_vendorItemCounts->end())
     {
         uint32 new_count = vItem->maxcount > used_count ? vItem->maxcount - used_count : 0;
-        m_vendorItemCounts.push_back(VendorItemCount(vItem->item, new_count));
+        m_vendorItemCounts->push_back(VendorItemCount(vItem->item, new_count));
         return new_count;
     }
 
@@ -24,7 +24,9 @@
 #include "Globals/SharedDefines.h"
 #include "Server/DBCEnums.h"
 #include "Util/Util.h"
+#include "Util/SlabPool.h"
 #include "Entities/CreatureSpellList.h"
+#include "Globals/LocalizedString.h"
 
 #include <list>
 #include <memory>
@@ -343,8 +345,8 @@ struct CreatureConditionalSpawn
 
 struct CreatureLocale
 {
-    std::vector<std::string> Name;
-    std::vector<std::string> SubName;
+    LocalizedString Name;
+    LocalizedString SubName;
 };
 
 struct GossipMenuItemsLocale
@@ -561,6 +563,8 @@ class Creature : public Unit
     public:
 
         explicit Creature(CreatureSubtype subtype = CREATURE_SUBTYPE_GENERIC);
+
+        SLAB_POOL_ALLOCATED
         virtual ~Creature();
 
         void AddToWorld() override;
@@ -581,6 +585,10 @@ class Creature : public Unit
         void Update(const uint32 diff) override;  // overwrite Unit::Update
 
         virtual void RegenerateAll(uint32 update_diff);
+
+        // idle creatures without players around update at CONFIG_UINT32_CREATURE_DORMANT_INTERVAL with the accumulated diff
+        bool IsDormant() const { return m_isDormant; }
+        void WakeFromDormancy() { m_isDormant = false; m_dormantCheckTimer = 0; }
         uint32 GetEquipmentId() const { return m_equipmentId; }
 
         CreatureSubtype GetSubtype() const { return m_subtype; }
@@ -779,6 +787,7 @@ class Creature : public Unit
         uint32 GetInteractionPauseTimer() const { return m_interactionPauseTimer; }
 
         GridReference<Creature>& GetGridRef() { return m_gridRef; }
+        void UpdateGridPosition() override { m_gridRef.UpdatePosition(GetGridObjectPosition()); }
         bool IsRegeneratingHealth() const { return (GetCreatureInfo()->RegenerateStats & REGEN_FLAG_HEALTH) != 0 && !(GetCreatureInfo()->CreatureTypeFlags & CREATURE_TYPEFLAGS_SIEGE_WEAPON); }
         bool IsRegeneratingPower() const;
         virtual uint8 GetPetAutoSpellSize() const { return CREATURE_MAX_SPELLS; }
@@ -867,7 +876,9 @@ class Creature : public Unit
         void Heartbeat() override;
 
         // Spell Lists
-        CreatureSpellList const& GetSpellList() const { return m_spellList; }
+        CreatureSpellList const& GetSpellList() const { return *m_spellList; }
+        bool HasOwnSpellList() const { return m_ownsSpellList; }
+        VendorItemCounts const* GetVendorItemCounts() const { return m_vendorItemCounts.get(); }
         std::vector<uint32> GetCharmSpells() const;
         enum CooldownResult
         {
@@ -904,8 +915,10 @@ class Creature : public Unit
 
         bool IsCorpseExpired() const;
 
-        // vendor items
-        VendorItemCounts m_vendorItemCounts;
+        CreatureSpellList& GetOwnSpellList();
+
+        // vendor items, only allocated once something limited was bought
+        std::unique_ptr<VendorItemCounts> m_vendorItemCounts;
 
         uint32 m_gossipMenuId;
         uint32 m_lootMoney;
@@ -930,6 +943,8 @@ class Creature : public Unit
         CreatureSubtype m_subtype;                          // set in Creatures subclasses for fast it detect without dynamic_cast use
         void RegeneratePower(float timerMultiplier);
         virtual void RegenerateHealth();
+        bool DeferDormantUpdate(uint32& diff);
+        bool CanBeDormant() const;
         MovementGeneratorType m_defaultMovementType;
         uint32 m_equipmentId;
         uint32 m_detectionRange;
@@ -938,6 +953,9 @@ class Creature : public Unit
         bool m_AlreadyCallAssistance;
         bool m_canCallForAssistance;
         bool m_isDeadByDefault;
+        bool m_isDormant;
+        uint32 m_dormantDiff;                               // (msecs) time accumulated while dormant, applied at the next update
+        uint32 m_dormantCheckTimer;                         // (msecs) time since nearby players were last searched
         uint32 m_temporaryFactionFlags;                     // used for real faction changes (not auras etc)
 
         uint32 m_originalEntry;
@@ -968,7 +986,9 @@ class Creature : public Unit
         std::set<uint32> m_hitBySpells;
 
         // Spell Lists
-        CreatureSpellList m_spellList;
+        // shared with the map's spell list container and only copied once this creature changes it
+        std::shared_ptr<CreatureSpellList const> m_spellList;
+        bool m_ownsSpellList;
 
         CreatureGroup* m_creatureGroup;
 
@@ -103,7 +103,7 @@ void CreatureLinkingMgr::LoadFromDB()
             ++count;
 
             // Add it to the map
-            m_creatureLinkingMap.insert(CreatureLinkingMap::value_type(entry, tmp));
+            m_creatureLinkingMap.emplace(MAKE_PAIR64(entry, tmp.mapId), tmp);
 
             // Store master_entry
             m_eventTriggers.insert(tmp.masterId);
@@ -152,7 +152,7 @@ void CreatureLinkingMgr::LoadFromDB()
         ++count;
 
         // Add it to the map
-        m_creatureLinkingGuidMap.insert(CreatureLinkingMap::value_type(guid, tmp));
+        m_creatureLinkingGuidMap.emplace(guid, tmp);
 
         // Store master_guid
         m_eventGuidTriggers.insert(tmp.masterId);
@@ -315,19 +315,16 @@ CreatureLinkingInfo const* CreatureLinkingMgr::GetLinkedTriggerInformation(Creat
 CreatureLinkingInfo const* CreatureLinkingMgr::GetLinkedTriggerInformation(uint32 entry, uint32 dbGuid, uint32 mapId) const
 {
     // guid case
-    CreatureLinkingMapBounds bounds = m_creatureLinkingGuidMap.equal_range(dbGuid);
-    for (CreatureLinkingMap::const_iterator iter = bounds.first; iter != bounds.second; ++iter)
-        return &(iter->second);
-
-    // entry case
-    bounds = m_creatureLinkingMap.equal_range(entry);
-    for (CreatureLinkingMap::const_iterator iter = bounds.first; iter != bounds.second; ++iter)
+    if (dbGuid)
     {
-        if (iter->second.mapId == mapId)
-            return &(iter->second);
+        CreatureLinkingGuidMap::const_iterator itr = m_creatureLinkingGuidMap.find(dbGuid);
+        if (itr != m_creatureLinkingGuidMap.end())
+            return &itr->second;
     }
 
-    return nullptr;
+    // entry case
+    CreatureLinkingMap::const_iterator itr = m_creatureLinkingMap.find(MAKE_PAIR64(entry, mapId));
+    return itr != m_creatureLinkingMap.end() ? &itr->second : nullptr;
 }
 
 // Function to add slave-NPCs to the holder
@@ -338,51 +335,30 @@ void CreatureLinkingHolder::AddSlaveToHolder(Creature* pCreature)
         return;
 
     if (pInfo->mapId == INVALID_MAP_ID)                     // Guid case, store master->slaves for fast access
-    {
-        HolderMapBounds bounds = m_holderGuidMap.equal_range(pInfo->masterId);
-        for (HolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
-        {
-            if (itr->second.linkingFlag == pInfo->linkingFlag)
-            {
-                itr->second.linkedGuids.push_back(std::make_pair(pCreature->GetDbGuid(), pCreature->GetObjectGuid()));
-                pCreature = nullptr;                           // Store that is was handled
-                break;
-            }
-        }
-
-        // If this is a new flag, insert new entry
-        if (pCreature)
-        {
-            InfoAndGuids tmp;
-            tmp.linkedGuids.push_back(std::make_pair(pCreature->GetDbGuid(), pCreature->GetObjectGuid()));
-            tmp.linkingFlag = pInfo->linkingFlag;
-            tmp.searchRange = 0;
-            m_holderGuidMap.insert(HolderMap::value_type(pInfo->masterId, tmp));
-        }
-        return;
-    }
+        AddSlaveToLinks(m_holderGuidMap[pInfo->masterId], pCreature, pInfo->linkingFlag, 0);
+    else
+        AddSlaveToLinks(m_holderMap[pInfo->masterId], pCreature, pInfo->linkingFlag, pInfo->searchRange);
+}
 
+// Helper function, to add a slave to the links of its master
+void CreatureLinkingHolder::AddSlaveToLinks(HolderLinks& links, Creature* pCreature, uint16 linkingFlag, uint16 searchRange)
+{
     // First try to find holder with same flag
-    HolderMapBounds bounds = m_holderMap.equal_range(pInfo->masterId);
-    for (HolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
+    for (InfoAndGuids& info : links)
     {
-        if (itr->second.linkingFlag == pInfo->linkingFlag && itr->second.searchRange == pInfo->searchRange)
+        if (info.linkingFlag == linkingFlag && info.searchRange == searchRange)
         {
-            itr->second.linkedGuids.push_back(std::make_pair(pCreature->GetDbGuid(), pCreature->GetObjectGuid()));
-            pCreature = nullptr;                               // Store that is was handled
-            break;
+            info.linkedGuids.emplace_back(pCreature->GetDbGuid(), pCreature->GetObjectGuid());
+            return;
         }
     }
 
     // If this is a new flag, insert new entry
-    if (pCreature)
-    {
-        InfoAndGuids tmp;
-        tmp.linkedGuids.push_back(std::make_pair(pCreature->GetDbGuid(), pCreature->GetObjectGuid()));
-        tmp.linkingFlag = pInfo->linkingFlag;
-        tmp.searchRange = pInfo->searchRange;
-        m_holderMap.insert(HolderMap::value_type(pInfo->masterId, tmp));
-    }
+    InfoAndGuids tmp;
+    tmp.linkedGuids.emplace_back(pCreature->GetDbGuid(), pCreature->GetObjectGuid());
+    tmp.linkingFlag = linkingFlag;
+    tmp.searchRange = searchRange;
+    links.push_back(std::move(tmp));
 }
 
 // Function to add master-NPCs to the holder
@@ -396,12 +372,11 @@ void CreatureLinkingHolder::AddMasterToHolder(Creature* pCreature)
         return;
 
     // Check, if already stored
-    BossGuidMapBounds bounds = m_masterGuid.equal_range(pCreature->GetEntry());
-    for (BossGuidMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
-        if (itr->second == pCreature->GetObjectGuid())
-            return;                                         // Already added
+    std::vector<ObjectGuid>& masters = m_masterGuid[pCreature->GetEntry()];
+    if (std::find(masters.begin(), masters.end(), pCreature->GetObjectGuid()) != masters.end())
+        return;                                             // Already added
 
-    m_masterGuid.insert(BossGuidMap::value_type(pCreature->GetEntry(), pCreature->GetObjectGuid()));
+    masters.push_back(pCreature->GetObjectGuid());
 }
 
 // Function to process actions for linked NPCs
@@ -430,27 +405,23 @@ void CreatureLinkingHolder::DoCreatureLinkingEvent(CreatureLinkingEvent eventTyp
         case LINKING_EVENT_DESPAWN: eventFlagFilter = EVENT_MASK_ON_DESPAWN; reverseEventFlagFilter = 0;                        break;
     }
 
-    // Process Slaves (by entry)
-    HolderMapBounds bounds = m_holderMap.equal_range(pSource->GetEntry());
-    for (HolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
+    // Process Slaves (by entry, then by guid)
+    HolderMap* holders[] = { &m_holderMap, &m_holderGuidMap };
+    uint32 keys[] = { pSource->GetEntry(), pSource->GetDbGuid() };
+    for (uint8 i = 0; i < 2; ++i)
     {
-        if (!itr->second.inUse)
-        {
-            itr->second.inUse = true;
-            ProcessSlaveGuidList(eventType, pSource, itr->second.linkingFlag & eventFlagFilter, itr->second.searchRange, itr->second.linkedGuids, pEnemy);
-            itr->second.inUse = false;
-        }
-    }
+        HolderMap::iterator links = holders[i]->find(keys[i]);
+        if (links == holders[i]->end())
+            continue;
 
-    // Process Slaves (by guid)
-    bounds = m_holderGuidMap.equal_range(pSource->GetDbGuid());
-    for (HolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
-    {
-        if (!itr->second.inUse)
+        for (InfoAndGuids& info : links->second)
         {
-            itr->second.inUse = true;
-            ProcessSlaveGuidList(eventType, pSource, itr->second.linkingFlag & eventFlagFilter, itr->second.searchRange, itr->second.linkedGuids, pEnemy);
-            itr->second.inUse = false;
+            if (!info.inUse)
+            {
+                info.inUse = true;
+                ProcessSlaveGuidList(eventType, pSource, info.linkingFlag & eventFlagFilter, info.searchRange, info.linkedGuids, pEnemy);
+                info.inUse = false;
+            }
         }
     }
 
@@ -459,26 +430,7 @@ void CreatureLinkingHolder::DoCreatureLinkingEvent(CreatureLinkingEvent eventTyp
     {
         if (pInfo->linkingFlag & reverseEventFlagFilter)
         {
-            Creature* pMaster = nullptr;
-            if (pInfo->mapId != INVALID_MAP_ID)             // entry case
-            { 
-                BossGuidMapBounds finds = m_masterGuid.equal_range(pInfo->masterId);
-                for (BossGuidMap::const_iterator itr = finds.first; itr != finds.second; ++itr)
-                {
-                    Creature* master = pSource->GetMap()->GetCreature(itr->second);
-                    if (master && IsSlaveInRangeOfMaster(pSource, master, pInfo->searchRange))
-                    {
-                        pMaster = master;
-                        break;
-                    }
-                }
-            }
-            else                                            // guid case
-            {
-                CreatureData const* masterData = sObjectMgr.GetCreatureData(pInfo->masterDBGuid);
-                CreatureInfo const* cInfo = ObjectMgr::GetCreatureTemplate(masterData->id);
-                pMaster = pSource->GetMap()->GetCreature(pInfo->masterDBGuid);
-            }
+            Creature* pMaster = FindLinkedMaster(pSource, pInfo);
 
             if ((!pMaster || pMaster->IsCorpse()) && eventType == LINKING_EVENT_EVADE && pSource->IsUsingNewSpawningSystem())
                 pSource->GetMap()->GetSpawnManager().RespawnCreature(pInfo->masterDBGuid);
@@ -517,8 +469,45 @@ void CreatureLinkingHolder::DoCreatureLinkingEvent(CreatureLinkingEvent eventTyp
     }
 }
 
+// Helper function, to find the master of a slave
+Creature* CreatureLinkingHolder::FindLinkedMaster(Creature* pSlave, CreatureLinkingInfo const* pInfo)
+{
+    if (pInfo->mapId == INVALID_MAP_ID)                     // guid case
+        return pSlave->GetMap()->GetCreature(pInfo->masterDBGuid);
+
+    // entry case - the master found last time for this spawn is checked first
+    uint32 slaveDbGuid = pSlave->GetDbGuid();
+    if (slaveDbGuid)
+    {
+        auto cached = m_slaveMasters.find(slaveDbGuid);
+        if (cached != m_slaveMasters.end())
+        {
+            Creature* pMaster = pSlave->GetMap()->GetCreature(cached->second);
+            if (pMaster && pMaster->GetEntry() == pInfo->masterId && IsSlaveInRangeOfMaster(pSlave, pMaster, pInfo->searchRange))
+                return pMaster;
+        }
+    }
+
+    BossGuidMap::const_iterator masters = m_masterGuid.find(pInfo->masterId);
+    if (masters == m_masterGuid.end())
+        return nullptr;
+
+    for (ObjectGuid const& masterGuid : masters->second)
+    {
+        Creature* pMaster = pSlave->GetMap()->GetCreature(masterGuid);
+        if (pMaster && IsSlaveInRangeOfMaster(pSlave, pMaster, pInfo->searchRange))
+        {
+            if (slaveDbGuid)
+                m_slaveMasters[slaveDbGuid] = masterGuid;
+            return pMaster;
+        }
+    }
+
+    return nullptr;
+}
+
 // Helper function, to process a slave list
-void CreatureLinkingHolder::ProcessSlaveGuidList(CreatureLinkingEvent eventType, Creature* pSource, uint32 flag, uint16 searchRange, std::list<std::pair<uint32, ObjectGuid>>& slaveGuidList, Unit* pEnemy)
+void CreatureLinkingHolder::ProcessSlaveGuidList(CreatureLinkingEvent eventType, Creature* pSource, uint32 flag, uint16 searchRange, std::vector<std::pair<uint32, ObjectGuid>>& slaveGuidList, Unit* pEnemy)
 {
     if (!flag)
         return;
@@ -531,23 +520,26 @@ void CreatureLinkingHolder::ProcessSlaveGuidList(CreatureLinkingEvent eventType,
         postprocessFlag = (postprocessFlag & ~(FLAG_RESPAWN_ON_EVADE | FLAG_RESPAWN_ON_DEATH | FLAG_RESPAWN_ON_RESPAWN));
     }
 
-    for (auto slave_itr = slaveGuidList.begin(); slave_itr != slaveGuidList.end();)
+    // Indexed, the list can grow while slaves are respawned
+    for (size_t i = 0; i < slaveGuidList.size();)
     {
+        std::pair<uint32, ObjectGuid> const slaveGuids = slaveGuidList[i];
         Creature* pSlave;
-        if ((*slave_itr).first)
-            pSlave = pSource->GetMap()->GetCreature((*slave_itr).first);
+        if (slaveGuids.first)
+            pSlave = pSource->GetMap()->GetCreature(slaveGuids.first);
         else
-            pSlave = pSource->GetMap()->GetCreature((*slave_itr).second);
+            pSlave = pSource->GetMap()->GetCreature(slaveGuids.second);
         if ((!pSlave || pSlave->IsCorpse()) && preprocessFlag) // dynguid respawning
-            pSource->GetMap()->GetSpawnManager().RespawnCreature((*slave_itr).first);
+            pSource->GetMap()->GetSpawnManager().RespawnCreature(slaveGuids.first);
         if (!pSlave)
         {
             // Remove old guid first
-            slave_itr = slaveGuidList.erase(slave_itr);
+            slaveGuidList[i] = slaveGuidList.back();
+            slaveGuidList.pop_back();
             continue;
         }
 
-        ++slave_itr;
+        ++i;
 
         // Ignore Pets
         if (pSlave->IsPet())
@@ -743,10 +735,13 @@ bool CreatureLinkingHolder::CanSpawn(uint32 dbGuid, Map* _map, CreatureLinkingIn
     }
 
     // Search for nearby master
-    BossGuidMapBounds finds = m_masterGuid.equal_range(pInfo->masterId);
-    for (BossGuidMap::const_iterator itr = finds.first; itr != finds.second; ++itr)
+    BossGuidMap::const_iterator masters = m_masterGuid.find(pInfo->masterId);
+    if (masters == m_masterGuid.end())
+        return true;
+
+    for (ObjectGuid const& masterGuid : masters->second)
     {
-        Creature* pMaster = _map->GetCreature(itr->second);
+        Creature* pMaster = _map->GetCreature(masterGuid);
         if (pMaster && IsSlaveInRangeOfMaster(pMaster, sx, sy, pInfo->searchRange))
         {
             if (pInfo->linkingFlag & FLAG_CANT_SPAWN_IF_BOSS_DEAD)
@@ -767,24 +762,7 @@ bool CreatureLinkingHolder::TryFollowMaster(Creature* pCreature)
     if (!pInfo || !(pInfo->linkingFlag & FLAG_FOLLOW))
         return false;
 
-    Creature* pMaster = nullptr;
-    if (pInfo->mapId != INVALID_MAP_ID)                     // entry case
-    {
-        BossGuidMapBounds finds = m_masterGuid.equal_range(pInfo->masterId);
-        for (BossGuidMap::const_iterator itr = finds.first; itr != finds.second; ++itr)
-        {
-            pMaster = pCreature->GetMap()->GetCreature(itr->second);
-            if (pMaster && IsSlaveInRangeOfMaster(pCreature, pMaster, pInfo->searchRange))
-                break;
-        }
-    }
-    else                                                    // guid case
-    {
-        CreatureData const* masterData = sObjectMgr.GetCreatureData(pInfo->masterDBGuid);
-        CreatureInfo const* cInfo = ObjectMgr::GetCreatureTemplate(masterData->id);
-        pMaster = pCreature->GetMap()->GetCreature(pInfo->masterDBGuid);
-    }
-
+    Creature* pMaster = FindLinkedMaster(pCreature, pInfo);
     if (pMaster && pMaster->IsAlive())
     {
         SetFollowing(pCreature, pMaster);
@@ -120,13 +120,13 @@ class CreatureLinkingMgr
         CreatureLinkingInfo const* GetLinkedTriggerInformation(uint32 entry, uint32 lowGuid, uint32 mapId) const;
 
     private:
-        typedef std::multimap < uint32 /*slaveEntry*/, CreatureLinkingInfo > CreatureLinkingMap;
-        typedef std::pair<CreatureLinkingMap::const_iterator, CreatureLinkingMap::const_iterator> CreatureLinkingMapBounds;
+        typedef std::unordered_map < uint64 /*slaveEntry, map*/, CreatureLinkingInfo > CreatureLinkingMap;
+        typedef std::unordered_map < uint32 /*slaveGuid*/, CreatureLinkingInfo > CreatureLinkingGuidMap;
 
-        // Storage of Data: npc_entry_slave, (map, npc_entry_master, flag, master_db_guid[If Unique], search_range)
+        // Storage of Data: (npc_entry_slave, map), (map, npc_entry_master, flag, master_db_guid[If Unique], search_range)
         CreatureLinkingMap m_creatureLinkingMap;
         // Storage of Data: npc_guid_slave, (map, npc_guid_master, flag, master_db_guid, search_range)
-        CreatureLinkingMap m_creatureLinkingGuidMap;
+        CreatureLinkingGuidMap m_creatureLinkingGuidMap;
 
         // Lookup Storage for fast access:
         std::unordered_set<uint32> m_eventTriggers;              // master by entry
@@ -171,23 +171,21 @@ class CreatureLinkingHolder
         {
             uint16 linkingFlag: 16;
             uint16 searchRange: 16;
-            std::list<std::pair<uint32, ObjectGuid>> linkedGuids;
+            std::vector<std::pair<uint32, ObjectGuid>> linkedGuids;
             bool inUse = false;
         };
-        // Structure associated to a master (guid case)
-        struct InfoAndGuid
-        {
-            uint16 linkingFlag;
-            ObjectGuid linkedGuid;
-        };
 
-        typedef std::multimap < uint32 /*masterEntryOrGuid*/, InfoAndGuids > HolderMap;
-        typedef std::pair<HolderMap::iterator, HolderMap::iterator> HolderMapBounds;
-        typedef std::multimap < uint32 /*Entry*/, ObjectGuid > BossGuidMap;
-        typedef std::pair<BossGuidMap::const_iterator, BossGuidMap::const_iterator> BossGuidMapBounds;
+        // Links of one master, a list so that references stay valid while slaves spawned by an event are added
+        typedef std::list<InfoAndGuids> HolderLinks;
+        typedef std::unordered_map < uint32 /*masterEntryOrGuid*/, HolderLinks > HolderMap;
+        typedef std::unordered_map < uint32 /*Entry*/, std::vector<ObjectGuid> > BossGuidMap;
 
+        // Helper function, to add a slave to the links of its master
+        void AddSlaveToLinks(HolderLinks& links, Creature* pCreature, uint16 linkingFlag, uint16 searchRange);
+        // Helper function, to find the master of a slave
+        Creature* FindLinkedMaster(Creature* pSlave, CreatureLinkingInfo const* pInfo);
         // Helper function, to process a slave list
-        void ProcessSlaveGuidList(CreatureLinkingEvent eventType, Creature* pSource, uint32 flag, uint16 searchRange, std::list<std::pair<uint32, ObjectGuid>>& slaveGuidList, Unit* pEnemy);
+        void ProcessSlaveGuidList(CreatureLinkingEvent eventType, Creature* pSource, uint32 flag, uint16 searchRange, std::vector<std::pair<uint32, ObjectGuid>>& slaveGuidList, Unit* pEnemy);
         // Helper function, to process a single slave
         void ProcessSlave(CreatureLinkingEvent eventType, Creature* pSource, uint32 flag, Creature* pSlave, Unit* pEnemy);
         // Helper function to set following
@@ -204,6 +202,8 @@ class CreatureLinkingHolder
         HolderMap m_holderGuidMap;
         // boss_entry, guid for reverse action triggering and check alive
         BossGuidMap m_masterGuid;
+        // slave db_guid, guid of the master found by range - checked again on use
+        std::unordered_map<uint32, ObjectGuid> m_slaveMasters;
 };
 
 #define sCreatureLinkingMgr MaNGOS::Singleton<CreatureLinkingMgr>::Instance()
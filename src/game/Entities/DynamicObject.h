@@ -79,6 +79,7 @@ class DynamicObject : public WorldObject
         SpellTarget GetTarget() const { return m_target; }
 
         GridReference<DynamicObject>& GetGridRef() { return m_gridRef; }
+        void UpdateGridPosition() override { m_gridRef.UpdatePosition(GetGridObjectPosition()); }
 
     protected:
         uint32 m_spellId;
@@ -67,6 +67,7 @@ GameObject::GameObject() : WorldObject(),
     m_model(nullptr),
     m_captureSlider(0),
     m_captureState(),
+    m_capturePointSeeded(false),
     m_goInfo(nullptr),
     m_displayInfo(nullptr),
     m_AI(nullptr)
@@ -123,9 +124,11 @@ void GameObject::AddToWorld()
     ///- Register the gameobject for guid lookup
     if (!IsInWorld())
     {
-        GetMap()->GetObjectsStore().insert<GameObject>(GetObjectGuid(), (GameObject*)this);
+        GetMap()->InsertObject<GameObject>(GetObjectGuid(), (GameObject*)this);
         if (GetDbGuid())
             GetMap()->AddDbGuidObject(this);
+        if (GetGoType() == GAMEOBJECT_TYPE_CAPTURE_POINT && GetGOInfo()->capturePoint.radius)
+            GetMap()->AddCapturePoint(this);
     }
 
     if (m_model)
@@ -171,9 +174,11 @@ void GameObject::RemoveFromWorld()
         if (m_model && GetMap()->ContainsGameObjectModel(*m_model))
             GetMap()->RemoveGameObjectModel(*m_model);
 
-        GetMap()->GetObjectsStore().erase<GameObject>(GetObjectGuid(), (GameObject*)nullptr);
+        GetMap()->EraseObject<GameObject>(GetObjectGuid());
         if (GetDbGuid())
             GetMap()->RemoveDbGuidObject(this);
+        if (GetGoType() == GAMEOBJECT_TYPE_CAPTURE_POINT && GetGOInfo()->capturePoint.radius)
+            GetMap()->RemoveCapturePoint(this);
 
         ClearGameObjectGroup();
     }
@@ -2185,6 +2190,7 @@ void GameObject::UpdateCollisionState() const
         return;
 
     m_model->enable(IsCollisionEnabled() ? GetPhaseMask() : 0);
+    GetMap()->InvalidateLineOfSightCache();
 }
 
 void GameObject::UpdateModel()
@@ -2387,6 +2393,17 @@ void GameObject::SetCapturePointSlider(float value, bool isLocked)
         m_captureState = CAPTURE_STATE_NEUTRAL;
 }
 
+void GameObject::UpdateCapturePointPresence(Player* player)
+{
+    if (!m_capturePointSeeded)
+        return;
+
+    if (IsWithinDistInMap(player, GetGOInfo()->capturePoint.radius))
+        m_capturePointPlayers.insert(player->GetObjectGuid());
+    else
+        m_capturePointPlayers.erase(player->GetObjectGuid());
+}
+
 void GameObject::TickCapturePoint()
 {
     // TODO: On retail: Ticks every 5.2 seconds. slider value increase when new player enters on tick
@@ -2394,11 +2411,35 @@ void GameObject::TickCapturePoint()
     GameObjectInfo const* info = GetGOInfo();
     float radius = info->capturePoint.radius;
 
-    // search for players in radius
+    // players already in range when the point was spawned did not relocate yet, search once
+    if (!m_capturePointSeeded)
+    {
+        auto seed = [this, radius](Player* player)
+        {
+            if (IsWithinDistInMap(player, radius))
+                m_capturePointPlayers.insert(player->GetObjectGuid());
+        };
+        MaNGOS::PlayerWorker<decltype(seed)> worker(this, seed);
+        Cell::VisitWorldObjects(this, worker, radius);
+        m_capturePointSeeded = true;
+    }
+
+    // players in radius, as kept by relocations; drop those that left the map or the radius since
     PlayerList capturingPlayers;
     MaNGOS::AnyPlayerInCapturePointRange u_check(this, radius);
-    MaNGOS::PlayerListSearcher<MaNGOS::AnyPlayerInCapturePointRange> checker(capturingPlayers, u_check);
-    Cell::VisitWorldObjects(this, checker, radius);
+    for (GuidSet::iterator itr = m_capturePointPlayers.begin(); itr != m_capturePointPlayers.end();)
+    {
+        Player* player = GetMap()->GetPlayer(*itr);
+        if (!player || !IsWithinDistInMap(player, radius))
+        {
+            itr = m_capturePointPlayers.erase(itr);
+            continue;
+        }
+
+        if (u_check(player))
+            capturingPlayers.push_back(player);
+        ++itr;
+    }
 
     GuidSet tempUsers(m_UniqueUsers);
     uint32 neutralPercent = info->capturePoint.neutralPercent;
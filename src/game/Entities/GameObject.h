@@ -23,9 +23,11 @@
 #include "Globals/SharedDefines.h"
 #include "Entities/Object.h"
 #include "Util/Util.h"
+#include "Util/SlabPool.h"
 #include "AI/BaseAI/GameObjectAI.h"
 #include "Spells/SpellDefines.h"
 #include "Entities/GameObjectDefines.h"
+#include "Globals/LocalizedString.h"
 
 #include <array>
 
@@ -608,8 +610,8 @@ struct GameObjectInfo
 
 struct GameObjectLocale
 {
-    std::vector<std::string> Name;
-    std::vector<std::string> CastBarCaption;
+    LocalizedString Name;
+    LocalizedString CastBarCaption;
 };
 
 struct QuaternionData
@@ -747,6 +749,8 @@ class GameObject : public WorldObject
         explicit GameObject();
         ~GameObject();
 
+        SLAB_POOL_ALLOCATED
+
         static GameObject* CreateGameObject(uint32 entry);
 
         void AddToWorld() override;
@@ -863,6 +867,9 @@ class GameObject : public WorldObject
         }
 
         void SetActionTarget(ObjectGuid guid) { m_actionTarget = guid; };
+
+        // called on player relocation for capture points of the player's map
+        void UpdateCapturePointPresence(Player* player);
         void AddUniqueUse(Player* player);
         void AddUse() { ++m_useTimes; }
         bool IsInUse() const { return m_isInUse; }
@@ -925,6 +932,7 @@ class GameObject : public WorldObject
         float GetCollisionHeight() const override { return 1.f; } // to get away with ground collision
 
         GridReference<GameObject>& GetGridRef() { return m_gridRef; }
+        void UpdateGridPosition() override { m_gridRef.UpdatePosition(GetGridObjectPosition()); }
 
         uint32 GetScriptId() const;
         void AIM_Initialize();
@@ -982,6 +990,8 @@ class GameObject : public WorldObject
         uint32      m_captureTimer;                         // (msecs) timer used for capture points
         float       m_captureSlider;                        // capture point slider value in range of [0..100]
         CapturePointState m_captureState;
+        GuidSet m_capturePointPlayers;                      // players within radius, kept up to date by Map::UpdateCapturePointPresence
+        bool m_capturePointSeeded;                          // m_capturePointPlayers filled by the initial grid search
 
         GuidSet m_SkillupSet;                               // players that already have skill-up at GO use
 
@@ -665,8 +665,11 @@ uint32 Item::GetSpell() const
 
 int32 Item::GenerateItemRandomPropertyId(uint32 item_id)
 {
-    ItemPrototype const* itemProto = sItemStorage.LookupEntry<ItemPrototype>(item_id);
+    return GenerateItemRandomPropertyId(sItemStorage.LookupEntry<ItemPrototype>(item_id));
+}
 
+int32 Item::GenerateItemRandomPropertyId(ItemPrototype const* itemProto)
+{
     if (!itemProto)
         return 0;
 
@@ -739,7 +742,7 @@ void Item::SetItemRandomProperties(int32 randomPropId)
 
 void Item::UpdateItemSuffixFactor()
 {
-    uint32 suffixFactor = GenerateEnchSuffixFactor(GetEntry());
+    uint32 suffixFactor = GenerateEnchSuffixFactor(GetProto());
     if (GetItemSuffixFactor() == suffixFactor)
         return;
 
@@ -835,6 +838,14 @@ void Item::RemoveFromUpdateQueueOf(Player* player)
     uQueuePos = -1;
 }
 
+void Item::SetCount(uint32 value)
+{
+    SetUInt32Value(ITEM_FIELD_STACK_COUNT, value);
+
+    if (m_countIndexState.owner)
+        m_countIndexState.owner->UpdateItemCountIndex(this);
+}
+
 uint8 Item::GetBagSlot() const
 {
     return m_container ? m_container->GetSlot() : uint8(INVENTORY_SLOT_BAG_0);
@@ -1147,7 +1158,7 @@ Item* Item::CreateItem(uint32 item, uint32 count, Player const* player, uint32 r
         if (pItem->Create(sObjectMgr.GenerateItemLowGuid(), item, player))
         {
             pItem->SetCount(count);
-            if (uint32 randId = randomPropertyId ? randomPropertyId : Item::GenerateItemRandomPropertyId(item))
+            if (uint32 randId = randomPropertyId ? randomPropertyId : Item::GenerateItemRandomPropertyId(pProto))
                 pItem->SetItemRandomProperties(randId);
 
             return pItem;
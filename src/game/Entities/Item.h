@@ -256,6 +256,16 @@ enum ItemRequiredTargetType
 
 #define MAX_ITEM_REQ_TARGET_TYPE 2
 
+// What an item stored in a player's inventory or bank adds to the player's item count index
+struct ItemCountIndexState
+{
+    ItemCountIndexState() : owner(nullptr), count(0), inBank(false) {}
+
+    Player* owner;                                          // nullptr while not counted
+    uint32 count;
+    bool inBank;
+};
+
 struct ItemRequiredTarget
 {
     ItemRequiredTarget(ItemRequiredTargetType uiType, uint32 uiTargetEntry) : m_uiType(uiType), m_uiTargetEntry(uiTargetEntry) {}
@@ -310,7 +320,7 @@ class Item : public Object
         bool GemsFitSockets() const;
 
         uint32 GetCount() const { return GetUInt32Value(ITEM_FIELD_STACK_COUNT); }
-        void SetCount(uint32 value) { SetUInt32Value(ITEM_FIELD_STACK_COUNT, value); }
+        void SetCount(uint32 value);
         uint32 GetMaxStackCount() const { return GetProto()->GetMaxStackSize(); }
         uint8 GetGemCountWithID(uint32 GemID) const;
         uint8 GetGemCountWithLimitCategory(uint32 limitCategory) const;
@@ -324,6 +334,8 @@ class Item : public Object
         void SetContainer(Bag* container) { m_container = container; }
 
         bool IsInBag() const { return m_container != nullptr; }
+        ItemCountIndexState& GetCountIndexState() { return m_countIndexState; }
+        ItemCountIndexState const& GetCountIndexState() const { return m_countIndexState; }
         bool IsEquipped() const;
 
         uint32 GetSkill() const;
@@ -335,6 +347,7 @@ class Item : public Object
         void SetItemRandomProperties(int32 randomPropId);
         void UpdateItemSuffixFactor();
         static int32 GenerateItemRandomPropertyId(uint32 item_id);
+        static int32 GenerateItemRandomPropertyId(ItemPrototype const* itemProto);
         void SetEnchantment(EnchantmentSlot slot, uint32 id, uint32 duration, uint32 charges, ObjectGuid caster = ObjectGuid());
         void SetEnchantmentDuration(EnchantmentSlot slot, uint32 duration);
         void SetEnchantmentCharges(EnchantmentSlot slot, uint32 charges);
@@ -397,6 +410,7 @@ class Item : public Object
         bool mb_in_trade;                                   // true if item is currently in trade-window
         ItemLootUpdateState m_lootState;
         bool m_usedInSpell;
+        ItemCountIndexState m_countIndexState;
 };
 
 #endif
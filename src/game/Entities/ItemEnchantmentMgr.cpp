@@ -23,25 +23,78 @@
 #include "Util/ProgressBar.h"
 #include "Util/Util.h"
 
-#include <list>
+#include <algorithm>
+#include <map>
 #include <vector>
 
-struct EnchStoreItem
+// One item_enchantment_template entry compiled into a Walker alias table, so a roll
+// costs one urand and one rand_norm whatever the number of enchantments
+struct EnchGroup
 {
-    uint32  ench;
-    float   chance;
+    std::vector<uint32> ench;
+    std::vector<float> probability;                         // chance to keep column i instead of its alias
+    std::vector<uint32> alias;
 
-    EnchStoreItem()
-        : ench(0), chance(0) {}
+    bool IsEmpty() const { return ench.empty(); }
 
-    EnchStoreItem(uint32 _ench, float _chance)
-        : ench(_ench), chance(_chance) {}
+    uint32 Roll() const
+    {
+        uint32 column = urand(0, ench.size() - 1);
+        return rand_norm_f() < probability[column] ? ench[column] : ench[alias[column]];
+    }
 };
 
-typedef std::vector<EnchStoreItem> EnchStoreList;
-typedef std::unordered_map<uint32, EnchStoreList> EnchantmentStore;
+typedef std::vector<std::pair<uint32, float> > EnchStoreList;
+
+// indexed by item_enchantment_template.entry, empty groups for unused ids
+static std::vector<EnchGroup> RandomItemEnch;
+
+static void CompileEnchGroup(EnchStoreList const& list, EnchGroup& group)
+{
+    // chances past 100% could never be rolled, the rest is spread over what is left
+    std::vector<float> weights;
+    float total = 0.0f;
+    for (auto const& itr : list)
+    {
+        float chance = std::min(itr.second, 100.0f - total);
+        if (chance <= 0.0f)
+            break;
+
+        group.ench.push_back(itr.first);
+        weights.push_back(chance);
+        total += chance;
+    }
+
+    uint32 size = group.ench.size();
+    group.probability.assign(size, 1.0f);
+    group.alias.resize(size);
 
-static EnchantmentStore RandomItemEnch;
+    std::vector<uint32> small, large;
+    for (uint32 i = 0; i < size; ++i)
+    {
+        group.alias[i] = i;
+        weights[i] = weights[i] * size / total;
+        (weights[i] < 1.0f ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        uint32 less = small.back();
+        small.pop_back();
+        uint32 more = large.back();
+
+        group.probability[less] = weights[less];
+        group.alias[less] = more;
+
+        weights[more] -= 1.0f - weights[less];
+        if (weights[more] < 1.0f)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // leftovers of either list are only float rounding away from 1 and keep their own column
+}
 
 void LoadRandomEnchantmentsTable()
 {
@@ -52,6 +105,7 @@ void LoadRandomEnchantmentsTable()
 
     if (result)
     {
+        std::map<uint32, EnchStoreList> enchantments;
         BarGoLink bar(result->GetRowCount());
 
         do
@@ -64,7 +118,7 @@ void LoadRandomEnchantmentsTable()
             float chance = fields[2].GetFloat();
 
             if (chance > 0.000001f && chance <= 100.0f)
-                RandomItemEnch[entry].push_back(EnchStoreItem(ench, chance));
+                enchantments[entry].push_back(EnchStoreList::value_type(ench, chance));
 
             ++count;
         }
@@ -72,6 +126,12 @@ void LoadRandomEnchantmentsTable()
 
         delete result;
 
+        if (!enchantments.empty())
+            RandomItemEnch.resize(enchantments.rbegin()->first + 1);
+
+        for (auto const& itr : enchantments)
+            CompileEnchGroup(itr.second, RandomItemEnch[itr.first]);
+
         sLog.outString(">> Loaded %u Item Enchantment definitions", count);
     }
     else
@@ -84,43 +144,22 @@ uint32 GetItemEnchantMod(uint32 entry)
 {
     if (!entry) return 0;
 
-    EnchantmentStore::const_iterator tab = RandomItemEnch.find(entry);
-
-    if (tab == RandomItemEnch.end())
+    if (entry >= RandomItemEnch.size() || RandomItemEnch[entry].IsEmpty())
     {
         sLog.outErrorDb("Item RandomProperty / RandomSuffix id #%u used in `item_template` but it doesn't have records in `item_enchantment_template` table.", entry);
         return 0;
     }
 
-    double dRoll = rand_chance();
-    float fCount = 0;
-
-    const EnchStoreList& enchantList = tab->second;
-    for (auto ench_iter : enchantList)
-    {
-        fCount += ench_iter.chance;
-
-        if (fCount > dRoll) return ench_iter.ench;
-    }
-
-    // we could get here only if sum of all enchantment chances is lower than 100%
-    dRoll = (irand(0, (int)floor(fCount * 100) + 1)) / 100;
-    fCount = 0;
-
-    for (auto ench_iter : enchantList)
-    {
-        fCount += ench_iter.chance;
-
-        if (fCount > dRoll) return ench_iter.ench;
-    }
-
-    return 0;
+    return RandomItemEnch[entry].Roll();
 }
 
 uint32 GenerateEnchSuffixFactor(uint32 item_id)
 {
-    ItemPrototype const* itemProto = ObjectMgr::GetItemPrototype(item_id);
+    return GenerateEnchSuffixFactor(ObjectMgr::GetItemPrototype(item_id));
+}
 
+uint32 GenerateEnchSuffixFactor(ItemPrototype const* itemProto)
+{
     if (!itemProto)
         return 0;
     if (!itemProto->RandomSuffix)
@@ -21,7 +21,10 @@
 
 #include "Common.h"
 
+struct ItemPrototype;
+
 void LoadRandomEnchantmentsTable();
 uint32 GetItemEnchantMod(uint32 entry);
 uint32 GenerateEnchSuffixFactor(uint32 item_id);
+uint32 GenerateEnchSuffixFactor(ItemPrototype const* itemProto);
 #endif
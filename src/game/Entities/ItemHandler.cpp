@@ -725,6 +725,7 @@ void WorldSession::HandleListInventoryOpcode(WorldPacket& recv_data)
 void WorldSession::SendListInventory(ObjectGuid vendorguid) const
 {
     DEBUG_LOG("WORLD: Sent SMSG_LIST_INVENTORY");
+    ConditionCacheScope conditionCache;
 
     Creature* pCreature = GetPlayer()->GetNPCIfCanInteractWith(vendorguid, UNIT_NPC_FLAG_VENDOR);
 
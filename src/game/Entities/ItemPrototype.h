@@ -20,6 +20,7 @@
 #define _ITEMPROTOTYPE_H
 
 #include "Common.h"
+#include "Globals/LocalizedString.h"
 
 enum ItemModType
 {
@@ -731,8 +732,8 @@ struct ItemPrototype
 
 struct ItemLocale
 {
-    std::vector<std::string> Name;
-    std::vector<std::string> Description;
+    LocalizedString Name;
+    LocalizedString Description;
 };
 
 #endif
@@ -43,6 +43,7 @@
 #include "Social/SocialMgr.h"
 #include "Server/DBCEnums.h"
 #include "GMTickets/GMTicketMgr.h"
+#include "Social/WhoListIndex.h"
 
 void WorldSession::HandleRepopRequestOpcode(WorldPacket& recv_data)
 {
@@ -152,80 +153,82 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
     data << uint32(matchcount);                             // placeholder, count of players matching criteria
     data << uint32(displaycount);                           // placeholder, count of players displayed
 
-    // TODO: Guard Player map
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+    // player can see member of other team only if CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST
+    WhoListIndex::Query query;
+    query.levelMin = level_min;
+    query.levelMax = level_max;
+    query.teamMask = security == SEC_PLAYER && !allowTwoSideWhoList ? (1 << GetTeamIndexByTeamId(team)) : ((1 << PVP_TEAM_COUNT) - 1);
+    query.zoneIds.assign(zoneids, zoneids + zones_count);
+
+    // guild names of this query, case folded once per guild
+    struct GuildName
+    {
+        std::string name;
+        std::wstring folded;
+        bool valid;                                         // name is valid utf8
+    };
+    std::unordered_map<uint32, GuildName> guildNames;
+
+    WhoListIndex::Search(query, [&](WhoListIndex::Entry const& entry)
     {
-        Player* pl = itr->second;
+        Player* pl = entry.player;
 
         if (security == SEC_PLAYER)
         {
-            // player can see member of other team only if CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST
-            if (pl->GetTeam() != team && !allowTwoSideWhoList)
-                continue;
-
             // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
             if (pl->GetSession()->GetSecurity() > gmLevelInWhoList)
-                continue;
+                return;
         }
 
         // do not process players which are not in world
         if (!pl->IsInWorld())
-            continue;
+            return;
 
         // check if target is globally visible for player
         if (!pl->IsVisibleGloballyFor(_player))
-            continue;
+            return;
 
-        // check if target's level is in level range
-        uint32 lvl = pl->GetLevel();
-        if (lvl < level_min || lvl > level_max)
-            continue;
+        // level range and zones are selected by the index
+        uint32 lvl = entry.level;
 
         // check if class matches classmask
         uint32 class_ = pl->getClass();
         if (!(classmask & (1 << class_)))
-            continue;
+            return;
 
         // check if race matches racemask
         uint32 race = pl->getRace();
         if (!(racemask & (1 << race)))
-            continue;
+            return;
 
-        uint32 pzoneid = pl->GetZoneId();
+        uint32 pzoneid = entry.zoneId;
         uint8 gender = pl->getGender();
 
-        bool z_show = true;
-        for (uint32 i = 0; i < zones_count; ++i)
-        {
-            if (zoneids[i] == pzoneid)
-            {
-                z_show = true;
-                break;
-            }
+        std::wstring const& wpname = entry.name;
+        if (wpname.empty())
+            return;
 
-            z_show = false;
-        }
-        if (!z_show)
-            continue;
+        if (!(wplayer_name.empty() || wpname.find(wplayer_name) != std::wstring::npos))
+            return;
 
-        std::string pname = pl->GetName();
-        std::wstring wpname;
-        if (!Utf8toWStr(pname, wpname))
-            continue;
-        wstrToLower(wpname);
+        auto guildItr = guildNames.find(pl->GetGuildId());
+        if (guildItr == guildNames.end())
+        {
+            GuildName guildName;
+            guildName.name = sGuildMgr.GetGuildNameById(pl->GetGuildId());
+            guildName.valid = Utf8toWStr(guildName.name, guildName.folded);
+            wstrToLower(guildName.folded);
+            guildItr = guildNames.emplace(pl->GetGuildId(), std::move(guildName)).first;
+        }
 
-        if (!(wplayer_name.empty() || wpname.find(wplayer_name) != std::wstring::npos))
-            continue;
+        if (!guildItr->second.valid)
+            return;
 
-        std::string gname = sGuildMgr.GetGuildNameById(pl->GetGuildId());
-        std::wstring wgname;
-        if (!Utf8toWStr(gname, wgname))
-            continue;
-        wstrToLower(wgname);
+        std::string const& gname = guildItr->second.name;
+        std::wstring const& wgname = guildItr->second.folded;
 
         if (!(wguild_name.empty() || wgname.find(wguild_name) != std::wstring::npos))
-            continue;
+            return;
 
         std::string aname;
         if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(pzoneid))
@@ -247,22 +250,22 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
             }
         }
         if (!s_show)
-            continue;
+            return;
 
         // 49 is maximum player count sent to client
         if (++matchcount > 49)
-            continue;
+            return;
 
         ++displaycount;
 
-        data << pname;                                      // player name
+        data << pl->GetNameStr();                           // player name
         data << gname;                                      // guild name
         data << uint32(lvl);                                // player level
         data << uint32(class_);                             // player class
         data << uint32(race);                               // player race
         data << uint8(gender);                              // player gender
         data << uint32(pzoneid);                            // player zone id
-    }
+    });
 
     if (sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS) && matchcount > sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS))
         matchcount = sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS);
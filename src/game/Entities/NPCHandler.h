@@ -19,6 +19,8 @@
 #ifndef __NPCHANDLER_H
 #define __NPCHANDLER_H
 
+#include "Globals/LocalizedString.h"
+
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
 #if defined( __GNUC__ )
 #pragma pack(1)
@@ -50,8 +52,8 @@ struct NpcTextLocale
 {
     NpcTextLocale() { Text_0.resize(8); Text_1.resize(8); }
 
-    std::vector<std::vector<std::string> > Text_0;
-    std::vector<std::vector<std::string> > Text_1;
+    std::vector<LocalizedString> Text_0;
+    std::vector<LocalizedString> Text_1;
 };
 
 struct QEmote
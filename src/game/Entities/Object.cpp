@@ -86,7 +86,7 @@ void Object::_InitValues()
     m_uint32Values = new uint32[ m_valuesCount ];
     memset(m_uint32Values, 0, m_valuesCount * sizeof(uint32));
 
-    m_changedValues.resize(m_valuesCount, false);
+    m_changedValues.SetCount(m_valuesCount);
 
     m_objectUpdated = false;
 }
@@ -207,14 +207,40 @@ void Object::SendCreateUpdateToPlayer(Player* player) const
     }
 }
 
-void Object::BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target) const
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target, SharedUpdateBlocks* sharedBlocks /*= nullptr*/) const
 {
     UpdateMask updateMask;
     updateMask.SetCount(m_valuesCount);
 
     _SetUpdateBits(updateMask, target);
-    if (updateMask.HasData())
-        BuildValuesUpdateBlockForPlayer(data, updateMask, target);
+    if (!updateMask.HasData())
+        return;
+
+    // observers seeing the same fields get the very same bytes, unless some field is altered per target
+    if (sharedBlocks && IsValuesUpdateTargetIndependent(updateMask))
+    {
+        uint8 const* mask = updateMask.GetMask();
+        for (auto const& block : *sharedBlocks)
+        {
+            if (block.first.size() == updateMask.GetLength() && memcmp(block.first.data(), mask, updateMask.GetLength()) == 0)
+            {
+                data.AddUpdateBlock(block.second);
+                return;
+            }
+        }
+
+        sharedBlocks->emplace_back(std::vector<uint8>(mask, mask + updateMask.GetLength()), ByteBuffer(500));
+        ByteBuffer& buf = sharedBlocks->back().second;
+
+        buf << uint8(UPDATETYPE_VALUES);
+        buf << GetPackGUID();
+
+        BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
+        data.AddUpdateBlock(buf);
+        return;
+    }
+
+    BuildValuesUpdateBlockForPlayer(data, updateMask, target);
 }
 
 void Object::BuildValuesUpdateBlockForPlayerWithFlags(UpdateData& data, Player* target, UpdateFieldFlags flags) const
@@ -527,367 +553,380 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     // 2 specialized loops for speed optimization in non-unit case
     if (isType(TYPEMASK_UNIT))                              // unit (creature/player) case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->FindNextSetBit(0); index < m_valuesCount; index = updateMask->FindNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            if (index == UNIT_NPC_FLAGS)
             {
-                if (index == UNIT_NPC_FLAGS)
+                uint32 appendValue = m_uint32Values[index];
+
+                if (GetTypeId() == TYPEID_UNIT)
                 {
-                    uint32 appendValue = m_uint32Values[index];
+                    if (!target->canSeeSpellClickOn((Creature*)this))
+                        appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
 
-                    if (GetTypeId() == TYPEID_UNIT)
+                    if (appendValue & UNIT_NPC_FLAG_TRAINER)
                     {
-                        if (!target->canSeeSpellClickOn((Creature*)this))
-                            appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
-
-                        if (appendValue & UNIT_NPC_FLAG_TRAINER)
-                        {
-                            if (!((Creature*)this)->IsTrainerOf(target, false))
-                                appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
-                        }
+                        if (!((Creature*)this)->IsTrainerOf(target, false))
+                            appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
+                    }
 
-                        if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
-                        {
-                            if (target->getClass() != CLASS_HUNTER)
-                                appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
-                        }
+                    if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
+                    {
+                        if (target->getClass() != CLASS_HUNTER)
+                            appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
+                    }
 
-                        if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
+                    if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
+                    {
+                        QuestRelationsMapBounds bounds = sObjectMgr.GetCreatureQuestRelationsMapBounds(((Creature*)this)->GetEntry());
+                        for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
                         {
-                            QuestRelationsMapBounds bounds = sObjectMgr.GetCreatureQuestRelationsMapBounds(((Creature*)this)->GetEntry());
-                            for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+                            Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
+                            if (target->CanSeeStartQuest(pQuest))
                             {
-                                Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
-                                if (target->CanSeeStartQuest(pQuest))
-                                {
-                                    appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
-                                    break;
-                                }
+                                appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
+                                break;
                             }
+                        }
 
-                            bounds = sObjectMgr.GetCreatureQuestInvolvedRelationsMapBounds(((Creature*)this)->GetEntry());
-                            for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+                        bounds = sObjectMgr.GetCreatureQuestInvolvedRelationsMapBounds(((Creature*)this)->GetEntry());
+                        for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+                        {
+                            Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
+                            if (target->CanRewardQuest(pQuest, false))
                             {
-                                Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
-                                if (target->CanRewardQuest(pQuest, false))
-                                {
-                                    appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
-                                    break;
-                                }
+                                appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
+                                break;
                             }
                         }
                     }
+                }
 
-                    *data << uint32(appendValue);
+                *data << uint32(appendValue);
+            }
+            else if (index == UNIT_FIELD_AURASTATE)
+            {
+                if (IsPerCasterAuraState)
+                {
+                    // IsPerCasterAuraState set if related pet caster aura state set already
+                    if (((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
+                        *data << m_uint32Values[index];
+                    else
+                        *data << (m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1)));
                 }
-                else if (index == UNIT_FIELD_AURASTATE)
+                else
+                    *data << m_uint32Values[index];
+            }
+            // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+            else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
+            {
+                // convert from float to uint32 and send
+                *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+            }
+
+            // there are some float values which may be negative or can't get negative due to other checks
+            else if ((index >= UNIT_FIELD_NEGSTAT0 && index <= UNIT_FIELD_NEGSTAT4) ||
+                     (index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
+                     (index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
+                     (index >= UNIT_FIELD_POSSTAT0 && index <= UNIT_FIELD_POSSTAT4))
+            {
+                *data << uint32(m_floatValues[index]);
+            }
+            else if (index == UNIT_FIELD_HEALTH || index == UNIT_FIELD_MAXHEALTH)
+            {
+                uint32 value = m_uint32Values[index];
+
+                // Fog of War: replace absolute health values with percentages for non-allied units according to settings
+                if (!static_cast<const Unit*>(this)->IsFogOfWarVisibleHealth(target) &&
+                    !target->CanSeeSpecialInfoOf(static_cast<const Unit*>(this)))
                 {
-                    if (IsPerCasterAuraState)
+                    switch (index)
                     {
-                        // IsPerCasterAuraState set if related pet caster aura state set already
-                        if (((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
-                            *data << m_uint32Values[index];
-                        else
-                            *data << (m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1)));
+                        case UNIT_FIELD_HEALTH:     value = uint32(ceil((100.0 * value) / m_uint32Values[UNIT_FIELD_MAXHEALTH]));   break;
+                        case UNIT_FIELD_MAXHEALTH:  value = 100;                                                                    break;
                     }
-                    else
-                        *data << m_uint32Values[index];
                 }
-                // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-                else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
+
+                *data << value;
+            }
+            else if (index == UNIT_FIELD_FLAGS)
+            {
+                uint32 value = m_uint32Values[index];
+
+                // For gamemasters in GM mode:
+                if (target->IsGameMaster())
                 {
-                    // convert from float to uint32 and send
-                    *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+                    // Gamemasters should be always able to select units - remove not selectable flag:
+                    value &= ~UNIT_FLAG_UNINTERACTIBLE;
                 }
 
-                // there are some float values which may be negative or can't get negative due to other checks
-                else if ((index >= UNIT_FIELD_NEGSTAT0 && index <= UNIT_FIELD_NEGSTAT4) ||
-                         (index >= UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
-                         (index >= UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (UNIT_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
-                         (index >= UNIT_FIELD_POSSTAT0 && index <= UNIT_FIELD_POSSTAT4))
+                // Client bug workaround: Fix for missing chat channels when resuming taxi flight on login
+                // Client does not send any chat joining attempts by itself when taxi flag is on
+                if (target == this && (value & UNIT_FLAG_TAXI_FLIGHT))
                 {
-                    *data << uint32(m_floatValues[index]);
+                    if (sWorld.getConfig(CONFIG_BOOL_TAXI_FLIGHT_CHAT_FIX))
+                        if (WorldSession* session = static_cast<Player const*>(this)->GetSession())
+                            if (!session->IsInitialZoneUpdated())
+                                value &= ~UNIT_FLAG_TAXI_FLIGHT;
                 }
-                else if (index == UNIT_FIELD_HEALTH || index == UNIT_FIELD_MAXHEALTH)
-                {
-                    uint32 value = m_uint32Values[index];
 
-                    // Fog of War: replace absolute health values with percentages for non-allied units according to settings
-                    if (!static_cast<const Unit*>(this)->IsFogOfWarVisibleHealth(target) &&
-                        !target->CanSeeSpecialInfoOf(static_cast<const Unit*>(this)))
+                *data << value;
+            }
+            // Hide special-info for non empathy-casters,
+            // Hide lootable animation for unallowed players
+            // Handle tapped flag
+            else if (index == UNIT_DYNAMIC_FLAGS)
+            {
+                Creature const* creature = static_cast<Creature const*>(this);
+                uint32 dynflagsValue = m_uint32Values[index];
+                bool setTapFlags = false;
+
+                if (creature->IsAlive())
+                {
+                    // Checking SPELL_AURA_EMPATHY and caster
+                    if (dynflagsValue & UNIT_DYNFLAG_SPECIALINFO)
                     {
-                        switch (index)
+                        bool bIsEmpathy = false;
+                        bool bIsCaster = false;
+                        Unit::AuraList const& mAuraEmpathy = creature->GetAurasByType(SPELL_AURA_EMPATHY);
+                        for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
                         {
-                            case UNIT_FIELD_HEALTH:     value = uint32(ceil((100.0 * value) / m_uint32Values[UNIT_FIELD_MAXHEALTH]));   break;
-                            case UNIT_FIELD_MAXHEALTH:  value = 100;                                                                    break;
+                            bIsEmpathy = true;              // Empathy by aura set
+                            if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
+                                bIsCaster = true;           // target is the caster of an empathy aura
                         }
+                        if (bIsEmpathy && !bIsCaster)       // Empathy by aura, but target is not the caster
+                            dynflagsValue &= ~UNIT_DYNFLAG_SPECIALINFO;
                     }
 
-                    *data << value;
-                }
-                else if (index == UNIT_FIELD_FLAGS)
-                {
-                    uint32 value = m_uint32Values[index];
-
-                    // For gamemasters in GM mode:
-                    if (target->IsGameMaster())
+                    // creature is alive so, not lootable
+                    dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+                    if (creature->IsInCombat())
                     {
-                        // Gamemasters should be always able to select units - remove not selectable flag:
-                        value &= ~UNIT_FLAG_UNINTERACTIBLE;
+                        // as creature is in combat we have to manage tap flags
+                        setTapFlags = true;
                     }
-
-                    // Client bug workaround: Fix for missing chat channels when resuming taxi flight on login
-                    // Client does not send any chat joining attempts by itself when taxi flag is on
-                    if (target == this && (value & UNIT_FLAG_TAXI_FLIGHT))
+                    else
                     {
-                        if (sWorld.getConfig(CONFIG_BOOL_TAXI_FLIGHT_CHAT_FIX))
-                            if (WorldSession* session = static_cast<Player const*>(this)->GetSession())
-                                if (!session->IsInitialZoneUpdated())
-                                    value &= ~UNIT_FLAG_TAXI_FLIGHT;
+                        // creature is not in combat so its not tapped
+                        dynflagsValue = dynflagsValue & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
+                        //sLog.outString(">> %s is not in combat so not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
                     }
-
-                    *data << value;
                 }
-                // Hide special-info for non empathy-casters,
-                // Hide lootable animation for unallowed players
-                // Handle tapped flag
-                else if (index == UNIT_DYNAMIC_FLAGS)
+                else
                 {
-                    Creature const* creature = static_cast<Creature const*>(this);
-                    uint32 dynflagsValue = m_uint32Values[index];
-                    bool setTapFlags = false;
-
-                    if (creature->IsAlive())
+                    // check loot flag
+                    if (creature->m_loot && creature->m_loot->CanLoot(target))
                     {
-                        // Checking SPELL_AURA_EMPATHY and caster
-                        if (dynflagsValue & UNIT_DYNFLAG_SPECIALINFO)
-                        {
-                            bool bIsEmpathy = false;
-                            bool bIsCaster = false;
-                            Unit::AuraList const& mAuraEmpathy = creature->GetAurasByType(SPELL_AURA_EMPATHY);
-                            for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
-                            {
-                                bIsEmpathy = true;              // Empathy by aura set
-                                if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
-                                    bIsCaster = true;           // target is the caster of an empathy aura
-                            }
-                            if (bIsEmpathy && !bIsCaster)       // Empathy by aura, but target is not the caster
-                                dynflagsValue &= ~UNIT_DYNFLAG_SPECIALINFO;
-                        }
-
-                        // creature is alive so, not lootable
-                        dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-                        if (creature->IsInCombat())
-                        {
-                            // as creature is in combat we have to manage tap flags
-                            setTapFlags = true;
-                        }
-                        else
-                        {
-                            // creature is not in combat so its not tapped
-                            dynflagsValue = dynflagsValue & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
-                            //sLog.outString(">> %s is not in combat so not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                        }
+                        // creature is dead and this player can loot it
+                        dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
+                        //sLog.outString(">> %s is lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
                     }
                     else
                     {
-                        // check loot flag
-                        if (creature->m_loot && creature->m_loot->CanLoot(target))
-                        {
-                            // creature is dead and this player can loot it
-                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
-                            //sLog.outString(">> %s is lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                        }
-                        else
-                        {
-                            // creature is dead but this player cannot loot it
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-                            //sLog.outString(">> %s is not lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                        }
-
-                        // as creature is died we have to manage tap flags
-                        setTapFlags = true;
+                        // creature is dead but this player cannot loot it
+                        dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+                        //sLog.outString(">> %s is not lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
                     }
 
-                    // check tap flags
-                    if (setTapFlags)
+                    // as creature is died we have to manage tap flags
+                    setTapFlags = true;
+                }
+
+                // check tap flags
+                if (setTapFlags)
+                {
+                    dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
+                    if (creature->IsTappedBy(target))
                     {
-                        dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
-                        if (creature->IsTappedBy(target))
-                        {
-                            // creature is in combat or died and tapped by this player
-                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                            //sLog.outString(">> %s is tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                        }
-                        else
-                        {
-                            // creature is in combat or died but not tapped by this player
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                            //sLog.outString(">> %s is not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                        }
+                        // creature is in combat or died and tapped by this player
+                        dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED_BY_PLAYER;
+                        //sLog.outString(">> %s is tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
                     }
-
-                    if (GetTypeId() == TYPEID_UNIT || GetTypeId() == TYPEID_PLAYER)
+                    else
                     {
-                        Unit const* unit = static_cast<const Unit*>(this); // hunters mark effects should only be visible to owners and not all players
-                        if (!unit->HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetObjectGuid()))
-                            dynflagsValue &= ~UNIT_DYNFLAG_TRACK_UNIT;
+                        // creature is in combat or died but not tapped by this player
+                        dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
+                        //sLog.outString(">> %s is not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
                     }
+                }
 
-                    *data << dynflagsValue;
+                if (GetTypeId() == TYPEID_UNIT || GetTypeId() == TYPEID_PLAYER)
+                {
+                    Unit const* unit = static_cast<const Unit*>(this); // hunters mark effects should only be visible to owners and not all players
+                    if (!unit->HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetObjectGuid()))
+                        dynflagsValue &= ~UNIT_DYNFLAG_TRACK_UNIT;
                 }
-                else if (index == UNIT_FIELD_FACTIONTEMPLATE)
+
+                *data << dynflagsValue;
+            }
+            else if (index == UNIT_FIELD_FACTIONTEMPLATE)
+            {
+                uint32 value = m_uint32Values[index];
+
+                // [XFACTION]: Alter faction if detected crossfaction group interaction when updating faction field:
+                if (this != target && GetTypeId() == TYPEID_PLAYER)
                 {
-                    uint32 value = m_uint32Values[index];
+                    Player const* thisPlayer = static_cast<Player const*>(this);
 
-                    // [XFACTION]: Alter faction if detected crossfaction group interaction when updating faction field:
-                    if (this != target && GetTypeId() == TYPEID_PLAYER)
+                    if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP) && target->IsInGroup(thisPlayer))
                     {
-                        Player const* thisPlayer = static_cast<Player const*>(this);
+                        const uint32 targetTeam = target->GetTeam();
 
-                        if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP) && target->IsInGroup(thisPlayer))
+                        if (thisPlayer->GetTeam() != targetTeam && value == Player::getFactionForRace(thisPlayer->getRace()))
                         {
-                            const uint32 targetTeam = target->GetTeam();
-
-                            if (thisPlayer->GetTeam() != targetTeam && value == Player::getFactionForRace(thisPlayer->getRace()))
+                            switch (targetTeam)
                             {
-                                switch (targetTeam)
-                                {
-                                    case ALLIANCE:  value = 1054;   break;  // "Alliance Generic"
-                                    case HORDE:     value = 1495;   break;  // "Horde Generic"
-                                }
+                                case ALLIANCE:  value = 1054;   break;  // "Alliance Generic"
+                                case HORDE:     value = 1495;   break;  // "Horde Generic"
                             }
                         }
                     }
-
-                    *data << value;
-                }
-                else                                        // Unhandled index, just send
-                {
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[index];
                 }
+
+                *data << value;
+            }
+            else                                            // Unhandled index, just send
+            {
+                // send in current format (float as float, uint32 as uint32)
+                *data << m_uint32Values[index];
             }
         }
     }
     else if (isType(TYPEMASK_CORPSE))                       // corpse case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->FindNextSetBit(0); index < m_valuesCount; index = updateMask->FindNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            if (index == CORPSE_FIELD_BYTES_1)
             {
-                if (index == CORPSE_FIELD_BYTES_1)
+                uint32 value = m_uint32Values[index];
+
+                // [XFACTION]: Alter race field if detected crossfaction group interaction:
+                if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP))
                 {
-                    uint32 value = m_uint32Values[index];
+                    Corpse const* thisCorpse = static_cast<Corpse const*>(this);
+                    ObjectGuid const& ownerGuid = thisCorpse->GetOwnerGuid();
+                    Group const* targetGroup = target->GetGroup();
 
-                    // [XFACTION]: Alter race field if detected crossfaction group interaction:
-                    if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP))
+                    if (ownerGuid != target->GetObjectGuid() && targetGroup && targetGroup->IsMember(ownerGuid))
                     {
-                        Corpse const* thisCorpse = static_cast<Corpse const*>(this);
-                        ObjectGuid const& ownerGuid = thisCorpse->GetOwnerGuid();
-                        Group const* targetGroup = target->GetGroup();
-
-                        if (ownerGuid != target->GetObjectGuid() && targetGroup && targetGroup->IsMember(ownerGuid))
-                        {
-                            const uint8 targetRace = target->getRace();
+                        const uint8 targetRace = target->getRace();
 
-                            if (Player::TeamForRace(thisCorpse->getRace()) != Player::TeamForRace(targetRace))
-                                value = ((value &~ uint32(0xFF << 8)) | (uint32(targetRace) << 8));
-                        }
+                        if (Player::TeamForRace(thisCorpse->getRace()) != Player::TeamForRace(targetRace))
+                            value = ((value &~ uint32(0xFF << 8)) | (uint32(targetRace) << 8));
                     }
-
-                    *data << value;
                 }
-                else
-                    *data << m_uint32Values[index];         // other cases
+
+                *data << value;
             }
+            else
+                *data << m_uint32Values[index];             // other cases
         }
     }
     else if (isType(TYPEMASK_GAMEOBJECT))                   // gameobject case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->FindNextSetBit(0); index < m_valuesCount; index = updateMask->FindNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
+            // send in current format (float as float, uint32 as uint32)
+            if (index == GAMEOBJECT_DYNAMIC)
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYNAMIC)
-                {
-                    // GAMEOBJECT_TYPE_DUNGEON_DIFFICULTY can have lo flag = 2
-                    //      most likely related to "can enter map" and then should be 0 if can not enter
+                // GAMEOBJECT_TYPE_DUNGEON_DIFFICULTY can have lo flag = 2
+                //      most likely related to "can enter map" and then should be 0 if can not enter
 
-                    if (IsActivateToQuest)
+                if (IsActivateToQuest)
+                {
+                    GameObject const* gameObject = static_cast<GameObject const*>(this);
+                    switch (((GameObject*)this)->GetGoType())
                     {
-                        GameObject const* gameObject = static_cast<GameObject const*>(this);
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_QUESTGIVER:
-                                // GO also seen with GO_DYNFLAG_LO_SPARKLE explicit, relation/reason unclear (192861)
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
-                                *data << uint16(-1);
-                                break;
-                            case GAMEOBJECT_TYPE_CHEST:
-                                if (gameObject->GetLootState() == GO_READY || gameObject->GetLootState() == GO_ACTIVATED)
-                                    *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
-                                else
-                                    *data << uint16(0);
-                                *data << uint16(-1);
-                                break;
-                            case GAMEOBJECT_TYPE_GENERIC:
-                            case GAMEOBJECT_TYPE_SPELL_FOCUS:
-                            case GAMEOBJECT_TYPE_GOOBER:
+                        case GAMEOBJECT_TYPE_QUESTGIVER:
+                            // GO also seen with GO_DYNFLAG_LO_SPARKLE explicit, relation/reason unclear (192861)
+                            *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
+                            *data << uint16(-1);
+                            break;
+                        case GAMEOBJECT_TYPE_CHEST:
+                            if (gameObject->GetLootState() == GO_READY || gameObject->GetLootState() == GO_ACTIVATED)
                                 *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
-                                *data << uint16(-1);
-                                break;
-                            default:
-                                // unknown, not happen.
+                            else
                                 *data << uint16(0);
-                                *data << uint16(-1);
-                                break;
-                        }
+                            *data << uint16(-1);
+                            break;
+                        case GAMEOBJECT_TYPE_GENERIC:
+                        case GAMEOBJECT_TYPE_SPELL_FOCUS:
+                        case GAMEOBJECT_TYPE_GOOBER:
+                            *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
+                            *data << uint16(-1);
+                            break;
+                        default:
+                            // unknown, not happen.
+                            *data << uint16(0);
+                            *data << uint16(-1);
+                            break;
                     }
-                    else
+                }
+                else
+                {
+                    GameObject const* gameObject = static_cast<GameObject const*>(this);
+                    switch (((GameObject*)this)->GetGoType())
                     {
-                        GameObject const* gameObject = static_cast<GameObject const*>(this);
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_TRANSPORT:
-                            case GAMEOBJECT_TYPE_MO_TRANSPORT:
-                                *data << m_uint32Values[index];
-                                break;
-                            default:
-                                // disable quest object
-                                *data << uint16(0);
-                                *data << uint16(-1);
-                                break;
-                        }
+                        case GAMEOBJECT_TYPE_TRANSPORT:
+                        case GAMEOBJECT_TYPE_MO_TRANSPORT:
+                            *data << m_uint32Values[index];
+                            break;
+                        default:
+                            // disable quest object
+                            *data << uint16(0);
+                            *data << uint16(-1);
+                            break;
                     }
                 }
-                else
-                    *data << m_uint32Values[index];         // other cases
             }
+            else
+                *data << m_uint32Values[index];             // other cases
         }
     }
     else                                                    // other objects case (no special index checks)
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        for (uint32 index = updateMask->FindNextSetBit(0); index < m_valuesCount; index = updateMask->FindNextSetBit(index + 1))
         {
-            if (updateMask->GetBit(index))
-            {
-                // send in current format (float as float, uint32 as uint32)
-                *data << m_uint32Values[index];
-            }
+            // send in current format (float as float, uint32 as uint32)
+            *data << m_uint32Values[index];
         }
     }
 }
 
-void Object::ClearUpdateMask(bool remove)
+// true when BuildValuesUpdate writes the same bytes for every target receiving this mask
+bool Object::IsValuesUpdateTargetIndependent(UpdateMask const& updateMask) const
 {
-    if (m_uint32Values)
+    if (isType(TYPEMASK_UNIT))
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
-            m_changedValues[index] = false;
+        if (((Unit*)this)->HasAuraState(AURA_STATE_CONFLAGRATE))
+            return false;
+
+        if (updateMask.GetBit(UNIT_NPC_FLAGS) || updateMask.GetBit(UNIT_FIELD_AURASTATE) || updateMask.GetBit(UNIT_FIELD_FLAGS) ||
+                updateMask.GetBit(UNIT_DYNAMIC_FLAGS) || updateMask.GetBit(UNIT_FIELD_FACTIONTEMPLATE))
+            return false;
+
+        // health only differs per target with fog of war enabled
+        if (sWorld.getConfig(CONFIG_UINT32_FOGOFWAR_HEALTH) < 2 && (updateMask.GetBit(UNIT_FIELD_HEALTH) || updateMask.GetBit(UNIT_FIELD_MAXHEALTH)))
+            return false;
+
+        return true;
     }
 
+    if (isType(TYPEMASK_GAMEOBJECT))                        // GAMEOBJECT_DYNAMIC is always sent per target
+        return ((GameObject*)this)->IsDynTransport();
+
+    if (isType(TYPEMASK_CORPSE))
+        return !updateMask.GetBit(CORPSE_FIELD_BYTES_1);
+
+    return true;
+}
+
+void Object::ClearUpdateMask(bool remove)
+{
+    if (m_uint32Values)
+        m_changedValues.Clear();
+
     if (m_objectUpdated)
     {
         if (remove)
@@ -976,23 +1015,26 @@ void Object::MarkUpdateFieldsWithFlagForUpdate(UpdateMask& updateMask, uint16 fl
 
 void Object::_SetUpdateBits(UpdateMask& updateMask, Player* target) const
 {
+    if (!m_changedValues.HasData())
+        return;
+
     uint16 const* flags = nullptr;
     uint16 visibleFlag = GetUpdateFieldFlagsForTarget(target, flags);
-    MANGOS_ASSERT(flags);
+    UpdateMask const* visibleMask = UpdateFields::GetUpdateFieldVisibilityMask(GetTypeId(), visibleFlag);
+    MANGOS_ASSERT(visibleMask);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
-        if (m_changedValues[index] && (flags[index] & visibleFlag))
-            updateMask.SetBit(index);
+    updateMask.SetIntersection(m_changedValues, *visibleMask);
 }
 
 void Object::_SetCreateBits(UpdateMask& updateMask, Player* target) const
 {
     uint16 const* flags = nullptr;
     uint16 visibleFlag = GetUpdateFieldFlagsForTarget(target, flags);
-    MANGOS_ASSERT(flags);
+    UpdateMask const* visibleMask = UpdateFields::GetUpdateFieldVisibilityMask(GetTypeId(), visibleFlag);
+    MANGOS_ASSERT(visibleMask);
 
-    for (uint16 index = 0; index < m_valuesCount; ++index)
-        if (GetUInt32Value(index) != 0 && (flags[index] & visibleFlag))
+    for (uint32 index = visibleMask->FindNextSetBit(0); index < m_valuesCount; index = visibleMask->FindNextSetBit(index + 1))
+        if (GetUInt32Value(index) != 0)
             updateMask.SetBit(index);
 }
 
@@ -1003,7 +1045,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
     if (m_int32Values[index] != value)
     {
         m_int32Values[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -1015,7 +1057,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     if (m_uint32Values[index] != value)
     {
         m_uint32Values[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -1027,8 +1069,8 @@ void Object::SetUInt64Value(uint16 index, const uint64& value)
     {
         m_uint32Values[index] = *((uint32*)&value);
         m_uint32Values[index + 1] = *(((uint32*)&value) + 1);
-        m_changedValues[index] = true;
-        m_changedValues[index + 1] = true;
+        m_changedValues.SetBit(index);
+        m_changedValues.SetBit(index + 1);
         MarkForClientUpdate();
     }
 }
@@ -1040,7 +1082,7 @@ void Object::SetFloatValue(uint16 index, float value)
     if (m_floatValues[index] != value)
     {
         m_floatValues[index] = value;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -1059,7 +1101,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -1078,7 +1120,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
     {
         m_uint32Values[index] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[index] |= uint32(uint32(value) << (offset * 16));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -1140,7 +1182,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -1154,7 +1196,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     if (oldval != newval)
     {
         m_uint32Values[index] = newval;
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -1172,7 +1214,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     if (!(uint8(m_uint32Values[index] >> (offset * 8)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -1190,7 +1232,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     if (uint8(m_uint32Values[index] >> (offset * 8)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (offset * 8));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -1202,7 +1244,7 @@ void Object::SetShortFlag(uint16 index, bool highpart, uint16 newFlag)
     if (!(uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & newFlag))
     {
         m_uint32Values[index] |= uint32(uint32(newFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -1214,7 +1256,7 @@ void Object::RemoveShortFlag(uint16 index, bool highpart, uint16 oldFlag)
     if (uint16(m_uint32Values[index] >> (highpart ? 16 : 0)) & oldFlag)
     {
         m_uint32Values[index] &= ~uint32(uint32(oldFlag) << (highpart ? 16 : 0));
-        m_changedValues[index] = true;
+        m_changedValues.SetBit(index);
         MarkForClientUpdate();
     }
 }
@@ -1235,7 +1277,7 @@ bool Object::PrintEntryError(char const* descr) const
     return false;
 }
 
-void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, SharedUpdateBlocks* sharedBlocks /*= nullptr*/) const
 {
     UpdateDataMapType::iterator iter = update_players.find(pl);
 
@@ -1246,7 +1288,7 @@ void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_play
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(iter->second, iter->first);
+    BuildValuesUpdateBlockForPlayer(iter->second, iter->first, sharedBlocks);
 }
 
 void Object::AddToClientUpdateList()
@@ -1281,7 +1323,7 @@ void Object::MarkForClientUpdate()
 
 void Object::ForceValuesUpdateAtIndex(uint16 index)
 {
-    m_changedValues[index] = true;
+    m_changedValues.SetBit(index);
     if (m_inWorld && !m_objectUpdated)
     {
         AddToClientUpdateList();
@@ -1293,7 +1335,7 @@ WorldObject::WorldObject() :
     m_transportInfo(nullptr), m_isOnEventNotified(false),
     m_currMap(nullptr), m_mapId(0),
     m_InstanceId(0), m_phaseMask(PHASEMASK_NORMAL), m_isActiveObject(false), m_visibilityData(this),
-    m_debugFlags(0), m_transport(nullptr), m_destLocCounter(0), m_castCounter(0)
+    m_debugFlags(0), m_transport(nullptr), m_destLocCounter(0), m_castCounter(0), m_updateGeneration(0)
 {
 }
 
@@ -1317,6 +1359,7 @@ void WorldObject::_Create(uint32 guidlow, HighGuid guidhigh, uint32 phaseMask)
 {
     Object::_Create(guidlow, guidlow, 0, guidhigh);
     m_phaseMask = phaseMask;
+    UpdateGridPosition();
 }
 
 void WorldObject::Relocate(float x, float y, float z, float orientation)
@@ -1328,6 +1371,8 @@ void WorldObject::Relocate(float x, float y, float z, float orientation)
 
     if (isType(TYPEMASK_UNIT))
         m_movementInfo.ChangePosition(x, y, z, orientation);
+
+    UpdateGridPosition();
 }
 
 void WorldObject::Relocate(float x, float y, float z)
@@ -1338,6 +1383,8 @@ void WorldObject::Relocate(float x, float y, float z)
 
     if (isType(TYPEMASK_UNIT))
         m_movementInfo.ChangePosition(x, y, z, GetOrientation());
+
+    UpdateGridPosition();
 }
 
 void WorldObject::SetOrientation(float orientation)
@@ -1508,6 +1555,29 @@ bool WorldObject::IsWithinLOSInMap(const WorldObject* obj, bool ignoreM2Model) c
     return IsWithinLOS(x, y, z + obj->GetCollisionHeight(), ignoreM2Model);
 }
 
+void WorldObject::RemoveNotInLOSInMap(UnitList& targets, bool ignoreM2Model) const
+{
+    if (targets.empty())
+        return;
+
+    std::vector<Position> points;
+    points.reserve(targets.size());
+    for (Unit* target : targets)
+        points.emplace_back(target->GetPositionX(), target->GetPositionY(), target->GetPositionZ() + target->GetCollisionHeight());
+
+    std::vector<bool> visible;
+    GetMap()->IsInLineOfSight(GetPositionX(), GetPositionY(), GetPositionZ() + GetCollisionHeight(), points, GetPhaseMask(), ignoreM2Model, visible);
+
+    size_t index = 0;
+    for (UnitList::iterator itr = targets.begin(); itr != targets.end(); ++index)
+    {
+        if (!visible[index] || !IsInMap(*itr))
+            itr = targets.erase(itr);
+        else
+            ++itr;
+    }
+}
+
 bool WorldObject::IsWithinLOS(float ox, float oy, float oz, bool ignoreM2Model) const
 {
     float x, y, z;
@@ -2053,6 +2123,39 @@ void WorldObject::SendMessageToSetExcept(WorldPacket const& data, Player const*
     }
 }
 
+void WorldObject::SendMovementToSetExcept(WorldPacket&& data, Player const* skipped_receiver)
+{
+    if (!IsInWorld())
+        return;
+
+    // far observers skip most heartbeats, state changes always reach everyone
+    float fullRateDistance = 0.0f;
+    if (data.GetOpcode() == MSG_MOVE_HEARTBEAT && GetMap()->GetFullRateRelayDistance() > 0.0f && GetVisibilityData().IsThrottledHeartbeat())
+        fullRateDistance = GetMap()->GetFullRateRelayDistance();
+
+    if (!fullRateDistance && !sWorld.getConfig(CONFIG_BOOL_NETWORK_BATCH_MOVEMENT_RELAY))
+    {
+        SendMessageToSetExcept(data, skipped_receiver);
+        return;
+    }
+
+    MaNGOS::MovementRelayCollector collector(this, skipped_receiver, fullRateDistance);
+    Cell::VisitWorldObjects(this, collector, GetMap()->GetVisibilityDistance());
+    if (collector.i_receivers.empty())
+        return;
+
+    // relays are flushed by the map after it processed its session packets, any other caller
+    // (world thread handlers, object updates) sends at once to stay in order with its other packets
+    if (!sWorld.getConfig(CONFIG_BOOL_NETWORK_BATCH_MOVEMENT_RELAY) || MapAccessScope::GetMap() != GetMap())
+    {
+        for (Player* receiver : collector.i_receivers)
+            receiver->GetSession()->SendPacket(data);
+        return;
+    }
+
+    GetMap()->QueueMovementRelay(collector.i_receivers, std::make_shared<WorldPacket const>(std::move(data)));
+}
+
 void WorldObject::SendMessageToAllWhoSeeMe(WorldPacket const& data, bool /*self*/) const
 {
     if (IsInWorld())
@@ -2523,6 +2626,7 @@ void WorldObject::GetNearPointAt(const float posX, const float posY, const float
 void WorldObject::SetPhaseMask(uint32 newPhaseMask, bool update)
 {
     m_phaseMask = newPhaseMask;
+    UpdateGridPosition();
 
     if (update && IsInWorld())
         UpdateVisibilityAndView();
@@ -2613,6 +2717,7 @@ struct WorldObjectChangeAccumulator
 {
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
+    SharedUpdateBlocks i_sharedBlocks;                      // serialized once per distinct mask, copied to every observer
     WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj)
     {
         // send self fields changes in another way, otherwise
@@ -2627,7 +2732,7 @@ struct WorldObjectChangeAccumulator
         {
             Player* owner = iter.getSource()->GetOwner();
             if (owner != &i_object && owner->HasAtClient(&i_object))
-                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas);
+                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas, &i_sharedBlocks);
         }
     }
 
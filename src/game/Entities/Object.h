@@ -24,6 +24,7 @@
 #include "Util/ByteBuffer.h"
 #include "Entities/UpdateFields.h"
 #include "Entities/UpdateData.h"
+#include "Entities/UpdateMask.h"
 #include "Entities/ObjectGuid.h"
 #include "Entities/EntitiesMgr.h"
 #include "Globals/SharedDefines.h"
@@ -34,6 +35,7 @@
 #include "Entities/ObjectVisibility.h"
 #include "Grids/Cell.h"
 #include "Utilities/EventProcessor.h"
+#include "Util/TickArena.h"
 
 #include <set>
 
@@ -120,7 +122,9 @@ struct SpellEntry;
 class Spell;
 class GenericTransport;
 
-typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
+typedef TickUnorderedMap<Player*, UpdateData> UpdateDataMapType;
+// values update blocks of one object serialized during one BuildUpdateData call, keyed by the raw update mask
+typedef std::vector<std::pair<std::vector<uint8>, ByteBuffer>> SharedUpdateBlocks;
 
 // Spell cooldown flags sent in SMSG_SPELL_COOLDOWN
 enum SpellCooldownFlags
@@ -214,16 +218,27 @@ typedef std::unique_ptr<CooldownData> CooldownDataUPTR;
 typedef std::map<uint32, TimePoint> GCDMap;
 typedef std::map<SpellSchools, TimePoint> LockoutMap;
 
+// Cooldowns of one object kept in a small vector sorted by spell id.
+// Objects rarely hold more than a handful of cooldowns, so a binary search over
+// contiguous storage beats a tree walk. Category owners sit in a second small
+// vector behind a 64 bit presence mask, and Update only scans the entries once
+// the earliest pending expiry has passed.
 class CooldownContainer
 {
     public:
-        typedef std::map<uint32, CooldownDataUPTR> spellIdMap;
+        typedef std::vector<std::pair<uint32, CooldownDataUPTR>> spellIdMap;
         typedef spellIdMap::const_iterator ConstIterator;
         typedef spellIdMap::iterator Iterator;
-        typedef std::map<uint32, ConstIterator> categoryMap;
+        typedef std::vector<std::pair<uint32 /*category*/, uint32 /*spellId*/>> categoryMap;
+
+        CooldownContainer() : m_categoryMask(0) {}
 
         void Update(TimePoint const& now)
         {
+            if (now < m_nextExpireTime)
+                return;
+
+            m_nextExpireTime = TimePoint::max();
             auto spellCDItr = m_spellIdMap.begin();
             while (spellCDItr != m_spellIdMap.end())
             {
@@ -234,9 +249,17 @@ class CooldownContainer
                 {
                     if (cd->m_category && cd->IsCatCDExpired(now))
                     {
-                        m_categoryMap.erase(cd->m_category);
+                        EraseCategory(cd->m_category);
                         cd->m_category = 0;
                     }
+
+                    if (!cd->m_typePermanent)
+                    {
+                        if (!cd->IsSpellCDExpired(now))
+                            m_nextExpireTime = std::min(m_nextExpireTime, cd->m_expireTime);
+                        if (!cd->IsCatCDExpired(now))
+                            m_nextExpireTime = std::min(m_nextExpireTime, cd->m_catExpireTime);
+                    }
                     ++spellCDItr;
                 }
             }
@@ -245,9 +268,9 @@ class CooldownContainer
         bool AddCooldown(TimePoint clockNow, uint32 spellId, uint32 duration, uint32 spellCategory = 0, uint32 categoryDuration = 0, uint32 itemId = 0, bool onHold = false)
         {
             RemoveBySpellId(spellId);
-            auto resultItr = m_spellIdMap.emplace(spellId, std::move(std::unique_ptr<CooldownData>(new CooldownData(clockNow, spellId, duration, spellCategory, categoryDuration, itemId, onHold))));
+            auto resultItr = m_spellIdMap.emplace(LowerBound(spellId), spellId, std::unique_ptr<CooldownData>(new CooldownData(clockNow, spellId, duration, spellCategory, categoryDuration, itemId, onHold)));
             // do not overwrite one permanent category cooldown with another permanent category cooldown
-            if (resultItr.second && spellCategory && categoryDuration)
+            if (spellCategory && categoryDuration)
             {
                 auto catItr = FindByCategory(spellCategory);
                 if (!onHold || catItr == m_spellIdMap.end() || !catItr->second->IsPermanent())
@@ -257,41 +280,37 @@ class CooldownContainer
                     {
                         catItr->second->SetCatCDExpireTime(std::chrono::milliseconds(categoryDuration) + clockNow);
                         catItr->second->m_typePermanent = false;
-                        resultItr.first->second->m_category = 0;
+                        resultItr->second->m_category = 0;
                     }
                     else
-                        m_categoryMap.emplace(spellCategory, resultItr.first);
+                    {
+                        m_categoryMap.emplace_back(spellCategory, spellId);
+                        m_categoryMask |= CategoryBit(spellCategory);
+                    }
                 }
                 else
-                    resultItr.first->second->m_category = 0;
+                    resultItr->second->m_category = 0;
             }
 
-            return resultItr.second;
+            // rescan at the next update to pick up the new expiry times
+            m_nextExpireTime = TimePoint();
+            return true;
         }
 
         void RemoveBySpellId(uint32 spellId)
         {
-            auto spellCDItr = m_spellIdMap.find(spellId);
+            auto spellCDItr = FindBySpellId(spellId);
             if (spellCDItr != m_spellIdMap.end())
-            {
-                auto& cdData = spellCDItr->second;
-                if (cdData->m_category)
-                {
-                    auto catCDItr = m_categoryMap.find(cdData->m_category);
-                    if (catCDItr != m_categoryMap.end())
-                        m_categoryMap.erase(catCDItr);
-                }
-                m_spellIdMap.erase(spellCDItr);
-            }
+                erase(spellCDItr);
         }
 
         void RemoveByCategory(uint32 category)
         {
-            auto spellCDItr = m_categoryMap.find(category);
-            if (spellCDItr != m_categoryMap.end())
+            auto spellCDItr = FindByCategory(category);
+            if (spellCDItr != m_spellIdMap.end())
             {
-                spellCDItr->second->second->m_category = 0;
-                m_categoryMap.erase(spellCDItr);
+                spellCDItr->second->m_category = 0;
+                EraseCategory(category);
             }
         }
 
@@ -299,23 +318,32 @@ class CooldownContainer
         {
             auto& cdData = spellCDItr->second;
             if (cdData->m_category)
-            {
-                auto catCDItr = m_categoryMap.find(cdData->m_category);
-                if (catCDItr != m_categoryMap.end())
-                    m_categoryMap.erase(catCDItr);
-            }
+                EraseCategory(cdData->m_category);
             return m_spellIdMap.erase(spellCDItr);
         }
 
-        ConstIterator FindBySpellId(uint32 id) const { return m_spellIdMap.find(id); }
+        ConstIterator FindBySpellId(uint32 id) const
+        {
+            auto itr = LowerBound(id);
+            return itr != m_spellIdMap.end() && itr->first == id ? itr : end();
+        }
 
         ConstIterator FindByCategory(uint32 category) const
         {
-            auto itr = m_categoryMap.find(category);
-            return itr != m_categoryMap.end() ? itr->second : end();
+            if (!(m_categoryMask & CategoryBit(category)))
+                return end();
+
+            for (auto const& catItr : m_categoryMap)
+                if (catItr.first == category)
+                    return FindBySpellId(catItr.second);
+
+            return end();
         }
 
-        void clear() { m_spellIdMap.clear(); m_categoryMap.clear(); }
+        // expiry times of stored cooldowns were changed from outside
+        void ScheduleUpdate() { m_nextExpireTime = TimePoint(); }
+
+        void clear() { m_spellIdMap.clear(); m_categoryMap.clear(); m_categoryMask = 0; }
 
         ConstIterator begin() const { return m_spellIdMap.begin(); }
         ConstIterator end() const { return m_spellIdMap.end(); }
@@ -323,8 +351,36 @@ class CooldownContainer
         size_t size() const { return m_spellIdMap.size(); }
 
     private:
+        static uint64 CategoryBit(uint32 category) { return uint64(1) << (category & 63); }
+
+        ConstIterator LowerBound(uint32 spellId) const
+        {
+            return std::lower_bound(m_spellIdMap.begin(), m_spellIdMap.end(), spellId,
+                [](spellIdMap::value_type const& entry, uint32 id) { return entry.first < id; });
+        }
+
+        void EraseCategory(uint32 category)
+        {
+            for (auto catItr = m_categoryMap.begin(); catItr != m_categoryMap.end(); ++catItr)
+            {
+                if (catItr->first != category)
+                    continue;
+
+                *catItr = m_categoryMap.back();
+                m_categoryMap.pop_back();
+                break;
+            }
+
+            // rebuild the mask so bits of other categories sharing the slot survive
+            m_categoryMask = 0;
+            for (auto const& catItr : m_categoryMap)
+                m_categoryMask |= CategoryBit(catItr.first);
+        }
+
         spellIdMap m_spellIdMap;
         categoryMap m_categoryMap;
+        uint64 m_categoryMask;                              // bit (category & 63) set while a category cooldown may exist
+        TimePoint m_nextExpireTime;                         // earliest expiry of a non permanent cooldown
 };
 
 struct Position
@@ -436,7 +492,7 @@ class Object
         void MarkForClientUpdate();
         void SendForcedObjectUpdate();
 
-        void BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target) const;
+        void BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target, SharedUpdateBlocks* sharedBlocks = nullptr) const;
         void BuildValuesUpdateBlockForPlayerWithFlags(UpdateData& data, Player* target, UpdateFieldFlags flags) const;
         void BuildValuesUpdateBlockForPlayer(UpdateData& data, UpdateMask& updateMask, Player* target) const;
         void BuildForcedValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
@@ -651,7 +707,8 @@ class Object
 
         void BuildMovementUpdate(ByteBuffer* data, uint16 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
-        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const;
+        bool IsValuesUpdateTargetIndependent(UpdateMask const& updateMask) const;
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, SharedUpdateBlocks* sharedBlocks = nullptr) const;
 
         uint16 m_objectType;
 
@@ -665,7 +722,7 @@ class Object
             float*  m_floatValues;
         };
 
-        std::vector<bool> m_changedValues;
+        UpdateMask m_changedValues;
 
         uint16 m_valuesCount;
 
@@ -1044,6 +1101,10 @@ class WorldObject : public Object
 
         virtual void SetPhaseMask(uint32 newPhaseMask, bool update);
         uint32 GetPhaseMask() const { return m_phaseMask; }
+
+        // refreshes the positional data the grid cell keeps for this object
+        virtual void UpdateGridPosition() {}
+        GridObjectPosition GetGridObjectPosition() const { return GridObjectPosition(m_position.x, m_position.y, m_position.z, std::max(GetObjectBoundingRadius(), GetCombatReach()), m_phaseMask); }
         bool InSamePhase(WorldObject const* obj) const { return InSamePhase(obj->GetPhaseMask()); }
         bool InSamePhase(uint32 phasemask) const { return (GetPhaseMask() & phasemask) != 0; }
 
@@ -1103,6 +1164,8 @@ class WorldObject : public Object
         bool IsWithinLOS(float ox, float oy, float oz, bool ignoreM2Model = false) const;
         bool IsWithinLOSForMe(float x, float y, float z, float collisionHeight, bool ignoreM2Model = false) const;
         bool IsWithinLOSInMap(const WorldObject* obj, bool ignoreM2Model = false) const;
+        // removes the units not in sight, tracing all rays from this object as one batch
+        void RemoveNotInLOSInMap(UnitList& targets, bool ignoreM2Model = false) const;
         bool GetDistanceOrder(WorldObject const* obj1, WorldObject const* obj2, bool is3D = true, DistanceCalculation distcalc = DIST_CALC_NONE) const;
         bool IsInRange(WorldObject const* obj, float minRange, float maxRange, bool is3D = true, bool combat = false) const;
         bool IsInRange2d(float x, float y, float minRange, float maxRange, bool combat = false) const;
@@ -1128,6 +1191,8 @@ class WorldObject : public Object
         virtual void SendMessageToSet(WorldPacket const& data, bool self) const;
         virtual void SendMessageToSetInRange(WorldPacket const& data, float dist, bool self) const;
         void SendMessageToSetExcept(WorldPacket const& data, Player const* skipped_receiver) const;
+        // relay movement to the set, batched per receiver until the session updates of the map are done
+        void SendMovementToSetExcept(WorldPacket&& data, Player const* skipped_receiver);
         virtual void SendMessageToAllWhoSeeMe(WorldPacket const& data, bool self) const;
 
         void MonsterSay(const char* text, uint32 language, Unit const* target = nullptr) const;
@@ -1273,6 +1338,16 @@ class WorldObject : public Object
         // Spell mod owner: static player whose spell mods apply to this unit (server-side)
         virtual Player* GetSpellModOwner() const { return nullptr; }
 
+        // Map::Update dedup, returns false if object is already queued for update in this map tick
+        bool MarkUpdateGeneration(uint32 generation)
+        {
+            if (m_updateGeneration == generation)
+                return false;
+            m_updateGeneration = generation;
+            return true;
+        }
+        uint32 GetUpdateGeneration() const { return m_updateGeneration; }
+
     protected:
         explicit WorldObject();
 
@@ -1318,6 +1393,8 @@ class WorldObject : public Object
         // Spell System compliance
         uint8 m_destLocCounter;
         uint32 m_castCounter;                               // count casts chain of triggered spells for prevent infinity cast crashes
+
+        uint32 m_updateGeneration;                          // last Map::Update tick this object was queued in
 };
 
 #endif
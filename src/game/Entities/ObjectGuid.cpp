@@ -74,6 +74,32 @@ uint32 ObjectGuidGenerator<high>::Generate()
     return m_nextGuid++;
 }
 
+template<HighGuid high>
+uint32 ObjectGuidGenerator<high>::GenerateLeased(uint32 blockSize)
+{
+    struct Lease
+    {
+        ObjectGuidGenerator const* owner;
+        uint32 epoch;
+        uint32 next;
+        uint32 end;
+    };
+    static thread_local Lease lease = { nullptr, 0, 0, 0 };
+
+    uint32 const epoch = m_epoch.load(std::memory_order_acquire);
+    if (lease.owner != this || lease.epoch != epoch || lease.next == lease.end)
+    {
+        uint32 const first = m_nextGuid.fetch_add(blockSize);
+        if (first >= ObjectGuid::GetMaxCounter(high) - blockSize)
+        {
+            sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", ObjectGuid::GetTypeName(high));
+            World::StopNow(ERROR_EXIT_CODE);
+        }
+        lease = { this, epoch, first, first + blockSize };
+    }
+    return lease.next++;
+}
+
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid)
 {
     buf << uint64(guid.GetRawValue());
@@ -109,3 +135,4 @@ template uint32 ObjectGuidGenerator<HIGHGUID_DYNAMICOBJECT>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_CORPSE>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_INSTANCE>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_GROUP>::Generate();
+template uint32 ObjectGuidGenerator<HIGHGUID_ITEM>::GenerateLeased(uint32 blockSize);
@@ -21,6 +21,7 @@
 
 #include "Common.h"
 #include "Util/ByteBuffer.h"
+#include "Util/OpenHashSet.h"
 #include <atomic>
 
 enum TypeID
@@ -237,17 +238,21 @@ template<HighGuid high>
 class ObjectGuidGenerator
 {
     public:                                                 // constructors
-        explicit ObjectGuidGenerator(uint32 start = 1) : m_nextGuid(start) {}
+        explicit ObjectGuidGenerator(uint32 start = 1) : m_nextGuid(start), m_epoch(0) {}
 
     public:                                                 // modifiers
-        void Set(uint32 val) { m_nextGuid = val; }
+        void Set(uint32 val) { m_nextGuid = val; ++m_epoch; }
         uint32 Generate();
+        // takes guids from a block of blockSize reserved per thread, so threads creating many objects
+        // do not contend on m_nextGuid; guids are unique but no longer increase across threads
+        uint32 GenerateLeased(uint32 blockSize);
 
     public:                                                 // accessors
         uint32 GetNextAfterMaxUsed() const { return m_nextGuid; }
 
     private:                                                // fields
         std::atomic<uint32> m_nextGuid;
+        std::atomic<uint32> m_epoch;                        // thread blocks taken before the last Set are dropped
 };
 
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid);
@@ -272,4 +277,7 @@ namespace std
     };
 }
 
+// flat set for hot membership checks, iteration order is unspecified
+typedef OpenHashSet<ObjectGuid> GuidHashSet;
+
 #endif
@@ -21,6 +21,7 @@
 #include "Util/Util.h"
 #include "Entities/Player.h"
 #include "Entities/GameObject.h"
+#include "World/World.h"
 
 constexpr float VisibilityDistances[AsUnderlyingType(VisibilityDistanceType::Max)] =
 {
@@ -32,7 +33,7 @@ constexpr float VisibilityDistances[AsUnderlyingType(VisibilityDistanceType::Max
     MAX_VISIBILITY_DISTANCE
 };
 
-VisibilityData::VisibilityData(WorldObject* owner) : m_visibilityDistanceOverride(0.f), m_invisibilityMask(0), m_detectInvisibilityMask(0), m_stealthMask(0), m_owner(owner)
+VisibilityData::VisibilityData(WorldObject* owner) : m_visibilityDistanceOverride(0.f), m_invisibilityMask(0), m_detectInvisibilityMask(0), m_stealthMask(0), m_heartbeatCounter(0), m_owner(owner)
 {
     memset(m_invisibilityValues, 0, sizeof(m_invisibilityValues));
     memset(m_invisibilityDetectValues, 0, sizeof(m_invisibilityDetectValues));
@@ -184,4 +185,10 @@ float VisibilityData::GetStealthVisibilityDistance(Unit const* target, bool aler
         visibilityRange += (visibilityRange * 0.08f) + 1.5f;
 
     return std::max(target->GetCombatReach(), visibilityRange);
-}
\ No newline at end of file
+}
+
+bool VisibilityData::IsThrottledHeartbeat()
+{
+    uint32 const rate = sWorld.getConfig(CONFIG_UINT32_THROTTLED_HEARTBEAT_RATE);
+    return rate > 1 && (m_heartbeatCounter++ % rate) != 0;
+}
@@ -81,6 +81,9 @@ class VisibilityData
         uint32 GetStealthDetectionStrength(StealthType type) const { return m_stealthDetectStrength[type]; }
 
         float GetStealthVisibilityDistance(Unit const* target, bool alert = false) const;
+
+        // level of detail: observers beyond the map's full rate distance only receive every Nth heartbeat of the owner
+        bool IsThrottledHeartbeat();
     private:
         // visibility
         float m_visibilityDistanceOverride;
@@ -93,6 +96,8 @@ class VisibilityData
         uint32 m_stealthMask;
         uint32 m_stealthStrength[STEALTH_TYPE_MAX];
         uint32 m_stealthDetectStrength[STEALTH_TYPE_MAX];
+        // relayed heartbeats, picks the ones far observers receive
+        uint32 m_heartbeatCounter;
 
         WorldObject* m_owner;
 };
@@ -51,7 +51,7 @@ void Pet::AddToWorld()
 {
     ///- Register the pet for guid lookup
     if (!IsInWorld())
-        GetMap()->GetObjectsStore().insert<Pet>(GetObjectGuid(), (Pet*)this);
+        GetMap()->InsertObject<Pet>(GetObjectGuid(), (Pet*)this);
 
     Unit::AddToWorld();
 
@@ -65,7 +65,7 @@ void Pet::RemoveFromWorld()
 {
     ///- Remove the pet from the accessor
     if (IsInWorld())
-        GetMap()->GetObjectsStore().erase<Pet>(GetObjectGuid(), (Pet*)nullptr);
+        GetMap()->EraseObject<Pet>(GetObjectGuid());
 
     ///- Don't call the function for Creature, normal mobs + totems go in a different storage
     Unit::RemoveFromWorld();
@@ -215,6 +215,7 @@ bool Pet::LoadPetFromDB(Player* owner, Position const& spawnPos, uint32 petentry
     m_petType = pet_type;
 
     uint32 pet_number = fields[0].GetUInt32();
+    PetSaveMode loadedSlot = PetSaveMode(fields[7].GetUInt32());
 
     if (!forced && owner->IsPetNeedBeTemporaryUnsummoned(nullptr))
     {
@@ -404,14 +405,17 @@ bool Pet::LoadPetFromDB(Player* owner, Position const& spawnPos, uint32 petentry
 
     SynchronizeLevelWithOwner();
 
-    SavePetToDB(PET_SAVE_AS_CURRENT, owner);
+    // a pet already stored as current matches its rows, changes since the load are written by
+    // the next dismiss or owner save - otherwise the slots must be moved now
+    if (loadedSlot != PET_SAVE_AS_CURRENT)
+        SavePetToDB(PET_SAVE_AS_CURRENT, owner);
 
     if (GenericTransport* transport = owner->GetTransport())
         transport->AddPetToTransport(owner, this);
     return true;
 }
 
-void Pet::SavePetToDB(PetSaveMode mode, Player* owner)
+void Pet::SavePetToDB(PetSaveMode mode, Player* owner, bool separate_transaction /*= true*/)
 {
     if (!GetEntry())
         return;
@@ -457,8 +461,9 @@ void Pet::SavePetToDB(PetSaveMode mode, Player* owner)
                 RemoveAllAuras();
         }
 
-        // save pet's data as one single transaction
-        CharacterDatabase.BeginTransaction();
+        // save pet's data as one single transaction, or as part of the owner's
+        if (separate_transaction)
+            CharacterDatabase.BeginTransaction(owner->GetGUIDLow());
         _SaveSpells();
         _SaveSpellCooldowns();
         _SaveAuras();
@@ -523,12 +528,13 @@ void Pet::SavePetToDB(PetSaveMode mode, Player* owner)
         savePet.addUInt32(uint32(getPetType()));
 
         savePet.Execute();
-        CharacterDatabase.CommitTransaction();
+        if (separate_transaction)
+            CharacterDatabase.CommitTransaction();
     }
     else
     {
         RemoveAllAuras(AURA_REMOVE_BY_DELETE);
-        DeleteFromDB(m_charmInfo->GetPetNumber());
+        DeleteFromDB(m_charmInfo->GetPetNumber(), separate_transaction);
     }
 }
 
@@ -1359,7 +1365,7 @@ void Pet::_LoadSpellCooldowns()
             m_cooldownMap.AddCooldown(GetMap()->GetCurrentClockTime(), spell_id, uint32(spellRecTime.count()));
 #ifdef _DEBUG
             uint32 spellCDDuration = std::chrono::duration_cast<std::chrono::seconds>(spellRecTime).count();
-            sLog.outDebug("Adding spell cooldown to %s, SpellID(%u), recDuration(%us).", GetGuidStr().c_str(), spell_id, spellCDDuration);
+            DEBUG_LOG("Adding spell cooldown to %s, SpellID(%u), recDuration(%us).", GetGuidStr().c_str(), spell_id, spellCDDuration);
 #endif
         }
         while (result->NextRow());
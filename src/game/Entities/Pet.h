@@ -154,7 +154,7 @@ class Pet : public Creature
         bool Create(uint32 guidlow, CreatureCreatePos& cPos, CreatureInfo const* cinfo, uint32 pet_number);
         bool CreateBaseAtCreature(Creature* creature);
         bool LoadPetFromDB(Player* owner, Position const& spawnPos, uint32 petentry = 0, uint32 petnumber = 0, bool current = false, uint32 healthPercentage = 0, bool permanentOnly = false, bool forced = false);
-        void SavePetToDB(PetSaveMode mode, Player* owner);
+        void SavePetToDB(PetSaveMode mode, Player* owner, bool separate_transaction = true);
         static Position GetPetSpawnPosition(Unit* owner);
         bool isLoading() const { return m_loading; }
         void SetLoading(bool state) { m_loading = state; }
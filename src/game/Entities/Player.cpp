@@ -44,6 +44,7 @@
 #include "Groups/Group.h"
 #include "Guilds/Guild.h"
 #include "Guilds/GuildMgr.h"
+#include "GameEvents/GameEventMgr.h"
 #include "Entities/Pet.h"
 #include "Util/Util.h"
 #include "Entities/Transports.h"
@@ -58,6 +59,7 @@
 #include "Spells/Spell.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 #include "Social/SocialMgr.h"
+#include "Social/WhoListIndex.h"
 #include "Achievements/AchievementMgr.h"
 #include "Mails/Mail.h"
 #include "Spells/SpellAuras.h"
@@ -92,10 +94,6 @@
 #define SKILL_PERM_BONUS(x)    int16(PAIR32_HIPART(x))
 #define MAKE_SKILL_BONUS(t, p) MAKE_PAIR32(t,p)
 
-#ifdef BUILD_PLAYERBOT
-extern Config botConfig;
-#endif
-
 enum CharacterFlags
 {
     CHARACTER_FLAG_NONE                 = 0x00000000,
@@ -533,6 +531,7 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     m_areaUpdateId = 0;
 
     m_nextSave = sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE);
+    m_saveDelay = 0;
 
     // randomize first save time in range [CONFIG_UINT32_INTERVAL_SAVE] around [CONFIG_UINT32_INTERVAL_SAVE]
     // this must help in case next save after mass player load after server startup
@@ -574,7 +573,10 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     m_currentBuybackSlot = BUYBACK_SLOT_START;
 
     m_DailyQuestChanged = false;
+    m_questGiverStatusGeneration = 0;
     m_WeeklyQuestChanged = false;
+    m_characterRowExists = false;
+    m_enteredInstancesChanged = false;
 
     m_lastLiquid = nullptr;
 
@@ -614,6 +616,7 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     //////////////////// Rest System/////////////////////
 
     m_mailsUpdated = false;
+    m_mailDataRequestPending = false;
     unReadMails = 0;
     m_nextMailDelivereTime = 0;
 
@@ -680,6 +683,7 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     m_isGhouled = false;
 
     m_createdInstanceClearTimer = MINUTE * IN_MILLISECONDS;
+    m_groupUpdateTimer = 0;
 
     m_cinematicMgr = nullptr;
 
@@ -1620,9 +1624,16 @@ void Player::Update(const uint32 diff)
     {
         if (diff >= m_nextSave)
         {
-            // m_nextSave reseted in SaveToDB call
-            SaveToDB();
-            DETAIL_LOG("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            // wait for the world save budget, so saves are spread across the interval instead of bursting
+            m_saveDelay += diff;
+            if (sWorld.RequestPlayerAutoSave(IsAutoSaveUrgent()))
+            {
+                // m_nextSave reseted in SaveToDB call
+                SaveToDB();
+                DETAIL_LOG("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            }
+            else
+                m_nextSave = 1;                             // retry next tick
         }
         else
             m_nextSave -= diff;
@@ -1694,6 +1705,17 @@ void Player::Update(const uint32 diff)
     else
         m_createdInstanceClearTimer -= diff;
 
+    if (uint32 groupUpdateInterval = sWorld.getConfig(CONFIG_UINT32_GROUP_MEMBER_STATS_INTERVAL))
+    {
+        if (m_groupUpdateTimer <= diff)
+        {
+            m_groupUpdateTimer = groupUpdateInterval;
+            SendUpdateToOutOfRangeGroupMembers();
+        }
+        else
+            m_groupUpdateTimer -= diff;
+    }
+
     Pet* pet = GetPet();
     if (pet && !pet->IsWithinDistInMap(this, GetMap()->GetVisibilityDistance()) && (GetCharmGuid() && (pet->GetObjectGuid() != GetCharmGuid())))
         pet->Unsummon(PET_SAVE_REAGENTS, this);
@@ -1712,7 +1734,8 @@ void Player::Update(const uint32 diff)
 void Player::Heartbeat()
 {
     Unit::Heartbeat();
-    SendUpdateToOutOfRangeGroupMembers();
+    if (!sWorld.getConfig(CONFIG_UINT32_GROUP_MEMBER_STATS_INTERVAL))
+        SendUpdateToOutOfRangeGroupMembers();
 }
 
 void Player::SetDeathState(DeathState s)
@@ -2890,6 +2913,8 @@ void Player::GiveLevel(uint32 level)
     if (level == GetLevel())
         return;
 
+    InvalidateQuestGiverStatusCache();
+
     uint32 plClass = getClass();
 
     PlayerLevelInfo info;
@@ -4042,8 +4067,8 @@ void Player::_LoadSpellCooldowns(QueryResult* result)
             std::string itemStr = "";
             if (item_id)
                 itemStr = " caused by item id(" + std::to_string(item_id) + ") ";
-            sLog.outDebug("Adding spell cooldown to %s, SpellID(%u), recDuration(%us), category(%u), catRecDuration(%us)%s.", GetGuidStr().c_str(),
-                          spell_id, spellCDDuration, category, catCDDuration, itemStr.c_str());
+            DEBUG_LOG("Adding spell cooldown to %s, SpellID(%u), recDuration(%us), category(%u), catRecDuration(%us)%s.", GetGuidStr().c_str(),
+                      spell_id, spellCDDuration, category, catCDDuration, itemStr.c_str());
 #endif
         }
         while (result->NextRow());
@@ -5682,6 +5707,7 @@ bool Player::UpdateSkill(uint16 id, uint16 diff)
         SetUInt32Value(valueIndex, MAKE_SKILL_VALUE(new_value, max));
         if (skillStatus.uState != SKILL_NEW)
             skillStatus.uState = SKILL_CHANGED;
+        InvalidateQuestGiverStatusCache();
         GetAchievementMgr().UpdateAchievementCriteria(ACHIEVEMENT_CRITERIA_TYPE_REACH_SKILL_LEVEL, id);
         return true;
     }
@@ -5846,6 +5872,7 @@ bool Player::UpdateSkillPro(uint16 SkillId, int32 Chance, uint16 diff)
         SetUInt32Value(valueIndex, MAKE_SKILL_VALUE(new_value, MaxValue));
         if (skillStatus.uState != SKILL_NEW)
             skillStatus.uState = SKILL_CHANGED;
+        InvalidateQuestGiverStatusCache();
         for (uint32* bsl = &bonusSkillLevels[0]; *bsl; ++bsl)
         {
             if ((SkillValue < *bsl && new_value >= *bsl))
@@ -6002,6 +6029,8 @@ void Player::SetSkill(SkillStatusMap::iterator itr, uint16 value, uint16 max, ui
             status.uState = SKILL_DELETED;
     }
 
+    InvalidateQuestGiverStatusCache();
+
     // Learn/unlearn all spells auto-trained by this skill on change
     UpdateSkillTrainedSpells(id, value);
 
@@ -7499,11 +7528,11 @@ void Player::UpdateZone(uint32 newZone, uint32 newArea, bool force)
         sWorldState.HandlePlayerLeaveZone(this, m_zoneUpdateId);
         sOutdoorPvPMgr.HandlePlayerEnterZone(this, newZone);
         sWorldState.HandlePlayerEnterZone(this, newZone);
+        WhoListIndex::UpdateZone(this, newZone);
 
         if (sWorld.getConfig(CONFIG_BOOL_WEATHER))
         {
-            Weather* wth = GetMap()->GetWeatherSystem()->FindOrCreateWeather(newZone);
-            wth->SendWeatherUpdateToPlayer(this);
+            GetMap()->GetWeatherSystem()->SendWeatherUpdateToPlayer(this, newZone);
         }
     }
 
@@ -7725,14 +7754,19 @@ void Player::_ApplyItemMods(Item* item, uint8 slot, bool apply)
 
     DETAIL_LOG("applying mods for item %u ", item->GetGUIDLow());
 
-    uint32 attacktype = Player::GetAttackBySlot(slot);
-    if (attacktype < MAX_ATTACK)
-        _ApplyWeaponDependentAuraMods(item, WeaponAttackType(attacktype), apply);
+    {
+        // all stats of the item change together, before equip spells get to see them
+        StatUpdateScope statUpdates(*this);
+
+        uint32 attacktype = Player::GetAttackBySlot(slot);
+        if (attacktype < MAX_ATTACK)
+            _ApplyWeaponDependentAuraMods(item, WeaponAttackType(attacktype), apply);
 
-    _ApplyItemBonuses(proto, slot, apply);
+        _ApplyItemBonuses(proto, slot, apply);
 
-    if (slot == EQUIPMENT_SLOT_RANGED)
-        _ApplyAmmoBonuses();
+        if (slot == EQUIPMENT_SLOT_RANGED)
+            _ApplyAmmoBonuses();
+    }
 
     ApplyItemEquipSpell(item, apply);
     ApplyEnchantment(item, apply);
@@ -8638,25 +8672,28 @@ void Player::_ApplyAllItemMods()
 {
     DEBUG_LOG("_ApplyAllItemMods start.");
 
-    for (int i = 0; i < INVENTORY_SLOT_BAG_END; ++i)
     {
-        if (m_items[i])
+        StatUpdateScope statUpdates(*this);
+        for (int i = 0; i < INVENTORY_SLOT_BAG_END; ++i)
         {
-            if (m_items[i]->IsBroken())
-                continue;
+            if (m_items[i])
+            {
+                if (m_items[i]->IsBroken())
+                    continue;
 
-            ItemPrototype const* proto = m_items[i]->GetProto();
-            if (!proto)
-                continue;
+                ItemPrototype const* proto = m_items[i]->GetProto();
+                if (!proto)
+                    continue;
 
-            uint32 attacktype = Player::GetAttackBySlot(i);
-            if (attacktype < MAX_ATTACK)
-                _ApplyWeaponDependentAuraMods(m_items[i], WeaponAttackType(attacktype), true);
+                uint32 attacktype = Player::GetAttackBySlot(i);
+                if (attacktype < MAX_ATTACK)
+                    _ApplyWeaponDependentAuraMods(m_items[i], WeaponAttackType(attacktype), true);
 
-            _ApplyItemBonuses(proto, i, true);
+                _ApplyItemBonuses(proto, i, true);
 
-            if (i == EQUIPMENT_SLOT_RANGED)
-                _ApplyAmmoBonuses();
+                if (i == EQUIPMENT_SLOT_RANGED)
+                    _ApplyAmmoBonuses();
+            }
         }
     }
 
@@ -8828,6 +8865,14 @@ void Player::SendUpdateWorldState(uint32 Field, uint32 Value) const
     GetSession()->SendPacket(data);
 }
 
+std::shared_ptr<WorldPacket const> Player::BuildUpdateWorldStatePacket(uint32 Field, uint32 Value)
+{
+    std::shared_ptr<WorldPacket> data = std::make_shared<WorldPacket>(SMSG_UPDATE_WORLD_STATE, 8);
+    *data << Field;
+    *data << Value;
+    return data;
+}
+
 void Player::SendInitWorldStates(uint32 zoneid, uint32 areaid) const
 {
     // data depends on zoneid/mapid...
@@ -9312,23 +9357,15 @@ InventoryResult Player::CanUnequipItems(uint32 item, uint32 count) const
 uint32 Player::GetItemCount(uint32 item, bool inBankAlso, Item* skipItem) const
 {
     uint32 count = 0;
-    for (int i = EQUIPMENT_SLOT_START; i < INVENTORY_SLOT_ITEM_END; ++i)
-    {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem != skipItem &&  pItem->GetEntry() == item)
-            count += pItem->GetCount();
-    }
-    for (int i = KEYRING_SLOT_START; i < CURRENCYTOKEN_SLOT_END; ++i)
-    {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem != skipItem && pItem->GetEntry() == item)
-            count += pItem->GetCount();
-    }
-    for (int i = INVENTORY_SLOT_BAG_START; i < INVENTORY_SLOT_BAG_END; ++i)
+    ItemCountIndex::const_iterator itr = m_itemCountIndex.find(item);
+    if (itr != m_itemCountIndex.end())
+        count = itr->second.inventory + (inBankAlso ? itr->second.bank : 0);
+
+    if (skipItem && skipItem->GetEntry() == item)
     {
-        Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pBag)
-            count += pBag->GetItemCount(item, skipItem);
+        ItemCountIndexState const& state = skipItem->GetCountIndexState();
+        if (state.owner == this && (inBankAlso || !state.inBank))
+            count -= state.count;
     }
 
     if (skipItem && skipItem->GetProto()->GemProperties)
@@ -9339,24 +9376,8 @@ uint32 Player::GetItemCount(uint32 item, bool inBankAlso, Item* skipItem) const
             if (pItem && pItem != skipItem && pItem->GetProto()->Socket[0].Color)
                 count += pItem->GetGemCountWithID(item);
         }
-    }
-
-    if (inBankAlso)
-    {
-        for (int i = BANK_SLOT_ITEM_START; i < BANK_SLOT_ITEM_END; ++i)
-        {
-            Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-            if (pItem && pItem != skipItem && pItem->GetEntry() == item)
-                count += pItem->GetCount();
-        }
-        for (int i = BANK_SLOT_BAG_START; i < BANK_SLOT_BAG_END; ++i)
-        {
-            Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-            if (pBag)
-                count += pBag->GetItemCount(item, skipItem);
-        }
 
-        if (skipItem && skipItem->GetProto()->GemProperties)
+        if (inBankAlso)
         {
             for (int i = BANK_SLOT_ITEM_START; i < BANK_SLOT_ITEM_END; ++i)
             {
@@ -9373,30 +9394,110 @@ uint32 Player::GetItemCount(uint32 item, bool inBankAlso, Item* skipItem) const
 uint32 Player::GetItemCountWithLimitCategory(uint32 limitCategory, Item* skipItem) const
 {
     uint32 count = 0;
-    for (int i = EQUIPMENT_SLOT_START; i < INVENTORY_SLOT_ITEM_END; ++i)
-        if (Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-            if (pItem->GetProto()->ItemLimitCategory == limitCategory && pItem != skipItem)
-                count += pItem->GetCount();
+    ItemLimitCategoryCountIndex::const_iterator itr = m_itemLimitCategoryCountIndex.find(limitCategory);
+    if (itr != m_itemLimitCategoryCountIndex.end())
+        count = itr->second;
 
-    for (int i = KEYRING_SLOT_START; i < CURRENCYTOKEN_SLOT_END; ++i)
-        if (Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-            if (pItem->GetProto()->ItemLimitCategory == limitCategory && pItem != skipItem)
-                count += pItem->GetCount();
+    if (skipItem && skipItem->GetProto()->ItemLimitCategory == limitCategory)
+    {
+        ItemCountIndexState const& state = skipItem->GetCountIndexState();
+        if (state.owner == this)
+            count -= state.count;
+    }
 
-    for (int i = INVENTORY_SLOT_BAG_START; i < INVENTORY_SLOT_BAG_END; ++i)
-        if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-            count += pBag->GetItemCountWithLimitCategory(limitCategory, skipItem);
+    return count;
+}
 
-    for (int i = BANK_SLOT_ITEM_START; i < BANK_SLOT_ITEM_END; ++i)
-        if (Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-            if (pItem->GetProto()->ItemLimitCategory == limitCategory && pItem != skipItem)
-                count += pItem->GetCount();
+void Player::UpdateItemCountIndex(Item* pItem)
+{
+    RemoveItemCountIndexState(pItem);
+    AddItemCountIndexState(pItem);
 
-    for (int i = BANK_SLOT_BAG_START; i < BANK_SLOT_BAG_END; ++i)
-        if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-            count += pBag->GetItemCountWithLimitCategory(limitCategory, skipItem);
+    if (pItem->IsBag())
+    {
+        Bag* pBag = (Bag*)pItem;
+        for (uint32 i = 0; i < pBag->GetBagSize(); ++i)
+            if (Item* bagItem = pBag->GetItemByPos(i))
+                UpdateItemCountIndex(bagItem);
+    }
+}
 
-    return count;
+void Player::RemoveItemFromCountIndex(Item* pItem)
+{
+    RemoveItemCountIndexState(pItem);
+
+    if (pItem->IsBag())
+    {
+        Bag* pBag = (Bag*)pItem;
+        for (uint32 i = 0; i < pBag->GetBagSize(); ++i)
+            if (Item* bagItem = pBag->GetItemByPos(i))
+                RemoveItemFromCountIndex(bagItem);
+    }
+}
+
+void Player::AddItemCountIndexState(Item* pItem)
+{
+    uint8 bag = pItem->GetBagSlot();
+    uint8 slot = pItem->GetSlot();
+
+    // equipped bank bags are not counted themselves, only their content
+    bool inBank;
+    if (IsEquipmentPos(bag, slot) || IsInventoryPos(bag, slot))
+        inBank = false;
+    else if (IsBankPos(bag, slot) && !IsBagPos(pItem->GetPos()))
+        inBank = true;
+    else
+        return;
+
+    // content of a bag kept in a plain inventory or bank slot
+    if (GetItemByPos(bag, slot) != pItem)
+        return;
+
+    ItemCountIndexState& state = pItem->GetCountIndexState();
+    state.owner = this;
+    state.count = pItem->GetCount();
+    state.inBank = inBank;
+
+    ItemCountIndexEntry& entry = m_itemCountIndex[pItem->GetEntry()];
+    if (inBank)
+        entry.bank += state.count;
+    else
+        entry.inventory += state.count;
+
+    if (uint32 limitCategory = pItem->GetProto()->ItemLimitCategory)
+        m_itemLimitCategoryCountIndex[limitCategory] += state.count;
+}
+
+void Player::RemoveItemCountIndexState(Item* pItem)
+{
+    ItemCountIndexState& state = pItem->GetCountIndexState();
+    if (state.owner != this)
+        return;
+
+    ItemCountIndex::iterator itr = m_itemCountIndex.find(pItem->GetEntry());
+    if (itr != m_itemCountIndex.end())
+    {
+        if (state.inBank)
+            itr->second.bank -= state.count;
+        else
+            itr->second.inventory -= state.count;
+
+        if (!itr->second.inventory && !itr->second.bank)
+            m_itemCountIndex.erase(itr);
+    }
+
+    if (uint32 limitCategory = pItem->GetProto()->ItemLimitCategory)
+    {
+        ItemLimitCategoryCountIndex::iterator catItr = m_itemLimitCategoryCountIndex.find(limitCategory);
+        if (catItr != m_itemLimitCategoryCountIndex.end())
+        {
+            catItr->second -= state.count;
+            if (!catItr->second)
+                m_itemLimitCategoryCountIndex.erase(catItr);
+        }
+    }
+
+    state = ItemCountIndexState();
 }
 
 Item* Player::GetItemByEntry(uint32 item) const
@@ -9671,75 +9772,24 @@ bool Player::IsValidPos(uint8 bag, uint8 slot, bool explicit_pos) const
 
 bool Player::HasItemCount(uint32 item, uint32 count, bool inBankAlso) const
 {
-    uint32 tempcount = 0;
-    for (int i = EQUIPMENT_SLOT_START; i < INVENTORY_SLOT_ITEM_END; ++i)
-    {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
-        {
-            tempcount += pItem->GetCount();
-            if (tempcount >= count)
-                return true;
-        }
-    }
-    for (int i = KEYRING_SLOT_START; i < CURRENCYTOKEN_SLOT_END; ++i)
-    {
-        Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-        if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
-        {
-            tempcount += pItem->GetCount();
-            if (tempcount >= count)
-                return true;
-        }
-    }
-    for (int i = INVENTORY_SLOT_BAG_START; i < INVENTORY_SLOT_BAG_END; ++i)
-    {
-        if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-        {
-            for (uint32 j = 0; j < pBag->GetBagSize(); ++j)
-            {
-                Item* pItem = GetItemByPos(i, j);
-                if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
-                {
-                    tempcount += pItem->GetCount();
-                    if (tempcount >= count)
-                        return true;
-                }
-            }
-        }
-    }
+    uint32 tempcount = GetItemCount(item, inBankAlso);
 
-    if (inBankAlso)
+    // items of a trade being completed are not available anymore
+    if (tempcount && m_trade)
     {
-        for (int i = BANK_SLOT_ITEM_START; i < BANK_SLOT_ITEM_END; ++i)
+        for (uint8 i = 0; i < TRADE_SLOT_TRADED_COUNT; ++i)
         {
-            Item* pItem = GetItemByPos(INVENTORY_SLOT_BAG_0, i);
-            if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
+            Item* pItem = m_trade->GetItem(TradeSlots(i));
+            if (pItem && pItem->GetEntry() == item && pItem->IsInTrade())
             {
-                tempcount += pItem->GetCount();
-                if (tempcount >= count)
-                    return true;
-            }
-        }
-        for (int i = BANK_SLOT_BAG_START; i < BANK_SLOT_BAG_END; ++i)
-        {
-            if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, i))
-            {
-                for (uint32 j = 0; j < pBag->GetBagSize(); ++j)
-                {
-                    Item* pItem = GetItemByPos(i, j);
-                    if (pItem && pItem->GetEntry() == item && !pItem->IsInTrade())
-                    {
-                        tempcount += pItem->GetCount();
-                        if (tempcount >= count)
-                            return true;
-                    }
-                }
+                ItemCountIndexState const& state = pItem->GetCountIndexState();
+                if (state.owner == this && (inBankAlso || !state.inBank))
+                    tempcount -= state.count;
             }
         }
     }
 
-    return false;
+    return tempcount && tempcount >= count;
 }
 
 bool Player::HasItemOrGemWithIdEquipped(uint32 item, uint32 count, uint8 except_slot) const
@@ -11413,6 +11463,7 @@ Item* Player::_StoreItem(uint16 pos, Item* pItem, uint32 count, bool clone, bool
 
             pItem->SetSlot(slot);
             pItem->SetContainer(nullptr);
+            UpdateItemCountIndex(pItem);
 
             // need update known currency
             if (slot >= CURRENCYTOKEN_SLOT_START && slot < CURRENCYTOKEN_SLOT_END)
@@ -11429,6 +11480,7 @@ Item* Player::_StoreItem(uint16 pos, Item* pItem, uint32 count, bool clone, bool
         else if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, bag))
         {
             pBag->StoreItem(slot, pItem);
+            UpdateItemCountIndex(pItem);
             if (IsInWorld() && update)
             {
                 pItem->AddToWorld();
@@ -11653,6 +11705,7 @@ void Player::VisualizeItem(uint8 slot, Item* pItem)
     pItem->SetGuidValue(ITEM_FIELD_OWNER, GetObjectGuid());
     pItem->SetSlot(slot);
     pItem->SetContainer(nullptr);
+    UpdateItemCountIndex(pItem);
 
     if (slot < EQUIPMENT_SLOT_END)
         SetVisibleItemSlot(slot, pItem);
@@ -11740,6 +11793,7 @@ void Player::RemoveItem(uint8 bag, uint8 slot, bool update)
             if (pBag)
                 pBag->RemoveItem(slot);
         }
+        RemoveItemFromCountIndex(pItem);
         pItem->SetGuidValue(ITEM_FIELD_CONTAINED, ObjectGuid());
         // pItem->SetGuidValue(ITEM_FIELD_OWNER, ObjectGuid()); not clear owner at remove (it will be set at store). This used in mail and auction code
         pItem->SetSlot(NULL_SLOT);
@@ -11872,6 +11926,8 @@ void Player::DestroyItem(uint8 bag, uint8 slot, bool update)
         else if (Bag* pBag = (Bag*)GetItemByPos(INVENTORY_SLOT_BAG_0, bag))
             pBag->RemoveItem(slot);
 
+        RemoveItemFromCountIndex(pItem);
+
         if (IsInWorld() && update)
         {
             pItem->RemoveFromWorld();
@@ -13289,6 +13345,7 @@ void Player::SendNewItem(Item* item, uint32 count, bool received, bool created,
 
 void Player::PrepareGossipMenu(WorldObject* pSource, uint32 menuId, bool forceQuests)
 {
+    ConditionCacheScope conditionCache;
     m_playerMenu->ClearMenus();
 
     m_playerMenu->GetGossipMenu().SetMenuId(menuId);
@@ -13405,17 +13462,17 @@ void Player::PrepareGossipMenu(WorldObject* pSource, uint32 menuId, bool forceQu
                 case GOSSIP_OPTION_BOT:
                 {
 #ifdef BUILD_PLAYERBOT
-                    if (botConfig.GetBoolDefault("PlayerbotAI.DisableBots", false) && !pCreature->isInnkeeper())
+                    if (botConfDisableBots.Get() && !pCreature->isInnkeeper())
                     {
                         ChatHandler(this).PSendSysMessage("|cffff0000Playerbot system is currently disabled!");
                         hasMenuItem = false;
                         break;
                     }
 
-                    int32 cost = botConfig.GetIntDefault("PlayerbotAI.BotguyCost", 0);
+                    int32 cost = botConfBotguyCost.Get();
                     if (cost >= 0)
                     {
-                        std::string reqQuestIds = botConfig.GetStringDefault("PlayerbotAI.BotguyQuests", "");
+                        std::string reqQuestIds = botConfBotguyQuests.Get();
                         if ((reqQuestIds == "" || requiredQuests(reqQuestIds.c_str())) && !pCreature->isInnkeeper() && this->GetMoney() >= (uint32)cost)
                             pCreature->LoadBotMenu(this);
                     }
@@ -13709,7 +13766,7 @@ void Player::OnGossipSelect(WorldObject* pSource, uint32 gossipListId, uint32 me
             // DEBUG_LOG("GOSSIP_OPTION_BOT");
             m_playerMenu->CloseGossip();
             uint32 guidlo = m_playerMenu->GossipOptionSender(gossipListId);
-            int32 cost = botConfig.GetIntDefault("PlayerbotAI.BotguyCost", 0);
+            int32 cost = botConfBotguyCost.Get();
 
             if (!GetPlayerbotMgr())
                 SetPlayerbotMgr(new PlayerbotMgr(this));
@@ -13724,7 +13781,7 @@ void Player::OnGossipSelect(WorldObject* pSource, uint32 gossipListId, uint32 me
                 if (resultchar)
                 {
                     Field* fields = resultchar->Fetch();
-                    int maxnum = botConfig.GetIntDefault("PlayerbotAI.MaxNumBots", 9);
+                    int maxnum = botConfMaxNumBots.Get();
                     int acctcharcount = fields[0].GetUInt32();
                     if (!(m_session->GetSecurity() > SEC_PLAYER))
                         if (acctcharcount > maxnum)
@@ -13740,7 +13797,7 @@ void Player::OnGossipSelect(WorldObject* pSource, uint32 gossipListId, uint32 me
                 if (resultlvl)
                 {
                     Field* fields = resultlvl->Fetch();
-                    int maxlvl = botConfig.GetIntDefault("PlayerbotAI.RestrictBotLevel", 80);
+                    int maxlvl = botConfRestrictBotLevel.Get();
                     int charlvl = fields[0].GetUInt32();
                     if (!(m_session->GetSecurity() > SEC_PLAYER))
                         if (charlvl > maxlvl)
@@ -14393,6 +14450,7 @@ void Player::AddQuest(Quest const* pQuest, Object* questGiver)
     for (SpellAreaForAreaMap::const_iterator itr = saBounds.first; itr != saBounds.second; ++itr)
         itr->second->ApplyOrRemoveSpellIfCan(this, zone, area, true);
 
+    InvalidateQuestGiverStatusCache();
     UpdateForQuestWorldObjects();
 }
 
@@ -14570,6 +14628,8 @@ void Player::RewardQuest(Quest const* pQuest, uint32 reward, Object* questGiver,
             q_status.uState = QUEST_CHANGED;
     }
 
+    InvalidateQuestGiverStatusCache();
+
     if (announce)
         SendQuestReward(pQuest, xp, honor);
 
@@ -15275,6 +15335,7 @@ void Player::SetQuestStatus(uint32 quest_id, QuestStatus status)
             q_status.uState = QUEST_CHANGED;
     }
 
+    InvalidateQuestGiverStatusCache();
     UpdateForQuestWorldObjects();
 }
 
@@ -15736,6 +15797,8 @@ enum TitleFactions
 
 void Player::ReputationChanged(FactionEntry const* factionEntry)
 {
+    InvalidateQuestGiverStatusCache();
+
     ReputationMgr const& repMgr = GetReputationMgr();
     for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
     {
@@ -16022,7 +16085,7 @@ void Player::SendQuestGiverStatusMultiple() const
             uint8 dialogStatus = sScriptDevAIMgr.GetDialogStatus(this, questgiver);
 
             if (dialogStatus == DIALOG_STATUS_UNDEFINED)
-                dialogStatus = GetSession()->getDialogStatus(this, questgiver, DIALOG_STATUS_NONE);
+                dialogStatus = GetQuestGiverDialogStatus(questgiver);
 
             data << questgiver->GetObjectGuid();
             data << uint8(dialogStatus);
@@ -16041,7 +16104,7 @@ void Player::SendQuestGiverStatusMultiple() const
             uint8 dialogStatus = sScriptDevAIMgr.GetDialogStatus(this, questgiver);
 
             if (dialogStatus == DIALOG_STATUS_UNDEFINED)
-                dialogStatus = GetSession()->getDialogStatus(this, questgiver, DIALOG_STATUS_NONE);
+                dialogStatus = GetQuestGiverDialogStatus(questgiver);
 
             data << questgiver->GetObjectGuid();
             data << uint8(dialogStatus);
@@ -16053,6 +16116,27 @@ void Player::SendQuestGiverStatusMultiple() const
     GetSession()->SendPacket(data);
 }
 
+uint32 Player::GetQuestGiverDialogStatus(Object const* questgiver) const
+{
+    uint32 generation = sGameEventMgr.GetQuestStateGeneration();
+    if (m_questGiverStatusGeneration != generation)
+    {
+        m_questGiverStatusCache.clear();
+        m_questGiverStatusGeneration = generation;
+    }
+
+    uint64 key = (uint64(questgiver->GetTypeId()) << 32) | questgiver->GetEntry();
+    auto itr = m_questGiverStatusCache.find(key);
+    if (itr != m_questGiverStatusCache.end())
+        return itr->second;
+
+    bool cacheable = true;
+    uint32 dialogStatus = GetSession()->getDialogStatus(this, questgiver, DIALOG_STATUS_NONE, &cacheable);
+    if (cacheable)
+        m_questGiverStatusCache.emplace(key, uint8(dialogStatus));
+    return dialogStatus;
+}
+
 /*********************************************************/
 /***                   LOAD SYSTEM                     ***/
 /*********************************************************/
@@ -16279,6 +16363,7 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
 
     // overwrite possible wrong/corrupted guid
     SetGuidValue(OBJECT_FIELD_GUID, guid);
+    m_characterRowExists = true;
 
     // overwrite some data fields
     SetByteValue(UNIT_FIELD_BYTES_0, UNIT_BYTES_0_OFFSET_RACE, fields[3].GetUInt8()); // race
@@ -17295,30 +17380,26 @@ void Player::_LoadItemLoot(QueryResult* result)
     }
 }
 
-// load mailed item which should receive current player
+// load the mailed item list of the player, the item instances are loaded when the mails are shown, see LoadMailItems
 void Player::_LoadMailedItems(QueryResult* result)
 {
-    // data needs to be at first place for Item::LoadFromDB
-    //        0          1            2                3      4         5        6      7             8                 9           10         11    12       13         14
-    // SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime text, mail_id, item_guid, item_template FROM mail_items JOIN item_instance ON item_guid = guid WHERE receiver = '%u'", m_guid.GetCounter());
+    //        0        1          2
+    // SELECT mail_id, item_guid, item_template FROM mail_items WHERE receiver = '%u'", m_guid.GetCounter());
     if (!result)
         return;
 
     do
     {
         Field* fields = result->Fetch();
-        uint32 mail_id       = fields[12].GetUInt32();
-        uint32 item_guid_low = fields[13].GetUInt32();
-        uint32 item_template = fields[14].GetUInt32();
+        uint32 mail_id       = fields[0].GetUInt32();
+        uint32 item_guid_low = fields[1].GetUInt32();
+        uint32 item_template = fields[2].GetUInt32();
 
         Mail* mail = GetMail(mail_id);
         if (!mail)
             continue;
-        mail->AddItem(item_guid_low, item_template);
 
-        ItemPrototype const* proto = ObjectMgr::GetItemPrototype(item_template);
-
-        if (!proto)
+        if (!ObjectMgr::GetItemPrototype(item_template))
         {
             sLog.outError("Player %u has unknown item_template (ProtoType) in mailed items(GUID: %u template: %u) in mail (%u), deleted.", GetGUIDLow(), item_guid_low, item_template, mail->messageID);
             CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", item_guid_low);
@@ -17326,18 +17407,8 @@ void Player::_LoadMailedItems(QueryResult* result)
             continue;
         }
 
-        Item* item = NewItemOrBag(proto);
-
-        if (!item->LoadFromDB(item_guid_low, fields, GetObjectGuid()))
-        {
-            sLog.outError("Player::_LoadMailedItems - Item in mail (%u) doesn't exist !!!! - item guid: %u, deleted from mail", mail->messageID, item_guid_low);
-            CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", item_guid_low);
-            item->FSetState(ITEM_REMOVED);
-            item->SaveToDB();                               // it also deletes item object !
-            continue;
-        }
-
-        AddMItem(item);
+        mail->AddItem(item_guid_low, item_template);
+        mail->itemsLoaded = false;
     }
     while (result->NextRow());
 
@@ -17347,8 +17418,8 @@ void Player::_LoadMailedItems(QueryResult* result)
 void Player::_LoadMails(QueryResult* result)
 {
     m_mail.clear();
-    //        0  1           2      3        4       5    6           7            8     9   10      11         12             13
-    //"SELECT id,messageType,sender,receiver,subject,body,expire_time,deliver_time,money,cod,checked,stationery,mailTemplateId,has_items FROM mail WHERE receiver = '%u' ORDER BY id DESC", GetGUIDLow()
+    //        0  1           2      3        4       5            6           7            8     9   10      11         12             13
+    //"SELECT id,messageType,sender,receiver,subject,LENGTH(body),expire_time,deliver_time,money,cod,checked,stationery,mailTemplateId,has_items FROM mail WHERE receiver = '%u' ORDER BY id DESC", GetGUIDLow()
     if (!result)
         return;
 
@@ -17361,7 +17432,7 @@ void Player::_LoadMails(QueryResult* result)
         m->sender = fields[2].GetUInt32();
         m->receiverGuid = ObjectGuid(HIGHGUID_PLAYER, fields[3].GetUInt32());
         m->subject = fields[4].GetCppString();
-        m->body = fields[5].GetCppString();
+        m->bodyLoaded = fields[5].GetUInt32() == 0;        // bodies are only fetched once the mailbox is opened
         m->expire_time = (time_t)fields[6].GetUInt64();
         m->deliver_time = (time_t)fields[7].GetUInt64();
         m->money = fields[8].GetUInt32();
@@ -17388,6 +17459,117 @@ void Player::_LoadMails(QueryResult* result)
     delete result;
 }
 
+void Player::LoadMailBodies(QueryResult* result, std::vector<uint32> const& mailIds)
+{
+    // empty result still means every requested body not found is empty
+    std::unordered_map<uint32, std::string> bodies;
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            bodies[fields[0].GetUInt32()] = fields[1].GetCppString();
+        }
+        while (result->NextRow());
+        delete result;
+    }
+
+    for (uint32 mailId : mailIds)
+    {
+        Mail* mail = GetMail(mailId);
+        if (!mail || mail->bodyLoaded)
+            continue;
+
+        auto itr = bodies.find(mailId);
+        if (itr != bodies.end())
+            mail->body = std::move(itr->second);
+        mail->bodyLoaded = true;
+    }
+}
+
+void Player::LoadMailItems(QueryResult* result, std::vector<uint32> const& mailIds)
+{
+    // data needs to be at first place for Item::LoadFromDB
+    //        0          1            2                3      4         5        6      7             8                 9           10          11    12       13
+    // SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, mail_id, item_guid FROM mail_items JOIN item_instance ON item_guid = guid WHERE mail_id IN (...)
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            uint32 mail_id       = fields[12].GetUInt32();
+            uint32 item_guid_low = fields[13].GetUInt32();
+
+            // the mail could have been deleted or its item taken meanwhile
+            Mail* mail = GetMail(mail_id);
+            if (!mail || mail->itemsLoaded || GetMItem(item_guid_low))
+                continue;
+
+            ItemPrototype const* proto = ObjectMgr::GetItemPrototype(fields[0].GetUInt32());
+            if (!proto)
+                continue;
+
+            Item* item = NewItemOrBag(proto);
+            if (!item->LoadFromDB(item_guid_low, fields, GetObjectGuid()))
+            {
+                sLog.outError("Player::LoadMailItems - Item in mail (%u) doesn't exist !!!! - item guid: %u, deleted from mail", mail->messageID, item_guid_low);
+                CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", item_guid_low);
+                item->FSetState(ITEM_REMOVED);
+                item->SaveToDB();                           // it also deletes item object !
+                continue;
+            }
+
+            AddMItem(item);
+        }
+        while (result->NextRow());
+        delete result;
+    }
+
+    for (uint32 mailId : mailIds)
+    {
+        Mail* mail = GetMail(mailId);
+        if (!mail || mail->itemsLoaded)
+            continue;
+
+        // drop item entries without instance, nothing could be taken from them
+        for (MailItemInfoVec::iterator itr = mail->items.begin(); itr != mail->items.end();)
+        {
+            if (!GetMItem(itr->item_guid))
+            {
+                sLog.outError("Player::LoadMailItems - Item in mail (%u) doesn't exist !!!! - item guid: %u, deleted from mail", mail->messageID, itr->item_guid);
+                CharacterDatabase.PExecute("DELETE FROM mail_items WHERE item_guid = '%u'", itr->item_guid);
+                itr = mail->items.erase(itr);
+            }
+            else
+                ++itr;
+        }
+        mail->itemsLoaded = true;
+    }
+}
+
+void Player::LoadMailBody(Mail* mail)
+{
+    if (mail->bodyLoaded)
+        return;
+
+    if (QueryResult* result = CharacterDatabase.PQuery("SELECT body FROM mail WHERE id = '%u'", mail->messageID))
+    {
+        mail->body = result->Fetch()[0].GetCppString();
+        delete result;
+    }
+    mail->bodyLoaded = true;
+}
+
+void Player::LoadMailItems(Mail* mail)
+{
+    if (mail->itemsLoaded)
+        return;
+
+    std::vector<uint32> mailIds(1, mail->messageID);
+    LoadMailItems(CharacterDatabase.PQuery("SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, mail_id, item_guid "
+                                           "FROM mail_items JOIN item_instance ON item_guid = guid WHERE mail_id = '%u'", mail->messageID), mailIds);
+}
+
 void Player::LoadPet()
 {
     // fixme: the pet should still be loaded if the player is not in world
@@ -18142,11 +18324,26 @@ bool Player::_LoadHomeBind(QueryResult* result)
 /***                   SAVE SYSTEM                     ***/
 /*********************************************************/
 
+bool Player::IsAutoSaveUrgent() const
+{
+    // waited half an interval already, do not postpone any further
+    if (m_saveDelay >= sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE) / 2)
+        return true;
+
+    // a lot of unsaved progress would be lost on crash, save it ahead of idle players
+    uint32 changes = m_itemUpdateQueue.size();
+    for (auto const& itr : mQuestStatus)
+        if (itr.second.uState != QUEST_UNCHANGED)
+            ++changes;
+    return changes >= PLAYER_SAVE_URGENT_CHANGES;
+}
+
 void Player::SaveToDB()
 {
     // we should assure this: ASSERT((m_nextSave != sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE)));
     // delay auto save at any saves (manual, in code, or autosave)
     m_nextSave = sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE);
+    m_saveDelay = 0;
 
     // lets allow only players in world to be saved
     if (IsBeingTeleportedFar())
@@ -18161,32 +18358,41 @@ void Player::SaveToDB()
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     outDebugStatsValues();
 
-    CharacterDatabase.BeginTransaction();
+    // keyed by character, saves of different characters may be committed in parallel
+    CharacterDatabase.BeginTransaction(GetGUIDLow());
 
-    static SqlStatementID delChar ;
     static SqlStatementID insChar ;
+    static SqlStatementID updChar ;
+
+    // both statements bind the same values in the same order with the guid last
+    // loaded characters keep their row, so only a newly created one needs the insert
+    SqlStatement uberInsert = m_characterRowExists ?
+                              CharacterDatabase.CreateStatement(updChar, "UPDATE characters SET account = ?, name = ?, race = ?, class = ?, gender = ?, level = ?, xp = ?, money = ?, playerBytes = ?, playerBytes2 = ?, playerFlags = ?, "
+                                      "map = ?, dungeon_difficulty = ?, position_x = ?, position_y = ?, position_z = ?, orientation = ?, "
+                                      "taximask = ?, online = ?, cinematic = ?, "
+                                      "totaltime = ?, leveltime = ?, rest_bonus = ?, logout_time = ?, is_logout_resting = ?, resettalents_cost = ?, resettalents_time = ?, "
+                                      "trans_x = ?, trans_y = ?, trans_z = ?, trans_o = ?, transguid = ?, extra_flags = ?, stable_slots = ?, at_login = ?, zone = ?, "
+                                      "death_expire_time = ?, taxi_path = ?, arenaPoints = ?, totalHonorPoints = ?, todayHonorPoints = ?, yesterdayHonorPoints = ?, totalKills = ?, "
+                                      "todayKills = ?, yesterdayKills = ?, chosenTitle = ?, knownCurrencies = ?, watchedFaction = ?, drunk = ?, health = ?, power1 = ?, power2 = ?, power3 = ?, "
+                                      "power4 = ?, power5 = ?, power6 = ?, power7 = ?, specCount = ?, activeSpec = ?, exploredZones = ?, equipmentCache = ?, ammoId = ?, knownTitles = ?, actionBars = ?, grantableLevels = ?, fishingSteps = ? "
+                                      "WHERE guid = ?") :
+                              CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
+                                      "map, dungeon_difficulty, position_x, position_y, position_z, orientation, "
+                                      "taximask, online, cinematic, "
+                                      "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
+                                      "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
+                                      "death_expire_time, taxi_path, arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, totalKills, "
+                                      "todayKills, yesterdayKills, chosenTitle, knownCurrencies, watchedFaction, drunk, health, power1, power2, power3, "
+                                      "power4, power5, power6, power7, specCount, activeSpec, exploredZones, equipmentCache, ammoId, knownTitles, actionBars, grantableLevels, fishingSteps, guid) "
+                                      "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                      "?, ?, ?, ?, ?, ?, "
+                                      "?, ?, ?, "
+                                      "?, ?, ?, ?, ?, ?, ?, "
+                                      "?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                      "?, ?, ?, ?, ?, ?, ?, "
+                                      "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                      "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) ");
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
-    SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
-                              "map, dungeon_difficulty, position_x, position_y, position_z, orientation, "
-                              "taximask, online, cinematic, "
-                              "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
-                              "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
-                              "death_expire_time, taxi_path, arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, totalKills, "
-                              "todayKills, yesterdayKills, chosenTitle, knownCurrencies, watchedFaction, drunk, health, power1, power2, power3, "
-                              "power4, power5, power6, power7, specCount, activeSpec, exploredZones, equipmentCache, ammoId, knownTitles, actionBars, grantableLevels, fishingSteps) "
-                              "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) ");
-
-    uberInsert.addUInt32(GetGUIDLow());
     uberInsert.addUInt32(GetSession()->GetAccountId());
     uberInsert.addString(m_name);
     uberInsert.addUInt8(getRace());
@@ -18324,7 +18530,10 @@ void Player::SaveToDB()
 
     uberInsert.addUInt8(m_fishingSteps);
 
+    uberInsert.addUInt32(GetGUIDLow());
+
     uberInsert.Execute();
+    m_characterRowExists = true;
 
     if (m_mailsUpdated)                                     // save mails only when needed
         _SaveMail();
@@ -18348,16 +18557,16 @@ void Player::SaveToDB()
     _SaveGlyphs();
     _SaveTalents();
 
+    // save pet (hunter pet level and experience and all type pets health/mana except priest pet).
+    if (Pet* pet = GetPet())
+        pet->SavePetToDB(PET_SAVE_AS_CURRENT, this, false);
+
     CharacterDatabase.CommitTransaction();
 
     // check if stats should only be saved on logout
     // save stats can be out of transaction
     if (m_session->isLogingOut() || !sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT))
         _SaveStats();
-
-    // save pet (hunter pet level and experience and all type pets health/mana except priest pet).
-    if (Pet* pet = GetPet())
-        pet->SavePetToDB(PET_SAVE_AS_CURRENT, this);
 }
 
 // fast save function for item/money cheating preventing - save only inventory and money state
@@ -21646,6 +21855,7 @@ void Player::ResetDailyQuestStatus()
         SetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1 + quest_daily_idx, 0);
 
     m_serversideDailyQuests.clear();
+    InvalidateQuestGiverStatusCache();
 
     // DB data deleted in caller
     m_DailyQuestChanged = false;
@@ -21657,6 +21867,7 @@ void Player::ResetWeeklyQuestStatus()
         return;
 
     m_weeklyquests.clear();
+    InvalidateQuestGiverStatusCache();
     // DB data deleted in caller
     m_WeeklyQuestChanged = false;
 }
@@ -21667,6 +21878,7 @@ void Player::ResetMonthlyQuestStatus()
         return;
 
     m_monthlyquests.clear();
+    InvalidateQuestGiverStatusCache();
     // DB data deleted in caller
     m_MonthlyQuestChanged = false;
 }
@@ -24993,7 +25205,7 @@ void Player::AddCooldown(SpellEntry const& spellEntry, ItemPrototype const* item
             data << uint32(spellEntry.Id);
             data << GetObjectGuid();
             SendDirectMessage(data);
-            sLog.outDebug("Sending SMSG_COOLDOWN_EVENT with spell id = %u", spellEntry.Id);
+            DEBUG_LOG("Sending SMSG_COOLDOWN_EVENT with spell id = %u", spellEntry.Id);
         }
     }
 }
@@ -25111,7 +25323,10 @@ void Player::ModifyCooldown(uint32 spellId, int32 cooldownModMs)
                 break; // invalidated iterator
             }
             else
+            {
                 cdData->SetSpellCDExpireTime(expireTime + std::chrono::milliseconds(cooldownModMs));
+                m_cooldownMap.ScheduleUpdate();
+            }
         }
     }
 
@@ -25165,7 +25380,10 @@ bool Player::CanEnterNewInstance(uint32 instanceId)
 void Player::AddNewInstanceId(uint32 instanceId)
 {
     if (m_enteredInstances.find(instanceId) == m_enteredInstances.end())
+    {
         m_enteredInstances.emplace(instanceId, std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now() + std::chrono::hours(1)));
+        m_enteredInstancesChanged = true;
+    }
 }
 
 void Player::_LoadCreatedInstanceTimers()
@@ -25192,6 +25410,10 @@ void Player::_LoadCreatedInstanceTimers()
 
 void Player::_SaveNewInstanceIdTimer()
 {
+    if (!m_enteredInstancesChanged)
+        return;
+
+    m_enteredInstancesChanged = false;
     CharacterDatabase.PExecute("DELETE FROM account_instances_entered WHERE AccountId = '%u'", m_session->GetAccountId());
 
     if (m_enteredInstances.empty())
@@ -25216,7 +25438,10 @@ void Player::UpdateNewInstanceIdTimers(TimePoint const& now)
     for (auto iter = m_enteredInstances.begin(); iter != m_enteredInstances.end();)
     {
         if ((*iter).second < now)
+        {
             iter = m_enteredInstances.erase(iter);
+            m_enteredInstancesChanged = true;
+        }
         else
             ++iter;
     }
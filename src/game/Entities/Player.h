@@ -76,6 +76,9 @@ typedef std::deque<Mail*> PlayerMails;
 // TODO: Maybe this can be implemented in configuration file.
 #define PLAYER_NEW_INSTANCE_LIMIT_PER_HOUR 5
 
+// unsaved item and quest changes that move an autosave ahead of the world save budget
+#define PLAYER_SAVE_URGENT_CHANGES 32
+
 enum EnvironmentFlags
 {
     ENVIRONMENT_FLAG_NONE           = 0x00,
@@ -1261,6 +1264,8 @@ class Player : public Unit
         uint8 FindEquipSlot(ItemPrototype const* proto, uint32 slot, bool swap) const;
         uint32 GetItemCount(uint32 item, bool inBankAlso = false, Item* skipItem = nullptr) const;
         uint32 GetItemCountWithLimitCategory(uint32 limitCategory, Item* skipItem = nullptr) const;
+        void UpdateItemCountIndex(Item* pItem);             // at store, equip and stack count change, includes bag content
+        void RemoveItemFromCountIndex(Item* pItem);         // at remove from slot, includes bag content
         Item* GetItemByGuid(ObjectGuid guid) const;
         Item* GetItemByEntry(uint32 item) const;            // only for special cases
         Item* GetItemByLimitedCategory(uint32 limitedCategory) const;
@@ -1551,6 +1556,10 @@ class Player : public Unit
         void SendQuestUpdateAddPlayer(Quest const* quest, uint32 count);
         void SendQuestGiverStatusMultiple() const;
 
+        // WorldSession::getDialogStatus of a quest giver entry, cached until quest, level, skill or reputation state changes
+        uint32 GetQuestGiverDialogStatus(Object const* questgiver) const;
+        void InvalidateQuestGiverStatusCache() const { m_questGiverStatusCache.clear(); }
+
         ObjectGuid GetDividerGuid() const { return m_dividerGuid; }
         void SetDividerGuid(ObjectGuid guid) { m_dividerGuid = guid; }
         void ClearDividerGuid() { m_dividerGuid.Clear(); }
@@ -1651,6 +1660,14 @@ class Player : public Unit
         size_t GetMailSize() const { return m_mail.size(); }
         Mail* GetMail(uint32 id);
 
+        // mail bodies and mailed item instances are not part of the login queries, they are fetched for the mails shown when the mailbox is opened
+        bool IsMailDataRequestPending() const { return m_mailDataRequestPending; }
+        void SetMailDataRequestPending(bool pending) { m_mailDataRequestPending = pending; }
+        void LoadMailBodies(QueryResult* result, std::vector<uint32> const& mailIds);
+        void LoadMailItems(QueryResult* result, std::vector<uint32> const& mailIds);
+        void LoadMailBody(Mail* mail);                      // synchronous fallbacks for single mails
+        void LoadMailItems(Mail* mail);
+
         void SendItemRetrievalMail(uint32 itemEntry, uint32 count); // Item retrieval mails sent by The Postmaster (34337), used in multiple places.
 
         PlayerMails::iterator GetMailBegin() { return m_mail.begin();}
@@ -2148,6 +2165,7 @@ class Player : public Unit
 
         void SendInitWorldStates(uint32 zoneid, uint32 areaid) const;
         void SendUpdateWorldState(uint32 Field, uint32 Value) const;
+        static std::shared_ptr<WorldPacket const> BuildUpdateWorldStatePacket(uint32 Field, uint32 Value);
         void SendDirectMessage(WorldPacket const& data) const;
         void FillBGWeekendWorldStates(WorldPacket& data, uint32& count) const;
 
@@ -2343,6 +2361,7 @@ class Player : public Unit
 
         uint32 GetSaveTimer() const { return m_nextSave; }
         void   SetSaveTimer(uint32 timer) { m_nextSave = timer; }
+        bool   IsAutoSaveUrgent() const;
 
         // Recall position
         uint32 m_recallMap;
@@ -2363,7 +2382,7 @@ class Player : public Unit
         bool HasAtClient(WorldObject const* u) { return u == this || m_clientGUIDs.find(u->GetObjectGuid()) != m_clientGUIDs.end(); }
         void AddAtClient(WorldObject* target);
         void RemoveAtClient(WorldObject* target);
-        GuidSet& GetClientGuids() { return m_clientGUIDs; }
+        GuidHashSet& GetClientGuids() { return m_clientGUIDs; }
 
         bool IsVisibleInGridForPlayer(Player* pl) const override;
         bool IsVisibleGloballyFor(Player* u) const;
@@ -2460,6 +2479,7 @@ class Player : public Unit
         void SetOriginalGroup(Group* group, int8 subgroup = -1);
 
         GridReference<Player>& GetGridRef() { return m_gridRef; }
+        void UpdateGridPosition() override { m_gridRef.UpdatePosition(GetGridObjectPosition()); }
         MapReference& GetMapRef() { return m_mapRef; }
 
         DeclinedName const* GetDeclinedNames() const { return m_declinedname; }
@@ -2693,6 +2713,7 @@ class Player : public Unit
 
         Team m_team;
         uint32 m_nextSave;
+        uint32 m_saveDelay;                                 // time the due autosave waited for the world save budget
         time_t m_speakTime;
         uint32 m_speakCount;
         Difficulty m_dungeonDifficulty;
@@ -2703,6 +2724,22 @@ class Player : public Unit
         Item* m_items[PLAYER_SLOTS_COUNT];
         uint32 m_currentBuybackSlot;
 
+        struct ItemCountIndexEntry
+        {
+            ItemCountIndexEntry() : inventory(0), bank(0) {}
+
+            uint32 inventory;                               // equipped, backpack, keyring, currency and bag content
+            uint32 bank;                                    // bank slots and bank bag content
+        };
+        typedef std::unordered_map<uint32 /*item entry*/, ItemCountIndexEntry> ItemCountIndex;
+        typedef std::unordered_map<uint32 /*limit category*/, uint32> ItemLimitCategoryCountIndex;
+
+        void AddItemCountIndexState(Item* pItem);
+        void RemoveItemCountIndexState(Item* pItem);
+
+        ItemCountIndex m_itemCountIndex;
+        ItemLimitCategoryCountIndex m_itemLimitCategoryCountIndex; // inventory and bank
+
         std::vector<Item*> m_itemUpdateQueue;
         bool m_itemUpdateQueueBlocked;
 
@@ -2717,6 +2754,7 @@ class Player : public Unit
         uint32 m_ArenaTeamIdInvited;
 
         PlayerMails m_mail;
+        bool m_mailDataRequestPending;
         PlayerSpellMap m_spells;
         PlayerTalentMap m_talents[MAX_TALENT_SPEC_COUNT];
         uint32 m_lastPotionId;                              // last used health/mana potion in combat, that block next potion use
@@ -2762,6 +2800,7 @@ class Player : public Unit
         bool   m_DailyQuestChanged;
         bool   m_WeeklyQuestChanged;
         bool   m_MonthlyQuestChanged;
+        bool   m_characterRowExists;                        // characters row was loaded or inserted, saves update it in place
 
         uint32 m_drunkTimer;
 
@@ -2921,13 +2960,18 @@ class Player : public Unit
         Spell* m_modsSpell;
         std::set<SpellModifierPair>* m_consumedMods;
 
-        GuidSet m_clientGUIDs;
+        GuidHashSet m_clientGUIDs;
+
+        mutable std::unordered_map<uint64, uint8> m_questGiverStatusCache;  // type id and entry -> dialog status
+        mutable uint32 m_questGiverStatusGeneration;        // GameEventMgr quest state the cache was built with
 
         // Recruit-A-Friend
         uint8 m_grantableLevels;
 
         std::unordered_map<uint32, TimePoint> m_enteredInstances;
+        bool m_enteredInstancesChanged;
         uint32 m_createdInstanceClearTimer;
+        uint32 m_groupUpdateTimer;                          // with Group.MemberStatsInterval instead of the heartbeat
 
         uint32 m_pendingBindMapId;
         uint32 m_pendingBindId;
@@ -104,8 +104,9 @@ Player const* Unit::GetControllingPlayer(bool ignoreCharms/* = false*/) const
 /// @note Relations API Tier 1
 ///
 /// Client-side counterpart: <tt>static function (original symbol name unknown)</tt>
+/// Served from the precomputed table by GetFactionReaction, kept as the only place of the logic
 /////////////////////////////////////////////////
-static inline ReputationRank GetFactionReaction(FactionTemplateEntry const* thisTemplate, FactionTemplateEntry const* otherTemplate)
+static ReputationRank CalculateFactionReaction(FactionTemplateEntry const* thisTemplate, FactionTemplateEntry const* otherTemplate)
 {
     MANGOS_ASSERT(thisTemplate)
     MANGOS_ASSERT(otherTemplate)
@@ -150,6 +151,79 @@ static inline ReputationRank GetFactionReaction(FactionTemplateEntry const* this
     return (thisTemplate->factionFlags & FACTION_TEMPLATE_FLAG_HATES_ALL_EXCEPT_FRIENDS) ? REP_HOSTILE : REP_NEUTRAL;
 }
 
+// Reactions of every faction template pair, 2 bits each: 0 for a missing template, else index in FactionReactionRanks
+static std::vector<uint8> s_factionReactions;
+static uint32 s_factionReactionRows = 0;
+static ReputationRank const FactionReactionRanks[4] = { REP_NEUTRAL, REP_HOSTILE, REP_NEUTRAL, REP_FRIENDLY };
+
+/////////////////////////////////////////////////
+/// [Serverside] Precompute faction template to faction template reactions
+///
+/// @note Relations API Tier 3
+///
+/// Called once after DBC load, the table is only read afterwards (from any map thread).
+/////////////////////////////////////////////////
+void Unit::LoadFactionReactions()
+{
+    uint32 startTime = WorldTimer::getMSTime();
+
+    uint32 rows = sFactionTemplateStore.GetNumRows();
+    std::vector<uint8> reactions((size_t(rows) * rows + 3) / 4, 0);
+
+    for (uint32 i = 0; i < rows; ++i)
+    {
+        FactionTemplateEntry const* thisTemplate = sFactionTemplateStore.LookupEntry(i);
+        if (!thisTemplate)
+            continue;
+
+        for (uint32 j = 0; j < rows; ++j)
+        {
+            FactionTemplateEntry const* otherTemplate = sFactionTemplateStore.LookupEntry(j);
+            if (!otherTemplate)
+                continue;
+
+            uint8 code;
+            switch (CalculateFactionReaction(thisTemplate, otherTemplate))
+            {
+                case REP_HOSTILE:  code = 1; break;
+                case REP_FRIENDLY: code = 3; break;
+                default:           code = 2; break;
+            }
+
+            size_t index = size_t(i) * rows + j;
+            reactions[index / 4] |= uint8(code << ((index % 4) * 2));
+        }
+    }
+
+    s_factionReactions.swap(reactions);
+    s_factionReactionRows = rows;
+
+    sLog.outString(">> Precomputed reactions of %u faction templates in %u ms", rows, WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()));
+    sLog.outString();
+}
+
+/////////////////////////////////////////////////
+/// [Serverside] Get faction template to faction tenplate reaction
+///
+/// @note Relations API Tier 3
+///
+/// Table lookup of CalculateFactionReaction, falls back to it before the table is built
+/////////////////////////////////////////////////
+static inline ReputationRank GetFactionReaction(FactionTemplateEntry const* thisTemplate, FactionTemplateEntry const* otherTemplate)
+{
+    MANGOS_ASSERT(thisTemplate)
+    MANGOS_ASSERT(otherTemplate)
+
+    if (thisTemplate->ID < s_factionReactionRows && otherTemplate->ID < s_factionReactionRows)
+    {
+        size_t index = size_t(thisTemplate->ID) * s_factionReactionRows + otherTemplate->ID;
+        if (uint8 code = (s_factionReactions[index / 4] >> ((index % 4) * 2)) & 3)
+            return FactionReactionRanks[code];
+    }
+
+    return CalculateFactionReaction(thisTemplate, otherTemplate);
+}
+
 /////////////////////////////////////////////////
 /// Get faction template to unit reaction
 ///
@@ -104,7 +104,7 @@ void Totem::Summon(Unit* owner)
         owner->AI()->JustSummoned((Creature*)this);
 
     // there are some totems, which exist just for their visual appeareance
-    for (auto& data : m_spellList.Spells)
+    for (auto& data : m_spellList->Spells)
     {
         uint32 spellId = data.second.SpellId;
         if (!spellId)
@@ -164,10 +164,10 @@ void Totem::UnSummon()
 
 uint32 Totem::GetSpell() const
 {
-    if (m_spellList.Spells.empty())
+    if (m_spellList->Spells.empty())
         return 0;
 
-    return m_spellList.Spells.begin()->second.SpellId;
+    return m_spellList->Spells.begin()->second.SpellId;
 }
 
 void Totem::SetTypeBySummonSpell(SpellEntry const* spellProto)
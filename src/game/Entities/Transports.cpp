@@ -543,11 +543,9 @@ void Transport::Update(const uint32 diff)
         m_positionChangeTimer.Reset(positionUpdateDelay);
         if (IsMoving() && pathProgress)
         {
-            float t = CalculateSegmentPos(float(pathProgress) * 0.001f);
-            G3D::Vector3 pos, dir;
-            m_currentFrame->Spline->evaluate_percent(m_currentFrame->Index, t, pos);
-            m_currentFrame->Spline->evaluate_derivative(m_currentFrame->Index, t, dir);
-            UpdatePosition(pos.x, pos.y, pos.z, atan2(dir.y, dir.x) + M_PI);
+            float x, y, z, o;
+            if (m_currentFrame->GetPathPosition(pathProgress, x, y, z, o))
+                UpdatePosition(x, y, z, o);
         }
         if (IsInWorld())
         {
@@ -567,37 +565,6 @@ void Transport::Update(const uint32 diff)
     }
 }
 
-float Transport::CalculateSegmentPos(float now)
-{
-    KeyFrame const& frame = *m_currentFrame;
-    float const speed = float(m_goInfo->moTransport.moveSpeed);
-    float const accel = float(m_goInfo->moTransport.accelRate);
-    float timeSinceStop = frame.TimeFrom + (now - (1.0f / IN_MILLISECONDS) * frame.DepartureTime);
-    float timeUntilStop = frame.TimeTo - (now - (1.0f / IN_MILLISECONDS) * frame.DepartureTime);
-    float segmentPos, dist;
-    float accelTime = m_transportTemplate.accelTime;
-    float accelDist = m_transportTemplate.accelDist;
-    // calculate from nearest stop, less confusing calculation...
-    if (timeSinceStop < timeUntilStop)
-    {
-        if (timeSinceStop < accelTime)
-            dist = 0.5f * accel * timeSinceStop * timeSinceStop;
-        else
-            dist = accelDist + (timeSinceStop - accelTime) * speed;
-        segmentPos = dist - frame.DistSinceStop;
-    }
-    else
-    {
-        if (timeUntilStop < m_transportTemplate.accelTime)
-            dist = 0.5f * accel * timeUntilStop * timeUntilStop;
-        else
-            dist = accelDist + (timeUntilStop - accelTime) * speed;
-        segmentPos = frame.DistUntilStop - dist;
-    }
-
-    return segmentPos / frame.NextDistFromPrev;
-}
-
 bool ElevatorTransport::Create(uint32 dbGuid, uint32 guidlow, uint32 name_id, Map* map, uint32 phaseMask, float x, float y, float z, float ang, const QuaternionData& rotation, uint8 animprogress, GOState go_state)
 {
     if (GenericTransport::Create(dbGuid, guidlow, name_id, map, phaseMask, x, y, z, ang, rotation, animprogress, go_state))
@@ -743,11 +710,20 @@ void ElevatorTransport::SetGoState(GOState state)
 
 void GenericTransport::UpdatePassengerPositions(PassengerSet& passengers)
 {
+    // the transform is the same for all passengers, and their visibility is updated together once the map update is done
+    float const transCos = std::cos(GetOrientation());
+    float const transSin = std::sin(GetOrientation());
+    Map::RelocationBatch batch;
     for (const auto passenger : passengers)
-        UpdatePassengerPosition(passenger);
+        UpdatePassengerPosition(passenger, transCos, transSin);
 }
 
 void GenericTransport::UpdatePassengerPosition(WorldObject* passenger)
+{
+    UpdatePassengerPosition(passenger, std::cos(GetOrientation()), std::sin(GetOrientation()));
+}
+
+void GenericTransport::UpdatePassengerPosition(WorldObject* passenger, float transCos, float transSin)
 {
     // transport teleported but passenger not yet (can happen for players)
     if (passenger->IsInWorld() && passenger->GetMap() != GetMap())
@@ -755,12 +731,12 @@ void GenericTransport::UpdatePassengerPosition(WorldObject* passenger)
 
     // Do not use Unit::UpdatePosition here, we don't want to remove auras
     // as if regular movement occurred
-    float x, y, z, o;
-    x = passenger->GetTransOffsetX();
-    y = passenger->GetTransOffsetY();
-    z = passenger->GetTransOffsetZ();
-    o = passenger->GetTransOffsetO();
-    CalculatePassengerPosition(x, y, z, &o);
+    float const offX = passenger->GetTransOffsetX();
+    float const offY = passenger->GetTransOffsetY();
+    float x = GetPositionX() + offX * transCos - offY * transSin;
+    float y = GetPositionY() + offY * transCos + offX * transSin;
+    float z = GetPositionZ() + passenger->GetTransOffsetZ();
+    float o = MapManager::NormalizeOrientation(GetOrientation() + passenger->GetTransOffsetO());
     if (!MaNGOS::IsValidMapCoord(x, y, z))
     {
         sLog.outError("[TRANSPORTS] Object %s [guid %u] has invalid position on transport.", passenger->GetName(), passenger->GetGUIDLow());
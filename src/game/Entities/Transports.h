@@ -37,6 +37,7 @@ class GenericTransport : public GameObject
 
         void UpdatePosition(float x, float y, float z, float o);
         void UpdatePassengerPosition(WorldObject* object);
+        void UpdatePassengerPosition(WorldObject* object, float transCos, float transSin);
 
         typedef std::set<Player*> PlayerSet;
         PassengerSet& GetPassengers() { return m_passengers; }
@@ -112,7 +113,6 @@ class Transport : public GenericTransport
         void UpdateForMap(Map const* targetMap, bool newMap);
         void DoEventIfAny(TaxiPathNodeEntry const& node, bool departure);
         void MoveToNextWayPoint();                          // move m_next/m_cur to next points
-        float CalculateSegmentPos(float perc);
 
         bool IsMoving() const { return m_isMoving; }
         void SetMoving(bool val) { m_isMoving = val; }
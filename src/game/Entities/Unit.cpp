@@ -51,6 +51,7 @@
 #include "Tools/Formulas.h"
 #include "Entities/Transports.h"
 #include "Anticheat/Anticheat.hpp"
+#include "Social/WhoListIndex.h"
 
 #ifdef BUILD_METRICS
  #include "Metric/Metric.h"
@@ -140,23 +141,12 @@ static const SpellPartialResistDistribution SPELL_PARTIAL_RESIST_DISTRIBUTION =
 void MovementInfo::Read(ByteBuffer& data)
 {
     stime = sWorld.GetCurrentMSTime();
-    data >> moveFlags;
-    data >> moveFlags2;
-    data >> ctime;
-    data >> pos.x;
-    data >> pos.y;
-    data >> pos.z;
-    data >> pos.o;
+    data.read_bulk(moveFlags, moveFlags2, ctime, pos.x, pos.y, pos.z, pos.o);
 
     if (HasMovementFlag(MOVEFLAG_ONTRANSPORT))
     {
         data >> t_guid.ReadAsPacked();
-        data >> t_pos.x;
-        data >> t_pos.y;
-        data >> t_pos.z;
-        data >> t_pos.o;
-        data >> t_time;
-        data >> t_seat;
+        data.read_bulk(t_pos.x, t_pos.y, t_pos.z, t_pos.o, t_time, t_seat);
 
         if (moveFlags2 & MOVEFLAG2_INTERP_MOVEMENT)
             data >> t_time2;
@@ -171,10 +161,7 @@ void MovementInfo::Read(ByteBuffer& data)
 
     if (HasMovementFlag(MOVEFLAG_FALLING))
     {
-        data >> jump.zspeed;
-        data >> jump.cosAngle;
-        data >> jump.sinAngle;
-        data >> jump.xyspeed;
+        data.read_bulk(jump.zspeed, jump.cosAngle, jump.sinAngle, jump.xyspeed);
         if (!jump.startClientTime)
         {
             jump.startClientTime = ctime;
@@ -291,6 +278,7 @@ Unit::Unit() :
     // m_AurasCheck = 2000;
     // m_removeAuraTimer = 4;
     m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.end();
+    m_modAurasHoles = false;
     m_AuraFlags = 0;
 
     m_Visibility = VISIBILITY_ON;
@@ -298,6 +286,8 @@ Unit::Unit() :
 
     m_transform = 0;
     m_canModifyStats = false;
+    m_statUpdateDeferrals = 0;
+    m_deferredStatMods = 0;
 
     for (auto& i : m_spellImmune)
         i.clear();
@@ -395,18 +385,29 @@ Unit::~Unit()
     MANGOS_ASSERT(m_deletedHolders.empty());
 }
 
-void Unit::Update(const uint32 diff)
-{
-    if (!IsInWorld())
-        return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.update", {
+std::map<std::string, std::string> Unit::GetMetricTags() const
+{
+    return {
         { "entry", std::to_string(GetEntry()) },
         { "guid", std::to_string(GetGUIDLow()) },
         { "unit_type", std::to_string(GetGUIDHigh()) },
         { "map_id", std::to_string(GetMapId()) },
         { "instance_id", std::to_string(GetInstanceId()) }
-    }, 1000);
+    };
+}
+#endif
+
+void Unit::Update(const uint32 diff)
+{
+    if (!IsInWorld())
+        return;
+#ifdef BUILD_METRICS
+    static metric::histogram& updateHistogram = metric::aggregates::instance().register_histogram("unit.update.aggregate");
+    metric::timer meas(updateHistogram, 1000, [this](int64 elapsed)
+    {
+        metric::metric::instance().report("unit.update", "duration", elapsed, GetMetricTags());
+    });
 #endif
 
     /*if(p_time > m_AurasCheck)
@@ -462,19 +463,33 @@ void Unit::Update(const uint32 diff)
     // update abilities available only for fraction of time
     UpdateReactives(diff);
 
-    UpdateSplineMovement(diff);
-    i_motionMaster.UpdateMotion(diff);
+    // a long tick is moved in steps, so motion generators see the spline ends and waypoints in between
+    // instead of catching up in one jump. Units the map already stepped in its spline batch are not split.
+    uint32 const movementStep = sWorld.getConfig(CONFIG_UINT32_TICK_PACER_MOVEMENT_STEP);
+    if (movementStep && diff > movementStep && m_splineBatchResult.generation != GetUpdateGeneration())
+    {
+        for (uint32 left = diff; left;)
+        {
+            uint32 const step = std::min(left, movementStep);
+            UpdateSplineMovement(step);
+            i_motionMaster.UpdateMotion(step);
+            left -= step;
+        }
+    }
+    else
+    {
+        UpdateSplineMovement(diff);
+        i_motionMaster.UpdateMotion(diff);
+    }
 
     if (AI() && IsAlive())
     {
 #ifdef BUILD_METRICS
-        metric::duration<std::chrono::microseconds> meas_ai("unit.update.ai", {
-            { "entry", std::to_string(GetEntry()) },
-            { "guid", std::to_string(GetGUIDLow()) },
-            { "unit_type", std::to_string(GetGUIDHigh()) },
-            { "map_id", std::to_string(GetMapId()) },
-            { "instance_id", std::to_string(GetInstanceId()) }
-        }, 1000);
+        static metric::histogram& aiHistogram = metric::aggregates::instance().register_histogram("unit.update.ai.aggregate");
+        metric::timer meas_ai(aiHistogram, 1000, [this](int64 elapsed)
+        {
+            metric::metric::instance().report("unit.update.ai", "duration", elapsed, GetMetricTags());
+        });
 #endif
 
         AI()->UpdateAI(diff);   // AI not react good at real update delays (while freeze in non-active part of map)
@@ -4992,15 +5007,16 @@ uint32 Unit::GetWeaponSkillValue(WeaponAttackType attType, Unit const* target) c
 void Unit::_UpdateSpells(uint32 time)
 {
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.update.spells", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-        }, 1000);
-
     std::vector<uint32> updatedSpellIds;
+
+    static metric::histogram& spellsHistogram = metric::aggregates::instance().register_histogram("unit.update.spells.aggregate");
+    metric::timer meas(spellsHistogram, 1000, [this, &updatedSpellIds](int64 elapsed)
+    {
+        std::string logging;
+        for (uint32 spellId : updatedSpellIds)
+            logging += std::to_string(spellId) + ",";
+        metric::metric::instance().report("unit.update.spells", { { "duration", elapsed }, { "spells", "\"" + logging + "\"" } }, GetMetricTags());
+    });
 #endif
 
     if (m_currentSpells[CURRENT_AUTOREPEAT_SPELL])
@@ -5041,12 +5057,6 @@ void Unit::_UpdateSpells(uint32 time)
         else
             ++iter;
     }
-#ifdef BUILD_METRICS
-    std::string logging;
-    for (uint32 spellId : updatedSpellIds)
-        logging += std::to_string(spellId) + ",";
-    meas.add_field("spells", "\"" + logging + "\"");
-#endif
 }
 
 void Unit::_UpdateAutoRepeatSpell()
@@ -5822,6 +5832,14 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     holder->SetCreationDelayFlag();
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
 
+    if (uint32 procFlags = sSpellMgr.GetSpellProcFlags(holder->GetSpellProto()))
+    {
+        // same position as in the holder map, procs keep triggering in spell id order
+        auto pos = std::upper_bound(m_procHolders.begin(), m_procHolders.end(), holder->GetId(),
+            [](uint32 spellId, ProcHolderEntry const& entry) { return spellId < entry.holder->GetId(); });
+        m_procHolders.insert(pos, ProcHolderEntry{ procFlags, holder });
+    }
+
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
             AddAuraToModList(aur);
@@ -6461,6 +6479,15 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder* holder, AuraRemoveMode mode)
         }
     }
 
+    for (auto procItr = m_procHolders.begin(); procItr != m_procHolders.end(); ++procItr)
+    {
+        if (procItr->holder == holder)
+        {
+            m_procHolders.erase(procItr);
+            break;
+        }
+    }
+
     holder->SetRemoveMode(mode);
 
     uint32 auraFlags = holder->GetAuraFlags();
@@ -6523,6 +6550,7 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
         m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        m_modAurasHoles = true;
     }
 
     // Set remove mode
@@ -7782,16 +7810,16 @@ Unit* Unit::GetCharm(WorldObject const* pov /*= nullptr*/) const
                     return ObjectAccessor::FindPlayer(guid);
             }
             // Bugcheck
-            sLog.outDebug("Unit::GetCharm: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
-                          GetGuidStr().c_str(), guid.GetString().c_str());
+            DEBUG_LOG("Unit::GetCharm: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
+                      GetGuidStr().c_str(), guid.GetString().c_str());
             return nullptr;
         }
         // We need a unit in the same map only
         if (Unit* unit = accessor->GetMap()->GetUnit(guid))
             return unit;
         // Bugcheck
-        sLog.outDebug("Unit::GetCharm: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
-                      GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
+        DEBUG_LOG("Unit::GetCharm: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
+                  GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
         // const_cast<Unit*>(this)->SetCharm(nullptr);
     }
     return nullptr;
@@ -7811,16 +7839,16 @@ Unit* Unit::GetCharmer(WorldObject const* pov /*= nullptr*/) const
                     return ObjectAccessor::FindPlayer(guid);
             }
             // Bugcheck
-            sLog.outDebug("Unit::GetCharmer: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
-                          GetGuidStr().c_str(), guid.GetString().c_str());
+            DEBUG_LOG("Unit::GetCharmer: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
+                      GetGuidStr().c_str(), guid.GetString().c_str());
             return nullptr;
         }
         // We need a unit in the same map only
         if (Unit* unit = accessor->GetMap()->GetUnit(guid))
             return unit;
         // Bugcheck
-        sLog.outDebug("Unit::GetCharmer: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
-                      GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
+        DEBUG_LOG("Unit::GetCharmer: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
+                  GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
         // const_cast<Unit*>(this)->SetCharmer(nullptr);
     }
     return nullptr;
@@ -7840,16 +7868,16 @@ Unit* Unit::GetCreator(WorldObject const* pov /*= nullptr*/) const
                     return ObjectAccessor::FindPlayer(guid);
             }
             // Bugcheck
-            sLog.outDebug("Unit::GetCreator: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
-                          GetGuidStr().c_str(), guid.GetString().c_str());
+            DEBUG_LOG("Unit::GetCreator: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
+                      GetGuidStr().c_str(), guid.GetString().c_str());
             return nullptr;
         }
         // We need a unit in the same map only
         if (Unit* unit = accessor->GetMap()->GetUnit(guid))
             return unit;
         // Bugcheck
-        sLog.outDebug("Unit::GetCreator: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
-                      GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
+        DEBUG_LOG("Unit::GetCreator: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
+                  GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
         // const_cast<Unit*>(this)->SetCreator(nullptr);
     }
     return nullptr;
@@ -7869,16 +7897,16 @@ Unit* Unit::GetTarget(WorldObject const* pov /*= nullptr*/) const
                     return ObjectAccessor::FindPlayer(guid);
             }
             // Bugcheck
-            sLog.outDebug("Unit::GetTarget: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
-                          GetGuidStr().c_str(), guid.GetString().c_str());
+            DEBUG_LOG("Unit::GetTarget: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
+                      GetGuidStr().c_str(), guid.GetString().c_str());
             return nullptr;
         }
         // We need a unit in the same map only
         if (Unit* unit = accessor->GetMap()->GetUnit(guid))
             return unit;
         // Bugcheck
-        sLog.outDebug("Unit::GetTarget: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
-                      GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
+        DEBUG_LOG("Unit::GetTarget: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
+                  GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
         // const_cast<Unit*>(this)->SetTarget(nullptr);
     }
     return nullptr;
@@ -7898,16 +7926,16 @@ WorldObject* Unit::GetChannelObject(WorldObject const* pov /*= nullptr*/) const
                     return ObjectAccessor::FindPlayer(guid);
             }
             // Bugcheck
-            sLog.outDebug("Unit::GetChannelObject: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
-                          GetGuidStr().c_str(), guid.GetString().c_str());
+            DEBUG_LOG("Unit::GetChannelObject: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
+                      GetGuidStr().c_str(), guid.GetString().c_str());
             return nullptr;
         }
         // We need a unit in the same map only
         if (WorldObject* unit = accessor->GetMap()->GetWorldObject(guid))
             return unit;
         // Bugcheck
-        sLog.outDebug("Unit::GetChannelObject: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
-                      GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
+        DEBUG_LOG("Unit::GetChannelObject: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
+                  GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
         // const_cast<Unit*>(this)->SetChannelObject(nullptr);
     }
     return nullptr;
@@ -7951,16 +7979,16 @@ Unit* Unit::GetSpawner(WorldObject const* pov /*= nullptr*/) const
                     return ObjectAccessor::FindPlayer(guid);
             }
             // Bugcheck
-            sLog.outDebug("Unit::GetSpawner: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
-                          GetGuidStr().c_str(), guid.GetString().c_str());
+            DEBUG_LOG("Unit::GetSpawner: Guid field management continuity violation for %s, can't look up %s while accessor is outside of the world",
+                      GetGuidStr().c_str(), guid.GetString().c_str());
             return nullptr;
         }
         // We need a unit in the same map only
         if (Unit* unit = accessor->GetMap()->GetUnit(guid))
             return unit;
         // Bugcheck
-        sLog.outDebug("Unit::GetSpawner: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
-                      GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
+        DEBUG_LOG("Unit::GetSpawner: Guid field management continuity violation for %s in map '%s', %s does not exist in this instance",
+                  GetGuidStr().c_str(), accessor->GetMap()->GetMapName(), guid.GetString().c_str());
     }
     return nullptr;
 }
@@ -10241,6 +10269,7 @@ void Unit::UpdateVisibilityAndView()
             if (!owner || !IsVisibleForOrDetect(owner, this, false))
             {
                 alist.erase(it);
+                m_modAurasHoles = true;
                 RemoveAura(aura);
                 it = alist.begin();
             }
@@ -11060,6 +11089,35 @@ bool Unit::HandleStatModifier(UnitMods unitMod, UnitModifierType modifierType, f
     if (!CanModifyStats())
         return false;
 
+    if (m_statUpdateDeferrals)
+        m_deferredStatMods |= 1 << unitMod;
+    else
+        UpdateStatsOfUnitMod(unitMod);
+
+    return true;
+}
+
+void Unit::FlushStatUpdates()
+{
+    MANGOS_ASSERT(m_statUpdateDeferrals);
+    if (--m_statUpdateDeferrals)
+        return;
+
+    uint32 const changedMods = m_deferredStatMods;
+    m_deferredStatMods = 0;
+
+    // stats were disabled meanwhile, whoever enables them again updates everything
+    if (!CanModifyStats())
+        return;
+
+    // primary stats first, their updates already refresh most of the values depending on them
+    for (uint32 unitMod = 0; unitMod < UNIT_MOD_END; ++unitMod)
+        if (changedMods & (1 << unitMod))
+            UpdateStatsOfUnitMod(UnitMods(unitMod));
+}
+
+void Unit::UpdateStatsOfUnitMod(UnitMods unitMod)
+{
     switch (unitMod)
     {
         case UNIT_MOD_STAT_STRENGTH:
@@ -11096,8 +11154,6 @@ bool Unit::HandleStatModifier(UnitMods unitMod, UnitModifierType modifierType, f
         default:
             break;
     }
-
-    return true;
 }
 
 float Unit::GetModifierValue(UnitMods unitMod, UnitModifierType modifierType) const
@@ -11272,9 +11328,14 @@ void Unit::SetLevel(uint32 lvl)
 {
     SetUInt32Value(UNIT_FIELD_LEVEL, lvl);
 
-    // group update
-    if ((GetTypeId() == TYPEID_PLAYER) && ((Player*)this)->GetGroup())
-        ((Player*)this)->SetGroupUpdateFlag(GROUP_UPDATE_FLAG_LEVEL);
+    if (GetTypeId() == TYPEID_PLAYER)
+    {
+        WhoListIndex::UpdateLevel((Player*)this, lvl);
+
+        // group update
+        if (((Player*)this)->GetGroup())
+            ((Player*)this)->SetGroupUpdateFlag(GROUP_UPDATE_FLAG_LEVEL);
+    }
 }
 
 void Unit::SetHealth(uint32 val)
@@ -11433,7 +11494,10 @@ void Unit::ApplyAuraProcTriggerDamage(Aura* aura, bool apply)
     if (apply)
         tAuraProcTriggerDamage.push_back(aura);
     else
+    {
         tAuraProcTriggerDamage.remove(aura);
+        m_modAurasHoles = true;
+    }
 }
 
 uint32 Unit::GetCreatePowers(Powers power) const
@@ -11619,7 +11683,8 @@ void CharmInfo::ProcessUnattackableTargets(CombatData* combatData)
     if (!combatData->threatManager.getThreatList().empty()) // threat list case
     {
         Unit::AttackerSet friendlyTargets;
-        for (auto itr = combatData->threatManager.getThreatList().begin(); itr != combatData->threatManager.getThreatList().end(); ++itr)
+        ThreatList const threatList = combatData->threatManager.getThreatList();
+        for (auto itr = threatList.begin(); itr != threatList.end(); ++itr)
         {
             Unit* attacker = (*itr)->getTarget();
             if (attacker->GetTypeId() != TYPEID_UNIT)
@@ -12326,8 +12391,8 @@ void Unit::UpdateModelData()
     {
         // we expect values in database to be relative to scale = 1.0
         SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, GetObjectScale() * modelInfo->bounding_radius);
-
         SetFloatValue(UNIT_FIELD_COMBATREACH, GetObjectScale() * modelInfo->combat_reach);
+        UpdateGridPosition();
 
         SetBaseWalkSpeed(modelInfo->SpeedWalk);
         SetBaseRunSpeed(modelInfo->SpeedRun, false);
@@ -12412,25 +12477,22 @@ Unit* Unit::SelectRandomUnfriendlyTarget(Unit* except /*= nullptr*/, float radiu
         targets.remove(except);
 
     // remove not LoS targets
+    RemoveNotInLOSInMap(targets, true);
+
     for (UnitList::iterator tIter = targets.begin(); tIter != targets.end();)
     {
         bool remove = false;
-        if (!IsWithinLOSInMap(*tIter, true))
-            remove = true;
-        else
+        // 2.4.2 - sweeping strikes no longer hits critters
+        switch ((*tIter)->GetTypeId())
         {
-            // 2.4.2 - sweeping strikes no longer hits critters
-            switch ((*tIter)->GetTypeId())
+            case TYPEID_UNIT:
             {
-                case TYPEID_UNIT:
-                {
-                    Creature* target = static_cast<Creature*>(*tIter);
-                    if (target->IsCritter())
-                        remove = true;
-                    break;
-                }
-                default: break;
+                Creature* target = static_cast<Creature*>(*tIter);
+                if (target->IsCritter())
+                    remove = true;
+                break;
             }
+            default: break;
         }
 
         if (remove)
@@ -12470,17 +12532,7 @@ Unit* Unit::SelectRandomFriendlyTarget(Unit* except /*= nullptr*/, float radius
         targets.remove(except);
 
     // remove not LoS targets
-    for (UnitList::iterator tIter = targets.begin(); tIter != targets.end();)
-    {
-        if (!IsWithinLOSInMap(*tIter, true))
-        {
-            UnitList::iterator tIter2 = tIter;
-            ++tIter;
-            targets.erase(tIter2);
-        }
-        else
-            ++tIter;
-    }
+    RemoveNotInLOSInMap(targets, true);
 
     // no appropriate targets
     if (targets.empty())
@@ -13067,6 +13119,14 @@ void Unit::CleanupDeletedAuras()
     for (AuraList::const_iterator itr = m_deletedAuras.begin(); itr != m_deletedAuras.end(); ++itr)
         delete *itr;
     m_deletedAuras.clear();
+
+    // nothing walks the aura lists at this point, close the holes left by removed auras
+    if (m_modAurasHoles)
+    {
+        for (AuraList& auraList : m_modAuras)
+            auraList.Compact();
+        m_modAurasHoles = false;
+    }
 }
 
 bool Unit::IsShapeShifted() const
@@ -13150,6 +13210,7 @@ class UnitVisitObjectsInRangeNotifyEvent : public BasicEvent
             {
                 MaNGOS::PlayerVisitObjectsNotifier notify(static_cast<Player&>(m_owner));
                 Cell::VisitAllObjects(&m_owner, notify, radius);
+                m_owner.GetMap()->UpdateCapturePointPresence(static_cast<Player*>(&m_owner));
             }
             else // if(m_owner.GetTypeId() == TYPEID_UNIT)
             {
@@ -13197,22 +13258,35 @@ void Unit::AbortAINotifyEvent()
 }
 
 void Unit::OnRelocated()
+{
+    if (IsRelocationNotifyDue())
+    {
+        if (sWorld.getConfig(CONFIG_BOOL_VISIBILITY_COALESCE_RELOCATIONS) || Map::RelocationBatch::IsActive())
+            GetMap()->QueueRelocationNotify(this);
+        else
+            UpdateRelocationVisibility();
+    }
+    ScheduleAINotify(GetMap()->GetRelocationAINotifyDelay());
+}
+
+bool Unit::IsRelocationNotifyDue() const
 {
     // switch to use G3D::Vector3 is good idea, maybe
     float dx = m_last_notified_position.x - GetPositionX();
     float dy = m_last_notified_position.y - GetPositionY();
     float dz = m_last_notified_position.z - GetPositionZ();
     float distsq = dx * dx + dy * dy + dz * dz;
-    if (distsq > World::GetRelocationLowerLimitSq())
-    {
-        m_last_notified_position.x = GetPositionX();
-        m_last_notified_position.y = GetPositionY();
-        m_last_notified_position.z = GetPositionZ();
+    return distsq > GetMap()->GetRelocationLowerLimitSq();
+}
 
-        GetViewPoint().Call_UpdateVisibilityForOwner();
-        UpdateObjectVisibility();
-    }
-    ScheduleAINotify(World::GetRelocationAINotifyDelay());
+void Unit::UpdateRelocationVisibility()
+{
+    m_last_notified_position.x = GetPositionX();
+    m_last_notified_position.y = GetPositionY();
+    m_last_notified_position.z = GetPositionZ();
+
+    GetViewPoint().Call_UpdateVisibilityForOwner();
+    UpdateObjectVisibility();
 }
 
 /**
@@ -13285,18 +13359,22 @@ void Unit::UpdateSplineMovement(uint32 t_diff)
         POSITION_UPDATE_DELAY = 400,
     };
 
-    if (movespline->Finalized())
+    // already stepped by the map this tick, a spline stopped since then is left alone like any finalized one
+    Movement::MoveSplineBatchResult const batch = m_splineBatchResult;
+    bool const batched = batch.generation && batch.generation == GetUpdateGeneration() && batch.splineId == movespline->GetId();
+    m_splineBatchResult.generation = 0;
+
+    if (movespline->Finalized() && (!batched || !batch.arrived))
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.updatesplinemovement", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-    }, 1000);
+    static metric::histogram& splineHistogram = metric::aggregates::instance().register_histogram("unit.updatesplinemovement.aggregate");
+    metric::timer meas(splineHistogram, 1000, [this](int64 elapsed)
+    {
+        metric::metric::instance().report("unit.updatesplinemovement", "duration", elapsed, GetMetricTags());
+    });
 #endif
-    movespline->updateState(t_diff);
+    if (!batched)
+        movespline->updateState(t_diff);
     bool arrived = movespline->Finalized();
 
     if (arrived)
@@ -13306,14 +13384,21 @@ void Unit::UpdateSplineMovement(uint32 t_diff)
     if (m_movesplineTimer.Passed() || arrived)
     {
         m_movesplineTimer.Reset(POSITION_UPDATE_DELAY);
-        UpdateSplinePosition();
+        if (batched && batch.positionDue)
+            ApplySplinePosition(batch.position);
+        else
+            UpdateSplinePosition();
     }
 }
 
 void Unit::UpdateSplinePosition(bool relocateOnly)
 {
     Movement::Location computedLoc = movespline->ComputePosition();
-    Position pos(computedLoc.x, computedLoc.y, computedLoc.z, computedLoc.orientation);
+    ApplySplinePosition(Position(computedLoc.x, computedLoc.y, computedLoc.z, computedLoc.orientation), relocateOnly);
+}
+
+void Unit::ApplySplinePosition(Position pos, bool relocateOnly)
+{
     if (GenericTransport* transport = GetTransport())
     {
         m_movementInfo.UpdateTransportData(pos);
@@ -14030,7 +14115,8 @@ void Unit::RemoveUnattackableTargets(Unit* charmer)
             friendlyTargets.insert(attacker);
     }
 
-    for (auto itr = getThreatManager().getThreatList().begin(); itr != getThreatManager().getThreatList().end(); ++itr)
+    ThreatList const threatList = getThreatManager().getThreatList();
+    for (auto itr = threatList.begin(); itr != threatList.end(); ++itr)
     {
         Unit* attacker = (*itr)->getTarget();
         if (attacker->GetTypeId() != TYPEID_UNIT)
@@ -14109,11 +14195,16 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed)
         if (!killDelayed)
             continue;
         // 2/ Interrupt spells that are not referenced but that still have an event (like delayed spell)
-        for (auto i_events = target->m_events.GetEvents().begin(); i_events != target->m_events.GetEvents().end(); ++i_events)
-            if (SpellEvent* event = dynamic_cast<SpellEvent*>(i_events->second))
-                if (event && event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
-                    if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
-                        event->GetSpell()->cancel();
+        std::vector<SpellEvent*> spellEvents;
+        target->m_events.ForEachEvent([&](BasicEvent* event)
+        {
+            if (SpellEvent* spellEvent = dynamic_cast<SpellEvent*>(event))
+                spellEvents.push_back(spellEvent);
+        });
+        for (SpellEvent* event : spellEvents)
+            if (event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
+                if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
+                    event->GetSpell()->cancel();
     }
 }
 
@@ -45,6 +45,7 @@
 #include "Util/Timer.h"
 #include "AI/BaseAI/UnitAI.h"
 #include "Spells/SpellDefines.h"
+#include "Spells/AuraVector.h"
 #include "Maps/SpawnGroupDefines.h"
 
 #include <list>
@@ -591,6 +592,19 @@ enum NPCFlags
 namespace Movement
 {
     class MoveSpline;
+    class MoveSplineBatch;
+
+    // spline step done by MoveSplineBatch for the unit, only valid in the map update it was made in
+    struct MoveSplineBatchResult
+    {
+        MoveSplineBatchResult() : generation(0), splineId(0), arrived(false), positionDue(false) {}
+
+        uint32 generation;
+        uint32 splineId;
+        bool arrived;
+        bool positionDue;
+        Position position;
+    };
 }
 
 /**
@@ -1151,7 +1165,7 @@ class Unit : public WorldObject
         typedef std::pair<SpellAuraHolderMap::iterator, SpellAuraHolderMap::iterator> SpellAuraHolderBounds;
         typedef std::pair<SpellAuraHolderMap::const_iterator, SpellAuraHolderMap::const_iterator> SpellAuraHolderConstBounds;
         typedef std::list<SpellAuraHolder*> SpellAuraHolderList;
-        typedef std::list<Aura*> AuraList;
+        typedef AuraVector AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<uint32 /*playerGuidLow*/> ComboPointHolderSet;
         typedef std::map<uint8 /*slot*/, uint32 /*spellId*/> VisibleAuraMap;
@@ -1209,6 +1223,10 @@ class Unit : public WorldObject
 
         void Update(const uint32 diff) override;
         void Heartbeat() override;
+#ifdef BUILD_METRICS
+        // detailed tags for single slow updates, too costly to build for every sample
+        std::map<std::string, std::string> GetMetricTags() const;
+#endif
 
         /**
          * Updates the attack time for the given WeaponAttackType
@@ -1449,6 +1467,8 @@ class Unit : public WorldObject
 
         Player const* GetControllingPlayer(bool ignoreCharms = false) const;
 
+        static void LoadFactionReactions();                 // precompute faction template pair reactions after DBC load
+
         ReputationRank GetReactionTo(Unit const* unit) const override;
         ReputationRank GetReactionTo(Corpse const* corpse) const override;
 
@@ -2084,6 +2104,9 @@ class Unit : public WorldObject
         Powers GetPowerTypeByAuraGroup(UnitMods unitMod) const;
         bool CanModifyStats() const { return m_canModifyStats; }
         void SetCanModifyStats(bool modifyStats) { m_canModifyStats = modifyStats; }
+        // modifier changes are summed up meanwhile and each touched stat is recalculated once, see StatUpdateScope
+        void DeferStatUpdates() { ++m_statUpdateDeferrals; }
+        void FlushStatUpdates();
         virtual bool UpdateStats(Stats stat) = 0;
         virtual bool UpdateAllStats() = 0;
         virtual void UpdateResistances(uint32 school) = 0;
@@ -2440,6 +2463,8 @@ class Unit : public WorldObject
         void FinalizeAINotifyEvent() { m_AINotifyEvent = nullptr; }
         void AbortAINotifyEvent();
         void OnRelocated();
+        bool IsRelocationNotifyDue() const;
+        void UpdateRelocationVisibility();
 
 
         bool IsLinkingEventTrigger() const { return m_isCreatureLinkingTrigger; }
@@ -2592,6 +2617,14 @@ class Unit : public WorldObject
 
         SpellAuraHolderMap m_spellAuraHolders;
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
+
+        // holders that can proc with the flags they react to, kept in m_spellAuraHolders order
+        struct ProcHolderEntry
+        {
+            uint32 procFlags;
+            SpellAuraHolder* holder;
+        };
+        std::vector<ProcHolderEntry> m_procHolders;
         AuraList m_deletedAuras;                            // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
         std::map<uint32, Aura*> m_classScripts;
@@ -2612,11 +2645,14 @@ class Unit : public WorldObject
         std::map<uint32, Creature*> m_creatures;
 
         AuraList m_modAuras[TOTAL_AURAS];
+        bool m_modAurasHoles;                               // an aura was removed from m_modAuras since the last compaction
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
 
         WeaponDamageInfo m_weaponDamageInfo;
 
         bool m_canModifyStats;
+        uint32 m_statUpdateDeferrals;
+        uint32 m_deferredStatMods;                          // mask of UnitMods changed while stat updates are deferred
         // std::list< spellEffectPair > AuraSpells[TOTAL_AURAS];  // TODO: use this if ok for mem
         VisibleAuraMap m_visibleAuras;
 
@@ -2677,8 +2713,12 @@ class Unit : public WorldObject
         FormationSlotDataSPtr m_formationSlot;
 
     private:
+        friend class Movement::MoveSplineBatch;
+
         void CleanupDeletedAuras();
         void UpdateSplineMovement(uint32 t_diff);
+        void ApplySplinePosition(Position pos, bool relocateOnly = false);
+        void UpdateStatsOfUnitMod(UnitMods unitMod);
 
         // player or player's pet
         float GetCombatRatingReduction(CombatRating cr) const;
@@ -2700,6 +2740,7 @@ class Unit : public WorldObject
         Position m_last_notified_position;
         BasicEvent* m_AINotifyEvent;
         ShortTimeTracker m_movesplineTimer;
+        Movement::MoveSplineBatchResult m_splineBatchResult;
 
         Diminishing m_Diminishing;
 
@@ -2888,6 +2929,21 @@ struct LowestHPNearestOrder
     }
 };
 
+// Recalculates the stats touched by several modifier changes once when the scope ends.
+// Values derived from stats, such as max health and attack power, are stale inside the scope.
+class StatUpdateScope
+{
+    public:
+        explicit StatUpdateScope(Unit& unit) : m_unit(unit) { m_unit.DeferStatUpdates(); }
+        ~StatUpdateScope() { m_unit.FlushStatUpdates(); }
+
+        StatUpdateScope(StatUpdateScope const&) = delete;
+        StatUpdateScope& operator=(StatUpdateScope const&) = delete;
+
+    private:
+        Unit& m_unit;
+};
+
 class UnitLambdaEvent : public BasicEvent
 {
     public:
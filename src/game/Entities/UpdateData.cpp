@@ -27,13 +27,46 @@
 #include "World/World.h"
 #include "Entities/ObjectGuid.h"
 #include "Server/WorldSession.h"
+#include "Util/TSS.h"
+
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
+namespace
+{
+    // deflate state is around 256KB, keep one initialized stream per thread and only reset it between packets
+    struct UpdateCompressor
+    {
+        UpdateCompressor() : level(-1)
+        {
+            stream.zalloc = (alloc_func)nullptr;
+            stream.zfree = (free_func)nullptr;
+            stream.opaque = (voidpf)nullptr;
+        }
+
+        ~UpdateCompressor()
+        {
+            if (level >= 0)
+                deflateEnd(&stream);
+        }
+
+        z_stream stream;
+        int level;                                          // level the stream was initialized with, -1 if not initialized
+    };
+
+    MaNGOS::thread_local_ptr<UpdateCompressor> updateCompressor;
+
+    // staging buffer for the uncompressed packet, keeps its capacity between packets
+    MaNGOS::thread_local_ptr<ByteBuffer> updatePacketBuffer;
+}
 
 UpdateData::UpdateData() : m_data(1), m_currentIndex(0)
 {
     m_data[0].m_buffer = 0;
 }
 
-void UpdateData::AddOutOfRangeGUID(GuidSet& guids)
+void UpdateData::AddOutOfRangeGUID(GuidHashSet const& guids)
 {
     m_outOfRangeGUIDs.insert(guids.begin(), guids.end());
 }
@@ -61,21 +94,65 @@ void UpdateData::AddUpdateBlock(const ByteBuffer& block)
     }
 }
 
+int UpdateData::GetCompressionLevel(uint32 size)
+{
+    // default Z_BEST_SPEED (1)
+    int level = int(sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    if (level <= Z_BEST_SPEED || !sWorld.getConfig(CONFIG_BOOL_COMPRESSION_ADAPTIVE))
+        return level;
+
+    // small packets gain next to nothing from higher levels
+    if (size < 4 * sWorld.getConfig(CONFIG_UINT32_COMPRESSION_MIN_SIZE))
+        return Z_BEST_SPEED;
+
+    // world update is late, trade bandwidth for cpu
+    uint32 interval = sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE);
+    uint32 diff = World::GetCurrentDiff();
+    if (interval && diff > interval)
+    {
+        uint32 overload = std::min(diff - interval, interval);
+        level -= int((level - Z_BEST_SPEED) * overload / interval);
+    }
+
+    return level;
+}
+
 void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
 {
-    z_stream c_stream;
+    UpdateCompressor* compressor = updateCompressor.get();
+    z_stream& c_stream = compressor->stream;
 
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
+#ifdef BUILD_METRICS
+    metric::duration<std::chrono::microseconds> meas("updatedata.compress");
+#endif
 
-    // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
+    int level = GetCompressionLevel(uint32(src_size));
+    int z_res;
+    if (compressor->level != level)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
+        // first use on this thread or level changed at config reload
+        if (compressor->level >= 0)
+            deflateEnd(&c_stream);
+
+        compressor->level = -1;
+        z_res = deflateInit(&c_stream, level);
+        if (z_res != Z_OK)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+            *dst_size = 0;
+            return;
+        }
+        compressor->level = level;
+    }
+    else
+    {
+        z_res = deflateReset(&c_stream);
+        if (z_res != Z_OK)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+            *dst_size = 0;
+            return;
+        }
     }
 
     c_stream.next_out = (Bytef*)dst;
@@ -106,23 +183,21 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
     *dst_size = c_stream.total_out;
+
+#ifdef BUILD_METRICS
+    meas.add_field("level", static_cast<int32>(level));
+    meas.add_field("in_size", static_cast<int32>(src_size));
+    meas.add_field("out_size", static_cast<int32>(*dst_size));
+    meas.add_field("ratio", src_size ? float(*dst_size) / float(src_size) : 0.0f);
+#endif
 }
 
 WorldPacket UpdateData::BuildPacket(size_t index)
 {
-    WorldPacket packet;
-    MANGOS_ASSERT(packet.empty());                         // shouldn't happen
-
-    ByteBuffer buf(4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data[index].m_buffer.wpos());
+    ByteBuffer& buf = *updatePacketBuffer.get();
+    buf.clear();
+    buf.reserve(4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data[index].m_buffer.wpos());
 
     buf << (uint32)(!m_outOfRangeGUIDs.empty() ? m_data[index].m_blockCount + 1 : m_data[index].m_blockCount);
 
@@ -138,8 +213,11 @@ WorldPacket UpdateData::BuildPacket(size_t index)
     buf.append(m_data[index].m_buffer);
 
     size_t pSize = buf.wpos();                              // use real used data size
+    bool const compress = pSize > sWorld.getConfig(CONFIG_UINT32_COMPRESSION_MIN_SIZE);
+
+    WorldPacket packet(MSG_NULL_ACTION, compress ? compressBound(pSize) + sizeof(uint32) : pSize, PooledStorageTag());
 
-    if (pSize > 100)                                        // compress large packets
+    if (compress)                                           // compress large packets
     {
         uint32 destsize = compressBound(pSize);
         packet.resize(destsize + sizeof(uint32));
@@ -171,7 +249,7 @@ void UpdateData::SendData(WorldSession& session)
 {
     for (size_t i = 0; i < GetPacketCount(); ++i)
     {
-        WorldPacket packet = BuildPacket(i);
-        session.SendPacket(packet);
+        // update packets are the largest we send, let the socket reference them instead of copying
+        session.SendPacket(std::make_shared<WorldPacket const>(BuildPacket(i)));
     }
 }
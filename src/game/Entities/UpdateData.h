@@ -61,7 +61,7 @@ class UpdateData
     public:
         UpdateData();
 
-        void AddOutOfRangeGUID(GuidSet& guids);
+        void AddOutOfRangeGUID(GuidHashSet const& guids);
         void AddOutOfRangeGUID(ObjectGuid const& guid);
         void AddUpdateBlock(const ByteBuffer& block);
         WorldPacket BuildPacket(size_t index); // Copy Elision is a thing
@@ -78,6 +78,7 @@ class UpdateData
         std::vector<BufferPair> m_data;
         uint32 m_currentIndex;
 
+        static int GetCompressionLevel(uint32 size);
         static void Compress(void* dst, uint32* dst_size, void* src, int src_size);
 };
 #endif
@@ -17,6 +17,7 @@
  */
 
 #include "UpdateFields.h"
+#include "UpdateMask.h"
 #include "Log.h"
 #include "ObjectGuid.h"
 #include <array>
@@ -442,6 +443,63 @@ static std::array<uint16, GAMEOBJECT_END> const g_gameObjectUpdateFieldFlags = S
 static std::array<uint16, DYNAMICOBJECT_END> const g_dynamicObjectUpdateFieldFlags = SetupUpdateFieldFlagsArray<DYNAMICOBJECT_END>(TYPEMASK_OBJECT | TYPEMASK_DYNAMICOBJECT);
 static std::array<uint16, CORPSE_END> const g_corpseUpdateFieldFlags = SetupUpdateFieldFlagsArray<CORPSE_END>(TYPEMASK_OBJECT | TYPEMASK_CORPSE);
 
+// Flags GetUpdateFieldFlagsForTarget adds on top of UF_FLAG_PUBLIC | UF_FLAG_DYNAMIC depending on the observer
+static uint16 const g_targetDependentFlags[] = { UF_FLAG_PRIVATE, UF_FLAG_OWNER_ONLY, UF_FLAG_UNK2, UF_FLAG_SPECIAL_INFO, UF_FLAG_GROUP_ONLY };
+static uint32 const VISIBILITY_MASK_COUNT = 1 << (sizeof(g_targetDependentFlags) / sizeof(g_targetDependentFlags[0]));
+
+typedef std::array<UpdateMask, VISIBILITY_MASK_COUNT> VisibilityMasks;
+
+template<std::size_t SIZE>
+static VisibilityMasks SetupVisibilityMasks(std::array<uint16, SIZE> const& flagsArray)
+{
+    VisibilityMasks masks;
+    for (uint32 combination = 0; combination < VISIBILITY_MASK_COUNT; ++combination)
+    {
+        uint16 visibleFlag = UF_FLAG_PUBLIC | UF_FLAG_DYNAMIC;
+        for (uint32 i = 0; i < sizeof(g_targetDependentFlags) / sizeof(g_targetDependentFlags[0]); ++i)
+            if (combination & (1 << i))
+                visibleFlag |= g_targetDependentFlags[i];
+
+        masks[combination].SetCount(SIZE);
+        for (uint32 index = 0; index < SIZE; ++index)
+            if (flagsArray[index] & visibleFlag)
+                masks[combination].SetBit(index);
+    }
+    return masks;
+}
+
+static VisibilityMasks const g_containerVisibilityMasks = SetupVisibilityMasks(g_containerUpdateFieldFlags);
+static VisibilityMasks const g_playerVisibilityMasks = SetupVisibilityMasks(g_playerUpdateFieldFlags);
+static VisibilityMasks const g_gameObjectVisibilityMasks = SetupVisibilityMasks(g_gameObjectUpdateFieldFlags);
+static VisibilityMasks const g_dynamicObjectVisibilityMasks = SetupVisibilityMasks(g_dynamicObjectUpdateFieldFlags);
+static VisibilityMasks const g_corpseVisibilityMasks = SetupVisibilityMasks(g_corpseUpdateFieldFlags);
+
+UpdateMask const* UpdateFields::GetUpdateFieldVisibilityMask(uint8 objectTypeId, uint16 visibleFlag)
+{
+    uint32 combination = 0;
+    for (uint32 i = 0; i < sizeof(g_targetDependentFlags) / sizeof(g_targetDependentFlags[0]); ++i)
+        if (visibleFlag & g_targetDependentFlags[i])
+            combination |= 1 << i;
+
+    switch (objectTypeId)
+    {
+        case TYPEID_ITEM:
+        case TYPEID_CONTAINER:
+            return &g_containerVisibilityMasks[combination];
+        case TYPEID_UNIT:
+        case TYPEID_PLAYER:
+            return &g_playerVisibilityMasks[combination];
+        case TYPEID_GAMEOBJECT:
+            return &g_gameObjectVisibilityMasks[combination];
+        case TYPEID_DYNAMICOBJECT:
+            return &g_dynamicObjectVisibilityMasks[combination];
+        case TYPEID_CORPSE:
+            return &g_corpseVisibilityMasks[combination];
+    }
+    sLog.outError("Unhandled object type id (%hhu) in GetUpdateFieldVisibilityMask!", objectTypeId);
+    return nullptr;
+}
+
 uint16 const* UpdateFields::GetUpdateFieldFlagsArray(uint8 objectTypeId)
 {
     switch (objectTypeId)
@@ -471,9 +471,13 @@ struct UpdateFieldData
     uint16 flags = UF_FLAG_NONE;
 };
 
+class UpdateMask;
+
 namespace UpdateFields
 {
     uint16 const* GetUpdateFieldFlagsArray(uint8 objectTypeId);
+    // fields an observer granted visibleFlag (always including UF_FLAG_PUBLIC | UF_FLAG_DYNAMIC) can see, precomputed per object type
+    UpdateMask const* GetUpdateFieldVisibilityMask(uint8 objectTypeId, uint16 visibleFlag);
     UpdateFieldData const* GetUpdateFieldDataByName(char const* name);
     UpdateFieldData const* GetUpdateFieldDataByTypeMaskAndOffset(uint8 objectTypeMask, uint16 offset);
 };
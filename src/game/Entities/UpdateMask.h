@@ -20,6 +20,11 @@
 #define __UPDATEMASK_H
 
 #include "Util/Errors.h"
+#include "Util/ByteConverter.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 class UpdateMask
 {
@@ -48,6 +53,40 @@ class UpdateMask
             return (((uint8*)mUpdateMask)[ index >> 3 ] & (1 << (index & 0x7))) != 0;
         }
 
+        // next set bit at or after index, GetCount() when there is none
+        // whole blocks are skipped at once, so scanning costs proportional to set bits rather than fields
+        uint32 FindNextSetBit(uint32 index) const
+        {
+            uint32 block = index >> 5;
+            if (block >= mBlocks)
+                return mCount;
+
+            uint32 bits = GetBlockBits(block) & (0xFFFFFFFF << (index & 0x1F));
+            while (!bits)
+            {
+                if (++block >= mBlocks)
+                    return mCount;
+                bits = GetBlockBits(block);
+            }
+
+            uint32 const found = (block << 5) + CountTrailingZeros(bits);
+            return found < mCount ? found : mCount;
+        }
+
+        // sets this mask to first & second, both must cover at least GetCount() bits
+        void SetIntersection(UpdateMask const& first, UpdateMask const& second)
+        {
+            MANGOS_ASSERT(first.mCount >= mCount && second.mCount >= mCount);
+            uint32 any = 0;
+            // plain word loop, vectorized by the compiler
+            for (uint32 i = 0; i < mBlocks; ++i)
+            {
+                mUpdateMask[i] = first.mUpdateMask[i] & second.mUpdateMask[i];
+                any |= mUpdateMask[i];
+            }
+            mHasData = any != 0;
+        }
+
         uint32 GetBlockCount() const { return mBlocks; }
         uint32 GetLength() const { return mBlocks << 2; }
         uint32 GetCount() const { return mCount; }
@@ -115,6 +154,25 @@ class UpdateMask
         }
 
     private:
+        // bits are set bytewise, read the block as the little endian word sent to the client
+        uint32 GetBlockBits(uint32 block) const
+        {
+            uint32 bits = mUpdateMask[block];
+            EndianConvert(bits);
+            return bits;
+        }
+
+        static uint32 CountTrailingZeros(uint32 bits)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, bits);
+            return uint32(index);
+#else
+            return uint32(__builtin_ctz(bits));
+#endif
+        }
+
         bool mHasData;
         uint32 mCount;
         uint32 mBlocks;
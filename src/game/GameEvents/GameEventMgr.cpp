@@ -403,6 +403,8 @@ void GameEventMgr::LoadFromDB()
         sLog.outString(">> Loaded %u gameobjects in game events", count);
     }
 
+    BuildMapSpawns();
+
     // now recheck that all eventPools linked with events after our skip pools with parents
     for (std::map<uint16, int16>::const_iterator itr = pool2event.begin(); itr != pool2event.end();  ++itr)
     {
@@ -895,8 +897,6 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
             }
 
             sObjectMgr.AddCreatureToGrid(itr, data);
-
-            Creature::SpawnInMaps(itr, data);
         }
     }
 
@@ -925,11 +925,12 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
             }
 
             sObjectMgr.AddGameobjectToGrid(itr, data);
-
-            GameObject::SpawnInMaps(itr, data);
         }
     }
 
+    // loaded grids get the objects over the next map updates
+    SendMapSpawns(internal_event_id, true);
+
     if (event_id > 0)
     {
         if ((size_t)event_id >= m_gameEventSpawnPoolIds.size())
@@ -943,6 +944,86 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
     }
 }
 
+// Objects spawned outside pools, grouped by map and ordered by grid, so a map can spawn them a batch per update
+void GameEventMgr::BuildMapSpawns()
+{
+    m_gameEventMapSpawns.clear();
+    m_gameEventMapSpawns.resize(m_gameEvents.size() * 2 - 1);
+
+    for (uint32 internal_event_id = 0; internal_event_id < m_gameEventMapSpawns.size(); ++internal_event_id)
+    {
+        int32 event_id = int32(internal_event_id) - int32(m_gameEvents.size()) + 1;
+        GameEventMapSpawnsMap& mapSpawns = m_gameEventMapSpawns[internal_event_id];
+        std::map<uint32, std::vector<std::pair<uint32, uint32>>> creatures, gameobjects; // map id -> (grid, guid)
+
+        for (uint32 guid : m_gameEventCreatureGuids[internal_event_id])
+        {
+            // pooled objects of negative events go through their pool
+            if (event_id < 0 && sPoolMgr.IsPartOfAPool<Creature>(guid))
+                continue;
+
+            if (CreatureData const* data = sObjectMgr.GetCreatureData(guid))
+            {
+                GridPair grid = MaNGOS::ComputeGridPair(data->posX, data->posY);
+                creatures[data->mapid].push_back({ grid.x_coord * MAX_NUMBER_OF_GRIDS + grid.y_coord, guid });
+            }
+        }
+
+        for (uint32 guid : m_gameEventGameobjectGuids[internal_event_id])
+        {
+            if (event_id < 0 && sPoolMgr.IsPartOfAPool<GameObject>(guid))
+                continue;
+
+            if (GameObjectData const* data = sObjectMgr.GetGOData(guid))
+            {
+                GridPair grid = MaNGOS::ComputeGridPair(data->posX, data->posY);
+                gameobjects[data->mapid].push_back({ grid.x_coord * MAX_NUMBER_OF_GRIDS + grid.y_coord, guid });
+            }
+        }
+
+        auto fill = [&mapSpawns](std::map<uint32, std::vector<std::pair<uint32, uint32>>>& byMap, bool creature)
+        {
+            for (auto& mapItr : byMap)
+            {
+                GameEventMapSpawns& spawns = mapSpawns[mapItr.first];
+                if (!spawns.creatures)
+                {
+                    spawns.creatures = std::make_shared<std::vector<uint32>>();
+                    spawns.gameobjects = std::make_shared<std::vector<uint32>>();
+                }
+
+                std::sort(mapItr.second.begin(), mapItr.second.end());
+                std::vector<uint32>& guids = creature ? *spawns.creatures : *spawns.gameobjects;
+                guids.reserve(mapItr.second.size());
+                for (auto const& gridGuid : mapItr.second)
+                    guids.push_back(gridGuid.second);
+            }
+        };
+        fill(creatures, true);
+        fill(gameobjects, false);
+    }
+}
+
+void GameEventMgr::SendMapSpawns(int32 internal_event_id, bool spawn)
+{
+    if ((size_t)internal_event_id >= m_gameEventMapSpawns.size())
+        return;
+
+    for (auto const& mapItr : m_gameEventMapSpawns[internal_event_id])
+    {
+        Map::GameEventSpawnList creatures = mapItr.second.creatures;
+        Map::GameEventSpawnList gameobjects = mapItr.second.gameobjects;
+        auto post = [&creatures, &gameobjects, spawn](Map* map)
+        {
+            map->GetMessager().AddMessage([creatures, gameobjects, spawn](Map* map)
+            {
+                map->AddGameEventSpawns(creatures, gameobjects, spawn);
+            });
+        };
+        sMapMgr.DoForAllMapsWithMapId(mapItr.first, post);
+    }
+}
+
 void GameEventMgr::GameEventUnspawn(int16 event_id)
 {
     int32 internal_event_id = m_gameEvents.size() + event_id - 1;
@@ -971,9 +1052,6 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
 
             // Remove spawn data
             sObjectMgr.RemoveCreatureFromGrid(itr, data);
-
-            // Remove spawned cases
-            Creature::AddToRemoveListInMaps(itr, data);
         }
     }
 
@@ -1001,12 +1079,12 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
 
             // Remove spawn data
             sObjectMgr.RemoveGameobjectFromGrid(itr, data);
-
-            // Remove spawned cases
-            GameObject::AddToRemoveListInMaps(itr, data);
         }
     }
 
+    // spawned objects are removed over the next map updates
+    SendMapSpawns(internal_event_id, false);
+
     if (event_id > 0)
     {
         if ((size_t)event_id >= m_gameEventSpawnPoolIds.size())
@@ -1097,6 +1175,10 @@ void GameEventMgr::UpdateEventQuests(uint16 event_id, bool Activate)
 
         const_cast<Quest*>(pQuest)->SetQuestActiveState(Activate);
     }
+
+    // quest giver status cached by players depends on active quests
+    if (!m_gameEventQuests[event_id].empty())
+        ++m_questStateGeneration;
 }
 
 void GameEventMgr::UpdateWorldStates(uint16 event_id, bool Activate)
@@ -1136,7 +1218,7 @@ void GameEventMgr::SendEventMails(int16 event_id)
                << " AND characters.deleteDate IS NULL AND character_queststatus.guid = characters.guid AND character_queststatus.quest = "
                << mail.questId
                << " AND character_queststatus.rewarded <> 0";
-            sMassMailMgr.AddMassMailTask(new MailDraft(mail.mailTemplateId), MailSender(MAIL_CREATURE, mail.senderEntry), ss.str().c_str());
+            sMassMailMgr.AddMassMailTask(new MailDraft(mail.mailTemplateId), MailSender(MAIL_CREATURE, mail.senderEntry), ss.str().c_str(), "characters.guid");
         }
         else
             sMassMailMgr.AddMassMailTask(new MailDraft(mail.mailTemplateId), MailSender(MAIL_CREATURE, mail.senderEntry), mail.raceMask);
@@ -1176,7 +1258,7 @@ int16 GameEventMgr::GetGameEventId<Pool>(uint32 guid_or_poolid)
     return 0;
 }
 
-GameEventMgr::GameEventMgr()
+GameEventMgr::GameEventMgr() : m_questStateGeneration(0)
 {
     m_isGameEventsInit = false;
 }
@@ -23,6 +23,8 @@
 #include "Globals/SharedDefines.h"
 #include "Platform/Define.h"
 
+#include <atomic>
+
 #define max_ge_check_delay 86400                            // 1 day in seconds
 #define FAR_FUTURE 4102444800                               // 2100, January 1st
 
@@ -118,11 +120,16 @@ class GameEventMgr
         GameEventCreatureData const* GetCreatureUpdateDataForActiveEvent(uint32 lowguid) const;
 
         void WeeklyEventTimerRecalculation();
+
+        // changes whenever event quests are activated or deactivated
+        uint32 GetQuestStateGeneration() const { return m_questStateGeneration; }
     private:
         void ApplyNewEvent(uint16 event_id, bool resume);
         void UnApplyEvent(uint16 event_id);
         void GameEventSpawn(int16 event_id);
         void GameEventUnspawn(int16 event_id);
+        void BuildMapSpawns();
+        void SendMapSpawns(int32 internal_event_id, bool spawn);
         void UpdateCreatureData(int16 event_id, bool activate);
         void UpdateEventQuests(uint16 event_id, bool Activate);
         void UpdateWorldStates(uint16 event_id, bool Activate);
@@ -130,7 +137,7 @@ class GameEventMgr
         void OnEventHappened(uint16 event_id, bool activate, bool resume);
         void ComputeEventStartAndEndTime(GameEventData& data, time_t today);
     protected:
-        typedef std::list<uint32> GuidList;
+        typedef std::vector<uint32> GuidList;
         typedef std::list<uint16> IdList;
         typedef std::vector<GuidList> GameEventGuidMap;
         typedef std::vector<IdList> GameEventIdMap;
@@ -143,6 +150,7 @@ class GameEventMgr
         typedef std::vector<QuestList> GameEventQuestMap;
 
         GameEventQuestMap m_gameEventQuests;                 // events size, only positive event case
+        std::atomic<uint32> m_questStateGeneration;
 
         GameEventCreatureDataMap m_gameEventCreatureData;    // events size, only positive event case
         GameEventCreatureDataPerGuidMap m_gameEventCreatureDataPerGuid;
@@ -154,6 +162,15 @@ class GameEventMgr
         GameEventGuidMap  m_gameEventCreatureGuids;          // events*2-1
         GameEventGuidMap  m_gameEventGameobjectGuids;       // events*2-1
         GameEventIdMap    m_gameEventSpawnPoolIds;          // events size, only positive event case
+
+        // creatures and gameobjects of an event spawned directly on one map, ordered by grid
+        struct GameEventMapSpawns
+        {
+            std::shared_ptr<std::vector<uint32>> creatures;
+            std::shared_ptr<std::vector<uint32>> gameobjects;
+        };
+        typedef std::map<uint32 /*mapId*/, GameEventMapSpawns> GameEventMapSpawnsMap;
+        std::vector<GameEventMapSpawnsMap> m_gameEventMapSpawns; // events*2-1
         GameEventDataMap  m_gameEvents;
         ActiveEvents m_activeEvents;
         bool m_isGameEventsInit;
@@ -102,61 +102,247 @@ uint8 const ConditionTargetsInternal[] =
 // Starts from 4th element so that -3 will return first element.
 uint8 const* ConditionTargets = &ConditionTargetsInternal[3];
 
-// Checks if player meets the condition
-bool ConditionEntry::Meets(WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const
+namespace
 {
-    DEBUG_LOG("Condition-System: Check condition %u, type %i - called from %s with params target: %s, map %i, source %s",
-              m_entry, m_condition, conditionSourceToStr[conditionSourceType], target ? target->GetGuidStr().c_str() : "<nullptr>", map ? map->GetId() : -1, source ? source->GetGuidStr().c_str() : "<nullptr>");
+    // Jump targets at and above STEP_TERMINAL end the program
+    uint16 const STEP_TRUE     = 0xFFFF;
+    uint16 const STEP_FALSE    = 0xFFFE;
+    uint16 const STEP_TERMINAL = 0xFFFE;
 
-    if (m_flags & CONDITION_FLAG_SWAP_TARGETS)
-        std::swap(source, target);
+    uint32 const MAX_CONDITION_DEPTH = 32;                  // deeper trees only come from self references
+    uint32 const MAX_CONDITION_NODES = 4096;                // bounds trees that reuse the same subcondition over and over
 
-    if (!CheckParamRequirements(target, map, source))
+    // One leaf check of a flattened condition tree. CONDITION_NOT, CONDITION_AND, CONDITION_OR and the
+    // reverse flags are all expressed by where the step jumps to, so evaluation never recurses.
+    struct ConditionStep
     {
-        sLog.outErrorDb("CONDITION %u type %u used with bad parameters, called from %s, used with target: %s, map %i, source %s",
-            m_entry, m_condition, conditionSourceToStr[conditionSourceType], target ? target->GetGuidStr().c_str() : "<nullptr>", map ? map->GetId() : -1, source ? source->GetGuidStr().c_str() : "<nullptr>");
-        return false;
-    } 
+        ConditionEntry const* leaf;
+        uint16 onTrue;
+        uint16 onFalse;
+        uint16 onBadParams;                                 // bad parameters fail the leaf without its own reverse flag
+        bool swapTargets;
+        bool memoize;
+    };
+
+    struct ConditionProgram
+    {
+        std::vector<ConditionStep> steps;
+        uint16 start = STEP_FALSE;
+    };
+
+    std::vector<ConditionProgram> s_conditionPrograms;      // indexed by condition entry
+
+    struct CachedResult
+    {
+        ConditionEntry const* leaf;
+        WorldObject const* target;
+        WorldObject const* source;
+        Map const* map;
+        ConditionSource sourceType;
+        bool result;
+    };
+
+    size_t const MAX_CACHED_RESULTS = 128;
 
-    bool result = Evaluate(target, map, source, conditionSourceType);
+    struct ConditionCache
+    {
+        uint32 scopes = 0;
+        std::vector<CachedResult> results;
+    };
 
-    if (m_flags & CONDITION_FLAG_REVERSE_RESULT)
-        result = !result;
+    thread_local ConditionCache s_conditionCache;
 
-    return result;
+    // Leaves whose lookups cost enough to be worth remembering within a ConditionCacheScope
+    bool IsMemoizedConditionType(ConditionType type)
+    {
+        switch (type)
+        {
+            case CONDITION_AURA:
+            case CONDITION_AD_COMMISSION_AURA:
+            case CONDITION_AREAID:
+            case CONDITION_AREA_FLAG:
+            case CONDITION_QUESTREWARDED:
+            case CONDITION_QUESTTAKEN:
+            case CONDITION_QUESTAVAILABLE:
+            case CONDITION_QUEST_NONE:
+            case CONDITION_ITEM_WITH_BANK:
+            case CONDITION_CREATURE_IN_RANGE:
+            case CONDITION_SPAWN_COUNT:
+                return true;
+            default:
+                return false;
+        }
+    }
 }
 
-// Actual evaluation of the condition done here.
-bool inline ConditionEntry::Evaluate(WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const
+struct ConditionCompiler
 {
-    switch (m_condition)
+    std::vector<ConditionStep>& steps;
+    uint32 nodes;
+
+    // Sets start to the step that begins evaluating entry, or to a terminal when the result is known at load
+    bool Compile(uint32 entry, bool swapTargets, uint16 onTrue, uint16 onFalse, uint32 depth, uint16& start)
     {
-        case CONDITION_NOT:
-        {
-            // Checked on load
-            return !sConditionStorage.LookupEntry<ConditionEntry>(m_value1)->Meets(target, map, source, conditionSourceType);
-        }
-        case CONDITION_OR:
+        ConditionEntry const* condition = sConditionStorage.LookupEntry<ConditionEntry>(entry);
+        if (!condition || depth > MAX_CONDITION_DEPTH || ++nodes > MAX_CONDITION_NODES)
+            return false;
+
+        if (condition->m_flags & CONDITION_FLAG_SWAP_TARGETS)
+            swapTargets = !swapTargets;
+
+        uint16 const onBadParams = onFalse;
+        if (condition->m_flags & CONDITION_FLAG_REVERSE_RESULT)
+            std::swap(onTrue, onFalse);
+
+        switch (condition->m_condition)
         {
-            // Third and fourth condition are optional
-            if (m_value3 && sConditionStorage.LookupEntry<ConditionEntry>(m_value3)->Meets(target, map, source, conditionSourceType))
+            case CONDITION_NOT:
+                return Compile(condition->m_value1, swapTargets, onFalse, onTrue, depth + 1, start);
+            case CONDITION_AND:
+            case CONDITION_OR:
+            {
+                // same order as the checks were always done in: optional third and fourth first
+                uint32 const operands[] = { condition->m_value3, condition->m_value4, condition->m_value1, condition->m_value2 };
+                bool const isAnd = condition->m_condition == CONDITION_AND;
+                uint16 next = isAnd ? onTrue : onFalse;
+                for (int i = 3; i >= 0; --i)
+                {
+                    if (i < 2 && !operands[i])
+                        continue;
+
+                    if (!Compile(operands[i], swapTargets, isAnd ? next : onTrue, isAnd ? onFalse : next, depth + 1, next))
+                        return false;
+                }
+                start = next;
                 return true;
-            if (m_value4 && sConditionStorage.LookupEntry<ConditionEntry>(m_value4)->Meets(target, map, source, conditionSourceType))
+            }
+            case CONDITION_NONE:
+                start = onTrue;                             // empty condition, always met
+                return true;
+            case CONDITION_UNUSED_2:
+            case CONDITION_UNUSED_3:
+            case CONDITION_UNUSED_4:
+            case CONDITION_UNUSED_5:
+            case CONDITION_UNUSED_6:
+            case CONDITION_UNUSED_7:
+                start = onFalse;
                 return true;
-            
-            return sConditionStorage.LookupEntry<ConditionEntry>(m_value1)->Meets(target, map, source, conditionSourceType) || sConditionStorage.LookupEntry<ConditionEntry>(m_value2)->Meets(target, map, source, conditionSourceType);
+            default:
+                break;
         }
-        case CONDITION_AND:
+
+        // result can not change where evaluation continues
+        if (onTrue == onFalse && onFalse == onBadParams)
         {
-            // Third and fourth condition are optional
-            bool extraConditionsSatisfied = true;
-            if (m_value3)
-                extraConditionsSatisfied = extraConditionsSatisfied && sConditionStorage.LookupEntry<ConditionEntry>(m_value3)->Meets(target, map, source, conditionSourceType);
-            if (m_value4)
-                extraConditionsSatisfied = extraConditionsSatisfied && sConditionStorage.LookupEntry<ConditionEntry>(m_value4)->Meets(target, map, source, conditionSourceType);
+            start = onTrue;
+            return true;
+        }
+
+        if (steps.size() >= STEP_TERMINAL)
+            return false;
+
+        start = uint16(steps.size());
+        steps.push_back({ condition, onTrue, onFalse, onBadParams, swapTargets, IsMemoizedConditionType(condition->m_condition) });
+        return true;
+    }
+
+    static bool EvaluateStep(ConditionStep const& step, WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType, bool& result)
+    {
+        ConditionEntry const* leaf = step.leaf;
+        if (step.swapTargets)
+            std::swap(source, target);
+
+        ConditionCache& cache = s_conditionCache;
+        bool const useCache = step.memoize && cache.scopes;
+        if (useCache)
+        {
+            for (CachedResult const& cached : cache.results)
+            {
+                if (cached.leaf == leaf && cached.target == target && cached.source == source && cached.map == map && cached.sourceType == conditionSourceType)
+                {
+                    result = cached.result;
+                    return true;
+                }
+            }
+        }
+
+        if (!leaf->CheckParamRequirements(target, map, source))
+        {
+            sLog.outErrorDb("CONDITION %u type %u used with bad parameters, called from %s, used with target: %s, map %i, source %s",
+                leaf->m_entry, leaf->m_condition, conditionSourceToStr[conditionSourceType], target ? target->GetGuidStr().c_str() : "<nullptr>", map ? map->GetId() : -1, source ? source->GetGuidStr().c_str() : "<nullptr>");
+            return false;
+        }
+
+        result = leaf->Evaluate(target, map, source, conditionSourceType);
+        if (useCache && cache.results.size() < MAX_CACHED_RESULTS)
+            cache.results.push_back({ leaf, target, source, map, conditionSourceType, result });
+        return true;
+    }
+};
+
+void ConditionEntry::CompileAll()
+{
+    s_conditionPrograms.clear();
+    s_conditionPrograms.resize(sConditionStorage.GetMaxEntry());
 
-            return extraConditionsSatisfied && sConditionStorage.LookupEntry<ConditionEntry>(m_value1)->Meets(target, map, source, conditionSourceType) && sConditionStorage.LookupEntry<ConditionEntry>(m_value2)->Meets(target, map, source, conditionSourceType);
+    for (uint32 i = 0; i < sConditionStorage.GetMaxEntry(); ++i)
+    {
+        if (!sConditionStorage.LookupEntry<ConditionEntry>(i))
+            continue;
+
+        ConditionProgram& program = s_conditionPrograms[i];
+        ConditionCompiler compiler = { program.steps, 0 };
+        if (!compiler.Compile(i, false, STEP_TRUE, STEP_FALSE, 0, program.start))
+        {
+            sLog.outErrorDb("ObjectMgr::LoadConditions: condition_entry %u references itself or is nested too deep, skip", i);
+            program = ConditionProgram();
+            sConditionStorage.EraseEntry(i);
+            continue;
         }
+        program.steps.shrink_to_fit();
+    }
+}
+
+ConditionCacheScope::ConditionCacheScope()
+{
+    ++s_conditionCache.scopes;
+}
+
+ConditionCacheScope::~ConditionCacheScope()
+{
+    if (--s_conditionCache.scopes == 0)
+        s_conditionCache.results.clear();
+}
+
+// Checks if player meets the condition
+bool ConditionEntry::Meets(WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const
+{
+    DEBUG_LOG("Condition-System: Check condition %u, type %i - called from %s with params target: %s, map %i, source %s",
+              m_entry, m_condition, conditionSourceToStr[conditionSourceType], target ? target->GetGuidStr().c_str() : "<nullptr>", map ? map->GetId() : -1, source ? source->GetGuidStr().c_str() : "<nullptr>");
+
+    if (m_entry >= s_conditionPrograms.size())
+        return false;
+
+    ConditionProgram const& program = s_conditionPrograms[m_entry];
+    uint16 current = program.start;
+    while (current < STEP_TERMINAL)
+    {
+        ConditionStep const& step = program.steps[current];
+        bool result;
+        if (!ConditionCompiler::EvaluateStep(step, target, map, source, conditionSourceType, result))
+            current = step.onBadParams;
+        else
+            current = result ? step.onTrue : step.onFalse;
+    }
+
+    return current == STEP_TRUE;
+}
+
+// Actual evaluation of a leaf condition done here, CONDITION_NOT, CONDITION_AND and CONDITION_OR are compiled into jumps at load
+bool inline ConditionEntry::Evaluate(WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const
+{
+    switch (m_condition)
+    {
         case CONDITION_NONE:
         {
             return true;                                    // empty condition, always met
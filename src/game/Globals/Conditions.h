@@ -153,7 +153,12 @@ class ConditionEntry
 
         // Checks if the condition is met
         bool Meets(WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const;
+
+        // Flattens every loaded condition tree into a jump program, erases the entries that can not be compiled
+        static void CompileAll();
     private:
+        friend struct ConditionCompiler;
+
         void DisableCondition() { m_condition = CONDITION_NONE; m_flags ^= CONDITION_FLAG_REVERSE_RESULT; }
         bool CheckParamRequirements(WorldObject const* target, Map const* map, WorldObject const* source) const;
         bool inline Evaluate(WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const;
@@ -166,6 +171,18 @@ class ConditionEntry
         uint8 m_flags;
 };
 
+// Results of expensive leaf conditions are remembered while a scope is alive on the current thread,
+// so building one gossip menu, vendor list or loot does not repeat the same aura, area and quest lookups.
+// Must not span code that changes the state the conditions depend on.
+class ConditionCacheScope
+{
+    public:
+        ConditionCacheScope();
+        ~ConditionCacheScope();
+        ConditionCacheScope(ConditionCacheScope const&) = delete;
+        ConditionCacheScope& operator=(ConditionCacheScope const&) = delete;
+};
+
 // Check if a player meets condition conditionId
 bool IsConditionSatisfied(uint32 conditionId, WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType);
 
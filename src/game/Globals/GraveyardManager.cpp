@@ -24,8 +24,32 @@
 #include "Maps/Map.h"
 #include "World/World.h"
 
-WorldSafeLocsEntry const* GraveyardManager::GetClosestGraveyardHelper(GraveYardMapBounds bounds, float x, float y, float z, uint32 mapId, Team team) const
+void GraveyardManager::BuildIndex() const
 {
+    m_index.clear();
+    for (auto const& itr : m_graveyardMap)
+    {
+        // Checked on load
+        if (WorldSafeLocsEntry const* entry = sWorldSafeLocsStore.LookupEntry<WorldSafeLocsEntry>(itr.second.safeLocId))
+            m_index[itr.first].push_back({ entry, itr.second.team });
+    }
+    m_indexDirty = false;
+}
+
+GraveyardManager::GraveyardCandidates const* GraveyardManager::GetCandidates(uint32 locKey) const
+{
+    if (m_indexDirty)
+        BuildIndex();
+
+    auto itr = m_index.find(locKey);
+    return itr != m_index.end() ? &itr->second : nullptr;
+}
+
+WorldSafeLocsEntry const* GraveyardManager::GetClosestGraveyardHelper(GraveyardCandidates const* candidates, float x, float y, float z, uint32 mapId, Team team) const
+{
+    if (!candidates)
+        return nullptr;
+
     // Simulate std. algorithm:
     //   found some graveyard associated to (ghost_zone,ghost_map)
     //
@@ -49,17 +73,14 @@ WorldSafeLocsEntry const* GraveyardManager::GetClosestGraveyardHelper(GraveYardM
 
     MapEntry const* mapEntry = sMapStore.LookupEntry(mapId);
 
-    for (GraveYardMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+    for (GraveyardCandidate const& candidate : *candidates)
     {
-        GraveYardData const& data = itr->second;
-
-        // Checked on load
-        WorldSafeLocsEntry const* entry = sWorldSafeLocsStore.LookupEntry<WorldSafeLocsEntry>(data.safeLocId);
+        WorldSafeLocsEntry const* entry = candidate.entry;
 
         // skip enemy faction graveyard
         // team == TEAM_BOTH_ALLOWED case can be at call from .neargrave
         // TEAM_INVALID != team for all teams
-        if (data.team != TEAM_BOTH_ALLOWED && data.team != team && team != TEAM_BOTH_ALLOWED)
+        if (candidate.team != TEAM_BOTH_ALLOWED && candidate.team != team && team != TEAM_BOTH_ALLOWED)
             continue;
 
         // find now nearest graveyard at other (continent) map
@@ -128,7 +149,8 @@ void GraveyardManager::Init(Map* map)
 {
     // TODO: Only load relevant ones for specific map - warning: for example TK needs to have netherstorm
     // For now its likely not that harmful, its not that big
-    m_graveyardMap = sWorld.GetGraveyardManager().GetGraveyardMap();
+    m_graveyardMap = sWorld.GetGraveyardManager().GetGraveyardLinks();
+    m_indexDirty = true;
 }
 
 WorldSafeLocsEntry const* GraveyardManager::GetClosestGraveYard(float x, float y, float z, uint32 mapId, Team team) const
@@ -137,27 +159,18 @@ WorldSafeLocsEntry const* GraveyardManager::GetClosestGraveYard(float x, float y
     //  - First try linked to the current area id (if we have one)
     //  - Then try linked to the current zone id (if we have one)
     //  - Then try linked to the current map id
-    const uint32 zoneId = sTerrainMgr.GetZoneId(mapId, x, y, z);
-    const uint32 areaId = sTerrainMgr.GetAreaId(mapId, x, y, z);
+    uint32 zoneId, areaId;
+    sTerrainMgr.GetZoneAndAreaId(zoneId, areaId, mapId, x, y, z);
 
     WorldSafeLocsEntry const* graveyard = nullptr;
     if (areaId != 0)
-    {
-        auto bounds = m_graveyardMap.equal_range(GraveyardLinkKey(areaId, GRAVEYARD_AREALINK));
-        graveyard = GetClosestGraveyardHelper(bounds, x, y, z, mapId, team);
-    }
+        graveyard = GetClosestGraveyardHelper(GetCandidates(GraveyardLinkKey(areaId, GRAVEYARD_AREALINK)), x, y, z, mapId, team);
 
-    if (zoneId != 0 && graveyard == nullptr)
-    {
-        auto bounds = m_graveyardMap.equal_range(GraveyardLinkKey(zoneId, GRAVEYARD_AREALINK));
-        graveyard = GetClosestGraveyardHelper(bounds, x, y, z, mapId, team);
-    }
+    if (zoneId != 0 && graveyard == nullptr && zoneId != areaId)
+        graveyard = GetClosestGraveyardHelper(GetCandidates(GraveyardLinkKey(zoneId, GRAVEYARD_AREALINK)), x, y, z, mapId, team);
 
     if (graveyard == nullptr)
-    {
-        auto bounds = m_graveyardMap.equal_range(GraveyardLinkKey(mapId, GRAVEYARD_MAPLINK));
-        graveyard = GetClosestGraveyardHelper(bounds, x, y, z, mapId, team);
-    }
+        graveyard = GetClosestGraveyardHelper(GetCandidates(GraveyardLinkKey(mapId, GRAVEYARD_MAPLINK)), x, y, z, mapId, team);
 
     if (graveyard == nullptr)
         sLog.outErrorDb("Table `game_graveyard_zone` incomplete: Map %u Zone "
@@ -233,6 +246,7 @@ bool GraveyardManager::AddGraveYardLink(uint32 id, uint32 locId, uint32 linkKind
     data.safeLocId = id;
     data.team = team;
     m_graveyardMap.insert(GraveYardMap::value_type(locKey, data));
+    m_indexDirty = true;
 
     if (inDB)
         WorldDatabase.PExecuteLog("INSERT INTO game_graveyard_zone "
@@ -255,6 +269,13 @@ void GraveyardManager::SetGraveYardLinkTeam(uint32 id, uint32 locKey, Team team)
             continue;
 
         data.team = team;                                   // Validate link
+
+        // capture points flip teams often, keep the index instead of rebuilding it
+        auto indexed = m_index.find(locKey);
+        if (!m_indexDirty && indexed != m_index.end())
+            for (GraveyardCandidate& candidate : indexed->second)
+                if (candidate.entry->ID == id)
+                    candidate.team = team;
         return;
     }
 
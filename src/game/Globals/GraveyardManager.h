@@ -59,11 +59,26 @@ class GraveyardManager
         static uint32 GraveyardLinkKey(uint32 locId, uint32 linkKind);
 
         // Only for use in Map
-        GraveYardMap& GetGraveyardMap() { return m_graveyardMap; }
+        GraveYardMap& GetGraveyardMap() { m_indexDirty = true; return m_graveyardMap; }
+        GraveYardMap const& GetGraveyardLinks() const { return m_graveyardMap; }
     private:
-        WorldSafeLocsEntry const* GetClosestGraveyardHelper(GraveYardMapBounds bounds, float x, float y, float z, uint32 mapId, Team team) const;
+        // a link with its safe location resolved, links of one location key are stored together
+        struct GraveyardCandidate
+        {
+            WorldSafeLocsEntry const* entry;
+            Team team;
+        };
+        typedef std::vector<GraveyardCandidate> GraveyardCandidates;
+
+        WorldSafeLocsEntry const* GetClosestGraveyardHelper(GraveyardCandidates const* candidates, float x, float y, float z, uint32 mapId, Team team) const;
+        GraveyardCandidates const* GetCandidates(uint32 locKey) const;
+        void BuildIndex() const;
 
         GraveYardMap m_graveyardMap;
+
+        // m_graveyardMap by location key, rebuilt on first use after the map was handed out for changes
+        mutable std::unordered_map<uint32, GraveyardCandidates> m_index;
+        mutable bool m_indexDirty = true;
 };
 
 #endif
\ No newline at end of file
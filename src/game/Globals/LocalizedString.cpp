@@ -0,0 +1,50 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Globals/LocalizedString.h"
+#include "Log.h"
+
+INSTANTIATE_SINGLETON_1(LocalizedStringArena);
+
+LocalizedStringArena::LocalizedStringArena() : m_count(1)
+{
+    m_chunks[0].reset(new std::string[CHUNK_SIZE]);
+}
+
+uint32 LocalizedStringArena::Intern(std::string const& str)
+{
+    if (str.empty())
+        return 0;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_index.find(std::string_view(str));
+    if (itr != m_index.end())
+        return itr->second;
+
+    uint32 const offset = m_count;
+    MANGOS_ASSERT((offset >> CHUNK_BITS) < MAX_CHUNKS);
+    std::unique_ptr<std::string[]>& chunk = m_chunks[offset >> CHUNK_BITS];
+    if (!chunk)
+        chunk.reset(new std::string[CHUNK_SIZE]);
+
+    std::string& stored = chunk[offset & CHUNK_MASK];
+    stored = str;
+    m_index.emplace(std::string_view(stored), offset);
+    ++m_count;
+    return offset;
+}
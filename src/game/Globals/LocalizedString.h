@@ -0,0 +1,80 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LOCALIZEDSTRING_H
+#define MANGOS_LOCALIZEDSTRING_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Interned storage of the localized texts of the locale tables. Each distinct text is kept once,
+// for the whole server run, and referenced by its offset. Offset 0 is the empty string.
+// Offsets are handed out under lock, reading a text by its offset does not lock.
+class LocalizedStringArena
+{
+    public:
+        LocalizedStringArena();
+
+        uint32 Intern(std::string const& str);
+        std::string const& Get(uint32 offset) const { return m_chunks[offset >> CHUNK_BITS][offset & CHUNK_MASK]; }
+
+        uint32 GetCount() const { return m_count; }
+
+    private:
+        static uint32 const CHUNK_BITS = 12;
+        static uint32 const CHUNK_SIZE = 1 << CHUNK_BITS;
+        static uint32 const CHUNK_MASK = CHUNK_SIZE - 1;
+        static uint32 const MAX_CHUNKS = 1024;
+
+        // chunks never move, readers index them while new texts are added
+        std::unique_ptr<std::string[]> m_chunks[MAX_CHUNKS];
+        uint32 m_count;
+
+        std::mutex m_lock;
+        std::unordered_map<std::string_view, uint32> m_index; // views into m_chunks
+};
+
+#define sLocalizedStrings MaNGOS::Singleton<LocalizedStringArena>::Instance()
+
+// Texts of one field by storage locale index (see ObjectMgr::GetStorageLocaleIndexFor), reads like std::vector<std::string>
+class LocalizedString
+{
+    public:
+        size_t size() const { return m_offsets.size(); }
+        bool empty() const { return m_offsets.empty(); }
+        std::string const& operator[](size_t idx) const { return sLocalizedStrings.Get(m_offsets[idx]); }
+
+        void Set(size_t idx, std::string const& str)
+        {
+            if (m_offsets.size() <= idx)
+                m_offsets.resize(idx + 1, 0);
+            m_offsets[idx] = sLocalizedStrings.Intern(str);
+        }
+
+    private:
+        std::vector<uint32> m_offsets;
+};
+
+#endif
@@ -28,6 +28,9 @@
 #include "Grids/GridNotifiersImpl.h"
 #include "Entities/ObjectGuid.h"
 #include "World/World.h"
+#include "Social/WhoListIndex.h"
+
+#include <utf8.h>
 
 #include <mutex>
 
@@ -38,31 +41,28 @@ INSTANTIATE_CLASS_MUTEX(ObjectAccessor, std::mutex);
 template<class T>
 void HashMapHolder<T>::Insert(T* o)
 {
-    WriteGuard guard(i_lock);
-    m_objectMap[o->GetObjectGuid()] = o;
+    Shard& shard = GetShard(o->GetObjectGuid());
+    WriteGuard guard(shard.lock);
+    shard.objects[o->GetObjectGuid()] = o;
 }
 
 template<class T>
 void HashMapHolder<T>::Remove(T* o)
 {
-    WriteGuard guard(i_lock);
-    m_objectMap.erase(o->GetObjectGuid());
+    Shard& shard = GetShard(o->GetObjectGuid());
+    WriteGuard guard(shard.lock);
+    shard.objects.erase(o->GetObjectGuid());
 }
 
 template<class T>
 T* HashMapHolder<T>::Find(ObjectGuid guid)
 {
-    ReadGuard guard(i_lock);
-    typename MapType::iterator itr = m_objectMap.find(guid);
-    return (itr != m_objectMap.end()) ? itr->second : nullptr;
+    Shard& shard = GetShard(guid);
+    ReadGuard guard(shard.lock);
+    typename MapType::const_iterator itr = shard.objects.find(guid);
+    return (itr != shard.objects.end()) ? itr->second : nullptr;
 }
 
-template<class T>
-typename HashMapHolder<T>::MapType& HashMapHolder<T>::GetContainer() { return m_objectMap; }
-
-template<class T>
-typename HashMapHolder<T>::LockType& HashMapHolder<T>::GetLock() { return i_lock; }
-
 ObjectAccessor::ObjectAccessor() {}
 ObjectAccessor::~ObjectAccessor()
 {
@@ -108,6 +108,7 @@ Player* ObjectAccessor::FindPlayer(ObjectGuid guid, bool inWorld /*= true*/)
     if (!plr || (!plr->IsInWorld() && inWorld))
         return nullptr;
 
+    MapAccessScope::Validate(plr, "ObjectAccessor::FindPlayer");
     return plr;
 }
 
@@ -117,32 +118,28 @@ Player* ObjectAccessor::FindPlayerByName(char const* name, bool inWorld /*=true*
     if (!player || (inWorld && !player->IsInWorld()))
         return nullptr;
 
+    MapAccessScope::Validate(player, "ObjectAccessor::FindPlayerByName");
     return player;
 }
 
 void ObjectAccessor::SaveAllPlayers() const
 {
-    HashMapHolder<Player>::ReadGuard g(HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (auto& itr : m)
+    HashMapHolder<Player>::DoForAllObjects([](Player* plr)
     {
-        if (itr.second->IsInWorld())
-            itr.second->GetMap()->GetMessager().AddMessage([guid = itr.second->GetObjectGuid()](Map* map)
+        if (plr->IsInWorld())
+            plr->GetMap()->GetMessager().AddMessage([guid = plr->GetObjectGuid()](Map* map)
             {
                 if (Player* player = map->GetPlayer(guid))
                     player->SaveToDB();
             });
         else
-            itr.second->SaveToDB();
-    }
+            plr->SaveToDB();
+    });
 }
 
 void ObjectAccessor::ExecuteOnAllPlayers(std::function<void(Player*)> executor)
 {
-    HashMapHolder<Player>::ReadGuard g(HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        executor(itr->second);
+    HashMapHolder<Player>::DoForAllObjects(executor);
 }
 
 void ObjectAccessor::KickPlayer(ObjectGuid guid)
@@ -196,6 +193,7 @@ ObjectAccessor::AddCorpse(Corpse* corpse)
     Guard guard(i_corpseGuard);
     MANGOS_ASSERT(i_player2corpse.find(corpse->GetOwnerGuid()) == i_player2corpse.end());
     i_player2corpse[corpse->GetOwnerGuid()] = corpse;
+    i_corpseExpiry.emplace(corpse->GetExpiryTime(), corpse->GetOwnerGuid());
 
     // build mapid*cellid -> guid_set map
     CellPair cell_pair = MaNGOS::ComputeCellPair(corpse->GetPositionX(), corpse->GetPositionY());
@@ -295,61 +293,158 @@ ObjectAccessor::ConvertCorpseForPlayer(ObjectGuid player_guid, bool insignia)
 void ObjectAccessor::RemoveOldCorpses()
 {
     time_t now = time(nullptr);
-    Player2CorpsesMapType::iterator next;
-    for (Player2CorpsesMapType::iterator itr = i_player2corpse.begin(); itr != i_player2corpse.end(); itr = next)
+    std::vector<ObjectGuid> expired;
     {
-        next = itr;
-        ++next;
+        Guard guard(i_corpseGuard);
+        while (!i_corpseExpiry.empty() && i_corpseExpiry.top().first < now)
+        {
+            ObjectGuid ownerGuid = i_corpseExpiry.top().second;
+            i_corpseExpiry.pop();
 
-        if (!itr->second->IsExpired(now))
-            continue;
+            Player2CorpsesMapType::const_iterator itr = i_player2corpse.find(ownerGuid);
+            if (itr == i_player2corpse.end())
+                continue;                                   // already converted or reclaimed
 
-        ConvertCorpseForPlayer(itr->first);
+            if (itr->second->IsExpired(now))
+                expired.push_back(ownerGuid);
+            else                                            // ghost time reset or a newer corpse
+                i_corpseExpiry.emplace(itr->second->GetExpiryTime(), ownerGuid);
+        }
     }
+
+    for (ObjectGuid const& ownerGuid : expired)
+        ConvertCorpseForPlayer(ownerGuid);
 }
 
 void ObjectAccessor::AddObject(Player* player)
 {
     HashMapHolder<Player>::Insert(player);
     PlayerNameMapHolder::Insert(player);
+    WhoListIndex::Insert(player);
 }
 
 void ObjectAccessor::RemoveObject(Player* player)
 {
     HashMapHolder<Player>::Remove(player);
     PlayerNameMapHolder::Remove(player);
+    WhoListIndex::Remove(player);
 }
 
 /// Define the static member of HashMapHolder
 
-template <class T> typename HashMapHolder<T>::MapType HashMapHolder<T>::m_objectMap;
-template <class T> std::mutex HashMapHolder<T>::i_lock;
+template <class T> typename HashMapHolder<T>::Shard HashMapHolder<T>::m_shards[HashMapHolder<T>::SHARD_COUNT];
 
 /// Global definitions for the hashmap storage
 
 template class HashMapHolder<Player>;
 template class HashMapHolder<Corpse>;
 
+namespace
+{
+    // MAX_INTERNAL_PLAYER_NAME characters of up to 3 utf8 bytes each (BMP only)
+    size_t const FOLDED_NAME_BUFFER = MAX_INTERNAL_PLAYER_NAME * 3;
+
+    // lowercases the utf8 name into buffer, fails for invalid utf8 or too long names
+    bool FoldPlayerName(std::string_view name, char* buffer, size_t& length)
+    {
+        length = 0;
+        try
+        {
+            char const* itr = name.data();
+            char const* end = name.data() + name.size();
+            for (size_t chars = 0; itr != end; ++chars)
+            {
+                uint32 const codepoint = utf8::next(itr, end);
+                if (chars >= MAX_INTERNAL_PLAYER_NAME || codepoint > 0xFFFF)
+                    return false;
+
+                char encoded[4];
+                char* encodedEnd = utf8::append(uint32(wcharToLower(wchar_t(codepoint))), encoded);
+                for (char* c = encoded; c != encodedEnd; ++c)
+                    buffer[length++] = *c;
+            }
+        }
+        catch (std::exception const&)
+        {
+            return false;
+        }
+        return true;
+    }
+
+    // FNV-1a
+    uint32 HashFoldedName(std::string_view folded)
+    {
+        uint32 hash = 2166136261u;
+        for (char c : folded)
+            hash = (hash ^ uint8(c)) * 16777619u;
+        return hash;
+    }
+}
+
 void PlayerNameMapHolder::Insert(Player* p)
 {
-    m_objectMap[p->GetNameStr()] = p;
+    char buffer[FOLDED_NAME_BUFFER];
+    size_t length;
+    if (!FoldPlayerName(p->GetNameStr(), buffer, length))
+        return;
+
+    std::string_view const folded(buffer, length);
+    std::unique_lock<std::shared_mutex> guard(m_lock);
+    auto itr = m_objectMap.find(folded);
+    if (itr != m_objectMap.end())
+    {
+        itr->second = p;
+        return;
+    }
+
+    itr = m_objectMap.emplace(std::string(folded), p).first;
+    m_hashIndex.emplace(HashFoldedName(folded), itr);
 }
 
 void PlayerNameMapHolder::Remove(Player* p)
 {
-    m_objectMap.erase(p->GetNameStr());
+    char buffer[FOLDED_NAME_BUFFER];
+    size_t length;
+    if (!FoldPlayerName(p->GetNameStr(), buffer, length))
+        return;
+
+    std::string_view const folded(buffer, length);
+    std::unique_lock<std::shared_mutex> guard(m_lock);
+    auto range = m_hashIndex.equal_range(HashFoldedName(folded));
+    for (auto itr = range.first; itr != range.second; ++itr)
+    {
+        if (itr->second->first != folded)
+            continue;
+
+        // a newer player with the same name may already have replaced this one
+        if (itr->second->second == p)
+        {
+            m_objectMap.erase(itr->second);
+            m_hashIndex.erase(itr);
+        }
+        return;
+    }
 }
 
-Player* PlayerNameMapHolder::Find(std::string const& name)
+Player* PlayerNameMapHolder::Find(std::string_view name)
 {
-    std::string charName(name);
-    if (!normalizePlayerName(charName))
+    char buffer[FOLDED_NAME_BUFFER];
+    size_t length;
+    if (name.empty() || !FoldPlayerName(name, buffer, length))
         return nullptr;
 
-    MapType::iterator itr = m_objectMap.find(charName);
-    return (itr != m_objectMap.end()) ? itr->second : nullptr;
+    std::string_view const folded(buffer, length);
+    std::shared_lock<std::shared_mutex> guard(m_lock);
+    auto range = m_hashIndex.equal_range(HashFoldedName(folded));
+    for (auto itr = range.first; itr != range.second; ++itr)
+        if (itr->second->first == folded)
+            return itr->second->second;
+
+    return nullptr;
 }
 
 /// Define the static member of PlayerNameMapHolder
 
+std::shared_mutex PlayerNameMapHolder::m_lock;
 PlayerNameMapHolder::MapType PlayerNameMapHolder::m_objectMap;
+PlayerNameMapHolder::HashType PlayerNameMapHolder::m_hashIndex;
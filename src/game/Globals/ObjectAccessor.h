@@ -32,21 +32,27 @@
 #include "Entities/Corpse.h"
 
 #include <functional>
+#include <map>
 #include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <string_view>
 
 class Unit;
 class WorldObject;
 class Map;
 
+// Objects are spread over shards by guid counter, each with its own reader/writer lock,
+// so lookups from different map threads neither serialize on one mutex nor block each other.
 template <class T>
 class HashMapHolder
 {
     public:
 
         typedef std::unordered_map<ObjectGuid, T*>   MapType;
-        typedef std::mutex LockType;
-        typedef std::lock_guard<std::mutex> ReadGuard;
-        typedef std::lock_guard<std::mutex> WriteGuard;
+        typedef std::shared_mutex LockType;
+        typedef std::shared_lock<std::shared_mutex> ReadGuard;
+        typedef std::unique_lock<std::shared_mutex> WriteGuard;
 
         static void Insert(T* o);
 
@@ -54,34 +60,56 @@ class HashMapHolder
 
         static T* Find(ObjectGuid guid);
 
-        static MapType& GetContainer();
-
-        static LockType& GetLock();
+        // executor must not insert or remove objects, the visited shard stays read locked meanwhile
+        template <typename F>
+        static void DoForAllObjects(F&& executor)
+        {
+            for (Shard& shard : m_shards)
+            {
+                ReadGuard guard(shard.lock);
+                for (auto& itr : shard.objects)
+                    executor(itr.second);
+            }
+        }
 
     private:
 
         // Non instanceable only static
         HashMapHolder() {}
 
-        static LockType i_lock;
-        static MapType  m_objectMap;
+        static uint32 const SHARD_COUNT = 16;               // power of two
+
+        struct alignas(64) Shard
+        {
+            LockType lock;
+            MapType  objects;
+        };
+
+        static Shard& GetShard(ObjectGuid guid) { return m_shards[guid.GetCounter() & (SHARD_COUNT - 1)]; }
+
+        static Shard m_shards[SHARD_COUNT];
 };
 
+// Players indexed by case folded name. Lookups fold the queried name into a stack
+// buffer and hash it, so they do not allocate.
 class PlayerNameMapHolder
 {
     public:
-        typedef std::unordered_map<std::string, Player*> MapType;
+        typedef std::map<std::string, Player*, std::less<>> MapType;      // iterators stay valid for the hash index
+        typedef std::unordered_multimap<uint32, MapType::iterator> HashType;
 
         static void Insert(Player* p);
         static void Remove(Player* p);
-        static Player* Find(std::string const& name);
+        static Player* Find(std::string_view name);
 
     private:
 
         // Non instanceable only static
         PlayerNameMapHolder() {}
 
+        static std::shared_mutex m_lock;
         static MapType m_objectMap;
+        static HashType m_hashIndex;
 };
 
 class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLevelLockable<ObjectAccessor, std::mutex> >
@@ -105,11 +133,6 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
         static Player* FindPlayerByName(char const* name, bool inWorld = true);
         static void KickPlayer(ObjectGuid guid);
 
-        HashMapHolder<Player>::MapType& GetPlayers() const
-        {
-            return HashMapHolder<Player>::GetContainer();
-        }
-
         void SaveAllPlayers() const;
         void ExecuteOnAllPlayers(std::function<void(Player*)> executor);
 
@@ -132,6 +155,11 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
 
         Player2CorpsesMapType   i_player2corpse;
 
+        // (expiry time, owner) of corpses, earliest first - checked against the current corpse when due,
+        // so entries of removed corpses or corpses with a reset ghost time are dropped or pushed back then
+        typedef std::pair<time_t, ObjectGuid> CorpseExpiry;
+        std::priority_queue<CorpseExpiry, std::vector<CorpseExpiry>, std::greater<CorpseExpiry>> i_corpseExpiry;
+
         typedef std::mutex LockType;
         typedef MaNGOS::GeneralLock<LockType > Guard;
 
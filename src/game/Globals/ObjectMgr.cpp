@@ -49,8 +49,10 @@
 #include "World/WorldState.h"
 
 #include <limits>
+#include <tuple>
 #include "Entities/ItemEnchantmentMgr.h"
 #include "Loot/LootMgr.h"
+#include "Multithreading/TaskGraph.h"
 
 INSTANTIATE_SINGLETON_1(ObjectMgr);
 
@@ -226,11 +228,41 @@ ArenaTeam* ObjectMgr::GetArenaTeamByCaptain(ObjectGuid guid) const
     return nullptr;
 }
 
+// replaces the columns <name>_loc<N> of inactive locales (Locales.Active) by NULL, field indexes stay the same
+static std::string SelectActiveLocaleColumns(std::string query)
+{
+    std::string::size_type pos = 0;
+    while ((pos = query.find("_loc", pos)) != std::string::npos)
+    {
+        std::string::size_type const digit = pos + 4;
+        if (digit >= query.size() || !isdigit(query[digit]) || (digit + 1 < query.size() && (isalnum(query[digit + 1]) || query[digit + 1] == '_')))
+        {
+            pos = digit;
+            continue;
+        }
+
+        uint32 const locale = query[digit] - '0';
+        if (locale >= MAX_LOCALE || sWorld.IsActiveLocale(LocaleConstant(locale)))
+        {
+            pos = digit;
+            continue;
+        }
+
+        std::string::size_type start = pos;
+        while (start > 0 && (isalnum(query[start - 1]) || query[start - 1] == '_'))
+            --start;
+
+        query.replace(start, digit + 1 - start, "NULL");
+        pos = start + 4;
+    }
+    return query;
+}
+
 void ObjectMgr::LoadCreatureLocales()
 {
     mCreatureLocaleMap.clear();                             // need for reload case
 
-    QueryResult* result = WorldDatabase.Query("SELECT entry,name_loc1,subname_loc1,name_loc2,subname_loc2,name_loc3,subname_loc3,name_loc4,subname_loc4,name_loc5,subname_loc5,name_loc6,subname_loc6,name_loc7,subname_loc7,name_loc8,subname_loc8 FROM locales_creature");
+    QueryResult* result = WorldDatabase.Query(SelectActiveLocaleColumns("SELECT entry,name_loc1,subname_loc1,name_loc2,subname_loc2,name_loc3,subname_loc3,name_loc4,subname_loc4,name_loc5,subname_loc5,name_loc6,subname_loc6,name_loc7,subname_loc7,name_loc8,subname_loc8 FROM locales_creature").c_str());
 
     if (!result)
     {
@@ -265,10 +297,7 @@ void ObjectMgr::LoadCreatureLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.Name.size() <= idx)
-                        data.Name.resize(idx + 1);
-
-                    data.Name[idx] = str;
+                    data.Name.Set(idx, str);
                 }
             }
             str = fields[1 + 2 * (i - 1) + 1].GetCppString();
@@ -277,10 +306,7 @@ void ObjectMgr::LoadCreatureLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.SubName.size() <= idx)
-                        data.SubName.resize(idx + 1);
-
-                    data.SubName[idx] = str;
+                    data.SubName.Set(idx, str);
                 }
             }
         }
@@ -1981,11 +2007,136 @@ void ObjectMgr::LoadCreatureSpawnEntry()
     sLog.outString();
 }
 
+namespace
+{
+    enum SpawnRowState
+    {
+        SPAWN_ROW_SKIPPED,                                  // rejected before its data is stored
+        SPAWN_ROW_STORED,                                   // data is stored, but not spawned
+        SPAWN_ROW_VALID,
+    };
+
+    struct CreatureSpawnRow
+    {
+        CreatureSpawnRow() : guid(0), spawnDataEntry(0), cInfo(nullptr), state(SPAWN_ROW_SKIPPED), isConditional(false) {}
+
+        uint32 guid;
+        uint32 spawnDataEntry;
+        CreatureData data;
+        CreatureInfo const* cInfo;
+        SpawnRowState state;
+        bool isConditional;
+    };
+
+    struct GameObjectSpawnRow
+    {
+        GameObjectSpawnRow() : guid(0), goState(0), gInfo(nullptr), state(SPAWN_ROW_SKIPPED) {}
+
+        uint32 guid;
+        uint32 goState;
+        GameObjectData data;
+        GameObjectInfo const* gInfo;
+        SpawnRowState state;
+    };
+
+    // one (map, spawn mode) cell a static spawn is listed in
+    struct SpawnCellEntry
+    {
+        uint32 mapKey;
+        uint32 cellId;
+        uint32 guid;
+
+        bool operator<(SpawnCellEntry const& other) const
+        {
+            return std::tie(mapKey, cellId, guid) < std::tie(other.mapKey, other.cellId, other.guid);
+        }
+        bool operator==(SpawnCellEntry const& other) const
+        {
+            return mapKey == other.mapKey && cellId == other.cellId && guid == other.guid;
+        }
+    };
+
+    uint32 GetSpawnMask(std::map<uint32, uint32> const& spawnMasks, uint32 mapId)
+    {
+        auto itr = spawnMasks.find(mapId);
+        return itr != spawnMasks.end() ? itr->second : 0;
+    }
+
+    void CollectSpawnCells(std::vector<SpawnCellEntry>& entries, uint32 guid, uint32 mapId, uint8 spawnMask, float x, float y)
+    {
+        CellPair cell_pair = MaNGOS::ComputeCellPair(x, y);
+        uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
+
+        for (uint8 i = 0; spawnMask != 0; ++i, spawnMask >>= 1)
+            if (spawnMask & 1)
+                entries.push_back({ MAKE_PAIR32(mapId, i), cell_id, guid });
+    }
+
+    // sorts the collected entries once and hands every cell its guids as one sorted array
+    void BuildCellIndex(MapObjectGuids& index, std::vector<SpawnCellEntry>& entries, CellGuidSet CellObjectGuids::* member)
+    {
+        std::sort(entries.begin(), entries.end());
+        entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+        for (size_t first = 0; first < entries.size();)
+        {
+            size_t last = first + 1;
+            while (last < entries.size() && entries[last].mapKey == entries[first].mapKey && entries[last].cellId == entries[first].cellId)
+                ++last;
+
+            CellGuidSet& guids = index[entries[first].mapKey][entries[first].cellId].*member;
+            if (guids.empty())
+            {
+                std::vector<uint32> sorted;
+                sorted.reserve(last - first);
+                for (size_t i = first; i < last; ++i)
+                    sorted.push_back(entries[i].guid);
+                guids.assign_sorted(std::move(sorted));
+            }
+            else
+            {
+                for (size_t i = first; i < last; ++i)
+                    guids.insert(entries[i].guid);
+            }
+
+            first = last;
+        }
+    }
+
+    // calls validate for every row, split in even chunks over the configured load threads;
+    // validate may only read shared data and log, anything else is done afterwards in row order
+    template<class Row, class Validate>
+    void RunSpawnRowValidation(std::vector<Row>& rows, char const* name, Validate const& validate)
+    {
+        uint32 const threads = sWorld.getConfig(CONFIG_UINT32_NUM_LOAD_THREADS);
+        if (threads <= 1 || rows.size() < threads)
+        {
+            for (Row& row : rows)
+                validate(row);
+            return;
+        }
+
+        TaskGraph validateGraph;
+        size_t const chunkSize = (rows.size() + threads - 1) / threads;
+        for (size_t first = 0; first < rows.size(); first += chunkSize)
+        {
+            size_t const last = std::min(rows.size(), first + chunkSize);
+            std::string const taskName = std::string(name) + " " + std::to_string(first / chunkSize + 1) + "/" + std::to_string(threads);
+            validateGraph.AddTask(taskName.c_str(), [&rows, &validate, first, last]()
+            {
+                for (size_t i = first; i < last; ++i)
+                    validate(rows[i]);
+            });
+        }
+        validateGraph.Run(threads);
+    }
+}
+
 void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
     //                                                0                       1   2    3
-    QueryResult* result = WorldDatabase.Query("SELECT creature.guid, creature.id, map, modelid,"
+    QueryResult* result = WorldDatabase.QueryStreamed("SELECT creature.guid, creature.id, map, modelid,"
                           //   4             5           6           7           8            9             10                   11           12
                           "equipment_id, position_x, position_y, position_z, orientation, spawntimesecsmin, spawntimesecsmax, spawndist, currentwaypoint,"
                           //   13         14       15          16            17         18         19
@@ -2025,18 +2176,58 @@ void ObjectMgr::LoadCreatures()
                 if (GetMapDifficultyData(i, Difficulty(k)))
                     spawnMasks[i] |= (1 << k);
 
-    BarGoLink bar(result->GetRowCount());
+    // streamed results do not know their size up front
+    std::unique_ptr<QueryResult> countResult(WorldDatabase.Query("SELECT COUNT(*) FROM creature"));
+    uint64 const rowCount = countResult ? countResult->Fetch()[0].GetUInt64() : 0;
+    BarGoLink bar(rowCount);
 
+    // rows are read serially from the stream, validated in parallel and only then stored in row order
+    std::vector<CreatureSpawnRow> rows;
+    rows.reserve(rowCount);
     do
     {
         Field* fields = result->Fetch();
         bar.step();
 
-        uint32 guid         = fields[ 0].GetUInt32();
-        uint32 entry        = fields[ 1].GetUInt32();
+        rows.emplace_back();
+        CreatureSpawnRow& row = rows.back();
+        CreatureData& data = row.data;
+
+        row.guid                = fields[ 0].GetUInt32();
+        data.id                 = fields[ 1].GetUInt32();
+        data.mapid              = fields[ 2].GetUInt32();
+        data.modelid_override   = fields[ 3].GetUInt32();
+        data.equipmentId        = fields[ 4].GetUInt32();
+        data.posX               = fields[ 5].GetFloat();
+        data.posY               = fields[ 6].GetFloat();
+        data.posZ               = fields[ 7].GetFloat();
+        data.orientation        = fields[ 8].GetFloat();
+        data.spawntimesecsmin   = fields[ 9].GetUInt32();
+        data.spawntimesecsmax   = fields[10].GetUInt32();
+        data.spawndist          = fields[11].GetFloat();
+        data.currentwaypoint    = fields[12].GetUInt32();
+        data.curhealth          = fields[13].GetUInt32();
+        data.curmana            = fields[14].GetUInt32();
+        data.is_dead            = fields[15].GetBool();
+        data.movementType       = fields[16].GetUInt8();
+        data.spawnMask          = fields[17].GetUInt8();
+        data.phaseMask          = fields[18].GetUInt16();
+        data.gameEvent          = fields[19].GetInt16();
+        data.GuidPoolId         = fields[20].GetInt16();
+        data.EntryPoolId        = fields[21].GetInt16();
+        row.spawnDataEntry      = fields[22].GetUInt32();
+    }
+    while (result->NextRow());
+
+    delete result;
+
+    RunSpawnRowValidation(rows, "Creature spawns", [&](CreatureSpawnRow& row)
+    {
+        uint32 const guid       = row.guid;
+        CreatureData& data      = row.data;
+        uint32 entry            = data.id;
 
         // validate creature dual spawn template
-        bool isConditional  = false;
         if (entry == 0)
         {
             CreatureConditionalSpawn const* cSpawn = GetCreatureConditionalSpawn(guid);
@@ -2047,60 +2238,39 @@ void ObjectMgr::LoadCreatures()
             }
             else
             {
-                isConditional = true;
+                row.isConditional = true;
                 // set a default entry to validate the record; will be reset back to 0 afterwards
                 entry = cSpawn->EntryAlliance != 0 ? cSpawn->EntryAlliance : cSpawn->EntryHorde;
             }
         }
 
-        CreatureInfo const* cInfo = nullptr;
         if (entry)
         {
-            cInfo = GetCreatureTemplate(entry);
-            if (!cInfo)
+            row.cInfo = GetCreatureTemplate(entry);
+            if (!row.cInfo)
             {
                 sLog.outErrorDb("Table `creature` has creature (GUID: %u) with non existing creature entry %u, skipped.", guid, entry);
-                continue;
+                return;
             }
         }
 
-        CreatureData& data = mCreatureDataMap[guid];
+        // from here on rejected rows still replace the stored data, but are not spawned
+        row.state = SPAWN_ROW_STORED;
 
-        data.id                 = entry;
-        data.mapid              = fields[ 2].GetUInt32();
-        data.modelid_override   = fields[ 3].GetUInt32();
-        data.equipmentId        = fields[ 4].GetUInt32();
-        data.posX               = fields[ 5].GetFloat();
-        data.posY               = fields[ 6].GetFloat();
-        data.posZ               = fields[ 7].GetFloat();
-        data.orientation        = fields[ 8].GetFloat();
-        data.spawntimesecsmin   = fields[ 9].GetUInt32();
-        data.spawntimesecsmax   = fields[10].GetUInt32();
-        data.spawndist          = fields[11].GetFloat();
-        data.currentwaypoint    = fields[12].GetUInt32();
-        data.curhealth          = fields[13].GetUInt32();
-        data.curmana            = fields[14].GetUInt32();
-        data.is_dead            = fields[15].GetBool();
-        data.movementType       = fields[16].GetUInt8();
-        data.spawnMask          = fields[17].GetUInt8();
-        data.phaseMask          = fields[18].GetUInt16();
-        data.gameEvent          = fields[19].GetInt16();
-        data.GuidPoolId         = fields[20].GetInt16();
-        data.EntryPoolId        = fields[21].GetInt16();
+        data.id = entry;
         data.spawnTemplate = GetCreatureSpawnTemplate(0);
-        uint32 spawnDataEntry   = fields[22].GetUInt32();
 
         MapEntry const* mapEntry = sMapStore.LookupEntry(data.mapid);
         if (!mapEntry)
         {
             sLog.outErrorDb("Table `creature` have creature (GUID: %u) that spawned at nonexistent map (Id: %u), skipped.", guid, data.mapid);
-            continue;
+            return;
         }
 
         if (!MaNGOS::IsValidMapCoord(data.posX, data.posY, data.posZ))
         {
             sLog.outErrorDb("Table `creature` have creature (GUID: %u) that spawned at not valid coordinate (x:%5.2f, y:%5.2f, z:%5.2f) skipped.", guid, data.posX, data.posY, data.posZ);
-            continue;
+            return;
         }
 
         if (data.spawntimesecsmax < data.spawntimesecsmin)
@@ -2110,21 +2280,18 @@ void ObjectMgr::LoadCreatures()
             data.spawntimesecsmax = data.spawntimesecsmin;
         }
 
-        if (m_transportMaps.find(data.mapid) == m_transportMaps.end() && data.spawnMask & ~spawnMasks[data.mapid])
+        if (m_transportMaps.find(data.mapid) == m_transportMaps.end() && data.spawnMask & ~GetSpawnMask(spawnMasks, data.mapid))
             sLog.outErrorDb("Table `creature` have creature (GUID: %u) that have wrong spawn mask %u including not supported difficulty modes for map (Id: %u).", guid, data.spawnMask, data.mapid);
 
-        bool ok = true;
-        for (uint32 diff = 0; diff < MAX_DIFFICULTY - 1 && ok; ++diff)
+        for (uint32 diff = 0; diff < MAX_DIFFICULTY - 1; ++diff)
         {
             if (difficultyCreatures[diff].find(data.id) != difficultyCreatures[diff].end())
             {
                 sLog.outErrorDb("Table `creature` have creature (GUID: %u) that listed as difficulty %u template (entry: %u) in `creature_template`, skipped.",
                                 guid, diff + 1, data.id);
-                ok = false;
+                return;
             }
         }
-        if (!ok)
-            continue;
 
         if (data.modelid_override > 0 && !sCreatureDisplayInfoStore.LookupEntry(data.modelid_override))
         {
@@ -2139,7 +2306,7 @@ void ObjectMgr::LoadCreatures()
                 sLog.outErrorDb("Table `creature` have creature (Entry: %u) with equipment_id %u not found in table `creature_equip_template`, set to no equipment.", data.id, data.equipmentId);
                 data.equipmentId = -1;
             }
-            if (cInfo && data.equipmentId == cInfo->EquipmentTemplateId)
+            if (row.cInfo && data.equipmentId == row.cInfo->EquipmentTemplateId)
             {
                 sLog.outErrorDb("Table `creature` has creature (GUID: %u, Entry: %u) with equipment_id %u already defined in creature_template table", guid, data.id, data.equipmentId); 
                 data.equipmentId = 0;
@@ -2174,12 +2341,12 @@ void ObjectMgr::LoadCreatures()
             data.phaseMask = 1;
         }
 
-        if (spawnDataEntry > 0)
+        if (row.spawnDataEntry > 0)
         {
-            if (CreatureSpawnTemplate const* templateData = GetCreatureSpawnTemplate(spawnDataEntry))
+            if (CreatureSpawnTemplate const* templateData = GetCreatureSpawnTemplate(row.spawnDataEntry))
                 data.spawnTemplate = templateData;
             else
-                sLog.outErrorDb("Table `creature` have creature (GUID: %u Entry: %u) with spawn template %u that doesnt exist.", guid, data.id, spawnDataEntry);
+                sLog.outErrorDb("Table `creature` have creature (GUID: %u Entry: %u) with spawn template %u that doesnt exist.", guid, data.id, row.spawnDataEntry);
         }
 
         if (mapEntry->IsContinent())
@@ -2190,25 +2357,39 @@ void ObjectMgr::LoadCreatures()
         else
             data.OriginalZoneId = 0;
 
+        row.state = SPAWN_ROW_VALID;
+    });
+
+    std::vector<SpawnCellEntry> cellEntries;
+    cellEntries.reserve(rows.size());
+    for (CreatureSpawnRow& row : rows)
+    {
+        if (row.state == SPAWN_ROW_SKIPPED)
+            continue;
+
+        CreatureData& data = mCreatureDataMap[row.guid];
+        data = row.data;
+        if (row.state != SPAWN_ROW_VALID)
+            continue;
+
         if (m_transportMaps.find(data.mapid) != m_transportMaps.end())
-            m_guidsForMap[data.mapid].emplace_back(TYPEID_UNIT, guid);
+            m_guidsForMap[data.mapid].emplace_back(TYPEID_UNIT, row.guid);
         else if (data.IsNotPartOfPoolOrEvent()) // if not this is to be managed by GameEvent System or Pool system
         {
-            AddCreatureToGrid(guid, &data);
+            CollectSpawnCells(cellEntries, row.guid, data.mapid, data.spawnMask, data.posX, data.posY);
 
-            if (sWorld.getConfig(CONFIG_BOOL_AUTOLOAD_ACTIVE) && cInfo && cInfo->ExtraFlags & CREATURE_EXTRA_FLAG_ACTIVE)
-                m_activeCreatures.emplace(data.mapid, guid);
+            if (sWorld.getConfig(CONFIG_BOOL_AUTOLOAD_ACTIVE) && row.cInfo && row.cInfo->ExtraFlags & CREATURE_EXTRA_FLAG_ACTIVE)
+                m_activeCreatures.emplace(data.mapid, row.guid);
         }
 
         // reset the entry to 0; this will be processed by Creature::GetCreatureConditionalSpawnEntry
-        if (isConditional)
+        if (row.isConditional)
             data.id = 0;
 
         ++count;
     }
-    while (result->NextRow());
 
-    delete result;
+    BuildCellIndex(mMapObjectGuids, cellEntries, &CellObjectGuids::creatures);
 
     sLog.outString(">> Loaded " SIZEFMTD " creatures", mCreatureDataMap.size());
     sLog.outString();
@@ -2251,7 +2432,7 @@ void ObjectMgr::LoadGameObjects()
     uint32 count = 0;
 
     //                                                0                           1   2    3                      4                      5                      6
-    QueryResult* result = WorldDatabase.Query("SELECT gameobject.guid, gameobject.id, map, round(position_x, 20), round(position_y, 20), round(position_z, 20), round(orientation, 20),"
+    QueryResult* result = WorldDatabase.QueryStreamed("SELECT gameobject.guid, gameobject.id, map, round(position_x, 20), round(position_y, 20), round(position_z, 20), round(orientation, 20),"
                           // 7                   8                     9                     10                    11                12                13            14     15         16         17
                           "round(rotation0, 20), round(rotation1, 20), round(rotation2, 20), round(rotation3, 20), spawntimesecsmin, spawntimesecsmax, animprogress, state, spawnMask, phaseMask, event,"
                           //   18                          19
@@ -2278,90 +2459,109 @@ void ObjectMgr::LoadGameObjects()
                 if (GetMapDifficultyData(i, Difficulty(k)))
                     spawnMasks[i] |= (1 << k);
 
-    BarGoLink bar(result->GetRowCount());
+    // streamed results do not know their size up front
+    std::unique_ptr<QueryResult> countResult(WorldDatabase.Query("SELECT COUNT(*) FROM gameobject"));
+    uint64 const rowCount = countResult ? countResult->Fetch()[0].GetUInt64() : 0;
+    BarGoLink bar(rowCount);
 
+    // rows are read serially from the stream, validated in parallel and only then stored in row order
+    std::vector<GameObjectSpawnRow> rows;
+    rows.reserve(rowCount);
     do
     {
         Field* fields = result->Fetch();
         bar.step();
 
-        uint32 guid         = fields[ 0].GetUInt32();
-        uint32 entry        = fields[ 1].GetUInt32();
+        rows.emplace_back();
+        GameObjectSpawnRow& row = rows.back();
+        GameObjectData& data = row.data;
+
+        row.guid              = fields[ 0].GetUInt32();
+        data.id               = fields[ 1].GetUInt32();
+        data.mapid            = fields[ 2].GetUInt32();
+        data.posX             = fields[ 3].GetFloat();
+        data.posY             = fields[ 4].GetFloat();
+        data.posZ             = fields[ 5].GetFloat();
+        data.orientation      = fields[ 6].GetFloat();
+        data.rotation.x       = fields[ 7].GetFloat();
+        data.rotation.y       = fields[ 8].GetFloat();
+        data.rotation.z       = fields[ 9].GetFloat();
+        data.rotation.w       = fields[10].GetFloat();
+        data.spawntimesecsmin = fields[11].GetInt32();
+        data.spawntimesecsmax = fields[12].GetInt32();
+        data.animprogress     = fields[13].GetUInt32();
+        row.goState           = fields[14].GetUInt32();
+        data.spawnMask        = fields[15].GetUInt8();
+        data.phaseMask        = fields[16].GetUInt16();
+        data.gameEvent        = fields[17].GetInt16();
+        data.GuidPoolId       = fields[18].GetInt16();
+        data.EntryPoolId      = fields[19].GetInt16();
+    }
+    while (result->NextRow());
+
+    delete result;
+
+    RunSpawnRowValidation(rows, "GameObject spawns", [&](GameObjectSpawnRow& row)
+    {
+        uint32 const guid     = row.guid;
+        GameObjectData& data  = row.data;
+        uint32 entry          = data.id;
 
         if (entry == 0)
             if (uint32 randomEntry = GetRandomGameObjectEntry(guid))
                 entry = randomEntry;
 
-        GameObjectInfo const* gInfo = nullptr;
         if (entry)
         {
-            gInfo = GetGameObjectInfo(entry);
-            if (!gInfo)
+            row.gInfo = GetGameObjectInfo(entry);
+            if (!row.gInfo)
             {
                 sLog.outErrorDb("Table `gameobject` has gameobject (GUID: %u) with non existing gameobject entry %u, skipped.", guid, entry);
-                continue;
+                return;
             }
 
-            if (!gInfo->displayId)
+            if (!row.gInfo->displayId)
             {
-                switch (gInfo->type)
+                switch (row.gInfo->type)
                 {
                     // can be invisible always and then not req. display id in like case
                     case GAMEOBJECT_TYPE_TRAP:
                     case GAMEOBJECT_TYPE_SPELL_FOCUS:
                         break;
                     default:
-                        sLog.outErrorDb("Gameobject (GUID: %u Entry %u GoType: %u) have displayId == 0 and then will always invisible in game.", guid, entry, gInfo->type);
+                        sLog.outErrorDb("Gameobject (GUID: %u Entry %u GoType: %u) have displayId == 0 and then will always invisible in game.", guid, entry, row.gInfo->type);
                         break;
                 }
             }
-            else if (!sGameObjectDisplayInfoStore.LookupEntry(gInfo->displayId))
+            else if (!sGameObjectDisplayInfoStore.LookupEntry(row.gInfo->displayId))
             {
-                sLog.outErrorDb("Gameobject (GUID: %u Entry %u GoType: %u) have invalid displayId (%u), not loaded.", guid, entry, gInfo->type, gInfo->displayId);
-                continue;
+                sLog.outErrorDb("Gameobject (GUID: %u Entry %u GoType: %u) have invalid displayId (%u), not loaded.", guid, entry, row.gInfo->type, row.gInfo->displayId);
+                return;
             }
         }
 
+        // from here on rejected rows still replace the stored data, but are not spawned
+        row.state = SPAWN_ROW_STORED;
 
-        GameObjectData& data = mGameObjectDataMap[guid];
-
-        data.id               = entry;
-        data.mapid            = fields[ 2].GetUInt32();
-        data.posX             = fields[ 3].GetFloat();
-        data.posY             = fields[ 4].GetFloat();
-        data.posZ             = fields[ 5].GetFloat();
-        data.orientation      = fields[ 6].GetFloat();
-        data.rotation.x       = fields[ 7].GetFloat();
-        data.rotation.y       = fields[ 8].GetFloat();
-        data.rotation.z       = fields[ 9].GetFloat();
-        data.rotation.w       = fields[10].GetFloat();
-        data.spawntimesecsmin = fields[11].GetInt32();
-        data.spawntimesecsmax = fields[12].GetInt32();
-        data.animprogress     = fields[13].GetUInt32();
-        uint32 go_state       = fields[14].GetUInt32();
-        data.spawnMask        = fields[15].GetUInt8();
-        data.phaseMask        = fields[16].GetUInt16();
-        data.gameEvent        = fields[17].GetInt16();
-        data.GuidPoolId       = fields[18].GetInt16();
-        data.EntryPoolId      = fields[19].GetInt16();
+        data.id = entry;
 
         MapEntry const* mapEntry = sMapStore.LookupEntry(data.mapid);
         if (!mapEntry)
         {
             sLog.outErrorDb("Table `gameobject` have gameobject (GUID: %u Entry: %u) that spawned at nonexistent map (Id: %u), skip", guid, data.id, data.mapid);
-            continue;
+            return;
         }
 
         if (!MaNGOS::IsValidMapCoord(data.posX, data.posY, data.posZ))
         {
             sLog.outErrorDb("Table `gameobject` have gameobject (GUID: %u) that spawned at not valid coordinate (x:%5.2f, y:%5.2f, z:%5.2f) skipped.", guid, data.posX, data.posY, data.posZ);
-            continue;
+            return;
         }
 
-        if (m_transportMaps.find(data.mapid) == m_transportMaps.end() && data.spawnMask & ~spawnMasks[data.mapid])
+        if (m_transportMaps.find(data.mapid) == m_transportMaps.end() && data.spawnMask & ~GetSpawnMask(spawnMasks, data.mapid))
             sLog.outErrorDb("Table `gameobject` have gameobject (GUID: %u Entry: %u) that have wrong spawn mask %u including not supported difficulty modes for map (Id: %u), skip", guid, data.id, data.spawnMask, data.mapid);
 
-        if (data.spawntimesecsmin == 0 && gInfo && gInfo->IsDespawnAtAction())
+        if (data.spawntimesecsmin == 0 && row.gInfo && row.gInfo->IsDespawnAtAction())
         {
             sLog.outErrorDb("Table `gameobject` have gameobject (GUID: %u Entry: %u) with `spawntimesecs` (0) value, but gameobejct marked as despawnable at action.", guid, data.id);
         }
@@ -2373,41 +2573,41 @@ void ObjectMgr::LoadGameObjects()
             data.spawntimesecsmax = data.spawntimesecsmin;
         }
 
-        if (go_state >= MAX_GO_STATE)
+        if (row.goState >= MAX_GO_STATE)
         {
-            sLog.outErrorDb("Table `gameobject` have gameobject (GUID: %u Entry: %u) with invalid `state` (%u) value, skip", guid, data.id, go_state);
-            continue;
+            sLog.outErrorDb("Table `gameobject` have gameobject (GUID: %u Entry: %u) with invalid `state` (%u) value, skip", guid, data.id, row.goState);
+            return;
         }
-        data.go_state       = GOState(go_state);
+        data.go_state       = GOState(row.goState);
 
         if (data.rotation.x < -1.0f || data.rotation.x > 1.0f)
         {
             sLog.outErrorDb("Table `gameobject` have gameobject (GUID: %u Entry: %u) with invalid rotation.x (%f) value, skip", guid, data.id, data.rotation.x);
-            continue;
+            return;
         }
 
         if (data.rotation.y < -1.0f || data.rotation.y > 1.0f)
         {
             sLog.outErrorDb("Table `gameobject` have gameobject (GUID: %u Entry: %u) with invalid rotation.y (%f) value, skip", guid, data.id, data.rotation.y);
-            continue;
+            return;
         }
 
         if (data.rotation.z < -1.0f || data.rotation.z > 1.0f)
         {
             sLog.outErrorDb("Table `gameobject` have gameobject (GUID: %u Entry: %u) with invalid rotation.z (%f) value, skip", guid, data.id, data.rotation.z);
-            continue;
+            return;
         }
 
         if (data.rotation.w < -1.0f || data.rotation.w > 1.0f)
         {
             sLog.outErrorDb("Table `gameobject` have gameobject (GUID: %u Entry: %u) with invalid rotation.w (%f) value, skip", guid, data.id, data.rotation.w);
-            continue;
+            return;
         }
 
         if (!MapManager::IsValidMapCoord(data.mapid, data.posX, data.posY, data.posZ, data.orientation))
         {
             sLog.outErrorDb("Table `gameobject` have gameobject (GUID: %u Entry: %u) with invalid coordinates, skip", guid, data.id);
-            continue;
+            return;
         }
 
         if (data.phaseMask == 0)
@@ -2424,21 +2624,35 @@ void ObjectMgr::LoadGameObjects()
         else
             data.OriginalZoneId = 0;
 
+        row.state = SPAWN_ROW_VALID;
+    });
+
+    std::vector<SpawnCellEntry> cellEntries;
+    cellEntries.reserve(rows.size());
+    for (GameObjectSpawnRow& row : rows)
+    {
+        if (row.state == SPAWN_ROW_SKIPPED)
+            continue;
+
+        GameObjectData& data = mGameObjectDataMap[row.guid];
+        data = row.data;
+        if (row.state != SPAWN_ROW_VALID)
+            continue;
+
         if (m_transportMaps.find(data.mapid) != m_transportMaps.end())
-            m_guidsForMap[data.mapid].emplace_back(TYPEID_GAMEOBJECT, guid);
+            m_guidsForMap[data.mapid].emplace_back(TYPEID_GAMEOBJECT, row.guid);
         else if (data.IsNotPartOfPoolOrEvent()) // if not this is to be managed by GameEvent System or Pool system
         {
-            AddGameobjectToGrid(guid, &data);
+            CollectSpawnCells(cellEntries, row.guid, data.mapid, data.spawnMask, data.posX, data.posY);
 
-            if (sWorld.getConfig(CONFIG_BOOL_AUTOLOAD_ACTIVE) && gInfo && gInfo->ExtraFlags & GAMEOBJECT_EXTRA_FLAG_ACTIVE)
-                m_activeGameObjects.emplace(data.mapid, guid);
+            if (sWorld.getConfig(CONFIG_BOOL_AUTOLOAD_ACTIVE) && row.gInfo && row.gInfo->ExtraFlags & GAMEOBJECT_EXTRA_FLAG_ACTIVE)
+                m_activeGameObjects.emplace(data.mapid, row.guid);
         }
 
         ++count;
     }
-    while (result->NextRow());
 
-    delete result;
+    BuildCellIndex(mMapObjectGuids, cellEntries, &CellObjectGuids::gameobjects);
 
     sLog.outString(">> Loaded " SIZEFMTD " gameobjects", mGameObjectDataMap.size());
     sLog.outString();
@@ -2719,7 +2933,7 @@ void ObjectMgr::LoadItemLocales()
 {
     mItemLocaleMap.clear();                                 // need for reload case
 
-    QueryResult* result = WorldDatabase.Query("SELECT entry,name_loc1,description_loc1,name_loc2,description_loc2,name_loc3,description_loc3,name_loc4,description_loc4,name_loc5,description_loc5,name_loc6,description_loc6,name_loc7,description_loc7,name_loc8,description_loc8 FROM locales_item");
+    QueryResult* result = WorldDatabase.Query(SelectActiveLocaleColumns("SELECT entry,name_loc1,description_loc1,name_loc2,description_loc2,name_loc3,description_loc3,name_loc4,description_loc4,name_loc5,description_loc5,name_loc6,description_loc6,name_loc7,description_loc7,name_loc8,description_loc8 FROM locales_item").c_str());
 
     if (!result)
     {
@@ -2754,10 +2968,7 @@ void ObjectMgr::LoadItemLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.Name.size() <= idx)
-                        data.Name.resize(idx + 1);
-
-                    data.Name[idx] = str;
+                    data.Name.Set(idx, str);
                 }
             }
 
@@ -2767,10 +2978,7 @@ void ObjectMgr::LoadItemLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.Description.size() <= idx)
-                        data.Description.resize(idx + 1);
-
-                    data.Description[idx] = str;
+                    data.Description.Set(idx, str);
                 }
             }
         }
@@ -5432,7 +5640,7 @@ void ObjectMgr::LoadQuestLocales()
 {
     mQuestLocaleMap.clear();                                // need for reload case
 
-    QueryResult* result = WorldDatabase.Query("SELECT entry,"
+    QueryResult* result = WorldDatabase.Query(SelectActiveLocaleColumns("SELECT entry,"
                           "Title_loc1,Details_loc1,Objectives_loc1,OfferRewardText_loc1,RequestItemsText_loc1,EndText_loc1,CompletedText_loc1,ObjectiveText1_loc1,ObjectiveText2_loc1,ObjectiveText3_loc1,ObjectiveText4_loc1,"
                           "Title_loc2,Details_loc2,Objectives_loc2,OfferRewardText_loc2,RequestItemsText_loc2,EndText_loc2,CompletedText_loc2,ObjectiveText1_loc2,ObjectiveText2_loc2,ObjectiveText3_loc2,ObjectiveText4_loc2,"
                           "Title_loc3,Details_loc3,Objectives_loc3,OfferRewardText_loc3,RequestItemsText_loc3,EndText_loc3,CompletedText_loc3,ObjectiveText1_loc3,ObjectiveText2_loc3,ObjectiveText3_loc3,ObjectiveText4_loc3,"
@@ -5442,7 +5650,7 @@ void ObjectMgr::LoadQuestLocales()
                           "Title_loc7,Details_loc7,Objectives_loc7,OfferRewardText_loc7,RequestItemsText_loc7,EndText_loc7,CompletedText_loc7,ObjectiveText1_loc7,ObjectiveText2_loc7,ObjectiveText3_loc7,ObjectiveText4_loc7,"
                           "Title_loc8,Details_loc8,Objectives_loc8,OfferRewardText_loc8,RequestItemsText_loc8,EndText_loc8,CompletedText_loc8,ObjectiveText1_loc8,ObjectiveText2_loc8,ObjectiveText3_loc8,ObjectiveText4_loc8"
                           " FROM locales_quest"
-                                             );
+                                             ).c_str());
 
     if (!result)
     {
@@ -5477,10 +5685,7 @@ void ObjectMgr::LoadQuestLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.Title.size() <= idx)
-                        data.Title.resize(idx + 1);
-
-                    data.Title[idx] = str;
+                    data.Title.Set(idx, str);
                 }
             }
             str = fields[1 + 11 * (i - 1) + 1].GetCppString();
@@ -5489,10 +5694,7 @@ void ObjectMgr::LoadQuestLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.Details.size() <= idx)
-                        data.Details.resize(idx + 1);
-
-                    data.Details[idx] = str;
+                    data.Details.Set(idx, str);
                 }
             }
             str = fields[1 + 11 * (i - 1) + 2].GetCppString();
@@ -5501,10 +5703,7 @@ void ObjectMgr::LoadQuestLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.Objectives.size() <= idx)
-                        data.Objectives.resize(idx + 1);
-
-                    data.Objectives[idx] = str;
+                    data.Objectives.Set(idx, str);
                 }
             }
             str = fields[1 + 11 * (i - 1) + 3].GetCppString();
@@ -5513,10 +5712,7 @@ void ObjectMgr::LoadQuestLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.OfferRewardText.size() <= idx)
-                        data.OfferRewardText.resize(idx + 1);
-
-                    data.OfferRewardText[idx] = str;
+                    data.OfferRewardText.Set(idx, str);
                 }
             }
             str = fields[1 + 11 * (i - 1) + 4].GetCppString();
@@ -5525,10 +5721,7 @@ void ObjectMgr::LoadQuestLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.RequestItemsText.size() <= idx)
-                        data.RequestItemsText.resize(idx + 1);
-
-                    data.RequestItemsText[idx] = str;
+                    data.RequestItemsText.Set(idx, str);
                 }
             }
             str = fields[1 + 11 * (i - 1) + 5].GetCppString();
@@ -5537,10 +5730,7 @@ void ObjectMgr::LoadQuestLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.EndText.size() <= idx)
-                        data.EndText.resize(idx + 1);
-
-                    data.EndText[idx] = str;
+                    data.EndText.Set(idx, str);
                 }
             }
             str = fields[1 + 11 * (i - 1) + 6].GetCppString();
@@ -5549,10 +5739,7 @@ void ObjectMgr::LoadQuestLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.CompletedText.size() <= idx)
-                        data.CompletedText.resize(idx + 1);
-
-                    data.CompletedText[idx] = str;
+                    data.CompletedText.Set(idx, str);
                 }
             }
             for (int k = 0; k < 4; ++k)
@@ -5563,10 +5750,7 @@ void ObjectMgr::LoadQuestLocales()
                     int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                     if (idx >= 0)
                     {
-                        if ((int32)data.ObjectiveText[k].size() <= idx)
-                            data.ObjectiveText[k].resize(idx + 1);
-
-                        data.ObjectiveText[k][idx] = str;
+                        data.ObjectiveText[k].Set(idx, str);
                     }
                 }
             }
@@ -5907,6 +6091,8 @@ void ObjectMgr::LoadConditions()
         }
     }
 
+    ConditionEntry::CompileAll();
+
     for (auto& mQuestTemplate : mQuestTemplates) // needs to be checked after loading conditions
     {
         Quest* qinfo = mQuestTemplate.second;
@@ -6057,7 +6243,7 @@ void ObjectMgr::LoadGossipTextLocales()
 {
     mNpcTextLocaleMap.clear();                              // need for reload case
 
-    QueryResult* result = WorldDatabase.Query("SELECT entry,"
+    QueryResult* result = WorldDatabase.Query(SelectActiveLocaleColumns("SELECT entry,"
                           "Text0_0_loc1,Text0_1_loc1,Text1_0_loc1,Text1_1_loc1,Text2_0_loc1,Text2_1_loc1,Text3_0_loc1,Text3_1_loc1,Text4_0_loc1,Text4_1_loc1,Text5_0_loc1,Text5_1_loc1,Text6_0_loc1,Text6_1_loc1,Text7_0_loc1,Text7_1_loc1,"
                           "Text0_0_loc2,Text0_1_loc2,Text1_0_loc2,Text1_1_loc2,Text2_0_loc2,Text2_1_loc2,Text3_0_loc2,Text3_1_loc2,Text4_0_loc2,Text4_1_loc2,Text5_0_loc2,Text5_1_loc2,Text6_0_loc2,Text6_1_loc2,Text7_0_loc2,Text7_1_loc2,"
                           "Text0_0_loc3,Text0_1_loc3,Text1_0_loc3,Text1_1_loc3,Text2_0_loc3,Text2_1_loc3,Text3_0_loc3,Text3_1_loc3,Text4_0_loc3,Text4_1_loc3,Text5_0_loc3,Text5_1_loc3,Text6_0_loc3,Text6_1_loc3,Text7_0_loc3,Text7_1_loc3,"
@@ -6066,7 +6252,7 @@ void ObjectMgr::LoadGossipTextLocales()
                           "Text0_0_loc6,Text0_1_loc6,Text1_0_loc6,Text1_1_loc6,Text2_0_loc6,Text2_1_loc6,Text3_0_loc6,Text3_1_loc6,Text4_0_loc6,Text4_1_loc6,Text5_0_loc6,Text5_1_loc6,Text6_0_loc6,Text6_1_loc6,Text7_0_loc6,Text7_1_loc6,"
                           "Text0_0_loc7,Text0_1_loc7,Text1_0_loc7,Text1_1_loc7,Text2_0_loc7,Text2_1_loc7,Text3_0_loc7,Text3_1_loc7,Text4_0_loc7,Text4_1_loc7,Text5_0_loc7,Text5_1_loc7,Text6_0_loc7,Text6_1_loc7,Text7_0_loc7,Text7_1_loc7, "
                           "Text0_0_loc8,Text0_1_loc8,Text1_0_loc8,Text1_1_loc8,Text2_0_loc8,Text2_1_loc8,Text3_0_loc8,Text3_1_loc8,Text4_0_loc8,Text4_1_loc8,Text5_0_loc8,Text5_1_loc8,Text6_0_loc8,Text6_1_loc8,Text7_0_loc8,Text7_1_loc8 "
-                          " FROM locales_npc_text");
+                          " FROM locales_npc_text").c_str());
 
     if (!result)
     {
@@ -6103,10 +6289,7 @@ void ObjectMgr::LoadGossipTextLocales()
                     int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                     if (idx >= 0)
                     {
-                        if ((int32)data.Text_0[j].size() <= idx)
-                            data.Text_0[j].resize(idx + 1);
-
-                        data.Text_0[j][idx] = str0;
+                        data.Text_0[j].Set(idx, str0);
                     }
                 }
                 std::string str1 = fields[1 + 8 * 2 * (i - 1) + 2 * j + 1].GetCppString();
@@ -6115,10 +6298,7 @@ void ObjectMgr::LoadGossipTextLocales()
                     int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                     if (idx >= 0)
                     {
-                        if ((int32)data.Text_1[j].size() <= idx)
-                            data.Text_1[j].resize(idx + 1);
-
-                        data.Text_1[j][idx] = str1;
+                        data.Text_1[j].Set(idx, str1);
                     }
                 }
             }
@@ -7281,10 +7461,10 @@ void ObjectMgr::LoadGameObjectLocales()
 {
     mGameObjectLocaleMap.clear();                           // need for reload case
 
-    QueryResult* result = WorldDatabase.Query("SELECT entry,"
+    QueryResult* result = WorldDatabase.Query(SelectActiveLocaleColumns("SELECT entry,"
                           "name_loc1,name_loc2,name_loc3,name_loc4,name_loc5,name_loc6,name_loc7,name_loc8,"
                           "castbarcaption_loc1,castbarcaption_loc2,castbarcaption_loc3,castbarcaption_loc4,"
-                          "castbarcaption_loc5,castbarcaption_loc6,castbarcaption_loc7,castbarcaption_loc8 FROM locales_gameobject");
+                          "castbarcaption_loc5,castbarcaption_loc6,castbarcaption_loc7,castbarcaption_loc8 FROM locales_gameobject").c_str());
 
     if (!result)
     {
@@ -7319,10 +7499,7 @@ void ObjectMgr::LoadGameObjectLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.Name.size() <= idx)
-                        data.Name.resize(idx + 1);
-
-                    data.Name[idx] = str;
+                    data.Name.Set(idx, str);
                 }
             }
         }
@@ -7335,10 +7512,7 @@ void ObjectMgr::LoadGameObjectLocales()
                 int idx = GetOrNewStorageLocaleIndexFor(LocaleConstant(i));
                 if (idx >= 0)
                 {
-                    if ((int32)data.CastBarCaption.size() <= idx)
-                        data.CastBarCaption.resize(idx + 1);
-
-                    data.CastBarCaption[idx] = str;
+                    data.CastBarCaption.Set(idx, str);
                 }
             }
         }
@@ -8879,6 +9053,7 @@ int ObjectMgr::GetOrNewStorageLocaleIndexFor(LocaleConstant loc)
     if (loc == DEFAULT_LOCALE)
         return -1;
 
+    std::lock_guard<std::mutex> guard(m_LocalForIndexLock);
     for (size_t i = 0; i < m_LocalForIndex.size(); ++i)
         if (m_LocalForIndex[i] == loc)
             return i;
@@ -9773,11 +9948,13 @@ void ObjectMgr::LoadActiveEntities(Map* _map)
     // Load active objects for _map
     if (sWorld.isForceLoadMap(_map->GetId()))
     {
+        std::vector<std::pair<float, float>> positions;
         for (CreatureDataMap::const_iterator itr = mCreatureDataMap.begin(); itr != mCreatureDataMap.end(); ++itr)
         {
             if (itr->second.mapid == _map->GetId())
-                _map->ForceLoadGrid(itr->second.posX, itr->second.posY);
+                positions.emplace_back(itr->second.posX, itr->second.posY);
         }
+        _map->ForceLoadGrids(positions);
     }
     else                                                    // Normal case - Load all npcs that are active
     {
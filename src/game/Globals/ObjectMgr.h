@@ -38,6 +38,7 @@
 #include "Entities/Vehicle.h"
 
 #include <map>
+#include <mutex>
 #include <climits>
 
 class Group;
@@ -445,6 +446,8 @@ SkillRangeType GetSkillRangeType(SkillLineEntry const* pSkill, bool racial);
 #define MAX_PET_NAME             12                         // max allowed by client name length
 #define MAX_CHARTER_NAME         24                         // max allowed by client name length
 
+#define ITEM_GUID_LEASE_SIZE     64                         // item guids reserved by a thread at once
+
 bool normalizePlayerName(std::string& name, size_t max_len = MAX_INTERNAL_PLAYER_NAME);
 
 struct LanguageDesc
@@ -831,7 +834,8 @@ class ObjectMgr
         uint32 GenerateStaticGameObjectLowGuid() { if (m_StaticGameObjectGuids.GetNextAfterMaxUsed() >= m_FirstTemporaryGameObjectGuid) return 0; return m_StaticGameObjectGuids.Generate(); }
 
         uint32 GeneratePlayerLowGuid()   { return m_CharGuids.Generate();     }
-        uint32 GenerateItemLowGuid()     { return m_ItemGuids.Generate();     }
+        // items are created from every map and session thread, each takes its guids from an own block
+        uint32 GenerateItemLowGuid()     { return m_ItemGuids.GenerateLeased(ITEM_GUID_LEASE_SIZE); }
         uint32 GenerateCorpseLowGuid()   { return m_CorpseGuids.Generate();   }
         uint32 GenerateInstanceLowGuid() { return m_InstanceGuids.Generate(); }
         uint32 GenerateGroupLowGuid()    { return m_GroupGuids.Generate();    }
@@ -1343,6 +1347,7 @@ class ObjectMgr
 
         typedef             std::vector<LocaleConstant> LocalForIndex;
         LocalForIndex        m_LocalForIndex;
+        std::mutex           m_LocalForIndexLock;           // locale loaders may run in parallel at startup
 
         ExclusiveQuestGroupsMap m_ExclusiveQuestGroups;
 
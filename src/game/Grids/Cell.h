@@ -31,6 +31,8 @@ struct CellArea
     CellArea(const CellPair& low, const CellPair& high) : low_bound(low), high_bound(high) {}
 
     bool operator!() const { return low_bound == high_bound; }
+    bool operator==(CellArea const& other) const { return low_bound == other.low_bound && high_bound == other.high_bound; }
+    bool operator!=(CellArea const& other) const { return !(*this == other); }
 
     void ResizeBorders(CellPair& begin_cell, CellPair& end_cell) const
     {
@@ -27,8 +27,62 @@
 #include "BattleGround/BattleGroundMgr.h"
 #include "AI/BaseAI/UnitAI.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRID_PREFILTER_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace MaNGOS;
 
+// added to every prefilter range so float rounding can never drop an object the full check would accept
+static float const GRID_PREFILTER_SLACK = 0.01f;
+
+size_t MaNGOS::PrefilterGridPositions(GridPositionBlock const& block, size_t first, size_t count, GridPrefilter const& filter, uint32* survivors)
+{
+    float const* x = block.X();
+    float const* y = block.Y();
+    float const* radius = block.Radius();
+    uint32 const* flags = block.Flags();
+    float const range = filter.range + GRID_PREFILTER_SLACK;
+
+    size_t found = 0;
+    size_t i = first;
+    size_t const last = first + count;
+#ifdef GRID_PREFILTER_SSE2
+    __m128 const cx = _mm_set1_ps(filter.x);
+    __m128 const cy = _mm_set1_ps(filter.y);
+    __m128 const cr = _mm_set1_ps(range);
+    __m128i const phase = _mm_set1_epi32(int32(filter.phaseMask));
+    __m128i const zero = _mm_setzero_si128();
+    for (; i + 4 <= last; i += 4)
+    {
+        __m128 const dx = _mm_sub_ps(_mm_loadu_ps(x + i), cx);
+        __m128 const dy = _mm_sub_ps(_mm_loadu_ps(y + i), cy);
+        __m128 const r = _mm_add_ps(_mm_loadu_ps(radius + i), cr);
+        __m128 const inRange = _mm_cmplt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(r, r));
+        __m128i const outOfPhase = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(flags + i)), phase), zero);
+        int mask = _mm_movemask_ps(_mm_andnot_ps(_mm_castsi128_ps(outOfPhase), inRange));
+        size_t index = i;
+        while (mask)
+        {
+            if (mask & 1)
+                survivors[found++] = uint32(index);
+            mask >>= 1;
+            ++index;
+        }
+    }
+#endif
+    for (; i < last; ++i)
+    {
+        float const dx = x[i] - filter.x;
+        float const dy = y[i] - filter.y;
+        float const r = radius[i] + range;
+        if ((flags[i] & filter.phaseMask) != 0 && dx * dx + dy * dy < r * r)
+            survivors[found++] = uint32(i);
+    }
+    return found;
+}
+
 void VisibleChangesNotifier::Visit(CameraMapType& m)
 {
     for (auto& iter : m)
@@ -59,9 +113,9 @@ void VisibleNotifier::Notify()
     }
 
     // Far objects update on player notify
-    for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end();)
+    for (GuidHashSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end();)
     {
-        GuidSet::iterator current = itr++;
+        GuidHashSet::iterator current = itr++;
         if (WorldObject* obj = player.GetMap()->GetWorldObject(*current))
         {
             if (!obj->GetVisibilityData().IsVisibilityOverridden())
@@ -72,7 +126,7 @@ void VisibleNotifier::Notify()
         }
     }
 
-    for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end();)
+    for (GuidHashSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end();)
     {
         if ((*itr).IsMOTransport())
         {
@@ -84,7 +138,7 @@ void VisibleNotifier::Notify()
 
     // generate outOfRange for not iterate objects
     i_data.AddOutOfRangeGUID(i_clientGUIDs);
-    for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end(); ++itr)
+    for (GuidHashSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end(); ++itr)
     {
         if (WorldObject* target = player.GetMap()->GetWorldObject(*itr))
         {
@@ -163,6 +217,23 @@ void MessageDelivererExcept::Visit(CameraMapType& m)
     }
 }
 
+void MovementRelayCollector::Visit(CameraMapType& m)
+{
+    for (auto& iter : m)
+    {
+        Player* owner = iter.getSource()->GetOwner();
+
+        if (!owner->InSamePhase(i_phaseMask) || owner == i_skipped_receiver)
+            continue;
+
+        if (i_fullRateDistance > 0.0f && !i_object->IsWithinDist(iter.getSource()->GetBody(), i_fullRateDistance, false))
+            continue;
+
+        if (owner->GetSession())
+            i_receivers.push_back(owner);
+    }
+}
+
 void ObjectMessageDeliverer::Visit(CameraMapType& m)
 {
     for (auto& iter : m)
@@ -233,7 +304,8 @@ template<class T>
 void ObjectUpdater::Visit(GridRefManager<T>& m)
 {
     for (auto& iter : m)
-        m_objectToUpdateSet.emplace(iter.getSource());
+        if (iter.getSource()->MarkUpdateGeneration(m_generation))
+            m_objectsToUpdate.push_back(iter.getSource());
 }
 
 bool CannibalizeObjectCheck::operator()(Corpse* u)
@@ -30,6 +30,7 @@
 
 #include <functional>
 #include <memory>
+#include <type_traits>
 
 namespace MaNGOS
 {
@@ -37,15 +38,39 @@ namespace MaNGOS
     {
         Camera& i_camera;
         UpdateData i_data;
-        GuidSet i_clientGUIDs;
+        GuidHashSet i_clientGUIDs;
         WorldObjectSet i_visibleNow;
 
         explicit VisibleNotifier(Camera& c) : i_camera(c), i_clientGUIDs(c.GetOwner()->GetClientGuids()) {}
         template<class T> void Visit(GridRefManager<T>& m);
+        template<class T> void Visit(std::vector<T*> const& objects);
         void Visit(CameraMapType& /*m*/) {}
         void Notify(void);
     };
 
+    // Objects around a view point, gathered by one grid visit and replayed to every camera attached to it
+    struct VisibleObjectsCollector
+    {
+        std::vector<Player*> i_players;
+        std::vector<Creature*> i_creatures;
+        std::vector<Corpse*> i_corpses;
+        std::vector<GameObject*> i_gameObjects;
+        std::vector<DynamicObject*> i_dynamicObjects;
+
+        void Visit(PlayerMapType& m) { Collect(m, i_players); }
+        void Visit(CreatureMapType& m) { Collect(m, i_creatures); }
+        void Visit(CorpseMapType& m) { Collect(m, i_corpses); }
+        void Visit(GameObjectMapType& m) { Collect(m, i_gameObjects); }
+        void Visit(DynamicObjectMapType& m) { Collect(m, i_dynamicObjects); }
+        void Visit(CameraMapType& /*m*/) {}
+
+        template<class T> static void Collect(GridRefManager<T>& m, std::vector<T*>& objects)
+        {
+            for (auto& iter : m)
+                objects.push_back(iter.getSource());
+        }
+    };
+
     struct VisibleChangesNotifier
     {
         WorldObject& i_object;
@@ -82,6 +107,21 @@ namespace MaNGOS
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
 
+    struct MovementRelayCollector
+    {
+        WorldObject const* i_object;
+        uint32        i_phaseMask;
+        Player const* i_skipped_receiver;
+        float         i_fullRateDistance;               // receivers further away are skipped, 0 for none
+        std::vector<Player*> i_receivers;
+
+        MovementRelayCollector(WorldObject const* obj, Player const* skipped, float fullRateDistance)
+            : i_object(obj), i_phaseMask(obj->GetPhaseMask()), i_skipped_receiver(skipped), i_fullRateDistance(fullRateDistance) {}
+
+        void Visit(CameraMapType& m);
+        template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
+    };
+
     struct ObjectMessageDeliverer
     {
         uint32 i_phaseMask;
@@ -130,7 +170,7 @@ namespace MaNGOS
 
     struct ObjectUpdater
     {
-        ObjectUpdater(WorldObjectUnSet& otus, const uint32& diff) : m_objectToUpdateSet(otus), m_timeDiff(diff) {}
+        ObjectUpdater(WorldObjectVector& objects, uint32 generation, const uint32& diff) : m_objectsToUpdate(objects), m_generation(generation), m_timeDiff(diff) {}
         template<class T> void Visit(GridRefManager<T>& m);
         void Visit(PlayerMapType&) {}
         void Visit(CorpseMapType&) {}
@@ -138,7 +178,8 @@ namespace MaNGOS
         void Visit(CreatureMapType&);
 
         private:
-            WorldObjectUnSet& m_objectToUpdateSet;
+            WorldObjectVector& m_objectsToUpdate;
+            uint32 m_generation;                            // objects already stamped with it are queued once
             uint32 m_timeDiff;
     };
 
@@ -347,6 +388,68 @@ namespace MaNGOS
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
+    // Circle around a point outside of which a check never accepts an object.
+    // range already includes the size of the focus object, the size of each
+    // candidate is taken from the cell's packed positions.
+    struct GridPrefilter
+    {
+        float x;
+        float y;
+        float range;
+        uint32 phaseMask;
+    };
+
+    // Number of packed positions tested per prefilter pass
+    static size_t const GRID_PREFILTER_CHUNK = 64;
+
+    // Writes the indexes within [first, first + count) of the block entries that may pass
+    // the filter to survivors, returns their number. Tests 2d distance only, which keeps
+    // it conservative for 3d checks as well.
+    size_t PrefilterGridPositions(GridPositionBlock const& block, size_t first, size_t count, GridPrefilter const& filter, uint32* survivors);
+
+    // Checks providing bool GetPrefilter(GridPrefilter&) let the searchers skip objects
+    // by their packed position before calling the check itself
+    template<class Check, class = void>
+    struct HasGridPrefilter : std::false_type {};
+
+    template<class Check>
+    struct HasGridPrefilter<Check, std::void_t<decltype(std::declval<Check&>().GetPrefilter(std::declval<GridPrefilter&>()))>> : std::true_type {};
+
+    // Calls visitor for every object of the cell in phase and passing the check's prefilter,
+    // stops as soon as visitor returns false
+    template<class Check, class T, class Visitor>
+    void VisitPrefiltered(GridRefManager<T>& m, Check& check, uint32 phaseMask, Visitor visitor)
+    {
+        if constexpr (HasGridPrefilter<Check>::value)
+        {
+            GridPrefilter filter;
+            if (check.GetPrefilter(filter))
+            {
+                filter.phaseMask = phaseMask;
+                T* const* objects = m.GetObjects();
+                size_t const size = m.GetArraySize();
+                uint32 survivors[GRID_PREFILTER_CHUNK];
+                for (size_t first = 0; first < size; first += GRID_PREFILTER_CHUNK)
+                {
+                    size_t const count = PrefilterGridPositions(m.GetPositions(), first, std::min(GRID_PREFILTER_CHUNK, size - first), filter, survivors);
+                    for (size_t i = 0; i < count; ++i)
+                        if (!visitor(objects[survivors[i]]))
+                            return;
+                }
+                return;
+            }
+        }
+
+        for (typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
+        {
+            if (!itr->getSource()->InSamePhase(phaseMask))
+                continue;
+
+            if (!visitor(itr->getSource()))
+                return;
+        }
+    }
+
     // Unit searchers
 
     // First accepted by Check Unit if any
@@ -1196,6 +1299,13 @@ namespace MaNGOS
         public:
             AnyUnitInObjectRangeCheck(WorldObject const* obj, float range) : i_obj(obj), i_range(range) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            bool GetPrefilter(GridPrefilter& filter) const
+            {
+                filter.x = i_obj->GetPositionX();
+                filter.y = i_obj->GetPositionY();
+                filter.range = i_range + i_obj->GetCombatReach();
+                return true;
+            }
             bool operator()(Unit* u)
             {
                 return u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range);
@@ -1231,6 +1341,15 @@ namespace MaNGOS
 
             Unit const& GetFocusObject() const { return *m_source; }
 
+            // m_range only shrinks, so the filter taken at the start of a cell stays valid for it
+            bool GetPrefilter(GridPrefilter& filter) const
+            {
+                filter.x = m_source->GetPositionX();
+                filter.y = m_source->GetPositionY();
+                filter.range = m_range + m_source->GetCombatReach();
+                return true;
+            }
+
             bool operator()(Unit* currUnit)
             {
                 if (currUnit->IsAlive() && (m_source->IsAttackedBy(currUnit) || (m_owner && m_owner->IsAttackedBy(currUnit)) || m_source->IsEnemy(currUnit) || currUnit->IsEnemy(m_source))
@@ -1260,6 +1379,13 @@ namespace MaNGOS
                 i_targetForPlayer = i_obj->IsControlledByPlayer();
             }
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            bool GetPrefilter(GridPrefilter& filter) const
+            {
+                filter.x = i_obj->GetPositionX();
+                filter.y = i_obj->GetPositionY();
+                filter.range = i_range + i_obj->GetCombatReach();
+                return true;
+            }
             bool operator()(Unit* u)
             {
                 // Check contains checks for: live, non-selectable, non-attackable flags, flight check and GM check, ignore totems
@@ -39,10 +39,21 @@ inline void MaNGOS::VisibleNotifier::Visit(GridRefManager<T>& m)
     }
 }
 
+template<class T>
+inline void MaNGOS::VisibleNotifier::Visit(std::vector<T*> const& objects)
+{
+    for (T* object : objects)
+    {
+        i_camera.UpdateVisibilityOf(object, i_data, i_visibleNow);
+        i_clientGUIDs.erase(object->GetObjectGuid());
+    }
+}
+
 inline void MaNGOS::ObjectUpdater::Visit(CreatureMapType& m)
 {
     for (auto& iter : m)
-        m_objectToUpdateSet.emplace(iter.getSource());
+        if (iter.getSource()->MarkUpdateGeneration(m_generation))
+            m_objectsToUpdate.push_back(iter.getSource());
 }
 
 inline void UnitVisitObjectsNotifierWorker(Unit* unitA, Unit* unitB)
@@ -527,17 +538,14 @@ void MaNGOS::UnitSearcher<Check>::Visit(CreatureMapType& m)
     if (i_object)
         return;
 
-    for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitPrefiltered(m, i_check, i_phaseMask, [this](Creature* obj)
     {
-        if (!itr->getSource()->InSamePhase(i_phaseMask))
-            continue;
+        if (!i_check(obj))
+            return true;
 
-        if (i_check(itr->getSource()))
-        {
-            i_object = itr->getSource();
-            return;
-        }
-    }
+        i_object = obj;
+        return false;
+    });
 }
 
 template<class Check>
@@ -547,61 +555,58 @@ void MaNGOS::UnitSearcher<Check>::Visit(PlayerMapType& m)
     if (i_object)
         return;
 
-    for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitPrefiltered(m, i_check, i_phaseMask, [this](Player* obj)
     {
-        if (!itr->getSource()->InSamePhase(i_phaseMask))
-            continue;
+        if (!i_check(obj))
+            return true;
 
-        if (i_check(itr->getSource()))
-        {
-            i_object = itr->getSource();
-            return;
-        }
-    }
+        i_object = obj;
+        return false;
+    });
 }
 
 template<class Check>
 void MaNGOS::UnitLastSearcher<Check>::Visit(CreatureMapType& m)
 {
-    for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitPrefiltered(m, i_check, i_phaseMask, [this](Creature* obj)
     {
-        if (!itr->getSource()->InSamePhase(i_phaseMask))
-            continue;
-
-        if (i_check(itr->getSource()))
-            i_object = itr->getSource();
-    }
+        if (i_check(obj))
+            i_object = obj;
+        return true;
+    });
 }
 
 template<class Check>
 void MaNGOS::UnitLastSearcher<Check>::Visit(PlayerMapType& m)
 {
-    for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitPrefiltered(m, i_check, i_phaseMask, [this](Player* obj)
     {
-        if (!itr->getSource()->InSamePhase(i_phaseMask))
-            continue;
-
-        if (i_check(itr->getSource()))
-            i_object = itr->getSource();
-    }
+        if (i_check(obj))
+            i_object = obj;
+        return true;
+    });
 }
 
 template<class Check>
 void MaNGOS::UnitListSearcher<Check>::Visit(PlayerMapType& m)
 {
-    for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (itr->getSource()->InSamePhase(i_phaseMask))
-            if (i_check(itr->getSource()))
-                i_objects.push_back(itr->getSource());
+    VisitPrefiltered(m, i_check, i_phaseMask, [this](Player* obj)
+    {
+        if (i_check(obj))
+            i_objects.push_back(obj);
+        return true;
+    });
 }
 
 template<class Check>
 void MaNGOS::UnitListSearcher<Check>::Visit(CreatureMapType& m)
 {
-    for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (itr->getSource()->InSamePhase(i_phaseMask))
-            if (i_check(itr->getSource()))
-                i_objects.push_back(itr->getSource());
+    VisitPrefiltered(m, i_check, i_phaseMask, [this](Creature* obj)
+    {
+        if (i_check(obj))
+            i_objects.push_back(obj);
+        return true;
+    });
 }
 
 // Creature searchers
@@ -689,7 +694,7 @@ void MaNGOS::LocalizedPacketDo<Builder>::operator()(Player* p)
         if (i_data_cache.size() < cache_idx + 1)
             i_data_cache.resize(cache_idx + 1);
 
-        auto data = std::unique_ptr<WorldPacket>(new WorldPacket());
+        auto data = std::unique_ptr<WorldPacket>(new WorldPacket(MSG_NULL_ACTION, 200, PooledStorageTag()));
 
         i_builder(*data, loc_idx);
 
@@ -28,6 +28,8 @@ InvalidState::Update(Map&, NGridType&, GridInfo&, const uint32& /*x*/, const uin
 void
 ActiveState::Update(Map& m, NGridType& grid, GridInfo& info, const uint32& x, const uint32& y, const uint32& t_diff) const
 {
+    m.TouchGrid(x, y);
+
     // Only check grid activity every (grid_expiry/10) ms, because it's really useless to do it every cycle
     info.UpdateTimeTracker(t_diff);
     if (info.getTimeTracker().Passed())
@@ -48,7 +50,8 @@ ActiveState::Update(Map& m, NGridType& grid, GridInfo& info, const uint32& x, co
 void
 IdleState::Update(Map& m, NGridType& grid, GridInfo&, const uint32& x, const uint32& y, const uint32&) const
 {
-    m.ResetGridExpiry(grid);
+    // hysteresis, a grid reloaded right after its last unload waits longer this time
+    m.ResetGridExpiry(grid, m.GetGridExpiryFactor(x, y));
     grid.SetGridState(GRID_STATE_REMOVAL);
     DEBUG_LOG("Grid[%u,%u] on map %u moved to IDLE state", x, y, m.GetId());
 }
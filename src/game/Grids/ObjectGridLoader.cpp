@@ -114,9 +114,14 @@ template<> void addUnitState(Creature* obj, CellPair const& cell_pair)
 template <class T>
 void LoadHelper(CellGuidSet const& guid_set, CellPair& cell, GridRefManager<T>& /*m*/, uint32& count, Map* map, GridType& grid)
 {
+    if (guid_set.empty())
+        return;
+
     BattleGround* bg = map->IsBattleGroundOrArena() ? ((BattleGroundMap*)map)->GetBG() : nullptr;
 
-    for (uint32 guid : guid_set)
+    // spawns triggered while loading may modify the set, walk a copy of the cell's guids
+    std::vector<uint32> const guids(guid_set.begin(), guid_set.end());
+    for (uint32 guid : guids)
     {
         T* obj;
         if constexpr (std::is_same_v<T, GameObject>)
@@ -35,8 +35,6 @@
 #include "Spells/SpellAuras.h"
 #ifdef BUILD_PLAYERBOT
 #include "PlayerBot/Base/PlayerbotMgr.h"
-#include "Config/Config.h"
-extern Config botConfig;
 #endif
 
 GroupMemberStatus GetGroupMemberStatus(const Player* member = nullptr)
@@ -408,7 +406,7 @@ uint32 Group::RemoveMember(ObjectGuid guid, uint8 method)
     Player* player = sObjectMgr.GetPlayer(guid);
 #ifdef BUILD_PLAYERBOT
     // if master leaves group, all bots leave group
-    if (!botConfig.GetBoolDefault("PlayerbotAI.DisableBots", false))
+    if (!botConfDisableBots.Get())
     {
         if (player && player->GetPlayerbotMgr())
             player->GetPlayerbotMgr()->RemoveAllBotsFromGroup();
@@ -723,13 +721,24 @@ void Group::UpdatePlayerOutOfRange(Player* pPlayer)
     if (pPlayer->GetGroupUpdateFlag() == GROUP_UPDATE_FLAG_NONE)
         return;
 
-    WorldPacket data;
-    WorldSession::BuildPartyMemberStatsChangedPacket(pPlayer, data);
+    // one delta of the accumulated flags, built for the first member out of range and shared by all of them
+    std::shared_ptr<WorldPacket> data;
 
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
+    {
         if (Player* player = itr->getSource())
+        {
             if (player != pPlayer && !player->HasAtClient(pPlayer))
-                player->GetSession()->SendPacket(data);
+            {
+                if (!data)
+                {
+                    data = std::make_shared<WorldPacket>();
+                    WorldSession::BuildPartyMemberStatsChangedPacket(pPlayer, *data);
+                }
+                player->GetSession()->SendPacket(std::shared_ptr<WorldPacket const>(data));
+            }
+        }
+    }
 }
 
 void Group::UpdatePlayerOnlineStatus(Player* player, bool online /*= true*/)
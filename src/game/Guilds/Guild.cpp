@@ -100,6 +100,9 @@ Guild::Guild()
     m_GuildBankEventLogNextGuid_Money = 0;
     for (unsigned int& i : m_GuildBankEventLogNextGuid_Item)
         i = 0;
+
+    for (time_t& i : m_rosterCacheTime)
+        i = 0;
 }
 
 Guild::~Guild()
@@ -252,6 +255,7 @@ bool Guild::AddMember(ObjectGuid plGuid, uint32 plRank)
     }
 
     UpdateAccountsNumber();
+    InvalidateRoster();
 
     return true;
 }
@@ -259,6 +263,7 @@ bool Guild::AddMember(ObjectGuid plGuid, uint32 plRank)
 void Guild::SetMOTD(std::string motd)
 {
     MOTD = motd;
+    InvalidateRoster();
 
     // motd now can be used for encoding to DB
     CharacterDatabase.escape_string(motd);
@@ -268,6 +273,7 @@ void Guild::SetMOTD(std::string motd)
 void Guild::SetGINFO(std::string ginfo)
 {
     GINFO = ginfo;
+    InvalidateRoster();
 
     // ginfo now can be used for encoding to DB
     CharacterDatabase.escape_string(ginfo);
@@ -500,6 +506,7 @@ void Guild::SetLeader(ObjectGuid guid)
 
     m_LeaderGuid = guid;
     slot->ChangeRank(GR_GUILDMASTER);
+    InvalidateRoster();
 
     CharacterDatabase.PExecute("UPDATE guild SET leaderguid='%u' WHERE guildid='%u'", guid.GetCounter(), m_Id);
 }
@@ -556,6 +563,7 @@ bool Guild::DelMember(ObjectGuid guid, bool isDisbanding)
     }
 
     members.erase(lowguid);
+    InvalidateRoster();
 
     Player* player = sObjectMgr.GetPlayer(guid);
     // If player not online data in data field will be loaded from guild tabs no need to update it !!
@@ -680,6 +688,7 @@ void Guild::CreateRank(std::string name_, uint32 rights)
     uint32 new_rank_id = m_Ranks.size();
 
     AddRank(name_, rights, 0);
+    InvalidateRoster();
 
     // existing records in db should be deleted before calling this procedure and m_PurchasedTabs must be loaded already
 
@@ -710,6 +719,7 @@ void Guild::DelRank()
     CharacterDatabase.PExecute("DELETE FROM guild_bank_right WHERE rid>='%u' AND guildid='%u'", rank, m_Id);
 
     m_Ranks.pop_back();
+    InvalidateRoster();
 }
 
 std::string Guild::GetRankName(uint32 rankId)
@@ -746,6 +756,7 @@ void Guild::SetRankRights(uint32 rankId, uint32 rights)
         return;
 
     m_Ranks[rankId].Rights = rights;
+    InvalidateRoster();
 
     CharacterDatabase.PExecute("UPDATE guild_rank SET rights='%u' WHERE rid='%u' AND guildid='%u'", rights, rankId, m_Id);
 }
@@ -765,6 +776,10 @@ void Guild::Disband()
         DelMember(ObjectGuid(HIGHGUID_PLAYER, itr->first), true);
     }
 
+    // logged while the members left, the log tables are wiped below
+    m_pendingEventLog.clear();
+    m_pendingBankEventLog.clear();
+
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.PExecute("DELETE FROM guild WHERE guildid = '%u'", m_Id);
     CharacterDatabase.PExecute("DELETE FROM guild_rank WHERE guildid = '%u'", m_Id);
@@ -782,59 +797,81 @@ void Guild::Disband()
 }
 
 void Guild::Roster(WorldSession* session /*= nullptr*/)
+{
+    bool withOfficerNotes = session && HasRankRight(session->GetPlayer()->GetRank(), GR_RIGHT_VIEWOFFNOTE);
+
+    // online status, level and zone changes of members are not tracked, they are picked up when the cache expires
+    time_t now = time(nullptr);
+    std::shared_ptr<WorldPacket const>& data = m_rosterCache[withOfficerNotes];
+    if (!data || now >= m_rosterCacheTime[withOfficerNotes] + time_t(sWorld.getConfig(CONFIG_UINT32_GUILD_ROSTER_CACHE_TIME)))
+    {
+        data = BuildRosterPacket(withOfficerNotes);
+        m_rosterCacheTime[withOfficerNotes] = now;
+    }
+
+    if (session)
+        session->SendPacket(data);
+    else
+        BroadcastPacket(*data);
+    DEBUG_LOG("WORLD: Sent (SMSG_GUILD_ROSTER)");
+}
+
+void Guild::InvalidateRoster()
+{
+    for (std::shared_ptr<WorldPacket const>& i : m_rosterCache)
+        i.reset();
+}
+
+std::shared_ptr<WorldPacket const> Guild::BuildRosterPacket(bool withOfficerNotes) const
 {
     // we can only guess size
-    WorldPacket data(SMSG_GUILD_ROSTER, (4 + MOTD.length() + 1 + GINFO.length() + 1 + 4 + m_Ranks.size() * (4 + 4 + GUILD_BANK_MAX_TABS * (4 + 4)) + members.size() * 50));
-    data << uint32(members.size());
-    data << MOTD;
-    data << GINFO;
+    std::shared_ptr<WorldPacket> data = std::make_shared<WorldPacket>(SMSG_GUILD_ROSTER, (4 + MOTD.length() + 1 + GINFO.length() + 1 + 4 + m_Ranks.size() * (4 + 4 + GUILD_BANK_MAX_TABS * (4 + 4)) + members.size() * 50));
+    *data << uint32(members.size());
+    *data << MOTD;
+    *data << GINFO;
 
-    data << uint32(m_Ranks.size());
+    *data << uint32(m_Ranks.size());
     for (RankList::const_iterator ritr = m_Ranks.begin(); ritr != m_Ranks.end(); ++ritr)
     {
-        data << uint32(ritr->Rights);
-        data << uint32(ritr->BankMoneyPerDay);              // count of: withdraw gold(gold/day) Note: in game set gold, in packet set bronze.
+        *data << uint32(ritr->Rights);
+        *data << uint32(ritr->BankMoneyPerDay);             // count of: withdraw gold(gold/day) Note: in game set gold, in packet set bronze.
         for (int i = 0; i < GUILD_BANK_MAX_TABS; ++i)
         {
-            data << uint32(ritr->TabRight[i]);              // for TAB_i rights: view tabs = 0x01, deposit items =0x02
-            data << uint32(ritr->TabSlotPerDay[i]);         // for TAB_i count of: withdraw items(stack/day)
+            *data << uint32(ritr->TabRight[i]);             // for TAB_i rights: view tabs = 0x01, deposit items =0x02
+            *data << uint32(ritr->TabSlotPerDay[i]);        // for TAB_i count of: withdraw items(stack/day)
         }
     }
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         if (Player* pl = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first)))
         {
-            data << pl->GetObjectGuid();
-            data << uint8(1);
-            data << pl->GetName();
-            data << uint32(itr->second.RankId);
-            data << uint8(pl->GetLevel());
-            data << uint8(pl->getClass());
-            data << uint8(pl->getGender());                                     // new 2.4.0
-            data << uint32(pl->GetZoneId());
-            data << itr->second.Pnote;
-            data << ((session && HasRankRight(session->GetPlayer()->GetRank(), GR_RIGHT_VIEWOFFNOTE)) ? itr->second.OFFnote : "");
+            *data << pl->GetObjectGuid();
+            *data << uint8(1);
+            *data << pl->GetName();
+            *data << uint32(itr->second.RankId);
+            *data << uint8(pl->GetLevel());
+            *data << uint8(pl->getClass());
+            *data << uint8(pl->getGender());                                    // new 2.4.0
+            *data << uint32(pl->GetZoneId());
+            *data << itr->second.Pnote;
+            *data << (withOfficerNotes ? itr->second.OFFnote : "");
         }
         else
         {
-            data << ObjectGuid(HIGHGUID_PLAYER, itr->first);
-            data << uint8(0);
-            data << itr->second.Name;
-            data << uint32(itr->second.RankId);
-            data << uint8(itr->second.Level);
-            data << uint8(itr->second.Class);
-            data << uint8(itr->second.Gender_);                                 // new 2.4.0
-            data << uint32(itr->second.ZoneId);
-            data << float(float(time(nullptr) - itr->second.LogoutTime) / DAY);
-            data << itr->second.Pnote;
-            data << ((session && HasRankRight(session->GetPlayer()->GetRank(), GR_RIGHT_VIEWOFFNOTE)) ? itr->second.OFFnote : "");
+            *data << ObjectGuid(HIGHGUID_PLAYER, itr->first);
+            *data << uint8(0);
+            *data << itr->second.Name;
+            *data << uint32(itr->second.RankId);
+            *data << uint8(itr->second.Level);
+            *data << uint8(itr->second.Class);
+            *data << uint8(itr->second.Gender_);                                // new 2.4.0
+            *data << uint32(itr->second.ZoneId);
+            *data << float(float(time(nullptr) - itr->second.LogoutTime) / DAY);
+            *data << itr->second.Pnote;
+            *data << (withOfficerNotes ? itr->second.OFFnote : "");
         }
     }
-    if (session)
-        session->SendPacket(data);
-    else
-        BroadcastPacket(data);
-    DEBUG_LOG("WORLD: Sent (SMSG_GUILD_ROSTER)");
+    return data;
 }
 
 void Guild::Query(WorldSession* session)
@@ -904,20 +941,21 @@ void Guild::DisplayGuildEventLog(WorldSession* session)
     WorldPacket data(MSG_GUILD_EVENT_LOG_QUERY, 0);
     // count, max count == 100
     data << uint8(m_GuildEventLog.size());
-    for (GuildEventLog::const_iterator itr = m_GuildEventLog.begin(); itr != m_GuildEventLog.end(); ++itr)
+    for (uint32 i = 0; i < m_GuildEventLog.size(); ++i)
     {
+        GuildEventLogEntry const& entry = m_GuildEventLog[i];
         // Event type
-        data << uint8(itr->EventType);
+        data << uint8(entry.EventType);
         // Player 1
-        data << ObjectGuid(HIGHGUID_PLAYER, itr->PlayerGuid1);
+        data << ObjectGuid(HIGHGUID_PLAYER, entry.PlayerGuid1);
         // Player 2 not for left/join guild events
-        if (itr->EventType != GUILD_EVENT_LOG_JOIN_GUILD && itr->EventType != GUILD_EVENT_LOG_LEAVE_GUILD)
-            data << ObjectGuid(HIGHGUID_PLAYER, itr->PlayerGuid2);
+        if (entry.EventType != GUILD_EVENT_LOG_JOIN_GUILD && entry.EventType != GUILD_EVENT_LOG_LEAVE_GUILD)
+            data << ObjectGuid(HIGHGUID_PLAYER, entry.PlayerGuid2);
         // New Rank - only for promote/demote guild events
-        if (itr->EventType == GUILD_EVENT_LOG_PROMOTE_PLAYER || itr->EventType == GUILD_EVENT_LOG_DEMOTE_PLAYER)
-            data << uint8(itr->NewRank);
+        if (entry.EventType == GUILD_EVENT_LOG_PROMOTE_PLAYER || entry.EventType == GUILD_EVENT_LOG_DEMOTE_PLAYER)
+            data << uint8(entry.NewRank);
         // Event timestamp
-        data << uint32(time(nullptr) - itr->TimeStamp);
+        data << uint32(time(nullptr) - entry.TimeStamp);
     }
     session->SendPacket(data);
     DEBUG_LOG("WORLD: Sent (MSG_GUILD_EVENT_LOG_QUERY)");
@@ -954,7 +992,7 @@ void Guild::LoadGuildEventLogFromDB()
         // but if problem appears, player will see set of guild events that have same timestamp in bad order
 
         // Add entry to list
-        m_GuildEventLog.push_front(NewEvent);
+        m_GuildEventLog.PushOldest(NewEvent);
     }
     while (result->NextRow());
     delete result;
@@ -972,15 +1010,67 @@ void Guild::LogGuildEvent(uint8 EventType, ObjectGuid playerGuid1, ObjectGuid pl
     NewEvent.TimeStamp = uint32(time(nullptr));
     // Count new LogGuid
     m_GuildEventLogNextGuid = (m_GuildEventLogNextGuid + 1) % sWorld.getConfig(CONFIG_UINT32_GUILD_EVENT_LOG_COUNT);
-    // Check max records limit
-    if (m_GuildEventLog.size() >= GUILD_EVENTLOG_MAX_RECORDS)
-        m_GuildEventLog.pop_front();
-    // Add event to list
-    m_GuildEventLog.push_back(NewEvent);
+    // Add event to list, the oldest one is dropped when full
+    m_GuildEventLog.Push(NewEvent);
     // Save event to DB
-    CharacterDatabase.PExecute("DELETE FROM guild_eventlog WHERE guildid='%u' AND LogGuid='%u'", m_Id, m_GuildEventLogNextGuid);
-    CharacterDatabase.PExecute("INSERT INTO guild_eventlog (guildid, LogGuid, EventType, PlayerGuid1, PlayerGuid2, NewRank, TimeStamp) VALUES ('%u','%u','%u','%u','%u','%u','" UI64FMTD "')",
-                               m_Id, m_GuildEventLogNextGuid, uint32(NewEvent.EventType), NewEvent.PlayerGuid1, NewEvent.PlayerGuid2, uint32(NewEvent.NewRank), NewEvent.TimeStamp);
+    m_pendingEventLog.push_back({ m_GuildEventLogNextGuid, NewEvent });
+    if (!sWorld.getConfig(CONFIG_UINT32_GUILD_LOG_FLUSH_INTERVAL))
+        SaveLogs();
+}
+
+void Guild::SaveLogs()
+{
+    if (m_pendingEventLog.empty() && m_pendingBankEventLog.empty())
+        return;
+
+    // LogGuids wrap around, a slot written twice since the last save only keeps its last entry
+    std::map<uint32, GuildEventLogEntry const*> events;
+    for (PendingEventLog const& pending : m_pendingEventLog)
+        events[pending.logGuid] = &pending.entry;
+
+    std::map<uint32, std::map<uint32, GuildBankEventLogEntry const*> > bankEvents;
+    for (PendingBankEventLog const& pending : m_pendingBankEventLog)
+        bankEvents[pending.tabId][pending.logGuid] = &pending.entry;
+
+    // no transaction of its own, bank moves log from inside theirs
+    if (!events.empty())
+    {
+        std::ostringstream del, ins;
+        del << "DELETE FROM guild_eventlog WHERE guildid='" << m_Id << "' AND LogGuid IN (";
+        ins << "INSERT INTO guild_eventlog (guildid, LogGuid, EventType, PlayerGuid1, PlayerGuid2, NewRank, TimeStamp) VALUES ";
+        for (auto itr = events.begin(); itr != events.end(); ++itr)
+        {
+            GuildEventLogEntry const& entry = *itr->second;
+            char const* sep = itr == events.begin() ? "" : ",";
+            del << sep << itr->first;
+            ins << sep << "('" << m_Id << "','" << itr->first << "','" << uint32(entry.EventType) << "','" << entry.PlayerGuid1 << "','"
+                << entry.PlayerGuid2 << "','" << uint32(entry.NewRank) << "','" << entry.TimeStamp << "')";
+        }
+        del << ")";
+        CharacterDatabase.Execute(del.str().c_str());
+        CharacterDatabase.Execute(ins.str().c_str());
+    }
+
+    for (auto const& tab : bankEvents)
+    {
+        std::ostringstream del, ins;
+        del << "DELETE FROM guild_bank_eventlog WHERE guildid='" << m_Id << "' AND TabId='" << tab.first << "' AND LogGuid IN (";
+        ins << "INSERT INTO guild_bank_eventlog (guildid,LogGuid,TabId,EventType,PlayerGuid,ItemOrMoney,ItemStackCount,DestTabId,TimeStamp) VALUES ";
+        for (auto itr = tab.second.begin(); itr != tab.second.end(); ++itr)
+        {
+            GuildBankEventLogEntry const& entry = *itr->second;
+            char const* sep = itr == tab.second.begin() ? "" : ",";
+            del << sep << itr->first;
+            ins << sep << "('" << m_Id << "','" << itr->first << "','" << tab.first << "','" << uint32(entry.EventType) << "','" << entry.PlayerGuid << "','"
+                << entry.ItemOrMoney << "','" << uint32(entry.ItemStackCount) << "','" << uint32(entry.DestTabId) << "','" << entry.TimeStamp << "')";
+        }
+        del << ")";
+        CharacterDatabase.Execute(del.str().c_str());
+        CharacterDatabase.Execute(ins.str().c_str());
+    }
+
+    m_pendingEventLog.clear();
+    m_pendingBankEventLog.clear();
 }
 
 // *************************************************
@@ -1392,6 +1482,7 @@ void Guild::SetBankMoneyPerDay(uint32 rankId, uint32 money)
         money = WITHDRAW_MONEY_UNLIMITED;
 
     m_Ranks[rankId].BankMoneyPerDay = money;
+    InvalidateRoster();
 
     for (auto& itr : members)
     {
@@ -1421,6 +1512,7 @@ void Guild::SetBankRightsAndSlots(uint32 rankId, uint8 TabId, uint32 right, uint
 
     m_Ranks[rankId].TabSlotPerDay[TabId] = nbSlots;
     m_Ranks[rankId].TabRight[TabId] = right;
+    InvalidateRoster();
 
     if (db)
     {
@@ -1536,7 +1628,7 @@ void Guild::LoadGuildBankEventLogFromDB()
             }
                 // add event to list
                 // events are ordered from oldest (in beginning) to latest (in the end)
-            m_GuildBankEventLog_Item[tabId].push_front(NewEvent);
+            m_GuildBankEventLog_Item[tabId].PushOldest(NewEvent);
 
             if (!isNextLogGuidSet)
             {
@@ -1580,7 +1672,7 @@ void Guild::LoadGuildBankEventLogFromDB()
         else
             // add event to list
             // events are ordered from oldest (in beginning) to latest (in the end)
-            m_GuildBankEventLog_Money.push_front(NewEvent);
+            m_GuildBankEventLog_Money.PushOldest(NewEvent);
     }
     while (result->NextRow());
     delete result;
@@ -1591,65 +1683,48 @@ void Guild::DisplayGuildBankLogs(WorldSession* session, uint8 TabId)
     if (TabId > GUILD_BANK_MAX_TABS)
         return;
 
-    if (TabId == GUILD_BANK_MAX_TABS)
+    BankLogCache& cache = m_bankLogCache[TabId];
+    if (!cache.packet)
     {
-        // Here we display money logs
-        WorldPacket data(MSG_GUILD_BANK_LOG_QUERY, m_GuildBankEventLog_Money.size() * (4 * 4 + 1) + 1 + 1);
-        data << uint8(TabId);                               // Here GUILD_BANK_MAX_TABS
-        data << uint8(m_GuildBankEventLog_Money.size());    // number of log entries
-        for (GuildBankEventLog::const_iterator itr = m_GuildBankEventLog_Money.begin(); itr != m_GuildBankEventLog_Money.end(); ++itr)
-        {
-            data << uint8(itr->EventType);
-            data << ObjectGuid(HIGHGUID_PLAYER, itr->PlayerGuid);
-            if (itr->EventType == GUILD_BANK_LOG_DEPOSIT_MONEY ||
-                    itr->EventType == GUILD_BANK_LOG_WITHDRAW_MONEY ||
-                    itr->EventType == GUILD_BANK_LOG_REPAIR_MONEY ||
-                    itr->EventType == GUILD_BANK_LOG_UNK1 ||
-                    itr->EventType == GUILD_BANK_LOG_UNK2)
-            {
-                data << uint32(itr->ItemOrMoney);
-            }
-            else
-            {
-                data << uint32(itr->ItemOrMoney);
-                data << uint32(itr->ItemStackCount);
-                if (itr->EventType == GUILD_BANK_LOG_MOVE_ITEM || itr->EventType == GUILD_BANK_LOG_MOVE_ITEM2)
-                    data << uint8(itr->DestTabId);          // moved tab
-            }
-            data << uint32(time(nullptr) - itr->TimeStamp);
-        }
-        session->SendPacket(data);
-    }
-    else
-    {
-        // here we display current tab logs
-        WorldPacket data(MSG_GUILD_BANK_LOG_QUERY, m_GuildBankEventLog_Item[TabId].size() * (4 * 4 + 1 + 1) + 1 + 1);
-        data << uint8(TabId);                               // Here a real Tab Id
-        // number of log entries
-        data << uint8(m_GuildBankEventLog_Item[TabId].size());
-        for (GuildBankEventLog::const_iterator itr = m_GuildBankEventLog_Item[TabId].begin(); itr != m_GuildBankEventLog_Item[TabId].end(); ++itr)
+        // Here we display money logs at GUILD_BANK_MAX_TABS, else the current tab logs
+        GuildBankEventLog const& log = TabId == GUILD_BANK_MAX_TABS ? m_GuildBankEventLog_Money : m_GuildBankEventLog_Item[TabId];
+
+        cache.packet.reset(new WorldPacket(MSG_GUILD_BANK_LOG_QUERY, log.size() * (4 * 4 + 1 + 1) + 1 + 1));
+        cache.timeStamps.clear();
+
+        WorldPacket& data = *cache.packet;
+        data << uint8(TabId);
+        data << uint8(log.size());                          // number of log entries
+        for (uint32 i = 0; i < log.size(); ++i)
         {
-            data << uint8(itr->EventType);
-            data << ObjectGuid(HIGHGUID_PLAYER, itr->PlayerGuid);
-            if (itr->EventType == GUILD_BANK_LOG_DEPOSIT_MONEY ||
-                    itr->EventType == GUILD_BANK_LOG_WITHDRAW_MONEY ||
-                    itr->EventType == GUILD_BANK_LOG_REPAIR_MONEY ||
-                    itr->EventType == GUILD_BANK_LOG_UNK1 ||
-                    itr->EventType == GUILD_BANK_LOG_UNK2)
+            GuildBankEventLogEntry const& entry = log[i];
+            data << uint8(entry.EventType);
+            data << ObjectGuid(HIGHGUID_PLAYER, entry.PlayerGuid);
+            if (entry.EventType == GUILD_BANK_LOG_DEPOSIT_MONEY ||
+                    entry.EventType == GUILD_BANK_LOG_WITHDRAW_MONEY ||
+                    entry.EventType == GUILD_BANK_LOG_REPAIR_MONEY ||
+                    entry.EventType == GUILD_BANK_LOG_UNK1 ||
+                    entry.EventType == GUILD_BANK_LOG_UNK2)
             {
-                data << uint32(itr->ItemOrMoney);
+                data << uint32(entry.ItemOrMoney);
             }
             else
             {
-                data << uint32(itr->ItemOrMoney);
-                data << uint32(itr->ItemStackCount);
-                if (itr->EventType == GUILD_BANK_LOG_MOVE_ITEM || itr->EventType == GUILD_BANK_LOG_MOVE_ITEM2)
-                    data << uint8(itr->DestTabId);          // moved tab
+                data << uint32(entry.ItemOrMoney);
+                data << uint32(entry.ItemStackCount);
+                if (entry.EventType == GUILD_BANK_LOG_MOVE_ITEM || entry.EventType == GUILD_BANK_LOG_MOVE_ITEM2)
+                    data << uint8(entry.DestTabId);         // moved tab
             }
-            data << uint32(time(nullptr) - itr->TimeStamp);
+            cache.timeStamps.push_back(std::make_pair(data.wpos(), entry.TimeStamp));
+            data << uint32(0);                              // seconds ago, set below
         }
-        session->SendPacket(data);
     }
+
+    WorldPacket data(*cache.packet);
+    time_t now = time(nullptr);
+    for (auto const& stamp : cache.timeStamps)
+        data.put<uint32>(stamp.first, uint32(now - stamp.second));
+    session->SendPacket(data);
     DEBUG_LOG("WORLD: Sent (MSG_GUILD_BANK_LOG_QUERY)");
 }
 
@@ -1672,26 +1747,21 @@ void Guild::LogBankEvent(uint8 EventType, uint8 TabId, uint32 PlayerGuidLow, uin
         m_GuildBankEventLogNextGuid_Money = (m_GuildBankEventLogNextGuid_Money + 1) % sWorld.getConfig(CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT);
         currentLogGuid = m_GuildBankEventLogNextGuid_Money;
         currentTabId = GUILD_BANK_MONEY_LOGS_TAB;
-        if (m_GuildBankEventLog_Money.size() >= GUILD_BANK_MAX_LOGS)
-            m_GuildBankEventLog_Money.pop_front();
-
-        m_GuildBankEventLog_Money.push_back(NewEvent);
+        m_GuildBankEventLog_Money.Push(NewEvent);
+        m_bankLogCache[GUILD_BANK_MAX_TABS].packet.reset();
     }
     else
     {
         m_GuildBankEventLogNextGuid_Item[TabId] = ((m_GuildBankEventLogNextGuid_Item[TabId]) + 1) % sWorld.getConfig(CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT);
         currentLogGuid = m_GuildBankEventLogNextGuid_Item[TabId];
-        if (m_GuildBankEventLog_Item[TabId].size() >= GUILD_BANK_MAX_LOGS)
-            m_GuildBankEventLog_Item[TabId].pop_front();
-
-        m_GuildBankEventLog_Item[TabId].push_back(NewEvent);
+        m_GuildBankEventLog_Item[TabId].Push(NewEvent);
+        m_bankLogCache[TabId].packet.reset();
     }
 
     // save event to database
-    CharacterDatabase.PExecute("DELETE FROM guild_bank_eventlog WHERE guildid='%u' AND LogGuid='%u' AND TabId='%u'", m_Id, currentLogGuid, currentTabId);
-
-    CharacterDatabase.PExecute("INSERT INTO guild_bank_eventlog (guildid,LogGuid,TabId,EventType,PlayerGuid,ItemOrMoney,ItemStackCount,DestTabId,TimeStamp) VALUES ('%u','%u','%u','%u','%u','%u','%u','%u','" UI64FMTD "')",
-                               m_Id, currentLogGuid, currentTabId, uint32(NewEvent.EventType), NewEvent.PlayerGuid, NewEvent.ItemOrMoney, uint32(NewEvent.ItemStackCount), uint32(NewEvent.DestTabId), NewEvent.TimeStamp);
+    m_pendingBankEventLog.push_back({ currentLogGuid, currentTabId, NewEvent });
+    if (!sWorld.getConfig(CONFIG_UINT32_GUILD_LOG_FLUSH_INTERVAL))
+        SaveLogs();
 }
 
 bool Guild::AddGBankItemToDB(uint32 GuildId, uint32 BankTab, uint32 BankTabSlot, uint32 GUIDLow, uint32 Entry) const
@@ -2423,17 +2493,22 @@ void Guild::MoveFromCharToBank(Player* pl, uint8 PlayerBag, uint8 PlayerSlot, ui
 
 ObjectGuid Guild::GetGuildInviter(ObjectGuid playerGuid) const
 {
-    for (auto const& itr : m_GuildEventLog)
+    for (uint32 i = 0; i < m_GuildEventLog.size(); ++i)
     {
-        if (itr.EventType == GUILD_EVENT_LOG_INVITE_PLAYER &&
-            itr.PlayerGuid2 == playerGuid)
-            return ObjectGuid(HIGHGUID_PLAYER, itr.PlayerGuid1);
+        GuildEventLogEntry const& entry = m_GuildEventLog[i];
+        if (entry.EventType == GUILD_EVENT_LOG_INVITE_PLAYER &&
+            entry.PlayerGuid2 == playerGuid)
+            return ObjectGuid(HIGHGUID_PLAYER, entry.PlayerGuid1);
     }
     return ObjectGuid();
 }
 
 void Guild::BroadcastEvent(GuildEvents event, ObjectGuid guid, char const* str1 /*=nullptr*/, char const* str2 /*=nullptr*/, char const* str3 /*=nullptr*/)
 {
+    // rank changes go through MemberSlot and are announced here; sign on/off is left to the roster cache expiry
+    if (event != GE_SIGNED_ON && event != GE_SIGNED_OFF)
+        InvalidateRoster();
+
     uint8 strCount = !str1 ? 0 : (!str2 ? 1 : (!str3 ? 2 : 3));
 
     WorldPacket data(SMSG_GUILD_EVENT, 1 + 1 + 1 * strCount + (!guid ? 0 : 8));
@@ -230,6 +230,45 @@ struct GuildBankEventLogEntry
     }
 };
 
+// Fixed capacity log, a new entry overwrites the oldest one once full. Index 0 is the oldest entry.
+template<class T, uint32 Capacity>
+class GuildLogRing
+{
+    public:
+        GuildLogRing() : m_start(0), m_size(0) {}
+
+        uint32 size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        T const& operator[](uint32 index) const { return m_entries[(m_start + index) % Capacity]; }
+
+        void Push(T const& entry)
+        {
+            if (m_size < Capacity)
+                m_entries[(m_start + m_size++) % Capacity] = entry;
+            else
+            {
+                m_entries[m_start] = entry;
+                m_start = (m_start + 1) % Capacity;
+            }
+        }
+
+        // loading only, rows come newest first
+        void PushOldest(T const& entry)
+        {
+            if (m_size == Capacity)
+                return;
+
+            m_start = (m_start + Capacity - 1) % Capacity;
+            m_entries[m_start] = entry;
+            ++m_size;
+        }
+
+    private:
+        T m_entries[Capacity];
+        uint32 m_start;
+        uint32 m_size;
+};
+
 struct GuildBankTab
 {
     GuildBankTab() { memset(Slots, 0, GUILD_BANK_MAX_SLOTS * sizeof(Item*)); }
@@ -397,12 +436,16 @@ class Guild
         }
 
         void Roster(WorldSession* session = nullptr);          // nullptr = broadcast
+        // drop the cached roster packets, needed after any change of members, ranks, notes or motd
+        void InvalidateRoster();
         void Query(WorldSession* session);
 
         // Guild EventLog
         void   LoadGuildEventLogFromDB();
         void   DisplayGuildEventLog(WorldSession* session);
         void   LogGuildEvent(uint8 EventType, ObjectGuid playerGuid1, ObjectGuid playerGuid2 = ObjectGuid(), uint8 newRank = 0);
+        // writes the event and bank log entries logged since the last call, see Guild.LogFlushInterval
+        void   SaveLogs();
         ObjectGuid GetGuildInviter(ObjectGuid playerGuid) const;
 
         // ** Guild bank **
@@ -470,21 +513,49 @@ class Guild
         typedef std::vector<GuildBankTab*> TabListMap;
         TabListMap m_TabListMap;
 
-        /** These are actually ordered lists. The first element is the oldest entry.*/
-        typedef std::list<GuildEventLogEntry> GuildEventLog;
-        typedef std::list<GuildBankEventLogEntry> GuildBankEventLog;
+        typedef GuildLogRing<GuildEventLogEntry, GUILD_EVENTLOG_MAX_RECORDS> GuildEventLog;
+        typedef GuildLogRing<GuildBankEventLogEntry, GUILD_BANK_MAX_LOGS> GuildBankEventLog;
         GuildEventLog m_GuildEventLog;
         GuildBankEventLog m_GuildBankEventLog_Money;
         GuildBankEventLog m_GuildBankEventLog_Item[GUILD_BANK_MAX_TABS];
 
+        // logged but not yet written entries, with the LogGuid they replace in the db
+        struct PendingEventLog
+        {
+            uint32 logGuid;
+            GuildEventLogEntry entry;
+        };
+        struct PendingBankEventLog
+        {
+            uint32 logGuid;
+            uint32 tabId;                                   // GUILD_BANK_MONEY_LOGS_TAB for money
+            GuildBankEventLogEntry entry;
+        };
+        std::vector<PendingEventLog> m_pendingEventLog;
+        std::vector<PendingBankEventLog> m_pendingBankEventLog;
+
+        // MSG_GUILD_BANK_LOG_QUERY as last built per tab, money log at GUILD_BANK_MAX_TABS.
+        // Only the "seconds ago" fields are rewritten when sent again, any new entry drops it.
+        struct BankLogCache
+        {
+            std::unique_ptr<WorldPacket> packet;
+            std::vector<std::pair<size_t, uint64> > timeStamps;     // position in packet, entry TimeStamp
+        };
+        BankLogCache m_bankLogCache[GUILD_BANK_MAX_TABS + 1];
+
         uint32 m_GuildEventLogNextGuid;
         uint32 m_GuildBankEventLogNextGuid_Money;
         uint32 m_GuildBankEventLogNextGuid_Item[GUILD_BANK_MAX_TABS];
 
         uint64 m_GuildBankMoney;
 
+        // SMSG_GUILD_ROSTER as last built, without and with officer notes, reused up to Guild.RosterCacheTime
+        std::shared_ptr<WorldPacket const> m_rosterCache[2];
+        time_t m_rosterCacheTime[2];
+
     private:
         void UpdateAccountsNumber() { m_accountsNumber = 0;}// mark for lazy calculation at request in GetAccountsNumber
+        std::shared_ptr<WorldPacket const> BuildRosterPacket(bool withOfficerNotes) const;
 
         // used only from high level Swap/Move functions
         Item*  GetItem(uint8 TabId, uint8 SlotId);
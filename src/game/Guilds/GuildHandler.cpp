@@ -552,6 +552,7 @@ void WorldSession::HandleGuildSetPublicNoteOpcode(WorldPacket& recvPacket)
     recvPacket >> PNOTE;
 
     slot->SetPNOTE(PNOTE);
+    guild->InvalidateRoster();
 
     guild->Roster(this);
 }
@@ -589,6 +590,7 @@ void WorldSession::HandleGuildSetOfficerNoteOpcode(WorldPacket& recvPacket)
     recvPacket >> OFFNOTE;
 
     slot->SetOFFNOTE(OFFNOTE);
+    guild->InvalidateRoster();
 
     guild->Roster(this);
 }
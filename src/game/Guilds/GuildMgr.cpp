@@ -83,6 +83,12 @@ std::string GuildMgr::GetGuildNameById(uint32 guildId) const
     return "";
 }
 
+void GuildMgr::SaveGuildLogs()
+{
+    for (auto& itr : m_GuildMap)
+        itr.second->SaveLogs();
+}
+
 void GuildMgr::LoadGuilds()
 {
     uint32 count = 0;
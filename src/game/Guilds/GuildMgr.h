@@ -42,6 +42,8 @@ class GuildMgr
         std::string GetGuildNameById(uint32 guildId) const;
 
         void LoadGuilds();
+        // writes the pending event and bank logs of every guild
+        void SaveGuildLogs();
 };
 
 #define sGuildMgr MaNGOS::Singleton<GuildMgr>::Instance()
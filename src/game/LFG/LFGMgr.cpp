@@ -260,13 +260,13 @@ void LFGMgr::FinishDungeon(Group* group, uint32 dungeonId, Map const* currMap)
     uint32 gDungeonId = groupLfgData.GetDungeon();
     if (gDungeonId != dungeonId)
     {
-        sLog.outDebug("Group %s finished dungeon %u but queued for %u", group->GetObjectGuid().GetString().c_str(), dungeonId, gDungeonId);
+        DEBUG_LOG("Group %s finished dungeon %u but queued for %u", group->GetObjectGuid().GetString().c_str(), dungeonId, gDungeonId);
         return;
     }
 
     if (groupLfgData.GetState() == LFG_STATE_FINISHED_DUNGEON) // Shouldn't happen. Do not reward multiple times
     {
-        sLog.outDebug("Group: %s already rewarded", group->GetObjectGuid().GetString().c_str());
+        DEBUG_LOG("Group: %s already rewarded", group->GetObjectGuid().GetString().c_str());
         return;
     }
 
@@ -279,7 +279,7 @@ void LFGMgr::FinishDungeon(Group* group, uint32 dungeonId, Map const* currMap)
         LFGData& playerLfgData = player->GetLfgData();
         if (playerLfgData.GetState() == LFG_STATE_FINISHED_DUNGEON)
         {
-            sLog.outDebug("Group: %s, Player: %s already rewarded", group->GetObjectGuid().GetString().c_str(), guid.GetString().c_str());
+            DEBUG_LOG("Group: %s, Player: %s already rewarded", group->GetObjectGuid().GetString().c_str(), guid.GetString().c_str());
             continue;
         }
 
@@ -292,13 +292,13 @@ void LFGMgr::FinishDungeon(Group* group, uint32 dungeonId, Map const* currMap)
 
         if (!dungeon || (dungeon->type != LFG_TYPE_RANDOM_DUNGEON && !dungeon->seasonal))
         {
-            sLog.outDebug("Group: %s, Player: %s dungeon %u is not random or seasonal", group->GetObjectGuid().GetString().c_str(), guid.GetString().c_str(), rDungeonId);
+            DEBUG_LOG("Group: %s, Player: %s dungeon %u is not random or seasonal", group->GetObjectGuid().GetString().c_str(), guid.GetString().c_str(), rDungeonId);
             continue;
         }
 
         if (player->GetMap() != currMap)
         {
-            sLog.outDebug("Group: %s, Player: %s is in a different map", group->GetObjectGuid().GetString().c_str(), guid.GetString().c_str());
+            DEBUG_LOG("Group: %s, Player: %s is in a different map", group->GetObjectGuid().GetString().c_str(), guid.GetString().c_str());
             continue;
         }
 
@@ -309,7 +309,7 @@ void LFGMgr::FinishDungeon(Group* group, uint32 dungeonId, Map const* currMap)
 
         if (player->GetMapId() != mapId)
         {
-            sLog.outDebug("Group: %s, Player: %s is in map %u and should be in %u to get reward", group->GetObjectGuid().GetString().c_str(), guid.GetString().c_str(), player->GetMapId(), mapId);
+            DEBUG_LOG("Group: %s, Player: %s is in map %u and should be in %u to get reward", group->GetObjectGuid().GetString().c_str(), guid.GetString().c_str(), player->GetMapId(), mapId);
             continue;
         }
 
@@ -347,7 +347,7 @@ void LFGMgr::FinishDungeon(Group* group, uint32 dungeonId, Map const* currMap)
         }
 
         // Give rewards
-        sLog.outDebug("Group: %s, Player: %s done dungeon %u, %s previously done.", group->GetObjectGuid().GetString().c_str(), guid.GetString().c_str(), gDungeonId, done ? " " : " not");
+        DEBUG_LOG("Group: %s, Player: %s done dungeon %u, %s previously done.", group->GetObjectGuid().GetString().c_str(), guid.GetString().c_str(), gDungeonId, done ? " " : " not");
         LfgPlayerRewardData data = LfgPlayerRewardData(dungeon->Entry(), dungeonDone->Entry(), done, quest);
         player->GetSession()->SendLfgPlayerReward(data);
     }
@@ -765,6 +765,7 @@ void LFGMgr::JoinLfg(Player* player, uint8 roles, LfgDungeonSet& dungeons, std::
         }
         queueData.m_playerInfoPerGuid[player->GetObjectGuid()].m_roles = roles;
         queueData.m_raid = false;
+        queueData.m_team = player->GetTeam();
         // cross node broadcasts
         WorldPacket data = WorldSession::BuildLfgUpdate(LfgUpdateData(LFG_UPDATETYPE_JOIN_QUEUE, dungeons, comment), true);
         grp->BroadcastPacket(data, false);
@@ -783,6 +784,7 @@ void LFGMgr::JoinLfg(Player* player, uint8 roles, LfgDungeonSet& dungeons, std::
         queueData.m_playerInfoPerGuid[player->GetObjectGuid()].m_roles = roles;
         queueData.m_playerInfoPerGuid[player->GetObjectGuid()].m_level = player->GetLevel();
         queueData.m_raid = false;
+        queueData.m_team = player->GetTeam();
 
         player->GetLfgData().SetState(LFG_STATE_QUEUED);
     }
@@ -953,14 +955,14 @@ void LFGMgr::TeleportPlayer(Player* player, bool out, bool fromOpcode /*= false*
 
     if (!dungeon)
     {
-        sLog.outDebug("Player %s not in group/lfggroup or dungeon not found!", player->GetName());
+        DEBUG_LOG("Player %s not in group/lfggroup or dungeon not found!", player->GetName());
         player->GetSession()->SendLfgTeleportError(uint8(LFG_TELEPORTERROR_INVALID_LOCATION));
         return;
     }
 
     if (out)
     {
-        sLog.outDebug("Player %s is being teleported out. Current Map %u - Expected Map %u", player->GetName(), player->GetMapId(), uint32(dungeon->map));
+        DEBUG_LOG("Player %s is being teleported out. Current Map %u - Expected Map %u", player->GetName(), player->GetMapId(), uint32(dungeon->map));
         if (player->GetMapId() == uint32(dungeon->map))
             player->TeleportToBGEntryPoint();
 
@@ -1021,5 +1023,5 @@ void LFGMgr::TeleportPlayer(Player* player, bool out, bool fromOpcode /*= false*
     if (error != LFG_TELEPORTERROR_OK)
         player->GetSession()->SendLfgTeleportError(uint8(error));
 
-    sLog.outDebug("Player %s is being teleported in to map %u (x: %f, y: %f, z: %f) Result: %u", player->GetName(), dungeon->map, dungeon->x, dungeon->y, dungeon->z, error);
+    DEBUG_LOG("Player %s is being teleported in to map %u (x: %f, y: %f, z: %f) Result: %u", player->GetName(), dungeon->map, dungeon->x, dungeon->y, dungeon->z, error);
 }
@@ -20,17 +20,27 @@
 #include "LFG/LFGMgr.h"
 #include "World/World.h"
 
+#ifdef BUILD_METRICS
+ #include "Metric/Metric.h"
+#endif
+
 void LFGQueue::AddToQueue(LFGQueueData const& data)
 {
     auto result = m_queueData.emplace(data.m_ownerGuid, data);
     LFGQueueData& queueData = result.first->second;
     if (data.m_roleCheckState == LFG_ROLECHECK_INITIALITING)
         queueData.UpdateRoleCheck(queueData.m_leaderGuid, queueData.m_playerInfoPerGuid[queueData.m_leaderGuid].m_roles, false, false);
+    AddToBuckets(queueData);
 }
 
 void LFGQueue::RemoveFromQueue(ObjectGuid owner)
 {
-    m_queueData.erase(owner);
+    auto itr = m_queueData.find(owner);
+    if (itr == m_queueData.end())
+        return;
+
+    RemoveFromBuckets(itr->second);
+    m_queueData.erase(itr);
 }
 
 void LFGQueue::SetPlayerRoles(ObjectGuid group, ObjectGuid player, uint8 roles)
@@ -41,6 +51,8 @@ void LFGQueue::SetPlayerRoles(ObjectGuid group, ObjectGuid player, uint8 roles)
         itr->second.UpdateRoleCheck(player, roles, false, false);
         if (itr->second.GetState() == LFG_STATE_FAILED)
             m_queueData.erase(itr);
+        else
+            AddToBuckets(itr->second);
     }
 }
 
@@ -95,10 +107,166 @@ void LFGQueue::OnPlayerLogout(ObjectGuid guid, ObjectGuid groupGuid)
                 world->BroadcastPersonalized(personalizedPackets);
             });
         }
+        RemoveFromBuckets(data);
         m_queueData.erase(itr);
     }
 }
 
+void LFGQueue::AddToBuckets(LFGQueueData const& data)
+{
+    // premade groups bring their own composition and are not split up
+    if (data.GetState() != LFG_STATE_QUEUED || data.m_raid || data.m_playerInfoPerGuid.size() != 1)
+        return;
+
+    uint8 roles = data.m_playerInfoPerGuid.begin()->second.m_roles;
+    auto entry = std::make_pair(data.GetJoinTime(), data.m_ownerGuid);
+    for (uint32 dungeonId : data.m_dungeons)
+    {
+        LfgBucketKey key(dungeonId, data.m_team);
+        LfgRoleBuckets& buckets = m_buckets[key];
+        uint32 i = PLAYER_ROLE_TANK;
+        for (uint32 k = 0; i <= PLAYER_ROLE_DAMAGE; i = i << 1, ++k)
+            if ((i & roles) != 0)
+                buckets.m_roles[k].insert(entry);
+        m_changedBuckets.insert(key);
+    }
+}
+
+void LFGQueue::RemoveFromBuckets(LFGQueueData const& data)
+{
+    if (data.m_raid || data.m_playerInfoPerGuid.size() != 1)
+        return;
+
+    auto entry = std::make_pair(data.GetJoinTime(), data.m_ownerGuid);
+    for (uint32 dungeonId : data.m_dungeons)
+    {
+        auto itr = m_buckets.find(LfgBucketKey(dungeonId, data.m_team));
+        if (itr == m_buckets.end())
+            continue;
+
+        bool empty = true;
+        for (LfgRoleBuckets::Bucket& bucket : itr->second.m_roles)
+        {
+            bucket.erase(entry);
+            empty = empty && bucket.empty();
+        }
+
+        if (empty)
+        {
+            m_changedBuckets.erase(itr->first);
+            m_buckets.erase(itr);
+        }
+    }
+}
+
+void LFGQueue::MatchBuckets(uint32& counter)
+{
+    // matching removes the picked players from every bucket, copy the keys first
+    std::vector<LfgBucketKey> changed(m_changedBuckets.begin(), m_changedBuckets.end());
+    m_changedBuckets.clear();
+
+    for (LfgBucketKey const& key : changed)
+    {
+        auto itr = m_buckets.find(key);
+        while (itr != m_buckets.end() && MatchDungeon(key, itr->second, counter))
+        {
+            ++counter;
+            itr = m_buckets.find(key);
+        }
+    }
+}
+
+bool LFGQueue::MatchDungeon(LfgBucketKey const& key, LfgRoleBuckets const& buckets, uint32 proposalId)
+{
+    LfgRoleBuckets::Bucket const& tanks = buckets.m_roles[ROLE_INDEX_TANK];
+    LfgRoleBuckets::Bucket const& healers = buckets.m_roles[ROLE_INDEX_HEALER];
+    LfgRoleBuckets::Bucket const& damage = buckets.m_roles[ROLE_INDEX_DPS];
+    if (tanks.empty() || healers.empty() || damage.size() < LFG_DPS_NEEDED)
+        return false;
+
+    // a player offering several roles sits in several buckets, so the heads can overlap.
+    // Looking at the first two tanks covers a head tank who is also the only healer.
+    ObjectGuid picked[LFG_TANKS_NEEDED + LFG_HEALERS_NEEDED + LFG_DPS_NEEDED];
+    uint8 pickedRoles[LFG_TANKS_NEEDED + LFG_HEALERS_NEEDED + LFG_DPS_NEEDED];
+    uint32 count = 0;
+    auto isPicked = [&](ObjectGuid guid) { return std::find(picked, picked + count, guid) != picked + count; };
+
+    auto tankItr = tanks.begin();
+    for (uint32 tries = 0; tankItr != tanks.end() && tries < 2 && count < 2; ++tankItr, ++tries)
+    {
+        count = 0;
+        picked[count] = tankItr->second;
+        pickedRoles[count++] = PLAYER_ROLE_TANK;
+        for (auto& healer : healers)
+        {
+            if (!isPicked(healer.second))
+            {
+                picked[count] = healer.second;
+                pickedRoles[count++] = PLAYER_ROLE_HEALER;
+                break;
+            }
+        }
+    }
+
+    if (count < 2)
+        return false;
+
+    for (auto& dps : damage)
+    {
+        if (count == LFG_TANKS_NEEDED + LFG_HEALERS_NEEDED + LFG_DPS_NEEDED)
+            break;
+        if (!isPicked(dps.second))
+        {
+            picked[count] = dps.second;
+            pickedRoles[count++] = PLAYER_ROLE_DAMAGE;
+        }
+    }
+
+    if (count < LFG_TANKS_NEEDED + LFG_HEALERS_NEEDED + LFG_DPS_NEEDED)
+        return false;
+
+    LfgProposal proposal(key.first);
+    proposal.id = proposalId;
+    proposal.state = LFG_PROPOSAL_INITIATING;
+    proposal.cancelTime = sWorld.GetCurrentClockTime() + std::chrono::seconds(LFG_TIME_ROLECHECK);
+    proposal.leader = picked[0];
+    bool leaderFound = false;
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        LFGQueueData& queueData = m_queueData[picked[i]];
+        RemoveFromBuckets(queueData);
+        queueData.SetState(LFG_STATE_PROPOSAL);
+
+        // first one willing to lead, else the tank
+        if (!leaderFound && (queueData.m_playerInfoPerGuid.begin()->second.m_roles & PLAYER_ROLE_LEADER))
+        {
+            proposal.leader = picked[i];
+            leaderFound = true;
+        }
+
+        proposal.queues.push_back(picked[i]);
+        proposal.players[picked[i]] = LfgProposalPlayer(pickedRoles[i], LFG_ANSWER_PENDING, ObjectGuid(), queueData.m_randomDungeonId);
+    }
+
+    std::map<ObjectGuid, std::vector<WorldPacket>> personalizedPackets;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        LFGQueueData const& queueData = m_queueData[picked[i]];
+        std::vector<WorldPacket>& packets = personalizedPackets[picked[i]];
+        packets.emplace_back(WorldSession::BuildLfgUpdate(LfgUpdateData(LFG_UPDATETYPE_PROPOSAL_BEGIN, queueData.GetDungeons(), ""), false));
+        packets.emplace_back(WorldSession::BuildLfgUpdateProposal(proposal, queueData.m_randomDungeonId, picked[i]));
+    }
+
+    m_proposals[proposal.id] = proposal;
+
+    sWorld.GetMessager().AddMessage([personalizedPackets](World* world)
+    {
+        world->BroadcastPersonalized(personalizedPackets);
+    });
+    return true;
+}
+
 void LFGQueue::Update()
 {
     uint32 counter = 1;
@@ -128,6 +296,7 @@ void LFGQueue::Update()
                 {
                     LfgProposal proposal;
                     proposal.id = counter++;
+                    RemoveFromBuckets(queueData);
                     queueData.PopQueue(proposal);
                     m_proposals[proposal.id] = proposal;
                 }
@@ -135,7 +304,11 @@ void LFGQueue::Update()
         }
         else
         {
-            // no actual matchmaking for now - enable entering for full groups - TODO: matchmaking
+#ifdef BUILD_METRICS
+            static metric::histogram& matchHistogram = metric::aggregates::instance().register_histogram("lfg.match.tick");
+            metric::timer<> matchTimer(matchHistogram);
+#endif
+            // full premade groups only need to accept
             for (auto& queuedGroupData : m_queueData)
             {
                 LFGQueueData& queueData = queuedGroupData.second;
@@ -148,6 +321,8 @@ void LFGQueue::Update()
                     m_proposals[proposal.id] = proposal;
                 }
             }
+
+            MatchBuckets(counter);
         }
 
         for (auto& proposalData : m_proposals)
@@ -156,7 +331,10 @@ void LFGQueue::Update()
         for (auto itr = m_queueData.begin(); itr != m_queueData.end();)
         {
             if (itr->second.GetState() == LFG_STATE_FAILED)
+            {
+                RemoveFromBuckets(itr->second);
                 itr = m_queueData.erase(itr);
+            }
             else
                 ++itr;
         }
@@ -393,6 +571,7 @@ void LfgProposal::FailProposal(LFGQueue& queue)
         {
             // continue being queued - did nothing wrong
             queueData.SetState(LFG_STATE_QUEUED);
+            queue.AddToBuckets(queueData);
         }
     }
 
@@ -107,6 +107,16 @@ struct LFGQueueData
     TimePoint GetJoinTime() const { return m_joinTime; }
 };
 
+typedef std::pair<uint32, uint32> LfgBucketKey; // dungeon id, team
+
+// queued solo players who can fill a role in one dungeon, oldest first
+struct LfgRoleBuckets
+{
+    typedef std::set<std::pair<TimePoint, ObjectGuid>> Bucket;
+
+    Bucket m_roles[ROLE_INDEX_COUNT];
+};
+
 /*
  * intended to live in its own thread - must not access anything from the outside that is mutable
  * prototyping for being able to separate certain processes from world thread context entirely
@@ -122,6 +132,10 @@ class LFGQueue
 
         void OnPlayerLogout(ObjectGuid guid, ObjectGuid groupGuid);
 
+        // solo players are matched from the role buckets of each dungeon they queued for
+        void AddToBuckets(LFGQueueData const& data);
+        void RemoveFromBuckets(LFGQueueData const& data);
+
         LFGQueueData& GetQueueData(ObjectGuid owner) { return m_queueData[owner]; }
 
         void Update();
@@ -141,9 +155,13 @@ class LFGQueue
         void UpdateWaitTimeTank(int32 time, uint32 dungeonId);
         void UpdateWaitTimeAvg(int32 time, uint32 dungeonId);
     private:
+        void MatchBuckets(uint32& counter);
+        bool MatchDungeon(LfgBucketKey const& key, LfgRoleBuckets const& buckets, uint32 proposalId);
 
         std::map<ObjectGuid, LFGQueueData> m_queueData;
-        std::vector<LFGQueueData*> m_sortedQueue; // sorted by time
+
+        std::map<LfgBucketKey, LfgRoleBuckets> m_buckets;
+        std::set<LfgBucketKey> m_changedBuckets; // only buckets with new players can form a new group
 
         Messager<LFGQueue> m_messager;
 
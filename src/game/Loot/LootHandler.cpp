@@ -57,7 +57,7 @@ void WorldSession::HandleAutostoreLootItemOpcode(WorldPacket& recv_data)
     // item may be blocked by roll system or already looted or another cheating possibility
     if (lootItem->isBlocked || lootItem->GetSlotTypeForSharedLoot(_player, loot) == MAX_LOOT_SLOT_TYPE)
     {
-        sLog.outDebug("HandleAutostoreLootItemOpcode> %s have no right to loot itemId(%u)", _player->GetGuidStr().c_str(), lootItem->itemId);
+        DEBUG_LOG("HandleAutostoreLootItemOpcode> %s have no right to loot itemId(%u)", _player->GetGuidStr().c_str(), lootItem->itemId);
         loot->SendReleaseFor(_player);
         return;
     }
@@ -268,7 +268,7 @@ void WorldSession::HandleLootRoll(WorldPacket& recv_data)
     recv_data >> itemSlot;
     recv_data >> rollType;
 
-    sLog.outDebug("WORLD RECIEVE CMSG_LOOT_ROLL, From:%s, rollType:%u", lootedTarget.GetString().c_str(), uint32(rollType));
+    DEBUG_LOG("WORLD RECIEVE CMSG_LOOT_ROLL, From:%s, rollType:%u", lootedTarget.GetString().c_str(), uint32(rollType));
 
     Group* group = _player->GetGroup();
     if (!group)
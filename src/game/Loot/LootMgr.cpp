@@ -31,6 +31,9 @@
 #include "BattleGround/BattleGroundMgr.h"
 #include <sstream>
 #include <iomanip>
+#include <numeric>
+#include <atomic>
+#include <thread>
 
 INSTANTIATE_SINGLETON_1(LootMgr);
 
@@ -71,11 +74,19 @@ class LootTemplate::LootGroup                               // A set of loot def
 
         void Verify(LootStore const& lootstore, uint32 id, uint32 group_id) const;
         void CheckLootRefs(LootIdSet* ref_set) const;
+        void Compile();                                     // Builds the sampling tables (at loading stage, after all entries are added)
     private:
         LootStoreItemList ExplicitlyChanced;                // Entries with chances defined in DB
         LootStoreItemList EqualChanced;                     // Zero chances - every entry takes the same chance
 
+        bool ExplicitlyConditioned = false;                 // Some ExplicitlyChanced entries have a condition
+        // Alias table over ExplicitlyChanced and a last outcome for missing them all, empty if their chances exceed 100%
+        std::vector<float> AliasChance;
+        std::vector<uint32> Alias;
+
         LootStoreItem const* Roll(Loot const& loot, Player const* lootOwner) const; // Rolls an item from the group, returns NULL if all miss their chances
+        LootStoreItem const* RollExplicitlyChanced(Loot const& loot, Player const* lootOwner) const;
+        LootStoreItem const* RollEqualChanced(Loot const& loot, Player const* lootOwner) const;
 };
 
 // Remove all data and free all memory
@@ -86,6 +97,23 @@ void LootStore::Clear()
     m_LootTemplates.clear();
 }
 
+void LootStore::ClearStaged()
+{
+    for (LootTemplateMap::const_iterator itr = m_StagedTemplates.begin(); itr != m_StagedTemplates.end(); ++itr)
+        delete itr->second;
+    m_StagedTemplates.clear();
+}
+
+void LootStore::PublishStaged()
+{
+    if (!m_staging)
+        return;
+
+    m_LootTemplates.swap(m_StagedTemplates);
+    m_staging = false;
+    ClearStaged();                                          // the previous templates
+}
+
 // Checks validity of the loot store
 // Actual checks are done within LootTemplate::Verify() which is called for every template
 void LootStore::Verify() const
@@ -98,18 +126,24 @@ void LootStore::Verify() const
 // All checks of the loaded template are called from here, no error reports at loot generation required
 void LootStore::LoadLootTable()
 {
+    LootTemplateMap& templates = GetLoadTarget();
     LootTemplateMap::const_iterator tab;
     uint32 count = 0;
 
     // Clearing store (for reloading case)
-    Clear();
+    if (m_staging)
+        ClearStaged();
+    else
+        Clear();
 
     //                                                 0      1     2                    3        4              5         6
-    QueryResult* result = WorldDatabase.PQuery("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
+    QueryResult* result = WorldDatabase.PQueryStreamed("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
 
     if (result)
     {
-        BarGoLink bar(result->GetRowCount());
+        // streamed results do not know their size up front
+        std::unique_ptr<QueryResult> countResult(WorldDatabase.PQuery("SELECT COUNT(*) FROM %s", GetName()));
+        BarGoLink bar(countResult ? countResult->Fetch()[0].GetUInt64() : 0);
 
         do
         {
@@ -153,13 +187,13 @@ void LootStore::LoadLootTable()
 
             // Looking for the template of the entry
             // often entries are put together
-            if (m_LootTemplates.empty() || tab->first != entry)
+            if (templates.empty() || tab->first != entry)
             {
                 // Searching the template (in case template Id changed)
-                tab = m_LootTemplates.find(entry);
-                if (tab == m_LootTemplates.end())
+                tab = templates.find(entry);
+                if (tab == templates.end())
                 {
-                    std::pair< LootTemplateMap::iterator, bool > pr = m_LootTemplates.insert(LootTemplateMap::value_type(entry, new LootTemplate));
+                    std::pair< LootTemplateMap::iterator, bool > pr = templates.insert(LootTemplateMap::value_type(entry, new LootTemplate));
                     tab = pr.first;
                 }
             }
@@ -174,9 +208,13 @@ void LootStore::LoadLootTable()
 
         delete result;
 
-        Verify();                                           // Checks validity of the loot store
+        for (auto const& itr : templates)                   // Checks validity of the loot store
+            itr.second->Verify(*this, itr.first);
+
+        for (auto& itr : templates)
+            itr.second->Compile();
 
-        sLog.outString(">> Loaded %u loot definitions (" SIZEFMTD " templates) from table %s", count, m_LootTemplates.size(), GetName());
+        sLog.outString(">> Loaded %u loot definitions (" SIZEFMTD " templates) from table %s", count, templates.size(), GetName());
         sLog.outString();
     }
     else
@@ -220,7 +258,8 @@ void LootStore::LoadAndCollectLootIds(LootIdSet& ids_set)
 {
     LoadLootTable();
 
-    for (LootTemplateMap::const_iterator tab = m_LootTemplates.begin(); tab != m_LootTemplates.end(); ++tab)
+    LootTemplateMap const& templates = GetLoadTarget();
+    for (LootTemplateMap::const_iterator tab = templates.begin(); tab != templates.end(); ++tab)
         ids_set.insert(tab->first);
 }
 
@@ -362,8 +401,8 @@ LootItem::LootItem(LootStoreItem const& li, uint32 _lootSlot, uint32 threshold)
     conditionId       = li.conditionId;
     lootSlot          = _lootSlot;
     count             = urand(li.mincountOrRef, li.maxcount);     // constructor called for mincountOrRef > 0 only
-    randomSuffix      = GenerateEnchSuffixFactor(itemId);
-    randomPropertyId  = Item::GenerateItemRandomPropertyId(itemId);
+    randomSuffix      = GenerateEnchSuffixFactor(itemProto);
+    randomPropertyId  = Item::GenerateItemRandomPropertyId(itemProto);
     isBlocked         = false;
     currentLooterPass = false;
     isReleased        = false;
@@ -565,7 +604,7 @@ void GroupLootRoll::SendStartRoll()
     size_t voteMaskPos = data.wpos();
     data << uint8(0);                                       // roll type mask, allowed choices (placeholder)
 
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
+    for (RollVoteList::const_iterator itr = m_rollVotes.begin(); itr != m_rollVotes.end(); ++itr)
     {
         if (itr->second.vote == ROLL_NOT_VALID)
             continue;
@@ -594,7 +633,7 @@ void GroupLootRoll::SendAllPassed()
     data << uint32(m_lootItem->randomSuffix);               // randomSuffix
     data << uint32(m_lootItem->randomPropertyId);           // item random property ID
 
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
+    for (RollVoteList::const_iterator itr = m_rollVotes.begin(); itr != m_rollVotes.end(); ++itr)
     {
         if (itr->second.vote == ROLL_NOT_VALID)
             continue;
@@ -620,7 +659,7 @@ void GroupLootRoll::SendLootRollWon(ObjectGuid const& targetGuid, uint32 rollNum
     data << uint8(rollNumber);                              // rollnumber related to SMSG_LOOT_ROLL
     data << uint8(rollType);                                // Rolltype related to SMSG_LOOT_ROLL
 
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
+    for (RollVoteList::const_iterator itr = m_rollVotes.begin(); itr != m_rollVotes.end(); ++itr)
     {
         switch (itr->second.vote)
         {
@@ -639,7 +678,7 @@ void GroupLootRoll::SendLootRollWon(ObjectGuid const& targetGuid, uint32 rollNum
         }
     }
 
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
+    for (RollVoteList::const_iterator itr = m_rollVotes.begin(); itr != m_rollVotes.end(); ++itr)
     {
         if (itr->second.vote == ROLL_NOT_VALID)
             continue;
@@ -665,7 +704,7 @@ void GroupLootRoll::SendRoll(ObjectGuid const& targetGuid, uint32 rollNumber, ui
     data << uint8(rollType);                                // 0: "Need for: [item name]" 0: "You have selected need for [item name] 1: need roll 2: greed roll
     data << uint8(0);                                       // auto pass on loot
 
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
+    for (RollVoteList::const_iterator itr = m_rollVotes.begin(); itr != m_rollVotes.end(); ++itr)
     {
         if (itr->second.vote == ROLL_NOT_VALID)
             continue;
@@ -704,15 +743,17 @@ bool GroupLootRoll::TryToStart(Loot& loot, uint32 itemSlot)
         m_lootItem->isBlocked = true;                           // block the item while rolling
 
         uint32 playerCount = 0;
+        m_rollVotes.reserve(m_loot->m_ownerSet.size());
         for (auto itr : m_loot->m_ownerSet)
         {
+            m_rollVotes.emplace_back(itr, PlayerRollVote());
             Player* plr = sObjectMgr.GetPlayer(itr);
             if (!plr || !m_lootItem->IsAllowed(plr, m_loot))    // check if player meet the condition to be able to roll this item
             {
-                m_rollVoteMap[itr].vote = ROLL_NOT_VALID;
+                m_rollVotes.back().second.vote = ROLL_NOT_VALID;
                 continue;
             }
-            m_rollVoteMap[itr].vote = ROLL_NOT_EMITED_YET;      // initialize player vote map
+            m_rollVotes.back().second.vote = ROLL_NOT_EMITED_YET; // initialize player vote list
             ++playerCount;
         }
 
@@ -728,6 +769,7 @@ bool GroupLootRoll::TryToStart(Loot& loot, uint32 itemSlot)
             // start the roll
             SendStartRoll();
             m_endTime = time(nullptr) + (LOOT_ROLL_TIMEOUT / 1000);
+            m_notVotedCount = playerCount;
             m_isStarted = true;
             return true;
         }
@@ -742,10 +784,16 @@ bool GroupLootRoll::TryToStart(Loot& loot, uint32 itemSlot)
 bool GroupLootRoll::PlayerVote(Player* player, RollVote vote)
 {
     ObjectGuid const& playerGuid = player->GetObjectGuid();
-    RollVoteMap::iterator voterItr = m_rollVoteMap.find(playerGuid);
-    if (voterItr == m_rollVoteMap.end())
+    RollVoteList::iterator voterItr = std::find_if(m_rollVotes.begin(), m_rollVotes.end(), [&playerGuid](RollVoteList::value_type const& voter)
+    {
+        return voter.first == playerGuid;
+    });
+    if (voterItr == m_rollVotes.end())
         return false;
 
+    if (voterItr->second.vote == ROLL_NOT_EMITED_YET && vote != ROLL_NOT_EMITED_YET)
+        --m_notVotedCount;
+
     voterItr->second.vote = vote;
 
     if (vote != ROLL_PASS && vote != ROLL_NOT_VALID)
@@ -782,36 +830,33 @@ bool GroupLootRoll::PlayerVote(Player* player, RollVote vote)
     return true;
 }
 
-// check if we can found a winner for this roll or if timer is expired
-bool GroupLootRoll::UpdateRoll()
+// check if all players voted or if timer is expired, the winner is only searched then
+bool GroupLootRoll::UpdateRoll(time_t now)
 {
-    RollVoteMap::const_iterator winnerItr = m_rollVoteMap.end();
+    if (m_notVotedCount && m_endTime > now)
+        return false;
 
-    if (AllPlayerVoted(winnerItr) || m_endTime <= time(nullptr))
-    {
-        Finish(winnerItr);
-        return true;
-    }
-    return false;
+    RollVoteList::const_iterator winnerItr;
+    GetWinner(winnerItr);
+    Finish(winnerItr);
+    return true;
 }
 
 /**
-* \brief: Check if all player have voted and return true in that case. Also return current winner.
-* \param: RollVoteMap::const_iterator& winnerItr > will be different than m_rollCoteMap.end() if winner exist. (Someone voted greed or need)
-* \returns: bool > true if all players voted
+* \brief: Find the current winner of the roll.
+* \param: RollVoteList::const_iterator& winnerItr > will be different than m_rollVotes.end() if winner exist. (Someone voted greed or need)
 **/
-bool GroupLootRoll::AllPlayerVoted(RollVoteMap::const_iterator& winnerItr)
+void GroupLootRoll::GetWinner(RollVoteList::const_iterator& winnerItr) const
 {
-    uint32 notVoted = 0;
     bool isSomeoneNeed = false;
 
-    winnerItr = m_rollVoteMap.end();
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
+    winnerItr = m_rollVotes.end();
+    for (RollVoteList::const_iterator itr = m_rollVotes.begin(); itr != m_rollVotes.end(); ++itr)
     {
         switch (itr->second.vote)
         {
             case ROLL_NEED:
-                if (!isSomeoneNeed || winnerItr == m_rollVoteMap.end() || itr->second.number > winnerItr->second.number)
+                if (!isSomeoneNeed || winnerItr == m_rollVotes.end() || itr->second.number > winnerItr->second.number)
                 {
                     isSomeoneNeed = true;                                               // first passage will force to set winner because need is prioritized
                     winnerItr = itr;
@@ -821,29 +866,22 @@ bool GroupLootRoll::AllPlayerVoted(RollVoteMap::const_iterator& winnerItr)
             case ROLL_DISENCHANT:
                 if (!isSomeoneNeed)                                                      // if at least one need is detected then winner can't be a greed
                 {
-                    if (winnerItr == m_rollVoteMap.end() || itr->second.number > winnerItr->second.number)
+                    if (winnerItr == m_rollVotes.end() || itr->second.number > winnerItr->second.number)
                         winnerItr = itr;
                 }
                 break;
             // Explicitly passing excludes a player from winning loot, so no action required.
-            case ROLL_PASS:
-                break;
-            case ROLL_NOT_EMITED_YET:
-                ++notVoted;
-                break;
             default:
                 break;
         }
     }
-
-    return notVoted == 0;
 }
 
 // terminate the roll
-void GroupLootRoll::Finish(RollVoteMap::const_iterator& winnerItr)
+void GroupLootRoll::Finish(RollVoteList::const_iterator& winnerItr)
 {
     m_lootItem->isBlocked = false;
-    if (winnerItr == m_rollVoteMap.end())
+    if (winnerItr == m_rollVotes.end())
     {
         SendAllPassed();
         m_lootItem->isReleased = true;
@@ -965,6 +1003,8 @@ bool Loot::FillLoot(uint32 loot_id, LootStore const& store, Player* lootOwner, b
     if (!lootOwner)
         return false;
 
+    ConditionCacheScope conditionCache;
+
     LootTemplate const* tab = store.GetLootFor(loot_id);
 
     if (!tab)
@@ -1094,6 +1134,10 @@ bool Loot::CanLoot(Player const* player)
     if (itr == m_ownerSet.end())
         return false;
 
+    // content is unknown until the first opening rolls it
+    if (m_isDeferred)
+        return true;
+
     uint32 lootStatus = GetLootStatusFor(player);
 
     // is already looted?
@@ -1703,7 +1747,7 @@ void Loot::SetGroupLootRight(Player* player)
 Loot::Loot(Player* player, Creature* creature, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_isDeferred(false), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1730,31 +1774,18 @@ Loot::Loot(Player* player, Creature* creature, LootType type) :
             SetGroupLootRight(player);
             m_clientLootType = CLIENT_LOOT_CORPSE;
 
-            if ((creatureInfo->LootId && FillLoot(creatureInfo->LootId, LootTemplates_Creature, player, false)) || creatureInfo->MaxLootGold > 0)
+            // most corpses of farmed creatures are never opened, roll their loot at the first opening
+            if (sWorld.getConfig(CONFIG_BOOL_CORPSE_DEFERRED_LOOT) && (creatureInfo->LootId || creatureInfo->MaxLootGold > 0))
             {
-                GenerateMoneyLoot(creatureInfo->MinLootGold, creatureInfo->MaxLootGold);
-                // loot may be anyway empty (loot may be empty or contain items that no one have right to loot)
-                bool isLootedForAll = IsLootedForAll();
-                if (isLootedForAll)
-                {
-                    // show sometimes an empty window
-                    if (sWorld.getConfig(CONFIG_BOOL_CORPSE_EMPTY_LOOT_SHOW) && urand(0, 2) == 1)
-                    {
-                        m_isFakeLoot = true;
-                        isLootedForAll = false;
-                    }
-                }
-
-                if (!isLootedForAll)
-                    creature->SetFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE);
-                else
-                    creature->SetLootStatus(CREATURE_LOOT_STATUS_LOOTED);
+                m_isDeferred = true;
+                m_deferredSeed = urand();
+                m_deferredOwnerGuid = player->GetObjectGuid();
+                creature->SetFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE);
                 ForceLootAnimationClientUpdate();
                 break;
             }
 
-            sLog.outDebug("Loot::CreateLoot> cannot create corpse loot, FillLoot failed with loot id(%u)!", creatureInfo->LootId);
-            creature->SetLootStatus(CREATURE_LOOT_STATUS_LOOTED);
+            FillCorpseLoot(player, creature);
             break;
         }
         case LOOT_PICKPOCKETING:
@@ -1799,10 +1830,58 @@ Loot::Loot(Player* player, Creature* creature, LootType type) :
     return;
 }
 
+void Loot::FillCorpseLoot(Player* lootOwner, Creature* creature)
+{
+    CreatureInfo const* creatureInfo = creature->GetCreatureInfo();
+    if ((creatureInfo->LootId && FillLoot(creatureInfo->LootId, LootTemplates_Creature, lootOwner, false)) || creatureInfo->MaxLootGold > 0)
+    {
+        GenerateMoneyLoot(creatureInfo->MinLootGold, creatureInfo->MaxLootGold);
+        // loot may be anyway empty (loot may be empty or contain items that no one have right to loot)
+        bool isLootedForAll = IsLootedForAll();
+        if (isLootedForAll)
+        {
+            // show sometimes an empty window
+            if (sWorld.getConfig(CONFIG_BOOL_CORPSE_EMPTY_LOOT_SHOW) && urand(0, 2) == 1)
+            {
+                m_isFakeLoot = true;
+                isLootedForAll = false;
+            }
+        }
+
+        if (!isLootedForAll)
+            creature->SetFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE);
+        else
+            creature->SetLootStatus(CREATURE_LOOT_STATUS_LOOTED);
+        ForceLootAnimationClientUpdate();
+        return;
+    }
+
+    DEBUG_LOG("Loot::CreateLoot> cannot create corpse loot, FillLoot failed with loot id(%u)!", creatureInfo->LootId);
+    creature->SetLootStatus(CREATURE_LOOT_STATUS_LOOTED);
+}
+
+// Rolls deferred corpse loot as it would have been rolled at death: same owners and, by the seed, same rolls.
+// Conditions are checked for the killer if still online, else for the opener.
+void Loot::FillDeferred(Player* opener)
+{
+    if (!m_isDeferred)
+        return;
+
+    m_isDeferred = false;
+
+    // the killer may have left the map meanwhile, only players of the corpse's map can be used here
+    Player* lootOwner = m_lootTarget ? m_lootTarget->GetMap()->GetPlayer(m_deferredOwnerGuid) : nullptr;
+    if (!lootOwner)
+        lootOwner = opener;
+
+    RandomSeedScope seed(m_deferredSeed);
+    FillCorpseLoot(lootOwner, static_cast<Creature*>(m_lootTarget));
+}
+
 Loot::Loot(Player* player, GameObject* gameObject, LootType type, bool lootSnapshot) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_isDeferred(false), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1893,7 +1972,7 @@ Loot::Loot(Player* player, GameObject* gameObject, LootType type, bool lootSnaps
 Loot::Loot(Player* player, Corpse* corpse, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_isDeferred(false), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1942,7 +2021,7 @@ Loot::Loot(Player* player, Corpse* corpse, LootType type) :
 Loot::Loot(Player* player, Item* item, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_isDeferred(false), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1989,7 +2068,7 @@ Loot::Loot(Player* player, Item* item, LootType type) :
 Loot::Loot(Unit* unit, Item* item) :
     m_lootTarget(nullptr), m_itemTarget(item), m_gold(0), m_maxSlot(0),
     m_lootType(LOOT_SKINNING), m_clientLootType(CLIENT_LOOT_PICKPOCKETING), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0),
-    m_haveItemOverThreshold(false), m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_haveItemOverThreshold(false), m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_isDeferred(false), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     m_ownerSet.insert(unit->GetObjectGuid());
     m_guidTarget = item->GetObjectGuid();
@@ -1998,7 +2077,7 @@ Loot::Loot(Unit* unit, Item* item) :
 Loot::Loot(Player* player, uint32 id, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_isDeferred(false), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
     m_ownerSet.insert(player->GetObjectGuid());
     switch (type)
@@ -2028,7 +2107,7 @@ Loot::Loot(Player* player, uint32 id, LootType type) :
 Loot::Loot(LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_isDeferred(false), m_deferredSeed(0), m_createTime(World::GetCurrentClockTime())
 {
 
 }
@@ -2087,7 +2166,7 @@ InventoryResult Loot::SendItem(Player* target, LootItem* lootItem, bool sendErro
             if (lootItem->freeForAll)
             {
                 NotifyItemRemoved(target, lootItem->lootSlot);
-                sLog.outDebug("This item is free for all!!");
+                DEBUG_LOG("This item is free for all!!");
             }
             else
                 NotifyItemRemoved(lootItem->lootSlot);
@@ -2188,10 +2267,14 @@ bool Loot::AutoStore(Player* player, bool broadcast /*= false*/, uint32 bag /*=
 void Loot::Update()
 {
     m_isChanged = false;
+    if (m_roll.empty())
+        return;
+
+    time_t now = time(nullptr);
     GroupLootRollMap::iterator itr = m_roll.begin();
     while (itr != m_roll.end())
     {
-        if (itr->second.UpdateRoll())
+        if (itr->second.UpdateRoll(now))
             m_roll.erase(itr++);
         else
             ++itr;
@@ -2374,6 +2457,7 @@ void Loot::PrintLootList(ChatHandler& chat, WorldSession* session) const
 // fill in the bytebuffer with loot content for specified player
 void Loot::GetLootContentFor(Player* player, ByteBuffer& buffer)
 {
+    ConditionCacheScope conditionCache;
     uint8 itemsShown = 0;
 
     // gold
@@ -2388,7 +2472,7 @@ void Loot::GetLootContentFor(Player* player, ByteBuffer& buffer)
         LootSlotType slot_type = lootItem->GetSlotTypeForSharedLoot(player, this);
         if (slot_type >= MAX_LOOT_SLOT_TYPE)
         {
-            sLog.outDebug("Item not visible for %s> itemid(%u) in slot (%u)!", player->GetGuidStr().c_str(), lootItem->itemId, uint32(lootItem->lootSlot));
+            DEBUG_LOG("Item not visible for %s> itemid(%u) in slot (%u)!", player->GetGuidStr().c_str(), lootItem->itemId, uint32(lootItem->lootSlot));
             continue;
         }
 
@@ -2397,7 +2481,7 @@ void Loot::GetLootContentFor(Player* player, ByteBuffer& buffer)
         buffer << uint8(slot_type);                              // 0 - get 1 - look only 2 - master selection
         ++itemsShown;
 
-        sLog.outDebug("Sending loot to %s> itemid(%u) in slot (%u)!", player->GetGuidStr().c_str(), lootItem->itemId, uint32(lootItem->lootSlot));
+        DEBUG_LOG("Sending loot to %s> itemid(%u) in slot (%u)!", player->GetGuidStr().c_str(), lootItem->itemId, uint32(lootItem->lootSlot));
     }
 
     // update number of items shown
@@ -2431,74 +2515,118 @@ void LootTemplate::LootGroup::AddEntry(LootStoreItem& item)
 LootStoreItem const* LootTemplate::LootGroup::Roll(Loot const& loot, Player const* lootOwner) const
 {
     if (!ExplicitlyChanced.empty())                         // First explicitly chanced entries are checked
-    {
-        std::vector <LootStoreItem const*> lootStoreItemVector; // we'll use new vector to make easy the randomization
-
-        // fill the new vector with correct pointer to our item list
-        for (auto& itr : ExplicitlyChanced)
-            lootStoreItemVector.push_back(&itr);
+        if (LootStoreItem const* lsi = RollExplicitlyChanced(loot, lootOwner))
+            return lsi;
 
-        // randomize the new vector
-        shuffle(lootStoreItemVector.begin(), lootStoreItemVector.end(), *GetRandomGenerator());
+    if (!EqualChanced.empty())                              // If nothing selected yet - an item is taken from equal-chanced part
+        return RollEqualChanced(loot, lootOwner);
 
-        float chance = rand_chance_f();
+    return nullptr;                                            // Empty drop from the group
+}
 
-        // as the new vector is randomized we can start from first element and stop at first one that meet the condition
-        for (std::vector <LootStoreItem const*>::const_iterator itr = lootStoreItemVector.begin(); itr != lootStoreItemVector.end(); ++itr)
+LootStoreItem const* LootTemplate::LootGroup::RollExplicitlyChanced(Loot const& loot, Player const* lootOwner) const
+{
+    if (!AliasChance.empty())
+    {
+        // every entry drops with its own chance, unless some are dropped by conditions
+        if (!ExplicitlyConditioned || !lootOwner)
         {
-            LootStoreItem const* lsi = *itr;
+            uint32 const outcome = urand(0, AliasChance.size() - 1);
+            uint32 const index = rand_norm_f() < AliasChance[outcome] ? outcome : Alias[outcome];
+            return index < ExplicitlyChanced.size() ? &ExplicitlyChanced[index] : nullptr;
+        }
 
-            if (lsi->conditionId && lootOwner && !LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi->conditionId))
+        // with chances up to 100% the order of the entries does not change the odds, no need to shuffle
+        float chance = rand_chance_f();
+        for (auto const& lsi : ExplicitlyChanced)
+        {
+            if (lsi.conditionId && !LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi.conditionId))
             {
-                sLog.outDebug("In explicit chance -> This item cannot be added! (%u)", lsi->itemid);
+                DEBUG_LOG("In explicit chance -> This item cannot be added! (%u)", lsi.itemid);
                 continue;
             }
 
-            if (lsi->chance >= 100.0f)
-                return lsi;
+            if (lsi.chance >= 100.0f)
+                return &lsi;
 
-            chance -= lsi->chance;
+            chance -= lsi.chance;
             if (chance < 0)
-                return lsi;
+                return &lsi;
         }
+        return nullptr;
     }
 
-    if (!EqualChanced.empty())                              // If nothing selected yet - an item is taken from equal-chanced part
-    {
-        std::vector <LootStoreItem const*> lootStoreItemVector; // we'll use new vector to make easy the randomization
+    // chances above 100% in total (DB error reported at loading), the shuffled order decides which entries can drop
+    std::vector <LootStoreItem const*> lootStoreItemVector; // we'll use new vector to make easy the randomization
+
+    // fill the new vector with correct pointer to our item list
+    for (auto& itr : ExplicitlyChanced)
+        lootStoreItemVector.push_back(&itr);
 
-        // fill the new vector with correct pointer to our item list
-        for (auto& itr : EqualChanced)
-            lootStoreItemVector.push_back(&itr);
+    // randomize the new vector
+    shuffle(lootStoreItemVector.begin(), lootStoreItemVector.end(), *GetRandomGenerator());
 
-        // randomize the new vector
-        std::shuffle(lootStoreItemVector.begin(), lootStoreItemVector.end(), *GetRandomGenerator());
+    float chance = rand_chance_f();
+
+    // as the new vector is randomized we can start from first element and stop at first one that meet the condition
+    for (std::vector <LootStoreItem const*>::const_iterator itr = lootStoreItemVector.begin(); itr != lootStoreItemVector.end(); ++itr)
+    {
+        LootStoreItem const* lsi = *itr;
 
-        // as the new vector is randomized we can start from first element and stop at first one that meet the condition
-        for (std::vector <LootStoreItem const*>::const_iterator itr = lootStoreItemVector.begin(); itr != lootStoreItemVector.end(); ++itr)
+        if (lsi->conditionId && lootOwner && !LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi->conditionId))
         {
-            LootStoreItem const* lsi = *itr;
+            DEBUG_LOG("In explicit chance -> This item cannot be added! (%u)", lsi->itemid);
+            continue;
+        }
 
-            //check if we already have that item in the loot list
-            if (loot.IsItemAlreadyIn(lsi->itemid))
-            {
-                // the item is already looted, let's give a 50%  chance to pick another one
-                uint32 chance = urand(0, 1);
+        if (lsi->chance >= 100.0f)
+            return lsi;
 
-                if (chance)
-                    continue;                               // pass this item
-            }
+        chance -= lsi->chance;
+        if (chance < 0)
+            return lsi;
+    }
 
-            if (lsi->conditionId && lootOwner && !LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi->conditionId))
-            {
-                sLog.outDebug("In equal chance -> This item cannot be added! (%u)", lsi->itemid);
-                continue;
-            }
+    return nullptr;
+}
+
+LootStoreItem const* LootTemplate::LootGroup::RollEqualChanced(Loot const& loot, Player const* lootOwner) const
+{
+    // trying the entries in shuffled order is drawing them without replacement until one is taken,
+    // the remaining indexes are only listed once an entry is passed
+    std::vector<uint32> remaining;
+    uint32 left = EqualChanced.size();
+    while (left)
+    {
+        uint32 const draw = urand(0, left - 1);
+        LootStoreItem const* lsi = &EqualChanced[remaining.empty() ? draw : remaining[draw]];
+
+        bool passed = false;
+        //check if we already have that item in the loot list
+        if (loot.IsItemAlreadyIn(lsi->itemid))
+        {
+            // the item is already looted, let's give a 50%  chance to pick another one
+            passed = urand(0, 1) != 0;
+        }
+
+        if (!passed && lsi->conditionId && lootOwner && !LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi->conditionId))
+        {
+            DEBUG_LOG("In equal chance -> This item cannot be added! (%u)", lsi->itemid);
+            passed = true;
+        }
+
+        if (!passed)
             return lsi;
+
+        if (remaining.empty())
+        {
+            remaining.resize(left);
+            std::iota(remaining.begin(), remaining.end(), 0);
         }
+        remaining[draw] = remaining[--left];
     }
 
-    return nullptr;                                            // Empty drop from the group
+    return nullptr;
 }
 
 // True if group includes at least 1 quest drop entry
@@ -2570,6 +2698,52 @@ void LootTemplate::LootGroup::Verify(LootStore const& lootstore, uint32 id, uint
     }
 }
 
+// Vose's alias method: one uniform outcome and one chance decide the roll, whatever the number of entries
+void LootTemplate::LootGroup::Compile()
+{
+    float total = 0.0f;
+    ExplicitlyConditioned = false;
+    for (auto const& lsi : ExplicitlyChanced)
+    {
+        total += lsi.chance;
+        if (lsi.conditionId)
+            ExplicitlyConditioned = true;
+    }
+
+    AliasChance.clear();
+    Alias.clear();
+    if (ExplicitlyChanced.empty() || total > 100.0f)
+        return;
+
+    uint32 const outcomes = ExplicitlyChanced.size() + 1;   // the last one misses all entries
+    std::vector<float> scaled(outcomes);
+    for (uint32 i = 0; i < ExplicitlyChanced.size(); ++i)
+        scaled[i] = ExplicitlyChanced[i].chance * outcomes / 100.0f;
+    scaled[outcomes - 1] = (100.0f - total) * outcomes / 100.0f;
+
+    AliasChance.assign(outcomes, 1.0f);                     // outcomes left over at the end are 1 up to rounding
+    Alias.resize(outcomes);
+    std::vector<uint32> small, large;
+    for (uint32 i = 0; i < outcomes; ++i)
+    {
+        Alias[i] = i;
+        (scaled[i] < 1.0f ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        uint32 const less = small.back();
+        small.pop_back();
+        uint32 const more = large.back();
+        large.pop_back();
+
+        AliasChance[less] = scaled[less];
+        Alias[less] = more;
+        scaled[more] -= 1.0f - scaled[less];
+        (scaled[more] < 1.0f ? small : large).push_back(more);
+    }
+}
+
 void LootTemplate::LootGroup::CheckLootRefs(LootIdSet* ref_set) const
 {
     for (auto ieItr : ExplicitlyChanced)
@@ -2625,7 +2799,7 @@ void LootTemplate::Process(Loot& loot, Player const* lootOwner, LootStore const&
     }
 
     // Rolling non-grouped items
-    for (auto Entrie : Entries)
+    for (auto const& Entrie : Entries)
     {
         // Check condition
         if (Entrie.conditionId && lootOwner && !PlayerOrGroupFulfilsCondition(loot, lootOwner, Entrie.conditionId))
@@ -2653,6 +2827,12 @@ void LootTemplate::Process(Loot& loot, Player const* lootOwner, LootStore const&
         Group.Process(loot, lootOwner);
 }
 
+void LootTemplate::Compile()
+{
+    for (auto& Group : Groups)
+        Group.Compile();
+}
+
 // True if template includes at least 1 quest drop entry
 bool LootTemplate::HasQuestDrop(LootTemplateMap const& store, uint8 groupId) const
 {
@@ -3039,6 +3219,58 @@ void LoadLootTemplates_Reference(LootIdSet& ids_set)
     LootTemplates_Reference.LoadAndCollectLootIds(ids_set);
 }
 
+namespace
+{
+    // joined by StopLootTemplatesReload() at shutdown, or by the next reload
+    struct LootReloadThread
+    {
+        ~LootReloadThread() { if (thread.joinable()) thread.join(); } // only when the world was never stopped
+
+        std::thread thread;
+        std::atomic<bool> running{false};
+    };
+
+    LootReloadThread lootReload;
+}
+
+bool ReloadLootTemplatesInBackground(LootStore& store, std::function<void()> const& loader, std::function<void()> const& onPublished)
+{
+    if (lootReload.running.exchange(true))
+        return false;
+
+    if (lootReload.thread.joinable())
+        lootReload.thread.join();
+
+    store.BeginStaging();
+    lootReload.thread = std::thread([&store, loader, onPublished]()
+    {
+        WorldDatabase.ThreadStart();
+        loader();
+        WorldDatabase.ThreadEnd();
+
+        // messages are executed before the map updates are scheduled, so no map thread reads the store
+        sWorld.GetMessager().AddMessage([&store, onPublished](World* /*world*/)
+        {
+            store.PublishStaged();
+            onPublished();
+            lootReload.running = false;
+        });
+    });
+    return true;
+}
+
+bool IsLootTemplatesReloadRunning()
+{
+    return lootReload.running;
+}
+
+void StopLootTemplatesReload()
+{
+    // the loader can not be interrupted, its result is dropped together with the world messager
+    if (lootReload.thread.joinable())
+        lootReload.thread.join();
+}
+
 void CheckLootTemplates_Reference(LootIdSet& ids_set)
 {
     // check references and remove used
@@ -3151,7 +3383,11 @@ Loot* LootMgr::GetLoot(Player* player, ObjectGuid const& targetGuid) const
             Creature* creature = player->GetMap()->GetCreature(lguid);
 
             if (creature)
+            {
                 loot = creature->m_loot;
+                if (loot && loot->IsDeferred())
+                    loot->FillDeferred(player);
+            }
 
             break;
         }
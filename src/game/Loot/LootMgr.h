@@ -23,6 +23,7 @@
 #include "Entities/ObjectGuid.h"
 #include "Globals/SharedDefines.h"
 
+#include <functional>
 #include <vector>
 #include "Entities/Bag.h"
 
@@ -134,30 +135,32 @@ struct PlayerRollVote
 class GroupLootRoll
 {
     public:
-        typedef std::unordered_map<ObjectGuid, PlayerRollVote> RollVoteMap;
+        // one entry per loot owner, a group holds at most 40 so a plain search beats hashing
+        typedef std::vector<std::pair<ObjectGuid, PlayerRollVote> > RollVoteList;
 
-        GroupLootRoll() : m_rollVoteMap(ROLL_VOTE_MASK_ALL), m_isStarted(false), m_lootItem(nullptr), m_loot(nullptr), m_itemSlot(0), m_voteMask(), m_endTime(0)
+        GroupLootRoll() : m_isStarted(false), m_lootItem(nullptr), m_loot(nullptr), m_itemSlot(0), m_voteMask(), m_endTime(0), m_notVotedCount(0)
         {}
         ~GroupLootRoll();
 
         bool TryToStart(Loot& loot, uint32 itemSlot);
         bool PlayerVote(Player* player, RollVote vote);
-        bool UpdateRoll();
+        bool UpdateRoll(time_t now);
 
     private:
         void SendStartRoll();
         void SendAllPassed();
         void SendRoll(ObjectGuid const& targetGuid, uint32 rollNumber, uint32 rollType);
         void SendLootRollWon(ObjectGuid const& targetGuid, uint32 rollNumber, RollVote rollType);
-        void Finish(RollVoteMap::const_iterator& winnerItr);
-        bool AllPlayerVoted(RollVoteMap::const_iterator& winnerItr);
-        RollVoteMap           m_rollVoteMap;
+        void Finish(RollVoteList::const_iterator& winnerItr);
+        void GetWinner(RollVoteList::const_iterator& winnerItr) const;
+        RollVoteList          m_rollVotes;
         bool                  m_isStarted;
         LootItem*             m_lootItem;
         Loot*                 m_loot;
         uint32                m_itemSlot;
         RollVoteMask          m_voteMask;
         time_t                m_endTime;
+        uint32                m_notVotedCount;              // players still at ROLL_NOT_EMITED_YET
 };
 typedef std::unordered_map<uint32, GroupLootRoll> GroupLootRollMap;
 
@@ -224,8 +227,8 @@ class LootStore
 {
     public:
         explicit LootStore(char const* name, char const* entryName, bool ratesAllowed)
-            : m_name(name), m_entryName(entryName), m_ratesAllowed(ratesAllowed) {}
-        virtual ~LootStore() { Clear(); }
+            : m_name(name), m_entryName(entryName), m_ratesAllowed(ratesAllowed), m_staging(false) {}
+        virtual ~LootStore() { Clear(); ClearStaged(); }
 
         void Verify() const;
 
@@ -243,14 +246,24 @@ class LootStore
         char const* GetName() const { return m_name; }
         char const* GetEntryName() const { return m_entryName; }
         bool IsRatesAllowed() const { return m_ratesAllowed; }
+
+        // Loads until PublishStaged() go to a staging copy, readers keep the current templates meanwhile
+        void BeginStaging() { m_staging = true; }
+        // Swaps in the staging copy, no loot may be generated from this store concurrently
+        void PublishStaged();
     protected:
         void LoadLootTable();
         void Clear();
+        void ClearStaged();
     private:
+        LootTemplateMap& GetLoadTarget() { return m_staging ? m_StagedTemplates : m_LootTemplates; }
+
         LootTemplateMap m_LootTemplates;
+        LootTemplateMap m_StagedTemplates;
         char const* m_name;
         char const* m_entryName;
         bool m_ratesAllowed;
+        bool m_staging;
 };
 
 class LootTemplate
@@ -271,6 +284,9 @@ class LootTemplate
         // True if at least one player fulfils loot condition
         static bool PlayerOrGroupFulfilsCondition(const Loot& loot, Player const* lootOwner, uint16 conditionId);
 
+        // Builds the sampling tables of the groups (at loading stage, after all entries are added)
+        void Compile();
+
         // Checks integrity of the template
         void Verify(LootStore const& lootstore, uint32 id) const;
         void CheckLootRefs(LootIdSet* ref_set) const;
@@ -328,10 +344,14 @@ class Loot
         GuidSet const& GetOwnerSet() const { return m_ownerSet; }
         TimePoint const& GetCreateTime() const { return m_createTime; }
 
+        // corpse loot only has its owners and a seed until it is opened the first time (Corpse.DeferredLoot)
+        bool IsDeferred() const { return m_isDeferred; }
+        void FillDeferred(Player* opener);
+
     private:
         Loot(): m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(),
             m_clientLootType(), m_lootMethod(), m_threshold(), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-            m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false)
+            m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_isDeferred(false), m_deferredSeed(0)
         {}
         void Clear();
         bool IsLootedFor(Player const* player) const;
@@ -347,6 +367,7 @@ class Loot
         void SetGroupLootRight(Player* player);
         void GenerateMoneyLoot(uint32 minAmount, uint32 maxAmount);
         bool FillLoot(uint32 loot_id, LootStore const& store, Player* lootOwner, bool personal, bool noEmptyError = false);
+        void FillCorpseLoot(Player* lootOwner, Creature* creature);
         void ForceLootAnimationClientUpdate() const;
         void SetPlayerIsLooting(Player* player);
         void SetPlayerIsNotLooting(Player* player);
@@ -375,6 +396,9 @@ class Loot
         bool             m_isChest;                       // chest type object have special loot right
         bool             m_isChanged;                     // true if at least one item is looted
         bool             m_isFakeLoot;                    // nothing to loot but will sparkle for empty windows
+        bool             m_isDeferred;                    // corpse loot not rolled yet
+        uint32           m_deferredSeed;                  // random seed of the deferred corpse loot
+        ObjectGuid       m_deferredOwnerGuid;             // player the deferred corpse loot is rolled for
         GroupLootRollMap m_roll;                          // used if an item is under rolling
         GuidSet          m_playersLooting;                // player who opened loot windows
         GuidSet          m_playersOpened;                 // players that have released the corpse
@@ -392,6 +416,7 @@ extern LootStore LootTemplates_Skinning;
 extern LootStore LootTemplates_Disenchant;
 extern LootStore LootTemplates_Prospecting;
 extern LootStore LootTemplates_Spell;
+extern LootStore LootTemplates_Reference;
 
 void LoadLootTemplates_Creature();
 void LoadLootTemplates_Fishing();
@@ -409,6 +434,13 @@ void LoadLootTemplates_Reference(LootIdSet& ids_set);
 
 void CheckLootTemplates_Reference(LootIdSet& ids_set); // has to be split due to bg usage
 
+// Runs loader on a background thread with store staging, then publishes the store and calls onPublished
+// on the world thread between ticks. False if another background loot reload is still running.
+bool ReloadLootTemplatesInBackground(LootStore& store, std::function<void()> const& loader, std::function<void()> const& onPublished);
+bool IsLootTemplatesReloadRunning();
+// Waits for a running background loot reload, called at shutdown while the world database is still up
+void StopLootTemplatesReload();
+
 inline void LoadLootTables(LootIdSet& ids_set)
 {
     LoadLootTemplates_Creature();
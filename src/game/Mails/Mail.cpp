@@ -246,13 +246,18 @@ void MailDraft::SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, Ob
  * @param checked              The mask used to specify the mail.
  * @param deliver_delay        The delay after which the mail is delivered in seconds
  */
-void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sender, MailCheckMask checked, uint32 deliver_delay)
+void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sender, MailCheckMask checked, uint32 deliver_delay, MailInsertBatch* batch)
 {
     Player* pReceiver = receiver.GetPlayer();               // can be nullptr
 
     uint32 pReceiverAccount = 0;
     if (!pReceiver)
-        pReceiverAccount = sObjectMgr.GetPlayerAccountIdByGUID(receiver.GetPlayerGuid());
+    {
+        if (batch && batch->AreReceiversChecked())
+            pReceiverAccount = 1;                           // only checked for existence
+        else
+            pReceiverAccount = sObjectMgr.GetPlayerAccountIdByGUID(receiver.GetPlayerGuid());
+    }
 
     if (!pReceiver && !pReceiverAccount)                    // receiver not exist
     {
@@ -290,23 +295,45 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
     std::string safe_body = GetBody();
     CharacterDatabase.escape_string(safe_body);
 
-    CharacterDatabase.BeginTransaction();
-    CharacterDatabase.PExecute("INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,body,has_items,expire_time,deliver_time,money,cod,checked) "
-                               "VALUES ('%u', '%u', '%u', '%u', '%u', '%u', '%s', '%s', '%u', '" UI64FMTD "','" UI64FMTD "', '%u', '%u', '%u')",
-                               mailId, sender.GetMailMessageType(), sender.GetStationery(), GetMailTemplateId(), sender.GetSenderId(), receiver.GetPlayerGuid().GetCounter(), safe_subject.c_str(), safe_body.c_str(), (has_items ? 1 : 0), (uint64)expire_time, (uint64)deliver_time, m_money, m_COD, checked);
+    if (batch)
+    {
+        std::ostringstream ss;
+        ss << "('" << mailId << "', '" << uint32(sender.GetMailMessageType()) << "', '" << uint32(sender.GetStationery()) << "', '" << GetMailTemplateId()
+           << "', '" << sender.GetSenderId() << "', '" << receiver.GetPlayerGuid().GetCounter() << "', '" << safe_subject << "', '" << safe_body
+           << "', '" << (has_items ? 1 : 0) << "', '" << uint64(expire_time) << "', '" << uint64(deliver_time) << "', '" << m_money << "', '" << m_COD << "', '" << uint32(checked) << "')";
+        batch->AddMail(ss.str());
 
-    for (MailItemMap::const_iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
+        for (MailItemMap::const_iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
+        {
+            Item* item = mailItemIter->second;
+            std::ostringstream itemSs;
+            itemSs << "('" << mailId << "', '" << item->GetGUIDLow() << "', '" << item->GetEntry() << "', '" << receiver.GetPlayerGuid().GetCounter() << "')";
+            batch->AddItem(itemSs.str());
+        }
+    }
+    else
     {
-        Item* item = mailItemIter->second;
-        CharacterDatabase.PExecute("INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES ('%u', '%u', '%u','%u')",
-                                   mailId, item->GetGUIDLow(), item->GetEntry(), receiver.GetPlayerGuid().GetCounter());
+        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.PExecute("INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,body,has_items,expire_time,deliver_time,money,cod,checked) "
+                                   "VALUES ('%u', '%u', '%u', '%u', '%u', '%u', '%s', '%s', '%u', '" UI64FMTD "','" UI64FMTD "', '%u', '%u', '%u')",
+                                   mailId, sender.GetMailMessageType(), sender.GetStationery(), GetMailTemplateId(), sender.GetSenderId(), receiver.GetPlayerGuid().GetCounter(), safe_subject.c_str(), safe_body.c_str(), (has_items ? 1 : 0), (uint64)expire_time, (uint64)deliver_time, m_money, m_COD, checked);
+
+        for (MailItemMap::const_iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
+        {
+            Item* item = mailItemIter->second;
+            CharacterDatabase.PExecute("INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES ('%u', '%u', '%u','%u')",
+                                       mailId, item->GetGUIDLow(), item->GetEntry(), receiver.GetPlayerGuid().GetCounter());
+        }
+        CharacterDatabase.CommitTransaction();
     }
-    CharacterDatabase.CommitTransaction();
 
     // For online receiver update in game mail status and data
     if (pReceiver)
     {
-        pReceiver->AddNewMailDeliverTime(deliver_time);
+        if (batch)
+            batch->AddNotification(receiver.GetPlayerGuid(), deliver_time);
+        else
+            pReceiver->AddNewMailDeliverTime(deliver_time);
 
         Mail* m = new Mail;
         m->messageID = mailId;
@@ -343,6 +370,66 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
         deleteIncludedItems();
 }
 
+/// rows per multi-row insert, also bounded by the statement length for long mail bodies
+static uint32 const MAIL_BATCH_MAX_ROWS = 100;
+static size_t const MAIL_BATCH_MAX_LENGTH = 512 * 1024;
+
+void MailInsertBatch::AddMail(std::string const& values)
+{
+    if (!m_mailValues.empty())
+        m_mailValues += ',';
+    m_mailValues += values;
+
+    if (++m_mailRows >= MAIL_BATCH_MAX_ROWS || m_mailValues.size() >= MAIL_BATCH_MAX_LENGTH)
+        FlushMails();
+}
+
+void MailInsertBatch::AddItem(std::string const& values)
+{
+    if (!m_itemValues.empty())
+        m_itemValues += ',';
+    m_itemValues += values;
+
+    if (++m_itemRows >= MAIL_BATCH_MAX_ROWS)
+        FlushItems();
+}
+
+void MailInsertBatch::FlushMails()
+{
+    if (m_mailValues.empty())
+        return;
+
+    CharacterDatabase.Execute(("INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,body,has_items,expire_time,deliver_time,money,cod,checked) VALUES " + m_mailValues).c_str());
+    m_mailValues.clear();
+    m_mailRows = 0;
+}
+
+void MailInsertBatch::FlushItems()
+{
+    if (m_itemValues.empty())
+        return;
+
+    CharacterDatabase.Execute(("INSERT INTO mail_items (mail_id,item_guid,item_template,receiver) VALUES " + m_itemValues).c_str());
+    m_itemValues.clear();
+    m_itemRows = 0;
+}
+
+void MailInsertBatch::Flush()
+{
+    FlushMails();
+    FlushItems();
+}
+
+void MailInsertBatch::SendNotifications()
+{
+    // the receiver could have logged out meanwhile, the mail is loaded from the database at next login then
+    for (auto const& notification : m_notifications)
+        if (Player* receiver = sObjectMgr.GetPlayer(notification.first))
+            receiver->AddNewMailDeliverTime(notification.second);
+
+    m_notifications.clear();
+}
+
 /**
  * Generate items from template at mails loading (this happens when mail with mail template items send in time when receiver has been offline)
  *
@@ -177,6 +177,43 @@ class MailReceiver
         Player* m_receiver;
         ObjectGuid m_receiver_guid;
 };
+/**
+ * Collects the database rows of many sent mails into multi-row inserts.
+ * New mail notifications of online receivers are held back until the rows are written.
+ */
+class MailInsertBatch
+{
+    public:
+        /**
+         * Creates a new batch.
+         *
+         * @param receiversChecked true when all receivers are known to be existing characters, skips the account lookup of offline receivers.
+         */
+        explicit MailInsertBatch(bool receiversChecked = false) : m_receiversChecked(receiversChecked), m_mailRows(0), m_itemRows(0) {}
+        ~MailInsertBatch() { MANGOS_ASSERT(m_mailValues.empty() && m_itemValues.empty() && m_notifications.empty()); }
+
+        bool AreReceiversChecked() const { return m_receiversChecked; }
+        void SetReceiversChecked(bool checked) { m_receiversChecked = checked; }
+
+        void AddMail(std::string const& values);
+        void AddItem(std::string const& values);
+        void AddNotification(ObjectGuid const& receiver, time_t deliverTime) { m_notifications.emplace_back(receiver, deliverTime); }
+
+        /// Executes the collected inserts, expected to be called inside the transaction of the sent mails.
+        void Flush();
+        /// Notifies the receivers still online, call after the transaction is committed.
+        void SendNotifications();
+    private:
+        void FlushMails();
+        void FlushItems();
+
+        bool m_receiversChecked;
+        std::string m_mailValues;
+        uint32 m_mailRows;
+        std::string m_itemValues;
+        uint32 m_itemRows;
+        std::vector<std::pair<ObjectGuid, time_t> > m_notifications;
+};
 /**
  * The class to represent the draft of a mail.
  */
@@ -246,7 +283,7 @@ class MailDraft
         void CloneFrom(MailDraft const& draft);
     public:                                                 // finishers
         void SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, ObjectGuid receiver_guid);
-        void SendMailTo(MailReceiver const& receiver, MailSender const& sender, MailCheckMask checked = MAIL_CHECK_MASK_NONE, uint32 deliver_delay = 0);
+        void SendMailTo(MailReceiver const& receiver, MailSender const& sender, MailCheckMask checked = MAIL_CHECK_MASK_NONE, uint32 deliver_delay = 0, MailInsertBatch* batch = nullptr);
     private:
         MailDraft(MailDraft const&);                        // trap decl, no body, mail draft must cloned only explicitly...
         MailDraft& operator=(MailDraft const&);             // trap decl, no body, ...because items clone is high price operation
@@ -301,6 +338,10 @@ struct Mail
     std::string subject;
     /// the body of the mail
     std::string body;
+    /// false while the body of a mail loaded at login is still only in the database, see Player::LoadMailBodies
+    bool bodyLoaded = true;
+    /// false while the item instances of a mail loaded at login are still only in the database, see Player::LoadMailItems
+    bool itemsLoaded = true;
     /// flag mark mail that already has items, or already generate none items for template
     bool has_items;
     /// A vector containing Information about the items in this mail.
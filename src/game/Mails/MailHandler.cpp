@@ -41,6 +41,82 @@
 
 #define MAX_INBOX_CLIENT_UI_CAPACITY 50
 
+enum MailboxQueryIndex
+{
+    MAILBOX_QUERY_BODIES,
+    MAILBOX_QUERY_ITEMS,
+    MAX_MAILBOX_QUERY
+};
+
+/// Fetches the data of the mails shown in the mailbox that the login queries left in the DB
+class MailboxQueryHolder : public SqlQueryHolder
+{
+    public:
+        MailboxQueryHolder(uint32 accountId, ObjectGuid playerGuid, ObjectGuid mailboxGuid) : m_accountId(accountId), m_playerGuid(playerGuid), m_mailboxGuid(mailboxGuid) {}
+        uint32 GetAccountId() const { return m_accountId; }
+        ObjectGuid GetPlayerGuid() const { return m_playerGuid; }
+        ObjectGuid GetMailboxGuid() const { return m_mailboxGuid; }
+        std::vector<uint32> const& GetMailIds() const { return m_mailIds; }
+        bool Initialize(Player* player);
+    private:
+        uint32 m_accountId;
+        ObjectGuid m_playerGuid;
+        ObjectGuid m_mailboxGuid;
+        std::vector<uint32> m_mailIds;                      ///< shown mails with body or items not loaded
+};
+
+bool MailboxQueryHolder::Initialize(Player* player)
+{
+    std::ostringstream bodyIds;
+    std::ostringstream itemIds;
+    uint32 shown = 0;
+    time_t cur_time = time(nullptr);
+
+    // same mails as sent by WorldSession::SendMailList, the rest is fetched once it moves up in the list
+    for (PlayerMails::iterator itr = player->GetMailBegin(); itr != player->GetMailEnd() && shown < MAX_INBOX_CLIENT_UI_CAPACITY; ++itr)
+    {
+        Mail* mail = *itr;
+        if (mail->state == MAIL_STATE_DELETED || cur_time < mail->deliver_time)
+            continue;
+
+        ++shown;
+
+        if (mail->bodyLoaded && mail->itemsLoaded)
+            continue;
+
+        m_mailIds.push_back(mail->messageID);
+
+        if (!mail->bodyLoaded)
+            bodyIds << (bodyIds.tellp() > 0 ? "," : "") << mail->messageID;
+        if (!mail->itemsLoaded)
+            itemIds << (itemIds.tellp() > 0 ? "," : "") << mail->messageID;
+    }
+
+    if (m_mailIds.empty())
+        return false;
+
+    SetSize(MAX_MAILBOX_QUERY);
+
+    // an empty IN list is not valid SQL, 0 is never a mail id
+    std::string bodyList = bodyIds.tellp() > 0 ? bodyIds.str() : "0";
+    std::string itemList = itemIds.tellp() > 0 ? itemIds.str() : "0";
+
+    bool res = true;
+    res &= SetPQuery(MAILBOX_QUERY_BODIES, "SELECT id,body FROM mail WHERE id IN (%s) AND body <> ''", bodyList.c_str());
+    res &= SetPQuery(MAILBOX_QUERY_ITEMS, "SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, mail_id, item_guid "
+                     "FROM mail_items JOIN item_instance ON item_guid = guid WHERE mail_id IN (%s)", itemList.c_str());
+    return res;
+}
+
+struct MailboxQueryHandler
+{
+    void HandleMailboxCallback(QueryResult* /*dummy*/, SqlQueryHolder* holder)
+    {
+        if (holder)
+            WorldSession::HandleGetMailListCallBack(static_cast<MailboxQueryHolder*>(holder));
+    }
+} mailboxQueryHandler;
+
 bool WorldSession::CheckMailBox(ObjectGuid guid) const
 {
     // GM case
@@ -207,7 +283,10 @@ void WorldSession::HandleSendMail(WorldPacket& recv_data)
     else
     {
         rc_team = sObjectMgr.GetPlayerTeamByGUID(rc);
-        if (QueryResult* result = CharacterDatabase.PQuery("SELECT COUNT(*) FROM mail WHERE receiver = '%u'", rc.GetCounter()))
+        static SqlStatementID countMails;
+        SqlStatement stmt = CharacterDatabase.CreateStatement(countMails, "SELECT COUNT(*) FROM mail WHERE receiver = ?");
+        stmt.addUInt32(rc.GetCounter());
+        if (QueryResult* result = stmt.Query())
         {
             Field* fields = result->Fetch();
             mails_count = fields[0].GetUInt32();
@@ -438,6 +517,10 @@ void WorldSession::HandleMailReturnToSender(WorldPacket& recv_data)
         return;
     }
 
+    // the body and items go back with the mail, fetch them while the rows still exist
+    pl->LoadMailBody(m);
+    pl->LoadMailItems(m);
+
     // we can return mail now
     // so firstly delete the old one
     CharacterDatabase.BeginTransaction();
@@ -505,7 +588,14 @@ void WorldSession::HandleMailTakeItem(WorldPacket& recv_data)
         return;
     }
 
+    pl->LoadMailItems(m);
+
     Item* it = pl->GetMItem(itemId);
+    if (!it)
+    {
+        pl->SendMailResult(mailId, MAIL_ITEM_TAKEN, MAIL_ERR_INTERNAL_ERROR);
+        return;
+    }
 
     ItemPosCountVec dest;
     InventoryResult msg = _player->CanStoreItem(NULL_BAG, NULL_SLOT, dest, it, false);
@@ -620,6 +710,46 @@ void WorldSession::HandleGetMailList(WorldPacket& recv_data)
     if (!CheckMailBox(mailboxGuid))
         return;
 
+    if (_player->IsMailDataRequestPending())
+        return;
+
+    // bodies and item instances of the shown mails still in the DB are fetched, the list is sent from the callback
+    MailboxQueryHolder* holder = new MailboxQueryHolder(GetAccountId(), _player->GetObjectGuid(), mailboxGuid);
+    if (!holder->Initialize(_player))
+    {
+        delete holder;
+        SendMailList(mailboxGuid);
+        return;
+    }
+
+    _player->SetMailDataRequestPending(true);
+    CharacterDatabase.DelayQueryHolder(&mailboxQueryHandler, &MailboxQueryHandler::HandleMailboxCallback, holder);
+}
+
+void WorldSession::HandleGetMailListCallBack(MailboxQueryHolder* holder)
+{
+    WorldSession* session = sWorld.FindSession(holder->GetAccountId());
+    Player* player = session ? session->GetPlayer() : nullptr;
+    // the account may have logged in another character meanwhile, the mail ids are not its own
+    if (!player || player->GetObjectGuid() != holder->GetPlayerGuid())
+    {
+        delete holder;
+        return;
+    }
+
+    player->LoadMailBodies(holder->GetResult(MAILBOX_QUERY_BODIES), holder->GetMailIds());
+    player->LoadMailItems(holder->GetResult(MAILBOX_QUERY_ITEMS), holder->GetMailIds());
+    player->SetMailDataRequestPending(false);
+
+    // player may have walked away from the mailbox meanwhile
+    if (session->CheckMailBox(holder->GetMailboxGuid()))
+        session->SendMailList(holder->GetMailboxGuid());
+
+    delete holder;
+}
+
+void WorldSession::SendMailList(ObjectGuid /*mailboxGuid*/)
+{
     uint32 mailsCount = 0;                                  // send to client mails amount
     uint32 realCount = 0;                                   // real mails amount
 
@@ -749,6 +879,9 @@ void WorldSession::HandleMailCreateTextItem(WorldPacket& recv_data)
     Player* pl = _player;
 
     Mail* m = pl->GetMail(mailId);
+    if (m)
+        pl->LoadMailBody(m);
+
     if (!m || (m->body.empty() && !m->mailTemplateId) || m->state == MAIL_STATE_DELETED || m->deliver_time > time(nullptr))
     {
         pl->SendMailResult(mailId, MAIL_MADE_PERMANENT, MAIL_ERR_INTERNAL_ERROR);
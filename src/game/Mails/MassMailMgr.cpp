@@ -41,10 +41,10 @@ void MassMailMgr::AddMassMailTask(MailDraft* mailProto, const MailSender& sender
     {
         std::ostringstream ss;
         ss << "SELECT guid FROM characters WHERE (1 << (race - 1)) & " << raceMask << " AND deleteDate IS NULL";
-        AddMassMailTask(mailProto, sender, ss.str().c_str());
+        AddMassMailTask(mailProto, sender, ss.str().c_str(), "guid");
     }
     else
-        AddMassMailTask(mailProto, sender, "SELECT guid FROM characters WHERE deleteDate IS NULL");
+        AddMassMailTask(mailProto, sender, "SELECT guid FROM characters WHERE deleteDate IS NULL", "guid");
 }
 
 struct MassMailerQueryHandler
@@ -71,33 +71,131 @@ void MassMailMgr::AddMassMailTask(MailDraft* mailProto, const MailSender& sender
     CharacterDatabase.AsyncPQuery(&massMailerQueryHandler, &MassMailerQueryHandler::HandleQueryCallback, mailProto, sender, "%s", query);
 }
 
+void MassMailMgr::AddMassMailTask(MailDraft* mailProto, const MailSender& sender, char const* query, char const* guidColumn)
+{
+    std::lock_guard<std::mutex> guard(m_newMassMailsLock);
+
+    m_newMassMails.emplace_back(0, mailProto, sender);
+    MassMail& task = m_newMassMails.back();
+    task.m_query = query;
+    task.m_guidColumn = guidColumn;
+    task.m_lastPage = false;
+}
+
+void MassMailMgr::RequestReceivers(MassMail& task, bool sync)
+{
+    uint32 pageSize = sWorld.getConfig(CONFIG_UINT32_MASS_MAILER_PAGE_SIZE);
+
+    if (sync)
+    {
+        // a still pending async page is dropped at arrival, see HandleReceiversPage
+        task.m_pagePending = false;
+        LoadReceiversPage(task, CharacterDatabase.PQuery("%s AND %s > %u ORDER BY %s LIMIT %u",
+                          task.m_query.c_str(), task.m_guidColumn.c_str(), task.m_lastGuid, task.m_guidColumn.c_str(), pageSize));
+        return;
+    }
+
+    task.m_pagePending = true;
+    task.m_requestedGuid = task.m_lastGuid;
+    CharacterDatabase.AsyncPQuery(this, &MassMailMgr::HandleReceiversPage, task.m_id, task.m_lastGuid, "%s AND %s > %u ORDER BY %s LIMIT %u",
+                                  task.m_query.c_str(), task.m_guidColumn.c_str(), task.m_lastGuid, task.m_guidColumn.c_str(), pageSize);
+}
+
+void MassMailMgr::HandleReceiversPage(QueryResult* result, uint32 taskId, uint32 fromGuid)
+{
+    for (MassMail& task : m_massMails)
+    {
+        if (task.m_id != taskId)
+            continue;
+
+        if (task.m_pagePending && task.m_requestedGuid == fromGuid)
+        {
+            task.m_pagePending = false;
+            LoadReceiversPage(task, result);
+            return;
+        }
+        break;
+    }
+
+    delete result;
+}
+
+void MassMailMgr::LoadReceiversPage(MassMail& task, QueryResult* result)
+{
+    uint32 count = 0;
+    if (result)
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            uint32 lowguid = fields[0].GetUInt32();
+            task.m_receivers.insert(lowguid);
+            task.m_lastGuid = std::max(task.m_lastGuid, lowguid);
+            ++count;
+        }
+        while (result->NextRow());
+        delete result;
+    }
+
+    if (count < sWorld.getConfig(CONFIG_UINT32_MASS_MAILER_PAGE_SIZE))
+        task.m_lastPage = true;
+
+    DETAIL_LOG("Mass mail task %u: %u mails sent, %u receivers loaded%s", task.m_id, task.m_sent, count, task.m_lastPage ? " (last page)" : "");
+}
+
 void MassMailMgr::Update(bool sendall /*= false*/)
 {
+    {
+        std::lock_guard<std::mutex> guard(m_newMassMailsLock);
+        for (MassMail& task : m_newMassMails)
+        {
+            task.m_id = ++m_lastTaskId;
+            sLog.outString("Mass mail task %u started", task.m_id);
+        }
+        m_massMails.splice(m_massMails.end(), m_newMassMails);
+    }
+
     if (m_massMails.empty())
         return;
 
     uint32 maxcount = sWorld.getConfig(CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK);
+    uint32 pageSize = sWorld.getConfig(CONFIG_UINT32_MASS_MAILER_PAGE_SIZE);
+
+    // rows of all mails of this tick are written by a few multi-row inserts in one transaction
+    MailInsertBatch batch;
+    CharacterDatabase.BeginTransaction();
 
     do
     {
         MassMail& task = m_massMails.front();
 
-        while (!task.m_receivers.empty() && (sendall || maxcount > 0))
+        // paged receivers come from the characters table, no need to check each of them again
+        batch.SetReceiversChecked(!task.m_query.empty());
+
+        while (sendall || maxcount > 0)
         {
+            // request next page before running out of receivers, at shutdown wait for it
+            if (task.HasMorePages() && task.m_receivers.size() <= pageSize / 2 && (sendall || !task.m_pagePending))
+                RequestReceivers(task, sendall);
+
+            if (task.m_receivers.empty())
+                break;
+
             uint32 receiver_lowguid = *task.m_receivers.begin();
             task.m_receivers.erase(task.m_receivers.begin());
 
             ObjectGuid receiver_guid = ObjectGuid(HIGHGUID_PLAYER, receiver_lowguid);
             Player* receiver = sObjectMgr.GetPlayer(receiver_guid);
 
+            ++task.m_sent;
+            if (!sendall)
+                --maxcount;
+
             // last case. can be just send
-            if (task.m_receivers.empty())
+            if (task.m_receivers.empty() && !task.HasMorePages())
             {
                 // prevent mail return
-                task.m_protoMail->SendMailTo(MailReceiver(receiver, receiver_guid), task.m_sender, MAIL_CHECK_MASK_RETURNED);
-
-                if (!sendall)
-                    --maxcount;
+                task.m_protoMail->SendMailTo(MailReceiver(receiver, receiver_guid), task.m_sender, MAIL_CHECK_MASK_RETURNED, 0, &batch);
                 break;
             }
 
@@ -106,22 +204,30 @@ void MassMailMgr::Update(bool sendall /*= false*/)
             draft.CloneFrom(*task.m_protoMail);
 
             // prevent mail return
-            draft.SendMailTo(MailReceiver(receiver, receiver_guid), task.m_sender, MAIL_CHECK_MASK_RETURNED);
-
-            if (!sendall)
-                --maxcount;
+            draft.SendMailTo(MailReceiver(receiver, receiver_guid), task.m_sender, MAIL_CHECK_MASK_RETURNED, 0, &batch);
         }
 
-        if (task.m_receivers.empty())
-            m_massMails.pop_front();
+        // waiting for next receivers page
+        if (!task.m_receivers.empty() || task.HasMorePages())
+            break;
+
+        sLog.outString("Mass mail task %u finished: %u mails sent in %u seconds", task.m_id, task.m_sent, uint32(time(nullptr) - task.m_startTime));
+        m_massMails.pop_front();
     }
     while (!m_massMails.empty() && (sendall || maxcount > 0));
+
+    batch.Flush();
+    CharacterDatabase.CommitTransaction();
+
+    // new mail notifications after the mails are in the DB, the client can ask for them at once
+    batch.SendNotifications();
 }
 
 void MassMailMgr::GetStatistic(uint32& tasks, uint32& mails, uint32& needTime) const
 {
     tasks = m_massMails.size();
 
+    // receivers of paged tasks are counted only as far as loaded
     uint32 mailsCount = 0;
     for (const auto& m_massMail : m_massMails)
         mailsCount += m_massMail.m_receivers.size();
@@ -37,6 +37,10 @@
 #include "Common.h"
 #include "Mails/Mail.h"
 
+#include <mutex>
+
+class QueryResult;
+
 /**
  * A class to represent the mail send factory to multiple (often all existing) characters.
  *
@@ -45,7 +49,7 @@
 class MassMailMgr
 {
     public:                                                 // Constructors
-        MassMailMgr() {}
+        MassMailMgr() : m_lastTaskId(0) {}
 
     public:                                                 // Accessors
         void GetStatistic(uint32& tasks, uint32& mails, uint32& needTime) const;
@@ -59,7 +63,7 @@ class MassMailMgr
          * @param mailProto     prepared mail for clone and send to characters, will deleted in result call.
          * @param raceMask      mask of races that must receive mail.
          *
-         * Note: this function safe to be called from Map::Update content/etc, real data add will executed in next tick after query results ready
+         * Note: this function safe to be called from Map::Update content/etc, receivers are paged from the DB while the task is sent
          */
         void AddMassMailTask(MailDraft* mailProto, const MailSender& sender, uint32 raceMask);
 
@@ -73,6 +77,17 @@ class MassMailMgr
          */
         void AddMassMailTask(MailDraft* mailProto, const MailSender& sender, char const* query);
 
+        /**
+         * And new mass mail task with SQL query text for receivers paged from the DB while the task is sent.
+         *
+         * @param mailProto     prepared mail for clone and send to characters, will deleted in result call
+         * @param query         SQL query with WHERE clause over existing characters, first field in query result must be uint32 low guids list.
+         * @param guidColumn    column of the selected low guids, used for order and continue the pages
+         *
+         * Note: this function safe to be called from Map::Update content/etc, the task is started in next tick
+         */
+        void AddMassMailTask(MailDraft* mailProto, const MailSender& sender, char const* query, char const* guidColumn);
+
         /**
          * And new mass mail task and let fill receivers list returned as result.
          *
@@ -83,7 +98,7 @@ class MassMailMgr
          */
         ReceiversList& AddMassMailTask(MailDraft* mailProto, const MailSender& sender)
         {
-            m_massMails.emplace_back(mailProto, sender);
+            m_massMails.emplace_back(++m_lastTaskId, mailProto, sender);
             return m_massMails.rbegin()->m_receivers;
         }
 
@@ -97,23 +112,48 @@ class MassMailMgr
         /// Mass mail task store mail prototype and receivers list who not get mail yet
         struct MassMail
         {
-            explicit MassMail(MailDraft* mailProto, MailSender sender)
-                : m_protoMail(mailProto), m_sender(sender)
+            explicit MassMail(uint32 id, MailDraft* mailProto, MailSender sender)
+                : m_id(id), m_protoMail(mailProto), m_sender(sender), m_lastGuid(0), m_requestedGuid(0),
+                  m_pagePending(false), m_lastPage(true), m_sent(0), m_startTime(time(nullptr))
             {
                 MANGOS_ASSERT(mailProto);
             }
             MassMail(MassMail const&) = delete;
 
+            /// receivers still in the DB, not loaded yet
+            bool HasMorePages() const { return !m_lastPage; }
+
+            uint32 m_id;
             std::unique_ptr<MailDraft> m_protoMail;
 
             MailSender m_sender;
             ReceiversList m_receivers;
+
+            // paged receivers, m_query empty for tasks with a complete receivers list
+            std::string m_query;
+            std::string m_guidColumn;
+            uint32 m_lastGuid;                              ///< highest low guid loaded so far
+            uint32 m_requestedGuid;                         ///< m_lastGuid at request of the pending page
+            bool m_pagePending;
+            bool m_lastPage;
+
+            uint32 m_sent;
+            time_t m_startTime;
         };
 
         typedef std::list<MassMail> MassMailList;
 
+        void RequestReceivers(MassMail& task, bool sync);
+        void HandleReceiversPage(QueryResult* result, uint32 taskId, uint32 fromGuid);
+        void LoadReceiversPage(MassMail& task, QueryResult* result);
+
         /// List of current queued mass mail tasks
         MassMailList m_massMails;
+        uint32 m_lastTaskId;
+
+        /// paged tasks added from map threads, moved to m_massMails at next Update
+        MassMailList m_newMassMails;
+        std::mutex m_newMassMailsLock;
 };
 
 #define sMassMailMgr MaNGOS::Singleton<MassMailMgr>::Instance()
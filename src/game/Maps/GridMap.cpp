@@ -28,6 +28,7 @@
 #include "World/World.h"
 #include "Policies/Singleton.h"
 #include "Util/Util.h"
+#include "Util/MappedFile.h"
 
 #include <mutex>
 
@@ -37,6 +38,60 @@ char const* MAP_AREA_MAGIC    = "AREA";
 char const* MAP_HEIGHT_MAGIC  = "MHGT";
 char const* MAP_LIQUID_MAGIC  = "MLIQ";
 
+// reads a map file either through stdio or from a mapping of the whole file
+class GridMapFile
+{
+    public:
+        explicit GridMapFile(FILE* file) : m_file(file), m_mapping(nullptr), m_pos(0) {}
+        explicit GridMapFile(MappedFile const* mapping) : m_file(nullptr), m_mapping(mapping), m_pos(0) {}
+
+        bool Seek(uint32 offset)
+        {
+            if (m_file)
+                return fseek(m_file, offset, SEEK_SET) == 0;
+
+            if (offset > m_mapping->GetSize())
+                return false;
+            m_pos = offset;
+            return true;
+        }
+
+        bool Read(void* dest, size_t size)
+        {
+            if (!size)
+                return true;
+
+            if (m_file)
+                return fread(dest, size, 1, m_file) == 1;
+
+            if (size > m_mapping->GetSize() - m_pos)
+                return false;
+            memcpy(dest, m_mapping->GetData() + m_pos, size);
+            m_pos += size;
+            return true;
+        }
+
+        // count elements at the read position inside the mapping, nullptr if they have to be read into a buffer
+        template<typename T>
+        T* Map(size_t count)
+        {
+            if (!m_mapping || count * sizeof(T) > m_mapping->GetSize() - m_pos)
+                return nullptr;
+
+            unsigned char* data = m_mapping->GetData() + m_pos;
+            if (reinterpret_cast<uintptr_t>(data) % alignof(T) != 0)
+                return nullptr;
+
+            m_pos += count * sizeof(T);
+            return reinterpret_cast<T*>(data);
+        }
+
+    private:
+        FILE* m_file;
+        MappedFile const* m_mapping;
+        size_t m_pos;
+};
+
 static uint16 const holetab_h[4] = { 0x1111, 0x2222, 0x4444, 0x8888 };
 static uint16 const holetab_v[4] = { 0x000F, 0x00F0, 0x0F00, 0xF000 };
 
@@ -82,20 +137,38 @@ bool GridMap::loadData(char const* filename)
     // Unload old data if exist
     unloadData();
 
-    GridMapFileHeader header;
+    if (sWorld.getConfig(CONFIG_BOOL_MAPS_MEMORY_MAPPED))
+    {
+        // arrays point into the mapping, pages are only read when a position in them is queried
+        m_mapping.reset(MappedFile::Open(filename));
+        if (m_mapping)
+        {
+            GridMapFile in(m_mapping.get());
+            return loadData(in, filename);
+        }
+    }
+
     // Not return error if file not found
-    FILE* in = fopen(filename, "rb");
-    if (!in)
+    FILE* file = fopen(filename, "rb");
+    if (!file)
     {
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Failled to found %s", filename);
         // its a valid error only in case of no vmap files are available too
         return true;
     }
 
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    GridMapFile in(file);
+    bool result = loadData(in, filename);
+    fclose(file);
+    return result;
+}
+
+bool GridMap::loadData(GridMapFile& in, char const* filename)
+{
+    GridMapFileHeader header;
+    if (!in.Read(&header, sizeof(header)))
     {
         sLog.outError("Error loading GridMapFileHeader\n");
-        fclose(in);
         return false;
     }
 
@@ -107,7 +180,6 @@ bool GridMap::loadData(char const* filename)
         if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
         {
             sLog.outError("Error loading map area data\n");
-            fclose(in);
             return false;
         }
 
@@ -115,7 +187,6 @@ bool GridMap::loadData(char const* filename)
         if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
         {
             sLog.outError("Error loading map height data\n");
-            fclose(in);
             return false;
         }
 
@@ -123,7 +194,6 @@ bool GridMap::loadData(char const* filename)
         if (header.liquidMapOffset && !loadGridMapLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
         {
             sLog.outError("Error loading map liquids data\n");
-            fclose(in);
             return false;
         }
 
@@ -131,38 +201,49 @@ bool GridMap::loadData(char const* filename)
         if (header.holesOffset && !loadHolesData(in, header.holesOffset, header.holesSize))
         {
             sLog.outError("Error loading map holes data\n");
-            fclose(in);
             return false;
         }
 
-        fclose(in);
         return true;
     }
 
     sLog.outError("Map file '%s' has the wrong version. Please extract the mapfiles again with the latest extractors.", filename);
-    fclose(in);
     return false;
 }
 
 void GridMap::unloadData()
 {
-    if (m_area_map)    { delete[] m_area_map;    m_area_map = nullptr; }
-    if (m_V9)          { delete[] m_V9;          m_V9 = nullptr; }
-    if (m_V8)          { delete[] m_V8;          m_V8 = nullptr; }
-    if (m_liquidEntry) { delete[] m_liquidEntry; m_liquidEntry = nullptr; }
-    if (m_liquidFlags) { delete[] m_liquidFlags; m_liquidFlags = nullptr; }
-    if (m_liquid_map)  { delete[] m_liquid_map;  m_liquid_map = nullptr; }
-    if (m_holes)       { delete[] m_holes;       m_holes = nullptr; }
+    m_area_map = nullptr;
+    m_V9 = nullptr;
+    m_V8 = nullptr;
+    m_liquidEntry = nullptr;
+    m_liquidFlags = nullptr;
+    m_liquid_map = nullptr;
+    m_holes = nullptr;
+    m_buffers.clear();
+    m_mapping.reset();
 
     m_gridGetHeight = &GridMap::getHeightFromFlat;
 }
 
-bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+template<typename T>
+bool GridMap::loadArray(GridMapFile& in, T*& dest, size_t count)
+{
+    dest = in.Map<T>(count);
+    if (dest)
+        return true;
+
+    m_buffers.emplace_back(new char[count * sizeof(T)]);
+    dest = reinterpret_cast<T*>(m_buffers.back().get());
+    return in.Read(dest, count * sizeof(T));
+}
+
+bool GridMap::loadAreaData(GridMapFile& in, uint32 offset, uint32 /*size*/)
 {
     GridMapAreaHeader header;
-    if (fseek(in, offset, SEEK_SET) != 0)
+    if (!in.Seek(offset))
         return false;
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    if (!in.Read(&header, sizeof(header)))
         return false;
     if (header.fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
         return false;
@@ -170,20 +251,19 @@ bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
     m_gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
     {
-        m_area_map = new uint16 [16 * 16];
-        if (fread(m_area_map, sizeof(uint16), 16 * 16, in) != 16 * 16)
+        if (!loadArray(in, m_area_map, 16 * 16))
             return false;
     }
 
     return true;
 }
 
-bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHeightData(GridMapFile& in, uint32 offset, uint32 /*size*/)
 {
     GridMapHeightHeader header;
-    if (fseek(in, offset, SEEK_SET) != 0)
+    if (!in.Seek(offset))
         return false;
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    if (!in.Read(&header, sizeof(header)))
         return false;
     if (header.fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
         return false;
@@ -193,30 +273,21 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16[129 * 129];
-            m_uint16_V8 = new uint16[128 * 128];
-            if (fread(m_uint16_V9, sizeof(uint16), 129 * 129, in) != 129 * 129 ||
-                    fread(m_uint16_V8, sizeof(uint16), 128 * 128, in) != 128 * 128)
+            if (!loadArray(in, m_uint16_V9, 129 * 129) || !loadArray(in, m_uint16_V8, 128 * 128))
                 return false;
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             m_gridGetHeight = &GridMap::getHeightFromUint16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8[129 * 129];
-            m_uint8_V8 = new uint8[128 * 128];
-            if (fread(m_uint8_V9, sizeof(uint8), 129 * 129, in) != 129 * 129 ||
-                    fread(m_uint8_V8, sizeof(uint8), 128 * 128, in) != 128 * 128)
+            if (!loadArray(in, m_uint8_V9, 129 * 129) || !loadArray(in, m_uint8_V8, 128 * 128))
                 return false;
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             m_gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float[129 * 129];
-            m_V8 = new float[128 * 128];
-            if (fread(m_V9, sizeof(float), 129 * 129, in) != 129 * 129 ||
-                    fread(m_V8, sizeof(float), 128 * 128, in) != 128 * 128)
+            if (!loadArray(in, m_V9, 129 * 129) || !loadArray(in, m_V8, 128 * 128))
                 return false;
             m_gridGetHeight = &GridMap::getHeightFromFloat;
         }
@@ -227,20 +298,19 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
-bool GridMap::loadHolesData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHolesData(GridMapFile& in, uint32 offset, uint32 /*size*/)
 {
-    if (fseek(in, offset, SEEK_SET) != 0)
+    if (!in.Seek(offset))
         return false;
-    m_holes = new uint16[16 * 16];
-    return fread(m_holes, sizeof(uint16), 16 * 16, in) == 16 * 16;
+    return loadArray(in, m_holes, 16 * 16);
 }
 
-bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadGridMapLiquidData(GridMapFile& in, uint32 offset, uint32 /*size*/)
 {
     GridMapLiquidHeader header;
-    if (fseek(in, offset, SEEK_SET) != 0)
+    if (!in.Seek(offset))
         return false;
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    if (!in.Read(&header, sizeof(header)))
         return false;
     if (header.fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
         return false;
@@ -255,19 +325,13 @@ bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        m_liquidEntry = new uint16[16 * 16];
-        if (fread(m_liquidEntry, sizeof(uint16), 16 * 16, in) != 16 * 16)
-            return false;
-
-        m_liquidFlags = new uint8[16 * 16];
-        if (fread(m_liquidFlags, sizeof(uint8), 16 * 16, in) != 16 * 16)
+        if (!loadArray(in, m_liquidEntry, 16 * 16) || !loadArray(in, m_liquidFlags, 16 * 16))
             return false;
     }
 
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
     {
-        m_liquid_map = new float[m_liquid_width * m_liquid_height];
-        if (fread(m_liquid_map, sizeof(float), m_liquid_width * m_liquid_height, in) != size_t(m_liquid_width * m_liquid_height))
+        if (!loadArray(in, m_liquid_map, m_liquid_width * m_liquid_height))
             return false;
     }
 
@@ -790,6 +854,12 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
     {
         for (int x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
         {
+            if (!m_GridMaps[x][y])
+                continue;
+
+            // the grid preloader may reference and load grids concurrently
+            LOCK_GUARD lock(m_mutex);
+            LOCK_GUARD refLock(m_refMutex);
             const int16& iRef = m_GridRef[x][y];
             GridMap* pMap = m_GridMaps[x][y];
 
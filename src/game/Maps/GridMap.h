@@ -27,7 +27,9 @@
 #include "Maps/GridMapDefines.h"
 
 #include <atomic>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 class Creature;
 class Unit;
@@ -36,6 +38,8 @@ class InstanceData;
 class Group;
 class BattleGround;
 class Map;
+class GridMapFile;
+class MappedFile;
 
 namespace VMAP
 {
@@ -84,10 +88,17 @@ class GridMap
         // For fast check
         bool m_fullyLoaded;
 
-        bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-        bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-        bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
-        bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+        // the arrays above point either into m_mapping or into one of m_buffers
+        std::unique_ptr<MappedFile> m_mapping;
+        std::vector<std::unique_ptr<char[]>> m_buffers;
+
+        template<typename T>
+        bool loadArray(GridMapFile& in, T*& dest, size_t count);
+        bool loadData(GridMapFile& in, char const* filename);
+        bool loadAreaData(GridMapFile& in, uint32 offset, uint32 size);
+        bool loadHeightData(GridMapFile& in, uint32 offset, uint32 size);
+        bool loadGridMapLiquidData(GridMapFile& in, uint32 offset, uint32 size);
+        bool loadHolesData(GridMapFile& in, uint32 offset, uint32 size);
         bool isHole(int row, int col) const;
 
         // Get height functions and pointers
@@ -170,7 +181,7 @@ class TerrainInfo : public Referencable<std::atomic_long>
         // this method should be used only by TerrainManager
         // to cleanup unreferenced GridMap objects - they are too heavy
         // to destroy them dynamically, especially on highly populated servers
-        // THIS METHOD IS NOT THREAD-SAFE!!!! AND IT SHOULDN'T BE THREAD-SAFE!!!!
+        // must not run while map threads update, only the grid preloader may load grids meanwhile
         void CleanUpGrids(const uint32 diff);
 
         bool CanCheckLiquidLevel(float x, float y) const;
@@ -178,6 +189,7 @@ class TerrainInfo : public Referencable<std::atomic_long>
     protected:
         friend class Map;
         friend class ObjectMgr;
+        friend class GridPreloader;
         // load/unload terrain data
         GridMap* Load(const uint32 x, const uint32 y, bool mapOnly = false);
         void Unload(const uint32 x, const uint32 y);
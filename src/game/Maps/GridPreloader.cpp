@@ -0,0 +1,331 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/GridPreloader.h"
+#include "Policies/Singleton.h"
+#include "Entities/Player.h"
+#include "Maps/Map.h"
+#include "Maps/GridMap.h"
+#include "Maps/GridDefines.h"
+#include "MotionGenerators/MoveMap.h"
+#include "Movement/MoveSpline.h"
+#include "World/World.h"
+#include "Log.h"
+
+#include <cstdio>
+
+INSTANTIATE_SINGLETON_1(GridPreloader);
+
+// queue value left untouched when the queue is cancelled
+#define GRID_PRELOAD_NO_KEY UINT64_C(0xFFFFFFFFFFFFFFFF)
+
+GridPreloader::GridPreloader() : m_lookAhead(0)
+{
+}
+
+GridPreloader::~GridPreloader()
+{
+    Stop();
+}
+
+void GridPreloader::Initialize(uint32 threads, uint32 lookAhead, bool instancePrewarm)
+{
+    m_lookAhead = lookAhead;
+    if (!m_lookAhead && !instancePrewarm)
+        return;
+
+    for (uint32 i = 0; i < threads; ++i)
+        m_threads.emplace_back(&GridPreloader::WorkerThread, this);
+
+    if (!m_threads.empty())
+        sLog.outString("Grid preloader started with %u threads, looking %u ms ahead%s", threads, lookAhead, instancePrewarm ? ", keeping instance maps warm" : "");
+}
+
+void GridPreloader::Stop()
+{
+    if (m_threads.empty())
+        return;
+
+    m_queue.Cancel();
+    for (std::thread& thread : m_threads)
+        thread.join();
+    m_threads.clear();
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (auto& entry : m_entries)
+        Release(entry.second);
+    m_entries.clear();
+    m_stagedNavTiles.clear();
+}
+
+void GridPreloader::Update(uint32 diff)
+{
+    if (m_threads.empty())
+        return;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (auto itr = m_entries.begin(); itr != m_entries.end();)
+    {
+        PreloadEntry& entry = itr->second;
+        entry.expireTime -= int32(diff);
+        // entries still waiting for a worker are kept, the worker expects them
+        if (entry.warm || entry.expireTime > 0 || !entry.loaded)
+        {
+            ++itr;
+            continue;
+        }
+
+        Release(entry);
+        itr = m_entries.erase(itr);
+    }
+}
+
+void GridPreloader::Release(PreloadEntry& entry)
+{
+    // the grid keeps loaded while the map references it, otherwise it is collected by TerrainInfo::CleanUpGrids
+    if (entry.loaded)
+        entry.terrain->Unload(entry.gridX, entry.gridY);
+    if (!entry.navTilePath.empty())
+        m_stagedNavTiles.erase(entry.navTilePath);
+    if (entry.terrain->Release())
+        sTerrainMgr.UnloadTerrain(entry.mapId);
+}
+
+void GridPreloader::WarmGrids(uint32 mapId, std::vector<uint32> const& grids)
+{
+    if (m_threads.empty())
+        return;
+
+    TerrainInfo* terrain = sTerrainMgr.LoadTerrain(mapId);
+    for (uint32 grid : grids)
+        QueueTerrainGrid(terrain, mapId, grid >> 16, grid & 0xFFFF, 0, true);
+}
+
+void GridPreloader::ReleaseWarmMap(uint32 mapId)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (auto& entry : m_entries)
+    {
+        if (entry.second.mapId != mapId || !entry.second.warm)
+            continue;
+
+        // released by Update once loaded, like an expired preload
+        entry.second.warm = false;
+        entry.second.expireTime = 0;
+        if (!entry.second.navTilePath.empty())
+        {
+            auto itr = m_stagedNavTiles.find(entry.second.navTilePath);
+            if (itr != m_stagedNavTiles.end())
+                itr->second.warm = false;
+        }
+    }
+}
+
+void GridPreloader::PredictFor(Player* player)
+{
+    if (m_threads.empty() || !m_lookAhead || !player->IsInWorld())
+        return;
+
+    TerrainInfo* terrain = const_cast<TerrainInfo*>(player->GetMap()->GetTerrain());
+    uint32 const mapId = player->GetMapId();
+    float const lookAhead = m_lookAhead / 1000.0f;
+    // keep the preload a while after the player should have arrived
+    uint32 const expireTime = m_lookAhead * 2;
+
+    GridPair lastGrid = MaNGOS::ComputeGridPair(player->GetPositionX(), player->GetPositionY());
+
+    if (player->IsTaxiFlying())
+    {
+        Movement::MoveSpline const& spline = *player->movespline;
+        if (spline.Finalized() || !spline.Duration())
+            return;
+
+        auto const& path = spline._Spline().getPoints();
+        float length = 0.0f;
+        for (size_t i = 1; i < path.size(); ++i)
+            length += (path[i] - path[i - 1]).length();
+
+        // follow the flight path as far as the spline gets in the look ahead time
+        float distance = length * lookAhead * IN_MILLISECONDS / spline.Duration();
+        for (size_t i = std::max(spline.currentPathIdx(), 0) + 1; i < path.size() && distance > 0.0f; ++i)
+        {
+            distance -= (path[i] - path[i - 1]).length();
+
+            GridPair grid = MaNGOS::ComputeGridPair(path[i].x, path[i].y);
+            if (grid != lastGrid)
+            {
+                QueueGrid(terrain, mapId, path[i].x, path[i].y, expireTime);
+                lastGrid = grid;
+            }
+        }
+        return;
+    }
+
+    if (!player->IsMovingForward())
+        return;
+
+    // only fast movers outrun the grids loaded around them
+    float const speed = player->GetSpeed(player->IsFlying() ? MOVE_FLIGHT : MOVE_RUN);
+    if (speed < baseMoveSpeed[MOVE_RUN] * 1.5f)
+        return;
+
+    float const distance = speed * lookAhead;
+    float const dx = cos(player->GetOrientation());
+    float const dy = sin(player->GetOrientation());
+    for (float step = SIZE_OF_GRIDS / 2; step < distance + SIZE_OF_GRIDS / 2; step += SIZE_OF_GRIDS / 2)
+    {
+        float const travelled = std::min(step, distance);
+        float const x = player->GetPositionX() + dx * travelled;
+        float const y = player->GetPositionY() + dy * travelled;
+        if (!MaNGOS::IsValidMapCoord(x, y))
+            break;
+
+        GridPair grid = MaNGOS::ComputeGridPair(x, y);
+        if (grid != lastGrid)
+        {
+            QueueGrid(terrain, mapId, x, y, expireTime);
+            lastGrid = grid;
+        }
+    }
+}
+
+void GridPreloader::QueueGrid(TerrainInfo* terrain, uint32 mapId, float x, float y, uint32 expireTime)
+{
+    if (!MaNGOS::IsValidMapCoord(x, y))
+        return;
+
+    GridPair grid = MaNGOS::ComputeGridPair(x, y);
+    // terrain grid numbering, see Map::EnsureGridCreated
+    QueueTerrainGrid(terrain, mapId, (MAX_NUMBER_OF_GRIDS - 1) - grid.x_coord, (MAX_NUMBER_OF_GRIDS - 1) - grid.y_coord, expireTime, false);
+}
+
+void GridPreloader::QueueTerrainGrid(TerrainInfo* terrain, uint32 mapId, uint32 gridX, uint32 gridY, uint32 expireTime, bool warm)
+{
+    uint64 const key = MakeKey(mapId, gridX, gridY);
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto itr = m_entries.find(key);
+        if (itr != m_entries.end())
+        {
+            itr->second.expireTime = std::max(itr->second.expireTime, int32(expireTime));
+            if (warm && !itr->second.warm)
+            {
+                itr->second.warm = true;
+                auto tile = m_stagedNavTiles.find(itr->second.navTilePath);
+                if (tile != m_stagedNavTiles.end())
+                    tile->second.warm = true;
+            }
+            return;
+        }
+
+        terrain->AddRef();
+        PreloadEntry& entry = m_entries[key];
+        entry.terrain = terrain;
+        entry.mapId = mapId;
+        entry.gridX = gridX;
+        entry.gridY = gridY;
+        entry.expireTime = int32(expireTime);
+        entry.loaded = false;
+        entry.warm = warm;
+    }
+
+    m_queue.Push(std::move(key));
+}
+
+void GridPreloader::WorkerThread()
+{
+    while (true)
+    {
+        uint64 key = GRID_PRELOAD_NO_KEY;
+        m_queue.WaitAndPop(key);
+        if (key == GRID_PRELOAD_NO_KEY)
+            break;
+
+        TerrainInfo* terrain;
+        uint32 mapId, gridX, gridY;
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            auto itr = m_entries.find(key);
+            if (itr == m_entries.end())
+                continue;
+            terrain = itr->second.terrain;
+            mapId = itr->second.mapId;
+            gridX = itr->second.gridX;
+            gridY = itr->second.gridY;
+        }
+
+        // references the grid, map tile and vmap tile get loaded like from a map thread
+        terrain->Load(gridX, gridY);
+
+        // navmesh tiles belong to the navmesh of each map instance and are only added by its map thread
+        std::string navTilePath;
+        std::vector<unsigned char> navTile;
+        if (MMAP::MMapFactory::IsPathfindingEnabled(mapId, nullptr))
+        {
+            char fileName[100];
+            snprintf(fileName, sizeof(fileName), "%03u%02u%02u.mmtile", mapId, gridX, gridY);
+            navTilePath = sWorld.GetDataPath() + "mmaps/" + fileName;
+            if (FILE* file = fopen(navTilePath.c_str(), "rb"))
+            {
+                fseek(file, 0, SEEK_END);
+                long size = ftell(file);
+                fseek(file, 0, SEEK_SET);
+                navTile.resize(size > 0 ? size_t(size) : 0);
+                if (navTile.empty() || fread(&navTile[0], navTile.size(), 1, file) != 1)
+                    navTile.clear();
+                fclose(file);
+            }
+            if (navTile.empty())
+                navTilePath.clear();
+        }
+
+        std::lock_guard<std::mutex> guard(m_mutex);
+        PreloadEntry& entry = m_entries[key];
+        entry.loaded = true;
+        if (!navTilePath.empty())
+        {
+            entry.navTilePath = navTilePath;
+            StagedNavTile& staged = m_stagedNavTiles[navTilePath];
+            staged.data = std::move(navTile);
+            staged.warm = entry.warm;
+        }
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Preloaded grid [%u,%u] of map %u", gridX, gridY, mapId);
+    }
+}
+
+bool GridPreloader::TakeStagedNavTile(std::string const& filePath, std::vector<unsigned char>& data)
+{
+    if (m_threads.empty())
+        return false;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto itr = m_stagedNavTiles.find(filePath);
+    if (itr == m_stagedNavTiles.end())
+        return false;
+
+    if (itr->second.warm)
+    {
+        data = itr->second.data;
+        return true;
+    }
+
+    data = std::move(itr->second.data);
+    m_stagedNavTiles.erase(itr);
+    return true;
+}
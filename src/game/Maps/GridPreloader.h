@@ -0,0 +1,99 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_GRIDPRELOADER_H
+#define MANGOS_GRIDPRELOADER_H
+
+#include "Common.h"
+#include "Util/ProducerConsumerQueue.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Player;
+class TerrainInfo;
+
+// Loads terrain, vmap and mmap tiles ahead of fast moving players on background threads.
+// The map thread still loads the grid objects itself when the player arrives, but finds the
+// geometry already in memory and the navmesh tile already read from disk.
+// Grids of often created instance maps can also be kept warm, so new instances of them start
+// without touching the disk (see InstancePrewarm.Maps).
+class GridPreloader
+{
+    public:
+        GridPreloader();
+        ~GridPreloader();
+
+        void Initialize(uint32 threads, uint32 lookAhead, bool instancePrewarm);
+        void Stop();
+
+        // world thread, releases preloads that were not needed in time
+        void Update(uint32 diff);
+
+        // map thread of player, queues the grids on the way of fast movers
+        void PredictFor(Player* player);
+
+        // world thread, keeps the given terrain grids (gridX << 16 | gridY) loaded until ReleaseWarmMap
+        void WarmGrids(uint32 mapId, std::vector<uint32> const& grids);
+        void ReleaseWarmMap(uint32 mapId);
+
+        // navmesh tile read in the background, consumed by the first load of that file
+        // unless its grid is kept warm, then every instance gets a copy
+        bool TakeStagedNavTile(std::string const& filePath, std::vector<unsigned char>& data);
+
+    private:
+        struct PreloadEntry
+        {
+            TerrainInfo* terrain;
+            uint32 mapId;
+            uint32 gridX;
+            uint32 gridY;
+            int32 expireTime;
+            bool loaded;
+            bool warm;
+            std::string navTilePath;
+        };
+
+        struct StagedNavTile
+        {
+            std::vector<unsigned char> data;
+            bool warm;
+        };
+
+        void QueueGrid(TerrainInfo* terrain, uint32 mapId, float x, float y, uint32 expireTime);
+        void QueueTerrainGrid(TerrainInfo* terrain, uint32 mapId, uint32 gridX, uint32 gridY, uint32 expireTime, bool warm);
+        void WorkerThread();
+        void Release(PreloadEntry& entry);
+
+        static uint64 MakeKey(uint32 mapId, uint32 gridX, uint32 gridY) { return (uint64(mapId) << 32) | (gridX << 16) | gridY; }
+
+        uint32 m_lookAhead;
+        std::vector<std::thread> m_threads;
+        ProducerConsumerQueue<uint64> m_queue;
+
+        std::mutex m_mutex;
+        std::unordered_map<uint64, PreloadEntry> m_entries;
+        std::unordered_map<std::string, StagedNavTile> m_stagedNavTiles;
+};
+
+#define sGridPreloader MaNGOS::Singleton<GridPreloader>::Instance()
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/LineOfSightCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// slots per map, direct mapped, a colliding pair simply replaces the older result
+#define LOS_CACHE_SIZE          2048
+// endpoints closer than this are treated as the same position
+#define LOS_CACHE_GRANULARITY   0.5f
+
+LineOfSightCache::LineOfSightCache() : m_slots(new Slot[LOS_CACHE_SIZE]), m_generation(1), m_lookups(0), m_hits(0)
+{
+    // generation 0 is never current, all slots start out empty
+    std::memset(m_slots.get(), 0, sizeof(Slot) * LOS_CACHE_SIZE);
+}
+
+bool LineOfSightCache::Key::operator==(Key const& other) const
+{
+    return std::memcmp(coords, other.coords, sizeof(coords)) == 0 && phasemask == other.phasemask && ignoreM2Model == other.ignoreM2Model;
+}
+
+LineOfSightCache::Key LineOfSightCache::MakeKey(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model)
+{
+    Key key;
+    key.coords[0] = int32(std::floor(srcX / LOS_CACHE_GRANULARITY));
+    key.coords[1] = int32(std::floor(srcY / LOS_CACHE_GRANULARITY));
+    key.coords[2] = int32(std::floor(srcZ / LOS_CACHE_GRANULARITY));
+    key.coords[3] = int32(std::floor(destX / LOS_CACHE_GRANULARITY));
+    key.coords[4] = int32(std::floor(destY / LOS_CACHE_GRANULARITY));
+    key.coords[5] = int32(std::floor(destZ / LOS_CACHE_GRANULARITY));
+    key.phasemask = phasemask;
+    key.ignoreM2Model = ignoreM2Model;
+
+    // sight is symmetric, both directions of a pair share the slot
+    if (std::lexicographical_compare(key.coords + 3, key.coords + 6, key.coords, key.coords + 3))
+        std::swap_ranges(key.coords, key.coords + 3, key.coords + 3);
+    return key;
+}
+
+uint32 LineOfSightCache::GetSlotIndex(Key const& key)
+{
+    // FNV-1a over the quantized coordinates
+    uint32 hash = 2166136261u;
+    for (int32 coord : key.coords)
+        hash = (hash ^ uint32(coord)) * 16777619u;
+    hash = (hash ^ key.phasemask) * 16777619u;
+    hash = (hash ^ uint32(key.ignoreM2Model)) * 16777619u;
+    return hash & (LOS_CACHE_SIZE - 1);
+}
+
+bool LineOfSightCache::Lookup(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model, bool& result)
+{
+    Key const key = MakeKey(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model);
+    uint32 const index = GetSlotIndex(key);
+    ++m_lookups;
+
+    std::lock_guard<std::mutex> guard(m_locks[index & 15]);
+    Slot const& slot = m_slots[index];
+    if (slot.generation != m_generation || !(slot.key == key))
+        return false;
+
+    result = slot.result;
+    ++m_hits;
+    return true;
+}
+
+void LineOfSightCache::Store(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model, bool result, uint32 generation)
+{
+    if (generation != m_generation)
+        return;
+
+    Key const key = MakeKey(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model);
+    uint32 const index = GetSlotIndex(key);
+
+    std::lock_guard<std::mutex> guard(m_locks[index & 15]);
+    Slot& slot = m_slots[index];
+    slot.key = key;
+    slot.generation = generation;
+    slot.result = result;
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LINEOFSIGHTCACHE_H
+#define MANGOS_LINEOFSIGHTCACHE_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// Caches line of sight results of one map for the current update tick.
+// Endpoints are quantized so that the same creature and player pair standing still hits the
+// same slot every time it is queried, in either direction. Results are dropped at the start of every tick and
+// whenever a gameobject model of the map changes, so the cache never outlives the geometry.
+// Safe to use from the cell updater threads, slots are guarded by striped locks.
+class LineOfSightCache
+{
+    public:
+        LineOfSightCache();
+
+        // drops every cached result, cheap enough to be called on each model change
+        void Invalidate() { ++m_generation; }
+
+        // generation must be taken before the query so a result computed across an invalidation is never stored
+        uint32 GetGeneration() const { return m_generation; }
+
+        bool Lookup(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model, bool& result);
+        void Store(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model, bool result, uint32 generation);
+
+        uint32 GetLookups() const { return m_lookups; }
+        uint32 GetHits() const { return m_hits; }
+        void ResetStats() { m_lookups = 0; m_hits = 0; }
+
+    private:
+        struct Key
+        {
+            int32 coords[6];
+            uint32 phasemask;
+            bool ignoreM2Model;
+
+            bool operator==(Key const& other) const;
+        };
+
+        struct Slot
+        {
+            Key key;
+            uint32 generation;
+            bool result;
+        };
+
+        static Key MakeKey(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model);
+        static uint32 GetSlotIndex(Key const& key);
+
+        std::unique_ptr<Slot[]> m_slots;
+        std::mutex m_locks[16];
+        std::atomic<uint32> m_generation;
+        std::atomic<uint32> m_lookups;
+        std::atomic<uint32> m_hits;
+};
+
+#endif
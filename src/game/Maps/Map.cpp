@@ -37,20 +37,102 @@
 #include "Maps/MapPersistentStateMgr.h"
 #include "Vmap/VMapFactory.h"
 #include "MotionGenerators/MoveMap.h"
+#include "MotionGenerators/PathRequestQueue.h"
+#include "MotionGenerators/PathCache.h"
+#include "MotionGenerators/WaypointSegmentCache.h"
+#include "Movement/MoveSplineBatch.h"
+#include "Maps/MapCostSampler.h"
+#include "Maps/GridPreloader.h"
 #include "Calendar/Calendar.h"
 #include "Chat/Chat.h"
 #include "Weather/Weather.h"
 #include "Grids/ObjectGridLoader.h"
 #include "Vmap/GameObjectModel.h"
 #include "LFG/LFGMgr.h"
+#include "Maps/MapWorkers.h"
+#include "World/TickProfiler.h"
+#include "World/TickPacer.h"
 
 #ifdef BUILD_METRICS
  #include "Metric/Metric.h"
+
+// pre-registered handles of Map::Update, tagged by map id only. Instance ids
+// have no bound, instances of the same map are summed up instead.
+struct MapUpdateMetrics
+{
+    explicit MapUpdateMetrics(metric::tag_map const& tags) :
+        update(metric::aggregates::instance().register_histogram("map.update", tags)),
+        session(metric::aggregates::instance().register_histogram("map.update.session", tags)),
+        cells(metric::aggregates::instance().register_histogram("map.update.cells", tags)),
+        messageLatency(metric::aggregates::instance().register_histogram("map.update.message_latency", tags)),
+        objects(metric::aggregates::instance().register_counter("map.update.objects", tags)),
+        sessions(metric::aggregates::instance().register_counter("map.update.sessions", tags)),
+        splineBatch(metric::aggregates::instance().register_counter("map.update.spline_batch", tags)),
+        messages(metric::aggregates::instance().register_counter("map.update.messages", tags)),
+        losLookups(metric::aggregates::instance().register_counter("map.update.los_lookups", tags)),
+        losHits(metric::aggregates::instance().register_counter("map.update.los_hits", tags)),
+        pathRequests(metric::aggregates::instance().register_counter("map.update.path_requests", tags)),
+        pathCacheLookups(metric::aggregates::instance().register_counter("map.update.path_cache_lookups", tags)),
+        pathCacheHits(metric::aggregates::instance().register_counter("map.update.path_cache_hits", tags)),
+        waypointSegmentLookups(metric::aggregates::instance().register_counter("map.update.waypoint_segment_lookups", tags)),
+        waypointSegmentHits(metric::aggregates::instance().register_counter("map.update.waypoint_segment_hits", tags)),
+        playerbotAiUs(metric::aggregates::instance().register_counter("map.update.playerbot_ai_us", tags)),
+        playerbotAiRuns(metric::aggregates::instance().register_counter("map.update.playerbot_ai_runs", tags)),
+        playerbotAiDeferred(metric::aggregates::instance().register_counter("map.update.playerbot_ai_deferred", tags))
+    {}
+
+    static MapUpdateMetrics const& Get(uint32 mapId)
+    {
+        static std::mutex lock;
+        static std::map<uint32, std::unique_ptr<MapUpdateMetrics>> metrics;
+
+        std::lock_guard<std::mutex> guard(lock);
+        std::unique_ptr<MapUpdateMetrics>& entry = metrics[mapId];
+        if (!entry)
+            entry.reset(new MapUpdateMetrics({ { "map_id", std::to_string(mapId) } }));
+        return *entry;
+    }
+
+    metric::histogram& update;
+    metric::histogram& session;
+    metric::histogram& cells;
+    metric::histogram& messageLatency;
+    metric::counter& objects;
+    metric::counter& sessions;
+    metric::counter& splineBatch;
+    metric::counter& messages;
+    metric::counter& losLookups;
+    metric::counter& losHits;
+    metric::counter& pathRequests;
+    metric::counter& pathCacheLookups;
+    metric::counter& pathCacheHits;
+    metric::counter& waypointSegmentLookups;
+    metric::counter& waypointSegmentHits;
+    metric::counter& playerbotAiUs;
+    metric::counter& playerbotAiRuns;
+    metric::counter& playerbotAiDeferred;
+};
 #endif
 
+thread_local Map const* MapAccessScope::m_map = nullptr;
+
+void MapAccessScope::Validate(WorldObject const* object, char const* accessor)
+{
+    uint32 const mode = sWorld.getConfig(CONFIG_UINT32_VALIDATE_MAP_THREAD_ACCESS);
+    if (!mode || !m_map || !object || !object->IsInWorld() || object->GetMap() == m_map)
+        return;
+
+    sLog.outError("MapAccessScope: %s returned %s of map %u (instance %u) to a thread bound to map %u (instance %u)",
+                  accessor, object->GetGuidStr().c_str(), object->GetMapId(), object->GetInstanceId(), m_map->GetId(), m_map->GetInstanceId());
+
+    if (mode > 1)
+        MANGOS_ASSERT(false && "cross-map access from a map thread");
+}
+
 Map::~Map()
 {
     UnloadAll(true);
+    m_objectPool->Release();
 
     if (!m_scriptSchedule.empty())
         sScriptMgr.DecreaseScheduledScriptCount(m_scriptSchedule.size());
@@ -62,6 +144,7 @@ Map::~Map()
     i_data = nullptr;
 
     // unload instance specific navigation data
+    m_navMeshQueries.reset();
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
 
     // release reference count
@@ -148,6 +231,7 @@ void Map::SetNavTile(uint32 tileX, uint32 tileY, uint32 tileNumber)
 {
     MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
     mmap->ChangeTile(GetId(), GetInstanceId(), tileX, tileY, tileNumber);
+    m_pathCache->Invalidate();
 }
 
 void Map::AwardLFGRewards(uint32 dungeonId)
@@ -190,30 +274,157 @@ void Map::ChangeGOPathfinding(uint32 entry, uint32 displayId, bool apply)
         }
         m_tileNumberPerTile[dataXY] = tileNumber;
     }
+
+    if (!tileIds.empty())
+        m_pathCache->Invalidate();
 }
 
 void Map::LoadMapAndVMap(int gx, int gy)
 {
     if (m_bLoadedGrids[gx][gy])
+    {
+        // terrain stays, the navmesh tile may have been evicted while the grid was unloaded
+        LoadNavTile(gx, gy);
         return;
+    }
 
     if (m_TerrainData->Load(gx, gy)) // fails also on maps which have no tiles for everything except mmaps
         m_bLoadedGrids[gx][gy] = true;
 
     if (!MMAP::MMapFactory::createOrGetMMapManager()->IsMMapTileLoaded(GetId(), GetInstanceId(), gx, gy))
-        MMAP::MMapFactory::createOrGetMMapManager()->loadMap(GetId(), GetInstanceId(), gx, gy, 0);
+    {
+        // paths ending at the old border may now have a shorter corridor through the new tile
+        if (MMAP::MMapFactory::createOrGetMMapManager()->loadMap(GetId(), GetInstanceId(), gx, gy, 0))
+            m_pathCache->Invalidate();
+    }
+}
+
+bool Map::LoadNavTile(int gx, int gy)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_navTileLock);
+        if (!m_evictedNavTiles.erase(uint32(gx) << 16 | uint32(gy)))
+            return false;
+    }
+
+    if (!MMAP::MMapFactory::createOrGetMMapManager()->loadMap(GetId(), GetInstanceId(), gx, gy, 0))
+        return false;
+
+    m_pathCache->Invalidate();
+    return true;
 }
 
+void Map::RequestNavTile(float x, float y)
+{
+    GridPair const p = MaNGOS::ComputeGridPair(x, y);
+    uint32 const gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+    uint32 const gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+    uint32 const packed = gx << 16 | gy;
+
+    std::lock_guard<std::mutex> guard(m_navTileLock);
+    if (m_evictedNavTiles.find(packed) != m_evictedNavTiles.end())
+        m_navTileRequests.insert(packed);
+}
+
+void Map::UpdateLoadShedding(uint32 diff)
+{
+    uint32 const previous = m_loadShedder.GetLevel();
+    if (!m_loadShedder.Update(diff, m_updateCost) || (!previous && !m_loadShedder.GetLevel()))
+        return;
+
+    // reapplied on every evaluation, picks up a visibility or relocation config reload
+    float const factor = m_loadShedder.GetRelocationFactor();
+    m_relocationLowerLimitSq = World::GetRelocationLowerLimitSq() * factor * factor;
+    m_relocationAINotifyDelay = uint32(World::GetRelocationAINotifyDelay() * factor);
+    if (m_loadShedder.GetLevel())
+    {
+        float const minDistance = std::min(m_VisibleDistance, sWorld.getConfig(CONFIG_FLOAT_VISIBILITY_SHEDDING_MIN_DISTANCE));
+        m_shedVisibleDistance = std::max(m_VisibleDistance * m_loadShedder.GetDistanceFactor(), minDistance);
+    }
+    else
+        m_shedVisibleDistance = 0.0f;
+
+    if (m_loadShedder.GetLevel() == previous)
+        return;
+
+    sLog.outString("Map %u instance %u: update time %u ms, visibility load shedding level %u -> %u, distance %.1f",
+        i_id, i_InstanceId, uint32(m_updateCost / IN_MILLISECONDS), previous, m_loadShedder.GetLevel(), GetVisibilityDistance());
+#ifdef BUILD_METRICS
+    metric::measurement meas("map.visibility_shedding", {
+        { "map_id", std::to_string(i_id) },
+        { "instance_id", std::to_string(i_InstanceId) }
+    });
+    meas.add_field("level", std::to_string(m_loadShedder.GetLevel()));
+    meas.add_field("distance", std::to_string(GetVisibilityDistance()));
+    meas.add_field("update_cost", std::to_string(m_updateCost));
+#endif
+}
+
+void Map::UpdateNavTiles(uint32 diff)
+{
+    std::set<uint32> requests;
+    {
+        std::lock_guard<std::mutex> guard(m_navTileLock);
+        requests.swap(m_navTileRequests);
+    }
+
+    for (uint32 packed : requests)
+        LoadNavTile(packed >> 16, packed & 0x0000FFFF);
+
+    uint32 const budget = sWorld.getConfig(CONFIG_UINT32_MMAP_MEMORY_BUDGET);
+    m_navTileTimer.Update(diff);
+    if (!budget || !m_navTileTimer.Passed())
+        return;
+    m_navTileTimer.Reset();
+
+    // tiles under loaded grids are in use, everything else may go once all maps together exceed the budget
+    std::vector<uint32> evicted;
+    MMAP::MMapFactory::createOrGetMMapManager()->EvictTiles(GetId(), GetInstanceId(), size_t(budget) * 1024 * 1024, [this](uint32 gx, uint32 gy)
+    {
+        if (gx >= MAX_NUMBER_OF_GRIDS || gy >= MAX_NUMBER_OF_GRIDS)
+            return true;
+        return getNGrid((MAX_NUMBER_OF_GRIDS - 1) - gx, (MAX_NUMBER_OF_GRIDS - 1) - gy) != nullptr;
+    }, evicted);
+
+    if (evicted.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_navTileLock);
+        m_evictedNavTiles.insert(evicted.begin(), evicted.end());
+    }
+    m_pathCache->Invalidate();
+}
+
+// freed creature/gameobject blocks kept per size class, enough for a few unloaded grids
+static size_t const MAP_OBJECT_POOL_CACHED_BLOCKS = 1024;
+
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
     : i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
       i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
-      m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(nullptr),
+      m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_shedVisibleDistance(0.0f),
+      m_relocationLowerLimitSq(World::GetRelocationLowerLimitSq()), m_relocationAINotifyDelay(World::GetRelocationAINotifyDelay()), m_persistentState(nullptr),
       m_activeNonPlayersIter(m_activeNonPlayers.end()), m_onEventNotifiedIter(m_onEventNotifiedObjects.end()),
       i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-      i_data(nullptr), i_script_id(0), m_transportsIterator(m_transports.begin()), m_defaultLight(GetDefaultMapLight(id)), m_spawnManager(*this),
-      m_variableManager(this)
+      i_data(nullptr), i_script_id(0), m_weatherUpdateDiff(0), m_transportsIterator(m_transports.begin()), m_defaultLight(GetDefaultMapLight(id)), m_spawnManager(*this),
+      m_variableManager(this), m_lastUpdateCost(0), m_updateCost(0), m_updateGeneration(0),
+      m_createdGridCount(0), m_gridLoads(0), m_gridUnloads(0), m_updateMetrics(nullptr)
 {
     m_weatherSystem = new WeatherSystem(this);
+    m_gridPreloadTimer.SetInterval(IN_MILLISECONDS);
+    m_navTileTimer.SetInterval(5 * IN_MILLISECONDS);
+    m_gridStatsTimer.SetInterval(MINUTE * IN_MILLISECONDS);
+    m_relocationNotifyTimer.SetInterval(sWorld.getConfig(CONFIG_UINT32_VISIBILITY_COALESCE_INTERVAL));
+    m_pathRequests.reset(new PathRequestQueue());
+    m_pathCache.reset(new PathCache());
+    m_pathCache->SetCapacity(sWorld.getConfig(CONFIG_UINT32_PATH_FIND_CACHE_SIZE));
+    m_waypointSegmentCache.reset(new WaypointSegmentCache());
+    m_splineBatch.reset(new Movement::MoveSplineBatch());
+    m_costSampler.reset(new MapCostSampler(id));
+    m_objectPool = new SlabPool(MAP_OBJECT_POOL_CACHED_BLOCKS);
+#ifdef BUILD_METRICS
+    m_updateMetrics = &MapUpdateMetrics::Get(id);
+#endif
 }
 
 void Map::Initialize(bool loadInstanceData /*= true*/)
@@ -227,6 +438,9 @@ void Map::Initialize(bool loadInstanceData /*= true*/)
         {
             // z code
             m_bLoadedGrids[idx][j] = false;
+            m_gridLastAccess[idx][j] = 0;
+            m_gridUnloadTime[idx][j] = 0;
+            m_gridChurn[idx][j] = 0;
             setNGrid(nullptr, idx, j);
         }
     }
@@ -253,26 +467,59 @@ void Map::Initialize(bool loadInstanceData /*= true*/)
 
     m_spawnManager.Initialize();
 
+    if (IsContinent())
+    {
+        // tasks go to the threads shared by all continents, waiting only for the ones of this map
+        if (MapUpdater* cellUpdater = sMapMgr.GetCellUpdater())
+            m_cellUpdater.reset(new MapUpdater(*cellUpdater));
+    }
+
     // load navmesh
-    MMAP::MMapFactory::createOrGetMMapManager()->loadMapData(GetId(), GetInstanceId());
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+    mmap->loadMapData(GetId(), GetInstanceId());
+    if (dtNavMesh const* navMesh = mmap->GetNavMesh(GetId(), GetInstanceId()))
+    {
+        m_navMeshQueries.reset(new MMAP::NavMeshQueryPool());
+        if (!m_navMeshQueries->Init(navMesh, m_cellUpdater ? m_cellUpdater->threads() + 1 : 1))
+            m_navMeshQueries.reset();
+    }
+}
+
+void Map::QueuePathRequest(PathRequestPtr const& request)
+{
+    m_pathRequests->Submit(request);
+}
+
+dtNavMeshQuery const* Map::GetNavMeshQuery() const
+{
+    if (!m_navMeshQueries)
+        return nullptr;
+
+    size_t slot = 0;
+    if (m_cellUpdater && MapUpdater::CurrentUpdater() == m_cellUpdater->pool())
+        slot = MapUpdater::CurrentWorkerIndex() + 1;
+    return m_navMeshQueries->Get(slot);
 }
 
 void Map::InitVisibilityDistance()
 {
     // init visibility for continents
     m_VisibleDistance = World::GetMaxVisibleDistanceOnContinents();
+    m_fullRateRelayDistance = sWorld.getConfig(CONFIG_FLOAT_FULL_RATE_DISTANCE_CONTINENTS);
 }
 
 // Template specialization of utility methods
 template<class T>
 void Map::AddToGrid(T* obj, NGridType* grid, Cell const& cell)
 {
+    obj->UpdateGridPosition();
     (*grid)(cell.CellX(), cell.CellY()).AddGridObject<T>(obj);
 }
 
 template<>
 void Map::AddToGrid(GameObject* obj, NGridType* grid, Cell const& cell)
 {
+    obj->UpdateGridPosition();
     (*grid)(cell.CellX(), cell.CellY()).AddGridObject<GameObject>(obj);
     obj->SetCurrentCell(cell);
 }
@@ -280,12 +527,14 @@ void Map::AddToGrid(GameObject* obj, NGridType* grid, Cell const& cell)
 template<>
 void Map::AddToGrid(Player* obj, NGridType* grid, Cell const& cell)
 {
+    obj->UpdateGridPosition();
     (*grid)(cell.CellX(), cell.CellY()).AddWorldObject(obj);
 }
 
 template<>
 void Map::AddToGrid(Corpse* obj, NGridType* grid, Cell const& cell)
 {
+    obj->UpdateGridPosition();
     // add to world object registry in grid
     if (obj->GetType() != CORPSE_BONES)
     {
@@ -301,6 +550,7 @@ void Map::AddToGrid(Corpse* obj, NGridType* grid, Cell const& cell)
 template<>
 void Map::AddToGrid(Creature* obj, NGridType* grid, Cell const& cell)
 {
+    obj->UpdateGridPosition();
     // add to world object registry in grid
     if (obj->IsPet())
     {
@@ -375,6 +625,17 @@ void Map::EnsureGridCreated(const GridPair& p)
 
         getNGrid(p.x_coord, p.y_coord)->SetGridState(GRID_STATE_IDLE);
 
+        // reloaded within one clean up delay of its unload: a player moves along the grid border
+        uint32 const now = WorldTimer::getMSTime();
+        uint8& churn = m_gridChurn[p.x_coord][p.y_coord];
+        if (m_gridUnloadTime[p.x_coord][p.y_coord] && WorldTimer::getMSTimeDiff(m_gridUnloadTime[p.x_coord][p.y_coord], now) < i_gridExpiry)
+            churn = std::min<uint8>(churn + 1, MAX_GRID_CHURN);
+        else
+            churn = 0;
+        m_gridLastAccess[p.x_coord][p.y_coord] = now;
+        ++m_createdGridCount;
+        ++m_gridLoads;
+
         // z coord
         int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
         int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
@@ -413,6 +674,7 @@ void Map::EnsureGridLoadedAtEnter(const Cell& cell, Player* player)
 
 bool Map::EnsureGridLoaded(const Cell& cell)
 {
+    SlabPool::Scope poolScope(m_objectPool);
     EnsureGridCreated(GridPair(cell.GridX(), cell.GridY()));
     NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -446,6 +708,30 @@ uint32 Map::GetLoadedGridsCount()
     return count;
 }
 
+void Map::CollectGridUnloadCandidates(std::vector<GridUnloadCandidate>& candidates)
+{
+    // same as Map::Update, grids of battlegrounds are never unloaded
+    if (IsBattleGroundOrArena())
+        return;
+
+    for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
+    {
+        NGridType* grid = i->getSource();
+        if (grid->GetGridState() != GRID_STATE_REMOVAL || grid->getUnloadLock())
+            continue;
+
+        candidates.push_back({ this, grid->getX(), grid->getY(), m_gridLastAccess[grid->getX()][grid->getY()] });
+    }
+}
+
+void Map::GetLoadedTerrainGrids(std::vector<uint32>& grids) const
+{
+    for (uint32 gx = 0; gx < MAX_NUMBER_OF_GRIDS; ++gx)
+        for (uint32 gy = 0; gy < MAX_NUMBER_OF_GRIDS; ++gy)
+            if (m_bLoadedGrids[gx][gy])
+                grids.push_back((gx << 16) | gy);
+}
+
 void Map::ForceLoadGrid(float x, float y)
 {
     if (!IsLoaded(x, y))
@@ -457,6 +743,63 @@ void Map::ForceLoadGrid(float x, float y)
     }
 }
 
+void Map::ForceLoadGrids(std::vector<std::pair<float, float>> const& positions)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // terrain grids (gridX << 16 | gridY) of the positions which are not loaded yet
+    std::vector<uint32> terrainGrids;
+    {
+        std::set<uint32> uniqueGrids;
+        for (auto const& position : positions)
+        {
+            if (!MaNGOS::IsValidMapCoord(position.first, position.second) || IsLoaded(position.first, position.second))
+                continue;
+
+            GridPair p = MaNGOS::ComputeGridPair(position.first, position.second);
+            uint32 const gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+            uint32 const gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+            if (!m_bLoadedGrids[gx][gy])
+                uniqueGrids.insert(gx << 16 | gy);
+        }
+        terrainGrids.assign(uniqueGrids.begin(), uniqueGrids.end());
+    }
+
+    // prefetch stage: map and vmap tiles are independent per grid, the first load creates the vmap tree
+    if (!terrainGrids.empty())
+    {
+        m_TerrainData->Load(terrainGrids[0] >> 16, terrainGrids[0] & 0xFFFF);
+
+        std::atomic<size_t> next(1);
+        size_t const threadCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), terrainGrids.size() - 1);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            threads.emplace_back([&]()
+            {
+                for (size_t index = next++; index < terrainGrids.size(); index = next++)
+                    m_TerrainData->Load(terrainGrids[index] >> 16, terrainGrids[index] & 0xFFFF);
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    uint32 const gridsBefore = m_createdGridCount;
+
+    // grid objects and navmesh tiles are added by this thread only
+    for (auto const& position : positions)
+        ForceLoadGrid(position.first, position.second);
+
+    // the loaded grids hold their own terrain reference now
+    for (uint32 grid : terrainGrids)
+        m_TerrainData->Unload(grid >> 16, grid & 0xFFFF);
+
+    sLog.outString("Map %u: preloaded %u grids in %u ms", GetId(), m_createdGridCount - gridsBefore,
+                   uint32(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()));
+}
+
 void Map::CreatePlayerOnClient(Player* player)
 {
     // update player state for other player and visa-versa
@@ -697,73 +1040,145 @@ bool Map::loaded(const GridPair& p) const
 
 #define MAP_METRICS
 
-void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor)
+void Map::UpdateActiveCellsOf(WorldObject const* obj, ActiveCellSource source, WorldObject const* center, float radius)
 {
-    // lets update mobs/objects in ALL visible cells around player!
-    CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), obj->IsInWorld() ? obj->GetVisibilityData().GetVisibilityDistance() : GetVisibilityDistance());
+    CellArea area = Cell::CalculateCellArea(center->GetPositionX(), center->GetPositionY(), radius);
+
+    auto itr = m_activeCellAreas[source].find(obj);
+    if (itr != m_activeCellAreas[source].end())
+    {
+        // still inside the same cells, nothing to do
+        if (itr->second == area)
+            return;
 
+        ChangeActiveCellArea(itr->second, false);
+        itr->second = area;
+    }
+    else
+        m_activeCellAreas[source].emplace(obj, area);
+
+    ChangeActiveCellArea(area, true);
+}
+
+void Map::ReleaseActiveCellsOf(WorldObject const* obj, ActiveCellSource source)
+{
+    auto itr = m_activeCellAreas[source].find(obj);
+    if (itr == m_activeCellAreas[source].end())
+        return;
+
+    ChangeActiveCellArea(itr->second, false);
+    m_activeCellAreas[source].erase(itr);
+}
+
+void Map::ChangeActiveCellArea(CellArea const& area, bool add)
+{
     for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
     {
         for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
         {
-            // marked cells are those that have been visited
-            // don't visit the same cell twice
             uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-            if (!isCellMarked(cell_id))
+            if (add)
+                ++m_activeCells[cell_id];
+            else
             {
-                markCell(cell_id);
-                CellPair pair(x, y);
-                Cell cell(pair);
-                cell.SetNoCreate();
-                Visit(cell, gridVisitor);
-                Visit(cell, worldVisitor);
+                auto itr = m_activeCells.find(cell_id);
+                MANGOS_ASSERT(itr != m_activeCells.end());
+                if (--itr->second == 0)
+                    m_activeCells.erase(itr);
             }
         }
     }
 }
 
+void Map::UpdateCellRegions(uint32 diff, MapCostSampler* sampler)
+{
+    // collect objects of all regions at once, visiting cells does not modify the grids
+    // every object lives in exactly one cell, active objects are already stamped and stay in the serial list
+    for (uint32 x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
+    {
+        m_cellRegionObjects[x].clear();
+        if (!m_cellRegions[x].empty())
+            m_cellUpdater->schedule_update(new GridCrawler(*this, m_cellRegions[x], m_cellRegionObjects[x], m_updateGeneration, diff, *m_cellUpdater));
+    }
+    m_cellUpdater->wait();
+
+    for (uint32 x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
+        m_cellRegions[x].clear();
+
+    // an update reaches up to MAX_VISIBILITY_DISTANCE, one grid, into the columns on both sides of its region
+    // (visibility, relocation, summons), two regions updated at the same time need two idle columns between them
+    static_assert(MAX_VISIBILITY_DISTANCE <= SIZE_OF_GRIDS, "cell region stride covers one grid of visibility");
+    uint32 const stride = 3;
+    for (uint32 pass = 0; pass < stride; ++pass)
+    {
+        for (uint32 x = pass; x < MAX_NUMBER_OF_GRIDS; x += stride)
+            if (!m_cellRegionObjects[x].empty())
+                m_cellUpdater->schedule_update(new ObjectUpdateWorker(m_cellRegionObjects[x], m_updateGeneration, diff, sampler, *m_cellUpdater));
+        m_cellUpdater->wait();
+    }
+}
+
 void Map::Update(const uint32& t_diff)
 {
 
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::milliseconds> meas("map.update", {
-        { "map_id", std::to_string(i_id) },
-        { "instance_id", std::to_string(i_InstanceId) }
-});
+    metric::timer<> meas(m_updateMetrics->update);
 #endif
+    TICK_PROFILE_ZONE("Map::Update", i_id);
 
+    SlabPool::Scope poolScope(m_objectPool);
+    // containers built during the update come from here, dropped at once when it ends
+    TickArena::Scope arenaScope;
 
     uint64 count = 0;
 
-    m_dyn_tree.update(t_diff);
+    {
+        std::unique_lock<std::shared_mutex> lock(m_dynTreeLock);
+        m_dyn_tree.update(t_diff);
+    }
+    // line of sight results are only reused within one tick, creatures and players move in between
+    m_losCache.Invalidate();
+
+    // no path runs here, tiles can be swapped safely
+    UpdateNavTiles(t_diff);
+
+    // cost of the previous updates, the worker records it once this one is done
+    UpdateLoadShedding(t_diff);
+
+    // paths requested during the previous update, nothing moves while they are computed
+    m_pathRequests->Process(m_cellUpdater.get(), sWorld.getConfig(CONFIG_UINT32_PATH_FIND_ASYNC_BATCH));
 
     GetMessager().Execute(this);
+    UpdateGameEventSpawns();
     m_spawnManager.Update();
 
-    /// update active cells around players and active objects
-    resetMarkedCells();
-
-    WorldObjectUnSet objToUpdate;
-    MaNGOS::ObjectUpdater obj_updater(objToUpdate, t_diff);
+    // objects are stamped with the generation once they are queued, no need for a set
+    ++m_updateGeneration;
+    m_objectsToUpdate.clear();
+    MapCostSampler* const costSampler = MapCostSampler::IsSampledTick(m_updateGeneration) ? m_costSampler.get() : nullptr;
+    if (costSampler)
+        costSampler->AddTick();
+    MaNGOS::ObjectUpdater obj_updater(m_objectsToUpdate, m_updateGeneration, t_diff);
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
 
-    for (m_transportsIterator = m_transports.begin(); m_transportsIterator != m_transports.end();)
     {
-        Transport* transport = *m_transportsIterator;
-        ++m_transportsIterator;
-        transport->Update(t_diff);
+        TICK_PROFILE_ZONE("Map transports", i_id);
+        for (m_transportsIterator = m_transports.begin(); m_transportsIterator != m_transports.end();)
+        {
+            Transport* transport = *m_transportsIterator;
+            ++m_transportsIterator;
+            transport->Update(t_diff);
+        }
     }
 
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
     {
+        TICK_PROFILE_ZONE("Map sessions", i_id);
 #ifdef BUILD_METRICS
         uint32 updatedSessions = 0;
-        metric::duration<std::chrono::milliseconds> sessions_meas("map.update.session", {
-            { "map_id", std::to_string(i_id) },
-            { "instance_id", std::to_string(i_InstanceId) },
-            });
+        metric::timer<> sessions_meas(m_updateMetrics->session);
 #endif
 
         for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -779,30 +1194,62 @@ void Map::Update(const uint32& t_diff)
             ++updatedSessions;
 #endif
         }
+
+        // movement handled by the sessions reaches every observer as one write, before anything the updates below send
+        SendMovementRelays();
 #ifdef BUILD_METRICS
-        sessions_meas.add_field("count", std::to_string(static_cast<int32>(updatedSessions)));
+        m_updateMetrics->sessions.add(updatedSessions);
 #endif
     }
 
     /// update players at tick
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
-        Player* plr = m_mapRefIter->getSource();
-        if (plr && plr->IsInWorld())
-            plr->Update(t_diff);
+        TICK_PROFILE_ZONE("Map players", i_id);
+        if (costSampler)
+            costSampler->BeginBatch();
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* plr = m_mapRefIter->getSource();
+            if (plr && plr->IsInWorld())
+            {
+                if (costSampler)
+                    costSampler->UpdateObject(plr, t_diff);
+                else
+                    plr->Update(t_diff);
+            }
+        }
+        if (costSampler)
+            costSampler->EndBatch();
+    }
+
+    /// queue the grids fast moving players are heading to for background loading
+    m_gridPreloadTimer.Update(t_diff);
+    if (m_gridPreloadTimer.Passed())
+    {
+        m_gridPreloadTimer.Reset();
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+            if (Player* player = m_mapRefIter->getSource())
+                sGridPreloader.PredictFor(player);
     }
 
+    /// update active cells around players and active objects, cells only change when crossing cell borders
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
         Player* player = m_mapRefIter->getSource();
         if (!player->IsInWorld() || !player->IsPositionValid())
+        {
+            ReleaseActiveCellsOf(player, ACTIVE_CELLS_OBJECT);
+            ReleaseActiveCellsOf(player, ACTIVE_CELLS_FAR_SIGHT);
             continue;
+        }
 
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+        UpdateActiveCellsOf(player, ACTIVE_CELLS_OBJECT, player, player->GetVisibilityData().GetVisibilityDistance());
 
         // If player is using far sight, visit that object too
         if (WorldObject* viewPoint = GetWorldObject(player->GetFarSightGuid()))
-            VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
+            UpdateActiveCellsOf(player, ACTIVE_CELLS_FAR_SIGHT, viewPoint, viewPoint->IsInWorld() ? viewPoint->GetVisibilityData().GetVisibilityDistance() : GetVisibilityDistance());
+        else
+            ReleaseActiveCellsOf(player, ACTIVE_CELLS_FAR_SIGHT);
     }
 
     // non-player active objects
@@ -818,52 +1265,105 @@ void Map::Update(const uint32& t_diff)
             ++m_activeNonPlayersIter;
 
             if (!obj->IsInWorld() || !obj->IsPositionValid())
+            {
+                ReleaseActiveCellsOf(obj, ACTIVE_CELLS_OBJECT);
                 continue;
+            }
 
-            objToUpdate.insert(obj);
+            if (obj->MarkUpdateGeneration(m_updateGeneration))
+                m_objectsToUpdate.push_back(obj);
 
-            // lets update mobs/objects in ALL visible cells around player!
-            CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+            // lets update mobs/objects in ALL visible cells around it
+            UpdateActiveCellsOf(obj, ACTIVE_CELLS_OBJECT, obj, GetVisibilityDistance());
+        }
+    }
 
-            for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
-            {
-                for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
-                {
-                    // marked cells are those that have been visited
-                    // don't visit the same cell twice
-                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                    if (!isCellMarked(cell_id))
-                    {
-                        markCell(cell_id);
-                        CellPair pair(x, y);
-                        Cell cell(pair);
-                        cell.SetNoCreate();
-                        Visit(cell, grid_object_update);
-                        Visit(cell, world_object_update);
-                    }
-                }
-            }
+    if (m_cellUpdater)
+    {
+        // crawl and update active cells on the cell updater threads
+#ifdef BUILD_METRICS
+        metric::timer<> cells_meas(m_updateMetrics->cells);
+#endif
+        TICK_PROFILE_ZONE("Map cells", i_id);
+        for (auto& activeCell : m_activeCells)
+        {
+            Cell cell(CellPair(activeCell.first % TOTAL_NUMBER_OF_CELLS_PER_MAP, activeCell.first / TOTAL_NUMBER_OF_CELLS_PER_MAP));
+            cell.SetNoCreate();
+            m_cellRegions[cell.GridX()].push_back(cell);
+        }
+
+        UpdateCellRegions(t_diff, costSampler);
+    }
+    else
+    {
+        TICK_PROFILE_ZONE("Map cells", i_id);
+        for (auto& activeCell : m_activeCells)
+        {
+            Cell cell(CellPair(activeCell.first % TOTAL_NUMBER_OF_CELLS_PER_MAP, activeCell.first / TOTAL_NUMBER_OF_CELLS_PER_MAP));
+            cell.SetNoCreate();
+            Visit(cell, grid_object_update);
+            Visit(cell, world_object_update);
         }
     }
 
-    // update all objects
-    for (auto wObj : objToUpdate)
+    // update all objects, their splines are stepped together first
     {
-        wObj->Update(t_diff);
-        ++count;
+        TICK_PROFILE_ZONE("Map objects", i_id);
+        // long ticks are left to the sub-steps of Unit::Update
+        uint32 const movementStep = sWorld.getConfig(CONFIG_UINT32_TICK_PACER_MOVEMENT_STEP);
+        if (!movementStep || t_diff <= movementStep)
+            m_splineBatch->Process(m_objectsToUpdate, t_diff, m_updateGeneration);
+        if (costSampler)
+        {
+            costSampler->UpdateObjects(m_objectsToUpdate, t_diff);
+            count = m_objectsToUpdate.size();
+        }
+        else
+        {
+            for (auto wObj : m_objectsToUpdate)
+            {
+                wObj->Update(t_diff);
+                ++count;
+            }
+        }
     }
 
+    // visibility of everything that moved in this update, from the final positions
+    ProcessRelocationNotifies(t_diff);
+
 #ifdef BUILD_METRICS
-    meas.add_field("count", std::to_string(static_cast<int32>(count)));
+    m_updateMetrics->objects.add(count);
+    m_updateMetrics->losLookups.add(m_losCache.GetLookups());
+    m_updateMetrics->losHits.add(m_losCache.GetHits());
+    m_updateMetrics->pathRequests.add(m_pathRequests->GetProcessed());
+    m_updateMetrics->pathCacheLookups.add(m_pathCache->GetLookups());
+    m_updateMetrics->pathCacheHits.add(m_pathCache->GetHits());
+    m_updateMetrics->waypointSegmentLookups.add(m_waypointSegmentCache->GetLookups());
+    m_updateMetrics->waypointSegmentHits.add(m_waypointSegmentCache->GetHits());
+    m_updateMetrics->splineBatch.add(m_splineBatch->GetLastCount());
+    m_updateMetrics->messages.add(m_messager.GetStats().delivered);
+    if (m_messager.GetStats().delivered)
+        m_updateMetrics->messageLatency.observe(m_messager.GetStats().maxLatency);
+#ifdef BUILD_PLAYERBOT
+    m_updateMetrics->playerbotAiUs.add(m_playerbotUpdateBudget.GetSpent(m_updateGeneration));
+    m_updateMetrics->playerbotAiRuns.add(m_playerbotUpdateBudget.GetRuns(m_updateGeneration));
+    m_updateMetrics->playerbotAiDeferred.add(m_playerbotUpdateBudget.GetDeferred(m_updateGeneration));
+#endif
 #endif
+    m_losCache.ResetStats();
+    m_pathRequests->ResetStats();
+    m_pathCache->ResetStats();
+    m_waypointSegmentCache->ResetStats();
 
     // Send world objects and item update field changes
     SendObjectUpdates();
+    m_variableManager.Update();
 
     // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
     if (!IsBattleGroundOrArena())
     {
+        TICK_PROFILE_ZONE("Map grid states", i_id);
         for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
         {
             NGridType* grid = i->getSource();
@@ -874,6 +1374,27 @@ void Map::Update(const uint32& t_diff)
         }
     }
 
+    m_gridStatsTimer.Update(t_diff);
+    if (m_gridStatsTimer.Passed())
+    {
+        m_gridStatsTimer.Reset();
+        if (m_gridLoads || m_gridUnloads)
+            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Map %u instance %u: %u grids loaded, %u unloaded in the last minute, %u in memory",
+                i_id, i_InstanceId, m_gridLoads, m_gridUnloads, m_createdGridCount);
+#ifdef BUILD_METRICS
+        metric::measurement grids_meas("map.grids", {
+            { "map_id", std::to_string(i_id) },
+            { "instance_id", std::to_string(i_InstanceId) }
+        });
+        grids_meas.add_field("loads", std::to_string(m_gridLoads));
+        grids_meas.add_field("unloads", std::to_string(m_gridUnloads));
+        grids_meas.add_field("loaded", std::to_string(m_createdGridCount));
+        grids_meas.add_field("navmesh_bytes", std::to_string(MMAP::MMapFactory::createOrGetMMapManager()->GetResidentBytes(GetId(), GetInstanceId())));
+#endif
+        m_gridLoads = 0;
+        m_gridUnloads = 0;
+    }
+
     ///- Process necessary scripts
     if (!m_scriptSchedule.empty())
         ScriptsProcess();
@@ -881,7 +1402,52 @@ void Map::Update(const uint32& t_diff)
     if (i_data)
         i_data->Update(t_diff);
 
-    m_weatherSystem->UpdateWeathers(t_diff);
+    // maps without weathers, most instances, have nothing to schedule
+    if (m_weatherSystem->HasWeathers())
+        m_weatherUpdateDiff += t_diff;
+    if (m_weatherUpdateDiff && sTickPacer.IsDue(m_weatherUpdateDiff, sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE)))
+    {
+        m_weatherSystem->UpdateWeathers(m_weatherUpdateDiff);
+        m_weatherUpdateDiff = 0;
+    }
+
+    PublishSnapshot();
+}
+
+void Map::PublishSnapshot()
+{
+    // empty maps keep their last snapshot, nothing readers care about changes there
+    if (m_mapRefManager.isEmpty() && m_snapshot && m_snapshot->players.empty() && m_snapshot->loadedGrids == m_createdGridCount)
+        return;
+
+    std::shared_ptr<MapSnapshot> snapshot = std::make_shared<MapSnapshot>();
+    snapshot->mapId = i_id;
+    snapshot->instanceId = i_InstanceId;
+    snapshot->updateGeneration = m_updateGeneration;
+    snapshot->loadedGrids = m_createdGridCount;
+    snapshot->players.reserve(m_mapRefManager.getSize());
+
+    for (auto& ref : m_mapRefManager)
+    {
+        Player* player = ref.getSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        MapSnapshot::PlayerEntry entry;
+        entry.guid = player->GetObjectGuid();
+        entry.zoneId = player->GetCachedZoneId();
+        entry.level = player->GetLevel();
+        entry.x = player->GetPositionX();
+        entry.y = player->GetPositionY();
+        entry.z = player->GetPositionZ();
+        entry.isGameMaster = player->IsGameMaster();
+        snapshot->players.push_back(entry);
+
+        if (!entry.isGameMaster)
+            ++snapshot->zonePopulation[entry.zoneId];
+    }
+
+    std::atomic_store(&m_snapshot, std::shared_ptr<MapSnapshot const>(std::move(snapshot)));
 }
 
 void Map::Remove(Player* player, bool remove)
@@ -898,6 +1464,9 @@ void Map::Remove(Player* player, bool remove)
     else
         player->RemoveFromWorld();
 
+    ReleaseActiveCellsOf(player, ACTIVE_CELLS_OBJECT);
+    ReleaseActiveCellsOf(player, ACTIVE_CELLS_FAR_SIGHT);
+
     // this may be called during Map::Update
     // after decrement+unlink, ++m_mapRefIter will continue correctly
     // when the first element of the list is being removed
@@ -1182,6 +1751,9 @@ bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
         unloader.UnloadN();
         delete getNGrid(x, y);
         setNGrid(nullptr, x, y);
+        m_gridUnloadTime[x][y] = WorldTimer::getMSTime();
+        --m_createdGridCount;
+        ++m_gridUnloads;
     }
 
     int gx = (MAX_NUMBER_OF_GRIDS - 1) - x;
@@ -1390,6 +1962,7 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 
     obj->CleanupsBeforeDelete();                            // remove or simplify at least cross referenced links
 
+    std::lock_guard<std::mutex> guard(m_objectUpdateLock);
     i_objectsToRemove.insert(obj);
     // DEBUG_LOG("Object (GUID: %u TypeId: %u ) added to removing list.",obj->GetGUIDLow(),obj->GetTypeId());
 }
@@ -1463,6 +2036,104 @@ bool Map::SendToPlayersInZone(WorldPacket const& data, uint32 zoneId) const
     return foundPlayer;
 }
 
+bool Map::SendToPlayersInZone(std::shared_ptr<WorldPacket const> const& data, uint32 zoneId) const
+{
+    bool foundPlayer = false;
+    for (const auto& itr : m_mapRefManager)
+    {
+        if (itr.getSource()->GetZoneId() == zoneId)
+        {
+            itr.getSource()->GetSession()->SendPacket(data);
+            foundPlayer = true;
+        }
+    }
+    return foundPlayer;
+}
+
+bool Map::HasPlayersInZone(uint32 zoneId) const
+{
+    for (const auto& itr : m_mapRefManager)
+        if (itr.getSource()->GetZoneId() == zoneId)
+            return true;
+    return false;
+}
+
+void Map::QueueRelocationNotify(Unit* unit)
+{
+    std::lock_guard<std::mutex> guard(m_relocationNotifyLock);
+    m_relocationNotifies.insert(unit->GetObjectGuid());
+}
+
+namespace
+{
+    // elevators move their passengers from the cell updater threads
+    thread_local uint32 relocationBatchDepth = 0;
+}
+
+Map::RelocationBatch::RelocationBatch()
+{
+    ++relocationBatchDepth;
+}
+
+Map::RelocationBatch::~RelocationBatch()
+{
+    --relocationBatchDepth;
+}
+
+bool Map::RelocationBatch::IsActive()
+{
+    return relocationBatchDepth != 0;
+}
+
+void Map::ProcessRelocationNotifies(uint32 diff)
+{
+    m_relocationNotifyTimer.Update(diff);
+    if (!m_relocationNotifyTimer.Passed())
+        return;
+    m_relocationNotifyTimer.Reset();
+
+    GuidSet notifies;
+    {
+        std::lock_guard<std::mutex> guard(m_relocationNotifyLock);
+        notifies.swap(m_relocationNotifies);
+    }
+
+    for (ObjectGuid const& guid : notifies)
+    {
+        // removed or moved back within the limit since it was queued
+        Unit* unit = GetUnit(guid);
+        if (unit && unit->IsInWorld() && unit->GetMap() == this && unit->IsRelocationNotifyDue())
+            unit->UpdateRelocationVisibility();
+    }
+}
+
+void Map::QueueMovementRelay(std::vector<Player*> const& receivers, std::shared_ptr<WorldPacket const> const& data)
+{
+    std::lock_guard<std::mutex> guard(m_movementRelayLock);
+    for (Player const* receiver : receivers)
+        m_movementRelays[receiver->GetObjectGuid()].push_back(data);
+}
+
+void Map::SendMovementRelays()
+{
+    std::lock_guard<std::mutex> guard(m_movementRelayLock);
+    for (auto itr = m_movementRelays.begin(); itr != m_movementRelays.end();)
+    {
+        // receivers without relays since the last flush are forgotten, the others keep their storage
+        if (itr->second.empty())
+        {
+            itr = m_movementRelays.erase(itr);
+            continue;
+        }
+
+        if (Player* player = GetPlayer(itr->first))
+            player->GetSession()->SendPackets(itr->second);
+
+        itr->second.clear();
+        ++itr;
+    }
+}
+
 bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
 {
     MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
@@ -1503,6 +2174,8 @@ bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    std::lock_guard<std::recursive_mutex> guard(m_activeNonPlayersLock);
+
     m_activeNonPlayers.insert(obj);
     Cell cell = Cell(MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
     EnsureGridLoaded(cell);
@@ -1531,6 +2204,8 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
+    std::lock_guard<std::recursive_mutex> guard(m_activeNonPlayersLock);
+
     // Map::Update for active object in proccess
     if (m_activeNonPlayersIter != m_activeNonPlayers.end())
     {
@@ -1542,6 +2217,8 @@ void Map::RemoveFromActive(WorldObject* obj)
     else
         m_activeNonPlayers.erase(obj);
 
+    ReleaseActiveCellsOf(obj, ACTIVE_CELLS_OBJECT);
+
     // also allow unloading spawn grid
     if (obj->GetTypeId() == TYPEID_UNIT)
     {
@@ -1710,6 +2387,7 @@ void DungeonMap::InitVisibilityDistance()
 {
     // init visibility distance for instances
     m_VisibleDistance = World::GetMaxVisibleDistanceInInstances();
+    m_fullRateRelayDistance = sWorld.getConfig(CONFIG_FLOAT_FULL_RATE_DISTANCE_INSTANCES);
 }
 
 /*
@@ -2006,6 +2684,7 @@ void BattleGroundMap::InitVisibilityDistance()
 {
     // init visibility distance for BG/Arenas
     m_VisibleDistance = World::GetMaxVisibleDistanceInBGArenas();
+    m_fullRateRelayDistance = sWorld.getConfig(CONFIG_FLOAT_FULL_RATE_DISTANCE_BGARENAS);
 }
 
 bool BattleGroundMap::CanEnter(Player* player)
@@ -2074,15 +2753,13 @@ bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* sourc
 
     if (execParams)                                         // Check if the execution should be uniquely
     {
-        for (ScriptScheduleMap::const_iterator searchItr = m_scriptSchedule.begin(); searchItr != m_scriptSchedule.end(); ++searchItr)
+        std::lock_guard<std::mutex> guard(m_scriptScheduleLock);
+        if (m_scriptSchedule.HasSameScript(scripts.first, id,
+                                           execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_SOURCE ? sourceGuid : ObjectGuid(),
+                                           execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_TARGET ? targetGuid : ObjectGuid(), ownerGuid))
         {
-            if (searchItr->second.IsSameScript(scripts.first, id,
-                                               execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_SOURCE ? sourceGuid : ObjectGuid(),
-                                               execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_TARGET ? targetGuid : ObjectGuid(), ownerGuid))
-            {
-                DETAIL_FILTER_LOG(LOG_FILTER_DB_SCRIPT, "DB-SCRIPTS: Process table `%s` id %u. Skip script as script already started for source %s, target %s - ScriptsStartParams %u", scripts.first, id, sourceGuid.GetString().c_str(), targetGuid.GetString().c_str(), execParams);
-                return true;
-            }
+            DETAIL_FILTER_LOG(LOG_FILTER_DB_SCRIPT, "DB-SCRIPTS: Process table `%s` id %u. Skip script as script already started for source %s, target %s - ScriptsStartParams %u", scripts.first, id, sourceGuid.GetString().c_str(), targetGuid.GetString().c_str(), execParams);
+            return true;
         }
     }
 
@@ -2110,7 +2787,8 @@ bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* sourc
     {
         auto const& scriptInfo = scriptInfoItr->second;
         ScriptAction sa(scripts.first, this, sourceGuid, targetGuid, ownerGuid, &scriptInfo);
-        m_scriptSchedule.emplace(GetCurrentClockTime() + std::chrono::milliseconds(scriptInfoItr->first), sa);
+        std::lock_guard<std::mutex> guard(m_scriptScheduleLock);
+        m_scriptSchedule.Schedule(GetCurrentClockTime() + std::chrono::milliseconds(scriptInfoItr->first), sa);
         sScriptMgr.IncreaseScheduledScriptsCount();
     }
 
@@ -2130,7 +2808,8 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
 
     if (delay)
     {
-        m_scriptSchedule.emplace(GetCurrentClockTime() + std::chrono::milliseconds(delay), sa);
+        std::lock_guard<std::mutex> guard(m_scriptScheduleLock);
+        m_scriptSchedule.Schedule(GetCurrentClockTime() + std::chrono::milliseconds(delay), sa);
         sScriptMgr.IncreaseScheduledScriptsCount();
     }
     else
@@ -2143,38 +2822,37 @@ void Map::ScriptsProcess()
     if (m_scriptSchedule.empty())
         return;
 
+    TICK_PROFILE_ZONE("Map scripts", i_id);
+
     ///- Process overdue queued scripts
-    ScriptScheduleMap::iterator iter = m_scriptSchedule.begin();
-    // ok as multimap is a *sorted* associative container
-    while (!m_scriptSchedule.empty() && (iter->first <= GetCurrentClockTime()))
+    // steps run unlocked, they can start scripts themselves
+    std::vector<ScriptAction> due;
     {
-        if (iter->second.HandleScriptStep())
-        {
-            // Terminate following script steps of this script
-            const char* tableName = iter->second.GetTableName();
-            uint32 id = iter->second.GetId();
-            ObjectGuid sourceGuid = iter->second.GetSourceGuid();
-            ObjectGuid targetGuid = iter->second.GetTargetGuid();
-            ObjectGuid ownerGuid = iter->second.GetOwnerGuid();
+        std::lock_guard<std::mutex> guard(m_scriptScheduleLock);
+        m_scriptSchedule.TakeDue(GetCurrentClockTime(), due);
+    }
+    sScriptMgr.DecreaseScheduledScriptCount(due.size());
 
-            for (ScriptScheduleMap::iterator rmItr = m_scriptSchedule.begin(); rmItr != m_scriptSchedule.end();)
-            {
-                if (rmItr->second.IsSameScript(tableName, id, sourceGuid, targetGuid, ownerGuid))
-                {
-                    m_scriptSchedule.erase(rmItr++);
-                    sScriptMgr.DecreaseScheduledScriptCount();
-                }
-                else
-                    ++rmItr;
-            }
-        }
-        else
-        {
-            m_scriptSchedule.erase(iter);
+    std::vector<bool> terminated(due.size(), false);
+    for (size_t i = 0; i < due.size(); ++i)
+    {
+        if (terminated[i] || !due[i].HandleScriptStep())
+            continue;
 
-            sScriptMgr.DecreaseScheduledScriptCount();
-        }
-        iter = m_scriptSchedule.begin();
+        // Terminate following script steps of this script, due now or later
+        const char* tableName = due[i].GetTableName();
+        uint32 id = due[i].GetId();
+        ObjectGuid sourceGuid = due[i].GetSourceGuid();
+        ObjectGuid targetGuid = due[i].GetTargetGuid();
+        ObjectGuid ownerGuid = due[i].GetOwnerGuid();
+
+        for (size_t j = i + 1; j < due.size(); ++j)
+            if (due[j].IsSameScript(tableName, id, sourceGuid, targetGuid, ownerGuid))
+                terminated[j] = true;
+
+        std::lock_guard<std::mutex> guard(m_scriptScheduleLock);
+        if (uint32 removed = m_scriptSchedule.RemoveSameScript(tableName, id, sourceGuid, targetGuid, ownerGuid))
+            sScriptMgr.DecreaseScheduledScriptCount(removed);
     }
 }
 
@@ -2188,8 +2866,9 @@ void Map::ScriptsProcess()
  */
 Player* Map::GetPlayer(ObjectGuid guid)
 {
-    Player* plr = ObjectAccessor::FindPlayer(guid);         // return only in world players
-    return plr && plr->GetMap() == this ? plr : nullptr;
+    // not ObjectAccessor::FindPlayer, a lookup limited to this map is no cross-map access
+    Player* plr = HashMapHolder<Player>::Find(guid);
+    return plr && plr->IsInWorld() && plr->GetMap() == this ? plr : nullptr;
 }
 
 /**
@@ -2199,6 +2878,7 @@ Player* Map::GetPlayer(ObjectGuid guid)
  */
 Creature* Map::GetCreature(ObjectGuid guid)
 {
+    std::shared_lock<std::shared_mutex> lock(m_objectsStoreLock);
     return m_objectsStore.find<Creature>(guid, (Creature*)nullptr);
 }
 
@@ -2209,6 +2889,7 @@ Creature* Map::GetCreature(ObjectGuid guid)
  */
 Pet* Map::GetPet(ObjectGuid guid)
 {
+    std::shared_lock<std::shared_mutex> lock(m_objectsStoreLock);
     return m_objectsStore.find<Pet>(guid, (Pet*)nullptr);
 }
 
@@ -2250,6 +2931,7 @@ Creature* Map::GetAnyTypeCreature(ObjectGuid guid)
  */
 GameObject* Map::GetGameObject(ObjectGuid guid)
 {
+    std::shared_lock<std::shared_mutex> lock(m_objectsStoreLock);
     return m_objectsStore.find<GameObject>(guid, (GameObject*)nullptr);
 }
 
@@ -2260,6 +2942,7 @@ GameObject* Map::GetGameObject(ObjectGuid guid)
  */
 DynamicObject* Map::GetDynamicObject(ObjectGuid guid)
 {
+    std::shared_lock<std::shared_mutex> lock(m_objectsStoreLock);
     return m_objectsStore.find<DynamicObject>(guid, (DynamicObject*)nullptr);
 }
 
@@ -2308,7 +2991,9 @@ WorldObject* Map::GetWorldObject(ObjectGuid guid)
 
 void Map::SendObjectUpdates()
 {
-    UpdateDataMapType update_players;
+    TICK_PROFILE_ZONE("Map::SendObjectUpdates", i_id);
+
+    UpdateDataMapType update_players(TickArena::Resource());
 
     while (!i_objectsToClientUpdate.empty())
     {
@@ -2329,6 +3014,7 @@ void Map::SendObjectUpdates()
 
 Creature* Map::GetCreature(uint32 dbguid)
 {
+    std::shared_lock<std::shared_mutex> lock(m_objectsStoreLock);
     auto itr = m_dbGuidObjects.find(std::make_pair(HIGHGUID_UNIT, dbguid));
     if (itr == m_dbGuidObjects.end())
         return nullptr;
@@ -2346,6 +3032,7 @@ Creature* Map::GetCreature(uint32 dbguid)
 
 GameObject* Map::GetGameObject(uint32 dbguid)
 {
+    std::shared_lock<std::shared_mutex> lock(m_objectsStoreLock);
     auto itr = m_dbGuidObjects.find(std::make_pair(HIGHGUID_GAMEOBJECT, dbguid));
     if (itr == m_dbGuidObjects.end())
         return nullptr;
@@ -2356,17 +3043,148 @@ GameObject* Map::GetGameObject(uint32 dbguid)
     return static_cast<GameObject*>((*itr).second.front());
 }
 
+void Map::AddGameEventSpawns(GameEventSpawnList const& creatures, GameEventSpawnList const& gameobjects, bool spawn)
+{
+    // a pending opposite change of the same event is superseded, the new one covers all of its objects
+    m_gameEventSpawns.erase(std::remove_if(m_gameEventSpawns.begin(), m_gameEventSpawns.end(), [&creatures](GameEventSpawnBatch const& batch)
+    {
+        return batch.creatures == creatures;
+    }), m_gameEventSpawns.end());
+
+    m_gameEventSpawns.push_back({ creatures, gameobjects, spawn, 0 });
+}
+
+void Map::UpdateGameEventSpawns()
+{
+    uint32 const limit = sWorld.getConfig(CONFIG_UINT32_GAME_EVENT_SPAWNS_PER_UPDATE);
+    uint32 applied = 0;
+    while (!m_gameEventSpawns.empty() && (!limit || applied < limit))
+    {
+        GameEventSpawnBatch& batch = m_gameEventSpawns.front();
+        uint32 const creatureCount = batch.creatures->size();
+        uint32 const total = creatureCount + batch.gameobjects->size();
+        for (; batch.next < total && (!limit || applied < limit); ++batch.next)
+        {
+            if (batch.next < creatureCount)
+                applied += ApplyGameEventSpawn(HIGHGUID_UNIT, (*batch.creatures)[batch.next], batch.spawn) ? 1 : 0;
+            else
+                applied += ApplyGameEventSpawn(HIGHGUID_GAMEOBJECT, (*batch.gameobjects)[batch.next - creatureCount], batch.spawn) ? 1 : 0;
+        }
+
+        if (batch.next < total)
+            break;
+
+        m_gameEventSpawns.pop_front();
+    }
+}
+
+// Only objects in loaded grids are touched, grids loaded later already use the changed ObjectMgr cell data
+bool Map::ApplyGameEventSpawn(HighGuid high, uint32 dbGuid, bool spawn)
+{
+    if (high == HIGHGUID_UNIT)
+    {
+        if (!spawn)
+        {
+            Creature* creature = GetCreature(dbGuid);
+            if (!creature)
+                return false;
+
+            creature->AddObjectToRemoveList();
+            return true;
+        }
+
+        CreatureData const* data = sObjectMgr.GetCreatureData(dbGuid);
+        if (!data || !IsLoaded(data->posX, data->posY) || GetCreature(dbGuid))
+            return false;
+
+        Creature* creature = new Creature;
+        if (!creature->LoadFromDB(dbGuid, this, dbGuid, 0))
+        {
+            delete creature;
+            return false;
+        }
+        return true;
+    }
+
+    if (!spawn)
+    {
+        GameObject* gameobject = GetGameObject(dbGuid);
+        if (!gameobject)
+            return false;
+
+        gameobject->Delete();
+        return true;
+    }
+
+    GameObjectData const* data = sObjectMgr.GetGOData(dbGuid);
+    if (!data || !IsLoaded(data->posX, data->posY) || GetGameObject(dbGuid))
+        return false;
+
+    GameObject* gameobject = GameObject::CreateGameObject(data->id);
+    if (!gameobject->LoadFromDB(dbGuid, this, dbGuid, 0))
+    {
+        delete gameobject;
+        return false;
+    }
+    return true;
+}
+
 void Map::AddDbGuidObject(WorldObject* obj)
 {
+    std::unique_lock<std::shared_mutex> lock(m_objectsStoreLock);
     m_dbGuidObjects[std::make_pair(HighGuid(obj->GetParentHigh()), obj->GetDbGuid())].push_back(obj);
 }
 
 void Map::RemoveDbGuidObject(WorldObject* obj)
 {
+    std::unique_lock<std::shared_mutex> lock(m_objectsStoreLock);
     auto& vec = m_dbGuidObjects[std::make_pair(HighGuid(obj->GetParentHigh()), obj->GetDbGuid())];
     vec.erase(std::remove(vec.begin(), vec.end(), obj), vec.end());
 }
 
+void Map::AddTempCreature(uint32 entry, bool pet)
+{
+    std::unique_lock<std::shared_mutex> lock(m_objectsStoreLock);
+    ++(pet ? m_tempPets : m_tempCreatures)[entry];
+}
+
+void Map::RemoveTempCreature(uint32 entry, bool pet)
+{
+    std::unique_lock<std::shared_mutex> lock(m_objectsStoreLock);
+    std::map<uint32, uint32>& targetArray = pet ? m_tempPets : m_tempCreatures;
+    auto itr = targetArray.find(entry);
+    if (itr != targetArray.end() && --itr->second == 0)
+        targetArray.erase(itr);
+}
+
+std::map<uint32, uint32> Map::GetTempCreatures() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_objectsStoreLock);
+    return m_tempCreatures;
+}
+
+std::map<uint32, uint32> Map::GetTempPets() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_objectsStoreLock);
+    return m_tempPets;
+}
+
+void Map::AddCapturePoint(GameObject* go)
+{
+    m_capturePoints.push_back(go);
+}
+
+void Map::RemoveCapturePoint(GameObject* go)
+{
+    m_capturePoints.erase(std::remove(m_capturePoints.begin(), m_capturePoints.end(), go), m_capturePoints.end());
+}
+
+void Map::UpdateCapturePointPresence(Player* player)
+{
+    for (GameObject* go : m_capturePoints)
+        go->UpdateCapturePointPresence(player);
+}
+
 uint32 Map::GenerateLocalLowGuid(HighGuid guidhigh)
 {
     // TODO: for map local guid counters possible force reload map instead shutdown server at guid counter overflow
@@ -2491,8 +3309,67 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model);
+    bool const useCache = sWorld.getConfig(CONFIG_BOOL_VMAP_LOS_CACHE);
+    uint32 generation = 0;
+    if (useCache)
+    {
+        bool result;
+        if (m_losCache.Lookup(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model, result))
+            return result;
+        generation = m_losCache.GetGeneration();
+    }
+
+    bool result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model);
+    if (result)
+    {
+        std::shared_lock<std::shared_mutex> lock(m_dynTreeLock);
+        result = m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model);
+    }
+
+    if (useCache)
+        m_losCache.Store(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model, result, generation);
+    return result;
+}
+
+void Map::IsInLineOfSight(float srcX, float srcY, float srcZ, std::vector<Position> const& targets, uint32 phasemask, bool ignoreM2Model, std::vector<bool>& results) const
+{
+    results.assign(targets.size(), true);
+
+    // answer what the cache already knows and trace the rest as one batch
+    bool const useCache = sWorld.getConfig(CONFIG_BOOL_VMAP_LOS_CACHE);
+    uint32 const generation = m_losCache.GetGeneration();
+    std::vector<size_t> pending;
+    std::vector<G3D::Vector3> points;
+    pending.reserve(targets.size());
+    points.reserve(targets.size());
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+        Position const& target = targets[i];
+        bool result;
+        if (useCache && m_losCache.Lookup(srcX, srcY, srcZ, target.x, target.y, target.z, phasemask, ignoreM2Model, result))
+        {
+            results[i] = result;
+            continue;
+        }
+        pending.push_back(i);
+        points.push_back(G3D::Vector3(target.x, target.y, target.z));
+    }
+
+    if (pending.empty())
+        return;
+
+    std::vector<bool> staticResults;
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSightBatch(GetId(), G3D::Vector3(srcX, srcY, srcZ), points, staticResults, ignoreM2Model);
+
+    std::shared_lock<std::shared_mutex> lock(m_dynTreeLock);
+    for (size_t i = 0; i < pending.size(); ++i)
+    {
+        Position const& target = targets[pending[i]];
+        bool const result = staticResults[i] && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, target.x, target.y, target.z, phasemask, ignoreM2Model);
+        results[pending[i]] = result;
+        if (useCache)
+            m_losCache.Store(srcX, srcY, srcZ, target.x, target.y, target.z, phasemask, ignoreM2Model, result, generation);
+    }
 }
 
 /**
@@ -2512,6 +3389,7 @@ bool Map::GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float
         destZ = tempZ;
     }
     // at second all dynamic objects, if static check has an hit, then we can calculate only to this closer point
+    std::shared_lock<std::shared_mutex> lock(m_dynTreeLock);
     bool result1 = m_dyn_tree.getObjectHitPos(phasemask, srcX, srcY, srcZ, destX, destY, destZ, tempX, tempY, tempZ, modifyDist);
     if (result1)
     {
@@ -2575,6 +3453,7 @@ bool Map::GetHeightInRange(uint32 phasemask, float x, float y, float& z, float m
             return false;
     }
 
+    std::shared_lock<std::shared_mutex> lock(m_dynTreeLock);
     z = std::max<float>(height, m_dyn_tree.getHeight(x, y, height + 1.0f, maxSearchDist, phasemask));
     return true;
 }
@@ -2585,21 +3464,31 @@ float Map::GetHeight(uint32 phasemask, float x, float y, float z, bool swim) con
 
     // Get Dynamic Height around static Height (if valid)
     float dynSearchHeight = 2.0f + (z < staticHeight ? staticHeight : z);
+    std::shared_lock<std::shared_mutex> lock(m_dynTreeLock);
     return std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight, phasemask));
 }
 
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
-    m_dyn_tree.insert(mdl);
+    {
+        std::unique_lock<std::shared_mutex> lock(m_dynTreeLock);
+        m_dyn_tree.insert(mdl);
+    }
+    m_losCache.Invalidate();
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
-    m_dyn_tree.remove(mdl);
+    {
+        std::unique_lock<std::shared_mutex> lock(m_dynTreeLock);
+        m_dyn_tree.remove(mdl);
+    }
+    m_losCache.Invalidate();
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
 {
+    std::shared_lock<std::shared_mutex> lock(m_dynTreeLock);
     return m_dyn_tree.contains(mdl);
 }
 
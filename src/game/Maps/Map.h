@@ -34,15 +34,28 @@
 #include "DBScripts/ScriptMgr.h"
 #include "Entities/CreatureLinkingMgr.h"
 #include "Vmap/DynamicTree.h"
+#include "Maps/LineOfSightCache.h"
+#include "Maps/ScriptSchedule.h"
 #include "Multithreading/Messager.h"
 #include "Globals/GraveyardManager.h"
 #include "Maps/SpawnManager.h"
 #include "Maps/MapDataContainer.h"
 #include "World/WorldStateVariableManager.h"
+#include "Maps/MapUpdater.h"
+#include "Maps/MapLoadShedder.h"
+#include "Maps/MapSnapshot.h"
+#include "Util/SlabPool.h"
+#ifdef BUILD_PLAYERBOT
+#include "PlayerBot/Base/PlayerbotUpdateBudget.h"
+#endif
 
 #include <bitset>
+#include <deque>
 #include <functional>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 
 struct CreatureInfo;
 class Creature;
@@ -114,6 +127,48 @@ struct ZoneDynamicInfo
 
 typedef std::unordered_map<uint32 /*zoneId*/, ZoneDynamicInfo> ZoneDynamicInfoMap;
 
+#define MAX_GRID_CHURN        3                             // grid reloads that each extend the next removal delay
+
+// grid waiting for its clean up delay, unloaded early when GridCleanUp.MaxLoadedGrids is exceeded
+struct GridUnloadCandidate
+{
+    Map* map;
+    uint32 x;
+    uint32 y;
+    uint32 lastAccess;                                      // WorldTimer::getMSTime() of the last update in active state
+};
+
+// Marks the calling thread as working on a single map, used while packets are processed from Map::Update()
+// so cross-map object access done by their handlers can be reported (see Network.ValidateMapThreadAccess)
+class MapAccessScope
+{
+    public:
+        explicit MapAccessScope(Map const* map) : m_previous(m_map) { m_map = map; }
+        ~MapAccessScope() { m_map = m_previous; }
+        MapAccessScope(MapAccessScope const&) = delete;
+        MapAccessScope& operator=(MapAccessScope const&) = delete;
+
+        // map the calling thread is bound to, nullptr when it may access any map
+        static Map const* GetMap() { return m_map; }
+
+        // report access to an object placed on another map than the one of the current scope
+        static void Validate(WorldObject const* object, char const* accessor);
+
+    private:
+        Map const* m_previous;
+        static thread_local Map const* m_map;
+};
+
+class dtNavMeshQuery;
+namespace MMAP { class NavMeshQueryPool; }
+class PathRequest;
+class PathRequestQueue;
+struct MapUpdateMetrics;
+class PathCache;
+class WaypointSegmentCache;
+namespace Movement { class MoveSplineBatch; }
+class MapCostSampler;
+
 class Map : public GridRefManager<NGridType>
 {
         friend class MapReference;
@@ -144,7 +199,6 @@ class Map : public GridRefManager<NGridType>
 
         static void DeleteFromWorld(Player* pl);        // player object will deleted at call
 
-        void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
         virtual void Update(const uint32&);
 
         void MessageBroadcast(Player const*, WorldPacket const&, bool to_self);
@@ -160,7 +214,12 @@ class Map : public GridRefManager<NGridType>
         void ExecuteMapWorkerZone(uint32 zoneId, std::function<void(Player*)> const& worker);
         void ExecuteMapWorkerArea(uint32 areaId, std::function<void(Player*)> const& worker);
 
-        float GetVisibilityDistance() const { return m_VisibleDistance; }
+        float GetVisibilityDistance() const { return m_shedVisibleDistance ? m_shedVisibleDistance : m_VisibleDistance; }
+        // configured relocation limits, raised while the map sheds load, see Visibility.LoadShedding.Threshold
+        float GetRelocationLowerLimitSq() const { return m_relocationLowerLimitSq; }
+        uint32 GetRelocationAINotifyDelay() const { return m_relocationAINotifyDelay; }
+        // observers closer than this receive every relayed heartbeat, 0 when throttling is disabled
+        float GetFullRateRelayDistance() const { return m_fullRateRelayDistance; }
         // function for setting up visibility distance for maps on per-type/per-Id basis
         virtual void InitVisibilityDistance();
 
@@ -186,6 +245,8 @@ class Map : public GridRefManager<NGridType>
         bool GetUnloadLock(const GridPair& p) const { return getNGrid(p.x_coord, p.y_coord)->getUnloadLock(); }
         void SetUnloadLock(const GridPair& p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadExplicitLock(on); }
         void ForceLoadGrid(float x, float y);
+        // force loads the grids of all given positions, their terrain and vmap tiles are read on several threads first
+        void ForceLoadGrids(std::vector<std::pair<float, float>> const& positions);
         bool UnloadGrid(const uint32& x, const uint32& y, bool pForce);
         virtual void UnloadAll(bool pForce);
 
@@ -195,6 +256,16 @@ class Map : public GridRefManager<NGridType>
         }
 
         time_t GetGridExpiry(void) const { return i_gridExpiry; }
+        // grids loaded again soon after they were unloaded stay longer in removal state, see IdleState
+        float GetGridExpiryFactor(uint32 x, uint32 y) const { return 1.0f + m_gridChurn[x][y]; }
+        void TouchGrid(uint32 x, uint32 y) { m_gridLastAccess[x][y] = WorldTimer::getMSTime(); }
+        uint32 GetCreatedGridsCount() const { return m_createdGridCount; }
+
+        // state of the last finished update, lock free and safe from any thread, nullptr before the first update
+        std::shared_ptr<MapSnapshot const> GetSnapshot() const { return std::atomic_load(&m_snapshot); }
+        void CollectGridUnloadCandidates(std::vector<GridUnloadCandidate>& candidates);
+        // terrain grids (gridX << 16 | gridY) with map and vmap tiles loaded, kept warm for new instances
+        void GetLoadedTerrainGrids(std::vector<uint32>& grids) const;
         uint32 GetId(void) const { return i_id; }
 
         // some calls like isInWater should not use vmaps due to processor power
@@ -243,10 +314,6 @@ class Map : public GridRefManager<NGridType>
 
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, const CellPair& cellpair);
 
-        void resetMarkedCells() { marked_cells.reset(); }
-        bool isCellMarked(uint32 pCellId) const { return marked_cells.test(pCellId); }
-        void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
-
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(uint32 x, uint32 y) const;
@@ -255,6 +322,25 @@ class Map : public GridRefManager<NGridType>
         void SendToPlayers(WorldPacket const& data) const;
         /// Send a Packet to all players in a zone. Return false if no player found
         bool SendToPlayersInZone(WorldPacket const& data, uint32 zoneId) const;
+        bool SendToPlayersInZone(std::shared_ptr<WorldPacket const> const& data, uint32 zoneId) const;
+        bool HasPlayersInZone(uint32 zoneId) const;
+
+        /// Queue a relayed movement packet for the receivers, sent to each of them as one write by SendMovementRelays()
+        /// only used while the map processes the packets of its sessions, SendMovementRelays() follows right after
+        void QueueMovementRelay(std::vector<Player*> const& receivers, std::shared_ptr<WorldPacket const> const& data);
+        void SendMovementRelays();
+
+        /// Queue the visibility update of a unit moved past the relocation limit, see Visibility.CoalesceRelocations
+        void QueueRelocationNotify(Unit* unit);
+
+        /// While alive, units relocated by the creating thread queue their visibility update even without Visibility.CoalesceRelocations
+        class RelocationBatch
+        {
+            public:
+                RelocationBatch();
+                ~RelocationBatch();
+                static bool IsActive();
+        };
 
         typedef MapRefManager PlayerList;
         PlayerList const& GetPlayers() const { return m_mapRefManager; }
@@ -299,18 +385,38 @@ class Map : public GridRefManager<NGridType>
         void AddDbGuidObject(WorldObject* obj);
         void RemoveDbGuidObject(WorldObject* obj);
 
+        // capture points track the players in their radius from relocations instead of searching grids every tick
+        void AddCapturePoint(GameObject* go);
+        void RemoveCapturePoint(GameObject* go);
+        void UpdateCapturePointPresence(Player* player);
+
         typedef TypeUnorderedMapContainer<AllMapStoredObjectTypes, ObjectGuid> MapStoredObjectTypesContainer;
-        MapStoredObjectTypesContainer& GetObjectsStore() { return m_objectsStore; }
-        std::map<uint32, uint32>& GetTempCreatures() { return m_tempCreatures; }
-        std::map<uint32, uint32>& GetTempPets() { return m_tempPets; }
+        // objects enter and leave the world on the cell threads too, changes of the store go through these
+        template<class T> void InsertObject(ObjectGuid guid, T* obj)
+        {
+            std::unique_lock<std::shared_mutex> lock(m_objectsStoreLock);
+            m_objectsStore.insert<T>(guid, obj);
+        }
+        template<class T> void EraseObject(ObjectGuid guid)
+        {
+            std::unique_lock<std::shared_mutex> lock(m_objectsStoreLock);
+            m_objectsStore.erase<T>(guid, (T*)nullptr);
+        }
+        MapStoredObjectTypesContainer& GetObjectsStore() { return m_objectsStore; } // iterate on the map thread only
+        void AddTempCreature(uint32 entry, bool pet);
+        void RemoveTempCreature(uint32 entry, bool pet);
+        std::map<uint32, uint32> GetTempCreatures() const;
+        std::map<uint32, uint32> GetTempPets() const;
 
         void AddUpdateObject(Object* obj)
         {
+            std::lock_guard<std::mutex> guard(m_objectUpdateLock);
             i_objectsToClientUpdate.insert(obj);
         }
 
         void RemoveUpdateObject(Object* obj)
         {
+            std::lock_guard<std::mutex> guard(m_objectUpdateLock);
             i_objectsToClientUpdate.erase(obj);
         }
 
@@ -332,12 +438,29 @@ class Map : public GridRefManager<NGridType>
         float GetHeight(uint32 phasemask, float x, float y, float z, bool swim = false) const;
         bool GetHeightInRange(uint32 phasemask, float x, float y, float& z, float maxSearchDist = 4.0f) const;
         bool IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model) const;
+        // one static tree walk for all rays from the source, results[i] tells if targets[i] is visible
+        void IsInLineOfSight(float srcX, float srcY, float srcZ, std::vector<Position> const& targets, uint32 phasemask, bool ignoreM2Model, std::vector<bool>& results) const;
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, uint32 phasemask, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
         void InsertGameObjectModel(const GameObjectModel& mdl);
         void RemoveGameObjectModel(const GameObjectModel& mdl);
         bool ContainsGameObjectModel(const GameObjectModel& mdl) const;
+        // models switching collision on or off in place have to drop the cached results themselves
+        void InvalidateLineOfSightCache() { m_losCache.Invalidate(); }
+
+        // navmesh tile at the position was evicted for the memory budget, reloaded at the start of the next update
+        void RequestNavTile(float x, float y);
+
+        // path computed at the start of the next update, see PathRequestQueue
+        void QueuePathRequest(std::shared_ptr<PathRequest> const& request);
+        // polygon corridors of recent paths, cleared when a navmesh tile of the map changes
+        PathCache* GetPathCache() const { return m_pathCache.get(); }
+        WaypointSegmentCache* GetWaypointSegmentCache() const { return m_waypointSegmentCache.get(); }
+        uint32 GetUpdateGeneration() const { return m_updateGeneration; }
+#ifdef BUILD_PLAYERBOT
+        PlayerbotUpdateBudget& GetPlayerbotUpdateBudget() { return m_playerbotUpdateBudget; }
+#endif
 
         // Get Holder for Creature Linking
         CreatureLinkingHolder* GetCreatureLinkingHolder() { return &m_creatureLinkingHolder; }
@@ -378,8 +501,24 @@ class Map : public GridRefManager<NGridType>
 
         uint32 GetLoadedGridsCount();
 
+        // duration of Map::Update in microseconds, rolling average is used as cost hint by the MapUpdater
+        uint64 GetLastUpdateCost() const { return m_lastUpdateCost; }
+        uint64 GetUpdateCost() const { return m_updateCost; }
+        void SetLastUpdateCost(uint64 cost)
+        {
+            m_lastUpdateCost = cost;
+            m_updateCost = m_updateCost ? (m_updateCost * 7 + cost) / 8 : cost;
+        }
+
         Messager<Map>& GetMessager() { return m_messager; }
 
+        // game event spawns or despawns of this map, applied over the next updates, see Event.SpawnsPerUpdate
+        typedef std::shared_ptr<std::vector<uint32> const> GameEventSpawnList;
+        void AddGameEventSpawns(GameEventSpawnList const& creatures, GameEventSpawnList const& gameobjects, bool spawn);
+
+        // object update costs of the sampled ticks, see MapUpdate.CostSampleInterval
+        MapCostSampler& GetCostSampler() { return *m_costSampler; }
+
         typedef std::set<Transport*> TransportSet;
         GenericTransport* GetTransport(ObjectGuid guid);
         TransportSet const& GetTransports() { return m_transports; }
@@ -392,6 +531,8 @@ class Map : public GridRefManager<NGridType>
         bool CanSpawn(TypeID typeId, uint32 dbGuid);
 
         SpawnManager& GetSpawnManager() { return m_spawnManager; }
+        // creatures and gameobjects created while the map updates or loads grids reuse its blocks
+        SlabPool& GetObjectPool() { return *m_objectPool; }
 
         MapDataContainer& GetMapDataContainer() { return m_dataContainer; }
         MapDataContainer const& GetMapDataContainer() const { return m_dataContainer; }
@@ -411,11 +552,17 @@ class Map : public GridRefManager<NGridType>
         void ChangeGOPathfinding(uint32 entry, uint32 displayId, bool apply);
         // Only loads one tile in one location - for testing only - also uses existing precomputed tiles
         void SetNavTile(uint32 tileX, uint32 tileY, uint32 tileNumber);
+        // query owned by the calling map or cell update thread, nullptr without navmesh
+        dtNavMeshQuery const* GetNavMeshQuery() const;
 
         void AwardLFGRewards(uint32 dungeonId);
 
     private:
         void LoadMapAndVMap(int gx, int gy);
+        bool LoadNavTile(int gx, int gy);
+        void UpdateNavTiles(uint32 diff);
+        void UpdateLoadShedding(uint32 diff);
+        void ProcessRelocationNotifies(uint32 diff);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -427,6 +574,18 @@ class Map : public GridRefManager<NGridType>
 
         bool CreatureCellRelocation(Creature* c, const Cell& new_cell);
 
+        // Active cells are reference counted per player/active object and only change when they cross a cell border
+        enum ActiveCellSource
+        {
+            ACTIVE_CELLS_OBJECT     = 0,                    // cells around the object itself
+            ACTIVE_CELLS_FAR_SIGHT  = 1,                    // cells around the far sight target of a player
+            MAX_ACTIVE_CELLS_SOURCE
+        };
+        void UpdateActiveCellsOf(WorldObject const* obj, ActiveCellSource source, WorldObject const* center, float radius);
+        void ReleaseActiveCellsOf(WorldObject const* obj, ActiveCellSource source);
+        void ChangeActiveCellArea(CellArea const& area, bool add);
+        void UpdateCellRegions(uint32 diff, MapCostSampler* sampler);
+
         bool loaded(const GridPair&) const;
         void EnsureGridCreated(const GridPair&);
         bool EnsureGridLoaded(Cell const&);
@@ -457,6 +616,11 @@ class Map : public GridRefManager<NGridType>
         uint32 i_InstanceId;
         uint32 m_unloadTimer;
         float m_VisibleDistance;
+        float m_shedVisibleDistance;                        // 0 while no load is shed
+        float m_relocationLowerLimitSq;
+        uint32 m_relocationAINotifyDelay;
+        MapLoadShedder m_loadShedder;
+        float m_fullRateRelayDistance;
         MapPersistentState* m_persistentState;
 
         MapRefManager m_mapRefManager;
@@ -465,10 +629,13 @@ class Map : public GridRefManager<NGridType>
         typedef WorldObjectSet ActiveNonPlayers;
         ActiveNonPlayers m_activeNonPlayers;
         ActiveNonPlayers::iterator m_activeNonPlayersIter;
+        std::recursive_mutex m_activeNonPlayersLock;        // objects turn active or inactive on the cell threads, grid loading reenters
         MapStoredObjectTypesContainer m_objectsStore;
         std::map<uint32, uint32> m_tempCreatures;
         std::map<uint32, uint32> m_tempPets;
         std::map<std::pair<HighGuid, uint32>, std::vector<WorldObject*>> m_dbGuidObjects;
+        mutable std::shared_mutex m_objectsStoreLock;       // guards the four containers above
+        std::vector<GameObject*> m_capturePoints;
 
         WorldObjectSet m_onEventNotifiedObjects;
         WorldObjectSet::iterator m_onEventNotifiedIter;
@@ -485,12 +652,56 @@ class Map : public GridRefManager<NGridType>
         TerrainInfo* const m_TerrainData;
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
-        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        // grid access history, kept after the grid itself is unloaded
+        uint32 m_gridLastAccess[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        uint32 m_gridUnloadTime[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        uint8 m_gridChurn[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        uint32 m_createdGridCount;
+
+        void PublishSnapshot();
+        std::shared_ptr<MapSnapshot const> m_snapshot;
+
+        // grid loads and unloads since the last report, see Map::Update
+        uint32 m_gridLoads;
+        uint32 m_gridUnloads;
+        ShortIntervalTimer m_gridStatsTimer;
+
+        // movement relays collected for every receiver since the last SendMovementRelays(), in relay order
+        std::mutex m_movementRelayLock;
+        std::unordered_map<ObjectGuid, std::vector<std::shared_ptr<WorldPacket const>>> m_movementRelays;
+
+        // units relocated since the last ProcessRelocationNotifies(), relocations can come from the cell updater threads
+        std::mutex m_relocationNotifyLock;
+        GuidSet m_relocationNotifies;
+        ShortIntervalTimer m_relocationNotifyTimer;
+
+        std::unordered_map<uint32 /*cell_id*/, uint32 /*refs*/> m_activeCells;
+        std::unordered_map<WorldObject const*, CellArea> m_activeCellAreas[MAX_ACTIVE_CELLS_SOURCE];
+
+        // Parallel cell update (MapUpdate.CellThreads), only created for continents, runs on the
+        // cell threads shared by all continents. Active cells are bucketed per grid column, columns
+        // updated at the same time have two idle columns between them, see UpdateCellRegions
+        std::unique_ptr<MapUpdater> m_cellUpdater;
+        std::unique_ptr<MMAP::NavMeshQueryPool> m_navMeshQueries; // slot 0 for the map thread, then one per cell thread
+        std::vector<Cell> m_cellRegions[MAX_NUMBER_OF_GRIDS];
+        WorldObjectVector m_cellRegionObjects[MAX_NUMBER_OF_GRIDS];
+        std::mutex m_objectUpdateLock;                      // guards i_objectsToClientUpdate and i_objectsToRemove
 
         WorldObjectSet i_objectsToRemove;
 
-        typedef std::multimap<TimePoint, ScriptAction> ScriptScheduleMap;
-        ScriptScheduleMap m_scriptSchedule;
+        ScriptSchedule m_scriptSchedule;
+        std::mutex m_scriptScheduleLock;                    // scripts are started from the cell threads
+
+        struct GameEventSpawnBatch
+        {
+            GameEventSpawnList creatures;
+            GameEventSpawnList gameobjects;
+            bool spawn;
+            uint32 next;                                    // position over creatures, then gameobjects
+        };
+        void UpdateGameEventSpawns();
+        bool ApplyGameEventSpawn(HighGuid high, uint32 dbGuid, bool spawn);
+        std::deque<GameEventSpawnBatch> m_gameEventSpawns;
 
         InstanceData* i_data;
         uint32 i_script_id;
@@ -514,9 +725,22 @@ class Map : public GridRefManager<NGridType>
 
         // Dynamic Map tree object
         DynamicMapTree m_dyn_tree;
+        mutable std::shared_mutex m_dynTreeLock;            // gameobject models move while the cell threads query it
+        mutable LineOfSightCache m_losCache;
+        std::unique_ptr<PathRequestQueue> m_pathRequests;
+        std::unique_ptr<PathCache> m_pathCache;
+        std::unique_ptr<WaypointSegmentCache> m_waypointSegmentCache;
+        std::unique_ptr<Movement::MoveSplineBatch> m_splineBatch;
+        std::unique_ptr<MapCostSampler> m_costSampler;
+        SlabPool* m_objectPool;                             // released in the destructor, freed with its last object
+#ifdef BUILD_PLAYERBOT
+        PlayerbotUpdateBudget m_playerbotUpdateBudget;
+#endif
+        MapUpdateMetrics const* m_updateMetrics;            // shared by all instances of the map id, null without BUILD_METRICS
 
         // WeatherSystem
         WeatherSystem* m_weatherSystem;
+        uint32 m_weatherUpdateDiff;                         // accumulated while weather updates are deferred
 
         // Transports
         TransportSet m_transports;
@@ -532,6 +756,22 @@ class Map : public GridRefManager<NGridType>
 
         WorldStateVariableManager m_variableManager;
 
+        uint64 m_lastUpdateCost;
+        uint64 m_updateCost;
+
+        // objects queued for update in the current tick, deduplicated by WorldObject::MarkUpdateGeneration
+        uint32 m_updateGeneration;
+
+        // how often the grids ahead of moving players are predicted
+        ShortIntervalTimer m_gridPreloadTimer;
+
+        // navmesh tiles unloaded by mmap.MemoryBudget, packed gx << 16 | gy
+        ShortIntervalTimer m_navTileTimer;
+        std::mutex m_navTileLock;
+        std::set<uint32> m_evictedNavTiles;
+        std::set<uint32> m_navTileRequests;
+        WorldObjectVector m_objectsToUpdate;
+
         ZoneDynamicInfoMap m_zoneDynamicInfo;
         ZoneDynamicInfoMap m_areaDynamicInfo;
         uint32 m_defaultLight;
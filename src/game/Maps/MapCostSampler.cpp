@@ -0,0 +1,207 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/MapCostSampler.h"
+#include "Maps/GridDefines.h"
+#include "Entities/Creature.h"
+#include "Entities/GameObject.h"
+#include "Globals/ObjectMgr.h"
+#include "AI/ScriptDevAI/ScriptDevAIMgr.h"
+#include "World/World.h"
+
+#ifdef BUILD_METRICS
+ #include "Metric/Aggregate.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    template <typename Key, typename Value>
+    std::vector<std::pair<Key, MapCostSampler::Cost>> SortedByTotal(std::unordered_map<Key, Value> const& costs)
+    {
+        std::vector<std::pair<Key, MapCostSampler::Cost>> sorted(costs.begin(), costs.end());
+        std::sort(sorted.begin(), sorted.end(), [](std::pair<Key, MapCostSampler::Cost> const& a, std::pair<Key, MapCostSampler::Cost> const& b)
+        {
+            return a.second.total > b.second.total;
+        });
+        return sorted;
+    }
+}
+
+void MapCostSampler::Cost::Add(uint64 elapsed)
+{
+    total += elapsed;
+    ++samples;
+    if (elapsed > max)
+        max = elapsed;
+
+#ifdef BUILD_METRICS
+    if (counter && total / 1000 > exportedUs)
+    {
+        counter->add(int64(total / 1000 - exportedUs));
+        exportedUs = total / 1000;
+    }
+#endif
+}
+
+MapCostSampler::MapCostSampler(uint32 mapId) : m_mapId(mapId), m_ticks(0)
+{
+}
+
+bool MapCostSampler::IsSampledTick(uint32 generation)
+{
+    uint32 const interval = sWorld.getConfig(CONFIG_UINT32_MAP_COST_SAMPLE_INTERVAL);
+    return interval && generation % interval == 0;
+}
+
+MapCostSampler::SampleBatch& MapCostSampler::LocalBatch()
+{
+    // one per updating thread, keeps its storage between sampled ticks
+    static thread_local SampleBatch batch;
+    return batch;
+}
+
+void MapCostSampler::Time(WorldObject* object, uint32 diff, SampleBatch& batch)
+{
+    // keys are taken before the update, it may move the object into another grid
+    GridPair const grid = MaNGOS::ComputeGridPair(object->GetPositionX(), object->GetPositionY());
+
+    Sample sample;
+    sample.grid = grid.x_coord * MAX_NUMBER_OF_GRIDS + grid.y_coord;
+    sample.zone = object->GetZoneId();
+    sample.entryKey = (uint64(object->GetTypeId()) << 32) | object->GetEntry();
+    switch (object->GetTypeId())
+    {
+        case TYPEID_UNIT: sample.scriptId = static_cast<Creature*>(object)->GetScriptId(); break;
+        case TYPEID_GAMEOBJECT: sample.scriptId = static_cast<GameObject*>(object)->GetScriptId(); break;
+        default: sample.scriptId = 0; break;
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    object->Update(diff);
+    sample.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    batch.push_back(sample);
+}
+
+void MapCostSampler::UpdateObjects(WorldObjectVector const& objects, uint32 diff)
+{
+    SampleBatch& batch = LocalBatch();
+    batch.clear();
+    for (WorldObject* object : objects)
+        Time(object, diff, batch);
+    Merge(batch);
+}
+
+void MapCostSampler::BeginBatch()
+{
+    LocalBatch().clear();
+}
+
+void MapCostSampler::UpdateObject(WorldObject* object, uint32 diff)
+{
+    Time(object, diff, LocalBatch());
+}
+
+void MapCostSampler::EndBatch()
+{
+    Merge(LocalBatch());
+}
+
+std::string MapCostSampler::GetScriptName(uint64 entryKey, uint32 scriptId)
+{
+    if (scriptId)
+        return sScriptDevAIMgr.GetScriptName(scriptId);
+
+    switch (uint32(entryKey >> 32))
+    {
+        case TYPEID_PLAYER:
+            return "(player)";
+        case TYPEID_UNIT:
+            if (CreatureInfo const* info = ObjectMgr::GetCreatureTemplate(uint32(entryKey)))
+                if (info->AIName && *info->AIName)
+                    return info->AIName;
+            return "(default)";
+        default:
+            return "(none)";
+    }
+}
+
+void MapCostSampler::Merge(SampleBatch const& batch)
+{
+    if (batch.empty())
+        return;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (Sample const& sample : batch)
+    {
+        m_grids[sample.grid].Add(sample.elapsed);
+
+        Cost& zone = m_zones[sample.zone];
+        EntryCost& entry = m_entries[sample.entryKey];
+#ifdef BUILD_METRICS
+        // handles are interned, registering again after a Reset() returns the same counter
+        if (!zone.counter)
+            zone.counter = &metric::aggregates::instance().register_counter("map.cost.zone_us", {
+                { "map_id", std::to_string(m_mapId) },
+                { "zone_id", std::to_string(sample.zone) }
+            });
+        if (!entry.counter)
+            entry.counter = &metric::aggregates::instance().register_counter("map.cost.script_us", {
+                { "map_id", std::to_string(m_mapId) },
+                { "script", GetScriptName(sample.entryKey, sample.scriptId) }
+            });
+#endif
+        zone.Add(sample.elapsed);
+
+        if (!entry.samples)
+            entry.scriptId = sample.scriptId;
+        entry.Add(sample.elapsed);
+    }
+}
+
+void MapCostSampler::GetSnapshot(Snapshot& snapshot) const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    snapshot.ticks = m_ticks;
+    snapshot.grids = SortedByTotal(m_grids);
+    snapshot.zones = SortedByTotal(m_zones);
+    snapshot.entries = SortedByTotal(m_entries);
+
+    std::unordered_map<std::string, Cost> scripts;
+    for (auto const& entry : m_entries)
+    {
+        Cost& script = scripts[GetScriptName(entry.first, entry.second.scriptId)];
+        script.total += entry.second.total;
+        script.samples += entry.second.samples;
+        script.max = std::max(script.max, entry.second.max);
+    }
+    snapshot.scripts = SortedByTotal(scripts);
+}
+
+void MapCostSampler::Reset()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_ticks = 0;
+    m_grids.clear();
+    m_zones.clear();
+    m_entries.clear();
+}
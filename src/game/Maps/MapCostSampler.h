@@ -0,0 +1,116 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPCOSTSAMPLER_H
+#define MANGOS_MAPCOSTSAMPLER_H
+
+#include "Common.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class WorldObject;
+typedef std::vector<WorldObject*> WorldObjectVector;
+
+namespace metric { class counter; }
+
+// Cost of the object updates of one map, attributed to grid, zone, entry and script.
+// Every MapUpdate.CostSampleInterval-th tick each object update is timed on its own,
+// other ticks pay nothing. Samples are collected per updating thread and merged once
+// per batch, so parallel cell updates only take the lock at their end.
+class MapCostSampler
+{
+    public:
+        struct Cost
+        {
+            Cost() : total(0), samples(0), max(0), exportedUs(0), counter(nullptr) {}
+
+            void Add(uint64 elapsed);
+
+            uint64 total;                                   // nanoseconds
+            uint32 samples;
+            uint64 max;
+            uint64 exportedUs;                              // part of total already added to the counter
+            metric::counter* counter;                       // only set with BUILD_METRICS
+        };
+
+        // sorted by total cost, most expensive first
+        struct Snapshot
+        {
+            uint32 ticks;
+            std::vector<std::pair<uint32, Cost>> grids;     // grid x * MAX_NUMBER_OF_GRIDS + grid y
+            std::vector<std::pair<uint32, Cost>> zones;
+            std::vector<std::pair<uint64, Cost>> entries;   // type id << 32 | entry
+            std::vector<std::pair<std::string, Cost>> scripts;
+        };
+
+        explicit MapCostSampler(uint32 mapId);
+
+        // whether the object updates of the tick with this update generation are timed
+        static bool IsSampledTick(uint32 generation);
+
+        // updates each object and times it, called by the map thread and the cell threads
+        void UpdateObjects(WorldObjectVector const& objects, uint32 diff);
+
+        // for objects updated outside of an object list (players)
+        void BeginBatch();
+        void UpdateObject(WorldObject* object, uint32 diff);
+        void EndBatch();
+
+        void AddTick() { std::lock_guard<std::mutex> guard(m_lock); ++m_ticks; }
+
+        void GetSnapshot(Snapshot& snapshot) const;
+        void Reset();
+
+        static std::string GetScriptName(uint64 entryKey, uint32 scriptId);
+
+    private:
+        struct Sample
+        {
+            uint32 grid;
+            uint32 zone;
+            uint64 entryKey;
+            uint32 scriptId;
+            uint64 elapsed;
+        };
+
+        typedef std::vector<Sample> SampleBatch;
+
+        struct EntryCost : Cost
+        {
+            EntryCost() : scriptId(0) {}
+
+            uint32 scriptId;                                // of the first sampled object with this entry
+        };
+
+        static SampleBatch& LocalBatch();
+        static void Time(WorldObject* object, uint32 diff, SampleBatch& batch);
+        void Merge(SampleBatch const& batch);
+
+        uint32 const m_mapId;
+
+        mutable std::mutex m_lock;
+        uint32 m_ticks;
+        std::unordered_map<uint32, Cost> m_grids;
+        std::unordered_map<uint32, Cost> m_zones;
+        std::unordered_map<uint64, EntryCost> m_entries;
+};
+
+#endif
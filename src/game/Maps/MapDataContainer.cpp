@@ -41,6 +41,15 @@ CreatureSpellList* MapDataContainer::GetCreatureSpellList(uint32 Id) const
     return &(*itr).second;
 }
 
+std::shared_ptr<CreatureSpellList const> MapDataContainer::GetSharedCreatureSpellList(uint32 Id) const
+{
+    auto itr = m_spellListContainer->spellLists.find(Id);
+    if (itr == m_spellListContainer->spellLists.end())
+        return nullptr;
+
+    return std::shared_ptr<CreatureSpellList const>(m_spellListContainer, &(*itr).second);
+}
+
 SpawnGroupEntry* MapDataContainer::GetSpawnGroup(uint32 Id) const
 {
     auto itr = m_spawnGroupContainer->spawnGroupMap.find(Id);
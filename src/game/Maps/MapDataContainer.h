@@ -42,6 +42,8 @@ class MapDataContainer
         MapDataContainer();
         void SetCreatureSpellListContainer(std::shared_ptr<CreatureSpellListContainer> container);
         CreatureSpellList* GetCreatureSpellList(uint32 Id) const;
+        // keeps the whole container alive, so creatures can share the list across spell list reloads
+        std::shared_ptr<CreatureSpellList const> GetSharedCreatureSpellList(uint32 Id) const;
         SpawnGroupEntry* GetSpawnGroup(uint32 Id) const;
         SpawnGroupEntry* GetSpawnGroupByGuid(uint32 dbGuid, uint32 high) const;
         std::shared_ptr<SpawnGroupEntryContainer> GetSpawnGroups() const;
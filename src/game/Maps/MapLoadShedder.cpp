@@ -0,0 +1,55 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/MapLoadShedder.h"
+#include "World/World.h"
+#include "Policies/Singleton.h"
+
+bool MapLoadShedder::Update(uint32 diff, uint64 updateCost)
+{
+    m_timer += diff;
+    if (m_timer < MAP_LOAD_SHEDDING_INTERVAL)
+        return false;
+    m_timer = 0;
+
+    uint64 const threshold = uint64(sWorld.getConfig(CONFIG_UINT32_VISIBILITY_SHEDDING_THRESHOLD)) * IN_MILLISECONDS;
+    if (!threshold)
+    {
+        m_level = 0;
+        m_calm = 0;
+    }
+    else if (updateCost >= threshold)
+    {
+        m_calm = 0;
+        if (m_level < MAP_LOAD_SHEDDING_LEVELS)
+            ++m_level;
+    }
+    else if (m_level && updateCost < threshold * 6 / 10)
+    {
+        m_calm += MAP_LOAD_SHEDDING_INTERVAL;
+        if (m_calm >= MAP_LOAD_SHEDDING_RECOVERY)
+        {
+            --m_level;
+            m_calm = 0;
+        }
+    }
+    else
+        m_calm = 0;
+
+    return true;
+}
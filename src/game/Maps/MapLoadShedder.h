@@ -0,0 +1,55 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPLOADSHEDDER_H
+#define MANGOS_MAPLOADSHEDDER_H
+
+#include "Common.h"
+
+#define MAP_LOAD_SHEDDING_LEVELS        4
+// map time between two evaluations, one level is added per evaluation above the threshold
+#define MAP_LOAD_SHEDDING_INTERVAL      (5 * IN_MILLISECONDS)
+// time below the recovery threshold before one level is given back
+#define MAP_LOAD_SHEDDING_RECOVERY      (30 * IN_MILLISECONDS)
+
+// Shedding level of one map chosen from its rolling update cost. While the cost is at or
+// above Visibility.LoadShedding.Threshold the level rises by one per evaluation; levels are
+// given back one at a time after the cost stayed below 60% of the threshold for the whole
+// recovery period. Each level shrinks the visibility distance and spaces out relocation
+// visibility and AI notifications, see the factors below.
+class MapLoadShedder
+{
+    public:
+        MapLoadShedder() : m_level(0), m_timer(0), m_calm(0) {}
+
+        // map thread, update cost in microseconds. True when the level was evaluated
+        bool Update(uint32 diff, uint64 updateCost);
+
+        uint32 GetLevel() const { return m_level; }
+
+        // multipliers of the configured visibility distance, relocation limit and AI notify delay
+        float GetDistanceFactor() const { return 1.0f - 0.15f * m_level; }
+        float GetRelocationFactor() const { return 1.0f + 0.5f * m_level; }
+
+    private:
+        uint32 m_level;
+        uint32 m_timer;
+        uint32 m_calm;                                      // time spent below the recovery threshold
+};
+
+#endif
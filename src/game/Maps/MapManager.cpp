@@ -27,7 +27,14 @@
 #include "Grids/CellImpl.h"
 #include "Globals/ObjectMgr.h"
 #include "Maps/MapWorkers.h"
+#include "Maps/GridPreloader.h"
+#include "World/TickProfiler.h"
 #include <future>
+#include <algorithm>
+
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
 
 #define CLASS_LOCK MaNGOS::ClassLevelLockable<MapManager, std::recursive_mutex>
 INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
@@ -37,6 +44,7 @@ MapManager::MapManager()
     : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN))
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
+    m_prewarmTimer.SetInterval(5 * MINUTE * IN_MILLISECONDS);
 }
 
 MapManager::~MapManager()
@@ -50,11 +58,17 @@ MapManager::~MapManager()
 void MapManager::Initialize()
 {
     InitStateMachine();
-    CreateContinents();
 
+    // started first, the continents are created on its threads
     int num_threads(sWorld.getConfig(CONFIG_UINT32_NUM_MAP_THREADS));
     if (num_threads > 0)
         m_updater.activate(num_threads);
+
+    // continents take their cell update tasks to it once initialized
+    if (uint32 cellThreads = sWorld.getConfig(CONFIG_UINT32_NUM_MAP_CELL_THREADS))
+        m_cellUpdater.activate(cellThreads);
+
+    CreateContinents();
 }
 
 void MapManager::InitStateMachine()
@@ -90,6 +104,8 @@ void MapManager::InitializeVisibilityDistanceInfo()
 
 void MapManager::CreateContinents()
 {
+    auto start = std::chrono::steady_clock::now();
+
     std::vector<std::future<void>> futures;
     uint32 continents[] = { 0, 1, 530, 571};
     for (auto id : continents)
@@ -98,12 +114,20 @@ void MapManager::CreateContinents()
         // add map into container
         i_maps[MapID(id)] = m;
 
-        // non-instanceable maps always expected have saved state
-        futures.push_back(std::async(std::launch::async, std::bind(&Map::Initialize, m, true)));
+        // non-instanceable maps always expected have saved state, preloaded grids (LoadAllGridsOnMaps) are loaded meanwhile
+        if (m_updater.activated())
+            m_updater.schedule_update(new MapInitializeWorker(*m, m_updater), sWorld.isForceLoadMap(id) ? 1 : 0);
+        else
+            futures.push_back(std::async(std::launch::async, std::bind(&Map::Initialize, m, true)));
     }
 
+    if (m_updater.activated())
+        m_updater.wait();
+
     for (auto& futurItr : futures)
         futurItr.wait();
+
+    sLog.outString("Continents created in %u ms", uint32(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()));
 }
 
 /// @param id - MapId of the to be created map. @param obj WorldObject for which the map is to be created. Must be player for Instancable maps.
@@ -195,16 +219,60 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
-    for (auto& map : i_maps)
+    if (m_updater.activated())
     {
-        if (m_updater.activated())
-            m_updater.schedule_update(new MapUpdateWorker(*map.second, (uint32)i_timer.GetCurrent(), m_updater));
-        else
+        // longest processing time first, heavy maps must not be picked up at the end of the tick
+        m_updateOrder.clear();
+        for (auto& map : i_maps)
+            m_updateOrder.push_back(map.second);
+        std::sort(m_updateOrder.begin(), m_updateOrder.end(), [](Map const* left, Map const* right)
+        {
+            return left->GetUpdateCost() > right->GetUpdateCost();
+        });
+
+#ifdef BUILD_METRICS
+        // expected tick length when each map goes to the least loaded thread
+        std::vector<uint64> threadLoad(std::max<size_t>(m_updater.threads(), 1), 0);
+        for (Map* map : m_updateOrder)
+            *std::min_element(threadLoad.begin(), threadLoad.end()) += map->GetUpdateCost();
+        uint64 predictedMakespan = *std::max_element(threadLoad.begin(), threadLoad.end());
+        auto start = std::chrono::steady_clock::now();
+#endif
+
+        for (Map* map : m_updateOrder)
+            m_updater.schedule_update(new MapUpdateWorker(*map, (uint32)i_timer.GetCurrent(), m_updater), map->GetUpdateCost());
+
+        m_updater.wait();
+
+#ifdef BUILD_METRICS
+        uint64 actualMakespan = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        metric::measurement meas("mapmanager.update");
+        meas.add_field("predicted_makespan", static_cast<int64>(predictedMakespan));
+        meas.add_field("actual_makespan", static_cast<int64>(actualMakespan));
+        meas.add_field("maps", static_cast<int32>(m_updateOrder.size()));
+#endif
+    }
+    else
+    {
+        for (auto& map : i_maps)
+        {
+            auto const start = std::chrono::steady_clock::now();
             map.second->Update((uint32)i_timer.GetCurrent());
+            map.second->SetLastUpdateCost(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        }
     }
 
-    if (m_updater.activated())
-        m_updater.wait();
+    TICK_PROFILE_ZONE("MapManager unload");
+
+    // no map updates at this point, grids of any map can be unloaded
+    UnloadGridsOverBudget();
+
+    m_prewarmTimer.Update(i_timer.GetCurrent());
+    if (m_prewarmTimer.Passed())
+    {
+        m_prewarmTimer.Reset();
+        UpdateInstancePrewarm();
+    }
 
     // remove all maps which can be unloaded
     MapMapType::iterator iter = i_maps.begin();
@@ -214,6 +282,7 @@ void MapManager::Update(uint32 diff)
         // check if map can be unloaded
         if (pMap->CanUnload((uint32)i_timer.GetCurrent()))
         {
+            RecordInstanceGrids(pMap);
             pMap->UnloadAll(true);
             delete pMap;
 
@@ -226,6 +295,92 @@ void MapManager::Update(uint32 diff)
     i_timer.SetCurrent(0);
 }
 
+void MapManager::UnloadGridsOverBudget()
+{
+    uint32 const budget = sWorld.getConfig(CONFIG_UINT32_GRID_MAX_LOADED);
+    if (!budget)
+        return;
+
+    uint32 loaded = 0;
+    for (auto& map : i_maps)
+        loaded += map.second->GetCreatedGridsCount();
+    if (loaded <= budget)
+        return;
+
+    std::vector<GridUnloadCandidate> candidates;
+    for (auto& map : i_maps)
+        map.second->CollectGridUnloadCandidates(candidates);
+
+    // least recently used first, compared by age so timer wrap around does not matter
+    uint32 const now = WorldTimer::getMSTime();
+    std::sort(candidates.begin(), candidates.end(), [now](GridUnloadCandidate const& left, GridUnloadCandidate const& right)
+    {
+        return WorldTimer::getMSTimeDiff(left.lastAccess, now) > WorldTimer::getMSTimeDiff(right.lastAccess, now);
+    });
+
+    for (GridUnloadCandidate const& candidate : candidates)
+    {
+        if (loaded <= budget)
+            break;
+
+        if (candidate.map->UnloadGrid(candidate.x, candidate.y, false))
+            --loaded;
+    }
+}
+
+void MapManager::RecordInstanceGrids(Map* map)
+{
+    if (!map->Instanceable() || !sWorld.getConfig(CONFIG_UINT32_INSTANCE_PREWARM_MAPS))
+        return;
+
+    std::vector<uint32> grids;
+    map->GetLoadedTerrainGrids(grids);
+    m_instanceGrids[map->GetId()].insert(grids.begin(), grids.end());
+}
+
+void MapManager::UpdateInstancePrewarm()
+{
+    uint32 const warmCount = sWorld.getConfig(CONFIG_UINT32_INSTANCE_PREWARM_MAPS);
+    if (!warmCount)
+        return;
+
+    for (auto& map : i_maps)
+        RecordInstanceGrids(map.second);
+
+    std::vector<std::pair<uint32, uint32>> popular(m_instanceCreations.begin(), m_instanceCreations.end());
+    std::sort(popular.begin(), popular.end(), [](std::pair<uint32, uint32> const& left, std::pair<uint32, uint32> const& right)
+    {
+        return left.second > right.second;
+    });
+
+    std::set<uint32> warmMaps;
+    for (size_t i = 0; i < popular.size() && warmMaps.size() < warmCount; ++i)
+        warmMaps.insert(popular[i].first);
+
+    for (uint32 mapId : m_warmMaps)
+        if (warmMaps.find(mapId) == warmMaps.end())
+            sGridPreloader.ReleaseWarmMap(mapId);
+
+    // grids seen since the last interval are added, already warm ones are kept as they are
+    for (uint32 mapId : warmMaps)
+    {
+        auto itr = m_instanceGrids.find(mapId);
+        if (itr != m_instanceGrids.end())
+            sGridPreloader.WarmGrids(mapId, std::vector<uint32>(itr->second.begin(), itr->second.end()));
+    }
+    m_warmMaps.swap(warmMaps);
+
+    // halved every interval, only recently created instances count
+    for (auto itr = m_instanceCreations.begin(); itr != m_instanceCreations.end();)
+    {
+        itr->second /= 2;
+        if (!itr->second)
+            itr = m_instanceCreations.erase(itr);
+        else
+            ++itr;
+    }
+}
+
 void MapManager::RemoveAllObjectsInRemoveList()
 {
     for (auto& i_map : i_maps)
@@ -263,6 +418,9 @@ void MapManager::UnloadAll()
     if (m_updater.activated())
         m_updater.deactivate();
 
+    if (m_cellUpdater.activated())
+        m_cellUpdater.deactivate();
+
     TerrainManager::Instance().UnloadAll();
 }
 
@@ -288,11 +446,21 @@ uint32 MapManager::GetNumPlayersInInstances()
     {
         Map* map = i_map.second;
         if (!map->IsDungeon()) continue;
-        ret += map->GetPlayers().getSize();
+        if (std::shared_ptr<MapSnapshot const> snapshot = map->GetSnapshot())
+            ret += snapshot->players.size();
     }
     return ret;
 }
 
+void MapManager::GetZonePopulation(std::unordered_map<uint32, uint32>& population)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (auto& i_map : i_maps)
+        if (std::shared_ptr<MapSnapshot const> snapshot = i_map.second->GetSnapshot())
+            for (auto const& zone : snapshot->zonePopulation)
+                population[zone.first] += zone.second;
+}
+
 ///// returns a new or existing Instance
 ///// in case of battlegrounds it will only return an existing map, those maps are created by bg-system
 Map* MapManager::CreateInstance(uint32 id, Player* player)
@@ -365,6 +533,7 @@ DungeonMap* MapManager::CreateDungeonMap(uint32 id, uint32 InstanceId, Difficult
     DEBUG_LOG("MapInstanced::CreateDungeonMap: %s map instance %d for %d created with difficulty %d", save ? "" : "new ", InstanceId, id, difficulty);
 
     DungeonMap* map = new DungeonMap(id, i_gridCleanUpDelay, InstanceId, difficulty);
+    ++m_instanceCreations[id];
 
     // Set owner team before initializing
     map->SetInstanceTeam(ownerTeam);
@@ -385,6 +554,7 @@ BattleGroundMap* MapManager::CreateBattleGroundMap(uint32 id, uint32 InstanceId,
     uint8 spawnMode = bracketEntry ? bracketEntry->difficulty : uint8(REGULAR_DIFFICULTY);
 
     BattleGroundMap* map = new BattleGroundMap(id, i_gridCleanUpDelay, InstanceId, spawnMode);
+    ++m_instanceCreations[id];
     MANGOS_ASSERT(map->IsBattleGroundOrArena());
     map->SetBG(bg);
     bg->SetBgMap(map);
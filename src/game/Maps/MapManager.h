@@ -95,6 +95,9 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 
         void UnloadAll();
 
+        // threads updating the cells of continents, shared by all of them, nullptr when disabled
+        MapUpdater* GetCellUpdater() { return m_cellUpdater.activated() ? &m_cellUpdater : nullptr; }
+
         static bool ExistMapAndVMap(uint32 mapid, float x, float y);
         static bool IsValidMAP(uint32 mapid);
 
@@ -144,7 +147,9 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         void InitializeVisibilityDistanceInfo();
         /* statistics */
         uint32 GetNumInstances();
+        // from the map snapshots of the last update, do not wait for nor touch running maps
         uint32 GetNumPlayersInInstances();
+        void GetZonePopulation(std::unordered_map<uint32, uint32>& population);
 
         // get list of all maps
         const MapMapType& Maps() const { return i_maps; }
@@ -178,6 +183,11 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         void InitStateMachine();
         void DeleteStateMachine();
 
+        void UnloadGridsOverBudget();
+
+        void RecordInstanceGrids(Map* map);
+        void UpdateInstancePrewarm();
+
         Map* CreateInstance(uint32 id, Player* player);
         DungeonMap* CreateDungeonMap(uint32 id, uint32 InstanceId, Difficulty difficulty, DungeonPersistentState* save, Team ownerTeam);
         BattleGroundMap* CreateBattleGroundMap(uint32 id, uint32 InstanceId, BattleGround* bg);
@@ -188,6 +198,14 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         IntervalTimer i_timer;
 
         MapUpdater m_updater;
+        MapUpdater m_cellUpdater;
+        std::vector<Map*> m_updateOrder;
+
+        // instance maps kept warm by the grid preloader, picked by recent instance creations
+        ShortIntervalTimer m_prewarmTimer;
+        std::map<uint32 /*mapId*/, uint32> m_instanceCreations;
+        std::map<uint32 /*mapId*/, std::set<uint32>> m_instanceGrids;
+        std::set<uint32> m_warmMaps;
 };
 
 template<typename Do>
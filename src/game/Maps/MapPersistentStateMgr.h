@@ -26,6 +26,7 @@
 #include "Server/DBCStores.h"
 #include "Entities/ObjectGuid.h"
 #include "Pools/PoolManager.h"
+#include "Util/FlatSet.h"
 
 #include <list>
 #include <map>
@@ -43,7 +44,7 @@ class Map;
 
 #define NORMAL_INSTANCE_RESET_TIME 30 * MINUTE
 
-typedef std::set<uint32> CellGuidSet;
+typedef FlatSet<uint32> CellGuidSet;
 
 struct MapCellObjectGuids
 {
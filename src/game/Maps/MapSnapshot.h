@@ -0,0 +1,50 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPSNAPSHOT_H
+#define MANGOS_MAPSNAPSHOT_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+
+#include <unordered_map>
+#include <vector>
+
+// Read-only copy of what other threads ask of a map, published by Map::Update once the
+// update is done. Readers hold the shared pointer as long as they like, a new update
+// publishes a new snapshot instead of touching the old one.
+struct MapSnapshot
+{
+    struct PlayerEntry
+    {
+        ObjectGuid guid;
+        uint32 zoneId;
+        uint32 level;
+        float x, y, z;
+        bool isGameMaster;
+    };
+
+    uint32 mapId;
+    uint32 instanceId;
+    uint32 updateGeneration;                                // Map update the snapshot was taken after
+    uint32 loadedGrids;
+    std::vector<PlayerEntry> players;
+    std::unordered_map<uint32, uint32> zonePopulation;      // zone id -> players, game masters excluded
+};
+
+#endif
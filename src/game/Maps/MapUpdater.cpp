@@ -19,29 +19,51 @@
 #include "MapUpdater.h"
 #include "MapWorkers.h"
 
-MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), pending_requests(0)
+MapUpdater::MapUpdater(size_t num_threads) : _pool(nullptr), _cancelationToken(false), pending_requests(0), queued_requests(0)
 {
-    for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+    StartThreads(num_threads);
 }
 
 void MapUpdater::activate(size_t num_threads)
 {
-    if (activated())
+    if (_pool || activated())
         return;
 
+    StartThreads(num_threads);
+}
+
+void MapUpdater::StartThreads(size_t num_threads)
+{
+    // queues must exist before any thread can look for work
     for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
 }
 
 void MapUpdater::deactivate()
 {
-    _cancelationToken = true;
+    // the threads belong to the pool
+    if (_pool)
+        return;
 
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_queueLock);
+        _cancelationToken = true;
+        _queueCondition.notify_all();
+    }
 
     for (auto& thread : _workerThreads)
         thread.join();
+
+    for (auto& queue : _queues)
+    {
+        for (auto& task : queue->tasks)
+            delete task.first;
+        queue->tasks.clear();
+        queue->queuedCost = 0;
+    }
 }
 
 void MapUpdater::wait()
@@ -60,6 +82,9 @@ void MapUpdater::join()
 
 bool MapUpdater::activated()
 {
+    if (_pool)
+        return _pool->activated();
+
     return _workerThreads.size() > 0;
 }
 
@@ -71,30 +96,118 @@ void MapUpdater::update_finished()
     _condition.notify_all();
 }
 
-void MapUpdater::schedule_update(Worker* worker)
+void MapUpdater::schedule_update(Worker* worker, uint64 costHint /*= 0*/)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        ++pending_requests;
+    }
 
-    ++pending_requests;
-    _queue.Push(std::move(worker));
+    if (_pool)
+        _pool->Enqueue(worker, costHint);
+    else
+        Enqueue(worker, costHint);
 }
 
-void MapUpdater::WorkerThread()
+void MapUpdater::Enqueue(Worker* worker, uint64 costHint)
 {
-    while (true)
+    // place task on least loaded thread, queue length breaks ties when no cost is known
+    WorkerQueue* target = nullptr;
+    uint64 targetCost = 0;
+    size_t targetSize = 0;
+    for (auto& queue : _queues)
     {
-        Worker* request = nullptr;
+        std::lock_guard<std::mutex> lock(queue->lock);
+        if (!target || queue->queuedCost < targetCost || (queue->queuedCost == targetCost && queue->tasks.size() < targetSize))
+        {
+            target = queue.get();
+            targetCost = queue->queuedCost;
+            targetSize = queue->tasks.size();
+        }
+    }
 
-        _queue.WaitAndPop(request);
+    {
+        std::lock_guard<std::mutex> lock(target->lock);
+        target->tasks.emplace_back(worker, costHint);
+        target->queuedCost += costHint;
+    }
+
+    std::lock_guard<std::mutex> lock(_queueLock);
+    ++queued_requests;
+    _queueCondition.notify_one();
+}
 
-        if (_cancelationToken)
+Worker* MapUpdater::PopTask(size_t index)
+{
+    // own tasks first, from the front
+    {
+        WorkerQueue& own = *_queues[index];
+        std::lock_guard<std::mutex> lock(own.lock);
+        if (!own.tasks.empty())
         {
-            delete request;
-            return;
+            auto task = own.tasks.front();
+            own.tasks.pop_front();
+            own.queuedCost -= task.second;
+            return task.first;
         }
+    }
+
+    // steal from the back of the other threads
+    for (size_t i = 1; i < _queues.size(); ++i)
+    {
+        WorkerQueue& victim = *_queues[(index + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(victim.lock);
+        if (!victim.tasks.empty())
+        {
+            auto task = victim.tasks.back();
+            victim.tasks.pop_back();
+            victim.queuedCost -= task.second;
+            return task.first;
+        }
+    }
+
+    return nullptr;
+}
+
+static thread_local MapUpdater const* t_currentUpdater = nullptr;
+static thread_local size_t t_workerIndex = 0;
+
+MapUpdater const* MapUpdater::CurrentUpdater()
+{
+    return t_currentUpdater;
+}
+
+size_t MapUpdater::CurrentWorkerIndex()
+{
+    return t_workerIndex;
+}
+
+void MapUpdater::WorkerThread(size_t index)
+{
+    t_currentUpdater = this;
+    t_workerIndex = index;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_queueLock);
+
+            while (queued_requests == 0 && !_cancelationToken)
+                _queueCondition.wait(lock);
+
+            if (_cancelationToken)
+                return;
+
+            --queued_requests;
+        }
+
+        // a task is reserved for this thread above, it is guaranteed to sit in one of the queues
+        Worker* request = nullptr;
+        while (!request)
+            request = PopTask(index);
 
         request->execute();
 
         delete request;
     }
-}
\ No newline at end of file
+}
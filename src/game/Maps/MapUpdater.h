@@ -20,21 +20,33 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Platform/Define.h"
-#include "Util/ProducerConsumerQueue.h"
 
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <deque>
+#include <memory>
 #include <vector>
 #include <condition_variable>
 
 class Worker;
 
+/*
+ * Each worker thread owns a deque of tasks. New tasks go to the thread with the least
+ * queued cost (cost hint is usually the duration of the previous update of the same map),
+ * threads pop their own tasks from the front and steal from the back of other threads deques
+ * once they run dry.
+ *
+ * An updater created on top of another one owns no threads, it queues its tasks on the threads
+ * of that pool and wait() only waits for the tasks scheduled through it. This lets several maps
+ * share one pool while each of them waits for its own tasks only.
+ */
 class MapUpdater
 {
     public:
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
+        MapUpdater() : _pool(nullptr), _cancelationToken(false), pending_requests(0), queued_requests(0) {}
         MapUpdater(size_t num_threads);
+        explicit MapUpdater(MapUpdater& pool) : _pool(&pool), _cancelationToken(false), pending_requests(0), queued_requests(0) {}
         MapUpdater(const MapUpdater&) = delete;
         
         void activate(size_t num_threads);
@@ -42,11 +54,28 @@ class MapUpdater
         void wait();
         void join();
         bool activated();
+        size_t threads() const { return _pool ? _pool->threads() : _workerThreads.size(); }
+        // updater owning the threads the tasks run on
+        MapUpdater const* pool() const { return _pool ? _pool : this; }
         void update_finished();
-        void schedule_update(Worker* worker);
+        void schedule_update(Worker* worker, uint64 costHint = 0);
+
+        // updater running the calling thread and the thread's index in it, nullptr outside worker threads
+        static MapUpdater const* CurrentUpdater();
+        static size_t CurrentWorkerIndex();
 
     private:
-        ProducerConsumerQueue<Worker *> _queue;
+        struct WorkerQueue
+        {
+            WorkerQueue() : queuedCost(0) {}
+
+            std::mutex lock;
+            std::deque<std::pair<Worker*, uint64>> tasks;
+            uint64 queuedCost;
+        };
+
+        MapUpdater* _pool;
+        std::vector<std::unique_ptr<WorkerQueue>> _queues;
 
         std::vector<std::thread> _workerThreads;
         std::atomic<bool> _cancelationToken;
@@ -55,7 +84,14 @@ class MapUpdater
         std::condition_variable _condition;
         size_t pending_requests;
 
-        void WorkerThread();
+        std::mutex _queueLock;
+        std::condition_variable _queueCondition;
+        size_t queued_requests;                             // guarded by _queueLock
+
+        void StartThreads(size_t num_threads);
+        void Enqueue(Worker* worker, uint64 costHint);
+        Worker* PopTask(size_t index);
+        void WorkerThread(size_t index);
 };
 
-#endif //_MAP_UPDATER_H_INCLUDED
\ No newline at end of file
+#endif //_MAP_UPDATER_H_INCLUDED
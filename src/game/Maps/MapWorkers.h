@@ -23,9 +23,13 @@
 #include "Grids/GridNotifiersImpl.h"
 #include "MapUpdater.h"
 #include "MotionGenerators/MovementGenerator.h"
+#include "Movement/MoveSplineBatch.h"
+#include "Maps/MapCostSampler.h"
 #include "Entities/Object.h"
 #include "Platform/Define.h"
 
+#include <chrono>
+
 class Worker
 {
     public:
@@ -49,7 +53,9 @@ class MapUpdateWorker : public Worker
 
         void execute() override
         {
+            auto start = std::chrono::steady_clock::now();
             m_map.Update(m_diff);
+            m_map.SetLastUpdateCost(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
             GetWorker().update_finished();
         }
 
@@ -58,17 +64,34 @@ class MapUpdateWorker : public Worker
         uint32 m_diff;
 };
 
+class MapInitializeWorker : public Worker
+{
+    public:
+        MapInitializeWorker(Map& map, MapUpdater& updater) :
+            Worker(updater), m_map(map)
+        {}
+
+        void execute() override
+        {
+            m_map.Initialize(true);
+            GetWorker().update_finished();
+        }
+
+    private:
+        Map& m_map;
+};
+
 class GridCrawler : public Worker
 {
     public:
-        GridCrawler(Map& map, std::vector<Cell> &cells, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_map(map), m_cells(cells), m_diff(diff)
+        GridCrawler(Map& map, std::vector<Cell> &cells, WorldObjectVector& objects, uint32 generation, uint32 diff, MapUpdater& updater) :
+            Worker(updater), m_map(map), m_cells(cells), m_objects(objects), m_generation(generation), m_diff(diff)
         {}
 
+        // only collects the objects of the given cells, updating them is done by ObjectUpdateWorker
         void execute() override
         {
-            WorldObjectUnSet objToUpdate;
-            MaNGOS::ObjectUpdater obj_updater(objToUpdate, m_diff);
+            MaNGOS::ObjectUpdater obj_updater(m_objects, m_generation, m_diff);
             TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
             TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
 
@@ -84,6 +107,8 @@ class GridCrawler : public Worker
     private:
         Map& m_map;
         std::vector<Cell> &m_cells;
+        WorldObjectVector& m_objects;
+        uint32 m_generation;
         uint32 m_diff;
 };
 
@@ -91,21 +116,35 @@ class GridCrawler : public Worker
 class ObjectUpdateWorker : public Worker
 {
     public:
-        ObjectUpdateWorker(std::unordered_set<WorldObject*>& objects, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_objects(objects), m_diff(diff)
+        ObjectUpdateWorker(WorldObjectVector& objects, uint32 generation, uint32 diff, MapCostSampler* sampler, MapUpdater& updater) :
+            Worker(updater), m_objects(objects), m_generation(generation), m_diff(diff), m_sampler(sampler)
         {}
 
         void execute() override
         {
-            for (WorldObject* const &object : m_objects)
-                object->Update(m_diff);
+            TickArena::Scope arenaScope;
+
+            // one batch per updater thread, keeps its arrays allocated between ticks
+            static thread_local Movement::MoveSplineBatch splineBatch;
+            splineBatch.Process(m_objects, m_diff, m_generation);
+
+            // the sampler is only given in sampled ticks
+            if (m_sampler)
+                m_sampler->UpdateObjects(m_objects, m_diff);
+            else
+            {
+                for (WorldObject* const &object : m_objects)
+                    object->Update(m_diff);
+            }
 
             GetWorker().update_finished();
         }
 
     private:
-        std::unordered_set<WorldObject*>& m_objects;
+        WorldObjectVector& m_objects;
+        uint32 m_generation;
         uint32 m_diff;
+        MapCostSampler* m_sampler;
 };
 
 #endif //_MAP_WORKERS_H_INCLUDED
@@ -0,0 +1,138 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/ScriptSchedule.h"
+
+#include <algorithm>
+
+#define SCRIPT_SCHEDULE_SLOT_MS 50
+#define SCRIPT_SCHEDULE_SLOTS   512                         // one turn is 25.6 seconds
+
+ScriptSchedule::ScriptSchedule() : m_slots(SCRIPT_SCHEDULE_SLOTS, NONE), m_free(NONE), m_cursor(0), m_order(0), m_size(0)
+{
+}
+
+uint64 ScriptSchedule::GetSlot(TimePoint time)
+{
+    return uint64(time.time_since_epoch().count()) / SCRIPT_SCHEDULE_SLOT_MS;
+}
+
+void ScriptSchedule::Schedule(TimePoint when, ScriptAction const& action)
+{
+    uint32 index;
+    if (m_free != NONE)
+    {
+        index = m_free;
+        m_free = m_nodes[index].next;
+        m_nodes[index] = Node(when, m_order++, action);
+    }
+    else
+    {
+        index = m_nodes.size();
+        m_nodes.emplace_back(when, m_order++, action);
+    }
+
+    // a step in an already visited slot is found at the next visit of the current one
+    uint32& head = m_slots[std::max(GetSlot(when), m_cursor) % SCRIPT_SCHEDULE_SLOTS];
+    m_nodes[index].next = head;
+    head = index;
+    ++m_size;
+}
+
+void ScriptSchedule::TakeDue(TimePoint now, std::vector<ScriptAction>& due)
+{
+    uint64 const nowSlot = GetSlot(now);
+    if (m_size == 0)
+    {
+        m_cursor = nowSlot;
+        return;
+    }
+
+    // each slot is visited at most once, also after a long pause of the map
+    uint64 slot = nowSlot - m_cursor >= SCRIPT_SCHEDULE_SLOTS ? nowSlot - SCRIPT_SCHEDULE_SLOTS + 1 : m_cursor;
+
+    std::vector<uint32> taken;
+    for (; slot <= nowSlot; ++slot)
+    {
+        uint32* link = &m_slots[slot % SCRIPT_SCHEDULE_SLOTS];
+        while (*link != NONE)
+        {
+            Node& node = m_nodes[*link];
+            if (node.when <= now)
+            {
+                taken.push_back(*link);
+                *link = node.next;
+            }
+            else
+                link = &node.next;
+        }
+    }
+    m_cursor = nowSlot;
+
+    std::sort(taken.begin(), taken.end(), [this](uint32 left, uint32 right)
+    {
+        Node const& leftNode = m_nodes[left];
+        Node const& rightNode = m_nodes[right];
+        return leftNode.when != rightNode.when ? leftNode.when < rightNode.when : leftNode.order < rightNode.order;
+    });
+
+    due.reserve(due.size() + taken.size());
+    for (uint32 index : taken)
+    {
+        due.push_back(m_nodes[index].action);
+        m_nodes[index].next = m_free;
+        m_free = index;
+    }
+    m_size -= taken.size();
+}
+
+bool ScriptSchedule::HasSameScript(char const* table, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid) const
+{
+    for (uint32 head : m_slots)
+        for (uint32 index = head; index != NONE; index = m_nodes[index].next)
+            if (m_nodes[index].action.IsSameScript(table, id, sourceGuid, targetGuid, ownerGuid))
+                return true;
+
+    return false;
+}
+
+uint32 ScriptSchedule::RemoveSameScript(char const* table, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid)
+{
+    uint32 removed = 0;
+    for (uint32& head : m_slots)
+    {
+        uint32* link = &head;
+        while (*link != NONE)
+        {
+            uint32 const index = *link;
+            Node& node = m_nodes[index];
+            if (node.action.IsSameScript(table, id, sourceGuid, targetGuid, ownerGuid))
+            {
+                *link = node.next;
+                node.next = m_free;
+                m_free = index;
+                ++removed;
+            }
+            else
+                link = &node.next;
+        }
+    }
+
+    m_size -= removed;
+    return removed;
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SCRIPTSCHEDULE_H
+#define MANGOS_SCRIPTSCHEDULE_H
+
+#include "Common.h"
+#include "DBScripts/ScriptMgr.h"
+
+#include <vector>
+
+// Delayed DB script steps of one map, in a hashed timing wheel of SCRIPT_SCHEDULE_SLOT_MS wide slots.
+// Nodes are kept in one vector and reused through a free list, so scheduling a step costs no allocation
+// once the map ran its scripts for a while. Steps due later than one wheel turn wait in their slot.
+class ScriptSchedule
+{
+    public:
+        ScriptSchedule();
+
+        void Schedule(TimePoint when, ScriptAction const& action);
+
+        // moves the steps due at now into due, in time order and steps due at the same time in scheduling order
+        void TakeDue(TimePoint now, std::vector<ScriptAction>& due);
+
+        bool HasSameScript(char const* table, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid) const;
+        // returns the number of removed steps
+        uint32 RemoveSameScript(char const* table, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid);
+
+        bool empty() const { return m_size == 0; }
+        size_t size() const { return m_size; }
+
+    private:
+        static constexpr uint32 NONE = uint32(-1);
+
+        struct Node
+        {
+            Node(TimePoint _when, uint64 _order, ScriptAction const& _action) : when(_when), order(_order), action(_action), next(NONE) {}
+
+            TimePoint when;
+            uint64 order;
+            ScriptAction action;
+            uint32 next;
+        };
+
+        static uint64 GetSlot(TimePoint time);
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32> m_slots;                        // first node of each slot
+        uint32 m_free;                                      // first reusable node
+        uint64 m_cursor;                                    // last visited absolute slot
+        uint64 m_order;
+        size_t m_size;
+};
+
+#endif
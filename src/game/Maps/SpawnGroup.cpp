@@ -29,6 +29,9 @@
 #include "World/World.h"
 #include "Maps/InstanceData.h"
 
+// a group short of members waits this long for their respawn times before it looks again
+static std::chrono::seconds const SPAWN_GROUP_RECHECK_DELAY(1);
+
 SpawnGroup::SpawnGroup(SpawnGroupEntry const& entry, Map& map, uint32 typeId) : m_entry(entry), m_map(map), m_objectTypeId(typeId), m_enabled(m_entry.EnabledByDefault)
 {
 }
@@ -36,11 +39,13 @@ SpawnGroup::SpawnGroup(SpawnGroupEntry const& entry, Map& map, uint32 typeId) :
 void SpawnGroup::AddObject(uint32 dbGuid, uint32 entry)
 {
     m_objects[dbGuid] = entry;
+    m_nextSpawnCheck = TimePoint();
 }
 
 void SpawnGroup::RemoveObject(WorldObject* wo)
 {
     m_objects.erase(wo->GetDbGuid());
+    m_nextSpawnCheck = TimePoint();
 
     if (!m_map.IsDungeon() && m_objects.empty() && m_entry.HasChancedSpawns)
     {
@@ -67,6 +72,11 @@ uint32 SpawnGroup::GetGuidEntry(uint32 dbGuid) const
 
 void SpawnGroup::Update()
 {
+    // without members added or removed only passing respawn times can change the outcome,
+    // worldstate conditions can change any time and are evaluated every update
+    if (!m_entry.WorldStateCondition && m_map.GetCurrentClockTime() < m_nextSpawnCheck)
+        return;
+
     Spawn(false);
 }
 
@@ -117,7 +127,13 @@ uint32 SpawnGroup::GetEligibleEntry(std::map<uint32, uint32>& existingEntries, s
 void SpawnGroup::Spawn(bool force)
 {
     if (!m_enabled && !force)
+    {
+        m_nextSpawnCheck = TimePoint::max();                // until enabled
         return;
+    }
+
+    // full group only changes when a member is removed, else look again after a while
+    m_nextSpawnCheck = m_objects.size() >= m_entry.MaxCount ? TimePoint::max() : m_map.GetCurrentClockTime() + SPAWN_GROUP_RECHECK_DELAY;
 
     // duplicated code for optimization - way fewer cond fails
     if ((m_entry.Flags & SPAWN_GROUP_DESPAWN_ON_COND_FAIL) != 0) // must be before count check
@@ -329,6 +345,7 @@ void SpawnGroup::RespawnIfInVicinity(Position pos, float range)
 
     for (auto& dbGuid : m_entry.DbGuids)
         m_map.GetPersistentState()->SaveObjectRespawnTime(GetObjectTypeId(), dbGuid.DbGuid, now);
+    m_nextSpawnCheck = TimePoint();
 }
 
 std::string SpawnGroup::to_string() const
@@ -557,7 +574,7 @@ FormationData::FormationData(CreatureGroup* gData, FormationEntrySPtr fEntry) :
 
 FormationData::~FormationData()
 {
-    sLog.outDebug("Deleting formation (%u)!!!!!", m_groupData->GetGroupEntry().Id);
+    DEBUG_LOG("Deleting formation (%u)!!!!!", m_groupData->GetGroupEntry().Id);
 }
 
 bool FormationData::SetFollowersMaster()
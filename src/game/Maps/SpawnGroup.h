@@ -50,7 +50,7 @@ class SpawnGroup
         virtual void Despawn(uint32 timeMSToDespawn = 0) = 0;
         std::string to_string() const;
         uint32 GetObjectTypeId() const { return m_objectTypeId; }
-        void SetEnabled(bool enabled) { m_enabled = enabled; }
+        void SetEnabled(bool enabled) { m_enabled = enabled; m_nextSpawnCheck = TimePoint(); }
         SpawnGroupEntry const& GetGroupEntry() const { return m_entry; }
         uint32 GetGroupId() const { return m_entry.Id; }
 
@@ -68,6 +68,7 @@ class SpawnGroup
         std::map<uint32, bool> m_chosenSpawns;
         uint32 m_objectTypeId;
         bool m_enabled;
+        TimePoint m_nextSpawnCheck;                         // reset when members change, see Update
 };
 
 class CreatureGroup : public SpawnGroup
@@ -27,18 +27,19 @@ bool operator<(SpawnInfo const& lhs, SpawnInfo const& rhs)
     return lhs.GetRespawnTime() < rhs.GetRespawnTime();
 }
 
-bool SpawnInfo::ConstructForMap(Map& map)
+bool SpawnInfo::ConstructForMap(Map& map) const
 {
-    m_inUse = true;
-    bool result = false;
     if (GetHighGuid() == HIGHGUID_UNIT)
-        result = WorldObject::SpawnCreature(GetDbGuid(), &map);
-    else if (GetHighGuid() == HIGHGUID_GAMEOBJECT)
-        result = WorldObject::SpawnGameObject(GetDbGuid(), &map);
-    if (result)
-        SetUsed();
-    m_inUse = false;
-    return result;
+        return WorldObject::SpawnCreature(GetDbGuid(), &map);
+    if (GetHighGuid() == HIGHGUID_GAMEOBJECT)
+        return WorldObject::SpawnGameObject(GetDbGuid(), &map);
+    return false;
+}
+
+// std heap functions build a max-heap, reverse the order to get the earliest respawn on top
+static bool LaterRespawn(SpawnInfo const& lhs, SpawnInfo const& rhs)
+{
+    return rhs < lhs;
 }
 
 SpawnManager::~SpawnManager()
@@ -75,92 +76,125 @@ void SpawnManager::Initialize()
     }
 }
 
+void SpawnManager::Schedule(uint32 respawnDelay, uint32 dbguid, HighGuid high)
+{
+    std::lock_guard<std::recursive_mutex> guard(m_lock);
+
+    // a new schedule supersedes a pending one of the same spawn
+    uint32 generation = ++m_lastGeneration;
+    m_pendingSpawns[SpawnInfo::MakeKey(dbguid, high)] = generation;
+    m_spawns.emplace_back(m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay), dbguid, high, generation);
+    std::push_heap(m_spawns.begin(), m_spawns.end(), LaterRespawn);
+}
+
 void SpawnManager::AddCreature(uint32 respawnDelay, uint32 dbguid)
 {
-    m_spawns.emplace_back(m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay), dbguid, HIGHGUID_UNIT);
-    std::sort(m_spawns.begin(), m_spawns.end());
+    Schedule(respawnDelay, dbguid, HIGHGUID_UNIT);
 }
 
 void SpawnManager::AddGameObject(uint32 respawnDelay, uint32 dbguid)
 {
-    m_spawns.emplace_back(m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay), dbguid, HIGHGUID_GAMEOBJECT);
-    std::sort(m_spawns.begin(), m_spawns.end());
+    Schedule(respawnDelay, dbguid, HIGHGUID_GAMEOBJECT);
 }
 
-void SpawnManager::RespawnCreature(uint32 dbguid, uint32 respawnDelay)
+void SpawnManager::Respawn(uint32 dbguid, HighGuid high, uint32 respawnDelay)
 {
-    bool found = false;
-    auto itr = m_spawns.begin();
-    for (; itr != m_spawns.end(); )
+    std::lock_guard<std::recursive_mutex> guard(m_lock);
+
+    auto itr = m_pendingSpawns.find(SpawnInfo::MakeKey(dbguid, high));
+    if (itr == m_pendingSpawns.end())
     {
-        auto& spawnInfo = *itr;
-        if (!spawnInfo.IsUsed() && spawnInfo.GetDbGuid() == dbguid && spawnInfo.GetHighGuid() == HIGHGUID_UNIT)
-        {
-            found = true;
-            m_map.GetPersistentState()->SaveCreatureRespawnTime(dbguid, time(nullptr) + respawnDelay);
-            if (respawnDelay > 0)
-                spawnInfo.SetRespawnTime(m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay));
-            break;
-        }
-        ++itr;
+        Schedule(respawnDelay, dbguid, high);
+        return;
     }
-    if (!found)
-        AddCreature(respawnDelay, dbguid);
-    else if (respawnDelay == 0)
-        (*itr).ConstructForMap(m_map);
+
+    if (high == HIGHGUID_UNIT)
+        m_map.GetPersistentState()->SaveCreatureRespawnTime(dbguid, time(nullptr) + respawnDelay);
+    else
+        m_map.GetPersistentState()->SaveGORespawnTime(dbguid, time(nullptr) + respawnDelay);
+
     if (respawnDelay > 0)
-        std::sort(m_spawns.begin(), m_spawns.end());
+    {
+        Schedule(respawnDelay, dbguid, high);
+        return;
+    }
+
+    // not pending while constructed, a linked respawn of the same spawn during it schedules anew
+    uint32 generation = itr->second;
+    m_pendingSpawns.erase(itr);
+    if (!SpawnInfo(m_map.GetCurrentClockTime(), dbguid, high, generation).ConstructForMap(m_map))
+        m_pendingSpawns.emplace(SpawnInfo::MakeKey(dbguid, high), generation);
+}
+
+void SpawnManager::RespawnCreature(uint32 dbguid, uint32 respawnDelay)
+{
+    Respawn(dbguid, HIGHGUID_UNIT, respawnDelay);
 }
 
 void SpawnManager::RespawnGameObject(uint32 dbguid, uint32 respawnDelay)
 {
-    bool found = false;
-    auto itr = m_spawns.begin();
-    for (; itr != m_spawns.end(); )
-    {
-        auto& spawnInfo = *itr;
-        if (!spawnInfo.IsUsed() && spawnInfo.GetDbGuid() == dbguid && spawnInfo.GetHighGuid() == HIGHGUID_GAMEOBJECT)
-        {
-            found = true;
-            m_map.GetPersistentState()->SaveGORespawnTime(dbguid, time(nullptr) + respawnDelay);
-            if (respawnDelay > 0)
-                spawnInfo.SetRespawnTime(m_map.GetCurrentClockTime() + std::chrono::seconds(respawnDelay));
-            break;
-        }
-        ++itr;
-    }
-    if (!found)
-        AddGameObject(respawnDelay, dbguid);
-    else if (respawnDelay == 0)
-        (*itr).ConstructForMap(m_map);
-    if (respawnDelay > 0)
-        std::sort(m_spawns.begin(), m_spawns.end());
+    Respawn(dbguid, HIGHGUID_GAMEOBJECT, respawnDelay);
 }
 
 void SpawnManager::RespawnAll()
 {
-    for (auto itr = m_spawns.begin(); itr != m_spawns.end();)
+    std::lock_guard<std::recursive_mutex> guard(m_lock);
+
+    std::vector<SpawnInfo> pending;
+    for (auto& spawnInfo : m_spawns)
+    {
+        auto itr = m_pendingSpawns.find(spawnInfo.GetKey());
+        if (itr != m_pendingSpawns.end() && itr->second == spawnInfo.GetGeneration())
+            pending.push_back(spawnInfo);
+    }
+
+    for (auto& spawnInfo : pending)
     {
-        auto& spawnInfo = *itr;
         if (spawnInfo.GetHighGuid() == HIGHGUID_GAMEOBJECT)
             m_map.GetPersistentState()->SaveGORespawnTime(spawnInfo.GetDbGuid(), 0);
         if (spawnInfo.GetHighGuid() == HIGHGUID_UNIT)
             m_map.GetPersistentState()->SaveCreatureRespawnTime(spawnInfo.GetDbGuid(), 0);
-        spawnInfo.ConstructForMap(m_map);
+
+        auto itr = m_pendingSpawns.find(spawnInfo.GetKey());
+        if (itr == m_pendingSpawns.end() || itr->second != spawnInfo.GetGeneration())
+            continue;
+
+        m_pendingSpawns.erase(itr);
+        if (!spawnInfo.ConstructForMap(m_map))
+            m_pendingSpawns.emplace(spawnInfo.GetKey(), spawnInfo.GetGeneration());
     }
 }
 
 void SpawnManager::Update()
 {
+    std::lock_guard<std::recursive_mutex> guard(m_lock);
+
     auto now = m_map.GetCurrentClockTime();
-    for (auto itr = m_spawns.begin(); itr != m_spawns.end();)
+    std::vector<SpawnInfo> failed;
+    while (!m_spawns.empty() && m_spawns.front().GetRespawnTime() <= now)
     {
-        auto& spawnInfo = *itr;
-        if (spawnInfo.IsUsed() ||
-            (spawnInfo.GetRespawnTime() <= now && spawnInfo.ConstructForMap(m_map)))
-            itr = m_spawns.erase(itr);
-        else
-            ++itr;
+        std::pop_heap(m_spawns.begin(), m_spawns.end(), LaterRespawn);
+        SpawnInfo spawnInfo = m_spawns.back();
+        m_spawns.pop_back();
+
+        auto itr = m_pendingSpawns.find(spawnInfo.GetKey());
+        if (itr == m_pendingSpawns.end() || itr->second != spawnInfo.GetGeneration())
+            continue;                                       // superseded or already spawned
+
+        // not pending while constructed, a linked respawn of the same spawn during it schedules anew
+        m_pendingSpawns.erase(itr);
+        if (!spawnInfo.ConstructForMap(m_map))
+            failed.push_back(spawnInfo);
+    }
+
+    // retried next update, unless scheduled anew meanwhile
+    for (auto& spawnInfo : failed)
+    {
+        if (m_pendingSpawns.emplace(spawnInfo.GetKey(), spawnInfo.GetGeneration()).second)
+        {
+            m_spawns.push_back(spawnInfo);
+            std::push_heap(m_spawns.begin(), m_spawns.end(), LaterRespawn);
+        }
     }
 
     for (auto& group : m_spawnGroups)
@@ -169,8 +203,19 @@ void SpawnManager::Update()
 
 std::string SpawnManager::GetRespawnList()
 {
+    std::lock_guard<std::recursive_mutex> guard(m_lock);
+
+    std::vector<SpawnInfo> pending;
+    for (auto& spawnInfo : m_spawns)
+    {
+        auto itr = m_pendingSpawns.find(spawnInfo.GetKey());
+        if (itr != m_pendingSpawns.end() && itr->second == spawnInfo.GetGeneration())
+            pending.push_back(spawnInfo);
+    }
+    std::sort(pending.begin(), pending.end());
+
     std::string output = "";
-    for (auto& data : m_spawns)
+    for (auto& data : pending)
     {
         output += "DBGuid: " + std::to_string(data.GetDbGuid()) + "HighGuid: " + (data.GetHighGuid() == HIGHGUID_UNIT ? "Creature" : "GameObject") + "Respawn Time ";
         auto diff = (data.GetRespawnTime() - m_map.GetCurrentClockTime()).count();
@@ -23,6 +23,7 @@
 #include "Entities/ObjectGuid.h"
 #include "Maps/SpawnGroup.h"
 
+#include <mutex>
 #include <string>
 
 class Map;
@@ -30,20 +31,20 @@ class Map;
 class SpawnInfo
 {
     public:
-        SpawnInfo(TimePoint when, uint32 dbguid, HighGuid high) : m_respawnTime(when), m_dbguid(dbguid), m_high(high), m_used(false), m_inUse(false){}
+        SpawnInfo(TimePoint when, uint32 dbguid, HighGuid high, uint32 generation) : m_respawnTime(when), m_dbguid(dbguid), m_high(high), m_generation(generation) {}
         TimePoint const& GetRespawnTime() const { return m_respawnTime; }
-        void SetRespawnTime(TimePoint const& time) { m_respawnTime = time; }
-        bool ConstructForMap(Map& map); // can fail due to linking, pooling not supported
+        bool ConstructForMap(Map& map) const; // can fail due to linking, pooling not supported
         uint32 GetDbGuid() const { return m_dbguid; }
         HighGuid GetHighGuid() const { return m_high; }
-        void SetUsed() { m_used = true; }
-        bool IsUsed() const { return m_inUse || m_used; }
+        uint64 GetKey() const { return MakeKey(m_dbguid, m_high); }
+        uint32 GetGeneration() const { return m_generation; }
+
+        static uint64 MakeKey(uint32 dbguid, HighGuid high) { return (uint64(high) << 32) | dbguid; }
     private:
         TimePoint m_respawnTime;
         uint32 m_dbguid;
         HighGuid m_high;
-        bool m_used;
-        bool m_inUse;
+        uint32 m_generation;
 };
 
 bool operator<(SpawnInfo const& lhs, SpawnInfo const& rhs);
@@ -51,7 +52,7 @@ bool operator<(SpawnInfo const& lhs, SpawnInfo const& rhs);
 class SpawnManager
 {
     public:
-        SpawnManager(Map& map) : m_map(map) {}
+        SpawnManager(Map& map) : m_map(map), m_lastGeneration(0) {}
         ~SpawnManager();
         void Initialize();
 
@@ -71,10 +72,20 @@ class SpawnManager
 
         void RespawnSpawnGroupsInVicinity(Position pos, float range);
     private:
+        void Schedule(uint32 respawnDelay, uint32 dbguid, HighGuid high);
+        void Respawn(uint32 dbguid, HighGuid high, uint32 respawnDelay);
+
         Map& m_map;
 
-        std::vector<SpawnInfo> m_spawns; // must only be erased from in Update
+        // min-heap on respawn time, rescheduled or already spawned entries stay in it until popped
+        // and are recognized by a generation not matching m_pendingSpawns
+        std::vector<SpawnInfo> m_spawns;
+        std::unordered_map<uint64, uint32> m_pendingSpawns; // SpawnInfo::GetKey -> generation of the scheduled entry
+        uint32 m_lastGeneration;
         std::map<uint32, SpawnGroup*> m_spawnGroups;
+
+        // creatures and gameobjects schedule their respawn from the cell threads, constructing a spawn reenters
+        std::recursive_mutex m_lock;
 };
 
 #endif
\ No newline at end of file
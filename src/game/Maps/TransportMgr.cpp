@@ -57,6 +57,8 @@ void TransportMgr::LoadTransportTemplates()
             transportTemplate.entry = entry;
             if (!GenerateWaypoints(data, transportTemplate))
                 m_transportTemplates.erase(entry);
+            else
+                GeneratePathSamples(data, transportTemplate);
         }
     }
 }
@@ -307,6 +309,97 @@ bool TransportMgr::GenerateWaypoints(GameObjectInfo const* goinfo, TransportTemp
     return true;
 }
 
+// position within the frame's spline segment at the given path time in seconds
+static float CalculateSegmentPos(KeyFrame const& frame, TransportTemplate const& transportTemplate, float speed, float accel, float now)
+{
+    float timeSinceStop = frame.TimeFrom + (now - (1.0f / IN_MILLISECONDS) * frame.DepartureTime);
+    float timeUntilStop = frame.TimeTo - (now - (1.0f / IN_MILLISECONDS) * frame.DepartureTime);
+    float segmentPos, dist;
+    float accelTime = transportTemplate.accelTime;
+    float accelDist = transportTemplate.accelDist;
+    // calculate from nearest stop, less confusing calculation...
+    if (timeSinceStop < timeUntilStop)
+    {
+        if (timeSinceStop < accelTime)
+            dist = 0.5f * accel * timeSinceStop * timeSinceStop;
+        else
+            dist = accelDist + (timeSinceStop - accelTime) * speed;
+        segmentPos = dist - frame.DistSinceStop;
+    }
+    else
+    {
+        if (timeUntilStop < accelTime)
+            dist = 0.5f * accel * timeUntilStop * timeUntilStop;
+        else
+            dist = accelDist + (timeUntilStop - accelTime) * speed;
+        segmentPos = frame.DistUntilStop - dist;
+    }
+
+    return segmentPos / frame.NextDistFromPrev;
+}
+
+void TransportMgr::GeneratePathSamples(GameObjectInfo const* goinfo, TransportTemplate& transportTemplate)
+{
+    float const speed = float(goinfo->moTransport.moveSpeed);
+    float const accel = float(goinfo->moTransport.accelRate);
+
+    for (KeyFrame& frame : transportTemplate.keyFrames)
+    {
+        if (!frame.Spline || frame.NextArriveTime <= frame.DepartureTime)
+            continue;
+
+        frame.Samples.reserve((frame.NextArriveTime - frame.DepartureTime) / TRANSPORT_PATH_SAMPLE_INTERVAL + 2);
+        for (uint32 time = frame.DepartureTime;; time = std::min(time + TRANSPORT_PATH_SAMPLE_INTERVAL, frame.NextArriveTime))
+        {
+            float t = CalculateSegmentPos(frame, transportTemplate, speed, accel, float(time) * 0.001f);
+            G3D::Vector3 pos, dir;
+            frame.Spline->evaluate_percent(frame.Index, t, pos);
+            frame.Spline->evaluate_derivative(frame.Index, t, dir);
+            frame.Samples.push_back({ pos.x, pos.y, pos.z, float(atan2(dir.y, dir.x) + M_PI) });
+
+            if (time == frame.NextArriveTime)
+                break;
+        }
+    }
+}
+
+bool KeyFrame::GetPathPosition(uint32 pathProgress, float& x, float& y, float& z, float& o) const
+{
+    if (Samples.empty())
+        return false;
+
+    uint32 elapsed = pathProgress > DepartureTime ? pathProgress - DepartureTime : 0;
+    size_t index = elapsed / TRANSPORT_PATH_SAMPLE_INTERVAL;
+    if (index + 1 >= Samples.size())
+    {
+        TransportPathSample const& last = Samples.back();
+        x = last.x;
+        y = last.y;
+        z = last.z;
+        o = last.o;
+        return true;
+    }
+
+    // the last interval ends at the next arrival and can be shorter
+    uint32 const from = index * TRANSPORT_PATH_SAMPLE_INTERVAL;
+    uint32 const to = std::min(from + TRANSPORT_PATH_SAMPLE_INTERVAL, NextArriveTime - DepartureTime);
+    float const frac = to > from ? float(elapsed - from) / float(to - from) : 0.0f;
+
+    TransportPathSample const& prev = Samples[index];
+    TransportPathSample const& next = Samples[index + 1];
+    x = prev.x + (next.x - prev.x) * frac;
+    y = prev.y + (next.y - prev.y) * frac;
+    z = prev.z + (next.z - prev.z) * frac;
+
+    float turn = next.o - prev.o;
+    if (turn > M_PI_F)
+        turn -= 2 * M_PI_F;
+    else if (turn < -M_PI_F)
+        turn += 2 * M_PI_F;
+    o = prev.o + turn * frac;
+    return true;
+}
+
 void TransportMgr::AddPathNodeToTransport(uint32 transportEntry, uint32 timeSeg, TransportAnimationEntry const* node)
 {
     TransportAnimation& animNode = m_transportAnimations[transportEntry];
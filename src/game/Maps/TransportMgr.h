@@ -48,6 +48,13 @@ typedef std::map<uint32, TransportAnimation> TransportAnimationContainer;
 
 typedef Movement::Spline<double>                 TransportSpline;
 
+#define TRANSPORT_PATH_SAMPLE_INTERVAL 50                   // ms between precomputed path positions, the position update rate of Transport::Update
+
+struct TransportPathSample
+{
+    float x, y, z, o;
+};
+
 struct KeyFrame
 {
     explicit KeyFrame(TaxiPathNodeEntry const& _node) : Index(0), Node(&_node), InitialOrientation(0.0f),
@@ -74,6 +81,11 @@ struct KeyFrame
     float NextDistFromPrev;
     uint32 NextArriveTime;
 
+    // positions from departure until the next arrival, shared by all transports of the template
+    std::vector<TransportPathSample> Samples;
+
+    bool GetPathPosition(uint32 pathProgress, float& x, float& y, float& z, float& o) const;
+
     bool IsTeleportFrame() const { return Teleport; }
     bool IsUpdateFrame() const { return Update; }
     bool IsStopFrame() const { return Node->actionFlag == 2; }
@@ -118,6 +130,7 @@ class TransportMgr
         void AddPathNodeToTransport(uint32 transportEntry, uint32 timeSeg, TransportAnimationEntry const* node);
         void AddPathRotationToTransport(uint32 transportEntry, uint32 timeSeg, TransportRotationEntry const* node);
         bool GenerateWaypoints(GameObjectInfo const* goinfo, TransportTemplate& transportTemplate);
+        void GeneratePathSamples(GameObjectInfo const* goinfo, TransportTemplate& transportTemplate);
 
         TransportAnimationContainer m_transportAnimations;
         std::unordered_map<uint32, TransportTemplate> m_transportTemplates;
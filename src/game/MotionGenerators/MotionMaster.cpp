@@ -53,13 +53,11 @@ inline bool isStatic(MovementGenerator* mv)
 void MotionMaster::Initialize()
 {
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("motionmaster.initialize", {
-        { "entry", std::to_string(m_owner->GetEntry()) },
-        { "guid", std::to_string(m_owner->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_owner->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_owner->GetMapId()) },
-        { "instance_id", std::to_string(m_owner->GetInstanceId()) }
-    }, 1000);
+    static metric::histogram& initializeHistogram = metric::aggregates::instance().register_histogram("motionmaster.initialize.aggregate");
+    metric::timer meas(initializeHistogram, 1000, [this](int64 elapsed)
+    {
+        metric::metric::instance().report("motionmaster.initialize", "duration", elapsed, m_owner->GetMetricTags());
+    });
 #endif
     // stop current move
     m_owner->StopMoving();
@@ -111,13 +109,11 @@ void MotionMaster::UpdateMotion(uint32 diff)
     if (m_owner->hasUnitState(UNIT_STAT_CAN_NOT_MOVE))
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("motionmaster.updatemotion", {
-        { "entry", std::to_string(m_owner->GetEntry()) },
-        { "guid", std::to_string(m_owner->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_owner->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_owner->GetMapId()) },
-        { "instance_id", std::to_string(m_owner->GetInstanceId()) }
-    }, 1000);
+    static metric::histogram& updateHistogram = metric::aggregates::instance().register_histogram("motionmaster.updatemotion.aggregate");
+    metric::timer meas(updateHistogram, 1000, [this](int64 elapsed)
+    {
+        metric::metric::instance().report("motionmaster.updatemotion", "duration", elapsed, m_owner->GetMetricTags());
+    });
 #endif
 
     MANGOS_ASSERT(!empty());
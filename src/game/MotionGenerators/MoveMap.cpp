@@ -20,7 +20,12 @@
 #include "World/World.h"
 #include "Entities/Creature.h"
 #include "MotionGenerators/MoveMap.h"
+#include "MotionGenerators/TileGraph.h"
 #include "MoveMapSharedDefines.h"
+#include "Maps/GridPreloader.h"
+#include "Util/Timer.h"
+
+#include <algorithm>
 
 namespace MMAP
 {
@@ -116,6 +121,9 @@ namespace MMAP
     }
 
     // ######################## MMapManager ########################
+    // out of line, the tile graphs are only complete here
+    MMapManager::MMapManager() : m_loadedTiles(0), m_residentBytes(0) {}
+
     MMapManager::~MMapManager()
     {
         for (auto& loadedMMap : m_loadedMMaps)
@@ -175,9 +183,34 @@ namespace MMAP
         mmap_data->mmapLoadedTiles.clear();
 
         m_loadedMMaps.emplace(packInstanceId(mapId, instanceId), mmap_data);
+
+        loadTileGraph(mapId);
         return true;
     }
 
+    void MMapManager::loadTileGraph(uint32 mapId)
+    {
+        std::lock_guard<std::mutex> guard(m_tileGraphsMutex);
+        if (m_tileGraphs.find(mapId) != m_tileGraphs.end())
+            return;
+
+        // optional, without it long paths are searched on the navmesh alone
+        char fileName[1024];
+        snprintf(fileName, sizeof(fileName), (sWorld.GetDataPath() + "mmaps/%03i.mmgraph").c_str(), mapId);
+        TileGraph* graph = TileGraph::Load(fileName);
+        if (graph)
+            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadTileGraph: Loaded %03i.mmgraph with %u nodes", mapId, graph->GetNodeCount());
+
+        m_tileGraphs[mapId].reset(graph);
+    }
+
+    TileGraph const* MMapManager::GetTileGraph(uint32 mapId)
+    {
+        std::lock_guard<std::mutex> guard(m_tileGraphsMutex);
+        auto itr = m_tileGraphs.find(mapId);
+        return itr != m_tileGraphs.end() ? itr->second.get() : nullptr;
+    }
+
     uint32 MMapManager::packTileID(int32 x, int32 y) const
     {
         return uint32(x << 16 | y);
@@ -230,46 +263,74 @@ namespace MMAP
         }
 
         std::string filePath = sWorld.GetDataPath() + std::string("mmaps/") + fileName;
-        // load this tile
-        FILE* file = fopen(filePath.c_str(), "rb");
-        if (!file)
-        {
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "ERROR: MMAP:loadMap: Could not open mmtile file '%s'", fileName);
-            return false;
-        }
 
-        // read header
         MmapTileHeader fileHeader;
-        fread(&fileHeader, sizeof(MmapTileHeader), 1, file);
+        unsigned char* data;
 
-        if (fileHeader.mmapMagic != MMAP_MAGIC)
+        // the grid preloader may have read this tile already
+        std::vector<unsigned char> staged;
+        if (number == 0 && sGridPreloader.TakeStagedNavTile(filePath, staged))
         {
-            sLog.outError("MMAP:loadMap: Bad header in mmap %s", fileName);
-            fclose(file);
-            return false;
-        }
+            if (staged.size() < sizeof(MmapTileHeader))
+            {
+                sLog.outError("MMAP:loadMap: Bad header in mmap %s", fileName);
+                return false;
+            }
 
-        if (fileHeader.mmapVersion != MMAP_VERSION)
-        {
-            sLog.outError("MMAP:loadMap: %s was built with generator v%i, expected v%i",
-                          fileName, fileHeader.mmapVersion, MMAP_VERSION);
-            fclose(file);
-            return false;
+            memcpy(&fileHeader, &staged[0], sizeof(MmapTileHeader));
+            if (fileHeader.mmapMagic != MMAP_MAGIC || fileHeader.mmapVersion != MMAP_VERSION ||
+                    staged.size() < sizeof(MmapTileHeader) + fileHeader.size)
+            {
+                sLog.outError("MMAP:loadMap: Bad header or data in mmap %s", fileName);
+                return false;
+            }
+
+            data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
+            MANGOS_ASSERT(data);
+            memcpy(data, &staged[sizeof(MmapTileHeader)], fileHeader.size);
         }
+        else
+        {
+            // load this tile
+            FILE* file = fopen(filePath.c_str(), "rb");
+            if (!file)
+            {
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "ERROR: MMAP:loadMap: Could not open mmtile file '%s'", fileName);
+                return false;
+            }
 
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
-        MANGOS_ASSERT(data);
+            // read header
+            fread(&fileHeader, sizeof(MmapTileHeader), 1, file);
+
+            if (fileHeader.mmapMagic != MMAP_MAGIC)
+            {
+                sLog.outError("MMAP:loadMap: Bad header in mmap %s", fileName);
+                fclose(file);
+                return false;
+            }
+
+            if (fileHeader.mmapVersion != MMAP_VERSION)
+            {
+                sLog.outError("MMAP:loadMap: %s was built with generator v%i, expected v%i",
+                              fileName, fileHeader.mmapVersion, MMAP_VERSION);
+                fclose(file);
+                return false;
+            }
+
+            data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
+            MANGOS_ASSERT(data);
+
+            size_t result = fread(data, fileHeader.size, 1, file);
+            if (!result)
+            {
+                sLog.outError("MMAP:loadMap: Bad header or data in mmap %s", fileName);
+                fclose(file);
+                return false;
+            }
 
-        size_t result = fread(data, fileHeader.size, 1, file);
-        if (!result)
-        {
-            sLog.outError("MMAP:loadMap: Bad header or data in mmap %s", fileName);
             fclose(file);
-            return false;
         }
 
-        fclose(file);
-
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
@@ -283,6 +344,9 @@ namespace MMAP
         }
 
         mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+        mmap->tileUsage[packedGridPos] = { fileHeader.size, WorldTimer::getMSTime(), number != 0 };
+        mmap->residentBytes += fileHeader.size;
+        m_residentBytes += fileHeader.size;
         ++m_loadedTiles;
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded into %03i[%02i,%02i]", fileName, mapId, header->x, header->y);
         return true;
@@ -398,6 +462,7 @@ namespace MMAP
         else
         {
             mmap->mmapLoadedTiles.erase(packedGridPos);
+            removeTileUsage(mmap, packedGridPos);
             --m_loadedTiles;
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
             return true;
@@ -434,6 +499,7 @@ namespace MMAP
                 }
             }
 
+            m_residentBytes -= mmap->residentBytes;
             delete mmap;
             itr = m_loadedMMaps.erase(itr);
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded %03i.mmap", mapId);
@@ -471,9 +537,74 @@ namespace MMAP
         mmap->navMeshQueries.erase(instanceId);
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
 
+        // instances own their navmesh, nobody else will use its tiles again
+        if (instanceId)
+        {
+            m_loadedTiles -= mmap->mmapLoadedTiles.size();
+            m_residentBytes -= mmap->residentBytes;
+            delete mmap;
+            m_loadedMMaps.erase(itr);
+        }
+
         return true;
     }
 
+    void MMapManager::removeTileUsage(MMapData* mmap, uint32 packedGridPos)
+    {
+        auto usage = mmap->tileUsage.find(packedGridPos);
+        if (usage == mmap->tileUsage.end())
+            return;
+
+        mmap->residentBytes -= usage->second.size;
+        m_residentBytes -= usage->second.size;
+        mmap->tileUsage.erase(usage);
+    }
+
+    size_t MMapManager::GetResidentBytes(uint32 mapId, uint32 instanceId) const
+    {
+        auto itr = m_loadedMMaps.find(packInstanceId(mapId, instanceId));
+        return itr != m_loadedMMaps.end() ? itr->second->residentBytes : 0;
+    }
+
+    uint32 MMapManager::EvictTiles(uint32 mapId, uint32 instanceId, size_t budget, std::function<bool(uint32 x, uint32 y)> const& isInUse, std::vector<uint32>& evicted)
+    {
+        auto itr = m_loadedMMaps.find(packInstanceId(mapId, instanceId));
+        if (itr == m_loadedMMaps.end())
+            return 0;
+
+        MMapData* mmap = itr->second;
+        uint32 const now = WorldTimer::getMSTime();
+        std::vector<std::pair<uint32, uint32>> candidates;     // idle time, packed grid pos
+        for (auto& usage : mmap->tileUsage)
+        {
+            if (isInUse(usage.first >> 16, usage.first & 0x0000FFFF))
+                usage.second.lastUse = now;
+            else if (!usage.second.pinned)
+                candidates.emplace_back(WorldTimer::getMSTimeDiff(usage.second.lastUse, now), usage.first);
+        }
+
+        if (m_residentBytes <= budget || candidates.empty())
+            return 0;
+
+        // longest idle first
+        std::sort(candidates.begin(), candidates.end(), std::greater<std::pair<uint32, uint32>>());
+
+        uint32 count = 0;
+        for (auto const& candidate : candidates)
+        {
+            if (m_residentBytes <= budget)
+                break;
+
+            if (unloadMap(mapId, instanceId, candidate.second >> 16, candidate.second & 0x0000FFFF))
+            {
+                evicted.push_back(candidate.second);
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
     dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId, uint32 instanceId)
     {
         auto itr = m_loadedMMaps.find(packInstanceId(mapId, instanceId));
@@ -491,6 +622,30 @@ namespace MMAP
         return m_loadedModels[mapId]->navMesh;
     }
 
+    NavMeshQueryPool::~NavMeshQueryPool()
+    {
+        for (dtNavMeshQuery* query : m_queries)
+            dtFreeNavMeshQuery(query);
+    }
+
+    bool NavMeshQueryPool::Init(dtNavMesh const* navMesh, size_t count)
+    {
+        m_queries.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            dtNavMeshQuery* query = dtAllocNavMeshQuery();
+            MANGOS_ASSERT(query);
+            if (dtStatusFailed(query->init(navMesh, 1024)))
+            {
+                dtFreeNavMeshQuery(query);
+                sLog.outError("MMAP:NavMeshQueryPool: Failed to initialize dtNavMeshQuery %u of %u", uint32(i), uint32(count));
+                return false;
+            }
+            m_queries.push_back(query);
+        }
+        return true;
+    }
+
     dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
     {
         auto itr = m_loadedMMaps.find(packInstanceId(mapId, instanceId));
@@ -23,7 +23,11 @@
 #include <Detour/Include/DetourAlloc.h>
 #include <Detour/Include/DetourNavMesh.h>
 #include <Detour/Include/DetourNavMeshQuery.h>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 class Unit;
 
@@ -41,14 +45,24 @@ inline void dtCustomFree(void* ptr)
 //  move map related classes
 namespace MMAP
 {
+    class TileGraph;
+
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
     typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
     typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> NavMeshGOQuerySet;
 
+    struct MMapTileUsage
+    {
+        uint32 size;                        // bytes of navmesh data
+        uint32 lastUse;                     // ms time the tile was last needed by its map
+        bool pinned;                        // gameobject variant, only replaced through ChangeTile
+    };
+    typedef std::unordered_map<uint32, MMapTileUsage> MMapTileUsageSet;
+
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapData(dtNavMesh* mesh) : navMesh(mesh), residentBytes(0) {}
         ~MMapData()
         {
             for (auto& navMeshQuerie : navMeshQueries)
@@ -63,6 +77,8 @@ namespace MMAP
         // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
         NavMeshQuerySet navMeshQueries;     // instanceId to query
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+        MMapTileUsageSet tileUsage;         // same keys as mmapLoadedTiles
+        size_t residentBytes;
     };
 
     struct MMapGOData
@@ -86,12 +102,30 @@ namespace MMAP
 
     typedef std::unordered_map<uint64, MMapData*> MMapDataSet;
 
+    // queries allocated up front for every thread allowed to path on one map,
+    // callers pick theirs by slot instead of looking it up per path
+    class NavMeshQueryPool
+    {
+        public:
+            NavMeshQueryPool() {}
+            ~NavMeshQueryPool();
+            NavMeshQueryPool(NavMeshQueryPool const&) = delete;
+            NavMeshQueryPool& operator=(NavMeshQueryPool const&) = delete;
+
+            bool Init(dtNavMesh const* navMesh, size_t count);
+            dtNavMeshQuery const* Get(size_t slot) const { return slot < m_queries.size() ? m_queries[slot] : nullptr; }
+            size_t Size() const { return m_queries.size(); }
+
+        private:
+            std::vector<dtNavMeshQuery*> m_queries;
+    };
+
     // singelton class
     // holds all all access to mmap loading unloading and meshes
     class MMapManager
     {
         public:
-            MMapManager() : m_loadedTiles(0) {}
+            MMapManager();
             ~MMapManager();
 
             bool loadMap(uint32 mapId, uint32 instanceId, int32 x, int32 y, uint32 number);
@@ -108,20 +142,35 @@ namespace MMAP
             dtNavMeshQuery const* GetModelNavMeshQuery(uint32 displayId);
             dtNavMesh const* GetNavMesh(uint32 mapId, uint32 instanceId);
             dtNavMesh const* GetGONavMesh(uint32 displayId);
+            // shared by all instances of the map, nullptr when the generator did not build one
+            TileGraph const* GetTileGraph(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return m_loadedTiles; }
+            size_t GetResidentBytes() const { return m_residentBytes; }
+            size_t GetResidentBytes(uint32 mapId, uint32 instanceId) const;
+            // to be called by the owning map while none of its paths run; tiles for which isInUse returns true
+            // are refreshed, the least recently used others are unloaded until all maps fit in budget bytes
+            uint32 EvictTiles(uint32 mapId, uint32 instanceId, size_t budget, std::function<bool(uint32 x, uint32 y)> const& isInUse, std::vector<uint32>& evicted);
             uint32 getLoadedMapsCount() const { return m_loadedMMaps.size(); }
 
             void ChangeTile(uint32 mapId, uint32 instanceId, uint32 tileX, uint32 tileY, uint32 tileNumber);
         private:
             uint32 packTileID(int32 x, int32 y) const;
             uint64 packInstanceId(uint32 mapId, uint32 instanceId) const;
+            void loadTileGraph(uint32 mapId);
+
+            void removeTileUsage(MMapData* mmap, uint32 packedGridPos);
 
             MMapDataSet m_loadedMMaps;
             uint32 m_loadedTiles;
+            std::atomic<size_t> m_residentBytes;    // navmesh tiles of all maps and instances
 
             std::unordered_map<uint32, MMapGOData*> m_loadedModels;
             std::mutex m_modelsMutex;
+
+            // kept until shutdown, paths of other maps may still hold a pointer
+            std::unordered_map<uint32, std::unique_ptr<TileGraph>> m_tileGraphs;
+            std::mutex m_tileGraphsMutex;
     };
 
     // static class
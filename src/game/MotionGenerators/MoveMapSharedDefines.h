@@ -40,6 +40,37 @@ struct MmapTileHeader
         mmapVersion(MMAP_VERSION), size(0), usesLiquids(0) {}
 };
 
+#define MMAP_GRAPH_MAGIC 0x4d4d4752   // 'MMGR'
+#define MMAP_GRAPH_VERSION 1
+
+// %03u.mmgraph: header, nodes sorted by id, then the edges of every node in node order
+// nodes are border crossings between two adjacent tiles, edges join nodes reachable inside one tile
+struct MmapGraphHeader
+{
+    uint32 graphMagic;
+    uint32 graphVersion;
+    uint32 mmapVersion;
+    uint32 nodeCount;
+    uint32 edgeCount;
+
+    MmapGraphHeader() : graphMagic(MMAP_GRAPH_MAGIC), graphVersion(MMAP_GRAPH_VERSION),
+        mmapVersion(MMAP_VERSION), nodeCount(0), edgeCount(0) {}
+};
+
+struct MmapGraphNode
+{
+    float pos[3];                                           // detour space (y, z, x)
+    uint32 tiles[2];                                        // navmesh tile x << 16 | y on both sides of the border
+    uint32 firstEdge;
+    uint32 edgeCount;
+};
+
+struct MmapGraphEdge
+{
+    uint32 node;
+    float cost;                                             // walked distance across the tile
+};
+
 enum NavArea
 {
     NAV_AREA_EMPTY          = 0,
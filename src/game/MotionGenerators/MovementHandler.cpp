@@ -355,7 +355,7 @@ void WorldSession::HandleMovementOpcodes(WorldPacket& recv_data)
     WorldPacket data(opcode, recv_data.size());
     data << mover->GetPackGUID();             // write guid
     movementInfo.Write(data);                               // write data
-    mover->SendMessageToSetExcept(data, _player);
+    mover->SendMovementToSetExcept(std::move(data), _player);
 }
 
 void WorldSession::HandleForceSpeedChangeAckOpcodes(WorldPacket& recv_data)
@@ -387,7 +387,7 @@ void WorldSession::HandleForceSpeedChangeAckOpcodes(WorldPacket& recv_data)
         data << guid.WriteAsPacked();
         data << movementInfo;
         data << newspeed; // new collision height
-        mover->SendMessageToSetExcept(data, _player);
+        mover->SendMovementToSetExcept(std::move(data), _player);
         return;
     }
 
@@ -425,7 +425,7 @@ void WorldSession::HandleForceSpeedChangeAckOpcodes(WorldPacket& recv_data)
     data << guid.WriteAsPacked();
     data << movementInfo;
     data << newspeed;
-    mover->SendMessageToSetExcept(data, _player);
+    mover->SendMovementToSetExcept(std::move(data), _player);
 
     // skip all forced speed changes except last and unexpected
     // in run/mounted case used one ACK and it must be skipped.m_forced_speed_changes[MOVE_RUN} store both.
@@ -541,7 +541,7 @@ void WorldSession::HandleMoveKnockBackAck(WorldPacket& recv_data)
     data << movementInfo.jump.sinAngle;
     data << movementInfo.jump.xyspeed;
     data << movementInfo.jump.zspeed;
-    mover->SendMessageToSetExcept(data, _player);
+    mover->SendMovementToSetExcept(std::move(data), _player);
 }
 
 void WorldSession::SendKnockBack(Unit* who, float angle, float horizontalSpeed, float verticalSpeed)
@@ -598,7 +598,7 @@ void WorldSession::HandleMoveFlagChangeOpcode(WorldPacket& recv_data)
     WorldPacket data(response, 8);
     data << guid.WriteAsPacked();
     data << movementInfo;
-    mover->SendMessageToSetExcept(data, _player);
+    mover->SendMovementToSetExcept(std::move(data), _player);
 }
 
 void WorldSession::HandleMoveRootAck(WorldPacket& recv_data)
@@ -636,7 +636,7 @@ void WorldSession::HandleMoveRootAck(WorldPacket& recv_data)
     WorldPacket data(recv_data.GetOpcode() == CMSG_FORCE_MOVE_UNROOT_ACK ? MSG_MOVE_UNROOT : MSG_MOVE_ROOT);
     data << guid.WriteAsPacked();
     data << movementInfo;
-    mover->SendMessageToSetExcept(data, _player);
+    mover->SendMovementToSetExcept(std::move(data), _player);
 }
 
 void WorldSession::HandleSummonResponseOpcode(WorldPacket& recv_data)
@@ -768,7 +768,7 @@ void WorldSession::HandleMoveTimeSkippedOpcode(WorldPacket& recv_data)
     WorldPacket data(MSG_MOVE_TIME_SKIPPED, 16);
     data << mover->GetPackGUID();
     data << timeSkipped;
-    mover->SendMessageToSetExcept(data, _player);
+    mover->SendMovementToSetExcept(std::move(data), _player);
 }
 
 bool WorldSession::ProcessMovementInfo(MovementInfo& movementInfo, Unit* mover, Player* plMover, WorldPacket& recv_data)
@@ -0,0 +1,91 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MotionGenerators/PathCache.h"
+
+size_t PathCache::KeyHash::operator()(Key const& key) const
+{
+    uint64 hash = key.startPoly * UINT64_C(0x9E3779B97F4A7C15);
+    hash ^= key.endPoly + UINT64_C(0x9E3779B97F4A7C15) + (hash << 6) + (hash >> 2);
+    hash ^= (uint64(key.includeFlags) << 48) | (uint64(key.excludeFlags) << 32) | key.maxPolys;
+    return size_t(hash ^ (hash >> 29));
+}
+
+void PathCache::SetCapacity(uint32 capacity)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_capacity = capacity;
+    while (m_entries.size() > m_capacity)
+    {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+}
+
+bool PathCache::Lookup(dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, uint16 excludeFlags, uint32 maxPolys, dtPolyRef* polys, uint32& polyCount)
+{
+    if (!m_capacity)
+        return false;
+
+    ++m_lookups;
+    Key const key = { startPoly, endPoly, includeFlags, excludeFlags, maxPolys };
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_index.find(key);
+    if (itr == m_index.end())
+        return false;
+
+    m_entries.splice(m_entries.begin(), m_entries, itr->second);
+    std::vector<dtPolyRef> const& cached = itr->second->polys;
+    std::copy(cached.begin(), cached.end(), polys);
+    polyCount = cached.size();
+    ++m_hits;
+    return true;
+}
+
+void PathCache::Store(dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, uint16 excludeFlags, uint32 maxPolys, dtPolyRef const* polys, uint32 polyCount, uint32 generation)
+{
+    if (!m_capacity || !polyCount || polyCount > maxPolys)
+        return;
+
+    Key const key = { startPoly, endPoly, includeFlags, excludeFlags, maxPolys };
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (generation != m_generation || m_index.find(key) != m_index.end())
+        return;
+
+    if (m_entries.size() >= m_capacity)
+    {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+
+    m_entries.push_front(Entry());
+    Entry& entry = m_entries.front();
+    entry.key = key;
+    entry.polys.assign(polys, polys + polyCount);
+    m_index.emplace(key, m_entries.begin());
+}
+
+void PathCache::Invalidate()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    ++m_generation;
+    m_entries.clear();
+    m_index.clear();
+}
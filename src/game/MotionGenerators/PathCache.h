@@ -0,0 +1,94 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATHCACHE_H
+#define MANGOS_PATHCACHE_H
+
+#include "Common.h"
+
+#include <Detour/Include/DetourNavMesh.h>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Polygon corridors found by PathFinder on one map, least recently used entries are dropped first.
+// Creatures going home, escorts and chasers keep asking for the same corridor between the same
+// polygons, the point path is still refined from the exact positions every time.
+// Start and end are quantized to their polygons, filters differ per movement type and are part of the key.
+// Cleared whenever a navmesh tile of the map changes, poly refs of replaced tiles are not valid anymore.
+class PathCache
+{
+    public:
+        PathCache() : m_capacity(0), m_generation(0), m_lookups(0), m_hits(0) {}
+
+        // 0 disables the cache
+        void SetCapacity(uint32 capacity);
+
+        // generation must be taken before the search so a corridor found across a tile change is never stored
+        uint32 GetGeneration() const { return m_generation; }
+
+        bool Lookup(dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, uint16 excludeFlags, uint32 maxPolys, dtPolyRef* polys, uint32& polyCount);
+        void Store(dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, uint16 excludeFlags, uint32 maxPolys, dtPolyRef const* polys, uint32 polyCount, uint32 generation);
+        void Invalidate();
+
+        uint32 GetLookups() const { return m_lookups; }
+        uint32 GetHits() const { return m_hits; }
+        void ResetStats() { m_lookups = 0; m_hits = 0; }
+
+    private:
+        struct Key
+        {
+            dtPolyRef startPoly;
+            dtPolyRef endPoly;
+            uint16 includeFlags;
+            uint16 excludeFlags;
+            uint32 maxPolys;
+
+            bool operator==(Key const& other) const
+            {
+                return startPoly == other.startPoly && endPoly == other.endPoly && includeFlags == other.includeFlags &&
+                       excludeFlags == other.excludeFlags && maxPolys == other.maxPolys;
+            }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(Key const& key) const;
+        };
+
+        struct Entry
+        {
+            Key key;
+            std::vector<dtPolyRef> polys;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        std::mutex m_lock;
+        EntryList m_entries;                                // most recently used first
+        std::unordered_map<Key, EntryList::iterator, KeyHash> m_index;
+        uint32 m_capacity;
+        std::atomic<uint32> m_generation;
+        std::atomic<uint32> m_lookups;
+        std::atomic<uint32> m_hits;
+};
+
+#endif
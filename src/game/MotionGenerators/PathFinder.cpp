@@ -23,6 +23,8 @@
 #include "Log.h"
 #include "World/World.h"
 #include "Entities/Transports.h"
+#include "MotionGenerators/PathCache.h"
+#include "MotionGenerators/TileGraph.h"
 #include <Detour/Include/DetourCommon.h>
 #include <Detour/Include/DetourMath.h>
 
@@ -32,17 +34,26 @@
 
 #include <limits>
 ////////////////// PathFinder //////////////////
+// maps hand out a query per update thread, the shared per instance query is only used outside of them
+static dtNavMeshQuery const* GetDefaultNavMeshQuery(Unit const* unit)
+{
+    if (unit->IsInWorld())
+        if (dtNavMeshQuery const* query = unit->GetMap()->GetNavMeshQuery())
+            return query;
+
+    return MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(unit->GetMapId(), unit->GetInstanceId());
+}
+
 PathFinder::PathFinder(const Unit* owner, bool ignoreNormalization) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_straightLine(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH), // TODO: Fix legitimate long paths
-    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_cachedPoints(m_pointPathLimit * VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_defaultMapId(m_sourceUnit->GetMapId()), m_ignoreNormalization(ignoreNormalization)
+    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_cachedPoints(m_pointPathLimit * VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_ignoreNormalization(ignoreNormalization)
 {
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
 
     if (MMAP::MMapFactory::IsPathfindingEnabled(m_sourceUnit->GetMapId(), m_sourceUnit))
     {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
+        m_defaultNavMeshQuery = GetDefaultNavMeshQuery(m_sourceUnit);
     }
 
     createFilter();
@@ -62,8 +73,8 @@ void PathFinder::SetCurrentNavMesh()
             m_navMeshQuery = mmap->GetModelNavMeshQuery(transport->GetDisplayId());
         else
         {
-            if (m_defaultMapId != m_sourceUnit->GetMapId())
-                m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
+            // fetched on every path, the query belongs to whichever update thread runs the owner now
+            m_defaultNavMeshQuery = GetDefaultNavMeshQuery(m_sourceUnit);
 
             m_navMeshQuery = m_defaultNavMeshQuery;
         }
@@ -92,13 +103,11 @@ bool PathFinder::calculate(Vector3 const& start, Vector3 const& dest, bool force
         return false;
 
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("pathfinder.calculate", {
-        { "entry", std::to_string(m_sourceUnit->GetEntry()) },
-        { "guid", std::to_string(m_sourceUnit->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_sourceUnit->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_sourceUnit->GetMapId()) },
-        { "instance_id", std::to_string(m_sourceUnit->GetInstanceId()) }
-    }, 1000);
+    static metric::histogram& pathHistogram = metric::aggregates::instance().register_histogram("pathfinder.calculate.aggregate");
+    metric::timer meas(pathHistogram, 1000, [this](int64 elapsed)
+    {
+        metric::metric::instance().report("pathfinder.calculate", "duration", elapsed, m_sourceUnit->GetMetricTags());
+    });
 #endif
 
     //if (GenericTransport* transport = m_sourceUnit->GetTransport())
@@ -214,6 +223,10 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         if (m_pointPathLimit > m_pathPolyRefs.size())
             m_pathPolyRefs.resize(m_pointPathLimit);
     }
+
+    // a hierarchical search raises the limit for this path only
+    uint32 const pointPathLimit = m_pointPathLimit;
+
     float distToStartPoly, distToEndPoly;
     float startPoint[VERTEX_SIZE] = {startPos.y, startPos.z, startPos.x};
     float endPoint[VERTEX_SIZE] = {endPos.y, endPos.z, endPos.x};
@@ -455,15 +468,36 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
 
         if (!m_straightLine)
         {
-            dtResult = m_navMeshQuery->findPath(
-                    startPoly,          // start polygon
-                    endPoly,            // end polygon
-                    startPoint,         // start position
-                    endPoint,           // end position
-                    &m_filter,          // polygon search filter
-                    m_pathPolyRefs.data(), // [out] path
-                    (int*)&m_polyLength,
-                    m_pointPathLimit);   // max number of polygons in output path
+            // corridors on transports use model navmeshes, their poly refs mean nothing to the map
+            PathCache* cache = nullptr;
+            if (!m_sourceUnit->GetTransport() && m_sourceUnit->IsInWorld())
+                cache = m_sourceUnit->GetMap()->GetPathCache();
+
+            uint32 generation = 0;
+            bool cached = false;
+            if (cache)
+            {
+                generation = cache->GetGeneration();
+                cached = cache->Lookup(startPoly, endPoly, m_filter.getIncludeFlags(), m_filter.getExcludeFlags(), m_pointPathLimit, m_pathPolyRefs.data(), m_polyLength);
+            }
+
+            if (cached || BuildHierarchicalPolyPath(startPoly, endPoly, startPoint, endPoint))
+                dtResult = DT_SUCCESS;
+            else
+            {
+                dtResult = m_navMeshQuery->findPath(
+                        startPoly,          // start polygon
+                        endPoly,            // end polygon
+                        startPoint,         // start position
+                        endPoint,           // end position
+                        &m_filter,          // polygon search filter
+                        m_pathPolyRefs.data(), // [out] path
+                        (int*)&m_polyLength,
+                        m_pointPathLimit);   // max number of polygons in output path
+
+                if (cache && m_polyLength && dtStatusSucceed(dtResult))
+                    cache->Store(startPoly, endPoly, m_filter.getIncludeFlags(), m_filter.getExcludeFlags(), m_pointPathLimit, m_pathPolyRefs.data(), m_polyLength, generation);
+            }
         }
         else
         {
@@ -543,6 +577,82 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
 
     // generate the point-path out of our up-to-date poly-path
     BuildPointPath(startPoint, endPoint);
+    m_pointPathLimit = pointPathLimit;
+}
+
+bool PathFinder::BuildHierarchicalPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPoint, const float* endPoint)
+{
+    // callers limiting the path length want a short path, transports have their own navmesh
+    if (m_pointPathLimit < MAX_POINT_PATH_LENGTH || m_sourceUnit->GetTransport() || m_navMeshQuery != m_defaultNavMeshQuery)
+        return false;
+
+    dtMeshTile const* startTile = nullptr;
+    dtMeshTile const* endTile = nullptr;
+    dtPoly const* poly = nullptr;
+    if (dtStatusFailed(m_navMesh->getTileAndPolyByRef(startPoly, &startTile, &poly)) ||
+            dtStatusFailed(m_navMesh->getTileAndPolyByRef(endPoly, &endTile, &poly)))
+        return false;
+
+    // neighbour tiles are cheap enough for a plain search
+    if (std::abs(startTile->header->x - endTile->header->x) <= 1 && std::abs(startTile->header->y - endTile->header->y) <= 1)
+        return false;
+
+    MMAP::TileGraph const* graph = MMAP::MMapFactory::createOrGetMMapManager()->GetTileGraph(m_sourceUnit->GetMapId());
+    if (!graph)
+        return false;
+
+    std::vector<float> waypoints;
+    if (!graph->FindRoute(MMAP::TileGraph::PackTile(startTile->header->x, startTile->header->y), startPoint,
+                          MMAP::TileGraph::PackTile(endTile->header->x, endTile->header->y), endPoint, waypoints))
+        return false;
+
+    if (m_pathPolyRefs.size() < MAX_HIERARCHICAL_PATH_LENGTH)
+        m_pathPolyRefs.resize(MAX_HIERARCHICAL_PATH_LENGTH);
+
+    // join the local corridors between consecutive border crossings, each one starts on the last polygon of the previous
+    uint32 const segmentCount = waypoints.size() / VERTEX_SIZE + 1;
+    dtPolyRef segmentStart = startPoly;
+    float segmentStartPos[VERTEX_SIZE];
+    dtVcopy(segmentStartPos, startPoint);
+    uint32 polyLength = 0;
+    for (uint32 i = 0; i < segmentCount; ++i)
+    {
+        dtPolyRef segmentEnd = endPoly;
+        float segmentEndPos[VERTEX_SIZE];
+        if (i + 1 < segmentCount)
+        {
+            // crossings the unit may not walk, e.g. water for non swimmers, leave the route to the plain search
+            if (dtStatusFailed(m_navMeshQuery->findNearestPoly(&waypoints[i * VERTEX_SIZE], NearPolySearchBound, &m_filter, &segmentEnd, segmentEndPos)) || segmentEnd == INVALID_POLYREF)
+                return false;
+        }
+        else
+            dtVcopy(segmentEndPos, endPoint);
+
+        uint32 const offset = polyLength ? polyLength - 1 : 0;
+        int segmentLength = 0;
+        dtStatus dtResult = m_navMeshQuery->findPath(segmentStart, segmentEnd, segmentStartPos, segmentEndPos, &m_filter,
+                            &m_pathPolyRefs[offset], &segmentLength, MAX_HIERARCHICAL_PATH_LENGTH - offset);
+        if (dtStatusFailed(dtResult) || segmentLength <= 0)
+        {
+            if (!polyLength)
+                return false;
+            break;
+        }
+
+        polyLength = offset + segmentLength;
+
+        // budget spent or crossing not reached, the remaining route is found again once the unit gets there
+        if (m_pathPolyRefs[polyLength - 1] != segmentEnd || polyLength >= MAX_HIERARCHICAL_PATH_LENGTH)
+            break;
+
+        segmentStart = segmentEnd;
+        dtVcopy(segmentStartPos, segmentEndPos);
+    }
+
+    m_polyLength = polyLength;
+    m_pointPathLimit = MAX_HIERARCHICAL_PATH_LENGTH;
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildHierarchicalPolyPath :: %u crossings, %u polygons\n", segmentCount - 1, m_polyLength);
+    return true;
 }
 
 void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
@@ -848,7 +958,13 @@ bool PathFinder::HaveTile(const Vector3& p) const
     if (tx == -1 || ty == -1)
         return false;
 
-    return (m_navMesh->getTileAt(tx, ty, 0) != nullptr); // Don't use layer so always set to 0
+    if (m_navMesh->getTileAt(tx, ty, 0)) // Don't use layer so always set to 0
+        return true;
+
+    // the tile may only have been evicted, this path is a shortcut but the next one will have it again
+    if (m_sourceUnit->IsInWorld())
+        m_sourceUnit->GetMap()->RequestNavTile(p.x, p.y);
+    return false;
 }
 
 uint32 PathFinder::fixupCorridor(dtPolyRef* path, uint32 npath, uint32 maxPath, dtPolyRef const* visited, uint32 nvisited)
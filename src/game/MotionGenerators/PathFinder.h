@@ -37,6 +37,9 @@ class Unit;
 #define MAX_PATH_LENGTH         74
 #define MAX_POINT_PATH_LENGTH   74
 
+// polygon budget of routes planned over the tile graph, farther routes come back incomplete and are extended when reached
+#define MAX_HIERARCHICAL_PATH_LENGTH (MAX_POINT_PATH_LENGTH * 16)
+
 #define SMOOTH_PATH_STEP_SIZE   4.0f
 #define SMOOTH_PATH_SLOP        0.3f
 
@@ -114,7 +117,6 @@ class PathFinder
         const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
 
         const dtNavMeshQuery*   m_defaultNavMeshQuery;     // the nav mesh query used to find the path
-        uint32                  m_defaultMapId;
 
         bool                    m_ignoreNormalization;
 
@@ -141,6 +143,7 @@ class PathFinder
         bool HaveTile(const Vector3& p) const;
 
         void BuildPolyPath(const Vector3& startPos, const Vector3& endPos);
+        bool BuildHierarchicalPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPoint, const float* endPoint);
         void BuildPointPath(const float* startPoint, const float* endPoint);
         void BuildShortcut();
 
@@ -0,0 +1,129 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MotionGenerators/PathRequestQueue.h"
+#include "Maps/MapWorkers.h"
+
+void PathRequest::SetDestination(Vector3 const& start, Vector3 const& dest, bool forceDest, bool straightLine)
+{
+    m_kind = PATH_TO_POINT;
+    m_start = start;
+    m_dest = dest;
+    m_forceDest = forceDest;
+    m_straightLine = straightLine;
+}
+
+void PathRequest::SetRandomPoint(Vector3 const& center, float range)
+{
+    m_kind = PATH_TO_RANDOM_POINT;
+    m_start = center;
+    m_range = range;
+}
+
+void PathRequest::Cancel()
+{
+    // requests only run while the map update waits for them, never while the owner is destroyed
+    m_state.store(STATE_CANCELED, std::memory_order_release);
+    m_path.reset();
+}
+
+void PathRequest::Execute()
+{
+    if (m_state.load(std::memory_order_acquire) != STATE_QUEUED)
+        return;
+
+    switch (m_kind)
+    {
+        case PATH_TO_POINT:
+            m_path->calculate(m_start, m_dest, m_forceDest, m_straightLine);
+            break;
+        case PATH_TO_RANDOM_POINT:
+            m_path->ComputePathToRandomPoint(m_start, m_range);
+            break;
+    }
+
+    // a request canceled meanwhile stays canceled
+    uint8 expected = STATE_QUEUED;
+    m_state.compare_exchange_strong(expected, STATE_DONE, std::memory_order_acq_rel);
+}
+
+class PathRequestWorker : public Worker
+{
+    public:
+        PathRequestWorker(PathRequestPtr const* begin, PathRequestPtr const* end, MapUpdater& updater) :
+            Worker(updater), m_begin(begin), m_end(end)
+        {}
+
+        void execute() override
+        {
+            PathRequestQueue::ExecuteRange(m_begin, m_end);
+            GetWorker().update_finished();
+        }
+
+    private:
+        PathRequestPtr const* m_begin;
+        PathRequestPtr const* m_end;
+};
+
+void PathRequestQueue::Submit(PathRequestPtr const& request)
+{
+    request->m_state.store(PathRequest::STATE_QUEUED, std::memory_order_release);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_queued.push_back(request);
+}
+
+void PathRequestQueue::ExecuteRange(PathRequestPtr const* begin, PathRequestPtr const* end)
+{
+    for (; begin != end; ++begin)
+        (*begin)->Execute();
+}
+
+void PathRequestQueue::Process(MapUpdater* updater, uint32 maxRequests)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (m_queued.empty())
+            return;
+
+        size_t count = m_queued.size();
+        if (maxRequests && count > maxRequests)
+            count = maxRequests;
+
+        m_batch.assign(m_queued.begin(), m_queued.begin() + count);
+        m_queued.erase(m_queued.begin(), m_queued.begin() + count);
+    }
+
+    PathRequestPtr const* requests = m_batch.data();
+    size_t const count = m_batch.size();
+    size_t const threads = updater ? updater->threads() : 0;
+    if (threads > 1 && count > 1)
+    {
+        // one contiguous slice per thread, requests of one map share the navmesh anyway
+        size_t const slices = std::min(threads, count);
+        size_t const perSlice = (count + slices - 1) / slices;
+        for (size_t first = 0; first < count; first += perSlice)
+            updater->schedule_update(new PathRequestWorker(requests + first, requests + std::min(first + perSlice, count), *updater));
+        updater->wait();
+    }
+    else
+        ExecuteRange(requests, requests + count);
+
+    m_processed += count;
+    m_batch.clear();
+}
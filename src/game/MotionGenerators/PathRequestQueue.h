@@ -0,0 +1,112 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATHREQUESTQUEUE_H
+#define MANGOS_PATHREQUESTQUEUE_H
+
+#include "Common.h"
+#include "MotionGenerators/PathFinder.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class MapUpdater;
+
+// One path computation handed from a movement generator to its map.
+// The owner keeps moving along its previous path and polls IsReady() on its next updates,
+// the path finder must not be touched while the request is queued.
+class PathRequest
+{
+    public:
+        explicit PathRequest(Unit const* owner) : m_path(new PathFinder(owner)), m_kind(PATH_TO_POINT), m_forceDest(false),
+            m_straightLine(false), m_range(0.0f), m_state(STATE_IDLE) {}
+
+        void SetDestination(Vector3 const& start, Vector3 const& dest, bool forceDest = false, bool straightLine = false);
+        void SetRandomPoint(Vector3 const& center, float range);
+
+        bool IsQueued() const { return m_state.load(std::memory_order_acquire) == STATE_QUEUED; }
+        bool IsReady() const { return m_state.load(std::memory_order_acquire) == STATE_DONE; }
+        // result is consumed, the request can be filled and submitted again
+        void Reset() { m_state.store(STATE_IDLE, std::memory_order_release); }
+        // owner goes away, a queued request is skipped and no longer refers to it
+        void Cancel();
+
+        PathFinder& GetPathFinder() { return *m_path; }
+
+    private:
+        friend class PathRequestQueue;
+
+        enum Kind
+        {
+            PATH_TO_POINT,
+            PATH_TO_RANDOM_POINT,
+        };
+
+        enum State
+        {
+            STATE_IDLE,
+            STATE_QUEUED,
+            STATE_DONE,
+            STATE_CANCELED,
+        };
+
+        void Execute();
+
+        std::unique_ptr<PathFinder> m_path;
+        Kind m_kind;
+        Vector3 m_start;
+        Vector3 m_dest;
+        bool m_forceDest;
+        bool m_straightLine;
+        float m_range;
+        std::atomic<uint8> m_state;
+};
+
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
+// Path requests of one map. They are collected while the map updates from any of its threads
+// and computed together at the start of the next update, when no unit moves, spread over
+// the cell update threads if the map has them. Each thread uses its own navmesh query.
+class PathRequestQueue
+{
+    public:
+        PathRequestQueue() : m_processed(0) {}
+
+        void Submit(PathRequestPtr const& request);
+
+        // computes up to maxRequests queued paths (0 for all), the rest wait for the next call
+        void Process(MapUpdater* updater, uint32 maxRequests);
+
+        // number of paths computed since the last reset
+        uint32 GetProcessed() const { return m_processed; }
+        void ResetStats() { m_processed = 0; }
+
+    private:
+        friend class PathRequestWorker;
+
+        static void ExecuteRange(PathRequestPtr const* begin, PathRequestPtr const* end);
+
+        std::mutex m_lock;
+        std::vector<PathRequestPtr> m_queued;               // guarded by m_lock
+        std::vector<PathRequestPtr> m_batch;
+        uint32 m_processed;
+};
+
+#endif
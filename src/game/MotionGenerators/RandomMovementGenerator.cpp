@@ -21,11 +21,28 @@
 #include "Movement/MoveSplineInit.h"
 #include "Movement/MoveSpline.h"
 #include "MotionGenerators/RandomMovementGenerator.h"
+#include "MotionGenerators/PathRequestQueue.h"
+#include "World/World.h"
+
+AbstractRandomMovementGenerator::~AbstractRandomMovementGenerator()
+{
+    CancelPathRequest();
+}
+
+void AbstractRandomMovementGenerator::CancelPathRequest()
+{
+    if (m_pathRequest)
+    {
+        m_pathRequest->Cancel();
+        m_pathRequest.reset();
+    }
+}
 
 void AbstractRandomMovementGenerator::Initialize(Unit& owner)
 {
     owner.addUnitState(i_stateActive);
 
+    CancelPathRequest();
     m_pathFinder = std::make_unique<PathFinder>(&owner);
 
     // Client-controlled unit should have control removed
@@ -51,6 +68,7 @@ void AbstractRandomMovementGenerator::Initialize(Unit& owner)
 void AbstractRandomMovementGenerator::Finalize(Unit& owner)
 {
     owner.clearUnitState(i_stateActive | i_stateMotion);
+    CancelPathRequest();
 
     // Client-controlled unit should have control restored
     if (const Player* controllingClientPlayer = owner.GetClientControlling())
@@ -94,43 +112,84 @@ bool AbstractRandomMovementGenerator::Update(Unit& owner, const uint32& diff)
 
     if (owner.movespline->Finalized())
     {
+        if (m_pathRequest)
+        {
+            // wait for the path requested earlier
+            if (m_pathRequest->IsQueued())
+                return true;
+
+            if (m_pathRequest->IsReady())
+            {
+                m_pathRequest->Reset();
+                ScheduleNextMove(owner, LaunchPath(owner, m_pathRequest->GetPathFinder()));
+                return true;
+            }
+        }
+
         i_nextMoveTimer.Update(diff);
 
         if (i_nextMoveTimer.Passed())
         {
-            if (_setLocation(owner))
-            {
-                if (i_nextMoveCount > 1)
-                    --i_nextMoveCount;
-                else
-                {
-                    i_nextMoveCount = urand(1, i_nextMoveCountMax);
-                    i_nextMoveTimer.Reset(urand(i_nextMoveDelayMin, i_nextMoveDelayMax));
-                }
-            }
-            else
-                i_nextMoveTimer.Reset(owner.HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED) ? 100 : 500);
+            int32 duration = _setLocation(owner);
+            if (!m_pathRequest || !m_pathRequest->IsQueued())
+                ScheduleNextMove(owner, duration);
         }
     }
 
     return true;
 }
 
+void AbstractRandomMovementGenerator::ScheduleNextMove(Unit& owner, int32 duration)
+{
+    if (duration)
+    {
+        if (i_nextMoveCount > 1)
+            --i_nextMoveCount;
+        else
+        {
+            i_nextMoveCount = urand(1, i_nextMoveCountMax);
+            i_nextMoveTimer.Reset(urand(i_nextMoveDelayMin, i_nextMoveDelayMax));
+        }
+    }
+    else
+        i_nextMoveTimer.Reset(owner.HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED) ? 100 : 500);
+}
+
 int32 AbstractRandomMovementGenerator::_setLocation(Unit& owner)
 {
     // Look for a random location within certain radius of initial position
     float x = i_x, y = i_y, z = i_z;
 
+    // creatures without a controlling player never change maps while the request is queued
+    if (sWorld.getConfig(CONFIG_BOOL_PATH_FIND_ASYNC) && owner.GetTypeId() == TYPEID_UNIT && owner.IsInWorld() &&
+            !owner.HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED))
+    {
+        if (!m_pathRequest)
+            m_pathRequest = std::make_shared<PathRequest>(&owner);
+
+        if (i_pathLength != 0.0f)
+            m_pathRequest->GetPathFinder().setPathLengthLimit(i_pathLength);
+
+        m_pathRequest->SetRandomPoint(Vector3(x, y, z), i_radius);
+        owner.GetMap()->QueuePathRequest(m_pathRequest);
+        return 0;
+    }
+
     if (i_pathLength != 0.0f)
         m_pathFinder->setPathLengthLimit(i_pathLength);
 
     m_pathFinder->ComputePathToRandomPoint(Vector3(x, y, z), i_radius);
 
-    if ((m_pathFinder->getPathType() & PATHFIND_NOPATH) != 0)
+    return LaunchPath(owner, *m_pathFinder);
+}
+
+int32 AbstractRandomMovementGenerator::LaunchPath(Unit& owner, PathFinder& path)
+{
+    if ((path.getPathType() & PATHFIND_NOPATH) != 0)
         return 0;
 
     Movement::MoveSplineInit init(owner);
-    init.MovebyPath(m_pathFinder->getPath());
+    init.MovebyPath(path.getPath());
     init.SetWalk(i_walk);
 
     if (owner.IsSlowedInCombat())
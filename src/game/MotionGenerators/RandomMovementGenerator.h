@@ -23,6 +23,7 @@
 #include "Entities/ObjectGuid.h"
 
 class PathFinder;
+class PathRequest;
 
 class AbstractRandomMovementGenerator : public MovementGenerator
 {
@@ -34,6 +35,7 @@ class AbstractRandomMovementGenerator : public MovementGenerator
             i_stateActive(stateActive), i_stateMotion(stateMotion)
         {
         }
+        ~AbstractRandomMovementGenerator();
 
         void Initialize(Unit& owner) override;
         void Finalize(Unit& owner) override;
@@ -43,6 +45,9 @@ class AbstractRandomMovementGenerator : public MovementGenerator
 
     protected:
         virtual int32 _setLocation(Unit& owner);
+        int32 LaunchPath(Unit& owner, PathFinder& path);
+        void ScheduleNextMove(Unit& owner, int32 duration);
+        void CancelPathRequest();
 
         float i_x, i_y, i_z;
         float i_radius;
@@ -51,6 +56,7 @@ class AbstractRandomMovementGenerator : public MovementGenerator
         bool i_walk;
 
         std::unique_ptr<PathFinder> m_pathFinder;
+        std::shared_ptr<PathRequest> m_pathRequest;         // pending asynchronous path, see PathFinder.Async
         ShortTimeTracker i_nextMoveTimer;
         uint32 i_nextMoveCount, i_nextMoveCountMax;
         uint32 i_nextMoveDelayMin, i_nextMoveDelayMax;
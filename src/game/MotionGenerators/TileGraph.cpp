@@ -0,0 +1,181 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MotionGenerators/TileGraph.h"
+#include "Log.h"
+
+#include <cmath>
+#include <queue>
+
+namespace MMAP
+{
+    static float NodeDistance(float const* a, float const* b)
+    {
+        float const dx = a[0] - b[0];
+        float const dy = a[1] - b[1];
+        float const dz = a[2] - b[2];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    TileGraph* TileGraph::Load(char const* fileName)
+    {
+        FILE* file = fopen(fileName, "rb");
+        if (!file)
+            return nullptr;
+
+        MmapGraphHeader header;
+        if (fread(&header, sizeof(MmapGraphHeader), 1, file) != 1 || header.graphMagic != MMAP_GRAPH_MAGIC)
+        {
+            sLog.outError("MMAP:TileGraph: Bad header in %s", fileName);
+            fclose(file);
+            return nullptr;
+        }
+
+        if (header.graphVersion != MMAP_GRAPH_VERSION || header.mmapVersion != MMAP_VERSION)
+        {
+            sLog.outError("MMAP:TileGraph: %s was built for another mmap version, rebuild it with the generator", fileName);
+            fclose(file);
+            return nullptr;
+        }
+
+        TileGraph* graph = new TileGraph();
+        graph->m_nodes.resize(header.nodeCount);
+        graph->m_edges.resize(header.edgeCount);
+        bool const read = (!header.nodeCount || fread(graph->m_nodes.data(), sizeof(MmapGraphNode), header.nodeCount, file) == header.nodeCount) &&
+                          (!header.edgeCount || fread(graph->m_edges.data(), sizeof(MmapGraphEdge), header.edgeCount, file) == header.edgeCount);
+        fclose(file);
+
+        if (!read)
+        {
+            sLog.outError("MMAP:TileGraph: %s is truncated", fileName);
+            delete graph;
+            return nullptr;
+        }
+
+        for (uint32 i = 0; i < header.nodeCount; ++i)
+        {
+            MmapGraphNode const& node = graph->m_nodes[i];
+            if (node.firstEdge > header.edgeCount || node.edgeCount > header.edgeCount - node.firstEdge)
+            {
+                sLog.outError("MMAP:TileGraph: %s has invalid edges for node %u", fileName, i);
+                delete graph;
+                return nullptr;
+            }
+
+            graph->m_tileNodes[node.tiles[0]].push_back(i);
+            graph->m_tileNodes[node.tiles[1]].push_back(i);
+        }
+
+        for (MmapGraphEdge const& edge : graph->m_edges)
+        {
+            if (edge.node >= header.nodeCount)
+            {
+                sLog.outError("MMAP:TileGraph: %s has an edge to unknown node %u", fileName, edge.node);
+                delete graph;
+                return nullptr;
+            }
+        }
+
+        return graph;
+    }
+
+    bool TileGraph::FindRoute(uint32 startTile, float const* start, uint32 endTile, float const* end, std::vector<float>& waypoints) const
+    {
+        auto startNodes = m_tileNodes.find(startTile);
+        auto endNodes = m_tileNodes.find(endTile);
+        if (startNodes == m_tileNodes.end() || endNodes == m_tileNodes.end())
+            return false;
+
+        // nodes bordering the end tile get their remaining distance, the end itself is not a node
+        std::unordered_map<uint32, float> goalCost;
+        for (uint32 node : endNodes->second)
+            goalCost[node] = NodeDistance(m_nodes[node].pos, end);
+
+        struct Visit
+        {
+            float cost;
+            uint32 parent;
+            bool closed;
+        };
+        std::unordered_map<uint32, Visit> visits;
+        typedef std::pair<float, uint32> OpenEntry;         // estimated total, node
+        std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+
+        uint32 const noParent = uint32(-1);
+        for (uint32 node : startNodes->second)
+        {
+            float const cost = NodeDistance(start, m_nodes[node].pos);
+            auto itr = visits.find(node);
+            if (itr != visits.end() && itr->second.cost <= cost)
+                continue;
+            visits[node] = { cost, noParent, false };
+            open.emplace(cost + NodeDistance(m_nodes[node].pos, end), node);
+        }
+
+        uint32 bestGoal = noParent;
+        float bestTotal = 0.0f;
+        while (!open.empty())
+        {
+            OpenEntry const current = open.top();
+            open.pop();
+
+            // everything left is estimated longer than the best complete route
+            if (bestGoal != noParent && current.first >= bestTotal)
+                break;
+
+            Visit& visit = visits[current.second];
+            if (visit.closed)
+                continue;
+            visit.closed = true;
+
+            auto goal = goalCost.find(current.second);
+            if (goal != goalCost.end() && (bestGoal == noParent || visit.cost + goal->second < bestTotal))
+            {
+                bestGoal = current.second;
+                bestTotal = visit.cost + goal->second;
+            }
+
+            MmapGraphNode const& node = m_nodes[current.second];
+            float const baseCost = visit.cost;
+            for (uint32 i = node.firstEdge; i < node.firstEdge + node.edgeCount; ++i)
+            {
+                MmapGraphEdge const& edge = m_edges[i];
+                float const cost = baseCost + edge.cost;
+                auto itr = visits.find(edge.node);
+                if (itr != visits.end() && (itr->second.closed || itr->second.cost <= cost))
+                    continue;
+
+                visits[edge.node] = { cost, current.second, false };
+                open.emplace(cost + NodeDistance(m_nodes[edge.node].pos, end), edge.node);
+            }
+        }
+
+        if (bestGoal == noParent)
+            return false;
+
+        std::vector<uint32> route;
+        for (uint32 node = bestGoal; node != noParent; node = visits[node].parent)
+            route.push_back(node);
+
+        waypoints.clear();
+        waypoints.reserve(route.size() * 3);
+        for (auto itr = route.rbegin(); itr != route.rend(); ++itr)
+            waypoints.insert(waypoints.end(), m_nodes[*itr].pos, m_nodes[*itr].pos + 3);
+        return true;
+    }
+}
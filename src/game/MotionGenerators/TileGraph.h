@@ -0,0 +1,53 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TILEGRAPH_H
+#define MANGOS_TILEGRAPH_H
+
+#include "Common.h"
+#include "MotionGenerators/MoveMapSharedDefines.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace MMAP
+{
+    // abstract graph of one map built by the generator, routes between far tiles are planned on it
+    // and the resulting border crossings are refined into a polygon corridor by PathFinder
+    class TileGraph
+    {
+        public:
+            static TileGraph* Load(char const* fileName);
+
+            static uint32 PackTile(int32 x, int32 y) { return uint32(x) << 16 | uint32(y); }
+
+            // start and end in detour space, fills waypoints with the crossings to walk through (3 floats each)
+            bool FindRoute(uint32 startTile, float const* start, uint32 endTile, float const* end, std::vector<float>& waypoints) const;
+
+            uint32 GetNodeCount() const { return m_nodes.size(); }
+
+        private:
+            TileGraph() {}
+
+            std::vector<MmapGraphNode> m_nodes;
+            std::vector<MmapGraphEdge> m_edges;
+            std::unordered_map<uint32, std::vector<uint32>> m_tileNodes;   // nodes on the border of each tile
+    };
+}
+
+#endif
@@ -186,9 +186,9 @@ void WaypointManager::Load()
         while (result->NextRow());
 
         //                                       0   1      2          3          4          5            6         7
-        result.reset(WorldDatabase.Query("SELECT Id, Point, PositionX, PositionY, PositionZ, Orientation, WaitTime, ScriptId FROM creature_movement"));
+        result.reset(WorldDatabase.QueryStreamed("SELECT Id, Point, PositionX, PositionY, PositionZ, Orientation, WaitTime, ScriptId FROM creature_movement"));
 
-        BarGoLink bar(result->GetRowCount());
+        BarGoLink bar(total_nodes);
 
         // error after load, we check if creature guid corresponding to the path id has proper MovementType
         std::set<uint32> creatureNoMoveType;
@@ -317,9 +317,9 @@ void WaypointManager::Load()
         while (result->NextRow());
 
         //                                       0      1       2      3          4          5          6            7         8
-        result.reset(WorldDatabase.Query("SELECT Entry, PathId, Point, PositionX, PositionY, PositionZ, Orientation, WaitTime, ScriptId FROM creature_movement_template"));
+        result.reset(WorldDatabase.QueryStreamed("SELECT Entry, PathId, Point, PositionX, PositionY, PositionZ, Orientation, WaitTime, ScriptId FROM creature_movement_template"));
 
-        BarGoLink bar(result->GetRowCount());
+        BarGoLink bar(total_nodes);
         std::set<uint32> blacklistWaypoints;
 
         do
@@ -428,9 +428,9 @@ void WaypointManager::Load()
         }
 
         //                                       0       1      2          3          4          5            6         7
-        result.reset(WorldDatabase.Query("SELECT PathId, Point, PositionX, PositionY, PositionZ, Orientation, WaitTime, ScriptId FROM waypoint_path"));
+        result.reset(WorldDatabase.QueryStreamed("SELECT PathId, Point, PositionX, PositionY, PositionZ, Orientation, WaitTime, ScriptId FROM waypoint_path"));
 
-        BarGoLink bar(result->GetRowCount());
+        BarGoLink bar(total_nodes);
         std::set<uint32> blacklistWaypoints;
 
         do
@@ -28,6 +28,8 @@
 #include "Movement/MoveSpline.h"
 #include "Maps/GridDefines.h"
 #include "Entities/Transports.h"
+#include "MotionGenerators/WaypointSegmentCache.h"
+#include "MotionGenerators/PathCache.h"
 
 #include <cassert>
 
@@ -253,37 +255,36 @@ void WaypointMovementGenerator<Creature>::OnArrived(Creature& creature)
     m_scriptTime = 0;
 }
 
-// return added travel time - TODO: implement caching of path
-uint32 WaypointMovementGenerator<Creature>::BuildIntPath(PointsArray& path, Creature& creature, Vector3 const& endPos)
+// return added travel time
+uint32 WaypointMovementGenerator<Creature>::BuildIntPath(PointsArray& path, Creature& creature, WaypointPath::const_iterator nodeItr)
 {
     Vector3 startPos = path.back();
-    uint32 travelTime = 0;
+    Vector3 const endPos(nodeItr->second.x, nodeItr->second.y, nodeItr->second.z);
     auto speedType = MovementInfo::GetSpeedType(creature.m_movementInfo.GetMovementFlags());
     float creatureSpeed = creature.GetSpeed(speedType);
 
-    PathFinder pathfinder(&creature, true);
-    pathfinder.calculate(startPos, endPos, true);
-    auto genPath = pathfinder.getPath();
-
-    Vector3 firstPoint = startPos;
-    bool first = true;
-    for (auto& point : genPath)
+    // patrols walk the same segments every round, passengers path in transport space and are not shared
+    Map* map = creature.GetMap();
+    bool const cacheable = !creature.GetTransport();
+    uint32 const generation = map->GetPathCache()->GetGeneration();
+    if (!cacheable || !map->GetWaypointSegmentCache()->Lookup(i_path, nodeItr->first, creature.GetEntry(), startPos, endPos, generation, path))
     {
-        if (first) // first point is already in path
-        {
-            first = false;
-            continue;
-        }
-        const Vector3 offset = point - firstPoint;
-        const float distance = offset.magnitude();
-        travelTime += distance / creatureSpeed * 1000;
-        path.push_back(point);
+        PathFinder pathfinder(&creature, true);
+        pathfinder.calculate(startPos, endPos, true);
+        auto genPath = pathfinder.getPath();
+
+        size_t const firstAdded = path.size();
+        // first point is already in path
+        if (!genPath.empty())
+            path.insert(path.end(), genPath.begin() + 1, genPath.end());
+
+        if (cacheable && (pathfinder.getPathType() & PATHFIND_NORMAL))
+            map->GetWaypointSegmentCache()->Store(i_path, nodeItr->first, creature.GetEntry(), startPos, endPos, generation, PointsArray(path.begin() + firstAdded, path.end()));
     }
-    const Vector3 offset = endPos - firstPoint;
-    const float distance = offset.magnitude();
-    travelTime = distance / creatureSpeed * 1000;
 
-    return travelTime;
+    const Vector3 offset = endPos - startPos;
+    const float distance = offset.magnitude();
+    return distance / creatureSpeed * 1000;
 }
 
 
@@ -362,7 +363,7 @@ void WaypointMovementGenerator<Creature>::SendNextWayPointPath(Creature& creatur
     genPath.push_back(startPos);
 
     // compute path to next node and put it in the path
-    uint32 travelTime = BuildIntPath(genPath, creature, Vector3(nextNode->x, nextNode->y, nextNode->z));
+    uint32 travelTime = BuildIntPath(genPath, creature, m_currentWaypointNode);
 
     bool looped = false;
     auto currPointItr = m_currentWaypointNode;
@@ -383,12 +384,9 @@ void WaypointMovementGenerator<Creature>::SendNextWayPointPath(Creature& creatur
                 break; // did all the path and not reached MinimumPathTime?
         }
 
-        auto const nodeAfter = nodeAfterItr->second;
-
         // extend path only if next node is different than current node
         m_nodeIndexes.push_back(genPath.size() - 1);
-        Vector3 nodeAfterCoord(nodeAfter.x, nodeAfter.y, nodeAfter.z);
-        travelTime += BuildIntPath(genPath, creature, nodeAfterCoord);
+        travelTime += BuildIntPath(genPath, creature, nodeAfterItr);
         currPointItr = nodeAfterItr;
         nextNode = &nodeAfterItr->second;
     }
@@ -104,7 +104,7 @@ class WaypointMovementGenerator<Creature>
 
     private:
         void LoadPath(Creature& creature, int32 pathId, WaypointPathOrigin wpOrigin, uint32 overwriteEntry);
-        uint32 BuildIntPath(Movement::PointsArray& path, Creature& creature, G3D::Vector3 const& endPos);
+        uint32 BuildIntPath(Movement::PointsArray& path, Creature& creature, WaypointPath::const_iterator nodeItr);
 
         void Stop(int32 time) { i_nextMoveTime.Reset(time); }
         bool Stopped(Creature& u);
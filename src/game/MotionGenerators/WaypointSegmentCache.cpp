@@ -0,0 +1,60 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MotionGenerators/WaypointSegmentCache.h"
+
+// walkers resume from a relocated spline position, allow for float drift around the stored start
+static float const SEGMENT_MATCH_DIST_SQ = 0.5f * 0.5f;
+
+size_t WaypointSegmentCache::KeyHash::operator()(Key const& key) const
+{
+    uint64 hash = uint64(reinterpret_cast<uintptr_t>(key.path)) * UINT64_C(0x9E3779B97F4A7C15);
+    hash ^= ((uint64(key.entry) << 32) | key.nodeId) + UINT64_C(0x9E3779B97F4A7C15) + (hash << 6) + (hash >> 2);
+    return size_t(hash ^ (hash >> 29));
+}
+
+bool WaypointSegmentCache::Lookup(WaypointPath const* path, uint32 nodeId, uint32 entry, G3D::Vector3 const& start, G3D::Vector3 const& end, uint32 generation, Movement::PointsArray& points)
+{
+    ++m_lookups;
+    Key const key = { path, nodeId, entry };
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_segments.find(key);
+    if (itr == m_segments.end())
+        return false;
+
+    Segment const& segment = itr->second;
+    if (segment.generation != generation || (segment.start - start).squaredLength() > SEGMENT_MATCH_DIST_SQ || segment.end != end)
+        return false;
+
+    points.insert(points.end(), segment.points.begin(), segment.points.end());
+    ++m_hits;
+    return true;
+}
+
+void WaypointSegmentCache::Store(WaypointPath const* path, uint32 nodeId, uint32 entry, G3D::Vector3 const& start, G3D::Vector3 const& end, uint32 generation, Movement::PointsArray const& points)
+{
+    Key const key = { path, nodeId, entry };
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    Segment& segment = m_segments[key];
+    segment.start = start;
+    segment.end = end;
+    segment.generation = generation;
+    segment.points = points;
+}
@@ -0,0 +1,76 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WAYPOINTSEGMENTCACHE_H
+#define MANGOS_WAYPOINTSEGMENTCACHE_H
+
+#include "Common.h"
+#include "Movement/MoveSplineInitArgs.h"
+#include "MotionGenerators/WaypointManager.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+// Point paths between consecutive waypoints on one map, found by PathFinder once and shared by every
+// creature patrolling the same path. A segment is only reused when the walker starts and ends where it was
+// built, so reloaded paths and creatures pushed off their route simply miss and rebuild it.
+// Entries are tied to the generation of the map's PathCache and so go stale whenever a navmesh tile changes.
+class WaypointSegmentCache
+{
+    public:
+        WaypointSegmentCache() : m_lookups(0), m_hits(0) {}
+
+        // points exclude the start, which is already in the spline path of the caller
+        bool Lookup(WaypointPath const* path, uint32 nodeId, uint32 entry, G3D::Vector3 const& start, G3D::Vector3 const& end, uint32 generation, Movement::PointsArray& points);
+        void Store(WaypointPath const* path, uint32 nodeId, uint32 entry, G3D::Vector3 const& start, G3D::Vector3 const& end, uint32 generation, Movement::PointsArray const& points);
+
+        uint32 GetLookups() const { return m_lookups; }
+        uint32 GetHits() const { return m_hits; }
+        void ResetStats() { m_lookups = 0; m_hits = 0; }
+
+    private:
+        struct Key
+        {
+            WaypointPath const* path;
+            uint32 nodeId;
+            uint32 entry;
+
+            bool operator==(Key const& other) const { return path == other.path && nodeId == other.nodeId && entry == other.entry; }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(Key const& key) const;
+        };
+
+        struct Segment
+        {
+            G3D::Vector3 start;
+            G3D::Vector3 end;
+            uint32 generation;
+            Movement::PointsArray points;
+        };
+
+        std::mutex m_lock;
+        std::unordered_map<Key, Segment, KeyHash> m_segments;
+        std::atomic<uint32> m_lookups;
+        std::atomic<uint32> m_hits;
+};
+
+#endif
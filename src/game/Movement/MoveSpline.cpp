@@ -163,6 +163,7 @@ namespace Movement
 
     void MoveSpline::Initialize(const MoveSplineInitArgs& args)
     {
+        ++m_pathVersion;
         splineflags = args.flags;
         facing = args.facing;
         m_Id = args.splineId;
@@ -196,7 +197,8 @@ namespace Movement
     }
 
     MoveSpline::MoveSpline() : m_Id(0), speed(0), time_passed(0),
-        vertical_acceleration(0.f), initialOrientation(0.f), effect_start_time(0), point_Idx(0), point_Idx_offset(0)
+        vertical_acceleration(0.f), initialOrientation(0.f), effect_start_time(0), point_Idx(0), point_Idx_offset(0),
+        m_pathVersion(1), m_createPathVersion(0)
     {
         splineflags.done = true;
     }
@@ -22,6 +22,8 @@
 #include "spline.h"
 #include "MoveSplineInitArgs.h"
 
+#include <mutex>
+
 namespace Movement
 {
     extern float gravity;
@@ -60,6 +62,7 @@ namespace Movement
                 Result_NextSegment  = 0x08,
             };
             friend class PacketBuilder;
+            friend class MoveSplineBatch;
         protected:
             MySpline        spline;
 
@@ -81,6 +84,12 @@ namespace Movement
             int32           point_Idx;
             int32           point_Idx_offset;
 
+            // path part of the create block, the same for every observer until the next Initialize
+            uint32          m_pathVersion;
+            mutable uint32  m_createPathVersion;
+            mutable std::vector<uint8> m_createPath;
+            mutable std::mutex m_createPathLock;
+
             void init_spline(const MoveSplineInitArgs& args);
         protected:
 
@@ -0,0 +1,93 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MoveSplineBatch.h"
+#include "Entities/Unit.h"
+
+namespace Movement
+{
+    void MoveSplineBatch::Collect(std::vector<WorldObject*> const& objects)
+    {
+        m_owners.clear();
+        m_splines.clear();
+        m_segmentLeft.clear();
+        m_positionLeft.clear();
+
+        for (WorldObject* object : objects)
+        {
+            // players are updated on their own before the update lists are processed
+            if (object->GetTypeId() != TYPEID_UNIT || !object->IsInWorld())
+                continue;
+
+            Unit* unit = static_cast<Unit*>(object);
+            MoveSpline* spline = unit->movespline;
+            if (!spline->Initialized() || spline->Finalized())
+                continue;
+
+            m_owners.push_back(unit);
+            m_splines.push_back(spline);
+            m_segmentLeft.push_back(spline->segment_time_elapsed());
+            m_positionLeft.push_back(unit->m_movesplineTimer.GetExpiry());
+        }
+
+        size_t const count = m_splines.size();
+        m_crossing.resize(count);
+        m_positionDue.resize(count);
+        m_locations.resize(count);
+    }
+
+    void MoveSplineBatch::Process(std::vector<WorldObject*> const& objects, uint32 diff, uint32 generation)
+    {
+        Collect(objects);
+
+        size_t const count = m_splines.size();
+        if (!count)
+            return;
+
+        for (size_t i = 0; i < count; ++i)
+            m_crossing[i] = diff >= m_segmentLeft[i];
+
+        // staying inside the segment is all MoveSpline::_updateState would do, anything else takes the full path
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (m_crossing[i])
+                m_splines[i]->updateState(diff);
+            else
+                m_splines[i]->time_passed += diff;
+        }
+
+        // same condition as the position timer in Unit::UpdateSplineMovement
+        for (size_t i = 0; i < count; ++i)
+            m_positionDue[i] = m_positionLeft[i] <= diff || m_splines[i]->Finalized();
+
+        for (size_t i = 0; i < count; ++i)
+            if (m_positionDue[i])
+                m_locations[i] = m_splines[i]->ComputePosition();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            MoveSplineBatchResult& result = m_owners[i]->m_splineBatchResult;
+            result.generation = generation;
+            result.splineId = m_splines[i]->GetId();
+            result.arrived = m_splines[i]->Finalized();
+            result.positionDue = m_positionDue[i] != 0;
+            if (result.positionDue)
+                result.position = Position(m_locations[i].x, m_locations[i].y, m_locations[i].z, m_locations[i].orientation);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOSSERVER_MOVESPLINEBATCH_H
+#define MANGOSSERVER_MOVESPLINEBATCH_H
+
+#include "MoveSpline.h"
+
+#include <vector>
+
+class Unit;
+class WorldObject;
+
+namespace Movement
+{
+    // Steps the splines of all units of one update list in a single pass before the units are updated.
+    // Spline state is gathered into flat arrays so the common case, a spline staying inside its current
+    // segment, is a plain add over contiguous memory. Positions that are due are evaluated in the same pass,
+    // relocation and arrival handling are left to Unit::UpdateSplineMovement which picks up the result.
+    class MoveSplineBatch
+    {
+        public:
+            void Process(std::vector<WorldObject*> const& objects, uint32 diff, uint32 generation);
+
+            size_t GetLastCount() const { return m_splines.size(); }
+
+        private:
+            void Collect(std::vector<WorldObject*> const& objects);
+
+            std::vector<Unit*> m_owners;
+            std::vector<MoveSpline*> m_splines;
+            std::vector<uint32> m_segmentLeft;              // time until the current segment ends
+            std::vector<uint32> m_positionLeft;             // time until the owner's next position update
+            std::vector<uint8> m_crossing;                  // segment ends within this step, needs the full state update
+            std::vector<uint8> m_positionDue;
+            std::vector<Location> m_locations;
+    };
+}
+
+#endif // MANGOSSERVER_MOVESPLINEBATCH_H
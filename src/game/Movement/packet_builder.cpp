@@ -166,11 +166,26 @@ namespace Movement
             data << move_spline.vertical_acceleration;      // added in 3.1
             data << move_spline.effect_start_time;          // added in 3.1
 
+            WriteCreatePath(move_spline, data);
+        }
+    }
+
+    void PacketBuilder::WriteCreatePath(const MoveSpline& move_spline, ByteBuffer& data)
+    {
+        // serialized once per spline and shared by all observers, a new Initialize bumps the version
+        std::lock_guard<std::mutex> guard(move_spline.m_createPathLock);
+        if (move_spline.m_createPathVersion != move_spline.m_pathVersion)
+        {
             uint32 nodes = move_spline.getPath().size();
-            data << nodes;
-            data.append<Vector3>(&move_spline.getPath()[0], nodes);
-            data << uint8(move_spline.spline.mode());       // added in 3.1
-            data << (move_spline.isCyclic() ? Vector3::zero() : move_spline.FinalDestination());
+            ByteBuffer path(sizeof(uint32) + (nodes + 1) * sizeof(Vector3) + sizeof(uint8));
+            path << nodes;
+            path.append<Vector3>(&move_spline.getPath()[0], nodes);
+            path << uint8(move_spline.spline.mode());       // added in 3.1
+            path << (move_spline.isCyclic() ? Vector3::zero() : move_spline.FinalDestination());
+
+            move_spline.m_createPath.assign(path.contents(), path.contents() + path.size());
+            move_spline.m_createPathVersion = move_spline.m_pathVersion;
         }
+        data.append(move_spline.m_createPath.data(), move_spline.m_createPath.size());
     }
 }
@@ -28,6 +28,7 @@ namespace Movement
     class PacketBuilder
     {
             static void WriteCommonMonsterMovePart(const MoveSpline& move_spline, WorldPacket& data);
+            static void WriteCreatePath(const MoveSpline& move_spline, ByteBuffer& data);
         public:
 
             static void WriteMonsterMove(const MoveSpline& move_spline, WorldPacket& data);
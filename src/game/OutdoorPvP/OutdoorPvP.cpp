@@ -54,18 +54,50 @@ void OutdoorPvP::HandlePlayerLeaveZone(Player* player, bool isMainZone)
         if (isMainZone && !player->GetSession()->PlayerLogout())
             SendRemoveWorldStates(player);
 
-        sLog.outDebug("Player %s left an Outdoor PvP zone", player->GetName());
+        DEBUG_LOG("Player %s left an Outdoor PvP zone", player->GetName());
     }
 }
 
 /**
-   Function that updates the world state for all the players of the outdoor pvp zone
+   Function that queues a world state update for all the players of the outdoor pvp zone
 
    @param   world state to update
    @param   new world state value
  */
 void OutdoorPvP::SendUpdateWorldState(uint32 field, uint32 value)
 {
+    std::lock_guard<std::mutex> guard(m_worldStateLock);
+    m_pendingWorldStates[field] = value;
+}
+
+/**
+   Function that sends the queued world states which differ from the last sent values
+ */
+void OutdoorPvP::FlushWorldStateUpdates()
+{
+    std::map<uint32, uint32> pending;
+    {
+        std::lock_guard<std::mutex> guard(m_worldStateLock);
+        if (m_pendingWorldStates.empty())
+            return;
+        pending.swap(m_pendingWorldStates);
+    }
+
+    for (auto itr = pending.begin(); itr != pending.end();)
+    {
+        auto sent = m_sentWorldStates.find(itr->first);
+        if (sent != m_sentWorldStates.end() && sent->second == itr->second)
+            itr = pending.erase(itr);
+        else
+        {
+            m_sentWorldStates[itr->first] = itr->second;
+            ++itr;
+        }
+    }
+
+    if (pending.empty())
+        return;
+
     for (GuidZoneMap::const_iterator itr = m_zonePlayers.begin(); itr != m_zonePlayers.end(); ++itr)
     {
         // only send world state update to main zone
@@ -73,7 +105,8 @@ void OutdoorPvP::SendUpdateWorldState(uint32 field, uint32 value)
             continue;
 
         if (Player* player = sObjectMgr.GetPlayer(itr->first))
-            player->SendUpdateWorldState(field, value);
+            for (auto& state : pending)
+                player->SendUpdateWorldState(state.first, state.second);
     }
 }
 
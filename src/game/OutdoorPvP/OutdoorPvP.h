@@ -25,6 +25,8 @@
 #include "Globals/SharedDefines.h"
 #include "OutdoorPvPMgr.h"
 
+#include <mutex>
+
 class WorldPacket;
 
 enum CapturePointArtKits
@@ -88,9 +90,12 @@ class OutdoorPvP
         // applies buff to a team inside the specific zone
         void BuffTeam(Team team, uint32 spellId, bool remove = false, const uint32 areaId = 0);
 
-        // send world state update to all players present
+        // queue world state update for all players present, sent by FlushWorldStateUpdates
         void SendUpdateWorldState(uint32 field, uint32 value);
 
+        // send the world states changed since the last flush, once per world tick
+        void FlushWorldStateUpdates();
+
         // set banner visual
         void SetBannerVisual(const WorldObject* objRef, ObjectGuid goGuid, uint32 artKit, uint32 animId);
         void SetBannerVisual(GameObject* go, uint32 artKit, uint32 animId);
@@ -133,6 +138,12 @@ class OutdoorPvP
         GuidZoneMap m_zonePlayers;
 
         bool m_isBattlefield;
+
+    private:
+        // capture point events queue world states from map threads
+        std::mutex m_worldStateLock;
+        std::map<uint32, uint32> m_pendingWorldStates;
+        std::map<uint32, uint32> m_sentWorldStates;
 };
 
 #endif
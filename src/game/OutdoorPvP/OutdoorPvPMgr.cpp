@@ -195,6 +195,11 @@ void OutdoorPvPMgr::HandlePlayerLeaveArea(Player* player, uint32 zoneId, uint32
 
 void OutdoorPvPMgr::Update(uint32 diff)
 {
+    // world states changed by the previous map updates go out once per tick
+    for (auto& m_script : m_scripts)
+        if (m_script)
+            m_script->FlushWorldStateUpdates();
+
     m_updateTimer.Update(diff);
     if (!m_updateTimer.Passed())
         return;
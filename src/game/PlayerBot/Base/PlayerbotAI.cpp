@@ -17,6 +17,7 @@
  */
 
 #include <stdarg.h>
+#include <chrono>
 #include "Common.h"
 #include "Log.h"
 #include "Server/WorldPacket.h"
@@ -88,7 +89,7 @@ class PlayerbotChatHandler : protected ChatHandler
 };
 
 PlayerbotAI::PlayerbotAI(PlayerbotMgr &mgr, Player* const bot, bool debugWhisper) :
-    m_mgr(mgr), m_bot(bot), m_classAI(0), m_ignoreAIUpdatesUntilTime(CurrentTime()),
+    m_mgr(mgr), m_bot(bot), m_classAI(0), m_ignoreAIUpdatesUntilTime(CurrentTime()), m_thinkTimer(0), m_updateBudgetRound(0),
     m_combatOrder(ORDERS_NONE), m_ScenarioType(SCENARIO_PVE),
     m_CurrentlyCastingSpellId(0), m_CraftSpellId(0), m_spellIdCommand(0),
     m_targetGuidCommand(ObjectGuid()),
@@ -4417,8 +4418,9 @@ void PlayerbotAI::UpdateAttackerInfo()
             continue;
         Unit* a = itr->second.attacker;
         float t = 0.00;
-        std::list<HostileReference*>::const_iterator i = a->getThreatManager().getThreatList().begin();
-        for (; i != a->getThreatManager().getThreatList().end(); ++i)
+        ThreatList const threatList = a->getThreatManager().getThreatList();
+        ThreatList::const_iterator i = threatList.begin();
+        for (; i != threatList.end(); ++i)
         {
             if ((*i)->getThreat() > t && (*i)->getTarget() != m_bot)
                 t = (*i)->getThreat();
@@ -5025,7 +5027,40 @@ void PlayerbotAI::Announce(AnnounceFlags msg)
 // hasUnitState(FLAG) FLAG like: UNIT_STAT_ROOT, UNIT_STAT_CONFUSED, UNIT_STAT_STUNNED
 // hasAuraType
 
-void PlayerbotAI::UpdateAI(const uint32 /*p_time*/)
+void PlayerbotAI::UpdateAI(const uint32 p_time)
+{
+    if (m_thinkTimer > p_time)
+    {
+        m_thinkTimer -= p_time;
+        return;
+    }
+    m_thinkTimer = 0;
+
+    // over budget bots retry next tick with their timer expired
+    Map* map = m_bot->GetMap();
+    if (!map->GetPlayerbotUpdateBudget().Acquire(map->GetUpdateGeneration(), m_updateBudgetRound, m_mgr.m_confUpdateBudget))
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+    Think();
+    map->GetPlayerbotUpdateBudget().Release(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+    // until then the bot keeps following its last decision, movement and melee go on
+    m_thinkTimer = GetThinkInterval();
+}
+
+uint32 PlayerbotAI::GetThinkInterval() const
+{
+    if (m_botState == BOTSTATE_COMBAT || m_bot->IsInCombat())
+        return m_mgr.m_confThinkInterval[PlayerbotMgr::THINK_COMBAT];
+
+    if (m_bot->GetMotionMaster()->GetCurrentMovementGeneratorType() == FOLLOW_MOTION_TYPE)
+        return m_mgr.m_confThinkInterval[PlayerbotMgr::THINK_FOLLOWING];
+
+    return m_mgr.m_confThinkInterval[PlayerbotMgr::THINK_IDLE];
+}
+
+void PlayerbotAI::Think()
 {
     if (GetClassAI()->GetWaitUntil() <= CurrentTime())
         GetClassAI()->ClearWait();
@@ -6075,7 +6110,7 @@ bool PlayerbotAI::PickPocket(Unit* pTarget)
         }
 
         if (!loot->AutoStore(m_bot, false, NULL_BAG, NULL_SLOT))
-            sLog.outDebug("PLAYERBOT Debug: Failed to get loot from pickpocketed NPC");
+            DEBUG_LOG("PLAYERBOT Debug: Failed to get loot from pickpocketed NPC");
 
         // release the loot whatever happened
         loot->Release(m_bot);
@@ -9927,6 +9962,7 @@ void PlayerbotAI::_HandleCommandMail(std::string& text, Player& fromPlayer)
                     if ((*itr)->subject != "")
                         msg << "Subject: " << (*itr)->subject << "\n";
 
+                    m_bot->LoadMailBody(*itr);
                     if ((*itr)->body != "")
                         msg << (*itr)->body << "\n";
                     break;
@@ -9940,6 +9976,7 @@ void PlayerbotAI::_HandleCommandMail(std::string& text, Player& fromPlayer)
                 case MAIL_AUCTION:
                 {
                     msg << "|cffccffff"; // blue
+                    m_bot->LoadMailBody(*itr);
                     msg << AuctionResult((*itr)->subject, (*itr)->body) << "\n";
                     break;
                 }
@@ -9951,6 +9988,7 @@ void PlayerbotAI::_HandleCommandMail(std::string& text, Player& fromPlayer)
             if ((*itr)->money)
                 msg << "[To Collect: " << Cash((*itr)->money) << " ]\n";
 
+            m_bot->LoadMailItems(*itr);
             uint8 item_count = (*itr)->items.size(); // max count is MAX_MAIL_ITEMS (12)
             if (item_count > 0)
             {
@@ -10036,6 +10074,7 @@ void PlayerbotAI::_HandleCommandMail(std::string& text, Player& fromPlayer)
                 return;
             }
 
+            m_bot->LoadMailItems(m);
             if (m->HasItems())
             {
                 bool has_items = true;
@@ -2069,6 +2069,10 @@ class PlayerbotAI
         // Helper routines not needed by class AIs.
         void UpdateAttackersForTarget(Unit* victim);
 
+        // one AI decision, UpdateAI gates it by think interval and the map update budget
+        void Think();
+        uint32 GetThinkInterval() const;
+
         void _doSellItem(Item* const item, std::ostringstream& report, std::ostringstream& canSell, uint32& TotalCost, uint32& TotalSold);
         void MakeItemLink(const Item* item, std::ostringstream& out, bool IncludeQuantity = true);
         void MakeItemText(const Item* item, std::ostringstream& out, bool IncludeQuantity = true);
@@ -2083,6 +2087,8 @@ class PlayerbotAI
         // ignores AI updates until time specified
         // no need to waste CPU cycles during casting etc
         time_t m_ignoreAIUpdatesUntilTime;
+        uint32 m_thinkTimer;                    // (msecs) until the next decision may be taken
+        uint32 m_updateBudgetRound;             // last PlayerbotUpdateBudget round this bot thought in
 
         CombatStyle m_combatStyle;
         CombatOrderType m_combatOrder;
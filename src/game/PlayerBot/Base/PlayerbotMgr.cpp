@@ -38,6 +38,13 @@ class CharacterHandler;
 
 Config botConfig;
 
+ConfigHandle<bool> botConfDisableBots("PlayerbotAI.DisableBots", false);
+ConfigHandle<bool> botConfSellGarbage("PlayerbotAI.SellGarbage", true);
+ConfigHandle<int32> botConfBotguyCost("PlayerbotAI.BotguyCost", 0);
+ConfigHandle<std::string> botConfBotguyQuests("PlayerbotAI.BotguyQuests", "");
+ConfigHandle<int32> botConfMaxNumBots("PlayerbotAI.MaxNumBots", 9);
+ConfigHandle<int32> botConfRestrictBotLevel("PlayerbotAI.RestrictBotLevel", 80);
+
 void PlayerbotMgr::SetInitialWorldSettings()
 {
     //Get playerbot configuration file
@@ -49,6 +56,19 @@ void PlayerbotMgr::SetInitialWorldSettings()
     //Check playerbot config file version
     if (botConfig.GetIntDefault("ConfVersion", 0) != PLAYERBOT_CONF_VERSION)
         sLog.outError("Playerbot: Configuration file version doesn't match expected version. Some config variables may be wrong or missing.");
+
+    botConfig.Register(botConfDisableBots);
+    botConfig.Register(botConfSellGarbage);
+    botConfig.Register(botConfBotguyCost);
+    botConfig.Register(botConfBotguyQuests);
+    botConfig.Register(botConfMaxNumBots);
+    botConfig.Register(botConfRestrictBotLevel);
+}
+
+void PlayerbotMgr::ReloadConfig()
+{
+    if (!botConfig.Reload())
+        sLog.outError("Playerbot: Unable to reload configuration file %s.", botConfig.GetFilename().c_str());
 }
 
 PlayerbotMgr::PlayerbotMgr(Player* const master) : m_master(master)
@@ -71,6 +91,10 @@ PlayerbotMgr::PlayerbotMgr(Player* const master) : m_master(master)
         sLog.outError("Playerbot: PlayerbotAI.Collect.DistanceMax higher than allowed. Using 100");
         m_confCollectDistanceMax = 100;
     }
+    m_confThinkInterval[THINK_IDLE] = botConfig.GetIntDefault("PlayerbotAI.ThinkInterval.Idle", 1000);
+    m_confThinkInterval[THINK_FOLLOWING] = botConfig.GetIntDefault("PlayerbotAI.ThinkInterval.Following", 500);
+    m_confThinkInterval[THINK_COMBAT] = botConfig.GetIntDefault("PlayerbotAI.ThinkInterval.Combat", 200);
+    m_confUpdateBudget = botConfig.GetIntDefault("PlayerbotAI.UpdateBudget", 10000);
     m_confCollectDistance = botConfig.GetIntDefault("PlayerbotAI.Collect.Distance", 25);
     if (m_confCollectDistance > m_confCollectDistanceMax)
     {
@@ -643,7 +667,7 @@ void PlayerbotMgr::HandleMasterIncomingPacket(const WorldPacket& packet)
                         case GOSSIP_OPTION_VENDOR:
                         {
                             // bot->GetPlayerbotAI()->TellMaster("PlayerbotMgr:GOSSIP_OPTION_VENDOR");
-                            if (!botConfig.GetBoolDefault("PlayerbotAI.SellGarbage", true))
+                            if (!botConfSellGarbage.Get())
                                 continue;
 
                             // changed the SellGarbage() function to support ch.SendSysMessaage()
@@ -691,7 +715,7 @@ void PlayerbotMgr::HandleMasterIncomingPacket(const WorldPacket& packet)
 
         case CMSG_LIST_INVENTORY:
         {
-            if (!botConfig.GetBoolDefault("PlayerbotAI.SellGarbage", true))
+            if (!botConfSellGarbage.Get())
                 return;
 
             WorldPacket p(packet);
@@ -1197,7 +1221,7 @@ bool ChatHandler::HandlePlayerbotCommand(char* args)
 {
     if (!(m_session->GetSecurity() > SEC_PLAYER))
     {
-        if (botConfig.GetBoolDefault("PlayerbotAI.DisableBots", false))
+        if (botConfDisableBots.Get())
         {
             PSendSysMessage("|cffff0000Playerbot system is currently disabled!");
             SetSentErrorMessage(true);
@@ -1278,7 +1302,7 @@ bool ChatHandler::HandlePlayerbotCommand(char* args)
     {
         Field* fields = resultchar->Fetch();
         int acctcharcount = fields[0].GetUInt32();
-        int maxnum = botConfig.GetIntDefault("PlayerbotAI.MaxNumBots", 9);
+        int maxnum = botConfMaxNumBots.Get();
         if (!(m_session->GetSecurity() > SEC_PLAYER))
             if (acctcharcount > maxnum && (cmdStr == "add" || cmdStr == "login"))
             {
@@ -1295,7 +1319,7 @@ bool ChatHandler::HandlePlayerbotCommand(char* args)
     {
         Field* fields = resultlvl->Fetch();
         int charlvl = fields[0].GetUInt32();
-        int maxlvl = botConfig.GetIntDefault("PlayerbotAI.RestrictBotLevel", 80);
+        int maxlvl = botConfRestrictBotLevel.Get();
         uint8 race = fields[2].GetUInt8();
         uint8 charclass = fields[3].GetUInt8();
         uint32 mapid = fields[4].GetUInt32();
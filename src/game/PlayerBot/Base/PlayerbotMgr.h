@@ -20,6 +20,7 @@
 #define _PLAYERBOTMGR_H
 
 #include "Common.h"
+#include "Config/Config.h"
 
 class WorldPacket;
 class Player;
@@ -30,11 +31,20 @@ class PlayerbotClassAI;
 
 typedef std::unordered_map<ObjectGuid, Player*> PlayerBotMap;
 
+// playerbot settings read on live events, parsed by botConfig on load and reload
+extern ConfigHandle<bool> botConfDisableBots;
+extern ConfigHandle<bool> botConfSellGarbage;
+extern ConfigHandle<int32> botConfBotguyCost;
+extern ConfigHandle<std::string> botConfBotguyQuests;
+extern ConfigHandle<int32> botConfMaxNumBots;
+extern ConfigHandle<int32> botConfRestrictBotLevel;
+
 class PlayerbotMgr
 {
         // static functions, available without a PlayerbotMgr instance
     public:
         static void SetInitialWorldSettings();
+        static void ReloadConfig();
 
     public:
         PlayerbotMgr(Player* const master);
@@ -69,6 +79,14 @@ class PlayerbotMgr
         void Stay();
 
     public:
+        enum ThinkState
+        {
+            THINK_IDLE,
+            THINK_FOLLOWING,
+            THINK_COMBAT,
+            MAX_THINK_STATE
+        };
+
         // config variables
         uint32 m_confRestrictBotLevel;
         uint32 m_confDisableBotsInRealm;
@@ -85,6 +103,8 @@ class PlayerbotMgr
         bool m_confCollectObjects;
         uint32 m_confCollectDistance;
         uint32 m_confCollectDistanceMax;
+        uint32 m_confThinkInterval[MAX_THINK_STATE];        // (msecs) minimum time between two bot decisions
+        uint32 m_confUpdateBudget;                          // (usecs) bot AI time per map tick, 0 for no limit
 
     private:
         Player* const m_master;
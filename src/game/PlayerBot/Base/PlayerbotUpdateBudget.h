@@ -0,0 +1,79 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _PLAYERBOTUPDATEBUDGET_H
+#define _PLAYERBOTUPDATEBUDGET_H
+
+#include "Platform/Define.h"
+
+// Shares a per tick CPU budget between the bots of one map.
+// Bots only think once per round; a round ends with the first tick in which no
+// bot had to be deferred, so bots skipped for the budget go first next tick.
+class PlayerbotUpdateBudget
+{
+    public:
+        PlayerbotUpdateBudget() : m_generation(0), m_round(1), m_spent(0), m_runs(0), m_deferred(0) {}
+
+        // generation identifies the map tick, servedRound is kept by the bot
+        bool Acquire(uint32 generation, uint32& servedRound, uint64 budget)
+        {
+            BeginTick(generation);
+            if (servedRound == m_round)
+                return false;
+
+            if (budget && m_spent >= budget)
+            {
+                ++m_deferred;
+                return false;
+            }
+
+            servedRound = m_round;
+            ++m_runs;
+            return true;
+        }
+
+        void Release(uint64 elapsed) { m_spent += elapsed; }
+
+        // cost of the given tick, microseconds
+        uint64 GetSpent(uint32 generation) const { return generation == m_generation ? m_spent : 0; }
+        uint32 GetRuns(uint32 generation) const { return generation == m_generation ? m_runs : 0; }
+        uint32 GetDeferred(uint32 generation) const { return generation == m_generation ? m_deferred : 0; }
+
+    private:
+        void BeginTick(uint32 generation)
+        {
+            if (generation == m_generation)
+                return;
+
+            if (!m_deferred)
+                ++m_round;
+
+            m_generation = generation;
+            m_spent = 0;
+            m_runs = 0;
+            m_deferred = 0;
+        }
+
+        uint32 m_generation;
+        uint32 m_round;
+        uint64 m_spent;
+        uint32 m_runs;
+        uint32 m_deferred;
+};
+
+#endif
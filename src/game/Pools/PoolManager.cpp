@@ -31,80 +31,135 @@ INSTANTIATE_SINGLETON_1(PoolManager);
 ////////////////////////////////////////////////////////////
 // template class SpawnedPoolData
 
-// Method that tell amount spawned objects/subpools
-uint32 SpawnedPoolData::GetSpawnedObjects(uint32 pool_id) const
+void SpawnedPoolData::SetBit(std::vector<bool>& bits, uint32 index, bool value)
 {
-    SpawnedPoolPools::const_iterator itr = mSpawnedPools.find(pool_id);
-    return itr != mSpawnedPools.end() ? itr->second : 0;
+    if (index >= bits.size())
+    {
+        if (!value)
+            return;
+        bits.resize(index + 1, false);
+    }
+    bits[index] = value;
+}
+
+void SpawnedPoolData::ChangeSpawnedCount(uint32 pool_id, bool add)
+{
+    if (pool_id >= m_spawnedCounts.size())
+        m_spawnedCounts.resize(pool_id + 1, 0);
+
+    SetBit(m_spawnedPools, pool_id, true);
+    uint32& val = m_spawnedCounts[pool_id];
+    if (add)
+        ++val;
+    else if (val > 0)
+        --val;
 }
 
 // Method that tell if a creature is spawned currently
 template<>
 bool SpawnedPoolData::IsSpawnedObject<Creature>(uint32 db_guid) const
 {
-    return mSpawnedCreatures.find(db_guid) != mSpawnedCreatures.end();
+    uint32 index;
+    return sPoolMgr.GetSpawnIndex<Creature>(db_guid, index) && TestBit(m_spawnedCreatures, index);
 }
 
 // Method that tell if a gameobject is spawned currently
 template<>
 bool SpawnedPoolData::IsSpawnedObject<GameObject>(uint32 db_guid) const
 {
-    return mSpawnedGameobjects.find(db_guid) != mSpawnedGameobjects.end();
+    uint32 index;
+    return sPoolMgr.GetSpawnIndex<GameObject>(db_guid, index) && TestBit(m_spawnedGameobjects, index);
 }
 
 // Method that tell if a pool is spawned currently
 template<>
 bool SpawnedPoolData::IsSpawnedObject<Pool>(uint32 sub_pool_id) const
 {
-    return mSpawnedPools.find(sub_pool_id) != mSpawnedPools.end();
+    return TestBit(m_spawnedPools, sub_pool_id);
 }
 
 template<>
-void SpawnedPoolData::AddSpawn<Creature>(uint32 db_guid, uint32 pool_id)
+bool SpawnedPoolData::IsSpawnedMember<Creature>(PoolObject const& obj) const
 {
-    mSpawnedCreatures.insert(db_guid);
-    ++mSpawnedPools[pool_id];
+    return TestBit(m_spawnedCreatures, obj.spawnIndex);
 }
 
 template<>
-void SpawnedPoolData::AddSpawn<GameObject>(uint32 db_guid, uint32 pool_id)
+bool SpawnedPoolData::IsSpawnedMember<GameObject>(PoolObject const& obj) const
 {
-    mSpawnedGameobjects.insert(db_guid);
-    ++mSpawnedPools[pool_id];
+    return TestBit(m_spawnedGameobjects, obj.spawnIndex);
 }
 
 template<>
-void SpawnedPoolData::AddSpawn<Pool>(uint32 sub_pool_id, uint32 pool_id)
+bool SpawnedPoolData::IsSpawnedMember<Pool>(PoolObject const& obj) const
 {
-    mSpawnedPools[sub_pool_id] = 0;
-    ++mSpawnedPools[pool_id];
+    return TestBit(m_spawnedPools, obj.spawnIndex);
 }
 
 template<>
-void SpawnedPoolData::RemoveSpawn<Creature>(uint32 db_guid, uint32 pool_id)
+void SpawnedPoolData::AddSpawn<Creature>(PoolObject const& obj, uint32 pool_id)
 {
-    mSpawnedCreatures.erase(db_guid);
-    uint32& val = mSpawnedPools[pool_id];
-    if (val > 0)
-        --val;
+    SetBit(m_spawnedCreatures, obj.spawnIndex, true);
+    ChangeSpawnedCount(pool_id, true);
 }
 
 template<>
-void SpawnedPoolData::RemoveSpawn<GameObject>(uint32 db_guid, uint32 pool_id)
+void SpawnedPoolData::AddSpawn<GameObject>(PoolObject const& obj, uint32 pool_id)
 {
-    mSpawnedGameobjects.erase(db_guid);
-    uint32& val = mSpawnedPools[pool_id];
-    if (val > 0)
-        --val;
+    SetBit(m_spawnedGameobjects, obj.spawnIndex, true);
+    ChangeSpawnedCount(pool_id, true);
 }
 
 template<>
-void SpawnedPoolData::RemoveSpawn<Pool>(uint32 sub_pool_id, uint32 pool_id)
+void SpawnedPoolData::AddSpawn<Pool>(PoolObject const& obj, uint32 pool_id)
 {
-    mSpawnedPools.erase(sub_pool_id);
-    uint32& val = mSpawnedPools[pool_id];
-    if (val > 0)
-        --val;
+    SetBit(m_spawnedPools, obj.spawnIndex, true);
+    if (obj.spawnIndex < m_spawnedCounts.size())
+        m_spawnedCounts[obj.spawnIndex] = 0;
+    ChangeSpawnedCount(pool_id, true);
+}
+
+template<>
+void SpawnedPoolData::RemoveSpawn<Creature>(PoolObject const& obj, uint32 pool_id)
+{
+    SetBit(m_spawnedCreatures, obj.spawnIndex, false);
+    ChangeSpawnedCount(pool_id, false);
+}
+
+template<>
+void SpawnedPoolData::RemoveSpawn<GameObject>(PoolObject const& obj, uint32 pool_id)
+{
+    SetBit(m_spawnedGameobjects, obj.spawnIndex, false);
+    ChangeSpawnedCount(pool_id, false);
+}
+
+template<>
+void SpawnedPoolData::RemoveSpawn<Pool>(PoolObject const& obj, uint32 pool_id)
+{
+    SetBit(m_spawnedPools, obj.spawnIndex, false);
+    if (obj.spawnIndex < m_spawnedCounts.size())
+        m_spawnedCounts[obj.spawnIndex] = 0;
+    ChangeSpawnedCount(pool_id, false);
+}
+
+SpawnedPoolObjects SpawnedPoolData::GetSpawnedCreatures() const
+{
+    std::vector<uint32> const& guids = sPoolMgr.GetSpawnIndexGuids<Creature>();
+    SpawnedPoolObjects spawned;
+    for (uint32 i = 0; i < m_spawnedCreatures.size() && i < guids.size(); ++i)
+        if (m_spawnedCreatures[i])
+            spawned.push_back(guids[i]);
+    return spawned;
+}
+
+SpawnedPoolObjects SpawnedPoolData::GetSpawnedGameobjects() const
+{
+    std::vector<uint32> const& guids = sPoolMgr.GetSpawnIndexGuids<GameObject>();
+    SpawnedPoolObjects spawned;
+    for (uint32 i = 0; i < m_spawnedGameobjects.size() && i < guids.size(); ++i)
+        if (m_spawnedGameobjects[i])
+            spawned.push_back(guids[i]);
+    return spawned;
 }
 
 ////////////////////////////////////////////////////////////
@@ -192,77 +247,179 @@ void PoolGroup<T>::SetExcludeObject(uint32 guid, bool state)
     }
 }
 
+// Builds an alias table over the explicitly chanced objects, so a roll picks one of them or misses
+// them all in constant time. Chances summing above 100 are scaled down to share the whole roll.
 template <class T>
-PoolObject* PoolGroup<T>::RollOne(SpawnedPoolData& spawns, uint32 triggerFrom, MapPersistentState& mapState)
+void PoolGroup<T>::Compile()
 {
-    PoolObject* explicitlyObjFound = nullptr;
-    auto gen = GetRandomGenerator();
+    AliasChance.clear();
+    Alias.clear();
+    if (ExplicitlyChanced.empty())
+        return;
 
-    if (!ExplicitlyChanced.empty())
-    {
-        float roll = (float)rand_chance();
+    float total = 0.0f;
+    for (PoolObject const& obj : ExplicitlyChanced)
+        total += obj.chance;
+    float const scale = std::max(total, 100.0f);
 
-        std::vector <PoolObject*> explicitlyChancedVector;
+    uint32 const outcomes = ExplicitlyChanced.size() + 1;   // the last one misses all objects
+    std::vector<float> scaled(outcomes);
+    for (uint32 i = 0; i < ExplicitlyChanced.size(); ++i)
+        scaled[i] = ExplicitlyChanced[i].chance * outcomes / scale;
+    scaled[outcomes - 1] = (scale - total) * outcomes / scale;
 
-        // call memory manager once to reserve enough memory for performance
-        explicitlyChancedVector.reserve(ExplicitlyChanced.size());
+    AliasChance.assign(outcomes, 1.0f);                     // outcomes left over at the end are 1 up to rounding
+    Alias.resize(outcomes);
+    std::vector<uint32> small, large;
+    for (uint32 i = 0; i < outcomes; ++i)
+    {
+        Alias[i] = i;
+        (scaled[i] < 1.0f ? small : large).push_back(i);
+    }
 
-        // fill new vector with address of object in EqualChanced list
-        std::transform(ExplicitlyChanced.begin(), ExplicitlyChanced.end(), std::back_inserter(explicitlyChancedVector), [](PoolObject& objPtr) { return &objPtr; });
+    while (!small.empty() && !large.empty())
+    {
+        uint32 const less = small.back();
+        small.pop_back();
+        uint32 const more = large.back();
+        large.pop_back();
+
+        AliasChance[less] = scaled[less];
+        Alias[less] = more;
+        scaled[more] -= 1.0f - scaled[less];
+        (scaled[more] < 1.0f ? small : large).push_back(more);
+    }
+}
 
-        // randomize the new vector
-        std::shuffle(explicitlyChancedVector.begin(), explicitlyChancedVector.end(), *gen);
+template <class T>
+bool PoolGroup<T>::CanRoll(PoolObject* object, SpawnedPoolData& spawns, uint32 triggerFrom, MapPersistentState& mapState)
+{
+    if (object->exclude)
+        return false;
 
-        for (auto obj : explicitlyChancedVector)
-        {
-            if (obj->exclude)
-                continue;
+    if (object->guid != triggerFrom && spawns.IsSpawnedMember<T>(*object))
+        return false;
 
-            if (!CanSpawn(obj, mapState))
-                continue;
+    return CanSpawn(object, mapState);
+}
 
-            if (obj->guid != triggerFrom && spawns.IsSpawnedObject<T>(obj->guid))
-                continue;
+// Picks an explicitly chanced object with the configured chances. If the rolled one is excluded or already spawned
+// the roll is repeated over the available objects and the miss chance only.
+template <class T>
+PoolObject* PoolGroup<T>::RollExplicitlyChanced(SpawnedPoolData& spawns, uint32 triggerFrom, MapPersistentState& mapState, bool& missed)
+{
+    missed = false;
+    if (AliasChance.empty())
+        return nullptr;
+
+    uint32 const outcome = urand(0, AliasChance.size() - 1);
+    uint32 const index = rand_norm_f() < AliasChance[outcome] ? outcome : Alias[outcome];
+    if (index >= ExplicitlyChanced.size())
+    {
+        missed = true;
+        return nullptr;
+    }
 
-            // we found an object but it may have no luck to be picked so we save it in case of no other object have been picked.
-            if (!explicitlyObjFound)
-                explicitlyObjFound = obj;
+    PoolObject* obj = &ExplicitlyChanced[index];
+    if (CanRoll(obj, spawns, triggerFrom, mapState))
+        return obj;
 
-            if (roll < obj->chance)
-                return obj;
+    std::vector<PoolObject*> available;
+    float total = 0.0f;
+    float availableTotal = 0.0f;
+    for (PoolObject& candidate : ExplicitlyChanced)
+    {
+        total += candidate.chance;
+        if (CanRoll(&candidate, spawns, triggerFrom, mapState))
+        {
+            available.push_back(&candidate);
+            availableTotal += candidate.chance;
         }
     }
 
-    if (!EqualChanced.empty())
+    if (available.empty())
+        return nullptr;
+
+    float roll = rand_norm_f() * (availableTotal + std::max(100.0f - total, 0.0f));
+    for (PoolObject* candidate : available)
     {
-        std::vector <PoolObject*> equalyChancedVector;
+        if (roll < candidate->chance)
+            return candidate;
+        roll -= candidate->chance;
+    }
 
-        // call memory manager once to reserve enough memory for performance
-        equalyChancedVector.reserve(EqualChanced.size());
+    // the roll fell into the miss chance, or past the last object by rounding
+    missed = total < 100.0f;
+    return missed ? nullptr : available.back();
+}
 
-        // fill new vector with address of object in EqualChanced list
-        std::transform(EqualChanced.begin(), EqualChanced.end(), std::back_inserter(equalyChancedVector), [](PoolObject& objPtr) { return &objPtr; });
+template <class T>
+PoolObject* PoolGroup<T>::RollEqualChanced(SpawnedPoolData& spawns, uint32 triggerFrom, MapPersistentState& mapState)
+{
+    if (EqualChanced.empty())
+        return nullptr;
 
-        // randomize the new vector
-        std::shuffle(equalyChancedVector.begin(), equalyChancedVector.end(), *gen);
+    // usually most objects are available, a few blind picks avoid building the shuffled list below
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        PoolObject* obj = &EqualChanced[urand(0, EqualChanced.size() - 1)];
+        if (CanRoll(obj, spawns, triggerFrom, mapState))
+            return obj;
+    }
 
-        for (auto obj : equalyChancedVector)
-        {
-            if (obj->exclude)
-                continue;
+    std::vector<PoolObject*> equalyChancedVector;
 
-            if (!CanSpawn(obj, mapState))
-                continue;
+    // call memory manager once to reserve enough memory for performance
+    equalyChancedVector.reserve(EqualChanced.size());
 
-            if (obj->guid != triggerFrom && spawns.IsSpawnedObject<T>(obj->guid))
-                continue;
+    // fill new vector with address of object in EqualChanced list
+    std::transform(EqualChanced.begin(), EqualChanced.end(), std::back_inserter(equalyChancedVector), [](PoolObject& objPtr) { return &objPtr; });
 
+    // randomize the new vector
+    std::shuffle(equalyChancedVector.begin(), equalyChancedVector.end(), *GetRandomGenerator());
+
+    for (auto obj : equalyChancedVector)
+        if (CanRoll(obj, spawns, triggerFrom, mapState))
             return obj;
-        }
-    }
 
-    // return first explicitly chanced object if there is one
-    return explicitlyObjFound;
+    return nullptr;
+}
+
+// Picks up to count different equally chanced objects at once, for filling a pool after many of its objects despawned
+template <class T>
+void PoolGroup<T>::RollEqualChanced(SpawnedPoolData& spawns, MapPersistentState& mapState, uint32 count, std::vector<PoolObject*>& result)
+{
+    for (PoolObject& obj : EqualChanced)
+        if (CanRoll(&obj, spawns, 0, mapState))
+            result.push_back(&obj);
+
+    // partial Fisher-Yates, only the first count picks are needed
+    uint32 const picks = std::min<uint32>(count, result.size());
+    for (uint32 i = 0; i < picks; ++i)
+        std::swap(result[i], result[urand(i, result.size() - 1)]);
+    result.resize(picks);
+}
+
+template <class T>
+PoolObject* PoolGroup<T>::RollOne(SpawnedPoolData& spawns, uint32 triggerFrom, MapPersistentState& mapState)
+{
+    bool missed;
+    if (PoolObject* obj = RollExplicitlyChanced(spawns, triggerFrom, mapState, missed))
+        return obj;
+
+    if (PoolObject* obj = RollEqualChanced(spawns, triggerFrom, mapState))
+        return obj;
+
+    if (!missed)
+        return nullptr;
+
+    // the roll missed all explicitly chanced objects and there is no equally chanced one to take instead
+    std::vector<PoolObject*> available;
+    for (PoolObject& obj : ExplicitlyChanced)
+        if (CanRoll(&obj, spawns, triggerFrom, mapState))
+            available.push_back(&obj);
+
+    return available.empty() ? nullptr : available[urand(0, available.size() - 1)];
 }
 
 // Main method to despawn a creature or gameobject in a pool
@@ -271,31 +428,25 @@ PoolObject* PoolGroup<T>::RollOne(SpawnedPoolData& spawns, uint32 triggerFrom, M
 template<class T>
 void PoolGroup<T>::DespawnObject(MapPersistentState& mapState, uint32 guid)
 {
-    for (size_t i = 0; i < EqualChanced.size(); ++i)
+    SpawnedPoolData& spawns = mapState.GetSpawnedPoolData();
+
+    for (PoolObject& obj : EqualChanced)
     {
-        // if spawned
-        if (mapState.GetSpawnedPoolData().IsSpawnedObject<T>(EqualChanced[i].guid))
+        // any or specially requested, if spawned
+        if ((!guid || obj.guid == guid) && spawns.IsSpawnedMember<T>(obj))
         {
-            // any or specially requested
-            if (!guid || EqualChanced[i].guid == guid)
-            {
-                Despawn1Object(mapState, EqualChanced[i].guid);
-                mapState.GetSpawnedPoolData().RemoveSpawn<T>(EqualChanced[i].guid, poolId);
-            }
+            Despawn1Object(mapState, obj.guid);
+            spawns.RemoveSpawn<T>(obj, poolId);
         }
     }
 
-    for (size_t i = 0; i < ExplicitlyChanced.size(); ++i)
+    for (PoolObject& obj : ExplicitlyChanced)
     {
-        // spawned
-        if (mapState.GetSpawnedPoolData().IsSpawnedObject<T>(ExplicitlyChanced[i].guid))
+        // any or specially requested, if spawned
+        if ((!guid || obj.guid == guid) && spawns.IsSpawnedMember<T>(obj))
         {
-            // any or specially requested
-            if (!guid || ExplicitlyChanced[i].guid == guid)
-            {
-                Despawn1Object(mapState, ExplicitlyChanced[i].guid);
-                mapState.GetSpawnedPoolData().RemoveSpawn<T>(ExplicitlyChanced[i].guid, poolId);
-            }
+            Despawn1Object(mapState, obj.guid);
+            spawns.RemoveSpawn<T>(obj, poolId);
         }
     }
 }
@@ -406,6 +557,23 @@ void PoolGroup<T>::SpawnObject(MapPersistentState& mapState, uint32 limit, uint3
             triggerFrom = 0;
     }
 
+    // Many objects to spawn without explicit chances, e.g. at pool init or after a mass despawn: pick them in one pass
+    if (!triggerFrom && count > 1 && ExplicitlyChanced.empty())
+    {
+        std::vector<PoolObject*> rolled;
+        RollEqualChanced(spawns, mapState, count, rolled);
+        for (PoolObject* obj : rolled)
+        {
+            // spawning the previous picks can block a later one
+            if (!CanSpawn(obj, mapState))
+                continue;
+
+            spawns.AddSpawn<T>(*obj, poolId);
+            Spawn1Object(mapState, obj, instantly);
+        }
+        return;
+    }
+
     // This will try to spawn the rest of pool, not guaranteed
     for (int i = 0; i < count; ++i)
     {
@@ -424,7 +592,7 @@ void PoolGroup<T>::SpawnObject(MapPersistentState& mapState, uint32 limit, uint3
             continue;
         }
 
-        spawns.AddSpawn<T>(obj->guid, poolId);
+        spawns.AddSpawn<T>(*obj, poolId);
         Spawn1Object(mapState, obj, instantly);
 
         if (triggerFrom)
@@ -653,6 +821,7 @@ void PoolManager::LoadFromDB()
 
     mPoolCreatureGroups.resize(max_pool_id + 1);
     mCreatureSearchMap.clear();
+    mCreatureGuids.clear();
     //                                   1     2           3
     result = WorldDatabase.Query("SELECT guid, pool_entry, chance FROM pool_creature");
 
@@ -705,9 +874,11 @@ void PoolManager::LoadFromDB()
             PoolObject plObject(guid, chance);
             PoolGroup<Creature>& cregroup = mPoolCreatureGroups[pool_id];
             cregroup.SetPoolId(pool_id);
+            plObject.spawnIndex = mCreatureGuids.size();
+            mCreatureGuids.push_back(guid);
             cregroup.AddEntry(plObject, pPoolTemplate->MaxLimit);
-            SearchPair p(guid, pool_id);
-            mCreatureSearchMap.insert(p);
+            PoolMember member = { pool_id, plObject.spawnIndex };
+            mCreatureSearchMap[guid] = member;
         }
         while (result->NextRow());
         sLog.outString();
@@ -777,9 +948,11 @@ void PoolManager::LoadFromDB()
             PoolObject plObject(guid, chance);
             PoolGroup<Creature>& cregroup = mPoolCreatureGroups[pool_id];
             cregroup.SetPoolId(pool_id);
+            plObject.spawnIndex = mCreatureGuids.size();
+            mCreatureGuids.push_back(guid);
             cregroup.AddEntry(plObject, pPoolTemplate->MaxLimit);
-            SearchPair p(guid, pool_id);
-            mCreatureSearchMap.insert(p);
+            PoolMember member = { pool_id, plObject.spawnIndex };
+            mCreatureSearchMap[guid] = member;
         }
         while (result->NextRow());
         sLog.outString();
@@ -791,6 +964,7 @@ void PoolManager::LoadFromDB()
 
     mPoolGameobjectGroups.resize(max_pool_id + 1);
     mGameobjectSearchMap.clear();
+    mGameobjectGuids.clear();
     //                                   1     2           3
     result = WorldDatabase.Query("SELECT guid, pool_entry, chance FROM pool_gameobject");
 
@@ -843,9 +1017,11 @@ void PoolManager::LoadFromDB()
             PoolObject plObject(guid, chance);
             PoolGroup<GameObject>& gogroup = mPoolGameobjectGroups[pool_id];
             gogroup.SetPoolId(pool_id);
+            plObject.spawnIndex = mGameobjectGuids.size();
+            mGameobjectGuids.push_back(guid);
             gogroup.AddEntry(plObject, pPoolTemplate->MaxLimit);
-            SearchPair p(guid, pool_id);
-            mGameobjectSearchMap.insert(p);
+            PoolMember member = { pool_id, plObject.spawnIndex };
+            mGameobjectSearchMap[guid] = member;
         }
         while (result->NextRow());
         sLog.outString();
@@ -916,9 +1092,11 @@ void PoolManager::LoadFromDB()
             PoolObject plObject = PoolObject(guid, chance);
             PoolGroup<GameObject>& gogroup = mPoolGameobjectGroups[pool_id];
             gogroup.SetPoolId(pool_id);
+            plObject.spawnIndex = mGameobjectGuids.size();
+            mGameobjectGuids.push_back(guid);
             gogroup.AddEntry(plObject, pPoolTemplate->MaxLimit);
-            SearchPair p(guid, pool_id);
-            mGameobjectSearchMap.insert(p);
+            PoolMember member = { pool_id, plObject.spawnIndex };
+            mGameobjectSearchMap[guid] = member;
         }
         while (result->NextRow());
         sLog.outString();
@@ -1034,6 +1212,13 @@ void PoolManager::LoadFromDB()
     // check chances integrity
     for (uint16 pool_entry = 0; pool_entry < mPoolTemplate.size(); ++pool_entry)
     {
+        if (pool_entry <= max_pool_id)
+        {
+            mPoolCreatureGroups[pool_entry].Compile();
+            mPoolGameobjectGroups[pool_entry].Compile();
+            mPoolPoolGroups[pool_entry].Compile();
+        }
+
         auto& poolTemplate = mPoolTemplate[pool_entry];
         if (poolTemplate.AutoSpawn)
         {
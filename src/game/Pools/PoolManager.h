@@ -50,8 +50,9 @@ struct PoolObject
     uint32  guid;
     float   chance;
     bool exclude;
+    uint32  spawnIndex;                                     // dense index over all pooled creatures or gameobjects, pool id for pools
 
-    PoolObject(uint32 _guid, float _chance): guid(_guid), chance(fabs(_chance)), exclude(false) {}
+    PoolObject(uint32 _guid, float _chance): guid(_guid), chance(fabs(_chance)), exclude(false), spawnIndex(_guid) {}
 
     template<typename T>
     void CheckEventLinkAndReport(uint32 poolId, int16 event_id, std::map<uint32, int16> const& creature2event, std::map<uint32, int16> const& go2event) const;
@@ -61,9 +62,9 @@ class Pool                                                  // for Pool of Pool
 {
 };
 
-typedef std::set<uint32> SpawnedPoolObjects;
-typedef std::map<uint32, uint32> SpawnedPoolPools;
+typedef std::vector<uint32> SpawnedPoolObjects;
 
+// Spawn state of the pools of one map copy, flat bitsets by PoolObject::spawnIndex
 class SpawnedPoolData
 {
     public:
@@ -72,24 +73,32 @@ class SpawnedPoolData
         template<typename T>
         bool IsSpawnedObject(uint32 db_guid_or_pool_id) const;
 
-        uint32 GetSpawnedObjects(uint32 pool_id) const;
+        template<typename T>
+        bool IsSpawnedMember(PoolObject const& obj) const;
+
+        uint32 GetSpawnedObjects(uint32 pool_id) const { return pool_id < m_spawnedCounts.size() ? m_spawnedCounts[pool_id] : 0; }
 
         template<typename T>
-        void AddSpawn(uint32 db_guid_or_pool_id, uint32 pool_id);
+        void AddSpawn(PoolObject const& obj, uint32 pool_id);
 
         template<typename T>
-        void RemoveSpawn(uint32 db_guid_or_pool_id, uint32 pool_id);
+        void RemoveSpawn(PoolObject const& obj, uint32 pool_id);
 
         bool IsInitialized() const { return m_isInitialized; }
         void SetInitialized() { m_isInitialized = true; }
 
-        SpawnedPoolObjects const& GetSpawnedCreatures() const { return mSpawnedCreatures; }
-        SpawnedPoolObjects const& GetSpawnedGameobjects() const { return mSpawnedGameobjects; }
-        SpawnedPoolPools const& GetSpawnedPools() const { return mSpawnedPools; }
+        // db guids, for commands
+        SpawnedPoolObjects GetSpawnedCreatures() const;
+        SpawnedPoolObjects GetSpawnedGameobjects() const;
     private:
-        SpawnedPoolObjects mSpawnedCreatures;
-        SpawnedPoolObjects mSpawnedGameobjects;
-        SpawnedPoolPools   mSpawnedPools;
+        static bool TestBit(std::vector<bool> const& bits, uint32 index) { return index < bits.size() && bits[index]; }
+        static void SetBit(std::vector<bool>& bits, uint32 index, bool value);
+        void ChangeSpawnedCount(uint32 pool_id, bool add);
+
+        std::vector<bool> m_spawnedCreatures;
+        std::vector<bool> m_spawnedGameobjects;
+        std::vector<bool> m_spawnedPools;                   // also set for pools that had members spawned or despawned
+        std::vector<uint32> m_spawnedCounts;                // spawned members by pool id
         bool m_isInitialized;
 };
 
@@ -104,6 +113,7 @@ class PoolGroup
         ~PoolGroup() {};
         bool isEmpty() const { return ExplicitlyChanced.empty() && EqualChanced.empty(); }
         void AddEntry(PoolObject& poolitem, uint32 maxentries);
+        void Compile();                                     // builds the alias table, after all entries are added
         bool CheckPool() const;
         void CheckEventLinkAndReport(int16 event_id, std::map<uint32, int16> const& creature2event, std::map<uint32, int16> const& go2event) const;
         PoolObject* RollOne(SpawnedPoolData& spawns, uint32 triggerFrom, MapPersistentState& mapState);
@@ -122,10 +132,18 @@ class PoolGroup
         size_t size() const { return ExplicitlyChanced.size() + EqualChanced.size(); }
     private:
         bool CanSpawn(PoolObject* object, MapPersistentState& mapState);
-        
+        bool CanRoll(PoolObject* object, SpawnedPoolData& spawns, uint32 triggerFrom, MapPersistentState& mapState);
+        PoolObject* RollExplicitlyChanced(SpawnedPoolData& spawns, uint32 triggerFrom, MapPersistentState& mapState, bool& missed);
+        PoolObject* RollEqualChanced(SpawnedPoolData& spawns, uint32 triggerFrom, MapPersistentState& mapState);
+        void RollEqualChanced(SpawnedPoolData& spawns, MapPersistentState& mapState, uint32 count, std::vector<PoolObject*>& result);
+
         uint32 poolId;
         PoolObjectList ExplicitlyChanced;
         PoolObjectList EqualChanced;
+
+        // alias table over ExplicitlyChanced and a last outcome for missing them all
+        std::vector<float> AliasChance;
+        std::vector<uint32> Alias;
 };
 
 class PoolManager
@@ -160,6 +178,13 @@ class PoolManager
         template<typename T>
         void SetExcludeObject(uint16 pool_id, uint32 db_guid_or_pool_id, bool state);
 
+        // dense index of a pooled creature/gameobject used by SpawnedPoolData, pool id for pools
+        template<typename T>
+        bool GetSpawnIndex(uint32 db_guid_or_pool_id, uint32& index) const;
+
+        template<typename T>
+        std::vector<uint32> const& GetSpawnIndexGuids() const;
+
         bool CheckPool(uint16 pool_id) const;
         void CheckEventLinkAndReport(uint16 pool_id, int16 event_id, std::map<uint32, int16> const& creature2event, std::map<uint32, int16> const& go2event) const;
 
@@ -198,15 +223,26 @@ class PoolManager
         typedef std::pair<uint32, uint16> SearchPair;
         typedef std::map<uint32, uint16> SearchMap;
 
+        struct PoolMember
+        {
+            uint16 poolId;
+            uint32 spawnIndex;
+        };
+        typedef std::unordered_map<uint32, PoolMember> MemberSearchMap;
+
         PoolTemplateDataMap mPoolTemplate;
         PoolGroupCreatureMap mPoolCreatureGroups;
         PoolGroupGameObjectMap mPoolGameobjectGroups;
         PoolGroupPoolMap mPoolPoolGroups;
 
-        // static maps DB low guid -> pool id
-        SearchMap mCreatureSearchMap;
-        SearchMap mGameobjectSearchMap;
+        // static maps DB low guid -> pool id and spawn index, child pool id -> mother pool id
+        MemberSearchMap mCreatureSearchMap;
+        MemberSearchMap mGameobjectSearchMap;
         SearchMap mPoolSearchMap;
+
+        // spawn index -> DB low guid
+        std::vector<uint32> mCreatureGuids;
+        std::vector<uint32> mGameobjectGuids;
 };
 
 #define sPoolMgr MaNGOS::Singleton<PoolManager>::Instance()
@@ -215,9 +251,9 @@ class PoolManager
 template<>
 inline uint16 PoolManager::IsPartOfAPool<Creature>(uint32 db_guid) const
 {
-    SearchMap::const_iterator itr = mCreatureSearchMap.find(db_guid);
+    MemberSearchMap::const_iterator itr = mCreatureSearchMap.find(db_guid);
     if (itr != mCreatureSearchMap.end())
-        return itr->second;
+        return itr->second.poolId;
 
     return 0;
 }
@@ -226,9 +262,9 @@ inline uint16 PoolManager::IsPartOfAPool<Creature>(uint32 db_guid) const
 template<>
 inline uint16 PoolManager::IsPartOfAPool<GameObject>(uint32 db_guid) const
 {
-    SearchMap::const_iterator itr = mGameobjectSearchMap.find(db_guid);
+    MemberSearchMap::const_iterator itr = mGameobjectSearchMap.find(db_guid);
     if (itr != mGameobjectSearchMap.end())
-        return itr->second;
+        return itr->second.poolId;
 
     return 0;
 }
@@ -244,4 +280,38 @@ inline uint16 PoolManager::IsPartOfAPool<Pool>(uint32 pool_id) const
     return 0;
 }
 
+template<>
+inline bool PoolManager::GetSpawnIndex<Creature>(uint32 db_guid, uint32& index) const
+{
+    MemberSearchMap::const_iterator itr = mCreatureSearchMap.find(db_guid);
+    if (itr == mCreatureSearchMap.end())
+        return false;
+
+    index = itr->second.spawnIndex;
+    return true;
+}
+
+template<>
+inline bool PoolManager::GetSpawnIndex<GameObject>(uint32 db_guid, uint32& index) const
+{
+    MemberSearchMap::const_iterator itr = mGameobjectSearchMap.find(db_guid);
+    if (itr == mGameobjectSearchMap.end())
+        return false;
+
+    index = itr->second.spawnIndex;
+    return true;
+}
+
+template<>
+inline std::vector<uint32> const& PoolManager::GetSpawnIndexGuids<Creature>() const
+{
+    return mCreatureGuids;
+}
+
+template<>
+inline std::vector<uint32> const& PoolManager::GetSpawnIndexGuids<GameObject>() const
+{
+    return mGameobjectGuids;
+}
+
 #endif
@@ -22,6 +22,7 @@
 #include "Platform/Define.h"
 #include "Database/DatabaseEnv.h"
 #include "Server/DBCEnums.h"
+#include "Globals/LocalizedString.h"
 
 #include <vector>
 
@@ -187,14 +188,14 @@ struct QuestLocale
 {
     QuestLocale() { ObjectiveText.resize(QUEST_OBJECTIVES_COUNT); }
 
-    std::vector<std::string> Title;
-    std::vector<std::string> Details;
-    std::vector<std::string> Objectives;
-    std::vector<std::string> OfferRewardText;
-    std::vector<std::string> RequestItemsText;
-    std::vector<std::string> EndText;
-    std::vector<std::string> CompletedText;
-    std::vector< std::vector<std::string> > ObjectiveText;
+    LocalizedString Title;
+    LocalizedString Details;
+    LocalizedString Objectives;
+    LocalizedString OfferRewardText;
+    LocalizedString RequestItemsText;
+    LocalizedString EndText;
+    LocalizedString CompletedText;
+    std::vector<LocalizedString> ObjectiveText;
 };
 
 // This Quest class provides a convenient way to access a few pretotaled (cached) quest details,
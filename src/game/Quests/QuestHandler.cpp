@@ -62,7 +62,7 @@ void WorldSession::HandleQuestgiverStatusQueryOpcode(WorldPacket& recv_data)
                 dialogStatus = sScriptDevAIMgr.GetDialogStatus(_player, cr_questgiver);
 
                 if (dialogStatus == DIALOG_STATUS_UNDEFINED)
-                    dialogStatus = getDialogStatus(_player, cr_questgiver, DIALOG_STATUS_NONE);
+                    dialogStatus = _player->GetQuestGiverDialogStatus(cr_questgiver);
             }
             break;
         }
@@ -75,7 +75,7 @@ void WorldSession::HandleQuestgiverStatusQueryOpcode(WorldPacket& recv_data)
                 dialogStatus = sScriptDevAIMgr.GetDialogStatus(_player, go_questgiver);
 
                 if (dialogStatus == DIALOG_STATUS_UNDEFINED)
-                    dialogStatus = getDialogStatus(_player, go_questgiver, DIALOG_STATUS_NONE);
+                    dialogStatus = _player->GetQuestGiverDialogStatus(go_questgiver);
             }
             break;
         }
@@ -671,8 +671,9 @@ void WorldSession::HandleQuestPushResult(WorldPacket& recvPacket)
  * @param pPlayer - for whom
  * @param questgiver - from whom
  * @param defstatus - initial set status (usually it will be called with DIALOG_STATUS_NONE) - must not be DIALOG_STATUS_UNDEFINED
+ * @param cacheable - if given, set to false when a quest condition makes the result depend on more than quest, level, skill and reputation state
  */
-uint32 WorldSession::getDialogStatus(const Player* pPlayer, const Object* questgiver, uint32 defstatus) const
+uint32 WorldSession::getDialogStatus(const Player* pPlayer, const Object* questgiver, uint32 defstatus, bool* cacheable) const
 {
     MANGOS_ASSERT(defstatus != DIALOG_STATUS_UNDEFINED);
 
@@ -711,6 +712,9 @@ uint32 WorldSession::getDialogStatus(const Player* pPlayer, const Object* questg
         if (!pQuest || !pQuest->IsActive())
             continue;
 
+        if (cacheable && pQuest->GetRequiredCondition())
+            *cacheable = false;
+
         QuestStatus status = pPlayer->GetQuestStatus(quest_id);
 
         if (status == QUEST_STATUS_COMPLETE && !pPlayer->GetQuestRewardStatus(quest_id))
@@ -734,6 +738,9 @@ uint32 WorldSession::getDialogStatus(const Player* pPlayer, const Object* questg
         if (!pQuest || !pQuest->IsActive())
             continue;
 
+        if (cacheable && pQuest->GetRequiredCondition())
+            *cacheable = false;
+
         QuestStatus status = pPlayer->GetQuestStatus(quest_id);
 
         if (status == QUEST_STATUS_NONE)                    // For all other cases the mark is handled either at some place else, or with involved-relations already
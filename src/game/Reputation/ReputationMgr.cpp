@@ -41,12 +41,6 @@ FactionState const* ReputationMgr::GetState(FactionEntry const* factionEntry) co
     return (factionEntry && factionEntry->HasReputation()) ? GetState(RepListID(factionEntry->reputationListID)) : nullptr;
 }
 
-FactionState const* ReputationMgr::GetState(RepListID id) const
-{
-    FactionStateList::const_iterator repItr = m_factions.find(id);
-    return repItr != m_factions.end() ? &repItr->second : nullptr;
-}
-
 int32 ReputationMgr::GetReputation(uint32 faction_id) const
 {
     FactionEntry const* factionEntry = sFactionStore.LookupEntry(faction_id);
@@ -110,8 +104,10 @@ bool ReputationMgr::IsAtWar(FactionEntry const* factionEntry) const
 
 ReputationRank ReputationMgr::GetRank(FactionEntry const* factionEntry) const
 {
-    int32 reputation = GetReputation(factionEntry);
-    return ReputationToRank(reputation);
+    if (FactionState const* state = GetState(factionEntry))
+        return state->Rank;
+
+    return ReputationToRank(0);
 }
 
 ReputationRank ReputationMgr::GetBaseRank(FactionEntry const* factionEntry) const
@@ -122,7 +118,8 @@ ReputationRank ReputationMgr::GetBaseRank(FactionEntry const* factionEntry) cons
 
 ReputationRank const* ReputationMgr::GetForcedRankIfAny(FactionTemplateEntry const* factionTemplateEntry) const
 {
-    if (!factionTemplateEntry)
+    // called for every reaction check of the player, most have no forced reaction at all
+    if (!factionTemplateEntry || m_forcedReactions.empty())
         return nullptr;
 
     ForcedReactions::const_iterator forceItr = m_forcedReactions.find(factionTemplateEntry->faction);
@@ -177,9 +174,8 @@ void ReputationMgr::SendState(FactionState const* faction, bool anyRankIncreased
     data << uint32(faction->ReputationListID);
     data << uint32(faction->Standing);
 
-    for (auto& m_faction : m_factions)
+    for (FactionState& subFaction : m_factions)
     {
-        FactionState& subFaction = m_faction.second;
         if (subFaction.needSend)
         {
             subFaction.needSend = false;
@@ -204,22 +200,13 @@ void ReputationMgr::SendInitialReputations()
 
     RepListID a = 0;
 
-    for (auto& m_faction : m_factions)
+    // absent factions have zero flags and standing
+    for (; a != 128 && a < m_factions.size(); ++a)
     {
-        // fill in absent fields
-        for (; a != m_faction.first; ++a)
-        {
-            data << uint8(0x00);
-            data << uint32(0x00000000);
-        }
+        data << uint8(m_factions[a].Flags);
+        data << uint32(m_factions[a].Standing);
 
-        // fill in encountered data
-        data << uint8(m_faction.second.Flags);
-        data << uint32(m_faction.second.Standing);
-
-        m_faction.second.needSend = false;
-
-        ++a;
+        m_factions[a].needSend = false;
     }
 
     // fill in absent fields
@@ -261,6 +248,7 @@ void ReputationMgr::Initialize()
             newFaction.ID = factionEntry->ID;
             newFaction.ReputationListID = factionEntry->reputationListID;
             newFaction.Standing = 0;
+            newFaction.Rank = GetBaseRank(factionEntry);
             newFaction.Flags = GetDefaultStateFlags(factionEntry);
             newFaction.needSend = true;
             newFaction.needSave = true;
@@ -268,8 +256,10 @@ void ReputationMgr::Initialize()
             if (newFaction.Flags & FACTION_FLAG_VISIBLE)
                 ++m_visibleFactionCount;
 
-            UpdateRankCounters(REP_HOSTILE, GetBaseRank(factionEntry));
+            UpdateRankCounters(REP_HOSTILE, newFaction.Rank);
 
+            if (newFaction.ReputationListID >= m_factions.size())
+                m_factions.resize(newFaction.ReputationListID + 1, FactionState());
             m_factions[newFaction.ReputationListID] = newFaction;
         }
     }
@@ -309,9 +299,9 @@ void ReputationMgr::SetReputation(FactionEntry const* factionEntry, int32 standi
             spillOverRepOut *= factionEntry->spilloverRateOut;
             if (FactionEntry const* parent = sFactionStore.LookupEntry(factionEntry->team))
             {
-                FactionStateList::iterator parentState = m_factions.find(parent->reputationListID);
+                FactionState const* parentState = GetState(parent);
                 // some team factions have own reputation standing, in this case do not spill to other sub-factions
-                if (parentState != m_factions.end() && (parentState->second.Flags & FACTION_FLAG_TEAM_REPUTATION))
+                if (parentState && (parentState->Flags & FACTION_FLAG_TEAM_REPUTATION))
                 {
                     if (SetOneFactionReputation(parent, int32(spillOverRepOut), incremental))
                         anyRankIncreased = true;
@@ -341,14 +331,13 @@ void ReputationMgr::SetReputation(FactionEntry const* factionEntry, int32 standi
         }
     }
     // spillover done, update faction itself
-    FactionStateList::iterator faction = m_factions.find(RepListID(factionEntry->reputationListID));
-    if (faction != m_factions.end())
+    if (FactionState const* faction = GetState(factionEntry))
     {
         if (SetOneFactionReputation(factionEntry, standing, incremental))
             anyRankIncreased = true;
 
         // only this faction gets reported to client, even if it has no own visible standing
-        SendState(&faction->second, anyRankIncreased);
+        SendState(faction, anyRankIncreased);
     }
 }
 
@@ -357,10 +346,9 @@ bool ReputationMgr::SetOneFactionReputation(FactionEntry const* factionEntry, in
     if (!factionEntry)
         return false;
 
-    FactionStateList::iterator itr = m_factions.find(RepListID(factionEntry->reputationListID));
-    if (itr != m_factions.end())
+    if (FactionState* state = factionEntry->HasReputation() ? GetState(RepListID(factionEntry->reputationListID)) : nullptr)
     {
-        FactionState& faction = itr->second;
+        FactionState& faction = *state;
         int32 BaseRep = GetBaseReputation(factionEntry);
 
         if (incremental)
@@ -375,6 +363,7 @@ bool ReputationMgr::SetOneFactionReputation(FactionEntry const* factionEntry, in
         ReputationRank rankNew = ReputationToRank(standing);
 
         faction.Standing = standing - BaseRep;
+        faction.Rank = rankNew;
         faction.needSend = true;
         faction.needSave = true;
 
@@ -385,7 +374,7 @@ bool ReputationMgr::SetOneFactionReputation(FactionEntry const* factionEntry, in
             // Server alters "At war" flag on two occasions:
             // * When reputation dips to "Hostile": forced tick and now locked for manual changes
             if (rankNew < REP_UNFRIENDLY && rankNew < rankOld && rankOld > REP_HOSTILE)
-                SetAtWar(&itr->second, true);
+                SetAtWar(&faction, true);
             // * When reputation improves to "Neutral": untick by id, can be manually overriden for eligible factions
             else if (rankNew > REP_UNFRIENDLY && rankNew > rankOld && rankOld < REP_NEUTRAL)
                 SetAtWar(RepListID(factionEntry->reputationListID), false);
@@ -422,11 +411,7 @@ void ReputationMgr::SetVisible(FactionEntry const* factionEntry)
     if (!factionEntry || !factionEntry->HasReputation())
         return;
 
-    FactionStateList::iterator itr = m_factions.find(RepListID(factionEntry->reputationListID));
-    if (itr == m_factions.end())
-        return;
-
-    SetVisible(&itr->second);
+    SetVisible(GetState(RepListID(factionEntry->reputationListID)));
 }
 
 void ReputationMgr::SetVisible(FactionState* faction)
@@ -453,15 +438,15 @@ void ReputationMgr::SetVisible(FactionState* faction)
 
 void ReputationMgr::SetAtWar(RepListID repListID, bool on)
 {
-    FactionStateList::iterator itr = m_factions.find(repListID);
-    if (itr == m_factions.end())
+    FactionState* faction = GetState(repListID);
+    if (!faction)
         return;
 
     // always invisible or hidden faction can't change war state
-    if (itr->second.Flags & (FACTION_FLAG_INVISIBLE_FORCED | FACTION_FLAG_HIDDEN))
+    if (faction->Flags & (FACTION_FLAG_INVISIBLE_FORCED | FACTION_FLAG_HIDDEN))
         return;
 
-    SetAtWar(&itr->second, on);
+    SetAtWar(faction, on);
 }
 
 void ReputationMgr::SetAtWar(FactionState* faction, bool atWar)
@@ -488,11 +473,7 @@ void ReputationMgr::SetAtWar(FactionState* faction, bool atWar)
 
 void ReputationMgr::SetInactive(RepListID repListID, bool on)
 {
-    FactionStateList::iterator itr = m_factions.find(repListID);
-    if (itr == m_factions.end())
-        return;
-
-    SetInactive(&itr->second, on);
+    SetInactive(GetState(repListID), on);
 }
 
 void ReputationMgr::SetInactive(FactionState* faction, bool inactive)
@@ -533,7 +514,7 @@ void ReputationMgr::LoadFromDB(QueryResult* result)
             FactionEntry const* factionEntry = sFactionStore.LookupEntry(fields[0].GetUInt32());
             if (factionEntry && factionEntry->HasReputation())
             {
-                FactionState* faction = &m_factions[factionEntry->reputationListID];
+                FactionState* faction = GetState(RepListID(factionEntry->reputationListID));
 
                 // update standing to current
                 faction->Standing = int32(fields[1].GetUInt32());
@@ -542,6 +523,7 @@ void ReputationMgr::LoadFromDB(QueryResult* result)
                 int32 BaseRep = GetBaseReputation(factionEntry);
                 ReputationRank old_rank = ReputationToRank(BaseRep);
                 ReputationRank new_rank = ReputationToRank(BaseRep + faction->Standing);
+                faction->Rank = new_rank;
                 UpdateRankCounters(old_rank, new_rank);
 
                 uint32 dbFactionFlags = fields[2].GetUInt32();
@@ -593,9 +575,8 @@ void ReputationMgr::SaveToDB()
     SqlStatement stmtDel = CharacterDatabase.CreateStatement(delRep, "DELETE FROM character_reputation WHERE guid = ? AND faction=?");
     SqlStatement stmtIns = CharacterDatabase.CreateStatement(insRep, "INSERT INTO character_reputation (guid,faction,standing,flags) VALUES (?, ?, ?, ?)");
 
-    for (auto& m_faction : m_factions)
+    for (FactionState& faction : m_factions)
     {
-        FactionState& faction = m_faction.second;
         if (faction.needSave)
         {
             stmtDel.PExecute(m_player->GetGUIDLow(), faction.ID);
@@ -23,6 +23,7 @@
 #include "Globals/SharedDefines.h"
 #include "Server/DBCStructure.h"
 #include <map>
+#include <vector>
 
 enum FactionFlags
 {
@@ -43,12 +44,13 @@ struct FactionState
     RepListID ReputationListID;
     uint32 Flags;
     int32  Standing;
+    ReputationRank Rank;                                    // rank of base reputation + Standing, kept in sync with Standing
     bool needSend;
     bool needSave;
 };
 
-typedef std::map<RepListID, FactionState> FactionStateList;
-typedef std::pair<FactionStateList::const_iterator, FactionStateList::const_iterator> FactionStateListPair;
+// indexed by RepListID, slots without faction have ID 0
+typedef std::vector<FactionState> FactionStateList;
 
 typedef std::map<uint32, ReputationRank> ForcedReactions;
 
@@ -79,7 +81,10 @@ class ReputationMgr
         FactionStateList const& GetStateList() const { return m_factions; }
 
         FactionState const* GetState(FactionEntry const* factionEntry) const;
-        FactionState const* GetState(RepListID id) const;
+        FactionState const* GetState(RepListID id) const
+        {
+            return id < m_factions.size() && m_factions[id].ID ? &m_factions[id] : nullptr;
+        }
 
         int32 GetReputation(uint32 faction_id) const;
         int32 GetReputation(FactionEntry const* factionEntry) const;
@@ -120,6 +125,7 @@ class ReputationMgr
         uint32 GetDefaultStateFlags(const FactionEntry* factionEntry) const;
         void SetReputation(FactionEntry const* factionEntry, int32 standing, bool incremental);
         bool SetOneFactionReputation(FactionEntry const* factionEntry, int32 standing, bool incremental);
+        FactionState* GetState(RepListID id) { return id < m_factions.size() && m_factions[id].ID ? &m_factions[id] : nullptr; }
         void SetVisible(FactionState* faction);
         void SetAtWar(FactionState* faction, bool atWar);
         void SetInactive(FactionState* faction, bool inactive);
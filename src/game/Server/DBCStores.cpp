@@ -24,6 +24,7 @@
 #include "Globals/Locales.h"
 #include "Globals/SharedDefines.h"
 #include "Server/SQLStorages.h"
+#include "Spells/SpellMgr.h"
 
 #include "DBCfmt.h"
 
@@ -676,11 +677,13 @@ void LoadDBCStores(const std::string& dataPath)
     // include existing nodes that have at least single not spell base (scripted) path
     {
         std::set<uint32> spellPaths;
-        for (uint32 i = 1; i < sSpellTemplate.GetMaxEntry(); ++i)
-            if (SpellEntry const* sInfo = sSpellTemplate.LookupEntry<SpellEntry>(i))
-                for (int j = 0; j < MAX_EFFECT_INDEX; ++j)
-                    if (sInfo->Effect[j] == 123 /*SPELL_EFFECT_SEND_TAXI*/)
-                        spellPaths.insert(sInfo->EffectMiscValue[j]);
+        for (uint32 spellId : sSpellMgr.GetSpellsWithEffect(123 /*SPELL_EFFECT_SEND_TAXI*/))
+        {
+            SpellEntry const* sInfo = sSpellTemplate.LookupEntry<SpellEntry>(spellId);
+            for (int j = 0; j < MAX_EFFECT_INDEX; ++j)
+                if (sInfo->Effect[j] == 123 /*SPELL_EFFECT_SEND_TAXI*/)
+                    spellPaths.insert(sInfo->EffectMiscValue[j]);
+        }
 
         memset(sTaxiNodesMask, 0, sizeof(sTaxiNodesMask));
         memset(sOldContinentsNodesMask, 0, sizeof(sTaxiNodesMask));
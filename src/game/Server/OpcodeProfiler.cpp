@@ -0,0 +1,187 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/OpcodeProfiler.h"
+#include "Server/Opcodes.h"
+#include "Policies/Singleton.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <algorithm>
+
+INSTANTIATE_SINGLETON_1(OpcodeProfiler);
+
+uint32 OpcodeLatencySnapshot::GetPercentile(float percentile) const
+{
+    if (!count)
+        return 0;
+
+    uint64 const target = std::max<uint64>(1, uint64(count * percentile + 0.5f));
+    uint64 seen = 0;
+    for (uint32 i = 0; i < OPCODE_LATENCY_BUCKETS; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= target)
+            return std::min(maxTime, (uint32(1) << (i + 1)) - 1);
+    }
+
+    return maxTime;
+}
+
+OpcodeProfiler::Histogram::Histogram() : count(0), wallTime(0), cpuTime(0), maxTime(0), intervalMaxTime(0)
+{
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+OpcodeProfiler::OpcodeProfiler() : m_histograms(new Histogram[NUM_MSG_TYPES * MAX_OPCODE_PROFILE_THREAD]),
+    m_intervalBaseline(NUM_MSG_TYPES * MAX_OPCODE_PROFILE_THREAD)
+{
+}
+
+void OpcodeProfiler::Record(uint16 opcode, OpcodeProfileThread thread, uint64 wallTime, uint64 cpuTime)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    Histogram& histogram = Get(opcode, thread);
+
+    uint32 bucket = 0;
+    while (bucket < OPCODE_LATENCY_BUCKETS - 1 && (wallTime >> (bucket + 1)))
+        ++bucket;
+
+    histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    histogram.wallTime.fetch_add(wallTime, std::memory_order_relaxed);
+    histogram.cpuTime.fetch_add(cpuTime, std::memory_order_relaxed);
+
+    uint32 const time = uint32(std::min<uint64>(wallTime, std::numeric_limits<uint32>::max()));
+    uint32 maxTime = histogram.maxTime.load(std::memory_order_relaxed);
+    while (time > maxTime && !histogram.maxTime.compare_exchange_weak(maxTime, time, std::memory_order_relaxed)) {}
+    maxTime = histogram.intervalMaxTime.load(std::memory_order_relaxed);
+    while (time > maxTime && !histogram.intervalMaxTime.compare_exchange_weak(maxTime, time, std::memory_order_relaxed)) {}
+}
+
+void OpcodeProfiler::Reset()
+{
+    for (uint32 i = 0; i < NUM_MSG_TYPES * MAX_OPCODE_PROFILE_THREAD; ++i)
+    {
+        Histogram& histogram = m_histograms[i];
+        for (auto& bucket : histogram.buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        histogram.count.store(0, std::memory_order_relaxed);
+        histogram.wallTime.store(0, std::memory_order_relaxed);
+        histogram.cpuTime.store(0, std::memory_order_relaxed);
+        histogram.maxTime.store(0, std::memory_order_relaxed);
+        histogram.intervalMaxTime.store(0, std::memory_order_relaxed);
+    }
+
+    std::fill(m_intervalBaseline.begin(), m_intervalBaseline.end(), OpcodeLatencySnapshot());
+}
+
+OpcodeLatencySnapshot OpcodeProfiler::Load(Histogram const& histogram) const
+{
+    OpcodeLatencySnapshot snapshot;
+    for (uint32 i = 0; i < OPCODE_LATENCY_BUCKETS; ++i)
+        snapshot.buckets[i] = histogram.buckets[i].load(std::memory_order_relaxed);
+    snapshot.count = histogram.count.load(std::memory_order_relaxed);
+    snapshot.wallTime = histogram.wallTime.load(std::memory_order_relaxed);
+    snapshot.cpuTime = histogram.cpuTime.load(std::memory_order_relaxed);
+    snapshot.maxTime = histogram.maxTime.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+static void SortSummaries(std::vector<OpcodeLatencySummary>& summaries)
+{
+    std::sort(summaries.begin(), summaries.end(), [](OpcodeLatencySummary const& left, OpcodeLatencySummary const& right)
+    {
+        return left.data.wallTime > right.data.wallTime;
+    });
+}
+
+std::vector<OpcodeLatencySummary> OpcodeProfiler::GetSummaries()
+{
+    std::vector<OpcodeLatencySummary> summaries;
+    for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+    {
+        for (uint32 thread = 0; thread < MAX_OPCODE_PROFILE_THREAD; ++thread)
+        {
+            Histogram const& histogram = Get(opcode, OpcodeProfileThread(thread));
+            if (!histogram.count.load(std::memory_order_relaxed))
+                continue;
+
+            summaries.push_back({ uint16(opcode), OpcodeProfileThread(thread), Load(histogram) });
+        }
+    }
+
+    SortSummaries(summaries);
+    return summaries;
+}
+
+std::vector<OpcodeLatencySummary> OpcodeProfiler::GetIntervalSummaries()
+{
+    std::vector<OpcodeLatencySummary> summaries;
+    for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+    {
+        for (uint32 thread = 0; thread < MAX_OPCODE_PROFILE_THREAD; ++thread)
+        {
+            Histogram& histogram = Get(opcode, OpcodeProfileThread(thread));
+            OpcodeLatencySnapshot& baseline = m_intervalBaseline[opcode * MAX_OPCODE_PROFILE_THREAD + thread];
+            if (histogram.count.load(std::memory_order_relaxed) == baseline.count)
+                continue;
+
+            OpcodeLatencySnapshot const current = Load(histogram);
+            OpcodeLatencySummary summary = { uint16(opcode), OpcodeProfileThread(thread), current };
+            for (uint32 i = 0; i < OPCODE_LATENCY_BUCKETS; ++i)
+                summary.data.buckets[i] -= baseline.buckets[i];
+            summary.data.count -= baseline.count;
+            summary.data.wallTime -= baseline.wallTime;
+            summary.data.cpuTime -= baseline.cpuTime;
+            summary.data.maxTime = histogram.intervalMaxTime.exchange(0, std::memory_order_relaxed);
+
+            baseline = current;
+            summaries.push_back(summary);
+        }
+    }
+
+    SortSummaries(summaries);
+    return summaries;
+}
+
+uint64 OpcodeProfiler::GetThreadCpuTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        return 0;
+
+    // 100 nanosecond units
+    uint64 const total = ((uint64(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime) + ((uint64(user.dwHighDateTime) << 32) | user.dwLowDateTime);
+    return total / 10;
+#else
+    timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+        return 0;
+
+    return uint64(time.tv_sec) * 1000000 + uint64(time.tv_nsec) / 1000;
+#endif
+}
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_OPCODEPROFILER_H
+#define MANGOS_OPCODEPROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+enum OpcodeProfileThread
+{
+    OPCODE_PROFILE_WORLD    = 0,                            // World::UpdateSessions
+    OPCODE_PROFILE_MAP      = 1,                            // WorldSession::UpdateMap on map threads
+    MAX_OPCODE_PROFILE_THREAD
+};
+
+// log2 buckets in microseconds, the last one collects everything above ~8 seconds
+#define OPCODE_LATENCY_BUCKETS 24
+
+struct OpcodeLatencySnapshot
+{
+    OpcodeLatencySnapshot() : count(0), wallTime(0), cpuTime(0), maxTime(0)
+    {
+        memset(buckets, 0, sizeof(buckets));
+    }
+
+    uint64 buckets[OPCODE_LATENCY_BUCKETS];
+    uint64 count;
+    uint64 wallTime;                                        // microseconds
+    uint64 cpuTime;                                         // microseconds
+    uint32 maxTime;                                         // microseconds
+
+    // approximated by the upper bound of the bucket holding the percentile, in microseconds
+    uint32 GetPercentile(float percentile) const;
+};
+
+struct OpcodeLatencySummary
+{
+    uint16 opcode;
+    OpcodeProfileThread thread;
+    OpcodeLatencySnapshot data;
+};
+
+// Latency histograms of opcode handlers, split by the thread type they ran on.
+// Recording is lock free so map threads can report concurrently.
+class OpcodeProfiler
+{
+    public:
+        OpcodeProfiler();
+
+        void Record(uint16 opcode, OpcodeProfileThread thread, uint64 wallTime, uint64 cpuTime);
+        void Reset();
+
+        // every handler that ran, sorted by total wall time. the interval variant only covers what
+        // happened since its previous call and is meant for a single periodic reader (metrics)
+        std::vector<OpcodeLatencySummary> GetSummaries();
+        std::vector<OpcodeLatencySummary> GetIntervalSummaries();
+
+        // CPU time consumed by the calling thread in microseconds, 0 if the platform does not provide it
+        static uint64 GetThreadCpuTime();
+
+    private:
+        struct Histogram
+        {
+            Histogram();
+
+            std::atomic<uint64> buckets[OPCODE_LATENCY_BUCKETS];
+            std::atomic<uint64> count;
+            std::atomic<uint64> wallTime;
+            std::atomic<uint64> cpuTime;
+            std::atomic<uint32> maxTime;
+            std::atomic<uint32> intervalMaxTime;
+        };
+
+        OpcodeLatencySnapshot Load(Histogram const& histogram) const;
+
+        Histogram& Get(uint16 opcode, OpcodeProfileThread thread) { return m_histograms[opcode * MAX_OPCODE_PROFILE_THREAD + thread]; }
+
+        std::unique_ptr<Histogram[]> m_histograms;
+        std::vector<OpcodeLatencySnapshot> m_intervalBaseline;
+};
+
+#define sOpcodeProfiler MaNGOS::Singleton<OpcodeProfiler>::Instance()
+
+#endif
@@ -1366,6 +1366,7 @@ enum PacketProcessing
     PROCESS_THREADSAFE,                                     // packet is thread-safe - process it in Map::Update()
     PROCESS_MAP_THREAD,                                     // packet is map thread safe
     PROCESS_IMMEDIATE,                                      // packet is network thread safe
+    PROCESS_SESSION_THREAD,                                 // packet only touches its own session - process it in the parallel session update
 };
 
 class WorldPacket;
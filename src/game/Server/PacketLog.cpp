@@ -17,9 +17,14 @@
 
 #include "PacketLog.h"
 #include "Util/Timer.h"
+#include "Util/Util.h"
+#include "Util/ByteBufferPool.h"
 #include "Server/WorldPacket.h"
 #include "Config/Config.h"
 #include "Globals/SharedDefines.h"
+#include "Log.h"
+
+#include <zlib.h>
 
 #pragma pack(push, 1)
 
@@ -57,13 +62,17 @@ struct PacketHeader
 
 #pragma pack(pop)
 
-PacketLog::PacketLog() : _file(nullptr)
+PacketLog::PacketLog() : _enabled(false), _file(nullptr), _format(PACKET_LOG_FORMAT_PKT), _sampleRate(0), _stop(false), _dropped(0),
+    _lastConnectionId(0), _chunkRecords(0), _chunkSize(0)
 {
     std::call_once(_initializeFlag, &PacketLog::Initialize, this);
 }
 
 PacketLog::~PacketLog()
 {
+    _enabled = false;
+    StopWriter();
+
     if (_file)
         fclose(_file);
 
@@ -85,31 +94,68 @@ void PacketLog::Initialize()
         if ((logsDir.at(logsDir.length() - 1) != '/') && (logsDir.at(logsDir.length() - 1) != '\\'))
             logsDir.push_back('/');
 
+    _format = sConfig.GetIntDefault("PacketLog.Format", PACKET_LOG_FORMAT_PKT) == PACKET_LOG_FORMAT_CHUNKED ? PACKET_LOG_FORMAT_CHUNKED : PACKET_LOG_FORMAT_PKT;
+    _sampleRate = std::min(sConfig.GetIntDefault("PacketLog.SampleRate", 0), 100);
+    _chunkSize = std::max(sConfig.GetIntDefault("PacketLog.ChunkSize", 256 * 1024), 4 * 1024);
+
+    _accounts.clear();
+    for (std::string const& token : StrSplit(sConfig.GetStringDefault("PacketLog.Accounts", ""), ", "))
+        if (uint32 accountId = uint32(std::strtoul(token.c_str(), nullptr, 10)))
+            _accounts.insert(accountId);
+
     std::string logname = sConfig.GetStringDefault("PacketLogFile", "");
     if (!logname.empty())
     {
         _file = fopen((logsDir + logname).c_str(), "wb");
+        if (!_file)
+        {
+            sLog.outError("PacketLog: cannot open %s for writing", (logsDir + logname).c_str());
+            return;
+        }
 
-        LogHeader header;
-        header.Signature[0] = 'P'; header.Signature[1] = 'K'; header.Signature[2] = 'T';
-        header.FormatVersion = 0x0301;
-        header.SnifferId = 'T';
-        header.Build = buildVersion[0];
-        header.Locale[0] = 'e'; header.Locale[1] = 'n'; header.Locale[2] = 'U'; header.Locale[3] = 'S';
-        std::memset(header.SessionKey, 0, sizeof(header.SessionKey));
-        header.SniffStartUnixtime = time(nullptr);
-        header.SniffStartTicks = WorldTimer::getMSTime();
-        header.OptionalDataSize = 0;
-
-        if (CanLogPacket())
+        if (_format == PACKET_LOG_FORMAT_CHUNKED)
+        {
+            PacketLogFileHeader header;
+            header.magic = PACKET_LOG_FILE_MAGIC;
+            header.version = PACKET_LOG_VERSION;
+            header.compression = PACKET_LOG_COMPRESSION_ZLIB;
+            header.build = buildVersion[0];
+            header.startUnixtime = time(nullptr);
+            header.startTicks = WorldTimer::getMSTime();
             fwrite(&header, sizeof(header), 1, _file);
+        }
+        else
+        {
+            LogHeader header;
+            header.Signature[0] = 'P'; header.Signature[1] = 'K'; header.Signature[2] = 'T';
+            header.FormatVersion = 0x0301;
+            header.SnifferId = 'T';
+            header.Build = buildVersion[0];
+            header.Locale[0] = 'e'; header.Locale[1] = 'n'; header.Locale[2] = 'U'; header.Locale[3] = 'S';
+            std::memset(header.SessionKey, 0, sizeof(header.SessionKey));
+            header.SniffStartUnixtime = time(nullptr);
+            header.SniffStartTicks = WorldTimer::getMSTime();
+            header.OptionalDataSize = 0;
+            fwrite(&header, sizeof(header), 1, _file);
+        }
+
+        // the capacity is fixed at the first start, producers never see the queue change
+        if (!_queue)
+            _queue.reset(new MPSCQueue<Entry>(std::max(sConfig.GetIntDefault("PacketLog.QueueSize", 16384), 2)));
+
+        _stop = false;
+        _writer = std::thread(&PacketLog::WriterThread, this);
+        _enabled = true;
     }
 }
 
 void PacketLog::Reinitialize()
 {
     std::lock_guard<std::mutex> lock(_logPacketLock);
-    if (CanLogPacket())
+    _enabled = false;
+    StopWriter();
+
+    if (_file)
     {
         fclose(_file);
         _file = nullptr;
@@ -117,35 +163,165 @@ void PacketLog::Reinitialize()
     Initialize();
 }
 
-void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port)
+bool PacketLog::ShouldCaptureSession(uint32 accountId)
 {
     std::lock_guard<std::mutex> lock(_logPacketLock);
+    if (!CanLogPacket())
+        return false;
 
-    PacketHeader header;
-    header.Direction = direction == CLIENT_TO_SERVER ? 0x47534d43 : 0x47534d53;
-    header.ConnectionId = 0;
-    header.ArrivalTicks = WorldTimer::getMSTime();
+    if (_accounts.find(accountId) != _accounts.end())
+        return true;
 
-    header.OptionalDataSize = sizeof(header.OptionalData);
-    memset(header.OptionalData.SocketIPBytes, 0, sizeof(header.OptionalData.SocketIPBytes));
+    return _sampleRate && urand(0, 99) < _sampleRate;
+}
+
+void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port,
+                          uint32 accountId, uint32 connectionId)
+{
+    Entry entry;
+    entry.header.ticks = WorldTimer::getMSTime();
+    entry.header.accountId = accountId;
+    entry.header.connectionId = connectionId;
+    entry.header.direction = direction == CLIENT_TO_SERVER ? PACKET_LOG_CLIENT_TO_SERVER : PACKET_LOG_SERVER_TO_CLIENT;
+    entry.header.opcode = uint16(packet.GetOpcode());
+    entry.header.size = uint32(packet.size());
+
+    memset(entry.address, 0, sizeof(entry.address));
     if (addr.is_v4())
     {
         auto bytes = addr.to_v4().to_bytes();
-        memcpy(header.OptionalData.SocketIPBytes, bytes.data(), bytes.size());
+        memcpy(entry.address, bytes.data(), bytes.size());
     }
     else if (addr.is_v6())
     {
         auto bytes = addr.to_v6().to_bytes();
-        memcpy(header.OptionalData.SocketIPBytes, bytes.data(), bytes.size());
+        memcpy(entry.address, bytes.data(), bytes.size());
     }
+    entry.port = port;
 
-    header.OptionalData.SocketPort = port;
-    header.Length = packet.size() + sizeof(header.Opcode);
-    header.Opcode = packet.GetOpcode();
+    if (!packet.empty())
+    {
+        entry.payload = ByteBufferPool::Acquire(packet.size());
+        entry.payload.assign(packet.contents(), packet.contents() + packet.size());
+    }
+
+    // never wait for the disk on a map or network thread, a full queue drops the packet
+    if (!_queue->Push(std::move(entry)))
+    {
+        ++_dropped;
+        ByteBufferPool::Release(std::move(entry.payload));
+    }
+}
+
+void PacketLog::WriteEntry(Entry& entry)
+{
+    if (_format == PACKET_LOG_FORMAT_CHUNKED)
+    {
+        uint8 const* header = reinterpret_cast<uint8 const*>(&entry.header);
+        _chunk.insert(_chunk.end(), header, header + sizeof(entry.header));
+        _chunk.insert(_chunk.end(), entry.payload.begin(), entry.payload.end());
+        ++_chunkRecords;
+
+        if (_chunk.size() >= _chunkSize)
+            FlushChunk();
+        return;
+    }
+
+    PacketHeader header;
+    header.Direction = entry.header.direction == PACKET_LOG_CLIENT_TO_SERVER ? 0x47534d43 : 0x47534d53;
+    header.ConnectionId = entry.header.connectionId;
+    header.ArrivalTicks = entry.header.ticks;
+
+    header.OptionalDataSize = sizeof(header.OptionalData);
+    memcpy(header.OptionalData.SocketIPBytes, entry.address, sizeof(header.OptionalData.SocketIPBytes));
+    header.OptionalData.SocketPort = entry.port;
+    header.Length = entry.header.size + sizeof(header.Opcode);
+    header.Opcode = entry.header.opcode;
 
     fwrite(&header, sizeof(header), 1, _file);
-    if (!packet.empty())
-        fwrite(packet.contents(), 1, packet.size(), _file);
+    if (!entry.payload.empty())
+        fwrite(entry.payload.data(), 1, entry.payload.size(), _file);
+}
+
+void PacketLog::FlushChunk()
+{
+    if (!_chunkRecords)
+        return;
+
+    uLongf compressedSize = compressBound(_chunk.size());
+    _compressed.resize(compressedSize);
+    if (compress2(_compressed.data(), &compressedSize, _chunk.data(), _chunk.size(), Z_BEST_SPEED) != Z_OK)
+    {
+        sLog.outError("PacketLog: failed to compress a chunk of %u packets, dropped", _chunkRecords);
+        _chunk.clear();
+        _chunkRecords = 0;
+        return;
+    }
+
+    PacketLogChunkHeader header;
+    header.magic = PACKET_LOG_CHUNK_MAGIC;
+    header.compressedSize = uint32(compressedSize);
+    header.rawSize = uint32(_chunk.size());
+    header.recordCount = _chunkRecords;
+
+    fwrite(&header, sizeof(header), 1, _file);
+    fwrite(_compressed.data(), 1, compressedSize, _file);
+    fflush(_file);
+
+    _chunk.clear();
+    _chunkRecords = 0;
+}
+
+void PacketLog::WriterThread()
+{
+    // a partially filled chunk is written after this long without traffic, bounds what a crash loses
+    uint32 const idleFlushTime = 1000;
+    uint32 lastWrite = WorldTimer::getMSTime();
+
+    Entry entry;
+    while (true)
+    {
+        // read before draining so nothing queued ahead of StopWriter is lost
+        bool const stop = _stop.load(std::memory_order_acquire);
+
+        bool written = false;
+        while (_queue->Pop(entry))
+        {
+            WriteEntry(entry);
+            ByteBufferPool::Release(std::move(entry.payload));
+            written = true;
+        }
+
+        if (uint64 dropped = _dropped.exchange(0))
+            sLog.outError("PacketLog: " UI64FMTD " packets dropped, PacketLog.QueueSize is too small", dropped);
 
+        if (stop)
+            break;
+
+        uint32 const now = WorldTimer::getMSTime();
+        if (written)
+        {
+            if (_format == PACKET_LOG_FORMAT_PKT)
+                fflush(_file);
+            lastWrite = now;
+        }
+        else
+        {
+            if (_chunkRecords && WorldTimer::getMSTimeDiff(lastWrite, now) >= idleFlushTime)
+                FlushChunk();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    FlushChunk();
     fflush(_file);
 }
+
+void PacketLog::StopWriter()
+{
+    if (!_writer.joinable())
+        return;
+
+    _stop = true;
+    _writer.join();
+}
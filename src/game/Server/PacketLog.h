@@ -19,9 +19,16 @@
 #define TRINITY_PACKETLOG_H
 
 #include "Common.h"
+#include "Server/PacketLogFormat.h"
+#include "Util/MPSCQueue.h"
 
 #include <boost/asio/ip/address.hpp>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
 
 enum Direction
 {
@@ -29,6 +36,12 @@ enum Direction
     SERVER_TO_CLIENT
 };
 
+enum PacketLogFormat
+{
+    PACKET_LOG_FORMAT_PKT       = 0,                        // PKT 3.1, readable by WPP
+    PACKET_LOG_FORMAT_CHUNKED   = 1,                        // PacketLogFormat.h, see contrib/packetlog
+};
+
 class WorldPacket;
 
 class PacketLog
@@ -44,11 +57,47 @@ class PacketLog
 
         void Initialize();
         void Reinitialize();
-        bool CanLogPacket() const { return (_file != nullptr); }
-        void LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port);
+        bool CanLogPacket() const { return _enabled.load(std::memory_order_relaxed); }
+        // called once per authenticated socket, true when PacketLog.Accounts or PacketLog.SampleRate select it
+        bool ShouldCaptureSession(uint32 accountId);
+        // unique id for every socket that gets captured, shared by both directions
+        uint32 NewConnectionId() { return ++_lastConnectionId; }
+        // only formats the record on the calling thread, the file is written by the writer thread
+        void LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port,
+                       uint32 accountId, uint32 connectionId);
 
     private:
-        FILE* _file;
+        struct Entry
+        {
+            PacketLogRecordHeader header;
+            uint8 address[16];
+            uint16 port;
+            std::vector<uint8> payload;
+        };
+
+        void WriterThread();
+        void StopWriter();
+        void WriteEntry(Entry& entry);
+        void FlushChunk();
+
+        std::atomic<bool> _enabled;
+        FILE* _file;                                        // owned by the writer thread while it runs
+        PacketLogFormat _format;
+        uint32 _sampleRate;                                 // percent of sessions captured without .debug packetlog
+        std::set<uint32> _accounts;
+
+        // allocated once, producers may still be pushing while Reinitialize swaps the file
+        std::unique_ptr<MPSCQueue<Entry>> _queue;
+        std::thread _writer;
+        std::atomic<bool> _stop;
+        std::atomic<uint64> _dropped;
+        std::atomic<uint32> _lastConnectionId;
+
+        // writer thread only
+        std::vector<uint8> _chunk;
+        std::vector<uint8> _compressed;
+        uint32 _chunkRecords;
+        uint32 _chunkSize;
 };
 
 #define sPacketLog PacketLog::instance()
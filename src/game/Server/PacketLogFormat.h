@@ -0,0 +1,81 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PACKETLOGFORMAT_H
+#define MANGOS_PACKETLOGFORMAT_H
+
+#include "Common.h"
+
+// Chunked packet capture written by PacketLog with PacketLog.Format = 1.
+//
+// file   := PacketLogFileHeader chunk*
+// chunk  := PacketLogChunkHeader <compressedSize bytes>
+// inflated chunk payload := (PacketLogRecordHeader <size bytes>)* recordCount times
+//
+// All fields are stored little endian. A chunk is only written once complete,
+// so a capture cut short by a crash is readable up to its last chunk.
+
+#define PACKET_LOG_FILE_MAGIC   0x4C504D43                  // "CMPL"
+#define PACKET_LOG_CHUNK_MAGIC  0x4B4E4843                  // "CHNK"
+#define PACKET_LOG_VERSION      1
+
+enum PacketLogCompression
+{
+    PACKET_LOG_COMPRESSION_NONE = 0,
+    PACKET_LOG_COMPRESSION_ZLIB = 1,
+};
+
+enum PacketLogDirection
+{
+    PACKET_LOG_CLIENT_TO_SERVER = 0,
+    PACKET_LOG_SERVER_TO_CLIENT = 1,
+};
+
+#pragma pack(push, 1)
+
+struct PacketLogFileHeader
+{
+    uint32 magic;
+    uint16 version;
+    uint16 compression;                                     // PacketLogCompression
+    uint32 build;
+    uint32 startUnixtime;
+    uint32 startTicks;                                      // WorldTimer::getMSTime() when the capture started
+};
+
+struct PacketLogChunkHeader
+{
+    uint32 magic;
+    uint32 compressedSize;
+    uint32 rawSize;
+    uint32 recordCount;
+};
+
+struct PacketLogRecordHeader
+{
+    uint32 ticks;                                           // WorldTimer::getMSTime() of the capture
+    uint32 accountId;
+    uint32 connectionId;                                    // unique per captured socket
+    uint8  direction;                                       // PacketLogDirection
+    uint16 opcode;
+    uint32 size;
+};
+
+#pragma pack(pop)
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/PacketLogReader.h"
+
+#include <zlib.h>
+#include <cstring>
+
+PacketLogReader::PacketLogReader() : m_file(nullptr), m_fileHeader(), m_chunkPos(0), m_chunkRecordsLeft(0), m_chunksRead(0)
+{
+}
+
+PacketLogReader::~PacketLogReader()
+{
+    Close();
+}
+
+bool PacketLogReader::Open(std::string const& path)
+{
+    Close();
+
+    m_file = fopen(path.c_str(), "rb");
+    if (!m_file)
+    {
+        m_error = "cannot open " + path;
+        return false;
+    }
+
+    if (fread(&m_fileHeader, sizeof(m_fileHeader), 1, m_file) != 1 || m_fileHeader.magic != PACKET_LOG_FILE_MAGIC)
+    {
+        m_error = path + " is not a chunked packet log";
+        Close();
+        return false;
+    }
+
+    if (m_fileHeader.version != PACKET_LOG_VERSION)
+    {
+        m_error = path + " has unsupported version " + std::to_string(m_fileHeader.version);
+        Close();
+        return false;
+    }
+
+    if (m_fileHeader.compression != PACKET_LOG_COMPRESSION_NONE && m_fileHeader.compression != PACKET_LOG_COMPRESSION_ZLIB)
+    {
+        m_error = path + " uses unknown compression " + std::to_string(m_fileHeader.compression);
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void PacketLogReader::Close()
+{
+    if (m_file)
+        fclose(m_file);
+
+    m_file = nullptr;
+    m_chunk.clear();
+    m_chunkPos = 0;
+    m_chunkRecordsLeft = 0;
+    m_chunksRead = 0;
+}
+
+bool PacketLogReader::ReadChunk()
+{
+    PacketLogChunkHeader header;
+    if (fread(&header, sizeof(header), 1, m_file) != 1)
+        return false;                                       // regular end of the capture
+
+    if (header.magic != PACKET_LOG_CHUNK_MAGIC)
+    {
+        m_error = "bad chunk magic after chunk " + std::to_string(m_chunksRead);
+        return false;
+    }
+
+    m_chunk.resize(header.rawSize);
+    if (m_fileHeader.compression == PACKET_LOG_COMPRESSION_NONE)
+    {
+        if (header.compressedSize != header.rawSize || fread(m_chunk.data(), 1, header.rawSize, m_file) != header.rawSize)
+        {
+            m_error = "truncated chunk " + std::to_string(m_chunksRead);
+            return false;
+        }
+    }
+    else
+    {
+        m_compressed.resize(header.compressedSize);
+        if (fread(m_compressed.data(), 1, header.compressedSize, m_file) != header.compressedSize)
+        {
+            m_error = "truncated chunk " + std::to_string(m_chunksRead);
+            return false;
+        }
+
+        uLongf rawSize = header.rawSize;
+        if (uncompress(m_chunk.data(), &rawSize, m_compressed.data(), header.compressedSize) != Z_OK || rawSize != header.rawSize)
+        {
+            m_error = "cannot inflate chunk " + std::to_string(m_chunksRead);
+            return false;
+        }
+    }
+
+    m_chunkPos = 0;
+    m_chunkRecordsLeft = header.recordCount;
+    ++m_chunksRead;
+    return true;
+}
+
+bool PacketLogReader::Next(PacketLogRecordHeader& record, uint8 const*& payload)
+{
+    if (!m_file)
+        return false;
+
+    while (!m_chunkRecordsLeft)
+        if (!ReadChunk())
+            return false;
+
+    if (m_chunkPos + sizeof(record) > m_chunk.size())
+    {
+        m_error = "record overruns chunk " + std::to_string(m_chunksRead - 1);
+        return false;
+    }
+
+    memcpy(&record, &m_chunk[m_chunkPos], sizeof(record));
+    m_chunkPos += sizeof(record);
+
+    if (m_chunkPos + record.size > m_chunk.size())
+    {
+        m_error = "record overruns chunk " + std::to_string(m_chunksRead - 1);
+        return false;
+    }
+
+    payload = m_chunk.data() + m_chunkPos;
+    m_chunkPos += record.size;
+    --m_chunkRecordsLeft;
+    return true;
+}
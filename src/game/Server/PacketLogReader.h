@@ -0,0 +1,65 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PACKETLOGREADER_H
+#define MANGOS_PACKETLOGREADER_H
+
+#include "Common.h"
+#include "Server/PacketLogFormat.h"
+
+#include <string>
+#include <vector>
+
+// Sequential reader for captures in the PacketLogFormat.h layout.
+// Used offline by contrib/packetlog and the replay tooling, never by mangosd itself.
+class PacketLogReader
+{
+    public:
+        PacketLogReader();
+        ~PacketLogReader();
+        PacketLogReader(PacketLogReader const&) = delete;
+        PacketLogReader& operator=(PacketLogReader const&) = delete;
+
+        // returns false and fills GetError() when the file is missing or not a packet log
+        bool Open(std::string const& path);
+        void Close();
+
+        PacketLogFileHeader const& GetFileHeader() const { return m_fileHeader; }
+
+        // reads the next record, payload points into the current chunk and stays
+        // valid until the next call. Returns false at the end of the capture or on a
+        // damaged chunk, the latter setting GetError().
+        bool Next(PacketLogRecordHeader& record, uint8 const*& payload);
+
+        std::string const& GetError() const { return m_error; }
+        uint32 GetChunksRead() const { return m_chunksRead; }
+
+    private:
+        bool ReadChunk();
+
+        FILE* m_file;
+        PacketLogFileHeader m_fileHeader;
+        std::vector<uint8> m_compressed;
+        std::vector<uint8> m_chunk;
+        size_t m_chunkPos;
+        uint32 m_chunkRecordsLeft;
+        uint32 m_chunksRead;
+        std::string m_error;
+};
+
+#endif
@@ -34,14 +34,33 @@ class WorldPacket : public ByteBuffer
         {
         }
         explicit WorldPacket(Opcodes opcode, size_t res = 200) : ByteBuffer(res), m_opcode(opcode) { }
+        WorldPacket(Opcodes opcode, size_t res, PooledStorageTag tag) : ByteBuffer(res, tag), m_opcode(opcode) { }
         // copy constructor
         WorldPacket(const WorldPacket& packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode)
         {
         }
+        WorldPacket(WorldPacket&& packet) noexcept          : ByteBuffer(std::move(packet)), m_opcode(packet.m_opcode), m_receivedTime(packet.m_receivedTime)
+        {
+        }
         WorldPacket(const WorldPacket& packet, std::chrono::steady_clock::time_point receivedTime) : ByteBuffer(packet),
             m_opcode(packet.m_opcode), m_receivedTime(receivedTime)
         {
         }
+        // declared explicitly, the move constructor would delete the implicit one
+        WorldPacket& operator=(const WorldPacket& packet)
+        {
+            ByteBuffer::operator=(packet);
+            m_opcode = packet.m_opcode;
+            m_receivedTime = packet.m_receivedTime;
+            return *this;
+        }
+        WorldPacket& operator=(WorldPacket&& packet) noexcept
+        {
+            ByteBuffer::operator=(std::move(packet));
+            m_opcode = packet.m_opcode;
+            m_receivedTime = packet.m_receivedTime;
+            return *this;
+        }
 
         void Initialize(Opcodes opcode, size_t newres = 200)
         {
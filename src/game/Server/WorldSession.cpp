@@ -29,7 +29,9 @@
 #include "Server/Opcodes.h"
 #include "Server/WorldPacket.h"
 #include "Server/WorldSession.h"
+#include "Server/OpcodeProfiler.h"
 #include "Entities/Player.h"
+#include "Maps/Map.h"
 #include "Globals/ObjectMgr.h"
 #include "Groups/Group.h"
 #include "Guilds/Guild.h"
@@ -101,7 +103,8 @@ WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, uint8
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetStorageLocaleIndexFor(locale)),
     m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED), m_sessionState(WORLD_SESSION_STATE_CREATED),
     m_timeSyncClockDeltaQueue(6), m_timeSyncClockDelta(0), m_pendingTimeSyncRequests(), m_timeSyncNextCounter(0), m_timeSyncTimer(0),
-    m_requestSocket(nullptr), m_recruitingFriendId(recruitingFriend), m_isRecruiter(isARecruiter) {}
+    m_requestSocket(nullptr), m_recruitingFriendId(recruitingFriend), m_isRecruiter(isARecruiter),
+    m_recvQueue(sWorld.getConfig(CONFIG_UINT32_NETWORK_RECV_QUEUE_SIZE)), m_recvQueueSize(0), m_mapThreadQueue(sock != nullptr) {}
 
 /// WorldSession destructor
 WorldSession::~WorldSession()
@@ -161,7 +164,7 @@ void WorldSession::SetInCharSelection()
 
 bool WorldSession::RequestNewSocket(WorldSocket* socket)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueLock);
+    std::lock_guard<std::mutex> guard(m_requestSocketLock);
     if (m_requestSocket)
         return false;
 
@@ -200,6 +203,31 @@ void WorldSession::SetExpansion(uint8 expansion)
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const& packet) const
+{
+    if (PrepareSendPacket(packet))
+        m_Socket->SendPacket(packet);
+}
+
+/// Send a packet whose contents the socket may keep referencing instead of copying them
+void WorldSession::SendPacket(std::shared_ptr<WorldPacket const> const& packet) const
+{
+    if (PrepareSendPacket(*packet))
+        m_Socket->SendPacket(packet);
+}
+
+/// Send packets in order as a single socket write
+void WorldSession::SendPackets(std::vector<std::shared_ptr<WorldPacket const>> const& packets) const
+{
+    bool canSend = false;
+    for (auto const& packet : packets)
+        canSend = PrepareSendPacket(*packet);
+
+    if (canSend)
+        m_Socket->SendPackets(packets);
+}
+
+/// Common part of SendPacket, returns false when there is no socket to send to
+bool WorldSession::PrepareSendPacket([[maybe_unused]] WorldPacket const& packet) const
 {
 #ifdef BUILD_PLAYERBOT
     // Send packet to bot AI
@@ -213,7 +241,7 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
 #endif
 
     if (!m_Socket || m_Socket->IsClosed())
-        return;
+        return false;
 
 #ifdef MANGOS_DEBUG
 
@@ -251,11 +279,11 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
 
 #endif                                                  // !MANGOS_DEBUG
 
-    m_Socket->SendPacket(packet);
+    return true;
 }
 
-/// Add an incoming packet to the queue
-void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
+/// Add an incoming packet to the queue, returns false when the session receive queue is full
+bool WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
 {
     sWorld.IncrementOpcodeCounter(new_packet->GetOpcode());
     OpcodeHandler const& opHandle = opcodeTable[new_packet->GetOpcode()];
@@ -264,19 +292,49 @@ void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
         (this->*opHandle.handler)(*new_packet);
         if (new_packet->rpos() < new_packet->wpos() && sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
             LogUnprocessedTail(*new_packet);
-        return;
+        return true;
     }
 
-    if (opHandle.packetProcessing == PROCESS_MAP_THREAD)
+    uint32 const recvQueueLimit = sWorld.getConfig(CONFIG_UINT32_NETWORK_RECV_QUEUE_SIZE);
+
+    // thread-safe handlers only touch the player's own map, they run in Map::Update() of that map
+    if (opHandle.packetProcessing == PROCESS_MAP_THREAD ||
+        (opHandle.packetProcessing == PROCESS_THREADSAFE && opHandle.status == STATUS_LOGGEDIN && m_mapThreadQueue &&
+         sWorld.getConfig(CONFIG_BOOL_NETWORK_MAP_THREAD_PACKETS)))
     {
         std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
+        if (m_recvQueueMap.size() >= recvQueueLimit)
+            return false;
+
         m_recvQueueMap.push_back(std::move(new_packet));
+        return true;
     }
-    else
+
+    // reserve a slot first so the configured limit holds even with several producers
+    uint32 const limit = std::min<uint32>(recvQueueLimit, m_recvQueue.Capacity());
+    if (m_recvQueueSize.fetch_add(1, std::memory_order_relaxed) >= limit)
+    {
+        m_recvQueueSize.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_recvQueue.Push(std::move(new_packet));
+    return true;
+}
+
+bool WorldSession::PopRecvPacket(std::unique_ptr<WorldPacket>& packet)
+{
+    if (m_heldRecvPacket)
     {
-        std::lock_guard<std::mutex> guard(m_recvQueueLock);
-        m_recvQueue.push_back(std::move(new_packet));
+        packet = std::move(m_heldRecvPacket);
+        return true;
     }
+
+    if (!m_recvQueue.Pop(packet))
+        return false;
+
+    m_recvQueueSize.fetch_sub(1, std::memory_order_relaxed);
+    return true;
 }
 
 void WorldSession::DeleteMovementPackets()
@@ -343,29 +401,39 @@ void WorldSession::ProcessByteBufferException(WorldPacket const& packet)
 /// Update the WorldSession (triggered by World update)
 bool WorldSession::Update(uint32 diff)
 {
+    // the checks read the player, so they only run in parallel while there is none (see UpdateIndependent)
+    if (_player)
+        UpdateAnticheat();
+
     GetMessager().Execute(this);
 
-    std::deque<std::unique_ptr<WorldPacket>> recvQueueCopy;
-    {
-        std::lock_guard<std::mutex> guard(m_recvQueueLock);
-        std::swap(recvQueueCopy, m_recvQueue);
-    }
+    // only process packets received before this update, handlers may queue new ones
+    uint32 recvQueueCount = m_recvQueueSize.load(std::memory_order_relaxed) + (m_heldRecvPacket ? 1 : 0);
 
-    if (m_Socket && !m_Socket->IsClosed() && m_anticheat)
+#ifdef BUILD_PLAYERBOT
+    if (_player && _player->GetPlayerbotMgr())
     {
-        auto const now = WorldTimer::getMSTime();
-        m_anticheat->Update(WorldTimer::getMSTimeDiff(m_lastAnticheatUpdate, now));
-        m_lastAnticheatUpdate = now;
+        std::deque<std::unique_ptr<WorldPacket>> botMasterPackets;
+        {
+            std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
+            std::swap(botMasterPackets, m_botMasterPackets);
+        }
+
+        for (auto const& botPacket : botMasterPackets)
+            _player->GetPlayerbotMgr()->HandleMasterIncomingPacket(*botPacket);
     }
+#endif
 
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    while (m_Socket && !m_Socket->IsClosed() && !recvQueueCopy.empty())
+    std::unique_ptr<WorldPacket> packet;
+    for (; recvQueueCount && PopRecvPacket(packet); --recvQueueCount)
     {
         // sLog.outError("MOEP: %s (0x%.4X)", packet->GetOpcodeName(), packet->GetOpcode());
 
-        auto const packet = std::move(recvQueueCopy.front());
-        recvQueueCopy.pop_front();
+        // received packets are dropped once the socket is closed
+        if (!m_Socket || m_Socket->IsClosed())
+            continue;
 
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
         try
@@ -456,11 +524,9 @@ bool WorldSession::Update(uint32 diff)
         {
             Player* const botPlayer = itr->second;
             WorldSession* const pBotWorldSession = botPlayer->GetSession();
-            while(!pBotWorldSession->m_recvQueue.empty())
+            std::unique_ptr<WorldPacket> botpacket;
+            while (pBotWorldSession->PopRecvPacket(botpacket))
             {
-                auto const botpacket = std::move(pBotWorldSession->m_recvQueue.front());
-                pBotWorldSession->m_recvQueue.pop_front();
-
                 OpcodeHandler const& opHandle = opcodeTable[botpacket->GetOpcode()];
                 pBotWorldSession->ExecuteOpcode(opHandle, *botpacket);
             }
@@ -482,7 +548,7 @@ bool WorldSession::Update(uint32 diff)
 
                 m_Socket = m_requestSocket;
                 m_requestSocket = nullptr;
-                sLog.outDetail("New Session key %s", m_Socket->GetSessionKey().AsHexStr());
+                DETAIL_LOG("New Session key %s", m_Socket->GetSessionKey().AsHexStr());
                 SendAuthOk();
             }
             else
@@ -550,32 +616,114 @@ bool WorldSession::Update(uint32 diff)
     return true;
 }
 
-void WorldSession::UpdateMap(uint32 diff)
+/// Update the session local state, may run in parallel with other sessions (see World::UpdateSessions)
+void WorldSession::UpdateIndependent(uint32 /*diff*/)
 {
-    std::deque<std::unique_ptr<WorldPacket>> recvQueueMapCopy;
+    if (!m_Socket || m_Socket->IsClosed())
+        return;
+
+    // character screen packets answered from session data only, stop at the first other one to keep the order
+    if (_player)
+        return;
+
+    // without a player the anticheat only uses session state, with one it runs in Update
+    UpdateAnticheat();
+
+    if (m_inQueue)
+        return;
+
+    uint32 recvQueueCount = m_recvQueueSize.load(std::memory_order_relaxed);
+    std::unique_ptr<WorldPacket> packet;
+    for (; recvQueueCount && PopRecvPacket(packet); --recvQueueCount)
+    {
+        OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
+        if (opHandle.packetProcessing != PROCESS_SESSION_THREAD || opHandle.status != STATUS_AUTHED)
+        {
+            m_heldRecvPacket = std::move(packet);
+            break;
+        }
+
+        m_playerRecentlyLogout = false;
+
+        try
+        {
+            ExecuteOpcode(opHandle, *packet);
+        }
+        catch (ByteBufferException&)
+        {
+            ProcessByteBufferException(*packet);
+        }
+    }
+}
+
+void WorldSession::UpdateAnticheat()
+{
+    if (!m_Socket || m_Socket->IsClosed() || !m_anticheat)
+        return;
+
+    auto const now = WorldTimer::getMSTime();
+    m_anticheat->Update(WorldTimer::getMSTimeDiff(m_lastAnticheatUpdate, now));
+    m_lastAnticheatUpdate = now;
+}
+
+void WorldSession::UpdateMap(uint32 /*diff*/)
+{
+    // only process packets received before this update, handlers may queue new ones
+    size_t recvQueueCount;
     {
         std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
-        std::swap(recvQueueMapCopy, m_recvQueueMap);
+        recvQueueCount = m_recvQueueMap.size();
     }
 
-    while (m_Socket && !m_Socket->IsClosed() && recvQueueMapCopy.size())
+    // handlers run here may only touch objects of the player's current map
+    MapAccessScope scope(_player ? _player->GetMap() : nullptr);
+
+    for (; recvQueueCount && m_Socket && !m_Socket->IsClosed(); --recvQueueCount)
     {
-        auto const packet = std::move(recvQueueMapCopy.front());
-        recvQueueMapCopy.pop_front();
+        // popped one by one so DeleteMovementPackets() called by a handler also affects the remaining ones
+        std::unique_ptr<WorldPacket> packet;
+        {
+            std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
+            if (m_recvQueueMap.empty())
+                break;
+
+            packet = std::move(m_recvQueueMap.front());
+            m_recvQueueMap.pop_front();
+        }
 
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
-        
+        if (opHandle.status != STATUS_LOGGEDIN || !_player)
+            continue;
+
+        // a handler started a far teleport, lag delayed packets of the old map are dropped like in Update()
+        if (!_player->IsInWorld())
+        {
+            if (opHandle.packetProcessing == PROCESS_THREADSAFE)
+                continue;
+
+            // map thread packets not bound to the map wait for the next one
+            std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
+            m_recvQueueMap.push_front(std::move(packet));
+            break;
+        }
+
         try
         {
-            if (opHandle.status == STATUS_LOGGEDIN)
-            {
-                ExecuteOpcode(opHandle, *packet);
-            }
+            ExecuteOpcode(opHandle, *packet);
         }
         catch (ByteBufferException&)
         {
             ProcessByteBufferException(*packet);
         }
+
+#ifdef BUILD_PLAYERBOT
+        // bots can be on other maps, let the world thread forward the packet to them
+        if (_player && _player->GetPlayerbotMgr())
+        {
+            std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
+            m_botMasterPackets.push_back(std::move(packet));
+        }
+#endif
     }
 }
 
@@ -748,6 +896,15 @@ void WorldSession::LogoutPlayer()
 
         SetPlayer(nullptr, 0);                                    // deleted in Remove/DeleteFromWorld call
 
+        // map packets left for the old character must not reach the next one
+        {
+            std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
+            m_recvQueueMap.clear();
+#ifdef BUILD_PLAYERBOT
+            m_botMasterPackets.clear();
+#endif
+        }
+
         ///- Send the 'logout complete' packet to the client
         WorldPacket data(SMSG_LOGOUT_COMPLETE, 0);
         SendPacket(data);
@@ -793,6 +950,10 @@ void WorldSession::LogoutPlayer()
 /// Kick a player out of the World
 void WorldSession::KickPlayer(bool save, bool inPlace)
 {
+    // logout touches maps and other sessions, not allowed from a parallel session update
+    if (World::DeferSessionOperation([this, save, inPlace]() { KickPlayer(save, inPlace); }))
+        return;
+
     m_playerSave = save;
     if (inPlace)
     {
@@ -1177,7 +1338,19 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& pac
     if (_player)
         _player->SetCanDelayTeleport(true);
 
-    (this->*opHandle.handler)(packet);
+    if (sWorld.getConfig(CONFIG_BOOL_OPCODE_PROFILING))
+    {
+        auto const wallStart = std::chrono::steady_clock::now();
+        uint64 const cpuStart = OpcodeProfiler::GetThreadCpuTime();
+
+        (this->*opHandle.handler)(packet);
+
+        uint64 const wallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wallStart).count();
+        sOpcodeProfiler.Record(packet.GetOpcode(), MapAccessScope::GetMap() ? OPCODE_PROFILE_MAP : OPCODE_PROFILE_WORLD,
+                               wallTime, OpcodeProfiler::GetThreadCpuTime() - cpuStart);
+    }
+    else
+        (this->*opHandle.handler)(packet);
 
     if (_player)
     {
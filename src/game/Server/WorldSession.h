@@ -32,6 +32,7 @@
 #include "Server/WorldSocket.h"
 #include "Multithreading/Messager.h"
 #include "LFG/LFGDefines.h"
+#include "Util/MPSCQueue.h"
 
 #include <deque>
 #include <mutex>
@@ -41,6 +42,8 @@
 
 struct ItemPrototype;
 struct AuctionEntry;
+class AuctionSorter;
+struct AuctionListFilter;
 struct AuctionHouseEntry;
 struct DeclinedName;
 struct TradeStatusInfo;
@@ -56,6 +59,7 @@ class Unit;
 class WorldPacket;
 class QueryResult;
 class LoginQueryHolder;
+class MailboxQueryHolder;
 class CharacterHandler;
 class GMTicket;
 class MovementInfo;
@@ -265,6 +269,8 @@ class WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const& packet) const;
+        void SendPacket(std::shared_ptr<WorldPacket const> const& packet) const;
+        void SendPackets(std::vector<std::shared_ptr<WorldPacket const>> const& packets) const;
         void SendExpectedSpamRecords();
         void SendMotd();
         void SendOfflineNameQueryResponses();
@@ -305,6 +311,8 @@ class WorldSession
         const std::string GetRemoteAddress() const { return m_Socket ? m_Socket->GetRemoteAddress() : "disconnected"; }
 #endif
         const std::string& GetLocalAddress() const { return m_localAddress; }
+        // send syscalls per second of the socket since the previous call, 0 without socket
+        float ConsumeSocketSendRate() { return m_Socket ? m_Socket->ConsumeSendRate() : 0.0f; }
 
         void SetPlayer(Player* plr, uint32 playerGuid);
         uint8 GetExpansion() const { return m_expansion; }
@@ -347,12 +355,14 @@ class WorldSession
         void LogoutPlayer();
         void KickPlayer(bool save = false, bool inPlace = false); // inplace variable needed for shutdown
 
-        void QueuePacket(std::unique_ptr<WorldPacket> new_packet);
+        bool QueuePacket(std::unique_ptr<WorldPacket> new_packet);
 
         void DeleteMovementPackets();
 
         bool Update(uint32 diff);
+        void UpdateIndependent(uint32 diff);
         void UpdateMap(uint32 diff);
+        void UpdateAnticheat();                             // warden and movement checks, reads the player if any
 
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position) const;
@@ -425,8 +435,8 @@ class WorldSession
         void SendAuctionRemovedNotification(AuctionEntry* auction) const;
         static void SendAuctionOutbiddedMail(AuctionEntry* auction);
         static void SendAuctionCancelledToBidderMail(AuctionEntry* auction);
-        void BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin,
-                                   uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull) const;
+        void BuildListAuctionItems(std::vector<AuctionEntry*>& auctions, AuctionListFilter const& filter, AuctionSorter const& sorter, WorldPacket& data, uint32 listfrom,
+                                   uint32 usable, uint32& count, uint32& totalcount, bool isFull) const;
 
         AuctionHouseEntry const* GetCheckedAuctionHouseForAuctioneer(ObjectGuid guid) const;
 
@@ -466,7 +476,7 @@ class WorldSession
         uint32 GetLatency() const { return m_latency; }
         void SetLatency(uint32 latency) { m_latency = latency; }
         void ResetClientTimeDelay() { m_clientTimeDelay = 0; }
-        uint32 getDialogStatus(const Player* pPlayer, const Object* questgiver, uint32 defstatus) const;
+        uint32 getDialogStatus(const Player* pPlayer, const Object* questgiver, uint32 defstatus, bool* cacheable = nullptr) const;
         ClientOSType GetOS() const { return m_clientOS; }
         void SetOS(ClientOSType os) { m_clientOS = os; }
         ClientPlatformType GetPlatform() const { return m_clientPlatform; }
@@ -722,6 +732,8 @@ class WorldSession
         void HandleAuctionListPendingSales(WorldPacket& recv_data);
 
         void HandleGetMailList(WorldPacket& recv_data);
+        static void HandleGetMailListCallBack(MailboxQueryHolder* holder);
+        void SendMailList(ObjectGuid mailboxGuid);
         void HandleSendMail(WorldPacket& recv_data);
         void HandleMailTakeMoney(WorldPacket& recv_data);
         void HandleMailTakeItem(WorldPacket& recv_data);
@@ -1021,6 +1033,8 @@ class WorldSession
         void HandleMoverRelocation(MovementInfo& movementInfo);
 
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet);
+        bool PrepareSendPacket(WorldPacket const& packet) const;
+        bool PopRecvPacket(std::unique_ptr<WorldPacket>& packet);  // consumer side of m_recvQueue
 
         // logging helper
         void LogUnexpectedOpcode(WorldPacket const& packet, const char* reason) const;
@@ -1087,10 +1101,16 @@ class WorldSession
         bool m_isRecruiter;
 
         // Thread safety mechanisms
-        std::mutex m_recvQueueLock;
+        std::mutex m_requestSocketLock;
         std::mutex m_recvQueueMapLock;
-        std::deque<std::unique_ptr<WorldPacket>> m_recvQueue;
+        MPSCQueue<std::unique_ptr<WorldPacket>> m_recvQueue;
+        std::atomic<uint32> m_recvQueueSize;                // packets reserved in m_recvQueue, bounded by Network.RecvQueueSize
+        std::unique_ptr<WorldPacket> m_heldRecvPacket;      // popped by UpdateIndependent() but left to Update(), precedes m_recvQueue
         std::deque<std::unique_ptr<WorldPacket>> m_recvQueueMap;
+        bool const m_mapThreadQueue;                        // sessions created without a socket (bots) process every packet in Update()
+#ifdef BUILD_PLAYERBOT
+        std::deque<std::unique_ptr<WorldPacket>> m_botMasterPackets; // map thread packets forwarded to the bots in Update()
+#endif
 
         Messager<WorldSession> m_messager;
 
@@ -24,6 +24,7 @@
 #include "Server/WorldPacket.h"
 #include "Globals/SharedDefines.h"
 #include "Util/ByteBuffer.h"
+#include "Util/ByteBufferPool.h"
 #include "Server/Opcodes.h"
 #include "Server/PacketLog.h"
 #include "Database/DatabaseEnv.h"
@@ -33,6 +34,9 @@
 #include "Server/DBCStores.h"
 #include "Util/CommonDefines.h"
 #include "Anticheat/Anticheat.hpp"
+#ifdef BUILD_METRICS
+#include "Metric/Aggregate.h"
+#endif
 
 #include <chrono>
 #include <functional>
@@ -42,6 +46,16 @@
 #include <boost/asio.hpp>
 #include <utility>
 
+#ifdef BUILD_METRICS
+namespace
+{
+    metric::counter& s_packetsReceived = metric::aggregates::instance().register_counter("network.packets", { { "direction", "received" } });
+    metric::counter& s_packetsSent = metric::aggregates::instance().register_counter("network.packets", { { "direction", "sent" } });
+    metric::counter& s_bytesReceived = metric::aggregates::instance().register_counter("network.bytes", { { "direction", "received" } });
+    metric::counter& s_bytesSent = metric::aggregates::instance().register_counter("network.bytes", { { "direction", "sent" } });
+}
+#endif
+
 #if defined( __GNUC__ )
 #pragma pack(1)
 #else
@@ -113,17 +127,65 @@ std::deque<uint32> WorldSocket::GetIncOpcodeHistory()
 }
 
 WorldSocket::WorldSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler) : Socket(service, std::move(closeHandler)), m_lastPingTime(std::chrono::system_clock::time_point::min()), m_overSpeedPings(0), m_existingHeader(),
-    m_useExistingHeader(false), m_session(nullptr), m_seed(urand()), m_loggingPackets(false)
+    m_useExistingHeader(false), m_session(nullptr), m_seed(urand()), m_loggingPackets(false),
+    m_packetLogAccountId(0), m_packetLogConnectionId(0)
+#ifdef BUILD_BENCHMARKS
+    , m_replay(false), m_replayPacketsSent(0), m_replayBytesSent(0)
+#endif
+{
+}
+
+#ifdef BUILD_BENCHMARKS
+std::shared_ptr<WorldSocket> WorldSocket::CreateReplaySocket(boost::asio::io_service& service)
+{
+    std::shared_ptr<WorldSocket> socket = std::make_shared<WorldSocket>(service, nullptr);
+
+    // an open descriptor is all IsClosed() looks at, Open() is never called so nothing is read
+    boost::system::error_code ec;
+    socket->GetAsioSocket().open(boost::asio::ip::tcp::v4(), ec);
+    if (ec)
+    {
+        sLog.outError("WorldSocket::CreateReplaySocket: %s", ec.message().c_str());
+        return nullptr;
+    }
+
+    socket->m_replay = true;
+    return socket;
+}
+
+void WorldSocket::CountReplayPacket(WorldPacket const& pct)
 {
+    m_replayPacketsSent.fetch_add(1, std::memory_order_relaxed);
+    m_replayBytesSent.fetch_add(ServerPktHeader(pct.size() + 2, pct.GetOpcode()).getHeaderLength() + pct.size(), std::memory_order_relaxed);
 }
+#endif
 
 void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
+{
+    WritePacket(pct, nullptr, immediate);
+}
+
+void WorldSocket::SendPacket(std::shared_ptr<const WorldPacket> const& pct, bool immediate)
+{
+    // aliasing pointer, keeps the packet alive as long as the socket references its contents
+    WritePacket(*pct, pct->empty() ? nullptr : std::shared_ptr<const uint8>(pct, pct->contents()), immediate);
+}
+
+void WorldSocket::WritePacket(const WorldPacket& pct, std::shared_ptr<const uint8> content, bool immediate)
 {
     if (IsClosed())
         return;
 
+#ifdef BUILD_BENCHMARKS
+    if (m_replay)
+    {
+        CountReplayPacket(pct);
+        return;
+    }
+#endif
+
     if (sPacketLog->CanLogPacket() && IsLoggingPackets())
-        sPacketLog->LogPacket(pct, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
+        sPacketLog->LogPacket(pct, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort(), m_packetLogAccountId, m_packetLogConnectionId);
 
     // Dump outgoing packet.
     sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct.GetOpcode(), pct.GetOpcodeName(), pct, false);
@@ -134,7 +196,9 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
     ServerPktHeader header(pct.size() + 2, pct.GetOpcode());
     m_crypt.EncryptSend((uint8*)header.header, header.getHeaderLength());
 
-    if (!pct.empty())
+    if (content)
+        Write(reinterpret_cast<const char*>(&header.header), header.getHeaderLength(), std::move(content), pct.size());
+    else if (!pct.empty())
         Write(reinterpret_cast<const char*>(&header.header), header.getHeaderLength(), reinterpret_cast<const char*>(pct.contents()), pct.size());
     else
         Write(reinterpret_cast<const char*>(&header.header), header.getHeaderLength());
@@ -142,11 +206,71 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
     if (immediate)
         ForceFlushOut();
 
+#ifdef BUILD_METRICS
+    s_packetsSent.add();
+    s_bytesSent.add(header.getHeaderLength() + pct.size());
+#endif
+
     m_opcodeHistoryOut.push_front(uint32(pct.GetOpcode()));
     if (m_opcodeHistoryOut.size() > 50)
         m_opcodeHistoryOut.resize(30);
 }
 
+void WorldSocket::SendPackets(std::vector<std::shared_ptr<const WorldPacket>> const& packets)
+{
+    if (IsClosed() || packets.empty())
+        return;
+
+#ifdef BUILD_BENCHMARKS
+    if (m_replay)
+    {
+        for (auto const& pct : packets)
+            CountReplayPacket(*pct);
+        return;
+    }
+#endif
+
+    size_t size = 0;
+    for (auto const& pct : packets)
+        size += sizeof(ServerPktHeader::header) + pct->size();
+
+    std::vector<uint8> buffer = ByteBufferPool::Acquire(size);
+
+    {
+        std::lock_guard<std::mutex> guard(m_worldSocketMutex);
+
+        for (auto const& pct : packets)
+        {
+            if (sPacketLog->CanLogPacket() && IsLoggingPackets())
+                sPacketLog->LogPacket(*pct, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort(), m_packetLogAccountId, m_packetLogConnectionId);
+
+            sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct->GetOpcode(), pct->GetOpcodeName(), *pct, false);
+
+            ServerPktHeader header(pct->size() + 2, pct->GetOpcode());
+            m_crypt.EncryptSend((uint8*)header.header, header.getHeaderLength());
+
+            buffer.insert(buffer.end(), header.header, header.header + header.getHeaderLength());
+            if (!pct->empty())
+                buffer.insert(buffer.end(), pct->contents(), pct->contents() + pct->size());
+
+            m_opcodeHistoryOut.push_front(uint32(pct->GetOpcode()));
+        }
+
+        if (m_opcodeHistoryOut.size() > 50)
+            m_opcodeHistoryOut.resize(30);
+
+        // headers are encrypted in stream order, queue them before another packet can be encrypted
+        Write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    }
+
+#ifdef BUILD_METRICS
+    s_packetsSent.add(packets.size());
+    s_bytesSent.add(buffer.size());
+#endif
+
+    ByteBufferPool::Release(std::move(buffer));
+}
+
 bool WorldSocket::Open()
 {
     if (!Socket::Open())
@@ -229,7 +353,7 @@ bool WorldSocket::ProcessIncomingData()
     if (IsClosed())
         return false;
 
-    std::unique_ptr<WorldPacket> pct(new WorldPacket(opcode, validBytesRemaining));
+    std::unique_ptr<WorldPacket> pct(new WorldPacket(opcode, validBytesRemaining, PooledStorageTag()));
 
     if (validBytesRemaining)
     {
@@ -237,8 +361,13 @@ bool WorldSocket::ProcessIncomingData()
         ReadSkip(validBytesRemaining);
     }
 
+#ifdef BUILD_METRICS
+    s_packetsReceived.add();
+    s_bytesReceived.add(sizeof(ClientPktHeader) + validBytesRemaining);
+#endif
+
     if (sPacketLog->CanLogPacket() && IsLoggingPackets())
-        sPacketLog->LogPacket(*pct, CLIENT_TO_SERVER, GetRemoteIpAddress(), GetRemotePort());
+        sPacketLog->LogPacket(*pct, CLIENT_TO_SERVER, GetRemoteIpAddress(), GetRemotePort(), m_packetLogAccountId, m_packetLogConnectionId);
 
     sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct->GetOpcode(), pct->GetOpcodeName(), *pct, true);
 
@@ -262,7 +391,7 @@ bool WorldSocket::ProcessIncomingData()
                     return false;
                 }
 
-                return HandleAuthSession(*pct);
+                return HandleAuthSession(std::move(pct));
 
             case CMSG_PING:
                 return HandlePing(*pct);
@@ -286,7 +415,12 @@ bool WorldSocket::ProcessIncomingData()
                     return false;
                 }
 
-                m_session->QueuePacket(std::move(pct));
+                if (!m_session->QueuePacket(std::move(pct)))
+                {
+                    sLog.outError("WorldSocket::ProcessIncomingData: receive queue of account %u is full (opcode = %u), disconnecting flooding client %s",
+                                  m_session->GetAccountId(), uint32(opcode), GetRemoteAddress().c_str());
+                    return false;
+                }
 
                 return true;
             }
@@ -314,38 +448,32 @@ bool WorldSocket::ProcessIncomingData()
     return true;
 }
 
-bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
+bool WorldSocket::HandleAuthSession(std::unique_ptr<WorldPacket> recvPacket)
 {
-    // NOTE: ATM the socket is singlethread, have this in mind ...
-    uint8 digest[20];
-    uint32 clientSeed;
-    uint32 ClientBuild;
     uint32 unk2;
-    LocaleConstant locale;
-    std::string account, os;
-    Sha1Hash sha1;
-    BigNumber v, s, g, N, K;
     WorldPacket packet;
 
+    std::unique_ptr<AuthSessionRequest> request(new AuthSessionRequest);
+
     // Read the content of the packet
-    recvPacket >> ClientBuild;
-    recvPacket >> unk2;
-    recvPacket >> account;
-    recvPacket.read_skip<uint32>();
-    recvPacket >> clientSeed;
-    recvPacket.read_skip<uint32>();
-    recvPacket.read_skip<uint32>();
-    recvPacket.read_skip<uint32>();
-    recvPacket.read_skip<uint64>();
-    recvPacket.read(digest, 20);
+    *recvPacket >> request->clientBuild;
+    *recvPacket >> unk2;
+    *recvPacket >> request->account;
+    recvPacket->read_skip<uint32>();
+    *recvPacket >> request->clientSeed;
+    recvPacket->read_skip<uint32>();
+    recvPacket->read_skip<uint32>();
+    recvPacket->read_skip<uint32>();
+    recvPacket->read_skip<uint64>();
+    recvPacket->read(request->digest, 20);
 
     DEBUG_LOG("WorldSocket::HandleAuthSession: client build %u, account %s, clientseed %X",
-              ClientBuild,
-              account.c_str(),
-              clientSeed);
+              request->clientBuild,
+              request->account.c_str(),
+              request->clientSeed);
 
     // Check the version of client trying to connect
-    if (!IsAcceptableClientBuild(ClientBuild))
+    if (!IsAcceptableClientBuild(request->clientBuild))
     {
         packet.Initialize(SMSG_AUTH_RESPONSE, 1);
         packet << uint8(AUTH_VERSION_MISMATCH);
@@ -357,12 +485,18 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     }
 
     // Get the account information from the realmd database
-    std::string safe_account = account; // Duplicate, else will screw the SHA hash verification below
+    std::string safe_account = request->account; // Duplicate, else will screw the SHA hash verification below
     LoginDatabase.escape_string(safe_account);
     // No SQL injection, username escaped.
 
-    QueryResult* result =
-        LoginDatabase.PQuery("SELECT "
+    // ban and recruit a friend checks are part of the lookup, a single round trip to the login database.
+    // nothing is read from the client until the result is handled, the next header is already encrypted
+    request->packet = std::move(recvPacket);
+    m_authRequest = std::move(request);
+    PauseRead();
+
+    if (!LoginDatabase.AsyncPQuery(&WorldSocket::AccountLookupCallback, shared<WorldSocket>(),
+                             "SELECT "
                              "a.id, "                    //0
                              "gmlevel, "                 //1
                              "sessionkey, "              //2
@@ -375,10 +509,62 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
                              "locale, "                  //9
                              "os, "                      //10
                              "flags, "                   //11
-                             "platform "                 //12
+                             "platform, "                //12
+                             "(SELECT 1 FROM account_banned WHERE account_id = a.id AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)"
+                             " UNION "
+                             "SELECT 1 FROM ip_banned WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'), "  //13
+                             "(SELECT referred FROM account_raf WHERE referrer = a.id LIMIT 1), "  //14
+                             "(SELECT referrer FROM account_raf WHERE referred = a.id LIMIT 1) "   //15
                              "FROM account a "
                              "WHERE username = '%s'",
-                             safe_account.c_str());
+                             GetRemoteAddress().c_str(), safe_account.c_str()))
+    {
+        sLog.outError("WorldSocket::HandleAuthSession: account lookup of %s could not be queued.", safe_account.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void WorldSocket::AccountLookupCallback(QueryResult* result, std::shared_ptr<WorldSocket> socket)
+{
+    // the session handling below waits for reconnecting sessions, not something to do on the world thread
+    socket->Post([socket, result]()
+    {
+        bool authenticated = false;
+        if (socket->IsClosed())
+            delete result;
+        else
+        {
+            try
+            {
+                authenticated = socket->HandleAccountLookup(result);
+            }
+            catch (ByteBufferException&)
+            {
+                sLog.outError("WorldSocket::HandleAuthSession: ByteBufferException occured while parsing CMSG_AUTH_SESSION from client %s.", socket->GetRemoteAddress().c_str());
+            }
+        }
+
+        socket->m_authRequest.reset();
+        if (authenticated)
+            socket->ResumeRead();
+        else if (!socket->IsClosed())
+            socket->Close();
+    });
+}
+
+bool WorldSocket::HandleAccountLookup(QueryResult* result)
+{
+    uint8 const* digest = m_authRequest->digest;
+    uint32 clientSeed = m_authRequest->clientSeed;
+    uint32 ClientBuild = m_authRequest->clientBuild;
+    std::string const& account = m_authRequest->account;
+    WorldPacket& recvPacket = *m_authRequest->packet;
+    LocaleConstant locale;
+    std::string os;
+    BigNumber v, s, g, N, K;
+    WorldPacket packet;
 
     // Stop if the account is not found
     if (!result)
@@ -450,24 +636,19 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 
     uint32 accountFlags = fields[11].GetUInt32();
 	std::string platform = fields[12].GetString();
+    bool banned = !fields[13].IsNULL();
+    uint32 recruited = fields[14].GetUInt32();
+    uint32 recruiter = fields[15].GetUInt32();
 
     delete result;
 
     // Re-check account ban (same check as in realmd)
-    QueryResult* banresult =
-        LoginDatabase.PQuery("SELECT 1 FROM account_banned WHERE account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)"
-                             "UNION "
-                             "SELECT 1 FROM ip_banned WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'",
-                             id, GetRemoteAddress().c_str());
-
-    if (banresult) // if account banned
+    if (banned)
     {
         packet.Initialize(SMSG_AUTH_RESPONSE, 1);
         packet << uint8(AUTH_BANNED);
         SendPacket(packet);
 
-        delete banresult;
-
         sLog.outError("WorldSocket::HandleAuthSession: Sent Auth Response (Account banned).");
         return false;
     }
@@ -536,6 +717,11 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 
     m_crypt.Init(&K);
 
+    m_packetLogAccountId = id;
+    m_packetLogConnectionId = sPacketLog->NewConnectionId();
+    if (sPacketLog->ShouldCaptureSession(id))
+        m_loggingPackets = true;
+
     m_session = sWorld.FindSession(id);
 
     ClientPlatformType clientPlatform;
@@ -596,30 +782,19 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     }
     else
     {
-        uint32 otherRaf = 0;
-        bool isRecruiter = false;
-        {
-            std::unique_ptr<QueryResult> result(LoginDatabase.PQuery("SELECT referrer, referred FROM account_raf WHERE referrer=%u OR referred=%u", id, id));
-            if (result)
-            {
-                Field* fields = result->Fetch();
-                uint32 recruiter = fields[0].GetUInt32();
-                if (id == recruiter)
-                {
-                    isRecruiter = true;
-                    otherRaf = fields[1].GetUInt32();
-                }
-                else
-                    otherRaf = recruiter;
-            }
-        }
+        bool isRecruiter = recruited != 0;
+        uint32 otherRaf = isRecruiter ? recruited : recruiter;
 
         // new session
         if (!(m_session = new WorldSession(id, this, AccountTypes(security), expansion, mutetime, locale, account, accountFlags, otherRaf, isRecruiter)))
             return false;
 
-        m_session->LoadGlobalAccountData();
-        m_session->LoadTutorialsData();
+        // character database is read by the world thread, before any packet of the session is handled
+        m_session->GetMessager().AddMessage([](WorldSession* session)
+        {
+            session->LoadGlobalAccountData();
+            session->LoadTutorialsData();
+        });
         m_session->SetGameBuild(ClientBuild);
         m_session->SetOS(clientOS);
         m_session->SetPlatform(clientPlatform);
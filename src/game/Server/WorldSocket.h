@@ -30,12 +30,17 @@
 #include "Auth/BigNumber.h"
 #include "Network/Socket.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <deque>
+#include <memory>
+#include <string>
+#include <vector>
 
 class WorldPacket;
 class WorldSession;
+class QueryResult;
 
 /**
  * WorldSocket.
@@ -115,27 +120,69 @@ class WorldSocket : public MaNGOS::Socket
         /// process one incoming packet.
         virtual bool ProcessIncomingData() override;
 
-        /// Called by ProcessIncoming() on CMSG_AUTH_SESSION.
-        bool HandleAuthSession(WorldPacket& recvPacket);
+        /// CMSG_AUTH_SESSION content kept while the account is looked up
+        struct AuthSessionRequest
+        {
+            std::unique_ptr<WorldPacket> packet;            // addon info is read once authenticated
+            std::string account;
+            uint32 clientBuild;
+            uint32 clientSeed;
+            uint8 digest[20];
+        };
+
+        std::unique_ptr<AuthSessionRequest> m_authRequest;
+
+        /// Called by ProcessIncoming() on CMSG_AUTH_SESSION, queues the account lookup and pauses the socket.
+        bool HandleAuthSession(std::unique_ptr<WorldPacket> recvPacket);
+
+        /// World thread, passes the account lookup back to the network thread of the socket.
+        static void AccountLookupCallback(QueryResult* result, std::shared_ptr<WorldSocket> socket);
+
+        /// Rest of the authentication on the account row, false closes the socket.
+        bool HandleAccountLookup(QueryResult* result);
 
         /// Called by ProcessIncoming() on CMSG_PING.
         bool HandlePing(WorldPacket& recvPacket);
 
+        /// Encrypt the header and queue the packet, referencing content instead of copying it when given.
+        void WritePacket(const WorldPacket& pct, std::shared_ptr<const uint8> content, bool immediate);
+
         std::mutex m_worldSocketMutex;
 
         std::deque<uint32> m_opcodeHistoryOut;
         std::deque<uint32> m_opcodeHistoryInc;
 
         bool m_loggingPackets;
+        uint32 m_packetLogAccountId;                        // set on auth, tags captured packets
+        uint32 m_packetLogConnectionId;
+
+#ifdef BUILD_BENCHMARKS
+        bool m_replay;                                      // never connected, outgoing packets are only counted
+        std::atomic<uint64> m_replayPacketsSent;
+        std::atomic<uint64> m_replayBytesSent;
+
+        void CountReplayPacket(WorldPacket const& pct);
+#endif
 
     public:
         WorldSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler);
 
         // send a packet \o/
         void SendPacket(const WorldPacket& pct, bool immediate = false);
+        // send a shared packet, large contents are handed to the socket without copying
+        void SendPacket(std::shared_ptr<const WorldPacket> const& pct, bool immediate = false);
+        // send several packets as one write, in the given order
+        void SendPackets(std::vector<std::shared_ptr<const WorldPacket>> const& packets);
 
         void FinalizeSession() { m_session = nullptr; }
 
+#ifdef BUILD_BENCHMARKS
+        // open socket without a peer for the packet replay, it reads nothing and drops what is sent
+        static std::shared_ptr<WorldSocket> CreateReplaySocket(boost::asio::io_service& service);
+        uint64 GetReplayPacketsSent() const { return m_replayPacketsSent.load(std::memory_order_relaxed); }
+        uint64 GetReplayBytesSent() const { return m_replayBytesSent.load(std::memory_order_relaxed); }
+#endif
+
         virtual bool Open() override;
 
         /// Return the session key
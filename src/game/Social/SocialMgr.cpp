@@ -66,14 +66,20 @@ bool PlayerSocial::AddToSocialList(ObjectGuid friend_guid, bool ignore)
     if (ignore)
         flag = SOCIAL_FLAG_IGNORED;
 
-    PlayerSocialMap::const_iterator itr = m_playerSocialMap.find(friend_guid.GetCounter());
+    PlayerSocialMap::iterator itr = m_playerSocialMap.find(friend_guid.GetCounter());
     if (itr != m_playerSocialMap.end())
     {
+        if (!ignore && !(itr->second.Flags & SOCIAL_FLAG_FRIEND))
+            sSocialMgr.AddFriendLister(friend_guid.GetCounter(), m_playerLowGuid);
+
         CharacterDatabase.PExecute("UPDATE character_social SET flags = (flags | %u) WHERE guid = '%u' AND friend = '%u'", flag, m_playerLowGuid, friend_guid.GetCounter());
-        m_playerSocialMap[friend_guid.GetCounter()].Flags |= flag;
+        itr->second.Flags |= flag;
     }
     else
     {
+        if (!ignore)
+            sSocialMgr.AddFriendLister(friend_guid.GetCounter(), m_playerLowGuid);
+
         CharacterDatabase.PExecute("INSERT INTO character_social (guid, friend, flags) VALUES ('%u', '%u', '%u')", m_playerLowGuid, friend_guid.GetCounter(), flag);
         FriendInfo fi;
         fi.Flags |= flag;
@@ -92,6 +98,9 @@ void PlayerSocial::RemoveFromSocialList(ObjectGuid friend_guid, bool ignore)
     if (ignore)
         flag = SOCIAL_FLAG_IGNORED;
 
+    if (!ignore && (itr->second.Flags & SOCIAL_FLAG_FRIEND))
+        sSocialMgr.RemoveFriendLister(friend_guid.GetCounter(), m_playerLowGuid);
+
     itr->second.Flags &= ~flag;
     if (itr->second.Flags == 0)
     {
@@ -176,6 +185,42 @@ SocialMgr::~SocialMgr()
 {
 }
 
+void SocialMgr::RemovePlayerSocial(uint32 guid)
+{
+    SocialMap::iterator itr = m_socialMap.find(guid);
+    if (itr == m_socialMap.end())
+        return;
+
+    for (PlayerSocialMap::const_iterator itr2 = itr->second.m_playerSocialMap.begin(); itr2 != itr->second.m_playerSocialMap.end(); ++itr2)
+        if (itr2->second.Flags & SOCIAL_FLAG_FRIEND)
+            RemoveFriendLister(itr2->first, guid);
+
+    m_socialMap.erase(itr);
+}
+
+void SocialMgr::AddFriendLister(uint32 friendLowGuid, uint32 listerLowGuid)
+{
+    m_friendListers[friendLowGuid].push_back(listerLowGuid);
+}
+
+void SocialMgr::RemoveFriendLister(uint32 friendLowGuid, uint32 listerLowGuid)
+{
+    FriendListerMap::iterator itr = m_friendListers.find(friendLowGuid);
+    if (itr == m_friendListers.end())
+        return;
+
+    std::vector<uint32>& listers = itr->second;
+    std::vector<uint32>::iterator lister = std::find(listers.begin(), listers.end(), listerLowGuid);
+    if (lister != listers.end())
+    {
+        *lister = listers.back();
+        listers.pop_back();
+    }
+
+    if (listers.empty())
+        m_friendListers.erase(itr);
+}
+
 void SocialMgr::GetFriendInfo(Player* player, uint32 friend_lowguid, FriendInfo& friendInfo) const
 {
     if (!player)
@@ -273,28 +318,31 @@ void SocialMgr::BroadcastToFriendListers(Player* player, WorldPacket const& pack
     AccountTypes gmLevelInWhoList = AccountTypes(sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_IN_WHO_LIST));
     bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST);
 
-    for (SocialMap::const_iterator itr = m_socialMap.begin(); itr != m_socialMap.end(); ++itr)
+    FriendListerMap::const_iterator itr = m_friendListers.find(guid);
+    if (itr == m_friendListers.end())
+        return;
+
+    for (uint32 listerGuid : itr->second)
     {
-        PlayerSocialMap::const_iterator itr2 = itr->second.m_playerSocialMap.find(guid);
-        if (itr2 != itr->second.m_playerSocialMap.end() && (itr2->second.Flags & SOCIAL_FLAG_FRIEND))
+        Player* pFriend = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, listerGuid));
+
+        // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
+        // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
+        if (pFriend && pFriend->IsInWorld() &&
+                (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
+                 ((pFriend->GetTeam() == team || allowTwoSideWhoList) && security <= gmLevelInWhoList)) &&
+                player->IsVisibleGloballyFor(pFriend))
         {
-            Player* pFriend = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
-
-            // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
-            // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
-            if (pFriend && pFriend->IsInWorld() &&
-                    (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
-                     ((pFriend->GetTeam() == team || allowTwoSideWhoList) && security <= gmLevelInWhoList)) &&
-                    player->IsVisibleGloballyFor(pFriend))
-            {
-                pFriend->GetSession()->SendPacket(packet);
-            }
+            pFriend->GetSession()->SendPacket(packet);
         }
     }
 }
 
 PlayerSocial* SocialMgr::LoadFromDB(QueryResult* result, ObjectGuid guid)
 {
+    // a social left from an earlier login of the character would keep stale listers
+    RemovePlayerSocial(guid.GetCounter());
+
     PlayerSocial* social = &m_socialMap[guid.GetCounter()];
     social->SetPlayerGuid(guid);
 
@@ -318,6 +366,8 @@ PlayerSocial* SocialMgr::LoadFromDB(QueryResult* result, ObjectGuid guid)
             continue;
 
         social->m_playerSocialMap[friend_guid] = FriendInfo(flags, note);
+        if (flags & SOCIAL_FLAG_FRIEND)
+            AddFriendLister(friend_guid, guid.GetCounter());
 
         if (flags & SOCIAL_FLAG_IGNORED)
             ++ignoreCounter;
@@ -137,7 +137,11 @@ class SocialMgr
         SocialMgr();
         ~SocialMgr();
         // Misc
-        void RemovePlayerSocial(uint32 guid) { m_socialMap.erase(guid); }
+        void RemovePlayerSocial(uint32 guid);
+
+        // reverse index of the loaded socials, friend -> players having him in their friend list
+        void AddFriendLister(uint32 friendLowGuid, uint32 listerLowGuid);
+        void RemoveFriendLister(uint32 friendLowGuid, uint32 listerLowGuid);
 
         void GetFriendInfo(Player* player, uint32 friend_lowguid, FriendInfo& friendInfo) const;
         // Packet management
@@ -147,7 +151,10 @@ class SocialMgr
         // Loading
         PlayerSocial* LoadFromDB(QueryResult* result, ObjectGuid guid);
     private:
+        typedef std::unordered_map<uint32, std::vector<uint32>> FriendListerMap;
+
         SocialMap m_socialMap;
+        FriendListerMap m_friendListers;                    // only socials of online players are loaded, so only online listers
 };
 
 #define sSocialMgr MaNGOS::Singleton<SocialMgr>::Instance()
@@ -0,0 +1,162 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Social/WhoListIndex.h"
+#include "Entities/Player.h"
+#include "Util/Util.h"
+
+std::mutex WhoListIndex::m_lock;
+std::unordered_map<ObjectGuid, WhoListIndex::Node> WhoListIndex::m_players;
+WhoListIndex::Bucket WhoListIndex::m_levels[PVP_TEAM_COUNT][STRONG_MAX_LEVEL + 1];
+std::unordered_map<uint32, WhoListIndex::Bucket> WhoListIndex::m_zones[PVP_TEAM_COUNT];
+
+void WhoListIndex::Insert(Player* player)
+{
+    std::wstring name;
+    if (Utf8toWStr(player->GetNameStr(), name))
+        wstrToLower(name);
+    else
+        name.clear();
+
+    uint32 const zoneId = player->GetZoneId();
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto result = m_players.emplace(player->GetObjectGuid(), Node());
+    Node& node = result.first->second;
+    if (!result.second)
+        Unlink(&node);
+
+    node.player = player;
+    node.level = std::min(player->GetLevel(), uint32(STRONG_MAX_LEVEL));
+    node.zoneId = zoneId;
+    node.name = std::move(name);
+    node.team = GetTeamIndexByTeamId(player->GetTeam());
+    Link(&node);
+}
+
+void WhoListIndex::Remove(Player* player)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_players.find(player->GetObjectGuid());
+    if (itr == m_players.end() || itr->second.player != player)
+        return;
+
+    Unlink(&itr->second);
+    m_players.erase(itr);
+}
+
+void WhoListIndex::UpdateLevel(Player* player, uint32 level)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_players.find(player->GetObjectGuid());
+    if (itr == m_players.end() || itr->second.player != player)
+        return;
+
+    Node& node = itr->second;
+    level = std::min(level, uint32(STRONG_MAX_LEVEL));
+    if (node.level == level)
+        return;
+
+    Erase(m_levels[node.team][node.level], node.levelPos, true);
+    node.level = level;
+    Bucket& bucket = m_levels[node.team][level];
+    node.levelPos = bucket.size();
+    bucket.push_back(&node);
+}
+
+void WhoListIndex::UpdateZone(Player* player, uint32 zoneId)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_players.find(player->GetObjectGuid());
+    if (itr == m_players.end() || itr->second.player != player)
+        return;
+
+    Node& node = itr->second;
+    if (node.zoneId == zoneId)
+        return;
+
+    Erase(m_zones[node.team][node.zoneId], node.zonePos, false);
+    node.zoneId = zoneId;
+    Bucket& bucket = m_zones[node.team][zoneId];
+    node.zonePos = bucket.size();
+    bucket.push_back(&node);
+}
+
+void WhoListIndex::Search(Query const& query, std::function<void(Entry const&)> const& visitor)
+{
+    uint32 const levelMax = std::min(query.levelMax, uint32(STRONG_MAX_LEVEL));
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (uint32 team = 0; team < PVP_TEAM_COUNT; ++team)
+    {
+        if (!(query.teamMask & (1 << team)))
+            continue;
+
+        if (query.zoneIds.empty())
+        {
+            for (uint32 level = query.levelMin; level <= levelMax; ++level)
+                for (Node const* node : m_levels[team][level])
+                    visitor(*node);
+            continue;
+        }
+
+        for (size_t i = 0; i < query.zoneIds.size(); ++i)
+        {
+            // the client may list a zone twice
+            if (std::find(query.zoneIds.begin(), query.zoneIds.begin() + i, query.zoneIds[i]) != query.zoneIds.begin() + i)
+                continue;
+
+            auto itr = m_zones[team].find(query.zoneIds[i]);
+            if (itr == m_zones[team].end())
+                continue;
+
+            for (Node const* node : itr->second)
+                if (node->level >= query.levelMin && node->level <= levelMax)
+                    visitor(*node);
+        }
+    }
+}
+
+void WhoListIndex::Link(Node* node)
+{
+    Bucket& levelBucket = m_levels[node->team][node->level];
+    node->levelPos = levelBucket.size();
+    levelBucket.push_back(node);
+
+    Bucket& zoneBucket = m_zones[node->team][node->zoneId];
+    node->zonePos = zoneBucket.size();
+    zoneBucket.push_back(node);
+}
+
+void WhoListIndex::Unlink(Node* node)
+{
+    Erase(m_levels[node->team][node->level], node->levelPos, true);
+    Erase(m_zones[node->team][node->zoneId], node->zonePos, false);
+}
+
+void WhoListIndex::Erase(Bucket& bucket, size_t pos, bool isLevel)
+{
+    // the last node takes the place of the removed one
+    Node* moved = bucket.back();
+    bucket[pos] = moved;
+    if (isLevel)
+        moved->levelPos = pos;
+    else
+        moved->zonePos = pos;
+    bucket.pop_back();
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WHOLISTINDEX_H
+#define MANGOS_WHOLISTINDEX_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+#include "Globals/SharedDefines.h"
+#include "Server/DBCEnums.h"
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Player;
+
+// Online players bucketed by team and level and by team and zone for CMSG_WHO, a query
+// only visits the buckets its level range or zone list selects. Kept current from login,
+// logout, level and zone changes, the case folded name is converted once at login.
+class WhoListIndex
+{
+    public:
+        struct Entry
+        {
+            Player* player;
+            uint32 level;
+            uint32 zoneId;
+            std::wstring name;                              // lower case, empty when the name is no valid utf8
+        };
+
+        struct Query
+        {
+            uint32 levelMin;
+            uint32 levelMax;
+            uint32 teamMask;                                // 1 << PvpTeamIndex
+            std::vector<uint32> zoneIds;                    // empty for any zone
+        };
+
+        static void Insert(Player* player);
+        static void Remove(Player* player);
+        static void UpdateLevel(Player* player, uint32 level);
+        static void UpdateZone(Player* player, uint32 zoneId);
+
+        // calls the visitor for every player of the selected teams in the level range and zones, under the index lock
+        static void Search(Query const& query, std::function<void(Entry const&)> const& visitor);
+
+    private:
+        struct Node : Entry
+        {
+            uint32 team;                                    // PvpTeamIndex
+            size_t levelPos;
+            size_t zonePos;
+        };
+
+        typedef std::vector<Node*> Bucket;
+
+        static void Link(Node* node);
+        static void Unlink(Node* node);
+        static void Erase(Bucket& bucket, size_t pos, bool isLevel);
+
+        // Non instanceable only static
+        WhoListIndex() {}
+
+        static std::mutex m_lock;
+        static std::unordered_map<ObjectGuid, Node> m_players;
+        static Bucket m_levels[PVP_TEAM_COUNT][STRONG_MAX_LEVEL + 1];
+        static std::unordered_map<uint32, Bucket> m_zones[PVP_TEAM_COUNT];
+};
+
+#endif
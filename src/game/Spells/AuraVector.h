@@ -0,0 +1,144 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_AURAVECTOR_H
+#define MANGOS_AURAVECTOR_H
+
+#include "Platform/Define.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+class Aura;
+
+// Auras of one modifier type, walked by almost every damage, stat and movement calculation. Stored in one
+// contiguous array in apply order. Removing an aura only leaves a hole, so iterators stay valid while auras
+// are added or removed during iteration; holes are closed by Compact() once the owner is sure nothing iterates.
+// end() is not tied to the size it was taken at, so a range-for also walks auras appended while it runs.
+class AuraVector
+{
+    public:
+        class const_iterator
+        {
+            friend class AuraVector;
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef Aura* value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef Aura* const* pointer;
+                typedef Aura* const& reference;
+
+                const_iterator() : m_list(nullptr), m_index(0) {}
+
+                reference operator*() const { return m_list->m_auras[m_index]; }
+                pointer operator->() const { return &m_list->m_auras[m_index]; }
+
+                const_iterator& operator++() { m_index = m_list->NextLive(m_index + 1); return *this; }
+                const_iterator operator++(int) { const_iterator tmp = *this; ++(*this); return tmp; }
+                const_iterator& operator--() { m_index = m_list->PrevLive(Position()); return *this; }
+                const_iterator operator--(int) { const_iterator tmp = *this; --(*this); return tmp; }
+
+                bool operator==(const_iterator const& other) const { return m_list == other.m_list && Position() == other.Position(); }
+                bool operator!=(const_iterator const& other) const { return !(*this == other); }
+
+            private:
+                const_iterator(AuraVector const* list, size_t index) : m_list(list), m_index(index) {}
+
+                // any index at or past the current size is end
+                size_t Position() const { return m_list ? std::min(m_index, m_list->m_auras.size()) : m_index; }
+
+                AuraVector const* m_list;
+                size_t m_index;
+        };
+        typedef const_iterator iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef const_reverse_iterator reverse_iterator;
+        typedef Aura* value_type;
+
+        AuraVector() : m_live(0) {}
+
+        const_iterator begin() const { return const_iterator(this, NextLive(0)); }
+        const_iterator end() const { return const_iterator(this, SIZE_MAX); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        bool empty() const { return m_live == 0; }
+        size_t size() const { return m_live; }
+        Aura* front() const { return *begin(); }
+        Aura* back() const { return *--end(); }
+
+        void push_back(Aura* aura)
+        {
+            m_auras.push_back(aura);
+            ++m_live;
+        }
+
+        void remove(Aura* aura)
+        {
+            for (Aura*& entry : m_auras)
+            {
+                if (entry == aura)
+                {
+                    entry = nullptr;
+                    --m_live;
+                }
+            }
+        }
+
+        // returns iterator to the next aura, other iterators remain valid
+        const_iterator erase(const_iterator itr)
+        {
+            m_auras[itr.m_index] = nullptr;
+            --m_live;
+            return const_iterator(this, NextLive(itr.m_index + 1));
+        }
+
+        void clear()
+        {
+            m_auras.clear();
+            m_live = 0;
+        }
+
+        // keeps apply order, must not be called while the list is iterated
+        void Compact()
+        {
+            if (m_live != m_auras.size())
+                m_auras.erase(std::remove(m_auras.begin(), m_auras.end(), nullptr), m_auras.end());
+        }
+
+    private:
+        size_t NextLive(size_t index) const
+        {
+            while (index < m_auras.size() && !m_auras[index])
+                ++index;
+            return index;
+        }
+
+        size_t PrevLive(size_t index) const
+        {
+            do --index;
+            while (!m_auras[index]);
+            return index;
+        }
+
+        std::vector<Aura*> m_auras;                         // nullptr for removed auras until compacted
+        size_t m_live;
+};
+
+#endif
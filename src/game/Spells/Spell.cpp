@@ -590,6 +590,37 @@ WorldObject* Spell::FindCorpseUsing()
 
 void Spell::FillTargetMap()
 {
+    // candidates only stay valid while the target map is filled in one go
+    struct AreaCandidatesScope
+    {
+        explicit AreaCandidatesScope(AreaTargetCandidates& candidates) : m_candidates(candidates)
+        {
+            m_candidates.enabled = true;
+            m_candidates.filled = false;
+        }
+        ~AreaCandidatesScope()
+        {
+            m_candidates.enabled = false;
+            m_candidates.filled = false;
+            m_candidates.units.clear();
+        }
+        AreaTargetCandidates& m_candidates;
+    } areaCandidatesScope(m_areaCandidates);
+
+    // search once with the largest area radius so effects with smaller areas reuse the result
+    m_areaCandidates.searchRadius = 0.f;
+    for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+    {
+        if (m_spellInfo->Effect[i] == SPELL_EFFECT_NONE)
+            continue;
+        if (SpellTargetInfoTable[m_spellInfo->EffectImplicitTargetA[i]].enumerator != TARGET_ENUMERATOR_AOE &&
+            SpellTargetInfoTable[m_spellInfo->EffectImplicitTargetB[i]].enumerator != TARGET_ENUMERATOR_AOE)
+            continue;
+        float const radius = GetSpellRadius(sSpellRadiusStore.LookupEntry(m_spellInfo->EffectRadiusIndex[i]));
+        if (radius < MAX_VISIBILITY_DISTANCE)
+            m_areaCandidates.searchRadius = std::max(m_areaCandidates.searchRadius, radius);
+    }
+
     TempTargetingData targetingData;
     uint8 effToIndex[MAX_EFFECT_INDEX] = {0, 1, 2};         // Helper array, to link to another tmpUnitList, if the targets for both effects match
 
@@ -808,6 +839,9 @@ bool Spell::FillUnitTargets(TempTargetingData& targetingData, SpellTargetingData
         SpellTargetImplicitType type = SpellTargetInfoTable[target].type;
         if (!unitTargetList.empty()) // Unit case
         {
+            if (!targetingData.magnet)
+                PrefetchTargetsLOS(unitTargetList, SpellEffectIndex(i), target);
+
             for (auto itr = unitTargetList.begin(); itr != unitTargetList.end();)
             {
                 if (!CheckTarget(*itr, SpellEffectIndex(i), bool(rightTarget), CheckException(targetingData.magnet)))
@@ -1496,6 +1530,9 @@ void Spell::DoSpellHitOnUnit(Unit* unit, uint32 effectMask, TargetInfo* target,
     if (!unit)
         return;
 
+    if (unit->IsCreature())
+        static_cast<Creature*>(unit)->WakeFromDormancy();
+
     const bool traveling = m_spellState == SPELL_STATE_TRAVELING;
 
     // Recheck immune (only for delayed spells)
@@ -8223,6 +8260,78 @@ CurrentSpellTypes Spell::GetCurrentContainer() const
     return (CURRENT_GENERIC_SPELL);
 }
 
+/**
+ * Traces the line of sight of all area targets against their common point as one batch per target height,
+ * the results land in the map line of sight cache where the CheckTarget calls that follow find them
+ */
+void Spell::PrefetchTargetsLOS(UnitList const& targets, SpellEffectIndex eff, uint32 targetType) const
+{
+    if (targets.size() < 2 || !sWorld.getConfig(CONFIG_BOOL_VMAP_LOS_CACHE) || IsIgnoreLosSpellEffect(m_spellInfo, eff))
+        return;
+
+    switch (m_spellInfo->Effect[eff])
+    {
+        case SPELL_EFFECT_SUMMON_PLAYER:
+        case SPELL_EFFECT_RESURRECT_NEW:
+            return;
+        default:
+            break;
+    }
+
+    SpellTargetInfo const& info = SpellTargetInfoTable[targetType];
+    float x, y, z;
+    bool addTargetHeight = true;
+    switch (info.los)
+    {
+        case TARGET_LOS_DEST:
+            m_targets.getDestination(x, y, z);
+            break;
+        case TARGET_LOS_SRC:
+            m_targets.getSource(x, y, z);
+            break;
+        case TARGET_LOS_CASTER:
+        {
+            if (info.enumerator == TARGET_ENUMERATOR_CHAIN || m_spellInfo->EffectImplicitTargetA[eff] == TARGET_LOCATION_CHANNEL_TARGET_DEST)
+                return;
+            WorldObject* caster = GetCastingObject();
+            if (!caster)
+                return;
+            caster->GetPosition(x, y, z);
+            z += caster->GetCollisionHeight();
+            addTargetHeight = false;
+            break;
+        }
+        default:
+            return;
+    }
+
+    // the point is raised by the height of each target, so only targets of the same height and phase share an origin
+    std::vector<Unit*> pending(targets.begin(), targets.end());
+    std::vector<Position> points;
+    std::vector<bool> results;
+    while (!pending.empty())
+    {
+        float const height = pending.front()->GetCollisionHeight();
+        uint32 const phaseMask = pending.front()->GetPhaseMask();
+        points.clear();
+        for (auto itr = pending.begin(); itr != pending.end();)
+        {
+            Unit* target = *itr;
+            if (target->GetPhaseMask() != phaseMask || (addTargetHeight && target->GetCollisionHeight() != height))
+            {
+                ++itr;
+                continue;
+            }
+
+            points.emplace_back(target->GetPositionX(), target->GetPositionY(), target->GetPositionZ() + target->GetCollisionHeight());
+            itr = pending.erase(itr);
+        }
+
+        if (points.size() > 1)
+            m_trueCaster->GetMap()->IsInLineOfSight(x, y, addTargetHeight ? z + height : z, points, phaseMask, true, results);
+    }
+}
+
 bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckException exception) const
 {
     // Check targets for creature type mask and remove not appropriate (skip explicit self target case, maybe need other explicit targets)
@@ -8646,7 +8755,26 @@ SpellCastResult Spell::CanOpenLock(SpellEffectIndex effIndex, uint32 lockId, Ski
 void Spell::FillAreaTargets(UnitList& targetUnitMap, float radius, float cone, SpellNotifyPushType pushType, SpellTargets spellTargets, WorldObject* originalCaster /*=nullptr*/)
 {
     MaNGOS::SpellNotifierCreatureAndPlayer notifier(*this, targetUnitMap, radius, cone, pushType, spellTargets, originalCaster);
-    Cell::VisitAllObjects(notifier.GetCenterX(), notifier.GetCenterY(), m_trueCaster->GetMap(), notifier, radius);
+    if (!m_areaCandidates.enabled)
+    {
+        Cell::VisitAllObjects(notifier.GetCenterX(), notifier.GetCenterY(), m_trueCaster->GetMap(), notifier, radius);
+        return;
+    }
+
+    AreaTargetCandidates& candidates = m_areaCandidates;
+    if (!candidates.filled || candidates.x != notifier.GetCenterX() || candidates.y != notifier.GetCenterY() || candidates.radius < radius)
+    {
+        candidates.units.clear();
+        candidates.x = notifier.GetCenterX();
+        candidates.y = notifier.GetCenterY();
+        candidates.radius = std::max(radius, candidates.searchRadius);
+        candidates.filled = true;
+
+        MaNGOS::SpellAreaCandidateCollector collector(candidates.units);
+        Cell::VisitAllObjects(candidates.x, candidates.y, m_trueCaster->GetMap(), collector, candidates.radius);
+    }
+
+    notifier.Visit(candidates.units);
 }
 
 void Spell::FillRaidOrPartyTargets(UnitList& targetUnitMap, Unit* member, Unit* center, float radius, bool raid, bool withPets, bool withcaster) const
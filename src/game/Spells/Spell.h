@@ -20,6 +20,7 @@
 #define __SPELL_H
 
 #include "Common.h"
+#include "Util/BlockPool.h"
 #include "Maps/GridDefines.h"
 #include "Globals/SharedDefines.h"
 #include "Server/DBCEnums.h"
@@ -97,6 +98,7 @@ namespace MaNGOS
 {
     struct SpellNotifierPlayer;
     struct SpellNotifierCreatureAndPlayer;
+    struct SpellAreaCandidateCollector;
 }
 
 class SpellCastTargets;
@@ -529,6 +531,8 @@ class Spell
         Spell(WorldObject* caster, SpellEntry const* info, uint32 triggeredFlags, ObjectGuid originalCasterGUID = ObjectGuid(), SpellEntry const* triggeredBy = nullptr);
         virtual ~Spell();
 
+        BLOCK_POOL_ALLOCATED
+
         SpellCastResult SpellStart(SpellCastTargets const* targets, Aura* triggeredByAura = nullptr);
 
         void cancel();
@@ -609,6 +613,7 @@ class Spell
         template<typename T> WorldObject* FindCorpseUsing();
 
         bool CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckException exception = EXCEPTION_NONE) const;
+        void PrefetchTargetsLOS(UnitList const& targets, SpellEffectIndex eff, uint32 targetType) const;
         bool CanAutoCast(Unit* target);
 
         static void SendCastResult(Player const* caster, SpellEntry const* spellInfo, uint8 cast_count, SpellCastResult result, bool isPetCastResult = false, uint32 param1 = 0, uint32 param2 = 0);
@@ -1056,6 +1061,22 @@ class Spell
         float m_castOrientation;
 
         uint32 m_affectedTargetCount;
+
+        // units around one center gathered by a single grid search while FillTargetMap runs,
+        // area searches of further effects around the same center filter this list instead
+        struct AreaTargetCandidates
+        {
+            AreaTargetCandidates() : enabled(false), filled(false), x(0.f), y(0.f), radius(0.f), searchRadius(0.f) {}
+
+            std::vector<Unit*> units;
+            bool enabled;
+            bool filled;
+            float x;
+            float y;
+            float radius;                                   // radius the units were gathered for
+            float searchRadius;                             // largest area radius among the effects of the spell
+        };
+        AreaTargetCandidates m_areaCandidates;
         uint32 m_chainTargetCount[MAX_EFFECT_INDEX];
         float m_jumpRadius;
         SpellTargetFilterScheme m_filteringScheme[MAX_EFFECT_INDEX][2];
@@ -1204,81 +1225,94 @@ namespace MaNGOS
                 return;
 
             for (typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
+                AddIfValid(itr->getSource());
+        }
+
+        // filters candidates gathered beforehand by SpellAreaCandidateCollector
+        void Visit(std::vector<Unit*> const& candidates)
+        {
+            if (!i_originalCaster || !i_castingObject)
+                return;
+
+            for (Unit* target : candidates)
+                AddIfValid(target);
+        }
+
+        void AddIfValid(Unit* target)
+        {
+            // there are still more spells which can be casted on dead, but
+            // they are no AOE and don't have such a nice SPELL_ATTR flag
+            // mostly phase check
+            if (i_spell.m_spellInfo->HasAttribute(SPELL_ATTR_EX6_IGNORE_PHASE_SHIFT))
             {
-                // there are still more spells which can be casted on dead, but
-                // they are no AOE and don't have such a nice SPELL_ATTR flag
-                // mostly phase check
-                if (i_spell.m_spellInfo->HasAttribute(SPELL_ATTR_EX6_IGNORE_PHASE_SHIFT))
-                {
-                    if (!itr->getSource()->IsInMapIgnorePhase(i_originalCaster))
-                        continue;
-                }
-                else if (!itr->getSource()->IsInMap(i_originalCaster))
-                    continue;
+                if (!target->IsInMapIgnorePhase(i_originalCaster))
+                    return;
+            }
+            else if (!target->IsInMap(i_originalCaster))
+                return;
 
-                if (itr->getSource()->IsTaxiFlying())
-                    continue;
+            if (target->IsTaxiFlying())
+                return;
 
-                if (itr->getSource()->IsAOEImmune())
-                    continue;
+            if (target->IsAOEImmune())
+                return;
 
-                switch (i_TargetType)
+            switch (i_TargetType)
+            {
+                case SPELL_TARGETS_ASSISTABLE:
+                    if (!i_originalCaster->CanAssistSpell(target, i_spell.m_spellInfo))
+                        return;
+                    break;
+                case SPELL_TARGETS_AOE_ATTACKABLE:
                 {
-                    case SPELL_TARGETS_ASSISTABLE:
-                        if (!i_originalCaster->CanAssistSpell(itr->getSource(), i_spell.m_spellInfo))
-                            continue;
-                        break;
-                    case SPELL_TARGETS_AOE_ATTACKABLE:
-                    {
-                        if (!i_originalCaster->CanAttackSpell(itr->getSource(), i_spell.m_spellInfo, !i_spell.m_spellInfo->HasAttribute(SPELL_ATTR_EX5_IGNORE_AREA_EFFECT_PVP_CHECK)))
-                            continue;
-                        break;
-                    }
-                    case SPELL_TARGETS_ALL:
-                        break;
-                    default: continue;
+                    if (!i_originalCaster->CanAttackSpell(target, i_spell.m_spellInfo, !i_spell.m_spellInfo->HasAttribute(SPELL_ATTR_EX5_IGNORE_AREA_EFFECT_PVP_CHECK)))
+                        return;
+                    break;
                 }
+                case SPELL_TARGETS_ALL:
+                    break;
+                default: return;
+            }
 
-                // we don't need to check InMap here, it's already done some lines above
-                switch (i_push_type)
+            // we don't need to check InMap here, it's already done some lines above
+            switch (i_push_type)
+            {
+                case PUSH_CONE:
                 {
-                    case PUSH_CONE:
+                    float heightDifference = std::abs(target->GetPositionZ() - i_centerZ);
+                    float maxHeight = i_radius / 2;
+                    float distance = std::min(sqrtf(target->GetDistance2d(i_centerX, i_centerY, DIST_CALC_NONE)), i_radius);
+                    float ratio = distance / i_radius;
+                    float conalMaxHeight = maxHeight * ratio; // pvp combat uses true cone from roughly model
+                    if (!i_originalCaster->IsControlledByPlayer() && target->IsControlledByPlayer())
+                        conalMaxHeight = maxHeight; // npcs just do a conal max Z aoe
+                    if (i_cone >= 0.f)
+                    {
+                        if (i_castingObject->isInFront(target, i_radius, i_cone) &&
+                            std::abs(target->GetPositionZ() - i_centerZ) - target->GetCombatReach() <= conalMaxHeight)
+                            i_data.push_back(target);
+                    }
+                    else
                     {
-                        float heightDifference = std::abs(itr->getSource()->GetPositionZ() - i_centerZ);
-                        float maxHeight = i_radius / 2;
-                        float distance = std::min(sqrtf(itr->getSource()->GetDistance2d(i_centerX, i_centerY, DIST_CALC_NONE)), i_radius);
-                        float ratio = distance / i_radius;
-                        float conalMaxHeight = maxHeight * ratio; // pvp combat uses true cone from roughly model
-                        if (!i_originalCaster->IsControlledByPlayer() && itr->getSource()->IsControlledByPlayer())
-                            conalMaxHeight = maxHeight; // npcs just do a conal max Z aoe
-                        if (i_cone >= 0.f)
-                        {
-                            if (i_castingObject->isInFront(itr->getSource(), i_radius, i_cone) &&
-                                std::abs(itr->getSource()->GetPositionZ() - i_centerZ) - itr->getSource()->GetCombatReach() <= conalMaxHeight)
-                                i_data.push_back(itr->getSource());
-                        }
-                        else
-                        {
-                            if (i_castingObject->isInBack(itr->getSource(), i_radius, -i_cone) &&
-                                std::abs(itr->getSource()->GetPositionZ() - i_centerZ) - itr->getSource()->GetCombatReach() <= conalMaxHeight)
-                                i_data.push_back(itr->getSource());
-                        }
-                        break;
+                        if (i_castingObject->isInBack(target, i_radius, -i_cone) &&
+                            std::abs(target->GetPositionZ() - i_centerZ) - target->GetCombatReach() <= conalMaxHeight)
+                            i_data.push_back(target);
                     }
-                    case PUSH_SELF_CENTER:
-                        if (itr->getSource()->GetDistance2d(i_centerX, i_centerY, DIST_CALC_COMBAT_REACH) <= i_radius)
-                            i_data.push_back(itr->getSource());
-                        break;
-                    case PUSH_SRC_CENTER:
-                    case PUSH_DEST_CENTER:
-                    case PUSH_TARGET_CENTER:
-                        float radius = i_radius;
-                        if (i_originalCaster->IsControlledByPlayer() && !itr->getSource()->IsControlledByPlayer())
-                            radius += itr->getSource()->GetCombatReach();
-                        if (itr->getSource()->GetDistance(i_centerX, i_centerY, i_centerZ, DIST_CALC_NONE) <= radius * radius)
-                            i_data.push_back(itr->getSource());
-                        break;
+                    break;
                 }
+                case PUSH_SELF_CENTER:
+                    if (target->GetDistance2d(i_centerX, i_centerY, DIST_CALC_COMBAT_REACH) <= i_radius)
+                        i_data.push_back(target);
+                    break;
+                case PUSH_SRC_CENTER:
+                case PUSH_DEST_CENTER:
+                case PUSH_TARGET_CENTER:
+                    float radius = i_radius;
+                    if (i_originalCaster->IsControlledByPlayer() && !target->IsControlledByPlayer())
+                        radius += target->GetCombatReach();
+                    if (target->GetDistance(i_centerX, i_centerY, i_centerZ, DIST_CALC_NONE) <= radius * radius)
+                        i_data.push_back(target);
+                    break;
             }
         }
 
@@ -1290,6 +1324,28 @@ namespace MaNGOS
 #endif
     };
 
+    // gathers every unit of the visited cells, filtering is left to SpellNotifierCreatureAndPlayer
+    struct SpellAreaCandidateCollector
+    {
+        std::vector<Unit*>& i_data;
+
+        explicit SpellAreaCandidateCollector(std::vector<Unit*>& data) : i_data(data) {}
+
+        void Visit(PlayerMapType& m)
+        {
+            for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+                i_data.push_back(itr->getSource());
+        }
+
+        void Visit(CreatureMapType& m)
+        {
+            for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+                i_data.push_back(itr->getSource());
+        }
+
+        template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
+    };
+
 #ifndef _MSC_VER
     template<> inline void SpellNotifierCreatureAndPlayer::Visit(CorpseMapType&) {}
     template<> inline void SpellNotifierCreatureAndPlayer::Visit(GameObjectMapType&) {}
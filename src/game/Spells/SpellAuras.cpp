@@ -6633,6 +6633,8 @@ void Aura::HandleAuraModStat(bool apply, bool /*Real*/)
             target->RemoveAurasTriggeredBySpell(GetId(), GetCasterGuid()); // just do it every time, lookup is too time consuming
     }
 
+    // misc -1 and -2 change all stats, the values depending on them are recalculated once
+    StatUpdateScope statUpdates(*target);
     for (int32 i = STAT_STRENGTH; i < MAX_STATS; ++i)
     {
         // -1 or -2 is all stats ( misc < -2 checked in function beginning )
@@ -6659,6 +6661,7 @@ void Aura::HandleModPercentStat(bool apply, bool /*Real*/)
     if (GetTarget()->GetTypeId() != TYPEID_PLAYER)
         return;
 
+    StatUpdateScope statUpdates(*GetTarget());
     for (int32 i = STAT_STRENGTH; i < MAX_STATS; ++i)
     {
         if (m_modifier.m_miscvalue == i || m_modifier.m_miscvalue == -1)
@@ -6735,13 +6738,17 @@ void Aura::HandleModTotalPercentStat(bool apply, bool /*Real*/)
     uint32 curHPValue = target->GetHealth();
     uint32 maxHPValue = target->GetMaxHealth();
 
-    for (int32 i = STAT_STRENGTH; i < MAX_STATS; ++i)
     {
-        if (m_modifier.m_miscvalue == i || m_modifier.m_miscvalue == -1)
+        // max health below must see the recalculated stamina
+        StatUpdateScope statUpdates(*target);
+        for (int32 i = STAT_STRENGTH; i < MAX_STATS; ++i)
         {
-            target->HandleStatModifier(UnitMods(UNIT_MOD_STAT_START + i), TOTAL_PCT, float(m_modifier.m_amount), apply);
-            if (target->GetTypeId() == TYPEID_PLAYER || ((Creature*)target)->IsPet())
-                target->ApplyStatPercentBuffMod(Stats(i), float(m_modifier.m_amount), apply);
+            if (m_modifier.m_miscvalue == i || m_modifier.m_miscvalue == -1)
+            {
+                target->HandleStatModifier(UnitMods(UNIT_MOD_STAT_START + i), TOTAL_PCT, float(m_modifier.m_amount), apply);
+                if (target->GetTypeId() == TYPEID_PLAYER || ((Creature*)target)->IsPet())
+                    target->ApplyStatPercentBuffMod(Stats(i), float(m_modifier.m_amount), apply);
+            }
         }
     }
 
@@ -19,6 +19,7 @@
 #define MANGOS_SPELLAURAS_H
 
 #include "Spells/SpellAuraDefines.h"
+#include "Util/BlockPool.h"
 #include "Server/DBCEnums.h"
 #include "Entities/ObjectGuid.h"
 #include "Spells/Scripts/SpellScript.h"
@@ -94,6 +95,9 @@ class SpellAuraHolder
     public:
         SpellAuraHolder(SpellEntry const* spellproto, Unit* target, WorldObject* caster, Item* castItem, SpellEntry const* triggeredBy);
         ~SpellAuraHolder();
+
+        BLOCK_POOL_ALLOCATED
+
         Aura* m_auras[MAX_EFFECT_INDEX];
 
         void AddAura(Aura* aura, SpellEffectIndex index);
@@ -461,6 +465,8 @@ class Aura
 
         virtual ~Aura();
 
+        BLOCK_POOL_ALLOCATED
+
         void SetModifier(AuraType type, int32 amount, uint32 periodicTime, int32 miscValue);
         Modifier*       GetModifier()       { return &m_modifier; }
         Modifier const* GetModifier() const { return &m_modifier; }
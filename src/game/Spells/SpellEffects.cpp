@@ -6044,7 +6044,7 @@ void Spell::EffectSummonType(SpellEffectIndex eff_idx)
     {
         realCaster->GetPosition(summonPositions[0].x, summonPositions[0].y, summonPositions[0].z);
         // TODO - Is this really an error?
-        sLog.outDebug("Spell Effect EFFECT_SUMMON (%u) - summon without destination (spell id %u, effIndex %u)", m_spellInfo->Effect[eff_idx], m_spellInfo->Id, eff_idx);
+        DEBUG_LOG("Spell Effect EFFECT_SUMMON (%u) - summon without destination (spell id %u, effIndex %u)", m_spellInfo->Effect[eff_idx], m_spellInfo->Id, eff_idx);
     }
 
     // Set summon positions
@@ -0,0 +1,71 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SPELLIDTABLE_H
+#define MANGOS_SPELLIDTABLE_H
+
+#include "Common.h"
+
+#include <vector>
+
+// Read-only copy of a spell id keyed container, indexed by id.
+// Spell ids are dense, so a lookup is one bounds check and two loads instead of a
+// tree or hash walk. Values are stored contiguously behind a 4 byte slot per id up
+// to the largest key. Has to be rebuilt whenever the source container is reloaded.
+template <typename T>
+class SpellIdTable
+{
+    public:
+        template <typename Container>
+        void Build(Container const& container)
+        {
+            m_index.clear();
+            m_values.clear();
+
+            uint32 maxId = 0;
+            for (auto const& itr : container)
+                maxId = std::max(maxId, uint32(itr.first));
+
+            if (!container.empty())
+                m_index.assign(maxId + 1, 0);
+            m_values.reserve(container.size());
+            for (auto const& itr : container)
+            {
+                m_values.push_back(itr.second);
+                m_index[itr.first] = uint32(m_values.size());
+            }
+
+            m_index.shrink_to_fit();
+            m_values.shrink_to_fit();
+        }
+
+        T const* Find(uint32 id) const
+        {
+            if (id >= m_index.size())
+                return nullptr;
+
+            uint32 const slot = m_index[id];
+            return slot ? &m_values[slot - 1] : nullptr;
+        }
+
+    private:
+        std::vector<uint32> m_index;                        // 1-based position in m_values, 0 for missing ids
+        std::vector<T> m_values;
+};
+
+#endif
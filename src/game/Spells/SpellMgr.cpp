@@ -841,6 +841,7 @@ void SpellMgr::LoadSpellProcEvents()
         bar.step();
         sLog.outString();
         sLog.outString(">> No spell proc event conditions loaded");
+        mSpellProcEventTable.Build(mSpellProcEventMap);
         return;
     }
 
@@ -880,6 +881,8 @@ void SpellMgr::LoadSpellProcEvents()
 
     delete result;
 
+    mSpellProcEventTable.Build(mSpellProcEventMap);
+
     sLog.outString(">> Loaded %u extra spell proc event conditions +%u custom proc (inc. +%u custom ranks)",  rankHelper.worker.count, rankHelper.worker.customProc, rankHelper.customRank);
     sLog.outString();
 }
@@ -907,6 +910,7 @@ void SpellMgr::LoadSpellProcItemEnchant()
         bar.step();
         sLog.outString(">> Loaded %u proc item enchant definitions", count);
         sLog.outString();
+        mSpellProcItemEnchantTable.Build(mSpellProcItemEnchantMap);
         return;
     }
 
@@ -950,6 +954,8 @@ void SpellMgr::LoadSpellProcItemEnchant()
 
     delete result;
 
+    mSpellProcItemEnchantTable.Build(mSpellProcItemEnchantMap);
+
     sLog.outString(">> Loaded %u proc item enchant definitions", count);
     sLog.outString();
 }
@@ -1010,6 +1016,7 @@ void SpellMgr::LoadSpellBonuses()
         bar.step();
         sLog.outString(">> Loaded %u spell bonus data", count);
         sLog.outString();
+        mSpellBonusTable.Build(mSpellBonusMap);
         return;
     }
 
@@ -1151,6 +1158,8 @@ void SpellMgr::LoadSpellBonuses()
 
     delete result;
 
+    mSpellBonusTable.Build(mSpellBonusMap);
+
     sLog.outString(">> Loaded %u extra spell bonus data",  count);
     sLog.outString();
 }
@@ -1268,6 +1277,7 @@ void SpellMgr::LoadSpellElixirs()
 
         sLog.outString(">> Loaded %u spell elixir definitions", count);
         sLog.outString();
+        mSpellElixirTable.Build(mSpellElixirs);
         return;
     }
 
@@ -1298,6 +1308,8 @@ void SpellMgr::LoadSpellElixirs()
 
     delete result;
 
+    mSpellElixirTable.Build(mSpellElixirs);
+
     sLog.outString(">> Loaded %u spell elixir definitions", count);
     sLog.outString();
 }
@@ -1379,6 +1391,7 @@ void SpellMgr::LoadSpellThreats()
         bar.step();
         sLog.outString(">> No spell threat entries loaded.");
         sLog.outString();
+        mSpellThreatTable.Build(mSpellThreatMap);
         return;
     }
 
@@ -1407,6 +1420,8 @@ void SpellMgr::LoadSpellThreats()
 
     delete result;
 
+    mSpellThreatTable.Build(mSpellThreatMap);
+
     sLog.outString(">> Loaded %u spell threat entries", rankHelper.worker.count);
     sLog.outString();
 }
@@ -1640,6 +1655,41 @@ static void LoadSpellChains_AbilityHelper(SpellChainMap& chainMap, AbilitySpellP
     chainMap[spell_id] = node;
 }
 
+void SpellMgr::LoadSpellIndexes()
+{
+    mSpellsByEffect.assign(MAX_SPELL_EFFECTS, SpellIdList());
+    mSpellsByAura.assign(TOTAL_AURAS, SpellIdList());
+    mSpellsByFamily.assign(SPELLFAMILY_PET + 1, SpellIdList());
+
+    uint32 count = 0;
+    for (uint32 i = 1; i < sSpellTemplate.GetMaxEntry(); ++i)
+    {
+        SpellEntry const* spellInfo = sSpellTemplate.LookupEntry<SpellEntry>(i);
+        if (!spellInfo)
+            continue;
+
+        for (int j = 0; j < MAX_EFFECT_INDEX; ++j)
+        {
+            uint32 effect = spellInfo->Effect[j];
+            // ids are visited in order, so a spell repeating an effect is always at the back
+            if (effect && effect < MAX_SPELL_EFFECTS && (mSpellsByEffect[effect].empty() || mSpellsByEffect[effect].back() != i))
+                mSpellsByEffect[effect].push_back(i);
+
+            uint32 aura = spellInfo->EffectApplyAuraName[j];
+            if (aura && aura < TOTAL_AURAS && (mSpellsByAura[aura].empty() || mSpellsByAura[aura].back() != i))
+                mSpellsByAura[aura].push_back(i);
+        }
+
+        if (spellInfo->SpellFamilyName < mSpellsByFamily.size())
+            mSpellsByFamily[spellInfo->SpellFamilyName].push_back(i);
+
+        ++count;
+    }
+
+    sLog.outString(">> Indexed %u spells by effect, aura and family", count);
+    sLog.outString();
+}
+
 void SpellMgr::LoadSpellChains()
 {
     mSpellChains.clear();                                   // need for reload case
@@ -1764,6 +1814,7 @@ void SpellMgr::LoadSpellChains()
         sLog.outString(">> Loaded 0 spell chain records");
         sLog.outErrorDb("`spell_chains` table is empty!");
         sLog.outString();
+        mSpellChainTable.Build(mSpellChains);
         return;
     }
 
@@ -1978,6 +2029,8 @@ void SpellMgr::LoadSpellChains()
         }
     }
 
+    mSpellChainTable.Build(mSpellChains);
+
     // fill next rank cache
     for (SpellChainMap::const_iterator i = mSpellChains.begin(); i != mSpellChains.end(); ++i)
     {
@@ -3208,8 +3261,24 @@ void SpellMgr::CheckUsedSpells(char const* table) const
         {
             ++countMasks;
 
+            // narrow the search to the most specific index, the checks below still apply
+            SpellIdList allSpells;
+            SpellIdList const* candidates = &allSpells;
+            if (family >= 0)
+                candidates = &GetSpellsOfFamily(family);
+            else if (effectType >= 0)
+                candidates = &GetSpellsWithEffect(effectType);
+            else if (auraType >= 0)
+                candidates = &GetSpellsWithAura(auraType);
+            else
+            {
+                for (uint32 spellId = 1; spellId < sSpellTemplate.GetMaxEntry(); ++spellId)
+                    if (sSpellTemplate.LookupEntry<SpellEntry>(spellId))
+                        allSpells.push_back(spellId);
+            }
+
             bool found = false;
-            for (uint32 spellId = 1; spellId < sSpellTemplate.GetMaxEntry(); ++spellId)
+            for (uint32 spellId : *candidates)
             {
                 SpellEntry const* spellEntry = sSpellTemplate.LookupEntry<SpellEntry>(spellId);
                 if (!spellEntry)
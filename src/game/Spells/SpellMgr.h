@@ -35,6 +35,7 @@
 #include "Spells/SpellAuras.h"
 #include "Server/SQLStorages.h"
 #include "Spells/SpellEffectDefines.h"
+#include "Spells/SpellIdTable.h"
 
 #include <map>
 
@@ -2720,6 +2721,9 @@ struct PetDefaultSpellsEntry
 // < 0 for petspelldata id, > 0 for creature_id
 typedef std::map<int32, PetDefaultSpellsEntry> PetDefaultSpellsMap;
 
+// spell ids ordered by id, each spell listed once
+typedef std::vector<uint32> SpellIdList;
+
 bool IsPrimaryProfessionSkill(uint32 skill);
 
 inline bool IsProfessionSkill(uint32 skill)
@@ -2750,11 +2754,10 @@ class SpellMgr
 
         uint32 GetSpellElixirMask(uint32 spellid) const
         {
-            SpellElixirMap::const_iterator itr = mSpellElixirs.find(spellid);
-            if (itr == mSpellElixirs.end())
-                return 0x0;
+            if (uint8 const* mask = mSpellElixirTable.Find(spellid))
+                return *mask;
 
-            return itr->second;
+            return 0x0;
         }
 
         SpellSpecific GetSpellElixirSpecific(uint32 spellid) const
@@ -2956,11 +2959,7 @@ class SpellMgr
 
         SpellThreatEntry const* GetSpellThreatEntry(uint32 spellid) const
         {
-            SpellThreatMap::const_iterator itr = mSpellThreatMap.find(spellid);
-            if (itr != mSpellThreatMap.end())
-                return &itr->second;
-
-            return nullptr;
+            return mSpellThreatTable.Find(spellid);
         }
 
         float GetSpellThreatMultiplier(SpellEntry const* spellInfo) const
@@ -2977,20 +2976,25 @@ class SpellMgr
         // Spell proc events
         SpellProcEventEntry const* GetSpellProcEvent(uint32 spellId) const
         {
-            SpellProcEventMap::const_iterator itr = mSpellProcEventMap.find(spellId);
-            if (itr != mSpellProcEventMap.end())
-                return &itr->second;
-            return nullptr;
+            return mSpellProcEventTable.Find(spellId);
+        }
+
+        // flags an aura of the spell can proc from, spell_proc_event overrides the dbc value
+        uint32 GetSpellProcFlags(SpellEntry const* spellProto) const
+        {
+            SpellProcEventEntry const* spellProcEvent = GetSpellProcEvent(spellProto->Id);
+            if (spellProcEvent && spellProcEvent->procFlags)
+                return spellProcEvent->procFlags;
+            return spellProto->procFlags;
         }
 
         // Spell procs from item enchants
         float GetItemEnchantProcChance(uint32 spellid) const
         {
-            SpellProcItemEnchantMap::const_iterator itr = mSpellProcItemEnchantMap.find(spellid);
-            if (itr == mSpellProcItemEnchantMap.end())
-                return 0.0f;
+            if (float const* chance = mSpellProcItemEnchantTable.Find(spellid))
+                return *chance;
 
-            return itr->second;
+            return 0.0f;
         }
 
         static bool IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const* spellProcEvent, uint32 EventProcFlag, SpellEntry const* spellInfo, uint32 procFlags, uint32 procExtra);
@@ -2998,12 +3002,7 @@ class SpellMgr
         // Spell bonus data
         SpellBonusEntry const* GetSpellBonusData(uint32 spellId) const
         {
-            // Lookup data
-            SpellBonusMap::const_iterator itr = mSpellBonusMap.find(spellId);
-            if (itr != mSpellBonusMap.end())
-                return &itr->second;
-
-            return nullptr;
+            return mSpellBonusTable.Find(spellId);
         }
 
         // Spell target coordinates
@@ -3018,11 +3017,7 @@ class SpellMgr
         // Spell ranks chains
         SpellChainNode const* GetSpellChainNode(uint32 spell_id) const
         {
-            SpellChainMap::const_iterator itr = mSpellChains.find(spell_id);
-            if (itr == mSpellChains.end())
-                return nullptr;
-
-            return &itr->second;
+            return mSpellChainTable.Find(spell_id);
         }
 
         uint32 GetFirstSpellInChain(uint32 spell_id) const
@@ -3062,6 +3057,22 @@ class SpellMgr
 
         SpellChainMapNext const& GetSpellChainNext() const { return mSpellChainsNext; }
 
+        // Spell indexes, built once from spell_template
+        SpellIdList const& GetSpellsWithEffect(uint32 effect) const
+        {
+            return effect < mSpellsByEffect.size() ? mSpellsByEffect[effect] : mEmptySpellIdList;
+        }
+
+        SpellIdList const& GetSpellsWithAura(uint32 auraType) const
+        {
+            return auraType < mSpellsByAura.size() ? mSpellsByAura[auraType] : mEmptySpellIdList;
+        }
+
+        SpellIdList const& GetSpellsOfFamily(uint32 family) const
+        {
+            return family < mSpellsByFamily.size() ? mSpellsByFamily[family] : mEmptySpellIdList;
+        }
+
         template<typename Worker>
         void doForHighRanks(uint32 spellid, Worker& worker)
         {
@@ -3308,6 +3319,7 @@ class SpellMgr
         void CheckUsedSpells(char const* table) const;
 
         // Loading data at server startup
+        void LoadSpellIndexes();                            // must be after LoadSpellTemplate
         void LoadSpellChains();
         void LoadSpellLearnSkills();
         void LoadSpellLearnSpells();
@@ -3338,6 +3350,13 @@ class SpellMgr
         SpellProcEventMap  mSpellProcEventMap;
         SpellProcItemEnchantMap mSpellProcItemEnchantMap;
         SpellBonusMap      mSpellBonusMap;
+        // dense copies of the maps above for the lookups done during combat
+        SpellIdTable<SpellChainNode>      mSpellChainTable;
+        SpellIdTable<uint8>               mSpellElixirTable;
+        SpellIdTable<SpellThreatEntry>    mSpellThreatTable;
+        SpellIdTable<SpellProcEventEntry> mSpellProcEventTable;
+        SpellIdTable<float>               mSpellProcItemEnchantTable;
+        SpellIdTable<SpellBonusEntry>     mSpellBonusTable;
         SkillLineAbilityMap mSkillLineAbilityMapBySpellId;
         SkillLineAbilityMap mSkillLineAbilityMapBySkillId;
         SkillRaceClassInfoMap mSkillRaceClassInfoMap;
@@ -3347,6 +3366,10 @@ class SpellMgr
         SpellAreaMap         mSpellAreaMap;
         SpellAreaForAuraMap  mSpellAreaForAuraMap;
         SpellAreaForAreaMap  mSpellAreaForAreaMap;
+        std::vector<SpellIdList> mSpellsByEffect;
+        std::vector<SpellIdList> mSpellsByAura;
+        std::vector<SpellIdList> mSpellsByFamily;
+        SpellIdList const    mEmptySpellIdList;
 };
 
 #define sSpellMgr SpellMgr::Instance()
@@ -358,7 +358,7 @@ struct ProcTriggeredData
     SpellAuraHolder* triggeredByHolder;
 };
 
-typedef std::list< ProcTriggeredData > ProcTriggeredList;
+typedef TickList<ProcTriggeredData> ProcTriggeredList;
 
 uint32 createProcExtendMask(SpellNonMeleeDamage* damageInfo, SpellMissInfo missCondition)
 {
@@ -536,12 +536,16 @@ void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
 {
     ProcExecutionData execData(argData, isVictim);
 
-    ProcTriggeredList procTriggered;
+    ProcTriggeredList procTriggered(TickArena::Resource());
     std::vector<SpellAuraHolder*> holdersForDeletion;
     // Fill procTriggered list
-    for (SpellAuraHolderMap::const_iterator itr = GetSpellAuraHolderMap().begin(); itr != GetSpellAuraHolderMap().end(); ++itr)
+    for (size_t i = 0; i < m_procHolders.size(); ++i)
     {
-        SpellAuraHolder* holder = itr->second;
+        // holders not reacting to any flag of the event would fail the proc flag check anyway
+        if (!(m_procHolders[i].procFlags & execData.procFlags))
+            continue;
+
+        SpellAuraHolder* holder = m_procHolders[i].holder;
         // skip deleted auras (possible at recursive triggered call
         if (holder->GetState() != SPELLAURAHOLDER_STATE_READY || holder->IsDeleted())
             continue;
@@ -564,7 +568,7 @@ void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
         if (result != SpellProcEventTriggerCheck::SPELL_PROC_TRIGGER_OK)
             continue;
 
-        procTriggered.push_back(ProcTriggeredData(spellProcEvent, itr->second));
+        procTriggered.push_back(ProcTriggeredData(spellProcEvent, holder));
     }
 
     for (SpellAuraHolder* holder : holdersForDeletion)
@@ -24,14 +24,22 @@
 #include "Util/ProgressBar.h"
 #include "Server/SQLStorages.h"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    std::thread s_cleanerThread;
+    std::atomic<bool> s_stopCleaning(false);
+}
+
 void CharacterDatabaseCleaner::CleanDatabase()
 {
     // config to disable
     if (!sWorld.getConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB))
         return;
 
-    sLog.outString("Cleaning character database...");
-
     // check flags which clean ups are necessary
     QueryResult* result = CharacterDatabase.PQuery("SELECT cleaning_flags FROM saved_variables");
     if (!result)
@@ -39,6 +47,34 @@ void CharacterDatabaseCleaner::CleanDatabase()
     uint32 flags = (*result)[0].GetUInt32();
     delete result;
 
+    if (!flags)
+        return;
+
+    if (sWorld.getConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB_BACKGROUND))
+    {
+        sLog.outString("Cleaning character database in the background...");
+        s_stopCleaning = false;
+        s_cleanerThread = std::thread(&CleanTables, flags);
+        return;
+    }
+
+    sLog.outString("Cleaning character database...");
+    CleanTables(flags);
+}
+
+void CharacterDatabaseCleaner::StopCleaning()
+{
+    if (!s_cleanerThread.joinable())
+        return;
+
+    s_stopCleaning = true;
+    s_cleanerThread.join();
+}
+
+void CharacterDatabaseCleaner::CleanTables(uint32 flags)
+{
+    auto start = std::chrono::steady_clock::now();
+
     // clean up
     if (flags & CLEANING_FLAG_ACHIEVEMENT_PROGRESS)
         CleanCharacterAchievementProgress();
@@ -48,11 +84,28 @@ void CharacterDatabaseCleaner::CleanDatabase()
         CleanCharacterSpell();
     if (flags & CLEANING_FLAG_TALENTS)
         CleanCharacterTalent();
+
+    // an interrupted cleaning is repeated at next start up
+    if (s_stopCleaning)
+        return;
+
     CharacterDatabase.Execute("UPDATE saved_variables SET cleaning_flags = 0");
+    sLog.outString("Character database cleaned in %u s", uint32(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start).count()));
 }
 
 void CharacterDatabaseCleaner::CheckUnique(const char* column, const char* table, bool (*check)(uint32))
 {
+    // a background cleaning must not hold the progress bar of the console, it always works in batches
+    uint32 batchSize = sWorld.getConfig(CONFIG_UINT32_CLEAN_CHARACTER_DB_BATCH);
+    if (!batchSize && s_cleanerThread.joinable())
+        batchSize = 10000;
+
+    if (batchSize)
+    {
+        CheckUniqueBatched(column, table, check, batchSize);
+        return;
+    }
+
     QueryResult* result = CharacterDatabase.PQuery("SELECT DISTINCT %s FROM %s", column, table);
     if (!result)
     {
@@ -93,6 +146,65 @@ void CharacterDatabaseCleaner::CheckUnique(const char* column, const char* table
     }
 }
 
+void CharacterDatabaseCleaner::CheckUniqueBatched(const char* column, const char* table, bool (*check)(uint32), uint32 batchSize)
+{
+    QueryResult* result = CharacterDatabase.PQuery("SELECT MIN(guid), MAX(guid) FROM %s", table);
+    if (!result || (*result)[0].IsNULL())
+    {
+        delete result;
+        sLog.outString("Table %s is empty.", table);
+        return;
+    }
+
+    uint32 const minGuid = (*result)[0].GetUInt32();
+    uint32 const maxGuid = (*result)[1].GetUInt32();
+    delete result;
+
+    uint32 dirtyBatches = 0;
+    uint32 reported = 0;
+    for (uint64 from = minGuid; from <= maxGuid && !s_stopCleaning; from += batchSize)
+    {
+        uint64 const to = std::min<uint64>(from + batchSize - 1, maxGuid);
+
+        // key range of the primary key, only the guids of this batch are read
+        result = CharacterDatabase.PQuery("SELECT DISTINCT %s FROM %s WHERE guid BETWEEN %u AND %u", column, table, uint32(from), uint32(to));
+        if (result)
+        {
+            std::ostringstream ss;
+            ss << "DELETE FROM " << table << " WHERE guid BETWEEN " << from << " AND " << to << " AND " << column << " IN (";
+            bool found = false;
+            do
+            {
+                uint32 id = result->Fetch()[0].GetUInt32();
+                if (check(id))
+                    continue;
+
+                ss << (found ? "," : "") << id;
+                found = true;
+            }
+            while (result->NextRow());
+            delete result;
+
+            if (found)
+            {
+                ss << ")";
+                CharacterDatabase.Execute(ss.str().c_str());
+                ++dirtyBatches;
+            }
+        }
+
+        uint32 const percent = uint32((to - minGuid + 1) * 100 / (uint64(maxGuid) - minGuid + 1));
+        if (percent >= reported + 10 || to == maxGuid)
+        {
+            sLog.outString("Cleaning %s: %u%%", table, percent);
+            reported = percent;
+        }
+    }
+
+    if (dirtyBatches)
+        sLog.outString("Table %s: removed invalid %s values in %u of its guid ranges", table, column, dirtyBatches);
+}
+
 bool CharacterDatabaseCleaner::AchievementProgressCheck(uint32 criteria)
 {
     return sAchievementCriteriaStore.LookupEntry(criteria) != nullptr;
@@ -30,8 +30,14 @@ namespace CharacterDatabaseCleaner
     };
 
     void CleanDatabase();
+    // waits for a background cleaning, which stops at its next batch
+    void StopCleaning();
+
+    void CleanTables(uint32 flags);
 
     void CheckUnique(const char* column, const char* table, bool (*check)(uint32));
+    // same check in ranges of batchSize character guids, the table's first key column must be guid
+    void CheckUniqueBatched(const char* column, const char* table, bool (*check)(uint32), uint32 batchSize);
 
     bool AchievementProgressCheck(uint32 criteria);
     bool SkillCheck(uint32 skill);
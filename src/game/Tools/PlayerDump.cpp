@@ -24,6 +24,9 @@
 #include "Globals/ObjectMgr.h"
 #include "Accounts/AccountMgr.h"
 
+// dump text collected before it is written to the file
+#define DUMP_FLUSH_SIZE (64 * 1024)
+
 // Character Dump tables
 struct DumpTable
 {
@@ -336,6 +339,7 @@ void PlayerDumpWriter::DumpTableContent(std::string& dump, uint32 guid, char con
 
             dump += CreateDumpString(tableTo, result);
             dump += "\n";
+            FlushDump(dump, false);
         }
         while (result->NextRow());
 
@@ -347,7 +351,21 @@ void PlayerDumpWriter::DumpTableContent(std::string& dump, uint32 guid, char con
 std::string PlayerDumpWriter::GetDump(uint32 guid)
 {
     std::string dump;
+    BuildDump(dump, guid);
+    return dump;
+}
+
+void PlayerDumpWriter::FlushDump(std::string& dump, bool force)
+{
+    if (!m_file || dump.empty() || (!force && dump.size() < DUMP_FLUSH_SIZE))
+        return;
 
+    fwrite(dump.data(), 1, dump.size(), m_file);
+    dump.clear();
+}
+
+void PlayerDumpWriter::BuildDump(std::string& dump, uint32 guid)
+{
     dump += "IMPORTANT NOTE: This sql queries not created for apply directly, use '.pdump load' command in console or client chat instead.\n";
     dump += "IMPORTANT NOTE: NOT APPLY ITS DIRECTLY to character DB or you will DAMAGE and CORRUPT character DB\n\n";
 
@@ -384,8 +402,6 @@ std::string PlayerDumpWriter::GetDump(uint32 guid)
 
     // TODO: Add instance/group..
     // TODO: Add a dump level option to skip some non-important tables
-
-    return dump;
 }
 
 DumpReturn PlayerDumpWriter::WriteDump(const std::string& file, uint32 guid)
@@ -394,13 +410,83 @@ DumpReturn PlayerDumpWriter::WriteDump(const std::string& file, uint32 guid)
     if (!fout)
         return DUMP_FILE_OPEN_ERROR;
 
-    std::string dump = GetDump(guid);
+    m_file = fout;
 
-    fprintf(fout, "%s\n", dump.c_str());
+    std::string dump;
+    BuildDump(dump, guid);
+    dump += "\n";
+    FlushDump(dump, true);
+
+    m_file = nullptr;
     fclose(fout);
     return DUMP_SUCCESS;
 }
 
+// Reading - Low level functions
+
+// reads one line of any length, false at the end of the file
+static bool ReadDumpLine(FILE* fin, std::string& line)
+{
+    line.clear();
+
+    char buf[4096];
+    while (fgets(buf, sizeof(buf), fin))
+    {
+        line += buf;
+        if (line[line.size() - 1] == '\n')
+            return true;
+    }
+    return !line.empty();
+}
+
+// Collects consecutive rows of one table into a single multi-row insert
+class DumpInsertBatch
+{
+    public:
+        // false if the insert could not be executed
+        bool Add(std::string const& table, std::string const& line)
+        {
+            std::string::size_type const start = line.find("VALUES (");
+            std::string::size_type const end = line.rfind(')');
+            if (start == std::string::npos || end == std::string::npos || end < start)
+                return Flush() && CharacterDatabase.Execute(line.c_str());
+
+            // the values group of this row, "(...)"
+            std::string::size_type const valuesStart = start + 7;
+            std::string::size_type const valuesSize = end - valuesStart + 1;
+
+            if (table != m_table || m_query.size() + valuesSize + 2 > MAX_QUERY_LEN)
+            {
+                if (!Flush())
+                    return false;
+
+                m_table = table;
+                m_query.assign(line, 0, valuesStart);
+            }
+            else
+                m_query += ",";
+
+            m_query.append(line, valuesStart, valuesSize);
+            return true;
+        }
+
+        bool Flush()
+        {
+            if (m_query.empty())
+                return true;
+
+            m_query += ";";
+            bool result = CharacterDatabase.Execute(m_query.c_str());
+            m_query.clear();
+            m_table.clear();
+            return result;
+        }
+
+    private:
+        std::string m_table;
+        std::string m_query;
+};
+
 // Reading - High-level functions
 #define ROLLBACK(DR) {CharacterDatabase.RollbackTransaction(); fclose(fin); return (DR);}
 
@@ -462,23 +548,16 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
     std::map<uint32, uint32> items;
     std::map<uint32, uint32> mails;
     std::map<uint32, uint32> eqsets;
-    char buf[32000] = "";
+    std::string line;
+    DumpInsertBatch batch;
 
     typedef std::map<uint32, uint32> PetIds;                // old->new petid relation
     typedef PetIds::value_type PetIdsPair;
     PetIds petids;
 
     CharacterDatabase.BeginTransaction();
-    while (!feof(fin))
+    while (ReadDumpLine(fin, line))
     {
-        if (!fgets(buf, 32000, fin))
-        {
-            if (feof(fin)) break;
-            ROLLBACK(DUMP_FILE_BROKEN);
-        }
-
-        std::string line; line.assign(buf);
-
         // skip empty strings
         size_t nw_pos = line.find_first_not_of(" \t\n\r\7");
         if (nw_pos == std::string::npos)
@@ -491,7 +570,7 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
         // add required_ check
         if (line.substr(nw_pos, 41) == "UPDATE character_db_version SET required_")
         {
-            if (!CharacterDatabase.Execute(line.c_str()))
+            if (!batch.Flush() || !CharacterDatabase.Execute(line.c_str()))
                 ROLLBACK(DUMP_FILE_BROKEN);
 
             continue;
@@ -711,10 +790,13 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                 break;
         }
 
-        if (execute_ok && !CharacterDatabase.Execute(line.c_str()))
+        if (execute_ok && !batch.Add(tn, line))
             ROLLBACK(DUMP_FILE_BROKEN);
     }
 
+    if (ferror(fin) || !batch.Flush())
+        ROLLBACK(DUMP_FILE_BROKEN);
+
     CharacterDatabase.CommitTransaction();
 
     // FIXME: current code with post-updating guids not safe for future per-map threads
@@ -73,13 +73,17 @@ class PlayerDump
 class PlayerDumpWriter : public PlayerDump
 {
     public:
-        PlayerDumpWriter() {}
+        PlayerDumpWriter() : m_file(nullptr) {}
 
         std::string GetDump(uint32 guid);
+        // streams the dump to the file while the tables are read
         DumpReturn WriteDump(const std::string& file, uint32 guid);
     private:
         typedef std::set<uint32> GUIDs;
 
+        void BuildDump(std::string& dump, uint32 guid);
+        // moves the collected dump text to the file of WriteDump, if any
+        void FlushDump(std::string& dump, bool force);
         void DumpTableContent(std::string& dump, uint32 guid, char const* tableFrom, char const* tableTo, DumpTableType type);
         static std::string GenerateWhereStr(char const* field, GUIDs const& guids, GUIDs::const_iterator& itr);
         static std::string GenerateWhereStr(char const* field, uint32 guid);
@@ -87,6 +91,8 @@ class PlayerDumpWriter : public PlayerDump
         GUIDs pets;
         GUIDs mails;
         GUIDs items;
+
+        FILE* m_file;
 };
 
 class PlayerDumpReader : public PlayerDump
@@ -254,15 +254,15 @@ void BIH::subdivide(int left, int right, std::vector<uint32>& tempTree, buildDat
 
 bool BIH::writeToFile(FILE* wf) const
 {
-    uint32 treeSize = tree.size();
+    uint32 treeSize = m_treeSize;
     uint32 check = 0;
-    uint32 count = objects.size();
+    uint32 count = m_objectCount;
     check += fwrite(&bounds.low(), sizeof(float), 3, wf);
     check += fwrite(&bounds.high(), sizeof(float), 3, wf);
     check += fwrite(&treeSize, sizeof(uint32), 1, wf);
-    check += fwrite(&tree[0], sizeof(uint32), treeSize, wf);
+    check += fwrite(m_tree, sizeof(uint32), treeSize, wf);
     check += fwrite(&count, sizeof(uint32), 1, wf);
-    check += fwrite(&objects[0], sizeof(uint32), count, wf);
+    check += fwrite(m_objects, sizeof(uint32), count, wf);
     return check == (3 + 3 + 2 + treeSize + count);
 }
 
@@ -280,6 +280,7 @@ bool BIH::readFromFile(FILE* rf)
     check += fread(&count, sizeof(uint32), 1, rf);
     objects.resize(count); // = new uint32[nObjects];
     check += fread(&objects[0], sizeof(uint32), count, rf);
+    bindStorage();
     return check == (3 + 3 + 2 + treeSize + count);
 }
 
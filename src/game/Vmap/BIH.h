@@ -78,10 +78,49 @@ class BIH
             // create space for the first node
             tree.push_back(static_cast<uint32>(3 << 30)); // dummy leaf
             tree.insert(tree.end(), 2, 0);
+            bindStorage();
+        }
+
+        // queries read through the views, they point at the own vectors or at memory mapped model data
+        void bindStorage()
+        {
+            m_tree = tree.data();
+            m_treeSize = tree.size();
+            m_objects = objects.data();
+            m_objectCount = objects.size();
+            m_external = false;
         }
 
     public:
         BIH() {init_empty();}
+        BIH(const BIH& other) { *this = other; }
+        BIH& operator=(const BIH& other)
+        {
+            tree = other.tree;
+            objects = other.objects;
+            bounds = other.bounds;
+            bindStorage();
+            if (other.m_external)
+                setStorage(other.bounds, other.m_tree, other.m_treeSize, other.m_objects, other.m_objectCount);
+            return *this;
+        }
+
+        //! use nodes and primitive indices owned by someone else, the data has to outlive the tree
+        void setStorage(const AABox& bound, uint32 const* treeData, uint32 treeSize, uint32 const* objectData, uint32 objectCount)
+        {
+            tree.clear();
+            objects.clear();
+            bounds = bound;
+            m_tree = treeData;
+            m_treeSize = treeSize;
+            m_objects = objectData;
+            m_objectCount = objectCount;
+            m_external = true;
+        }
+        const AABox& getBounds() const { return bounds; }
+        uint32 const* getTreeData() const { return m_tree; }
+        uint32 getTreeSize() const { return m_treeSize; }
+        uint32 const* getObjectData() const { return m_objects; }
         template< class BoundsFunc, class PrimArray >
         void build(const PrimArray& primitives, BoundsFunc& getBounds, uint32 leafSize = 3, bool printStats = false)
         {
@@ -113,13 +152,205 @@ class BIH
                 objects[i] = dat.indices[i];
             // nObjects = dat.numPrims;
             tree = tempTree;
+            bindStorage();
             delete[] dat.primBound;
             delete[] dat.indices;
         }
-        size_t primCount() const { return objects.size(); }
+        size_t primCount() const { return m_objectCount; }
 
         template<typename RayCallback>
         void intersectRay(const Ray& r, RayCallback& intersectCallback, float& maxDist, bool stopAtFirst = false, bool ignoreM2Model = false) const
+        {
+            auto leaf = [&](uint32 const* prims, int n)
+            {
+                for (int i = 0; i < n; ++i)
+                {
+                    bool hit = intersectCallback(r, prims[i], maxDist, stopAtFirst, ignoreM2Model);
+                    if (stopAtFirst && hit)
+                        return true;
+                }
+                return false;
+            };
+            traverseRay(r, leaf, maxDist);
+        }
+
+        // hands every leaf the ray passes to the callback as a whole, so it can test its primitives
+        // together: bool callback(const Ray&, uint32 const* prims, int count, float& maxDist, bool stopAtFirst)
+        template<typename LeafCallback>
+        void intersectRayLeaves(const Ray& r, LeafCallback& leafCallback, float& maxDist, bool stopAtFirst = false) const
+        {
+            auto leaf = [&](uint32 const* prims, int n)
+            {
+                bool hit = leafCallback(r, prims, n, maxDist, stopAtFirst);
+                return stopAtFirst && hit;
+            };
+            traverseRay(r, leaf, maxDist);
+        }
+
+        // calls back every object of the leaves overlapping the box, used to gather the
+        // candidates of many rays at once instead of walking the tree for each of them
+        template<typename IsectCallback>
+        void intersectBox(const AABox& box, IsectCallback& intersectCallback) const
+        {
+            if (!bounds.intersects(box))
+                return;
+
+            Vector3 const& lo = box.low();
+            Vector3 const& hi = box.high();
+
+            StackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true)
+            {
+                while (true)
+                {
+                    uint32 tn = m_tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    const bool BVH2 = (tn & (1 << 29)) != 0;
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node
+                            float tl = intBitsToFloat(m_tree[node + 1]);
+                            float tr = intBitsToFloat(m_tree[node + 2]);
+                            bool const left = lo[axis] <= tl;
+                            bool const right = hi[axis] >= tr;
+                            // box is between clip zones
+                            if (!left && !right)
+                                break;
+                            node = right ? offset + 3 : offset;
+                            if (left && right)
+                            {
+                                // box overlaps both nodes, push back left node
+                                stack[stackPos].node = offset;
+                                ++stackPos;
+                            }
+                        }
+                        else
+                        {
+                            // leaf - report all objects
+                            int n = m_tree[node + 1];
+                            while (n > 0)
+                            {
+                                intersectCallback(m_objects[offset]);
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else // BVH2 node (empty space cut off left and right)
+                    {
+                        if (axis > 2)
+                            return; // should not happen
+                        float tl = intBitsToFloat(m_tree[node + 1]);
+                        float tr = intBitsToFloat(m_tree[node + 2]);
+                        node = offset;
+                        if (tl > hi[axis] || tr < lo[axis])
+                            break;
+                    }
+                } // traversal loop
+
+                // stack is empty?
+                if (stackPos == 0)
+                    return;
+                // move back up the stack
+                --stackPos;
+                node = stack[stackPos].node;
+            }
+        }
+
+        template<typename IsectCallback>
+        void intersectPoint(const Vector3& p, IsectCallback& intersectCallback) const
+        {
+            if (!bounds.contains(p))
+                return;
+
+            StackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true)
+            {
+                while (true)
+                {
+                    uint32 tn = m_tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    const bool BVH2 = (tn & (1 << 29)) != 0;
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node
+                            float tl = intBitsToFloat(m_tree[node + 1]);
+                            float tr = intBitsToFloat(m_tree[node + 2]);
+                            // point is between clip zones
+                            if (tl < p[axis] && tr > p[axis])
+                                break;
+                            int right = offset + 3;
+                            node = right;
+                            // point is in right node only
+                            if (tl < p[axis])
+                            {
+                                continue;
+                            }
+                            node = offset; // left
+                            // point is in left node only
+                            if (tr > p[axis])
+                            {
+                                continue;
+                            }
+                            // point is in both nodes
+                            // push back right node
+                            stack[stackPos].node = right;
+                            ++stackPos;
+                        }
+                        else
+                        {
+                            // leaf - test some objects
+                            int n = m_tree[node + 1];
+                            while (n > 0)
+                            {
+                                intersectCallback(p, m_objects[offset]); // !!!
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else // BVH2 node (empty space cut off left and right)
+                    {
+                        if (axis > 2)
+                            return; // should not happen
+                        float tl = intBitsToFloat(m_tree[node + 1]);
+                        float tr = intBitsToFloat(m_tree[node + 2]);
+                        node = offset;
+                        if (tl > p[axis] || tr < p[axis])
+                            break;
+                    }
+                } // traversal loop
+
+                // stack is empty?
+                if (stackPos == 0)
+                    return;
+                // move back up the stack
+                --stackPos;
+                node = stack[stackPos].node;
+            }
+        }
+
+        bool writeToFile(FILE* wf) const;
+        bool readFromFile(FILE* rf);
+
+    protected:
+        // walks the nodes the ray passes, leafFunc(prims, count) returns true to stop the walk
+        template<typename LeafFunc>
+        void traverseRay(const Ray& r, LeafFunc& leafFunc, float& maxDist) const
         {
             float intervalMin = -1.f;
             float intervalMax = -1.f;
@@ -177,7 +408,7 @@ class BIH
             {
                 while (true)
                 {
-                    uint32 tn = tree[node];
+                    uint32 tn = m_tree[node];
                     uint32 axis = (tn & (3 << 30)) >> 30;
                     const bool BVH2 = (tn & (1 << 29)) != 0;
                     int offset = tn & ~(7 << 29);
@@ -186,8 +417,8 @@ class BIH
                         if (axis < 3)
                         {
                             // "normal" interior node
-                            float tf = (intBitsToFloat(tree[node + offsetFront[axis]]) - org[axis]) * invDir[axis];
-                            float tb = (intBitsToFloat(tree[node + offsetBack[axis]]) - org[axis]) * invDir[axis];
+                            float tf = (intBitsToFloat(m_tree[node + offsetFront[axis]]) - org[axis]) * invDir[axis];
+                            float tb = (intBitsToFloat(m_tree[node + offsetBack[axis]]) - org[axis]) * invDir[axis];
                             // ray passes between clip zones
                             if (tf < intervalMin && tb > intervalMax)
                                 break;
@@ -218,14 +449,9 @@ class BIH
                         else
                         {
                             // leaf - test some objects
-                            int n = tree[node + 1];
-                            while (n > 0)
-                            {
-                                bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst, ignoreM2Model);
-                                if (stopAtFirst && hit) return;
-                                --n;
-                                ++offset;
-                            }
+                            int n = m_tree[node + 1];
+                            if (n > 0 && leafFunc(&m_objects[offset], n))
+                                return;
                             break;
                         }
                     }
@@ -233,8 +459,8 @@ class BIH
                     {
                         if (axis > 2)
                             return; // should not happen
-                        float tf = (intBitsToFloat(tree[node + offsetFront[axis]]) - org[axis]) * invDir[axis];
-                        float tb = (intBitsToFloat(tree[node + offsetBack[axis]]) - org[axis]) * invDir[axis];
+                        float tf = (intBitsToFloat(m_tree[node + offsetFront[axis]]) - org[axis]) * invDir[axis];
+                        float tb = (intBitsToFloat(m_tree[node + offsetBack[axis]]) - org[axis]) * invDir[axis];
                         node = offset;
                         intervalMin = (tf >= intervalMin) ? tf : intervalMin;
                         intervalMax = (tb <= intervalMax) ? tb : intervalMax;
@@ -259,93 +485,14 @@ class BIH
             }
         }
 
-        template<typename IsectCallback>
-        void intersectPoint(const Vector3& p, IsectCallback& intersectCallback) const
-        {
-            if (!bounds.contains(p))
-                return;
-
-            StackNode stack[MAX_STACK_SIZE];
-            int stackPos = 0;
-            int node = 0;
-
-            while (true)
-            {
-                while (true)
-                {
-                    uint32 tn = tree[node];
-                    uint32 axis = (tn & (3 << 30)) >> 30;
-                    const bool BVH2 = (tn & (1 << 29)) != 0;
-                    int offset = tn & ~(7 << 29);
-                    if (!BVH2)
-                    {
-                        if (axis < 3)
-                        {
-                            // "normal" interior node
-                            float tl = intBitsToFloat(tree[node + 1]);
-                            float tr = intBitsToFloat(tree[node + 2]);
-                            // point is between clip zones
-                            if (tl < p[axis] && tr > p[axis])
-                                break;
-                            int right = offset + 3;
-                            node = right;
-                            // point is in right node only
-                            if (tl < p[axis])
-                            {
-                                continue;
-                            }
-                            node = offset; // left
-                            // point is in left node only
-                            if (tr > p[axis])
-                            {
-                                continue;
-                            }
-                            // point is in both nodes
-                            // push back right node
-                            stack[stackPos].node = right;
-                            ++stackPos;
-                        }
-                        else
-                        {
-                            // leaf - test some objects
-                            int n = tree[node + 1];
-                            while (n > 0)
-                            {
-                                intersectCallback(p, objects[offset]); // !!!
-                                --n;
-                                ++offset;
-                            }
-                            break;
-                        }
-                    }
-                    else // BVH2 node (empty space cut off left and right)
-                    {
-                        if (axis > 2)
-                            return; // should not happen
-                        float tl = intBitsToFloat(tree[node + 1]);
-                        float tr = intBitsToFloat(tree[node + 2]);
-                        node = offset;
-                        if (tl > p[axis] || tr < p[axis])
-                            break;
-                    }
-                } // traversal loop
-
-                // stack is empty?
-                if (stackPos == 0)
-                    return;
-                // move back up the stack
-                --stackPos;
-                node = stack[stackPos].node;
-            }
-        }
-
-        bool writeToFile(FILE* wf) const;
-        bool readFromFile(FILE* rf);
-
-    protected:
         std::vector<uint32> tree;
         std::vector<uint32> objects;
         AABox bounds;
+        uint32 const* m_tree;
+        uint32 m_treeSize;
+        uint32 const* m_objects;
+        uint32 m_objectCount;
+        bool m_external;
 
         struct buildData
         {
@@ -20,9 +20,11 @@
 
 #include <G3D/Table.h>
 #include <G3D/Array.h>
-#include <G3D/Set.h>
 #include "BIH.h"
 
+#include <algorithm>
+#include <vector>
+
 template<class T, class BoundsFunc = BoundsTrait<T> >
 class BIHWrap
 {
@@ -57,58 +59,97 @@ class BIHWrap
 
         typedef G3D::Array<const T*> ObjArray;
 
+        // objects inserted since the last build are tested linearly, a rebuild is only
+        // needed once this many piled up or half of the tree slots were removed
+        enum
+        {
+            PENDING_LIMIT = 8,
+        };
+
         BIH m_tree;
-        ObjArray m_objects;
+        ObjArray m_objects;                                 // tree slots, removed objects leave nullptr
         G3D::Table<const T*, uint32> m_obj2Idx;
-        G3D::Set<const T*> m_objects_to_push;
-        int unbalanced_times;
+        std::vector<const T*> m_pending;
+        uint32 m_removed;
 
     public:
 
-        BIHWrap() : unbalanced_times(0) {}
+        BIHWrap() : m_removed(0) {}
 
         void insert(const T& obj)
         {
-            ++unbalanced_times;
-            m_objects_to_push.insert(&obj);
+            m_pending.push_back(&obj);
         }
 
         void remove(const T& obj)
         {
-            ++unbalanced_times;
             uint32 Idx = 0;
             const T* temp;
             if (m_obj2Idx.getRemove(&obj, temp, Idx))
+            {
                 m_objects[Idx] = nullptr;
+                ++m_removed;
+            }
             else
-                m_objects_to_push.remove(&obj);
+            {
+                auto itr = std::find(m_pending.begin(), m_pending.end(), &obj);
+                if (itr != m_pending.end())
+                {
+                    *itr = m_pending.back();
+                    m_pending.pop_back();
+                }
+            }
+        }
+
+        bool needsBalance() const
+        {
+            return m_pending.size() > PENDING_LIMIT || (m_removed && m_removed * 2 >= uint32(m_objects.size()));
         }
 
         void balance()
         {
-            if (unbalanced_times == 0)
+            if (m_pending.empty() && !m_removed)
                 return;
 
-            unbalanced_times = 0;
+            ObjArray objects;
+            m_obj2Idx.getKeys(objects);
+            for (const T* obj : m_pending)
+                objects.append(obj);
+
+            m_pending.clear();
+            m_removed = 0;
+            m_obj2Idx.clear();
             m_objects.fastClear();
-            m_obj2Idx.getKeys(m_objects);
-            m_objects_to_push.getMembers(m_objects);
+            m_objects.append(objects);
+            for (int i = 0; i < m_objects.size(); ++i)
+                m_obj2Idx.set(m_objects[i], i);
 
             m_tree.build(m_objects, BoundsFunc::getBounds2);
         }
 
         template<typename RayCallback>
-        void intersectRay(const Ray& r, RayCallback& intersectCallback, float& maxDist, bool ignoreM2Model)
+        void intersectRay(const Ray& r, RayCallback& intersectCallback, float& maxDist, bool ignoreM2Model) const
         {
-            balance();
+            for (const T* obj : m_pending)
+                if (intersectCallback(r, *obj, maxDist, ignoreM2Model))
+                    return;
+
+            if (!m_objects.size())
+                return;
+
             MDLCallback<RayCallback> temp_cb(intersectCallback, m_objects.getCArray(), m_objects.size());
             m_tree.intersectRay(r, temp_cb, maxDist, true, ignoreM2Model);
         }
 
         template<typename IsectCallback>
-        void intersectPoint(const Vector3& p, IsectCallback& intersectCallback)
+        void intersectPoint(const Vector3& p, IsectCallback& intersectCallback) const
         {
-            balance();
+            for (const T* obj : m_pending)
+                intersectCallback(p, *obj);
+
+            if (!m_objects.size())
+                return;
+
             MDLCallback<IsectCallback> temp_cb(intersectCallback, m_objects.getCArray(), m_objects.size());
             m_tree.intersectPoint(p, temp_cb);
         }
@@ -47,8 +47,9 @@ static bool operator == (const GameObjectModel& mdl, const GameObjectModel& mdl2
 
 // int valuesPerNode = 5, numMeanSplits = 3;
 
-//int UNBALANCED_TIMES_LIMIT = 5;
 int CHECK_TREE_PERIOD = 200;
+// grid nodes rebuilt per check, the rest wait for the next period so no single update pays for all
+int MAX_NODE_REBUILDS = 4;
 
 typedef RegularGrid2D<GameObjectModel, BIHWrap<GameObjectModel> > ParentTree;
 
@@ -58,29 +59,10 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
     typedef ParentTree base;
 
     DynTreeImpl() :
-        rebalance_timer(CHECK_TREE_PERIOD),
-        unbalanced_times(0)
+        rebalance_timer(CHECK_TREE_PERIOD)
     {
     }
 
-    void insert(const Model& mdl)
-    {
-        base::insert(mdl);
-        ++unbalanced_times;
-    }
-
-    void remove(const Model& mdl)
-    {
-        base::remove(mdl);
-        ++unbalanced_times;
-    }
-
-    void balance()
-    {
-        base::balance();
-        unbalanced_times = 0;
-    }
-
     void update(uint32 difftime)
     {
         if (!size())
@@ -90,13 +72,11 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
         if (rebalance_timer.Passed())
         {
             rebalance_timer.Reset(CHECK_TREE_PERIOD);
-            if (unbalanced_times > 0)
-                balance();
+            base::balanceDirty(MAX_NODE_REBUILDS);
         }
     }
 
     ShortTimeTracker rebalance_timer;
-    int unbalanced_times;
 };
 
 DynamicMapTree::DynamicMapTree() : impl(*new DynTreeImpl())
@@ -49,7 +49,7 @@ bool GameObjectModel::initialize(const GameObject* const pGo, const GameObjectDi
     // ignore models with no bounds
     if (mdl_box == G3D::AABox::zero())
     {
-        sLog.outDebug("Model %s has zero bounds, loading skipped", it->second.name.c_str());
+        DEBUG_LOG("Model %s has zero bounds, loading skipped", it->second.name.c_str());
         return false;
     }
 
@@ -20,8 +20,14 @@
 #define _IVMAPMANAGER_H
 
 #include <string>
+#include <vector>
 #include <Platform/Define.h>
 
+namespace G3D
+{
+    class Vector3;
+}
+
 //===========================================================
 
 /**
@@ -60,6 +66,8 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, bool ignoreM2Model) = 0;
+            // rays sharing one origin, in world coordinates, results[i] tells if targets[i] is visible
+            virtual void isInLineOfSightBatch(unsigned int pMapId, G3D::Vector3 const& origin, std::vector<G3D::Vector3> const& targets, std::vector<bool>& results, bool ignoreM2Model) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
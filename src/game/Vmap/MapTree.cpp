@@ -165,6 +165,44 @@ namespace VMAP
     }
     //=========================================================
     /**
+    Collects the models overlapping the box spanned by all rays with a single tree walk,
+    then tests each ray against that short list only. Sets results[i] to false for blocked targets.
+    */
+
+    void StaticMapTree::isInLineOfSightBatch(const Vector3& origin, std::vector<Vector3> const& targets, std::vector<bool>& results, bool ignoreM2Model) const
+    {
+        G3D::AABox box(origin);
+        for (Vector3 const& target : targets)
+            box.merge(target);
+
+        std::vector<uint32> candidates;
+        auto collect = [&candidates](uint32 entry) { candidates.push_back(entry); };
+        iTree.intersectBox(box, collect);
+        if (candidates.empty())
+            return;
+
+        for (size_t i = 0; i < targets.size(); ++i)
+        {
+            float maxDist = (targets[i] - origin).magnitude();
+            MANGOS_ASSERT(maxDist < std::numeric_limits<float>::max());
+            // prevent NaN values which can cause BIH intersection to enter infinite loop
+            if (maxDist < 1e-10f)
+                continue;
+
+            G3D::Ray ray = G3D::Ray::fromOriginAndDirection(origin, (targets[i] - origin) / maxDist);
+            for (uint32 entry : candidates)
+            {
+                float distance = maxDist;
+                if (iTreeValues[entry].intersectRay(ray, distance, true, ignoreM2Model))
+                {
+                    results[i] = false;
+                    break;
+                }
+            }
+        }
+    }
+    //=========================================================
+    /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
     Return the hit pos or the original dest pos
     */
@@ -375,6 +413,7 @@ namespace VMAP
 
     void StaticMapTree::UnloadMap(VMapManager2* vm)
     {
+        std::unique_lock<std::shared_mutex> lock(vm->GetStaticMapLock());
         for (auto& iLoadedSpawn : iLoadedSpawns)
         {
             iTreeValues[iLoadedSpawn.first].setUnloaded();
@@ -393,6 +432,7 @@ namespace VMAP
         {
             // currently, core creates grids for all maps, whether it has terrain tiles or not
             // so we need "fake" tile loads to know when we can unload map geometry
+            std::unique_lock<std::shared_mutex> lock(vm->GetStaticMapLock());
             iLoadedTiles[packTileID(tileX, tileY)] = false;
             return true;
         }
@@ -433,6 +473,8 @@ namespace VMAP
                     uint32 referencedVal;
 
                     fread(&referencedVal, sizeof(uint32), 1, tf);
+                    // queries only wait for the instance swap, the model file was read above
+                    std::unique_lock<std::shared_mutex> lock(vm->GetStaticMapLock());
                     if (!iLoadedSpawns.count(referencedVal))
                     {
                         if (referencedVal > iNTreeValues)
@@ -458,11 +500,16 @@ namespace VMAP
                     }
                 }
             }
-            iLoadedTiles[packTileID(tileX, tileY)] = true;
             fclose(tf);
+
+            std::unique_lock<std::shared_mutex> lock(vm->GetStaticMapLock());
+            iLoadedTiles[packTileID(tileX, tileY)] = true;
         }
         else
+        {
+            std::unique_lock<std::shared_mutex> lock(vm->GetStaticMapLock());
             iLoadedTiles[packTileID(tileX, tileY)] = false;
+        }
         return result;
     }
 
@@ -477,6 +524,9 @@ namespace VMAP
             //ERROR_LOG("StaticMapTree::UnloadMapTile(): Trying to unload non-loaded tile. Map:%u X:%u Y:%u", iMapID, tileX, tileY);
             return;
         }
+
+        // read the spawn list first, queries are only held up while the instances are released
+        std::vector<std::pair<std::string, uint32>> spawns;
         if (tile->second) // file associated with tile
         {
             std::string tilefile = iBasePath + getTileFileName(iMapID, tileX, tileY);
@@ -497,27 +547,33 @@ namespace VMAP
                     result = ModelSpawn::readFromFile(tf, spawn);
                     if (result)
                     {
-                        // release model instance
-                        vm->releaseModelInstance(spawn.name);
-
-                        // update tree
                         uint32 referencedNode;
-
                         fread(&referencedNode, sizeof(uint32), 1, tf);
-                        if (iLoadedSpawns.empty() || iLoadedSpawns.count(referencedNode) == 0)
-                        {
-                            ERROR_LOG("Trying to unload non-referenced model '%s' (ID:%u)", spawn.name.c_str(), spawn.ID);
-                        }
-                        else if (--iLoadedSpawns[referencedNode] <= 0)
-                        {
-                            iTreeValues[referencedNode].setUnloaded();
-                            iLoadedSpawns.erase(referencedNode);
-                        }
+                        spawns.push_back(std::make_pair(spawn.name, referencedNode));
                     }
                 }
                 fclose(tf);
             }
         }
+
+        std::unique_lock<std::shared_mutex> lock(vm->GetStaticMapLock());
+        for (auto const& spawn : spawns)
+        {
+            // update tree
+            uint32 referencedNode = spawn.second;
+            if (iLoadedSpawns.empty() || iLoadedSpawns.count(referencedNode) == 0)
+            {
+                ERROR_LOG("Trying to unload non-referenced model '%s'", spawn.first.c_str());
+            }
+            else if (--iLoadedSpawns[referencedNode] <= 0)
+            {
+                iTreeValues[referencedNode].setUnloaded();
+                iLoadedSpawns.erase(referencedNode);
+            }
+
+            // release model instance
+            vm->releaseModelInstance(spawn.first);
+        }
         iLoadedTiles.erase(tile);
     }
 }
@@ -126,6 +126,21 @@ class RegularGrid2D
                         n->balance();
         }
 
+        // rebuilds up to maxNodes nodes whose pending changes piled up, returns how many were rebuilt
+        int balanceDirty(int maxNodes)
+        {
+            int rebuilt = 0;
+            for (int x = 0; x < CELL_NUMBER && rebuilt < maxNodes; ++x)
+                for (int y = 0; y < CELL_NUMBER && rebuilt < maxNodes; ++y)
+                    if (Node* n = nodes[x][y])
+                        if (n->needsBalance())
+                        {
+                            n->balance();
+                            ++rebuilt;
+                        }
+            return rebuilt;
+        }
+
         bool contains(const T& value) const { return memberTable.count(&value) > 0; }
         int size() const { return uint32(memberTable.size()); }
 
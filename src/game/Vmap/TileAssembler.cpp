@@ -22,8 +22,10 @@
 #include "VMapDefinitions.h"
 
 #include <set>
+#include <atomic>
 #include <iomanip>
 #include <sstream>
+#include <thread>
 
 using G3D::Vector3;
 using G3D::AABox;
@@ -56,6 +58,8 @@ namespace VMAP
     {
         iCurrentUniqueNameId = 0;
         iFilterMethod = nullptr;
+        iCompactModels = false;
+        iThreads = 1;
         iSrcDir = pSrcDirName;
         iDestDir = pDestDirName;
         // mkdir(iDestDir);
@@ -69,141 +73,225 @@ namespace VMAP
 
     bool TileAssembler::convertWorld2()
     {
-        bool success = readMapSpawns();
-        if (!success)
+        if (!readMapSpawns())
             return false;
 
-        // export Map data
-        for (MapData::iterator map_iter = mapData.begin(); map_iter != mapData.end() && success; ++map_iter)
+        std::vector<MapData::value_type*> maps;
+        for (auto& map_iter : mapData)
+            maps.push_back(&map_iter);
+
+        std::atomic<bool> success(true);
+        std::mutex modelFilesLock;
+
+        // export Map data, maps are independent of each other
+        runParallel(maps.size(), [&](size_t index)
         {
-            // build global map tree
-            std::vector<ModelSpawn*> mapSpawns;
-            UniqueEntryMap::iterator entry;
-            printf("Calculating model bounds for map %u...\n", map_iter->first);
-            for (entry = map_iter->second->UniqueEntries.begin(); entry != map_iter->second->UniqueEntries.end(); ++entry)
-            {
-                // M2 models don't have a bound set in WDT/ADT placement data, i still think they're not used for LoS at all on retail
-                if (entry->second.flags & MOD_M2)
-                {
-                    if (!calculateTransformedBound(entry->second))
-                        break;
-                }
-                else if (entry->second.flags & MOD_WORLDSPAWN) // WMO maps and terrain maps use different origin, so we need to adapt :/
-                {
-                    // TODO: remove extractor hack and uncomment below line:
-                    // entry->second.iPos += Vector3(533.33333f*32, 533.33333f*32, 0.f);
-                    entry->second.iBound = entry->second.iBound + Vector3(533.33333f * 32, 533.33333f * 32, 0.f);
-                }
-                mapSpawns.push_back(&(entry->second));
-                spawnedModelFiles.insert(entry->second.name);
-            }
+            if (!success)
+                return;
 
-            printf("Creating map tree...\n");
-            BIH pTree;
-            pTree.build(mapSpawns, BoundsTrait<ModelSpawn*>::getBounds);
+            std::set<std::string> modelFiles;
+            if (!exportMap(maps[index]->first, *maps[index]->second, modelFiles))
+                success = false;
 
-            // ===> possibly move this code to StaticMapTree class
-            std::map<uint32, uint32> modelNodeIdx;
-            for (uint32 i = 0; i < mapSpawns.size(); ++i)
-                modelNodeIdx.insert(pair<uint32, uint32>(mapSpawns[i]->ID, i));
+            std::lock_guard<std::mutex> guard(modelFilesLock);
+            spawnedModelFiles.insert(modelFiles.begin(), modelFiles.end());
+        });
+
+        if (!success)
+        {
+            for (auto& map_iter : mapData)
+                delete map_iter.second;
+            return false;
+        }
+
+        // add an object models, listed in temp_gameobject_models file
+        exportGameobjectModels();
+
+        // export objects
+        std::cout << "\nConverting Model Files" << std::endl;
+        std::vector<std::string> modelFiles(spawnedModelFiles.begin(), spawnedModelFiles.end());
+        runParallel(modelFiles.size(), [&](size_t index)
+        {
+            if (!success)
+                return;
 
-            // write map tree file
-            std::stringstream mapfilename;
-            mapfilename << iDestDir << "/" << std::setfill('0') << std::setw(3) << map_iter->first << ".vmtree";
-            FILE* mapfile = fopen(mapfilename.str().c_str(), "wb");
-            if (!mapfile)
+            printf("Converting %s\n", modelFiles[index].c_str());
+            if (!convertRawFile(modelFiles[index]))
             {
+                printf("error converting %s\n", modelFiles[index].c_str());
                 success = false;
-                printf("Cannot open %s\n", mapfilename.str().c_str());
-                break;
             }
+        });
+
+        // cleanup:
+        for (auto& map_iter : mapData)
+        {
+            delete map_iter.second;
+        }
+        return success;
+    }
 
-            // general info
-            if (success && fwrite(VMAP_MAGIC, 1, 8, mapfile) != 8) success = false;
-            uint32 globalTileID = StaticMapTree::packTileID(65, 65);
-            pair<TileMap::iterator, TileMap::iterator> globalRange = map_iter->second->TileEntries.equal_range(globalTileID);
-            char isTiled = globalRange.first == globalRange.second; // only maps without terrain (tiles) have global WMO
-            if (success && fwrite(&isTiled, sizeof(char), 1, mapfile) != 1) success = false;
-            // Nodes
-            if (success && fwrite("NODE", 4, 1, mapfile) != 1) success = false;
-            if (success) success = pTree.writeToFile(mapfile);
-            // global map spawns (WDT), if any (most instances)
-            if (success && fwrite("GOBJ", 4, 1, mapfile) != 1) success = false;
-
-            uint32 i = 0;
-            for (TileMap::iterator glob = globalRange.first; glob != globalRange.second && success; ++glob, ++i)
+    bool TileAssembler::exportMap(uint32 pMapId, MapSpawns& pSpawns, std::set<std::string>& pModelFiles)
+    {
+        // build global map tree
+        std::vector<ModelSpawn*> mapSpawns;
+        UniqueEntryMap::iterator entry;
+        printf("Calculating model bounds for map %u...\n", pMapId);
+        for (entry = pSpawns.UniqueEntries.begin(); entry != pSpawns.UniqueEntries.end(); ++entry)
+        {
+            // M2 models don't have a bound set in WDT/ADT placement data, i still think they're not used for LoS at all on retail
+            if (entry->second.flags & MOD_M2)
             {
-                ModelSpawn& globSpawn = map_iter->second->UniqueEntries[glob->second];
-                success = ModelSpawn::writeToFile(mapfile, map_iter->second->UniqueEntries[glob->second]);
-                // MapTree nodes to update when loading tile:
-                std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(globSpawn.ID);
-                if (success && fwrite(&nIdx->second, sizeof(uint32), 1, mapfile) != 1) success = false;
+                if (!calculateTransformedBound(entry->second))
+                    break;
+            }
+            else if (entry->second.flags & MOD_WORLDSPAWN) // WMO maps and terrain maps use different origin, so we need to adapt :/
+            {
+                // TODO: remove extractor hack and uncomment below line:
+                // entry->second.iPos += Vector3(533.33333f*32, 533.33333f*32, 0.f);
+                entry->second.iBound = entry->second.iBound + Vector3(533.33333f * 32, 533.33333f * 32, 0.f);
             }
+            mapSpawns.push_back(&(entry->second));
+            pModelFiles.insert(entry->second.name);
+        }
 
-            printf("Map %u global objects %u", map_iter->first, i);
+        printf("Creating map tree...\n");
+        BIH pTree;
+        pTree.build(mapSpawns, BoundsTrait<ModelSpawn*>::getBounds);
 
-            fclose(mapfile);
+        // ===> possibly move this code to StaticMapTree class
+        std::map<uint32, uint32> modelNodeIdx;
+        for (uint32 i = 0; i < mapSpawns.size(); ++i)
+            modelNodeIdx.insert(pair<uint32, uint32>(mapSpawns[i]->ID, i));
 
-            // <====
+        // write map tree file
+        std::stringstream mapfilename;
+        mapfilename << iDestDir << "/" << std::setfill('0') << std::setw(3) << pMapId << ".vmtree";
+        FILE* mapfile = fopen(mapfilename.str().c_str(), "wb");
+        if (!mapfile)
+        {
+            printf("Cannot open %s\n", mapfilename.str().c_str());
+            return false;
+        }
 
-            // write map tile files, similar to ADT files, only with extra BSP tree node info
-            TileMap& tileEntries = map_iter->second->TileEntries;
-            TileMap::iterator tile;
-            for (tile = tileEntries.begin(); tile != tileEntries.end(); ++tile)
+        bool success = true;
+
+        // general info
+        if (fwrite(VMAP_MAGIC, 1, 8, mapfile) != 8) success = false;
+        uint32 globalTileID = StaticMapTree::packTileID(65, 65);
+        pair<TileMap::iterator, TileMap::iterator> globalRange = pSpawns.TileEntries.equal_range(globalTileID);
+        char isTiled = globalRange.first == globalRange.second; // only maps without terrain (tiles) have global WMO
+        if (success && fwrite(&isTiled, sizeof(char), 1, mapfile) != 1) success = false;
+        // Nodes
+        if (success && fwrite("NODE", 4, 1, mapfile) != 1) success = false;
+        if (success) success = pTree.writeToFile(mapfile);
+        // global map spawns (WDT), if any (most instances)
+        if (success && fwrite("GOBJ", 4, 1, mapfile) != 1) success = false;
+
+        uint32 i = 0;
+        for (TileMap::iterator glob = globalRange.first; glob != globalRange.second && success; ++glob, ++i)
+        {
+            ModelSpawn& globSpawn = pSpawns.UniqueEntries[glob->second];
+            success = ModelSpawn::writeToFile(mapfile, pSpawns.UniqueEntries[glob->second]);
+            // MapTree nodes to update when loading tile:
+            std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(globSpawn.ID);
+            if (success && fwrite(&nIdx->second, sizeof(uint32), 1, mapfile) != 1) success = false;
+        }
+
+        printf("Map %u global objects %u", pMapId, i);
+
+        fclose(mapfile);
+
+        // <====
+
+        // write map tile files, similar to ADT files, only with extra BSP tree node info
+        TileMap& tileEntries = pSpawns.TileEntries;
+        TileMap::iterator tile;
+        for (tile = tileEntries.begin(); tile != tileEntries.end(); ++tile)
+        {
+            const ModelSpawn& spawn = pSpawns.UniqueEntries[tile->second];
+            if (spawn.flags & MOD_WORLDSPAWN)           // WDT spawn, saved as tile 65/65 currently...
+                continue;
+            uint32 nSpawns = tileEntries.count(tile->first);
+            std::stringstream tilefilename;
+            tilefilename.fill('0');
+            tilefilename << iDestDir << "/" << std::setw(3) << pMapId << "_";
+            uint32 x, y;
+            StaticMapTree::unpackTileID(tile->first, x, y);
+            tilefilename << std::setw(2) << x << "_" << std::setw(2) << y << ".vmtile";
+            FILE* tilefile = fopen(tilefilename.str().c_str(), "wb");
+            // file header
+            if (success && fwrite(VMAP_MAGIC, 1, 8, tilefile) != 8) success = false;
+            // write number of tile spawns
+            if (success && fwrite(&nSpawns, sizeof(uint32), 1, tilefile) != 1) success = false;
+            // write tile spawns
+            for (uint32 s = 0; s < nSpawns; ++s)
             {
-                const ModelSpawn& spawn = map_iter->second->UniqueEntries[tile->second];
-                if (spawn.flags & MOD_WORLDSPAWN)           // WDT spawn, saved as tile 65/65 currently...
-                    continue;
-                uint32 nSpawns = tileEntries.count(tile->first);
-                std::stringstream tilefilename;
-                tilefilename.fill('0');
-                tilefilename << iDestDir << "/" << std::setw(3) << map_iter->first << "_";
-                uint32 x, y;
-                StaticMapTree::unpackTileID(tile->first, x, y);
-                tilefilename << std::setw(2) << x << "_" << std::setw(2) << y << ".vmtile";
-                FILE* tilefile = fopen(tilefilename.str().c_str(), "wb");
-                // file header
-                if (success && fwrite(VMAP_MAGIC, 1, 8, tilefile) != 8) success = false;
-                // write number of tile spawns
-                if (success && fwrite(&nSpawns, sizeof(uint32), 1, tilefile) != 1) success = false;
-                // write tile spawns
-                for (uint32 s = 0; s < nSpawns; ++s)
-                {
-                    if (s)
-                        ++tile;
-                    ModelSpawn& spawn2 = map_iter->second->UniqueEntries[tile->second];
-                    success = success && ModelSpawn::writeToFile(tilefile, spawn2);
-                    // MapTree nodes to update when loading tile:
-                    std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(spawn2.ID);
-                    if (success && fwrite(&nIdx->second, sizeof(uint32), 1, tilefile) != 1) success = false;
-                }
-                fclose(tilefile);
+                if (s)
+                    ++tile;
+                ModelSpawn& spawn2 = pSpawns.UniqueEntries[tile->second];
+                success = success && ModelSpawn::writeToFile(tilefile, spawn2);
+                // MapTree nodes to update when loading tile:
+                std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(spawn2.ID);
+                if (success && fwrite(&nIdx->second, sizeof(uint32), 1, tilefile) != 1) success = false;
             }
-            // break; // test, extract only first map; TODO: remvoe this line
+            fclose(tilefile);
         }
+        return success;
+    }
 
-        // add an object models, listed in temp_gameobject_models file
-        exportGameobjectModels();
+    void TileAssembler::runParallel(size_t pCount, const std::function<void(size_t)>& pJob) const
+    {
+        if (iThreads <= 1 || pCount <= 1)
+        {
+            for (size_t i = 0; i < pCount; ++i)
+                pJob(i);
+            return;
+        }
 
-        // export objects
-        std::cout << "\nConverting Model Files" << std::endl;
-        for (const auto& spawnedModelFile : spawnedModelFiles)
+        std::atomic<size_t> next(0);
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < iThreads; ++t)
         {
-            std::cout << "Converting " << spawnedModelFile << std::endl;
-            if (!convertRawFile(spawnedModelFile))
+            workers.emplace_back([&]()
             {
-                std::cout << "error converting " << spawnedModelFile << std::endl;
-                success = false;
-                break;
-            }
+                for (size_t i = next++; i < pCount; i = next++)
+                    pJob(i);
+            });
         }
 
-        // cleanup:
-        for (auto& map_iter : mapData)
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    std::shared_ptr<WorldModel_Raw> TileAssembler::getRawModel(const std::string& pModelFilename)
+    {
         {
-            delete map_iter.second;
+            std::lock_guard<std::mutex> guard(iRawModelsLock);
+            auto itr = iRawModels.find(pModelFilename);
+            if (itr != iRawModels.end())
+                return itr->second;
         }
-        return success;
+
+        // two maps may read the same model at once, the first one stored is kept
+        auto raw_model = std::make_shared<WorldModel_Raw>();
+        if (!raw_model->Read((iSrcDir + "/" + pModelFilename).c_str()))
+            return nullptr;
+
+        std::lock_guard<std::mutex> guard(iRawModelsLock);
+        return iRawModels.emplace(pModelFilename, raw_model).first->second;
+    }
+
+    std::shared_ptr<WorldModel_Raw> TileAssembler::takeRawModel(const std::string& pModelFilename)
+    {
+        std::lock_guard<std::mutex> guard(iRawModelsLock);
+        auto itr = iRawModels.find(pModelFilename);
+        if (itr == iRawModels.end())
+            return nullptr;
+
+        std::shared_ptr<WorldModel_Raw> raw_model = itr->second;
+        iRawModels.erase(itr);
+        return raw_model;
     }
 
     bool TileAssembler::readMapSpawns()
@@ -253,10 +341,12 @@ namespace VMAP
         modelPosition.iScale = spawn.iScale;
         modelPosition.init();
 
-        WorldModel_Raw raw_model;
-        if (!raw_model.Read(modelFilename.c_str()))
+        std::shared_ptr<WorldModel_Raw> raw_model_ptr = getRawModel(spawn.name);
+        if (!raw_model_ptr)
             return false;
 
+        const WorldModel_Raw& raw_model = *raw_model_ptr;
+
         uint32 groups = raw_model.groupsArray.size();
         if (groups != 1)
             printf("Warning: '%s' does not seem to be a M2 model!\n", modelFilename.c_str());
@@ -265,7 +355,7 @@ namespace VMAP
         bool boundEmpty = true;
         for (uint32 g = 0; g < groups; ++g) // should be only one for M2 files...
         {
-            std::vector<Vector3>& vertices = raw_model.groupsArray[g].vertexArray;
+            const std::vector<Vector3>& vertices = raw_model.groupsArray[g].vertexArray;
 
             if (vertices.empty())
             {
@@ -304,9 +394,16 @@ namespace VMAP
             filename.append("/");
         filename.append(pModelFilename);
 
-        WorldModel_Raw raw_model;
-        if (!raw_model.Read(filename.c_str()))
-            return false;
+        // the model is converted once, so a raw model read for the spawn bounds can be handed over
+        std::shared_ptr<WorldModel_Raw> raw_model_ptr = takeRawModel(pModelFilename);
+        if (!raw_model_ptr)
+        {
+            raw_model_ptr = std::make_shared<WorldModel_Raw>();
+            if (!raw_model_ptr->Read(filename.c_str()))
+                return false;
+        }
+
+        WorldModel_Raw& raw_model = *raw_model_ptr;
 
         // write WorldModel
         WorldModel model;
@@ -328,6 +425,8 @@ namespace VMAP
         }
 
         //std::cout << "readRawFile2: '" << pModelFilename << "' tris: " << nElements << " nodes: " << nNodes << std::endl;
+        if (iCompactModels)
+            return model.writeCompactFile(iDestDir + "/" + pModelFilename + ".vmo");
         return model.writeFile(iDestDir + "/" + pModelFilename + ".vmo");
     }
 
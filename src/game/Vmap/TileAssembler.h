@@ -21,7 +21,10 @@
 
 #include <G3D/Vector3.h>
 #include <G3D/Matrix3.h>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 
 #include "ModelInstance.h"
@@ -98,6 +101,20 @@ namespace VMAP
             unsigned int iCurrentUniqueNameId;
             MapData mapData;
             std::set<std::string> spawnedModelFiles;
+            bool iCompactModels;
+            unsigned int iThreads;
+
+            // raw models read for the spawn bounds, shared by all maps and handed over to the model conversion
+            std::map<std::string, std::shared_ptr<WorldModel_Raw>> iRawModels;
+            std::mutex iRawModelsLock;
+
+            std::shared_ptr<WorldModel_Raw> getRawModel(const std::string& pModelFilename);
+            std::shared_ptr<WorldModel_Raw> takeRawModel(const std::string& pModelFilename);
+
+            //! calls pJob for each index below pCount on iThreads threads
+            void runParallel(size_t pCount, const std::function<void(size_t)>& pJob) const;
+
+            bool exportMap(uint32 pMapId, MapSpawns& pSpawns, std::set<std::string>& pModelFiles);
 
         public:
             TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName);
@@ -110,6 +127,10 @@ namespace VMAP
             void exportGameobjectModels();
             bool convertRawFile(const std::string& pModelFilename);
             void setModelNameFilterMethod(bool (*pFilterMethod)(char* pName)) { iFilterMethod = pFilterMethod; }
+            //! write .vmo files in the memory mappable layout
+            void setCompactModels(bool compact) { iCompactModels = compact; }
+            //! maps and models are converted on this many threads
+            void setThreads(unsigned int threads) { iThreads = threads ? threads : 1; }
     };
 }                                                           // VMAP
 
@@ -24,6 +24,7 @@
 namespace VMAP
 {
     const char VMAP_MAGIC[] = "VMAP_7.0";                   // used in final vmap files
+    const char VMAP_COMPACT_MAGIC[] = "VMAPc7.0";           // used in memory mappable model files
     const char RAW_VMAP_MAGIC[] = "VMAPs05";                // used in extracted vmap files with raw data
     const char GAMEOBJECT_MODELS[] = "temp_gameobject_models";
 
@@ -90,6 +90,7 @@ namespace VMAP
     // Check if specified map have tile loaded
     bool VMapManager2::IsTileLoaded(uint32 mapId, uint32 x, uint32 y) const
     {
+        std::shared_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
         InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(mapId);
         if (instanceTree == iInstanceMapTrees.end())
             return false;
@@ -101,39 +102,60 @@ namespace VMAP
 
     bool VMapManager2::_loadMap(unsigned int pMapId, const std::string& basePath, uint32 tileX, uint32 tileY)
     {
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree == iInstanceMapTrees.end())
+        // the tree can not be erased while a tile of it is loaded
+        std::lock_guard<std::mutex> loadLock(m_vmLoadMutex);
+
+        StaticMapTree* tree = nullptr;
+        {
+            std::shared_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
+            InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+            if (instanceTree != iInstanceMapTrees.end())
+                tree = instanceTree->second;
+        }
+
+        if (!tree)
         {
             std::string mapFileName = getMapFileName(pMapId);
-            StaticMapTree* newTree = new StaticMapTree(pMapId, basePath);
-            if (!newTree->InitMap(mapFileName, this))
+            tree = new StaticMapTree(pMapId, basePath);
+            if (!tree->InitMap(mapFileName, this))
             {
-                delete newTree;
+                delete tree;
                 return false;
             }
 
-            // insert new data
+            // insert new data, a tree inserted meanwhile is kept
             {
-                std::lock_guard<std::mutex> lock(m_vmStaticMapMutex);
-                instanceTree = iInstanceMapTrees.insert(InstanceTreeMap::value_type(pMapId, newTree)).first;
+                std::unique_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
+                StaticMapTree* inserted = iInstanceMapTrees.insert(InstanceTreeMap::value_type(pMapId, tree)).first->second;
+                if (inserted != tree)
+                {
+                    delete tree;
+                    tree = inserted;
+                }
             }
         }
-        return instanceTree->second->LoadMapTile(tileX, tileY, this);
+        return tree->LoadMapTile(tileX, tileY, this);
     }
 
     //=========================================================
 
     void VMapManager2::unloadMap(unsigned int pMapId)
     {
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        std::lock_guard<std::mutex> loadLock(m_vmLoadMutex);
+
+        StaticMapTree* tree = nullptr;
         {
-            instanceTree->second->UnloadMap(this);
-            if (instanceTree->second->numLoadedTiles() == 0)
-            {
-                delete instanceTree->second;
-                iInstanceMapTrees.erase(pMapId);
-            }
+            std::shared_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
+            InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+            if (instanceTree != iInstanceMapTrees.end())
+                tree = instanceTree->second;
+        }
+
+        if (tree)
+        {
+            tree->UnloadMap(this);
+            if (tree->numLoadedTiles() == 0)
+                eraseMapTree(pMapId);
         }
     }
 
@@ -141,24 +163,44 @@ namespace VMAP
 
     void VMapManager2::unloadMap(unsigned int  pMapId, int x, int y)
     {
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        std::lock_guard<std::mutex> loadLock(m_vmLoadMutex);
+
+        StaticMapTree* tree = nullptr;
         {
-            instanceTree->second->UnloadMapTile(x, y, this);
-            if (instanceTree->second->numLoadedTiles() == 0)
-            {
-                delete instanceTree->second;
-                iInstanceMapTrees.erase(pMapId);
-            }
+            std::shared_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
+            InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+            if (instanceTree != iInstanceMapTrees.end())
+                tree = instanceTree->second;
+        }
+
+        if (tree)
+        {
+            tree->UnloadMapTile(x, y, this);
+            if (tree->numLoadedTiles() == 0)
+                eraseMapTree(pMapId);
         }
     }
 
+    void VMapManager2::eraseMapTree(unsigned int pMapId)
+    {
+        // callers hold m_vmLoadMutex, no tile of the tree is loaded meanwhile
+        // waits for the queries still walking the tree
+        std::unique_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        delete instanceTree->second;
+        iInstanceMapTrees.erase(instanceTree);
+    }
+
     //==========================================================
 
     bool VMapManager2::isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, bool ignoreM2Model)
     {
         if (!isLineOfSightCalcEnabled()) return true;
         bool result = true;
+        std::shared_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
         InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
         if (instanceTree != iInstanceMapTrees.end())
         {
@@ -171,6 +213,25 @@ namespace VMAP
         }
         return result;
     }
+
+    void VMapManager2::isInLineOfSightBatch(unsigned int pMapId, Vector3 const& origin, std::vector<Vector3> const& targets, std::vector<bool>& results, bool ignoreM2Model)
+    {
+        results.assign(targets.size(), true);
+        if (!isLineOfSightCalcEnabled() || targets.empty())
+            return;
+
+        std::shared_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        std::vector<Vector3> internalTargets;
+        internalTargets.reserve(targets.size());
+        for (Vector3 const& target : targets)
+            internalTargets.push_back(convertPositionToInternalRep(target.x, target.y, target.z));
+
+        instanceTree->second->isInLineOfSightBatch(convertPositionToInternalRep(origin.x, origin.y, origin.z), internalTargets, results, ignoreM2Model);
+    }
     //=========================================================
     /**
     get the hit position and return true if we hit something
@@ -184,6 +245,7 @@ namespace VMAP
         rz = z2;
         if (isLineOfSightCalcEnabled())
         {
+            std::shared_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
             InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
             if (instanceTree != iInstanceMapTrees.end())
             {
@@ -210,6 +272,7 @@ namespace VMAP
         float height = VMAP_INVALID_HEIGHT_VALUE;           // no height
         if (isHeightCalcEnabled())
         {
+            std::shared_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
             InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
             if (instanceTree != iInstanceMapTrees.end())
             {
@@ -229,6 +292,7 @@ namespace VMAP
     bool VMapManager2::getAreaInfo(unsigned int pMapId, float x, float y, float& z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
     {
         bool result = false;
+        std::shared_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
         InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(pMapId);
         if (instanceTree != iInstanceMapTrees.end())
         {
@@ -242,6 +306,7 @@ namespace VMAP
 
     bool VMapManager2::GetLiquidLevel(uint32 pMapId, float x, float y, float z, uint8 ReqLiquidType, float& level, float& floor, uint32& type) const
     {
+        std::shared_lock<std::shared_mutex> lock(m_vmStaticMapMutex);
         InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(pMapId);
         if (instanceTree != iInstanceMapTrees.end())
         {
@@ -287,6 +352,7 @@ namespace VMAP
 
     void VMapManager2::releaseModelInstance(const std::string& filename)
     {
+        std::lock_guard<std::mutex> lock(m_vmModelMutex);
         ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
         if (model == iLoadedModelFiles.end())
         {
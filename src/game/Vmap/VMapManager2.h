@@ -25,6 +25,7 @@
 
 #include <unordered_map>
 #include <mutex>
+#include <shared_mutex>
 
 //===========================================================
 
@@ -66,8 +67,11 @@ namespace VMAP
     class VMapManager2 : public IVMapManager
     {
         private:
-            std::mutex m_vmStaticMapMutex;
+            // queries of all map threads share it, only tree insertion and tile contents changes take it exclusively
+            mutable std::shared_mutex m_vmStaticMapMutex;
             std::mutex m_vmModelMutex;
+            // serializes tile loads and unloads of all maps, map threads and the grid preloader load at the same time
+            std::mutex m_vmLoadMutex;
 
         protected:
             // Tree to check collision
@@ -75,6 +79,7 @@ namespace VMAP
             InstanceTreeMap iInstanceMapTrees;
 
             bool _loadMap(uint32 pMapId, const std::string& basePath, uint32 tileX, uint32 tileY);
+            void eraseMapTree(uint32 pMapId);
             /* void _unloadMap(uint32 pMapId, uint32 x, uint32 y); */
 
         public:
@@ -92,6 +97,7 @@ namespace VMAP
             void unloadMap(unsigned int pMapId) override;
 
             bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, bool ignoreM2Model) override;
+            void isInLineOfSightBatch(unsigned int pMapId, G3D::Vector3 const& origin, std::vector<G3D::Vector3> const& targets, std::vector<bool>& results, bool ignoreM2Model) override;
             /**
             fill the hit pos and return true, if an object was hit
             */
@@ -106,6 +112,9 @@ namespace VMAP
             WorldModel* acquireModelInstance(const std::string& basepath, const std::string& filename);
             void releaseModelInstance(const std::string& filename);
 
+            // taken exclusively by StaticMapTree around changes of the loaded model instances
+            std::shared_mutex& GetStaticMapLock() { return m_vmStaticMapMutex; }
+
             // what's the use of this? o.O
             std::string getDirFileName(unsigned int pMapId, int /*x*/, int /*y*/) const override
             {
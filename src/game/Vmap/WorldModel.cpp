@@ -20,8 +20,14 @@
 #include "VMapDefinitions.h"
 #include "MapTree.h"
 #include "ModelInstance.h"
+#include "Util/MappedFile.h"
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VMAP_SSE2_TRIANGLES
+#include <emmintrin.h>
+#endif
+
 using G3D::Vector3;
 using G3D::Ray;
 
@@ -32,7 +38,11 @@ template<> struct BoundsTrait<VMAP::GroupModel>
 
 namespace VMAP
 {
-    bool IntersectTriangle(MeshTriangle const& tri, std::vector<Vector3>::const_iterator points, G3D::Ray const& ray, float& distance)
+    // compact model files store both as plain float/uint32 triples
+    static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be tightly packed");
+    static_assert(sizeof(MeshTriangle) == 3 * sizeof(uint32), "MeshTriangle must be tightly packed");
+
+    bool IntersectTriangle(MeshTriangle const& tri, Vector3 const* points, G3D::Ray const& ray, float& distance)
     {
 #define EPS 1e-5f
 
@@ -86,6 +96,74 @@ namespace VMAP
         return false;
     }
 
+#ifdef VMAP_SSE2_TRIANGLES
+    // Same test as IntersectTriangle for up to four triangles at once, one per SSE lane.
+    // Lanes see the same float operations in the same order, so hits match the scalar test,
+    // distance ends up at the closest hit of the group.
+    bool IntersectTriangles4(MeshTriangle const* triangles, uint32 const* entries, int count,
+                             Vector3 const* points, G3D::Ray const& ray, float& distance)
+    {
+        alignas(16) float v0[3][4], v1[3][4], v2[3][4];
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            // unused lanes repeat the last triangle
+            MeshTriangle const& tri = triangles[entries[lane < count ? lane : count - 1]];
+            Vector3 const& p0 = points[tri.idx0];
+            Vector3 const& p1 = points[tri.idx1];
+            Vector3 const& p2 = points[tri.idx2];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                v0[axis][lane] = p0[axis];
+                v1[axis][lane] = p1[axis];
+                v2[axis][lane] = p2[axis];
+            }
+        }
+
+        __m128 const x0 = _mm_load_ps(v0[0]), y0 = _mm_load_ps(v0[1]), z0 = _mm_load_ps(v0[2]);
+        __m128 const e1x = _mm_sub_ps(_mm_load_ps(v1[0]), x0), e1y = _mm_sub_ps(_mm_load_ps(v1[1]), y0), e1z = _mm_sub_ps(_mm_load_ps(v1[2]), z0);
+        __m128 const e2x = _mm_sub_ps(_mm_load_ps(v2[0]), x0), e2y = _mm_sub_ps(_mm_load_ps(v2[1]), y0), e2z = _mm_sub_ps(_mm_load_ps(v2[2]), z0);
+
+        Vector3 const& dir = ray.direction();
+        Vector3 const& org = ray.origin();
+        __m128 const dx = _mm_set1_ps(dir.x), dy = _mm_set1_ps(dir.y), dz = _mm_set1_ps(dir.z);
+
+        // p = dir x e2, a = e1 . p
+        __m128 const px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        __m128 const py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        __m128 const pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        __m128 const a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+
+        __m128 const zero = _mm_setzero_ps();
+        __m128 const one = _mm_set1_ps(1.0f);
+        __m128 const absA = _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+        __m128 mask = _mm_cmpge_ps(absA, _mm_set1_ps(EPS));
+        if (!_mm_movemask_ps(mask))
+            return false;
+
+        __m128 const f = _mm_div_ps(one, a);
+        __m128 const sx = _mm_sub_ps(_mm_set1_ps(org.x), x0), sy = _mm_sub_ps(_mm_set1_ps(org.y), y0), sz = _mm_sub_ps(_mm_set1_ps(org.z), z0);
+        __m128 const u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)));
+        mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+
+        // q = s x e1
+        __m128 const qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        __m128 const qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        __m128 const qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+        __m128 const v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+        mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+        __m128 const t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+        mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, _mm_set1_ps(distance))));
+        if (!_mm_movemask_ps(mask))
+            return false;
+
+        alignas(16) float hits[4];
+        _mm_store_ps(hits, _mm_or_ps(_mm_and_ps(mask, t), _mm_andnot_ps(mask, _mm_set1_ps(distance))));
+        distance = std::min(std::min(hits[0], hits[1]), std::min(hits[2], hits[3]));
+        return true;
+    }
+#endif
+
     class TriBoundFunc
     {
         public:
@@ -219,7 +297,7 @@ namespace VMAP
 
     uint32 WmoLiquid::GetFileSize() const
     {
-        return 2 * sizeof(uint32) +
+        return 3 * sizeof(uint32) +
                sizeof(Vector3) +
                (iTilesX + 1) * (iTilesY + 1) * sizeof(float) + iTilesX * iTilesY;
     }
@@ -261,20 +339,87 @@ namespace VMAP
         return result;
     }
 
+    bool WmoLiquid::readFromMemory(uint8 const* data, uint32 size, WmoLiquid*& out)
+    {
+        out = nullptr;
+        uint32 const headerSize = 3 * sizeof(uint32) + sizeof(Vector3);
+        if (size < headerSize)
+            return false;
+
+        WmoLiquid* liquid = new WmoLiquid();
+        memcpy(&liquid->iTilesX, data, sizeof(uint32));
+        memcpy(&liquid->iTilesY, data + sizeof(uint32), sizeof(uint32));
+        memcpy(&liquid->iCorner, data + 2 * sizeof(uint32), sizeof(Vector3));
+        memcpy(&liquid->iType, data + 2 * sizeof(uint32) + sizeof(Vector3), sizeof(uint32));
+        uint64 const heights = uint64(liquid->iTilesX + 1) * (liquid->iTilesY + 1);
+        uint64 const flags = uint64(liquid->iTilesX) * liquid->iTilesY;
+        if (headerSize + heights * sizeof(float) + flags > size)
+        {
+            delete liquid;
+            return false;
+        }
+
+        liquid->iHeight = new float[heights];
+        memcpy(liquid->iHeight, data + headerSize, heights * sizeof(float));
+        liquid->iFlags = new uint8[flags];
+        memcpy(liquid->iFlags, data + headerSize + heights * sizeof(float), flags);
+        out = liquid;
+        return true;
+    }
+
     // ===================== GroupModel ==================================
 
     GroupModel::GroupModel(GroupModel const& other):
         iBound(other.iBound), iMogpFlags(other.iMogpFlags), iGroupWMOID(other.iGroupWMOID),
-        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), iLiquid(nullptr)
+        vertices(other.vertices), triangles(other.triangles), iVertices(nullptr), iVertexCount(0),
+        iTriangles(nullptr), iTriangleCount(0), meshTree(other.meshTree), iLiquid(nullptr)
     {
+        bindMesh();
+        if (other.iVertices != other.vertices.data() || other.iTriangles != other.triangles.data())
+        {
+            // mesh lives in the mapped file of the owning WorldModel
+            iVertices = other.iVertices;
+            iVertexCount = other.iVertexCount;
+            iTriangles = other.iTriangles;
+            iTriangleCount = other.iTriangleCount;
+        }
         if (other.iLiquid)
             iLiquid = new WmoLiquid(*other.iLiquid);
     }
 
+    GroupModel& GroupModel::operator=(GroupModel const& other)
+    {
+        if (this == &other)
+            return *this;
+
+        GroupModel copy(other);
+        std::swap(iBound, copy.iBound);
+        std::swap(iMogpFlags, copy.iMogpFlags);
+        std::swap(iGroupWMOID, copy.iGroupWMOID);
+        vertices.swap(copy.vertices);
+        triangles.swap(copy.triangles);
+        std::swap(iVertices, copy.iVertices);
+        std::swap(iVertexCount, copy.iVertexCount);
+        std::swap(iTriangles, copy.iTriangles);
+        std::swap(iTriangleCount, copy.iTriangleCount);
+        meshTree = copy.meshTree;
+        std::swap(iLiquid, copy.iLiquid);
+        return *this;
+    }
+
+    void GroupModel::bindMesh()
+    {
+        iVertices = vertices.data();
+        iVertexCount = vertices.size();
+        iTriangles = triangles.data();
+        iTriangleCount = triangles.size();
+    }
+
     void GroupModel::setMeshData(std::vector<Vector3>& vert, std::vector<MeshTriangle>& tri)
     {
         vertices.swap(vert);
         triangles.swap(tri);
+        bindMesh();
         TriBoundFunc bFunc(vertices);
         meshTree.build(triangles, bFunc);
     }
@@ -290,22 +435,22 @@ namespace VMAP
 
         // write vertices
         if (result && fwrite("VERT", 1, 4, wf) != 4) result = false;
-        count = vertices.size();
+        count = iVertexCount;
         chunkSize = sizeof(uint32) + sizeof(Vector3) * count;
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
         if (!count) // models without (collision) geometry end here, unsure if they are useful
             return result;
-        if (result && fwrite(&vertices[0], sizeof(Vector3), count, wf) != count) result = false;
+        if (result && fwrite(iVertices, sizeof(Vector3), count, wf) != count) result = false;
 
         // write triangle mesh
         if (result && fwrite("TRIM", 1, 4, wf) != 4) result = false;
-        count = triangles.size();
+        count = iTriangleCount;
         chunkSize = sizeof(uint32) + sizeof(MeshTriangle) * count;
         if (result && fwrite(&chunkSize, sizeof(uint32), 1, wf) != 1) result = false;
         if (result && fwrite(&count, sizeof(uint32), 1, wf) != 1) result = false;
         if (count)
-            if (result && fwrite(&triangles[0], sizeof(MeshTriangle), count, wf) != count) result = false;
+            if (result && fwrite(iTriangles, sizeof(MeshTriangle), count, wf) != count) result = false;
 
         // write mesh BIH
         if (result && fwrite("MBIH", 1, 4, wf) != 4) result = false;
@@ -332,6 +477,7 @@ namespace VMAP
         uint32 count = 0;
         triangles.clear();
         vertices.clear();
+        bindMesh();
         delete iLiquid;
         iLiquid = nullptr;
 
@@ -347,6 +493,7 @@ namespace VMAP
             return result;
         if (result) vertices.resize(count);
         if (result && fread(&vertices[0], sizeof(Vector3), count, rf) != count) result = false;
+        bindMesh();
 
         // read triangle mesh
         if (result && !readChunk(rf, chunk, "TRIM", 4)) result = false;
@@ -356,6 +503,7 @@ namespace VMAP
         {
             if (result) triangles.resize(count);
             if (result && fread(&triangles[0], sizeof(MeshTriangle), count, rf) != count) result = false;
+            bindMesh();
         }
 
         // read mesh BIH
@@ -372,8 +520,8 @@ namespace VMAP
 
     struct GModelRayCallback
     {
-        GModelRayCallback(const std::vector<MeshTriangle>& tris, const std::vector<Vector3>& vert):
-            vertices(vert.begin()), triangles(tris.begin()), hit(false) {}
+        GModelRayCallback(MeshTriangle const* tris, Vector3 const* vert):
+            vertices(vert), triangles(tris), hit(false) {}
         bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool /*pStopAtFirstHit*/, bool /*ignoreM2Model*/)
         {
             bool result = IntersectTriangle(triangles[entry], vertices, ray, distance);
@@ -381,24 +529,50 @@ namespace VMAP
                 hit = true;
             return hit;
         }
-        std::vector<Vector3>::const_iterator vertices;
-        std::vector<MeshTriangle>::const_iterator triangles;
+        // whole BIH leaf
+        bool operator()(const G3D::Ray& ray, uint32 const* entries, int count, float& distance, bool pStopAtFirstHit)
+        {
+#ifdef VMAP_SSE2_TRIANGLES
+            for (int i = 0; i < count; i += 4)
+            {
+                if (IntersectTriangles4(triangles, entries + i, std::min(count - i, 4), vertices, ray, distance))
+                {
+                    hit = true;
+                    if (pStopAtFirstHit)
+                        break;
+                }
+            }
+#else
+            for (int i = 0; i < count; ++i)
+            {
+                if (IntersectTriangle(triangles[entries[i]], vertices, ray, distance))
+                {
+                    hit = true;
+                    if (pStopAtFirstHit)
+                        break;
+                }
+            }
+#endif
+            return hit;
+        }
+        Vector3 const* vertices;
+        MeshTriangle const* triangles;
         bool hit;
     };
 
     bool GroupModel::IntersectRay(G3D::Ray const& ray, float& distance, bool stopAtFirstHit, bool ignoreM2Model) const
     {
-        if (triangles.empty())
+        if (!iTriangleCount)
             return false;
 
-        GModelRayCallback callback(triangles, vertices);
-        meshTree.intersectRay(ray, callback, distance, stopAtFirstHit, ignoreM2Model);
+        GModelRayCallback callback(iTriangles, iVertices);
+        meshTree.intersectRayLeaves(ray, callback, distance, stopAtFirstHit);
         return callback.hit;
     }
 
     bool GroupModel::IsInsideObject(Vector3 const& pos, Vector3 const& down, float& z_dist) const
     {
-        if (triangles.empty() || !iBound.contains(pos))
+        if (!iTriangleCount || !iBound.contains(pos))
             return false;
 
         Vector3 rPos = pos - 0.1f * down;
@@ -577,7 +751,16 @@ namespace VMAP
         uint32 chunkSize = 0;
         uint32 count = 0;
         char chunk[8];                          // Ignore the added magic header
-        if (!readChunk(rf, chunk, VMAP_MAGIC, 8)) result = false;
+        if (fread(chunk, sizeof(char), 8, rf) != 8)
+            result = false;
+        else if (!memcmp(chunk, VMAP_COMPACT_MAGIC, 8))
+        {
+            fclose(rf);
+            return readCompactFile(filename);
+        }
+        else if (memcmp(chunk, VMAP_MAGIC, 8))
+            result = false;
+        iMapping.reset();
 
         if (result && !readChunk(rf, chunk, "WMOD", 4)) result = false;
         if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
@@ -602,4 +785,209 @@ namespace VMAP
         fclose(rf);
         return result;
     }
+
+    // ===================== compact model file ==========================
+    // magic, header, group table, then the vertex, triangle and BIH index pools shared by all
+    // groups and finally the liquid blobs. Everything up to the liquids is 4 byte aligned so
+    // the pools are used in place from the mapped file.
+
+    struct CompactTree
+    {
+        float lo[3];
+        float hi[3];
+        uint32 treeOffset;                                  // into the index pool
+        uint32 treeSize;
+        uint32 objectOffset;
+        uint32 objectCount;
+    };
+
+    struct CompactModelHeader
+    {
+        uint32 rootWMOID;
+        uint32 groupCount;
+        uint32 vertexCount;
+        uint32 triangleCount;
+        uint32 indexCount;
+        uint32 liquidSize;
+        CompactTree groupTree;
+    };
+
+    struct CompactGroup
+    {
+        float lo[3];
+        float hi[3];
+        uint32 mogpFlags;
+        uint32 groupWMOID;
+        uint32 firstVertex;
+        uint32 vertexCount;
+        uint32 firstTriangle;
+        uint32 triangleCount;
+        CompactTree meshTree;
+        uint32 liquidOffset;                                // into the liquid blobs, 0 size for none
+        uint32 liquidSize;
+    };
+
+    static void PackTree(BIH const& tree, std::vector<uint32>& indices, CompactTree& out)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            out.lo[i] = tree.getBounds().low()[i];
+            out.hi[i] = tree.getBounds().high()[i];
+        }
+        out.treeOffset = indices.size();
+        out.treeSize = tree.getTreeSize();
+        indices.insert(indices.end(), tree.getTreeData(), tree.getTreeData() + tree.getTreeSize());
+        out.objectOffset = indices.size();
+        out.objectCount = tree.primCount();
+        indices.insert(indices.end(), tree.getObjectData(), tree.getObjectData() + tree.primCount());
+    }
+
+    static bool UnpackTree(CompactTree const& in, uint32 const* indices, uint32 indexCount, BIH& out)
+    {
+        if (in.treeSize < 3 || in.treeOffset > indexCount || in.treeSize > indexCount - in.treeOffset ||
+                in.objectOffset > indexCount || in.objectCount > indexCount - in.objectOffset)
+            return false;
+
+        out.setStorage(G3D::AABox(Vector3(in.lo[0], in.lo[1], in.lo[2]), Vector3(in.hi[0], in.hi[1], in.hi[2])),
+                       indices + in.treeOffset, in.treeSize, indices + in.objectOffset, in.objectCount);
+        return true;
+    }
+
+    bool WorldModel::writeCompactFile(std::string const& filename)
+    {
+        CompactModelHeader header;
+        memset(&header, 0, sizeof(header));
+        header.rootWMOID = RootWMOID;
+        header.groupCount = groupModels.size();
+
+        std::vector<CompactGroup> groups(groupModels.size());
+        std::vector<uint32> indices;
+        for (uint32 i = 0; i < groupModels.size(); ++i)
+        {
+            GroupModel const& model = groupModels[i];
+            CompactGroup& group = groups[i];
+            memset(&group, 0, sizeof(group));
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                group.lo[axis] = model.iBound.low()[axis];
+                group.hi[axis] = model.iBound.high()[axis];
+            }
+            group.mogpFlags = model.iMogpFlags;
+            group.groupWMOID = model.iGroupWMOID;
+            group.firstVertex = header.vertexCount;
+            group.vertexCount = model.iVertexCount;
+            group.firstTriangle = header.triangleCount;
+            group.triangleCount = model.iTriangleCount;
+            PackTree(model.meshTree, indices, group.meshTree);
+            group.liquidOffset = header.liquidSize;
+            group.liquidSize = model.iLiquid ? model.iLiquid->GetFileSize() : 0;
+
+            header.vertexCount += group.vertexCount;
+            header.triangleCount += group.triangleCount;
+            header.liquidSize += group.liquidSize;
+        }
+        PackTree(groupTree, indices, header.groupTree);
+        header.indexCount = indices.size();
+
+        FILE* wf = fopen(filename.c_str(), "wb");
+        if (!wf)
+            return false;
+
+        bool result = fwrite(VMAP_COMPACT_MAGIC, 1, 8, wf) == 8;
+        if (result && fwrite(&header, sizeof(header), 1, wf) != 1) result = false;
+        if (result && !groups.empty() && fwrite(&groups[0], sizeof(CompactGroup), groups.size(), wf) != groups.size()) result = false;
+        for (uint32 i = 0; i < groupModels.size() && result; ++i)
+            if (groupModels[i].iVertexCount && fwrite(groupModels[i].iVertices, sizeof(Vector3), groupModels[i].iVertexCount, wf) != groupModels[i].iVertexCount)
+                result = false;
+        for (uint32 i = 0; i < groupModels.size() && result; ++i)
+            if (groupModels[i].iTriangleCount && fwrite(groupModels[i].iTriangles, sizeof(MeshTriangle), groupModels[i].iTriangleCount, wf) != groupModels[i].iTriangleCount)
+                result = false;
+        if (result && !indices.empty() && fwrite(&indices[0], sizeof(uint32), indices.size(), wf) != indices.size()) result = false;
+        for (uint32 i = 0; i < groupModels.size() && result; ++i)
+            if (groupModels[i].iLiquid)
+                result = groupModels[i].iLiquid->writeToFile(wf);
+
+        fclose(wf);
+        return result;
+    }
+
+    bool WorldModel::readCompactFile(std::string const& filename)
+    {
+        std::shared_ptr<MappedFile> mapping(MappedFile::Open(filename.c_str()));
+        if (!mapping)
+            return false;
+
+        uint8 const* data = mapping->GetData();
+        size_t const size = mapping->GetSize();
+        size_t offset = 8;
+        if (size < offset + sizeof(CompactModelHeader))
+            return false;
+
+        CompactModelHeader header;
+        memcpy(&header, data + offset, sizeof(header));
+        offset += sizeof(header);
+
+        // validate the pool sizes before pointing anything into the mapping
+        uint64 const poolSize = uint64(header.groupCount) * sizeof(CompactGroup) + uint64(header.vertexCount) * sizeof(Vector3) +
+                                uint64(header.triangleCount) * sizeof(MeshTriangle) + uint64(header.indexCount) * sizeof(uint32) + header.liquidSize;
+        if (poolSize > size - offset)
+            return false;
+
+        CompactGroup const* groups = reinterpret_cast<CompactGroup const*>(data + offset);
+        offset += header.groupCount * sizeof(CompactGroup);
+        Vector3 const* vertices = reinterpret_cast<Vector3 const*>(data + offset);
+        offset += header.vertexCount * sizeof(Vector3);
+        MeshTriangle const* triangles = reinterpret_cast<MeshTriangle const*>(data + offset);
+        offset += header.triangleCount * sizeof(MeshTriangle);
+        uint32 const* indices = reinterpret_cast<uint32 const*>(data + offset);
+        offset += header.indexCount * sizeof(uint32);
+        uint8 const* liquids = data + offset;
+
+        std::vector<GroupModel> models(header.groupCount);
+        for (uint32 i = 0; i < header.groupCount; ++i)
+        {
+            CompactGroup const& group = groups[i];
+            GroupModel& model = models[i];
+            if (group.firstVertex > header.vertexCount || group.vertexCount > header.vertexCount - group.firstVertex ||
+                    group.firstTriangle > header.triangleCount || group.triangleCount > header.triangleCount - group.firstTriangle ||
+                    group.liquidOffset > header.liquidSize || group.liquidSize > header.liquidSize - group.liquidOffset)
+                return false;
+
+            model.iBound = G3D::AABox(Vector3(group.lo[0], group.lo[1], group.lo[2]), Vector3(group.hi[0], group.hi[1], group.hi[2]));
+            model.iMogpFlags = group.mogpFlags;
+            model.iGroupWMOID = group.groupWMOID;
+            model.iVertices = vertices + group.firstVertex;
+            model.iVertexCount = group.vertexCount;
+            model.iTriangles = triangles + group.firstTriangle;
+            model.iTriangleCount = group.triangleCount;
+
+            // the ray test trusts the indices, so check them once here
+            for (uint32 t = 0; t < group.triangleCount; ++t)
+            {
+                MeshTriangle const& tri = model.iTriangles[t];
+                if (tri.idx0 >= group.vertexCount || tri.idx1 >= group.vertexCount || tri.idx2 >= group.vertexCount)
+                    return false;
+            }
+
+            if (!UnpackTree(group.meshTree, indices, header.indexCount, model.meshTree))
+                return false;
+            for (uint32 o = 0; o < group.meshTree.objectCount; ++o)
+                if (indices[group.meshTree.objectOffset + o] >= group.triangleCount)
+                    return false;
+
+            if (group.liquidSize && !WmoLiquid::readFromMemory(liquids + group.liquidOffset, group.liquidSize, model.iLiquid))
+                return false;
+        }
+
+        if (!UnpackTree(header.groupTree, indices, header.indexCount, groupTree))
+            return false;
+        for (uint32 o = 0; o < header.groupTree.objectCount; ++o)
+            if (indices[header.groupTree.objectOffset + o] >= header.groupCount)
+                return false;
+
+        RootWMOID = header.rootWMOID;
+        groupModels.swap(models);
+        iMapping = mapping;
+        return true;
+    }
 }
@@ -27,6 +27,10 @@
 
 #include "Platform/Define.h"
 
+#include <memory>
+
+class MappedFile;
+
 namespace VMAP
 {
     class TreeNode;
@@ -58,6 +62,7 @@ namespace VMAP
             uint32 GetFileSize() const;
             bool writeToFile(FILE* wf);
             static bool readFromFile(FILE* rf, WmoLiquid*& out);
+            static bool readFromMemory(uint8 const* data, uint32 size, WmoLiquid*& out);
         private:
             WmoLiquid() : iTilesX(0), iTilesY(0), iType(0), iHeight(nullptr), iFlags(nullptr) {};
             uint32 iTilesX;  //!< number of tiles in x direction, each
@@ -75,12 +80,14 @@ namespace VMAP
     /*! holding additional info for WMO group files */
     class GroupModel
     {
+            friend class WorldModel;
         public:
-            GroupModel() : iMogpFlags(0), iGroupWMOID(0), iLiquid(nullptr) {}
+            GroupModel() : iMogpFlags(0), iGroupWMOID(0), iVertices(nullptr), iVertexCount(0), iTriangles(nullptr), iTriangleCount(0), iLiquid(nullptr) {}
             GroupModel(GroupModel const& other);
             GroupModel(uint32 mogpFlags, uint32 groupWMOID, AABox const& bound) :
-                iBound(bound), iMogpFlags(mogpFlags), iGroupWMOID(groupWMOID), iLiquid(nullptr) {}
+                iBound(bound), iMogpFlags(mogpFlags), iGroupWMOID(groupWMOID), iVertices(nullptr), iVertexCount(0), iTriangles(nullptr), iTriangleCount(0), iLiquid(nullptr) {}
             ~GroupModel() { delete iLiquid; }
+            GroupModel& operator=(GroupModel const& other);
 
             //! pass mesh data to object and create BIH. Passed vectors get get swapped with old geometry!
             void setMeshData(std::vector<Vector3>& vert, std::vector<MeshTriangle>& tri);
@@ -100,9 +107,16 @@ namespace VMAP
             uint32 iGroupWMOID;
             std::vector<Vector3> vertices;
             std::vector<MeshTriangle> triangles;
+            // mesh used by queries, either the vectors above or the shared pools of a compact model file
+            Vector3 const* iVertices;
+            uint32 iVertexCount;
+            MeshTriangle const* iTriangles;
+            uint32 iTriangleCount;
             BIH meshTree;
             WmoLiquid* iLiquid;
 
+            void bindMesh();
+
 #ifdef MMAP_GENERATOR
         public:
             void getMeshData(std::vector<Vector3>& outVertices, std::vector<MeshTriangle>& outTriangles, WmoLiquid*& liquid);
@@ -121,6 +135,8 @@ namespace VMAP
             bool IntersectPoint(const G3D::Vector3& p, const G3D::Vector3& down, float& dist, AreaInfo& info) const;
             bool GetLocationInfo(const G3D::Vector3& p, const G3D::Vector3& down, float& dist, LocationInfo& info) const;
             bool writeFile(const std::string& filename);
+            //! relocatable layout with vertex, triangle and tree pools shared by all groups, loaded by mapping the file
+            bool writeCompactFile(const std::string& filename);
             bool readFile(const std::string& filename);
             void setModelFlags(uint32 newFlags) { modelFlags = newFlags; }
             uint32 getModelFlags() const { return modelFlags; }
@@ -129,6 +145,9 @@ namespace VMAP
             std::vector<GroupModel> groupModels;
             BIH groupTree;
             uint32 modelFlags;
+            std::shared_ptr<MappedFile> iMapping;           // backs the mesh and trees of compact model files
+
+            bool readCompactFile(const std::string& filename);
 
 #ifdef MMAP_GENERATOR
         public:
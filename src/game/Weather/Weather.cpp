@@ -37,28 +37,15 @@ Weather::Weather(uint32 zone, WeatherZoneChances const* weatherChances) :
     m_weatherChances(weatherChances),
     m_isPermanentWeather(false)
 {
-    m_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER));
-    DETAIL_FILTER_LOG(LOG_FILTER_WEATHER, "WORLD: Starting weather system for zone %u (change every %u minutes).", m_zone, (m_timer.GetInterval() / (MINUTE * IN_MILLISECONDS)));
+    DETAIL_FILTER_LOG(LOG_FILTER_WEATHER, "WORLD: Starting weather system for zone %u (change every %u minutes).", m_zone, (sWorld.getConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER) / (MINUTE * IN_MILLISECONDS)));
 }
 
-/// Launch a weather update
-bool Weather::Update(uint32 diff, Map const* _map)
+/// Launch a weather change
+void Weather::Change(Map const* _map)
 {
-    m_timer.Update(diff);
-
-    ///- If the timer has passed, ReGenerate the weather
-    if (m_timer.Passed())
-    {
-        m_timer.Reset();
-        // update only if Regenerate has changed the weather
-        if (ReGenerate())
-        {
-            ///- Weather will be removed if not updated (no players in zone anymore)
-            if (!SendWeatherForPlayersInZone(_map))
-                return false;
-        }
-    }
-    return true;
+    // update only if Regenerate has changed the weather
+    if (ReGenerate())
+        SendWeatherForPlayersInZone(_map);
 }
 
 /// Calculate the new weather, returns true if and only if the weather changed
@@ -188,37 +175,37 @@ bool Weather::ReGenerate()
     return m_type != old_type || m_grade != old_grade;
 }
 
-void Weather::SendWeatherUpdateToPlayer(Player* player)
+std::shared_ptr<WorldPacket const> const& Weather::GetWeatherPacket()
 {
-    NormalizeGrade();
+    if (!m_packet)
+    {
+        NormalizeGrade();
 
-    WorldPacket data(SMSG_WEATHER, 4 + 4 + 1);
-    data << uint32(GetWeatherState());
-    data << float(m_grade);
-    data << uint8(0);       // 1 = instant change, 0 = smooth change
+        std::shared_ptr<WorldPacket> data = std::make_shared<WorldPacket>(SMSG_WEATHER, 4 + 4 + 1);
+        *data << uint32(GetWeatherState());
+        *data << float(m_grade);
+        *data << uint8(0);  // 1 = instant change, 0 = smooth change
+        m_packet = std::move(data);
+    }
+    return m_packet;
+}
 
-    player->GetSession()->SendPacket(data);
+void Weather::SendWeatherUpdateToPlayer(Player* player)
+{
+    player->GetSession()->SendPacket(GetWeatherPacket());
 }
 
 // Send the new weather to all players in the zone
-bool Weather::SendWeatherForPlayersInZone(Map const* _map)
+void Weather::SendWeatherForPlayersInZone(Map const* _map)
 {
-    NormalizeGrade();
-
-    WeatherState state = GetWeatherState();
-
-    WorldPacket data(SMSG_WEATHER, 4 + 4 + 1);
-    data << uint32(state);
-    data << float(m_grade);
-    data << uint8(0);       // 1 = instant change, 0 = smooth change
+    m_packet.reset();
 
     ///- Send the weather packet to all players in this zone
-    if (!_map->SendToPlayersInZone(data, m_zone))
-        return false;
+    if (!_map->SendToPlayersInZone(GetWeatherPacket(), m_zone))
+        return;
 
     ///- Log the event
-    LogWeatherState(state);
-    return true;
+    LogWeatherState(GetWeatherState());
 }
 
 // Set the weather
@@ -336,7 +323,7 @@ void Weather::LogWeatherState(WeatherState state) const
 //                  Weather System
 // ---------------------------------------------------------
 
-WeatherSystem::WeatherSystem(Map const* _map) : m_map(_map)
+WeatherSystem::WeatherSystem(Map const* _map) : m_map(_map), m_time(0)
 {}
 
 WeatherSystem::~WeatherSystem()
@@ -358,24 +345,67 @@ Weather* WeatherSystem::FindOrCreateWeather(uint32 zoneId)
     // Create
     Weather* w = new Weather(zoneId, sWeatherMgr.GetWeatherChances(zoneId));
     m_weathers[zoneId] = w;
+    ScheduleChange(zoneId);
     return w;
 }
 
+void WeatherSystem::SendWeatherUpdateToPlayer(Player* player, uint32 zoneId)
+{
+    WeatherMap::const_iterator itr = m_weathers.find(zoneId);
+    if (itr != m_weathers.end())
+    {
+        itr->second->SendWeatherUpdateToPlayer(player);
+        return;
+    }
+
+    // no weather object for zones which never change, most instances
+    if (!sWeatherMgr.GetWeatherChances(zoneId))
+    {
+        static std::shared_ptr<WorldPacket const> const finePacket = []()
+        {
+            std::shared_ptr<WorldPacket> data = std::make_shared<WorldPacket>(SMSG_WEATHER, 4 + 4 + 1);
+            *data << uint32(WEATHER_STATE_FINE);
+            *data << float(0.0f);
+            *data << uint8(0);
+            return data;
+        }();
+        player->GetSession()->SendPacket(finePacket);
+        return;
+    }
+
+    FindOrCreateWeather(zoneId)->SendWeatherUpdateToPlayer(player);
+}
+
+void WeatherSystem::ScheduleChange(uint32 zoneId)
+{
+    m_schedule.emplace(m_time + sWorld.getConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER), zoneId);
+}
+
 /// Update Weathers for the different zones
 void WeatherSystem::UpdateWeathers(uint32 diff)
 {
-    ///- Send an update signal to Weather objects
-    for (WeatherMap::iterator itr = m_weathers.begin(); itr != m_weathers.end();)
+    m_time += diff;
+
+    ///- Only the weathers whose change is due are touched
+    while (!m_schedule.empty() && m_schedule.begin()->first <= m_time)
     {
-        ///- and remove Weather objects for zones with no player
-        // As interval > WorldTick
-        if (!itr->second->Update(diff, m_map))
+        uint32 zoneId = m_schedule.begin()->second;
+        m_schedule.erase(m_schedule.begin());
+
+        WeatherMap::iterator itr = m_weathers.find(zoneId);
+        if (itr == m_weathers.end())
+            continue;
+
+        ///- Remove Weather objects for zones with no player
+        if (!m_map->HasPlayersInZone(zoneId))
         {
             delete itr->second;
-            m_weathers.erase(itr++);
+            m_weathers.erase(itr);
+            continue;
         }
-        else
-            ++itr;
+
+        itr->second->Change(m_map);
+        ScheduleChange(zoneId);
     }
 }
 
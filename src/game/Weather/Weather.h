@@ -25,10 +25,13 @@
 
 #include "Common.h"
 #include "Globals/SharedDefines.h"
-#include "Util/Timer.h"
+
+#include <map>
+#include <memory>
 
 class Player;
 class Map;
+class WorldPacket;
 
 // ---------------------------------------------------------
 //            Actual Weather in one zone
@@ -63,8 +66,8 @@ class Weather
         void SendWeatherUpdateToPlayer(Player* player);
         /// Set the weather
         void SetWeather(WeatherType type, float grade, Map const* _map, bool isPermanent);
-        /// Update the weather in this zone, when the timer is expired the weather will be rolled again
-        bool Update(uint32 diff, Map const* _map);
+        /// Roll the weather again and send it to the zone if it changed
+        void Change(Map const* _map);
         /// Check if a type is valid
         static bool IsValidWeatherType(uint32 type)
         {
@@ -84,7 +87,9 @@ class Weather
 
     private:
         /// Send SMSG_WEATHER to all players in the zone
-        bool SendWeatherForPlayersInZone(Map const* _map);
+        void SendWeatherForPlayersInZone(Map const* _map);
+        /// SMSG_WEATHER for the current state, built once per change
+        std::shared_ptr<WorldPacket const> const& GetWeatherPacket();
         /// Calculate new weather
         bool ReGenerate();
         /// Calculate state based on type and grade
@@ -97,9 +102,9 @@ class Weather
         uint32 m_zone;
         WeatherType m_type;
         float m_grade;
-        ShortIntervalTimer m_timer;
         WeatherZoneChances const* m_weatherChances;
         bool m_isPermanentWeather;
+        std::shared_ptr<WorldPacket const> m_packet;
 };
 
 // ---------------------------------------------------------
@@ -114,13 +119,25 @@ class WeatherSystem
         ~WeatherSystem();
 
         Weather* FindOrCreateWeather(uint32 zoneId);
+        /// Send the zone weather to a player entering it, zones without weather data only get fine weather
+        void SendWeatherUpdateToPlayer(Player* player, uint32 zoneId);
+        /// Roll the weathers whose change is due, weathers of zones without players are removed
         void UpdateWeathers(uint32 diff);
 
+        bool HasWeathers() const { return !m_weathers.empty(); }
+
     private:
+        void ScheduleChange(uint32 zoneId);
+
         Map const* const m_map;
 
         typedef std::unordered_map<uint32 /*zoneId*/, Weather*> WeatherMap;
         WeatherMap m_weathers;
+
+        // every weather has one pending change, ordered by due time
+        typedef std::multimap<uint64 /*dueTime*/, uint32 /*zoneId*/> WeatherSchedule;
+        WeatherSchedule m_schedule;
+        uint64 m_time;                                      // accumulated update time
 };
 
 // ---------------------------------------------------------
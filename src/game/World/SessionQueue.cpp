@@ -0,0 +1,115 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/SessionQueue.h"
+
+// compaction only pays off once the slots are no longer trivially few
+#define SESSION_QUEUE_COMPACT_SIZE 64
+
+static inline size_t LowBit(size_t node) { return node & (~node + 1); }
+
+uint32 SessionQueue::Sum(size_t slots) const
+{
+    uint32 sum = 0;
+    for (size_t node = slots; node; node -= LowBit(node))
+        sum += m_tree[node - 1];
+    return sum;
+}
+
+void SessionQueue::Push(WorldSession* session)
+{
+    if (m_index.find(session) != m_index.end())
+        return;
+
+    // the new node covers the slots (node - lowbit, node], all but the new one are already counted
+    size_t const node = m_slots.size() + 1;
+    m_tree.push_back(Sum(node - 1) - Sum(node - LowBit(node)) + 1);
+    m_slots.push_back(session);
+
+    m_index[session] = node - 1;
+    ++m_count;
+}
+
+bool SessionQueue::Remove(WorldSession* session)
+{
+    auto itr = m_index.find(session);
+    if (itr == m_index.end())
+        return false;
+
+    size_t const slot = itr->second;
+    m_index.erase(itr);
+    m_slots[slot] = nullptr;
+    for (size_t node = slot + 1; node <= m_tree.size(); node += LowBit(node))
+        --m_tree[node - 1];
+    --m_count;
+
+    while (m_first < m_slots.size() && !m_slots[m_first])
+        ++m_first;
+
+    if (m_slots.size() >= SESSION_QUEUE_COMPACT_SIZE && m_count * 2 < m_slots.size())
+        Compact();
+    return true;
+}
+
+WorldSession* SessionQueue::PopFront()
+{
+    if (empty())
+        return nullptr;
+
+    WorldSession* session = m_slots[m_first];
+    Remove(session);
+    return session;
+}
+
+void SessionQueue::Clear()
+{
+    m_slots.clear();
+    m_tree.clear();
+    m_index.clear();
+    m_first = 0;
+    m_count = 0;
+}
+
+uint32 SessionQueue::GetPosition(WorldSession const* session) const
+{
+    auto itr = m_index.find(session);
+    if (itr == m_index.end())
+        return 0;
+
+    return Sum(itr->second + 1);
+}
+
+void SessionQueue::Compact()
+{
+    std::vector<WorldSession*> slots;
+    slots.reserve(m_count);
+    for (size_t i = m_first; i < m_slots.size(); ++i)
+        if (m_slots[i])
+            slots.push_back(m_slots[i]);
+
+    m_slots.swap(slots);
+    m_first = 0;
+
+    // every slot is taken again, a node counts the whole range it covers
+    m_tree.resize(m_slots.size());
+    for (size_t node = 1; node <= m_slots.size(); ++node)
+    {
+        m_tree[node - 1] = uint32(LowBit(node));
+        m_index[m_slots[node - 1]] = node - 1;
+    }
+}
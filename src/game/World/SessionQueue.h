@@ -0,0 +1,69 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SESSIONQUEUE_H
+#define MANGOS_SESSIONQUEUE_H
+
+#include "Common.h"
+
+#include <unordered_map>
+#include <vector>
+
+class WorldSession;
+
+// Sessions waiting in the login queue in arrival order. Every session takes the next slot
+// and a Fenwick tree over the slots counts the ones still waiting, so the position of a
+// session and a removal from the middle are O(log n) instead of a walk over a list. Slots
+// left by removed sessions are compacted once they make up half of the queue.
+class SessionQueue
+{
+    public:
+        SessionQueue() : m_first(0), m_count(0) {}
+
+        void Push(WorldSession* session);
+        bool Remove(WorldSession* session);
+        WorldSession* PopFront();                           // nullptr when empty
+        void Clear();
+
+        // 1 for the first waiting session, 0 when not queued
+        uint32 GetPosition(WorldSession const* session) const;
+
+        uint32 size() const { return m_count; }
+        bool empty() const { return m_count == 0; }
+
+        // waiting sessions in queue order
+        template<typename Visitor>
+        void Visit(Visitor&& visitor) const
+        {
+            for (size_t i = m_first; i < m_slots.size(); ++i)
+                if (m_slots[i])
+                    visitor(m_slots[i]);
+        }
+
+    private:
+        uint32 Sum(size_t slots) const;                     // waiting sessions in the first slots
+        void Compact();
+
+        std::vector<WorldSession*> m_slots;                 // nullptr for removed sessions
+        std::vector<uint32> m_tree;                         // Fenwick tree over m_slots, node i at index i - 1
+        std::unordered_map<WorldSession const*, size_t> m_index;
+        size_t m_first;                                     // no session waits before this slot
+        uint32 m_count;
+};
+
+#endif
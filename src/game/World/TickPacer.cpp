@@ -0,0 +1,123 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/TickPacer.h"
+#include "World/World.h"
+#include "Util/Timer.h"
+#include "Policies/Singleton.h"
+#include "Log.h"
+
+#ifdef BUILD_METRICS
+#include "Metric/Aggregate.h"
+#endif
+
+#include <algorithm>
+
+INSTANTIATE_SINGLETON_1(TickPacer);
+
+TickPacer::TickPacer() : m_next(0), m_count(0), m_sinceRefresh(0), m_p50(0), m_p90(0), m_p95(0), m_p99(0), m_period(0), m_degraded(false)
+{
+    memset(m_ticks, 0, sizeof(m_ticks));
+}
+
+void TickPacer::AddTick(uint32 tickTime)
+{
+    m_ticks[m_next] = tickTime;
+    m_next = (m_next + 1) % TICK_PACER_WINDOW;
+    if (m_count < TICK_PACER_WINDOW)
+        ++m_count;
+
+    if (++m_sinceRefresh >= TICK_PACER_REFRESH)
+        Refresh();
+}
+
+void TickPacer::Refresh()
+{
+    m_sinceRefresh = 0;
+
+    uint32 sorted[TICK_PACER_WINDOW];
+    std::copy(m_ticks, m_ticks + m_count, sorted);
+    std::sort(sorted, sorted + m_count);
+
+    m_p50 = sorted[m_count * 50 / 100];
+    m_p90 = sorted[m_count * 90 / 100];
+    m_p95 = sorted[m_count * 95 / 100];
+    m_p99 = sorted[m_count * 99 / 100];
+
+    // leaves at three quarters of the threshold, a load right at it does not flip every refresh
+    uint32 const threshold = sWorld.getConfig(CONFIG_UINT32_TICK_PACER_DEGRADE_THRESHOLD);
+    bool const degraded = IsDegraded();
+    if (!degraded && threshold && m_p95 >= threshold)
+    {
+        m_degraded.store(true, std::memory_order_relaxed);
+        sLog.outString("TickPacer: world tick p95 %u ms reached %u ms, deferring non-critical updates", m_p95, threshold);
+    }
+    else if (degraded && (!threshold || m_p95 < threshold * 3 / 4))
+    {
+        m_degraded.store(false, std::memory_order_relaxed);
+        sLog.outString("TickPacer: world tick p95 back at %u ms, non-critical updates resumed", m_p95);
+    }
+
+#ifdef BUILD_METRICS
+    static metric::gauge& p50Gauge = metric::aggregates::instance().register_gauge("world.tick.pacer", { { "percentile", "50" } });
+    static metric::gauge& p95Gauge = metric::aggregates::instance().register_gauge("world.tick.pacer", { { "percentile", "95" } });
+    static metric::gauge& p99Gauge = metric::aggregates::instance().register_gauge("world.tick.pacer", { { "percentile", "99" } });
+    static metric::gauge& degradedGauge = metric::aggregates::instance().register_gauge("world.tick.degraded");
+    p50Gauge.set(m_p50);
+    p95Gauge.set(m_p95);
+    p99Gauge.set(m_p99);
+    degradedGauge.set(IsDegraded() ? 1 : 0);
+#endif
+}
+
+uint32 TickPacer::GetPeriod(uint32 minPeriod)
+{
+    uint32 const maxPeriod = sWorld.getConfig(CONFIG_UINT32_TICK_PACER_MAX_INTERVAL);
+    m_period = maxPeriod > minPeriod ? std::min(std::max(m_p90, minPeriod), maxPeriod) : minPeriod;
+    return m_period;
+}
+
+uint32 TickPacer::GetPercentile(uint8 percentile) const
+{
+    switch (percentile)
+    {
+        case 50: return m_p50;
+        case 90: return m_p90;
+        case 95: return m_p95;
+        default: return m_p99;
+    }
+}
+
+bool TickPacer::IsDue(IntervalTimer const& timer) const
+{
+    return IsDue(uint32(timer.GetCurrent()), uint32(timer.GetInterval()));
+}
+
+bool TickPacer::IsDue(uint32 elapsed, uint32 interval) const
+{
+    return elapsed >= (IsDegraded() ? interval * TICK_PACER_DEFER_FACTOR : interval);
+}
+
+void TickPacer::Reset(IntervalTimer& timer) const
+{
+    time_t const deferred = timer.GetInterval() * TICK_PACER_DEFER_FACTOR;
+    if (IsDegraded() && timer.GetCurrent() >= deferred)
+        timer.SetCurrent(timer.GetCurrent() - deferred);
+    else
+        timer.Reset();
+}
@@ -0,0 +1,85 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TICKPACER_H
+#define MANGOS_TICKPACER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+
+class IntervalTimer;
+
+// world ticks the percentiles are taken over, a bit more than 10 seconds at the shortest period
+#define TICK_PACER_WINDOW           256
+// ticks between two percentile updates
+#define TICK_PACER_REFRESH          20
+// deferrable work still runs once it is this many intervals late
+#define TICK_PACER_DEFER_FACTOR     4
+
+// Paces the world loop on the recent tick times. With TickPacer.MaxInterval the loop
+// sleeps to the p90 of the last ticks instead of a fixed period, so one long tick does
+// not alternate with short ones and the diffs the maps see stay even. While the p95
+// is above TickPacer.DegradeThreshold deferrable work (auction house, AH bot, raid
+// browser, offline group leaders, weather) runs up to TICK_PACER_DEFER_FACTOR times
+// less often, the state leaves again with hysteresis.
+class TickPacer
+{
+    public:
+        TickPacer();
+
+        // world thread, after every World::Update with its duration in milliseconds
+        void AddTick(uint32 tickTime);
+
+        // time from the start of one tick to the next, never below minPeriod
+        uint32 GetPeriod(uint32 minPeriod);
+        uint32 GetLastPeriod() const { return m_period; }
+
+        uint32 GetPercentile(uint8 percentile) const;      // 50, 90, 95 or 99
+        uint32 GetTickCount() const { return m_count; }
+
+        // any thread
+        bool IsDegraded() const { return m_degraded.load(std::memory_order_relaxed); }
+
+        // whether deferrable work guarded by the timer is to run now
+        bool IsDue(IntervalTimer const& timer) const;
+        bool IsDue(uint32 elapsed, uint32 interval) const;
+        // restarts a due timer, keeping the overrun like IntervalTimer::Reset
+        void Reset(IntervalTimer& timer) const;
+
+    private:
+        void Refresh();
+
+        uint32 m_ticks[TICK_PACER_WINDOW];
+        uint32 m_next;
+        uint32 m_count;                                     // recorded ticks, at most TICK_PACER_WINDOW
+        uint32 m_sinceRefresh;
+
+        uint32 m_p50;
+        uint32 m_p90;
+        uint32 m_p95;
+        uint32 m_p99;
+        uint32 m_period;
+
+        std::atomic<bool> m_degraded;
+};
+
+#define sTickPacer MaNGOS::Singleton<TickPacer>::Instance()
+
+#endif
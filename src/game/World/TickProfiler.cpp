@@ -0,0 +1,174 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/TickProfiler.h"
+#include "Policies/Singleton.h"
+#include "Log.h"
+
+#include <chrono>
+#include <cstdio>
+
+INSTANTIATE_SINGLETON_1(TickProfiler);
+
+std::atomic<bool> TickProfiler::s_recording(false);
+thread_local TickProfiler::ThreadBuffer* TickProfiler::t_buffer = nullptr;
+
+TickProfiler::TickProfiler() : m_pendingTicks(0), m_ticksLeft(0), m_tick(0), m_tickStart(0), m_worldThread(0)
+{
+}
+
+TickProfiler::~TickProfiler()
+{
+    if (m_writer.joinable())
+        m_writer.join();
+}
+
+uint64 TickProfiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool TickProfiler::Start(uint32 ticks, std::string const& fileName)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (!ticks || m_pendingTicks || m_ticksLeft)
+        return false;
+
+    // zones that were still open when the previous recording ended
+    for (ThreadBuffer& buffer : m_threads)
+    {
+        std::lock_guard<std::mutex> bufferGuard(buffer.lock);
+        buffer.events.clear();
+    }
+
+    m_fileName = fileName;
+    m_pendingTicks = ticks;
+    return true;
+}
+
+TickProfiler::ThreadBuffer& TickProfiler::GetThreadBuffer()
+{
+    if (!t_buffer)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_threads.emplace_back();
+        m_threads.back().id = uint32(m_threads.size());
+        t_buffer = &m_threads.back();
+    }
+    return *t_buffer;
+}
+
+void TickProfiler::BeginTick()
+{
+    if (!IsRecording())
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (!m_pendingTicks)
+            return;
+
+        m_ticksLeft = m_pendingTicks;
+        m_pendingTicks = 0;
+        m_tick = 0;
+        s_recording.store(true, std::memory_order_relaxed);
+    }
+
+    m_worldThread = GetThreadBuffer().id;
+    m_tickStart = Now();
+}
+
+void TickProfiler::EndTick()
+{
+    if (!IsRecording())
+        return;
+
+    Record("World tick", m_tickStart, Now(), m_tick++);
+    if (--m_ticksLeft == 0)
+        Finish();
+}
+
+void TickProfiler::Record(char const* name, uint64 start, uint64 end, uint32 arg)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> guard(buffer.lock);
+    buffer.events.push_back({ name, start, end - start, arg });
+}
+
+void TickProfiler::Finish()
+{
+    s_recording.store(false, std::memory_order_relaxed);
+
+    std::vector<std::pair<uint32, std::vector<Event>>> threads;
+    std::string fileName;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        for (ThreadBuffer& buffer : m_threads)
+        {
+            std::lock_guard<std::mutex> bufferGuard(buffer.lock);
+            if (!buffer.events.empty())
+                threads.emplace_back(buffer.id, std::move(buffer.events));
+            buffer.events.clear();
+        }
+        fileName = m_fileName;
+    }
+
+    // can be several megabytes, keep it off the world thread
+    if (m_writer.joinable())
+        m_writer.join();
+
+    uint32 const worldThread = m_worldThread;
+    m_writer = std::thread([fileName, worldThread, threads]()
+    {
+        Write(fileName, worldThread, threads);
+    });
+}
+
+void TickProfiler::Write(std::string const& fileName, uint32 worldThread, std::vector<std::pair<uint32, std::vector<Event>>> const& threads)
+{
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+    {
+        sLog.outError("TickProfiler: cannot open %s for writing", fileName.c_str());
+        return;
+    }
+
+    uint64 origin = UINT64_MAX;
+    size_t count = 0;
+    for (auto const& thread : threads)
+    {
+        for (Event const& event : thread.second)
+            origin = std::min(origin, event.start);
+        count += thread.second.size();
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (auto const& thread : threads)
+    {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}",
+                first ? "" : ",\n", thread.first, thread.first == worldThread ? "world" : "worker", thread.first);
+        first = false;
+
+        for (Event const& event : thread.second)
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":" UI64FMTD ",\"dur\":" UI64FMTD ",\"args\":{\"arg\":%u}}",
+                    event.name, thread.first, event.start - origin, event.duration, event.arg);
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    sLog.outString("TickProfiler: wrote " SIZEFMTD " zones to %s", count, fileName.c_str());
+}
@@ -0,0 +1,117 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TICKPROFILER_H
+#define MANGOS_TICKPROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Scoped zones of a number of world ticks, recorded on demand (.debug tickprofile)
+// and written in the Chrome trace event format for chrome://tracing or ui.perfetto.dev.
+// A zone costs one relaxed atomic load while nothing is recorded.
+class TickProfiler
+{
+    public:
+        TickProfiler();
+        ~TickProfiler();
+
+        // records the next ticks into fileName, false while another recording is underway
+        bool Start(uint32 ticks, std::string const& fileName);
+        static bool IsRecording() { return s_recording.load(std::memory_order_relaxed); }
+
+        // world thread, around every World::Update
+        void BeginTick();
+        void EndTick();
+
+        // any thread, times from Now()
+        void Record(char const* name, uint64 start, uint64 end, uint32 arg);
+
+        // microseconds on a monotonic clock
+        static uint64 Now();
+
+    private:
+        struct Event
+        {
+            char const* name;                               // string literal of the zone
+            uint64 start;
+            uint64 duration;
+            uint32 arg;
+        };
+
+        // written by its thread only, the lock just hands the events over at the end
+        struct ThreadBuffer
+        {
+            uint32 id;
+            std::mutex lock;
+            std::vector<Event> events;
+        };
+
+        ThreadBuffer& GetThreadBuffer();
+        void Finish();
+        static void Write(std::string const& fileName, uint32 worldThread, std::vector<std::pair<uint32, std::vector<Event>>> const& threads);
+
+        static std::atomic<bool> s_recording;
+        static thread_local ThreadBuffer* t_buffer;
+
+        std::mutex m_lock;                                  // everything below
+        std::deque<ThreadBuffer> m_threads;
+        std::string m_fileName;
+        uint32 m_pendingTicks;                              // requested, recording starts with the next tick
+        uint32 m_ticksLeft;
+        uint32 m_tick;
+        uint64 m_tickStart;
+        uint32 m_worldThread;
+
+        std::thread m_writer;                               // world thread only
+};
+
+#define sTickProfiler MaNGOS::Singleton<TickProfiler>::Instance()
+
+class TickProfileZone
+{
+    public:
+        explicit TickProfileZone(char const* name, uint32 arg = 0)
+            : m_name(TickProfiler::IsRecording() ? name : nullptr), m_arg(arg), m_start(m_name ? TickProfiler::Now() : 0) {}
+        ~TickProfileZone()
+        {
+            if (m_name)
+                sTickProfiler.Record(m_name, m_start, TickProfiler::Now(), m_arg);
+        }
+        TickProfileZone(TickProfileZone const&) = delete;
+        TickProfileZone& operator=(TickProfileZone const&) = delete;
+
+    private:
+        char const* const m_name;
+        uint32 const m_arg;
+        uint64 const m_start;
+};
+
+#define TICK_PROFILE_CONCAT_(a, b) a##b
+#define TICK_PROFILE_CONCAT(a, b) TICK_PROFILE_CONCAT_(a, b)
+// name has to be a string literal, the optional second argument is shown as "arg" in the trace
+#define TICK_PROFILE_ZONE(...) TickProfileZone TICK_PROFILE_CONCAT(tickProfileZone, __LINE__)(__VA_ARGS__)
+
+#endif
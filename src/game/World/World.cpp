@@ -25,10 +25,14 @@
 #include "Config/Config.h"
 #include "Platform/Define.h"
 #include "SystemConfig.h"
+#include "Util/BlockPool.h"
 #include "Log.h"
 #include "Server/Opcodes.h"
 #include "Server/WorldSession.h"
 #include "Server/WorldPacket.h"
+#include "Server/OpcodeProfiler.h"
+#include "World/TickProfiler.h"
+#include "World/TickPacer.h"
 #include "Entities/Player.h"
 #include "Skills/SkillExtraItems.h"
 #include "Skills/SkillDiscovery.h"
@@ -45,6 +49,7 @@
 #include "Loot/LootMgr.h"
 #include "Entities/ItemEnchantmentMgr.h"
 #include "Maps/MapManager.h"
+#include "Maps/MapWorkers.h"
 #include "DBScripts/ScriptMgr.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 #include "AI/CreatureAIRegistry.h"
@@ -72,6 +77,9 @@
 #include "Anticheat/Anticheat.hpp"
 #include "LFG/LFGMgr.h"
 #include "Vmap/GameObjectModel.h"
+#include "Multithreading/TaskGraph.h"
+#include "Maps/GridPreloader.h"
+#include "Util/ProgressBar.h"
 
 #ifdef BUILD_AHBOT
  #include "AuctionHouseBot/AuctionHouseBot.h"
@@ -102,7 +110,8 @@ TimePoint World::m_currentTime = TimePoint();
 uint32 World::m_currentDiff = 0;
 
 /// World constructor
-World::World() : mail_timer(0), mail_timer_expires(0), m_NextDailyQuestReset(0), m_NextWeeklyQuestReset(0), m_NextMonthlyQuestReset(0), m_opcodeCounters(NUM_MSG_TYPES)
+World::World() : mail_timer(0), mail_timer_expires(0), m_NextDailyQuestReset(0), m_NextWeeklyQuestReset(0), m_NextMonthlyQuestReset(0), m_opcodeCounters(NUM_MSG_TYPES),
+    m_playerSaveBudget(0), m_playerSaveBudgetCap(0), m_cliReadOnlyCommands(0)
 {
     m_playerLimit = 0;
     m_allowMovement = true;
@@ -112,6 +121,7 @@ World::World() : mail_timer(0), mail_timer_expires(0), m_NextDailyQuestReset(0),
     m_startTime = m_gameTime;
     m_maxActiveSessionCount = 0;
     m_maxQueuedSessionCount = 0;
+    m_queuePositionsChanged = false;
 
     m_defaultDbcLocale = DEFAULT_LOCALE;
     m_availableDbcLocaleMask = 0;
@@ -134,10 +144,15 @@ World::~World()
 {
     // it is assumed that no other thread is accessing this data when the destructor is called.  therefore, no locks are necessary
 
+    if (m_sessionUpdater.activated())
+        m_sessionUpdater.deactivate();
+
     ///- Empty the kicked session set
     for (auto const session : m_sessions)
         delete session.second;
 
+    StopCliReadOnlyCommandThread();
+
     for (auto const cliCommand : m_cliCommandQueue)
         delete cliCommand;
 
@@ -155,7 +170,12 @@ void World::CleanupsBeforeStop()
 {
     KickAll(true);                                   // save and kick all players
     UpdateSessions(1);                               // real players unload required UpdateSessions call
+    sGuildMgr.SaveGuildLogs();                       // logs still waiting for the next batch
+    StopCliReadOnlyCommandThread();                  // read-only console commands still query the databases
+    StopLootTemplatesReload();                       // background loot reload still queries the world database
     sBattleGroundMgr.DeleteAllBattleGrounds();       // unload battleground templates before different singletons destroyed
+    sGridPreloader.Stop();                           // release preloaded grids before their terrain is unloaded
+    CharacterDatabaseCleaner::StopCleaning();        // background cleaning still uses the character database
     sMapMgr.UnloadAll();                             // unload all grids (including locked in memory)
 }
 
@@ -280,19 +300,13 @@ World::AddSession_(WorldSession* s)
 
 int32 World::GetQueuedSessionPos(WorldSession const* sess) const
 {
-    uint32 position = 1;
-
-    for (Queue::const_iterator iter = m_QueuedSessions.begin(); iter != m_QueuedSessions.end(); ++iter, ++position)
-        if ((*iter) == sess)
-            return position;
-
-    return 0;
+    return m_QueuedSessions.GetPosition(sess);
 }
 
 void World::AddQueuedSession(WorldSession* sess)
 {
     sess->SetInQueue(true);
-    m_QueuedSessions.push_back(sess);
+    m_QueuedSessions.Push(sess);
 
     // The 1st SMSG_AUTH_RESPONSE needs to contain other info too.
     WorldPacket packet(SMSG_AUTH_RESPONSE, 1 + 4 + 1 + 4 + 1 + 4 + 1);
@@ -311,57 +325,57 @@ bool World::RemoveQueuedSession(WorldSession* sess)
     // sessions count including queued to remove (if removed_session set)
     uint32 sessions = GetActiveSessionCount();
 
-    uint32 position = 1;
-    Queue::iterator iter = m_QueuedSessions.begin();
-
-    // search to remove and count skipped positions
-    bool found = false;
-
-    for (; iter != m_QueuedSessions.end(); ++iter, ++position)
-    {
-        if (*iter == sess)
-        {
-            sess->SetInQueue(false);
-            iter = m_QueuedSessions.erase(iter);
-            found = true;                                   // removing queued session
-            break;
-        }
-    }
-
-    // iter point to next socked after removed or end()
-    // position store position of removed socket and then new position next socket after removed
-
+    bool const found = m_QueuedSessions.Remove(sess);
+    if (found)
+        sess->SetInQueue(false);
     // if session not queued then we need decrease sessions count
-    if (!found && sessions)
+    else if (sessions)
         --sessions;
 
     // accept first in queue
     if ((!m_playerLimit || (int32)sessions < m_playerLimit) && !m_QueuedSessions.empty())
-    {
-        WorldSession* pop_sess = m_QueuedSessions.front();
-        pop_sess->SetInQueue(false);
-        pop_sess->SendAuthWaitQue(0);
+        AcceptQueuedSession(m_QueuedSessions.PopFront());
+    else if (!found)
+        return false;
 
-        WorldPacket pkt(SMSG_CLIENTCACHE_VERSION, 4);
-        pkt << uint32(getConfig(CONFIG_UINT32_CLIENTCACHE_VERSION));
-        pop_sess->SendPacket(pkt);
+    // the sessions behind moved up, they learn their positions with the next queue update
+    m_queuePositionsChanged = true;
+    return found;
+}
+
+void World::AcceptQueuedSession(WorldSession* sess)
+{
+    sess->SetInQueue(false);
+    sess->SendAuthWaitQue(0);
 
-        pop_sess->SendAccountDataTimes(GLOBAL_CACHE_MASK);
-        pop_sess->SendTutorialsData();
+    WorldPacket pkt(SMSG_CLIENTCACHE_VERSION, 4);
+    pkt << uint32(getConfig(CONFIG_UINT32_CLIENTCACHE_VERSION));
+    sess->SendPacket(pkt);
 
-        m_QueuedSessions.pop_front();
+    sess->SendAccountDataTimes(GLOBAL_CACHE_MASK);
+    sess->SendTutorialsData();
+}
 
-        // update iter to point first queued socket or end() if queue is empty now
-        iter = m_QueuedSessions.begin();
-        position = 1;
+/// Admits queued sessions while there is room, for a raised limit or a queue draining after a restart,
+/// and sends the waiting ones their positions once per interval instead of on every removal
+void World::UpdateQueuedSessions()
+{
+    while (!m_QueuedSessions.empty() && (!m_playerLimit || int32(GetActiveSessionCount()) < m_playerLimit))
+    {
+        AcceptQueuedSession(m_QueuedSessions.PopFront());
+        m_queuePositionsChanged = true;
     }
 
-    // update position from iter to end()
-    // iter point to first not updated socket, position store new position
-    for (; iter != m_QueuedSessions.end(); ++iter, ++position)
-        (*iter)->SendAuthWaitQue(position);
+    if (!m_queuePositionsChanged)
+        return;
 
-    return found;
+    m_queuePositionsChanged = false;
+
+    uint32 position = 1;
+    m_QueuedSessions.Visit([&position](WorldSession* sess)
+    {
+        sess->SendAuthWaitQue(position++);
+    });
 }
 
 /// Initialize config values
@@ -454,6 +468,8 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_FLOAT_RATE_AUCTION_DEPOSIT, "Rate.Auction.Deposit", 1.0f);
     setConfig(CONFIG_FLOAT_RATE_AUCTION_CUT,     "Rate.Auction.Cut", 1.0f);
     setConfig(CONFIG_UINT32_AUCTION_DEPOSIT_MIN, "Auction.Deposit.Min", SILVER);
+    setConfig(CONFIG_UINT32_AUCTION_QUERY_THREADS, "Auction.QueryThreads", 1);
+    setConfig(CONFIG_UINT32_AUCTION_SNAPSHOT_INTERVAL, "Auction.SnapshotInterval", 2000);
     setConfig(CONFIG_FLOAT_RATE_HONOR, "Rate.Honor", 1.0f);
     setConfigPos(CONFIG_FLOAT_RATE_MINING_AMOUNT, "Rate.Mining.Amount", 1.0f);
     setConfigPos(CONFIG_FLOAT_RATE_MINING_NEXT,   "Rate.Mining.Next", 1.0f);
@@ -481,11 +497,37 @@ void World::LoadConfigSettings(bool reload)
 
     ///- Read other configuration items from the config file
     setConfigMinMax(CONFIG_UINT32_COMPRESSION, "Compression", 1, 1, 9);
+    setConfig(CONFIG_UINT32_COMPRESSION_MIN_SIZE, "Compression.MinSize", 100);
+    setConfig(CONFIG_BOOL_COMPRESSION_ADAPTIVE, "Compression.Adaptive", false);
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
+    setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB_BACKGROUND, "CleanCharacterDB.Background", false);
+    setConfig(CONFIG_UINT32_CLEAN_CHARACTER_DB_BATCH, "CleanCharacterDB.BatchSize", 0);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
     setConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS, "MaxWhoListReturns", 49);
 
+    m_activeLocaleMask = 0;
+    std::string activeLocales = sConfig.GetStringDefault("Locales.Active");
+    std::istringstream activeLocalesStream(activeLocales);
+    for (std::string localeName; activeLocalesStream >> localeName;)
+    {
+        bool found = false;
+        for (LocaleNameStr const* itr = &fullLocaleNameList[0]; itr->name; ++itr)
+        {
+            if (localeName == itr->name)
+            {
+                m_activeLocaleMask |= 1 << itr->locale;
+                found = true;
+            }
+        }
+
+        if (!found)
+            sLog.outError("Locales.Active has unknown locale %s, ignored.", localeName.c_str());
+    }
+
+    if (!m_activeLocaleMask)                                // all locales
+        m_activeLocaleMask = (1 << MAX_LOCALE) - 1;
+
     std::string forceLoadGridOnMaps = sConfig.GetStringDefault("LoadAllGridsOnMaps");
     if (!forceLoadGridOnMaps.empty())
     {
@@ -501,15 +543,24 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_INTERVAL_SAVE, "PlayerSave.Interval", 15 * MINUTE * IN_MILLISECONDS);
     setConfigMinMax(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE, "PlayerSave.Stats.MinLevel", 0, 0, MAX_LEVEL);
     setConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT, "PlayerSave.Stats.SaveOnlyOnLogout", true);
+    setConfig(CONFIG_BOOL_PLAYER_SAVE_SMOOTHING, "PlayerSave.Smoothing", true);
+    setConfig(CONFIG_BOOL_DBC_MEMORY_MAPPED, "DBC.MemoryMapped", true);
+    setConfig(CONFIG_BOOL_MAPS_MEMORY_MAPPED, "Maps.MemoryMapped", true);
 
     setConfigMin(CONFIG_UINT32_INTERVAL_GRIDCLEAN, "GridCleanUpDelay", 5 * MINUTE * IN_MILLISECONDS, MIN_GRID_DELAY);
     if (reload)
         sMapMgr.SetGridCleanUpDelay(getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN));
+    setConfig(CONFIG_UINT32_GRID_MAX_LOADED, "GridCleanUp.MaxLoadedGrids", 0);
 
     setConfigMin(CONFIG_UINT32_INTERVAL_MAPUPDATE, "MapUpdateInterval", 100, MIN_MAP_UPDATE_DELAY);
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 
+    setConfig(CONFIG_UINT32_TICK_PACER_MAX_INTERVAL, "TickPacer.MaxInterval", 0);
+    setConfig(CONFIG_UINT32_TICK_PACER_MOVEMENT_STEP, "TickPacer.MovementStep", 0);
+    setConfig(CONFIG_UINT32_TICK_PACER_DEGRADE_THRESHOLD, "TickPacer.DegradeThreshold", 0);
+    setConfig(CONFIG_UINT32_QUEUE_UPDATE_INTERVAL, "PlayerLimit.QueueUpdateInterval", IN_MILLISECONDS);
+
     setConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 10 * MINUTE * IN_MILLISECONDS);
 
     if (configNoReload(reload, CONFIG_UINT32_PORT_WORLD, "WorldServerPort", DEFAULT_WORLDSERVER_PORT))
@@ -622,6 +673,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_MAIL_DELIVERY_DELAY, "MailDeliveryDelay", HOUR);
 
     setConfigMin(CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK, "MassMailer.SendPerTick", 10, 1);
+    setConfigMin(CONFIG_UINT32_MASS_MAILER_PAGE_SIZE, "MassMailer.PageSize", 1000, 10);
 
     setConfig(CONFIG_UINT32_UPTIME_UPDATE, "UpdateUptimeInterval", 10);
     if (reload)
@@ -631,6 +683,13 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_UINT32_NUM_MAP_THREADS, "MapUpdate.Threads", 3);
+    setConfig(CONFIG_UINT32_NUM_MAP_CELL_THREADS, "MapUpdate.CellThreads", 0);
+    setConfig(CONFIG_UINT32_MAP_COST_SAMPLE_INTERVAL, "MapUpdate.CostSampleInterval", 0);
+    setConfig(CONFIG_UINT32_NUM_SESSION_THREADS, "SessionUpdate.Threads", 0);
+    setConfig(CONFIG_UINT32_NUM_LOAD_THREADS, "Startup.LoadThreads", 4);
+    setConfig(CONFIG_UINT32_GRID_PRELOAD_THREADS, "GridPreload.Threads", 1);
+    setConfig(CONFIG_UINT32_GRID_PRELOAD_LOOKAHEAD, "GridPreload.LookAhead", 15 * IN_MILLISECONDS);
+    setConfig(CONFIG_UINT32_INSTANCE_PREWARM_MAPS, "InstancePrewarm.Maps", 4);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_ORANGE, "SkillChance.Orange", 100);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_YELLOW, "SkillChance.Yellow", 75);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_GREEN,  "SkillChance.Green",  25);
@@ -671,6 +730,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_CHATFLOOD_MUTE_TIME,     "ChatFlood.MuteTime", 10);
 
     setConfig(CONFIG_BOOL_EVENT_ANNOUNCE, "Event.Announce", false);
+    setConfig(CONFIG_UINT32_GAME_EVENT_SPAWNS_PER_UPDATE, "Event.SpawnsPerUpdate", 250);
 
     setConfig(CONFIG_UINT32_CREATURE_FAMILY_ASSISTANCE_DELAY, "CreatureFamilyAssistanceDelay", 1500);
     setConfig(CONFIG_UINT32_CREATURE_FAMILY_FLEE_DELAY,       "CreatureFamilyFleeDelay",       10000);
@@ -701,6 +761,7 @@ void World::LoadConfigSettings(bool reload)
 
     setConfig(CONFIG_BOOL_CORPSE_EMPTY_LOOT_SHOW,                     "Corpse.EmptyLootShow",                  true);
     setConfig(CONFIG_BOOL_CORPSE_ALLOW_ALL_ITEMS_SHOW_IN_MASTER_LOOT, "Corpse.AllowAllItemsShowInMasterLoot", false);
+    setConfig(CONFIG_BOOL_CORPSE_DEFERRED_LOOT,                       "Corpse.DeferredLoot",                   false);
     setConfig(CONFIG_UINT32_CORPSE_DECAY_NORMAL,                      "Corpse.Decay.NORMAL",                    300);
     setConfig(CONFIG_UINT32_CORPSE_DECAY_RARE,                        "Corpse.Decay.RARE",                      900);
     setConfig(CONFIG_UINT32_CORPSE_DECAY_ELITE,                       "Corpse.Decay.ELITE",                     600);
@@ -719,6 +780,8 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_FLOAT_LEASH_RADIUS, "LeashRadius", 30.f);
     setConfigMin(CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY, "CreatureRespawnAggroDelay", 5000, 0);
     setConfig(CONFIG_UINT32_CREATURE_PICKPOCKET_RESTOCK_DELAY, "CreaturePickpocketRestockDelay", 600);
+    setConfig(CONFIG_UINT32_CREATURE_DORMANT_INTERVAL, "CreatureDormantInterval", 1000);
+    setConfigMinMax(CONFIG_FLOAT_CREATURE_DORMANT_RADIUS, "CreatureDormantRadius", 60.0f, 0.0f, MAX_VISIBILITY_DISTANCE);
 
     // always use declined names in the russian client
     if (getConfig(CONFIG_UINT32_REALM_ZONE) == REALM_ZONE_RUSSIAN)
@@ -734,6 +797,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_BATTLEGROUND_PREMATURE_FINISH_TIMER,       "BattleGround.PrematureFinishTimer", 5 * MINUTE * IN_MILLISECONDS);
     setConfig(CONFIG_UINT32_BATTLEGROUND_PREMADE_GROUP_WAIT_FOR_MATCH, "BattleGround.PremadeGroupWaitForMatch", 30 * MINUTE * IN_MILLISECONDS);
     setConfigMinMax(CONFIG_UINT32_BATTLEGROUND_RANDOM_RESET_HOUR,      "BattleGround.Random.ResetHour", 6, 0, 23);
+    setConfigMinMax(CONFIG_UINT32_BATTLEGROUND_PRECREATED_INSTANCES,   "BattleGround.PrecreatedInstances", 1, 0, 5);
     setConfig(CONFIG_UINT32_ARENA_MAX_RATING_DIFFERENCE,               "Arena.MaxRatingDifference", 150);
     setConfig(CONFIG_UINT32_ARENA_RATING_DISCARD_TIMER,                "Arena.RatingDiscardTimer", 10 * MINUTE * IN_MILLISECONDS);
     setConfig(CONFIG_BOOL_ARENA_AUTO_DISTRIBUTE_POINTS,                "Arena.AutoDistributePoints", false);
@@ -760,6 +824,11 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_OFFHAND_CHECK_AT_TALENTS_RESET, "OffhandCheckAtTalentsReset", false);
 
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET, "Network.KickOnBadPacket", false);
+    setConfig(CONFIG_BOOL_OPCODE_PROFILING, "Network.OpcodeProfiling", false);
+    setConfigMin(CONFIG_UINT32_NETWORK_RECV_QUEUE_SIZE, "Network.RecvQueueSize", 1024, 64);
+    setConfig(CONFIG_BOOL_NETWORK_MAP_THREAD_PACKETS, "Network.MapThreadPackets", false);
+    setConfig(CONFIG_BOOL_NETWORK_BATCH_MOVEMENT_RELAY, "Network.BatchMovementRelay", true);
+    setConfigMinMax(CONFIG_UINT32_VALIDATE_MAP_THREAD_ACCESS, "Network.ValidateMapThreadAccess", 0, 0, 2);
 
     setConfig(CONFIG_BOOL_PLAYER_COMMANDS, "PlayerCommands", true);
 
@@ -778,9 +847,12 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_INSTANT_LOGOUT, "InstantLogout", SEC_MODERATOR);
 
     setConfigMin(CONFIG_UINT32_GROUP_OFFLINE_LEADER_DELAY, "Group.OfflineLeaderDelay", 300, 0);
+    setConfig(CONFIG_UINT32_GROUP_MEMBER_STATS_INTERVAL, "Group.MemberStatsInterval", 0);
 
     setConfigMin(CONFIG_UINT32_GUILD_EVENT_LOG_COUNT, "Guild.EventLogRecordsCount", GUILD_EVENTLOG_MAX_RECORDS, GUILD_EVENTLOG_MAX_RECORDS);
     setConfigMin(CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT, "Guild.BankEventLogRecordsCount", GUILD_BANK_MAX_LOGS, GUILD_BANK_MAX_LOGS);
+    setConfig(CONFIG_UINT32_GUILD_ROSTER_CACHE_TIME, "Guild.RosterCacheTime", 5);
+    setConfig(CONFIG_UINT32_GUILD_LOG_FLUSH_INTERVAL, "Guild.LogFlushInterval", 10);
 
     setConfig(CONFIG_UINT32_MIRRORTIMER_FATIGUE_MAX,       "MirrorTimer.Fatigue.Max", 60);
     setConfig(CONFIG_UINT32_MIRRORTIMER_BREATH_MAX,        "MirrorTimer.Breath.Max", 180);
@@ -837,6 +909,18 @@ void World::LoadConfigSettings(bool reload)
         m_MaxVisibleDistanceInBGArenas = MAX_VISIBILITY_DISTANCE;
     }
 
+    setConfigMin(CONFIG_FLOAT_FULL_RATE_DISTANCE_CONTINENTS, "Visibility.FullRateDistance.Continents", 50.0f, 0.0f);
+    setConfigMin(CONFIG_FLOAT_FULL_RATE_DISTANCE_INSTANCES, "Visibility.FullRateDistance.Instances", 0.0f, 0.0f);
+    setConfigMin(CONFIG_FLOAT_FULL_RATE_DISTANCE_BGARENAS, "Visibility.FullRateDistance.BGArenas", 0.0f, 0.0f);
+    setConfigMin(CONFIG_UINT32_THROTTLED_HEARTBEAT_RATE, "Visibility.ThrottledHeartbeatRate", 3, 1);
+    setConfig(CONFIG_BOOL_VISIBILITY_COALESCE_RELOCATIONS, "Visibility.CoalesceRelocations", false);
+
+    setConfig(CONFIG_UINT32_CLI_COMMAND_TICK_BUDGET, "Console.CommandTickBudget", 0);
+    setConfig(CONFIG_BOOL_CLI_READ_ONLY_COMMAND_THREAD, "Console.ReadOnlyCommandThread", true);
+    setConfig(CONFIG_UINT32_VISIBILITY_COALESCE_INTERVAL, "Visibility.CoalesceRelocations.Interval", 0);
+    setConfig(CONFIG_UINT32_VISIBILITY_SHEDDING_THRESHOLD, "Visibility.LoadShedding.Threshold", 0);
+    setConfigMin(CONFIG_FLOAT_VISIBILITY_SHEDDING_MIN_DISTANCE, "Visibility.LoadShedding.MinDistance", 45.0f * getConfig(CONFIG_FLOAT_RATE_CREATURE_AGGRO), 0.0f);
+
     ///- Load the CharDelete related config options
     setConfigMinMax(CONFIG_UINT32_CHARDELETE_METHOD, "CharDelete.Method", 0, 0, 1);
     setConfigMinMax(CONFIG_UINT32_CHARDELETE_MIN_LEVEL, "CharDelete.MinLevel", 0, 0, getConfig(CONFIG_UINT32_MAX_PLAYER_LEVEL));
@@ -871,6 +955,7 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
+    setConfig(CONFIG_BOOL_VMAP_LOS_CACHE, "vmap.LoSCache", true);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
 
@@ -886,10 +971,14 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_MMAP_ENABLED, "mmap.enabled", true);
     std::string ignoreMapIds = sConfig.GetStringDefault("mmap.ignoreMapIds");
     MMAP::MMapFactory::preventPathfindingOnMaps(ignoreMapIds.c_str());
+    setConfig(CONFIG_UINT32_MMAP_MEMORY_BUDGET, "mmap.MemoryBudget", 0);
     sLog.outString("WORLD: MMap pathfinding %sabled", getConfig(CONFIG_BOOL_MMAP_ENABLED) ? "en" : "dis");
 
     setConfig(CONFIG_BOOL_PATH_FIND_OPTIMIZE, "PathFinder.OptimizePath", true);
     setConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z, "PathFinder.NormalizeZ", false);
+    setConfig(CONFIG_BOOL_PATH_FIND_ASYNC, "PathFinder.Async", true);
+    setConfig(CONFIG_UINT32_PATH_FIND_ASYNC_BATCH, "PathFinder.AsyncBatch", 0);
+    setConfig(CONFIG_UINT32_PATH_FIND_CACHE_SIZE, "PathFinder.CacheSize", 512);
 
     setConfig(CONFIG_UINT32_MAX_RECRUIT_A_FRIEND_BONUS_PLAYER_LEVEL, "Raf.BonusLevel", 60);
     setConfig(CONFIG_UINT32_MAX_RECRUIT_A_FRIEND_BONUS_PLAYER_LEVEL_DIFFERENCE, "Raf.LevelDifference", 4);
@@ -955,6 +1044,9 @@ void World::SetInitialWorldSettings()
     // load SQL dbcs first, other DBCs need them
     sObjectMgr.LoadSQLDBCs();
 
+    sLog.outString("Building spell indexes...");
+    sSpellMgr.LoadSpellIndexes();                           // must be after LoadSQLDBCs
+
     // Load before npc_text, gossip_menu_option, script_texts
     sLog.outString("Loading broadcast_text...");
     sObjectMgr.LoadBroadcastText();
@@ -964,8 +1056,10 @@ void World::SetInitialWorldSettings()
 
     ///- Load the DBC files
     sLog.outString("Initialize DBC data stores...");
+    DBCFileLoader::SetMemoryMapping(getConfig(CONFIG_BOOL_DBC_MEMORY_MAPPED));
     LoadDBCStores(m_dataPath);
     DetectDBCLang();
+    Unit::LoadFactionReactions();
     sObjectMgr.SetDbc2StorageLocaleIndex(GetDefaultDbcLocale());    // Get once for all the locale index of DBC language (console/broadcasts)
 
     // Loading cameras for characters creation cinematic
@@ -1338,28 +1432,35 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading BattleGround event indexes...");
     sBattleGroundMgr.LoadBattleEventIndexes();
 
-    sLog.outString("Loading GameTeleports...");
-    sObjectMgr.LoadGameTele();
-
-    sLog.outString("Loading Questgiver Greetings...");
-    sObjectMgr.LoadQuestgiverGreeting();
-
-    sLog.outString("Loading Trainer Greetings...");
-    sObjectMgr.LoadTrainerGreetings();
-
-    ///- Loading localization data
-    sLog.outString("Loading Localization strings...");
-    sObjectMgr.LoadCreatureLocales();                       // must be after CreatureInfo loading
-    sObjectMgr.LoadGameObjectLocales();                     // must be after GameobjectInfo loading
-    sObjectMgr.LoadItemLocales();                           // must be after ItemPrototypes loading
-    sObjectMgr.LoadQuestLocales();                          // must be after QuestTemplates loading
-    sObjectMgr.LoadGossipTextLocales();                     // must be after LoadGossipText
-    sObjectMgr.LoadPageTextLocales();                       // must be after PageText loading
-    sObjectMgr.LoadGossipMenuItemsLocales();                // must be after gossip menu items loading
-    sObjectMgr.LoadPointOfInterestLocales();                // must be after POI loading
-    sObjectMgr.LoadQuestgiverGreetingLocales();
-    sObjectMgr.LoadTrainerGreetingLocales();                // must be after CreatureInfo loading
-    sObjectMgr.LoadBroadcastTextLocales();
+    ///- Loading greetings, teleports and localization data
+    // each of these fills only its own container, so independent ones are loaded in parallel
+    sLog.outString("Loading GameTeleports, greetings and localization strings...");
+    {
+        TaskGraph loadGraph;
+        loadGraph.AddTask("GameTeleports", []() { sObjectMgr.LoadGameTele(); });
+        uint32 questgiverGreetings = loadGraph.AddTask("Questgiver Greetings", []() { sObjectMgr.LoadQuestgiverGreeting(); });
+        uint32 trainerGreetings = loadGraph.AddTask("Trainer Greetings", []() { sObjectMgr.LoadTrainerGreetings(); });
+        loadGraph.AddTask("Creature locales", []() { sObjectMgr.LoadCreatureLocales(); });                 // must be after CreatureInfo loading
+        loadGraph.AddTask("GameObject locales", []() { sObjectMgr.LoadGameObjectLocales(); });             // must be after GameobjectInfo loading
+        loadGraph.AddTask("Item locales", []() { sObjectMgr.LoadItemLocales(); });                         // must be after ItemPrototypes loading
+        loadGraph.AddTask("Quest locales", []() { sObjectMgr.LoadQuestLocales(); });                       // must be after QuestTemplates loading
+        loadGraph.AddTask("Gossip text locales", []() { sObjectMgr.LoadGossipTextLocales(); });            // must be after LoadGossipText
+        loadGraph.AddTask("Page text locales", []() { sObjectMgr.LoadPageTextLocales(); });                // must be after PageText loading
+        loadGraph.AddTask("Gossip menu item locales", []() { sObjectMgr.LoadGossipMenuItemsLocales(); });  // must be after gossip menu items loading
+        loadGraph.AddTask("Point of interest locales", []() { sObjectMgr.LoadPointOfInterestLocales(); }); // must be after POI loading
+        loadGraph.AddTask("Questgiver greeting locales", []() { sObjectMgr.LoadQuestgiverGreetingLocales(); }, { questgiverGreetings });
+        loadGraph.AddTask("Trainer greeting locales", []() { sObjectMgr.LoadTrainerGreetingLocales(); }, { trainerGreetings });
+        loadGraph.AddTask("Broadcast text locales", []() { sObjectMgr.LoadBroadcastTextLocales(); });
+
+        uint32 loadThreads = getConfig(CONFIG_UINT32_NUM_LOAD_THREADS);
+        // progress bars of parallel loaders would overwrite each other
+        bool showBars = BarGoLink::GetOutputState();
+        if (loadThreads > 1)
+            BarGoLink::SetOutputState(false);
+
+        loadGraph.Run(loadThreads, []() { WorldDatabase.ThreadStart(); }, []() { WorldDatabase.ThreadEnd(); });
+        BarGoLink::SetOutputState(showBars);
+    }
     sLog.outString(">>> Localization strings loaded");
     sLog.outString();
 
@@ -1436,6 +1537,11 @@ void World::SetInitialWorldSettings()
     // Update groups with offline leader after delay in seconds
     m_timers[WUPDATE_GROUPS].SetInterval(IN_MILLISECONDS);
 
+    m_timers[WUPDATE_QUEUE].SetInterval(getConfig(CONFIG_UINT32_QUEUE_UPDATE_INTERVAL));
+
+    // guild event and bank logs are written in batches, 0 writes them as they happen
+    m_timers[WUPDATE_GUILD_LOGS].SetInterval(std::max<uint32>(getConfig(CONFIG_UINT32_GUILD_LOG_FLUSH_INTERVAL), 1) * IN_MILLISECONDS);
+
     // to set mailtimer to return mails every day between 4 and 5 am
     // mailtimer is increased when updating auctions
     // one second is 1000 -(tested on win system)
@@ -1454,8 +1560,17 @@ void World::SetInitialWorldSettings()
     ///- Initialize MapManager
     sLog.outString("Starting Map System");
     sMapMgr.Initialize();
+    sGridPreloader.Initialize(getConfig(CONFIG_UINT32_GRID_PRELOAD_THREADS), getConfig(CONFIG_UINT32_GRID_PRELOAD_LOOKAHEAD),
+        getConfig(CONFIG_UINT32_INSTANCE_PREWARM_MAPS) != 0);
     sLog.outString();
 
+    if (uint32 sessionThreads = getConfig(CONFIG_UINT32_NUM_SESSION_THREADS))
+    {
+        sLog.outString("Starting %u session update threads", sessionThreads);
+        m_sessionUpdater.activate(sessionThreads);
+        sLog.outString();
+    }
+
     ///- Initialize Battlegrounds
     sLog.outString("Starting BattleGround System");
     sBattleGroundMgr.CreateInitialBattleGrounds();
@@ -1617,9 +1732,9 @@ void World::Update(uint32 diff)
         ResetRandomBattleground();
 
     /// <ul><li> Handle auctions when the timer has passed
-    if (m_timers[WUPDATE_AUCTIONS].Passed())
+    if (sTickPacer.IsDue(m_timers[WUPDATE_AUCTIONS]))
     {
-        m_timers[WUPDATE_AUCTIONS].Reset();
+        sTickPacer.Reset(m_timers[WUPDATE_AUCTIONS]);
 
         ///- Update mails (return old mails with item, or delete them)
         //(tested... works on win)
@@ -1635,11 +1750,13 @@ void World::Update(uint32 diff)
 
 #ifdef BUILD_AHBOT
     /// <li> Handle AHBot operations
-    if (m_timers[WUPDATE_AHBOT].Passed())
+    if (sTickPacer.IsDue(m_timers[WUPDATE_AHBOT]))
     {
         sAuctionHouseBot.Update();
-        m_timers[WUPDATE_AHBOT].Reset();
+        sTickPacer.Reset(m_timers[WUPDATE_AHBOT]);
     }
+    else
+        sAuctionHouseBot.ContinueCycle();
 #endif
 
     /// <li> Handle session updates
@@ -1648,6 +1765,13 @@ void World::Update(uint32 diff)
 #endif
     UpdateSessions(diff);
 
+    /// <li> Admit and renumber the login queue
+    if (m_timers[WUPDATE_QUEUE].Passed())
+    {
+        m_timers[WUPDATE_QUEUE].Reset();
+        UpdateQueuedSessions();
+    }
+
     /// <li> Update uptime table
     if (m_timers[WUPDATE_UPTIME].Passed())
     {
@@ -1658,25 +1782,34 @@ void World::Update(uint32 diff)
         LoginDatabase.PExecute("UPDATE uptime SET uptime = %u, maxplayers = %u WHERE realmid = %u AND starttime = " UI64FMTD, tmpDiff, maxClientsNum, realmID, uint64(m_startTime));
     }
 
+    /// <li> Refill the autosave budget before players request their saves
+    UpdatePlayerSaveBudget(diff);
+
     /// <li> Handle all other objects
     ///- Update objects (maps, transport, creatures,...)
 #ifdef BUILD_METRICS
     auto preMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
-    sMapMgr.Update(diff);
+    {
+        TICK_PROFILE_ZONE("MapManager::Update");
+        sMapMgr.Update(diff);
+    }
 #ifdef BUILD_METRICS
     auto postMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
-    sBattleGroundMgr.Update(diff);
-    sOutdoorPvPMgr.Update(diff);
-    sWorldState.Update(diff);
+    {
+        TICK_PROFILE_ZONE("World singletons");
+        sBattleGroundMgr.Update(diff);
+        sOutdoorPvPMgr.Update(diff);
+        sWorldState.Update(diff);
+    }
 #ifdef BUILD_METRICS
     auto postSingletonTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
     ///- Update groups with offline leaders
-    if (m_timers[WUPDATE_GROUPS].Passed())
+    if (sTickPacer.IsDue(m_timers[WUPDATE_GROUPS]))
     {
-        m_timers[WUPDATE_GROUPS].Reset();
+        sTickPacer.Reset(m_timers[WUPDATE_GROUPS]);
         if (const uint32 delay = getConfig(CONFIG_UINT32_GROUP_OFFLINE_LEADER_DELAY))
         {
             for (ObjectMgr::GroupMap::const_iterator i = sObjectMgr.GetGroupMapBegin(); i != sObjectMgr.GetGroupMapEnd(); ++i)
@@ -1684,6 +1817,13 @@ void World::Update(uint32 diff)
         }
     }
 
+    ///- Write the guild logs gathered since the last time
+    if (m_timers[WUPDATE_GUILD_LOGS].Passed())
+    {
+        m_timers[WUPDATE_GUILD_LOGS].Reset();
+        sGuildMgr.SaveGuildLogs();
+    }
+
     ///- Delete all characters which have been deleted X days before
     if (m_timers[WUPDATE_DELETECHARS].Passed())
     {
@@ -1712,9 +1852,9 @@ void World::Update(uint32 diff)
     }
 
     //- Process Raid browser
-    if (m_timers[WUPDATE_RAID_BROWSER].Passed())
+    if (sTickPacer.IsDue(m_timers[WUPDATE_RAID_BROWSER]))
     {
-        m_timers[WUPDATE_RAID_BROWSER].Reset();
+        sTickPacer.Reset(m_timers[WUPDATE_RAID_BROWSER]);
         GetRaidBrowser().Update(this);
     }
 
@@ -1737,6 +1877,7 @@ void World::Update(uint32 diff)
     ProcessCliCommands();
 
     // cleanup unused GridMap objects as well as VMaps
+    sGridPreloader.Update(diff);
     sTerrainMgr.Update(diff);
 #ifdef BUILD_METRICS
     auto updateEndTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
@@ -1747,6 +1888,9 @@ void World::Update(uint32 diff)
     long long singletons = (postSingletonTime - postMapTime).count();
     long long cleanup = (updateEndTime - postSingletonTime).count();
 
+    static metric::histogram& tickHistogram = metric::aggregates::instance().register_histogram("world.update.tick");
+    tickHistogram.observe(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_currentTime).count());
+
     metric::measurement meas("world.update");
     meas.add_field("total", std::to_string(total));
     meas.add_field("presession", std::to_string(presession));
@@ -1754,6 +1898,9 @@ void World::Update(uint32 diff)
     meas.add_field("map", std::to_string(map));
     meas.add_field("singletons", std::to_string(singletons));
     meas.add_field("cleanup", std::to_string(cleanup));
+    meas.add_field("messages", std::to_string(m_messager.GetStats().delivered));
+    meas.add_field("message_latency_total", std::to_string(m_messager.GetStats().totalLatency));
+    meas.add_field("message_latency_max", std::to_string(m_messager.GetStats().maxLatency));
 #endif
 }
 
@@ -1791,7 +1938,7 @@ namespace MaNGOS
 
                 while (char* line = lineFromMessage(pos))
                 {
-                    auto data = std::unique_ptr<WorldPacket>(new WorldPacket());
+                    auto data = std::unique_ptr<WorldPacket>(new WorldPacket(MSG_NULL_ACTION, 200, PooledStorageTag()));
                     ChatHandler::BuildChatPacket(*data, CHAT_MSG_SYSTEM, line);
                     data_list.push_back(std::move(data));
                 }
@@ -1960,7 +2107,7 @@ void World::SendDefenseMessageBroadcastText(uint32 zoneId, uint32 textId)
 /// Kick (and save) all players
 void World::KickAll(bool save)
 {
-    m_QueuedSessions.clear();                               // prevent send queue update packet and login queued sessions
+    m_QueuedSessions.Clear();                               // prevent send queue update packet and login queued sessions
 
     // session not removed at kick and will removed in next update tick
     for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
@@ -2207,8 +2354,45 @@ void World::ShutdownCancel()
     DEBUG_LOG("Server %s cancelled.", (m_ShutdownMask & SHUTDOWN_MASK_RESTART ? "restart" : "shutdown"));
 }
 
+// operations deferred by the session update running on this thread, null outside of parallel session updates
+static thread_local std::vector<std::function<void()>>* s_sessionOperations = nullptr;
+
+class SessionUpdateWorker : public Worker
+{
+    public:
+        SessionUpdateWorker(std::vector<WorldSession*>& sessions, std::vector<std::function<void()>>& operations, uint32 diff, MapUpdater& updater) :
+            Worker(updater), m_sessions(sessions), m_operations(operations), m_diff(diff)
+        {}
+
+        void execute() override
+        {
+            s_sessionOperations = &m_operations;
+            for (WorldSession* session : m_sessions)
+                session->UpdateIndependent(m_diff);
+            s_sessionOperations = nullptr;
+
+            GetWorker().update_finished();
+        }
+
+    private:
+        std::vector<WorldSession*>& m_sessions;
+        std::vector<std::function<void()>>& m_operations;
+        uint32 m_diff;
+};
+
+bool World::DeferSessionOperation(std::function<void()>&& operation)
+{
+    if (!s_sessionOperations)
+        return false;
+
+    s_sessionOperations->push_back(std::move(operation));
+    return true;
+}
+
 void World::UpdateSessions(uint32 diff)
 {
+    TICK_PROFILE_ZONE("World::UpdateSessions");
+
     ///- Add new sessions
     {
         std::deque<WorldSession*> sessionQueueCopy;
@@ -2221,6 +2405,47 @@ void World::UpdateSessions(uint32 diff)
             AddSession_(session);
     }
 
+    ///- Update the session local state of all sessions, in parallel when session threads are enabled
+    if (m_sessionUpdater.activated())
+    {
+        // shards are fixed by account and sorted so every session sees the same order each tick
+        size_t const shardCount = m_sessionUpdater.threads() * 4;
+        m_sessionShards.resize(shardCount);
+        m_sessionShardOperations.resize(shardCount);
+        for (auto& shard : m_sessionShards)
+            shard.clear();
+
+        for (auto const& session : m_sessions)
+            m_sessionShards[session.first % shardCount].push_back(session.second);
+
+        for (size_t i = 0; i < shardCount; ++i)
+        {
+            if (m_sessionShards[i].empty())
+                continue;
+
+            std::sort(m_sessionShards[i].begin(), m_sessionShards[i].end(), [](WorldSession const* left, WorldSession const* right)
+            {
+                return left->GetAccountId() < right->GetAccountId();
+            });
+            m_sessionUpdater.schedule_update(new SessionUpdateWorker(m_sessionShards[i], m_sessionShardOperations[i], diff, m_sessionUpdater), m_sessionShards[i].size());
+        }
+
+        m_sessionUpdater.wait();
+
+        ///- Merge phase: world global operations requested by the shards, in shard order
+        for (auto& operations : m_sessionShardOperations)
+        {
+            for (auto const& operation : operations)
+                operation();
+            operations.clear();
+        }
+    }
+    else
+    {
+        for (auto const& session : m_sessions)
+            session.second->UpdateIndependent(diff);
+    }
+
     ///- Then send an update signal to remaining ones
     for (SessionMap::iterator itr = m_sessions.begin(); itr != m_sessions.end();)
     {
@@ -2241,23 +2466,85 @@ void World::UpdateSessions(uint32 diff)
 // This handles the issued and queued CLI/RA commands
 void World::ProcessCliCommands()
 {
-    std::lock_guard<std::mutex> guard(m_cliCommandQueueLock);
+    uint32 const budget = getConfig(CONFIG_UINT32_CLI_COMMAND_TICK_BUDGET);
+    uint32 const startTime = WorldTimer::getMSTime();
 
-    while (!m_cliCommandQueue.empty())
+    while (true)
     {
-        auto const command = m_cliCommandQueue.front();
-        m_cliCommandQueue.pop_front();
+        const CliCommandHolder* command;
+        {
+            std::lock_guard<std::mutex> guard(m_cliCommandQueueLock);
+            if (m_cliCommandQueue.empty())
+                break;
+
+            command = m_cliCommandQueue.front();
+            m_cliCommandQueue.pop_front();
+        }
+
+        // commands only reading the databases and static stores do not need to hold up the tick
+        if (getConfig(CONFIG_BOOL_CLI_READ_ONLY_COMMAND_THREAD))
+        {
+            CliHandler handler(command->m_cliAccountId, command->m_cliAccessLevel, command->m_print);
+            if (CliHandler::IsReadOnlyCommand(handler.FindCommand(CliHandler::SkipCommandPrefix(&command->m_command[0]))))
+            {
+                if (!m_cliReadOnlyThread.joinable())
+                    m_cliReadOnlyThread = std::thread(&World::CliReadOnlyCommandThread, this);
+
+                ++m_cliReadOnlyCommands;
+                m_cliReadOnlyQueue.Push(std::move(command));
+                continue;
+            }
+        }
+
+        ExecuteCliCommand(command);
+
+        // the rest waits for the next tick once the budget is used up
+        if (budget && WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()) >= budget)
+            break;
+    }
+}
+
+void World::ExecuteCliCommand(const CliCommandHolder* command)
+{
+    DEBUG_LOG("CLI command under processing...");
+
+    // output is handed to the print callback line by line while the command runs
+    CliHandler handler(command->m_cliAccountId, command->m_cliAccessLevel, command->m_print);
+    handler.ParseCommands(&command->m_command[0]);
 
-        DEBUG_LOG("CLI command under processing...");
+    if (command->m_commandFinished)
+        command->m_commandFinished(!handler.HasSentErrorMessage());
 
-        CliHandler handler(command->m_cliAccountId, command->m_cliAccessLevel, command->m_print);
-        handler.ParseCommands(&command->m_command[0]);
+    delete command;
+}
+
+void World::CliReadOnlyCommandThread()
+{
+    LoginDatabase.ThreadStart();
+    CharacterDatabase.ThreadStart();
 
-        if (command->m_commandFinished)
-            command->m_commandFinished(!handler.HasSentErrorMessage());
+    while (true)
+    {
+        const CliCommandHolder* command = nullptr;
+        m_cliReadOnlyQueue.WaitAndPop(command);
+        if (!command)
+            break;
 
-        delete command;
+        ExecuteCliCommand(command);
+        --m_cliReadOnlyCommands;
     }
+
+    CharacterDatabase.ThreadEnd();
+    LoginDatabase.ThreadEnd();
+}
+
+void World::StopCliReadOnlyCommandThread()
+{
+    if (!m_cliReadOnlyThread.joinable())
+        return;
+
+    m_cliReadOnlyQueue.Cancel();
+    m_cliReadOnlyThread.join();
 }
 
 void World::InitResultQueue()
@@ -2266,6 +2553,8 @@ void World::InitResultQueue()
 
 void World::UpdateResultQueue()
 {
+    TICK_PROFILE_ZONE("DB callbacks");
+
     // process async result queues
     CharacterDatabase.ProcessResultQueue();
     WorldDatabase.ProcessResultQueue();
@@ -2587,6 +2876,41 @@ void World::UpdateMaxSessionCounters()
     m_maxQueuedSessionCount = std::max(m_maxQueuedSessionCount, uint32(m_QueuedSessions.size()));
 }
 
+void World::UpdatePlayerSaveBudget(uint32 diff)
+{
+    uint32 interval = getConfig(CONFIG_UINT32_INTERVAL_SAVE);
+    if (!interval || !getConfig(CONFIG_BOOL_PLAYER_SAVE_SMOOTHING))
+        return;
+
+    // every online player saves once per interval, so hand out players * diff / interval saves this tick
+    uint64 share = uint64(GetActiveSessionCount()) * diff * 1000 / interval;
+    // allow a backlog of two ticks worth of saves, but always at least one save
+    m_playerSaveBudgetCap = int32(std::min<uint64>(std::max<uint64>(share * 2, 1000), 1000000));
+
+    int32 budget = m_playerSaveBudget.load();
+    int32 refilled;
+    do
+        refilled = std::min<int64>(int64(budget) + int64(share), m_playerSaveBudgetCap);
+    while (!m_playerSaveBudget.compare_exchange_weak(budget, refilled));
+}
+
+bool World::RequestPlayerAutoSave(bool urgent)
+{
+    if (!getConfig(CONFIG_BOOL_PLAYER_SAVE_SMOOTHING))
+        return true;
+
+    // urgent saves may run the budget into debt which delays the following regular saves instead
+    int32 const floor = urgent ? -m_playerSaveBudgetCap : 1000;
+    int32 budget = m_playerSaveBudget.load();
+    do
+    {
+        if (budget < floor)
+            return false;
+    }
+    while (!m_playerSaveBudget.compare_exchange_weak(budget, budget - 1000));
+    return true;
+}
+
 void World::SetOnlinePlayer(Team team, uint8 race, uint8 plClass, bool apply)
 {
     if (apply)
@@ -2826,6 +3150,11 @@ void World::GeneratePacketMetrics()
         m_opcodeCounters[i] = 0;
     }
 
+    static metric::gauge& onlineSessions = metric::aggregates::instance().register_gauge("world.sessions", { { "state", "online" } });
+    static metric::gauge& queuedSessions = metric::aggregates::instance().register_gauge("world.sessions", { { "state", "queued" } });
+    onlineSessions.set(GetActiveSessionCount());
+    queuedSessions.set(GetQueuedSessionCount());
+
     metric::measurement meas_players("world.metrics.players");
     meas_players.add_field("online", std::to_string(GetActiveSessionCount()));
     meas_players.add_field("unique", std::to_string(GetUniqueSessionCount()));
@@ -2857,8 +3186,68 @@ void World::GeneratePacketMetrics()
     meas_players.add_field("druid", std::to_string(GetOnlineClassPlayers(CLASS_DRUID)));
     meas_players.add_field("deathknight", std::to_string(GetOnlineClassPlayers(CLASS_DEATH_KNIGHT)));
 
+    std::unordered_map<uint32, uint32> zonePopulation;
+    sMapMgr.GetZonePopulation(zonePopulation);
+    for (auto const& zone : zonePopulation)
+    {
+        metric::measurement meas_zone("world.metrics.zones", { {"zone_id", std::to_string(zone.first)} });
+        meas_zone.add_field("players", std::to_string(zone.second));
+    }
+
     metric::measurement meas_latency("world.metrics.latency");
     meas_latency.add_field("online", std::to_string(GetAverageLatency()));
+
+    BlockPool::Stats const poolStats = BlockPool::GetStats();
+    metric::measurement meas_pool("world.metrics.blockpool");
+    meas_pool.add_field("allocated", std::to_string(poolStats.allocated));
+    meas_pool.add_field("reused", std::to_string(poolStats.reused));
+    meas_pool.add_field("released", std::to_string(poolStats.released));
+
+    static char const* const profileThreadNames[MAX_OPCODE_PROFILE_THREAD] = { "world", "map" };
+    for (OpcodeLatencySummary const& summary : sOpcodeProfiler.GetIntervalSummaries())
+    {
+        metric::measurement meas_opcode("world.metrics.opcodes", { {"opcode", opcodeTable[summary.opcode].name}, {"thread", profileThreadNames[summary.thread]} });
+        meas_opcode.add_field("count", std::to_string(summary.data.count));
+        meas_opcode.add_field("p50", std::to_string(summary.data.GetPercentile(0.5f)));
+        meas_opcode.add_field("p99", std::to_string(summary.data.GetPercentile(0.99f)));
+        meas_opcode.add_field("max", std::to_string(summary.data.maxTime));
+        meas_opcode.add_field("wall", std::to_string(summary.data.wallTime));
+        meas_opcode.add_field("cpu", std::to_string(summary.data.cpuTime));
+    }
+
+    // send syscalls per socket, shows how well writes are coalesced
+    ExecuteForAllSessions([](WorldSession& session)
+    {
+        metric::measurement meas_socket("world.metrics.socket");
+        meas_socket.add_field("account", std::to_string(session.GetAccountId()));
+        meas_socket.add_field("sends_per_sec", session.ConsumeSocketSendRate());
+    });
+
+    std::pair<char const*, Database*> const databases[] = { {"world", &WorldDatabase}, {"character", &CharacterDatabase}, {"login", &LoginDatabase}, {"logs", &LogsDatabase} };
+    for (auto& database : databases)
+    {
+        metric::aggregates::instance().register_gauge("world.database.queue", { {"database", database.first} }).set(database.second->GetAsyncQueueSize());
+
+        metric::measurement meas_database("world.metrics.database", { {"database", database.first} });
+        meas_database.add_field("queue", std::to_string(database.second->GetAsyncQueueSize()));
+        meas_database.add_field("max_wait", std::to_string(database.second->ConsumeAsyncMaxWaitTime()));
+
+        // the costliest statements of the interval, the id matches the one shown by .debug queries
+        std::vector<SqlQuerySummary> const summaries = database.second->GetQueryProfiler().GetIntervalSummaries();
+        for (size_t i = 0; i < summaries.size() && i < 10; ++i)
+        {
+            char queryId[9];
+            snprintf(queryId, sizeof(queryId), "%08X", summaries[i].id);
+
+            metric::measurement meas_query("world.metrics.queries", { {"database", database.first}, {"query", queryId} });
+            meas_query.add_field("count", std::to_string(summaries[i].data.count));
+            meas_query.add_field("p50", std::to_string(summaries[i].data.GetPercentile(0.5f)));
+            meas_query.add_field("p99", std::to_string(summaries[i].data.GetPercentile(0.99f)));
+            meas_query.add_field("max", std::to_string(summaries[i].data.maxTime));
+            meas_query.add_field("total", std::to_string(summaries[i].data.totalTime));
+            meas_query.add_field("rows", std::to_string(summaries[i].data.rows));
+        }
+    }
 }
 
 uint32 World::GetAverageLatency() const
@@ -32,6 +32,9 @@
 #include "Globals/GraveyardManager.h"
 #include "LFG/LFG.h"
 #include "LFG/LFGQueue.h"
+#include "Maps/MapUpdater.h"
+#include "World/SessionQueue.h"
+#include "Util/ProducerConsumerQueue.h"
 
 #include <set>
 #include <list>
@@ -90,16 +93,26 @@ enum WorldTimers
     WUPDATE_GROUPS      = 6,
     WUPDATE_RAID_BROWSER= 7,
     WUPDATE_METRICS     = 8, // not used if BUILD_METRICS is not set
-    WUPDATE_COUNT       = 9
+    WUPDATE_QUEUE       = 9,
+    WUPDATE_GUILD_LOGS  = 10,
+    WUPDATE_COUNT       = 11
 };
 
 /// Configuration elements
 enum eConfigUInt32Values
 {
     CONFIG_UINT32_COMPRESSION = 0,
+    CONFIG_UINT32_COMPRESSION_MIN_SIZE,
+    CONFIG_UINT32_NETWORK_RECV_QUEUE_SIZE,
+    CONFIG_UINT32_VALIDATE_MAP_THREAD_ACCESS,
     CONFIG_UINT32_INTERVAL_SAVE,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
+    CONFIG_UINT32_GRID_MAX_LOADED,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
+    CONFIG_UINT32_TICK_PACER_MAX_INTERVAL,
+    CONFIG_UINT32_TICK_PACER_MOVEMENT_STEP,
+    CONFIG_UINT32_TICK_PACER_DEGRADE_THRESHOLD,
+    CONFIG_UINT32_QUEUE_UPDATE_INTERVAL,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
     CONFIG_UINT32_PORT_WORLD,
     CONFIG_UINT32_GAME_TYPE,
@@ -149,9 +162,24 @@ enum eConfigUInt32Values
     CONFIG_UINT32_GM_INVISIBLE_AURA,
     CONFIG_UINT32_MAIL_DELIVERY_DELAY,
     CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK,
+    CONFIG_UINT32_MASS_MAILER_PAGE_SIZE,
+    CONFIG_UINT32_GAME_EVENT_SPAWNS_PER_UPDATE,
     CONFIG_UINT32_UPTIME_UPDATE,
     CONFIG_UINT32_NUM_MAP_THREADS,
+    CONFIG_UINT32_NUM_SESSION_THREADS,
+    CONFIG_UINT32_NUM_LOAD_THREADS,
+    CONFIG_UINT32_CLEAN_CHARACTER_DB_BATCH,
+    CONFIG_UINT32_GRID_PRELOAD_THREADS,
+    CONFIG_UINT32_GRID_PRELOAD_LOOKAHEAD,
+    CONFIG_UINT32_INSTANCE_PREWARM_MAPS,
+    CONFIG_UINT32_NUM_MAP_CELL_THREADS,
+    CONFIG_UINT32_MAP_COST_SAMPLE_INTERVAL,
+    CONFIG_UINT32_PATH_FIND_ASYNC_BATCH,
+    CONFIG_UINT32_PATH_FIND_CACHE_SIZE,
+    CONFIG_UINT32_MMAP_MEMORY_BUDGET,
     CONFIG_UINT32_AUCTION_DEPOSIT_MIN,
+    CONFIG_UINT32_AUCTION_QUERY_THREADS,
+    CONFIG_UINT32_AUCTION_SNAPSHOT_INTERVAL,
     CONFIG_UINT32_SKILL_CHANCE_ORANGE,
     CONFIG_UINT32_SKILL_CHANCE_YELLOW,
     CONFIG_UINT32_SKILL_CHANCE_GREEN,
@@ -187,6 +215,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_BATTLEGROUND_PREMADE_GROUP_WAIT_FOR_MATCH,
     CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN,
     CONFIG_UINT32_BATTLEGROUND_RANDOM_RESET_HOUR,
+    CONFIG_UINT32_BATTLEGROUND_PRECREATED_INSTANCES,
     CONFIG_UINT32_ARENA_MAX_RATING_DIFFERENCE,
     CONFIG_UINT32_ARENA_RATING_DISCARD_TIMER,
     CONFIG_UINT32_ARENA_AUTO_DISTRIBUTE_INTERVAL_DAYS,
@@ -194,12 +223,15 @@ enum eConfigUInt32Values
     CONFIG_UINT32_ARENA_FIRST_RESET_DAY,
     CONFIG_UINT32_ARENA_SEASON_PREVIOUS_ID,
     CONFIG_UINT32_GROUP_OFFLINE_LEADER_DELAY,
+    CONFIG_UINT32_GROUP_MEMBER_STATS_INTERVAL,
     CONFIG_UINT32_BATTLEFIELD_COOLDOWN_DURATION,
     CONFIG_UINT32_BATTLEFIELD_BATTLE_DURATION,
     CONFIG_UINT32_BATTLEFIELD_MAX_PLAYERS_PER_TEAM,
     CONFIG_UINT32_CLIENTCACHE_VERSION,
     CONFIG_UINT32_GUILD_EVENT_LOG_COUNT,
     CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT,
+    CONFIG_UINT32_GUILD_ROSTER_CACHE_TIME,
+    CONFIG_UINT32_GUILD_LOG_FLUSH_INTERVAL,
     CONFIG_UINT32_MIRRORTIMER_FATIGUE_MAX,
     CONFIG_UINT32_MIRRORTIMER_BREATH_MAX,
     CONFIG_UINT32_MIRRORTIMER_ENVIRONMENTAL_MAX,
@@ -220,10 +252,15 @@ enum eConfigUInt32Values
     CONFIG_UINT32_FOGOFWAR_HEALTH,
     CONFIG_UINT32_FOGOFWAR_STATS,
     CONFIG_UINT32_CREATURE_PICKPOCKET_RESTOCK_DELAY,
+    CONFIG_UINT32_CREATURE_DORMANT_INTERVAL,
     CONFIG_UINT32_CHANNEL_STATIC_AUTO_TRESHOLD,
     CONFIG_UINT32_MAX_RECRUIT_A_FRIEND_BONUS_PLAYER_LEVEL,
     CONFIG_UINT32_MAX_RECRUIT_A_FRIEND_BONUS_PLAYER_LEVEL_DIFFERENCE,
     CONFIG_UINT32_SUNSREACH_COUNTER,
+    CONFIG_UINT32_THROTTLED_HEARTBEAT_RATE,
+    CONFIG_UINT32_VISIBILITY_SHEDDING_THRESHOLD,
+    CONFIG_UINT32_VISIBILITY_COALESCE_INTERVAL,
+    CONFIG_UINT32_CLI_COMMAND_TICK_BUDGET,
     CONFIG_UINT32_VALUE_COUNT
 };
 
@@ -312,6 +349,7 @@ enum eConfigFloatValues
     CONFIG_FLOAT_GHOST_RUN_SPEED_WORLD,
     CONFIG_FLOAT_GHOST_RUN_SPEED_BG,
     CONFIG_FLOAT_LEASH_RADIUS,
+    CONFIG_FLOAT_CREATURE_DORMANT_RADIUS,
     CONFIG_FLOAT_MOD_DISCOUNT_REPUTATION_FRIENDLY, // TODO
     CONFIG_FLOAT_MOD_DISCOUNT_REPUTATION_HONORED,
     CONFIG_FLOAT_MOD_DISCOUNT_REPUTATION_REVERED,
@@ -319,6 +357,10 @@ enum eConfigFloatValues
     CONFIG_FLOAT_MOD_INCREASED_XP,
     CONFIG_FLOAT_MOD_INCREASED_GOLD,
     CONFIG_FLOAT_MAX_RECRUIT_A_FRIEND_DISTANCE,
+    CONFIG_FLOAT_FULL_RATE_DISTANCE_CONTINENTS,
+    CONFIG_FLOAT_FULL_RATE_DISTANCE_INSTANCES,
+    CONFIG_FLOAT_FULL_RATE_DISTANCE_BGARENAS,
+    CONFIG_FLOAT_VISIBILITY_SHEDDING_MIN_DISTANCE,
     CONFIG_FLOAT_VALUE_COUNT
 };
 
@@ -326,6 +368,7 @@ enum eConfigFloatValues
 enum eConfigBoolValues
 {
     CONFIG_BOOL_GRID_UNLOAD = 0,
+    CONFIG_BOOL_COMPRESSION_ADAPTIVE,
     CONFIG_BOOL_SAVE_RESPAWN_TIME_IMMEDIATELY,
     CONFIG_BOOL_OFFHAND_CHECK_AT_TALENTS_RESET,
     CONFIG_BOOL_ALLOW_TWO_SIDE_ACCOUNTS,
@@ -361,6 +404,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_ADDON_CHANNEL,
     CONFIG_BOOL_CORPSE_EMPTY_LOOT_SHOW,
     CONFIG_BOOL_CORPSE_ALLOW_ALL_ITEMS_SHOW_IN_MASTER_LOOT,
+    CONFIG_BOOL_CORPSE_DEFERRED_LOOT,
     CONFIG_BOOL_DEATH_CORPSE_RECLAIM_DELAY_PVP,
     CONFIG_BOOL_DEATH_CORPSE_RECLAIM_DELAY_PVE,
     CONFIG_BOOL_DEATH_BONES_WORLD,
@@ -388,9 +432,17 @@ enum eConfigBoolValues
     CONFIG_BOOL_OUTDOORPVP_GH_ENABLED,
     CONFIG_BOOL_BATTLEFIELD_WG_ENABLED,
     CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET,
+    CONFIG_BOOL_OPCODE_PROFILING,
+    CONFIG_BOOL_NETWORK_MAP_THREAD_PACKETS,
+    CONFIG_BOOL_NETWORK_BATCH_MOVEMENT_RELAY,
     CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT,
+    CONFIG_BOOL_PLAYER_SAVE_SMOOTHING,
+    CONFIG_BOOL_DBC_MEMORY_MAPPED,
+    CONFIG_BOOL_MAPS_MEMORY_MAPPED,
     CONFIG_BOOL_CLEAN_CHARACTER_DB,
+    CONFIG_BOOL_CLEAN_CHARACTER_DB_BACKGROUND,
     CONFIG_BOOL_VMAP_INDOOR_CHECK,
+    CONFIG_BOOL_VMAP_LOS_CACHE,
     CONFIG_BOOL_PET_UNSUMMON_AT_MOUNT,
     CONFIG_BOOL_PET_ATTACK_FROM_BEHIND,
     CONFIG_BOOL_AUTO_DOWNRANK,
@@ -399,7 +451,10 @@ enum eConfigBoolValues
     CONFIG_BOOL_AUTOLOAD_ACTIVE,
     CONFIG_BOOL_PATH_FIND_OPTIMIZE,
     CONFIG_BOOL_PATH_FIND_NORMALIZE_Z,
+    CONFIG_BOOL_PATH_FIND_ASYNC,
     CONFIG_BOOL_ALWAYS_SHOW_QUEST_GREETING,
+    CONFIG_BOOL_VISIBILITY_COALESCE_RELOCATIONS,
+    CONFIG_BOOL_CLI_READ_ONLY_COMMAND_THREAD,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -518,6 +573,8 @@ class World
         // player counts
         void SetOnlinePlayer(Team team, uint8 race, uint8 plClass, bool apply); // threadsafe
         uint32 GetOnlineTeamPlayers(bool alliance) const { return m_onlineTeams[alliance]; }
+        // autosave pacing, called by players whose save timer expired - threadsafe
+        bool RequestPlayerAutoSave(bool urgent);
         uint32 GetOnlineRacePlayers(uint8 race) const { return m_onlineRaces[race]; }
         uint32 GetOnlineClassPlayers(uint8 plClass) const { return m_onlineClasses[plClass]; }
 
@@ -529,7 +586,6 @@ class World
         void SetPlayerLimit(int32 limit, bool needUpdate = false);
 
         // player Queue
-        typedef std::list<WorldSession*> Queue;
         void AddQueuedSession(WorldSession*);
         bool RemoveQueuedSession(WorldSession* sess);
         int32 GetQueuedSessionPos(WorldSession const* sess) const;
@@ -594,6 +650,10 @@ class World
 
         void UpdateSessions(uint32 diff);
 
+        // called from a parallel session update: queues the operation for the merge phase and returns true,
+        // otherwise returns false and the caller is expected to run it directly
+        static bool DeferSessionOperation(std::function<void()>&& operation);
+
         /// Get a server configuration element (see #eConfigFloatValues)
         void setConfig(eConfigFloatValues index, float value) { m_configFloatValues[index] = value; }
         /// Get a server configuration element (see #eConfigFloatValues)
@@ -616,6 +676,8 @@ class World
 
         /// Get configuration about force-loaded maps
         bool isForceLoadMap(uint32 id) const { return m_configForceLoadMapIds.find(id) != m_configForceLoadMapIds.end(); }
+        // locale texts of inactive locales are not loaded from the locales_* tables
+        bool IsActiveLocale(LocaleConstant locale) const { return (m_activeLocaleMask & (1 << locale)) != 0; }
 
         /// Are we on a "Player versus Player" server?
         bool IsPvPRealm() const { return (getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_PVP || getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_RPPVP || getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_FFA_PVP); }
@@ -638,6 +700,8 @@ class World
 
         void ProcessCliCommands();
         void QueueCliCommand(const CliCommandHolder* commandHolder) { std::lock_guard<std::mutex> guard(m_cliCommandQueueLock); m_cliCommandQueue.push_back(commandHolder); }
+        // true while read-only console commands are queued or running outside the world thread
+        bool IsCliReadOnlyCommandRunning() const { return m_cliReadOnlyCommands > 0; }
 
         void UpdateResultQueue();
         void InitResultQueue();
@@ -750,6 +814,11 @@ class World
         typedef std::unordered_set<uint32> UniqueSessions;
         SessionMap m_sessions;
         UniqueSessions m_uniqueSessionCount;
+
+        // parallel part of the session updates, see UpdateSessions()
+        MapUpdater m_sessionUpdater;
+        std::vector<std::vector<WorldSession*>> m_sessionShards;
+        std::vector<std::vector<std::function<void()>>> m_sessionShardOperations;
         uint32 m_maxActiveSessionCount;
         uint32 m_maxQueuedSessionCount;
 
@@ -778,6 +847,14 @@ class World
         std::mutex m_cliCommandQueueLock;
         std::deque<const CliCommandHolder*> m_cliCommandQueue;
 
+        // read-only CLI commands, answered by their own thread
+        static void ExecuteCliCommand(const CliCommandHolder* command);
+        void CliReadOnlyCommandThread();
+        void StopCliReadOnlyCommandThread();
+        std::thread m_cliReadOnlyThread;
+        ProducerConsumerQueue<const CliCommandHolder*> m_cliReadOnlyQueue;
+        std::atomic<uint32> m_cliReadOnlyCommands;
+
         // next daily quests and random BG reset time
         time_t m_NextDailyQuestReset;
         time_t m_NextWeeklyQuestReset;
@@ -785,7 +862,10 @@ class World
         time_t m_NextRandomBattlegroundReset;
 
         // Player Queue
-        Queue m_QueuedSessions;
+        SessionQueue m_QueuedSessions;
+        bool m_queuePositionsChanged;                       // sent with the next WUPDATE_QUEUE
+        void AcceptQueuedSession(WorldSession* sess);
+        void UpdateQueuedSessions();
 
         // sessions that are added async
         void AddSession_(WorldSession* s);
@@ -799,6 +879,7 @@ class World
 
         // List of Maps that should be force-loaded on startup
         std::set<uint32> m_configForceLoadMapIds;
+        uint32 m_activeLocaleMask;
 
         // Vector of quests that were chosen for given group
         std::vector<uint32> m_eventGroupChosen;
@@ -818,6 +899,11 @@ class World
         std::array<std::atomic<uint32>, MAX_RACES> m_onlineRaces;
         std::array<std::atomic<uint32>, MAX_CLASSES> m_onlineClasses;
 
+        // autosave budget in thousandths of a save, refilled every tick so saves spread over the interval
+        void UpdatePlayerSaveBudget(uint32 diff);
+        std::atomic<int32> m_playerSaveBudget;
+        int32 m_playerSaveBudgetCap;
+
         GraveyardManager m_graveyardManager;
 
         // World is owner to differentiate from Dungeon finder where queue is completely disjoint
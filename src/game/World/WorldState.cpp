@@ -885,10 +885,11 @@ void WorldState::Update(const uint32 diff)
 
 void WorldState::SendWorldstateUpdate(std::mutex& mutex, GuidVector const& guids, uint32 value, uint32 worldStateId)
 {
+    std::shared_ptr<WorldPacket const> packet = Player::BuildUpdateWorldStatePacket(worldStateId, value);
     std::lock_guard<std::mutex> guard(mutex);
     for (ObjectGuid const& guid : guids)
         if (Player* player = sObjectMgr.GetPlayer(guid))
-            player->SendUpdateWorldState(worldStateId, value);
+            player->GetSession()->SendPacket(packet);
 }
 
 void WorldState::BuffAdalsSongOfBattle()
@@ -1007,9 +1008,10 @@ void WorldState::AddWarEffortProgress(AQResources resource, uint32 count)
         return;
     m_aqData.m_WarEffortCounters[resource] += count;
     Save(SAVE_ID_AHN_QIRAJ);
+    std::shared_ptr<WorldPacket const> packet = Player::BuildUpdateWorldStatePacket(aqWorldstateMap[resource], m_aqData.m_WarEffortCounters[resource]);
     for (ObjectGuid& guid : m_aqData.m_warEffortWorldstatesPlayers)
         if (Player* player = sObjectMgr.GetPlayer(guid))
-            player->SendUpdateWorldState(aqWorldstateMap[resource], m_aqData.m_WarEffortCounters[resource]);
+            player->GetSession()->SendPacket(packet);
     uint32 id = uint32(resource);
     if (id >= aqWorldStateTotalsMap.size())
         id -= 5;
@@ -1041,10 +1043,11 @@ void WorldState::HandleWarEffortPhaseTransition(uint32 newPhase)
             m_aqData.m_phase = PHASE_2_TRANSPORTING_RESOURCES;
             m_aqData.m_timer = 5 * DAY * IN_MILLISECONDS;
             {
+                std::shared_ptr<WorldPacket const> packet = Player::BuildUpdateWorldStatePacket(WORLD_STATE_AQ_DAYS_LEFT, m_aqData.GetDaysRemaining());
                 std::lock_guard<std::mutex> guard(m_aqData.m_warEffortMutex);
                 for (ObjectGuid& guid : m_aqData.m_warEffortWorldstatesPlayers)
                     if (Player* player = sObjectMgr.GetPlayer(guid))
-                        player->SendUpdateWorldState(WORLD_STATE_AQ_DAYS_LEFT, m_aqData.GetDaysRemaining());
+                        player->GetSession()->SendPacket(packet);
             }
             break;
         case PHASE_4_10_HOUR_WAR:
@@ -1519,6 +1522,7 @@ void ScourgeInvasionData::Reset()
     m_lastAttackZone = 0;
     m_broadcastTimer = 10000;
     memset(m_remaining, 0, sizeof(m_remaining));
+    m_sentWorldStates.clear();
 }
 
 std::string ScourgeInvasionData::GetData()
@@ -1626,29 +1630,47 @@ void WorldState::BroadcastSIWorldstates()
     uint32 remainingTanaris = GetSIRemaining(SI_REMAINING_TANARIS);
     uint32 remainingWinterspring = GetSIRemaining(SI_REMAINING_WINTERSPRING);
 
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (const auto& itr : m)
+    std::pair<uint32, uint32> const states[] =
+    {
+        { WORLD_STATE_SCOURGE_AZSHARA, remainingAzshara > 0 ? 1 : 0 },
+        { WORLD_STATE_SCOURGE_BLASTED_LANDS, remainingBlastedLands > 0 ? 1 : 0 },
+        { WORLD_STATE_SCOURGE_BURNING_STEPPES, remainingBurningSteppes > 0 ? 1 : 0 },
+        { WORLD_STATE_SCOURGE_EASTERN_PLAGUELANDS, remainingEasternPlaguelands > 0 ? 1 : 0 },
+        { WORLD_STATE_SCOURGE_TANARIS, remainingTanaris > 0 ? 1 : 0 },
+        { WORLD_STATE_SCOURGE_WINTERSPRING, remainingWinterspring > 0 ? 1 : 0 },
+
+        { WORLD_STATE_SCOURGE_BATTLES_WON, victories },
+        { WORLD_STATE_SCOURGE_NECROPOLIS_AZSHARA, remainingAzshara },
+        { WORLD_STATE_SCOURGE_NECROPOLIS_BLASTED_LANDS, remainingBlastedLands },
+        { WORLD_STATE_SCOURGE_NECROPOLIS_BURNING_STEPPES, remainingBurningSteppes },
+        { WORLD_STATE_SCOURGE_NECROPOLIS_EASTERN_PLAGUELANDS, remainingEasternPlaguelands },
+        { WORLD_STATE_SCOURGE_NECROPOLIS_TANARIS, remainingTanaris },
+        { WORLD_STATE_SCOURGE_NECROPOLIS_WINTERSPRING, remainingWinterspring },
+    };
+
+    // players entering the world get the current values with their initial world states, only changes go out here
+    std::vector<std::shared_ptr<WorldPacket const>> packets;
+    for (auto const& state : states)
+    {
+        auto itr = m_siData.m_sentWorldStates.find(state.first);
+        if (itr != m_siData.m_sentWorldStates.end() && itr->second == state.second)
+            continue;
+
+        m_siData.m_sentWorldStates[state.first] = state.second;
+        packets.push_back(Player::BuildUpdateWorldStatePacket(state.first, state.second));
+    }
+
+    if (packets.empty())
+        return;
+
+    sObjectAccessor.ExecuteOnAllPlayers([&](Player* pl)
     {
-        Player* pl = itr.second;
         // do not process players which are not in world
         if (!pl->IsInWorld())
-            continue;
+            return;
 
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_AZSHARA, remainingAzshara > 0 ? 1 : 0);
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_BLASTED_LANDS, remainingBlastedLands > 0 ? 1 : 0);
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_BURNING_STEPPES, remainingBurningSteppes > 0 ? 1 : 0);
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_EASTERN_PLAGUELANDS, remainingEasternPlaguelands > 0 ? 1 : 0);
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_TANARIS, remainingTanaris > 0 ? 1 : 0);
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_WINTERSPRING, remainingWinterspring > 0 ? 1 : 0);
-
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_BATTLES_WON, victories);
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_NECROPOLIS_AZSHARA, remainingAzshara);
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_NECROPOLIS_BLASTED_LANDS, remainingBlastedLands);
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_NECROPOLIS_BURNING_STEPPES, remainingBurningSteppes);
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_NECROPOLIS_EASTERN_PLAGUELANDS, remainingEasternPlaguelands);
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_NECROPOLIS_TANARIS, remainingTanaris);
-        pl->SendUpdateWorldState(WORLD_STATE_SCOURGE_NECROPOLIS_WINTERSPRING, remainingWinterspring);
-    }
+        pl->GetSession()->SendPackets(packets);
+    });
 }
 
 void WorldState::HandleDefendedZones()
@@ -378,6 +378,7 @@ struct ScourgeInvasionData
     std::set<uint32> m_pendingPallids;
     std::map<uint32, InvasionZone> m_invasionPoints;
     std::map<uint32, CityAttack> m_attackPoints;
+    std::map<uint32, uint32> m_sentWorldStates;         // last broadcast values, cleared once the invasion stops
 
     ScourgeInvasionData();
 
@@ -65,9 +65,10 @@ void WorldStateVariableManager::SetVariable(int32 Id, int32 value)
     if (variable.value == value)
         return;
 
+    // keep the value players saw, a change reverted within the same update is not sent
+    if (variable.send)
+        m_dirtyVariables.emplace(Id, variable.value);
     variable.value = value;
-    if (m_variables[Id].send)
-        BroadcastVariable(Id);
 }
 
 void WorldStateVariableManager::SetVariableData(int32 Id, bool send, uint32 zoneId, uint32 areaId)
@@ -105,7 +106,7 @@ void WorldStateVariableManager::BroadcastVariable(int32 Id) const
     {
         WorldStateVariable const* variable = GetVariableData(Id);
         MANGOS_ASSERT(variable); // if we are broadcasting a variable it must be initialized
-        int32 value = variable->value;
+        std::shared_ptr<WorldPacket const> packet = Player::BuildUpdateWorldStatePacket(Id, variable->value);
         bool queryIds = variable->zoneId || variable->areaId;
         for (const auto& lPlayer : lPlayers)
         {
@@ -116,12 +117,58 @@ void WorldStateVariableManager::BroadcastVariable(int32 Id) const
                     player->GetZoneAndAreaId(zoneId, areaId);
                 if ((!variable->zoneId || variable->zoneId == zoneId) &&
                     (!variable->areaId || variable->areaId == areaId))
-                    player->SendUpdateWorldState(Id, value);
+                    player->GetSession()->SendPacket(packet);
             }
         }
     }
 }
 
+void WorldStateVariableManager::Update()
+{
+    if (m_dirtyVariables.empty())
+        return;
+
+    std::vector<WorldStateVariable const*> changed;
+    std::vector<std::shared_ptr<WorldPacket const>> packets;
+    bool queryIds = false;
+    for (auto const& dirty : m_dirtyVariables)
+    {
+        WorldStateVariable const* variable = GetVariableData(dirty.first);
+        if (!variable->send || variable->value == dirty.second)
+            continue;
+
+        changed.push_back(variable);
+        packets.push_back(Player::BuildUpdateWorldStatePacket(dirty.first, variable->value));
+        queryIds = queryIds || variable->zoneId || variable->areaId;
+    }
+    m_dirtyVariables.clear();
+
+    if (changed.empty())
+        return;
+
+    // every packet is built once and shared by all players it goes to
+    std::vector<std::shared_ptr<WorldPacket const>> playerPackets;
+    for (const auto& lPlayer : m_owner->GetPlayers())
+    {
+        Player* player = lPlayer.getSource();
+        if (!player)
+            continue;
+
+        uint32 zoneId = 0, areaId = 0;
+        if (queryIds)
+            player->GetZoneAndAreaId(zoneId, areaId);
+
+        playerPackets.clear();
+        for (size_t i = 0; i < changed.size(); ++i)
+            if ((!changed[i]->zoneId || changed[i]->zoneId == zoneId) &&
+                (!changed[i]->areaId || changed[i]->areaId == areaId))
+                playerPackets.push_back(packets[i]);
+
+        if (!playerPackets.empty())
+            player->GetSession()->SendPackets(playerPackets);
+    }
+}
+
 std::string WorldStateVariableManager::GetVariableList() const
 {
     std::string output;
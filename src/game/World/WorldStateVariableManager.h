@@ -22,11 +22,13 @@
 #include "Platform/Define.h"
 #include <map>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 class ByteBuffer;
 class Map;
+class WorldPacket;
 
 struct WorldStateVariable
 {
@@ -55,12 +57,16 @@ class WorldStateVariableManager
         void FillInitialWorldStates(ByteBuffer& data, uint32& count, uint32 zoneId, uint32 areaId);
         void BroadcastVariable(int32 Id) const;
 
+        // sends the variables changed since the last call, once per map update
+        void Update();
+
         std::string GetVariableList() const;
 
         void SetEncounterVariable(uint32 encounterId, bool state);
 
     private:
         std::map<int32, WorldStateVariable> m_variables;
+        std::map<int32, int32> m_dirtyVariables;            // id -> value last sent, changes coalesced until Update
         Map* m_owner;
 };
 
@@ -68,7 +68,10 @@ uint32 realmID;                                             ///< Id of the realm
 /// Launch the mangos server
 int main(int argc, char* argv[])
 {
-    std::string auctionBotConfig, configFile, playerBotConfig, serviceParameter;
+    std::string auctionBotConfig, configFile, playerBotConfig, serviceParameter, benchmarkFile, replayFile, replayReport;
+#ifdef BUILD_BENCHMARKS
+    float replaySpeed = 1.0f;
+#endif
 
     boost::program_options::options_description desc("Allowed options");
     desc.add_options()
@@ -79,6 +82,12 @@ int main(int argc, char* argv[])
 #endif
     ("help,h", "prints usage")
     ("version,v", "print version and exit")
+#ifdef BUILD_BENCHMARKS
+    ("benchmark", boost::program_options::value<std::string>(&benchmarkFile), "run the core benchmarks after loading the world, write the results as JSON to this file and exit")
+    ("replay", boost::program_options::value<std::string>(&replayFile), "replay the client packets of a PacketLog.Format = 1 capture, then write a report and exit")
+    ("replay-speed", boost::program_options::value<float>(&replaySpeed)->default_value(1.0f), "speed-up of the replay")
+    ("replay-report", boost::program_options::value<std::string>(&replayReport)->default_value("replay.json"), "file the replay report is written to as JSON")
+#endif
 #ifdef _WIN32
     ("s", boost::program_options::value<std::string>(&serviceParameter), "<run, install, uninstall> service");
 #else
@@ -121,6 +130,17 @@ int main(int argc, char* argv[])
         _PLAYERBOT_CONFIG = playerBotConfig;
 #endif
 
+#ifdef BUILD_BENCHMARKS
+    sMaster.SetBenchmarkFile(benchmarkFile);
+
+    if (replaySpeed <= 0.0f)
+    {
+        std::cerr << "ERROR: the replay speed has to be above 0" << std::endl;
+        return 1;
+    }
+    sMaster.SetReplay(replayFile, replaySpeed, replayReport);
+#endif
+
 #ifdef _WIN32                                                // windows service command need execute before config read
     if (vm.count("s"))
     {
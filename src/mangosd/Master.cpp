@@ -34,6 +34,7 @@
 #include "revision_sql.h"
 #include "MaNGOSsoap.h"
 #include "Mails/MassMailMgr.h"
+#include "AuctionHouse/AuctionQueryPool.h"
 #include "Server/DBCStores.h"
 
 #include "Config/Config.h"
@@ -41,6 +42,13 @@
 #include "Policies/Singleton.h"
 #include "Network/Listener.hpp"
 #include "Network/Socket.hpp"
+#ifdef BUILD_METRICS
+#include "Metric/Exporter.h"
+#endif
+#ifdef BUILD_BENCHMARKS
+#include "Benchmark/CoreBenchmarks.h"
+#include "Benchmark/PacketReplay.h"
+#endif
 
 #include <memory>
 
@@ -123,6 +131,21 @@ int Master::Run()
     ///- Initialize the World
     sWorld.SetInitialWorldSettings();
 
+#ifdef BUILD_BENCHMARKS
+    if (!m_benchmarkFile.empty())
+    {
+        bool const written = CoreBenchmarks::Run(m_benchmarkFile);
+
+        CharacterDatabase.HaltDelayThread();
+        WorldDatabase.HaltDelayThread();
+        LoginDatabase.HaltDelayThread();
+        LogsDatabase.HaltDelayThread();
+
+        m_canBeKilled = true;
+        return written ? 0 : 1;
+    }
+#endif
+
 #ifndef _WIN32
     detachDaemon();
 #endif
@@ -148,6 +171,13 @@ int Master::Run()
     }
 
     sWorld.StartLFGQueueThread();
+    sAuctionQueries.Start(sWorld.getConfig(CONFIG_UINT32_AUCTION_QUERY_THREADS));
+
+#ifdef BUILD_BENCHMARKS
+    std::unique_ptr<MaNGOS::Thread> replayThread;
+    if (!m_replayCapture.empty())
+        replayThread.reset(new MaNGOS::Thread(new PacketReplay(m_replayCapture, m_replaySpeed, m_replayReport)));
+#endif
 
     MaNGOS::Thread* cliThread = nullptr;
 
@@ -222,12 +252,28 @@ int Master::Run()
             sLog.outError("Invalid network tread workers setting in mangosd.conf. (%d) should be > 0", networkThreadWorker);
             networkThreadWorker = 1;
         }
-        MaNGOS::Listener<WorldSocket> listener(sConfig.GetStringDefault("BindIP", "0.0.0.0"), int32(sWorld.getConfig(CONFIG_UINT32_PORT_WORLD)), networkThreadWorker);
+        MaNGOS::Listener<WorldSocket> listener(sConfig.GetStringDefault("BindIP", "0.0.0.0"), int32(sWorld.getConfig(CONFIG_UINT32_PORT_WORLD)), networkThreadWorker,
+                                               sConfig.GetBoolDefault("Network.ReusePort", false));
 
         std::unique_ptr<MaNGOS::Listener<RASocket>> raListener;
         if (sConfig.GetBoolDefault("Ra.Enable", false))
             raListener.reset(new MaNGOS::Listener<RASocket>(sConfig.GetStringDefault("Ra.IP", "0.0.0.0"), sConfig.GetIntDefault("Ra.Port", 3443), 1));
 
+#ifdef BUILD_METRICS
+        std::unique_ptr<metric::exporter> metricExporter;
+        if (sConfig.GetBoolDefault("Metric.Exporter.Enable", false))
+        {
+            try
+            {
+                metricExporter.reset(new metric::exporter(sConfig.GetStringDefault("Metric.Exporter.IP", "127.0.0.1"), sConfig.GetIntDefault("Metric.Exporter.Port", 9101)));
+            }
+            catch (boost::system::system_error const& e)
+            {
+                sLog.outError("Metric exporter could not be started: %s", e.what());
+            }
+        }
+#endif
+
         std::unique_ptr<SOAPThread> soapThread;
         if (sConfig.GetBoolDefault("SOAP.Enabled", false))
             soapThread.reset(new SOAPThread(sConfig.GetStringDefault("SOAP.IP", "127.0.0.1"), sConfig.GetIntDefault("SOAP.Port", 7878)));
@@ -255,6 +301,12 @@ int Master::Run()
     // when the main thread closes the singletons get unloaded
     // since worldrunnable uses them, it will crash if unloaded after master
     world_thread.wait();
+    sAuctionQueries.Stop();
+
+#ifdef BUILD_BENCHMARKS
+    if (replayThread)
+        replayThread->wait();
+#endif
 
     ///- Clean account database before leaving
     clearOnlineAccounts();
@@ -312,15 +364,16 @@ bool Master::_StartDB()
     ///- Get world database info from configuration file
     std::string dbstring = sConfig.GetStringDefault("WorldDatabaseInfo");
     int nConnections = sConfig.GetIntDefault("WorldDatabaseConnections", 1);
+    int nAsyncConnections = sConfig.GetIntDefault("WorldDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Database not specified in configuration file");
         return false;
     }
-    sLog.outString("World Database total connections: %i", nConnections + 1);
+    sLog.outString("World Database total connections: %i", nConnections + nAsyncConnections);
 
     ///- Initialise the world database
-    if (!WorldDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!WorldDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to world database %s", dbstring.c_str());
         return false;
@@ -335,6 +388,7 @@ bool Master::_StartDB()
 
     dbstring = sConfig.GetStringDefault("CharacterDatabaseInfo");
     nConnections = sConfig.GetIntDefault("CharacterDatabaseConnections", 1);
+    nAsyncConnections = sConfig.GetIntDefault("CharacterDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Character Database not specified in configuration file");
@@ -343,10 +397,10 @@ bool Master::_StartDB()
         WorldDatabase.HaltDelayThread();
         return false;
     }
-    sLog.outString("Character Database total connections: %i", nConnections + 1);
+    sLog.outString("Character Database total connections: %i", nConnections + nAsyncConnections);
 
     ///- Initialise the Character database
-    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to Character database %s", dbstring.c_str());
 
@@ -366,6 +420,7 @@ bool Master::_StartDB()
     ///- Get login database info from configuration file
     dbstring = sConfig.GetStringDefault("LoginDatabaseInfo");
     nConnections = sConfig.GetIntDefault("LoginDatabaseConnections", 1);
+    nAsyncConnections = sConfig.GetIntDefault("LoginDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Login database not specified in configuration file");
@@ -377,8 +432,8 @@ bool Master::_StartDB()
     }
 
     ///- Initialise the login database
-    sLog.outString("Login Database total connections: %i", nConnections + 1);
-    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
+    sLog.outString("Login Database total connections: %i", nConnections + nAsyncConnections);
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to login database %s", dbstring.c_str());
 
@@ -400,6 +455,7 @@ bool Master::_StartDB()
     ///- Get logs database info from configuration file
     dbstring = sConfig.GetStringDefault("LogsDatabaseInfo", "");
     nConnections = sConfig.GetIntDefault("LogsDatabaseConnections", 1);
+    nAsyncConnections = sConfig.GetIntDefault("LogsDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("logs database not specified in configuration file");
@@ -412,8 +468,8 @@ bool Master::_StartDB()
     }
 
     ///- Initialise the logs database
-    sLog.outString("Logs Database total connections: %i", nConnections + 1);
-    if (!LogsDatabase.Initialize(dbstring.c_str(), nConnections))
+    sLog.outString("Logs Database total connections: %i", nConnections + nAsyncConnections);
+    if (!LogsDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Cannot connect to logs database %s", dbstring.c_str());
 
@@ -33,6 +33,18 @@ class Master
         int Run();
         static volatile bool m_canBeKilled;
 
+#ifdef BUILD_BENCHMARKS
+        // non empty runs the benchmarks instead of starting the server
+        void SetBenchmarkFile(std::string const& fileName) { m_benchmarkFile = fileName; }
+        // non empty replays the capture once the world runs, then stops the server
+        void SetReplay(std::string const& captureFile, float speed, std::string const& reportFile)
+        {
+            m_replayCapture = captureFile;
+            m_replaySpeed = speed;
+            m_replayReport = reportFile;
+        }
+#endif
+
     private:
         bool _StartDB();
 
@@ -41,6 +53,13 @@ class Master
         static void _OnSignal(int s);
 
         void clearOnlineAccounts();
+
+#ifdef BUILD_BENCHMARKS
+        std::string m_benchmarkFile;
+        std::string m_replayCapture;
+        float m_replaySpeed = 1.0f;
+        std::string m_replayReport;
+#endif
 };
 
 #define sMaster MaNGOS::Singleton<Master>::Instance()
@@ -22,6 +22,11 @@
 
 #include "Common.h"
 #include "World/World.h"
+#include "World/TickProfiler.h"
+#include "World/TickPacer.h"
+#ifdef BUILD_BENCHMARKS
+#include "Benchmark/PacketReplay.h"
+#endif
 #include "WorldRunnable.h"
 #include "Util/Timer.h"
 #include "Maps/MapManager.h"
@@ -52,14 +57,25 @@ void WorldRunnable::run()
         ++World::m_worldLoopCounter;
 
         diffTick = WorldTimer::tick();
+        sTickProfiler.BeginTick();
+#ifdef BUILD_BENCHMARKS
+        uint64 const replayTickStart = PacketReplay::IsRunning() ? TickProfiler::Now() : 0;
+#endif
         sWorld.Update(diffTick);
+#ifdef BUILD_BENCHMARKS
+        if (replayTickStart)
+            PacketReplay::RecordTick(TickProfiler::Now() - replayTickStart);
+#endif
+        sTickProfiler.EndTick();
         diffTime = WorldTimer::getMSTime() - WorldTimer::tickTime();
+        sTickPacer.AddTick(diffTime);
 
-        // we have to wait WORLD_SLEEP_CONST max between loops
+        // we have to wait WORLD_SLEEP_CONST max between loops, or the recent tick times when paced
         // don't wait if over
-        if (diffTime < WORLD_SLEEP_CONST)
+        uint32 const period = sTickPacer.GetPeriod(WORLD_SLEEP_CONST);
+        if (diffTime < period)
         {
-            MaNGOS::Thread::Sleep(WORLD_SLEEP_CONST - diffTime);
+            MaNGOS::Thread::Sleep(period - diffTime);
         }
 #ifdef MANGOS_DEBUG
         else
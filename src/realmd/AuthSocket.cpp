@@ -29,8 +29,13 @@
 #include "RealmList.h"
 #include "AuthSocket.h"
 #include "AuthCodes.h"
+#include "AuthWorkerPool.h"
+#include "BanCache.h"
 #include "Auth/SRP6.h"
 #include "Util/CommonDefines.h"
+#ifdef BUILD_METRICS
+#include "Metric/Aggregate.h"
+#endif
 
 #include <openssl/md5.h>
 #include <ctime>
@@ -174,16 +179,28 @@ typedef struct AuthHandler
 #pragma pack(pop)
 #endif
 
+#ifdef BUILD_METRICS
+namespace
+{
+    metric::counter& s_connections = metric::aggregates::instance().register_counter("realmd.connections");
+    metric::counter& s_logonsSucceeded = metric::aggregates::instance().register_counter("realmd.logons", { { "result", "success" } });
+    metric::counter& s_logonsFailed = metric::aggregates::instance().register_counter("realmd.logons", { { "result", "wrong_password" } });
+}
+#endif
+
 std::array<uint8, 16> VersionChallenge = { { 0xBA, 0xA3, 0x1E, 0x99, 0xA0, 0x0B, 0x21, 0x57, 0xFC, 0x37, 0x3F, 0xB3, 0x69, 0xCD, 0xD2, 0xF1 } };
 
 /// Constructor - set the N and g values for SRP6
 AuthSocket::AuthSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
-    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER), m_timeoutTimer(service)
+    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER), m_realmListSent(false), m_timeoutTimer(service)
 {
 }
 
 bool AuthSocket::Open()
 {
+#ifdef BUILD_METRICS
+    s_connections.add();
+#endif
     m_timeoutTimer.expires_from_now(boost::posix_time::seconds(30));
     m_timeoutTimer.async_wait([&] (const boost::system::error_code& error)
     {
@@ -250,6 +267,10 @@ bool AuthSocket::ProcessIncomingData()
             break;
         }
 
+        // handed to a worker, the next command waits for its answer
+        if (IsReadPaused())
+            break;
+
         // did we iterate over the entire command table, finding nothing? if so, punt!
         if (i == tableLength)
         {
@@ -264,6 +285,26 @@ bool AuthSocket::ProcessIncomingData()
     return true;
 }
 
+bool AuthSocket::RunOnWorker(std::function<bool()> const& step)
+{
+    std::shared_ptr<AuthSocket> self = shared<AuthSocket>();
+    bool const queued = sAuthWorkers.Enqueue([self, step]()
+    {
+        if (self->IsClosed())
+            return;
+
+        if (step())
+            self->ResumeRead();
+        else
+            self->Close();
+    });
+
+    // the job resumes through the network thread, after this handler returned
+    if (queued)
+        PauseRead();
+    return queued;
+}
+
 void AuthSocket::SendProof(Sha1Hash sha)
 {
     switch (_build)
@@ -347,8 +388,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
 
@@ -375,15 +414,22 @@ bool AuthSocket::_HandleLogonChallenge()
     LoginDatabase.escape_string(_safelocale);
     LoginDatabase.escape_string(m_os);
 
+    auto step = [this]() { return CompleteLogonChallenge(); };
+    if (!RunOnWorker(step))
+        return step();
+
+    return true;
+}
+
+/// Account and ban lookups and the host ephemeral of the logon challenge
+bool AuthSocket::CompleteLogonChallenge()
+{
+    ByteBuffer pkt;
     pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
     pkt << uint8(0x00);
 
     ///- Verify that this IP is not in the ip_banned table
-    // No SQL injection possible (paste the IP address as passed by the socket)
-    std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
-            "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'", m_address.c_str()));
-
-    if (ip_banned_result)
+    if (sBanCache.GetIpBan(m_address) != BAN_STATE_NONE)
     {
         pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
         BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
@@ -391,8 +437,10 @@ bool AuthSocket::_HandleLogonChallenge()
     else
     {
         ///- Get the account details from the account table
-        // No SQL injection (escaped user name)
-        QueryResult* result = LoginDatabase.PQuery("SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str());
+        static SqlStatementID selAccount;
+        SqlStatement stmt = LoginDatabase.CreateStatement(selAccount, "SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = ?");
+        stmt.addString(_login);
+        QueryResult* result = stmt.Query();
         if (result)
         {
             Field* fields = result->Fetch();
@@ -429,11 +477,10 @@ bool AuthSocket::_HandleLogonChallenge()
             if (!locked && !broken)
             {
                 ///- If the account is banned, reject the logon attempt
-                QueryResult* banresult = LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
-                                         "account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)", fields[0].GetUInt32());
-                if (banresult)
+                BanState banState = sBanCache.GetAccountBan(fields[0].GetUInt32());
+                if (banState != BAN_STATE_NONE)
                 {
-                    if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
+                    if (banState == BAN_STATE_BANNED)
                     {
                         pkt << uint8(AUTH_LOGON_FAILED_BANNED);
                         BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
@@ -443,8 +490,6 @@ bool AuthSocket::_HandleLogonChallenge()
                         pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
                         BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
                     }
-
-                    delete banresult;
                 }
                 else
                 {
@@ -522,6 +567,30 @@ bool AuthSocket::_HandleLogonProof()
     ///- Session is closed unless overriden
     _status = STATUS_CLOSED;
 
+    // the pin follows the proof, it is read before the rest of the buffer is left to the next command
+    std::vector<uint8> keys;
+    bool pinRead = false;
+    if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
+    {
+        uint8 pinCount;
+        if (Read((char*)&pinCount, sizeof(uint8)))
+        {
+            keys.resize(pinCount + 1);
+            pinRead = Read((char*)keys.data(), sizeof(uint8) * pinCount);
+            keys[pinCount] = '\0';
+        }
+    }
+
+    auto step = [this, lp, keys, pinRead]() { return CompleteLogonProof(lp, keys, pinRead); };
+    if (!RunOnWorker(step))
+        return step();
+
+    return true;
+}
+
+/// SRP6 verification of the logon proof and the account updates
+bool AuthSocket::CompleteLogonProof(sAuthLogonProof_C lp, std::vector<uint8> const& keys, bool pinRead)
+{
     /// <ul><li> If the client has no valid version
     if (!FindBuildInfo(_build))
     {
@@ -552,22 +621,14 @@ bool AuthSocket::_HandleLogonProof()
     {
         if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
         {
-            uint8 pinCount;
-            if (!Read((char*)&pinCount, sizeof(uint8)))
-            {
-                const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
-                Write(data, sizeof(data));
-                return true;
-            }
-            std::vector<uint8> keys(pinCount + 1);
-            if (!Read((char*)keys.data(), sizeof(uint8) * pinCount))
+            if (!pinRead)
             {
                 const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
                 Write(data, sizeof(data));
                 return true;
             }
 
-            keys[pinCount] = '\0';
+            uint8 pinCount = uint8(keys.size() - 1);
             auto ServerToken = generateToken(_token.c_str());
             auto clientToken = atoi((const char*)keys.data());
             if (ServerToken != clientToken)
@@ -590,13 +651,15 @@ bool AuthSocket::_HandleLogonProof()
         }
 
         BASIC_LOG("User '%s' successfully authenticated", _login.c_str());
+#ifdef BUILD_METRICS
+        s_logonsSucceeded.add();
+#endif
 
         ///- Update the sessionkey, current ip and login time and reset number of failed logins in the account table for this account
         // No SQL injection (escaped user input) and IP address as received by socket
         const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
         LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0, os = '%s', platform = '%s' WHERE username = '%s'", K_hex, _safelocale.c_str(), m_os.c_str(), m_platform.c_str(), _safelogin.c_str());
-        if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str()))
-            LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s',NOW(),'%u')", loginfail->Fetch()[0].GetUInt32(), m_address.c_str(), LOGIN_TYPE_REALMD);
+        LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) SELECT id,'%s',NOW(),'%u' FROM account WHERE username = '%s'", m_address.c_str(), LOGIN_TYPE_REALMD, _safelogin.c_str());
         OPENSSL_free((void*)K_hex);
 
         ///- Finish SRP6 and send the final result to the client
@@ -623,6 +686,9 @@ bool AuthSocket::_HandleLogonProof()
         }
 
         BASIC_LOG("[AuthChallenge] account %s tried to login with wrong password!", _login.c_str());
+#ifdef BUILD_METRICS
+        s_logonsFailed.add();
+#endif
 
         uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
         if (MaxWrongPassCount > 0)
@@ -646,6 +712,7 @@ bool AuthSocket::_HandleLogonProof()
                         LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
                                                "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
                                                acc_id, WrongPassBanTime);
+                        sBanCache.InvalidateAccount(acc_id);
                         BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
                                   _login.c_str(), WrongPassBanTime, failed_logins);
                     }
@@ -655,6 +722,7 @@ bool AuthSocket::_HandleLogonProof()
                         LoginDatabase.escape_string(current_ip);
                         LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
                                                current_ip.c_str(), WrongPassBanTime);
+                        sBanCache.InvalidateIp(m_address);
                         BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
                                   current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
                     }
@@ -813,24 +881,38 @@ bool AuthSocket::_HandleRealmList()
     uint8 accountSecurityLevel = (*result)[1].GetUInt8();
     delete result;
 
-    ///- Update realm list if need
-    sRealmList.UpdateIfNeed();
+    ///- Serialized list of this build and security level, refreshed with the realm list
+    uint32 const key = (uint32(_build) << 16) | (uint32(accountSecurityLevel) << 8) | uint32(_accountSecurityLevel);
+    RealmListPacketPtr list = sRealmList.GetRealmListPacket(key, [this, accountSecurityLevel](RealmListPacket& packet)
+    {
+        LoadRealmlist(packet, accountSecurityLevel);
+    });
 
-    ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
-    ByteBuffer pkt;
-    LoadRealmlist(pkt, id, accountSecurityLevel);
+    ///- Patch in the # of user characters in each realm, the first list of a connection reads them from the database
+    RealmList::CharacterCounts counts = sRealmList.GetCharacterCounts(id, !m_realmListSent);
+    m_realmListSent = true;
 
     ByteBuffer hdr;
     hdr << (uint8) CMD_REALM_LIST;
-    hdr << (uint16)pkt.size();
-    hdr.append(pkt);
+    hdr << (uint16)list->data.size();
+    size_t const dataPos = hdr.wpos();
+    hdr.append(list->data);
+
+    for (auto const& charCount : list->charCounts)
+    {
+        auto itr = counts.find(charCount.first);
+        if (itr != counts.end())
+            hdr.put<uint8>(dataPos + charCount.second, itr->second);
+    }
 
     Write((const char*)hdr.contents(), hdr.size());
     return true;
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLevel)
+void AuthSocket::LoadRealmlist(RealmListPacket& list, uint8 securityLevel)
 {
+    ByteBuffer& pkt = list.data;
+
     switch (_build)
     {
         case 5875:                                          // 1.12.1
@@ -842,19 +924,6 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
 
             for (const auto& i : sRealmList)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
-
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
                 RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : nullptr;
@@ -885,7 +954,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
                 pkt << name;                                // name
                 pkt << i.second.address;                   // address
                 pkt << float(i.second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
+                list.charCounts.emplace_back(i.second.m_ID, pkt.wpos());
+                pkt << uint8(0);                            // characters, patched in per account
                 pkt << uint8(i.second.timezone);           // realm category
                 pkt << uint8(0x00);                         // unk, may be realm number/id?
             }
@@ -907,19 +977,6 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
 
             for (const auto& i : sRealmList)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
-
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
                 RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : nullptr;
@@ -947,7 +1004,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
                 pkt << i.first;                            // name
                 pkt << i.second.address;                   // address
                 pkt << float(i.second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
+                list.charCounts.emplace_back(i.second.m_ID, pkt.wpos());
+                pkt << uint8(0);                            // characters, patched in per account
                 pkt << uint8(i.second.timezone);           // realm category (Cfg_Categories.dbc)
                 pkt << uint8(0x2C);                         // unk, may be realm number/id?
 
@@ -34,9 +34,13 @@
 #include <boost/asio.hpp>
 
 #include <functional>
+#include <vector>
 
 #define HMAC_RES_SIZE 20
 
+struct AUTH_LOGON_PROOF_C;
+struct RealmListPacket;
+
 class AuthSocket : public MaNGOS::Socket
 {
     public:
@@ -47,7 +51,7 @@ class AuthSocket : public MaNGOS::Socket
         bool Open() override;
 
         void SendProof(Sha1Hash sha);
-        void LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 accountSecurityLevel = 0);
+        void LoadRealmlist(RealmListPacket& list, uint8 securityLevel);
         int32 generateToken(char const* b32key);
 
         uint8 getEligibleRealmCount(uint8 accountSecurityLevel);
@@ -65,6 +69,11 @@ class AuthSocket : public MaNGOS::Socket
         bool _HandleXferAccept();
 
     private:
+        // runs the step on an auth worker with reading paused, false when there are no workers
+        bool RunOnWorker(std::function<bool()> const& step);
+        bool CompleteLogonChallenge();
+        bool CompleteLogonProof(AUTH_LOGON_PROOF_C lp, std::vector<uint8> const& keys, bool pinRead);
+
         enum eStatus
         {
             STATUS_CHALLENGE,
@@ -89,6 +98,7 @@ class AuthSocket : public MaNGOS::Socket
         std::string _safelocale;
         uint16 _build;
         AccountTypes _accountSecurityLevel;
+        bool m_realmListSent;
 
         boost::asio::deadline_timer m_timeoutTimer;
 
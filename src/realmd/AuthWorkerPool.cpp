@@ -0,0 +1,78 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "AuthWorkerPool.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+
+AuthWorkerPool& sAuthWorkers
+{
+    static AuthWorkerPool pool;
+    return pool;
+}
+
+void AuthWorkerPool::Start(uint32 threads)
+{
+    for (uint32 i = 0; i < threads; ++i)
+        m_threads.emplace_back(&AuthWorkerPool::WorkerThread, this);
+
+    if (!m_threads.empty())
+        sLog.outString("Logons are handled by %u worker threads", threads);
+}
+
+void AuthWorkerPool::Stop()
+{
+    if (m_threads.empty())
+        return;
+
+    m_queue.Cancel();
+    for (std::thread& thread : m_threads)
+        thread.join();
+    m_threads.clear();
+}
+
+bool AuthWorkerPool::Enqueue(Job const& job)
+{
+    if (m_threads.empty())
+        return false;
+
+    m_queue.Push(new Job(job));
+    return true;
+}
+
+void AuthWorkerPool::WorkerThread()
+{
+    LoginDatabase.ThreadStart();
+
+    while (true)
+    {
+        Job* job = nullptr;
+        m_queue.WaitAndPop(job);
+        if (!job)
+            break;
+
+        (*job)();
+        delete job;
+    }
+
+    LoginDatabase.ThreadEnd();
+}
@@ -0,0 +1,59 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _AUTHWORKERPOOL_H
+#define _AUTHWORKERPOOL_H
+
+#include "Common.h"
+#include "Util/ProducerConsumerQueue.h"
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+/// Threads running the database lookups and SRP6 math of logons, off the network threads
+class AuthWorkerPool
+{
+    public:
+        typedef std::function<void()> Job;
+
+        static AuthWorkerPool& Instance();
+
+        ~AuthWorkerPool() { Stop(); }
+
+        void Start(uint32 threads);
+        void Stop();
+
+        /// False without worker threads, the caller runs the job itself then
+        bool Enqueue(Job const& job);
+
+    private:
+        void WorkerThread();
+
+        std::vector<std::thread> m_threads;
+        ProducerConsumerQueue<Job*> m_queue;
+};
+
+#define sAuthWorkers AuthWorkerPool::Instance()
+
+#endif
+/// @}
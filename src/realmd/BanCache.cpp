@@ -0,0 +1,120 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "BanCache.h"
+#include "Database/DatabaseEnv.h"
+
+// expired entries are only dropped once a cache grows past this
+#define BAN_CACHE_PURGE_SIZE 16384
+
+BanCache& sBanCache
+{
+    static BanCache cache;
+    return cache;
+}
+
+template<typename Key>
+bool BanCache::Find(std::unordered_map<Key, Entry>& cache, Key const& key, BanState& state)
+{
+    if (!m_ttl)
+        return false;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto itr = cache.find(key);
+    if (itr == cache.end() || itr->second.expireTime <= time(nullptr))
+        return false;
+
+    state = itr->second.state;
+    return true;
+}
+
+template<typename Key>
+void BanCache::Store(std::unordered_map<Key, Entry>& cache, Key const& key, BanState state)
+{
+    if (!m_ttl)
+        return;
+
+    time_t const now = time(nullptr);
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (cache.size() >= BAN_CACHE_PURGE_SIZE)
+    {
+        for (auto itr = cache.begin(); itr != cache.end();)
+        {
+            if (itr->second.expireTime <= now)
+                itr = cache.erase(itr);
+            else
+                ++itr;
+        }
+    }
+
+    cache[key] = { state, now + time_t(m_ttl) };
+}
+
+BanState BanCache::GetIpBan(std::string const& ip)
+{
+    BanState state;
+    if (Find(m_ipBans, ip, state))
+        return state;
+
+    static SqlStatementID selIpBan;
+    SqlStatement stmt = LoginDatabase.CreateStatement(selIpBan, "SELECT expires_at FROM ip_banned "
+        "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = ?");
+    stmt.addString(ip);
+    std::unique_ptr<QueryResult> result(stmt.Query());
+    state = result ? BAN_STATE_BANNED : BAN_STATE_NONE;
+
+    Store(m_ipBans, ip, state);
+    return state;
+}
+
+BanState BanCache::GetAccountBan(uint32 accountId)
+{
+    BanState state;
+    if (Find(m_accountBans, accountId, state))
+        return state;
+
+    static SqlStatementID selAccountBan;
+    SqlStatement stmt = LoginDatabase.CreateStatement(selAccountBan, "SELECT banned_at,expires_at FROM account_banned WHERE "
+        "account_id = ? AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)");
+    stmt.addUInt32(accountId);
+    std::unique_ptr<QueryResult> result(stmt.Query());
+    if (!result)
+        state = BAN_STATE_NONE;
+    else
+        state = (*result)[0].GetUInt64() == (*result)[1].GetUInt64() ? BAN_STATE_BANNED : BAN_STATE_SUSPENDED;
+
+    Store(m_accountBans, accountId, state);
+    return state;
+}
+
+void BanCache::InvalidateIp(std::string const& ip)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_ipBans.erase(ip);
+}
+
+void BanCache::InvalidateAccount(uint32 accountId)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_accountBans.erase(accountId);
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _BANCACHE_H
+#define _BANCACHE_H
+
+#include "Common.h"
+
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+enum BanState
+{
+    BAN_STATE_NONE,
+    BAN_STATE_SUSPENDED,                                    ///< temporary ban
+    BAN_STATE_BANNED                                        ///< permanent ban
+};
+
+/// Recent ip and account ban lookups, a login storm does not query the same bans over and over
+class BanCache
+{
+    public:
+        static BanCache& Instance();
+
+        BanCache() : m_ttl(0) {}
+
+        /// Seconds a lookup is reused, 0 always queries the database
+        void SetTTL(uint32 seconds) { m_ttl = seconds; }
+
+        /// Any thread, queried with prepared statements when not cached
+        BanState GetIpBan(std::string const& ip);
+        BanState GetAccountBan(uint32 accountId);
+
+        /// Forget the cached state after a ban was added
+        void InvalidateIp(std::string const& ip);
+        void InvalidateAccount(uint32 accountId);
+
+    private:
+        struct Entry
+        {
+            BanState state;
+            time_t expireTime;
+        };
+
+        template<typename Key>
+        bool Find(std::unordered_map<Key, Entry>& cache, Key const& key, BanState& state);
+        template<typename Key>
+        void Store(std::unordered_map<Key, Entry>& cache, Key const& key, BanState state);
+
+        uint32 m_ttl;
+
+        std::mutex m_mutex;
+        std::unordered_map<std::string, Entry> m_ipBans;
+        std::unordered_map<uint32, Entry> m_accountBans;
+};
+
+#define sBanCache BanCache::Instance()
+
+#endif
+/// @}
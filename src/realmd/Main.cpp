@@ -27,11 +27,16 @@
 #include "Config/Config.h"
 #include "Log.h"
 #include "AuthSocket.h"
+#include "AuthWorkerPool.h"
+#include "BanCache.h"
 #include "SystemConfig.h"
 #include "revision.h"
 #include "revision_sql.h"
 #include "Util/Util.h"
 #include "Network/Listener.hpp"
+#ifdef BUILD_METRICS
+#include "Metric/Exporter.h"
+#endif
 
 #include <openssl/opensslv.h>
 #include <openssl/crypto.h>
@@ -231,6 +236,9 @@ int main(int argc, char* argv[])
     LoginDatabase.Execute("DELETE FROM ip_banned WHERE expires_at<=UNIX_TIMESTAMP() AND expires_at<>banned_at");
     LoginDatabase.CommitTransaction();
 
+    sBanCache.SetTTL(sConfig.GetIntDefault("BanCacheTTL", 10));
+    sAuthWorkers.Start(sConfig.GetIntDefault("AuthWorkerThreads", 2));
+
     // FIXME - more intelligent selection of thread count is needed here.  config option?
     MaNGOS::Listener<AuthSocket> listener(
             sConfig.GetStringDefault("BindIP", "0.0.0.0"),
@@ -238,6 +246,22 @@ int main(int argc, char* argv[])
             sConfig.GetIntDefault("ListenerThreads", 1)
     );
 
+#ifdef BUILD_METRICS
+    std::unique_ptr<metric::exporter> metricExporter;
+    if (sConfig.GetBoolDefault("Metric.Exporter.Enable", false))
+    {
+        try
+        {
+            metricExporter.reset(new metric::exporter(sConfig.GetStringDefault("Metric.Exporter.IP", "127.0.0.1"), sConfig.GetIntDefault("Metric.Exporter.Port", 9102)));
+        }
+        catch (boost::system::system_error const& e)
+        {
+            sLog.outError("Metric exporter could not be started: %s", e.what());
+        }
+    }
+    metric::gauge& loginQueue = metric::aggregates::instance().register_gauge("realmd.database.queue");
+#endif
+
     ///- Catch termination signals
     HookSignals();
 
@@ -303,6 +327,9 @@ int main(int argc, char* argv[])
             DETAIL_LOG("Ping MySQL to keep connection alive");
             LoginDatabase.Ping();
         }
+#ifdef BUILD_METRICS
+        loginQueue.set(LoginDatabase.GetAsyncQueueSize());
+#endif
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
 #ifdef _WIN32
         if (m_ServiceStatus == 0) stopEvent = true;
@@ -310,6 +337,8 @@ int main(int argc, char* argv[])
 #endif
     }
 
+    sAuthWorkers.Stop();
+
     ///- Wait for the delay thread to exit
     LoginDatabase.HaltDelayThread();
 
@@ -350,9 +379,11 @@ bool StartDB()
         return false;
     }
 
-    sLog.outString("Login Database total connections: %i", 1 + 1);
+    // the auth workers query in parallel, each connection serves one of them at a time
+    int nConnections = sConfig.GetIntDefault("LoginDatabaseConnections", 1);
+    sLog.outString("Login Database total connections: %i", nConnections + 1);
 
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
     {
         sLog.outError("Cannot connect to database");
         return false;
@@ -31,6 +31,9 @@ INSTANTIATE_SINGLETON_1(RealmList);
 
 extern DatabaseType LoginDatabase;
 
+// cached character counts are dropped at once when this many accounts are held between two realm list refreshes
+#define REALM_CHAR_COUNTS_LIMIT 16384
+
 // will only support 1.12.1/1.12.2/1.12.3, TBC 2.4.3 and official release for WotLK and later, client builds 10505, 8606, 6141, 6005, 5875
 // if you need more from old build then add it in cases in realmd sources code
 // list sorted from high to low build and first build used as low bound for accepted by default range (any > it will accepted by realmd at least)
@@ -147,8 +150,13 @@ void RealmList::UpdateIfNeed()
 
     m_NextUpdateTime = time(nullptr) + m_UpdateInterval;
 
-    // Clears Realm list
+    // Clears Realm list, together with what was serialized from it
     m_realms.clear();
+    m_packets.clear();
+    {
+        std::lock_guard<std::mutex> guard(m_charCountsLock);
+        m_charCounts.clear();
+    }
 
     // Get the content of the realmlist table in the database
     UpdateRealms(false);
@@ -192,3 +200,52 @@ void RealmList::UpdateRealms(bool init)
         delete result;
     }
 }
+
+RealmListPacketPtr RealmList::GetRealmListPacket(uint32 key, PacketBuilder const& builder)
+{
+    std::lock_guard<std::mutex> guard(m_packetsLock);
+
+    UpdateIfNeed();
+
+    auto itr = m_packets.find(key);
+    if (itr != m_packets.end())
+        return itr->second;
+
+    std::shared_ptr<RealmListPacket> packet = std::make_shared<RealmListPacket>();
+    builder(*packet);
+    m_packets[key] = packet;
+    return packet;
+}
+
+RealmList::CharacterCounts RealmList::GetCharacterCounts(uint32 accountId, bool reload)
+{
+    if (!reload)
+    {
+        std::lock_guard<std::mutex> guard(m_charCountsLock);
+        auto itr = m_charCounts.find(accountId);
+        if (itr != m_charCounts.end())
+            return itr->second;
+    }
+
+    CharacterCounts counts;
+
+    static SqlStatementID selCharCounts;
+    SqlStatement stmt = LoginDatabase.CreateStatement(selCharCounts, "SELECT realmid, numchars FROM realmcharacters WHERE acctid = ?");
+    stmt.addUInt32(accountId);
+    if (QueryResult* result = stmt.Query())
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            counts[fields[0].GetUInt32()] = fields[1].GetUInt8();
+        }
+        while (result->NextRow());
+        delete result;
+    }
+
+    std::lock_guard<std::mutex> guard(m_charCountsLock);
+    if (m_charCounts.size() >= REALM_CHAR_COUNTS_LIMIT)
+        m_charCounts.clear();
+    m_charCounts[accountId] = counts;
+    return counts;
+}
@@ -24,7 +24,14 @@
 #define _REALMLIST_H
 
 #include "Common.h"
+#include "Util/ByteBuffer.h"
+
 #include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 struct RealmBuildInfo
 {
@@ -55,11 +62,22 @@ struct Realm
     RealmBuildInfo realmBuildInfo;                          // build info for show version in list
 };
 
+/// Serialized realm list of one client build and security level, the character counts are patched in per account
+struct RealmListPacket
+{
+    ByteBuffer data;
+    std::vector<std::pair<uint32, size_t>> charCounts;     ///< realm id and position of its character count in data
+};
+
+typedef std::shared_ptr<RealmListPacket const> RealmListPacketPtr;
+
 /// Storage object for the list of realms on the server
 class RealmList
 {
     public:
         typedef std::map<std::string, Realm> RealmMap;
+        typedef std::function<void(RealmListPacket&)> PacketBuilder;
+        typedef std::unordered_map<uint32, uint8> CharacterCounts;   ///< realm id -> characters of the account
 
         static RealmList& Instance();
 
@@ -68,18 +86,29 @@ class RealmList
 
         void Initialize(uint32 updateInterval);
 
-        void UpdateIfNeed();
+        /// Any thread, the realm list is refreshed when due and the builder only called for a key not yet serialized
+        RealmListPacketPtr GetRealmListPacket(uint32 key, PacketBuilder const& builder);
+
+        /// Any thread, characters of the account per realm, reload skips the cached counts
+        CharacterCounts GetCharacterCounts(uint32 accountId, bool reload);
 
         RealmMap::const_iterator begin() const { return m_realms.begin(); }
         RealmMap::const_iterator end() const { return m_realms.end(); }
         uint32 size() const { return m_realms.size(); }
     private:
+        void UpdateIfNeed();
         void UpdateRealms(bool init);
         void UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
     private:
         RealmMap m_realms;                                  ///< Internal map of realms
         uint32   m_UpdateInterval;
         time_t   m_NextUpdateTime;
+
+        std::mutex m_packetsLock;                           ///< also guards the realm map refresh
+        std::unordered_map<uint32, RealmListPacketPtr> m_packets;
+
+        std::mutex m_charCountsLock;
+        std::unordered_map<uint32, CharacterCounts> m_charCounts;
 };
 
 #define sRealmList RealmList::Instance()
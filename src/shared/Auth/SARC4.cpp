@@ -18,34 +18,67 @@
 
 #include "Auth/SARC4.h"
 
-SARC4::SARC4(size_t len) : m_ctx(EVP_CIPHER_CTX_new())
+#include <utility>
+
+SARC4::SARC4(size_t len) : m_keyLength(len), m_i(0), m_j(0), m_keystreamPos(KeystreamSize)
 {
-    EVP_CIPHER_CTX_init(m_ctx);
-    EVP_EncryptInit_ex(m_ctx, EVP_rc4(), nullptr, nullptr, nullptr);
-    EVP_CIPHER_CTX_set_key_length(m_ctx, len);
+    for (size_t i = 0; i < 256; ++i)
+        m_state[i] = uint8(i);
 }
 
-SARC4::SARC4(const uint8 *seed, size_t len) : m_ctx(EVP_CIPHER_CTX_new())
+SARC4::SARC4(const uint8 *seed, size_t len) : SARC4(len)
 {
-    EVP_CIPHER_CTX_init(m_ctx);
-    EVP_EncryptInit_ex(m_ctx, EVP_rc4(), nullptr, nullptr, nullptr);
-    EVP_CIPHER_CTX_set_key_length(m_ctx, len);
-    EVP_EncryptInit_ex(m_ctx, nullptr, nullptr, seed, nullptr);
+    Init(seed);
 }
 
-SARC4::~SARC4()
+void SARC4::Init(const uint8 *seed)
 {
-    EVP_CIPHER_CTX_free(m_ctx);
+    for (size_t i = 0; i < 256; ++i)
+        m_state[i] = uint8(i);
+
+    uint8 j = 0;
+    for (size_t i = 0; i < 256; ++i)
+    {
+        j = uint8(j + m_state[i] + seed[i % m_keyLength]);
+        std::swap(m_state[i], m_state[j]);
+    }
+
+    m_i = 0;
+    m_j = 0;
+    m_keystreamPos = KeystreamSize;
 }
 
-void SARC4::Init(const uint8 *seed)
+void SARC4::GenerateKeystream()
 {
-    EVP_EncryptInit_ex(m_ctx, nullptr, nullptr, seed, nullptr);
+    uint8 i = m_i;
+    uint8 j = m_j;
+    for (size_t n = 0; n < KeystreamSize; ++n)
+    {
+        i = uint8(i + 1);
+        j = uint8(j + m_state[i]);
+        std::swap(m_state[i], m_state[j]);
+        m_keystream[n] = m_state[uint8(m_state[i] + m_state[j])];
+    }
+
+    m_i = i;
+    m_j = j;
+    m_keystreamPos = 0;
 }
 
 void SARC4::UpdateData(uint8 *data, size_t len)
 {
-    int outlen = 0;
-    EVP_EncryptUpdate(m_ctx, data, &outlen, data, len);
-    EVP_EncryptFinal_ex(m_ctx, data, &outlen);
+    while (len)
+    {
+        if (m_keystreamPos == KeystreamSize)
+            GenerateKeystream();
+
+        size_t const count = std::min(len, KeystreamSize - m_keystreamPos);
+        uint8 const* keystream = &m_keystream[m_keystreamPos];
+        for (size_t n = 0; n < count; ++n)
+            data[n] ^= keystream[n];
+
+        data += count;
+        len -= count;
+        m_keystreamPos += count;
+    }
 }
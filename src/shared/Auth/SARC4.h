@@ -20,19 +20,29 @@
 #define _AUTH_SARC4_H
 
 #include "Common.h"
-#include <openssl/evp.h>
 
+// In-process RC4. Packet headers are only 4-5 bytes, so instead of paying a cipher call
+// per header the keystream is generated ahead in blocks and headers are xored against it.
 class SARC4
 {
     public:
         SARC4(size_t len);
         SARC4(const uint8 *seed, size_t len);
-        ~SARC4();
 
         void Init(const uint8 *seed);
         void UpdateData(uint8 *data, size_t len);
 
     private:
-        EVP_CIPHER_CTX* m_ctx;
+        static const size_t KeystreamSize = 1024;
+
+        void GenerateKeystream();
+
+        size_t m_keyLength;
+        uint8 m_state[256];
+        uint8 m_i;
+        uint8 m_j;
+
+        uint8 m_keystream[KeystreamSize];
+        size_t m_keystreamPos;                              // next unused keystream byte
 };
 #endif
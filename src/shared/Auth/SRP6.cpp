@@ -37,6 +37,12 @@ void SRP6::CalculateHostPublicEphemeral(void)
     MANGOS_ASSERT(gmod.GetNumBytes() <= 32);
 }
 
+void SRP6::CalculateClientPublicEphemeral(void)
+{
+    a.SetRand(19 * 8);
+    A = g.ModExp(a, N);
+}
+
 void SRP6::CalculateProof(std::string username)
 {
     uint8 hash[20];
@@ -90,6 +96,35 @@ bool SRP6::CalculateSessionKey(uint8* lp_A, int l)
     return true;
 }
 
+bool SRP6::CalculateClientSessionKey(uint8* lp_B, int l, const uint8* credentialsHash)
+{
+    B.SetBinary(lp_B, l);
+
+    // SRP safeguard: abort if B % N == 0
+    BigNumber reducedB = B % N;
+    if (reducedB.isZero())
+        return false;
+
+    Sha1Hash sha;
+    sha.UpdateBigNumbers(&A, &B, nullptr);
+    sha.Finalize();
+    u.SetBinary(sha.GetDigest(), 20);
+
+    sha.Initialize();
+    sha.UpdateData(s.AsByteArray());
+    sha.UpdateData(credentialsHash, Sha1Hash::GetLength());
+    sha.Finalize();
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), Sha1Hash::GetLength());
+
+    // S = (B - 3 * g^x) ^ (a + u * x), 3 * N is added first to keep the base positive
+    BigNumber gx = g.ModExp(x, N);
+    BigNumber base = ((N * 3) + reducedB - (gx * 3)) % N;
+    S = base.ModExp(a + (u * x), N);
+
+    return true;
+}
+
 bool SRP6::CalculateVerifier(const std::string& rI)
 {
     BigNumber salt;
@@ -198,6 +233,12 @@ bool SRP6::SetSalt(const char* new_s)
         return false;
     return true;
 }
+bool SRP6::SetSalt(const uint8* new_s, int l)
+{
+    s.SetBinary(new_s, l);
+    return !s.isZero();
+}
+
 bool SRP6::SetVerifier(const char* new_v)
 {
     if (v.SetHexStr(new_v) == 0 || v.isZero())
@@ -41,6 +41,13 @@ class SRP6
         */
         void CalculateHostPublicEphemeral(void);
 
+        //! calculates the client public ephemeral (A)
+        /*!
+          generates also a random number as client private ephemeral (a),
+          only needed when acting as the client side of the protocol
+        */
+        void CalculateClientPublicEphemeral(void);
+
         //! calculates proof (M) of the strong session key (K)
         /*!
           \param username the unique identity of the account to authenticate
@@ -56,6 +63,17 @@ class SRP6
         */
         bool CalculateSessionKey(uint8* lp_A, int l);
 
+        //! calculates a session key (S) based on host public ephemeral (B), client side counterpart of CalculateSessionKey
+        /*!
+          the salt (s) has to be set and the client public ephemeral (A) calculated first
+          safeguard condition is (B % N != 0)
+          \param lp_B the host public ephemeral (B)
+          \param l the length of host public ephemeral (B)
+          \param credentialsHash raw sha1 digest of USERNAME:PASSWORD
+          \return true on valid safeguard conditions otherwise false
+        */
+        bool CalculateClientSessionKey(uint8* lp_B, int l, const uint8* credentialsHash);
+
         //! calculates the password verifier (v)
         /*!
           \param rI a sha1 hash of USERNAME:PASSWORD
@@ -100,6 +118,7 @@ class SRP6
         */
         void Finalize(Sha1Hash& sha);
 
+        BigNumber GetClientPublicEphemeral(void) { return A; };
         BigNumber GetHostPublicEphemeral(void) { return B; };
         BigNumber GetGeneratorModulo(void) { return g; };
         BigNumber GetPrime(void) { return N; };
@@ -109,11 +128,12 @@ class SRP6
         BigNumber GetVerifier(void) { return v; };
 
         bool SetSalt(const char* new_s);
+        bool SetSalt(const uint8* new_s, int l);
         void SetStrongSessionKey(const char* new_K) { K.SetHexStr(new_K); };
         bool SetVerifier(const char* new_v);
 
     private:
-        BigNumber A, u, S;
+        BigNumber a, A, u, S;
         BigNumber N, s, g, v;
         BigNumber b, B;
         BigNumber K;
@@ -71,9 +71,19 @@ bool Config::Reload()
 
     m_entries = std::move(newEntries);
 
+    for (ConfigHandleBase* handle : m_handles)
+        handle->Load(*this);
+
     return true;
 }
 
+void Config::Register(ConfigHandleBase& handle)
+{
+    std::lock_guard<std::mutex> guard(m_configLock);
+    m_handles.push_back(&handle);
+    handle.Load(*this);
+}
+
 bool Config::IsSet(const std::string& name) const
 {
     auto const nameLower = boost::algorithm::to_lower_copy(name);
@@ -113,3 +123,26 @@ float Config::GetFloatDefault(const std::string& name, float def) const
     return std::stof(value);
 }
 
+
+template <>
+void ConfigHandle<bool>::Load(Config const& config)
+{
+    m_value.store(config.GetBoolDefault(m_name, m_default), std::memory_order_relaxed);
+}
+
+template <>
+void ConfigHandle<int32>::Load(Config const& config)
+{
+    m_value.store(config.GetIntDefault(m_name, m_default), std::memory_order_relaxed);
+}
+
+template <>
+void ConfigHandle<float>::Load(Config const& config)
+{
+    m_value.store(config.GetFloatDefault(m_name, m_default), std::memory_order_relaxed);
+}
+
+void ConfigHandle<std::string>::Load(Config const& config)
+{
+    std::atomic_store(&m_value, std::make_shared<std::string const>(config.GetStringDefault(m_name, m_default)));
+}
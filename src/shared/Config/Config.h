@@ -22,10 +22,58 @@
 #include "Common.h"
 #include "Policies/Singleton.h"
 #include "Platform/Define.h"
+#include <atomic>
+#include <memory>
 #include <mutex>
 
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+class Config;
+
+class ConfigHandleBase
+{
+    public:
+        virtual ~ConfigHandleBase() {}
+        virtual void Load(Config const& config) = 0;
+};
+
+// Typed value of one config entry, parsed when registered and again on every Reload() of its Config.
+// Reading it takes no lock and does no string lookup, so it is meant for values read on live events.
+template <typename T>
+class ConfigHandle : public ConfigHandleBase
+{
+    public:
+        ConfigHandle(std::string const& name, T def) : m_name(name), m_default(def), m_value(def) {}
+
+        T Get() const { return m_value.load(std::memory_order_relaxed); }
+        void Load(Config const& config) override;
+
+    private:
+        std::string m_name;
+        T m_default;
+        std::atomic<T> m_value;
+};
+
+template <> void ConfigHandle<bool>::Load(Config const& config);
+template <> void ConfigHandle<int32>::Load(Config const& config);
+template <> void ConfigHandle<float>::Load(Config const& config);
+
+template <>
+class ConfigHandle<std::string> : public ConfigHandleBase
+{
+    public:
+        ConfigHandle(std::string const& name, std::string const& def) : m_name(name), m_default(def), m_value(std::make_shared<std::string const>(def)) {}
+
+        std::string Get() const { return *std::atomic_load(&m_value); }
+        void Load(Config const& config) override;
+
+    private:
+        std::string m_name;
+        std::string m_default;
+        std::shared_ptr<std::string const> m_value;
+};
 
 class Config
 {
@@ -45,7 +93,14 @@ class Config
         float GetFloatDefault(const std::string& name, float def) const;
 
         const std::string& GetFilename() const { return m_filename; }
+
+        // loads the handle now and on every later Reload(), the handle must outlive the config
+        void Register(ConfigHandleBase& handle);
+
         std::mutex m_configLock;
+
+    private:
+        std::vector<ConfigHandleBase*> m_handles;
 };
 
 #define sConfig MaNGOS::Singleton<Config>::Instance()
@@ -22,16 +22,47 @@
 
 #include "DBCFileLoader.h"
 
+// magic, record count, field count, record size, string size
+#define DBC_HEADER_SIZE (5 * sizeof(uint32))
+
+bool DBCFileLoader::useMemoryMapping = false;
+
 DBCFileLoader::DBCFileLoader()
 {
     data = nullptr;
     fieldsOffset = nullptr;
 }
 
-bool DBCFileLoader::Load(const char* filename, const char* fmt)
+bool DBCFileLoader::Load(const char* filename, const char* fmt, bool mapped)
+{
+    if (!mapping)
+        delete[] data;
+    data = nullptr;
+    mapping.reset();
+    delete[] fieldsOffset;
+    fieldsOffset = nullptr;
+
+    if (!(mapped ? ReadMapped(filename) : ReadFile(filename)))
+        return false;
+
+    fieldsOffset = new uint32[fieldCount];
+    fieldsOffset[0] = 0;
+    for (uint32 i = 1; i < fieldCount; ++i)
+    {
+        fieldsOffset[i] = fieldsOffset[i - 1];
+        if (fmt[i - 1] == 'b' || fmt[i - 1] == 'X')         // byte fields
+            fieldsOffset[i] += 1;
+        else                                                // 4 byte fields (int32/float/strings)
+            fieldsOffset[i] += 4;
+    }
+
+    stringTable = data + recordSize * recordCount;
+    return true;
+}
+
+bool DBCFileLoader::ReadFile(const char* filename)
 {
     uint32 header;
-    delete[] data;
 
     FILE* f = fopen(filename, "rb");
     if (!f)
@@ -84,19 +115,7 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
 
     EndianConvert(stringSize);
 
-    fieldsOffset = new uint32[fieldCount];
-    fieldsOffset[0] = 0;
-    for (uint32 i = 1; i < fieldCount; ++i)
-    {
-        fieldsOffset[i] = fieldsOffset[i - 1];
-        if (fmt[i - 1] == 'b' || fmt[i - 1] == 'X')         // byte fields
-            fieldsOffset[i] += 1;
-        else                                                // 4 byte fields (int32/float/strings)
-            fieldsOffset[i] += 4;
-    }
-
     data = new unsigned char[recordSize * recordCount + stringSize];
-    stringTable = data + recordSize * recordCount;
 
     if (fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
     {
@@ -108,9 +127,37 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
     return true;
 }
 
+bool DBCFileLoader::ReadMapped(const char* filename)
+{
+    std::unique_ptr<MappedFile> fileMapping(MappedFile::Open(filename));
+    if (!fileMapping || fileMapping->GetSize() < DBC_HEADER_SIZE)
+        return false;
+
+    uint32 fileHeader[5];
+    memcpy(fileHeader, fileMapping->GetData(), sizeof(fileHeader));
+    for (uint32& value : fileHeader)
+        EndianConvert(value);
+
+    if (fileHeader[0] != 0x43424457)                        //'WDBC'
+        return false;
+
+    recordCount = fileHeader[1];
+    fieldCount = fileHeader[2];
+    recordSize = fileHeader[3];
+    stringSize = fileHeader[4];
+
+    if (fileMapping->GetSize() < DBC_HEADER_SIZE + size_t(recordSize) * recordCount + stringSize)
+        return false;
+
+    data = fileMapping->GetData() + DBC_HEADER_SIZE;
+    mapping = std::move(fileMapping);
+    return true;
+}
+
 DBCFileLoader::~DBCFileLoader()
 {
-    delete[] data;
+    if (!mapping)
+        delete[] data;
     delete[] fieldsOffset;
 }
 
@@ -165,34 +212,34 @@ uint32 DBCFileLoader::GetFormatRecordSize(const char* format, int32* index_pos)
     return recordsize;
 }
 
-char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**& indexTable)
+bool DBCFileLoader::CanIndexInPlace(const char* format) const
 {
-    /*
-    format STRING, NA, FLOAT,NA,INT <=>
-    struct{
-    char* field0,
-    float field1,
-    int field2
-    }entry;
-
-    this func will generate  entry[rows] data;
-    */
+#if MANGOS_ENDIAN == MANGOS_BIG_ENDIAN
+    return false;
+#else
+    if (!mapping || strlen(format) != fieldCount)
+        return false;
 
-    typedef char* ptr;
-    if (strlen(format) != fieldCount)
-        return nullptr;
+    // only 4 byte numeric fields keep the same layout in file and structure, strings are offsets in the file
+    for (uint32 x = 0; format[x]; ++x)
+        if (format[x] != FT_INT && format[x] != FT_FLOAT && format[x] != FT_IND)
+            return false;
 
-    // get struct size and index pos
-    int32 i;
-    uint32 recordsize = GetFormatRecordSize(format, &i);
+    return GetFormatRecordSize(format) == recordSize;
+#endif
+}
 
-    if (i >= 0)
+char** DBCFileLoader::AllocateIndexTable(int32 indexPos, uint32& records)
+{
+    typedef char* ptr;
+    ptr* indexTable;
+    if (indexPos >= 0)
     {
         uint32 maxi = 0;
         // find max index
         for (uint32 y = 0; y < recordCount; ++y)
         {
-            uint32 ind = getRecord(y).getUInt(i);
+            uint32 ind = getRecord(y).getUInt(indexPos);
             if (ind > maxi)
                 maxi = ind;
         }
@@ -207,6 +254,51 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
         records = recordCount;
         indexTable = new ptr[recordCount];
     }
+    return indexTable;
+}
+
+char* DBCFileLoader::AutoProduceIndex(const char* format, uint32& records, char**& indexTable)
+{
+    if (!CanIndexInPlace(format))
+        return nullptr;
+
+    int32 i;
+    GetFormatRecordSize(format, &i);
+    indexTable = AllocateIndexTable(i, records);
+
+    for (uint32 y = 0; y < recordCount; ++y)
+    {
+        char* entry = reinterpret_cast<char*>(data + y * recordSize);
+        if (i >= 0)
+            indexTable[getRecord(y).getUInt(i)] = entry;
+        else
+            indexTable[y] = entry;
+    }
+
+    return reinterpret_cast<char*>(data);
+}
+
+char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**& indexTable)
+{
+    /*
+    format STRING, NA, FLOAT,NA,INT <=>
+    struct{
+    char* field0,
+    float field1,
+    int field2
+    }entry;
+
+    this func will generate  entry[rows] data;
+    */
+
+    if (strlen(format) != fieldCount)
+        return nullptr;
+
+    // get struct size and index pos
+    int32 i;
+    uint32 recordsize = GetFormatRecordSize(format, &i);
+
+    indexTable = AllocateIndexTable(i, records);
 
     char* dataTable = new char[recordCount * recordsize];
 
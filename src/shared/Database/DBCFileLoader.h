@@ -20,7 +20,9 @@
 #define DBC_FILE_LOADER_H
 #include "Platform/Define.h"
 #include "Util/ByteConverter.h"
+#include "Util/MappedFile.h"
 #include <cassert>
+#include <memory>
 
 enum FieldFormat
 {
@@ -44,7 +46,8 @@ class DBCFileLoader
         DBCFileLoader();
         ~DBCFileLoader();
 
-        bool Load(const char* filename, const char* fmt);
+        // mapped loads read the file through a MappedFile instead of copying it into a buffer
+        bool Load(const char* filename, const char* fmt, bool mapped = false);
 
         class Record
         {
@@ -93,10 +96,24 @@ class DBCFileLoader
         uint32 GetCols() const { return fieldCount; }
         uint32 GetOffset(size_t id) const { return (fieldsOffset != nullptr && id < fieldCount) ? fieldsOffset[id] : 0; }
         bool IsLoaded() const { return data != nullptr; }
+        bool IsMapped() const { return mapping != nullptr; }
+        // true when format describes the file records byte by byte, so entries can point into the mapping
+        bool CanIndexInPlace(const char* format) const;
+        // builds only the index table, entries point into the mapped records, returns the records start
+        char* AutoProduceIndex(const char* format, uint32& records, char**& indexTable);
+        // the caller takes ownership of the mapping which must outlive the entries in the index table
+        MappedFile* ReleaseMapping() { return mapping.release(); }
         char* AutoProduceData(const char* format, uint32& records, char**& indexTable);
         char* AutoProduceStrings(const char* format, char* dataTable);
         static uint32 GetFormatRecordSize(const char* format, int32* index_pos = nullptr);
+
+        // enables mapped loading in DBCStorage
+        static void SetMemoryMapping(bool enable) { useMemoryMapping = enable; }
+        static bool IsMemoryMappingEnabled() { return useMemoryMapping; }
     private:
+        bool ReadFile(const char* filename);
+        bool ReadMapped(const char* filename);
+        char** AllocateIndexTable(int32 indexPos, uint32& records);
 
         uint32 recordSize;
         uint32 recordCount;
@@ -105,5 +122,8 @@ class DBCFileLoader
         uint32* fieldsOffset;
         unsigned char* data;
         unsigned char* stringTable;
+        std::unique_ptr<MappedFile> mapping;
+
+        static bool useMemoryMapping;
 };
 #endif
@@ -26,7 +26,7 @@ class DBCStorage
 {
         typedef std::list<char*> StringPoolList;
     public:
-        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(nullptr), m_dataTable(nullptr) { }
+        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(nullptr), m_dataTable(nullptr), m_mapping(nullptr) { }
         ~DBCStorage() { Clear(); }
 
         T const* LookupEntry(uint32 id) const { return (id >= nCount) ? nullptr : indexTable[id]; }
@@ -38,11 +38,18 @@ class DBCStorage
         {
             DBCFileLoader dbc;
             // Check if load was sucessful, only then continue
-            if (!dbc.Load(fn, fmt))
+            if (!dbc.Load(fn, fmt, DBCFileLoader::IsMemoryMappingEnabled()))
                 return false;
 
             fieldCount = dbc.GetCols();
 
+            // fixed format entries are used directly from the mapped file, without strings there is nothing to copy
+            if (dbc.AutoProduceIndex(fmt, nCount, (char**&)indexTable))
+            {
+                m_mapping = dbc.ReleaseMapping();
+                return true;
+            }
+
             // load raw non-string data
             m_dataTable = (T*)dbc.AutoProduceData(fmt, nCount, (char**&)indexTable);
 
@@ -59,6 +66,10 @@ class DBCStorage
             if (!indexTable)
                 return false;
 
+            // entries indexed in place have no strings
+            if (m_mapping)
+                return true;
+
             DBCFileLoader dbc;
             // Check if load was successful, only then continue
             if (!dbc.Load(fn, fmt))
@@ -79,6 +90,8 @@ class DBCStorage
             indexTable = nullptr;
             delete[]((char*)m_dataTable);
             m_dataTable = nullptr;
+            delete m_mapping;
+            m_mapping = nullptr;
 
             while (!m_stringPoolList.empty())
             {
@@ -97,6 +110,7 @@ class DBCStorage
         char const* fmt;
         T** indexTable;
         T* m_dataTable;
+        MappedFile* m_mapping;                          // owns the entries instead of m_dataTable when indexed in place
         StringPoolList m_stringPoolList;
 };
 
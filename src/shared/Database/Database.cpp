@@ -91,13 +91,26 @@ bool SqlConnection::ExecuteStmt(int nIndex, const SqlStmtParameters& id)
     return pStmt->execute();
 }
 
+QueryResult* SqlConnection::QueryStmt(int nIndex, const SqlStmtParameters& id)
+{
+    if (nIndex == -1)
+        return nullptr;
+
+    // get prepared statement object
+    SqlPreparedStatement* pStmt = GetStmt(nIndex);
+    // bind parameters
+    pStmt->bind(id);
+    // execute statement and fetch the result set
+    return pStmt->query();
+}
+
 //////////////////////////////////////////////////////////////////////////
 Database::~Database()
 {
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -111,6 +124,12 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
 
     m_pingIntervallms = sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000);
 
+    m_queryProfiler.SetEnabled(sConfig.GetBoolDefault("SQLProfiling", false));
+    m_queryProfiler.SetSlowQueryTime(sConfig.GetIntDefault("SQLSlowQueryTime", 0));
+
+    // kept for connections opened on demand
+    m_infoString = infoString;
+
     // create DB connections
 
     // setup connection pool size
@@ -139,6 +158,19 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
     if (!m_pAsyncConn->Initialize(infoString))
         return false;
 
+    nAsyncConns = std::min(std::max(nAsyncConns, MIN_CONNECTION_POOL_SIZE), MAX_CONNECTION_POOL_SIZE);
+    for (int i = 1; i < nAsyncConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pAsyncWorkerConnections.push_back(pConn);
+    }
+
     m_pResultQueue = new SqlResultQueue;
 
     InitDelayThread();
@@ -155,6 +187,14 @@ void Database::StopServer()
     m_pResultQueue = nullptr;
     m_pAsyncConn = nullptr;
 
+    for (auto& m_pAsyncWorkerConnection : m_pAsyncWorkerConnections)
+        delete m_pAsyncWorkerConnection;
+
+    m_pAsyncWorkerConnections.clear();
+
+    delete m_pStreamConn;
+    m_pStreamConn = nullptr;
+
     for (auto& m_pQueryConnection : m_pQueryConnections)
         delete m_pQueryConnection;
 
@@ -164,7 +204,7 @@ void Database::StopServer()
 SqlDelayThread* Database::CreateDelayThread()
 {
     assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    return new SqlDelayThread(this, m_pAsyncConn, m_pAsyncWorkerConnections);
 }
 
 void Database::InitDelayThread()
@@ -234,11 +274,25 @@ void Database::Ping()
         delete guard->Query(sql);
     }
 
+    for (auto& m_pAsyncWorkerConnection : m_pAsyncWorkerConnections)
+    {
+        SqlConnection::Lock guard(m_pAsyncWorkerConnection);
+        delete guard->Query(sql);
+    }
+
     for (int i = 0; i < m_nQueryConnPoolSize; ++i)
     {
         SqlConnection::Lock guard(m_pQueryConnections[i]);
         delete guard->Query(sql);
     }
+
+    std::lock_guard<std::mutex> streamGuard(m_streamConnGuard);
+    if (m_pStreamConn)
+    {
+        SqlConnection::Lock guard(m_pStreamConn);
+        if (!guard->IsStreaming())
+            delete guard->Query(sql);
+    }
 }
 
 bool Database::PExecuteLog(const char* format, ...)
@@ -302,6 +356,53 @@ QueryResult* Database::PQuery(const char* format, ...)
     return Query(szQuery);
 }
 
+QueryResult* Database::QueryStreamed(const char* sql)
+{
+    SqlConnection* pConn;
+    {
+        std::lock_guard<std::mutex> streamGuard(m_streamConnGuard);
+        if (!m_pStreamConn)
+        {
+            m_pStreamConn = CreateConnection();
+            if (!m_pStreamConn->Initialize(m_infoString.c_str()))
+            {
+                delete m_pStreamConn;
+                m_pStreamConn = nullptr;
+                return Query(sql);
+            }
+        }
+        pConn = m_pStreamConn;
+    }
+
+    {
+        SqlConnection::Lock guard(pConn);
+        if (!guard->IsStreaming())
+            return guard->QueryStreamed(sql);
+    }
+
+    // a streamed result is still open (nested or concurrent load), buffer this one
+    return Query(sql);
+}
+
+QueryResult* Database::PQueryStreamed(const char* format, ...)
+{
+    if (!format) return nullptr;
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return nullptr;
+    }
+
+    return QueryStreamed(szQuery);
+}
+
 QueryNamedResult* Database::PQueryNamed(const char* format, ...)
 {
     if (!format) return nullptr;
@@ -385,7 +486,7 @@ bool Database::DirectPExecute(const char* format, ...)
     return DirectExecute(szQuery);
 }
 
-bool Database::BeginTransaction()
+bool Database::BeginTransaction(uint32 orderingKey /*= 0*/)
 {
     if (!m_pAsyncConn)
         return false;
@@ -393,7 +494,7 @@ bool Database::BeginTransaction()
     MANGOS_ASSERT(!m_currentTransaction.get());   // if we will get a nested transaction request - we MUST fix code!!!
 
     if (!m_currentTransaction.get())
-        m_currentTransaction.reset(new SqlTransaction);
+        m_currentTransaction.reset(new SqlTransaction(orderingKey));
 
     return m_currentTransaction.get() != nullptr;
 }
@@ -578,6 +679,14 @@ bool Database::DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* pa
     return _guard->ExecuteStmt(id.ID(), *params);
 }
 
+QueryResult* Database::QueryStmt(const SqlStatementID& id, SqlStmtParameters* params)
+{
+    MANGOS_ASSERT(params);
+    std::unique_ptr<SqlStmtParameters> p(params);
+    SqlConnection::Lock _guard(getQueryConnection());
+    return _guard->QueryStmt(id.ID(), *params);
+}
+
 SqlStatement Database::CreateStatement(SqlStatementID& index, const char* fmt)
 {
     int nId = -1;
@@ -622,3 +731,79 @@ std::string Database::GetStmtString(const int stmtId) const
 
     return std::string();
 }
+
+int Database::GetBatchedStmtId(const int stmtId, uint32 rows)
+{
+    {
+        LOCK_GUARD _guard(m_stmtGuard);
+        auto itr = m_stmtBatchRegistry.find(stmtId);
+        if (itr != m_stmtBatchRegistry.end())
+        {
+            if (!itr->second.batchable)
+                return -1;
+            if (itr->second.rowStmtIds.size() > rows && itr->second.rowStmtIds[rows] != -1)
+                return itr->second.rowStmtIds[rows];
+        }
+    }
+
+    StmtBatchInfo info;
+    info.batchable = false;
+
+    std::string fmt = GetStmtString(stmtId);
+    while (!fmt.empty() && (isspace(uint8(fmt.back())) || fmt.back() == ';'))
+        fmt.pop_back();
+
+    std::string upper(fmt);
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+
+    // only plain "INSERT/REPLACE ... VALUES (...)" with a single value tuple at the end can be merged
+    size_t const valuesPos = upper.rfind("VALUES");
+    size_t const tuplePos = valuesPos == std::string::npos ? std::string::npos : upper.find('(', valuesPos);
+    if ((upper.compare(0, 6, "INSERT") == 0 || upper.compare(0, 7, "REPLACE") == 0) &&
+            upper.find("SELECT") == std::string::npos && upper.find("ON DUPLICATE") == std::string::npos &&
+            tuplePos != std::string::npos && upper.find_first_not_of(' ', valuesPos + 6) == tuplePos)
+    {
+        int depth = 0;
+        size_t closePos = std::string::npos;
+        for (size_t i = tuplePos; i < upper.size() && closePos == std::string::npos; ++i)
+        {
+            if (upper[i] == '(')
+                ++depth;
+            else if (upper[i] == ')' && --depth == 0)
+                closePos = i;
+        }
+
+        if (closePos == upper.size() - 1)
+        {
+            info.batchable = true;
+            info.prefix = fmt.substr(0, tuplePos);
+            info.tuple = fmt.substr(tuplePos);
+        }
+    }
+
+    LOCK_GUARD _guard(m_stmtGuard);
+    StmtBatchInfo& batchInfo = m_stmtBatchRegistry.emplace(stmtId, std::move(info)).first->second;
+    if (!batchInfo.batchable)
+        return -1;
+
+    if (batchInfo.rowStmtIds.size() <= rows)
+        batchInfo.rowStmtIds.resize(rows + 1, -1);
+
+    if (batchInfo.rowStmtIds[rows] == -1)
+    {
+        std::string szFmt = batchInfo.prefix + batchInfo.tuple;
+        for (uint32 i = 1; i < rows; ++i)
+            szFmt.append(", ").append(batchInfo.tuple);
+
+        PreparedStmtRegistry::const_iterator iter = m_stmtRegistry.find(szFmt);
+        if (iter == m_stmtRegistry.end())
+        {
+            batchInfo.rowStmtIds[rows] = ++m_iStmtIndex;
+            m_stmtRegistry[szFmt] = m_iStmtIndex;
+        }
+        else
+            batchInfo.rowStmtIds[rows] = iter->second;
+    }
+
+    return batchInfo.rowStmtIds[rows];
+}
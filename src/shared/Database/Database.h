@@ -24,9 +24,11 @@
 #include "Database/SqlDelayThread.h"
 #include "Policies/ThreadingModel.h"
 #include "SqlPreparedStatement.h"
+#include "SqlQueryProfiler.h"
 
 #include <boost/thread/tss.hpp>
 #include <atomic>
+#include <chrono>
 
 class SqlTransaction;
 class SqlResultQueue;
@@ -48,6 +50,11 @@ class SqlConnection
         // public methods for making queries
         virtual QueryResult* Query(const char* sql) = 0;
         virtual QueryNamedResult* QueryNamed(const char* sql) = 0;
+        // unbuffered query, rows are read from the server while the caller iterates. Nothing else may run on
+        // the connection until the result is exhausted or deleted. Connections without support buffer the result
+        virtual QueryResult* QueryStreamed(const char* sql) { return Query(sql); }
+        // true while an unbuffered result still reads from this connection
+        bool IsStreaming() const { return m_streaming; }
 
         // public methods for making requests
         virtual bool Execute(const char* sql) = 0;
@@ -63,6 +70,7 @@ class SqlConnection
 
         // methods to work with prepared statements
         bool ExecuteStmt(int nIndex, const SqlStmtParameters& id);
+        QueryResult* QueryStmt(int nIndex, const SqlStmtParameters& id);
 
         // SqlConnection object lock
         class Lock
@@ -80,8 +88,14 @@ class SqlConnection
         // get DB object
         Database& DB() const { return m_db; }
 
+        // microseconds since startTime, for the query profiler
+        static uint64 GetElapsedTime(std::chrono::steady_clock::time_point startTime)
+        {
+            return uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+        }
+
     protected:
-        SqlConnection(Database& db) : m_db(db) {}
+        SqlConnection(Database& db) : m_db(db), m_streaming(false) {}
 
         virtual SqlPreparedStatement* CreateStatement(const std::string& fmt);
         // allocate prepared statement and return statement ID
@@ -92,6 +106,8 @@ class SqlConnection
         // free prepared statements objects
         void FreePreparedStatements();
 
+        std::atomic<bool> m_streaming;
+
     private:
         std::recursive_mutex m_mutex;
 
@@ -104,7 +120,7 @@ class Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
         // start worker thread for async DB request execution
         virtual void InitDelayThread();
         // stop worker thread
@@ -126,6 +142,11 @@ class Database
         QueryResult* PQuery(const char* format, ...) ATTR_PRINTF(2, 3);
         QueryNamedResult* PQueryNamed(const char* format, ...) ATTR_PRINTF(2, 3);
 
+        // for big startup loads: rows are streamed from the server while being processed instead of buffered first.
+        // Runs on a dedicated connection, GetRowCount() of the result is 0 when streaming
+        QueryResult* QueryStreamed(const char* sql);
+        QueryResult* PQueryStreamed(const char* format, ...) ATTR_PRINTF(2, 3);
+
         bool DirectExecute(const char* sql) const
         {
             if (!m_pAsyncConn)
@@ -183,7 +204,8 @@ class Database
         // Writes SQL commands to a LOG file (see mangosd.conf "LogSQL")
         bool PExecuteLog(const char* format, ...) ATTR_PRINTF(2, 3);
 
-        bool BeginTransaction();
+        // transactions with the same non zero ordering key keep their order, different keys may be committed in parallel
+        bool BeginTransaction(uint32 orderingKey = 0);
         bool CommitTransaction();
         bool RollbackTransaction();
         // for sync transaction execution
@@ -195,6 +217,8 @@ class Database
         SqlStatement CreateStatement(SqlStatementID& index, const char* fmt);
         // get prepared statement format string
         std::string GetStmtString(const int stmtId) const;
+        // get statement inserting 'rows' value tuples of single row INSERT/REPLACE statement 'stmtId', -1 if it can't be batched
+        int GetBatchedStmtId(const int stmtId, uint32 rows);
 
         operator bool () const { return !m_pQueryConnections.empty() && m_pAsyncConn; }
 
@@ -212,6 +236,13 @@ class Database
         bool CheckRequiredField(char const* table_name, char const* required_name);
         uint32 GetPingIntervall() const { return m_pingIntervallms; }
 
+        // per statement latency statistics, see SQLProfiling in mangosd.conf
+        SqlQueryProfiler& GetQueryProfiler() { return m_queryProfiler; }
+
+        // async queue statistics
+        uint32 GetAsyncQueueSize() const { return m_threadBody ? m_threadBody->GetQueueSize() : 0; }
+        uint32 ConsumeAsyncMaxWaitTime() { return m_threadBody ? m_threadBody->ConsumeMaxWaitTime() : 0; }
+
         // function to ping database connections
         void Ping();
 
@@ -222,7 +253,7 @@ class Database
 
     protected:
         Database() :
-            m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pResultQueue(nullptr),
+            m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pStreamConn(nullptr), m_pResultQueue(nullptr),
             m_threadBody(nullptr), m_delayThread(nullptr), m_allowAsyncTransactions(false),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
         {
@@ -251,6 +282,8 @@ class Database
         // query function for prepared statements
         bool ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
         bool DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
+        // synchronous prepared SELECT on the query connection pool
+        QueryResult* QueryStmt(const SqlStatementID& id, SqlStmtParameters* params);
 
         // connection helper counters
         int m_nQueryConnPoolSize;                           // current size of query connection pool
@@ -260,8 +293,15 @@ class Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        // only one single DB connection for transactions
+        // main DB connection for transactions, the only one used for unkeyed requests
         SqlConnection* m_pAsyncConn;
+        // extra connections for transactions with an ordering key
+        SqlConnectionContainer m_pAsyncWorkerConnections;
+
+        // connection for unbuffered queries, opened on first use
+        SqlConnection* m_pStreamConn;
+        std::mutex m_streamConnGuard;
+        std::string m_infoString;
 
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
         SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
@@ -280,6 +320,18 @@ class Database
 
         int m_iStmtIndex;
 
+        // multi row variants of single row insert statements
+        struct StmtBatchInfo
+        {
+            bool batchable;
+            std::string prefix;                             // statement up to the value tuple
+            std::string tuple;                              // "(?, ?, ...)"
+            std::vector<int> rowStmtIds;                    // statement id per row count, -1 if not registered yet
+        };
+        std::unordered_map<int, StmtBatchInfo> m_stmtBatchRegistry;
+
+        SqlQueryProfiler m_queryProfiler;
+
     private:
 
         bool m_logSQL;
@@ -178,6 +178,7 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
         return false;
 
     uint32 _s = WorldTimer::getMSTime();
+    auto const startTime = std::chrono::steady_clock::now();
 
     if (mysql_query(mMysql, sql))
     {
@@ -191,6 +192,8 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
     *pRowCount = mysql_affected_rows(mMysql);
     *pFieldCount = mysql_field_count(mMysql);
 
+    m_db.GetQueryProfiler().Record(sql, false, GetElapsedTime(startTime), *pResult ? *pRowCount : 0);
+
     if (!*pResult)
         return false;
 
@@ -240,6 +243,39 @@ QueryNamedResult* MySQLConnection::QueryNamed(const char* sql)
     return new QueryNamedResult(queryResult, names);
 }
 
+QueryResult* MySQLConnection::QueryStreamed(const char* sql)
+{
+    if (!mMysql)
+        return nullptr;
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    if (mysql_query(mMysql, sql))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_error(mMysql));
+        return nullptr;
+    }
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+
+    // rows stay on the server side until fetched
+    MYSQL_RES* result = mysql_use_result(mMysql);
+    if (!result)
+        return nullptr;
+
+    m_streaming = true;
+    QueryResultMysqlStreamed* queryResult = new QueryResultMysqlStreamed(mMysql, result, mysql_fetch_fields(result), mysql_field_count(mMysql), m_streaming);
+
+    // keep the empty result convention of Query()
+    if (!queryResult->NextRow())
+    {
+        delete queryResult;
+        return nullptr;
+    }
+
+    return queryResult;
+}
+
 bool MySQLConnection::Execute(const char* sql)
 {
     if (!mMysql)
@@ -247,6 +283,7 @@ bool MySQLConnection::Execute(const char* sql)
 
     {
         uint32 _s = WorldTimer::getMSTime();
+        auto const startTime = std::chrono::steady_clock::now();
 
         if (mysql_query(mMysql, sql))
         {
@@ -255,6 +292,7 @@ bool MySQLConnection::Execute(const char* sql)
             return false;
         }
         DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+        m_db.GetQueryProfiler().Record(sql, false, GetElapsedTime(startTime), mysql_affected_rows(mMysql));
         // end guarded block
     }
 
@@ -446,11 +484,8 @@ void MySqlPreparedStatement::RemoveBinds()
     m_bPrepared = false;
 }
 
-bool MySqlPreparedStatement::execute()
+bool MySqlPreparedStatement::executeStmt()
 {
-    if (!isPrepared())
-        return false;
-
     if (mysql_stmt_execute(m_stmt))
     {
         sLog.outError("SQL: cannot execute '%s'", m_szFmt.c_str());
@@ -461,6 +496,48 @@ bool MySqlPreparedStatement::execute()
     return true;
 }
 
+bool MySqlPreparedStatement::execute()
+{
+    if (!isPrepared())
+        return false;
+
+    auto const startTime = std::chrono::steady_clock::now();
+    if (!executeStmt())
+        return false;
+
+    m_pConn.DB().GetQueryProfiler().Record(m_szFmt.c_str(), true, SqlConnection::GetElapsedTime(startTime), mysql_stmt_affected_rows(m_stmt));
+    return true;
+}
+
+QueryResult* MySqlPreparedStatement::query()
+{
+    if (!isQuery())
+        return nullptr;
+
+    auto const startTime = std::chrono::steady_clock::now();
+    if (!executeStmt())
+        return nullptr;
+
+    if (mysql_stmt_store_result(m_stmt))
+    {
+        sLog.outError("SQL: cannot store result of '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        return nullptr;
+    }
+
+    QueryResultMysqlStmt* queryResult = nullptr;
+    uint64 const rowCount = mysql_stmt_num_rows(m_stmt);
+    if (rowCount)
+    {
+        queryResult = new QueryResultMysqlStmt(m_stmt, mysql_fetch_fields(m_pResultMetadata), rowCount, m_nColumns);
+        queryResult->NextRow();
+    }
+
+    mysql_stmt_free_result(m_stmt);
+    m_pConn.DB().GetQueryProfiler().Record(m_szFmt.c_str(), true, SqlConnection::GetElapsedTime(startTime), rowCount);
+    return queryResult;
+}
+
 enum_field_types MySqlPreparedStatement::ToMySQLType(const SqlStmtFieldData& data, bool& bUnsigned)
 {
     bUnsigned = 0;
@@ -42,6 +42,8 @@ class MySqlPreparedStatement : public SqlPreparedStatement
 
         // execute DML statement
         virtual bool execute() override;
+        // execute SELECT, rows are fetched through the binary protocol
+        virtual QueryResult* query() override;
 
     protected:
         // bind parameters
@@ -51,6 +53,7 @@ class MySqlPreparedStatement : public SqlPreparedStatement
 
     private:
         void RemoveBinds();
+        bool executeStmt();
 
         MYSQL* m_pMySQLConn;
         MYSQL_STMT* m_stmt;
@@ -71,6 +74,7 @@ class MySQLConnection : public SqlConnection
 
         QueryResult* Query(const char* sql) override;
         QueryNamedResult* QueryNamed(const char* sql) override;
+        QueryResult* QueryStreamed(const char* sql) override;
         bool Execute(const char* sql) override;
 
         unsigned long escape_string(char* to, const char* from, unsigned long length);
@@ -102,6 +102,7 @@ bool PostgreSQLConnection::_Query(const char* sql, PGresult** pResult, uint64* p
         return false;
 
     uint32 _s = WorldTimer::getMSTime();
+    auto const startTime = std::chrono::steady_clock::now();
     // Send the query
     *pResult = PQexec(mPGconn, sql);
     if (!*pResult)
@@ -121,6 +122,7 @@ bool PostgreSQLConnection::_Query(const char* sql, PGresult** pResult, uint64* p
 
     *pRowCount = PQntuples(*pResult);
     *pFieldCount = PQnfields(*pResult);
+    m_db.GetQueryProfiler().Record(sql, false, GetElapsedTime(startTime), *pRowCount);
     // end guarded block
 
     if (!*pRowCount)
@@ -178,6 +180,7 @@ bool PostgreSQLConnection::Execute(const char* sql)
         return false;
 
     uint32 _s = WorldTimer::getMSTime();
+    auto const startTime = std::chrono::steady_clock::now();
 
     PGresult* res = PQexec(mPGconn, sql);
     if (PQresultStatus(res) != PGRES_COMMAND_OK)
@@ -191,6 +194,8 @@ bool PostgreSQLConnection::Execute(const char* sql)
         DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
     }
 
+    m_db.GetQueryProfiler().Record(sql, false, GetElapsedTime(startTime), strtoull(PQcmdTuples(res), nullptr, 10));
+
     PQclear(res);
     return true;
 }
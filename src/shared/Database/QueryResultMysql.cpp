@@ -21,6 +21,10 @@
 #include "DatabaseEnv.h"
 #include "Util/Errors.h"
 
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
 QueryResultMysql::QueryResultMysql(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount) :
     QueryResult(rowCount, fieldCount), mResult(result)
 {
@@ -66,7 +70,58 @@ void QueryResultMysql::EndQuery()
     }
 }
 
-enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType) const
+QueryResultMysqlStreamed::QueryResultMysqlStreamed(MYSQL* mysql, MYSQL_RES* result, MYSQL_FIELD* fields, uint32 fieldCount, std::atomic<bool>& streaming) :
+    QueryResult(0, fieldCount), mMysql(mysql), mResult(result), mStreaming(streaming)
+{
+    mCurrentRow = new Field[mFieldCount];
+    MANGOS_ASSERT(mCurrentRow);
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+        mCurrentRow[i].SetType(QueryResultMysql::ConvertNativeType(fields[i].type));
+}
+
+QueryResultMysqlStreamed::~QueryResultMysqlStreamed()
+{
+    EndQuery();
+}
+
+bool QueryResultMysqlStreamed::NextRow()
+{
+    if (!mResult)
+        return false;
+
+    MYSQL_ROW row = mysql_fetch_row(mResult);
+    if (!row)
+    {
+        // end of rows and a broken transfer look the same here
+        if (mysql_errno(mMysql))
+            sLog.outErrorDb("streamed query ERROR: %s", mysql_error(mMysql));
+
+        EndQuery();
+        return false;
+    }
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+        mCurrentRow[i].SetValue(row[i]);
+
+    return true;
+}
+
+void QueryResultMysqlStreamed::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = nullptr;
+
+    if (mResult)
+    {
+        // drains rows not fetched yet so the connection is usable again
+        mysql_free_result(mResult);
+        mResult = nullptr;
+        mStreaming = false;
+    }
+}
+
+enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType)
 {
     switch (mysqlType)
     {
@@ -96,4 +151,79 @@ enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysql
             return Field::DB_TYPE_UNKNOWN;
     }
 }
+
+QueryResultMysqlStmt::QueryResultMysqlStmt(MYSQL_STMT* stmt, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount) :
+    QueryResult(rowCount, fieldCount), mNextRow(0)
+{
+    typedef std::remove_pointer<decltype(MYSQL_BIND::is_null)>::type NullFlag;
+
+    std::vector<MYSQL_BIND> binds(mFieldCount);
+    std::vector<unsigned long> lengths(mFieldCount);
+    std::unique_ptr<NullFlag[]> nulls(new NullFlag[mFieldCount]);
+    memset(binds.data(), 0, sizeof(MYSQL_BIND) * mFieldCount);
+
+    // fetch lengths only, values are read per column into their final place afterwards
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        binds[i].buffer_type = MYSQL_TYPE_STRING;
+        binds[i].length = &lengths[i];
+        binds[i].is_null = &nulls[i];
+    }
+
+    mOffsets.reserve(mRowCount * mFieldCount);
+    if (!mysql_stmt_bind_result(stmt, binds.data()))
+    {
+        while (true)
+        {
+            int const fetchResult = mysql_stmt_fetch(stmt);
+            if (fetchResult != 0 && fetchResult != MYSQL_DATA_TRUNCATED)
+                break;
+
+            for (uint32 i = 0; i < mFieldCount; ++i)
+            {
+                if (nulls[i])
+                {
+                    mOffsets.push_back(NULL_OFFSET);
+                    continue;
+                }
+
+                size_t const offset = mData.size();
+                mOffsets.push_back(offset);
+                mData.resize(offset + lengths[i] + 1, '\0');
+                if (lengths[i])
+                {
+                    MYSQL_BIND column;
+                    memset(&column, 0, sizeof(MYSQL_BIND));
+                    column.buffer_type = MYSQL_TYPE_STRING;
+                    column.buffer = &mData[offset];
+                    column.buffer_length = lengths[i];
+                    mysql_stmt_fetch_column(stmt, &column, i, 0);
+                }
+            }
+        }
+    }
+    mRowCount = mOffsets.size() / std::max(mFieldCount, 1u);
+
+    mCurrentRow = new Field[mFieldCount];
+    for (uint32 i = 0; i < mFieldCount; ++i)
+        mCurrentRow[i].SetType(QueryResultMysql::ConvertNativeType(fields[i].type));
+}
+
+QueryResultMysqlStmt::~QueryResultMysqlStmt()
+{
+    delete[] mCurrentRow;
+}
+
+bool QueryResultMysqlStmt::NextRow()
+{
+    if (mNextRow >= mRowCount)
+        return false;
+
+    size_t const* offsets = &mOffsets[mNextRow * mFieldCount];
+    for (uint32 i = 0; i < mFieldCount; ++i)
+        mCurrentRow[i].SetValue(offsets[i] == NULL_OFFSET ? nullptr : &mData[offsets[i]]);
+
+    ++mNextRow;
+    return true;
+}
 #endif
@@ -28,6 +28,8 @@
 #endif
 
 #include <mysql.h>
+#include <atomic>
+#include <vector>
 
 class QueryResultMysql : public QueryResult
 {
@@ -38,11 +40,50 @@ class QueryResultMysql : public QueryResult
 
         bool NextRow() override;
 
+        static enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType);
+
+    private:
+        void EndQuery();
+
+        MYSQL_RES* mResult;
+};
+
+// result of a server side prepared statement, rows are copied out of the statement on construction
+// so the statement can be reused by the connection right away
+class QueryResultMysqlStmt : public QueryResult
+{
+    public:
+        QueryResultMysqlStmt(MYSQL_STMT* stmt, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount);
+
+        ~QueryResultMysqlStmt();
+
+        bool NextRow() override;
+
+    private:
+        std::vector<char> mData;                            // all non NULL values, each NUL terminated
+        std::vector<size_t> mOffsets;                       // per row and column offset into mData, NULL_OFFSET for NULL
+        uint64 mNextRow;
+
+        static size_t const NULL_OFFSET = size_t(-1);
+};
+
+// unbuffered result of mysql_use_result, each NextRow() reads the next row from the server.
+// The row count is unknown while streaming, the connection is marked busy until the result ends
+class QueryResultMysqlStreamed : public QueryResult
+{
+    public:
+        QueryResultMysqlStreamed(MYSQL* mysql, MYSQL_RES* result, MYSQL_FIELD* fields, uint32 fieldCount, std::atomic<bool>& streaming);
+
+        ~QueryResultMysqlStreamed();
+
+        bool NextRow() override;
+
     private:
-        enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
         void EndQuery();
 
+        MYSQL* mMysql;
         MYSQL_RES* mResult;
+        std::atomic<bool>& mStreaming;
 };
 #endif
 #endif
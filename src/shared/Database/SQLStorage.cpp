@@ -18,6 +18,8 @@
 
 #include "SQLStorage.h"
 
+#include <algorithm>
+
 // -----------------------------------  SQLStorageBase  ---------------------------------------- //
 
 SQLStorageBase::SQLStorageBase() :
@@ -213,7 +215,8 @@ void SQLMultiStorage::Load()
 void SQLMultiStorage::Free()
 {
     SQLStorageBase::Free();
-    m_indexMultiMap.clear();
+    m_keys.clear();
+    m_records.clear();
 }
 
 void SQLMultiStorage::prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint32 recordSize)
@@ -221,12 +224,40 @@ void SQLMultiStorage::prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint
     // Clear (possible) old data and old index array
     Free();
 
+    m_keys.reserve(recordCount);
+    m_records.reserve(recordCount);
+
     SQLStorageBase::prepareToLoad(maxRecordId, recordCount, recordSize);
 }
 
+void SQLMultiStorage::JustFinishedLoading()
+{
+    // stable, records of one key stay in load order like they did in the multimap
+    std::vector<uint32> order(m_keys.size());
+    for (uint32 i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](uint32 left, uint32 right) { return m_keys[left] < m_keys[right]; });
+
+    RecordKeys keys(m_keys.size());
+    RecordPointers records(m_records.size());
+    for (uint32 i = 0; i < order.size(); ++i)
+    {
+        keys[i] = m_keys[order[i]];
+        records[i] = m_records[order[i]];
+    }
+
+    m_keys.swap(keys);
+    m_records.swap(records);
+}
+
 void SQLMultiStorage::EraseEntry(uint32 id)
 {
-    m_indexMultiMap.erase(id);
+    // only done while checking loaded data, lookups stay a plain binary search
+    std::pair<RecordKeys::iterator, RecordKeys::iterator> range = std::equal_range(m_keys.begin(), m_keys.end(), id);
+    size_t const first = range.first - m_keys.begin();
+    size_t const last = range.second - m_keys.begin();
+    m_keys.erase(range.first, range.second);
+    m_records.erase(m_records.begin() + first, m_records.begin() + last);
 }
 
 SQLMultiStorage::SQLMultiStorage(const char* fmt, const char* _entry_field, const char* sqlname)
@@ -23,6 +23,8 @@
 #include "Database/DatabaseEnv.h"
 #include "DBCFileLoader.h"
 
+#include <algorithm>
+
 class SQLStorageBase
 {
         template<class DerivedLoader, class StorageClass> friend class SQLStorageLoaderBase;
@@ -76,6 +78,8 @@ class SQLStorageBase
 
         virtual void prepareToLoad(uint32 maxEntry, uint32 recordCount, uint32 recordSize);
         virtual void JustCreatedRecord(uint32 recordId, char* record) = 0;
+        // called once all records of a load are created
+        virtual void JustFinishedLoading() {}
         virtual void Free();
 
     private:
@@ -179,7 +183,10 @@ class SQLMultiStorage : public SQLStorageBase
         template<typename T> friend class SQLMSIteratorBounds;
 
     private:
-        typedef std::multimap<uint32 /*recordId*/, char* /*record*/> RecordMultiMap;
+        // built once after loading: keys sorted ascending (records of one key keep their load order)
+        // and the record of each key at the same position
+        typedef std::vector<uint32 /*recordId*/> RecordKeys;
+        typedef std::vector<char* /*record*/> RecordPointers;
 
     public:
         SQLMultiStorage(const char* fmt, const char* _entry_field, const char* sqlname);
@@ -197,18 +204,19 @@ class SQLMultiStorage : public SQLStorageBase
                 friend class SQLMSIteratorBounds<T>;
 
             public:
-                T const* getValue() const { return reinterpret_cast<T const*>(citerator->second); }
-                uint32 getKey() const { return citerator->first; }
+                T const* getValue() const { return reinterpret_cast<T const*>(*record); }
+                uint32 getKey() const { return *key; }
 
-                void operator ++() { ++citerator; }
+                void operator ++() { ++key; ++record; }
                 T const* operator *() const { return getValue(); }
                 T const* operator ->() const { return getValue(); }
-                bool operator !=(const SQLMultiSIterator& r) const { return citerator != r.citerator; }
-                bool operator ==(const SQLMultiSIterator& r) const { return citerator == r.citerator; }
+                bool operator !=(const SQLMultiSIterator& r) const { return key != r.key; }
+                bool operator ==(const SQLMultiSIterator& r) const { return key == r.key; }
 
             private:
-                SQLMultiSIterator(RecordMultiMap::const_iterator _itr) : citerator(_itr) {}
-                RecordMultiMap::const_iterator citerator;
+                SQLMultiSIterator(uint32 const* _key, char* const* _record) : key(_key), record(_record) {}
+                uint32 const* key;
+                char* const* record;
         };
 
         template<typename T>
@@ -221,11 +229,18 @@ class SQLMultiStorage : public SQLStorageBase
                 const SQLMultiSIterator<T> second;
 
             private:
-                SQLMSIteratorBounds(std::pair<RecordMultiMap::const_iterator, RecordMultiMap::const_iterator> pair) : first(pair.first), second(pair.second) {}
+                SQLMSIteratorBounds(SQLMultiSIterator<T> const& _first, SQLMultiSIterator<T> const& _second) : first(_first), second(_second) {}
         };
 
         template<typename T>
-        SQLMSIteratorBounds<T> getBounds(uint32 key) const { return SQLMSIteratorBounds<T>(m_indexMultiMap.equal_range(key)); }
+        SQLMSIteratorBounds<T> getBounds(uint32 key) const
+        {
+            std::pair<RecordKeys::const_iterator, RecordKeys::const_iterator> range = std::equal_range(m_keys.begin(), m_keys.end(), key);
+            size_t const first = range.first - m_keys.begin();
+            size_t const second = range.second - m_keys.begin();
+            return SQLMSIteratorBounds<T>(SQLMultiSIterator<T>(m_keys.data() + first, m_records.data() + first),
+                                          SQLMultiSIterator<T>(m_keys.data() + second, m_records.data() + second));
+        }
 
         void Load();
 
@@ -235,13 +250,16 @@ class SQLMultiStorage : public SQLStorageBase
         void prepareToLoad(uint32 maxRecordId, uint32 recordCount, uint32 recordSize) override;
         void JustCreatedRecord(uint32 recordId, char* record) override
         {
-            m_indexMultiMap.insert(RecordMultiMap::value_type(recordId, record));
+            m_keys.push_back(recordId);
+            m_records.push_back(record);
         }
+        void JustFinishedLoading() override;
 
         void Free() override;
 
     private:
-        RecordMultiMap m_indexMultiMap;
+        RecordKeys m_keys;
+        RecordPointers m_records;
 };
 
 template <class DerivedLoader, class StorageClass>
@@ -274,6 +292,17 @@ class SQLStorageLoaderBase
         void storeValue(V value, StorageClass& store, char* p, uint32 x, uint32& offset);
         void storeValue(char const* value, StorageClass& store, char* p, uint32 x, uint32& offset);
 
+        static uint32 GetDstFieldSize(char format);
+
+        // binary snapshot of the loaded records, used instead of the SQL table while the table checksum matches
+        bool GetSnapshotKey(StorageClass const& store, std::string& path, uint64& checksum) const;
+        bool LoadSnapshot(StorageClass& store, std::string const& path, uint64 checksum);
+        void SaveSnapshot(StorageClass const& store, std::string const& path, uint64 checksum) const;
+
+        std::vector<uint32> m_snapshotIds;                  // record id per record, in load order
+        std::vector<std::string> m_snapshotStrings;         // string source fields of all records, in load order
+        std::vector<bool> m_snapshotNullStrings;
+
         // trap, no body
         void storeValue(char* value, StorageClass& store, char* record, uint32 field_pos, uint32& offset);
 };
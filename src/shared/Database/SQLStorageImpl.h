@@ -22,6 +22,13 @@
 #include "Util/ProgressBar.h"
 #include "Log.h"
 #include "DBCFileLoader.h"
+#include "Config/Config.h"
+
+#include <cstdio>
+#include <memory>
+
+#define SQL_STORAGE_SNAPSHOT_MAGIC      0x534C5153          // "SQLS"
+#define SQL_STORAGE_SNAPSHOT_VERSION    1
 
 template<class DerivedLoader, class StorageClass>
 template<class S, class D>                                  // S source-type, D destination-type
@@ -302,9 +309,245 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::storeValue(char const* v
     }
 }
 
+template<class DerivedLoader, class StorageClass>
+uint32 SQLStorageLoaderBase<DerivedLoader, StorageClass>::GetDstFieldSize(char format)
+{
+    switch (format)
+    {
+        case FT_LOGIC:
+            return sizeof(bool);
+        case FT_BYTE:
+        case FT_NA_BYTE:
+            return sizeof(char);
+        case FT_INT:
+        case FT_NA:
+            return sizeof(uint32);
+        case FT_FLOAT:
+        case FT_NA_FLOAT:
+            return sizeof(float);
+        case FT_STRING:
+        case FT_NA_POINTER:
+            return sizeof(char*);
+        case FT_64BITINT:
+            return sizeof(uint64);
+        case FT_IND:
+        case FT_SORT:
+            assert(false && "SQL storage not have sort field types");
+            break;
+        default:
+            assert(false && "unknown format character");
+            break;
+    }
+    return 0;
+}
+
+template<class DerivedLoader, class StorageClass>
+bool SQLStorageLoaderBase<DerivedLoader, StorageClass>::GetSnapshotKey(StorageClass const& store, std::string& path, uint64& checksum) const
+{
+#ifdef DO_POSTGRESQL
+    return false;
+#else
+    std::string dir = sConfig.GetStringDefault("SnapshotDir");
+    if (dir.empty())
+        return false;
+
+    // computed by the server without sending the rows
+    QueryResult* result = WorldDatabase.PQuery("CHECKSUM TABLE %s", store.GetTableName());
+    if (!result)
+        return false;
+
+    Field* fields = result->Fetch();
+    bool const valid = !fields[1].IsNULL();
+    checksum = fields[1].GetUInt64();
+    delete result;
+
+    if (!valid)
+        return false;
+
+    if (dir.at(dir.length() - 1) != '/' && dir.at(dir.length() - 1) != '\\')
+        dir.append("/");
+
+    path = dir + store.GetTableName() + ".snapshot";
+    return true;
+#endif
+}
+
+template<class DerivedLoader, class StorageClass>
+bool SQLStorageLoaderBase<DerivedLoader, StorageClass>::LoadSnapshot(StorageClass& store, std::string const& path, uint64 checksum)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    std::unique_ptr<FILE, int(*)(FILE*)> fileGuard(file, &fclose);
+
+    auto readValue = [file](auto& value) { return fread(&value, sizeof(value), 1, file) == 1; };
+    auto readFormat = [&](char const* format)
+    {
+        uint32 length;
+        if (!readValue(length) || length != strlen(format))
+            return false;
+        std::string stored(length, '\0');
+        return fread(&stored[0], 1, length, file) == length && stored == format;
+    };
+
+    uint32 header, version, maxRecordId, recordCount, recordSize;
+    uint64 storedChecksum;
+    if (!readValue(header) || header != SQL_STORAGE_SNAPSHOT_MAGIC || !readValue(version) || version != SQL_STORAGE_SNAPSHOT_VERSION)
+        return false;
+    if (!readValue(storedChecksum) || storedChecksum != checksum)
+        return false;
+    if (!readFormat(store.GetSrcFormat()) || !readFormat(store.GetDstFormat()))
+        return false;
+    if (!readValue(maxRecordId) || !readValue(recordCount) || !readValue(recordSize) || !recordCount)
+        return false;
+
+    uint32 expectedSize = 0;
+    for (uint32 x = 0; x < store.GetDstFieldCount(); ++x)
+        expectedSize += GetDstFieldSize(store.GetDstFormat(x));
+    if (recordSize != expectedSize)
+        return false;
+
+    std::vector<uint32> ids(recordCount);
+    std::vector<char> data(size_t(recordCount) * recordSize);
+    if (fread(ids.data(), sizeof(uint32), recordCount, file) != recordCount || fread(data.data(), 1, data.size(), file) != data.size())
+        return false;
+
+    uint32 stringCount;
+    if (!readValue(stringCount))
+        return false;
+
+    std::vector<std::string> strings(stringCount);
+    std::vector<bool> nullStrings(stringCount);
+    for (uint32 i = 0; i < stringCount; ++i)
+    {
+        uint32 length;
+        if (!readValue(length))
+            return false;
+        if (length == uint32(-1))
+        {
+            nullStrings[i] = true;
+            continue;
+        }
+        strings[i].resize(length);
+        if (length && fread(&strings[i][0], 1, length, file) != length)
+            return false;
+    }
+
+    // everything is read and consistent, only now touch the storage
+    store.prepareToLoad(maxRecordId, recordCount, recordSize);
+
+    uint32 stringIndex = 0;
+    for (uint32 i = 0; i < recordCount; ++i)
+    {
+        char* record = store.createRecord(ids[i]);
+        memcpy(record, &data[size_t(i) * recordSize], recordSize);
+
+        // plain values are final, pointers and values converted from strings are rebuilt the way the SQL load does
+        uint32 offset = 0;
+        for (uint32 x = 0, y = 0; x < store.GetDstFieldCount();)
+        {
+            switch (store.GetDstFormat(x))
+            {
+                case FT_NA:
+                case FT_NA_BYTE:
+                case FT_NA_FLOAT:
+                    offset += GetDstFieldSize(store.GetDstFormat(x)); ++x; continue;
+                case FT_NA_POINTER: storeValue((char const*)nullptr, store, record, x, offset); ++x; continue;
+                default:
+                    break;
+            }
+
+            switch (store.GetSrcFormat(y))
+            {
+                case FT_NA:
+                case FT_NA_BYTE:
+                case FT_NA_FLOAT:
+                    break;
+                case FT_STRING:
+                    MANGOS_ASSERT(stringIndex < stringCount);
+                    storeValue(nullStrings[stringIndex] ? (char const*)nullptr : strings[stringIndex].c_str(), store, record, x, offset);
+                    ++stringIndex;
+                    ++x;
+                    break;
+                default:
+                    if (store.GetDstFormat(x) == FT_STRING)
+                        storeValue((uint32)0, store, record, x, offset);
+                    else
+                        offset += GetDstFieldSize(store.GetDstFormat(x));
+                    ++x;
+                    break;
+            }
+            ++y;
+        }
+    }
+
+    return true;
+}
+
+template<class DerivedLoader, class StorageClass>
+void SQLStorageLoaderBase<DerivedLoader, StorageClass>::SaveSnapshot(StorageClass const& store, std::string const& path, uint64 checksum) const
+{
+    // write aside and rename, a crash while writing must not leave a valid looking snapshot
+    std::string const tmpPath = path + ".tmp";
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if (!file)
+    {
+        sLog.outError("Can't write snapshot file '%s' for table %s", tmpPath.c_str(), store.GetTableName());
+        return;
+    }
+
+    auto writeValue = [file](auto const& value) { fwrite(&value, sizeof(value), 1, file); };
+    auto writeFormat = [&](char const* format)
+    {
+        uint32 const length = strlen(format);
+        writeValue(length);
+        fwrite(format, 1, length, file);
+    };
+
+    writeValue(uint32(SQL_STORAGE_SNAPSHOT_MAGIC));
+    writeValue(uint32(SQL_STORAGE_SNAPSHOT_VERSION));
+    writeValue(checksum);
+    writeFormat(store.GetSrcFormat());
+    writeFormat(store.GetDstFormat());
+    writeValue(store.GetMaxEntry());
+    writeValue(store.GetRecordCount());
+    writeValue(store.GetRecordSize());
+    fwrite(m_snapshotIds.data(), sizeof(uint32), m_snapshotIds.size(), file);
+    fwrite(store.m_data, store.GetRecordSize(), store.GetRecordCount(), file);
+
+    writeValue(uint32(m_snapshotStrings.size()));
+    for (size_t i = 0; i < m_snapshotStrings.size(); ++i)
+    {
+        uint32 const length = m_snapshotNullStrings[i] ? uint32(-1) : uint32(m_snapshotStrings[i].size());
+        writeValue(length);
+        if (!m_snapshotNullStrings[i])
+            fwrite(m_snapshotStrings[i].data(), 1, m_snapshotStrings[i].size(), file);
+    }
+
+    bool const failed = ferror(file) != 0;
+    fclose(file);
+
+    if (failed || rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        sLog.outError("Can't write snapshot file '%s' for table %s", path.c_str(), store.GetTableName());
+        remove(tmpPath.c_str());
+    }
+}
+
 template<class DerivedLoader, class StorageClass>
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store, bool error_at_empty /*= true*/)
 {
+    std::string snapshotPath;
+    uint64 checksum = 0;
+    bool const useSnapshot = GetSnapshotKey(store, snapshotPath, checksum);
+    if (useSnapshot && LoadSnapshot(store, snapshotPath, checksum))
+    {
+        store.JustFinishedLoading();
+        sLog.outString("%s loaded from snapshot", store.GetTableName());
+        return;
+    }
+
     Field* fields = nullptr;
     QueryResult* result  = WorldDatabase.PQuery("SELECT MAX(%s) FROM %s", store.EntryFieldName(), store.GetTableName());
     if (!result)
@@ -352,38 +595,7 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     // get struct size
     uint32 offset = 0;
     for (uint32 x = 0; x < store.GetDstFieldCount(); ++x)
-    {
-        switch (store.GetDstFormat(x))
-        {
-            case FT_LOGIC:
-                recordsize += sizeof(bool);   break;
-            case FT_BYTE:
-                recordsize += sizeof(char);   break;
-            case FT_INT:
-                recordsize += sizeof(uint32); break;
-            case FT_FLOAT:
-                recordsize += sizeof(float);  break;
-            case FT_STRING:
-                recordsize += sizeof(char*);  break;
-            case FT_NA:
-                recordsize += sizeof(uint32); break;
-            case FT_NA_BYTE:
-                recordsize += sizeof(char);   break;
-            case FT_NA_FLOAT:
-                recordsize += sizeof(float);  break;
-            case FT_NA_POINTER:
-                recordsize += sizeof(char*);  break;
-            case FT_64BITINT:
-                recordsize += sizeof(uint64);  break;
-            case FT_IND:
-            case FT_SORT:
-                assert(false && "SQL storage not have sort field types");
-                break;
-            default:
-                assert(false && "unknown format character");
-                break;
-        }
-    }
+        recordsize += GetDstFieldSize(store.GetDstFormat(x));
 
     // Prepare data storage and lookup storage
     store.prepareToLoad(maxRecordId, recordCount, recordsize);
@@ -397,6 +609,9 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         char* record = store.createRecord(fields[0].GetUInt32());
         offset = 0;
 
+        if (useSnapshot)
+            m_snapshotIds.push_back(fields[0].GetUInt32());
+
         // dependend on dest-size
         // iterate two indexes: x over dest, y over source
         //                      y++ If and only If x != FT_NA*
@@ -424,7 +639,13 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
                 case FT_BYTE:   storeValue((char)fields[y].GetUInt8(), store, record, x, offset);         ++x; break;
                 case FT_INT:    storeValue((uint32)fields[y].GetUInt32(), store, record, x, offset);      ++x; break;
                 case FT_FLOAT:  storeValue((float)fields[y].GetFloat(), store, record, x, offset);        ++x; break;
-                case FT_STRING: storeValue((char const*)fields[y].GetString(), store, record, x, offset); ++x; break;
+                case FT_STRING:
+                    if (useSnapshot)
+                    {
+                        m_snapshotStrings.push_back(fields[y].IsNULL() ? std::string() : fields[y].GetCppString());
+                        m_snapshotNullStrings.push_back(fields[y].IsNULL());
+                    }
+                    storeValue((char const*)fields[y].GetString(), store, record, x, offset); ++x; break;
                 case FT_64BITINT: storeValue((uint64)fields[y].GetUInt64(), store, record, x, offset);            ++x; break;
                 case FT_NA:
                 case FT_NA_BYTE:
@@ -445,6 +666,11 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     while (result->NextRow());
 
     delete result;
+
+    store.JustFinishedLoading();
+
+    if (useSnapshot)
+        SaveSnapshot(store, snapshotPath, checksum);
 }
 
 #endif
@@ -20,14 +20,18 @@
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, std::vector<SqlConnection*> const& workerConns) :
+    m_dbEngine(db), m_dbConnection(conn), m_running(true), m_queueSize(0), m_maxWaitTime(0)
 {
+    for (SqlConnection* workerConn : workerConns)
+        m_workers.emplace_back(new LaneWorker(*this, workerConn));
 }
 
 SqlDelayThread::~SqlDelayThread()
 {
     // process all requests which might have been queued while thread was stopping
     ProcessRequests();
+    m_workers.clear();
 }
 
 void SqlDelayThread::run()
@@ -68,7 +72,7 @@ void SqlDelayThread::Stop()
 
 void SqlDelayThread::ProcessRequests()
 {
-    std::queue<std::unique_ptr<SqlOperation>> sqlQueue;
+    std::queue<QueuedOperation> sqlQueue;
 
     // we need to move the contents of the queue to a local copy because executing these statements with the
     // lock in place can result in a deadlock with the world thread which calls Database::ProcessResultQueue()
@@ -77,10 +81,151 @@ void SqlDelayThread::ProcessRequests()
         sqlQueue = std::move(m_sqlQueue);
     }
 
+    // keyed operations only keep their order relative to the same key and may run in parallel,
+    // everything else is a barrier that runs after all previous operations finished
+    std::vector<OperationLane> lanes(m_workers.size() + 1);
+    bool hasLanes = false;
     while (!sqlQueue.empty())
     {
-        auto const s = std::move(sqlQueue.front());
+        QueuedOperation queued = std::move(sqlQueue.front());
         sqlQueue.pop();
-        s->Execute(m_dbConnection);
+
+        uint32 const key = m_workers.empty() ? 0 : queued.operation->GetOrderingKey();
+        if (!key)
+        {
+            if (hasLanes)
+            {
+                ProcessLanes(lanes);
+                hasLanes = false;
+            }
+            ExecuteOperation(queued, m_dbConnection);
+            continue;
+        }
+
+        lanes[key % lanes.size()].push_back(std::move(queued));
+        hasLanes = true;
+    }
+
+    if (hasLanes)
+        ProcessLanes(lanes);
+}
+
+void SqlDelayThread::ProcessLanes(std::vector<OperationLane>& lanes)
+{
+    for (size_t i = 1; i < lanes.size(); ++i)
+    {
+        if (lanes[i].empty())
+            continue;
+
+        m_workers[i - 1]->Schedule(std::move(lanes[i]));
+        lanes[i].clear();
+    }
+
+    // first lane runs on the delay thread connection
+    for (auto& queued : lanes[0])
+        ExecuteOperation(queued, m_dbConnection);
+    lanes[0].clear();
+
+    for (auto& worker : m_workers)
+        worker->Wait();
+}
+
+void SqlDelayThread::ExecuteOperation(QueuedOperation& queued, SqlConnection* conn)
+{
+    uint64 const waitTimeUs = SqlConnection::GetElapsedTime(queued.queuedTime);
+    m_dbEngine->GetQueryProfiler().RecordQueueWait(waitTimeUs);
+    uint32 const waitTime = uint32(waitTimeUs / 1000);
+    uint32 maxWaitTime = m_maxWaitTime;
+    while (waitTime > maxWaitTime && !m_maxWaitTime.compare_exchange_weak(maxWaitTime, waitTime)) {}
+
+    queued.operation->Execute(conn);
+    queued.operation.reset();
+    --m_queueSize;
+}
+
+void SqlDelayThread::RunOnAllConnections(ConnectionJob const& job)
+{
+    for (auto& worker : m_workers)
+        worker->Schedule(job);
+
+    job(m_dbConnection);
+
+    for (auto& worker : m_workers)
+        worker->Wait();
+}
+
+SqlDelayThread::LaneWorker::LaneWorker(SqlDelayThread& owner, SqlConnection* conn) :
+    m_owner(owner), m_dbConnection(conn), m_hasWork(false), m_stop(false), m_thread(&LaneWorker::run, this)
+{
+}
+
+SqlDelayThread::LaneWorker::~LaneWorker()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_stop = true;
     }
+    m_condition.notify_all();
+    m_thread.join();
+}
+
+void SqlDelayThread::LaneWorker::Schedule(OperationLane&& lane)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_lane = std::move(lane);
+        m_hasWork = true;
+    }
+    m_condition.notify_all();
+}
+
+void SqlDelayThread::LaneWorker::Schedule(ConnectionJob const& job)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_job = job;
+        m_hasWork = true;
+    }
+    m_condition.notify_all();
+}
+
+void SqlDelayThread::LaneWorker::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return !m_hasWork; });
+}
+
+void SqlDelayThread::LaneWorker::run()
+{
+#ifndef DO_POSTGRESQL
+    mysql_thread_init();
+#endif
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return m_hasWork || m_stop; });
+        if (!m_hasWork)
+            break;
+
+        OperationLane lane = std::move(m_lane);
+        m_lane.clear();
+        ConnectionJob job = std::move(m_job);
+        m_job = nullptr;
+        lock.unlock();
+
+        for (auto& queued : lane)
+            m_owner.ExecuteOperation(queued, m_dbConnection);
+        if (job)
+            job(m_dbConnection);
+
+        lock.lock();
+        m_hasWork = false;
+        m_condition.notify_all();
+    }
+    lock.unlock();
+
+#ifndef DO_POSTGRESQL
+    mysql_thread_end();
+#endif
 }
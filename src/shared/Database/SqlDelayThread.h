@@ -23,9 +23,14 @@
 #include "SqlOperations.h"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <thread>
+#include <vector>
 
 class Database;
 class SqlOperation;
@@ -34,27 +39,78 @@ class SqlConnection;
 class SqlDelayThread : public MaNGOS::Runnable
 {
     private:
+        struct QueuedOperation
+        {
+            std::unique_ptr<SqlOperation> operation;
+            std::chrono::steady_clock::time_point queuedTime;
+        };
+        typedef std::vector<QueuedOperation> OperationLane;
+        typedef std::function<void(SqlConnection*)> ConnectionJob;
+
+        // executes one lane of ordered operations on its own connection
+        class LaneWorker
+        {
+            public:
+                LaneWorker(SqlDelayThread& owner, SqlConnection* conn);
+                ~LaneWorker();
+
+                void Schedule(OperationLane&& lane);
+                void Schedule(ConnectionJob const& job);
+                void Wait();
+
+            private:
+                void run();
+
+                SqlDelayThread& m_owner;
+                SqlConnection* m_dbConnection;
+                OperationLane m_lane;
+                ConnectionJob m_job;
+                bool m_hasWork;
+                bool m_stop;
+                std::mutex m_mutex;
+                std::condition_variable m_condition;
+                std::thread m_thread;
+        };
+
         std::mutex m_queueMutex;
-        std::queue<std::unique_ptr<SqlOperation>> m_sqlQueue;   ///< Queue of SQL statements
+        std::queue<QueuedOperation> m_sqlQueue;                 ///< Queue of SQL statements
         Database* m_dbEngine;                                   ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                          ///< Pointer to DB connection
+        std::vector<std::unique_ptr<LaneWorker>> m_workers;     ///< Extra connections for ordered lanes
         std::atomic<bool> m_running;
 
+        std::atomic<uint32> m_queueSize;
+        std::atomic<uint32> m_maxWaitTime;
+
         // process all enqueued requests
         void ProcessRequests();
+        // run keyed operations collected since the last unordered one, one lane per connection
+        void ProcessLanes(std::vector<OperationLane>& lanes);
+        void ExecuteOperation(QueuedOperation& queued, SqlConnection* conn);
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
+        SqlDelayThread(Database* db, SqlConnection* conn, std::vector<SqlConnection*> const& workerConns = {});
         ~SqlDelayThread();
 
         ///< Put sql statement to delay queue
         bool Delay(SqlOperation* sql)
         {
             std::lock_guard<std::mutex> guard(m_queueMutex);
-            m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
+            m_sqlQueue.push({ std::unique_ptr<SqlOperation>(sql), std::chrono::steady_clock::now() });
+            ++m_queueSize;
             return true;
         }
 
+        // connections an operation executed by this thread can spread its work over
+        uint32 GetConnectionCount() const { return m_workers.size() + 1; }
+        // runs job once on every connection in parallel and returns when all finished, only call from an executed operation
+        void RunOnAllConnections(ConnectionJob const& job);
+
+        // operations waiting for or in execution
+        uint32 GetQueueSize() const { return m_queueSize; }
+        // longest time in ms an operation waited for execution since the last call
+        uint32 ConsumeMaxWaitTime() { return m_maxWaitTime.exchange(0); }
+
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
 };
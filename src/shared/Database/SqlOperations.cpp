@@ -25,6 +25,9 @@
 
 #define LOCK_DB_CONN(conn) SqlConnection::Lock guard(conn)
 
+// row limit for consecutive inserts merged inside one transaction, keeps statements well below max_allowed_packet
+#define MAX_BATCHED_INSERT_ROWS 64
+
 /// ---- ASYNC STATEMENTS / TRANSACTIONS ----
 
 bool SqlPlainRequest::Execute(SqlConnection* conn)
@@ -57,6 +60,37 @@ bool SqlTransaction::Execute(SqlConnection* conn)
     {
         SqlOperation* pStmt = m_queue[i];
 
+        // merge consecutive rows of the same insert statement into one multi row insert
+        if (SqlPreparedRequest* pRequest = dynamic_cast<SqlPreparedRequest*>(pStmt))
+        {
+            int nRows = 1;
+            while (i + nRows < nItems && nRows < MAX_BATCHED_INSERT_ROWS)
+            {
+                SqlPreparedRequest* pNext = dynamic_cast<SqlPreparedRequest*>(m_queue[i + nRows]);
+                if (!pNext || pNext->GetIndex() != pRequest->GetIndex())
+                    break;
+                ++nRows;
+            }
+
+            int const nBatchIndex = nRows > 1 ? conn->DB().GetBatchedStmtId(pRequest->GetIndex(), nRows) : -1;
+            if (nBatchIndex != -1)
+            {
+                SqlStmtParameters batchParams(pRequest->GetParams().boundParams() * nRows);
+                for (int row = 0; row < nRows; ++row)
+                    for (SqlStmtFieldData const& data : static_cast<SqlPreparedRequest*>(m_queue[i + row])->GetParams().params())
+                        batchParams.addParam(data);
+
+                if (!conn->ExecuteStmt(nBatchIndex, batchParams))
+                {
+                    conn->RollbackTransaction();
+                    return false;
+                }
+
+                i += nRows - 1;
+                continue;
+            }
+        }
+
         if (!pStmt->Execute(conn))
         {
             conn->RollbackTransaction();
@@ -124,7 +158,7 @@ bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* t
 
     /// delay the execution of the queries, sync them with the delay thread
     /// which will in turn resync on execution (via the queue) and call back
-    SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue);
+    SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue, thread);
     thread->Delay(holderEx);
     return true;
 }
@@ -137,10 +171,10 @@ bool SqlQueryHolder::SetQuery(size_t index, const char* sql)
         return false;
     }
 
-    if (m_queries[index].first != nullptr)
+    if (m_queries[index].first != nullptr || m_stmtQueries[index].second != nullptr)
     {
         sLog.outError("Attempt assign query to holder index (" SIZEFMTD ") where other query stored (Old: [%s] New: [%s])",
-                      index, m_queries[index].first, sql);
+                      index, m_queries[index].first ? m_queries[index].first : "prepared statement", sql);
         return false;
     }
 
@@ -172,6 +206,32 @@ bool SqlQueryHolder::SetPQuery(size_t index, const char* format, ...)
     return SetQuery(index, szQuery);
 }
 
+bool SqlQueryHolder::SetStmtQuery(size_t index, SqlStatement& stmt)
+{
+    if (m_queries.size() <= index)
+    {
+        sLog.outError("Query index (" SIZEFMTD ") out of range (size: " SIZEFMTD ") for statement %i", index, m_queries.size(), stmt.ID());
+        return false;
+    }
+
+    if (m_queries[index].first != nullptr || m_stmtQueries[index].second != nullptr)
+    {
+        sLog.outError("Attempt assign statement %i to holder index (" SIZEFMTD ") where other query stored", stmt.ID(), index);
+        return false;
+    }
+
+    SqlStmtParameters* params = stmt.detach();
+    if (params->boundParams() != stmt.arguments())
+    {
+        sLog.outError("SQL ERROR: wrong amount of parameters (%i instead of %i) for statement %i", params->boundParams(), stmt.arguments(), stmt.ID());
+        delete params;
+        return false;
+    }
+
+    m_stmtQueries[index] = SqlStmtQuery(stmt.ID(), params);
+    return true;
+}
+
 QueryResult* SqlQueryHolder::GetResult(size_t index)
 {
     if (index < m_queries.size())
@@ -182,6 +242,11 @@ QueryResult* SqlQueryHolder::GetResult(size_t index)
             delete[](const_cast<char*>(m_queries[index].first));
             m_queries[index].first = nullptr;
         }
+        if (m_stmtQueries[index].second != nullptr)
+        {
+            delete m_stmtQueries[index].second;
+            m_stmtQueries[index].second = nullptr;
+        }
         /// when you get a result aways remember to delete it!
         return m_queries[index].second;
     }
@@ -197,14 +262,15 @@ void SqlQueryHolder::SetResult(size_t index, QueryResult* result)
 
 SqlQueryHolder::~SqlQueryHolder()
 {
-    for (auto& m_querie : m_queries)
+    for (size_t i = 0; i < m_queries.size(); ++i)
     {
         /// if the result was never used, free the resources
         /// results used already (getresult called) are expected to be deleted
-        if (m_querie.first != nullptr)
+        if (m_queries[i].first != nullptr || m_stmtQueries[i].second != nullptr)
         {
-            delete[](const_cast<char*>(m_querie.first));
-            delete m_querie.second;
+            delete[](const_cast<char*>(m_queries[i].first));
+            delete m_stmtQueries[i].second;
+            delete m_queries[i].second;
         }
     }
 }
@@ -213,6 +279,7 @@ void SqlQueryHolder::SetSize(size_t size)
 {
     /// to optimize push_back, reserve the number of queries about to be executed
     m_queries.resize(size);
+    m_stmtQueries.resize(size, SqlStmtQuery(-1, nullptr));
 }
 
 bool SqlQueryHolderEx::Execute(SqlConnection* conn)
@@ -220,15 +287,33 @@ bool SqlQueryHolderEx::Execute(SqlConnection* conn)
     if (!m_holder || !m_callback || !m_queue)
         return false;
 
-    LOCK_DB_CONN(conn);
+    auto const startTime = std::chrono::steady_clock::now();
+
     /// we can do this, we are friends
     std::vector<SqlQueryHolder::SqlResultPair>& queries = m_holder->m_queries;
-    for (size_t i = 0; i < queries.size(); ++i)
+    std::atomic<size_t> nextQuery(0);
+    auto executeQueries = [&](SqlConnection* queryConn)
     {
-        /// execute all queries in the holder and pass the results
-        char const* sql = queries[i].first;
-        if (sql) m_holder->SetResult(i, conn->Query(sql));
-    }
+        LOCK_DB_CONN(queryConn);
+        /// every connection takes the next pending query until all are done
+        for (size_t i = nextQuery++; i < queries.size(); i = nextQuery++)
+        {
+            /// execute all queries in the holder and pass the results
+            char const* sql = queries[i].first;
+            if (sql)
+                m_holder->SetResult(i, queryConn->Query(sql));
+            else if (SqlStmtParameters const* params = m_holder->m_stmtQueries[i].second)
+                m_holder->SetResult(i, queryConn->QueryStmt(m_holder->m_stmtQueries[i].first, *params));
+        }
+    };
+
+    /// the worker connections are idle while an unordered operation runs, use them to fan out
+    if (m_thread && m_thread->GetConnectionCount() > 1 && queries.size() > 1)
+        m_thread->RunOnAllConnections(executeQueries);
+    else
+        executeQueries(conn);
+
+    m_holder->m_executionTime = SqlConnection::GetElapsedTime(startTime);
 
     /// sync with the caller thread
     m_queue->Add(m_callback);
@@ -33,12 +33,15 @@ class Database;
 class SqlConnection;
 class SqlDelayThread;
 class SqlStmtParameters;
+class SqlStatement;
 
 class SqlOperation
 {
     public:
         virtual void OnRemove() { delete this; }
         virtual bool Execute(SqlConnection* conn) = 0;
+        // non zero keys only keep their order relative to operations with the same key
+        virtual uint32 GetOrderingKey() const { return 0; }
         virtual ~SqlOperation() {}
 };
 
@@ -58,12 +61,14 @@ class SqlTransaction : public SqlOperation
 {
     private:
         std::vector<SqlOperation* > m_queue;
+        uint32 const m_orderingKey;
 
     public:
-        SqlTransaction() {}
+        explicit SqlTransaction(uint32 orderingKey = 0) : m_orderingKey(orderingKey) {}
         ~SqlTransaction();
 
         void DelayExecute(SqlOperation* sql) { m_queue.push_back(sql); }
+        uint32 GetOrderingKey() const override { return m_orderingKey; }
 
         bool Execute(SqlConnection* conn) override;
 };
@@ -76,6 +81,9 @@ class SqlPreparedRequest : public SqlOperation
 
         bool Execute(SqlConnection* conn) override;
 
+        int GetIndex() const { return m_nIndex; }
+        SqlStmtParameters const& GetParams() const { return *m_param; }
+
     private:
         const int m_nIndex;
         SqlStmtParameters* m_param;
@@ -121,15 +129,22 @@ class SqlQueryHolder
         friend class SqlQueryHolderEx;
     private:
         typedef std::pair<const char*, QueryResult*> SqlResultPair;
+        typedef std::pair<int, SqlStmtParameters*> SqlStmtQuery;
         std::vector<SqlResultPair> m_queries;
+        std::vector<SqlStmtQuery> m_stmtQueries;            // prepared statement per index, used instead of the plain query
+        uint64 m_executionTime;                             // microseconds spent executing all queries
     public:
-        SqlQueryHolder() {}
+        SqlQueryHolder() : m_executionTime(0) {}
         virtual ~SqlQueryHolder();
         bool SetQuery(size_t index, const char* sql);
         bool SetPQuery(size_t index, const char* format, ...) ATTR_PRINTF(3, 4);
+        // takes the bound parameters of stmt, it's executed as a server side prepared statement when supported
+        bool SetStmtQuery(size_t index, SqlStatement& stmt);
         void SetSize(size_t size);
         QueryResult* GetResult(size_t index);
         void SetResult(size_t index, QueryResult* result);
+        // wall time in microseconds the database needed for all queries, valid in the callback
+        uint64 GetExecutionTime() const { return m_executionTime; }
         bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue);
 };
 
@@ -139,9 +154,10 @@ class SqlQueryHolderEx : public SqlOperation
         SqlQueryHolder* m_holder;
         MaNGOS::IQueryCallback* m_callback;
         SqlResultQueue* m_queue;
+        SqlDelayThread* m_thread;
     public:
-        SqlQueryHolderEx(SqlQueryHolder* holder, MaNGOS::IQueryCallback* callback, SqlResultQueue* queue)
-            : m_holder(holder), m_callback(callback), m_queue(queue) {}
+        SqlQueryHolderEx(SqlQueryHolder* holder, MaNGOS::IQueryCallback* callback, SqlResultQueue* queue, SqlDelayThread* thread)
+            : m_holder(holder), m_callback(callback), m_queue(queue), m_thread(thread) {}
         bool Execute(SqlConnection* conn) override;
 };
 #endif                                                      //__SQLOPERATIONS_H
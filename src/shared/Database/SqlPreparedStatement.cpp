@@ -83,6 +83,22 @@ bool SqlStatement::DirectExecute()
     return m_pDB->DirectExecuteStmt(m_index, args);
 }
 
+QueryResult* SqlStatement::Query()
+{
+    SqlStmtParameters* args = detach();
+    // verify amount of bound parameters
+    if (args->boundParams() != arguments())
+    {
+        sLog.outError("SQL ERROR: wrong amount of parameters (%i instead of %i)", args->boundParams(), arguments());
+        sLog.outError("SQL ERROR: statement: %s", m_pDB->GetStmtString(ID()).c_str());
+        delete args;
+        MANGOS_ASSERT(false);
+        return nullptr;
+    }
+
+    return m_pDB->QueryStmt(m_index, args);
+}
+
 //////////////////////////////////////////////////////////////////////////
 SqlPlainPreparedStatement::SqlPlainPreparedStatement(const std::string& fmt, SqlConnection& conn) : SqlPreparedStatement(fmt, conn)
 {
@@ -125,6 +141,14 @@ void SqlPlainPreparedStatement::bind(const SqlStmtParameters& holder)
     }
 }
 
+QueryResult* SqlPlainPreparedStatement::query()
+{
+    if (m_szPlainRequest.empty())
+        return nullptr;
+
+    return m_pConn.Query(m_szPlainRequest.c_str());
+}
+
 bool SqlPlainPreparedStatement::execute()
 {
     if (m_szPlainRequest.empty())
@@ -206,6 +206,8 @@ class SqlStatement
 
         bool Execute();
         bool DirectExecute();
+        // synchronous SELECT, returns nullptr for empty result like Database::Query
+        QueryResult* Query();
 
         // templates to simplify 1-4 parameter bindings
         template<typename ParamType1>
@@ -264,6 +266,7 @@ class SqlStatement
         SqlStatement(const SqlStatementID& index, Database& db) : m_index(index), m_pDB(&db), m_pParams(nullptr) {}
 
     private:
+        friend class SqlQueryHolder;
 
         SqlStmtParameters* get()
         {
@@ -314,6 +317,8 @@ class SqlPreparedStatement
 
         // execute statement w/o result set
         virtual bool execute() = 0;
+        // execute statement and return its result set, nullptr when empty
+        virtual QueryResult* query() = 0;
 
     protected:
         SqlPreparedStatement(const std::string& fmt, SqlConnection& conn) :
@@ -343,6 +348,7 @@ class SqlPlainPreparedStatement : public SqlPreparedStatement
         virtual void bind(const SqlStmtParameters& holder) override;
 
         virtual bool execute() override;
+        virtual QueryResult* query() override;
 
     protected:
         void DataToString(const SqlStmtFieldData& data, std::ostringstream& fmt) const;
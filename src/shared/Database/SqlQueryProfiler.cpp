@@ -0,0 +1,176 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Database/SqlQueryProfiler.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+// longer statements (mass inserts) are grouped by their beginning
+#define SQL_PROFILE_MAX_QUERY_LENGTH 256
+
+void SqlQueryStats::Add(uint64 time, uint64 rowCount)
+{
+    uint32 bucket = 0;
+    while (bucket < SQL_LATENCY_BUCKETS - 1 && (time >> (bucket + 1)))
+        ++bucket;
+
+    ++buckets[bucket];
+    ++count;
+    totalTime += time;
+    rows += rowCount;
+    maxTime = std::max(maxTime, uint32(std::min<uint64>(time, std::numeric_limits<uint32>::max())));
+}
+
+uint32 SqlQueryStats::GetPercentile(float percentile) const
+{
+    if (!count)
+        return 0;
+
+    uint64 const target = std::max<uint64>(1, uint64(count * percentile + 0.5f));
+    uint64 seen = 0;
+    for (uint32 i = 0; i < SQL_LATENCY_BUCKETS; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= target)
+            return std::min(maxTime, (uint32(1) << (i + 1)) - 1);
+    }
+
+    return maxTime;
+}
+
+std::string SqlQueryProfiler::Normalize(char const* sql)
+{
+    std::string result;
+    result.reserve(std::min<size_t>(strlen(sql), SQL_PROFILE_MAX_QUERY_LENGTH));
+
+    for (char const* itr = sql; *itr && result.length() < SQL_PROFILE_MAX_QUERY_LENGTH;)
+    {
+        char const c = *itr;
+        if (c == '\'' || c == '"')
+        {
+            // skip the literal including escaped quotes
+            for (++itr; *itr && *itr != c; ++itr)
+                if (*itr == '\\' && itr[1])
+                    ++itr;
+            if (*itr)
+                ++itr;
+            result += '?';
+        }
+        else if (isdigit((unsigned char)c) && (result.empty() || !(isalnum((unsigned char)result.back()) || result.back() == '_')))
+        {
+            // number not being part of an identifier, also covers floats and negative values after an operator
+            while (isalnum((unsigned char)*itr) || *itr == '.')
+                ++itr;
+            result += '?';
+        }
+        else
+        {
+            result += c;
+            ++itr;
+        }
+    }
+
+    return result;
+}
+
+void SqlQueryProfiler::Add(std::string const& query, uint64 time, uint64 rows)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    Entry& entry = m_entries[query];
+    entry.total.Add(time, rows);
+    entry.interval.Add(time, rows);
+}
+
+void SqlQueryProfiler::Record(char const* sql, bool prepared, uint64 time, uint64 rows)
+{
+    if (uint32 slowQueryTime = m_slowQueryTime)
+        if (time >= uint64(slowQueryTime) * 1000)
+            sLog.outError("SQL: slow query (%u ms, " UI64FMTD " rows): %s", uint32(time / 1000), rows, sql);
+
+    if (!m_enabled)
+        return;
+
+    Add(prepared ? std::string(sql) : Normalize(sql), time, rows);
+}
+
+void SqlQueryProfiler::RecordQueueWait(uint64 time)
+{
+    if (!m_enabled)
+        return;
+
+    Add("<async queue wait>", time, 0);
+}
+
+void SqlQueryProfiler::Reset()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_entries.clear();
+}
+
+static void SortSummaries(std::vector<SqlQuerySummary>& summaries)
+{
+    std::sort(summaries.begin(), summaries.end(), [](SqlQuerySummary const& left, SqlQuerySummary const& right)
+    {
+        return left.data.totalTime > right.data.totalTime;
+    });
+}
+
+static uint32 GetQueryId(std::string const& query)
+{
+    // FNV-1a, std::hash is not guaranteed to be stable between builds
+    uint32 hash = 2166136261u;
+    for (char c : query)
+        hash = (hash ^ uint8(c)) * 16777619u;
+    return hash;
+}
+
+std::vector<SqlQuerySummary> SqlQueryProfiler::GetSummaries()
+{
+    std::vector<SqlQuerySummary> summaries;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        summaries.reserve(m_entries.size());
+        for (auto const& entry : m_entries)
+            summaries.push_back({ entry.first, GetQueryId(entry.first), entry.second.total });
+    }
+
+    SortSummaries(summaries);
+    return summaries;
+}
+
+std::vector<SqlQuerySummary> SqlQueryProfiler::GetIntervalSummaries()
+{
+    std::vector<SqlQuerySummary> summaries;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        for (auto& entry : m_entries)
+        {
+            if (!entry.second.interval.count)
+                continue;
+
+            summaries.push_back({ entry.first, GetQueryId(entry.first), entry.second.interval });
+            entry.second.interval = SqlQueryStats();
+        }
+    }
+
+    SortSummaries(summaries);
+    return summaries;
+}
@@ -0,0 +1,101 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SQLQUERYPROFILER_H
+#define MANGOS_SQLQUERYPROFILER_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// log2 buckets in microseconds, the last one collects everything above ~8 seconds
+#define SQL_LATENCY_BUCKETS 24
+
+struct SqlQueryStats
+{
+    SqlQueryStats() : count(0), totalTime(0), maxTime(0), rows(0)
+    {
+        memset(buckets, 0, sizeof(buckets));
+    }
+
+    void Add(uint64 time, uint64 rowCount);
+
+    // approximated by the upper bound of the bucket holding the percentile, in microseconds
+    uint32 GetPercentile(float percentile) const;
+
+    uint64 buckets[SQL_LATENCY_BUCKETS];
+    uint64 count;
+    uint64 totalTime;                                       // microseconds
+    uint32 maxTime;                                         // microseconds
+    uint64 rows;                                            // returned by queries, affected by other statements
+};
+
+struct SqlQuerySummary
+{
+    std::string query;
+    uint32 id;                                              // hash of the query text, stable between runs
+    SqlQueryStats data;
+};
+
+// Latency, row count and async queue wait statistics of one database, per statement text.
+// Plain queries are grouped by their text with numbers and string literals replaced by '?',
+// prepared statements by their format string.
+class SqlQueryProfiler
+{
+    public:
+        SqlQueryProfiler() : m_enabled(false), m_slowQueryTime(0) {}
+
+        void SetEnabled(bool enabled) { m_enabled = enabled; }
+        bool IsEnabled() const { return m_enabled; }
+        // in milliseconds, 0 disables the slow query log
+        void SetSlowQueryTime(uint32 time) { m_slowQueryTime = time; }
+
+        // called by the connections after every statement, time in microseconds
+        void Record(char const* sql, bool prepared, uint64 time, uint64 rows);
+        // time an async request waited in the queue before it was started, in microseconds
+        void RecordQueueWait(uint64 time);
+        void Reset();
+
+        // sorted by total time. the interval variant only covers what happened since its previous
+        // call and is meant for a single periodic reader (metrics)
+        std::vector<SqlQuerySummary> GetSummaries();
+        std::vector<SqlQuerySummary> GetIntervalSummaries();
+
+        static std::string Normalize(char const* sql);
+
+    private:
+        struct Entry
+        {
+            SqlQueryStats total;
+            SqlQueryStats interval;
+        };
+
+        void Add(std::string const& query, uint64 time, uint64 rows);
+
+        std::atomic<bool> m_enabled;
+        std::atomic<uint32> m_slowQueryTime;
+
+        std::mutex m_lock;
+        std::unordered_map<std::string, Entry> m_entries;
+};
+
+#endif
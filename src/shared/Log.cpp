@@ -70,7 +70,8 @@ const int LogType_count = int(LogError) + 1;
 
 Log::Log() :
     raLogfile(nullptr), logfile(nullptr), gmLogfile(nullptr), charLogfile(nullptr), dberLogfile(nullptr),
-    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr)
+    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr), m_asyncStop(false), m_droppedLogRecords(0),
+    m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr)
 {
     Initialize();
 }
@@ -287,6 +288,13 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    // Main log file written by a background thread
+    if (logfile && sConfig.GetBoolDefault("LogAsync", false) && !m_asyncQueue)
+    {
+        m_asyncQueue.reset(new MPSCQueue<std::string>(std::max(sConfig.GetIntDefault("LogAsync.QueueSize", 8192), 2)));
+        m_asyncWriter = std::thread(&Log::AsyncWriterThread, this);
+    }
 }
 
 FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
@@ -360,6 +368,110 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
+void Log::appendLogFile(char const* prefix, char const* format, va_list* ap)
+{
+    if (!m_asyncQueue)
+    {
+        outTimestamp(logfile);
+        fputs(prefix, logfile);
+        if (format)
+            vfprintf(logfile, format, *ap);
+        fprintf(logfile, "\n");
+        fflush(logfile);
+        return;
+    }
+
+    // formatted right away, the arguments may not outlive the call
+    time_t t = time(nullptr);
+    tm aTm;
+#if PLATFORM == PLATFORM_WINDOWS
+    localtime_s(&aTm, &t);
+#else
+    localtime_r(&t, &aTm);
+#endif
+    char buf[512];
+    int length = snprintf(buf, sizeof(buf), "%-4d-%02d-%02d %02d:%02d:%02d %s", aTm.tm_year + 1900, aTm.tm_mon + 1, aTm.tm_mday,
+        aTm.tm_hour, aTm.tm_min, aTm.tm_sec, prefix);
+    std::string record(buf, std::min(size_t(std::max(length, 0)), sizeof(buf) - 1));
+    if (format)
+    {
+        va_list copy;
+        va_copy(copy, *ap);
+        length = vsnprintf(buf, sizeof(buf), format, copy);
+        va_end(copy);
+        if (length >= int(sizeof(buf)))
+        {
+            size_t const start = record.size();
+            record.resize(start + length + 1);
+            vsnprintf(&record[start], length + 1, format, *ap);
+            record.resize(start + length);
+        }
+        else if (length > 0)
+            record.append(buf, length);
+    }
+    record += '\n';
+
+    if (!m_asyncQueue->Push(std::move(record)))
+        m_droppedLogRecords.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Log::outLogFile(char const* prefix, char const* format, va_list* ap)
+{
+    if (m_asyncQueue)
+    {
+        appendLogFile(prefix, format, ap);
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    appendLogFile(prefix, format, ap);
+}
+
+void Log::AsyncWriterThread()
+{
+    std::string record;
+    uint64 reportedDrops = 0;
+    while (true)
+    {
+        // a stop request is seen before the last drain, records queued until then are written
+        bool const stopping = m_asyncStop.load(std::memory_order_acquire);
+
+        uint32 written = 0;
+        while (m_asyncQueue->Pop(record))
+        {
+            fwrite(record.data(), 1, record.size(), logfile);
+            ++written;
+        }
+
+        uint64 const drops = m_droppedLogRecords.load(std::memory_order_relaxed);
+        if (drops != reportedDrops)
+        {
+            outTimestamp(logfile);
+            fprintf(logfile, "ERROR:" UI64FMTD " log records dropped, LogAsync.QueueSize is too small\n", drops - reportedDrops);
+            reportedDrops = drops;
+            ++written;
+        }
+
+        // one flush per batch instead of per line
+        if (written)
+            fflush(logfile);
+        else if (!stopping)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        if (stopping)
+            break;
+    }
+}
+
+void Log::StopAsyncWriter()
+{
+    if (!m_asyncWriter.joinable())
+        return;
+
+    m_asyncStop.store(true, std::memory_order_release);
+    m_asyncWriter.join();
+}
+
 void Log::outString()
 {
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
@@ -367,11 +479,7 @@ void Log::outString()
         outTime();
     printf("\n");
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+        appendLogFile("", nullptr, nullptr);
 
     fflush(stdout);
 }
@@ -402,14 +510,9 @@ void Log::outString(const char* str, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        appendLogFile("", str, &ap);
         va_end(ap);
-
-        fflush(logfile);
     }
 
     fflush(stdout);
@@ -440,15 +543,9 @@ void Log::outError(const char* err, ...)
     fprintf(stderr, "\n");
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        appendLogFile("ERROR:", err, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     fflush(stderr);
@@ -464,11 +561,7 @@ void Log::outErrorDb()
     fprintf(stderr, "\n");
 
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
-    }
+        appendLogFile("ERROR:", nullptr, nullptr);
 
     if (dberLogfile)
     {
@@ -506,15 +599,9 @@ void Log::outErrorDb(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        appendLogFile("ERROR:", err, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (dberLogfile)
@@ -543,11 +630,7 @@ void Log::outErrorEventAI()
     fprintf(stderr, "\n");
 
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
-    }
+        appendLogFile("ERROR CreatureEventAI", nullptr, nullptr);
 
     if (eventAiErLogfile)
     {
@@ -584,15 +667,9 @@ void Log::outErrorEventAI(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        appendLogFile("ERROR CreatureEventAI: ", err, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (eventAiErLogfile)
@@ -616,9 +693,9 @@ void Log::outBasic(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (m_logLevel >= LOG_LVL_BASIC)
     {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
         if (m_colored)
             SetColor(true, m_colors[LogDetails]);
 
@@ -634,20 +711,17 @@ void Log::outBasic(const char* str, ...)
             ResetColor(true);
 
         printf("\n");
+        fflush(stdout);
     }
 
+    // map threads only wait for each other on the console, see LogAsync
     if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
     {
         va_list ap;
-        outTimestamp(logfile);
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        outLogFile("", str, &ap);
         va_end(ap);
-        fflush(logfile);
     }
-
-    fflush(stdout);
 }
 
 void Log::outDetail(const char* str, ...)
@@ -655,9 +729,9 @@ void Log::outDetail(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (m_logLevel >= LOG_LVL_DETAIL)
     {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
         if (m_colored)
             SetColor(true, m_colors[LogDetails]);
 
@@ -673,32 +747,27 @@ void Log::outDetail(const char* str, ...)
             ResetColor(true);
 
         printf("\n");
+        fflush(stdout);
     }
 
+    // map threads only wait for each other on the console, see LogAsync
     if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
-        outTimestamp(logfile);
-
         va_list ap;
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
+        outLogFile("", str, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
-
-    fflush(stdout);
 }
 
 void Log::outDebug(const char* str, ...)
 {
-    if (!str)
+    if (!str || LOG_LVL_COMPILED < LOG_LVL_DEBUG)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (m_logLevel >= LOG_LVL_DEBUG)
     {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
         if (m_colored)
             SetColor(true, m_colors[LogDebug]);
 
@@ -714,22 +783,17 @@ void Log::outDebug(const char* str, ...)
             ResetColor(true);
 
         printf("\n");
+        fflush(stdout);
     }
 
+    // map threads only wait for each other on the console, see LogAsync
     if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
     {
-        outTimestamp(logfile);
-
         va_list ap;
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
+        outLogFile("", str, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
-
-    fflush(stdout);
 }
 
 void Log::outCommand(uint32 account, const char* str, ...)
@@ -760,12 +824,9 @@ void Log::outCommand(uint32 account, const char* str, ...)
     if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
         va_list ap;
-        outTimestamp(logfile);
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        appendLogFile("", str, &ap);
         va_end(ap);
-        fflush(logfile);
     }
 
     if (m_gmlog_per_account)
@@ -822,14 +883,7 @@ void Log::outErrorScriptLib()
     fprintf(stderr, "\n");
 
     if (logfile)
-    {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR:> ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        fflush(logfile);
-    }
+        appendLogFile(m_scriptLibName ? ("<" + std::string(m_scriptLibName) + " ERROR:> ").c_str() : "<Scripting Library ERROR>: ", nullptr, nullptr);
 
     if (scriptErrLogFile)
     {
@@ -866,18 +920,9 @@ void Log::outErrorScriptLib(const char* err, ...)
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR>: ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        appendLogFile(m_scriptLibName ? ("<" + std::string(m_scriptLibName) + " ERROR>: ").c_str() : "<Scripting Library ERROR>: ", err, &ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (scriptErrLogFile)
@@ -1049,7 +1094,7 @@ void detail_log(const char* str, ...)
 
 void debug_log(const char* str, ...)
 {
-    if (!str)
+    if (!str || !sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
         return;
 
     char buf[256];
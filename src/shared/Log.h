@@ -21,8 +21,14 @@
 
 #include "Common.h"
 #include "Policies/Singleton.h"
+#include "Util/MPSCQueue.h"
 
+#include <atomic>
+#include <cstdarg>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
 
 class Config;
 class ByteBuffer;
@@ -35,6 +41,14 @@ enum LogLevel
     LOG_LVL_DEBUG   = 3
 };
 
+// highest level built into the binary, BUILD_DEBUG_LOG=OFF drops debug output
+// together with the evaluation of its arguments
+#ifdef MANGOS_DISABLE_DEBUG_LOG
+#define LOG_LVL_COMPILED            LOG_LVL_DETAIL
+#else
+#define LOG_LVL_COMPILED            LOG_LVL_DEBUG
+#endif
+
 // bitmask (not forgot update logFilterData content)
 enum LogFilters
 {
@@ -100,6 +114,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
 
         ~Log()
         {
+            StopAsyncWriter();
+
             if (logfile != nullptr)
                 fclose(logfile);
             logfile = nullptr;
@@ -182,9 +198,10 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         static std::string GetTimestampStr();
         bool HasLogFilter(uint32 filter) const { return (m_logFilter & filter) != 0; }
         void SetLogFilter(LogFilters filter, bool on) { if (on) m_logFilter |= filter; else m_logFilter &= ~filter; }
-        bool HasLogLevelOrHigher(LogLevel loglvl) const { return m_logLevel >= loglvl || (m_logFileLevel >= loglvl && logfile); }
+        bool HasLogLevelOrHigher(LogLevel loglvl) const { return loglvl <= LOG_LVL_COMPILED && (m_logLevel >= loglvl || (m_logFileLevel >= loglvl && logfile)); }
         bool IsOutCharDump() const { return m_charLog_Dump; }
         bool IsIncludeTime() const { return m_includeTime; }
+        uint64 GetDroppedLogRecords() const { return m_droppedLogRecords; }
         std::string GetTraceLog();
 
         static void WaitBeforeContinueIfNeed();
@@ -198,6 +215,13 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
+        // one line to the main log file, caller holds m_worldLogMtx unless the log is asynchronous
+        void appendLogFile(char const* prefix, char const* format, va_list* ap);
+        // same, takes m_worldLogMtx itself when needed
+        void outLogFile(char const* prefix, char const* format, va_list* ap);
+        void AsyncWriterThread();
+        void StopAsyncWriter();
+
         FILE* raLogfile;
         FILE* logfile;
         FILE* gmLogfile;
@@ -211,6 +235,12 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         std::mutex m_worldLogMtx;
         std::mutex m_traceLogMtx;
 
+        // LogAsync: preformatted lines of the main log file, written and flushed in batches
+        std::unique_ptr<MPSCQueue<std::string>> m_asyncQueue;
+        std::thread m_asyncWriter;
+        std::atomic<bool> m_asyncStop;
+        std::atomic<uint64> m_droppedLogRecords;
+
         // log/console control
         LogLevel m_logLevel;
         LogLevel m_logFileLevel;
@@ -259,6 +289,20 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
             sLog.outDetail(__VA_ARGS__);                \
     } while(0)
 
+#ifdef MANGOS_DISABLE_DEBUG_LOG
+// arguments stay compiled for format checks but are never evaluated
+#define DEBUG_LOG(...)                                  \
+    do {                                                \
+        if (false)                                      \
+            sLog.outDebug(__VA_ARGS__);                 \
+    } while(0)
+
+#define DEBUG_FILTER_LOG(F,...)                         \
+    do {                                                \
+        if (false)                                      \
+            sLog.outDebug(__VA_ARGS__);                 \
+    } while(0)
+#else
 #define DEBUG_LOG(...)                                  \
     do {                                                \
         if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))    \
@@ -270,6 +314,7 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG) && !sLog.HasLogFilter(F)) \
             sLog.outDebug(__VA_ARGS__);                 \
     } while(0)
+#endif
 
 #define ERROR_DB_FILTER_LOG(F,...)                      \
     do {                                                \
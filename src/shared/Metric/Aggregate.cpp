@@ -0,0 +1,165 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Aggregate.h"
+#include "Util/Errors.h"
+
+std::atomic<bool> metric::aggregate::s_enabled(false);
+thread_local metric::thread_slots* metric::aggregate::t_slots = nullptr;
+
+namespace
+{
+    // hands the slots of an ending thread to the next new one, totals stay cumulative
+    struct thread_slots_owner
+    {
+        ~thread_slots_owner()
+        {
+            if (slots)
+                metric::aggregates::instance().release_slots(*slots);
+        }
+
+        metric::thread_slots* slots = nullptr;
+    };
+}
+
+metric::thread_slots& metric::aggregate::attach_thread()
+{
+    static thread_local thread_slots_owner owner;
+
+    t_slots = &aggregates::instance().acquire_slots();
+    owner.slots = t_slots;
+    return *t_slots;
+}
+
+metric::aggregates::aggregates() : m_nextSlot(0)
+{
+}
+
+metric::aggregates& metric::aggregates::instance()
+{
+    static aggregates instance;
+    return instance;
+}
+
+template <typename T>
+T& metric::aggregates::find_or_create(aggregate_kind kind, std::string const& name, tag_map const& tags, uint32 slots)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_index.find(std::make_pair(name, tags));
+    if (itr != m_index.end())
+    {
+        MANGOS_ASSERT(itr->second->get_kind() == kind);
+        return static_cast<T&>(*itr->second);
+    }
+
+    // running out of slots would only come from tags with unbounded values
+    MANGOS_ASSERT(m_nextSlot + slots <= METRIC_SLOTS_PER_PAGE * METRIC_MAX_PAGES);
+
+    T* created = new T(name, tags, m_nextSlot);
+    m_nextSlot += slots;
+
+    m_aggregates.emplace_back(created);
+    m_index[std::make_pair(name, tags)] = created;
+    return *created;
+}
+
+metric::counter& metric::aggregates::register_counter(std::string const& name, tag_map const& tags)
+{
+    return find_or_create<counter>(AGGREGATE_COUNTER, name, tags, 1);
+}
+
+metric::gauge& metric::aggregates::register_gauge(std::string const& name, tag_map const& tags)
+{
+    return find_or_create<gauge>(AGGREGATE_GAUGE, name, tags, 0);
+}
+
+metric::histogram& metric::aggregates::register_histogram(std::string const& name, tag_map const& tags)
+{
+    return find_or_create<histogram>(AGGREGATE_HISTOGRAM, name, tags, histogram::SLOT_COUNT);
+}
+
+metric::thread_slots& metric::aggregates::acquire_slots()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (thread_slots& slots : m_threads)
+    {
+        if (!slots.in_use.load(std::memory_order_relaxed))
+        {
+            slots.in_use.store(true, std::memory_order_relaxed);
+            return slots;
+        }
+    }
+
+    m_threads.emplace_back();
+    m_threads.back().in_use.store(true, std::memory_order_relaxed);
+    return m_threads.back();
+}
+
+void metric::aggregates::release_slots(thread_slots& slots)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    slots.in_use.store(false, std::memory_order_relaxed);
+}
+
+void metric::aggregates::snapshot(std::vector<aggregate_snapshot>& result, bool drainMax)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    result.resize(m_aggregates.size());
+    for (size_t i = 0; i < m_aggregates.size(); ++i)
+    {
+        aggregate const& source = *m_aggregates[i];
+        aggregate_snapshot& entry = result[i];
+        entry = aggregate_snapshot();
+        entry.source = &source;
+
+        switch (source.get_kind())
+        {
+            case AGGREGATE_GAUGE:
+                entry.value = static_cast<gauge const&>(source).get();
+                break;
+            case AGGREGATE_COUNTER:
+                for (thread_slots const& slots : m_threads)
+                    entry.value += slots.read(source.m_firstSlot);
+                break;
+            case AGGREGATE_HISTOGRAM:
+                for (thread_slots& slots : m_threads)
+                {
+                    for (uint32 bucket = 0; bucket < METRIC_HISTOGRAM_BUCKETS; ++bucket)
+                        entry.buckets[bucket] += slots.read(source.m_firstSlot + bucket);
+                    entry.sum += slots.read(source.m_firstSlot + histogram::SLOT_SUM);
+
+                    int64 max;
+                    if (drainMax)
+                    {
+                        thread_slots::page* page = slots.pages[(source.m_firstSlot + histogram::SLOT_MAX) / METRIC_SLOTS_PER_PAGE].load(std::memory_order_acquire);
+                        max = page ? page->values[(source.m_firstSlot + histogram::SLOT_MAX) % METRIC_SLOTS_PER_PAGE].exchange(0, std::memory_order_relaxed) : 0;
+                    }
+                    else
+                        max = slots.read(source.m_firstSlot + histogram::SLOT_MAX);
+                    if (max > entry.max)
+                        entry.max = max;
+                }
+
+                for (uint32 bucket = 0; bucket < METRIC_HISTOGRAM_BUCKETS; ++bucket)
+                    entry.value += entry.buckets[bucket];
+                break;
+        }
+    }
+}
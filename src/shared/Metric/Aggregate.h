@@ -0,0 +1,259 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOSSERVER_METRIC_AGGREGATE_H
+#define MANGOSSERVER_METRIC_AGGREGATE_H
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Common.h"
+
+// Pre-registered metric handles, aggregated per thread without locks and turned
+// into measurements once a second by metric::metric. Register a handle once
+// (e.g. as a member or a function static) and keep the reference, every
+// registration with the same name and tags returns the same handle. Handles live
+// as long as the process, so tags must have a bounded set of values: map ids and
+// opcodes are fine, guids and instance ids are not.
+
+#define METRIC_HISTOGRAM_BUCKETS    24                      // upper bounds 1, 2, 4 ... 2^22, the last one is unbounded
+#define METRIC_SLOTS_PER_PAGE       256
+#define METRIC_MAX_PAGES            256                     // at most 65536 slots, a histogram takes 26
+
+namespace metric
+{
+    typedef std::map<std::string, std::string> tag_map;
+
+    enum aggregate_kind
+    {
+        AGGREGATE_COUNTER,
+        AGGREGATE_GAUGE,
+        AGGREGATE_HISTOGRAM,
+    };
+
+    // cumulative slots of one thread, only the owning thread writes them
+    struct thread_slots
+    {
+        struct page
+        {
+            page() { for (auto& value : values) value.store(0, std::memory_order_relaxed); }
+            std::atomic<int64> values[METRIC_SLOTS_PER_PAGE];
+        };
+
+        thread_slots() : in_use(false) { for (auto& p : pages) p.store(nullptr, std::memory_order_relaxed); }
+        ~thread_slots() { for (auto& p : pages) delete p.load(std::memory_order_relaxed); }
+
+        std::atomic<page*> pages[METRIC_MAX_PAGES];
+        std::atomic<bool> in_use;
+
+        std::atomic<int64>& slot(uint32 index)
+        {
+            page* p = pages[index / METRIC_SLOTS_PER_PAGE].load(std::memory_order_relaxed);
+            if (!p)
+            {
+                p = new page();
+                pages[index / METRIC_SLOTS_PER_PAGE].store(p, std::memory_order_release);
+            }
+            return p->values[index % METRIC_SLOTS_PER_PAGE];
+        }
+
+        int64 read(uint32 index) const
+        {
+            page* p = pages[index / METRIC_SLOTS_PER_PAGE].load(std::memory_order_acquire);
+            return p ? p->values[index % METRIC_SLOTS_PER_PAGE].load(std::memory_order_relaxed) : 0;
+        }
+    };
+
+    class aggregate
+    {
+        public:
+            aggregate(aggregate_kind kind, std::string name, tag_map tags, uint32 firstSlot)
+                : m_kind(kind), m_name(std::move(name)), m_tags(std::move(tags)), m_firstSlot(firstSlot) {}
+            virtual ~aggregate() {}
+
+            aggregate_kind get_kind() const { return m_kind; }
+            std::string const& get_name() const { return m_name; }
+            tag_map const& get_tags() const { return m_tags; }
+
+        protected:
+            static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+            static thread_slots& local() { return t_slots ? *t_slots : attach_thread(); }
+            static thread_slots& attach_thread();
+
+            // single writer per thread_slots, no read-modify-write needed
+            static void bump(std::atomic<int64>& value, int64 delta) { value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed); }
+
+            aggregate_kind const m_kind;
+            std::string const m_name;
+            tag_map const m_tags;
+            uint32 const m_firstSlot;
+
+            static std::atomic<bool> s_enabled;
+            static thread_local thread_slots* t_slots;
+
+            friend class aggregates;
+    };
+
+    class counter : public aggregate
+    {
+        public:
+            counter(std::string name, tag_map tags, uint32 slot) : aggregate(AGGREGATE_COUNTER, std::move(name), std::move(tags), slot) {}
+
+            void add(int64 value = 1)
+            {
+                if (enabled())
+                    bump(local().slot(m_firstSlot), value);
+            }
+    };
+
+    // last value wins, shared by all threads
+    class gauge : public aggregate
+    {
+        public:
+            gauge(std::string name, tag_map tags, uint32 /*firstSlot*/) : aggregate(AGGREGATE_GAUGE, std::move(name), std::move(tags), 0), m_value(0) {}
+
+            void set(int64 value) { m_value.store(value, std::memory_order_relaxed); }
+            void add(int64 value) { m_value.fetch_add(value, std::memory_order_relaxed); }
+            int64 get() const { return m_value.load(std::memory_order_relaxed); }
+
+        private:
+            std::atomic<int64> m_value;
+    };
+
+    // exponential buckets, values are usually durations in microseconds
+    class histogram : public aggregate
+    {
+        public:
+            enum
+            {
+                SLOT_SUM    = METRIC_HISTOGRAM_BUCKETS,
+                SLOT_MAX    = METRIC_HISTOGRAM_BUCKETS + 1,
+                SLOT_COUNT  = METRIC_HISTOGRAM_BUCKETS + 2,
+            };
+
+            histogram(std::string name, tag_map tags, uint32 firstSlot) : aggregate(AGGREGATE_HISTOGRAM, std::move(name), std::move(tags), firstSlot) {}
+
+            void observe(int64 value)
+            {
+                if (!enabled())
+                    return;
+
+                thread_slots& slots = local();
+                bump(slots.slot(m_firstSlot + bucket_of(value)), 1);
+                bump(slots.slot(m_firstSlot + SLOT_SUM), value);
+
+                // drained by the flush, a racing sample may move to the next interval
+                std::atomic<int64>& max = slots.slot(m_firstSlot + SLOT_MAX);
+                if (value > max.load(std::memory_order_relaxed))
+                    max.store(value, std::memory_order_relaxed);
+            }
+
+            static uint32 bucket_of(int64 value)
+            {
+                if (value <= 1)
+                    return 0;
+#if defined(__GNUC__)
+                uint32 const bucket = 64 - __builtin_clzll(uint64(value - 1));
+#else
+                uint32 bucket = 0;
+                for (uint64 bound = 1; uint64(value) > bound && bucket < METRIC_HISTOGRAM_BUCKETS; bound <<= 1)
+                    ++bucket;
+#endif
+                return bucket < METRIC_HISTOGRAM_BUCKETS - 1 ? bucket : METRIC_HISTOGRAM_BUCKETS - 1;
+            }
+
+            // upper bound of a bucket, -1 for the unbounded one
+            static int64 bucket_bound(uint32 bucket) { return bucket < METRIC_HISTOGRAM_BUCKETS - 1 ? int64(1) << bucket : -1; }
+    };
+
+    // measures the scope into a histogram in microseconds. An outlier callback gets
+    // the duration of scopes at or above the threshold, to report them with
+    // detailed tags that would be too expensive to build for every sample.
+    struct no_outlier { void operator()(int64) const {} };
+
+    template <typename Outlier = no_outlier>
+    class timer
+    {
+        public:
+            explicit timer(histogram& target, int64 threshold = 0, Outlier outlier = Outlier())
+                : m_target(target), m_threshold(threshold), m_outlier(std::move(outlier)), m_start(std::chrono::steady_clock::now()) {}
+            ~timer()
+            {
+                int64 const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count();
+                m_target.observe(elapsed);
+                if (m_threshold && elapsed >= m_threshold)
+                    m_outlier(elapsed);
+            }
+            timer(timer const&) = delete;
+            timer& operator=(timer const&) = delete;
+
+        private:
+            histogram& m_target;
+            int64 const m_threshold;
+            Outlier m_outlier;
+            std::chrono::steady_clock::time_point const m_start;
+    };
+
+    // summed over all threads since registration
+    struct aggregate_snapshot
+    {
+        aggregate const* source;
+        int64 value;                                        // counter total or gauge value
+        int64 sum;
+        int64 max;                                          // since the previous drained snapshot
+        int64 buckets[METRIC_HISTOGRAM_BUCKETS];
+    };
+
+    class aggregates
+    {
+        public:
+            static aggregates& instance();
+
+            counter& register_counter(std::string const& name, tag_map const& tags = {});
+            gauge& register_gauge(std::string const& name, tag_map const& tags = {});
+            histogram& register_histogram(std::string const& name, tag_map const& tags = {});
+
+            void set_enabled(bool enabled) { aggregate::s_enabled.store(enabled, std::memory_order_relaxed); }
+
+            // drainMax resets the histogram maxima, only the flush of metric::metric does it
+            void snapshot(std::vector<aggregate_snapshot>& result, bool drainMax);
+
+            thread_slots& acquire_slots();
+            void release_slots(thread_slots& slots);
+
+        private:
+            aggregates();
+
+            template <typename T>
+            T& find_or_create(aggregate_kind kind, std::string const& name, tag_map const& tags, uint32 slots);
+
+            std::mutex m_lock;                              // registration, snapshots and thread changes
+            std::deque<std::unique_ptr<aggregate>> m_aggregates;
+            std::map<std::pair<std::string, tag_map>, aggregate*> m_index;
+            std::deque<thread_slots> m_threads;            // never shrinks, slots of ended threads are handed to new ones
+            uint32 m_nextSlot;
+    };
+}
+
+#endif // MANGOSSERVER_METRIC_AGGREGATE_H
@@ -0,0 +1,200 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Exporter.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cerrno>
+
+namespace
+{
+    // larger requests are not scrapes
+    size_t const MAX_REQUEST_SIZE = 8192;
+
+    // prometheus names only allow [a-zA-Z0-9_:], the dots of measurement names become underscores
+    std::string sanitize_name(std::string const& name)
+    {
+        std::string result = name;
+        for (char& c : result)
+            if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != ':')
+                c = '_';
+        if (!result.empty() && isdigit(static_cast<unsigned char>(result[0])))
+            result.insert(0, 1, '_');
+        return result;
+    }
+
+    void append_labels(std::string& out, metric::tag_map const& tags, char const* le = nullptr)
+    {
+        if (tags.empty() && !le)
+            return;
+
+        out += '{';
+        bool first = true;
+        auto append = [&](std::string const& key, std::string const& value)
+        {
+            if (!first)
+                out += ',';
+            first = false;
+
+            out += sanitize_name(key);
+            out += "=\"";
+            for (char c : value)
+            {
+                if (c == '\\' || c == '"')
+                    out += '\\';
+                if (c == '\n')
+                    out += "\\n";
+                else
+                    out += c;
+            }
+            out += '"';
+        };
+
+        for (auto const& tag : tags)
+            append(tag.first, tag.second);
+        if (le)
+            append("le", le);
+        out += '}';
+    }
+}
+
+metric::exporter_socket::exporter_socket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
+    : MaNGOS::Socket(service, std::move(closeHandler))
+{
+}
+
+bool metric::exporter_socket::ProcessIncomingData()
+{
+    size_t const length = ReadLengthRemaining();
+    size_t const offset = m_request.size();
+    m_request.resize(offset + length);
+    Read(&m_request[offset], length);
+
+    size_t end;
+    while ((end = m_request.find("\r\n\r\n")) != std::string::npos)
+    {
+        std::string const line = m_request.substr(0, m_request.find("\r\n"));
+        m_request.erase(0, end + 4);
+
+        if (line.compare(0, 4, "GET ") != 0)
+        {
+            Respond("405 Method Not Allowed", "text/plain", "only GET is supported\n");
+            continue;
+        }
+
+        std::string const path = line.substr(4, line.find(' ', 4) - 4);
+        if (path == "/metrics" || path.compare(0, 9, "/metrics?") == 0)
+            Respond("200 OK", "text/plain; version=0.0.4; charset=utf-8", exporter::render());
+        else
+            Respond("404 Not Found", "text/plain", "metrics are served at /metrics\n");
+    }
+
+    if (m_request.size() > MAX_REQUEST_SIZE)
+    {
+        sLog.outError("metric::exporter_socket: request from %s is too large, closing", GetRemoteAddress().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void metric::exporter_socket::Respond(char const* status, std::string const& contentType, std::string const& body)
+{
+    std::string const header = std::string("HTTP/1.1 ") + status + "\r\nContent-Type: " + contentType +
+        "\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+
+    Write(header.c_str(), header.size(), body.c_str(), body.size());
+}
+
+metric::exporter::exporter(std::string const& address, int port) : m_listener(address, port, 1)
+{
+    // the handles only count while someone reads them
+    aggregates::instance().set_enabled(true);
+    sLog.outString("Metric exporter listening on %s:%d", address.c_str(), port);
+}
+
+std::string metric::exporter::render()
+{
+    std::vector<aggregate_snapshot> snapshots;
+    aggregates::instance().snapshot(snapshots, false);
+
+    // series of one name have to be listed together under a single TYPE line
+    std::stable_sort(snapshots.begin(), snapshots.end(), [](aggregate_snapshot const& a, aggregate_snapshot const& b)
+    {
+        return a.source->get_name() < b.source->get_name();
+    });
+
+    std::string out;
+    out.reserve(snapshots.size() * 128);
+
+    std::string const* family = nullptr;
+    std::string name;
+    for (aggregate_snapshot const& snapshot : snapshots)
+    {
+        aggregate const& source = *snapshot.source;
+        if (!family || *family != source.get_name())
+        {
+            family = &source.get_name();
+            name = sanitize_name(source.get_name());
+
+            char const* type = "gauge";
+            if (source.get_kind() == AGGREGATE_COUNTER)
+                type = "counter";
+            else if (source.get_kind() == AGGREGATE_HISTOGRAM)
+                type = "histogram";
+            out += "# TYPE " + name + (source.get_kind() == AGGREGATE_COUNTER ? "_total " : " ") + type + "\n";
+        }
+
+        switch (source.get_kind())
+        {
+            case AGGREGATE_GAUGE:
+                out += name;
+                append_labels(out, source.get_tags());
+                out += ' ' + std::to_string(snapshot.value) + '\n';
+                break;
+            case AGGREGATE_COUNTER:
+                out += name + "_total";
+                append_labels(out, source.get_tags());
+                out += ' ' + std::to_string(snapshot.value) + '\n';
+                break;
+            case AGGREGATE_HISTOGRAM:
+            {
+                int64 cumulative = 0;
+                for (uint32 bucket = 0; bucket < METRIC_HISTOGRAM_BUCKETS; ++bucket)
+                {
+                    cumulative += snapshot.buckets[bucket];
+                    int64 const bound = histogram::bucket_bound(bucket);
+                    out += name + "_bucket";
+                    append_labels(out, source.get_tags(), bound < 0 ? "+Inf" : std::to_string(bound).c_str());
+                    out += ' ' + std::to_string(cumulative) + '\n';
+                }
+
+                out += name + "_sum";
+                append_labels(out, source.get_tags());
+                out += ' ' + std::to_string(snapshot.sum) + '\n';
+                out += name + "_count";
+                append_labels(out, source.get_tags());
+                out += ' ' + std::to_string(snapshot.value) + '\n';
+                break;
+            }
+        }
+    }
+
+    return out;
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOSSERVER_METRIC_EXPORTER_H
+#define MANGOSSERVER_METRIC_EXPORTER_H
+
+#include "Aggregate.h"
+#include "Common.h"
+#include "Network/Socket.hpp"
+#include "Network/Listener.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace metric
+{
+    // a scrape connection, answers GET /metrics and keeps the connection open for the next one
+    class exporter_socket : public MaNGOS::Socket
+    {
+        public:
+            exporter_socket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler);
+
+        private:
+            bool ProcessIncomingData() override;
+            void Respond(char const* status, std::string const& contentType, std::string const& body);
+
+            std::string m_request;
+    };
+
+    // Prometheus / OpenMetrics pull endpoint for the handles of metric::aggregates.
+    // A scrape only reads the aggregated slots, the game state is never touched.
+    class exporter
+    {
+        public:
+            exporter(std::string const& address, int port);
+
+            // text exposition format 0.0.4, histograms keep their cumulative buckets
+            static std::string render();
+
+        private:
+            MaNGOS::Listener<exporter_socket> m_listener;
+    };
+}
+
+#endif // MANGOSSERVER_METRIC_EXPORTER_H
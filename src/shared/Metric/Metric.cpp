@@ -87,6 +87,9 @@ metric::metric::~metric()
     m_writeService.post([&] {
         m_sendTimer->cancel();
     });
+    m_queueService.post([&] {
+        m_aggregateTimer->cancel();
+    });
 
     m_queueServiceWork.reset();
     m_writeServiceWork.reset();
@@ -109,6 +112,7 @@ void metric::metric::initialize()
     };
 
     m_sendTimer.reset(new boost::asio::deadline_timer(m_writeService));
+    m_aggregateTimer.reset(new boost::asio::deadline_timer(m_queueService));
     m_queueServiceWork.reset(new boost::asio::io_service::work(m_queueService));
     m_writeServiceWork.reset(new boost::asio::io_service::work(m_writeService));
 
@@ -122,6 +126,8 @@ void metric::metric::initialize()
     });
 
     schedule_timer();
+    schedule_aggregate_timer();
+    aggregates::instance().set_enabled(true);
 }
 
 metric::metric& metric::metric::instance()
@@ -192,6 +198,86 @@ void metric::metric::prepare_send(const boost::system::error_code& ec)
     schedule_timer();
 }
 
+void metric::metric::schedule_aggregate_timer()
+{
+    using namespace std::placeholders;
+
+    m_aggregateTimer->expires_from_now(boost::posix_time::seconds(1));
+    m_aggregateTimer->async_wait(std::bind(&metric::metric::flush_aggregates, this, _1));
+}
+
+void metric::metric::flush_aggregates(const boost::system::error_code& ec)
+{
+    if (ec)
+        return;
+
+    aggregates::instance().snapshot(m_aggregateCurrent, true);
+    // handles registered since the last flush start from zero
+    m_aggregatePrevious.resize(m_aggregateCurrent.size(), aggregate_snapshot());
+
+    std::vector<std::unique_ptr<Measurement>> measurements;
+    for (size_t i = 0; i < m_aggregateCurrent.size(); ++i)
+    {
+        aggregate_snapshot const& current = m_aggregateCurrent[i];
+        aggregate_snapshot const& previous = m_aggregatePrevious[i];
+        aggregate const& source = *current.source;
+
+        std::map<std::string, boost::any> fields;
+        switch (source.get_kind())
+        {
+            case AGGREGATE_GAUGE:
+                fields["value"] = current.value;
+                break;
+            case AGGREGATE_COUNTER:
+                if (current.value == previous.value)
+                    continue;
+                fields["count"] = current.value - previous.value;
+                break;
+            case AGGREGATE_HISTOGRAM:
+            {
+                int64 const count = current.value - previous.value;
+                if (!count)
+                    continue;
+
+                int64 const sum = current.sum - previous.sum;
+                fields["count"] = count;
+                fields["sum"] = sum;
+                fields["max"] = current.max;
+                fields["mean"] = float(sum) / count;
+
+                // upper bound of the bucket holding the quantile, the maximum for the last one
+                std::pair<char const*, int64> const quantiles[] = { { "p50", 50 }, { "p95", 95 }, { "p99", 99 } };
+                int64 seen = 0;
+                uint32 quantile = 0;
+                for (uint32 bucket = 0; bucket < METRIC_HISTOGRAM_BUCKETS && quantile < 3; ++bucket)
+                {
+                    seen += current.buckets[bucket] - previous.buckets[bucket];
+                    while (quantile < 3 && seen * 100 >= quantiles[quantile].second * count)
+                    {
+                        int64 const bound = histogram::bucket_bound(bucket);
+                        fields[quantiles[quantile].first] = bound < 0 || bound > current.max ? current.max : bound;
+                        ++quantile;
+                    }
+                }
+                break;
+            }
+        }
+
+        measurements.emplace_back(new Measurement(source.get_name(), source.get_tags(), fields));
+    }
+
+    std::swap(m_aggregatePrevious, m_aggregateCurrent);
+
+    if (!measurements.empty())
+    {
+        std::lock_guard<std::mutex> guard(m_queueWriteLock);
+        for (auto& measurement : measurements)
+            m_measurementQueue.push_back(std::move(measurement));
+    }
+
+    schedule_aggregate_timer();
+}
+
 void metric::metric::send()
 {
     std::vector<std::unique_ptr<Measurement>> measurements;
@@ -202,7 +288,7 @@ void metric::metric::send()
         std::swap(measurements, m_measurementQueue);
     }
 
-    sLog.outDetail("Sending %zu measurements!", measurements.size());
+    DETAIL_LOG("Sending %zu measurements!", measurements.size());
 
     using boost::asio::ip::tcp;
 
@@ -28,6 +28,7 @@
 #include <thread>
 #include <vector>
 
+#include "Aggregate.h"
 #include "Measurement.h"
 #include "Common.h"
 
@@ -124,6 +125,7 @@ namespace metric
             boost::asio::io_service m_writeService;
 
             std::unique_ptr<boost::asio::deadline_timer> m_sendTimer;
+            std::unique_ptr<boost::asio::deadline_timer> m_aggregateTimer;
             std::unique_ptr<boost::asio::io_service::work> m_queueServiceWork;
             std::unique_ptr<boost::asio::io_service::work> m_writeServiceWork;
             std::thread m_queueServiceThread;
@@ -135,9 +137,16 @@ namespace metric
             std::mutex m_queueWriteLock;
             std::vector<std::unique_ptr<Measurement>> m_measurementQueue;
 
+            // queue service thread only
+            std::vector<aggregate_snapshot> m_aggregateCurrent;
+            std::vector<aggregate_snapshot> m_aggregatePrevious;
+
             void schedule_timer();
             void prepare_send(const boost::system::error_code& ec);
             void send();
+
+            void schedule_aggregate_timer();
+            void flush_aggregates(const boost::system::error_code& ec);
     };
 }
 
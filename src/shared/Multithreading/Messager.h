@@ -19,34 +19,160 @@
 #ifndef MANGOS_MESSAGER_H
 #define MANGOS_MESSAGER_H
 
-#include <vector>
-#include <mutex>
-#include <functional>
+#include "Util/BlockPool.h"
+#include "Util/InplaceFunction.h"
 
+#include <atomic>
+#include <utility>
+#ifdef BUILD_METRICS
+#include <algorithm>
+#include <chrono>
+#endif
+
+// captures up to this size are stored in the message node, bigger ones are allocated separately
+#define MESSAGER_INLINE_CAPACITY 48
+
+// Messages for an object owned by another thread, run by the owner in Execute.
+// Producers link their message into an intrusive lock-free list with a single exchange,
+// the owner is the only consumer. Nodes come from the BlockPool, so sending a message with
+// small captures does not touch the global allocator. Messages of one producer run in order.
 template <class T>
 class Messager
 {
     public:
-        void AddMessage(const std::function<void(T*)>& message)
+        typedef InplaceFunction<void(T*), MESSAGER_INLINE_CAPACITY> Message;
+
+#ifdef BUILD_METRICS
+        // messages run by the last Execute and how long they waited, in microseconds
+        struct Stats
+        {
+            uint32 delivered = 0;
+            uint64 totalLatency = 0;
+            uint64 maxLatency = 0;
+        };
+#endif
+
+        Messager() : m_head(&m_stub), m_tail(&m_stub) {}
+        Messager(Messager const&) = delete;
+        Messager& operator=(Messager const&) = delete;
+
+        ~Messager()
+        {
+            // not executed messages are dropped with the object
+            while (Node* node = Pop())
+                delete node;
+        }
+
+        // can be called from any thread
+        template <typename F>
+        void AddMessage(F&& message)
         {
-            std::lock_guard<std::mutex> guard(m_messageMutex);
-            m_messageVector.push_back(message);
+            Push(new Node(std::forward<F>(message)));
         }
+
+        // owner thread only, messages added while executing run on the next call
         void Execute(T* object)
         {
-            std::vector<std::function<void(T*)>> messageVectorCopy;
+            Node* const last = m_head.load(std::memory_order_acquire);
+
+#ifdef BUILD_METRICS
+            Stats stats;
+            auto const now = std::chrono::steady_clock::now();
+#endif
+            // stops early at a message still being linked by its producer, it runs next time
+            while (last != &m_stub || m_tail != &m_stub)
             {
-                std::lock_guard<std::mutex> guard(m_messageMutex);
-                std::swap(m_messageVector, messageVectorCopy);
+                Node* node = Pop();
+                if (!node)
+                    break;
+#ifdef BUILD_METRICS
+                uint64 const latency = std::chrono::duration_cast<std::chrono::microseconds>(now - node->created).count();
+                ++stats.delivered;
+                stats.totalLatency += latency;
+                stats.maxLatency = std::max(stats.maxLatency, latency);
+#endif
+                node->message(object);
+                bool const done = node == last;
+                delete node;
+                if (done)
+                    break;
             }
-            for (auto& message : messageVectorCopy)
-                message(object);
-
-            messageVectorCopy.clear();
+#ifdef BUILD_METRICS
+            m_stats = stats;
+#endif
         }
+
+#ifdef BUILD_METRICS
+        Stats const& GetStats() const { return m_stats; }
+#endif
+
     private:
-        std::vector<std::function<void(T*)>> m_messageVector;
-        std::mutex m_messageMutex;  
+        struct Node
+        {
+            Node() : next(nullptr) {}
+            template <typename F>
+            explicit Node(F&& callable) : next(nullptr), message(std::forward<F>(callable))
+#ifdef BUILD_METRICS
+                , created(std::chrono::steady_clock::now())
+#endif
+            {}
+
+            std::atomic<Node*> next;
+            Message message;
+#ifdef BUILD_METRICS
+            std::chrono::steady_clock::time_point created;
+#endif
+
+            BLOCK_POOL_ALLOCATED
+        };
+
+        void Push(Node* node)
+        {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        // the stub node keeps the list non empty, so producers never touch m_tail
+        Node* Pop()
+        {
+            Node* tail = m_tail;
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (tail == &m_stub)
+            {
+                if (!next)
+                    return nullptr;
+                m_tail = next;
+                tail = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+
+            if (next)
+            {
+                m_tail = next;
+                return tail;
+            }
+
+            // tail is not the newest node, its successor is still being linked
+            if (tail != m_head.load(std::memory_order_acquire))
+                return nullptr;
+
+            Push(&m_stub);
+            next = tail->next.load(std::memory_order_acquire);
+            if (next)
+            {
+                m_tail = next;
+                return tail;
+            }
+            return nullptr;
+        }
+
+        alignas(64) std::atomic<Node*> m_head;              // newest node, producers
+        alignas(64) Node* m_tail;                           // oldest node, consumer
+        Node m_stub;
+#ifdef BUILD_METRICS
+        Stats m_stats;
+#endif
 };
 
-#endif
\ No newline at end of file
+#endif
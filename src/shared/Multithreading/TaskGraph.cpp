@@ -0,0 +1,112 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Multithreading/TaskGraph.h"
+#include "Log.h"
+#include "Util/Errors.h"
+#include "Util/Timer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+uint32 TaskGraph::AddTask(char const* name, Task const& task, std::vector<uint32> const& dependencies)
+{
+    uint32 const id = uint32(m_nodes.size());
+    m_nodes.push_back({ name, task, {}, uint32(dependencies.size()) });
+
+    for (uint32 dependency : dependencies)
+    {
+        MANGOS_ASSERT(dependency < id);
+        m_nodes[dependency].dependents.push_back(id);
+    }
+
+    return id;
+}
+
+void TaskGraph::RunNode(Node const& node) const
+{
+    uint32 const startTime = WorldTimer::getMSTime();
+    node.task();
+    sLog.outString(">> %s done in %u ms", node.name.c_str(), WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()));
+}
+
+void TaskGraph::Run(uint32 threads, Task const& threadStart, Task const& threadEnd)
+{
+    if (threads <= 1 || m_nodes.size() <= 1)
+    {
+        for (Node const& node : m_nodes)
+            RunNode(node);
+        return;
+    }
+
+    std::mutex lock;
+    std::condition_variable readyCondition;
+    std::deque<uint32> ready;
+    std::vector<uint32> pending(m_nodes.size());
+    size_t finished = 0;
+
+    for (uint32 i = 0; i < m_nodes.size(); ++i)
+    {
+        pending[i] = m_nodes[i].dependencyCount;
+        if (!pending[i])
+            ready.push_back(i);
+    }
+
+    auto worker = [&]()
+    {
+        if (threadStart)
+            threadStart();
+
+        std::unique_lock<std::mutex> guard(lock);
+        while (true)
+        {
+            readyCondition.wait(guard, [&]() { return !ready.empty() || finished == m_nodes.size(); });
+            if (ready.empty())
+                break;
+
+            uint32 const id = ready.front();
+            ready.pop_front();
+
+            guard.unlock();
+            RunNode(m_nodes[id]);
+            guard.lock();
+
+            ++finished;
+            for (uint32 dependent : m_nodes[id].dependents)
+                if (!--pending[dependent])
+                    ready.push_back(dependent);
+
+            readyCondition.notify_all();
+        }
+        guard.unlock();
+
+        if (threadEnd)
+            threadEnd();
+    };
+
+    std::vector<std::thread> workers;
+    threads = std::min(threads, uint32(m_nodes.size()));
+    for (uint32 i = 0; i < threads; ++i)
+        workers.emplace_back(worker);
+
+    for (std::thread& thread : workers)
+        thread.join();
+}
@@ -0,0 +1,57 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TASKGRAPH_H
+#define MANGOS_TASKGRAPH_H
+
+#include "Platform/Define.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Set of named tasks with declared dependencies, run once each.
+// A task may only depend on tasks added before it, so insertion order is always
+// a valid serial order. With several threads a task starts as soon as all of its
+// dependencies have finished.
+class TaskGraph
+{
+    public:
+        typedef std::function<void()> Task;
+
+        // returns the id to use in the dependency list of later tasks
+        uint32 AddTask(char const* name, Task const& task, std::vector<uint32> const& dependencies = {});
+
+        // blocks until all tasks are done, threadStart/threadEnd run on each worker thread
+        void Run(uint32 threads, Task const& threadStart = nullptr, Task const& threadEnd = nullptr);
+
+    private:
+        struct Node
+        {
+            std::string name;
+            Task task;
+            std::vector<uint32> dependents;
+            uint32 dependencyCount;
+        };
+
+        void RunNode(Node const& node) const;
+
+        std::vector<Node> m_nodes;
+};
+
+#endif
@@ -23,6 +23,10 @@
 
 #include <boost/asio.hpp>
 
+#ifdef SO_REUSEPORT
+#include <unistd.h>
+#endif
+
 #include <memory>
 #include <thread>
 #include <vector>
@@ -33,50 +37,84 @@ namespace MaNGOS
     class Listener
     {
         private:
+            // a connection accepted by an overloaded thread is moved when another one is this much lighter
+            static constexpr double MigrateLoadFactor = 1.25;
+
             boost::asio::io_service m_service;
             boost::asio::ip::tcp::acceptor m_acceptor;
 
             std::thread m_acceptorThread;
             std::vector<std::unique_ptr<NetworkThread<SocketType>>> m_workerThreads;
 
+            // every worker thread accepts on its own SO_REUSEPORT acceptor
+            bool m_perThreadAccept;
+
             // the time in milliseconds to sleep a worker thread at the end of each tick
             const int SleepInterval = 100;
 
-            NetworkThread<SocketType> *SelectWorker() const
+            // least loaded worker by measured traffic, not by socket count, so heavy clients are spread out
+            NetworkThread<SocketType> *SelectWorker(double* load = nullptr) const
             {
                 int minIndex = 0;
-                size_t minSize = m_workerThreads[minIndex]->Size();
+                double minLoad = m_workerThreads[minIndex]->Load();
 
                 for (size_t i = 1; i < m_workerThreads.size(); ++i)
                 {
-                    const size_t size = m_workerThreads[i]->Size();
+                    const double workerLoad = m_workerThreads[i]->Load();
 
-                    if (size < minSize)
+                    if (workerLoad < minLoad)
                     {
-                        minSize = size;
+                        minLoad = workerLoad;
                         minIndex = i;
                     }
                 }
 
+                if (load)
+                    *load = minLoad;
+
                 return m_workerThreads[minIndex].get();
             }
 
             void BeginAccept();
             void OnAccept(NetworkThread<SocketType> *worker, std::shared_ptr<SocketType> const& socket, const boost::system::error_code &ec);
 
+            void BeginThreadAccept(NetworkThread<SocketType> *worker);
+            void OnThreadAccept(NetworkThread<SocketType> *worker, std::shared_ptr<SocketType> const& socket, const boost::system::error_code &ec);
+
         public:
-            Listener(std::string const& address, int port, int workerThreads);
+            Listener(std::string const& address, int port, int workerThreads, bool reusePort = false);
             ~Listener();
     };
 
     template <typename SocketType>
-    Listener<SocketType>::Listener(std::string const& address, int port, int workerThreads)
-    : m_service(), m_acceptor(m_service, boost::asio::ip::tcp::endpoint(boost::asio::ip::address::from_string(address), port))
+    Listener<SocketType>::Listener(std::string const& address, int port, int workerThreads, bool reusePort)
+    : m_service(), m_acceptor(m_service), m_perThreadAccept(false)
     {
         m_workerThreads.reserve(workerThreads);
         for (auto i = 0; i < workerThreads; ++i)
             m_workerThreads.push_back(std::unique_ptr<NetworkThread<SocketType>>(new NetworkThread<SocketType>));
 
+        boost::asio::ip::tcp::endpoint const endpoint(boost::asio::ip::address::from_string(address), port);
+
+#ifdef SO_REUSEPORT
+        m_perThreadAccept = reusePort && workerThreads > 1;
+#endif
+
+        if (m_perThreadAccept)
+        {
+            for (auto const& worker : m_workerThreads)
+            {
+                worker->OpenAcceptor(endpoint, true);
+                BeginThreadAccept(worker.get());
+            }
+            return;
+        }
+
+        m_acceptor.open(endpoint.protocol());
+        m_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+        m_acceptor.bind(endpoint);
+        m_acceptor.listen();
+
         BeginAccept();
 
         m_acceptorThread = std::thread([this]() { m_service.run(); });
@@ -85,6 +123,14 @@ namespace MaNGOS
     template <typename SocketType>
     Listener<SocketType>::~Listener()
     {
+        // accept handlers of the worker threads use this listener, stop them before anything is destroyed
+        if (m_perThreadAccept)
+        {
+            for (auto const& worker : m_workerThreads)
+                worker->CloseAcceptor();
+            return;
+        }
+
         // Close the acceptor. This will cancel any asynchronous accept
         // operation and should stop the acceptor thread. Note that closing
         // the acceptor needs to be done in the acceptor thread, because
@@ -118,6 +164,61 @@ namespace MaNGOS
         if (m_acceptor.is_open())
             BeginAccept();
     }
+
+    template <typename SocketType>
+    void Listener<SocketType>::BeginThreadAccept(NetworkThread<SocketType> *worker)
+    {
+        auto socket = worker->CreateSocket();
+
+        worker->GetAcceptor().async_accept(socket->GetAsioSocket(),
+            [this, worker, socket] (const boost::system::error_code &ec)
+        {
+            this->OnThreadAccept(worker, socket, ec);
+        });
+    }
+
+    template <typename SocketType>
+    void Listener<SocketType>::OnThreadAccept(NetworkThread<SocketType> *worker, std::shared_ptr<SocketType> const& socket, const boost::system::error_code &ec)
+    {
+        if (ec)
+        {
+            worker->RemoveSocket(socket.get());
+            if (!worker->GetAcceptor().is_open())
+                return;
+        }
+        else
+        {
+            // the kernel placed the connection by address hash, move it when another thread is clearly less loaded
+            double minLoad;
+            auto target = SelectWorker(&minLoad);
+            if (target != worker && worker->Load() > (minLoad + NetworkThread<SocketType>::ConnectionLoad()) * MigrateLoadFactor)
+            {
+                boost::system::error_code error;
+                auto const protocol = socket->GetAsioSocket().local_endpoint(error).protocol();
+                auto const handle = socket->GetAsioSocket().release(error);
+                worker->RemoveSocket(socket.get());
+
+                if (!error)
+                {
+                    auto moved = target->CreateSocket();
+                    moved->GetAsioSocket().assign(protocol, handle, error);
+                    if (error)
+                    {
+                        target->RemoveSocket(moved.get());
+#ifdef SO_REUSEPORT
+                        ::close(handle);
+#endif
+                    }
+                    else
+                        moved->Open();
+                }
+            }
+            else
+                socket->Open();
+        }
+
+        BeginThreadAccept(worker);
+    }
 }
 
 #endif /* !__LISTENER_HPP_ */
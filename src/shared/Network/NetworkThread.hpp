@@ -23,6 +23,9 @@
 
 #include <boost/asio.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <thread>
 #include <mutex>
 #include <unordered_set>
@@ -33,18 +36,40 @@ namespace MaNGOS
     class NetworkThread
     {
         private:
+            // minimum time between two load samples, in seconds
+            static constexpr double LoadSampleInterval = 1.0;
+            // period of the moving average over the samples, in seconds
+            static constexpr double LoadAveragePeriod = 10.0;
+            // fixed costs of a packet and of an open connection, expressed as bytes per second
+            static constexpr double PacketWeight = 64.0;
+            static constexpr double SocketWeight = 256.0;
+
             boost::asio::io_service m_service;
 
             std::mutex m_socketLock;
             std::unordered_set<std::shared_ptr<SocketType>> m_sockets;
 
+            std::shared_ptr<NetworkLoad> m_load;
+
+            std::mutex m_loadLock;
+            std::chrono::steady_clock::time_point m_loadSampleTime;
+            uint64 m_loadSampleBytes;
+            uint64 m_loadSamplePackets;
+            double m_byteRate;
+            double m_packetRate;
+
+            // only used with per thread accepting, owned here so it is destroyed before the service
+            std::unique_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
+
             // note that the work member *must* be declared after the service member for the work constructor to function correctly
             std::unique_ptr<boost::asio::io_service::work> m_work;
 
             std::thread m_serviceThread;
 
         public:
-            NetworkThread() : m_work(new boost::asio::io_service::work(m_service)), m_serviceThread([this] { boost::system::error_code ec; this->m_service.run(ec); })
+            NetworkThread() : m_load(std::make_shared<NetworkLoad>()), m_loadSampleTime(std::chrono::steady_clock::now()), m_loadSampleBytes(0), m_loadSamplePackets(0),
+                m_byteRate(0.0), m_packetRate(0.0), m_work(new boost::asio::io_service::work(m_service)),
+                m_serviceThread([this] { boost::system::error_code ec; this->m_service.run(ec); })
             {
             }
 
@@ -68,6 +93,41 @@ namespace MaNGOS
 
             size_t Size() const { return m_sockets.size(); }
 
+            boost::asio::io_service& GetService() { return m_service; }
+
+            // estimated cost of the traffic handled by this thread, in weighted bytes per second
+            double Load()
+            {
+                std::lock_guard<std::mutex> guard(m_loadLock);
+
+                auto const now = std::chrono::steady_clock::now();
+                double const elapsed = std::chrono::duration<double>(now - m_loadSampleTime).count();
+                if (elapsed >= LoadSampleInterval)
+                {
+                    uint64 const bytes = m_load->bytes.load(std::memory_order_relaxed);
+                    uint64 const packets = m_load->packets.load(std::memory_order_relaxed);
+
+                    double const weight = std::min(1.0, elapsed / LoadAveragePeriod);
+                    m_byteRate += (double(bytes - m_loadSampleBytes) / elapsed - m_byteRate) * weight;
+                    m_packetRate += (double(packets - m_loadSamplePackets) / elapsed - m_packetRate) * weight;
+
+                    m_loadSampleTime = now;
+                    m_loadSampleBytes = bytes;
+                    m_loadSamplePackets = packets;
+                }
+
+                return m_byteRate + m_packetRate * PacketWeight + double(Size()) * SocketWeight;
+            }
+
+            static double ConnectionLoad() { return SocketWeight; }
+
+            // acceptor bound to the shared port, to be used from this thread only
+            boost::asio::ip::tcp::acceptor& OpenAcceptor(boost::asio::ip::tcp::endpoint const& endpoint, bool reusePort);
+            boost::asio::ip::tcp::acceptor& GetAcceptor() { return *m_acceptor; }
+
+            // closes the acceptor from within the service thread and waits until the aborted accept has been handled
+            void CloseAcceptor();
+
             std::shared_ptr<SocketType> CreateSocket();
 
             void RemoveSocket(Socket *socket)
@@ -86,8 +146,42 @@ namespace MaNGOS
 
         MANGOS_ASSERT(i.second);
 
+        (*i.first)->SetLoadCounter(m_load);
+
         return *i.first;
     }
+
+    template <typename SocketType>
+    boost::asio::ip::tcp::acceptor& NetworkThread<SocketType>::OpenAcceptor(boost::asio::ip::tcp::endpoint const& endpoint, bool reusePort)
+    {
+        m_acceptor.reset(new boost::asio::ip::tcp::acceptor(m_service));
+        m_acceptor->open(endpoint.protocol());
+        m_acceptor->set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+#ifdef SO_REUSEPORT
+        // every thread listens on the same port and the kernel spreads incoming connections over them
+        if (reusePort)
+            m_acceptor->set_option(boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+#endif
+        m_acceptor->bind(endpoint);
+        m_acceptor->listen();
+        return *m_acceptor;
+    }
+
+    template <typename SocketType>
+    void NetworkThread<SocketType>::CloseAcceptor()
+    {
+        if (!m_acceptor)
+            return;
+
+        // the aborted accept completion is queued by close(), so signal from a handler posted after it
+        std::promise<void> closed;
+        m_service.post([this, &closed]()
+        {
+            m_acceptor->close();
+            m_service.post([&closed]() { closed.set_value(); });
+        });
+        closed.get_future().wait();
+    }
 }
 
 #endif /* !__NETWORK_THREAD_HPP_ */
\ No newline at end of file
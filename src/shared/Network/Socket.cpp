@@ -18,6 +18,7 @@
 
 #include "Socket.hpp"
 #include "Log.h"
+#include "Util/ByteBufferPool.h"
 
 #include <boost/asio.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
@@ -33,10 +34,23 @@
 namespace MaNGOS
 {
     Socket::Socket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
-        : m_writeState(WriteState::Idle), m_readState(ReadState::Idle), m_socket(service),
-          m_closeHandler(std::move(closeHandler)), m_outBufferFlushTimer(service), m_address("0.0.0.0"),
+        : m_writeState(WriteState::Idle), m_readState(ReadState::Idle), m_readPaused(false), m_socket(service),
+          m_closeHandler(std::move(closeHandler)), m_outSegmentsInFlight(0), m_bufferedBytes(0), m_sendCount(0), m_sendRateCount(0),
+          m_sendRateTime(std::chrono::steady_clock::now()), m_outBufferFlushTimer(service), m_address("0.0.0.0"),
           m_remoteAddress(boost::asio::ip::address()), m_remotePort(0){}
 
+    float Socket::ConsumeSendRate()
+    {
+        auto const now = std::chrono::steady_clock::now();
+        uint64 const count = m_sendCount.load(std::memory_order_relaxed);
+        float const elapsed = std::chrono::duration<float>(now - m_sendRateTime).count();
+        float const rate = elapsed > 0.0f ? float(count - m_sendRateCount) / elapsed : 0.0f;
+
+        m_sendRateTime = now;
+        m_sendRateCount = count;
+        return rate;
+    }
+
     bool Socket::Open()
     {
         try
@@ -52,8 +66,6 @@ namespace MaNGOS
             return false;
         }
 
-        m_outBuffer.reset(new PacketBuffer);
-        m_secondaryOutBuffer.reset(new PacketBuffer);
         m_inBuffer.reset(new PacketBuffer);
 
         StartAsyncRead();
@@ -106,6 +118,7 @@ namespace MaNGOS
         }
 
         m_inBuffer->m_writePosition += length;
+        AddLoad(length, 0);
 
         const size_t available = m_socket.available();
 
@@ -117,6 +130,11 @@ namespace MaNGOS
             return;
         }
 
+        ProcessInBuffer();
+    }
+
+    void Socket::ProcessInBuffer()
+    {
         // we must repeat this in case we have read in multiple messages from the client
         while (m_inBuffer->m_readPosition < m_inBuffer->m_writePosition)
         {
@@ -140,6 +158,15 @@ namespace MaNGOS
 
                 return;
             }
+
+            AddLoad(0, 1);
+
+            // the rest stays in the buffer, no read is started until the socket resumes
+            if (m_readPaused)
+            {
+                m_readState = ReadState::Idle;
+                return;
+            }
         }
 
         // at this point, the packet has been read and successfully processed.  reset the buffer.
@@ -148,6 +175,22 @@ namespace MaNGOS
         StartAsyncRead();
     }
 
+    void Socket::ResumeRead()
+    {
+        std::shared_ptr<Socket> ptr = shared<Socket>();
+        Post([ptr]()
+        {
+            ptr->m_readPaused = false;
+            if (!ptr->IsClosed())
+                ptr->ProcessInBuffer();
+        });
+    }
+
+    void Socket::Post(std::function<void()> handler)
+    {
+        boost::asio::post(m_socket.get_executor(), std::move(handler));
+    }
+
     void Socket::OnError(const boost::system::error_code& error)
     {
         // skip logging this code because it happens whenever anyone disconnects.  reduces spam.
@@ -172,33 +215,72 @@ namespace MaNGOS
     {
         std::lock_guard<std::mutex> guard(m_mutex);
 
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
-
         // write the header
-        outBuffer->Write(header, headerSize);
+        AppendOut(header, headerSize);
 
         // write the content
-        outBuffer->Write(content, contentSize);
+        AppendOut(content, contentSize);
 
-        // flush data if need
-        if (m_writeState == WriteState::Idle)
-            StartWriteFlushTimer();
+        OnDataQueued(headerSize + contentSize);
     }
 
-    void Socket::Write(const char* buffer, int length)
+    void Socket::Write(const char* header, int headerSize, std::shared_ptr<const uint8> content, int contentSize)
     {
         std::lock_guard<std::mutex> guard(m_mutex);
 
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+        // only the header is copied, small contents are not worth a separate buffer
+        AppendOut(header, headerSize);
+
+        if (contentSize < ZeroCopyThreshold)
+            AppendOut(reinterpret_cast<const char*>(content.get()), contentSize);
+        else
+        {
+            m_outSegments.emplace_back();
+            m_outSegments.back().shared = std::move(content);
+            m_outSegments.back().length = contentSize;
+        }
+
+        OnDataQueued(headerSize + contentSize);
+    }
+
+    void Socket::Write(const char* buffer, int length)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
 
         // write the header
-        outBuffer->Write(buffer, length);
+        AppendOut(buffer, length);
+
+        OnDataQueued(length);
+    }
+
+// note that this function assumes that the socket mutex is locked
+    void Socket::OnDataQueued(size_t length)
+    {
+        AddLoad(0, 1);
+        m_bufferedBytes += length;
 
         // flush data if need
         if (m_writeState == WriteState::Idle)
             StartWriteFlushTimer();
+        // enough data for a full send, do not wait for the rest of the coalescing period
+        else if (m_writeState == WriteState::Buffering && m_bufferedBytes >= CoalesceBytes)
+            ForceFlushOut();
+    }
+
+// note that this function assumes that the socket mutex is locked
+    void Socket::AppendOut(const char* buffer, int length)
+    {
+        assert(buffer != nullptr && length != 0);
+
+        // copy into the last owned segment, unless it is part of the write currently underway
+        if (m_outSegments.empty() || m_outSegments.size() <= m_outSegmentsInFlight || m_outSegments.back().shared)
+        {
+            m_outSegments.emplace_back();
+            m_outSegments.back().owned = ByteBufferPool::Acquire(std::max(length, DEFAULT_BUFFER_SIZE));
+        }
+
+        std::vector<uint8>& owned = m_outSegments.back().owned;
+        owned.insert(owned.end(), reinterpret_cast<const uint8*>(buffer), reinterpret_cast<const uint8*>(buffer) + length);
     }
 
 // note that this function assumes that the socket mutex is locked
@@ -216,8 +298,13 @@ namespace MaNGOS
 
         m_writeState = WriteState::Buffering;
 
+        // a socket that has not sent anything for a while sends right away, only sockets which
+        // flushed recently are busy enough for coalescing to save sends
+        auto const now = std::chrono::steady_clock::now();
+        int const delay = now - m_lastFlushTime < std::chrono::milliseconds(BufferTimeout) ? BufferTimeout : 0;
+
         std::shared_ptr<Socket> ptr = shared<Socket>();
-        m_outBufferFlushTimer.expires_from_now(boost::posix_time::milliseconds(int(BufferTimeout)));
+        m_outBufferFlushTimer.expires_from_now(boost::posix_time::milliseconds(delay));
         m_outBufferFlushTimer.async_wait([ptr](const boost::system::error_code&) { ptr->FlushOut(); });
     }
 
@@ -234,11 +321,27 @@ namespace MaNGOS
 
         assert(m_writeState == WriteState::Buffering);
 
-        // at this point we are guarunteed that there is data to send in the primary buffer.  send it.
+        // at this point we are guarunteed that there is data to send.  send it.
         m_writeState = WriteState::Sending;
+        m_lastFlushTime = std::chrono::steady_clock::now();
+        m_bufferedBytes = 0;
+
+        StartAsyncWrite();
+    }
+
+// note that this function assumes that the socket mutex is locked
+    void Socket::StartAsyncWrite()
+    {
+        // gather the pending segments into a single write, asio hands them to the kernel as one vectored send
+        size_t count = 0;
+        for (auto itr = m_outSegments.begin(); itr != m_outSegments.end() && count < MaxWriteBuffers; ++itr, ++count)
+            m_outBuffers[count] = boost::asio::const_buffer(itr->Data(), itr->Size());
+
+        m_outSegmentsInFlight = count;
+        m_sendCount.fetch_add(1, std::memory_order_relaxed);
 
         std::shared_ptr<Socket> ptr = shared<Socket>();
-        m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
+        m_socket.async_write_some(OutBufferSequence(m_outBuffers.data(), count),
                                   make_custom_alloc_handler(m_allocator,
         [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length); }));
     }
@@ -270,37 +373,32 @@ namespace MaNGOS
         std::lock_guard<std::mutex> guard(m_mutex);
 
         assert(m_writeState == WriteState::Sending);
-        assert(length <= m_outBuffer->m_writePosition);
 
-        // if there is data left to write, move it to the start of the buffer
-        if (length < m_outBuffer->m_writePosition)
-        {
-            memcpy(&(m_outBuffer->m_buffer[0]), &(m_outBuffer->m_buffer[length]), (m_outBuffer->m_writePosition - length) * sizeof(m_outBuffer->m_buffer[0]));
-            m_outBuffer->m_writePosition -= length;
-        }
-        // if not, reset the write pointer
-        else
-            m_outBuffer->m_writePosition = 0;
+        AddLoad(length, 0);
 
-        // if there is data in the secondary buffer, append it to the primary buffer
-        if (m_secondaryOutBuffer->m_writePosition > 0)
+        // drop what has been sent, a partially sent segment keeps its remainder at the front
+        m_outSegmentsInFlight = 0;
+        while (length > 0)
         {
-            // do we have enough space? if not, resize
-            if (m_outBuffer->m_buffer.size() < (m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition))
-                m_outBuffer->m_buffer.resize(m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition);
+            assert(!m_outSegments.empty());
 
-            memcpy(&(m_outBuffer->m_buffer[m_outBuffer->m_writePosition]), &(m_secondaryOutBuffer->m_buffer[0]), (m_secondaryOutBuffer->m_writePosition) * sizeof(m_secondaryOutBuffer->m_buffer[0]));
+            OutSegment& segment = m_outSegments.front();
+            size_t const size = segment.Size();
+            if (length < size)
+            {
+                segment.offset += length;
+                break;
+            }
 
-            m_outBuffer->m_writePosition += m_secondaryOutBuffer->m_writePosition;
-            m_secondaryOutBuffer->m_writePosition = 0;
+            length -= size;
+            if (!segment.shared)
+                ByteBufferPool::Release(std::move(segment.owned));
+            m_outSegments.pop_front();
         }
 
-        std::shared_ptr<Socket> ptr = shared<Socket>();
         // if there is any data to write, do so immediately
-        if (m_outBuffer->m_writePosition > 0)
-            m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-                                      make_custom_alloc_handler(m_allocator,
-            [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length);}));
+        if (!m_outSegments.empty())
+            StartAsyncWrite();
         else
             m_writeState = WriteState::Idle;
     }
@@ -25,20 +25,43 @@
 
 #include <boost/asio.hpp>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <memory>
 #include <string>
 #include <mutex>
 #include <functional>
+#include <vector>
 
 namespace MaNGOS
 {
+    // traffic counters shared by all sockets of a network thread, used for load based socket placement
+    struct NetworkLoad
+    {
+        NetworkLoad() : bytes(0), packets(0) {}
+
+        std::atomic<uint64> bytes;                          // received and sent
+        std::atomic<uint64> packets;                        // processed incoming and queued outgoing
+    };
+
     class Socket : public std::enable_shared_from_this<Socket>
     {
         private:
-            // buffer timeout period, in milliseconds.  higher values decrease responsiveness
-            // ingame but increase bandwidth efficiency by reducing tcp overhead.
+            // buffer timeout period of busy sockets, in milliseconds.  higher values decrease responsiveness
+            // ingame but increase bandwidth efficiency by reducing tcp overhead.  idle sockets flush right away.
             static const int BufferTimeout = 50;
 
+            // contents at least this large are referenced instead of copied into the output buffer
+            static const int ZeroCopyThreshold = 1024;
+
+            // buffered bytes that end the coalescing period early
+            static const size_t CoalesceBytes = 8192;
+
+            // maximum number of buffers handed to a single gather write
+            static const size_t MaxWriteBuffers = 64;
+
             enum class WriteState
             {
                 Idle,       // no write operation is currently underway
@@ -54,14 +77,63 @@ namespace MaNGOS
 
             WriteState m_writeState;
             ReadState m_readState;
+            bool m_readPaused;                              // received data is kept unprocessed until ResumeRead()
 
             boost::asio::ip::tcp::socket m_socket;
 
             std::function<void(Socket *)> m_closeHandler;
 
+            std::shared_ptr<NetworkLoad> m_load;
+
+            void AddLoad(size_t bytes, size_t packets)
+            {
+                if (!m_load)
+                    return;
+
+                m_load->bytes.fetch_add(bytes, std::memory_order_relaxed);
+                m_load->packets.fetch_add(packets, std::memory_order_relaxed);
+            }
+
+            // a piece of outgoing data, either copied into owned storage or shared with the sender
+            struct OutSegment
+            {
+                OutSegment() : offset(0), length(0) {}
+
+                std::vector<uint8> owned;
+                std::shared_ptr<const uint8> shared;
+                size_t offset;                              // bytes already sent
+                size_t length;                              // size of shared content, owned uses its size()
+
+                const uint8* Data() const { return (shared ? shared.get() : owned.data()) + offset; }
+                size_t Size() const { return (shared ? length : owned.size()) - offset; }
+            };
+
+            // buffer sequence over m_outBuffers, avoids copying a container into every write operation
+            struct OutBufferSequence
+            {
+                typedef boost::asio::const_buffer value_type;
+                typedef const boost::asio::const_buffer* const_iterator;
+
+                OutBufferSequence(const_iterator first, size_t count) : m_begin(first), m_end(first + count) {}
+
+                const_iterator begin() const { return m_begin; }
+                const_iterator end() const { return m_end; }
+
+                const_iterator m_begin;
+                const_iterator m_end;
+            };
+
             std::unique_ptr<PacketBuffer> m_inBuffer;
-            std::unique_ptr<PacketBuffer> m_outBuffer;
-            std::unique_ptr<PacketBuffer> m_secondaryOutBuffer;
+
+            std::deque<OutSegment> m_outSegments;
+            size_t m_outSegmentsInFlight;                   // front segments handed to the current write, must not change
+            std::array<boost::asio::const_buffer, MaxWriteBuffers> m_outBuffers;
+            size_t m_bufferedBytes;                         // queued since the last flush
+            std::chrono::steady_clock::time_point m_lastFlushTime;
+
+            std::atomic<uint64> m_sendCount;                // write operations issued, each one is a send syscall
+            uint64 m_sendRateCount;
+            std::chrono::steady_clock::time_point m_sendRateTime;
 
             std::mutex m_mutex;
             std::mutex m_closeMutex;
@@ -69,10 +141,14 @@ namespace MaNGOS
 
             void StartAsyncRead();
             void OnRead(const boost::system::error_code &error, size_t length);
+            void ProcessInBuffer();
 
             void StartWriteFlushTimer();
             void OnWriteComplete(const boost::system::error_code &error, size_t length);
             void FlushOut();
+            void OnDataQueued(size_t length);
+            void AppendOut(const char *buffer, int length);
+            void StartAsyncWrite();
 
             void OnError(const boost::system::error_code &error);
 
@@ -90,6 +166,14 @@ namespace MaNGOS
 
             void ForceFlushOut();
 
+            // stop after the packet being processed, for handlers waiting on something else than the network
+            void PauseRead() { m_readPaused = true; }
+            bool IsReadPaused() const { return m_readPaused; }
+            // continue with the data received so far, from any thread
+            void ResumeRead();
+            // run a handler on the network thread of the socket, serialized with its reads
+            void Post(std::function<void()> handler);
+
         public:
             Socket(boost::asio::io_service &service, std::function<void (Socket *)> closeHandler);
             virtual ~Socket() = default;
@@ -97,6 +181,11 @@ namespace MaNGOS
             virtual bool Open();
             void Close();
 
+            void SetLoadCounter(std::shared_ptr<NetworkLoad> load) { m_load = std::move(load); }
+
+            // send syscalls per second since the previous call, meant for a single periodic reader
+            float ConsumeSendRate();
+
             bool IsClosed() const { return !m_socket.is_open(); }
             virtual bool Deletable() const { return IsClosed(); }
 
@@ -105,6 +194,8 @@ namespace MaNGOS
 
             void Write(const char *buffer, int length);
             void Write(const char *header, int headerSize, const char* content, int contentSize);
+            // content is kept alive until sent instead of being copied, when it is large enough
+            void Write(const char *header, int headerSize, std::shared_ptr<const uint8> content, int contentSize);
 
             boost::asio::ip::tcp::socket &GetAsioSocket() { return m_socket; }
 
@@ -0,0 +1,188 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Util/BlockPool.h"
+#include "Util/TSS.h"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace
+{
+    size_t const SIZE_CLASS_SHIFT = 6;                      // 64 byte granularity
+    size_t const SIZE_CLASS_COUNT = 64;                     // up to 4KB
+    size_t const LOCAL_CACHE_BYTES = 64 * 1024;             // per thread and class
+    size_t const SHARED_CACHE_BYTES = 1024 * 1024;          // per class
+
+    size_t ClassIndex(size_t size) { return (size - 1) >> SIZE_CLASS_SHIFT; }
+    size_t ClassSize(size_t index) { return (index + 1) << SIZE_CLASS_SHIFT; }
+    size_t LocalLimit(size_t index) { return std::max<size_t>(8, std::min<size_t>(256, LOCAL_CACHE_BYTES / ClassSize(index))); }
+    size_t SharedLimit(size_t index) { return std::max<size_t>(32, SHARED_CACHE_BYTES / ClassSize(index)); }
+
+    // free blocks are chained through their first bytes
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct BlockList
+    {
+        BlockList() : head(nullptr), count(0) {}
+
+        void Push(void* block)
+        {
+            FreeBlock* node = static_cast<FreeBlock*>(block);
+            node->next = head;
+            head = node;
+            ++count;
+        }
+
+        void* Pop()
+        {
+            FreeBlock* node = head;
+            head = node->next;
+            --count;
+            return node;
+        }
+
+        FreeBlock* head;
+        size_t count;
+    };
+
+    std::atomic<uint64> allocatedCount(0);
+    std::atomic<uint64> reusedCount(0);
+    std::atomic<uint64> releasedCount(0);
+
+    void ReleaseBlock(void* block)
+    {
+        ::operator delete(block);
+        releasedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    struct SharedCache
+    {
+        std::mutex lock;
+        BlockList lists[SIZE_CLASS_COUNT];
+    };
+
+    SharedCache& GetSharedCache()
+    {
+        static SharedCache cache;
+        return cache;
+    }
+
+    struct LocalCache
+    {
+        // hand the blocks of an exiting thread to the shared lists
+        ~LocalCache()
+        {
+            SharedCache& shared = GetSharedCache();
+            std::lock_guard<std::mutex> guard(shared.lock);
+            for (size_t index = 0; index < SIZE_CLASS_COUNT; ++index)
+            {
+                BlockList& local = lists[index];
+                BlockList& list = shared.lists[index];
+                while (local.count)
+                {
+                    void* block = local.Pop();
+                    if (list.count < SharedLimit(index))
+                        list.Push(block);
+                    else
+                        ReleaseBlock(block);
+                }
+            }
+        }
+
+        BlockList lists[SIZE_CLASS_COUNT];
+    };
+
+    MaNGOS::thread_local_ptr<LocalCache> localCache;
+}
+
+void* BlockPool::Allocate(size_t size)
+{
+    if (size == 0 || size > ClassSize(SIZE_CLASS_COUNT - 1))
+        return ::operator new(size);
+
+    size_t const index = ClassIndex(size);
+    BlockList& local = localCache->lists[index];
+    if (!local.count)
+    {
+        // refill half of the local cache at once to keep the shared lock cold
+        SharedCache& shared = GetSharedCache();
+        std::lock_guard<std::mutex> guard(shared.lock);
+        BlockList& list = shared.lists[index];
+        size_t const count = std::min(list.count, LocalLimit(index) / 2);
+        for (size_t i = 0; i < count; ++i)
+            local.Push(list.Pop());
+    }
+
+    if (!local.count)
+    {
+        allocatedCount.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(ClassSize(index));
+    }
+
+    reusedCount.fetch_add(1, std::memory_order_relaxed);
+    return local.Pop();
+}
+
+void BlockPool::Free(void* block, size_t size)
+{
+    if (!block)
+        return;
+
+    if (size == 0 || size > ClassSize(SIZE_CLASS_COUNT - 1))
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    size_t const index = ClassIndex(size);
+    BlockList& local = localCache->lists[index];
+    if (local.count < LocalLimit(index))
+    {
+        local.Push(block);
+        return;
+    }
+
+    // local cache full, move half of it to the shared list
+    {
+        SharedCache& shared = GetSharedCache();
+        std::lock_guard<std::mutex> guard(shared.lock);
+        BlockList& list = shared.lists[index];
+        size_t const count = local.count / 2;
+        for (size_t i = 0; i < count && list.count < SharedLimit(index); ++i)
+            list.Push(local.Pop());
+    }
+
+    if (local.count < LocalLimit(index))
+        local.Push(block);
+    else
+        ReleaseBlock(block);
+}
+
+BlockPool::Stats BlockPool::GetStats()
+{
+    Stats stats;
+    stats.allocated = allocatedCount.load(std::memory_order_relaxed);
+    stats.reused = reusedCount.load(std::memory_order_relaxed);
+    stats.released = releasedCount.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,52 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _BLOCKPOOL_H
+#define _BLOCKPOOL_H
+
+#include "Common.h"
+
+// Size-classed recycler for small, frequently churned objects.
+// Classes opt in by forwarding their operator new and delete here. Freed blocks
+// stay in a cache of the releasing thread, surplus goes through a shared bounded
+// list so objects destroyed on another thread than the one that created them
+// keep circulating instead of hitting the global allocator again.
+class BlockPool
+{
+    public:
+        struct Stats
+        {
+            uint64 allocated;                               // blocks taken from the global allocator
+            uint64 reused;                                  // allocations served from a cache
+            uint64 released;                                // blocks returned to the global allocator
+        };
+
+        static void* Allocate(size_t size);
+        // size must be the one passed to Allocate
+        static void Free(void* block, size_t size);
+
+        static Stats GetStats();
+};
+
+// Forwards the sized class allocation functions to BlockPool. Deleting through a
+// virtual destructor passes the dynamic size, so derived classes share the pool.
+#define BLOCK_POOL_ALLOCATED                                                        \
+    static void* operator new(size_t size) { return BlockPool::Allocate(size); }   \
+    static void operator delete(void* block, size_t size) { BlockPool::Free(block, size); }
+
+#endif
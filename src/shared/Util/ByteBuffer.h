@@ -21,8 +21,12 @@
 
 #include "Common.h"
 #include "Util/ByteConverter.h"
+#include "Util/ByteBufferPool.h"
 #include <utf8.h>
 
+#include <string_view>
+#include <type_traits>
+
 class ByteBufferException
 {
     public:
@@ -46,25 +50,73 @@ struct Unused
     Unused() {}
 };
 
+// selects constructors taking their storage from ByteBufferPool, it is given back on destruction
+struct PooledStorageTag {};
+
 class ByteBuffer
 {
     public:
         const static size_t DEFAULT_SIZE = 0x1000;
 
         // constructor
-        ByteBuffer(): _rpos(0), _wpos(0)
+        ByteBuffer(): _rpos(0), _wpos(0), _pooled(false)
         {
             _storage.reserve(DEFAULT_SIZE);
         }
 
         // constructor
-        ByteBuffer(size_t res): _rpos(0), _wpos(0)
+        ByteBuffer(size_t res): _rpos(0), _wpos(0), _pooled(false)
         {
             _storage.reserve(res);
         }
 
+        ByteBuffer(size_t res, PooledStorageTag): _rpos(0), _wpos(0), _storage(ByteBufferPool::Acquire(res)), _pooled(true) { }
+
         // copy constructor
-        ByteBuffer(const ByteBuffer& buf): _rpos(buf._rpos), _wpos(buf._wpos), _storage(buf._storage) { }
+        ByteBuffer(const ByteBuffer& buf): _rpos(buf._rpos), _wpos(buf._wpos), _storage(buf._storage), _pooled(false) { }
+
+        // move constructor, takes over the storage together with its pool ownership
+        ByteBuffer(ByteBuffer&& buf) noexcept : _rpos(buf._rpos), _wpos(buf._wpos), _storage(std::move(buf._storage)), _pooled(buf._pooled)
+        {
+            buf._rpos = buf._wpos = 0;
+            buf._storage.clear();
+            buf._pooled = false;
+        }
+
+        // move assignment, the own pooled storage goes back to the pool before the other one is taken over
+        ByteBuffer& operator=(ByteBuffer&& buf) noexcept
+        {
+            if (this == &buf)
+                return *this;
+
+            if (_pooled)
+                ByteBufferPool::Release(std::move(_storage));
+
+            _rpos = buf._rpos;
+            _wpos = buf._wpos;
+            _storage = std::move(buf._storage);
+            _pooled = buf._pooled;
+
+            buf._rpos = buf._wpos = 0;
+            buf._storage.clear();
+            buf._pooled = false;
+            return *this;
+        }
+
+        // keeps the own storage (and its pool ownership), only the content is copied
+        ByteBuffer& operator=(const ByteBuffer& buf)
+        {
+            _rpos = buf._rpos;
+            _wpos = buf._wpos;
+            _storage = buf._storage;
+            return *this;
+        }
+
+        ~ByteBuffer()
+        {
+            if (_pooled)
+                ByteBufferPool::Release(std::move(_storage));
+        }
 
         void clear()
         {
@@ -227,6 +279,13 @@ class ByteBuffer
             return *this;
         }
 
+        // no copy, see read_string_view
+        ByteBuffer& operator>>(std::string_view& value)
+        {
+            value = read_string_view(true);
+            return *this;
+        }
+
         template<class T>
         ByteBuffer& operator>>(Unused<T> const&)
         {
@@ -297,18 +356,50 @@ class ByteBuffer
 
         void read(std::string& value, bool utf8)
         {
-            value.clear();
-            while (rpos() < size())
-            {
-                char c = read<char>();
-                if (c == 0)
-                    break;
-                value += c;
-            }
+            std::string_view view = read_string_view(utf8);
+            value.assign(view.data(), view.size());
+        }
+
+        // string up to the terminating zero (or the buffer end) without copying it,
+        // only valid as long as the buffer is alive and not written to
+        std::string_view read_string_view(bool utf8)
+        {
+            if (_rpos >= size())
+                return std::string_view();
+
+            char const* begin = reinterpret_cast<char const*>(&_storage[_rpos]);
+            size_t left = size() - _rpos;
+            char const* end = static_cast<char const*>(memchr(begin, 0, left));
+            size_t length = end ? size_t(end - begin) : left;
+
+            _rpos += end ? length + 1 : length;
+
+            std::string_view value(begin, length);
 
             // Detect invalid unicode sequence in string and raise appropriate exception
             if (utf8 && !utf8::is_valid(value.begin(), value.end()))
                 throw ByteBufferException(false, _rpos, value.length(), size());
+
+            return value;
+        }
+
+        // raw bytes without copying them, same lifetime as read_string_view
+        uint8 const* read_view(size_t len)
+        {
+            if (_rpos + len > size())
+                throw ByteBufferException(false, _rpos, len, size());
+            uint8 const* view = &_storage[_rpos];
+            _rpos += len;
+            return view;
+        }
+
+        // several fixed size values in a row with a single bounds check
+        template <typename... T> void read_bulk(T&... values)
+        {
+            constexpr size_t length = (sizeof(T) + ...);
+            if (_rpos + length > size())
+                throw ByteBufferException(false, _rpos, length, size());
+            (read_unchecked(values), ...);
         }
 
         uint64 readPackGUID()
@@ -429,6 +520,14 @@ class ByteBuffer
         void hexlike() const;
 
     private:
+        template <typename T> void read_unchecked(T& value)
+        {
+            static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, "read_bulk is for integer and floating point values");
+            memcpy(&value, &_storage[_rpos], sizeof(T));
+            EndianConvert(value);
+            _rpos += sizeof(T);
+        }
+
         // limited for internal use because can "append" any unexpected type (like pointer and etc) with hard detection problem
         template <typename T> void append(T value)
         {
@@ -439,6 +538,7 @@ class ByteBuffer
     protected:
         size_t _rpos, _wpos;
         std::vector<uint8> _storage;
+        bool _pooled;                                       // return _storage to ByteBufferPool on destruction
 };
 
 template <typename T>
@@ -0,0 +1,130 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Util/ByteBufferPool.h"
+#include "Util/TSS.h"
+
+#include <mutex>
+
+namespace
+{
+    size_t const SIZE_CLASS_MIN_SHIFT = 8;                  // 256 bytes
+    size_t const SIZE_CLASS_COUNT = 5;                      // up to 64KB
+    size_t const LOCAL_CACHE_BYTES = 256 * 1024;            // per thread and class
+    size_t const SHARED_CACHE_BYTES = 4 * 1024 * 1024;      // per class
+
+    size_t ClassSize(size_t index) { return size_t(1) << (SIZE_CLASS_MIN_SHIFT + index * 2); }
+    size_t LocalLimit(size_t index) { return std::max<size_t>(4, std::min<size_t>(64, LOCAL_CACHE_BYTES / ClassSize(index))); }
+    size_t SharedLimit(size_t index) { return std::max<size_t>(16, SHARED_CACHE_BYTES / ClassSize(index)); }
+
+    typedef std::vector<std::vector<uint8>> StorageList;
+
+    struct SharedCache
+    {
+        std::mutex lock;
+        StorageList lists[SIZE_CLASS_COUNT];
+    };
+
+    SharedCache& GetSharedCache()
+    {
+        static SharedCache cache;
+        return cache;
+    }
+
+    struct LocalCache
+    {
+        StorageList lists[SIZE_CLASS_COUNT];
+    };
+
+    MaNGOS::thread_local_ptr<LocalCache> localCache;
+}
+
+std::vector<uint8> ByteBufferPool::Acquire(size_t res)
+{
+    std::vector<uint8> storage;
+
+    size_t index = 0;
+    while (index < SIZE_CLASS_COUNT && ClassSize(index) < res)
+        ++index;
+
+    if (index == SIZE_CLASS_COUNT)
+    {
+        storage.reserve(res);
+        return storage;
+    }
+
+    StorageList& local = localCache->lists[index];
+    if (local.empty())
+    {
+        // refill half of the local cache at once to keep the shared lock cold
+        SharedCache& shared = GetSharedCache();
+        std::lock_guard<std::mutex> guard(shared.lock);
+        StorageList& list = shared.lists[index];
+        size_t const count = std::min(list.size(), LocalLimit(index) / 2);
+        for (size_t i = 0; i < count; ++i)
+        {
+            local.push_back(std::move(list.back()));
+            list.pop_back();
+        }
+    }
+
+    if (local.empty())
+    {
+        storage.reserve(ClassSize(index));
+        return storage;
+    }
+
+    storage = std::move(local.back());
+    local.pop_back();
+    return storage;
+}
+
+void ByteBufferPool::Release(std::vector<uint8>&& storage)
+{
+    size_t const capacity = storage.capacity();
+    if (capacity < ClassSize(0) || capacity > ClassSize(SIZE_CLASS_COUNT - 1) * 2)
+        return;
+
+    // largest class the storage can serve
+    size_t index = SIZE_CLASS_COUNT - 1;
+    while (ClassSize(index) > capacity)
+        --index;
+
+    storage.clear();
+
+    StorageList& local = localCache->lists[index];
+    if (local.size() < LocalLimit(index))
+    {
+        local.push_back(std::move(storage));
+        return;
+    }
+
+    // local cache full, move half of it to the shared list
+    SharedCache& shared = GetSharedCache();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    StorageList& list = shared.lists[index];
+    size_t const count = local.size() / 2;
+    for (size_t i = 0; i < count && list.size() < SharedLimit(index); ++i)
+    {
+        list.push_back(std::move(local.back()));
+        local.pop_back();
+    }
+
+    if (local.size() < LocalLimit(index))
+        local.push_back(std::move(storage));
+}
@@ -0,0 +1,39 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _BYTEBUFFERPOOL_H
+#define _BYTEBUFFERPOOL_H
+
+#include "Common.h"
+
+#include <vector>
+
+// Size-classed recycler for ByteBuffer storage.
+// Every thread keeps a small cache per size class, surplus and refills go
+// through a shared bounded list so buffers released on another thread than
+// the one that acquired them (network -> world thread) keep circulating.
+class ByteBufferPool
+{
+    public:
+        // returns an empty vector with at least res bytes of capacity
+        static std::vector<uint8> Acquire(size_t res);
+        // takes back any storage, vectors too small or too big for a size class are freed
+        static void Release(std::vector<uint8>&& storage);
+};
+
+#endif
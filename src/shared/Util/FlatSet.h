@@ -0,0 +1,81 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _FLAT_SET_H
+#define _FLAT_SET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Set kept as a sorted vector. Lookups are binary searches and iteration walks
+// contiguous memory; insert and erase shift the tail, so it suits sets that are
+// built once and modified rarely. Any insert or erase invalidates iterators.
+template <typename T>
+class FlatSet
+{
+    public:
+        typedef typename std::vector<T>::const_iterator const_iterator;
+        typedef const_iterator iterator;
+        typedef T value_type;
+        typedef size_t size_type;
+
+        const_iterator begin() const { return m_values.begin(); }
+        const_iterator end() const { return m_values.end(); }
+
+        bool empty() const { return m_values.empty(); }
+        size_t size() const { return m_values.size(); }
+        T const* data() const { return m_values.data(); }
+
+        void clear() { m_values.clear(); }
+        void reserve(size_t count) { m_values.reserve(count); }
+
+        // takes over values that are already sorted and free of duplicates
+        void assign_sorted(std::vector<T>&& values) { m_values = std::move(values); }
+
+        std::pair<const_iterator, bool> insert(T const& value)
+        {
+            typename std::vector<T>::iterator itr = std::lower_bound(m_values.begin(), m_values.end(), value);
+            if (itr != m_values.end() && !(value < *itr))
+                return std::make_pair(const_iterator(itr), false);
+            return std::make_pair(const_iterator(m_values.insert(itr, value)), true);
+        }
+
+        const_iterator find(T const& value) const
+        {
+            const_iterator itr = std::lower_bound(m_values.begin(), m_values.end(), value);
+            return itr != m_values.end() && !(value < *itr) ? itr : m_values.end();
+        }
+
+        size_t count(T const& value) const { return find(value) != end() ? 1 : 0; }
+
+        size_t erase(T const& value)
+        {
+            typename std::vector<T>::iterator itr = std::lower_bound(m_values.begin(), m_values.end(), value);
+            if (itr == m_values.end() || value < *itr)
+                return 0;
+            m_values.erase(itr);
+            return 1;
+        }
+
+    private:
+        std::vector<T> m_values;
+};
+
+#endif
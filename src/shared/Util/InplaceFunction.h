@@ -0,0 +1,154 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _INPLACE_FUNCTION_H
+#define _INPLACE_FUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, size_t Capacity = 48>
+class InplaceFunction;
+
+// Copyable callable wrapper like std::function, but callables up to Capacity bytes
+// are kept inside the object instead of on the heap. Bigger ones still work and
+// fall back to a heap allocation.
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+    public:
+        InplaceFunction() : m_ops(nullptr) {}
+        InplaceFunction(std::nullptr_t) : m_ops(nullptr) {}
+
+        template <typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, InplaceFunction>::value>::type>
+        InplaceFunction(F&& callable) : m_ops(nullptr)
+        {
+            typedef typename std::decay<F>::type Callable;
+            if (IsNull(callable))
+                return;
+
+            OpsFor<Callable>::Create(&m_storage, std::forward<F>(callable));
+            m_ops = OpsFor<Callable>::Table();
+        }
+
+        InplaceFunction(InplaceFunction const& other) : m_ops(other.m_ops)
+        {
+            if (m_ops)
+                m_ops->copy(&m_storage, &other.m_storage);
+        }
+
+        InplaceFunction(InplaceFunction&& other) noexcept : m_ops(other.m_ops)
+        {
+            if (m_ops)
+            {
+                m_ops->move(&m_storage, &other.m_storage);
+                other.m_ops = nullptr;
+            }
+        }
+
+        ~InplaceFunction() { Reset(); }
+
+        InplaceFunction& operator=(InplaceFunction const& other)
+        {
+            if (this != &other)
+            {
+                InplaceFunction copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        InplaceFunction& operator=(InplaceFunction&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_ops = other.m_ops;
+                if (m_ops)
+                {
+                    m_ops->move(&m_storage, &other.m_storage);
+                    other.m_ops = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        explicit operator bool() const { return m_ops != nullptr; }
+
+        R operator()(Args... args) const { return m_ops->invoke(&m_storage, std::forward<Args>(args)...); }
+
+    private:
+        typedef typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type Storage;
+
+        struct Ops
+        {
+            R (*invoke)(Storage const*, Args&&...);
+            void (*copy)(Storage*, Storage const*);
+            void (*move)(Storage*, Storage*);           // leaves the source destroyed
+            void (*destroy)(Storage*);
+        };
+
+        template <typename Callable>
+        struct StoredInline : std::integral_constant<bool, sizeof(Callable) <= Capacity &&
+            alignof(std::max_align_t) % alignof(Callable) == 0 && std::is_nothrow_move_constructible<Callable>::value> {};
+
+        template <typename Callable, bool Inline = StoredInline<Callable>::value>
+        struct OpsFor
+        {
+            static Callable* Get(Storage* storage) { return reinterpret_cast<Callable*>(storage); }
+            template <typename F> static void Create(Storage* storage, F&& callable) { new (storage) Callable(std::forward<F>(callable)); }
+            static R Invoke(Storage const* storage, Args&&... args) { return (*Get(const_cast<Storage*>(storage)))(std::forward<Args>(args)...); }
+            static void Copy(Storage* to, Storage const* from) { new (to) Callable(*Get(const_cast<Storage*>(from))); }
+            static void Move(Storage* to, Storage* from) { new (to) Callable(std::move(*Get(from))); Get(from)->~Callable(); }
+            static void Destroy(Storage* storage) { Get(storage)->~Callable(); }
+            static Ops const* Table() { static Ops const ops = { &Invoke, &Copy, &Move, &Destroy }; return &ops; }
+        };
+
+        template <typename Callable>
+        struct OpsFor<Callable, false>
+        {
+            static Callable*& Get(Storage* storage) { return *reinterpret_cast<Callable**>(storage); }
+            template <typename F> static void Create(Storage* storage, F&& callable) { Get(storage) = new Callable(std::forward<F>(callable)); }
+            static R Invoke(Storage const* storage, Args&&... args) { return (*Get(const_cast<Storage*>(storage)))(std::forward<Args>(args)...); }
+            static void Copy(Storage* to, Storage const* from) { Get(to) = new Callable(*Get(const_cast<Storage*>(from))); }
+            static void Move(Storage* to, Storage* from) { Get(to) = Get(from); }
+            static void Destroy(Storage* storage) { delete Get(storage); }
+            static Ops const* Table() { static Ops const ops = { &Invoke, &Copy, &Move, &Destroy }; return &ops; }
+        };
+
+        template <typename F>
+        static bool IsNull(F const& callable, typename std::enable_if<std::is_constructible<bool, F const&>::value>::type* = nullptr) { return !callable; }
+        template <typename F>
+        static bool IsNull(F const&, typename std::enable_if<!std::is_constructible<bool, F const&>::value>::type* = nullptr) { return false; }
+
+        void Reset()
+        {
+            if (m_ops)
+            {
+                m_ops->destroy(&m_storage);
+                m_ops = nullptr;
+            }
+        }
+
+        Storage m_storage;
+        Ops const* m_ops;
+};
+
+#endif
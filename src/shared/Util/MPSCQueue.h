@@ -0,0 +1,105 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _MPSCQ_H
+#define _MPSCQ_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Bounded lock-free queue for many producers and a single consumer.
+// Slots are preallocated as a ring and each carries a sequence number telling
+// producers and the consumer whether it is free or holds published data.
+template <typename T>
+class MPSCQueue
+{
+    public:
+        explicit MPSCQueue(size_t capacity) : m_mask(RoundUpPowerOfTwo(capacity) - 1), m_buffer(new Cell[m_mask + 1]),
+            m_enqueuePos(0), m_dequeuePos(0)
+        {
+            for (size_t i = 0; i <= m_mask; ++i)
+                m_buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        MPSCQueue(const MPSCQueue<T>&) = delete;
+        MPSCQueue<T>& operator=(const MPSCQueue<T>&) = delete;
+
+        // can be called from any thread, returns false when the ring is full
+        bool Push(T&& value)
+        {
+            Cell* cell;
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            while (true)
+            {
+                cell = &m_buffer[pos & m_mask];
+                size_t const seq = cell->sequence.load(std::memory_order_acquire);
+                ptrdiff_t const diff = ptrdiff_t(seq) - ptrdiff_t(pos);
+                if (diff == 0)
+                {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+
+            cell->data = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // must only be called from the consumer thread
+        bool Pop(T& value)
+        {
+            Cell& cell = m_buffer[m_dequeuePos & m_mask];
+            size_t const seq = cell.sequence.load(std::memory_order_acquire);
+            if (ptrdiff_t(seq) - ptrdiff_t(m_dequeuePos + 1) < 0)
+                return false;
+
+            value = std::move(cell.data);
+            cell.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+            ++m_dequeuePos;
+            return true;
+        }
+
+        size_t Capacity() const { return m_mask + 1; }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+
+        static size_t RoundUpPowerOfTwo(size_t value)
+        {
+            size_t result = 2;
+            while (result < value)
+                result <<= 1;
+            return result;
+        }
+
+        size_t const m_mask;
+        std::unique_ptr<Cell[]> m_buffer;
+        alignas(64) std::atomic<size_t> m_enqueuePos;
+        alignas(64) size_t m_dequeuePos;
+};
+
+#endif
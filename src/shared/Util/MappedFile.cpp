@@ -0,0 +1,57 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Util/MappedFile.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+struct MappedFile::Impl
+{
+    boost::interprocess::file_mapping file;
+    boost::interprocess::mapped_region region;
+};
+
+MappedFile::MappedFile() : m_data(nullptr), m_size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+}
+
+MappedFile* MappedFile::Open(const char* filename)
+{
+    try
+    {
+        std::unique_ptr<Impl> impl(new Impl);
+        impl->file = boost::interprocess::file_mapping(filename, boost::interprocess::read_only);
+        // private pages, an accidental write never reaches the shared file
+        impl->region = boost::interprocess::mapped_region(impl->file, boost::interprocess::copy_on_write);
+
+        MappedFile* mapping = new MappedFile;
+        mapping->m_data = static_cast<unsigned char*>(impl->region.get_address());
+        mapping->m_size = impl->region.get_size();
+        mapping->m_impl = std::move(impl);
+        return mapping;
+    }
+    catch (boost::interprocess::interprocess_exception const&)
+    {
+        return nullptr;
+    }
+}
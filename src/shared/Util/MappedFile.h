@@ -0,0 +1,47 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPPEDFILE_H
+#define MANGOS_MAPPEDFILE_H
+
+#include <cstddef>
+#include <memory>
+
+// Copy on write view of a whole file, processes mapping the same file share its pages
+class MappedFile
+{
+    public:
+        ~MappedFile();
+
+        // nullptr when the file does not exist or cannot be mapped
+        static MappedFile* Open(const char* filename);
+
+        unsigned char* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+
+    private:
+        struct Impl;
+
+        MappedFile();
+
+        std::unique_ptr<Impl> m_impl;
+        unsigned char* m_data;
+        size_t m_size;
+};
+
+#endif
@@ -0,0 +1,244 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _OPEN_HASH_SET_H
+#define _OPEN_HASH_SET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// Flat hash set using open addressing with linear probing.
+// Keys live in one contiguous array so lookups touch a single cache line in the
+// common case. Erase leaves a tombstone instead of moving entries, so iterators
+// to other elements stay valid while erasing during iteration; the table is only
+// rebuilt on insert. Iteration order is unspecified.
+template <typename T, typename Hash = std::hash<T>>
+class OpenHashSet
+{
+    private:
+        enum SlotState : uint8_t
+        {
+            SLOT_EMPTY   = 0,
+            SLOT_FULL    = 1,
+            SLOT_DELETED = 2,
+        };
+
+    public:
+        class const_iterator
+        {
+            friend class OpenHashSet;
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef T const* pointer;
+                typedef T const& reference;
+
+                const_iterator() : m_set(nullptr), m_index(0) {}
+
+                reference operator*() const { return m_set->m_keys[m_index]; }
+                pointer operator->() const { return &m_set->m_keys[m_index]; }
+
+                const_iterator& operator++() { m_index = m_set->NextFull(m_index + 1); return *this; }
+                const_iterator operator++(int) { const_iterator tmp = *this; ++(*this); return tmp; }
+
+                bool operator==(const_iterator const& other) const { return m_index == other.m_index && m_set == other.m_set; }
+                bool operator!=(const_iterator const& other) const { return !(*this == other); }
+
+            private:
+                const_iterator(OpenHashSet const* set, size_t index) : m_set(set), m_index(index) {}
+
+                OpenHashSet const* m_set;
+                size_t m_index;
+        };
+        typedef const_iterator iterator;
+        typedef T value_type;
+        typedef size_t size_type;
+
+        OpenHashSet() : m_size(0), m_used(0) {}
+
+        const_iterator begin() const { return const_iterator(this, NextFull(0)); }
+        const_iterator end() const { return const_iterator(this, m_keys.size()); }
+
+        bool empty() const { return m_size == 0; }
+        size_t size() const { return m_size; }
+
+        // keeps the allocated table so refilling the set does not allocate again
+        void clear()
+        {
+            std::fill(m_states.begin(), m_states.end(), SLOT_EMPTY);
+            m_size = 0;
+            m_used = 0;
+        }
+
+        void reserve(size_t count)
+        {
+            size_t capacity = MIN_CAPACITY;
+            while (capacity * MAX_LOAD_NUM < count * MAX_LOAD_DEN)
+                capacity <<= 1;
+            if (capacity > m_keys.size())
+                Rehash(capacity);
+        }
+
+        std::pair<const_iterator, bool> insert(T const& key)
+        {
+            if ((m_used + 1) * MAX_LOAD_DEN > m_keys.size() * MAX_LOAD_NUM)
+            {
+                // mostly tombstones: purge them in place instead of growing
+                size_t capacity = m_keys.empty() ? MIN_CAPACITY : m_keys.size();
+                if ((m_size + 1) * MAX_LOAD_DEN * 2 > capacity * MAX_LOAD_NUM)
+                    capacity *= 2;
+                Rehash(capacity);
+            }
+
+            size_t const mask = m_keys.size() - 1;
+            size_t index = Bucket(key);
+            size_t tombstone = m_keys.size();
+            while (m_states[index] != SLOT_EMPTY)
+            {
+                if (m_states[index] == SLOT_FULL)
+                {
+                    if (m_keys[index] == key)
+                        return std::make_pair(const_iterator(this, index), false);
+                }
+                else if (tombstone == m_keys.size())
+                    tombstone = index;
+                index = (index + 1) & mask;
+            }
+
+            if (tombstone != m_keys.size())
+                index = tombstone;
+            else
+                ++m_used;
+
+            m_keys[index] = key;
+            m_states[index] = SLOT_FULL;
+            ++m_size;
+            return std::make_pair(const_iterator(this, index), true);
+        }
+
+        template <typename InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+                insert(*first);
+        }
+
+        const_iterator find(T const& key) const
+        {
+            size_t const index = FindIndex(key);
+            return const_iterator(this, index);
+        }
+
+        size_t count(T const& key) const { return FindIndex(key) != m_keys.size() ? 1 : 0; }
+
+        size_t erase(T const& key)
+        {
+            size_t const index = FindIndex(key);
+            if (index == m_keys.size())
+                return 0;
+            EraseAt(index);
+            return 1;
+        }
+
+        // returns iterator to the next element, other iterators remain valid
+        const_iterator erase(const_iterator itr)
+        {
+            EraseAt(itr.m_index);
+            return const_iterator(this, NextFull(itr.m_index + 1));
+        }
+
+    private:
+        static size_t const MIN_CAPACITY = 16;
+        // rebuild once live entries plus tombstones exceed 3/4 of the table
+        static size_t const MAX_LOAD_NUM = 3;
+        static size_t const MAX_LOAD_DEN = 4;
+
+        size_t Bucket(T const& key) const
+        {
+            // fibonacci hashing, scatters identity hashes such as raw guids over the table
+            uint64_t const mixed = uint64_t(Hash()(key)) * UINT64_C(0x9E3779B97F4A7C15);
+            return size_t(mixed >> 32) & (m_keys.size() - 1);
+        }
+
+        size_t FindIndex(T const& key) const
+        {
+            if (m_size == 0)
+                return m_keys.size();
+
+            size_t const mask = m_keys.size() - 1;
+            size_t index = Bucket(key);
+            while (m_states[index] != SLOT_EMPTY)
+            {
+                if (m_states[index] == SLOT_FULL && m_keys[index] == key)
+                    return index;
+                index = (index + 1) & mask;
+            }
+            return m_keys.size();
+        }
+
+        size_t NextFull(size_t index) const
+        {
+            while (index < m_states.size() && m_states[index] != SLOT_FULL)
+                ++index;
+            return index;
+        }
+
+        void EraseAt(size_t index)
+        {
+            m_states[index] = SLOT_DELETED;
+            --m_size;
+        }
+
+        void Rehash(size_t capacity)
+        {
+            std::vector<T> keys(capacity);
+            std::vector<uint8_t> states(capacity, SLOT_EMPTY);
+            keys.swap(m_keys);
+            states.swap(m_states);
+
+            m_size = 0;
+            m_used = 0;
+            size_t const mask = capacity - 1;
+            for (size_t i = 0; i < states.size(); ++i)
+            {
+                if (states[i] != SLOT_FULL)
+                    continue;
+
+                size_t index = Bucket(keys[i]);
+                while (m_states[index] != SLOT_EMPTY)
+                    index = (index + 1) & mask;
+                m_keys[index] = keys[i];
+                m_states[index] = SLOT_FULL;
+                ++m_size;
+                ++m_used;
+            }
+        }
+
+        std::vector<T> m_keys;
+        std::vector<uint8_t> m_states;
+        size_t m_size;                                      // live entries
+        size_t m_used;                                      // live entries and tombstones
+};
+
+#endif
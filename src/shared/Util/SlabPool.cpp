@@ -0,0 +1,159 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Util/SlabPool.h"
+
+#include <algorithm>
+#include <new>
+
+namespace
+{
+    // every block starts with the pool it belongs to, padded to keep the object aligned
+    size_t const HEADER_SIZE = alignof(std::max_align_t) > sizeof(SlabPool*) ? alignof(std::max_align_t) : sizeof(SlabPool*);
+    size_t const SIZE_CLASS_GRANULARITY = 256;
+
+    size_t ClassSize(size_t size) { return (size + HEADER_SIZE + SIZE_CLASS_GRANULARITY - 1) / SIZE_CLASS_GRANULARITY * SIZE_CLASS_GRANULARITY; }
+
+    thread_local SlabPool* currentPool = nullptr;
+}
+
+SlabPool::Scope::Scope(SlabPool* pool) : m_previous(currentPool)
+{
+    currentPool = pool;
+}
+
+SlabPool::Scope::~Scope()
+{
+    currentPool = m_previous;
+}
+
+SlabPool::SlabPool(size_t maxCachedBlocks) : m_maxCachedBlocks(maxCachedBlocks), m_references(1), m_released(false), m_allocated(0), m_reused(0)
+{
+}
+
+SlabPool::~SlabPool()
+{
+    for (FreeList& list : m_freeLists)
+        for (void* block : list.blocks)
+            ::operator delete(block);
+}
+
+void SlabPool::Release()
+{
+    {
+        // nothing can be reused anymore
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_released = true;
+        for (FreeList& list : m_freeLists)
+        {
+            for (void* block : list.blocks)
+                ::operator delete(block);
+            list.blocks.clear();
+        }
+    }
+    RemoveReference();
+}
+
+void SlabPool::RemoveReference()
+{
+    if (m_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete this;
+}
+
+SlabPool::Stats SlabPool::GetStats() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    Stats stats;
+    stats.allocated = m_allocated;
+    stats.reused = m_reused;
+    stats.cached = 0;
+    for (FreeList const& list : m_freeLists)
+        stats.cached += list.blocks.size();
+    return stats;
+}
+
+void* SlabPool::Take(size_t size)
+{
+    m_references.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (FreeList& list : m_freeLists)
+    {
+        if (list.size != size)
+            continue;
+
+        if (list.blocks.empty())
+            break;
+
+        void* block = list.blocks.back();
+        list.blocks.pop_back();
+        ++m_reused;
+        return block;
+    }
+
+    ++m_allocated;
+    return ::operator new(size);
+}
+
+void SlabPool::Give(void* block, size_t size)
+{
+    bool cached = false;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        // once released the pool only waits for its remaining blocks
+        if (!m_released)
+        {
+            auto itr = std::find_if(m_freeLists.begin(), m_freeLists.end(), [size](FreeList const& list) { return list.size == size; });
+            if (itr == m_freeLists.end())
+                itr = m_freeLists.insert(m_freeLists.end(), FreeList{ size, {} });
+
+            if (itr->blocks.size() < m_maxCachedBlocks)
+            {
+                itr->blocks.push_back(block);
+                cached = true;
+            }
+        }
+    }
+
+    if (!cached)
+        ::operator delete(block);
+
+    RemoveReference();
+}
+
+void* SlabPool::Allocate(size_t size)
+{
+    SlabPool* pool = currentPool;
+    size_t const blockSize = ClassSize(size);
+    char* block = static_cast<char*>(pool ? pool->Take(blockSize) : ::operator new(blockSize));
+    *reinterpret_cast<SlabPool**>(block) = pool;
+    return block + HEADER_SIZE;
+}
+
+void SlabPool::Free(void* object, size_t size)
+{
+    if (!object)
+        return;
+
+    char* block = static_cast<char*>(object) - HEADER_SIZE;
+    SlabPool* pool = *reinterpret_cast<SlabPool**>(block);
+    if (pool)
+        pool->Give(block, ClassSize(size));
+    else
+        ::operator delete(block);
+}
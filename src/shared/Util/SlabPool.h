@@ -0,0 +1,99 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _SLABPOOL_H
+#define _SLABPOOL_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Recycler for large objects created and destroyed in bursts, like the spawns of
+// a grid that gets loaded and unloaded again. Classes opt in by forwarding their
+// operator new and delete here. Allocations are served by the pool made current
+// on the calling thread with SlabPool::Scope, or by the global allocator if there
+// is none. Every block remembers its pool and goes back there on delete from any
+// thread; a pool lives until its owner released it and all its blocks are freed.
+class SlabPool
+{
+    public:
+        struct Stats
+        {
+            uint64 allocated;                               // blocks taken from the global allocator
+            uint64 reused;                                  // allocations served from the free lists
+            uint64 cached;                                  // blocks waiting in the free lists
+        };
+
+        // makes pool serve the allocations of the current thread while alive
+        class Scope
+        {
+            public:
+                explicit Scope(SlabPool* pool);
+                ~Scope();
+                Scope(Scope const&) = delete;
+                Scope& operator=(Scope const&) = delete;
+
+            private:
+                SlabPool* m_previous;
+        };
+
+        // maxCachedBlocks limits the free list of each size class
+        explicit SlabPool(size_t maxCachedBlocks);
+        SlabPool(SlabPool const&) = delete;
+        SlabPool& operator=(SlabPool const&) = delete;
+
+        // gives up the owner's reference, the pool is destroyed with its last block
+        void Release();
+
+        Stats GetStats() const;
+
+        static void* Allocate(size_t size);
+        // size must be the one passed to Allocate
+        static void Free(void* block, size_t size);
+
+    private:
+        struct FreeList
+        {
+            size_t size;
+            std::vector<void*> blocks;
+        };
+
+        ~SlabPool();
+
+        void* Take(size_t size);
+        void Give(void* block, size_t size);
+        void RemoveReference();
+
+        mutable std::mutex m_lock;
+        std::vector<FreeList> m_freeLists;                  // one per size class, few classes per pool
+        size_t const m_maxCachedBlocks;
+        std::atomic<uint32> m_references;                   // owner plus every live block
+        bool m_released;
+        uint64 m_allocated;
+        uint64 m_reused;
+};
+
+// Forwards the sized class allocation functions to SlabPool. Deleting through a
+// virtual destructor passes the dynamic size, so derived classes share the pool.
+#define SLAB_POOL_ALLOCATED                                                         \
+    static void* operator new(size_t size) { return SlabPool::Allocate(size); }    \
+    static void operator delete(void* block, size_t size) { SlabPool::Free(block, size); }
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Util/TickArena.h"
+
+#include <memory>
+
+namespace
+{
+    struct ThreadArena
+    {
+        ThreadArena() : buffer(new uint8[TickArena::INITIAL_SIZE]), resource(buffer.get(), TickArena::INITIAL_SIZE, std::pmr::new_delete_resource()) {}
+
+        std::unique_ptr<uint8[]> buffer;
+        std::pmr::monotonic_buffer_resource resource;
+    };
+
+    thread_local std::unique_ptr<ThreadArena> currentArena;
+    thread_local uint32 scopeDepth = 0;
+}
+
+TickArena::Scope::Scope()
+{
+    if (!currentArena)
+        currentArena.reset(new ThreadArena());
+    ++scopeDepth;
+}
+
+TickArena::Scope::~Scope()
+{
+    if (--scopeDepth == 0)
+        currentArena->resource.release();
+}
+
+std::pmr::memory_resource* TickArena::Resource()
+{
+    return scopeDepth ? &currentArena->resource : std::pmr::get_default_resource();
+}
@@ -0,0 +1,59 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _TICKARENA_H
+#define _TICKARENA_H
+
+#include "Common.h"
+
+#include <list>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+// Monotonic memory for short lived containers of one map update, like the update
+// data of the players or the triggered procs of a hit. A thread gets its arena while
+// a TickArena::Scope is alive, all memory taken from it is dropped at once when the
+// outermost scope ends. Containers using Resource() must therefore not outlive the
+// scope they were created in. Without a scope Resource() is the default heap
+// resource, so the same code stays safe outside of map updates.
+class TickArena
+{
+    public:
+        // makes the arena of the current thread serve Resource() while alive
+        class Scope
+        {
+            public:
+                Scope();
+                ~Scope();
+                Scope(Scope const&) = delete;
+                Scope& operator=(Scope const&) = delete;
+        };
+
+        static std::pmr::memory_resource* Resource();
+
+        // bytes kept by every thread between scopes, more is taken from the heap and given back
+        static constexpr size_t INITIAL_SIZE = 256 * 1024;
+};
+
+// containers meant to be constructed with TickArena::Resource()
+template <typename T> using TickVector = std::pmr::vector<T>;
+template <typename T> using TickList = std::pmr::list<T>;
+template <typename K, typename V, typename H = std::hash<K>> using TickUnorderedMap = std::pmr::unordered_map<K, V, H>;
+
+#endif
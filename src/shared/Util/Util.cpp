@@ -326,7 +326,7 @@ uint32 CreatePIDFile(const std::string& filename)
     return (uint32)pid;
 }
 
-bool Utf8toWStr(const std::string& utf8str, std::wstring& wstr, size_t max_len)
+bool Utf8toWStr(std::string_view utf8str, std::wstring& wstr, size_t max_len)
 {
     if (utf8str.empty())
     {
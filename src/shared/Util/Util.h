@@ -22,6 +22,7 @@
 #include "Common.h"
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <random>
 
@@ -47,6 +48,21 @@ inline uint32 secsToTimeBitFields(time_t secs)
 
 std::mt19937* GetRandomGenerator();
 
+/* Makes the random functions of this thread draw from a generator seeded with seed until the end
+ * of the scope, then continues the previous sequence. The same seed gives the same rolls whenever
+ * they are made. */
+class RandomSeedScope
+{
+    public:
+        explicit RandomSeedScope(uint32 seed) : m_saved(*GetRandomGenerator()) { GetRandomGenerator()->seed(seed); }
+        ~RandomSeedScope() { *GetRandomGenerator() = m_saved; }
+        RandomSeedScope(RandomSeedScope const&) = delete;
+        RandomSeedScope& operator=(RandomSeedScope const&) = delete;
+
+    private:
+        std::mt19937 m_saved;
+};
+
 /* Return a random number in the range min..max; (max-min) must be smaller than 32768. */
 int32 irand(int32 min, int32 max);
 
@@ -160,7 +176,7 @@ inline void ApplyPercentModFloatVar(float& var, float val, bool apply)
     var *= (apply ? (100.0f + val) / 100.0f : 100.0f / (100.0f + val));
 }
 
-bool Utf8toWStr(const std::string& utf8str, std::wstring& wstr, size_t max_len = 0);
+bool Utf8toWStr(std::string_view utf8str, std::wstring& wstr, size_t max_len = 0);
 // in wsize==max size of buffer, out wsize==real string size
 
 bool WStrToUtf8(const std::wstring& wstr, std::string& utf8str);